@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/dynamic_resolution/DynamicResolution.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace iglu {
+namespace dynamicresolution {
+
+namespace {
+
+size_t scaleSize(size_t size, float scale) {
+  return std::max(static_cast<size_t>(std::lround(static_cast<float>(size) * scale)),
+                  static_cast<size_t>(1));
+}
+
+} // namespace
+
+DynamicResolutionController::DynamicResolutionController(igl::IDevice& device,
+                                                         DynamicResolutionDesc desc) :
+  desc_(desc) {
+  IGL_ASSERT(desc_.minScale > 0.0f && desc_.minScale <= desc_.maxScale);
+  IGL_ASSERT(desc_.scaleStep > 0.0f);
+
+  scale_ = unroundedScale_ = desc_.maxScale;
+
+  if (!device.hasFeature(igl::DeviceFeatures::Timers)) {
+    return;
+  }
+  timers_.reserve(desc_.numTimers);
+  for (uint32_t i = 0; i != desc_.numTimers; i++) {
+    auto timer = device.createTimer(nullptr);
+    if (!timer) {
+      break;
+    }
+    timers_.push_back({std::move(timer)});
+  }
+}
+
+void DynamicResolutionController::beginFrame(igl::ICommandBuffer& commandBuffer) {
+  IGL_ASSERT_MSG(!currentTimer_, "endFrame() was not called for the previous frame");
+
+  for (auto& timer : timers_) {
+    if (timer.inFlight && timer.timer->resultsAvailable()) {
+      timer.inFlight = false;
+      addGpuTimeSample(static_cast<float>(timer.timer->getElapsedTimeNanos()) * 1e-6f, timer.scale);
+    }
+  }
+
+  // if all the timers are still in flight, this frame is not measured
+  for (auto& timer : timers_) {
+    if (!timer.inFlight) {
+      currentTimer_ = &timer;
+      currentTimer_->scale = scale_;
+      commandBuffer.beginTimer(currentTimer_->timer);
+      break;
+    }
+  }
+}
+
+void DynamicResolutionController::endFrame(igl::ICommandBuffer& commandBuffer) {
+  if (!currentTimer_) {
+    return;
+  }
+  commandBuffer.endTimer(currentTimer_->timer);
+  currentTimer_->inFlight = true;
+  currentTimer_ = nullptr;
+}
+
+void DynamicResolutionController::addGpuTimeSample(float gpuTimeMs, float scale) {
+  if (gpuTimeMs <= 0.0f || scale <= 0.0f) {
+    return;
+  }
+
+  // the GPU time is roughly proportional to the number of pixels rendered
+  const float normalizedTimeMs = gpuTimeMs * (scale_ * scale_) / (scale * scale);
+  gpuTimeMs_ = gpuTimeMs_ == 0.0f ? normalizedTimeMs
+                                  : gpuTimeMs_ + desc_.smoothing * (normalizedTimeMs - gpuTimeMs_);
+
+  const float desiredScale =
+      scale_ * std::sqrt(desc_.targetGpuTimeMs * desc_.headroom / gpuTimeMs_);
+  if (gpuTimeMs_ > desc_.targetGpuTimeMs) {
+    unroundedScale_ = std::min(unroundedScale_, desiredScale);
+  } else if (gpuTimeMs_ < desc_.targetGpuTimeMs * desc_.headroom) {
+    unroundedScale_ =
+        std::max(unroundedScale_,
+                 std::min(desiredScale, unroundedScale_ + desc_.maxScaleIncreasePerFrame));
+  }
+  unroundedScale_ = std::clamp(unroundedScale_, desc_.minScale, desc_.maxScale);
+
+  const float steppedScale = std::clamp(
+      std::floor(unroundedScale_ / desc_.scaleStep + 1e-4f) * desc_.scaleStep,
+      desc_.minScale,
+      desc_.maxScale);
+  if (steppedScale != scale_) {
+    gpuTimeMs_ *= (steppedScale * steppedScale) / (scale_ * scale_);
+    scale_ = steppedScale;
+  }
+}
+
+igl::Dimensions DynamicResolutionController::getRenderTargetSize(
+    const igl::Dimensions& outputSize) const {
+  return {static_cast<size_t>(std::ceil(static_cast<float>(outputSize.width) * desc_.maxScale)),
+          static_cast<size_t>(std::ceil(static_cast<float>(outputSize.height) * desc_.maxScale)),
+          1};
+}
+
+igl::Dimensions DynamicResolutionController::getScaledSize(
+    const igl::Dimensions& outputSize) const {
+  const igl::Dimensions renderTargetSize = getRenderTargetSize(outputSize);
+  return {std::min(scaleSize(outputSize.width, scale_), renderTargetSize.width),
+          std::min(scaleSize(outputSize.height, scale_), renderTargetSize.height),
+          1};
+}
+
+igl::Viewport DynamicResolutionController::getViewport(const igl::Dimensions& outputSize) const {
+  const igl::Dimensions size = getScaledSize(outputSize);
+  return {0.0f, 0.0f, static_cast<float>(size.width), static_cast<float>(size.height), 0.0f, 1.0f};
+}
+
+igl::ScissorRect DynamicResolutionController::getScissor(const igl::Dimensions& outputSize) const {
+  const igl::Dimensions size = getScaledSize(outputSize);
+  return {0, 0, static_cast<uint32_t>(size.width), static_cast<uint32_t>(size.height)};
+}
+
+igl::Size DynamicResolutionController::getUVScale(const igl::Dimensions& outputSize) const {
+  const igl::Dimensions size = getScaledSize(outputSize);
+  const igl::Dimensions renderTargetSize = getRenderTargetSize(outputSize);
+  return {static_cast<float>(size.width) / static_cast<float>(renderTargetSize.width),
+          static_cast<float>(size.height) / static_cast<float>(renderTargetSize.height)};
+}
+
+igl::Size DynamicResolutionController::getUVMax(const igl::Dimensions& outputSize) const {
+  const igl::Dimensions size = getScaledSize(outputSize);
+  const igl::Dimensions renderTargetSize = getRenderTargetSize(outputSize);
+  return {(static_cast<float>(size.width) - 0.5f) / static_cast<float>(renderTargetSize.width),
+          (static_cast<float>(size.height) - 0.5f) / static_cast<float>(renderTargetSize.height)};
+}
+
+} // namespace dynamicresolution
+} // namespace iglu
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/IGL.h>
+#include <memory>
+#include <vector>
+
+namespace iglu {
+namespace dynamicresolution {
+
+/**
+ * @brief Parameters of a DynamicResolutionController.
+ *
+ *  targetGpuTimeMs          - GPU time budget of a frame, e.g. 1000/90 to hold 90 Hz
+ *  headroom                 - The scale aims at this fraction of the budget, so that small spikes
+ *                             do not immediately miss it
+ *  minScale, maxScale       - Range of the resolution scale, per axis. The render targets are
+ *                             allocated at maxScale
+ *  scaleStep                - The scale is rounded down to multiples of this, so that it does not
+ *                             change by a few pixels every frame
+ *  smoothing                - Weight of a new GPU time sample in the moving average
+ *  maxScaleIncreasePerFrame - The scale drops as soon as the budget is exceeded but only grows by
+ *                             this much per sample, to avoid oscillating
+ *  numTimers                - GPU timers kept in flight. Results come back a few frames late, so
+ *                             this should cover the number of frames the GPU lags behind
+ */
+struct DynamicResolutionDesc {
+  float targetGpuTimeMs = 1000.0f / 90.0f;
+  float headroom = 0.9f;
+  float minScale = 0.5f;
+  float maxScale = 1.0f;
+  float scaleStep = 1.0f / 32.0f;
+  float smoothing = 0.2f;
+  float maxScaleIncreasePerFrame = 0.02f;
+  uint32_t numTimers = 4;
+};
+
+/**
+ * @brief Adjusts the rendering resolution every frame to keep the GPU time of a frame within a
+ * budget.
+ *
+ * The scene is rendered into render targets allocated once with getRenderTargetSize(), so
+ * changing the scale never reallocates them. Each frame only the top-left part returned by
+ * getViewport() and getScissor() is rendered, and the final pass upscales it to the output by
+ * multiplying its texture coordinates by getUVScale(). Rows and columns of that part start at
+ * texel 0 with every backend, so the same UV scale works everywhere. Clamping the texture
+ * coordinates to getUVMax() keeps bilinear filtering from reading the stale texels outside of it.
+ *
+ * Every frame, call beginFrame() and endFrame() around the commands to measure. They time the
+ * frame with ITimers kept in flight and feed the results back once the GPU has finished, without
+ * ever blocking. On devices without DeviceFeatures::Timers, the application can report its own
+ * measurements with addGpuTimeSample() instead.
+ *
+ * Since the GPU time mostly depends on the number of pixels rendered, the scale is adjusted by
+ * the square root of the ratio between the budget and the measured time. Samples are normalized
+ * to the current scale, so the results of frames rendered before a change do not push it further.
+ */
+class DynamicResolutionController final {
+ public:
+  DynamicResolutionController(igl::IDevice& device, DynamicResolutionDesc desc = {});
+
+  /// Starts timing the frame and feeds back the results of the previous frames that are available
+  void beginFrame(igl::ICommandBuffer& commandBuffer);
+  /// Stops timing the frame. Must be recorded into the same command buffer as beginFrame()
+  void endFrame(igl::ICommandBuffer& commandBuffer);
+
+  /// Reports the GPU time of a frame rendered at `scale`, the value getScale() returned then
+  void addGpuTimeSample(float gpuTimeMs, float scale);
+
+  /// The resolution scale of the next frame, per axis
+  [[nodiscard]] float getScale() const {
+    return scale_;
+  }
+  /// Moving average of the GPU time, normalized to the current scale. 0 until the first sample
+  [[nodiscard]] float getGpuTimeMs() const {
+    return gpuTimeMs_;
+  }
+
+  /// Size to allocate the render targets with, for an output of `outputSize`
+  [[nodiscard]] igl::Dimensions getRenderTargetSize(const igl::Dimensions& outputSize) const;
+  /// Size of the part of the render targets rendered this frame
+  [[nodiscard]] igl::Dimensions getScaledSize(const igl::Dimensions& outputSize) const;
+  [[nodiscard]] igl::Viewport getViewport(const igl::Dimensions& outputSize) const;
+  [[nodiscard]] igl::ScissorRect getScissor(const igl::Dimensions& outputSize) const;
+  /// Multiplies the [0, 1] texture coordinates of the upscale pass to sample the rendered part
+  [[nodiscard]] igl::Size getUVScale(const igl::Dimensions& outputSize) const;
+  /// Texture coordinates of the center of the last texels of the rendered part
+  [[nodiscard]] igl::Size getUVMax(const igl::Dimensions& outputSize) const;
+
+ private:
+  struct Timer {
+    std::shared_ptr<igl::ITimer> timer;
+    float scale = 1.0f;
+    bool inFlight = false;
+  };
+
+  DynamicResolutionDesc desc_;
+  std::vector<Timer> timers_;
+  // the timer of the frame between beginFrame() and endFrame(), if any
+  Timer* currentTimer_ = nullptr;
+  float scale_ = 1.0f;
+  // the scale before rounding down to DynamicResolutionDesc::scaleStep
+  float unroundedScale_ = 1.0f;
+  float gpuTimeMs_ = 0.0f;
+};
+
+} // namespace dynamicresolution
+} // namespace iglu
@@ -9,7 +9,9 @@
 
 #include <IGLU/simple_renderer/Drawable.h>
 #include <IGLU/simple_renderer/Material.h>
+#include <algorithm>
 #include <igl/ShaderCreator.h>
+#include <vector>
 
 namespace iglu {
 namespace imgui {
@@ -170,25 +172,26 @@ static std::unique_ptr<igl::IShaderStages> getShaderStagesForBackend(igl::IDevic
   IGL_UNREACHABLE_RETURN(nullptr);
 }
 
+// Holds the geometry of all the draw lists of a frame
 struct DrawableData {
   std::shared_ptr<iglu::vertexdata::VertexData> vertexData;
   std::shared_ptr<iglu::drawable::Drawable> drawable;
+  size_t maxVertices = 0;
+  size_t maxIndices = 0;
 
   DrawableData(igl::IDevice& device,
                const std::shared_ptr<igl::IVertexInputState>& inputState,
-               const std::shared_ptr<iglu::material::Material>& material) {
-    IGL_ASSERT_MSG(sizeof(ImDrawIdx) == 2, "The constants below may not work with the ImGui data.");
-    const size_t kMaxVertices = (1l << 16);
-    const size_t kMaxVertexBufferSize = kMaxVertices * sizeof(ImDrawVert);
-    const size_t kMaxIndexBufferSize = kMaxVertices * sizeof(ImDrawIdx);
-
+               const std::shared_ptr<iglu::material::Material>& material,
+               size_t numVertices,
+               size_t numIndices) :
+    maxVertices(numVertices), maxIndices(numIndices) {
     const igl::BufferDesc vbDesc(igl::BufferDesc::BufferTypeBits::Vertex,
                                  nullptr,
-                                 kMaxVertexBufferSize,
+                                 maxVertices * sizeof(ImDrawVert),
                                  igl::ResourceStorage::Shared);
     const igl::BufferDesc ibDesc(igl::BufferDesc::BufferTypeBits::Index,
                                  nullptr,
-                                 kMaxIndexBufferSize,
+                                 maxIndices * sizeof(ImDrawIdx),
                                  igl::ResourceStorage::Shared);
 
     iglu::vertexdata::PrimitiveDesc primitiveDesc;
@@ -219,8 +222,12 @@ class Session::Renderer {
  private:
   std::shared_ptr<igl::IVertexInputState> _vertexInputState;
   std::shared_ptr<iglu::material::Material> _material;
-  std::vector<DrawableData> _drawables[3]; // list of drawables to be reused every 3 frames
+  // grow-only buffers reused every 3 frames, shared by all the draw lists of a frame
+  std::unique_ptr<DrawableData> _drawables[3];
   size_t _nextBufferingIndex = 0;
+  // all the draw lists of a frame are merged here and uploaded at once
+  std::vector<ImDrawVert> _vertices;
+  std::vector<ImDrawIdx> _indices;
 
   igl::RenderPipelineDesc _renderPipelineDesc;
   std::shared_ptr<igl::ITexture> _fontTexture;
@@ -343,9 +350,42 @@ void Session::Renderer::renderDrawData(igl::IDevice& device,
       drawData->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
 
   // Since vertex buffers are updated every frame, we must use triple buffering for Metal to work
-  std::vector<DrawableData>& curFrameDrawables = _drawables[_nextBufferingIndex];
+  std::unique_ptr<DrawableData>& drawableData = _drawables[_nextBufferingIndex];
   _nextBufferingIndex = (_nextBufferingIndex + 1) % 3;
 
+  const auto numVertices = static_cast<size_t>(drawData->TotalVtxCount);
+  const auto numIndices = static_cast<size_t>(drawData->TotalIdxCount);
+  if (!drawableData || drawableData->maxVertices < numVertices ||
+      drawableData->maxIndices < numIndices) {
+    // grow geometrically so that a growing UI does not reallocate every frame
+    const size_t kMinElements = 1 << 16;
+    const auto grow = [kMinElements](size_t current, size_t required) {
+      return std::max({required, current * 2, kMinElements});
+    };
+    drawableData = std::make_unique<DrawableData>(
+        device,
+        _vertexInputState,
+        _material,
+        grow(drawableData ? drawableData->maxVertices : 0, numVertices),
+        grow(drawableData ? drawableData->maxIndices : 0, numIndices));
+  }
+
+  // Upload the vertex/index buffers of all the draw lists at once
+  _vertices.clear();
+  _indices.clear();
+  for (int n = 0; n < drawData->CmdListsCount; n++) {
+    const ImDrawList* cmd_list = drawData->CmdLists[n];
+    _vertices.insert(_vertices.end(), cmd_list->VtxBuffer.begin(), cmd_list->VtxBuffer.end());
+    _indices.insert(_indices.end(), cmd_list->IdxBuffer.begin(), cmd_list->IdxBuffer.end());
+  }
+  if (_vertices.empty() || _indices.empty()) {
+    return;
+  }
+  drawableData->vertexData->vertexBuffer().upload(_vertices.data(),
+                                                  {_vertices.size() * sizeof(ImDrawVert), 0});
+  drawableData->vertexData->indexBuffer().upload(_indices.data(),
+                                                 {_indices.size() * sizeof(ImDrawIdx), 0});
+
   const bool isOpenGL = device.getBackendType() == igl::BackendType::OpenGL;
   const bool isVulkan = device.getBackendType() == igl::BackendType::Vulkan;
 
@@ -356,21 +396,12 @@ void Session::Renderer::renderDrawData(igl::IDevice& device,
   }
 
   ImTextureID lastBoundTextureId = nullptr;
+  size_t firstVertex = 0;
+  size_t firstIndex = 0;
 
   for (int n = 0; n < drawData->CmdListsCount; n++) {
     const ImDrawList* cmd_list = drawData->CmdLists[n];
 
-    if (n >= curFrameDrawables.size()) {
-      curFrameDrawables.emplace_back(device, _vertexInputState, _material);
-    }
-    DrawableData& drawableData = curFrameDrawables[n];
-
-    // Upload vertex/index buffers
-    drawableData.vertexData->vertexBuffer().upload(
-        cmd_list->VtxBuffer.Data, {cmd_list->VtxBuffer.Size * sizeof(ImDrawVert), 0});
-    drawableData.vertexData->indexBuffer().upload(
-        cmd_list->IdxBuffer.Data, {cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx), 0});
-
     for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++) {
       const ImDrawCmd cmd = cmd_list->CmdBuffer[cmd_i];
       IGL_ASSERT(cmd.UserCallback == nullptr);
@@ -405,11 +436,16 @@ void Session::Renderer::renderDrawData(igl::IDevice& device,
         }
       }
 
-      drawableData.vertexData->primitiveDesc().numEntries = cmd.ElemCount;
-      drawableData.vertexData->primitiveDesc().offset = cmd.IdxOffset * sizeof(ImDrawIdx);
+      // the indices of a draw list are relative to its first vertex
+      auto& primitiveDesc = drawableData->vertexData->primitiveDesc();
+      primitiveDesc.numEntries = cmd.ElemCount;
+      primitiveDesc.offset = (firstIndex + cmd.IdxOffset) * sizeof(ImDrawIdx);
+      primitiveDesc.vertexOffset = (firstVertex + cmd.VtxOffset) * sizeof(ImDrawVert);
 
-      drawableData.drawable->draw(device, cmdEncoder, _renderPipelineDesc);
+      drawableData->drawable->draw(device, cmdEncoder, _renderPipelineDesc);
     }
+    firstVertex += cmd_list->VtxBuffer.Size;
+    firstIndex += cmd_list->IdxBuffer.Size;
   }
 
   if (isOpenGL) {
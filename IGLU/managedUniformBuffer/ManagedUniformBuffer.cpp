@@ -92,6 +92,12 @@ ManagedUniformBuffer::ManagedUniformBuffer(igl::IDevice& device,
     result.code = igl::Result::Code::RuntimeError;
     return;
   }
+  if (createBuffer && info.ringBuffer) {
+    // not owning: the ring buffer outlives this object
+    ringBuffer_ = std::shared_ptr<igl::IBuffer>(std::shared_ptr<igl::IBuffer>(),
+                                                &info.ringBuffer->getBuffer());
+    createBuffer = false;
+  }
   if (createBuffer) {
     desc.data = data_;
     desc.type = igl::BufferDesc::BufferTypeBits::Uniform;
@@ -148,6 +154,11 @@ void ManagedUniformBuffer::bind(const igl::IDevice& device,
   } else {
     if (useBindBytes_) {
       encoder.bindBytes(uniformInfo.index, bindTarget, data_, length_);
+    } else if (ringBuffer_) {
+      size_t offset = 0;
+      if (allocateFromRingBuffer(offset)) {
+        encoder.bindBuffer(uniformInfo.index, bindTarget, ringBuffer_, offset);
+      }
     } else {
       // Need to ensure the latest data is present in the buffer
       // TODO: Have callers handle this when data has changed.
@@ -167,6 +178,11 @@ void ManagedUniformBuffer::bind(const igl::IDevice& device, igl::IComputeCommand
   } else {
     if (useBindBytes_) {
       encoder.bindBytes(uniformInfo.index, data_, length_);
+    } else if (ringBuffer_) {
+      size_t offset = 0;
+      if (allocateFromRingBuffer(offset)) {
+        encoder.bindBuffer(uniformInfo.index, ringBuffer_, offset);
+      }
     } else {
       // Need to ensure the latest data is present in the buffer
       // TODO: Have callers handle this when data has changed.
@@ -180,34 +196,66 @@ void ManagedUniformBuffer::bind(const igl::IDevice& device, igl::IComputeCommand
   }
 }
 
+bool ManagedUniformBuffer::allocateFromRingBuffer(size_t& outOffset) {
+  igl::Result result;
+  const igl::RingBufferAllocation allocation =
+      uniformInfo.ringBuffer->allocate(uniformInfo.length, &result);
+  if (allocation.empty()) {
+    IGL_LOG_ERROR_ONCE("ManagedUniformBuffer: ring buffer allocation failed: %s\n",
+                       result.message.c_str());
+    return false;
+  }
+  checked_memcpy(allocation.data, allocation.size, data_, uniformInfo.length);
+  outOffset = allocation.offset;
+  return true;
+}
+
 void* ManagedUniformBuffer::getData() {
   return data_;
 }
 
 bool ManagedUniformBuffer::updateData(const char* name, const void* data, size_t dataSize) {
   IGL_ASSERT(name);
-  for (auto& uniform : uniformInfo.uniforms) {
-    if (strcmp(name, uniform.name.c_str()) == 0) {
-      // If dataSize is smaller than the expected size, we will just update as client requested.
-      // This could mean the user knows only a portion of the uniform data needs updating
-      // However, if dataSize is larger than or equal to what we expect for this uniform, we will
-      // only copy data up to the expected data size for this uniform
-      size_t uniformDataSize = getUniformDataSizeInternal(uniform);
-      if (dataSize > uniformDataSize) {
-        dataSize = uniformDataSize;
+  const int uniformIndex = getUniformIndex(name);
+  if (uniformIndex < 0) {
+    IGL_ASSERT_MSG(0, "call to updateData: uniform with name %s not found, skipping update\n");
+    return false;
+  }
+  return updateData(uniformIndex, data, dataSize);
+}
+
+bool ManagedUniformBuffer::updateData(int uniformIndex, const void* data, size_t dataSize) {
+  if (!IGL_VERIFY(uniformIndex >= 0 &&
+                  static_cast<size_t>(uniformIndex) < uniformInfo.uniforms.size())) {
+    return false;
+  }
+  auto& uniform = uniformInfo.uniforms[uniformIndex];
+  // If dataSize is smaller than the expected size, we will just update as client requested.
+  // This could mean the user knows only a portion of the uniform data needs updating
+  // However, if dataSize is larger than or equal to what we expect for this uniform, we will
+  // only copy data up to the expected data size for this uniform
+  size_t uniformDataSize = getUniformDataSizeInternal(uniform);
+  if (dataSize > uniformDataSize) {
+    dataSize = uniformDataSize;
 #if IGL_DEBUG
-        IGL_LOG_INFO_ONCE(
-            "IGLU/ManagedBufferBuffer/updateData: dataSize is larger than expected. This could be "
-            "benign. See comments in updateData for more details. \n");
+    IGL_LOG_INFO_ONCE(
+        "IGLU/ManagedBufferBuffer/updateData: dataSize is larger than expected. This could be "
+        "benign. See comments in updateData for more details. \n");
 #endif
-      }
-      char* ptr = reinterpret_cast<char*>(data_);
-      checked_memcpy(ptr + uniform.offset, uniformDataSize, data, dataSize);
-      return true;
+  }
+  char* ptr = reinterpret_cast<char*>(data_);
+  checked_memcpy(ptr + uniform.offset, uniformDataSize, data, dataSize);
+  return true;
+}
+
+int ManagedUniformBuffer::getUniformIndex(const char* name) const {
+  IGL_ASSERT(name);
+  for (size_t i = 0; i != uniformInfo.uniforms.size(); i++) {
+    if (strcmp(name, uniformInfo.uniforms[i].name.c_str()) == 0) {
+      return static_cast<int>(i);
     }
   }
-  IGL_ASSERT_MSG(0, "call to updateData: uniform with name %s not found, skipping update\n");
-  return false;
+  return -1;
 }
 
 size_t ManagedUniformBuffer::getUniformDataSize(const char* name) {
@@ -19,6 +19,11 @@ struct ManagedUniformBufferInfo {
   int index = -1;
   size_t length = 0;
   std::vector<igl::UniformDesc> uniforms;
+  // Optional, not owned. When set, every bind() copies the current data into a new allocation of
+  // the ring buffer instead of uploading it to a buffer which the GPU might still be reading. The
+  // ring buffer must outlive the ManagedUniformBuffer and its owner calls endFrame() once per
+  // frame. Ignored with OpenGL, which binds individual uniforms, and when bindBytes is used.
+  igl::IRingBuffer* ringBuffer = nullptr;
 };
 
 class ManagedUniformBuffer {
@@ -29,6 +34,11 @@ class ManagedUniformBuffer {
   ~ManagedUniformBuffer();
   // This function takes a chunk of data and use it to update the value of uniform 'name'
   bool updateData(const char* name, const void* data, size_t dataSize);
+  // Same as above, with the index of the uniform returned by getUniformIndex()
+  bool updateData(int uniformIndex, const void* data, size_t dataSize);
+  // This function returns the index of uniform 'name' in uniformInfo.uniforms, or -1 if no
+  // uniform with given name exists. Resolve it once to skip the name lookup of updateData()
+  int getUniformIndex(const char* name) const;
   // This function returns the expected data size for uniform with given name
   // If uniform has type UniformType::Float3, this function will return
   // 3 * sizeof(float) if elementStride is zero and return elementStride otherwise
@@ -48,9 +58,13 @@ class ManagedUniformBuffer {
 
  private:
   size_t getUniformDataSizeInternal(igl::UniformDesc& uniform);
+  // copies the data into a new allocation of uniformInfo.ringBuffer, returns false if it is full
+  bool allocateFromRingBuffer(size_t& outOffset);
   void* data_ = nullptr;
   int length_ = 0;
   std::shared_ptr<igl::IBuffer> buffer_;
+  // not owning, bound to the allocations of uniformInfo.ringBuffer
+  std::shared_ptr<igl::IBuffer> ringBuffer_;
 #if IGL_PLATFORM_IOS_SIMULATOR
   /// If we're in the simulator we need to hold onto length so we can deallocate memory buffer
   /// properly.
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "MeshletBuilder.h"
+
+#include <meshoptimizer.h>
+
+namespace iglu {
+namespace meshlet {
+
+MeshletMesh buildMeshlets(const float* positions,
+                          size_t positionStride,
+                          size_t numVertices,
+                          const uint32_t* indices,
+                          size_t numIndices,
+                          const MeshletBuilderDesc& desc) {
+  MeshletMesh mesh;
+  if (!positions || !indices || numVertices == 0 || numIndices < 3) {
+    return mesh;
+  }
+
+  const size_t maxMeshlets =
+      meshopt_buildMeshletsBound(numIndices, desc.maxVertices, desc.maxTriangles);
+  std::vector<meshopt_Meshlet> meshlets(maxMeshlets);
+  mesh.meshletVertices.resize(maxMeshlets * desc.maxVertices);
+  mesh.meshletTriangles.resize(maxMeshlets * desc.maxTriangles * 3);
+  meshlets.resize(meshopt_buildMeshlets(meshlets.data(),
+                                        mesh.meshletVertices.data(),
+                                        mesh.meshletTriangles.data(),
+                                        indices,
+                                        numIndices,
+                                        positions,
+                                        numVertices,
+                                        positionStride,
+                                        desc.maxVertices,
+                                        desc.maxTriangles,
+                                        desc.coneWeight));
+  if (meshlets.empty()) {
+    mesh.meshletVertices.clear();
+    mesh.meshletTriangles.clear();
+    return mesh;
+  }
+
+  // trims the worst case allocations; triangles of a meshlet are padded to 4 bytes
+  const meshopt_Meshlet& last = meshlets.back();
+  mesh.meshletVertices.resize(last.vertex_offset + last.vertex_count);
+  mesh.meshletTriangles.resize(last.triangle_offset + ((last.triangle_count * 3 + 3) & ~3u));
+
+  mesh.meshlets.reserve(meshlets.size());
+  mesh.cullData.reserve(meshlets.size());
+  mesh.indices.reserve(numIndices);
+  for (const meshopt_Meshlet& m : meshlets) {
+    const uint32_t* meshletVertices = &mesh.meshletVertices[m.vertex_offset];
+    const uint8_t* meshletTriangles = &mesh.meshletTriangles[m.triangle_offset];
+
+    mesh.meshlets.push_back({m.vertex_offset, m.triangle_offset, m.vertex_count, m.triangle_count});
+
+    const meshopt_Bounds bounds = meshopt_computeMeshletBounds(meshletVertices,
+                                                               meshletTriangles,
+                                                               m.triangle_count,
+                                                               positions,
+                                                               numVertices,
+                                                               positionStride);
+    MeshletCullData cullData = {};
+    cullData.sphere[0] = bounds.center[0];
+    cullData.sphere[1] = bounds.center[1];
+    cullData.sphere[2] = bounds.center[2];
+    cullData.sphere[3] = bounds.radius;
+    cullData.cone[0] = bounds.cone_axis[0];
+    cullData.cone[1] = bounds.cone_axis[1];
+    cullData.cone[2] = bounds.cone_axis[2];
+    cullData.cone[3] = bounds.cone_cutoff;
+    cullData.firstIndex = static_cast<uint32_t>(mesh.indices.size());
+    cullData.indexCount = m.triangle_count * 3;
+    mesh.cullData.push_back(cullData);
+
+    for (size_t i = 0; i != m.triangle_count * 3; ++i) {
+      mesh.indices.push_back(meshletVertices[meshletTriangles[i]]);
+    }
+  }
+
+  return mesh;
+}
+
+} // namespace meshlet
+} // namespace iglu
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace iglu {
+namespace meshlet {
+
+/// Per-meshlet data read by the culling shader, see MeshletCuller. Matches the std430 layout.
+struct MeshletCullData {
+  /// Bounding sphere: xyz center, w radius
+  float sphere[4];
+  /// Normal cone: xyz axis, w cutoff. Backfacing when
+  /// dot(center - camera, axis) >= cutoff * length(center - camera) + radius
+  float cone[4];
+  /// Range of the meshlet triangles in MeshletMesh::indices
+  uint32_t firstIndex;
+  uint32_t indexCount;
+  uint32_t padding[2];
+};
+
+/// A range of MeshletMesh::meshletVertices and MeshletMesh::meshletTriangles, in the layout
+/// consumed by mesh shaders
+struct Meshlet {
+  uint32_t vertexOffset;
+  uint32_t triangleOffset;
+  uint32_t vertexCount;
+  uint32_t triangleCount;
+};
+
+struct MeshletMesh {
+  std::vector<Meshlet> meshlets;
+  /// Indices into the source vertices, 'vertexCount' per meshlet
+  std::vector<uint32_t> meshletVertices;
+  /// Local vertex indices, 3 per triangle
+  std::vector<uint8_t> meshletTriangles;
+  /// One per meshlet
+  std::vector<MeshletCullData> cullData;
+  /// The triangles of all the meshlets in order, indexing the source vertices. Used to draw the
+  /// meshlets with indexed indirect draws.
+  std::vector<uint32_t> indices;
+};
+
+struct MeshletBuilderDesc {
+  size_t maxVertices = 64;
+  /// Must be divisible by 4
+  size_t maxTriangles = 124;
+  /// Trades spatially compact meshlets for tighter normal cones, between 0 and 1
+  float coneWeight = 0.25f;
+};
+
+/// Splits an indexed triangle list into meshlets with meshoptimizer and computes their bounds.
+/// @param positions xyz positions of the vertices
+/// @param positionStride Distance in bytes between two positions
+MeshletMesh buildMeshlets(const float* positions,
+                          size_t positionStride,
+                          size_t numVertices,
+                          const uint32_t* indices,
+                          size_t numIndices,
+                          const MeshletBuilderDesc& desc = {});
+
+} // namespace meshlet
+} // namespace iglu
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "MeshletCuller.h"
+
+#include <utility>
+
+namespace iglu {
+namespace meshlet {
+
+namespace {
+
+constexpr uint32_t kThreadgroupSize = 64;
+
+struct PushConstants {
+  MeshletCuller::Params params;
+  uint32_t numMeshlets = 0;
+  uint32_t padding[3] = {};
+};
+// the minimum push constants size guaranteed by Vulkan
+static_assert(sizeof(PushConstants) == 128, "PushConstants must fit 128 bytes");
+static_assert(sizeof(MeshletCullData) == 48, "MeshletCullData must match the shaders");
+
+// buffers are accessed through buffer device addresses, see igl::vulkan::Device
+const char kVulkanShader[] = R"(
+layout (local_size_x = 64) in;
+
+struct Meshlet {
+  vec4 sphere;
+  vec4 cone;
+  uvec4 draw;
+};
+
+struct DrawCommand {
+  uint indexCount;
+  uint instanceCount;
+  uint firstIndex;
+  int vertexOffset;
+  uint firstInstance;
+};
+
+layout (std430, buffer_reference) readonly buffer Meshlets {
+  Meshlet meshlets[];
+};
+
+layout (std430, buffer_reference) writeonly buffer DrawCommands {
+  DrawCommand commands[];
+};
+
+layout (push_constant) uniform PushConstants {
+  vec4 frustumPlanes[6];
+  vec4 cameraPosition;
+  uint numMeshlets;
+} pc;
+
+bool isVisible(Meshlet m) {
+  for (int i = 0; i != 6; i++) {
+    if (dot(pc.frustumPlanes[i].xyz, m.sphere.xyz) + pc.frustumPlanes[i].w < -m.sphere.w) {
+      return false;
+    }
+  }
+  vec3 v = m.sphere.xyz - pc.cameraPosition.xyz;
+  return dot(v, m.cone.xyz) < m.cone.w * length(v) + m.sphere.w;
+}
+
+void main() {
+  uint i = gl_GlobalInvocationID.x;
+  if (i >= pc.numMeshlets) {
+    return;
+  }
+  Meshlet m = Meshlets(getBuffer(0)).meshlets[i];
+  DrawCommands(getBuffer(1)).commands[i] =
+      DrawCommand(m.draw.y, isVisible(m) ? 1u : 0u, m.draw.x, 0, 0u);
+}
+)";
+
+const char kMetalShader[] = R"(
+using namespace metal;
+
+struct Meshlet {
+  float4 sphere;
+  float4 cone;
+  uint4 draw;
+};
+
+// MTLDrawIndexedPrimitivesIndirectArguments
+struct DrawCommand {
+  uint indexCount;
+  uint instanceCount;
+  uint indexStart;
+  int baseVertex;
+  uint baseInstance;
+};
+
+struct PushConstants {
+  float4 frustumPlanes[6];
+  float4 cameraPosition;
+  uint numMeshlets;
+};
+
+static bool isVisible(Meshlet m, constant PushConstants& pc) {
+  for (int i = 0; i != 6; i++) {
+    if (dot(pc.frustumPlanes[i].xyz, m.sphere.xyz) + pc.frustumPlanes[i].w < -m.sphere.w) {
+      return false;
+    }
+  }
+  float3 v = m.sphere.xyz - pc.cameraPosition.xyz;
+  return dot(v, m.cone.xyz) < m.cone.w * length(v) + m.sphere.w;
+}
+
+kernel void cullMeshlets(device const Meshlet* meshlets [[buffer(0)]],
+                         device DrawCommand* commands [[buffer(1)]],
+                         constant PushConstants& pc [[buffer(2)]],
+                         uint i [[thread_position_in_grid]]) {
+  if (i >= pc.numMeshlets) {
+    return;
+  }
+  Meshlet m = meshlets[i];
+  commands[i] = DrawCommand{m.draw.y, isVisible(m, pc) ? 1u : 0u, m.draw.x, 0, 0u};
+}
+)";
+
+} // namespace
+
+bool MeshletCuller::isSupported(const igl::IDevice& device) {
+  const igl::BackendType backend = device.getBackendType();
+  return (backend == igl::BackendType::Vulkan || backend == igl::BackendType::Metal) &&
+         device.hasFeature(igl::DeviceFeatures::Compute) &&
+         device.hasFeature(igl::DeviceFeatures::DrawIndexedIndirect);
+}
+
+MeshletCuller::MeshletCuller(igl::IDevice& device,
+                             const MeshletMesh& mesh,
+                             igl::Result* outResult) :
+  backendType_(device.getBackendType()) {
+  if (!isSupported(device)) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::Unsupported, "Meshlet culling is not supported");
+    return;
+  }
+  if (mesh.cullData.empty()) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "No meshlets");
+    return;
+  }
+
+  igl::Result ret;
+  cullDataBuffer_ = device.createBuffer(
+      igl::BufferDesc(igl::BufferDesc::BufferTypeBits::Storage,
+                      mesh.cullData.data(),
+                      mesh.cullData.size() * sizeof(MeshletCullData)),
+      &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+  drawCommandBuffer_ = device.createBuffer(
+      igl::BufferDesc(igl::BufferDesc::BufferTypeBits::Storage |
+                          igl::BufferDesc::BufferTypeBits::Indirect,
+                      nullptr,
+                      mesh.cullData.size() * igl::IGL_DRAW_ELEMENTS_INDIRECT_COMMAND_SIZE,
+                      igl::ResourceStorage::Private,
+                      0,
+                      "Buffer: meshlet draw commands"),
+      &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+  indexBuffer_ = device.createBuffer(igl::BufferDesc(igl::BufferDesc::BufferTypeBits::Index,
+                                                     mesh.indices.data(),
+                                                     mesh.indices.size() * sizeof(uint32_t)),
+                                     &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+
+  igl::ComputePipelineDesc desc;
+  const bool isMetal = backendType_ == igl::BackendType::Metal;
+  desc.shaderStages =
+      igl::ShaderStagesCreator::fromModuleStringInput(device,
+                                                      isMetal ? kMetalShader : kVulkanShader,
+                                                      isMetal ? "cullMeshlets" : "main",
+                                                      "Shader Module: meshlet culling",
+                                                      &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+  desc.debugName = "Pipeline: meshlet culling";
+  pipelineState_ = device.createComputePipeline(desc, &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+
+  numMeshlets_ = static_cast<uint32_t>(mesh.cullData.size());
+  igl::Result::setOk(outResult);
+}
+
+void MeshletCuller::cull(igl::ICommandBuffer& commandBuffer, const Params& params) {
+  if (!pipelineState_) {
+    return;
+  }
+
+  PushConstants pushConstants;
+  pushConstants.params = params;
+  pushConstants.numMeshlets = numMeshlets_;
+
+  auto encoder = commandBuffer.createComputeCommandEncoder();
+  encoder->bindComputePipelineState(pipelineState_);
+  encoder->bindBuffer(0, cullDataBuffer_, 0);
+  encoder->bindBuffer(1, drawCommandBuffer_, 0);
+  if (backendType_ == igl::BackendType::Vulkan) {
+    encoder->bindPushConstants(0, &pushConstants, sizeof(pushConstants));
+  } else {
+    encoder->bindBytes(2, &pushConstants, sizeof(pushConstants));
+  }
+  encoder->dispatchThreadGroups(
+      igl::Dimensions((numMeshlets_ + kThreadgroupSize - 1) / kThreadgroupSize, 1, 1),
+      igl::Dimensions(kThreadgroupSize, 1, 1));
+  encoder->endEncoding();
+}
+
+void MeshletCuller::draw(igl::IRenderCommandEncoder& commandEncoder) {
+  if (!pipelineState_) {
+    return;
+  }
+  commandEncoder.multiDrawIndexedIndirect(igl::PrimitiveType::Triangle,
+                                          igl::IndexFormat::UInt32,
+                                          *indexBuffer_,
+                                          *drawCommandBuffer_,
+                                          0,
+                                          numMeshlets_,
+                                          igl::IGL_DRAW_ELEMENTS_INDIRECT_COMMAND_SIZE);
+}
+
+} // namespace meshlet
+} // namespace iglu
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/meshlet/MeshletBuilder.h>
+#include <igl/IGL.h>
+#include <memory>
+
+namespace iglu {
+namespace meshlet {
+
+/// GPU culling of the meshlets of a mesh. A compute shader tests every meshlet against the view
+/// frustum and its normal cone, and writes one indexed indirect draw command per meshlet, with
+/// no instance when the meshlet is culled. draw() then issues all the commands at once.
+///
+/// Supported on Vulkan and Metal, see isSupported(). Vertices are not owned: the render pipeline
+/// and the vertex buffer of the source vertices are bound by the caller before draw().
+class MeshletCuller final {
+ public:
+  /// Both in the model space of the mesh
+  struct Params {
+    /// xyz: inward facing normal, w: distance
+    float frustumPlanes[6][4] = {};
+    /// xyz, w unused
+    float cameraPosition[4] = {};
+  };
+
+  static bool isSupported(const igl::IDevice& device);
+
+  MeshletCuller(igl::IDevice& device, const MeshletMesh& mesh, igl::Result* outResult = nullptr);
+  ~MeshletCuller() = default;
+
+  /// Encodes the culling pass. Must be called outside of a render pass, in the command buffer of
+  /// draw() or in one submitted before it. The draw commands of the previous frame are
+  /// overwritten: wait for it before culling again, e.g. with one culler per frame in flight.
+  void cull(igl::ICommandBuffer& commandBuffer, const Params& params);
+
+  /// Draws the meshlets which passed the last cull()
+  void draw(igl::IRenderCommandEncoder& commandEncoder);
+
+  uint32_t numMeshlets() const {
+    return numMeshlets_;
+  }
+
+ private:
+  igl::BackendType backendType_;
+  uint32_t numMeshlets_ = 0;
+  std::shared_ptr<igl::IBuffer> cullDataBuffer_;
+  std::shared_ptr<igl::IBuffer> drawCommandBuffer_;
+  std::shared_ptr<igl::IBuffer> indexBuffer_;
+  std::shared_ptr<igl::IComputePipelineState> pipelineState_;
+};
+
+} // namespace meshlet
+} // namespace iglu
@@ -0,0 +1,457 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "DepthPyramid.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace iglu {
+namespace occlusion {
+
+namespace {
+
+constexpr uint32_t kThreadgroupSize = 8;
+
+struct PushConstants {
+  // width, height, offset, 1 to read the depth copy instead of the buffer
+  uint32_t src[4] = {};
+  // width, height, offset
+  uint32_t dst[4] = {};
+};
+
+const char kVulkanCopyVertexShader[] = R"(
+void main() {
+  vec2 uv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+  gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+const char kVulkanCopyFragmentShader[] = R"(
+layout (location = 0) out float outDepth;
+
+void main() {
+  uint idxTex = bindings.slots[0].x;
+  uint idxSmp = bindings.slots[0].y;
+  outDepth = texelFetch(sampler2D(kTextures2D[idxTex], kSamplers[idxSmp]),
+                        ivec2(gl_FragCoord.xy), 0).r;
+}
+)";
+
+// the pyramid is accessed through a buffer device address, see igl::vulkan::Device
+const char kVulkanReduceShader[] = R"(
+layout (local_size_x = 8, local_size_y = 8) in;
+
+// kBinding_StorageImages in igl/vulkan/VulkanContext.cpp
+layout (set = 0, binding = 6, r32f) uniform readonly image2D kImages2D[];
+
+layout (std430, buffer_reference) buffer Texels {
+  vec2 texels[];
+};
+
+layout (push_constant) uniform PushConstants {
+  uvec4 src;
+  uvec4 dst;
+} pc;
+
+vec2 load(uvec2 p) {
+  if (pc.src.w != 0u) {
+    return vec2(imageLoad(kImages2D[bindings.slots[0].x], ivec2(p)).r);
+  }
+  return Texels(getBuffer(0)).texels[pc.src.z + p.y * pc.src.x + p.x];
+}
+
+void main() {
+  uvec2 p = gl_GlobalInvocationID.xy;
+  if (p.x >= pc.dst.x || p.y >= pc.dst.y) {
+    return;
+  }
+  uvec2 first = 2u * p;
+  // the last column and row also cover the remaining texels of odd sizes
+  uvec2 last = min(first + 1u, pc.src.xy - 1u);
+  if (p.x == pc.dst.x - 1u) {
+    last.x = pc.src.x - 1u;
+  }
+  if (p.y == pc.dst.y - 1u) {
+    last.y = pc.src.y - 1u;
+  }
+  vec2 r = load(first);
+  for (uint y = first.y; y <= last.y; y++) {
+    for (uint x = first.x; x <= last.x; x++) {
+      vec2 v = load(uvec2(x, y));
+      r = vec2(min(r.x, v.x), max(r.y, v.y));
+    }
+  }
+  Texels(getBuffer(0)).texels[pc.dst.z + p.y * pc.dst.x + p.x] = r;
+}
+)";
+
+const char kMetalCopyShader[] = R"(
+using namespace metal;
+
+vertex float4 copyVertex(uint vid [[vertex_id]]) {
+  float2 uv = float2((vid << 1) & 2, vid & 2);
+  return float4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
+
+fragment float copyFragment(float4 position [[position]],
+                            depth2d<float, access::read> depthTexture [[texture(0)]]) {
+  return depthTexture.read(uint2(position.xy));
+}
+)";
+
+const char kMetalReduceShader[] = R"(
+using namespace metal;
+
+struct PushConstants {
+  uint4 src;
+  uint4 dst;
+};
+
+static float2 load(texture2d<float, access::read> depthCopy,
+                   device const float2* texels,
+                   constant PushConstants& pc,
+                   uint2 p) {
+  if (pc.src.w != 0) {
+    return float2(depthCopy.read(p).r);
+  }
+  return texels[pc.src.z + p.y * pc.src.x + p.x];
+}
+
+kernel void reduceDepth(texture2d<float, access::read> depthCopy [[texture(0)]],
+                        device float2* texels [[buffer(0)]],
+                        constant PushConstants& pc [[buffer(1)]],
+                        uint2 p [[thread_position_in_grid]]) {
+  if (p.x >= pc.dst.x || p.y >= pc.dst.y) {
+    return;
+  }
+  uint2 first = 2 * p;
+  // the last column and row also cover the remaining texels of odd sizes
+  uint2 last = min(first + 1, pc.src.xy - 1);
+  if (p.x == pc.dst.x - 1) {
+    last.x = pc.src.x - 1;
+  }
+  if (p.y == pc.dst.y - 1) {
+    last.y = pc.src.y - 1;
+  }
+  float2 r = load(depthCopy, texels, pc, first);
+  for (uint y = first.y; y <= last.y; y++) {
+    for (uint x = first.x; x <= last.x; x++) {
+      float2 v = load(depthCopy, texels, pc, uint2(x, y));
+      r = float2(min(r.x, v.x), max(r.y, v.y));
+    }
+  }
+  texels[pc.dst.z + p.y * pc.dst.x + p.x] = r;
+}
+)";
+
+const char kOpenGLCopyVertexShader[] = R"(
+void main() {
+  vec2 uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+  gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+const char kOpenGLCopyFragmentShader[] = R"(
+uniform highp sampler2D depthTexture;
+
+layout (location = 0) out float outDepth;
+
+void main() {
+  outDepth = texelFetch(depthTexture, ivec2(gl_FragCoord.xy), 0).r;
+}
+)";
+
+const char kOpenGLReduceShader[] = R"(
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (binding = 0, r32f) uniform readonly highp image2D depthCopy;
+
+layout (std430, binding = 0) buffer Pyramid {
+  vec2 texels[];
+};
+
+layout (std140) uniform IGLPushConstants {
+  uvec4 src;
+  uvec4 dst;
+} pc;
+
+vec2 load(uvec2 p) {
+  if (pc.src.w != 0u) {
+    return vec2(imageLoad(depthCopy, ivec2(p)).r);
+  }
+  return texels[pc.src.z + p.y * pc.src.x + p.x];
+}
+
+void main() {
+  uvec2 p = gl_GlobalInvocationID.xy;
+  if (p.x >= pc.dst.x || p.y >= pc.dst.y) {
+    return;
+  }
+  uvec2 first = 2u * p;
+  // the last column and row also cover the remaining texels of odd sizes
+  uvec2 last = min(first + 1u, pc.src.xy - 1u);
+  if (p.x == pc.dst.x - 1u) {
+    last.x = pc.src.x - 1u;
+  }
+  if (p.y == pc.dst.y - 1u) {
+    last.y = pc.src.y - 1u;
+  }
+  vec2 r = load(first);
+  for (uint y = first.y; y <= last.y; y++) {
+    for (uint x = first.x; x <= last.x; x++) {
+      vec2 v = load(uvec2(x, y));
+      r = vec2(min(r.x, v.x), max(r.y, v.y));
+    }
+  }
+  texels[pc.dst.z + p.y * pc.dst.x + p.x] = r;
+}
+)";
+
+// compute shaders need OpenGL 4.3 or OpenGL ES 3.1
+std::string getOpenGLPrologue(igl::ShaderVersion shaderVersion) {
+  return std::string(shaderVersion.family == igl::ShaderFamily::GlslEs ? "#version 310 es\n"
+                                                                       : "#version 430\n") +
+         "precision highp float;\nprecision highp int;\n";
+}
+
+std::unique_ptr<igl::IShaderStages> createCopyShaderStages(igl::IDevice& device,
+                                                           igl::Result* IGL_NULLABLE outResult) {
+  switch (device.getBackendType()) {
+  case igl::BackendType::Vulkan:
+    return igl::ShaderStagesCreator::fromModuleStringInput(device,
+                                                           kVulkanCopyVertexShader,
+                                                           "main",
+                                                           "Shader Module: depth copy (vert)",
+                                                           kVulkanCopyFragmentShader,
+                                                           "main",
+                                                           "Shader Module: depth copy (frag)",
+                                                           outResult);
+  case igl::BackendType::Metal:
+    return igl::ShaderStagesCreator::fromLibraryStringInput(device,
+                                                            kMetalCopyShader,
+                                                            "copyVertex",
+                                                            "copyFragment",
+                                                            "Shader Library: depth copy",
+                                                            outResult);
+  case igl::BackendType::OpenGL: {
+    const std::string prologue = getOpenGLPrologue(device.getShaderVersion());
+    const std::string vertexShader = prologue + kOpenGLCopyVertexShader;
+    const std::string fragmentShader = prologue + kOpenGLCopyFragmentShader;
+    return igl::ShaderStagesCreator::fromModuleStringInput(device,
+                                                           vertexShader.c_str(),
+                                                           "main",
+                                                           "Shader Module: depth copy (vert)",
+                                                           fragmentShader.c_str(),
+                                                           "main",
+                                                           "Shader Module: depth copy (frag)",
+                                                           outResult);
+  }
+  default:
+    igl::Result::setResult(
+        outResult, igl::Result::Code::Unsupported, "Depth pyramids are not supported");
+    return nullptr;
+  }
+}
+
+std::unique_ptr<igl::IShaderStages> createReduceShaderStages(igl::IDevice& device,
+                                                             igl::Result* IGL_NULLABLE outResult) {
+  switch (device.getBackendType()) {
+  case igl::BackendType::Vulkan:
+    return igl::ShaderStagesCreator::fromModuleStringInput(
+        device, kVulkanReduceShader, "main", "Shader Module: depth reduction", outResult);
+  case igl::BackendType::Metal:
+    return igl::ShaderStagesCreator::fromModuleStringInput(
+        device, kMetalReduceShader, "reduceDepth", "Shader Module: depth reduction", outResult);
+  case igl::BackendType::OpenGL: {
+    const std::string shader = getOpenGLPrologue(device.getShaderVersion()) + kOpenGLReduceShader;
+    return igl::ShaderStagesCreator::fromModuleStringInput(
+        device, shader.c_str(), "main", "Shader Module: depth reduction", outResult);
+  }
+  default:
+    igl::Result::setResult(
+        outResult, igl::Result::Code::Unsupported, "Depth pyramids are not supported");
+    return nullptr;
+  }
+}
+
+} // namespace
+
+bool DepthPyramid::isSupported(const igl::IDevice& device) {
+  const igl::BackendType backend = device.getBackendType();
+  if (backend != igl::BackendType::Vulkan && backend != igl::BackendType::Metal &&
+      backend != igl::BackendType::OpenGL) {
+    return false;
+  }
+  const auto capabilities = device.getTextureFormatCapabilities(igl::TextureFormat::R_F32);
+  return device.hasFeature(igl::DeviceFeatures::Compute) &&
+         (capabilities & igl::ICapabilities::TextureFormatCapabilityBits::Storage) != 0 &&
+         (capabilities & igl::ICapabilities::TextureFormatCapabilityBits::Attachment) != 0;
+}
+
+std::vector<DepthPyramid::Level> DepthPyramid::computeLevels(uint32_t width, uint32_t height) {
+  std::vector<Level> levels;
+  uint32_t offset = 0;
+  while (width > 1 || height > 1) {
+    width = std::max(width >> 1, 1u);
+    height = std::max(height >> 1, 1u);
+    levels.push_back({width, height, offset});
+    offset += width * height;
+  }
+  return levels;
+}
+
+DepthPyramid::DepthPyramid(igl::IDevice& device,
+                           uint32_t width,
+                           uint32_t height,
+                           igl::Result* IGL_NULLABLE outResult) :
+  backendType_(device.getBackendType()),
+  width_(width),
+  height_(height),
+  levels_(computeLevels(width, height)) {
+  if (!isSupported(device)) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::Unsupported, "Depth pyramids are not supported");
+    return;
+  }
+  if (levels_.empty()) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "The depth buffer is too small");
+    return;
+  }
+
+  igl::Result ret;
+  const Level& lastLevel = levels_.back();
+  buffer_ = device.createBuffer(
+      igl::BufferDesc(igl::BufferDesc::BufferTypeBits::Storage,
+                      nullptr,
+                      size_t(lastLevel.offset + lastLevel.width * lastLevel.height) *
+                          2 * sizeof(float),
+                      igl::ResourceStorage::Private,
+                      0,
+                      "Buffer: depth pyramid"),
+      &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+
+  depthCopy_ = device.createTexture(
+      igl::TextureDesc::new2D(igl::TextureFormat::R_F32,
+                              width,
+                              height,
+                              igl::TextureDesc::TextureUsageBits::Attachment |
+                                  igl::TextureDesc::TextureUsageBits::Storage,
+                              "Texture: depth pyramid copy"),
+      &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+  igl::FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = depthCopy_;
+  framebufferDesc.debugName = "Framebuffer: depth pyramid copy";
+  framebuffer_ = device.createFramebuffer(framebufferDesc, &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+
+  igl::RenderPipelineDesc copyDesc;
+  copyDesc.shaderStages = createCopyShaderStages(device, &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+  copyDesc.targetDesc.colorAttachments.resize(1);
+  copyDesc.targetDesc.colorAttachments[0].textureFormat = igl::TextureFormat::R_F32;
+  copyDesc.cullMode = igl::CullMode::Disabled;
+  copyDesc.fragmentUnitSamplerMap[0] = IGL_NAMEHANDLE("depthTexture");
+  copyDesc.debugName = IGL_NAMEHANDLE("Pipeline: depth pyramid copy");
+  copyPipelineState_ = device.createRenderPipeline(copyDesc, &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+
+  // texelFetch() ignores the filters, the default ones are nearest
+  samplerState_ = device.createSamplerState(igl::SamplerStateDesc(), &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+
+  igl::ComputePipelineDesc reduceDesc;
+  reduceDesc.shaderStages = createReduceShaderStages(device, &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+  reduceDesc.imagesMap[0] = IGL_NAMEHANDLE("depthCopy");
+  reduceDesc.buffersMap[0] = IGL_NAMEHANDLE("Pyramid");
+  reduceDesc.debugName = "Pipeline: depth reduction";
+  reducePipelineState_ = device.createComputePipeline(reduceDesc, &ret);
+  igl::Result::setResult(outResult, std::move(ret));
+}
+
+void DepthPyramid::build(igl::ICommandBuffer& commandBuffer, igl::ITexture& depthTexture) {
+  if (!reducePipelineState_) {
+    return;
+  }
+  IGL_ASSERT(depthTexture.getDimensions().width == width_ &&
+             depthTexture.getDimensions().height == height_);
+
+  // the copy reads the depth of the pixel it writes, so it does not depend on the conventions of
+  // the backend for texture coordinates
+  igl::RenderPassDesc renderPass;
+  renderPass.colorAttachments.resize(1);
+  renderPass.colorAttachments[0].loadAction = igl::LoadAction::DontCare;
+  renderPass.colorAttachments[0].storeAction = igl::StoreAction::Store;
+  {
+    auto encoder = commandBuffer.createRenderCommandEncoder(renderPass, framebuffer_);
+    encoder->bindViewport({0.0f, 0.0f, float(width_), float(height_), 0.0f, 1.0f});
+    encoder->bindRenderPipelineState(copyPipelineState_);
+    encoder->bindTexture(0, igl::BindTarget::kFragment, &depthTexture);
+    encoder->bindSamplerState(0, igl::BindTarget::kFragment, samplerState_);
+    encoder->draw(igl::PrimitiveType::Triangle, 0, 3);
+    encoder->endEncoding();
+  }
+
+  auto encoder = commandBuffer.createComputeCommandEncoder();
+  encoder->bindComputePipelineState(reducePipelineState_);
+  encoder->bindTexture(0, depthCopy_.get());
+  encoder->bindBuffer(0, buffer_, 0);
+  // one dispatch per level, each one reading the previous level
+  PushConstants pushConstants;
+  pushConstants.src[0] = width_;
+  pushConstants.src[1] = height_;
+  pushConstants.src[3] = 1;
+  for (const Level& level : levels_) {
+    pushConstants.dst[0] = level.width;
+    pushConstants.dst[1] = level.height;
+    pushConstants.dst[2] = level.offset;
+    if (backendType_ == igl::BackendType::Metal) {
+      encoder->bindBytes(1, &pushConstants, sizeof(pushConstants));
+    } else {
+      encoder->bindPushConstants(0, &pushConstants, sizeof(pushConstants));
+    }
+    encoder->dispatchThreadGroups(
+        igl::Dimensions((level.width + kThreadgroupSize - 1) / kThreadgroupSize,
+                        (level.height + kThreadgroupSize - 1) / kThreadgroupSize,
+                        1),
+        igl::Dimensions(kThreadgroupSize, kThreadgroupSize, 1));
+    pushConstants.src[0] = level.width;
+    pushConstants.src[1] = level.height;
+    pushConstants.src[2] = level.offset;
+    pushConstants.src[3] = 0;
+  }
+  encoder->endEncoding();
+}
+
+} // namespace occlusion
+} // namespace iglu
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/IGL.h>
+#include <memory>
+#include <vector>
+
+namespace iglu {
+namespace occlusion {
+
+/**
+ * @brief Hierarchical-Z pyramid of a depth buffer, for occlusion culling on the GPU.
+ *
+ * Every texel of a level holds the minimum and the maximum depth of the 2x2 texels it covers in
+ * the previous level, the first level halving the depth buffer itself. When a size is odd, the last
+ * column or row of the next level also covers the remaining texels, so that every level covers the
+ * whole depth buffer.
+ *
+ * The levels are stored one after another in a storage buffer of `float2` texels rather than in
+ * the mip levels of a texture: compute shaders can only write the first mip level of a texture on
+ * OpenGL, which has no texture views. Depth textures cannot be bound to compute shaders on most
+ * Vulkan devices either, so build() first copies the depth into a color texture with a fullscreen
+ * draw, then reduces it with one dispatch per level.
+ *
+ * Supported on Vulkan, Metal, and OpenGL 4.3 / OpenGL ES 3.1, see isSupported().
+ */
+class DepthPyramid final {
+ public:
+  struct Level {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    /// In texels from the start of the buffer
+    uint32_t offset = 0;
+  };
+
+  static bool isSupported(const igl::IDevice& device);
+
+  /// The levels of the pyramid of a `width` x `height` depth buffer, down to 1x1
+  static std::vector<Level> computeLevels(uint32_t width, uint32_t height);
+
+  DepthPyramid(igl::IDevice& device,
+               uint32_t width,
+               uint32_t height,
+               igl::Result* IGL_NULLABLE outResult = nullptr);
+  ~DepthPyramid() = default;
+
+  /// Encodes the construction of the pyramid from `depthTexture`, which must have the size given
+  /// to the constructor and be created with TextureUsageBits::Sampled. Must be called outside of a
+  /// render pass, in the command buffer of the culling or in one submitted before it.
+  void build(igl::ICommandBuffer& commandBuffer, igl::ITexture& depthTexture);
+
+  [[nodiscard]] uint32_t getWidth() const {
+    return width_;
+  }
+
+  [[nodiscard]] uint32_t getHeight() const {
+    return height_;
+  }
+
+  [[nodiscard]] const std::vector<Level>& getLevels() const {
+    return levels_;
+  }
+
+  /// Storage buffer of `float2` texels: x is the minimum depth and y the maximum depth
+  [[nodiscard]] const std::shared_ptr<igl::IBuffer>& getBuffer() const {
+    return buffer_;
+  }
+
+ private:
+  igl::BackendType backendType_;
+  uint32_t width_ = 0;
+  uint32_t height_ = 0;
+  std::vector<Level> levels_;
+  std::shared_ptr<igl::IBuffer> buffer_;
+  std::shared_ptr<igl::ITexture> depthCopy_;
+  std::shared_ptr<igl::IFramebuffer> framebuffer_;
+  std::shared_ptr<igl::IRenderPipelineState> copyPipelineState_;
+  std::shared_ptr<igl::ISamplerState> samplerState_;
+  std::shared_ptr<igl::IComputePipelineState> reducePipelineState_;
+};
+
+} // namespace occlusion
+} // namespace iglu
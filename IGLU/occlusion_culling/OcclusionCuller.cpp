@@ -0,0 +1,605 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "OcclusionCuller.h"
+
+#include <cstring>
+#include <utility>
+
+namespace iglu {
+namespace occlusion {
+
+namespace {
+
+constexpr uint32_t kThreadgroupSize = 64;
+
+// flags of the shaders
+constexpr uint32_t kFlagReverseZ = 1;
+// OpenGL clip space, z in [-w, w]
+constexpr uint32_t kFlagDepthMinusOneToOne = 2;
+// the first row of the pyramid is the top of the screen
+constexpr uint32_t kFlagFlipY = 4;
+constexpr uint32_t kFlagCompacted = 8;
+
+struct Info {
+  // numInstances, numLevels, pyramid width, pyramid height
+  uint32_t sizes[4] = {};
+  // kFlag*, unused, unused, unused
+  uint32_t flags[4] = {};
+};
+
+struct PushConstants {
+  float viewProj[16] = {};
+  float depthViewProj[16] = {};
+};
+// the minimum push constants size guaranteed by Vulkan
+static_assert(sizeof(PushConstants) == 128, "PushConstants must fit 128 bytes");
+static_assert(sizeof(OcclusionInstance) == 32, "OcclusionInstance must match the shaders");
+
+// shared by the Vulkan and OpenGL shaders, which declare `pc` and loadTexel() before it
+const char kGlslCulling[] = R"(
+const uint kReverseZ = 1u;
+const uint kDepthMinusOneToOne = 2u;
+const uint kFlipY = 4u;
+const uint kCompacted = 8u;
+
+struct Instance {
+  vec4 sphere;
+  // indexCount, firstIndex, baseVertex, baseInstance
+  uvec4 draw;
+};
+
+struct DrawCommand {
+  uint indexCount;
+  uint instanceCount;
+  uint firstIndex;
+  int vertexOffset;
+  uint firstInstance;
+};
+
+// a corner of the bounding box of the sphere in clip space
+vec4 getCorner(mat4 m, vec4 sphere, int i) {
+  vec3 s = vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);
+  return m * vec4(sphere.xyz + s * sphere.w, 1.0);
+}
+
+// all the corners are outside of the same clip plane
+bool isOutsideFrustum(vec4 sphere, uint flags) {
+  bool minusOneToOne = (flags & kDepthMinusOneToOne) != 0u;
+  uint outside = 63u;
+  for (int i = 0; i != 8; i++) {
+    vec4 c = getCorner(pc.viewProj, sphere, i);
+    uint planes = 0u;
+    planes |= c.x < -c.w ? 1u : 0u;
+    planes |= c.x > c.w ? 2u : 0u;
+    planes |= c.y < -c.w ? 4u : 0u;
+    planes |= c.y > c.w ? 8u : 0u;
+    planes |= c.z < (minusOneToOne ? -c.w : 0.0) ? 16u : 0u;
+    planes |= c.z > c.w ? 32u : 0u;
+    outside &= planes;
+  }
+  return outside != 0u;
+}
+
+bool isOccluded(vec4 sphere, uvec4 sizes, uint flags) {
+  vec2 uvMin = vec2(1.0);
+  vec2 uvMax = vec2(0.0);
+  float zMin = 1.0;
+  float zMax = 0.0;
+  for (int i = 0; i != 8; i++) {
+    vec4 c = getCorner(pc.depthViewProj, sphere, i);
+    // behind the camera of the pyramid, or no occlusion test at all with a zero matrix
+    if (c.w <= 0.0) {
+      return false;
+    }
+    vec3 ndc = c.xyz / c.w;
+    float depth = (flags & kDepthMinusOneToOne) != 0u ? ndc.z * 0.5 + 0.5 : ndc.z;
+    vec2 uv = ndc.xy * 0.5 + 0.5;
+    if ((flags & kFlipY) != 0u) {
+      uv.y = 1.0 - uv.y;
+    }
+    uvMin = min(uvMin, uv);
+    uvMax = max(uvMax, uv);
+    zMin = min(zMin, depth);
+    zMax = max(zMax, depth);
+  }
+  // nothing is known of what was off screen
+  if (any(lessThan(uvMin, vec2(0.0))) || any(greaterThan(uvMax, vec2(1.0)))) {
+    return false;
+  }
+
+  vec2 pMin = uvMin * vec2(sizes.zw);
+  vec2 pMax = uvMax * vec2(sizes.zw);
+  float extent = max(max(pMax.x - pMin.x, pMax.y - pMin.y), 1.0);
+  // the texels of the level are at least as large as the box, which then covers 2x2 of them
+  uint level = uint(clamp(ceil(log2(extent)) - 1.0, 0.0, float(sizes.y - 1u)));
+  uint width = sizes.z;
+  uint height = sizes.w;
+  uint offset = 0u;
+  for (uint i = 0u; i != level; i++) {
+    width = max(width >> 1, 1u);
+    height = max(height >> 1, 1u);
+    offset += width * height;
+  }
+  width = max(width >> 1, 1u);
+  height = max(height >> 1, 1u);
+
+  uvec2 lastTexel = uvec2(width - 1u, height - 1u);
+  uvec2 t0 = min(uvec2(pMin) >> (level + 1u), lastTexel);
+  uvec2 t1 = min(uvec2(pMax) >> (level + 1u), lastTexel);
+  bool reverseZ = (flags & kReverseZ) != 0u;
+  for (uint y = t0.y; y <= t1.y; y++) {
+    for (uint x = t0.x; x <= t1.x; x++) {
+      vec2 t = loadTexel(offset + y * width + x);
+      // the nearest point of the box may be in front of the farthest occluder
+      if (reverseZ ? zMax >= t.x : zMin <= t.y) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+)";
+
+// buffers are accessed through buffer device addresses, see igl::vulkan::Device
+const char kVulkanDeclarations[] = R"(
+layout (local_size_x = 64) in;
+
+layout (std430, buffer_reference) readonly buffer Pyramid {
+  vec2 texels[];
+};
+
+layout (push_constant) uniform PushConstants {
+  mat4 viewProj;
+  mat4 depthViewProj;
+} pc;
+
+vec2 loadTexel(uint i) {
+  return Pyramid(getBuffer(2)).texels[i];
+}
+)";
+
+const char kVulkanMain[] = R"(
+layout (std430, buffer_reference) readonly buffer Instances {
+  Instance instances[];
+};
+
+layout (std430, buffer_reference) readonly buffer Info {
+  uvec4 sizes;
+  uvec4 flags;
+};
+
+layout (std430, buffer_reference) buffer DrawCommands {
+  uint count;
+  uint padding[3];
+  DrawCommand commands[];
+};
+
+void main() {
+  uint i = gl_GlobalInvocationID.x;
+  uvec4 sizes = Info(getBuffer(1)).sizes;
+  uint flags = Info(getBuffer(1)).flags.x;
+  if (i >= sizes.x) {
+    return;
+  }
+  Instance inst = Instances(getBuffer(0)).instances[i];
+  bool visible = !isOutsideFrustum(inst.sphere, flags) && !isOccluded(inst.sphere, sizes, flags);
+  DrawCommands commands = DrawCommands(getBuffer(3));
+  if ((flags & kCompacted) == 0u) {
+    commands.commands[i] =
+        DrawCommand(inst.draw.x, visible ? 1u : 0u, inst.draw.y, int(inst.draw.z), inst.draw.w);
+  } else if (visible) {
+    commands.commands[atomicAdd(commands.count, 1u)] =
+        DrawCommand(inst.draw.x, 1u, inst.draw.y, int(inst.draw.z), inst.draw.w);
+  }
+}
+)";
+
+const char kOpenGLDeclarations[] = R"(
+layout (local_size_x = 64) in;
+
+layout (std430, binding = 2) readonly buffer Pyramid {
+  vec2 texels[];
+};
+
+layout (std140) uniform IGLPushConstants {
+  mat4 viewProj;
+  mat4 depthViewProj;
+} pc;
+
+vec2 loadTexel(uint i) {
+  return texels[i];
+}
+)";
+
+const char kOpenGLMain[] = R"(
+layout (std430, binding = 0) readonly buffer Instances {
+  Instance instances[];
+};
+
+layout (std430, binding = 1) readonly buffer Info {
+  uvec4 sizes;
+  uvec4 flags;
+} info;
+
+layout (std430, binding = 3) buffer DrawCommands {
+  uint count;
+  uint padding[3];
+  DrawCommand commands[];
+};
+
+void main() {
+  uint i = gl_GlobalInvocationID.x;
+  uint flags = info.flags.x;
+  if (i >= info.sizes.x) {
+    return;
+  }
+  Instance inst = instances[i];
+  bool visible =
+      !isOutsideFrustum(inst.sphere, flags) && !isOccluded(inst.sphere, info.sizes, flags);
+  if ((flags & kCompacted) == 0u) {
+    commands[i] =
+        DrawCommand(inst.draw.x, visible ? 1u : 0u, inst.draw.y, int(inst.draw.z), inst.draw.w);
+  } else if (visible) {
+    commands[atomicAdd(count, 1u)] =
+        DrawCommand(inst.draw.x, 1u, inst.draw.y, int(inst.draw.z), inst.draw.w);
+  }
+}
+)";
+
+const char kMetalShader[] = R"(
+using namespace metal;
+
+constant uint kReverseZ = 1;
+constant uint kDepthMinusOneToOne = 2;
+constant uint kFlipY = 4;
+constant uint kCompacted = 8;
+
+struct Instance {
+  float4 sphere;
+  // indexCount, firstIndex, baseVertex, baseInstance
+  uint4 draw;
+};
+
+// MTLDrawIndexedPrimitivesIndirectArguments
+struct DrawCommand {
+  uint indexCount;
+  uint instanceCount;
+  uint indexStart;
+  int baseVertex;
+  uint baseInstance;
+};
+
+struct Info {
+  uint4 sizes;
+  uint4 flags;
+};
+
+struct PushConstants {
+  float4x4 viewProj;
+  float4x4 depthViewProj;
+};
+
+// a corner of the bounding box of the sphere in clip space
+static float4 getCorner(float4x4 m, float4 sphere, int i) {
+  float3 s = float3((i & 1) != 0 ? 1.0 : -1.0,
+                    (i & 2) != 0 ? 1.0 : -1.0,
+                    (i & 4) != 0 ? 1.0 : -1.0);
+  return m * float4(sphere.xyz + s * sphere.w, 1.0);
+}
+
+// all the corners are outside of the same clip plane
+static bool isOutsideFrustum(constant PushConstants& pc, float4 sphere, uint flags) {
+  bool minusOneToOne = (flags & kDepthMinusOneToOne) != 0;
+  uint outside = 63;
+  for (int i = 0; i != 8; i++) {
+    float4 c = getCorner(pc.viewProj, sphere, i);
+    uint planes = 0;
+    planes |= c.x < -c.w ? 1 : 0;
+    planes |= c.x > c.w ? 2 : 0;
+    planes |= c.y < -c.w ? 4 : 0;
+    planes |= c.y > c.w ? 8 : 0;
+    planes |= c.z < (minusOneToOne ? -c.w : 0.0) ? 16 : 0;
+    planes |= c.z > c.w ? 32 : 0;
+    outside &= planes;
+  }
+  return outside != 0;
+}
+
+static bool isOccluded(constant PushConstants& pc,
+                       device const float2* texels,
+                       float4 sphere,
+                       uint4 sizes,
+                       uint flags) {
+  float2 uvMin = float2(1.0);
+  float2 uvMax = float2(0.0);
+  float zMin = 1.0;
+  float zMax = 0.0;
+  for (int i = 0; i != 8; i++) {
+    float4 c = getCorner(pc.depthViewProj, sphere, i);
+    // behind the camera of the pyramid, or no occlusion test at all with a zero matrix
+    if (c.w <= 0.0) {
+      return false;
+    }
+    float3 ndc = c.xyz / c.w;
+    float depth = (flags & kDepthMinusOneToOne) != 0 ? ndc.z * 0.5 + 0.5 : ndc.z;
+    float2 uv = ndc.xy * 0.5 + 0.5;
+    if ((flags & kFlipY) != 0) {
+      uv.y = 1.0 - uv.y;
+    }
+    uvMin = min(uvMin, uv);
+    uvMax = max(uvMax, uv);
+    zMin = min(zMin, depth);
+    zMax = max(zMax, depth);
+  }
+  // nothing is known of what was off screen
+  if (any(uvMin < float2(0.0)) || any(uvMax > float2(1.0))) {
+    return false;
+  }
+
+  float2 pMin = uvMin * float2(sizes.zw);
+  float2 pMax = uvMax * float2(sizes.zw);
+  float extent = max(max(pMax.x - pMin.x, pMax.y - pMin.y), 1.0);
+  // the texels of the level are at least as large as the box, which then covers 2x2 of them
+  uint level = uint(clamp(ceil(log2(extent)) - 1.0, 0.0, float(sizes.y - 1)));
+  uint width = sizes.z;
+  uint height = sizes.w;
+  uint offset = 0;
+  for (uint i = 0; i != level; i++) {
+    width = max(width >> 1, 1u);
+    height = max(height >> 1, 1u);
+    offset += width * height;
+  }
+  width = max(width >> 1, 1u);
+  height = max(height >> 1, 1u);
+
+  uint2 lastTexel = uint2(width - 1, height - 1);
+  uint2 t0 = min(uint2(pMin) >> (level + 1), lastTexel);
+  uint2 t1 = min(uint2(pMax) >> (level + 1), lastTexel);
+  bool reverseZ = (flags & kReverseZ) != 0;
+  for (uint y = t0.y; y <= t1.y; y++) {
+    for (uint x = t0.x; x <= t1.x; x++) {
+      float2 t = texels[offset + y * width + x];
+      // the nearest point of the box may be in front of the farthest occluder
+      if (reverseZ ? zMax >= t.x : zMin <= t.y) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+kernel void cullInstances(device const Instance* instances [[buffer(0)]],
+                          device const Info& info [[buffer(1)]],
+                          device const float2* texels [[buffer(2)]],
+                          device uint* drawCommands [[buffer(3)]],
+                          constant PushConstants& pc [[buffer(4)]],
+                          uint i [[thread_position_in_grid]]) {
+  uint flags = info.flags.x;
+  if (i >= info.sizes.x) {
+    return;
+  }
+  Instance inst = instances[i];
+  bool visible = !isOutsideFrustum(pc, inst.sphere, flags) &&
+                 !isOccluded(pc, texels, inst.sphere, info.sizes, flags);
+  // the commands follow the draw count, padded to 16 bytes
+  device DrawCommand* commands = (device DrawCommand*)(drawCommands + 4);
+  if ((flags & kCompacted) == 0) {
+    commands[i] = DrawCommand{
+        inst.draw.x, visible ? 1u : 0u, inst.draw.y, int(inst.draw.z), inst.draw.w};
+  } else if (visible) {
+    uint slot =
+        atomic_fetch_add_explicit((device atomic_uint*)drawCommands, 1, memory_order_relaxed);
+    commands[slot] = DrawCommand{inst.draw.x, 1u, inst.draw.y, int(inst.draw.z), inst.draw.w};
+  }
+}
+)";
+
+// compute shaders need OpenGL 4.3 or OpenGL ES 3.1
+std::string getOpenGLPrologue(igl::ShaderVersion shaderVersion) {
+  return std::string(shaderVersion.family == igl::ShaderFamily::GlslEs ? "#version 310 es\n"
+                                                                       : "#version 430\n") +
+         "precision highp float;\nprecision highp int;\n";
+}
+
+std::unique_ptr<igl::IShaderStages> createShaderStages(igl::IDevice& device,
+                                                       igl::Result* IGL_NULLABLE outResult) {
+  switch (device.getBackendType()) {
+  case igl::BackendType::Vulkan: {
+    const std::string shader = std::string(kVulkanDeclarations) + kGlslCulling + kVulkanMain;
+    return igl::ShaderStagesCreator::fromModuleStringInput(
+        device, shader.c_str(), "main", "Shader Module: occlusion culling", outResult);
+  }
+  case igl::BackendType::Metal:
+    return igl::ShaderStagesCreator::fromModuleStringInput(
+        device, kMetalShader, "cullInstances", "Shader Module: occlusion culling", outResult);
+  case igl::BackendType::OpenGL: {
+    const std::string shader = getOpenGLPrologue(device.getShaderVersion()) +
+                               kOpenGLDeclarations + kGlslCulling + kOpenGLMain;
+    return igl::ShaderStagesCreator::fromModuleStringInput(
+        device, shader.c_str(), "main", "Shader Module: occlusion culling", outResult);
+  }
+  default:
+    igl::Result::setResult(
+        outResult, igl::Result::Code::Unsupported, "Occlusion culling is not supported");
+    return nullptr;
+  }
+}
+
+} // namespace
+
+bool OcclusionCuller::isSupported(const igl::IDevice& device) {
+  return DepthPyramid::isSupported(device) &&
+         device.hasFeature(igl::DeviceFeatures::DrawIndexedIndirect);
+}
+
+OcclusionCuller::OcclusionCuller(igl::IDevice& device,
+                                 const DepthPyramid& pyramid,
+                                 OcclusionCullerDesc desc,
+                                 igl::Result* IGL_NULLABLE outResult) :
+  backendType_(device.getBackendType()),
+  compacted_(device.hasFeature(igl::DeviceFeatures::MultiDrawIndirectCount)) {
+  if (!isSupported(device)) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::Unsupported, "Occlusion culling is not supported");
+    return;
+  }
+  if (desc.instances.empty()) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "No instances");
+    return;
+  }
+  if (!pyramid.getBuffer()) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "The depth pyramid is not valid");
+    return;
+  }
+
+  igl::Result ret;
+  instanceBuffer_ = device.createBuffer(
+      igl::BufferDesc(igl::BufferDesc::BufferTypeBits::Storage,
+                      desc.instances.data(),
+                      desc.instances.size() * sizeof(OcclusionInstance),
+                      igl::ResourceStorage::Private,
+                      0,
+                      "Buffer: " + desc.debugName + " instances"),
+      &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+
+  Info info;
+  info.sizes[0] = static_cast<uint32_t>(desc.instances.size());
+  info.sizes[1] = static_cast<uint32_t>(pyramid.getLevels().size());
+  info.sizes[2] = pyramid.getWidth();
+  info.sizes[3] = pyramid.getHeight();
+  info.flags[0] = (desc.reverseZ ? kFlagReverseZ : 0) | (compacted_ ? kFlagCompacted : 0) |
+                  (backendType_ == igl::BackendType::OpenGL ? kFlagDepthMinusOneToOne
+                                                            : kFlagFlipY);
+  infoBuffer_ = device.createBuffer(igl::BufferDesc(igl::BufferDesc::BufferTypeBits::Storage,
+                                                    &info,
+                                                    sizeof(info),
+                                                    igl::ResourceStorage::Private,
+                                                    0,
+                                                    "Buffer: " + desc.debugName + " culling info"),
+                                    &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+
+  drawCommandBuffer_ = device.createBuffer(
+      igl::BufferDesc(igl::BufferDesc::BufferTypeBits::Storage |
+                          igl::BufferDesc::BufferTypeBits::Indirect,
+                      nullptr,
+                      kDrawCommandsOffset +
+                          desc.instances.size() * igl::IGL_DRAW_ELEMENTS_INDIRECT_COMMAND_SIZE,
+                      igl::ResourceStorage::Private,
+                      0,
+                      "Buffer: " + desc.debugName + " draw commands"),
+      &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+
+  igl::ComputePipelineDesc pipelineDesc;
+  pipelineDesc.shaderStages = createShaderStages(device, &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+  pipelineDesc.buffersMap[0] = IGL_NAMEHANDLE("Instances");
+  pipelineDesc.buffersMap[1] = IGL_NAMEHANDLE("Info");
+  pipelineDesc.buffersMap[2] = IGL_NAMEHANDLE("Pyramid");
+  pipelineDesc.buffersMap[3] = IGL_NAMEHANDLE("DrawCommands");
+  pipelineDesc.debugName = "Pipeline: occlusion culling";
+  pipelineState_ = device.createComputePipeline(pipelineDesc, &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+
+  pyramidBuffer_ = pyramid.getBuffer();
+  numInstances_ = static_cast<uint32_t>(desc.instances.size());
+  igl::Result::setOk(outResult);
+}
+
+void OcclusionCuller::cull(igl::ICommandBuffer& commandBuffer, const Params& params) {
+  if (!pipelineState_) {
+    return;
+  }
+
+  if (compacted_) {
+    auto blitEncoder = commandBuffer.createBlitCommandEncoder();
+    blitEncoder->fillBuffer(*drawCommandBuffer_, 0, sizeof(uint32_t), 0);
+    blitEncoder->endEncoding();
+  }
+
+  PushConstants pushConstants;
+  memcpy(pushConstants.viewProj, params.viewProj, sizeof(pushConstants.viewProj));
+  // a zero matrix puts every instance behind the camera of the pyramid, which disables the test
+  if (params.testOcclusion) {
+    memcpy(pushConstants.depthViewProj, params.depthViewProj, sizeof(pushConstants.depthViewProj));
+  }
+
+  auto encoder = commandBuffer.createComputeCommandEncoder();
+  encoder->bindComputePipelineState(pipelineState_);
+  encoder->bindBuffer(0, instanceBuffer_, 0);
+  encoder->bindBuffer(1, infoBuffer_, 0);
+  encoder->bindBuffer(2, pyramidBuffer_, 0);
+  encoder->bindBuffer(3, drawCommandBuffer_, 0);
+  if (backendType_ == igl::BackendType::Metal) {
+    encoder->bindBytes(4, &pushConstants, sizeof(pushConstants));
+  } else {
+    encoder->bindPushConstants(0, &pushConstants, sizeof(pushConstants));
+  }
+  encoder->dispatchThreadGroups(
+      igl::Dimensions((numInstances_ + kThreadgroupSize - 1) / kThreadgroupSize, 1, 1),
+      igl::Dimensions(kThreadgroupSize, 1, 1));
+  encoder->endEncoding();
+}
+
+void OcclusionCuller::draw(igl::IRenderCommandEncoder& commandEncoder,
+                           igl::IBuffer& indexBuffer,
+                           igl::IndexFormat indexFormat) {
+  if (!pipelineState_) {
+    return;
+  }
+  if (compacted_) {
+    commandEncoder.multiDrawIndexedIndirectCount(igl::PrimitiveType::Triangle,
+                                                 indexFormat,
+                                                 indexBuffer,
+                                                 *drawCommandBuffer_,
+                                                 kDrawCommandsOffset,
+                                                 *drawCommandBuffer_,
+                                                 0,
+                                                 numInstances_,
+                                                 igl::IGL_DRAW_ELEMENTS_INDIRECT_COMMAND_SIZE);
+  } else if (backendType_ == igl::BackendType::OpenGL) {
+    // the OpenGL backend has no multi-draw
+    for (uint32_t i = 0; i != numInstances_; i++) {
+      commandEncoder.drawIndexedIndirect(
+          igl::PrimitiveType::Triangle,
+          indexFormat,
+          indexBuffer,
+          *drawCommandBuffer_,
+          kDrawCommandsOffset + i * igl::IGL_DRAW_ELEMENTS_INDIRECT_COMMAND_SIZE);
+    }
+  } else {
+    commandEncoder.multiDrawIndexedIndirect(igl::PrimitiveType::Triangle,
+                                            indexFormat,
+                                            indexBuffer,
+                                            *drawCommandBuffer_,
+                                            kDrawCommandsOffset,
+                                            numInstances_,
+                                            igl::IGL_DRAW_ELEMENTS_INDIRECT_COMMAND_SIZE);
+  }
+}
+
+} // namespace occlusion
+} // namespace iglu
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/occlusion_culling/DepthPyramid.h>
+#include <cstdint>
+#include <igl/IGL.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace iglu {
+namespace occlusion {
+
+/// An instance to cull: its bounding sphere and the indexed draw which renders it
+struct OcclusionInstance {
+  /// xyz: center in world space, w: radius
+  float sphere[4] = {};
+  uint32_t indexCount = 0;
+  uint32_t firstIndex = 0;
+  int32_t baseVertex = 0;
+  uint32_t baseInstance = 0;
+};
+
+/**
+ * @brief Parameters of an OcclusionCuller.
+ *
+ *  instances - The instances to cull, drawn with a single instance each
+ *  reverseZ  - The depth buffer is cleared to 0 and nearer surfaces have larger depths
+ */
+struct OcclusionCullerDesc {
+  std::vector<OcclusionInstance> instances;
+  bool reverseZ = false;
+  std::string debugName;
+};
+
+/**
+ * @brief GPU frustum and occlusion culling of instances against a DepthPyramid.
+ *
+ * A compute shader tests the bounding sphere of every instance against the view frustum of the
+ * current frame, then projects it with the view-projection matrix of the depth pyramid, usually the
+ * one of the previous frame, and compares its nearest depth with the farthest depth of the 2x2
+ * pyramid texels covering it. Objects which were off screen or crossed the near plane when the
+ * pyramid was rendered are kept.
+ *
+ * When the device supports DeviceFeatures::MultiDrawIndirectCount, the visible instances are
+ * appended to a compacted list of indexed indirect draw commands whose count is written next to
+ * them, and draw() issues a single multiDrawIndexedIndirectCount(). Otherwise every instance keeps
+ * its command, with no instance when culled; draw() then issues a multiDrawIndexedIndirect(), or
+ * one drawIndexedIndirect() per instance on OpenGL.
+ *
+ * The draw command buffer starts with the draw count, padded to kDrawCommandsOffset bytes.
+ * Supported where DepthPyramid is, see isSupported().
+ */
+class OcclusionCuller final {
+ public:
+  static constexpr size_t kDrawCommandsOffset = 16;
+
+  struct Params {
+    /// Column-major view-projection matrix of the current frame
+    float viewProj[16] = {};
+    /// Column-major view-projection matrix the depth of the pyramid was rendered with
+    float depthViewProj[16] = {};
+    /// Only frustum culling is done when false, e.g. before the first pyramid or after a camera cut
+    bool testOcclusion = true;
+  };
+
+  static bool isSupported(const igl::IDevice& device);
+
+  OcclusionCuller(igl::IDevice& device,
+                  const DepthPyramid& pyramid,
+                  OcclusionCullerDesc desc,
+                  igl::Result* IGL_NULLABLE outResult = nullptr);
+  ~OcclusionCuller() = default;
+
+  /// Encodes the culling pass. Must be called outside of a render pass, after DepthPyramid::build()
+  /// and in the command buffer of draw() or in one submitted before it. The draw commands of the
+  /// previous frame are overwritten: wait for it before culling again.
+  void cull(igl::ICommandBuffer& commandBuffer, const Params& params);
+
+  /// Draws the instances which passed the last cull() with the vertex and fragment resources bound
+  /// by the caller
+  void draw(igl::IRenderCommandEncoder& commandEncoder,
+            igl::IBuffer& indexBuffer,
+            igl::IndexFormat indexFormat);
+
+  /// True if the draw commands are compacted and preceded by their count
+  [[nodiscard]] bool isCompacted() const {
+    return compacted_;
+  }
+
+  [[nodiscard]] uint32_t numInstances() const {
+    return numInstances_;
+  }
+
+  [[nodiscard]] const std::shared_ptr<igl::IBuffer>& getDrawCommandBuffer() const {
+    return drawCommandBuffer_;
+  }
+
+ private:
+  igl::BackendType backendType_;
+  bool compacted_ = false;
+  uint32_t numInstances_ = 0;
+  std::shared_ptr<igl::IBuffer> instanceBuffer_;
+  std::shared_ptr<igl::IBuffer> infoBuffer_;
+  std::shared_ptr<igl::IBuffer> pyramidBuffer_;
+  std::shared_ptr<igl::IBuffer> drawCommandBuffer_;
+  std::shared_ptr<igl::IComputePipelineState> pipelineState_;
+};
+
+} // namespace occlusion
+} // namespace iglu
@@ -0,0 +1,457 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/pipeline_manifest/PipelineManifest.h>
+
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+
+namespace iglu {
+namespace pipelinemanifest {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x4D4C4749; // "IGLM"
+// to be incremented whenever the layout of the manifest changes
+constexpr uint32_t kVersion = 1;
+
+class Writer {
+ public:
+  template<typename T>
+  void write(T value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+  }
+  void writeSize(size_t size) {
+    write(static_cast<uint64_t>(size));
+  }
+  void writeString(const std::string& str) {
+    write(static_cast<uint32_t>(str.size()));
+    data.insert(data.end(), str.begin(), str.end());
+  }
+  void writeNameHandle(const igl::NameHandle& name) {
+    writeString(name.toString());
+  }
+
+  std::vector<uint8_t> data;
+};
+
+// All reads fail once the end of the data has been reached
+class Reader {
+ public:
+  Reader(const uint8_t* data, size_t length) : data_(data), length_(length) {}
+
+  template<typename T>
+  bool read(T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (!data_ || length_ - offset_ < sizeof(T)) {
+      return fail();
+    }
+    std::memcpy(&value, data_ + offset_, sizeof(T));
+    offset_ += sizeof(T);
+    return true;
+  }
+  bool readSize(size_t& size) {
+    uint64_t value = 0;
+    if (!read(value) || value > length_) {
+      return fail();
+    }
+    size = static_cast<size_t>(value);
+    return true;
+  }
+  bool readString(std::string& str) {
+    uint32_t size = 0;
+    if (!read(size) || length_ - offset_ < size) {
+      return fail();
+    }
+    str.assign(reinterpret_cast<const char*>(data_ + offset_), size);
+    offset_ += size;
+    return true;
+  }
+  bool readNameHandle(igl::NameHandle& name) {
+    std::string str;
+    if (!readString(str)) {
+      return false;
+    }
+    name = igl::genNameHandle(str);
+    return true;
+  }
+  [[nodiscard]] bool isOk() const {
+    return ok_;
+  }
+  bool fail() {
+    offset_ = length_;
+    ok_ = false;
+    return false;
+  }
+
+ private:
+
+  const uint8_t* data_;
+  size_t length_;
+  size_t offset_ = 0;
+  bool ok_ = true;
+};
+
+void writeNameMap(Writer& writer, const std::unordered_map<size_t, igl::NameHandle>& map) {
+  writer.writeSize(map.size());
+  for (const auto& [index, name] : map) {
+    writer.writeSize(index);
+    writer.writeNameHandle(name);
+  }
+}
+
+void readNameMap(Reader& reader, std::unordered_map<size_t, igl::NameHandle>& map) {
+  size_t count = 0;
+  reader.readSize(count);
+  for (size_t i = 0; i != count && reader.isOk(); i++) {
+    size_t index = 0;
+    igl::NameHandle name;
+    if (reader.readSize(index) && reader.readNameHandle(name)) {
+      map[index] = std::move(name);
+    }
+  }
+}
+
+void writeStencil(Writer& writer, const igl::StencilStateDesc& desc) {
+  writer.write(desc.stencilFailureOperation);
+  writer.write(desc.depthFailureOperation);
+  writer.write(desc.depthStencilPassOperation);
+  writer.write(desc.stencilCompareFunction);
+  writer.write(desc.readMask);
+  writer.write(desc.writeMask);
+}
+
+void readStencil(Reader& reader, igl::StencilStateDesc& desc) {
+  reader.read(desc.stencilFailureOperation);
+  reader.read(desc.depthFailureOperation);
+  reader.read(desc.depthStencilPassOperation);
+  reader.read(desc.stencilCompareFunction);
+  reader.read(desc.readMask);
+  reader.read(desc.writeMask);
+}
+
+void writeShaderModule(Writer& writer, const ShaderModuleRecord& record) {
+  writer.write(record.info.stage);
+  writer.writeString(record.info.entryPoint);
+  writer.writeSize(record.info.specializationConstants.size());
+  for (const auto& constant : record.info.specializationConstants) {
+    writer.write(constant.id);
+    writer.writeString(constant.name);
+    writer.write(constant.type);
+    writer.write(constant.value);
+  }
+  writer.write(record.inputType);
+  writer.write(record.fastMathEnabled);
+  writer.writeString(record.code);
+  writer.writeString(record.debugName);
+}
+
+void readShaderModule(Reader& reader, ShaderModuleRecord& record) {
+  reader.read(record.info.stage);
+  reader.readString(record.info.entryPoint);
+  size_t numConstants = 0;
+  reader.readSize(numConstants);
+  for (size_t i = 0; i != numConstants && reader.isOk(); i++) {
+    igl::ShaderSpecializationConstant constant;
+    reader.read(constant.id);
+    reader.readString(constant.name);
+    reader.read(constant.type);
+    reader.read(constant.value);
+    record.info.specializationConstants.push_back(std::move(constant));
+  }
+  reader.read(record.inputType);
+  reader.read(record.fastMathEnabled);
+  reader.readString(record.code);
+  reader.readString(record.debugName);
+}
+
+void writeVertexInputState(Writer& writer, const igl::VertexInputStateDesc& desc) {
+  writer.writeSize(desc.numAttributes);
+  for (size_t i = 0; i != desc.numAttributes; i++) {
+    const igl::VertexAttribute& attribute = desc.attributes[i];
+    writer.writeSize(attribute.bufferIndex);
+    writer.write(attribute.format);
+    writer.writeSize(attribute.offset);
+    writer.writeString(attribute.name);
+    writer.write(static_cast<int32_t>(attribute.location));
+  }
+  writer.writeSize(desc.numInputBindings);
+  for (size_t i = 0; i != desc.numInputBindings; i++) {
+    const igl::VertexInputBinding& binding = desc.inputBindings[i];
+    writer.writeSize(binding.stride);
+    writer.write(binding.sampleFunction);
+    writer.writeSize(binding.sampleRate);
+  }
+}
+
+void readVertexInputState(Reader& reader, igl::VertexInputStateDesc& desc) {
+  if (!reader.readSize(desc.numAttributes) ||
+      desc.numAttributes > igl::IGL_VERTEX_ATTRIBUTES_MAX) {
+    desc.numAttributes = 0;
+    reader.fail();
+    return;
+  }
+  for (size_t i = 0; i != desc.numAttributes; i++) {
+    igl::VertexAttribute& attribute = desc.attributes[i];
+    size_t offset = 0;
+    int32_t location = -1;
+    reader.readSize(attribute.bufferIndex);
+    reader.read(attribute.format);
+    reader.readSize(offset);
+    reader.readString(attribute.name);
+    reader.read(location);
+    attribute.offset = offset;
+    attribute.location = location;
+  }
+  if (!reader.readSize(desc.numInputBindings) ||
+      desc.numInputBindings > igl::IGL_VERTEX_BUFFER_MAX) {
+    desc.numInputBindings = 0;
+    reader.fail();
+    return;
+  }
+  for (size_t i = 0; i != desc.numInputBindings; i++) {
+    igl::VertexInputBinding& binding = desc.inputBindings[i];
+    reader.readSize(binding.stride);
+    reader.read(binding.sampleFunction);
+    reader.readSize(binding.sampleRate);
+  }
+}
+
+void writeRenderPipeline(Writer& writer, const RenderPipelineRecord& record) {
+  const igl::RenderPipelineDesc& desc = record.desc;
+  writer.write(record.vertexInputState);
+  writer.write(record.vertexModule);
+  writer.write(record.fragmentModule);
+
+  writer.writeSize(desc.targetDesc.colorAttachments.size());
+  for (const auto& attachment : desc.targetDesc.colorAttachments) {
+    writer.write(attachment.textureFormat);
+    writer.write(attachment.colorWriteBits);
+    writer.write(attachment.blendEnabled);
+    writer.write(attachment.rgbBlendOp);
+    writer.write(attachment.alphaBlendOp);
+    writer.write(attachment.srcRGBBlendFactor);
+    writer.write(attachment.srcAlphaBlendFactor);
+    writer.write(attachment.dstRGBBlendFactor);
+    writer.write(attachment.dstAlphaBlendFactor);
+  }
+  writer.write(desc.targetDesc.depthAttachmentFormat);
+  writer.write(desc.targetDesc.stencilAttachmentFormat);
+  writer.write(desc.cullMode);
+  writer.write(desc.frontFaceWinding);
+  writer.write(desc.polygonFillMode);
+  writeNameMap(writer, desc.vertexUnitSamplerMap);
+  writeNameMap(writer, desc.fragmentUnitSamplerMap);
+  writer.writeSize(desc.uniformBlockBindingMap.size());
+  for (const auto& [index, names] : desc.uniformBlockBindingMap) {
+    writer.writeSize(index);
+    writer.writeNameHandle(names.first);
+    writer.writeNameHandle(names.second);
+  }
+  writer.write(static_cast<int32_t>(desc.sampleCount));
+  writer.writeNameHandle(desc.debugName);
+
+  writer.writeSize(record.variants.size());
+  for (const auto& variant : record.variants) {
+    writer.write(variant.primitiveType);
+    writer.write(variant.depthStencilState.compareFunction);
+    writer.write(variant.depthStencilState.isDepthWriteEnabled);
+    writeStencil(writer, variant.depthStencilState.backFaceStencil);
+    writeStencil(writer, variant.depthStencilState.frontFaceStencil);
+    writer.write(variant.depthBiasEnable);
+    writer.write(variant.framebufferMode);
+    writer.write(variant.hasColorResolve);
+  }
+}
+
+void readRenderPipeline(Reader& reader, RenderPipelineRecord& record) {
+  igl::RenderPipelineDesc& desc = record.desc;
+  reader.read(record.vertexInputState);
+  reader.read(record.vertexModule);
+  reader.read(record.fragmentModule);
+
+  size_t numColorAttachments = 0;
+  reader.readSize(numColorAttachments);
+  for (size_t i = 0; i != numColorAttachments && reader.isOk(); i++) {
+    igl::RenderPipelineDesc::TargetDesc::ColorAttachment attachment;
+    reader.read(attachment.textureFormat);
+    reader.read(attachment.colorWriteBits);
+    reader.read(attachment.blendEnabled);
+    reader.read(attachment.rgbBlendOp);
+    reader.read(attachment.alphaBlendOp);
+    reader.read(attachment.srcRGBBlendFactor);
+    reader.read(attachment.srcAlphaBlendFactor);
+    reader.read(attachment.dstRGBBlendFactor);
+    reader.read(attachment.dstAlphaBlendFactor);
+    desc.targetDesc.colorAttachments.push_back(attachment);
+  }
+  reader.read(desc.targetDesc.depthAttachmentFormat);
+  reader.read(desc.targetDesc.stencilAttachmentFormat);
+  reader.read(desc.cullMode);
+  reader.read(desc.frontFaceWinding);
+  reader.read(desc.polygonFillMode);
+  readNameMap(reader, desc.vertexUnitSamplerMap);
+  readNameMap(reader, desc.fragmentUnitSamplerMap);
+  size_t numUniformBlocks = 0;
+  reader.readSize(numUniformBlocks);
+  for (size_t i = 0; i != numUniformBlocks && reader.isOk(); i++) {
+    size_t index = 0;
+    std::pair<igl::NameHandle, igl::NameHandle> names;
+    if (reader.readSize(index) && reader.readNameHandle(names.first) &&
+        reader.readNameHandle(names.second)) {
+      desc.uniformBlockBindingMap[index] = std::move(names);
+    }
+  }
+  int32_t sampleCount = 1;
+  reader.read(sampleCount);
+  desc.sampleCount = sampleCount;
+  reader.readNameHandle(desc.debugName);
+
+  size_t numVariants = 0;
+  reader.readSize(numVariants);
+  for (size_t i = 0; i != numVariants && reader.isOk(); i++) {
+    RenderPipelineVariant variant;
+    reader.read(variant.primitiveType);
+    reader.read(variant.depthStencilState.compareFunction);
+    reader.read(variant.depthStencilState.isDepthWriteEnabled);
+    readStencil(reader, variant.depthStencilState.backFaceStencil);
+    readStencil(reader, variant.depthStencilState.frontFaceStencil);
+    reader.read(variant.depthBiasEnable);
+    reader.read(variant.framebufferMode);
+    reader.read(variant.hasColorResolve);
+    record.variants.push_back(variant);
+  }
+}
+
+void writeComputePipeline(Writer& writer, const ComputePipelineRecord& record) {
+  writer.write(record.computeModule);
+  writeNameMap(writer, record.desc.imagesMap);
+  writeNameMap(writer, record.desc.buffersMap);
+  writer.writeString(record.desc.debugName);
+}
+
+void readComputePipeline(Reader& reader, ComputePipelineRecord& record) {
+  reader.read(record.computeModule);
+  readNameMap(reader, record.desc.imagesMap);
+  readNameMap(reader, record.desc.buffersMap);
+  reader.readString(record.desc.debugName);
+}
+
+// the records reference modules and vertex input states by index
+bool hasValidIndices(const PipelineManifest& manifest) {
+  const size_t numModules = manifest.shaderModules.size();
+  for (const auto& record : manifest.renderPipelines) {
+    if (record.vertexModule >= numModules || record.fragmentModule >= numModules ||
+        record.vertexInputState < -1 ||
+        record.vertexInputState >= static_cast<int64_t>(manifest.vertexInputStates.size())) {
+      return false;
+    }
+  }
+  for (const auto& record : manifest.computePipelines) {
+    if (record.computeModule >= numModules) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+bool ShaderModuleRecord::operator==(const ShaderModuleRecord& other) const {
+  return info == other.info && inputType == other.inputType &&
+         fastMathEnabled == other.fastMathEnabled && code == other.code &&
+         debugName == other.debugName;
+}
+
+bool ShaderModuleRecord::operator!=(const ShaderModuleRecord& other) const {
+  return !(*this == other);
+}
+
+bool RenderPipelineVariant::operator==(const RenderPipelineVariant& other) const {
+  return primitiveType == other.primitiveType && depthStencilState == other.depthStencilState &&
+         depthBiasEnable == other.depthBiasEnable && framebufferMode == other.framebufferMode &&
+         hasColorResolve == other.hasColorResolve;
+}
+
+bool RenderPipelineVariant::operator!=(const RenderPipelineVariant& other) const {
+  return !(*this == other);
+}
+
+std::vector<uint8_t> PipelineManifest::serialize() const {
+  Writer writer;
+  writer.write(kMagic);
+  writer.write(kVersion);
+
+  writer.writeSize(shaderModules.size());
+  for (const auto& record : shaderModules) {
+    writeShaderModule(writer, record);
+  }
+  writer.writeSize(vertexInputStates.size());
+  for (const auto& desc : vertexInputStates) {
+    writeVertexInputState(writer, desc);
+  }
+  writer.writeSize(renderPipelines.size());
+  for (const auto& record : renderPipelines) {
+    writeRenderPipeline(writer, record);
+  }
+  writer.writeSize(computePipelines.size());
+  for (const auto& record : computePipelines) {
+    writeComputePipeline(writer, record);
+  }
+  return std::move(writer.data);
+}
+
+PipelineManifest PipelineManifest::deserialize(const uint8_t* data,
+                                               size_t length,
+                                               igl::Result* outResult) {
+  Reader reader(data, length);
+
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  if (!reader.read(magic) || !reader.read(version) || magic != kMagic || version != kVersion) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "Not a pipeline manifest of this version");
+    return {};
+  }
+
+  PipelineManifest manifest;
+  size_t count = 0;
+  reader.readSize(count);
+  for (size_t i = 0; i != count && reader.isOk(); i++) {
+    readShaderModule(reader, manifest.shaderModules.emplace_back());
+  }
+  count = 0;
+  reader.readSize(count);
+  for (size_t i = 0; i != count && reader.isOk(); i++) {
+    readVertexInputState(reader, manifest.vertexInputStates.emplace_back());
+  }
+  count = 0;
+  reader.readSize(count);
+  for (size_t i = 0; i != count && reader.isOk(); i++) {
+    readRenderPipeline(reader, manifest.renderPipelines.emplace_back());
+  }
+  count = 0;
+  reader.readSize(count);
+  for (size_t i = 0; i != count && reader.isOk(); i++) {
+    readComputePipeline(reader, manifest.computePipelines.emplace_back());
+  }
+
+  if (!reader.isOk() || !hasValidIndices(manifest)) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "Corrupted pipeline manifest");
+    return {};
+  }
+
+  igl::Result::setOk(outResult);
+  return manifest;
+}
+
+} // namespace pipelinemanifest
+} // namespace iglu
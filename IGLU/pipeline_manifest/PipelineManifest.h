@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/IGL.h>
+#include <string>
+#include <vector>
+
+namespace iglu {
+namespace pipelinemanifest {
+
+/// The creation parameters of a shader module, including its source code or binary
+struct ShaderModuleRecord {
+  igl::ShaderModuleInfo info;
+  igl::ShaderInputType inputType = igl::ShaderInputType::String;
+  bool fastMathEnabled = true;
+  /// Source code or binary data, depending on `inputType`
+  std::string code;
+  std::string debugName;
+
+  bool operator==(const ShaderModuleRecord& other) const;
+  bool operator!=(const ShaderModuleRecord& other) const;
+};
+
+/// Draw-time state selecting a variant of a render pipeline, which Vulkan compiles into separate
+/// VkPipelines. See igl::vulkan::RenderPipelineVariantDesc
+struct RenderPipelineVariant {
+  igl::PrimitiveType primitiveType = igl::PrimitiveType::Triangle;
+  igl::DepthStencilStateDesc depthStencilState;
+  bool depthBiasEnable = false;
+  igl::FramebufferMode framebufferMode = igl::FramebufferMode::Mono;
+  bool hasColorResolve = false;
+
+  bool operator==(const RenderPipelineVariant& other) const;
+  bool operator!=(const RenderPipelineVariant& other) const;
+};
+
+struct RenderPipelineRecord {
+  /// vertexInputState and shaderStages are null: they are referenced by the indices below
+  igl::RenderPipelineDesc desc;
+  /// Index into PipelineManifest::vertexInputStates, or -1 without vertex input state
+  int32_t vertexInputState = -1;
+  /// Indices into PipelineManifest::shaderModules
+  uint32_t vertexModule = 0;
+  uint32_t fragmentModule = 0;
+  std::vector<RenderPipelineVariant> variants;
+};
+
+struct ComputePipelineRecord {
+  /// shaderStages is null: the module is referenced by the index below
+  igl::ComputePipelineDesc desc;
+  /// Index into PipelineManifest::shaderModules
+  uint32_t computeModule = 0;
+};
+
+/**
+ * @brief Everything passed to the pipeline creation functions of a device during a session, in a
+ * form which can be saved and replayed at the next startup.
+ *
+ * @see PipelineRecorder, warmUpPipelines()
+ */
+struct PipelineManifest {
+  std::vector<ShaderModuleRecord> shaderModules;
+  std::vector<igl::VertexInputStateDesc> vertexInputStates;
+  std::vector<RenderPipelineRecord> renderPipelines;
+  std::vector<ComputePipelineRecord> computePipelines;
+
+  /// Compact binary representation, e.g. to be written to the application cache directory
+  [[nodiscard]] std::vector<uint8_t> serialize() const;
+  /// Parses data returned by serialize(). The manifest is empty if the data is invalid or was
+  /// written by an incompatible version.
+  static PipelineManifest deserialize(const uint8_t* IGL_NULLABLE data,
+                                      size_t length,
+                                      igl::Result* IGL_NULLABLE outResult);
+};
+
+} // namespace pipelinemanifest
+} // namespace iglu
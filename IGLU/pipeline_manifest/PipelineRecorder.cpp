@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/pipeline_manifest/PipelineRecorder.h>
+
+#include <algorithm>
+
+namespace iglu {
+namespace pipelinemanifest {
+
+namespace {
+
+ShaderModuleRecord makeRecord(const igl::ShaderModuleInfo& info,
+                              const igl::ShaderInput& input,
+                              const std::string& debugName) {
+  ShaderModuleRecord record;
+  record.info = info;
+  record.inputType = input.type;
+  record.fastMathEnabled = input.options.fastMathEnabled;
+  if (input.type == igl::ShaderInputType::Binary) {
+    record.code.assign(static_cast<const char*>(input.data), input.length);
+  } else {
+    record.code = input.source;
+  }
+  record.debugName = debugName;
+  return record;
+}
+
+// index of an equal element, which is appended if there is none
+template<typename T>
+uint32_t findOrAppend(std::vector<T>& records, T record) {
+  const auto it = std::find(records.begin(), records.end(), record);
+  if (it != records.end()) {
+    return static_cast<uint32_t>(it - records.begin());
+  }
+  records.push_back(std::move(record));
+  return static_cast<uint32_t>(records.size() - 1);
+}
+
+} // namespace
+
+template<typename T>
+int64_t PipelineRecorder::find(const std::unordered_map<const T*, Recorded<T>>& map,
+                               const std::shared_ptr<T>& object) {
+  const auto it = object ? map.find(object.get()) : map.end();
+  if (it == map.end() || it->second.object.lock() != object) {
+    return -1;
+  }
+  return it->second.index;
+}
+
+uint32_t PipelineRecorder::addShaderModule(const std::shared_ptr<igl::IShaderModule>& module,
+                                           ShaderModuleRecord record) {
+  const uint32_t index = findOrAppend(manifest_.shaderModules, std::move(record));
+  modules_[module.get()] = {module, index};
+  return index;
+}
+
+std::shared_ptr<igl::IShaderModule> PipelineRecorder::createShaderModule(
+    const igl::ShaderModuleDesc& desc,
+    igl::Result* outResult) {
+  auto module = device_.createShaderModule(desc, outResult);
+  if (module && desc.input.isValid()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    addShaderModule(module, makeRecord(desc.info, desc.input, desc.debugName));
+  }
+  return module;
+}
+
+std::unique_ptr<igl::IShaderLibrary> PipelineRecorder::createShaderLibrary(
+    const igl::ShaderLibraryDesc& desc,
+    igl::Result* outResult) {
+  auto library = device_.createShaderLibrary(desc, outResult);
+  if (library && desc.input.isValid()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // every module is replayed as a separate module created from the whole library source
+    for (const auto& info : desc.moduleInfo) {
+      if (auto module = library->getShaderModule(info.stage, info.entryPoint)) {
+        addShaderModule(module, makeRecord(info, desc.input, desc.debugName));
+      }
+    }
+  }
+  return library;
+}
+
+std::shared_ptr<igl::IVertexInputState> PipelineRecorder::createVertexInputState(
+    const igl::VertexInputStateDesc& desc,
+    igl::Result* outResult) {
+  auto vertexInputState = device_.createVertexInputState(desc, outResult);
+  if (vertexInputState) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint32_t index = findOrAppend(manifest_.vertexInputStates, desc);
+    vertexInputStates_[vertexInputState.get()] = {vertexInputState, index};
+  }
+  return vertexInputState;
+}
+
+std::shared_ptr<igl::IRenderPipelineState> PipelineRecorder::createRenderPipeline(
+    const igl::RenderPipelineDesc& desc,
+    igl::Result* outResult) {
+  auto pipelineState = device_.createRenderPipeline(desc, outResult);
+  if (!pipelineState || !desc.shaderStages) {
+    return pipelineState;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const int64_t vertexModule = find(modules_, desc.shaderStages->getVertexModule());
+  const int64_t fragmentModule = find(modules_, desc.shaderStages->getFragmentModule());
+  const int64_t vertexInputState = find(vertexInputStates_, desc.vertexInputState);
+  if (vertexModule < 0 || fragmentModule < 0 || (desc.vertexInputState && vertexInputState < 0)) {
+    IGL_LOG_INFO("PipelineRecorder: %s was not recorded, its shader modules or vertex input state "
+                 "were created without the recorder\n",
+                 desc.debugName.toConstChar());
+    return pipelineState;
+  }
+
+  RenderPipelineRecord record;
+  record.desc = desc;
+  record.desc.vertexInputState = nullptr;
+  record.desc.shaderStages = nullptr;
+  record.vertexInputState = static_cast<int32_t>(vertexInputState);
+  record.vertexModule = static_cast<uint32_t>(vertexModule);
+  record.fragmentModule = static_cast<uint32_t>(fragmentModule);
+
+  auto& records = manifest_.renderPipelines;
+  auto it = std::find_if(records.begin(), records.end(), [&record](const auto& r) {
+    return r.desc == record.desc && r.vertexInputState == record.vertexInputState &&
+           r.vertexModule == record.vertexModule && r.fragmentModule == record.fragmentModule;
+  });
+  if (it == records.end()) {
+    records.push_back(std::move(record));
+    it = records.end() - 1;
+  }
+  renderPipelines_[pipelineState.get()] = {pipelineState,
+                                           static_cast<uint32_t>(it - records.begin())};
+  return pipelineState;
+}
+
+std::shared_ptr<igl::IComputePipelineState> PipelineRecorder::createComputePipeline(
+    const igl::ComputePipelineDesc& desc,
+    igl::Result* outResult) {
+  auto pipelineState = device_.createComputePipeline(desc, outResult);
+  if (!pipelineState || !desc.shaderStages) {
+    return pipelineState;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const int64_t computeModule = find(modules_, desc.shaderStages->getComputeModule());
+  if (computeModule < 0) {
+    IGL_LOG_INFO("PipelineRecorder: %s was not recorded, its shader module was created without "
+                 "the recorder\n",
+                 desc.debugName.c_str());
+    return pipelineState;
+  }
+
+  ComputePipelineRecord record;
+  record.desc = desc;
+  record.desc.shaderStages = nullptr;
+  record.computeModule = static_cast<uint32_t>(computeModule);
+
+  const auto& records = manifest_.computePipelines;
+  const bool isRecorded =
+      std::any_of(records.begin(), records.end(), [&record](const auto& r) {
+        return r.desc == record.desc && r.computeModule == record.computeModule;
+      });
+  if (!isRecorded) {
+    manifest_.computePipelines.push_back(std::move(record));
+  }
+  return pipelineState;
+}
+
+void PipelineRecorder::addRenderPipelineVariant(
+    const std::shared_ptr<igl::IRenderPipelineState>& pipelineState,
+    const RenderPipelineVariant& variant) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const int64_t index = find(renderPipelines_, pipelineState);
+  if (index >= 0) {
+    findOrAppend(manifest_.renderPipelines[index].variants, variant);
+  }
+}
+
+PipelineManifest PipelineRecorder::getManifest() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return manifest_;
+}
+
+} // namespace pipelinemanifest
+} // namespace iglu
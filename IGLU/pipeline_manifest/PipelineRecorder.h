@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/pipeline_manifest/PipelineManifest.h>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace iglu {
+namespace pipelinemanifest {
+
+/**
+ * @brief Creates shader modules, vertex input states and pipelines with a device and records their
+ * descriptors into a PipelineManifest.
+ *
+ * Pipelines are only recorded when their shader modules and vertex input state were created
+ * through the same recorder. Identical descriptors are recorded once. The recorder can be used from
+ * any thread the device allows.
+ */
+class PipelineRecorder final {
+ public:
+  explicit PipelineRecorder(igl::IDevice& device) : device_(device) {}
+
+  std::shared_ptr<igl::IShaderModule> createShaderModule(const igl::ShaderModuleDesc& desc,
+                                                         igl::Result* IGL_NULLABLE outResult);
+  std::unique_ptr<igl::IShaderLibrary> createShaderLibrary(const igl::ShaderLibraryDesc& desc,
+                                                           igl::Result* IGL_NULLABLE outResult);
+  std::shared_ptr<igl::IVertexInputState> createVertexInputState(
+      const igl::VertexInputStateDesc& desc,
+      igl::Result* IGL_NULLABLE outResult);
+  std::shared_ptr<igl::IRenderPipelineState> createRenderPipeline(
+      const igl::RenderPipelineDesc& desc,
+      igl::Result* IGL_NULLABLE outResult);
+  std::shared_ptr<igl::IComputePipelineState> createComputePipeline(
+      const igl::ComputePipelineDesc& desc,
+      igl::Result* IGL_NULLABLE outResult);
+
+  /// Records draw-time state used with a pipeline created by this recorder, so that Vulkan can
+  /// compile the corresponding VkPipeline ahead of the first draw call after a replay.
+  void addRenderPipelineVariant(const std::shared_ptr<igl::IRenderPipelineState>& pipelineState,
+                                const RenderPipelineVariant& variant);
+
+  [[nodiscard]] PipelineManifest getManifest() const;
+
+ private:
+  template<typename T>
+  struct Recorded {
+    // checked when looking up an object, as the address of a destroyed object can be reused
+    std::weak_ptr<T> object;
+    uint32_t index = 0;
+  };
+
+  template<typename T>
+  static int64_t find(const std::unordered_map<const T*, Recorded<T>>& map,
+                      const std::shared_ptr<T>& object);
+  uint32_t addShaderModule(const std::shared_ptr<igl::IShaderModule>& module,
+                           ShaderModuleRecord record);
+
+  igl::IDevice& device_;
+
+  mutable std::mutex mutex_;
+  PipelineManifest manifest_;
+  std::unordered_map<const igl::IShaderModule*, Recorded<igl::IShaderModule>> modules_;
+  std::unordered_map<const igl::IVertexInputState*, Recorded<igl::IVertexInputState>>
+      vertexInputStates_;
+  std::unordered_map<const igl::IRenderPipelineState*, Recorded<igl::IRenderPipelineState>>
+      renderPipelines_;
+};
+
+} // namespace pipelinemanifest
+} // namespace iglu
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/pipeline_manifest/PipelineWarmUp.h>
+
+#include <mutex>
+
+#if IGL_BACKEND_VULKAN
+#include <igl/vulkan/Device.h>
+#include <igl/vulkan/RenderPipelineState.h>
+#endif // IGL_BACKEND_VULKAN
+
+namespace iglu {
+namespace pipelinemanifest {
+
+namespace {
+
+// shared with the completion handlers, which can run on any thread
+class WarmUpState {
+ public:
+  WarmUpState(size_t numRenderPipelines, size_t numComputePipelines) :
+    // released by finish() once all the pipelines have been requested
+    numPending_(numRenderPipelines + numComputePipelines + 1) {
+    pipelines_.renderPipelines.resize(numRenderPipelines);
+    pipelines_.computePipelines.resize(numComputePipelines);
+  }
+
+  std::shared_future<WarmedUpPipelines> getFuture() {
+    return promise_.get_future().share();
+  }
+
+  void setRenderPipeline(size_t index,
+                         std::shared_ptr<igl::IRenderPipelineState> pipelineState,
+                         const igl::Result& result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pipelines_.renderPipelines[index] = std::move(pipelineState);
+    setError(result);
+    completeOne();
+  }
+
+  void setComputePipeline(size_t index,
+                          std::shared_ptr<igl::IComputePipelineState> pipelineState,
+                          const igl::Result& result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pipelines_.computePipelines[index] = std::move(pipelineState);
+    setError(result);
+    completeOne();
+  }
+
+  void finish(const igl::Result& result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    setError(result);
+    completeOne();
+  }
+
+ private:
+  void setError(const igl::Result& result) {
+    if (pipelines_.result.isOk() && !result.isOk()) {
+      pipelines_.result = result;
+    }
+  }
+
+  void completeOne() {
+    if (--numPending_ == 0) {
+      promise_.set_value(std::move(pipelines_));
+    }
+  }
+
+  std::mutex mutex_;
+  WarmedUpPipelines pipelines_;
+  size_t numPending_;
+  std::promise<WarmedUpPipelines> promise_;
+};
+
+igl::ShaderModuleDesc toShaderModuleDesc(const ShaderModuleRecord& record) {
+  igl::ShaderModuleDesc desc =
+      record.inputType == igl::ShaderInputType::Binary
+          ? igl::ShaderModuleDesc::fromBinaryInput(
+                record.code.data(), record.code.size(), record.info, record.debugName)
+          : igl::ShaderModuleDesc::fromStringInput(
+                record.code.c_str(), record.info, record.debugName);
+  desc.input.options.fastMathEnabled = record.fastMathEnabled;
+  return desc;
+}
+
+std::vector<std::shared_ptr<igl::IShaderModule>> createShaderModules(
+    igl::IDevice& device,
+    const PipelineManifest& manifest,
+    igl::Result* outResult) {
+  std::vector<igl::ShaderModuleDesc> descs;
+  descs.reserve(manifest.shaderModules.size());
+  for (const auto& record : manifest.shaderModules) {
+    descs.push_back(toShaderModuleDesc(record));
+  }
+
+#if IGL_BACKEND_VULKAN
+  if (device.getBackendType() == igl::BackendType::Vulkan) {
+    // compiles the modules concurrently on worker threads
+    return static_cast<igl::vulkan::Device&>(device).createShaderModules(descs, outResult);
+  }
+#endif // IGL_BACKEND_VULKAN
+
+  std::vector<std::shared_ptr<igl::IShaderModule>> modules;
+  modules.reserve(descs.size());
+  igl::Result::setOk(outResult);
+  for (const auto& desc : descs) {
+    igl::Result result;
+    modules.push_back(device.createShaderModule(desc, &result));
+    if (outResult && outResult->isOk() && !result.isOk()) {
+      *outResult = std::move(result);
+    }
+  }
+  return modules;
+}
+
+#if IGL_BACKEND_VULKAN
+void warmUpVariants(igl::IDevice& device,
+                    const std::shared_ptr<igl::IRenderPipelineState>& pipelineState,
+                    const std::vector<RenderPipelineVariant>& variants) {
+  std::vector<igl::vulkan::RenderPipelineVariantDesc> descs;
+  descs.reserve(variants.size());
+  for (const auto& variant : variants) {
+    igl::vulkan::RenderPipelineVariantDesc desc;
+    desc.primitiveType = variant.primitiveType;
+    desc.depthStencilState = variant.depthStencilState;
+    desc.depthBiasEnable = variant.depthBiasEnable;
+    desc.framebufferMode = variant.framebufferMode;
+    desc.hasColorResolve = variant.hasColorResolve;
+    descs.push_back(desc);
+  }
+  // the VkPipelines are built on a background thread
+  static_cast<igl::vulkan::Device&>(device).warmUpRenderPipeline(pipelineState, descs);
+}
+#endif // IGL_BACKEND_VULKAN
+
+} // namespace
+
+std::shared_future<WarmedUpPipelines> warmUpPipelines(igl::IDevice& device,
+                                                      const PipelineManifest& manifest) {
+  IGL_PROFILER_FUNCTION();
+
+  auto state = std::make_shared<WarmUpState>(manifest.renderPipelines.size(),
+                                             manifest.computePipelines.size());
+  auto future = state->getFuture();
+
+  igl::Result result;
+  const auto modules = createShaderModules(device, manifest, &result);
+
+  std::vector<std::shared_ptr<igl::IVertexInputState>> vertexInputStates;
+  vertexInputStates.reserve(manifest.vertexInputStates.size());
+  for (const auto& desc : manifest.vertexInputStates) {
+    vertexInputStates.push_back(device.createVertexInputState(desc, nullptr));
+  }
+
+  for (size_t i = 0; i != manifest.renderPipelines.size(); i++) {
+    const RenderPipelineRecord& record = manifest.renderPipelines[i];
+    igl::Result stagesResult;
+    igl::RenderPipelineDesc desc = record.desc;
+    desc.vertexInputState =
+        record.vertexInputState >= 0 ? vertexInputStates[record.vertexInputState] : nullptr;
+    if (modules[record.vertexModule] && modules[record.fragmentModule]) {
+      desc.shaderStages = igl::ShaderStagesCreator::fromRenderModules(
+          device, modules[record.vertexModule], modules[record.fragmentModule], &stagesResult);
+    }
+    if (!desc.shaderStages) {
+      state->setRenderPipeline(i, nullptr, stagesResult);
+      continue;
+    }
+
+#if IGL_BACKEND_VULKAN
+    if (device.getBackendType() == igl::BackendType::Vulkan) {
+      // VkPipelines are built per variant when they are used, so the pipeline state is cheap
+      igl::Result pipelineResult;
+      auto pipelineState = device.createRenderPipeline(desc, &pipelineResult);
+      if (pipelineState && !record.variants.empty()) {
+        warmUpVariants(device, pipelineState, record.variants);
+      }
+      state->setRenderPipeline(i, std::move(pipelineState), pipelineResult);
+      continue;
+    }
+#endif // IGL_BACKEND_VULKAN
+
+    device.createRenderPipelineAsync(
+        desc,
+        // the resources referenced by the descriptor must outlive the creation of the pipeline
+        [state, i, shaderStages = desc.shaderStages, vertexInputState = desc.vertexInputState](
+            std::shared_ptr<igl::IRenderPipelineState> pipelineState, igl::Result result) {
+          state->setRenderPipeline(i, std::move(pipelineState), result);
+        });
+  }
+
+  for (size_t i = 0; i != manifest.computePipelines.size(); i++) {
+    const ComputePipelineRecord& record = manifest.computePipelines[i];
+    igl::Result stagesResult;
+    igl::ComputePipelineDesc desc = record.desc;
+    if (modules[record.computeModule]) {
+      desc.shaderStages = igl::ShaderStagesCreator::fromComputeModule(
+          device, modules[record.computeModule], &stagesResult);
+    }
+    if (!desc.shaderStages) {
+      state->setComputePipeline(i, nullptr, stagesResult);
+      continue;
+    }
+    device.createComputePipelineAsync(
+        desc,
+        [state, i, shaderStages = desc.shaderStages](
+            std::shared_ptr<igl::IComputePipelineState> pipelineState, igl::Result result) {
+          state->setComputePipeline(i, std::move(pipelineState), result);
+        });
+  }
+
+  state->finish(result);
+  return future;
+}
+
+} // namespace pipelinemanifest
+} // namespace iglu
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/pipeline_manifest/PipelineManifest.h>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace iglu {
+namespace pipelinemanifest {
+
+struct WarmedUpPipelines {
+  /// In the order of the manifest, null for the pipelines which could not be created
+  std::vector<std::shared_ptr<igl::IRenderPipelineState>> renderPipelines;
+  std::vector<std::shared_ptr<igl::IComputePipelineState>> computePipelines;
+  /// The first error
+  igl::Result result;
+};
+
+/**
+ * @brief Creates every pipeline of the manifest, e.g. recorded by PipelineRecorder during a
+ * previous session, so that the shader and pipeline caches of the backend are filled before the
+ * first frame:
+ *  - Vulkan: shader modules are compiled concurrently and the recorded pipeline variants are built
+ *    on a background thread by vulkan::Device::warmUpRenderPipeline(), filling the VkPipelineCache
+ *  - Metal: pipelines are created asynchronously, filling the binary archive when it is enabled
+ *  - OpenGL: programs are linked asynchronously, filling the program binary cache when it is
+ *    enabled. The pipeline states are created when the device scope is entered again.
+ *
+ * Must be called on the rendering thread. The caches are filled whether or not the returned
+ * pipeline states are kept, but the application can also use them, e.g. found by their debug names.
+ * @return Future which becomes ready when all the pipeline states have been created
+ */
+std::shared_future<WarmedUpPipelines> warmUpPipelines(igl::IDevice& device,
+                                                      const PipelineManifest& manifest);
+
+} // namespace pipelinemanifest
+} // namespace iglu
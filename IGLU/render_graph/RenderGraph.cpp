@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/render_graph/RenderGraph.h>
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace iglu {
+namespace rendergraph {
+
+namespace {
+
+bool isSameTexture(const igl::TextureDesc& a, const igl::TextureDesc& b) {
+  return a.type == b.type && a.format == b.format && a.width == b.width &&
+         a.height == b.height && a.depth == b.depth && a.numLayers == b.numLayers &&
+         a.numSamples == b.numSamples && a.numMipLevels == b.numMipLevels &&
+         a.usage == b.usage && a.options == b.options && a.storage == b.storage;
+}
+
+} // namespace
+
+void PassBuilder::read(TextureHandle texture) {
+  graph_.passes_[passIndex_].reads.push_back(texture);
+  graph_.addUsage(texture, igl::TextureDesc::TextureUsageBits::Sampled);
+}
+
+void PassBuilder::writeColor(size_t index,
+                             TextureHandle texture,
+                             igl::LoadAction loadAction,
+                             igl::Color clearColor) {
+  auto& pass = graph_.passes_[passIndex_];
+  IGL_ASSERT_MSG(pass.render, "Only render passes have attachments");
+  pass.writes.push_back(texture);
+  auto& attachment = pass.colorAttachments[index];
+  attachment.texture = texture;
+  attachment.loadAction = loadAction;
+  attachment.clearColor = clearColor;
+  graph_.addUsage(texture, igl::TextureDesc::TextureUsageBits::Attachment);
+}
+
+void PassBuilder::writeDepth(TextureHandle texture, igl::LoadAction loadAction, float clearDepth) {
+  auto& pass = graph_.passes_[passIndex_];
+  IGL_ASSERT_MSG(pass.render, "Only render passes have attachments");
+  pass.writes.push_back(texture);
+  pass.depthAttachment.texture = texture;
+  pass.depthAttachment.loadAction = loadAction;
+  pass.depthAttachment.clearDepth = clearDepth;
+  graph_.addUsage(texture, igl::TextureDesc::TextureUsageBits::Attachment);
+}
+
+void PassBuilder::writeStorage(TextureHandle texture) {
+  graph_.passes_[passIndex_].writes.push_back(texture);
+  graph_.addUsage(texture, igl::TextureDesc::TextureUsageBits::Storage);
+}
+
+void PassBuilder::setSideEffect() {
+  graph_.passes_[passIndex_].sideEffect = true;
+}
+
+RenderGraph::RenderGraph(igl::IDevice& device) : device_(device) {}
+
+TextureHandle RenderGraph::createTexture(const std::string& name, const igl::TextureDesc& desc) {
+  Texture texture;
+  texture.name = name;
+  texture.desc = desc;
+  if (texture.desc.storage == igl::ResourceStorage::Invalid) {
+    texture.desc.storage = igl::ResourceStorage::Private;
+  }
+  if (texture.desc.debugName.empty()) {
+    texture.desc.debugName = name;
+  }
+  textures_.push_back(std::move(texture));
+  return static_cast<TextureHandle>(textures_.size() - 1);
+}
+
+TextureHandle RenderGraph::importTexture(const std::string& name,
+                                         std::shared_ptr<igl::ITexture> texture) {
+  IGL_ASSERT(texture);
+  Texture imported;
+  imported.name = name;
+  imported.texture = std::move(texture);
+  imported.imported = true;
+  textures_.push_back(std::move(imported));
+  return static_cast<TextureHandle>(textures_.size() - 1);
+}
+
+void RenderGraph::addRenderPass(const std::string& name,
+                                const SetupFunc& setup,
+                                RenderFunc execute) {
+  Pass pass;
+  pass.render = std::move(execute);
+  addPass(name, setup, std::move(pass));
+}
+
+void RenderGraph::addComputePass(const std::string& name,
+                                 const SetupFunc& setup,
+                                 ComputeFunc execute) {
+  Pass pass;
+  pass.compute = std::move(execute);
+  addPass(name, setup, std::move(pass));
+}
+
+void RenderGraph::addPass(const std::string& name, const SetupFunc& setup, Pass pass) {
+  IGL_ASSERT_MSG(!compiled_, "Passes cannot be added after compile()");
+  pass.name = name;
+  passes_.push_back(std::move(pass));
+  PassBuilder builder(*this, passes_.size() - 1);
+  setup(builder);
+}
+
+void RenderGraph::addUsage(TextureHandle handle, igl::TextureDesc::TextureUsage usage) {
+  if (!IGL_VERIFY(handle < textures_.size())) {
+    return;
+  }
+  textures_[handle].desc.usage |= usage;
+}
+
+void RenderGraph::cull() {
+  // walk the passes backwards, keeping the ones which produce something still needed
+  std::unordered_set<TextureHandle> needed;
+  for (size_t i = passes_.size(); i-- > 0;) {
+    auto& pass = passes_[i];
+    bool keep = pass.sideEffect;
+    for (TextureHandle handle : pass.writes) {
+      keep = keep || textures_[handle].imported || needed.count(handle) != 0;
+    }
+    pass.culled = !keep;
+    if (pass.culled) {
+      continue;
+    }
+
+    // attachments which are cleared don't depend on earlier writes; storage writes might be partial
+    const auto overwrites = [](const Attachment& attachment) {
+      return attachment.texture != kInvalidTexture &&
+             attachment.loadAction != igl::LoadAction::Load;
+    };
+    for (const auto& [index, attachment] : pass.colorAttachments) {
+      if (overwrites(attachment)) {
+        needed.erase(attachment.texture);
+      }
+    }
+    if (overwrites(pass.depthAttachment)) {
+      needed.erase(pass.depthAttachment.texture);
+    }
+    for (const auto& [index, attachment] : pass.colorAttachments) {
+      if (attachment.loadAction == igl::LoadAction::Load) {
+        needed.insert(attachment.texture);
+      }
+    }
+    if (pass.depthAttachment.texture != kInvalidTexture &&
+        pass.depthAttachment.loadAction == igl::LoadAction::Load) {
+      needed.insert(pass.depthAttachment.texture);
+    }
+    needed.insert(pass.reads.begin(), pass.reads.end());
+  }
+}
+
+std::shared_ptr<igl::ITexture> RenderGraph::acquireTexture(const igl::TextureDesc& desc,
+                                                           igl::Result* outResult) {
+  for (auto& pooled : pool_) {
+    if (!pooled.inUse && isSameTexture(pooled.desc, desc)) {
+      pooled.inUse = true;
+      pooled.usedThisFrame = true;
+      igl::Result::setOk(outResult);
+      return pooled.texture;
+    }
+  }
+  auto texture = device_.createTexture(desc, outResult);
+  if (!texture) {
+    return nullptr;
+  }
+  pool_.push_back({texture, desc, true, true});
+  return texture;
+}
+
+void RenderGraph::releaseTexture(const std::shared_ptr<igl::ITexture>& texture) {
+  for (auto& pooled : pool_) {
+    if (pooled.texture == texture) {
+      pooled.inUse = false;
+      return;
+    }
+  }
+}
+
+igl::Result RenderGraph::allocate() {
+  for (size_t i = 0; i != passes_.size(); i++) {
+    if (passes_[i].culled) {
+      continue;
+    }
+    const auto use = [this, i](TextureHandle handle) {
+      auto& texture = textures_[handle];
+      texture.firstUse = std::min(texture.firstUse, i);
+      texture.lastUse = std::max(texture.lastUse, i);
+    };
+    std::for_each(passes_[i].reads.begin(), passes_[i].reads.end(), use);
+    std::for_each(passes_[i].writes.begin(), passes_[i].writes.end(), use);
+  }
+
+  // a texture goes back to the pool after its last pass, for the textures first used later
+  for (size_t i = 0; i != passes_.size(); i++) {
+    for (auto& texture : textures_) {
+      if (!texture.imported && texture.firstUse == i) {
+        igl::Result result;
+        texture.texture = acquireTexture(texture.desc, &result);
+        if (!result.isOk()) {
+          return result;
+        }
+      }
+    }
+    for (auto& texture : textures_) {
+      if (!texture.imported && texture.lastUse == i && texture.texture) {
+        releaseTexture(texture.texture);
+      }
+    }
+  }
+  return igl::Result();
+}
+
+igl::Result RenderGraph::compile() {
+  IGL_PROFILER_FUNCTION();
+
+  for (const auto& pass : passes_) {
+    const auto isValid = [this](TextureHandle handle) { return handle < textures_.size(); };
+    if (!std::all_of(pass.reads.begin(), pass.reads.end(), isValid) ||
+        !std::all_of(pass.writes.begin(), pass.writes.end(), isValid)) {
+      return igl::Result(igl::Result::Code::ArgumentOutOfRange,
+                         "Pass uses a texture which is not part of the graph");
+    }
+  }
+
+  cull();
+  igl::Result result = allocate();
+  compiled_ = result.isOk();
+  return result;
+}
+
+bool RenderGraph::isReadAfter(TextureHandle handle, size_t passIndex) const {
+  for (size_t i = passIndex + 1; i < passes_.size(); i++) {
+    const auto& pass = passes_[i];
+    if (pass.culled) {
+      continue;
+    }
+    if (std::find(pass.reads.begin(), pass.reads.end(), handle) != pass.reads.end()) {
+      return true;
+    }
+    for (const auto& [index, attachment] : pass.colorAttachments) {
+      if (attachment.texture == handle && attachment.loadAction == igl::LoadAction::Load) {
+        return true;
+      }
+    }
+    if (pass.depthAttachment.texture == handle &&
+        pass.depthAttachment.loadAction == igl::LoadAction::Load) {
+      return true;
+    }
+    if (!pass.compute && std::find(pass.writes.begin(), pass.writes.end(), handle) !=
+                             pass.writes.end()) {
+      // overwritten by a later render pass
+      return false;
+    }
+  }
+  return false;
+}
+
+std::shared_ptr<igl::IFramebuffer> RenderGraph::getFramebuffer(const Pass& pass,
+                                                               FramebufferCache& previous,
+                                                               igl::Result* outResult) {
+  std::vector<const igl::ITexture*> key;
+  igl::FramebufferDesc desc;
+  for (const auto& [index, attachment] : pass.colorAttachments) {
+    const auto& texture = textures_[attachment.texture].texture;
+    desc.colorAttachments[index].texture = texture;
+    key.resize(std::max(key.size(), index + 1), nullptr);
+    key[index] = texture.get();
+  }
+  if (pass.depthAttachment.texture != kInvalidTexture) {
+    desc.depthAttachment.texture = textures_[pass.depthAttachment.texture].texture;
+  }
+  key.push_back(desc.depthAttachment.texture.get());
+
+  auto it = framebuffers_.find(key);
+  if (it != framebuffers_.end()) {
+    igl::Result::setOk(outResult);
+    return it->second;
+  }
+  it = previous.find(key);
+  if (it != previous.end()) {
+    igl::Result::setOk(outResult);
+    return framebuffers_[key] = it->second;
+  }
+  desc.debugName = pass.name;
+  auto framebuffer = device_.createFramebuffer(desc, outResult);
+  if (framebuffer) {
+    framebuffers_[key] = framebuffer;
+  }
+  return framebuffer;
+}
+
+igl::Result RenderGraph::execute(igl::ICommandQueue& queue) {
+  IGL_PROFILER_FUNCTION();
+
+  if (!IGL_VERIFY(compiled_)) {
+    return igl::Result(igl::Result::Code::InvalidOperation, "The graph is not compiled");
+  }
+
+  igl::Result result;
+  auto commandBuffer = queue.createCommandBuffer(igl::CommandBufferDesc{}, &result);
+  if (!result.isOk()) {
+    return result;
+  }
+
+  // framebuffers are kept as long as consecutive frames use them
+  auto previousFramebuffers = std::move(framebuffers_);
+  framebuffers_.clear();
+
+  for (size_t i = 0; i != passes_.size(); i++) {
+    const auto& pass = passes_[i];
+    if (pass.culled) {
+      continue;
+    }
+    if (pass.compute) {
+      auto encoder = commandBuffer->createComputeCommandEncoder();
+      if (!encoder) {
+        return igl::Result(igl::Result::Code::RuntimeError, "Cannot create compute encoder");
+      }
+      pass.compute(*encoder);
+      encoder->endEncoding();
+      continue;
+    }
+
+    // attachments which nothing reads afterwards are not stored
+    const auto storeAction = [this, i](TextureHandle handle) {
+      return textures_[handle].imported || isReadAfter(handle, i) ? igl::StoreAction::Store
+                                                                  : igl::StoreAction::DontCare;
+    };
+    igl::RenderPassDesc renderPass;
+    for (const auto& [index, attachment] : pass.colorAttachments) {
+      if (renderPass.colorAttachments.size() <= index) {
+        renderPass.colorAttachments.resize(index + 1);
+      }
+      auto& color = renderPass.colorAttachments[index];
+      color.loadAction = attachment.loadAction;
+      color.storeAction = storeAction(attachment.texture);
+      color.clearColor = attachment.clearColor;
+    }
+    if (pass.depthAttachment.texture != kInvalidTexture) {
+      renderPass.depthAttachment.loadAction = pass.depthAttachment.loadAction;
+      renderPass.depthAttachment.storeAction = storeAction(pass.depthAttachment.texture);
+      renderPass.depthAttachment.clearDepth = pass.depthAttachment.clearDepth;
+    }
+
+    auto framebuffer = getFramebuffer(pass, previousFramebuffers, &result);
+    if (!framebuffer) {
+      return result;
+    }
+    auto encoder = commandBuffer->createRenderCommandEncoder(renderPass, framebuffer, &result);
+    if (!encoder) {
+      return result;
+    }
+    pass.render(*encoder);
+    encoder->endEncoding();
+  }
+
+  queue.submit(*commandBuffer);
+  return igl::Result();
+}
+
+void RenderGraph::reset() {
+  passes_.clear();
+  textures_.clear();
+  compiled_ = false;
+
+  // textures no frame needs anymore, e.g. after a resize, are released
+  pool_.erase(std::remove_if(pool_.begin(),
+                             pool_.end(),
+                             [](const PooledTexture& pooled) { return !pooled.usedThisFrame; }),
+              pool_.end());
+  for (auto& pooled : pool_) {
+    pooled.inUse = false;
+    pooled.usedThisFrame = false;
+  }
+}
+
+std::shared_ptr<igl::ITexture> RenderGraph::getTexture(TextureHandle handle) const {
+  return handle < textures_.size() ? textures_[handle].texture : nullptr;
+}
+
+bool RenderGraph::isPassCulled(const std::string& name) const {
+  for (const auto& pass : passes_) {
+    if (pass.name == name) {
+      return pass.culled;
+    }
+  }
+  return false;
+}
+
+} // namespace rendergraph
+} // namespace iglu
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <functional>
+#include <igl/IGL.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace iglu {
+namespace rendergraph {
+
+/// Identifies a texture of a RenderGraph
+using TextureHandle = uint32_t;
+constexpr TextureHandle kInvalidTexture = ~0u;
+
+class RenderGraph;
+
+/// Declares what a pass reads and writes. Only valid inside the setup function of the pass.
+class PassBuilder final {
+ public:
+  /// The pass samples `texture`
+  void read(TextureHandle texture);
+  /// The pass renders into `texture` as color attachment `index`
+  void writeColor(size_t index,
+                  TextureHandle texture,
+                  igl::LoadAction loadAction = igl::LoadAction::Clear,
+                  igl::Color clearColor = igl::Color(0, 0, 0, 0));
+  /// The pass renders into `texture` as depth attachment
+  void writeDepth(TextureHandle texture,
+                  igl::LoadAction loadAction = igl::LoadAction::Clear,
+                  float clearDepth = 1.0f);
+  /// The pass writes `texture` as a storage texture (compute passes)
+  void writeStorage(TextureHandle texture);
+  /// The pass is never culled, e.g. because it reads back data or writes buffers
+  void setSideEffect();
+
+ private:
+  friend class RenderGraph;
+  PassBuilder(RenderGraph& graph, size_t passIndex) : graph_(graph), passIndex_(passIndex) {}
+
+  RenderGraph& graph_;
+  size_t passIndex_;
+};
+
+/**
+ * @brief Schedules the passes of a frame from their declared reads and writes.
+ *
+ * Every frame, passes are added in submission order with the textures they read and write, then
+ * compile() and execute() are called, then reset(). compile():
+ * - culls the passes whose results are never used: only passes with side effects and passes
+ *   which write imported textures, and the passes they depend on, are kept;
+ * - allocates the transient textures (the ones created by the graph) from a pool kept across
+ *   frames, and hands the same texture to transients whose lifetimes don't overlap and whose
+ *   descriptors match, so intermediate textures only take memory while they are in use;
+ * - does not store attachments which no later pass reads.
+ *
+ * execute() records all the kept passes into a single command buffer, in order. Layout
+ * transitions and barriers are left to the backend, which derives them from how the textures are
+ * attached and bound, as for any other command buffer.
+ */
+class RenderGraph final {
+ public:
+  using RenderFunc = std::function<void(igl::IRenderCommandEncoder& encoder)>;
+  using ComputeFunc = std::function<void(igl::IComputeCommandEncoder& encoder)>;
+  using SetupFunc = std::function<void(PassBuilder& builder)>;
+
+  explicit RenderGraph(igl::IDevice& device);
+
+  /// Declares a texture allocated by the graph for the frame. The usage is derived from the
+  /// passes, and storage defaults to private.
+  TextureHandle createTexture(const std::string& name, const igl::TextureDesc& desc);
+  /// Declares a texture owned by the application, e.g. the drawable. Passes which write it are
+  /// never culled.
+  TextureHandle importTexture(const std::string& name, std::shared_ptr<igl::ITexture> texture);
+
+  /// Adds a render pass. `execute` is called by execute() with an encoder for the attachments
+  /// declared in `setup`, unless the pass is culled.
+  void addRenderPass(const std::string& name, const SetupFunc& setup, RenderFunc execute);
+  /// Adds a compute pass
+  void addComputePass(const std::string& name, const SetupFunc& setup, ComputeFunc execute);
+
+  /// Culls the passes and allocates the textures of the kept ones
+  igl::Result compile();
+  /// Records the kept passes into one command buffer and submits it to `queue`
+  igl::Result execute(igl::ICommandQueue& queue);
+  /// Removes all the passes and textures of the frame. Pooled textures are kept for the next one.
+  void reset();
+
+  /// The texture of `handle`. Transient textures are only valid between compile() and reset().
+  [[nodiscard]] std::shared_ptr<igl::ITexture> getTexture(TextureHandle handle) const;
+  [[nodiscard]] bool isPassCulled(const std::string& name) const;
+  /// Number of textures in the pool, used or not
+  [[nodiscard]] size_t getPooledTextureCount() const {
+    return pool_.size();
+  }
+
+ private:
+  friend class PassBuilder;
+
+  struct Attachment {
+    TextureHandle texture = kInvalidTexture;
+    igl::LoadAction loadAction = igl::LoadAction::Clear;
+    igl::Color clearColor = igl::Color(0, 0, 0, 0);
+    float clearDepth = 1.0f;
+  };
+
+  struct Pass {
+    std::string name;
+    RenderFunc render;
+    ComputeFunc compute;
+    std::vector<TextureHandle> reads;
+    std::vector<TextureHandle> writes;
+    std::map<size_t, Attachment> colorAttachments;
+    Attachment depthAttachment;
+    bool sideEffect = false;
+    bool culled = false;
+  };
+
+  struct Texture {
+    std::string name;
+    igl::TextureDesc desc;
+    std::shared_ptr<igl::ITexture> texture;
+    bool imported = false;
+    // indices of the first and last kept passes using the texture
+    size_t firstUse = ~size_t(0);
+    size_t lastUse = 0;
+  };
+
+  struct PooledTexture {
+    std::shared_ptr<igl::ITexture> texture;
+    igl::TextureDesc desc;
+    bool inUse = false;
+    // unused textures are released by reset()
+    bool usedThisFrame = false;
+  };
+
+  void addPass(const std::string& name, const SetupFunc& setup, Pass pass);
+  void addUsage(TextureHandle handle, igl::TextureDesc::TextureUsage usage);
+  void cull();
+  igl::Result allocate();
+  std::shared_ptr<igl::ITexture> acquireTexture(const igl::TextureDesc& desc,
+                                                igl::Result* outResult);
+  void releaseTexture(const std::shared_ptr<igl::ITexture>& texture);
+  [[nodiscard]] bool isReadAfter(TextureHandle handle, size_t passIndex) const;
+  using FramebufferCache =
+      std::map<std::vector<const igl::ITexture*>, std::shared_ptr<igl::IFramebuffer>>;
+  // looks in the framebuffers of this frame, then of the previous one, before creating one
+  std::shared_ptr<igl::IFramebuffer> getFramebuffer(const Pass& pass,
+                                                    FramebufferCache& previous,
+                                                    igl::Result* outResult);
+
+  igl::IDevice& device_;
+  std::vector<Pass> passes_;
+  std::vector<Texture> textures_;
+  std::vector<PooledTexture> pool_;
+  // framebuffers of the last execute(), keyed by their attachments
+  FramebufferCache framebuffers_;
+  bool compiled_ = false;
+};
+
+} // namespace rendergraph
+} // namespace iglu
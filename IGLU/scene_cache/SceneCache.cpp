@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "SceneCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#if IGL_PLATFORM_WIN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace iglu {
+namespace scenecache {
+
+namespace {
+
+constexpr uint32_t kMagic = makeSectionId('I', 'G', 'S', 'C');
+constexpr uint32_t kFormatVersion = 1;
+constexpr uint64_t kSectionAlignment = 16;
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t formatVersion;
+  uint32_t contentVersion;
+  uint32_t numSections;
+};
+
+// Must match SceneCache::SectionEntry, which is private
+struct FileSectionEntry {
+  uint32_t id;
+  uint32_t elementSize;
+  uint64_t offset;
+  uint64_t count;
+};
+
+static_assert(sizeof(FileHeader) == 16);
+static_assert(sizeof(FileSectionEntry) == 24);
+
+uint64_t alignUp(uint64_t value) {
+  return (value + kSectionAlignment - 1) & ~(kSectionAlignment - 1);
+}
+
+} // namespace
+
+void SceneCacheWriter::addSection(uint32_t id, const void* data, size_t elementSize, size_t count) {
+  IGL_ASSERT(elementSize > 0 && elementSize <= std::numeric_limits<uint32_t>::max());
+  IGL_ASSERT(data != nullptr || count == 0);
+  for (const auto& section : sections_) {
+    IGL_ASSERT_MSG(section.id != id, "Duplicate scene cache section");
+  }
+  sections_.push_back({id, static_cast<uint32_t>(elementSize), data, count});
+}
+
+bool SceneCacheWriter::write(const std::string& path, igl::Result* IGL_NULLABLE outResult) const {
+  const std::string tmpPath = path + ".tmp";
+
+  FILE* file = fopen(tmpPath.c_str(), "wb");
+  if (!file) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::RuntimeError, "Cannot create " + tmpPath);
+    return false;
+  }
+
+  const FileHeader header = {
+      kMagic, kFormatVersion, contentVersion_, static_cast<uint32_t>(sections_.size())};
+
+  std::vector<FileSectionEntry> entries;
+  entries.reserve(sections_.size());
+  uint64_t offset = alignUp(sizeof(FileHeader) + sizeof(FileSectionEntry) * sections_.size());
+  for (const auto& section : sections_) {
+    entries.push_back({section.id, section.elementSize, offset, section.count});
+    offset = alignUp(offset + uint64_t(section.elementSize) * section.count);
+  }
+
+  bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+  if (!entries.empty()) {
+    ok = ok &&
+         fwrite(entries.data(), sizeof(FileSectionEntry), entries.size(), file) == entries.size();
+  }
+
+  const uint8_t padding[kSectionAlignment] = {};
+  uint64_t written = sizeof(FileHeader) + sizeof(FileSectionEntry) * entries.size();
+  for (size_t i = 0; ok && i != sections_.size(); i++) {
+    const auto& section = sections_[i];
+    const size_t paddingSize = static_cast<size_t>(entries[i].offset - written);
+    ok = paddingSize == 0 || fwrite(padding, 1, paddingSize, file) == paddingSize;
+    if (ok && section.count) {
+      ok = fwrite(section.data, section.elementSize, section.count, file) == section.count;
+    }
+    written = entries[i].offset + uint64_t(section.elementSize) * section.count;
+  }
+
+  ok = (fclose(file) == 0) && ok;
+
+  // std::rename() does not replace existing files on Windows
+  std::remove(path.c_str());
+  if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+    std::remove(tmpPath.c_str());
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot write " + path);
+    return false;
+  }
+
+  igl::Result::setOk(outResult);
+  return true;
+}
+
+std::unique_ptr<SceneCache> SceneCache::open(const std::string& path,
+                                             uint32_t contentVersion,
+                                             igl::Result* IGL_NULLABLE outResult) {
+  std::unique_ptr<SceneCache> cache(new SceneCache());
+
+#if IGL_PLATFORM_WIN
+  HANDLE file = CreateFileA(path.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "Cannot open " + path);
+    return nullptr;
+  }
+  cache->fileHandle_ = file;
+  LARGE_INTEGER fileSize = {};
+  // empty files cannot be mapped
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "Empty " + path);
+    return nullptr;
+  }
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping == nullptr) {
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot map " + path);
+    return nullptr;
+  }
+  cache->mappingHandle_ = mapping;
+  const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (data == nullptr) {
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot map " + path);
+    return nullptr;
+  }
+  cache->size_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "Cannot open " + path);
+    return nullptr;
+  }
+  struct stat st = {};
+  // empty files cannot be mapped
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    ::close(fd);
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "Empty " + path);
+    return nullptr;
+  }
+  void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping keeps the file alive
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot map " + path);
+    return nullptr;
+  }
+  cache->size_ = static_cast<size_t>(st.st_size);
+#endif
+
+  cache->data_ = static_cast<const uint8_t*>(data);
+  cache->mapped_ = true;
+
+  if (!cache->validate(contentVersion, outResult)) {
+    return nullptr;
+  }
+  return cache;
+}
+
+std::unique_ptr<SceneCache> SceneCache::fromMemory(std::vector<uint8_t> data,
+                                                   uint32_t contentVersion,
+                                                   igl::Result* IGL_NULLABLE outResult) {
+  std::unique_ptr<SceneCache> cache(new SceneCache());
+  cache->ownedData_ = std::move(data);
+  cache->data_ = cache->ownedData_.data();
+  cache->size_ = cache->ownedData_.size();
+
+  if (!cache->validate(contentVersion, outResult)) {
+    return nullptr;
+  }
+  return cache;
+}
+
+SceneCache::~SceneCache() {
+#if IGL_PLATFORM_WIN
+  if (mapped_) {
+    UnmapViewOfFile(data_);
+  }
+  if (mappingHandle_) {
+    CloseHandle(mappingHandle_);
+  }
+  if (fileHandle_) {
+    CloseHandle(fileHandle_);
+  }
+#else
+  if (mapped_) {
+    munmap(const_cast<uint8_t*>(data_), size_);
+  }
+#endif
+}
+
+bool SceneCache::validate(uint32_t contentVersion, igl::Result* IGL_NULLABLE outResult) {
+  static_assert(sizeof(SceneCache::SectionEntry) == sizeof(FileSectionEntry));
+
+  auto fail = [outResult](const char* message) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, message);
+    return false;
+  };
+
+  if (size_ < sizeof(FileHeader)) {
+    return fail("Scene cache is truncated");
+  }
+  FileHeader header = {};
+  memcpy(&header, data_, sizeof(header));
+  // a cache written with the other byte order fails here too
+  if (header.magic != kMagic || header.formatVersion != kFormatVersion) {
+    return fail("Not a scene cache or unsupported format version");
+  }
+  if (header.contentVersion != contentVersion) {
+    return fail("Scene cache content version mismatch");
+  }
+  if ((size_ - sizeof(FileHeader)) / sizeof(SectionEntry) < header.numSections) {
+    return fail("Scene cache is truncated");
+  }
+
+  sections_ = reinterpret_cast<const SectionEntry*>(data_ + sizeof(FileHeader));
+  numSections_ = header.numSections;
+
+  for (uint32_t i = 0; i != numSections_; i++) {
+    const auto& section = sections_[i];
+    if (section.elementSize == 0 || section.offset % kSectionAlignment != 0 ||
+        section.offset > size_) {
+      return fail("Scene cache section is malformed");
+    }
+    if ((size_ - section.offset) / section.elementSize < section.count) {
+      return fail("Scene cache is truncated");
+    }
+  }
+
+  igl::Result::setOk(outResult);
+  return true;
+}
+
+bool SceneCache::hasSection(uint32_t id) const {
+  return findSection(id) != nullptr;
+}
+
+const SceneCache::SectionEntry* IGL_NULLABLE SceneCache::findSection(uint32_t id) const {
+  for (uint32_t i = 0; i != numSections_; i++) {
+    if (sections_[i].id == id) {
+      return &sections_[i];
+    }
+  }
+  return nullptr;
+}
+
+} // namespace scenecache
+} // namespace iglu
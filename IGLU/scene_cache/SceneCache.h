@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <igl/Common.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace iglu {
+namespace scenecache {
+
+/// Builds a section id from 4 characters, e.g. makeSectionId('V', 'E', 'R', 'T')
+constexpr uint32_t makeSectionId(char a, char b, char c, char d) {
+  return static_cast<uint32_t>(static_cast<uint8_t>(a)) |
+         (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8) |
+         (static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16) |
+         (static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24);
+}
+
+/// Read-only view of the elements of a section
+template<typename T>
+struct SectionView {
+  const T* data = nullptr;
+  size_t count = 0;
+
+  [[nodiscard]] bool empty() const {
+    return count == 0;
+  }
+  [[nodiscard]] const T* begin() const {
+    return data;
+  }
+  [[nodiscard]] const T* end() const {
+    return data + count;
+  }
+  [[nodiscard]] const T& operator[](size_t i) const {
+    return data[i];
+  }
+};
+
+/**
+ * @brief Writes processed scene data, such as vertices, indices and materials, into a cache file
+ * which SceneCache can map back into memory without parsing or copying it.
+ *
+ * The file is a header followed by a table of sections. Each section is an array of trivially
+ * copyable elements identified by a 4-character id, and starts at a 16-byte aligned offset so
+ * that it can be used in place. `contentVersion` is chosen by the application: bumping it when
+ * the processing or the layout of the elements changes makes older caches be rejected.
+ *
+ * The data passed to addSection() is not copied and must stay alive until write() returns.
+ */
+class SceneCacheWriter final {
+ public:
+  explicit SceneCacheWriter(uint32_t contentVersion) : contentVersion_(contentVersion) {}
+
+  void addSection(uint32_t id, const void* data, size_t elementSize, size_t count);
+
+  template<typename T>
+  void addSection(uint32_t id, const std::vector<T>& data) {
+    addSection(id, data.data(), sizeof(T), data.size());
+  }
+
+  /// Writes to a temporary file first and renames it, so an interrupted write never leaves a
+  /// truncated cache behind
+  bool write(const std::string& path, igl::Result* IGL_NULLABLE outResult = nullptr) const;
+
+ private:
+  struct Section {
+    uint32_t id = 0;
+    uint32_t elementSize = 0;
+    const void* data = nullptr;
+    size_t count = 0;
+  };
+
+  uint32_t contentVersion_ = 0;
+  std::vector<Section> sections_;
+};
+
+/**
+ * @brief A cache file written by SceneCacheWriter, memory-mapped for reading.
+ *
+ * Sections point straight into the mapping, so a warm cache loads in the time the OS takes to
+ * page it in, and vertex and index data can be handed to IDevice::createBuffer() as is. The
+ * views returned by getSection() are valid as long as the SceneCache is alive.
+ *
+ * Caches are written in the native byte order and are not meant to be shared between machines.
+ */
+class SceneCache final {
+ public:
+  /// Maps the file at `path`. Returns nullptr if it does not exist, is malformed or was written
+  /// with a different `contentVersion`
+  static std::unique_ptr<SceneCache> open(const std::string& path,
+                                          uint32_t contentVersion,
+                                          igl::Result* IGL_NULLABLE outResult = nullptr);
+
+  /// Same as open() for contents already in memory, e.g. loaded through a platform file loader
+  static std::unique_ptr<SceneCache> fromMemory(std::vector<uint8_t> data,
+                                                uint32_t contentVersion,
+                                                igl::Result* IGL_NULLABLE outResult = nullptr);
+
+  ~SceneCache();
+  SceneCache(const SceneCache&) = delete;
+  SceneCache& operator=(const SceneCache&) = delete;
+
+  [[nodiscard]] bool hasSection(uint32_t id) const;
+
+  /// Returns an empty view if the section is missing or its elements are not of size sizeof(T)
+  template<typename T>
+  [[nodiscard]] SectionView<T> getSection(uint32_t id) const {
+    const auto* section = findSection(id);
+    if (section == nullptr || section->elementSize != sizeof(T)) {
+      return {};
+    }
+    return {reinterpret_cast<const T*>(data_ + section->offset),
+            static_cast<size_t>(section->count)};
+  }
+
+  template<typename T>
+  [[nodiscard]] std::vector<T> copySection(uint32_t id) const {
+    const auto view = getSection<T>(id);
+    return std::vector<T>(view.begin(), view.end());
+  }
+
+ private:
+  struct SectionEntry {
+    uint32_t id;
+    uint32_t elementSize;
+    uint64_t offset;
+    uint64_t count;
+  };
+
+  SceneCache() = default;
+  bool validate(uint32_t contentVersion, igl::Result* IGL_NULLABLE outResult);
+  [[nodiscard]] const SectionEntry* IGL_NULLABLE findSection(uint32_t id) const;
+
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  const SectionEntry* sections_ = nullptr;
+  uint32_t numSections_ = 0;
+
+  std::vector<uint8_t> ownedData_;
+  bool mapped_ = false;
+#if IGL_PLATFORM_WIN
+  void* fileHandle_ = nullptr;
+  void* mappingHandle_ = nullptr;
+#endif
+};
+
+} // namespace scenecache
+} // namespace iglu
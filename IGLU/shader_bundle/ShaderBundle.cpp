@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/shader_bundle/ShaderBundle.h>
+
+#include <cstring>
+#include <igl/ShaderCreator.h>
+#include <type_traits>
+
+namespace iglu {
+namespace shaderbundle {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x424C4749; // "IGLB"
+// to be incremented whenever the layout of the bundle changes
+constexpr uint32_t kVersion = 1;
+
+template<typename T>
+void write(std::vector<uint8_t>& data, T value) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+  data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+void writeString(std::vector<uint8_t>& data, const std::string& str) {
+  write(data, static_cast<uint32_t>(str.size()));
+  data.insert(data.end(), str.begin(), str.end());
+}
+
+// All reads fail once the end of the data has been reached
+class Reader {
+ public:
+  Reader(const uint8_t* data, size_t length) : data_(data), length_(length) {}
+
+  template<typename T>
+  bool read(T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (!data_ || length_ - offset_ < sizeof(T)) {
+      return fail();
+    }
+    std::memcpy(&value, data_ + offset_, sizeof(T));
+    offset_ += sizeof(T);
+    return true;
+  }
+  bool readString(std::string& str) {
+    uint32_t size = 0;
+    if (!read(size) || length_ - offset_ < size) {
+      return fail();
+    }
+    str.assign(reinterpret_cast<const char*>(data_ + offset_), size);
+    offset_ += size;
+    return true;
+  }
+  [[nodiscard]] bool isOk() const {
+    return ok_;
+  }
+
+ private:
+  bool fail() {
+    offset_ = length_;
+    ok_ = false;
+    return false;
+  }
+
+ private:
+  const uint8_t* data_;
+  size_t length_;
+  size_t offset_ = 0;
+  bool ok_ = true;
+};
+
+std::shared_ptr<igl::IShaderModule> createShaderModule(const igl::IDevice& device,
+                                                       const ShaderBundle& bundle,
+                                                       igl::ShaderStage stage,
+                                                       const std::string& debugName,
+                                                       igl::Result* outResult) {
+  const igl::ShaderFamily family = device.getShaderVersion().family;
+  const ShaderBundleEntry* entry = bundle.find(family, stage);
+  if (!entry) {
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::ArgumentOutOfRange,
+                           "The shader bundle has no entry for the shader family of the device");
+    return nullptr;
+  }
+
+  const igl::ShaderModuleInfo info{stage, entry->entryPoint, {}};
+  if (entry->inputType == igl::ShaderInputType::Binary) {
+    return igl::ShaderModuleCreator::fromBinaryInput(
+        device, entry->data.data(), entry->data.size(), info, debugName, outResult);
+  }
+  return igl::ShaderModuleCreator::fromStringInput(
+      device, entry->data.c_str(), info, debugName, outResult);
+}
+
+} // namespace
+
+const ShaderBundleEntry* ShaderBundle::find(igl::ShaderFamily family,
+                                            igl::ShaderStage stage) const {
+  const ShaderBundleEntry* source = nullptr;
+  for (const auto& entry : entries) {
+    if (entry.family != family || entry.stage != stage) {
+      continue;
+    }
+    if (entry.inputType == igl::ShaderInputType::Binary) {
+      return &entry;
+    }
+    if (!source) {
+      source = &entry;
+    }
+  }
+  return source;
+}
+
+std::unique_ptr<igl::IShaderStages> ShaderBundle::createRenderShaderStages(
+    const igl::IDevice& device,
+    const std::string& debugName,
+    igl::Result* outResult) const {
+  auto vertexModule =
+      createShaderModule(device, *this, igl::ShaderStage::Vertex, debugName + " (vert)", outResult);
+  if (!vertexModule) {
+    return nullptr;
+  }
+  auto fragmentModule = createShaderModule(
+      device, *this, igl::ShaderStage::Fragment, debugName + " (frag)", outResult);
+  if (!fragmentModule) {
+    return nullptr;
+  }
+  return igl::ShaderStagesCreator::fromRenderModules(
+      device, std::move(vertexModule), std::move(fragmentModule), outResult);
+}
+
+std::unique_ptr<igl::IShaderStages> ShaderBundle::createComputeShaderStages(
+    const igl::IDevice& device,
+    const std::string& debugName,
+    igl::Result* outResult) const {
+  auto computeModule =
+      createShaderModule(device, *this, igl::ShaderStage::Compute, debugName, outResult);
+  if (!computeModule) {
+    return nullptr;
+  }
+  return igl::ShaderStagesCreator::fromComputeModule(device, std::move(computeModule), outResult);
+}
+
+std::vector<uint8_t> ShaderBundle::serialize() const {
+  std::vector<uint8_t> data;
+  write(data, kMagic);
+  write(data, kVersion);
+  write(data, static_cast<uint32_t>(entries.size()));
+  for (const auto& entry : entries) {
+    write(data, entry.family);
+    write(data, entry.inputType);
+    write(data, entry.stage);
+    writeString(data, entry.entryPoint);
+    writeString(data, entry.data);
+  }
+  return data;
+}
+
+ShaderBundle ShaderBundle::deserialize(const uint8_t* data,
+                                       size_t length,
+                                       igl::Result* outResult) {
+  Reader reader(data, length);
+
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  if (!reader.read(magic) || !reader.read(version) || magic != kMagic || version != kVersion) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "Not a shader bundle of this version");
+    return {};
+  }
+
+  ShaderBundle bundle;
+  uint32_t count = 0;
+  reader.read(count);
+  for (uint32_t i = 0; i != count && reader.isOk(); i++) {
+    ShaderBundleEntry& entry = bundle.entries.emplace_back();
+    reader.read(entry.family);
+    reader.read(entry.inputType);
+    reader.read(entry.stage);
+    reader.readString(entry.entryPoint);
+    reader.readString(entry.data);
+  }
+
+  if (!reader.isOk()) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "Corrupted shader bundle");
+    return {};
+  }
+
+  igl::Result::setOk(outResult);
+  return bundle;
+}
+
+} // namespace shaderbundle
+} // namespace iglu
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/IGL.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace iglu {
+namespace shaderbundle {
+
+/// One stage of a shader program in the form consumed by one shader family
+struct ShaderBundleEntry {
+  /// SpirV and Metal entries are usually binaries (SPIR-V, metallib), Glsl and GlslEs entries are
+  /// sources, since OpenGL program binaries are specific to a driver
+  igl::ShaderFamily family = igl::ShaderFamily::Unknown;
+  igl::ShaderInputType inputType = igl::ShaderInputType::Binary;
+  igl::ShaderStage stage = igl::ShaderStage::Fragment;
+  std::string entryPoint = "main";
+  /// Binary data or source code, depending on `inputType`
+  std::string data;
+};
+
+/**
+ * @brief The stages of one shader program compiled ahead of time for every shader family an
+ * application ships with, e.g. SPIR-V compiled from a single GLSL source and the MSL and GLSL ES
+ * cross-compiled from it, with the MSL compiled into a metallib.
+ *
+ * createRenderShaderStages() and createComputeShaderStages() pick the entries matching the shader
+ * family of the device and pass them to IDevice::createShaderModule(), so Vulkan and Metal skip
+ * runtime shader compilation entirely.
+ */
+struct ShaderBundle {
+  std::vector<ShaderBundleEntry> entries;
+
+  /// Returns the entry for `stage` in the form preferred by `family`, binaries before sources, or
+  /// nullptr if the bundle has none
+  [[nodiscard]] const ShaderBundleEntry* IGL_NULLABLE find(igl::ShaderFamily family,
+                                                           igl::ShaderStage stage) const;
+
+  std::unique_ptr<igl::IShaderStages> createRenderShaderStages(
+      const igl::IDevice& device,
+      const std::string& debugName,
+      igl::Result* IGL_NULLABLE outResult) const;
+  std::unique_ptr<igl::IShaderStages> createComputeShaderStages(
+      const igl::IDevice& device,
+      const std::string& debugName,
+      igl::Result* IGL_NULLABLE outResult) const;
+
+  /// Compact binary representation, e.g. written by a build step and packaged with the assets
+  [[nodiscard]] std::vector<uint8_t> serialize() const;
+  /// Parses data returned by serialize(). The bundle is empty if the data is invalid or was
+  /// written by an incompatible version.
+  static ShaderBundle deserialize(const uint8_t* IGL_NULLABLE data,
+                                  size_t length,
+                                  igl::Result* IGL_NULLABLE outResult);
+};
+
+} // namespace shaderbundle
+} // namespace iglu
@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/shader_hot_reload/ShaderHotReloader.h>
+
+#include <fstream>
+#include <sstream>
+
+namespace iglu {
+namespace shaderhotreload {
+
+namespace {
+
+std::optional<std::string> readFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return std::nullopt;
+  }
+  std::ostringstream stream;
+  stream << file.rdbuf();
+  return stream.str();
+}
+
+} // namespace
+
+ShaderHotReloader::ShaderHotReloader(igl::IDevice& device, std::chrono::milliseconds pollInterval) :
+  device_(device),
+  pollInterval_(pollInterval),
+  // OpenGL shader objects can only be created on the thread of their context
+  compileOnWorkerThread_(device.getBackendType() != igl::BackendType::OpenGL) {
+  worker_ = std::thread([this]() { watch(); });
+}
+
+ShaderHotReloader::~ShaderHotReloader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wakeUp_.notify_one();
+  worker_.join();
+}
+
+size_t ShaderHotReloader::getOrAddModule(const ShaderSource& source) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (size_t i = 0; i != modules_.size(); i++) {
+    const ShaderSource& s = modules_[i]->source;
+    if (s.path == source.path && s.info.stage == source.info.stage &&
+        s.info.entryPoint == source.info.entryPoint) {
+      return i;
+    }
+  }
+  auto module = std::make_unique<Module>();
+  module->source = source;
+  std::error_code ec;
+  module->lastWriteTime = std::filesystem::last_write_time(source.path, ec);
+  modules_.push_back(std::move(module));
+  return modules_.size() - 1;
+}
+
+std::shared_ptr<igl::IShaderModule> ShaderHotReloader::compile(const Module& module,
+                                                               const std::string& code,
+                                                               igl::Result* outResult) const {
+  auto shaderModule = device_.createShaderModule(
+      igl::ShaderModuleDesc::fromStringInput(code.c_str(), module.source.info, module.source.path),
+      outResult);
+  if (outResult && !outResult->isOk()) {
+    IGL_LOG_ERROR("ShaderHotReloader: %s: %s\n",
+                  module.source.path.c_str(),
+                  outResult->message.c_str());
+  }
+  return shaderModule;
+}
+
+ShaderHotReloader::PipelineHandle ShaderHotReloader::addRenderPipeline(
+    const igl::RenderPipelineDesc& desc,
+    const ShaderSource& vertex,
+    const ShaderSource& fragment,
+    igl::Result* outResult) {
+  Pipeline pipeline;
+  pipeline.desc = desc;
+  pipeline.vertexModule = getOrAddModule(vertex);
+  pipeline.fragmentModule = getOrAddModule(fragment);
+
+  for (const size_t index : {pipeline.vertexModule, pipeline.fragmentModule}) {
+    Module& module = *modules_[index];
+    if (module.module) {
+      continue;
+    }
+    std::optional<std::string> code;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      code = std::move(module.pendingCode);
+      module.pendingCode.reset();
+    }
+    if (!code && !module.source.code.empty()) {
+      code = module.source.code;
+    }
+    if (!code) {
+      code = readFile(module.source.path);
+    }
+    if (!code) {
+      igl::Result::setResult(
+          outResult, igl::Result::Code::ArgumentInvalid, "Cannot read " + module.source.path);
+      return kInvalidPipeline;
+    }
+    module.module = compile(module, *code, outResult);
+    if (!module.module) {
+      return kInvalidPipeline;
+    }
+  }
+
+  pipeline.desc.shaderStages = igl::ShaderStagesCreator::fromRenderModules(
+      device_,
+      modules_[pipeline.vertexModule]->module,
+      modules_[pipeline.fragmentModule]->module,
+      outResult);
+  if (!pipeline.desc.shaderStages) {
+    return kInvalidPipeline;
+  }
+  pipeline.state = device_.createRenderPipeline(pipeline.desc, &pipeline.lastResult);
+  igl::Result::setResult(outResult, pipeline.lastResult);
+  if (!pipeline.state) {
+    return kInvalidPipeline;
+  }
+
+  pipelines_.push_back(std::move(pipeline));
+  return static_cast<PipelineHandle>(pipelines_.size() - 1);
+}
+
+std::shared_ptr<igl::IRenderPipelineState> ShaderHotReloader::getRenderPipeline(
+    PipelineHandle handle) const {
+  return handle < pipelines_.size() ? pipelines_[handle].state : nullptr;
+}
+
+igl::Result ShaderHotReloader::getLastResult(PipelineHandle handle) const {
+  if (handle >= pipelines_.size()) {
+    return igl::Result(igl::Result::Code::ArgumentOutOfRange, "Invalid pipeline handle");
+  }
+  return pipelines_[handle].lastResult;
+}
+
+void ShaderHotReloader::updateSource(const std::string& path, std::string source) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& module : modules_) {
+      if (module->source.path == path) {
+        module->pendingCode = source;
+        module->compiled = false;
+      }
+    }
+  }
+  wakeUp_.notify_one();
+}
+
+void ShaderHotReloader::watch() {
+  IGL_PROFILER_THREAD("ShaderHotReloader");
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    if (pollInterval_.count() > 0) {
+      wakeUp_.wait_for(lock, pollInterval_);
+    } else {
+      wakeUp_.wait(lock);
+    }
+    if (stop_) {
+      break;
+    }
+    lock.unlock();
+    pollSources();
+    lock.lock();
+  }
+}
+
+void ShaderHotReloader::pollSources() {
+  IGL_PROFILER_FUNCTION();
+
+  std::vector<Module*> modules;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    modules.reserve(modules_.size());
+    for (auto& module : modules_) {
+      modules.push_back(module.get());
+    }
+  }
+
+  if (pollInterval_.count() > 0) {
+    for (Module* module : modules) {
+      std::error_code ec;
+      const auto lastWriteTime = std::filesystem::last_write_time(module->source.path, ec);
+      if (ec || lastWriteTime == module->lastWriteTime) {
+        continue;
+      }
+      module->lastWriteTime = lastWriteTime;
+      if (auto code = readFile(module->source.path)) {
+        updateSource(module->source.path, std::move(*code));
+      }
+    }
+  }
+
+  if (!compileOnWorkerThread_) {
+    return;
+  }
+
+  for (Module* module : modules) {
+    std::string code;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!module->pendingCode) {
+        continue;
+      }
+      code = std::move(*module->pendingCode);
+      module->pendingCode.reset();
+    }
+    igl::Result result;
+    auto shaderModule = compile(*module, code, &result);
+    std::lock_guard<std::mutex> lock(mutex_);
+    // skip the result if an even newer source arrived while compiling
+    if (!module->pendingCode) {
+      module->compiledModule = std::move(shaderModule);
+      module->compileResult = std::move(result);
+      module->compiled = true;
+    }
+  }
+}
+
+void ShaderHotReloader::rebuild(PipelineHandle handle) {
+  Pipeline& pipeline = pipelines_[handle];
+  const uint32_t generation = ++pipeline.generation;
+
+  igl::RenderPipelineDesc desc = pipeline.desc;
+  desc.shaderStages =
+      igl::ShaderStagesCreator::fromRenderModules(device_,
+                                                  modules_[pipeline.vertexModule]->module,
+                                                  modules_[pipeline.fragmentModule]->module,
+                                                  &pipeline.lastResult);
+  if (!desc.shaderStages) {
+    return;
+  }
+
+  device_.createRenderPipelineAsync(
+      desc,
+      // the shader stages must outlive the creation of the pipeline
+      [builtPipelines = builtPipelines_, handle, generation, shaderStages = desc.shaderStages](
+          std::shared_ptr<igl::IRenderPipelineState> state, igl::Result result) {
+        std::lock_guard<std::mutex> lock(builtPipelines->mutex);
+        builtPipelines->pipelines.push_back(
+            BuiltPipeline{handle, generation, std::move(state), std::move(result)});
+      });
+}
+
+size_t ShaderHotReloader::update() {
+  IGL_PROFILER_FUNCTION();
+
+  // 1. Pick up the modules which changed
+  std::vector<size_t> changedModules;
+  std::vector<std::pair<size_t, std::string>> codeToCompile;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i != modules_.size(); i++) {
+      Module& module = *modules_[i];
+      if (module.compiled) {
+        module.compiled = false;
+        if (module.compileResult.isOk()) {
+          module.module = std::move(module.compiledModule);
+          changedModules.push_back(i);
+        } else {
+          for (auto& pipeline : pipelines_) {
+            if (pipeline.vertexModule == i || pipeline.fragmentModule == i) {
+              pipeline.lastResult = module.compileResult;
+            }
+          }
+        }
+        module.compiledModule = nullptr;
+      } else if (!compileOnWorkerThread_ && module.pendingCode) {
+        codeToCompile.emplace_back(i, std::move(*module.pendingCode));
+        module.pendingCode.reset();
+      }
+    }
+  }
+
+  for (const auto& [index, code] : codeToCompile) {
+    Module& module = *modules_[index];
+    igl::Result result;
+    if (auto shaderModule = compile(module, code, &result)) {
+      module.module = std::move(shaderModule);
+      changedModules.push_back(index);
+    } else {
+      for (auto& pipeline : pipelines_) {
+        if (pipeline.vertexModule == index || pipeline.fragmentModule == index) {
+          pipeline.lastResult = result;
+        }
+      }
+    }
+  }
+
+  // 2. Rebuild only the pipelines using them
+  for (size_t handle = 0; handle != pipelines_.size(); handle++) {
+    const Pipeline& pipeline = pipelines_[handle];
+    for (const size_t index : changedModules) {
+      if (pipeline.vertexModule == index || pipeline.fragmentModule == index) {
+        rebuild(static_cast<PipelineHandle>(handle));
+        break;
+      }
+    }
+  }
+
+  // 3. Swap in the pipelines built since the last update
+  std::vector<BuiltPipeline> builtPipelines;
+  {
+    std::lock_guard<std::mutex> lock(builtPipelines_->mutex);
+    builtPipelines.swap(builtPipelines_->pipelines);
+  }
+  size_t numSwapped = 0;
+  for (auto& built : builtPipelines) {
+    Pipeline& pipeline = pipelines_[built.handle];
+    if (built.generation != pipeline.generation) {
+      continue;
+    }
+    pipeline.lastResult = built.result;
+    if (built.state) {
+      pipeline.state = std::move(built.state);
+      numSwapped++;
+    } else {
+      IGL_LOG_ERROR("ShaderHotReloader: cannot rebuild pipeline %u: %s\n",
+                    built.handle,
+                    built.result.message.c_str());
+    }
+  }
+  return numSwapped;
+}
+
+} // namespace shaderhotreload
+} // namespace iglu
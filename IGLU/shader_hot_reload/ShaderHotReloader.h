@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <igl/IGL.h>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace iglu {
+namespace shaderhotreload {
+
+/// A shader module of a hot-reloaded pipeline
+struct ShaderSource {
+  /// File containing the source code of the module. It is watched for changes. It can also be any
+  /// name used with ShaderHotReloader::updateSource(), e.g. for sources streamed over the network.
+  std::string path;
+  igl::ShaderModuleInfo info;
+  /// Initial source code. If empty, it is read from `path`.
+  std::string code;
+};
+
+/**
+ * @brief Recompiles shader modules when their source changes and rebuilds only the render
+ * pipelines which use them, while the application runs.
+ *
+ * Sources come from files, which a worker thread checks for modifications, or from
+ * updateSource(). Changed modules are compiled on the worker thread, except on OpenGL where the
+ * shader objects belong to the context of the render thread and are compiled by update(). The
+ * dependent pipelines are then recreated with IDevice::createRenderPipelineAsync() and swapped in
+ * by a later update(). Until then, and whenever a compilation fails, the previous pipeline state
+ * keeps being used, so a typo in a shader never breaks the running application.
+ *
+ * All the functions except updateSource() must be called on the render thread.
+ */
+class ShaderHotReloader final {
+ public:
+  using PipelineHandle = uint32_t;
+  static constexpr PipelineHandle kInvalidPipeline = ~0u;
+
+  /// Files are checked every `pollInterval`. A zero interval disables the file watcher: sources
+  /// then only change through updateSource().
+  explicit ShaderHotReloader(
+      igl::IDevice& device,
+      std::chrono::milliseconds pollInterval = std::chrono::milliseconds(250));
+  ~ShaderHotReloader();
+
+  ShaderHotReloader(const ShaderHotReloader&) = delete;
+  ShaderHotReloader& operator=(const ShaderHotReloader&) = delete;
+
+  /// Compiles the sources and creates a pipeline from `desc`, whose shader stages are ignored.
+  /// Sources already known by the reloader are shared with the other pipelines using them.
+  PipelineHandle addRenderPipeline(const igl::RenderPipelineDesc& desc,
+                                   const ShaderSource& vertex,
+                                   const ShaderSource& fragment,
+                                   igl::Result* IGL_NULLABLE outResult);
+  /// The latest successfully built state of the pipeline
+  [[nodiscard]] std::shared_ptr<igl::IRenderPipelineState> getRenderPipeline(
+      PipelineHandle handle) const;
+  /// The result of the latest compilation or creation of the pipeline, e.g. to show shader errors
+  [[nodiscard]] igl::Result getLastResult(PipelineHandle handle) const;
+
+  /// Replaces the source code of the modules from `path`. Can be called from any thread, e.g. by a
+  /// network listener.
+  void updateSource(const std::string& path, std::string source);
+
+  /// Rebuilds the pipelines using the modules which changed, and swaps in the pipelines rebuilt
+  /// since the previous call. To be called once per frame.
+  /// @return The number of pipelines swapped in
+  size_t update();
+
+ private:
+  struct Module {
+    ShaderSource source;
+    std::filesystem::file_time_type lastWriteTime{};
+    // shared with the worker thread, guarded by mutex_
+    std::optional<std::string> pendingCode;
+    std::shared_ptr<igl::IShaderModule> compiledModule;
+    igl::Result compileResult;
+    bool compiled = false;
+    // render thread only
+    std::shared_ptr<igl::IShaderModule> module;
+  };
+
+  struct Pipeline {
+    igl::RenderPipelineDesc desc;
+    size_t vertexModule = 0;
+    size_t fragmentModule = 0;
+    std::shared_ptr<igl::IRenderPipelineState> state;
+    igl::Result lastResult;
+    // incremented by every rebuild, so that only the latest one is swapped in
+    uint32_t generation = 0;
+  };
+
+  struct BuiltPipeline {
+    PipelineHandle handle = kInvalidPipeline;
+    uint32_t generation = 0;
+    std::shared_ptr<igl::IRenderPipelineState> state;
+    igl::Result result;
+  };
+
+  // pipelines created by createRenderPipelineAsync(), which may complete on any thread and after
+  // the reloader is destroyed
+  struct BuiltPipelines {
+    std::mutex mutex;
+    std::vector<BuiltPipeline> pipelines;
+  };
+
+  size_t getOrAddModule(const ShaderSource& source);
+  std::shared_ptr<igl::IShaderModule> compile(const Module& module,
+                                              const std::string& code,
+                                              igl::Result* IGL_NULLABLE outResult) const;
+  void rebuild(PipelineHandle handle);
+  void watch();
+  // reads the files which changed and compiles the modules if the worker thread can
+  void pollSources();
+
+  igl::IDevice& device_;
+  const std::chrono::milliseconds pollInterval_;
+  const bool compileOnWorkerThread_;
+
+  // modules_ is guarded by mutex_ for additions and for the fields shared with the worker thread
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Module>> modules_;
+  std::vector<Pipeline> pipelines_;
+  std::shared_ptr<BuiltPipelines> builtPipelines_ = std::make_shared<BuiltPipelines>();
+
+  std::condition_variable wakeUp_;
+  bool stop_ = false;
+  std::thread worker_;
+};
+
+} // namespace shaderhotreload
+} // namespace iglu
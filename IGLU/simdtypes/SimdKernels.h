@@ -0,0 +1,416 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/simdtypes/SimdTypes.h>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define IGLU_SIMD_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define IGLU_SIMD_SSE 1
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define IGLU_SIMD_WASM 1
+#endif
+
+/// Batch kernels over arrays of matrices and bounding volumes, vectorized with NEON, SSE (FMA when
+/// enabled at compile time) or WebAssembly SIMD, with a scalar fallback.
+///
+/// Matrices are column-major, like float4x4. Bounding volumes are in structure of arrays layout so
+/// that 4 objects are tested at once. No alignment is required.
+
+namespace iglu {
+namespace simdtypes {
+
+/// Frustum planes with inward facing normals: xyz normal, w distance
+struct FrustumPlanes {
+  float planes[6][4];
+};
+
+/// Structure of arrays of 'count' spheres
+struct SpheresSoA {
+  const float* centerX = nullptr;
+  const float* centerY = nullptr;
+  const float* centerZ = nullptr;
+  const float* radius = nullptr;
+};
+
+/// Structure of arrays of 'count' axis aligned bounding boxes
+struct AabbsSoA {
+  const float* minX = nullptr;
+  const float* minY = nullptr;
+  const float* minZ = nullptr;
+  const float* maxX = nullptr;
+  const float* maxY = nullptr;
+  const float* maxZ = nullptr;
+};
+
+namespace detail {
+
+#if IGLU_SIMD_NEON
+
+using vfloat4 = float32x4_t;
+using vmask4 = uint32x4_t;
+
+inline vfloat4 load(const float* p) {
+  return vld1q_f32(p);
+}
+inline void store(float* p, vfloat4 v) {
+  vst1q_f32(p, v);
+}
+inline vfloat4 splat(float f) {
+  return vdupq_n_f32(f);
+}
+inline vfloat4 add(vfloat4 a, vfloat4 b) {
+  return vaddq_f32(a, b);
+}
+inline vfloat4 sub(vfloat4 a, vfloat4 b) {
+  return vsubq_f32(a, b);
+}
+inline vfloat4 mul(vfloat4 a, vfloat4 b) {
+  return vmulq_f32(a, b);
+}
+// a * b + c
+inline vfloat4 madd(vfloat4 a, vfloat4 b, vfloat4 c) {
+  return vmlaq_f32(c, a, b);
+}
+inline vfloat4 abs(vfloat4 a) {
+  return vabsq_f32(a);
+}
+// (y, z, x, x)
+inline vfloat4 yzx(vfloat4 a) {
+  return vsetq_lane_f32(vgetq_lane_f32(a, 0), vextq_f32(a, a, 1), 2);
+}
+inline vmask4 lessThan(vfloat4 a, vfloat4 b) {
+  return vcltq_f32(a, b);
+}
+inline vmask4 maskOr(vmask4 a, vmask4 b) {
+  return vorrq_u32(a, b);
+}
+// one bit per lane
+inline int bitmask(vmask4 m) {
+  return static_cast<int>((vgetq_lane_u32(m, 0) & 1) | (vgetq_lane_u32(m, 1) & 2) |
+                          (vgetq_lane_u32(m, 2) & 4) | (vgetq_lane_u32(m, 3) & 8));
+}
+
+#elif IGLU_SIMD_SSE
+
+using vfloat4 = __m128;
+using vmask4 = __m128;
+
+inline vfloat4 load(const float* p) {
+  return _mm_loadu_ps(p);
+}
+inline void store(float* p, vfloat4 v) {
+  _mm_storeu_ps(p, v);
+}
+inline vfloat4 splat(float f) {
+  return _mm_set1_ps(f);
+}
+inline vfloat4 add(vfloat4 a, vfloat4 b) {
+  return _mm_add_ps(a, b);
+}
+inline vfloat4 sub(vfloat4 a, vfloat4 b) {
+  return _mm_sub_ps(a, b);
+}
+inline vfloat4 mul(vfloat4 a, vfloat4 b) {
+  return _mm_mul_ps(a, b);
+}
+// a * b + c
+inline vfloat4 madd(vfloat4 a, vfloat4 b, vfloat4 c) {
+#if defined(__FMA__)
+  return _mm_fmadd_ps(a, b, c);
+#else
+  return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+inline vfloat4 abs(vfloat4 a) {
+  return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+}
+// (y, z, x, w)
+inline vfloat4 yzx(vfloat4 a) {
+  return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+}
+inline vmask4 lessThan(vfloat4 a, vfloat4 b) {
+  return _mm_cmplt_ps(a, b);
+}
+inline vmask4 maskOr(vmask4 a, vmask4 b) {
+  return _mm_or_ps(a, b);
+}
+// one bit per lane
+inline int bitmask(vmask4 m) {
+  return _mm_movemask_ps(m);
+}
+
+#elif IGLU_SIMD_WASM
+
+using vfloat4 = v128_t;
+using vmask4 = v128_t;
+
+inline vfloat4 load(const float* p) {
+  return wasm_v128_load(p);
+}
+inline void store(float* p, vfloat4 v) {
+  wasm_v128_store(p, v);
+}
+inline vfloat4 splat(float f) {
+  return wasm_f32x4_splat(f);
+}
+inline vfloat4 add(vfloat4 a, vfloat4 b) {
+  return wasm_f32x4_add(a, b);
+}
+inline vfloat4 sub(vfloat4 a, vfloat4 b) {
+  return wasm_f32x4_sub(a, b);
+}
+inline vfloat4 mul(vfloat4 a, vfloat4 b) {
+  return wasm_f32x4_mul(a, b);
+}
+// a * b + c
+inline vfloat4 madd(vfloat4 a, vfloat4 b, vfloat4 c) {
+  return wasm_f32x4_add(wasm_f32x4_mul(a, b), c);
+}
+inline vfloat4 abs(vfloat4 a) {
+  return wasm_f32x4_abs(a);
+}
+// (y, z, x, w)
+inline vfloat4 yzx(vfloat4 a) {
+  return wasm_i32x4_shuffle(a, a, 1, 2, 0, 3);
+}
+inline vmask4 lessThan(vfloat4 a, vfloat4 b) {
+  return wasm_f32x4_lt(a, b);
+}
+inline vmask4 maskOr(vmask4 a, vmask4 b) {
+  return wasm_v128_or(a, b);
+}
+// one bit per lane
+inline int bitmask(vmask4 m) {
+  return static_cast<int>(wasm_i32x4_bitmask(m));
+}
+
+#else
+
+struct vfloat4 {
+  float v[4];
+};
+struct vmask4 {
+  bool v[4];
+};
+
+inline vfloat4 load(const float* p) {
+  return {{p[0], p[1], p[2], p[3]}};
+}
+inline void store(float* p, vfloat4 a) {
+  for (int i = 0; i != 4; ++i) {
+    p[i] = a.v[i];
+  }
+}
+inline vfloat4 splat(float f) {
+  return {{f, f, f, f}};
+}
+inline vfloat4 add(vfloat4 a, vfloat4 b) {
+  return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+}
+inline vfloat4 sub(vfloat4 a, vfloat4 b) {
+  return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+}
+inline vfloat4 mul(vfloat4 a, vfloat4 b) {
+  return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+}
+// a * b + c
+inline vfloat4 madd(vfloat4 a, vfloat4 b, vfloat4 c) {
+  return add(mul(a, b), c);
+}
+inline vfloat4 abs(vfloat4 a) {
+  for (float& f : a.v) {
+    f = f < 0.0f ? -f : f;
+  }
+  return a;
+}
+// (y, z, x, w)
+inline vfloat4 yzx(vfloat4 a) {
+  return {{a.v[1], a.v[2], a.v[0], a.v[3]}};
+}
+inline vmask4 lessThan(vfloat4 a, vfloat4 b) {
+  return {{a.v[0] < b.v[0], a.v[1] < b.v[1], a.v[2] < b.v[2], a.v[3] < b.v[3]}};
+}
+inline vmask4 maskOr(vmask4 a, vmask4 b) {
+  return {{a.v[0] || b.v[0], a.v[1] || b.v[1], a.v[2] || b.v[2], a.v[3] || b.v[3]}};
+}
+// one bit per lane
+inline int bitmask(vmask4 m) {
+  return int(m.v[0]) | (int(m.v[1]) << 1) | (int(m.v[2]) << 2) | (int(m.v[3]) << 3);
+}
+
+#endif
+
+inline vmask4 noneMask() {
+  return lessThan(splat(0.0f), splat(0.0f));
+}
+
+// a x b in xyz, the w lane is undefined
+inline vfloat4 cross(vfloat4 a, vfloat4 b) {
+  return yzx(sub(mul(a, yzx(b)), mul(yzx(a), b)));
+}
+
+// writes the visibility of 4 objects culled by 'culledMask' and returns how many are visible
+inline size_t storeVisibility(int culledMask, uint8_t* visible) {
+  size_t numVisible = 0;
+  for (int lane = 0; lane != 4; ++lane) {
+    visible[lane] = (culledMask & (1 << lane)) ? 0 : 1;
+    numVisible += visible[lane];
+  }
+  return numVisible;
+}
+
+} // namespace detail
+
+/// out[i] = m * in[i], e.g. world matrices from a parent matrix and local matrices. 'out' may
+/// alias 'in'.
+inline void multiplyBatch(const float4x4& m, const float4x4* in, float4x4* out, size_t count) {
+  const auto* mf = reinterpret_cast<const float*>(&m);
+  const detail::vfloat4 c0 = detail::load(mf);
+  const detail::vfloat4 c1 = detail::load(mf + 4);
+  const detail::vfloat4 c2 = detail::load(mf + 8);
+  const detail::vfloat4 c3 = detail::load(mf + 12);
+  for (size_t i = 0; i != count; ++i) {
+    const auto* src = reinterpret_cast<const float*>(&in[i]);
+    float result[16];
+    for (size_t col = 0; col != 4; ++col) {
+      const float* b = src + col * 4;
+      detail::vfloat4 r = detail::mul(c0, detail::splat(b[0]));
+      r = detail::madd(c1, detail::splat(b[1]), r);
+      r = detail::madd(c2, detail::splat(b[2]), r);
+      r = detail::madd(c3, detail::splat(b[3]), r);
+      detail::store(result + col * 4, r);
+    }
+    auto* dst = reinterpret_cast<float*>(&out[i]);
+    for (size_t j = 0; j != 16; ++j) {
+      dst[j] = result[j];
+    }
+  }
+}
+
+/// Writes the normal matrices of 'models', i.e. the inverse transpose of their upper 3x3, packed
+/// in 3 columns of 4 floats as std140 mat3 uniforms. Singular matrices keep their cofactors.
+inline void normalMatrixBatch(const float4x4* models, float3x4* out, size_t count) {
+  for (size_t i = 0; i != count; ++i) {
+    const auto* m = reinterpret_cast<const float*>(&models[i]);
+    const detail::vfloat4 a = detail::load(m);
+    const detail::vfloat4 b = detail::load(m + 4);
+    const detail::vfloat4 c = detail::load(m + 8);
+    // the columns of the inverse transpose are the cross products of the columns over the
+    // determinant
+    const detail::vfloat4 bc = detail::cross(b, c);
+    const detail::vfloat4 ca = detail::cross(c, a);
+    const detail::vfloat4 ab = detail::cross(a, b);
+    float dot[4];
+    detail::store(dot, detail::mul(a, bc));
+    const float det = dot[0] + dot[1] + dot[2];
+    const detail::vfloat4 invDet = detail::splat(det != 0.0f ? 1.0f / det : 1.0f);
+    auto* dst = reinterpret_cast<float*>(&out[i]);
+    detail::store(dst, detail::mul(bc, invDet));
+    detail::store(dst + 4, detail::mul(ca, invDet));
+    detail::store(dst + 8, detail::mul(ab, invDet));
+    dst[3] = dst[7] = dst[11] = 0.0f;
+  }
+}
+
+/// Frustum culling of 'count' spheres. Writes 1 to 'visible' for the spheres which intersect the
+/// frustum and 0 otherwise.
+/// @return The number of visible spheres
+inline size_t cullSpheres(const FrustumPlanes& frustum,
+                          const SpheresSoA& spheres,
+                          size_t count,
+                          uint8_t* visible) {
+  size_t numVisible = 0;
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const detail::vfloat4 x = detail::load(spheres.centerX + i);
+    const detail::vfloat4 y = detail::load(spheres.centerY + i);
+    const detail::vfloat4 z = detail::load(spheres.centerZ + i);
+    const detail::vfloat4 negRadius =
+        detail::sub(detail::splat(0.0f), detail::load(spheres.radius + i));
+    detail::vmask4 culled = detail::noneMask();
+    for (const auto& plane : frustum.planes) {
+      detail::vfloat4 d = detail::madd(x, detail::splat(plane[0]), detail::splat(plane[3]));
+      d = detail::madd(y, detail::splat(plane[1]), d);
+      d = detail::madd(z, detail::splat(plane[2]), d);
+      culled = detail::maskOr(culled, detail::lessThan(d, negRadius));
+    }
+    numVisible += detail::storeVisibility(detail::bitmask(culled), visible + i);
+  }
+  for (; i != count; ++i) {
+    bool isVisible = true;
+    for (const auto& plane : frustum.planes) {
+      const float d = plane[0] * spheres.centerX[i] + plane[1] * spheres.centerY[i] +
+                      plane[2] * spheres.centerZ[i] + plane[3];
+      isVisible = isVisible && d >= -spheres.radius[i];
+    }
+    visible[i] = isVisible ? 1 : 0;
+    numVisible += visible[i];
+  }
+  return numVisible;
+}
+
+/// Frustum culling of 'count' axis aligned bounding boxes. Writes 1 to 'visible' for the boxes
+/// which intersect the frustum and 0 otherwise. Conservative near the frustum corners.
+/// @return The number of visible boxes
+inline size_t cullAabbs(const FrustumPlanes& frustum,
+                        const AabbsSoA& aabbs,
+                        size_t count,
+                        uint8_t* visible) {
+  size_t numVisible = 0;
+  size_t i = 0;
+  const detail::vfloat4 half = detail::splat(0.5f);
+  for (; i + 4 <= count; i += 4) {
+    const detail::vfloat4 minX = detail::load(aabbs.minX + i);
+    const detail::vfloat4 minY = detail::load(aabbs.minY + i);
+    const detail::vfloat4 minZ = detail::load(aabbs.minZ + i);
+    const detail::vfloat4 maxX = detail::load(aabbs.maxX + i);
+    const detail::vfloat4 maxY = detail::load(aabbs.maxY + i);
+    const detail::vfloat4 maxZ = detail::load(aabbs.maxZ + i);
+    const detail::vfloat4 centerX = detail::mul(detail::add(minX, maxX), half);
+    const detail::vfloat4 centerY = detail::mul(detail::add(minY, maxY), half);
+    const detail::vfloat4 centerZ = detail::mul(detail::add(minZ, maxZ), half);
+    const detail::vfloat4 extentX = detail::mul(detail::sub(maxX, minX), half);
+    const detail::vfloat4 extentY = detail::mul(detail::sub(maxY, minY), half);
+    const detail::vfloat4 extentZ = detail::mul(detail::sub(maxZ, minZ), half);
+    detail::vmask4 culled = detail::noneMask();
+    for (const auto& plane : frustum.planes) {
+      // the distance of the center and the projected radius of the box on the plane normal
+      detail::vfloat4 d = detail::madd(centerX, detail::splat(plane[0]), detail::splat(plane[3]));
+      d = detail::madd(centerY, detail::splat(plane[1]), d);
+      d = detail::madd(centerZ, detail::splat(plane[2]), d);
+      detail::vfloat4 r = detail::mul(extentX, detail::abs(detail::splat(plane[0])));
+      r = detail::madd(extentY, detail::abs(detail::splat(plane[1])), r);
+      r = detail::madd(extentZ, detail::abs(detail::splat(plane[2])), r);
+      culled = detail::maskOr(culled, detail::lessThan(detail::add(d, r), detail::splat(0.0f)));
+    }
+    numVisible += detail::storeVisibility(detail::bitmask(culled), visible + i);
+  }
+  for (; i != count; ++i) {
+    bool isVisible = true;
+    for (const auto& plane : frustum.planes) {
+      // the corner of the box the furthest along the plane normal
+      const float d = plane[0] * (plane[0] >= 0.0f ? aabbs.maxX[i] : aabbs.minX[i]) +
+                      plane[1] * (plane[1] >= 0.0f ? aabbs.maxY[i] : aabbs.minY[i]) +
+                      plane[2] * (plane[2] >= 0.0f ? aabbs.maxZ[i] : aabbs.minZ[i]) + plane[3];
+      isVisible = isVisible && d >= 0.0f;
+    }
+    visible[i] = isVisible ? 1 : 0;
+    numVisible += visible[i];
+  }
+  return numVisible;
+}
+
+} // namespace simdtypes
+} // namespace iglu
@@ -28,6 +28,7 @@ void Drawable::draw(igl::IDevice& device,
 
     _pipelineState = device.createRenderPipeline(mutablePipelineDesc, nullptr);
     _lastPipelineDescHash = pipelineDescHash;
+    _pipelineCache = nullptr;
   }
 
   commandEncoder.bindRenderPipelineState(_pipelineState);
@@ -37,5 +38,28 @@ void Drawable::draw(igl::IDevice& device,
   _vertexData->draw(commandEncoder);
 }
 
+void Drawable::draw(igl::IDevice& device,
+                    igl::IRenderCommandEncoder& commandEncoder,
+                    PipelineCache& pipelineCache,
+                    const RenderTarget& target) {
+  commandEncoder.bindRenderPipelineState(pipelineState(pipelineCache, target));
+
+  _material->bind(device, *_pipelineState, commandEncoder);
+
+  _vertexData->draw(commandEncoder);
+}
+
+const std::shared_ptr<igl::IRenderPipelineState>& Drawable::pipelineState(
+    PipelineCache& pipelineCache,
+    const RenderTarget& target) {
+  if (!_pipelineState || _pipelineCache != &pipelineCache ||
+      target.signature != _lastPipelineDescHash) {
+    _pipelineState = pipelineCache.getPipelineState(_vertexData, _material, target);
+    _lastPipelineDescHash = target.signature;
+    _pipelineCache = &pipelineCache;
+  }
+  return _pipelineState;
+}
+
 } // namespace drawable
 } // namespace iglu
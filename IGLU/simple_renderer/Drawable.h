@@ -8,6 +8,7 @@
 #pragma once
 
 #include <IGLU/simple_renderer/Material.h>
+#include <IGLU/simple_renderer/PipelineCache.h>
 #include <IGLU/simple_renderer/VertexData.h>
 #include <memory>
 
@@ -26,6 +27,26 @@ class Drawable final {
             igl::IRenderCommandEncoder& commandEncoder,
             const igl::RenderPipelineDesc& pipelineDesc);
 
+  /// Same as above, with the pipeline state shared through 'pipelineCache'. The pipeline state
+  /// is only looked up again when the signature of 'target' changes.
+  void draw(igl::IDevice& device,
+            igl::IRenderCommandEncoder& commandEncoder,
+            PipelineCache& pipelineCache,
+            const RenderTarget& target);
+
+  /// Returns the pipeline state for drawing into 'target', looked up in 'pipelineCache' only when
+  /// the signature of 'target' changes. Used to sort drawables before drawing them.
+  const std::shared_ptr<igl::IRenderPipelineState>& pipelineState(PipelineCache& pipelineCache,
+                                                                  const RenderTarget& target);
+
+  const std::shared_ptr<vertexdata::VertexData>& vertexData() const {
+    return _vertexData;
+  }
+
+  const std::shared_ptr<material::Material>& material() const {
+    return _material;
+  }
+
   /// A Drawable is "immutable" in that there's no API to modify its inputs after
   /// creation. They're lightweight objects and should be recreated instead of updated.
   Drawable(std::shared_ptr<vertexdata::VertexData> vertexData,
@@ -38,6 +59,8 @@ class Drawable final {
 
   std::shared_ptr<igl::IRenderPipelineState> _pipelineState;
   size_t _lastPipelineDescHash = 0;
+  // the pipeline state above was obtained from this cache for this target signature
+  const PipelineCache* _pipelineCache = nullptr;
 };
 
 } // namespace drawable
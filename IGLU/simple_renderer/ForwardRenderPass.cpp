@@ -7,15 +7,65 @@
 
 #include "ForwardRenderPass.h"
 
+#include <cstring>
 #include <utility>
 
 namespace iglu {
 namespace renderpass {
 
-ForwardRenderPass::ForwardRenderPass(igl::IDevice& device) {
+namespace {
+// shared by all the frames in flight
+constexpr size_t kInstanceRingBufferSize = 4 * 1024 * 1024;
+
+constexpr uint32_t kIdBits = 12;
+constexpr uint32_t kDepthBits = 24;
+
+// the bits of non-negative floats sort like the floats
+uint64_t quantizeDepth(float depth) {
+  depth = depth > 0.0f ? depth : 0.0f;
+  uint32_t bits = 0;
+  std::memcpy(&bits, &depth, sizeof(bits));
+  return bits >> (31 - kDepthBits);
+}
+} // namespace
+
+uint64_t ForwardRenderPass::makeSortKey(bool isTranslucent,
+                                        uint32_t pipelineId,
+                                        uint32_t materialId,
+                                        uint32_t vertexDataId,
+                                        float depth) {
+  constexpr uint64_t kIdMask = (1u << kIdBits) - 1;
+  const uint64_t state = ((pipelineId & kIdMask) << (2 * kIdBits)) |
+                         ((materialId & kIdMask) << kIdBits) | (vertexDataId & kIdMask);
+  const uint64_t quantizedDepth = quantizeDepth(depth);
+  if (!isTranslucent) {
+    return (state << kDepthBits) | quantizedDepth;
+  }
+  const uint64_t invertedDepth = ((1u << kDepthBits) - 1) - quantizedDepth;
+  return (1ull << 63) | (invertedDepth << (3 * kIdBits)) | state;
+}
+
+ForwardRenderPass::ForwardRenderPass(igl::IDevice& device,
+                                     std::shared_ptr<drawable::PipelineCache> pipelineCache) :
+  _device(device),
+  _pipelineCache(pipelineCache ? std::move(pipelineCache)
+                               : std::make_shared<drawable::PipelineCache>(device)) {
   igl::CommandQueueDesc desc;
   _commandQueue = device.createCommandQueue(desc, nullptr);
   _backendType = device.getBackendType();
+
+  if (device.hasFeature(igl::DeviceFeatures::DrawInstanced)) {
+    igl::RingBufferDesc ringBufferDesc;
+    ringBufferDesc.type = igl::BufferDesc::BufferTypeBits::Vertex;
+    ringBufferDesc.length = kInstanceRingBufferSize;
+    ringBufferDesc.debugName = "ForwardRenderPass instances";
+    _instanceRingBuffer = device.createRingBuffer(ringBufferDesc, nullptr);
+  }
+  if (_instanceRingBuffer) {
+    // not owning: the ring buffer outlives the bindings of this render pass
+    _instanceBuffer = std::shared_ptr<igl::IBuffer>(std::shared_ptr<igl::IBuffer>(),
+                                                    &_instanceRingBuffer->getBuffer());
+  }
 }
 
 void ForwardRenderPass::begin(std::shared_ptr<igl::IFramebuffer> target,
@@ -24,12 +74,14 @@ void ForwardRenderPass::begin(std::shared_ptr<igl::IFramebuffer> target,
 
   _framebuffer = std::move(target);
 
-  _renderPipelineDesc.targetDesc.colorAttachments.resize(1);
-  _renderPipelineDesc.targetDesc.colorAttachments[0].textureFormat =
-      _framebuffer->getColorAttachment(0)->getFormat();
+  auto& targetDesc = _renderTarget.pipelineDesc.targetDesc;
+  targetDesc.colorAttachments.resize(1);
+  targetDesc.colorAttachments[0].textureFormat = _framebuffer->getColorAttachment(0)->getFormat();
   auto depthAttachment = _framebuffer->getDepthAttachment();
-  _renderPipelineDesc.targetDesc.depthAttachmentFormat =
+  targetDesc.depthAttachmentFormat =
       depthAttachment ? depthAttachment->getFormat() : igl::TextureFormat::Invalid;
+  // hashed once per render pass instead of once per draw call
+  _renderTarget.update();
 
   igl::RenderPassDesc defaultRenderPassDesc;
   defaultRenderPassDesc.colorAttachments.resize(1);
@@ -47,19 +99,167 @@ void ForwardRenderPass::begin(std::shared_ptr<igl::IFramebuffer> target,
 
 void ForwardRenderPass::draw(drawable::Drawable& drawable, igl::IDevice& device) const {
   IGL_ASSERT_MSG(isActive(), "Drawing not in progress");
-  drawable.draw(device, *_commandEncoder, _renderPipelineDesc);
+  drawable.draw(device, *_commandEncoder, *_pipelineCache, _renderTarget);
+}
+
+void ForwardRenderPass::submit(std::shared_ptr<drawable::Drawable> drawable,
+                               const void* instanceData,
+                               size_t instanceDataSize,
+                               float depth) {
+  IGL_ASSERT_MSG(isActive(), "Drawing not in progress");
+  IGL_ASSERT(instanceData || instanceDataSize == 0);
+
+  QueuedDrawable queued;
+  queued.pipelineState = drawable->pipelineState(*_pipelineCache, _renderTarget);
+  queued.drawable = std::move(drawable);
+  queued.instanceDataOffset = _instanceData.size();
+  queued.instanceDataSize = instanceDataSize;
+  queued.depth = depth;
+  if (instanceDataSize != 0) {
+    const auto* bytes = static_cast<const uint8_t*>(instanceData);
+    _instanceData.insert(_instanceData.end(), bytes, bytes + instanceDataSize);
+  }
+  _queue.push_back(std::move(queued));
+}
+
+void ForwardRenderPass::sortQueue() {
+  // dense ids in submission order, so that they fit the bits of the sort key
+  uint32_t numIds[3] = {};
+  const auto idOf = [this, &numIds](const void* object, size_t category) {
+    const auto result = _sortIds.try_emplace(object, numIds[category]);
+    numIds[category] += result.second ? 1 : 0;
+    return result.first->second;
+  };
+
+  _sortItems.resize(_queue.size());
+  for (size_t i = 0; i != _queue.size(); i++) {
+    const QueuedDrawable& queued = _queue[i];
+    const auto& material = queued.drawable->material();
+    _sortItems[i].key = makeSortKey(!(material->blendMode == material::BlendMode::Opaque()),
+                                    idOf(queued.pipelineState.get(), 0),
+                                    idOf(material.get(), 1),
+                                    idOf(queued.drawable->vertexData().get(), 2),
+                                    queued.depth);
+    _sortItems[i].index = static_cast<uint32_t>(i);
+  }
+  _sortIds.clear();
+
+  // LSD radix sort, 8 bits per pass. Stable: equal keys are drawn in submission order
+  _sortScratch.resize(_sortItems.size());
+  for (uint32_t shift = 0; shift != 64; shift += 8) {
+    size_t offsets[256] = {};
+    for (const SortItem& item : _sortItems) {
+      offsets[(item.key >> shift) & 0xff]++;
+    }
+    // all the keys share this digit
+    if (offsets[(_sortItems.front().key >> shift) & 0xff] == _sortItems.size()) {
+      continue;
+    }
+    size_t sum = 0;
+    for (size_t& offset : offsets) {
+      const size_t count = offset;
+      offset = sum;
+      sum += count;
+    }
+    for (const SortItem& item : _sortItems) {
+      _sortScratch[offsets[(item.key >> shift) & 0xff]++] = item;
+    }
+    _sortItems.swap(_sortScratch);
+  }
+}
+
+void ForwardRenderPass::flushQueue() {
+  if (_queue.empty()) {
+    return;
+  }
+  sortQueue();
+
+  const auto canMerge = [](const QueuedDrawable& a, const QueuedDrawable& b) {
+    return a.pipelineState == b.pipelineState &&
+           a.drawable->material() == b.drawable->material() &&
+           a.drawable->vertexData() == b.drawable->vertexData() &&
+           a.instanceDataSize == b.instanceDataSize;
+  };
+
+  const igl::IRenderPipelineState* boundPipelineState = nullptr;
+  const material::Material* boundMaterial = nullptr;
+  for (size_t first = 0; first != _sortItems.size();) {
+    const QueuedDrawable& queued = _queue[_sortItems[first].index];
+    size_t last = first + 1;
+    if (_instanceRingBuffer && queued.instanceDataSize != 0) {
+      while (last != _sortItems.size() && canMerge(_queue[_sortItems[last].index], queued)) {
+        last++;
+      }
+    }
+
+    if (queued.pipelineState.get() != boundPipelineState) {
+      _commandEncoder->bindRenderPipelineState(queued.pipelineState);
+      boundPipelineState = queued.pipelineState.get();
+      boundMaterial = nullptr;
+    }
+    const auto& material = queued.drawable->material();
+    if (material.get() != boundMaterial) {
+      material->bind(_device, *queued.pipelineState, *_commandEncoder);
+      boundMaterial = material.get();
+    }
+    drawInstances(*queued.drawable->vertexData(), first, last);
+    first = last;
+  }
+
+  _queue.clear();
+  _sortItems.clear();
+  _instanceData.clear();
+}
+
+void ForwardRenderPass::drawInstances(vertexdata::VertexData& vertexData,
+                                      size_t first,
+                                      size_t last) {
+  const size_t stride = _queue[_sortItems[first].index].instanceDataSize;
+  if (stride == 0) {
+    vertexData.draw(*_commandEncoder);
+    return;
+  }
+
+  igl::RingBufferAllocation allocation;
+  if (_instanceRingBuffer) {
+    allocation = _instanceRingBuffer->allocate(stride * (last - first), nullptr);
+  }
+  if (!allocation.empty()) {
+    auto* dst = static_cast<uint8_t*>(allocation.data);
+    for (size_t i = first; i != last; i++, dst += stride) {
+      const size_t offset = _queue[_sortItems[i].index].instanceDataOffset;
+      std::memcpy(dst, _instanceData.data() + offset, stride);
+    }
+    _commandEncoder->bindBuffer(
+        kInstanceBufferIndex, igl::BindTarget::kVertex, _instanceBuffer, allocation.offset);
+    vertexData.draw(*_commandEncoder, static_cast<uint32_t>(last - first));
+    return;
+  }
+
+  // no ring buffer (e.g. Metal) or it is full: the data of every instance is bound inline
+  for (size_t i = first; i != last; i++) {
+    const size_t offset = _queue[_sortItems[i].index].instanceDataOffset;
+    _commandEncoder->bindBytes(
+        kInstanceBufferIndex, igl::BindTarget::kVertex, _instanceData.data() + offset, stride);
+    vertexData.draw(*_commandEncoder);
+  }
 }
 
 void ForwardRenderPass::end(bool shouldPresent) {
   IGL_ASSERT_MSG(isActive(), "Drawing not in progress");
 
+  flushQueue();
+
   _commandEncoder->endEncoding();
 
   if (shouldPresent) {
     _commandBuffer->present(_framebuffer->getColorAttachment(0));
   }
 
-  _commandQueue->submit(*_commandBuffer);
+  const igl::SubmitHandle handle = _commandQueue->submit(*_commandBuffer);
+  if (_instanceRingBuffer) {
+    _instanceRingBuffer->endFrame(handle);
+  }
 
   _commandEncoder = nullptr;
   _commandBuffer = nullptr;
@@ -11,6 +11,7 @@
 #include <igl/IGL.h>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace iglu {
@@ -30,6 +31,24 @@ class ForwardRenderPass final {
   /// Call once per drawable.
   void draw(drawable::Drawable& drawable, igl::IDevice& device) const;
 
+  /// Queues 'drawable', which is drawn by end() after the draw() calls. Queued drawables are
+  /// sorted with a 64-bit key, see makeSortKey(): opaque ones first, grouped by pipeline state,
+  /// material and vertex data to minimize state changes and front-to-back within a group, then
+  /// translucent ones (Material::blendMode other than opaque) back-to-front. Consecutive drawables
+  /// sharing their states are merged into a single instanced draw call when
+  /// igl::DeviceFeatures::DrawInstanced is supported.
+  ///
+  /// 'instanceData' is copied and bound to vertex buffer kInstanceBufferIndex, which the vertex
+  /// input state reads with igl::VertexSampleFunction::Instance. Only drawables with the same
+  /// size of per-instance data are merged. Materials are bound by end(): their uniforms must not
+  /// change until then.
+  /// @param depth Distance from the camera, e.g. of the center of the bounds of the drawable.
+  /// Negative values are clamped to 0.
+  void submit(std::shared_ptr<drawable::Drawable> drawable,
+              const void* instanceData = nullptr,
+              size_t instanceDataSize = 0,
+              float depth = 0.0f);
+
   /// Call after all drawing within this render pass is finished. The 'present'
   /// parameter controls whether to present the target framebuffer and must be set
   /// to true exactly once per frame, when targeting the "onscreen" framebuffer.
@@ -45,18 +64,67 @@ class ForwardRenderPass final {
   bool isActive() const;
   std::shared_ptr<igl::IFramebuffer> activeTarget();
 
-  explicit ForwardRenderPass(igl::IDevice& device);
+  /// Vertex buffer index of the per-instance data passed to submit(). VertexData binds its
+  /// vertices to index 0.
+  static constexpr int kInstanceBufferIndex = 1;
+
+  /// Sort key of submit(), from the most significant bits:
+  ///  - opaque:      0 (1 bit) | pipeline (12 bits) | material (12 bits) | vertex data (12 bits) |
+  ///                 depth (24 bits)
+  ///  - translucent: 1 (1 bit) | inverted depth (24 bits) | pipeline | material | vertex data
+  /// The ids are assigned by end() in submission order and only affect grouping if they wrap.
+  static uint64_t makeSortKey(bool isTranslucent,
+                              uint32_t pipelineId,
+                              uint32_t materialId,
+                              uint32_t vertexDataId,
+                              float depth);
+
+  /// 'pipelineCache' can be shared by several render passes of the same device. A cache owned by
+  /// this render pass is created if it is null.
+
+  explicit ForwardRenderPass(igl::IDevice& device,
+                             std::shared_ptr<drawable::PipelineCache> pipelineCache = nullptr);
   ~ForwardRenderPass() = default;
 
  private:
+  struct QueuedDrawable {
+    std::shared_ptr<drawable::Drawable> drawable;
+    std::shared_ptr<igl::IRenderPipelineState> pipelineState;
+    // range of _instanceData
+    size_t instanceDataOffset = 0;
+    size_t instanceDataSize = 0;
+    float depth = 0.0f;
+  };
+
+  struct SortItem {
+    uint64_t key;
+    uint32_t index;
+  };
+
+  void flushQueue();
+  void sortQueue();
+  void drawInstances(vertexdata::VertexData& vertexData, size_t first, size_t last);
+
+  igl::IDevice& _device;
   igl::BackendType _backendType;
 
   std::shared_ptr<igl::ICommandQueue> _commandQueue;
   std::shared_ptr<igl::IFramebuffer> _framebuffer;
-  igl::RenderPipelineDesc _renderPipelineDesc;
+  drawable::RenderTarget _renderTarget;
+  std::shared_ptr<drawable::PipelineCache> _pipelineCache;
 
   std::shared_ptr<igl::ICommandBuffer> _commandBuffer;
   std::unique_ptr<igl::IRenderCommandEncoder> _commandEncoder;
+
+  std::vector<QueuedDrawable> _queue;
+  // in drawing order after sortQueue()
+  std::vector<SortItem> _sortItems;
+  std::vector<SortItem> _sortScratch;
+  std::unordered_map<const void*, uint32_t> _sortIds;
+  std::vector<uint8_t> _instanceData;
+  // null when instanced drawing or ring buffers are not supported
+  std::unique_ptr<igl::IRingBuffer> _instanceRingBuffer;
+  std::shared_ptr<igl::IBuffer> _instanceBuffer;
 };
 
 } // namespace renderpass
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "MeshPreparation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <meshoptimizer.h>
+#include <utility>
+
+namespace iglu {
+namespace vertexdata {
+
+namespace {
+
+// Assumption: <name, location> for OpenGL and Metal, respectively
+const std::pair<const char*, int> kAttrPosition("a_position", 0);
+const std::pair<const char*, int> kAttrNormal("a_normal", 1);
+const std::pair<const char*, int> kAttrUV("a_uv", 2);
+
+const float* element(const float* stream, size_t stride, size_t index) {
+  return reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(stream) + stride * index);
+}
+
+template<typename T>
+uint8_t* write(uint8_t* dst, const T* src, size_t count) {
+  std::memcpy(dst, src, sizeof(T) * count);
+  return dst + sizeof(T) * count;
+}
+
+// Octahedral encoding: the unit sphere is projected on an octahedron, whose lower half is folded
+// over the upper one
+void encodeOctahedral(const float* normal, int16_t* out) {
+  const float length = std::abs(normal[0]) + std::abs(normal[1]) + std::abs(normal[2]);
+  float x = length > 0.0f ? normal[0] / length : 0.0f;
+  float y = length > 0.0f ? normal[1] / length : 0.0f;
+  if (normal[2] < 0.0f) {
+    const float foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+    const float foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+    x = foldedX;
+    y = foldedY;
+  }
+  out[0] = static_cast<int16_t>(meshopt_quantizeSnorm(x, 16));
+  out[1] = static_cast<int16_t>(meshopt_quantizeSnorm(y, 16));
+}
+
+} // namespace
+
+PreparedMesh prepareMesh(const MeshAttributes& attributes, const MeshPreparationDesc& desc) {
+  PreparedMesh mesh;
+  const size_t numIndices = attributes.indices ? attributes.numIndices : attributes.numVertices;
+  if (!attributes.positions || attributes.numVertices == 0 || numIndices == 0) {
+    return mesh;
+  }
+
+  // 1. Merge the equal vertices
+  std::vector<meshopt_Stream> streams = {
+      {attributes.positions, sizeof(float) * 3, attributes.positionStride}};
+  if (attributes.normals) {
+    streams.push_back({attributes.normals, sizeof(float) * 3, attributes.normalStride});
+  }
+  if (attributes.uvs) {
+    streams.push_back({attributes.uvs, sizeof(float) * 2, attributes.uvStride});
+  }
+  std::vector<uint32_t> remap(attributes.numVertices);
+  size_t numVertices = meshopt_generateVertexRemapMulti(remap.data(),
+                                                        attributes.indices,
+                                                        numIndices,
+                                                        attributes.numVertices,
+                                                        streams.data(),
+                                                        streams.size());
+  std::vector<uint32_t> indices(numIndices);
+  meshopt_remapIndexBuffer(indices.data(), attributes.indices, numIndices, remap.data());
+
+  // the source vertex of every vertex, so that attributes are only read when writing the output
+  std::vector<uint32_t> sources(numVertices);
+  for (size_t i = 0; i != remap.size(); ++i) {
+    if (remap[i] != ~0u) {
+      sources[remap[i]] = static_cast<uint32_t>(i);
+    }
+  }
+
+  // 2. Reorder the triangles for the vertex cache and overdraw, then the vertices for fetching
+  if (desc.optimizeVertexCache) {
+    meshopt_optimizeVertexCache(indices.data(), indices.data(), numIndices, numVertices);
+  }
+  if (desc.overdrawThreshold > 0.0f) {
+    std::vector<float> positions(numVertices * 3);
+    for (size_t v = 0; v != numVertices; ++v) {
+      std::memcpy(&positions[v * 3],
+                  element(attributes.positions, attributes.positionStride, sources[v]),
+                  sizeof(float) * 3);
+    }
+    meshopt_optimizeOverdraw(indices.data(),
+                             indices.data(),
+                             numIndices,
+                             positions.data(),
+                             numVertices,
+                             sizeof(float) * 3,
+                             desc.overdrawThreshold);
+  }
+  if (desc.optimizeVertexFetch) {
+    remap.resize(numVertices);
+    numVertices =
+        meshopt_optimizeVertexFetchRemap(remap.data(), indices.data(), numIndices, numVertices);
+    meshopt_remapIndexBuffer(indices.data(), indices.data(), numIndices, remap.data());
+    std::vector<uint32_t> fetchSources(numVertices);
+    for (size_t i = 0; i != remap.size(); ++i) {
+      if (remap[i] != ~0u) {
+        fetchSources[remap[i]] = sources[i];
+      }
+    }
+    sources = std::move(fetchSources);
+  }
+
+  // 3. Interleaved layout
+  igl::VertexInputStateDesc& inputDesc = mesh.inputStateDesc;
+  size_t stride = 0;
+  auto addAttribute = [&inputDesc, &stride](igl::VertexAttributeFormat format,
+                                            const std::pair<const char*, int>& attr) {
+    inputDesc.attributes[inputDesc.numAttributes++] =
+        igl::VertexAttribute(0, format, stride, attr.first, attr.second);
+    stride += igl::VertexInputStateDesc::sizeForVertexAttributeFormat(format);
+  };
+  // HalfFloat3 is not a mandatory vertex format in Vulkan and breaks the 4-byte alignment of Metal
+  addAttribute(desc.quantize ? igl::VertexAttributeFormat::HalfFloat4
+                             : igl::VertexAttributeFormat::Float3,
+               kAttrPosition);
+  if (attributes.normals) {
+    addAttribute(desc.quantize ? igl::VertexAttributeFormat::Short2Norm
+                               : igl::VertexAttributeFormat::Float3,
+                 kAttrNormal);
+  }
+  if (attributes.uvs) {
+    addAttribute(!desc.quantize ? igl::VertexAttributeFormat::Float2
+                 : desc.halfUVs ? igl::VertexAttributeFormat::HalfFloat2
+                                : igl::VertexAttributeFormat::UShort2Norm,
+                 kAttrUV);
+  }
+  inputDesc.numInputBindings = 1;
+  inputDesc.inputBindings[0].stride = stride;
+
+  // unorm uvs are remapped to the range of the mesh
+  if (attributes.uvs && desc.quantize && !desc.halfUVs) {
+    float uvMin[2] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+    float uvMax[2] = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+    for (const uint32_t source : sources) {
+      const float* uv = element(attributes.uvs, attributes.uvStride, source);
+      for (size_t c = 0; c != 2; ++c) {
+        uvMin[c] = std::min(uvMin[c], uv[c]);
+        uvMax[c] = std::max(uvMax[c], uv[c]);
+      }
+    }
+    for (size_t c = 0; c != 2; ++c) {
+      mesh.uvOffset[c] = uvMin[c];
+      mesh.uvScale[c] = uvMax[c] > uvMin[c] ? uvMax[c] - uvMin[c] : 1.0f;
+    }
+  }
+
+  // 4. Vertices
+  mesh.numVertices = numVertices;
+  mesh.vertices.resize(numVertices * stride);
+  uint8_t* dst = mesh.vertices.data();
+  for (const uint32_t source : sources) {
+    const float* position = element(attributes.positions, attributes.positionStride, source);
+    if (desc.quantize) {
+      const uint16_t halfPosition[4] = {meshopt_quantizeHalf(position[0]),
+                                        meshopt_quantizeHalf(position[1]),
+                                        meshopt_quantizeHalf(position[2]),
+                                        meshopt_quantizeHalf(1.0f)};
+      dst = write(dst, halfPosition, 4);
+    } else {
+      dst = write(dst, position, 3);
+    }
+    if (attributes.normals) {
+      const float* normal = element(attributes.normals, attributes.normalStride, source);
+      if (desc.quantize) {
+        int16_t octNormal[2];
+        encodeOctahedral(normal, octNormal);
+        dst = write(dst, octNormal, 2);
+      } else {
+        dst = write(dst, normal, 3);
+      }
+    }
+    if (attributes.uvs) {
+      const float* uv = element(attributes.uvs, attributes.uvStride, source);
+      if (desc.quantize && desc.halfUVs) {
+        const uint16_t halfUV[2] = {meshopt_quantizeHalf(uv[0]), meshopt_quantizeHalf(uv[1])};
+        dst = write(dst, halfUV, 2);
+      } else if (desc.quantize) {
+        uint16_t unormUV[2];
+        for (size_t c = 0; c != 2; ++c) {
+          const float normalized = (uv[c] - mesh.uvOffset[c]) / mesh.uvScale[c];
+          unormUV[c] = static_cast<uint16_t>(meshopt_quantizeUnorm(normalized, 16));
+        }
+        dst = write(dst, unormUV, 2);
+      } else {
+        dst = write(dst, uv, 2);
+      }
+    }
+  }
+
+  // 5. Indices
+  mesh.numIndices = numIndices;
+  if (numVertices <= size_t(std::numeric_limits<uint16_t>::max()) + 1) {
+    mesh.indexFormat = igl::IndexFormat::UInt16;
+    mesh.indices.resize(numIndices * sizeof(uint16_t));
+    uint16_t* indices16 = reinterpret_cast<uint16_t*>(mesh.indices.data());
+    std::transform(indices.begin(), indices.end(), indices16, [](uint32_t index) {
+      return static_cast<uint16_t>(index);
+    });
+  } else {
+    mesh.indexFormat = igl::IndexFormat::UInt32;
+    mesh.indices.resize(numIndices * sizeof(uint32_t));
+    std::memcpy(mesh.indices.data(), indices.data(), mesh.indices.size());
+  }
+
+  return mesh;
+}
+
+std::shared_ptr<VertexData> createVertexData(igl::IDevice& device,
+                                             const PreparedMesh& mesh,
+                                             igl::Result* outResult) {
+  if (mesh.numVertices == 0 || mesh.numIndices == 0) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "Empty mesh");
+    return nullptr;
+  }
+
+  igl::Result ret;
+  std::shared_ptr<igl::IVertexInputState> vertexInput =
+      device.createVertexInputState(mesh.inputStateDesc, &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return nullptr;
+  }
+  std::shared_ptr<igl::IBuffer> vertexBuffer = device.createBuffer(
+      igl::BufferDesc(
+          igl::BufferDesc::BufferTypeBits::Vertex, mesh.vertices.data(), mesh.vertices.size()),
+      &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return nullptr;
+  }
+  std::shared_ptr<igl::IBuffer> indexBuffer = device.createBuffer(
+      igl::BufferDesc(
+          igl::BufferDesc::BufferTypeBits::Index, mesh.indices.data(), mesh.indices.size()),
+      &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return nullptr;
+  }
+
+  PrimitiveDesc primitiveDesc;
+  primitiveDesc.numEntries = mesh.numIndices;
+  primitiveDesc.type = igl::PrimitiveType::Triangle;
+
+  igl::Result::setOk(outResult);
+  return std::make_shared<VertexData>(std::move(vertexInput),
+                                      std::move(vertexBuffer),
+                                      std::move(indexBuffer),
+                                      mesh.indexFormat,
+                                      primitiveDesc);
+}
+
+} // namespace vertexdata
+} // namespace iglu
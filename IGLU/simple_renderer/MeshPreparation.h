@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "VertexData.h"
+
+#include <igl/IGL.h>
+#include <memory>
+#include <vector>
+
+namespace iglu {
+namespace vertexdata {
+
+/// Source attribute streams of a triangle list mesh. Only positions are required.
+struct MeshAttributes {
+  /// xyz
+  const float* positions = nullptr;
+  size_t positionStride = sizeof(float) * 3;
+  /// xyz, optional. Normalized when quantized.
+  const float* normals = nullptr;
+  size_t normalStride = sizeof(float) * 3;
+  /// uv, optional
+  const float* uvs = nullptr;
+  size_t uvStride = sizeof(float) * 2;
+  size_t numVertices = 0;
+
+  /// Optional. When null, every 3 vertices form a triangle and equal vertices are merged.
+  const uint32_t* indices = nullptr;
+  size_t numIndices = 0;
+};
+
+struct MeshPreparationDesc {
+  /// Reorders the triangles for the post-transform vertex cache
+  bool optimizeVertexCache = true;
+  /// Allowed vertex cache degradation when reordering the triangles to reduce overdraw, e.g.
+  /// 1.05 for 5%. 0 disables the overdraw optimization.
+  float overdrawThreshold = 1.05f;
+  /// Reorders the vertices in the order of first use by the triangles
+  bool optimizeVertexFetch = true;
+  /// Stores positions as HalfFloat4 (w = 1), normals as octahedral Short2Norm and uvs as
+  /// UShort2Norm instead of floats. Positions must fit the range and precision of half floats.
+  bool quantize = true;
+  /// When quantizing, stores uvs as HalfFloat2 instead of UShort2Norm remapped to the range of the
+  /// mesh: uvScale and uvOffset stay identity, so meshes can be drawn without per-mesh uniforms,
+  /// at the cost of precision for uvs far from 0.
+  bool halfUVs = false;
+};
+
+/// Interleaved vertex data ready for upload, see createVertexData().
+///
+/// Attributes, in this order: "a_position" (location 0), "a_normal" (location 1) and "a_uv"
+/// (location 2). The absent source streams are omitted.
+///
+/// Quantized attributes are decoded in the vertex shader:
+///  - normal: vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y)); float t = max(-n.z, 0.0);
+///            n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t); n = normalize(n);
+///  - uv:     uv = a_uv * uvScale + uvOffset, unless halfUVs is set
+struct PreparedMesh {
+  std::vector<uint8_t> vertices;
+  size_t numVertices = 0;
+  /// UInt32 indices are only used when the vertices do not fit UInt16 ones
+  std::vector<uint8_t> indices;
+  size_t numIndices = 0;
+  igl::IndexFormat indexFormat = igl::IndexFormat::UInt16;
+  /// A single vertex buffer binding at index 0
+  igl::VertexInputStateDesc inputStateDesc;
+  float uvOffset[2] = {0.0f, 0.0f};
+  float uvScale[2] = {1.0f, 1.0f};
+};
+
+/// Reorders the vertices and triangles of 'attributes' for the GPU with meshoptimizer, then
+/// quantizes and interleaves the attributes into a single vertex stream.
+PreparedMesh prepareMesh(const MeshAttributes& attributes, const MeshPreparationDesc& desc = {});
+
+/// Uploads 'mesh' to immutable buffers. Returns nullptr on failure.
+std::shared_ptr<VertexData> createVertexData(igl::IDevice& device,
+                                             const PreparedMesh& mesh,
+                                             igl::Result* outResult = nullptr);
+
+} // namespace vertexdata
+} // namespace iglu
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "PipelineCache.h"
+
+namespace iglu {
+namespace drawable {
+
+size_t PipelineCache::KeyHash::operator()(const Key& key) const {
+  size_t hash = std::hash<const void*>()(key.vertexInputState);
+  hash ^= std::hash<const void*>()(key.material) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  hash ^= key.targetSignature + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  hash ^= static_cast<size_t>(key.frontFaceWinding) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  return hash;
+}
+
+std::shared_ptr<igl::IRenderPipelineState> PipelineCache::getPipelineState(
+    const std::shared_ptr<vertexdata::VertexData>& vertexData,
+    const std::shared_ptr<material::Material>& material,
+    const RenderTarget& target) {
+  const std::shared_ptr<igl::IVertexInputState> vertexInputState =
+      vertexData->vertexInputState();
+  const Key key = {vertexInputState.get(),
+                   vertexData->primitiveDesc().frontFaceWinding,
+                   material.get(),
+                   target.signature};
+
+  Entry& entry = _entries[key];
+  if (entry.pipelineState && entry.vertexInputState.lock() == vertexInputState &&
+      entry.material.lock() == material && entry.targetPipelineDesc == target.pipelineDesc) {
+    return entry.pipelineState;
+  }
+
+  igl::RenderPipelineDesc pipelineDesc = target.pipelineDesc;
+  vertexData->populatePipelineDescriptor(pipelineDesc);
+  material->populatePipelineDescriptor(pipelineDesc);
+
+  entry.vertexInputState = vertexInputState;
+  entry.material = material;
+  entry.targetPipelineDesc = target.pipelineDesc;
+  entry.pipelineState = _device.createRenderPipeline(pipelineDesc, nullptr);
+  return entry.pipelineState;
+}
+
+void PipelineCache::purge() {
+  for (auto it = _entries.begin(); it != _entries.end();) {
+    const bool isExpired = (it->first.vertexInputState && it->second.vertexInputState.expired()) ||
+                           it->second.material.expired();
+    it = isExpired ? _entries.erase(it) : std::next(it);
+  }
+}
+
+} // namespace drawable
+} // namespace iglu
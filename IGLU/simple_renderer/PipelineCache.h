@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/simple_renderer/Material.h>
+#include <IGLU/simple_renderer/VertexData.h>
+#include <igl/IGL.h>
+#include <memory>
+#include <unordered_map>
+
+namespace iglu {
+namespace drawable {
+
+/// The framebuffer dependent part of a render pipeline descriptor. It is populated once per
+/// render pass, so that drawables only compare its signature instead of hashing descriptors.
+struct RenderTarget {
+  /// Only populated with the framebuffer information
+  igl::RenderPipelineDesc pipelineDesc;
+  /// Hash of 'pipelineDesc', see update()
+  size_t signature = 0;
+
+  void update() {
+    signature = std::hash<igl::RenderPipelineDesc>()(pipelineDesc);
+  }
+};
+
+/// Render pipeline states shared by all the drawables of a device, keyed by their vertex input
+/// state, material and render target. Drawables with the same vertex layout and material
+/// therefore share a single pipeline state.
+///
+/// Like Drawable, the cache assumes vertex data and materials are immutable once drawn. Not
+/// thread-safe: use it on the rendering thread.
+class PipelineCache final {
+ public:
+  /// Returns the pipeline state for drawing 'vertexData' with 'material' into 'target',
+  /// creating it on the first request.
+  std::shared_ptr<igl::IRenderPipelineState> getPipelineState(
+      const std::shared_ptr<vertexdata::VertexData>& vertexData,
+      const std::shared_ptr<material::Material>& material,
+      const RenderTarget& target);
+
+  /// Releases the pipeline states of the destroyed vertex input states and materials.
+  void purge();
+
+  size_t size() const {
+    return _entries.size();
+  }
+
+  explicit PipelineCache(igl::IDevice& device) : _device(device) {}
+  ~PipelineCache() = default;
+
+ private:
+  struct Key {
+    const igl::IVertexInputState* vertexInputState = nullptr;
+    igl::WindingMode frontFaceWinding = igl::WindingMode::CounterClockwise;
+    const material::Material* material = nullptr;
+    size_t targetSignature = 0;
+
+    bool operator==(const Key& other) const {
+      return vertexInputState == other.vertexInputState &&
+             frontFaceWinding == other.frontFaceWinding && material == other.material &&
+             targetSignature == other.targetSignature;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    // checked on lookup, as the address of a destroyed object can be reused
+    std::weak_ptr<igl::IVertexInputState> vertexInputState;
+    std::weak_ptr<material::Material> material;
+    // guards against signature collisions
+    igl::RenderPipelineDesc targetPipelineDesc;
+    std::shared_ptr<igl::IRenderPipelineState> pipelineState;
+  };
+
+  igl::IDevice& _device;
+  std::unordered_map<Key, Entry, KeyHash> _entries;
+};
+
+} // namespace drawable
+} // namespace iglu
@@ -124,8 +124,14 @@ ShaderUniforms::ShaderUniforms(igl::IDevice& device,
     }
 
     for (const igl::BufferArgDesc::BufferMemberDesc& uniformDesc : iglDesc.members) {
-      UniformDesc uniform{uniformDesc, bufferDesc};
-      _allUniformsByName.insert({uniformDesc.name, uniform});
+      UniformDesc uniform{uniformDesc, bufferDesc.get()};
+      // the same uniform can be declared by the buffers of several shader stages
+      const UniformHandle newHandle{_uniformsByHandle.size()};
+      const auto it = _uniformHandlesByName.try_emplace(uniformDesc.name, newHandle).first;
+      if (it->second.index == newHandle.index) {
+        _uniformsByHandle.emplace_back();
+      }
+      _uniformsByHandle[it->second.index].push_back(uniform);
       bufferDesc->uniforms.push_back(uniform);
     }
 
@@ -168,6 +174,8 @@ size_t getUniformExpectedSize(igl::UniformType uniformType, igl::BackendType bac
       expectedSize = 48;
     } else if (uniformType == igl::UniformType::Float3) {
       expectedSize = 16;
+    } else if (uniformType == igl::UniformType::Float16x3) {
+      expectedSize = 8;
     }
   }
 
@@ -175,18 +183,32 @@ size_t getUniformExpectedSize(igl::UniformType uniformType, igl::BackendType bac
 }
 } // namespace
 
-void ShaderUniforms::setUniformBytes(const igl::NameHandle& name,
+ShaderUniforms::UniformHandle ShaderUniforms::uniformHandle(
+    const igl::NameHandle& uniformName) const {
+  auto it = _uniformHandlesByName.find(uniformName);
+  return it != _uniformHandlesByName.end() ? it->second : UniformHandle{};
+}
+
+ShaderUniforms::UniformHandle ShaderUniforms::findUniform(
+    const igl::NameHandle& uniformName) const {
+  const UniformHandle handle = uniformHandle(uniformName);
+  if (!handle.isValid()) {
+    IGL_LOG_ERROR_ONCE("[IGL][Error] Invalid uniform name: %s\n", uniformName.toConstChar());
+  }
+  return handle;
+}
+
+void ShaderUniforms::setUniformBytes(const UniformHandle& uniform,
                                      const void* data,
                                      size_t elementSize,
                                      size_t count,
                                      size_t arrayIndex) {
-  auto range = _allUniformsByName.equal_range(name);
-  if (range.first == range.second) {
-    IGL_LOG_ERROR_ONCE("[IGL][Error] Invalid uniform name: %s\n", name.toConstChar());
+  if (!uniform.isValid()) {
     return;
   }
-  for (auto it = range.first; it != range.second; ++it) {
-    auto& uniformDesc = it->second;
+  IGL_ASSERT(uniform.index < _uniformsByHandle.size());
+  for (const UniformDesc& uniformDesc : _uniformsByHandle[uniform.index]) {
+    const igl::NameHandle& name = uniformDesc.iglMemberDesc.name;
     if (_backend != igl::BackendType::Vulkan) {
       auto expectedSize = getUniformExpectedSize(uniformDesc.iglMemberDesc.type, _backend);
       if (elementSize != expectedSize) {
@@ -205,7 +227,7 @@ void ShaderUniforms::setUniformBytes(const igl::NameHandle& name,
                          uniformDesc.iglMemberDesc.arrayLength);
       continue;
     }
-    auto strongBuffer = uniformDesc.buffer.lock();
+    BufferDesc* strongBuffer = uniformDesc.buffer;
     if (!strongBuffer) {
       IGL_LOG_ERROR("[IGL][Error] null uniform buffer!");
       continue;
@@ -227,75 +249,170 @@ void ShaderUniforms::setUniformBytes(const igl::NameHandle& name,
       IGL_LOG_ERROR("[IGL][Error] Failed to update uniform buffer\n");
       continue;
     }
+    strongBuffer->allocation->markDirty(offset, elementSize * count);
+  }
+}
+
+bool ShaderUniforms::isHalfUniform(const UniformHandle& uniform) const {
+  if (!uniform.isValid() || _uniformsByHandle[uniform.index].empty()) {
+    return false;
   }
+  // every shader stage declares the uniform with the same type
+  const igl::UniformType type = _uniformsByHandle[uniform.index].front().iglMemberDesc.type;
+  return igl::sizeForUniformElementType(type) == sizeof(igl::Float16);
+}
+
+void ShaderUniforms::setHalfUniformBytes(const UniformHandle& uniform,
+                                         const void* data,
+                                         size_t srcStride,
+                                         size_t count,
+                                         size_t arrayIndex) {
+  const igl::UniformType type = _uniformsByHandle[uniform.index].front().iglMemberDesc.type;
+  const size_t numComponents = igl::sizeForUniformType(type) / sizeof(igl::Float16);
+  const size_t elementSize = getUniformExpectedSize(type, _backend);
+  _halfScratch.assign(elementSize * count, 0);
+  for (size_t i = 0; i != count; i++) {
+    igl::packFloat16(
+        reinterpret_cast<igl::Float16*>(_halfScratch.data() + elementSize * i),
+        reinterpret_cast<const float*>(static_cast<const uint8_t*>(data) + srcStride * i),
+        numComponents);
+  }
+  setUniformBytes(uniform, _halfScratch.data(), elementSize, count, arrayIndex);
 }
 
 void ShaderUniforms::setBool(const igl::NameHandle& uniformName,
                              const bool& value,
                              size_t arrayIndex) {
-  setUniformBytes(uniformName, &value, sizeof(bool), 1, arrayIndex);
+  setBool(findUniform(uniformName), value, arrayIndex);
+}
+
+void ShaderUniforms::setBool(const UniformHandle& uniform,
+                             const bool& value,
+                             size_t arrayIndex) {
+  setUniformBytes(uniform, &value, sizeof(bool), 1, arrayIndex);
 }
 
 void ShaderUniforms::setBoolArray(const igl::NameHandle& uniformName,
                                   bool* value,
                                   size_t count,
                                   size_t arrayIndex) {
-  setUniformBytes(uniformName, value, sizeof(bool), count, arrayIndex);
+  setBoolArray(findUniform(uniformName), value, count, arrayIndex);
+}
+
+void ShaderUniforms::setBoolArray(const UniformHandle& uniform,
+                                  bool* value,
+                                  size_t count,
+                                  size_t arrayIndex) {
+  setUniformBytes(uniform, value, sizeof(bool), count, arrayIndex);
 }
 
 void ShaderUniforms::setFloat(const igl::NameHandle& uniformName,
                               const iglu::simdtypes::float1& value,
                               size_t arrayIndex) {
-  setUniformBytes(uniformName, &value, sizeof(iglu::simdtypes::float1), 1, arrayIndex);
+  setFloat(findUniform(uniformName), value, arrayIndex);
+}
+
+void ShaderUniforms::setFloat(const UniformHandle& uniform,
+                              const iglu::simdtypes::float1& value,
+                              size_t arrayIndex) {
+  if (isHalfUniform(uniform)) {
+    setHalfUniformBytes(uniform, &value, sizeof(iglu::simdtypes::float1), 1, arrayIndex);
+    return;
+  }
+  setUniformBytes(uniform, &value, sizeof(iglu::simdtypes::float1), 1, arrayIndex);
 }
 
 void ShaderUniforms::setFloatArray(const igl::NameHandle& uniformName,
                                    iglu::simdtypes::float1* value,
                                    size_t count,
                                    size_t arrayIndex) {
-  setUniformBytes(uniformName, value, sizeof(iglu::simdtypes::float1), count, arrayIndex);
+  setFloatArray(findUniform(uniformName), value, count, arrayIndex);
+}
+
+void ShaderUniforms::setFloatArray(const UniformHandle& uniform,
+                                   iglu::simdtypes::float1* value,
+                                   size_t count,
+                                   size_t arrayIndex) {
+  if (isHalfUniform(uniform)) {
+    setHalfUniformBytes(uniform, value, sizeof(iglu::simdtypes::float1), count, arrayIndex);
+    return;
+  }
+  setUniformBytes(uniform, value, sizeof(iglu::simdtypes::float1), count, arrayIndex);
 }
 
 void ShaderUniforms::setFloat2(const igl::NameHandle& uniformName,
                                const iglu::simdtypes::float2& value,
                                size_t arrayIndex) {
-  setUniformBytes(uniformName, &value, sizeof(iglu::simdtypes::float2), 1, arrayIndex);
+  setFloat2(findUniform(uniformName), value, arrayIndex);
+}
+
+void ShaderUniforms::setFloat2(const UniformHandle& uniform,
+                               const iglu::simdtypes::float2& value,
+                               size_t arrayIndex) {
+  if (isHalfUniform(uniform)) {
+    setHalfUniformBytes(uniform, &value, sizeof(iglu::simdtypes::float2), 1, arrayIndex);
+    return;
+  }
+  setUniformBytes(uniform, &value, sizeof(iglu::simdtypes::float2), 1, arrayIndex);
 }
 
 void ShaderUniforms::setFloat2Array(const igl::NameHandle& uniformName,
                                     iglu::simdtypes::float2* value,
                                     size_t count,
                                     size_t arrayIndex) {
-  setUniformBytes(uniformName, value, sizeof(iglu::simdtypes::float2), count, arrayIndex);
+  setFloat2Array(findUniform(uniformName), value, count, arrayIndex);
+}
+
+void ShaderUniforms::setFloat2Array(const UniformHandle& uniform,
+                                    iglu::simdtypes::float2* value,
+                                    size_t count,
+                                    size_t arrayIndex) {
+  if (isHalfUniform(uniform)) {
+    setHalfUniformBytes(uniform, value, sizeof(iglu::simdtypes::float2), count, arrayIndex);
+    return;
+  }
+  setUniformBytes(uniform, value, sizeof(iglu::simdtypes::float2), count, arrayIndex);
 }
 
 void ShaderUniforms::setFloat3(const igl::NameHandle& uniformName,
                                const iglu::simdtypes::float3& value,
                                size_t arrayIndex) {
+  setFloat3(findUniform(uniformName), value, arrayIndex);
+}
+
+void ShaderUniforms::setFloat3(const UniformHandle& uniform,
+                               const iglu::simdtypes::float3& value,
+                               size_t arrayIndex) {
+  if (isHalfUniform(uniform)) {
+    setHalfUniformBytes(uniform, &value, sizeof(iglu::simdtypes::float3), 1, arrayIndex);
+    return;
+  }
   size_t length = _backend == igl::BackendType::Metal ? sizeof(iglu::simdtypes::float3)
                                                       : sizeof(float[3]);
-  setUniformBytes(uniformName, &value, length, 1, arrayIndex);
+  setUniformBytes(uniform, &value, length, 1, arrayIndex);
 }
 
 void ShaderUniforms::setFloat3Array(const igl::NameHandle& uniformName,
                                     iglu::simdtypes::float3* value,
                                     size_t count,
                                     size_t arrayIndex) {
-  if (_backend == igl::BackendType::Metal) {
-    setUniformBytes(uniformName, value, sizeof(iglu::simdtypes::float3), count, arrayIndex);
+  setFloat3Array(findUniform(uniformName), value, count, arrayIndex);
+}
+
+void ShaderUniforms::setFloat3Array(const UniformHandle& uniform,
+                                    iglu::simdtypes::float3* value,
+                                    size_t count,
+                                    size_t arrayIndex) {
+  if (isHalfUniform(uniform)) {
+    setHalfUniformBytes(uniform, value, sizeof(iglu::simdtypes::float3), count, arrayIndex);
+  } else if (_backend == igl::BackendType::Metal) {
+    setUniformBytes(uniform, value, sizeof(iglu::simdtypes::float3), count, arrayIndex);
   } else {
     // simdtypes::float3 is padded to have an extra float.
     // Remove it so we can send the packed version to OpenGL/Vulkan
     auto* packedArray = new float[3 * count];
-    float* packedArrayPtr = packedArray;
-    auto paddedArrayPtr = reinterpret_cast<const float*>(value);
-    for (size_t i = 0; i < count; i++) {
-      for (int j = 0; j < 3; j++) {
-        *packedArrayPtr++ = *paddedArrayPtr++;
-      }
-      paddedArrayPtr++; // padded float
-    }
-    setUniformBytes(uniformName, packedArray, sizeof(float) * 3 * count, 1, arrayIndex);
+    igl::packPaddedFloat3Array(packedArray, reinterpret_cast<const float*>(value), count);
+    setUniformBytes(uniform, packedArray, sizeof(float) * 3 * count, 1, arrayIndex);
     delete[] packedArray;
   }
 }
@@ -303,47 +420,80 @@ void ShaderUniforms::setFloat3Array(const igl::NameHandle& uniformName,
 void ShaderUniforms::setFloat4(const igl::NameHandle& uniformName,
                                const iglu::simdtypes::float4& value,
                                size_t arrayIndex) {
-  setUniformBytes(uniformName, &value, sizeof(iglu::simdtypes::float4), 1, arrayIndex);
+  setFloat4(findUniform(uniformName), value, arrayIndex);
+}
+
+void ShaderUniforms::setFloat4(const UniformHandle& uniform,
+                               const iglu::simdtypes::float4& value,
+                               size_t arrayIndex) {
+  if (isHalfUniform(uniform)) {
+    setHalfUniformBytes(uniform, &value, sizeof(iglu::simdtypes::float4), 1, arrayIndex);
+    return;
+  }
+  setUniformBytes(uniform, &value, sizeof(iglu::simdtypes::float4), 1, arrayIndex);
 }
 
 void ShaderUniforms::setFloat4Array(const igl::NameHandle& uniformName,
                                     const iglu::simdtypes::float4* value,
                                     size_t count,
                                     size_t arrayIndex) {
-  setUniformBytes(uniformName, value, sizeof(iglu::simdtypes::float4), count, arrayIndex);
+  setFloat4Array(findUniform(uniformName), value, count, arrayIndex);
+}
+
+void ShaderUniforms::setFloat4Array(const UniformHandle& uniform,
+                                    const iglu::simdtypes::float4* value,
+                                    size_t count,
+                                    size_t arrayIndex) {
+  if (isHalfUniform(uniform)) {
+    setHalfUniformBytes(uniform, value, sizeof(iglu::simdtypes::float4), count, arrayIndex);
+    return;
+  }
+  setUniformBytes(uniform, value, sizeof(iglu::simdtypes::float4), count, arrayIndex);
 }
 
 void ShaderUniforms::setFloat2x2(const igl::NameHandle& uniformName,
                                  const iglu::simdtypes::float2x2& value,
                                  size_t arrayIndex) {
-  setUniformBytes(uniformName, &value, sizeof(iglu::simdtypes::float2x2), 1, arrayIndex);
+  setFloat2x2(findUniform(uniformName), value, arrayIndex);
+}
+
+void ShaderUniforms::setFloat2x2(const UniformHandle& uniform,
+                                 const iglu::simdtypes::float2x2& value,
+                                 size_t arrayIndex) {
+  setUniformBytes(uniform, &value, sizeof(iglu::simdtypes::float2x2), 1, arrayIndex);
 }
 
 void ShaderUniforms::setFloat2x2Array(const igl::NameHandle& uniformName,
                                       const iglu::simdtypes::float2x2* value,
                                       size_t count,
                                       size_t arrayIndex) {
-  setUniformBytes(uniformName, value, sizeof(iglu::simdtypes::float2x2), count, arrayIndex);
+  setFloat2x2Array(findUniform(uniformName), value, count, arrayIndex);
+}
+
+void ShaderUniforms::setFloat2x2Array(const UniformHandle& uniform,
+                                      const iglu::simdtypes::float2x2* value,
+                                      size_t count,
+                                      size_t arrayIndex) {
+  setUniformBytes(uniform, value, sizeof(iglu::simdtypes::float2x2), count, arrayIndex);
 }
 
 void ShaderUniforms::setFloat3x3(const igl::NameHandle& uniformName,
                                  const iglu::simdtypes::float3x3& value,
                                  size_t arrayIndex) {
+  setFloat3x3(findUniform(uniformName), value, arrayIndex);
+}
+
+void ShaderUniforms::setFloat3x3(const UniformHandle& uniform,
+                                 const iglu::simdtypes::float3x3& value,
+                                 size_t arrayIndex) {
   if (_backend == igl::BackendType::Metal || _backend == igl::BackendType::Vulkan) {
-    setUniformBytes(uniformName, &value, sizeof(iglu::simdtypes::float3x3), 1, arrayIndex);
+    setUniformBytes(uniform, &value, sizeof(iglu::simdtypes::float3x3), 1, arrayIndex);
   } else {
     // simdtypes::float3x3 has an extra float per float-vector.
     // Remove it so we can send the packed version to OpenGL
     float packedMatrix[9] = {0.0f};
-    auto paddedMatrixPtr = reinterpret_cast<const float*>(&value);
-    float* packedMatrixPtr = packedMatrix;
-    for (int i = 0; i < 3; i++) {
-      for (int j = 0; j < 3; j++) {
-        *packedMatrixPtr++ = *paddedMatrixPtr++;
-      }
-      paddedMatrixPtr++; // padded float
-    }
-    setUniformBytes(uniformName, &packedMatrix, sizeof(packedMatrix), 1, arrayIndex);
+    igl::packPaddedFloat3Array(packedMatrix, reinterpret_cast<const float*>(&value), 3);
+    setUniformBytes(uniform, &packedMatrix, sizeof(packedMatrix), 1, arrayIndex);
   }
 }
 
@@ -351,23 +501,21 @@ void ShaderUniforms::setFloat3x3Array(const igl::NameHandle& uniformName,
                                       const iglu::simdtypes::float3x3* value,
                                       size_t count,
                                       size_t arrayIndex) {
+  setFloat3x3Array(findUniform(uniformName), value, count, arrayIndex);
+}
+
+void ShaderUniforms::setFloat3x3Array(const UniformHandle& uniform,
+                                      const iglu::simdtypes::float3x3* value,
+                                      size_t count,
+                                      size_t arrayIndex) {
   if (_backend == igl::BackendType::Metal || _backend == igl::BackendType::Vulkan) {
-    setUniformBytes(uniformName, value, sizeof(iglu::simdtypes::float3x3), count, arrayIndex);
+    setUniformBytes(uniform, value, sizeof(iglu::simdtypes::float3x3), count, arrayIndex);
   } else {
     // simdtypes::float3x3 has an extra float per float-vector.
     // Remove it so we can send the packed version to OpenGL
-    auto paddedMatrixPtr = reinterpret_cast<const float*>(value);
     auto packedMatrix = new float[9 * count];
-    auto packedMatrixPtr = packedMatrix;
-    for (int n = 0; n < count; n++) {
-      for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 3; j++) {
-          *packedMatrixPtr++ = *paddedMatrixPtr++;
-        }
-        paddedMatrixPtr++; // skip over padded float
-      }
-    }
-    setUniformBytes(uniformName, packedMatrix, sizeof(float) * 9 * count, 1, arrayIndex);
+    igl::packPaddedFloat3Array(packedMatrix, reinterpret_cast<const float*>(value), 3 * count);
+    setUniformBytes(uniform, packedMatrix, sizeof(float) * 9 * count, 1, arrayIndex);
     delete[] packedMatrix;
   }
 }
@@ -375,27 +523,53 @@ void ShaderUniforms::setFloat3x3Array(const igl::NameHandle& uniformName,
 void ShaderUniforms::setFloat4x4(const igl::NameHandle& uniformName,
                                  const iglu::simdtypes::float4x4& value,
                                  size_t arrayIndex) {
-  setUniformBytes(uniformName, &value, sizeof(iglu::simdtypes::float4x4), 1, arrayIndex);
+  setFloat4x4(findUniform(uniformName), value, arrayIndex);
+}
+
+void ShaderUniforms::setFloat4x4(const UniformHandle& uniform,
+                                 const iglu::simdtypes::float4x4& value,
+                                 size_t arrayIndex) {
+  setUniformBytes(uniform, &value, sizeof(iglu::simdtypes::float4x4), 1, arrayIndex);
 }
 
 void ShaderUniforms::setFloat4x4Array(const igl::NameHandle& uniformName,
                                       const iglu::simdtypes::float4x4* value,
                                       size_t count,
                                       size_t arrayIndex) {
-  setUniformBytes(uniformName, value, sizeof(iglu::simdtypes::float4x4), count, arrayIndex);
+  setFloat4x4Array(findUniform(uniformName), value, count, arrayIndex);
+}
+
+void ShaderUniforms::setFloat4x4Array(const UniformHandle& uniform,
+                                      const iglu::simdtypes::float4x4* value,
+                                      size_t count,
+                                      size_t arrayIndex) {
+  setUniformBytes(uniform, value, sizeof(iglu::simdtypes::float4x4), count, arrayIndex);
 }
 
 void ShaderUniforms::setInt(const igl::NameHandle& uniformName,
                             const iglu::simdtypes::int1& value,
                             size_t arrayIndex) {
-  setUniformBytes(uniformName, &value, sizeof(iglu::simdtypes::int1), 1, arrayIndex);
+  setInt(findUniform(uniformName), value, arrayIndex);
+}
+
+void ShaderUniforms::setInt(const UniformHandle& uniform,
+                            const iglu::simdtypes::int1& value,
+                            size_t arrayIndex) {
+  setUniformBytes(uniform, &value, sizeof(iglu::simdtypes::int1), 1, arrayIndex);
 }
 
 void ShaderUniforms::setIntArray(const igl::NameHandle& uniformName,
                                  iglu::simdtypes::int1* value,
                                  size_t count,
                                  size_t arrayIndex) {
-  setUniformBytes(uniformName, value, sizeof(iglu::simdtypes::int1), count, arrayIndex);
+  setIntArray(findUniform(uniformName), value, count, arrayIndex);
+}
+
+void ShaderUniforms::setIntArray(const UniformHandle& uniform,
+                                 iglu::simdtypes::int1* value,
+                                 size_t count,
+                                 size_t arrayIndex) {
+  setUniformBytes(uniform, value, sizeof(iglu::simdtypes::int1), count, arrayIndex);
 }
 
 void ShaderUniforms::setBytes(const igl::NameHandle& bufferName,
@@ -444,19 +618,21 @@ void ShaderUniforms::bindUniformOpenGL(const igl::NameHandle& uniformName,
                                        const igl::IRenderPipelineState& pipelineState,
                                        igl::IRenderCommandEncoder& encoder) {
   const igl::BufferArgDesc::BufferMemberDesc& iglMemberDesc = uniformDesc.iglMemberDesc;
+  const auto& glPipelineState = static_cast<const igl::opengl::RenderPipelineState&>(pipelineState);
+  const auto* uniformLocation = glPipelineState.getUniformLocation(uniformName);
   igl::UniformDesc desc;
-  desc.location = pipelineState.getIndexByName(uniformName, igl::ShaderStage::Fragment);
+  desc.location =
+      uniformLocation && !uniformLocation->isUniformBlock ? uniformLocation->location : -1;
   desc.type = iglMemberDesc.type;
   desc.offset = iglMemberDesc.offset;
   desc.numElements = iglMemberDesc.arrayLength;
   desc.elementStride = igl::sizeForUniformType(iglMemberDesc.type);
 
   if (desc.location >= 0) {
-    auto strongBuffer = uniformDesc.buffer.lock();
-    if (strongBuffer) {
+    if (uniformDesc.buffer) {
       // We are binding individual uniforms. Confirm that iglBuffer is null
-      IGL_ASSERT(strongBuffer->allocation->iglBuffer == nullptr);
-      encoder.bindUniform(desc, strongBuffer->allocation->ptr);
+      IGL_ASSERT(uniformDesc.buffer->allocation->iglBuffer == nullptr);
+      encoder.bindUniform(desc, uniformDesc.buffer->allocation->ptr);
     }
   } else {
     IGL_LOG_ERROR_ONCE("[IGL][Error] Uniform not found in shader: %s\n", uniformName.toConstChar());
@@ -476,8 +652,7 @@ void ShaderUniforms::bindBuffer(igl::IDevice& device,
     const auto& uniformName = buffer->iglBufferDesc.name;
     if (buffer->iglBufferDesc.isUniformBlock) {
       IGL_ASSERT(buffer->allocation->iglBuffer != nullptr);
-      buffer->allocation->iglBuffer->upload(buffer->allocation->ptr,
-                                            igl::BufferRange(buffer->allocation->size, 0));
+      uploadDirtyRange(*buffer->allocation);
       const auto& glPipelineState =
           static_cast<const igl::opengl::RenderPipelineState&>(pipelineState);
       encoder.bindBuffer(glPipelineState.getUniformBlockBindingPoint(uniformName),
@@ -503,8 +678,14 @@ void ShaderUniforms::bindBuffer(igl::IDevice& device,
         uploadSize = buffer->suballocationsSize;
       }
 
-      buffer->allocation->iglBuffer->upload((uint8_t*)buffer->allocation->ptr + subAllocatedOffset,
-                                            igl::BufferRange(uploadSize, subAllocatedOffset));
+      if (device.getBackendType() == igl::BackendType::Vulkan) {
+        // Vulkan ring buffers only hold the data uploaded during their own frame
+        buffer->allocation->iglBuffer->upload(
+            (uint8_t*)buffer->allocation->ptr + subAllocatedOffset,
+            igl::BufferRange(uploadSize, subAllocatedOffset));
+      } else {
+        uploadDirtyRange(*buffer->allocation);
+      }
       uint8_t bindTarget;
       if (device.getBackendType() == igl::BackendType::Vulkan) {
         bindTarget = igl::BindTarget::kAllGraphics;
@@ -524,20 +705,28 @@ void ShaderUniforms::bindBuffer(igl::IDevice& device,
   }
 }
 
+void ShaderUniforms::uploadDirtyRange(BufferAllocation& allocation) {
+  if (allocation.dirtyEnd == 0) {
+    return;
+  }
+  allocation.iglBuffer->upload(
+      (uint8_t*)allocation.ptr + allocation.dirtyBegin,
+      igl::BufferRange(allocation.dirtyEnd - allocation.dirtyBegin, allocation.dirtyBegin));
+  allocation.dirtyBegin = allocation.dirtyEnd = 0;
+}
+
 // Bind the block which the specified uniform belongs to.
 void ShaderUniforms::bind(igl::IDevice& device,
                           const igl::IRenderPipelineState& pipelineState,
                           igl::IRenderCommandEncoder& encoder,
                           const igl::NameHandle& uniformName) {
-  auto range = _allUniformsByName.equal_range(uniformName);
-  if (range.first == range.second) {
-    IGL_LOG_ERROR_ONCE("[IGL][Error] Invalid uniform name: %s\n", uniformName.toConstChar());
+  const UniformHandle handle = findUniform(uniformName);
+  if (!handle.isValid()) {
     return;
   }
 
-  for (auto it = range.first; it != range.second; ++it) {
-    auto strongBuffer = it->second.buffer.lock();
-    bindBuffer(device, pipelineState, encoder, strongBuffer.get());
+  for (const UniformDesc& uniformDesc : _uniformsByHandle[handle.index]) {
+    bindBuffer(device, pipelineState, encoder, uniformDesc.buffer);
   }
 }
 
@@ -579,8 +768,8 @@ igl::Result ShaderUniforms::setSuballocationIndex(const igl::NameHandle& name, i
                        "Invalid argument, index cannot be < 0");
   }
 
-  auto range = _allUniformsByName.equal_range(name);
-  if (range.first == range.second) {
+  const UniformHandle handle = uniformHandle(name);
+  if (!handle.isValid()) {
     return igl::Result(igl::Result::Code::RuntimeError,
                        "Could not find uniform " + name.toString());
   }
@@ -588,10 +777,8 @@ igl::Result ShaderUniforms::setSuballocationIndex(const igl::NameHandle& name, i
   // At least one of the uniforms should be updated
   bool setIndexSuccess = false;
 
-  for (auto it = range.first; it != range.second; ++it) {
-    auto& uniformDesc = it->second;
-
-    auto strongBuffer = uniformDesc.buffer.lock();
+  for (const UniformDesc& uniformDesc : _uniformsByHandle[handle.index]) {
+    BufferDesc* strongBuffer = uniformDesc.buffer;
 
     if (!strongBuffer || !strongBuffer->isSuballocated) {
       continue;
@@ -8,10 +8,12 @@
 #pragma once
 
 #include <IGLU/simdtypes/SimdTypes.h>
+#include <algorithm>
 #include <igl/Common.h>
 #include <igl/IGL.h>
 #include <igl/NameHandle.h>
 #include <igl/Shader.h>
+#include <limits>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -22,82 +24,164 @@ namespace material {
 
 /// Handles allocation, updating and binding of shader uniforms. It uses reflection
 /// information to generate the underlying data and provides a simple API to manipulate it.
+///
+/// Setters only write to CPU memory and track the modified range of every buffer: bind() uploads
+/// the modified ranges, and nothing when no uniform of a buffer changed since the last bind().
+///
+/// The float setters also fill uniforms declared with half types (UniformType::Float16 to
+/// Float16x4), e.g. `half4` on Metal: the values are converted to half floats as they are written.
 class ShaderUniforms final {
  public:
+  /// The pre-resolved location of a uniform in all the buffers declaring it, obtained once with
+  /// uniformHandle(). Setters taking a handle skip the name lookup.
+  struct UniformHandle {
+    static constexpr size_t kInvalidIndex = std::numeric_limits<size_t>::max();
+    size_t index = kInvalidIndex;
+
+    bool isValid() const {
+      return index != kInvalidIndex;
+    }
+  };
+
+  /// Returns an invalid handle if no shader stage declares 'uniformName'. Handles are only valid
+  /// for the ShaderUniforms object which returned them.
+  UniformHandle uniformHandle(const igl::NameHandle& uniformName) const;
+
   // Use this to retrieve information about the underlying data.
   const igl::BufferArgDesc& bufferDescriptor(const igl::NameHandle& bufferName,
                                              igl::ShaderStage stage) const;
 
   // Setters: use these to update uniforms, individually or in bulk.
   void setBool(const igl::NameHandle& uniformName, const bool& value, size_t arrayIndex = 0);
+  void setBool(const UniformHandle& uniform, const bool& value, size_t arrayIndex = 0);
   void setBoolArray(const igl::NameHandle& uniformName,
                     bool* value,
                     size_t count = 1,
                     size_t arrayIndex = 0);
+  void setBoolArray(const UniformHandle& uniform,
+                    bool* value,
+                    size_t count = 1,
+                    size_t arrayIndex = 0);
 
   void setFloat(const igl::NameHandle& uniformName,
                 const iglu::simdtypes::float1& value,
                 size_t arrayIndex = 0);
+  void setFloat(const UniformHandle& uniform,
+                const iglu::simdtypes::float1& value,
+                size_t arrayIndex = 0);
   void setFloatArray(const igl::NameHandle& uniformName,
                      iglu::simdtypes::float1* value,
                      size_t count = 1,
                      size_t arrayIndex = 0);
+  void setFloatArray(const UniformHandle& uniform,
+                     iglu::simdtypes::float1* value,
+                     size_t count = 1,
+                     size_t arrayIndex = 0);
 
   void setFloat2(const igl::NameHandle& uniformName,
                  const iglu::simdtypes::float2& value,
                  size_t arrayIndex = 0);
+  void setFloat2(const UniformHandle& uniform,
+                 const iglu::simdtypes::float2& value,
+                 size_t arrayIndex = 0);
   void setFloat2Array(const igl::NameHandle& uniformName,
                       iglu::simdtypes::float2* value,
                       size_t count = 1,
                       size_t arrayIndex = 0);
+  void setFloat2Array(const UniformHandle& uniform,
+                      iglu::simdtypes::float2* value,
+                      size_t count = 1,
+                      size_t arrayIndex = 0);
 
   void setFloat3(const igl::NameHandle& uniformName,
                  const iglu::simdtypes::float3& value,
                  size_t arrayIndex = 0);
+  void setFloat3(const UniformHandle& uniform,
+                 const iglu::simdtypes::float3& value,
+                 size_t arrayIndex = 0);
   void setFloat3Array(const igl::NameHandle& uniformName,
                       iglu::simdtypes::float3* value,
                       size_t count = 1,
                       size_t arrayIndex = 0);
+  void setFloat3Array(const UniformHandle& uniform,
+                      iglu::simdtypes::float3* value,
+                      size_t count = 1,
+                      size_t arrayIndex = 0);
 
   void setFloat4(const igl::NameHandle& uniformName,
                  const iglu::simdtypes::float4& value,
                  size_t arrayIndex = 0);
+  void setFloat4(const UniformHandle& uniform,
+                 const iglu::simdtypes::float4& value,
+                 size_t arrayIndex = 0);
   void setFloat4Array(const igl::NameHandle& uniformName,
                       const iglu::simdtypes::float4* value,
                       size_t count = 1,
                       size_t arrayIndex = 0);
+  void setFloat4Array(const UniformHandle& uniform,
+                      const iglu::simdtypes::float4* value,
+                      size_t count = 1,
+                      size_t arrayIndex = 0);
 
   void setFloat2x2(const igl::NameHandle& uniformName,
                    const iglu::simdtypes::float2x2& value,
                    size_t arrayIndex = 0);
+  void setFloat2x2(const UniformHandle& uniform,
+                   const iglu::simdtypes::float2x2& value,
+                   size_t arrayIndex = 0);
   void setFloat2x2Array(const igl::NameHandle& uniformName,
                         const iglu::simdtypes::float2x2* value,
                         size_t count = 1,
                         size_t arrayIndex = 0);
+  void setFloat2x2Array(const UniformHandle& uniform,
+                        const iglu::simdtypes::float2x2* value,
+                        size_t count = 1,
+                        size_t arrayIndex = 0);
 
   void setFloat3x3(const igl::NameHandle& uniformName,
                    const iglu::simdtypes::float3x3& value,
                    size_t arrayIndex = 0);
+  void setFloat3x3(const UniformHandle& uniform,
+                   const iglu::simdtypes::float3x3& value,
+                   size_t arrayIndex = 0);
   void setFloat3x3Array(const igl::NameHandle& uniformName,
                         const iglu::simdtypes::float3x3* value,
                         size_t count = 1,
                         size_t arrayIndex = 0);
+  void setFloat3x3Array(const UniformHandle& uniform,
+                        const iglu::simdtypes::float3x3* value,
+                        size_t count = 1,
+                        size_t arrayIndex = 0);
 
   void setFloat4x4(const igl::NameHandle& uniformName,
                    const iglu::simdtypes::float4x4& value,
                    size_t arrayIndex = 0);
+  void setFloat4x4(const UniformHandle& uniform,
+                   const iglu::simdtypes::float4x4& value,
+                   size_t arrayIndex = 0);
   void setFloat4x4Array(const igl::NameHandle& uniformName,
                         const iglu::simdtypes::float4x4* value,
                         size_t count = 1,
                         size_t arrayIndex = 0);
+  void setFloat4x4Array(const UniformHandle& uniform,
+                        const iglu::simdtypes::float4x4* value,
+                        size_t count = 1,
+                        size_t arrayIndex = 0);
 
   void setInt(const igl::NameHandle& uniformName,
               const iglu::simdtypes::int1& value,
               size_t arrayIndex = 0);
+  void setInt(const UniformHandle& uniform,
+              const iglu::simdtypes::int1& value,
+              size_t arrayIndex = 0);
   void setIntArray(const igl::NameHandle& uniformName,
                    iglu::simdtypes::int1* value,
                    size_t count = 1,
                    size_t arrayIndex = 0);
+  void setIntArray(const UniformHandle& uniform,
+                   iglu::simdtypes::int1* value,
+                   size_t count = 1,
+                   size_t arrayIndex = 0);
 
   void setBytes(const igl::NameHandle& bufferName,
                 void* data,
@@ -139,7 +223,7 @@ class ShaderUniforms final {
   igl::Result setSuballocationIndex(const igl::NameHandle& name, int index);
 
   inline bool containsUniform(const igl::NameHandle& uniformName) const {
-    return _allUniformsByName.count(uniformName) > 0;
+    return _uniformHandlesByName.count(uniformName) > 0;
   }
 
   ShaderUniforms(igl::IDevice& device, const igl::IRenderPipelineReflection& reflection);
@@ -150,16 +234,24 @@ class ShaderUniforms final {
     void* ptr = nullptr;
     size_t size = 0;
     std::shared_ptr<igl::IBuffer> iglBuffer;
-    bool dirty = false;
+    // range of 'ptr' modified since the last upload to 'iglBuffer', empty if dirtyEnd == 0
+    size_t dirtyBegin = 0;
+    size_t dirtyEnd = 0;
 
     BufferAllocation(void* ptr, size_t size, std::shared_ptr<igl::IBuffer> buffer) :
-      ptr(ptr), size(size), iglBuffer(std::move(buffer)) {}
+      ptr(ptr), size(size), iglBuffer(std::move(buffer)), dirtyEnd(size) {}
+
+    void markDirty(size_t offset, size_t length) {
+      dirtyBegin = dirtyEnd == 0 ? offset : std::min(dirtyBegin, offset);
+      dirtyEnd = std::max(dirtyEnd, offset + length);
+    }
   };
 
   struct BufferDesc;
   struct UniformDesc {
     igl::BufferArgDesc::BufferMemberDesc iglMemberDesc;
-    std::weak_ptr<BufferDesc> buffer;
+    // owned by _bufferDescs
+    BufferDesc* buffer = nullptr;
   };
   struct BufferDesc {
     igl::BufferArgDesc iglBufferDesc;
@@ -178,7 +270,9 @@ class ShaderUniforms final {
   std::vector<std::shared_ptr<BufferDesc>> _bufferDescs;
   std::map<std::pair<igl::NameHandle, igl::ShaderStage>, std::shared_ptr<BufferDesc>>
       _allBuffersByName;
-  std::unordered_multimap<igl::NameHandle, UniformDesc> _allUniformsByName;
+  // indexed by UniformHandle::index, one entry per buffer declaring the uniform
+  std::vector<std::vector<UniformDesc>> _uniformsByHandle;
+  std::unordered_map<igl::NameHandle, UniformHandle> _uniformHandlesByName;
 
   struct TextureSlot {
     std::shared_ptr<igl::ITexture> texture;
@@ -190,13 +284,28 @@ class ShaderUniforms final {
 
   std::unordered_map<std::string, std::shared_ptr<igl::ISamplerState>> _allSamplersByName;
   const igl::BackendType _backend;
+  // half floats converted by setHalfUniformBytes()
+  std::vector<uint8_t> _halfScratch;
+
+  // logs an error if the uniform does not exist
+  UniformHandle findUniform(const igl::NameHandle& uniformName) const;
 
-  void setUniformBytes(const igl::NameHandle& name,
+  void setUniformBytes(const UniformHandle& uniform,
                        const void* data,
                        size_t elementSize,
                        size_t count,
                        size_t arrayIndex);
 
+  // true if 'uniform' is declared with a half type
+  bool isHalfUniform(const UniformHandle& uniform) const;
+
+  // converts 'count' elements of floats spaced by 'srcStride' bytes to the half type of 'uniform'
+  void setHalfUniformBytes(const UniformHandle& uniform,
+                           const void* data,
+                           size_t srcStride,
+                           size_t count,
+                           size_t arrayIndex);
+
   void bindUniformOpenGL(const igl::NameHandle& uniformName,
                          const UniformDesc& uniformDesc,
                          const igl::IRenderPipelineState& pipelineState,
@@ -206,6 +315,8 @@ class ShaderUniforms final {
                   const igl::IRenderPipelineState& pipelineState,
                   igl::IRenderCommandEncoder& encoder,
                   BufferDesc* buffer);
+
+  void uploadDirtyRange(BufferAllocation& allocation);
 };
 
 } // namespace material
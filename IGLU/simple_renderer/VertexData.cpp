@@ -64,20 +64,29 @@ bool VertexData::appendData(const void* data, size_t size, size_t numPrimitives)
   return true;
 }
 
-void VertexData::draw(igl::IRenderCommandEncoder& commandEncoder) {
-  if (primitiveDesc_.numEntries == 0) {
+void VertexData::draw(igl::IRenderCommandEncoder& commandEncoder, uint32_t instanceCount) {
+  if (primitiveDesc_.numEntries == 0 || instanceCount == 0) {
     return;
   }
-  // Assumption: we don't need buffer offset
   if (vb_) {
-    commandEncoder.bindBuffer(0, igl::BindTarget::kVertex, vb_, 0);
+    commandEncoder.bindBuffer(0, igl::BindTarget::kVertex, vb_, primitiveDesc_.vertexOffset);
   }
 
-  if (ib_) {
+  if (ib_ && instanceCount == 1) {
     commandEncoder.drawIndexed(
         primitiveDesc_.type, primitiveDesc_.numEntries, ibFormat_, *ib_, primitiveDesc_.offset);
-  } else {
+  } else if (ib_) {
+    commandEncoder.drawIndexedInstanced(primitiveDesc_.type,
+                                        primitiveDesc_.numEntries,
+                                        ibFormat_,
+                                        *ib_,
+                                        primitiveDesc_.offset,
+                                        instanceCount);
+  } else if (instanceCount == 1) {
     commandEncoder.draw(primitiveDesc_.type, primitiveDesc_.offset, primitiveDesc_.numEntries);
+  } else {
+    commandEncoder.drawInstanced(
+        primitiveDesc_.type, primitiveDesc_.offset, primitiveDesc_.numEntries, instanceCount);
   }
 }
 
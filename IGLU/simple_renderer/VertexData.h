@@ -20,6 +20,8 @@ struct PrimitiveDesc {
   size_t offset = 0;
   igl::PrimitiveType type = igl::PrimitiveType::Triangle;
   igl::WindingMode frontFaceWinding = igl::WindingMode::CounterClockwise;
+  /// Offset in bytes of the first vertex in the vertex buffer, e.g. when it holds several meshes
+  size_t vertexOffset = 0;
 };
 
 /// Consolidates all vertex data input in a single place. Also handles binding and drawing.
@@ -29,8 +31,9 @@ class VertexData final {
   /// before draw().
   void populatePipelineDescriptor(igl::RenderPipelineDesc& pipelineDesc) const;
 
-  /// Invokes the draw command of the lower level APIs.
-  void draw(igl::IRenderCommandEncoder& commandEncoder);
+  /// Invokes the draw command of the lower level APIs. An 'instanceCount' other than 1 requires
+  /// igl::DeviceFeatures::DrawInstanced.
+  void draw(igl::IRenderCommandEncoder& commandEncoder, uint32_t instanceCount = 1);
 
   PrimitiveDesc& primitiveDesc();
   std::shared_ptr<igl::IVertexInputState> vertexInputState();
@@ -0,0 +1,416 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Skinner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace iglu {
+namespace skinning {
+
+namespace {
+
+constexpr uint32_t kThreadgroupSize = 64;
+constexpr size_t kJointMatrixSize = 16 * sizeof(float);
+
+// buffer slots of the shaders
+enum Slot : size_t {
+  kSlotVertices = 0,
+  kSlotInfluences = 1,
+  kSlotMorphTargets = 2,
+  kSlotJoints = 3,
+  kSlotMorphWeights = 4,
+  kSlotOutput = 5,
+  kSlotParams = 6, // Metal only, push constants on Vulkan
+};
+
+struct Params {
+  uint32_t numVertices = 0;
+  uint32_t numJoints = 0;
+  uint32_t numMorphTargets = 0;
+  uint32_t padding = 0;
+};
+
+static_assert(sizeof(SkinningVertex) == 32, "SkinningVertex must match the shaders");
+static_assert(sizeof(SkinInfluence) == 32, "SkinInfluence must match the shaders");
+
+// buffers are accessed through buffer device addresses, see igl::vulkan::Device
+const char kVulkanShader[] = R"(
+layout (local_size_x = 64) in;
+
+struct Vertex {
+  vec4 position;
+  vec4 normal;
+};
+
+struct Influence {
+  vec4 weights;
+  uvec4 joints;
+};
+
+layout (std430, buffer_reference) readonly buffer Vertices {
+  Vertex vertices[];
+};
+
+layout (std430, buffer_reference) writeonly buffer OutVertices {
+  Vertex vertices[];
+};
+
+layout (std430, buffer_reference) readonly buffer Influences {
+  Influence influences[];
+};
+
+layout (std430, buffer_reference) readonly buffer Joints {
+  mat4 joints[];
+};
+
+layout (std430, buffer_reference) readonly buffer MorphWeights {
+  float weights[];
+};
+
+layout (push_constant) uniform PushConstants {
+  uint numVertices;
+  uint numJoints;
+  uint numMorphTargets;
+} pc;
+
+mat4 getJoint(uint j) {
+  return Joints(getBuffer(3)).joints[min(j, pc.numJoints - 1u)];
+}
+
+void main() {
+  uint i = gl_GlobalInvocationID.x;
+  if (i >= pc.numVertices) {
+    return;
+  }
+  Vertex v = Vertices(getBuffer(0)).vertices[i];
+  vec3 p = v.position.xyz;
+  vec3 n = v.normal.xyz;
+  for (uint t = 0; t != pc.numMorphTargets; t++) {
+    float w = MorphWeights(getBuffer(4)).weights[t];
+    if (w != 0.0) {
+      Vertex d = Vertices(getBuffer(2)).vertices[t * pc.numVertices + i];
+      p += w * d.position.xyz;
+      n += w * d.normal.xyz;
+    }
+  }
+  if (pc.numJoints != 0u) {
+    Influence inf = Influences(getBuffer(1)).influences[i];
+    mat4 m = inf.weights.x * getJoint(inf.joints.x) + inf.weights.y * getJoint(inf.joints.y) +
+             inf.weights.z * getJoint(inf.joints.z) + inf.weights.w * getJoint(inf.joints.w);
+    p = (m * vec4(p, 1.0)).xyz;
+    n = mat3(m) * n;
+  }
+  float len = length(n);
+  OutVertices(getBuffer(5)).vertices[i] =
+      Vertex(vec4(p, 1.0), vec4(len > 0.0 ? n / len : n, 0.0));
+}
+)";
+
+const char kMetalShader[] = R"(
+using namespace metal;
+
+struct Vertex {
+  float4 position;
+  float4 normal;
+};
+
+struct Influence {
+  float4 weights;
+  uint4 joints;
+};
+
+struct Params {
+  uint numVertices;
+  uint numJoints;
+  uint numMorphTargets;
+};
+
+kernel void skinVertices(device const Vertex* vertices [[buffer(0)]],
+                         device const Influence* influences [[buffer(1)]],
+                         device const Vertex* morphTargets [[buffer(2)]],
+                         device const float4x4* joints [[buffer(3)]],
+                         device const float* morphWeights [[buffer(4)]],
+                         device Vertex* outVertices [[buffer(5)]],
+                         constant Params& params [[buffer(6)]],
+                         uint i [[thread_position_in_grid]]) {
+  if (i >= params.numVertices) {
+    return;
+  }
+  Vertex v = vertices[i];
+  float3 p = v.position.xyz;
+  float3 n = v.normal.xyz;
+  for (uint t = 0; t != params.numMorphTargets; t++) {
+    float w = morphWeights[t];
+    if (w != 0.0) {
+      Vertex d = morphTargets[t * params.numVertices + i];
+      p += w * d.position.xyz;
+      n += w * d.normal.xyz;
+    }
+  }
+  if (params.numJoints != 0u) {
+    Influence inf = influences[i];
+    uint4 j = min(inf.joints, uint4(params.numJoints - 1u));
+    float4x4 m = inf.weights.x * joints[j.x] + inf.weights.y * joints[j.y] +
+                 inf.weights.z * joints[j.z] + inf.weights.w * joints[j.w];
+    p = (m * float4(p, 1.0)).xyz;
+    n = float3x3(m[0].xyz, m[1].xyz, m[2].xyz) * n;
+  }
+  float len = length(n);
+  outVertices[i] = Vertex{float4(p, 1.0), float4(len > 0.0 ? n / len : n, 0.0)};
+}
+)";
+
+} // namespace
+
+bool Skinner::isComputeSupported(const igl::IDevice& device) {
+  const igl::BackendType backend = device.getBackendType();
+  return (backend == igl::BackendType::Vulkan || backend == igl::BackendType::Metal) &&
+         device.hasFeature(igl::DeviceFeatures::Compute);
+}
+
+Skinner::Skinner(igl::IDevice& device, SkinnedMeshDesc desc, igl::Result* outResult) :
+  backendType_(device.getBackendType()), desc_(std::move(desc)) {
+  const size_t numVertices = desc_.vertices.size();
+  if (numVertices == 0) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "No vertices");
+    return;
+  }
+  if ((desc_.numJoints != 0 && desc_.influences.size() != numVertices) ||
+      desc_.morphTargetDeltas.size() != numVertices * desc_.numMorphTargets) {
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::ArgumentInvalid,
+                           "Skin influences or morph targets do not match the vertices");
+    return;
+  }
+
+  igl::Result ret;
+
+  if (!isComputeSupported(device)) {
+    numVertices_ = static_cast<uint32_t>(numVertices);
+    cpuOutput_.resize(numVertices);
+    skin(desc_, nullptr, nullptr, cpuOutput_.data());
+    outputBuffer_ = device.createBuffer(igl::BufferDesc(igl::BufferDesc::BufferTypeBits::Vertex,
+                                                        cpuOutput_.data(),
+                                                        numVertices * sizeof(SkinningVertex),
+                                                        igl::ResourceStorage::Shared,
+                                                        0,
+                                                        "Buffer: skinned " + desc_.debugName),
+                                        &ret);
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+
+  auto createStorageBuffer = [&device, &ret](const void* data, size_t length, std::string name) {
+    return device.createBuffer(igl::BufferDesc(igl::BufferDesc::BufferTypeBits::Storage,
+                                               data,
+                                               length,
+                                               igl::ResourceStorage::Private,
+                                               0,
+                                               std::move(name)),
+                               &ret);
+  };
+
+  vertexBuffer_ = createStorageBuffer(desc_.vertices.data(),
+                                      numVertices * sizeof(SkinningVertex),
+                                      "Buffer: rest pose " + desc_.debugName);
+  if (ret.isOk() && desc_.numJoints) {
+    influenceBuffer_ = createStorageBuffer(desc_.influences.data(),
+                                           numVertices * sizeof(SkinInfluence),
+                                           "Buffer: skin influences " + desc_.debugName);
+  }
+  if (ret.isOk() && desc_.numMorphTargets) {
+    morphTargetBuffer_ =
+        createStorageBuffer(desc_.morphTargetDeltas.data(),
+                            desc_.morphTargetDeltas.size() * sizeof(SkinningVertex),
+                            "Buffer: morph targets " + desc_.debugName);
+  }
+  if (ret.isOk()) {
+    outputBuffer_ = device.createBuffer(
+        igl::BufferDesc(igl::BufferDesc::BufferTypeBits::Storage |
+                            igl::BufferDesc::BufferTypeBits::Vertex,
+                        nullptr,
+                        numVertices * sizeof(SkinningVertex),
+                        igl::ResourceStorage::Private,
+                        0,
+                        "Buffer: skinned " + desc_.debugName),
+        &ret);
+  }
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+
+  igl::ComputePipelineDesc pipelineDesc;
+  const bool isMetal = backendType_ == igl::BackendType::Metal;
+  pipelineDesc.shaderStages =
+      igl::ShaderStagesCreator::fromModuleStringInput(device,
+                                                      isMetal ? kMetalShader : kVulkanShader,
+                                                      isMetal ? "skinVertices" : "main",
+                                                      "Shader Module: skinning",
+                                                      &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+  pipelineDesc.debugName = "Pipeline: skinning";
+  pipelineState_ = device.createComputePipeline(pipelineDesc, &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+
+  // the mesh data is only needed on the GPU from now on
+  desc_.vertices = {};
+  desc_.influences = {};
+  desc_.morphTargetDeltas = {};
+  numVertices_ = static_cast<uint32_t>(numVertices);
+  igl::Result::setOk(outResult);
+}
+
+void Skinner::encode(igl::IComputeCommandEncoder& encoder,
+                     igl::IRingBuffer& ringBuffer,
+                     const float* IGL_NULLABLE jointMatrices,
+                     const float* IGL_NULLABLE morphWeights,
+                     igl::Result* IGL_NULLABLE outResult) {
+  if (!IGL_VERIFY(usesCompute())) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::InvalidOperation, "Compute skinning is not supported");
+    return;
+  }
+
+  Params params;
+  params.numVertices = numVertices_;
+  params.numJoints = jointMatrices ? desc_.numJoints : 0;
+  params.numMorphTargets = morphWeights ? desc_.numMorphTargets : 0;
+
+  const size_t jointsSize = params.numJoints * kJointMatrixSize;
+  const size_t weightsSize = params.numMorphTargets * sizeof(float);
+
+  // unused slots are bound to the rest pose, so that every slot read by the shader is valid
+  std::shared_ptr<igl::IBuffer> frameBuffer = vertexBuffer_;
+  size_t jointsOffset = 0;
+  size_t weightsOffset = 0;
+  if (jointsSize + weightsSize) {
+    igl::Result ret;
+    const auto allocation = ringBuffer.allocate(jointsSize + weightsSize, &ret);
+    if (allocation.empty()) {
+      igl::Result::setResult(outResult, std::move(ret));
+      return;
+    }
+    IGL_ASSERT_MSG(allocation.offset % 16 == 0, "Ring buffer allocations must be 16-byte aligned");
+    if (jointsSize) {
+      memcpy(allocation.data, jointMatrices, jointsSize);
+    }
+    if (weightsSize) {
+      memcpy(static_cast<uint8_t*>(allocation.data) + jointsSize, morphWeights, weightsSize);
+    }
+    // bindBuffer() needs shared ownership of the buffer, which IRingBuffer does not hand out
+    frameBuffer = std::shared_ptr<igl::IBuffer>(std::shared_ptr<igl::IBuffer>(),
+                                                &ringBuffer.getBuffer());
+    jointsOffset = allocation.offset;
+    weightsOffset = allocation.offset + jointsSize;
+  }
+
+  encoder.bindComputePipelineState(pipelineState_);
+  encoder.bindBuffer(kSlotVertices, vertexBuffer_, 0);
+  encoder.bindBuffer(kSlotInfluences, influenceBuffer_ ? influenceBuffer_ : vertexBuffer_, 0);
+  encoder.bindBuffer(
+      kSlotMorphTargets, morphTargetBuffer_ ? morphTargetBuffer_ : vertexBuffer_, 0);
+  encoder.bindBuffer(kSlotJoints, jointsSize ? frameBuffer : vertexBuffer_, jointsOffset);
+  encoder.bindBuffer(kSlotMorphWeights, weightsSize ? frameBuffer : vertexBuffer_, weightsOffset);
+  encoder.bindBuffer(kSlotOutput, outputBuffer_, 0);
+  if (backendType_ == igl::BackendType::Vulkan) {
+    encoder.bindPushConstants(0, &params, sizeof(params));
+  } else {
+    encoder.bindBytes(kSlotParams, &params, sizeof(params));
+  }
+  encoder.dispatchThreadGroups(
+      igl::Dimensions((numVertices_ + kThreadgroupSize - 1) / kThreadgroupSize, 1, 1),
+      igl::Dimensions(kThreadgroupSize, 1, 1));
+
+  igl::Result::setOk(outResult);
+}
+
+void Skinner::skinOnCpu(const float* IGL_NULLABLE jointMatrices,
+                        const float* IGL_NULLABLE morphWeights,
+                        igl::Result* IGL_NULLABLE outResult) {
+  if (!IGL_VERIFY(outputBuffer_ && !usesCompute())) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::InvalidOperation, "Use encode() with compute skinning");
+    return;
+  }
+  skin(desc_, jointMatrices, morphWeights, cpuOutput_.data());
+  igl::Result::setResult(
+      outResult,
+      outputBuffer_->upload(cpuOutput_.data(),
+                            igl::BufferRange(cpuOutput_.size() * sizeof(SkinningVertex), 0)));
+}
+
+void Skinner::skin(const SkinnedMeshDesc& desc,
+                   const float* IGL_NULLABLE jointMatrices,
+                   const float* IGL_NULLABLE morphWeights,
+                   SkinningVertex* IGL_NONNULL outVertices) {
+  const size_t numVertices = desc.vertices.size();
+  const bool hasJoints = jointMatrices && desc.numJoints && desc.influences.size() == numVertices;
+  const uint32_t numMorphTargets = morphWeights ? desc.numMorphTargets : 0;
+
+  for (size_t i = 0; i != numVertices; i++) {
+    const SkinningVertex& v = desc.vertices[i];
+    float p[3] = {v.position[0], v.position[1], v.position[2]};
+    float n[3] = {v.normal[0], v.normal[1], v.normal[2]};
+
+    for (uint32_t t = 0; t != numMorphTargets; t++) {
+      const float w = morphWeights[t];
+      if (w != 0.0f) {
+        const SkinningVertex& d = desc.morphTargetDeltas[t * numVertices + i];
+        for (int c = 0; c != 3; c++) {
+          p[c] += w * d.position[c];
+          n[c] += w * d.normal[c];
+        }
+      }
+    }
+
+    if (hasJoints) {
+      const SkinInfluence& inf = desc.influences[i];
+      // column-major, like the joint matrices
+      float m[16] = {};
+      for (int k = 0; k != 4; k++) {
+        if (inf.weights[k] == 0.0f) {
+          continue;
+        }
+        const float* joint =
+            jointMatrices + std::min(inf.joints[k], desc.numJoints - 1) * size_t(16);
+        for (int e = 0; e != 16; e++) {
+          m[e] += inf.weights[k] * joint[e];
+        }
+      }
+      const float sp[3] = {p[0], p[1], p[2]};
+      const float sn[3] = {n[0], n[1], n[2]};
+      for (int r = 0; r != 3; r++) {
+        p[r] = m[r] * sp[0] + m[4 + r] * sp[1] + m[8 + r] * sp[2] + m[12 + r];
+        n[r] = m[r] * sn[0] + m[4 + r] * sn[1] + m[8 + r] * sn[2];
+      }
+    }
+
+    const float len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    const float invLen = len > 0.0f ? 1.0f / len : 1.0f;
+    SkinningVertex& out = outVertices[i];
+    for (int c = 0; c != 3; c++) {
+      out.position[c] = p[c];
+      out.normal[c] = n[c] * invLen;
+    }
+    out.position[3] = 1.0f;
+    out.normal[3] = 0.0f;
+  }
+}
+
+} // namespace skinning
+} // namespace iglu
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/IGL.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace iglu {
+namespace skinning {
+
+/// Position and normal of a vertex, as read and written by the Skinner. The w components are
+/// ignored on input; the output has w = 1 for positions and w = 0 for normals.
+struct SkinningVertex {
+  float position[4] = {};
+  float normal[4] = {};
+};
+
+/// Joints influencing a vertex and their weights, which should sum up to 1. Unused joints have a
+/// weight of 0.
+struct SkinInfluence {
+  float weights[4] = {};
+  uint32_t joints[4] = {};
+};
+
+/**
+ * @brief Rest pose and deformation data of a mesh.
+ *
+ *  vertices          - Rest pose, in the space the joint matrices transform from
+ *  influences        - Empty for meshes which only use morph targets, otherwise one per vertex
+ *  numJoints         - Number of joint matrices passed every frame
+ *  morphTargetDeltas - Offsets added to the vertices, weighted by the morph weights of the
+ *                      frame. Target-major: numMorphTargets consecutive arrays of
+ *                      vertices.size() deltas
+ *  numMorphTargets   - Number of morph weights passed every frame
+ */
+struct SkinnedMeshDesc {
+  std::vector<SkinningVertex> vertices;
+  std::vector<SkinInfluence> influences;
+  uint32_t numJoints = 0;
+  std::vector<SkinningVertex> morphTargetDeltas;
+  uint32_t numMorphTargets = 0;
+  std::string debugName;
+};
+
+/**
+ * @brief Deforms a mesh once per frame into a vertex buffer which every pass of the frame (depth
+ * pre-pass, shadows, main pass...) can render, instead of skinning in each of their vertex
+ * shaders.
+ *
+ * Morph targets are applied first, then linear blend skinning. Normals are transformed by the
+ * upper 3x3 of the blended joint matrix, which assumes joints without non-uniform scale.
+ *
+ * On Vulkan and Metal with DeviceFeatures::Compute (see isComputeSupported()), encode() records a
+ * compute dispatch which reads the joint matrices and morph weights of the frame from an
+ * IRingBuffer. The skinning of many meshes can be recorded into the same compute encoder. On the
+ * other backends, including OpenGL ES 2 which has neither compute shaders nor transform feedback
+ * in IGL, skinOnCpu() deforms the mesh on the CPU and uploads the result, which still happens
+ * only once per frame.
+ *
+ * getOutputBuffer() holds an array of SkinningVertex: bind it as a vertex buffer with two Float4
+ * attributes at offsets 0 and 16, and a stride of sizeof(SkinningVertex). Other attributes such as
+ * texture coordinates do not change and should come from a second vertex buffer.
+ */
+class Skinner final {
+ public:
+  static bool isComputeSupported(const igl::IDevice& device);
+
+  Skinner(igl::IDevice& device, SkinnedMeshDesc desc, igl::Result* outResult = nullptr);
+  ~Skinner() = default;
+
+  /// True if encode() should be used, false if skinOnCpu() should be used
+  [[nodiscard]] bool usesCompute() const {
+    return pipelineState_ != nullptr;
+  }
+
+  /**
+   * @brief Records the deformation of the mesh into `encoder`.
+   *
+   * `jointMatrices` are numJoints column-major 4x4 matrices and `morphWeights` numMorphTargets
+   * floats; a null pointer leaves out the skinning or the morph targets. They are copied into an
+   * allocation of `ringBuffer`, which must have been created with BufferTypeBits::Storage and an
+   * alignment of at least 16 bytes. The output buffer is overwritten: it must not be in use by the
+   * GPU, e.g. when frames in flight render it, use one Skinner per frame in flight.
+   */
+  void encode(igl::IComputeCommandEncoder& encoder,
+              igl::IRingBuffer& ringBuffer,
+              const float* IGL_NULLABLE jointMatrices,
+              const float* IGL_NULLABLE morphWeights,
+              igl::Result* IGL_NULLABLE outResult = nullptr);
+
+  /// Deforms the mesh on the CPU and uploads it into the output buffer, see encode()
+  void skinOnCpu(const float* IGL_NULLABLE jointMatrices,
+                 const float* IGL_NULLABLE morphWeights,
+                 igl::Result* IGL_NULLABLE outResult = nullptr);
+
+  /// The deformed vertices, an array of numVertices() SkinningVertex
+  [[nodiscard]] const std::shared_ptr<igl::IBuffer>& getOutputBuffer() const {
+    return outputBuffer_;
+  }
+
+  [[nodiscard]] uint32_t numVertices() const {
+    return numVertices_;
+  }
+
+  /// Reference implementation of the deformation, used by skinOnCpu()
+  static void skin(const SkinnedMeshDesc& desc,
+                   const float* IGL_NULLABLE jointMatrices,
+                   const float* IGL_NULLABLE morphWeights,
+                   SkinningVertex* IGL_NONNULL outVertices);
+
+ private:
+  igl::BackendType backendType_;
+  uint32_t numVertices_ = 0;
+  // the mesh data is only kept on the CPU by the CPU path
+  SkinnedMeshDesc desc_;
+  std::vector<SkinningVertex> cpuOutput_;
+  std::shared_ptr<igl::IBuffer> vertexBuffer_;
+  std::shared_ptr<igl::IBuffer> influenceBuffer_;
+  std::shared_ptr<igl::IBuffer> morphTargetBuffer_;
+  std::shared_ptr<igl::IBuffer> outputBuffer_;
+  std::shared_ptr<igl::IComputePipelineState> pipelineState_;
+};
+
+} // namespace skinning
+} // namespace iglu
@@ -0,0 +1,400 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "SpriteBatch.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <string>
+
+namespace iglu {
+namespace spritebatch {
+
+namespace {
+
+// 16-bit indices address 65536 vertices
+constexpr size_t kMaxSpritesPerDraw = 16384;
+constexpr size_t kMinFallbackBufferSize = 64 * 1024;
+
+const char kVulkanVertexShader[] = R"(
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec2 uv;
+layout (location = 2) in vec4 color;
+
+layout (location = 0) out vec2 vUV;
+layout (location = 1) out vec4 vColor;
+
+void main() {
+  gl_Position = vec4(position, 0.0, 1.0);
+  vUV = uv;
+  vColor = color;
+}
+)";
+
+const char kVulkanFragmentShader[] = R"(
+layout (location = 0) in vec2 vUV;
+layout (location = 1) in vec4 vColor;
+
+layout (location = 0) out vec4 outColor;
+
+void main() {
+  outColor = vColor * textureSample2D(0, 0, vUV);
+}
+)";
+
+const char kMetalShader[] = R"(
+using namespace metal;
+
+struct VertexIn {
+  float2 position [[attribute(0)]];
+  float2 uv [[attribute(1)]];
+  float4 color [[attribute(2)]];
+};
+
+struct VertexOut {
+  float4 position [[position]];
+  float2 uv;
+  float4 color;
+};
+
+vertex VertexOut vertexMain(VertexIn in [[stage_in]]) {
+  VertexOut out;
+  out.position = float4(in.position, 0.0, 1.0);
+  out.uv = in.uv;
+  out.color = in.color;
+  return out;
+}
+
+fragment float4 fragmentMain(VertexOut in [[stage_in]],
+                             texture2d<float> spriteTexture [[texture(0)]],
+                             sampler spriteSampler [[sampler(0)]]) {
+  return in.color * spriteTexture.sample(spriteSampler, in.uv);
+}
+)";
+
+// same prologue as the ImGui renderer, compatible with OpenGL ES 2
+std::string getOpenGLPrologue(igl::ShaderVersion shaderVersion) {
+  std::string prologue;
+  if (shaderVersion.majorVersion > 1 || shaderVersion.minorVersion > 30 ||
+      shaderVersion.family == igl::ShaderFamily::GlslEs) {
+#if IGL_PLATFORM_MACOS
+    prologue += "#version 100\n";
+#endif
+    prologue += "precision mediump float;\n";
+  }
+  return prologue;
+}
+
+const char kOpenGLVertexShader[] = R"(
+attribute vec2 position;
+attribute vec2 uv;
+attribute vec4 color;
+
+varying vec2 vUV;
+varying vec4 vColor;
+
+void main() {
+  gl_Position = vec4(position, 0.0, 1.0);
+  vUV = uv;
+  vColor = color;
+}
+)";
+
+const char kOpenGLFragmentShader[] = R"(
+uniform sampler2D spriteTexture;
+
+varying vec2 vUV;
+varying vec4 vColor;
+
+void main() {
+  gl_FragColor = vColor * texture2D(spriteTexture, vUV);
+}
+)";
+
+std::unique_ptr<igl::IShaderStages> createShaderStages(igl::IDevice& device,
+                                                       igl::Result* IGL_NULLABLE outResult) {
+  switch (device.getBackendType()) {
+  case igl::BackendType::Vulkan:
+    return igl::ShaderStagesCreator::fromModuleStringInput(device,
+                                                           kVulkanVertexShader,
+                                                           "main",
+                                                           "Shader Module: sprites (vert)",
+                                                           kVulkanFragmentShader,
+                                                           "main",
+                                                           "Shader Module: sprites (frag)",
+                                                           outResult);
+  case igl::BackendType::Metal:
+    return igl::ShaderStagesCreator::fromLibraryStringInput(
+        device, kMetalShader, "vertexMain", "fragmentMain", "Shader Library: sprites", outResult);
+  case igl::BackendType::OpenGL: {
+    const std::string prologue = getOpenGLPrologue(device.getShaderVersion());
+    const std::string vertexShader = prologue + kOpenGLVertexShader;
+    const std::string fragmentShader = prologue + kOpenGLFragmentShader;
+    return igl::ShaderStagesCreator::fromModuleStringInput(device,
+                                                           vertexShader.c_str(),
+                                                           "main",
+                                                           "Shader Module: sprites (vert)",
+                                                           fragmentShader.c_str(),
+                                                           "main",
+                                                           "Shader Module: sprites (frag)",
+                                                           outResult);
+  }
+  }
+  IGL_UNREACHABLE_RETURN(nullptr);
+}
+
+} // namespace
+
+SpriteBatch::SpriteBatch(igl::IDevice& device, igl::Result* IGL_NULLABLE outResult) {
+  igl::Result ret;
+  shaderStages_ = createShaderStages(device, &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+
+  igl::VertexInputStateDesc inputDesc;
+  inputDesc.numAttributes = 3;
+  inputDesc.attributes[0] = igl::VertexAttribute(
+      0, igl::VertexAttributeFormat::Float2, offsetof(SpriteVertex, position), "position", 0);
+  inputDesc.attributes[1] = igl::VertexAttribute(
+      0, igl::VertexAttributeFormat::Float2, offsetof(SpriteVertex, uv), "uv", 1);
+  inputDesc.attributes[2] = igl::VertexAttribute(
+      0, igl::VertexAttributeFormat::UByte4Norm, offsetof(SpriteVertex, color), "color", 2);
+  inputDesc.numInputBindings = 1;
+  inputDesc.inputBindings[0].stride = sizeof(SpriteVertex);
+  vertexInputState_ = device.createVertexInputState(inputDesc, &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+
+  depthStencilState_ = device.createDepthStencilState(igl::DepthStencilStateDesc(), &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+
+  samplerState_ = device.createSamplerState(igl::SamplerStateDesc::newLinear(), &ret);
+  if (!ret.isOk()) {
+    igl::Result::setResult(outResult, std::move(ret));
+    return;
+  }
+
+  // every draw starts at the first vertex of its sprites, so a single index buffer serves them all
+  std::vector<uint16_t> indices(kMaxSpritesPerDraw * 6);
+  for (size_t i = 0; i != kMaxSpritesPerDraw; i++) {
+    const auto v = static_cast<uint16_t>(i * 4);
+    const uint16_t quad[] = {v,
+                             static_cast<uint16_t>(v + 1),
+                             static_cast<uint16_t>(v + 2),
+                             static_cast<uint16_t>(v + 2),
+                             static_cast<uint16_t>(v + 3),
+                             v};
+    std::copy(std::begin(quad), std::end(quad), indices.begin() + i * 6);
+  }
+  indexBuffer_ = device.createBuffer(igl::BufferDesc(igl::BufferDesc::BufferTypeBits::Index,
+                                                     indices.data(),
+                                                     indices.size() * sizeof(uint16_t),
+                                                     igl::ResourceStorage::Private,
+                                                     0,
+                                                     "Buffer: sprite indices"),
+                                     &ret);
+  igl::Result::setResult(outResult, std::move(ret));
+}
+
+void SpriteBatch::begin(float targetWidth, float targetHeight) {
+  IGL_ASSERT(targetWidth > 0.0f && targetHeight > 0.0f);
+  scaleX_ = 2.0f / targetWidth;
+  scaleY_ = 2.0f / targetHeight;
+  sprites_.clear();
+  textures_.clear();
+  textureIndices_.clear();
+}
+
+void SpriteBatch::draw(igl::ITexture* IGL_NONNULL texture,
+                       const float uvMin[2],
+                       const float uvMax[2],
+                       float x,
+                       float y,
+                       float width,
+                       float height,
+                       uint32_t color) {
+  const auto it = textureIndices_.emplace(texture, static_cast<uint32_t>(textures_.size()));
+  if (it.second) {
+    textures_.push_back(texture);
+  }
+
+  // pixels with a top-left origin to normalized device coordinates
+  Sprite sprite;
+  sprite.x0 = x * scaleX_ - 1.0f;
+  sprite.y0 = 1.0f - y * scaleY_;
+  sprite.x1 = (x + width) * scaleX_ - 1.0f;
+  sprite.y1 = 1.0f - (y + height) * scaleY_;
+  sprite.u0 = uvMin[0];
+  sprite.v0 = uvMin[1];
+  sprite.u1 = uvMax[0];
+  sprite.v1 = uvMax[1];
+  sprite.color = color;
+  sprite.textureIndex = it.first->second;
+  sprites_.push_back(sprite);
+}
+
+uint32_t SpriteBatch::end(igl::IDevice& device,
+                          igl::IRenderCommandEncoder& encoder,
+                          const igl::IFramebuffer& framebuffer,
+                          igl::IRingBuffer* IGL_NULLABLE ringBuffer) {
+  if (sprites_.empty() || !indexBuffer_) {
+    return 0;
+  }
+  auto pipelineState = getPipelineState(device, framebuffer);
+  if (!pipelineState) {
+    return 0;
+  }
+
+  const size_t numSprites = sprites_.size();
+  order_.resize(numSprites);
+  std::iota(order_.begin(), order_.end(), 0u);
+  std::stable_sort(order_.begin(), order_.end(), [this](uint32_t a, uint32_t b) {
+    return sprites_[a].textureIndex < sprites_[b].textureIndex;
+  });
+
+  const size_t verticesSize = numSprites * 4 * sizeof(SpriteVertex);
+  std::shared_ptr<igl::IBuffer> vertexBuffer;
+  size_t vertexBufferOffset = 0;
+
+  if (ringBuffer) {
+    igl::Result ret;
+    const auto allocation = ringBuffer->allocate(verticesSize, &ret);
+    if (!allocation.empty()) {
+      writeVertices(static_cast<SpriteVertex*>(allocation.data));
+      // bindBuffer() needs shared ownership of the buffer, which IRingBuffer does not hand out
+      vertexBuffer = std::shared_ptr<igl::IBuffer>(std::shared_ptr<igl::IBuffer>(),
+                                                   &ringBuffer->getBuffer());
+      vertexBufferOffset = allocation.offset;
+    } else {
+      IGL_LOG_ERROR_ONCE("SpriteBatch: %s\n", ret.message.c_str());
+    }
+  }
+
+  if (!vertexBuffer) {
+    FallbackBuffer& fallback = fallbackBuffers_[nextFallbackBuffer_];
+    nextFallbackBuffer_ = (nextFallbackBuffer_ + 1) % kNumFallbackBuffers;
+    if (fallback.capacity < verticesSize) {
+      // grow geometrically so that a growing number of sprites does not reallocate every frame
+      fallback.capacity = std::max({verticesSize, fallback.capacity * 2, kMinFallbackBufferSize});
+      fallback.buffer = device.createBuffer(igl::BufferDesc(igl::BufferDesc::BufferTypeBits::Vertex,
+                                                            nullptr,
+                                                            fallback.capacity,
+                                                            igl::ResourceStorage::Shared,
+                                                            0,
+                                                            "Buffer: sprite vertices"),
+                                            nullptr);
+      if (!fallback.buffer) {
+        fallback.capacity = 0;
+        return 0;
+      }
+    }
+    vertices_.resize(numSprites * 4);
+    writeVertices(vertices_.data());
+    fallback.buffer->upload(vertices_.data(), igl::BufferRange(verticesSize, 0));
+    vertexBuffer = fallback.buffer;
+  }
+
+  encoder.bindRenderPipelineState(pipelineState);
+  encoder.bindDepthStencilState(depthStencilState_);
+  encoder.bindSamplerState(0, igl::BindTarget::kFragment, samplerState_);
+
+  uint32_t numDraws = 0;
+  for (size_t first = 0; first != numSprites;) {
+    const uint32_t textureIndex = sprites_[order_[first]].textureIndex;
+    size_t last = first + 1;
+    while (last != numSprites && last - first < kMaxSpritesPerDraw &&
+           sprites_[order_[last]].textureIndex == textureIndex) {
+      last++;
+    }
+    encoder.bindTexture(0, igl::BindTarget::kFragment, textures_[textureIndex]);
+    encoder.bindBuffer(0,
+                       igl::BindTarget::kVertex,
+                       vertexBuffer,
+                       vertexBufferOffset + first * 4 * sizeof(SpriteVertex));
+    encoder.drawIndexed(igl::PrimitiveType::Triangle,
+                        (last - first) * 6,
+                        igl::IndexFormat::UInt16,
+                        *indexBuffer_,
+                        0);
+    numDraws++;
+    first = last;
+  }
+  return numDraws;
+}
+
+std::shared_ptr<igl::IRenderPipelineState> SpriteBatch::getPipelineState(
+    igl::IDevice& device,
+    const igl::IFramebuffer& framebuffer) {
+  const auto colorTexture = framebuffer.getColorAttachment(0);
+  const auto depthTexture = framebuffer.getDepthAttachment();
+  if (!IGL_VERIFY(colorTexture)) {
+    return nullptr;
+  }
+  const igl::TextureFormat colorFormat = colorTexture->getFormat();
+  const igl::TextureFormat depthFormat =
+      depthTexture ? depthTexture->getFormat() : igl::TextureFormat::Invalid;
+  const auto sampleCount = static_cast<uint32_t>(colorTexture->getSamples());
+
+  const uint64_t key = uint64_t(colorFormat) | (uint64_t(depthFormat) << 16) |
+                       (uint64_t(sampleCount) << 32);
+  if (auto it = pipelineStates_.find(key); it != pipelineStates_.end()) {
+    return it->second;
+  }
+
+  igl::RenderPipelineDesc desc;
+  desc.shaderStages = shaderStages_;
+  desc.vertexInputState = vertexInputState_;
+  desc.targetDesc.colorAttachments.resize(1);
+  auto& colorAttachment = desc.targetDesc.colorAttachments[0];
+  colorAttachment.textureFormat = colorFormat;
+  colorAttachment.blendEnabled = true;
+  colorAttachment.rgbBlendOp = igl::BlendOp::Add;
+  colorAttachment.alphaBlendOp = igl::BlendOp::Add;
+  colorAttachment.srcRGBBlendFactor = igl::BlendFactor::SrcAlpha;
+  colorAttachment.srcAlphaBlendFactor = igl::BlendFactor::One;
+  colorAttachment.dstRGBBlendFactor = igl::BlendFactor::OneMinusSrcAlpha;
+  colorAttachment.dstAlphaBlendFactor = igl::BlendFactor::OneMinusSrcAlpha;
+  desc.targetDesc.depthAttachmentFormat = depthFormat;
+  if (framebuffer.getStencilAttachment()) {
+    desc.targetDesc.stencilAttachmentFormat = framebuffer.getStencilAttachment()->getFormat();
+  }
+  desc.sampleCount = static_cast<int>(sampleCount);
+  desc.cullMode = igl::CullMode::Disabled;
+  desc.fragmentUnitSamplerMap[0] = IGL_NAMEHANDLE("spriteTexture");
+  desc.debugName = IGL_NAMEHANDLE("Pipeline: sprites");
+
+  igl::Result ret;
+  auto pipelineState = device.createRenderPipeline(desc, &ret);
+  if (!ret.isOk()) {
+    IGL_LOG_ERROR("SpriteBatch: %s\n", ret.message.c_str());
+    return nullptr;
+  }
+  pipelineStates_[key] = pipelineState;
+  return pipelineState;
+}
+
+void SpriteBatch::writeVertices(SpriteVertex* IGL_NONNULL vertices) const {
+  for (const uint32_t i : order_) {
+    const Sprite& s = sprites_[i];
+    *vertices++ = {{s.x0, s.y0}, {s.u0, s.v0}, s.color};
+    *vertices++ = {{s.x1, s.y0}, {s.u1, s.v0}, s.color};
+    *vertices++ = {{s.x1, s.y1}, {s.u1, s.v1}, s.color};
+    *vertices++ = {{s.x0, s.y1}, {s.u0, s.v1}, s.color};
+  }
+}
+
+} // namespace spritebatch
+} // namespace iglu
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/sprite_batch/TextureAtlas.h>
+#include <cstdint>
+#include <igl/IGL.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace iglu {
+namespace spritebatch {
+
+/// Vertex of a sprite, in normalized device coordinates
+struct SpriteVertex {
+  float position[2] = {};
+  float uv[2] = {};
+  /// RGBA, 8 bits per channel, red in the lowest byte
+  uint32_t color = 0xFFFFFFFF;
+};
+
+/**
+ * @brief Renders many textured quads, such as glyphs and icons, with a handful of draw calls.
+ *
+ * Sprites are queued between begin() and end(), in pixels of the render target with the origin at
+ * its top-left corner. end() sorts them by texture, usually the pages of a TextureAtlas, writes
+ * their vertices and issues one indexed draw per texture. Sprites sharing a texture are drawn in
+ * the order they were queued, but sprites using different textures are not ordered relative to
+ * each other: overlapping sprites on different pages need separate begin()/end() batches.
+ *
+ * When a ring buffer is passed to end(), the vertices are written directly into it. It must have
+ * been created with BufferDesc::BufferTypeBits::Vertex; the caller closes its frames with
+ * IRingBuffer::endFrame(). Devices without ring buffers (Metal, OpenGL without persistently mapped
+ * buffers) go through a few vertex buffers recycled every kNumFallbackBuffers frames instead.
+ *
+ * Sprites are alpha blended and drawn without depth testing.
+ */
+class SpriteBatch final {
+ public:
+  static constexpr size_t kNumFallbackBuffers = 3;
+
+  explicit SpriteBatch(igl::IDevice& device, igl::Result* IGL_NULLABLE outResult = nullptr);
+  ~SpriteBatch() = default;
+
+  /// Clears the queued sprites. `targetWidth` and `targetHeight` are the size of the render target
+  /// in the units used by draw(), usually pixels
+  void begin(float targetWidth, float targetHeight);
+
+  /// Queues a sprite covering [x, x + width] x [y, y + height], textured with [uvMin, uvMax]
+  void draw(igl::ITexture* IGL_NONNULL texture,
+            const float uvMin[2],
+            const float uvMax[2],
+            float x,
+            float y,
+            float width,
+            float height,
+            uint32_t color = 0xFFFFFFFF);
+
+  /// Queues a sprite showing an image of a TextureAtlas
+  void draw(const TextureAtlas& atlas,
+            const AtlasRegion& region,
+            float x,
+            float y,
+            float width,
+            float height,
+            uint32_t color = 0xFFFFFFFF) {
+    draw(atlas.getPageTexture(region.page).get(),
+         region.uvMin,
+         region.uvMax,
+         x,
+         y,
+         width,
+         height,
+         color);
+  }
+
+  /**
+   * @brief Draws the queued sprites into `encoder`, whose render pass targets `framebuffer`.
+   * @return The number of draw calls issued.
+   */
+  uint32_t end(igl::IDevice& device,
+               igl::IRenderCommandEncoder& encoder,
+               const igl::IFramebuffer& framebuffer,
+               igl::IRingBuffer* IGL_NULLABLE ringBuffer = nullptr);
+
+  [[nodiscard]] size_t getNumSprites() const {
+    return sprites_.size();
+  }
+
+ private:
+  struct Sprite {
+    float x0, y0, x1, y1;
+    float u0, v0, u1, v1;
+    uint32_t color;
+    // textures_ index, in the order they are first used
+    uint32_t textureIndex;
+  };
+
+  struct FallbackBuffer {
+    std::shared_ptr<igl::IBuffer> buffer;
+    size_t capacity = 0;
+  };
+
+  std::shared_ptr<igl::IRenderPipelineState> getPipelineState(
+      igl::IDevice& device,
+      const igl::IFramebuffer& framebuffer);
+  void writeVertices(SpriteVertex* IGL_NONNULL vertices) const;
+
+  float scaleX_ = 0.0f;
+  float scaleY_ = 0.0f;
+  std::vector<Sprite> sprites_;
+  std::vector<igl::ITexture*> textures_;
+  std::unordered_map<igl::ITexture*, uint32_t> textureIndices_;
+  // sprites_ indices sorted by texture
+  std::vector<uint32_t> order_;
+  std::vector<SpriteVertex> vertices_;
+
+  std::shared_ptr<igl::IShaderStages> shaderStages_;
+  std::shared_ptr<igl::IVertexInputState> vertexInputState_;
+  std::shared_ptr<igl::IDepthStencilState> depthStencilState_;
+  std::shared_ptr<igl::ISamplerState> samplerState_;
+  std::shared_ptr<igl::IBuffer> indexBuffer_;
+  // keyed by color format, depth format and sample count
+  std::unordered_map<uint64_t, std::shared_ptr<igl::IRenderPipelineState>> pipelineStates_;
+  FallbackBuffer fallbackBuffers_[kNumFallbackBuffers];
+  size_t nextFallbackBuffer_ = 0;
+};
+
+} // namespace spritebatch
+} // namespace iglu
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace iglu {
+namespace spritebatch {
+
+TextureAtlas::TextureAtlas(igl::IDevice& device, TextureAtlasDesc desc) :
+  device_(device), desc_(std::move(desc)) {
+  const auto properties = igl::TextureFormatProperties::fromTextureFormat(desc_.format);
+  IGL_ASSERT_MSG(!properties.isCompressed(), "Texture atlases need an uncompressed format");
+  IGL_ASSERT(desc_.pageSize > 0);
+  bytesPerPixel_ = properties.bytesPerBlock;
+}
+
+AtlasRegion TextureAtlas::add(uint32_t width,
+                              uint32_t height,
+                              const void* IGL_NONNULL pixels,
+                              igl::Result* IGL_NULLABLE outResult) {
+  if (width == 0 || height == 0 || width + desc_.padding > desc_.pageSize ||
+      height + desc_.padding > desc_.pageSize) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentOutOfRange, "Image does not fit a page");
+    return {};
+  }
+
+  AtlasRegion region;
+  region.width = width;
+  region.height = height;
+
+  bool allocated = false;
+  for (uint32_t i = 0; i != pages_.size() && !allocated; i++) {
+    allocated = allocate(pages_[i], width, height, region.x, region.y);
+    region.page = i;
+  }
+  if (!allocated) {
+    if (pages_.size() >= desc_.maxPages) {
+      igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Texture atlas is full");
+      return {};
+    }
+    if (!createPage(outResult)) {
+      return {};
+    }
+    region.page = static_cast<uint32_t>(pages_.size() - 1);
+    allocated = allocate(pages_.back(), width, height, region.x, region.y);
+    IGL_ASSERT(allocated);
+  }
+
+  Page& page = pages_[region.page];
+  const size_t pageRowBytes = size_t(desc_.pageSize) * bytesPerPixel_;
+  const size_t rowBytes = size_t(width) * bytesPerPixel_;
+  for (uint32_t row = 0; row != height; row++) {
+    memcpy(page.pixels.data() + (region.y + row) * pageRowBytes + region.x * bytesPerPixel_,
+           static_cast<const uint8_t*>(pixels) + row * rowBytes,
+           rowBytes);
+  }
+  if (page.dirtyBegin >= page.dirtyEnd) {
+    page.dirtyBegin = region.y;
+    page.dirtyEnd = region.y + height;
+  } else {
+    page.dirtyBegin = std::min(page.dirtyBegin, region.y);
+    page.dirtyEnd = std::max(page.dirtyEnd, region.y + height);
+  }
+
+  const float scale = 1.0f / static_cast<float>(desc_.pageSize);
+  region.uvMin[0] = static_cast<float>(region.x) * scale;
+  region.uvMin[1] = static_cast<float>(region.y) * scale;
+  region.uvMax[0] = static_cast<float>(region.x + width) * scale;
+  region.uvMax[1] = static_cast<float>(region.y + height) * scale;
+
+  igl::Result::setOk(outResult);
+  return region;
+}
+
+igl::Result TextureAtlas::flush() {
+  const size_t pageRowBytes = size_t(desc_.pageSize) * bytesPerPixel_;
+  for (Page& page : pages_) {
+    if (page.dirtyBegin >= page.dirtyEnd) {
+      continue;
+    }
+    // whole rows are contiguous in the CPU copy, so the changes of a page need a single upload
+    const auto range = igl::TextureRangeDesc::new2D(
+        0, page.dirtyBegin, desc_.pageSize, page.dirtyEnd - page.dirtyBegin);
+    auto result = page.texture->upload(
+        range, page.pixels.data() + page.dirtyBegin * pageRowBytes, pageRowBytes);
+    if (!result.isOk()) {
+      return result;
+    }
+    page.dirtyBegin = page.dirtyEnd = 0;
+  }
+  return igl::Result();
+}
+
+void TextureAtlas::clear() {
+  for (Page& page : pages_) {
+    page.shelves.clear();
+    // the padding around the next images has to be empty again
+    std::fill(page.pixels.begin(), page.pixels.end(), 0);
+    page.dirtyBegin = 0;
+    page.dirtyEnd = desc_.pageSize;
+  }
+}
+
+bool TextureAtlas::allocate(Page& page,
+                            uint32_t width,
+                            uint32_t height,
+                            uint32_t& outX,
+                            uint32_t& outY) const {
+  const uint32_t paddedWidth = width + desc_.padding;
+  const uint32_t paddedHeight = height + desc_.padding;
+
+  // the shortest shelf which has room for the image
+  Shelf* bestShelf = nullptr;
+  for (Shelf& shelf : page.shelves) {
+    if (shelf.height >= paddedHeight && shelf.x + paddedWidth <= desc_.pageSize &&
+        (!bestShelf || shelf.height < bestShelf->height)) {
+      bestShelf = &shelf;
+    }
+  }
+
+  const uint32_t nextShelfY = page.shelves.empty()
+                                  ? 0
+                                  : page.shelves.back().y + page.shelves.back().height;
+  const bool canAddShelf = nextShelfY + paddedHeight <= desc_.pageSize;
+
+  // do not waste more than half of a shelf while there is room for a better fitting one
+  if (!bestShelf || (canAddShelf && bestShelf->height - paddedHeight > paddedHeight / 2)) {
+    if (!canAddShelf) {
+      return false;
+    }
+    page.shelves.push_back({nextShelfY, paddedHeight, 0});
+    bestShelf = &page.shelves.back();
+  }
+
+  outX = bestShelf->x;
+  outY = bestShelf->y;
+  bestShelf->x += paddedWidth;
+  return true;
+}
+
+bool TextureAtlas::createPage(igl::Result* IGL_NULLABLE outResult) {
+  const std::string debugName = desc_.debugName + " page " + std::to_string(pages_.size());
+  auto texture = device_.createTexture(
+      igl::TextureDesc::new2D(desc_.format,
+                              desc_.pageSize,
+                              desc_.pageSize,
+                              igl::TextureDesc::TextureUsageBits::Sampled,
+                              debugName.c_str()),
+      outResult);
+  if (!texture) {
+    return false;
+  }
+
+  Page page;
+  page.texture = std::move(texture);
+  page.pixels.resize(size_t(desc_.pageSize) * desc_.pageSize * bytesPerPixel_);
+  // the initial contents of textures are undefined, the padding has to be cleared
+  page.dirtyBegin = 0;
+  page.dirtyEnd = desc_.pageSize;
+  pages_.push_back(std::move(page));
+  return true;
+}
+
+} // namespace spritebatch
+} // namespace iglu
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/IGL.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace iglu {
+namespace spritebatch {
+
+/**
+ * @brief Parameters of a TextureAtlas.
+ *
+ *  pageSize - Width and height of every page, in pixels
+ *  format   - Uncompressed format of the pages and of the images added to them
+ *  padding  - Empty pixels kept around every image, so that linear filtering does not bleed
+ *             into the neighbouring ones
+ *  maxPages - add() fails once all the pages are full
+ */
+struct TextureAtlasDesc {
+  uint32_t pageSize = 1024;
+  igl::TextureFormat format = igl::TextureFormat::RGBA_UNorm8;
+  uint32_t padding = 1;
+  uint32_t maxPages = 4;
+  std::string debugName;
+};
+
+/// Location of an image in a TextureAtlas. Texture coordinates cover the image exactly.
+struct AtlasRegion {
+  uint32_t page = 0;
+  uint32_t x = 0;
+  uint32_t y = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  float uvMin[2] = {};
+  float uvMax[2] = {};
+
+  [[nodiscard]] bool empty() const {
+    return width == 0 || height == 0;
+  }
+};
+
+/**
+ * @brief Packs many small images, such as glyphs and icons, into a few large textures so that they
+ * can be rendered together by a SpriteBatch.
+ *
+ * Images are packed into horizontal shelves: an image goes into the shelf whose height fits it
+ * best, or opens a new shelf under the last one. Pages are created on demand, up to
+ * TextureAtlasDesc::maxPages. This wastes a little space with images of very different heights but
+ * is fast enough to add images while rendering, e.g. glyphs the first time they are displayed.
+ *
+ * add() only copies the image into a CPU copy of its page. flush() then uploads the rows of every
+ * page which changed since the previous flush() in a single upload per page, so adding hundreds of
+ * glyphs in a frame does not upload hundreds of small regions. Call it once per frame, before
+ * rendering the sprites.
+ */
+class TextureAtlas final {
+ public:
+  TextureAtlas(igl::IDevice& device, TextureAtlasDesc desc = {});
+  ~TextureAtlas() = default;
+
+  /// Adds an image of `width` x `height` pixels with tightly packed rows. Returns an empty region
+  /// if the image is larger than a page or if all the pages are full.
+  AtlasRegion add(uint32_t width,
+                  uint32_t height,
+                  const void* IGL_NONNULL pixels,
+                  igl::Result* IGL_NULLABLE outResult = nullptr);
+
+  /// Uploads the images added since the last flush()
+  igl::Result flush();
+
+  /// Forgets all the regions. The pages are kept and reused
+  void clear();
+
+  [[nodiscard]] uint32_t getNumPages() const {
+    return static_cast<uint32_t>(pages_.size());
+  }
+
+  [[nodiscard]] const std::shared_ptr<igl::ITexture>& getPageTexture(uint32_t page) const {
+    return pages_[page].texture;
+  }
+
+  [[nodiscard]] const TextureAtlasDesc& getDesc() const {
+    return desc_;
+  }
+
+ private:
+  struct Shelf {
+    uint32_t y = 0;
+    uint32_t height = 0;
+    // the next image goes there
+    uint32_t x = 0;
+  };
+
+  struct Page {
+    std::shared_ptr<igl::ITexture> texture;
+    std::vector<uint8_t> pixels;
+    std::vector<Shelf> shelves;
+    // rows [dirtyBegin, dirtyEnd) have to be uploaded
+    uint32_t dirtyBegin = 0;
+    uint32_t dirtyEnd = 0;
+  };
+
+  bool allocate(Page& page, uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY) const;
+  bool createPage(igl::Result* IGL_NULLABLE outResult);
+
+  igl::IDevice& device_;
+  TextureAtlasDesc desc_;
+  uint32_t bytesPerPixel_ = 0;
+  std::vector<Page> pages_;
+};
+
+} // namespace spritebatch
+} // namespace iglu
@@ -12,6 +12,9 @@
 #if IGL_PLATFORM_APPLE
 #include "MetalTextureAccessor.h"
 #endif
+#if IGL_BACKEND_VULKAN
+#include "VulkanTextureAccessor.h"
+#endif
 
 namespace iglu {
 namespace textureaccessor {
@@ -26,6 +29,10 @@ std::unique_ptr<ITextureAccessor> TextureAccessorFactory::createTextureAccessor(
 #if IGL_PLATFORM_APPLE
   case igl::BackendType::Metal:
     return std::make_unique<MetalTextureAccessor>(texture, device);
+#endif
+#if IGL_BACKEND_VULKAN
+  case igl::BackendType::Vulkan:
+    return std::make_unique<VulkanTextureAccessor>(texture, device);
 #endif
   default:
     IGL_ASSERT_NOT_IMPLEMENTED();
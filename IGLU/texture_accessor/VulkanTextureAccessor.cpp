@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/Macros.h>
+
+#if IGL_BACKEND_VULKAN
+
+#include "ITextureAccessor.h"
+#include "VulkanTextureAccessor.h"
+#include "igl/Texture.h"
+#include "igl/vulkan/Device.h"
+#include "igl/vulkan/Texture.h"
+#include "igl/vulkan/VulkanBuffer.h"
+#include "igl/vulkan/VulkanContext.h"
+#include "igl/vulkan/VulkanImage.h"
+#include "igl/vulkan/VulkanStagingDevice.h"
+#include "igl/vulkan/VulkanTexture.h"
+
+#if defined(IGL_CMAKE_BUILD)
+#include <igl/IGLSafeC.h>
+#else
+#include <secure_lib/secure_string.h>
+#endif
+
+namespace iglu {
+namespace textureaccessor {
+
+VulkanTextureAccessor::VulkanTextureAccessor(std::shared_ptr<igl::ITexture> texture,
+                                             igl::IDevice& device) :
+  ITextureAccessor(std::move(texture)),
+  ctx_(static_cast<igl::vulkan::Device&>(device).getVulkanContext()) {
+  const auto dimensions = texture_->getDimensions();
+  textureWidth_ = dimensions.width;
+  textureHeight_ = dimensions.height;
+
+  const auto& properties = texture_->getProperties();
+  textureBytesPerRow_ = properties.getBytesPerRow(textureWidth_);
+  textureBytesPerImage_ = properties.getBytesPerRange(texture_->getFullRange());
+
+  latestBytesRead_.resize(textureBytesPerImage_);
+
+  // persistently mapped readback buffers
+  for (auto& r : readbacks_) {
+    igl::Result res;
+    r.buffer = ctx_.createBuffer(textureBytesPerImage_,
+                                 VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                     VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                 &res,
+                                 "Buffer: texture accessor readback");
+    IGL_ASSERT(res.isOk());
+    IGL_ASSERT(r.buffer && r.buffer->isMapped());
+  }
+};
+
+void VulkanTextureAccessor::requestBytes(igl::ICommandQueue& /*commandQueue*/,
+                                         std::shared_ptr<igl::ITexture> texture) {
+  if (texture) {
+    IGL_ASSERT(textureWidth_ == texture->getDimensions().width &&
+               textureHeight_ == texture->getDimensions().height);
+    texture_ = std::move(texture);
+  }
+
+  latestReadback_ = (latestReadback_ + 1) % kNumReadbackBuffers;
+
+  Readback& readback = readbacks_[latestReadback_];
+
+  // all buffers are in flight: reuse the oldest one
+  ctx_.stagingDevice_->waitReadback(readback.handle, *readback.buffer);
+
+  const auto& vkTexture = static_cast<igl::vulkan::Texture&>(*texture_);
+  const VkRect2D imageRegion = {
+      VkOffset2D{0, 0},
+      VkExtent2D{static_cast<uint32_t>(textureWidth_), static_cast<uint32_t>(textureHeight_)},
+  };
+
+  readback.handle = ctx_.stagingDevice_->getImageData2DAsync(
+      vkTexture.getVkImage(),
+      0, // level
+      0, // layer
+      imageRegion,
+      vkTexture.getVulkanTexture().getVulkanImage().imageLayout_,
+      *readback.buffer,
+      0,
+      true, // Vulkan images are upside down compared to OpenGL ones, flip them on the GPU
+      static_cast<uint32_t>(textureBytesPerRow_));
+
+  isLatestReadbackCopied_ = false;
+  status_ = RequestStatus::InProgress;
+}
+
+RequestStatus VulkanTextureAccessor::getRequestStatus() {
+  if (status_ == RequestStatus::InProgress &&
+      ctx_.stagingDevice_->isReadbackReady(readbacks_[latestReadback_].handle)) {
+    status_ = RequestStatus::Ready;
+  }
+  return status_;
+};
+
+std::vector<unsigned char>& VulkanTextureAccessor::getBytes() {
+  if (status_ == RequestStatus::NotInitialized || isLatestReadbackCopied_) {
+    return latestBytesRead_;
+  }
+
+  const Readback& readback = readbacks_[latestReadback_];
+
+  ctx_.stagingDevice_->waitReadback(readback.handle, *readback.buffer);
+
+  // the readback buffer has been flipped by the copy
+  checked_memcpy_robust(latestBytesRead_.data(),
+                        latestBytesRead_.size(),
+                        readback.buffer->getMappedPtr(),
+                        textureBytesPerImage_,
+                        textureBytesPerImage_);
+
+  isLatestReadbackCopied_ = true;
+  status_ = RequestStatus::Ready;
+
+  return latestBytesRead_;
+}
+
+} // namespace textureaccessor
+} // namespace iglu
+
+#endif // IGL_BACKEND_VULKAN
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "ITextureAccessor.h"
+#include <array>
+#include <igl/CommandQueue.h>
+#include <igl/IGL.h>
+#include <igl/Texture.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
+
+namespace igl::vulkan {
+class VulkanBuffer;
+class VulkanContext;
+} // namespace igl::vulkan
+
+namespace iglu {
+namespace textureaccessor {
+
+class VulkanTextureAccessor : public ITextureAccessor {
+ public:
+  VulkanTextureAccessor(std::shared_ptr<igl::ITexture> texture, igl::IDevice& device);
+
+  void requestBytes(igl::ICommandQueue& commandQueue,
+                    std::shared_ptr<igl::ITexture> texture = nullptr) override;
+  RequestStatus getRequestStatus() override;
+  std::vector<unsigned char>& getBytes() override;
+
+ private:
+  // requests in flight read into different buffers, so new requests do not wait for old ones
+  static constexpr size_t kNumReadbackBuffers = 3;
+
+  struct Readback {
+    std::shared_ptr<igl::vulkan::VulkanBuffer> buffer;
+    igl::vulkan::VulkanImmediateCommands::SubmitHandle handle;
+  };
+
+  const igl::vulkan::VulkanContext& ctx_;
+  std::vector<unsigned char> latestBytesRead_;
+  RequestStatus status_ = RequestStatus::NotInitialized;
+  size_t textureWidth_ = 0;
+  size_t textureHeight_ = 0;
+  size_t textureBytesPerRow_ = 0;
+  size_t textureBytesPerImage_ = 0;
+  std::array<Readback, kNumReadbackBuffers> readbacks_;
+  size_t latestReadback_ = 0;
+  // true if latestBytesRead_ contains the data of the latest readback
+  bool isLatestReadbackCopied_ = false;
+};
+
+} // namespace textureaccessor
+} // namespace iglu
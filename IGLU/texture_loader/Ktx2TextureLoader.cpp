@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Ktx2TextureLoader.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace iglu {
+namespace textureloader {
+
+namespace {
+
+constexpr uint8_t kKtx2Identifier[12] =
+    {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+// identifier, header and index, followed by the level index
+constexpr size_t kHeaderLength = 80;
+constexpr size_t kLevelIndexEntryLength = 24;
+
+// Khronos data format descriptor values
+constexpr uint8_t kColorModelEtc1s = 163;
+constexpr uint8_t kColorModelUastc = 166;
+constexpr uint8_t kTransferFunctionSrgb = 2;
+
+// VkFormat values of the formats with an IGL equivalent
+constexpr uint32_t kVkFormatUndefined = 0;
+constexpr uint32_t kVkFormatRGBA8Unorm = 37;
+constexpr uint32_t kVkFormatRGBA8Srgb = 43;
+constexpr uint32_t kVkFormatBC7Unorm = 145;
+constexpr uint32_t kVkFormatEtc2RGB8Unorm = 147;
+constexpr uint32_t kVkFormatEacRG11Snorm = 156;
+constexpr uint32_t kVkFormatAstc4x4Unorm = 157;
+constexpr uint32_t kVkFormatAstc12x12Srgb = 184;
+
+template<typename T>
+T read(const uint8_t* data, size_t offset) {
+  T value;
+  memcpy(&value, data + offset, sizeof(value));
+  return value;
+}
+
+bool isSampled(const igl::ICapabilities& capabilities, igl::TextureFormat format) {
+  return contains(capabilities.getTextureFormatCapabilities(format),
+                  igl::ICapabilities::TextureFormatCapabilityBits::Sampled);
+}
+
+} // namespace
+
+std::unique_ptr<Ktx2Image> Ktx2Image::create(const uint8_t* data,
+                                             size_t length,
+                                             igl::Result* outResult) {
+  if (data == nullptr || length < kHeaderLength ||
+      memcmp(data, kKtx2Identifier, sizeof(kKtx2Identifier)) != 0) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "Not a KTX2 file");
+    return nullptr;
+  }
+
+  std::unique_ptr<Ktx2Image> image(new Ktx2Image());
+  image->data_ = data;
+  image->length_ = length;
+  image->vkFormat_ = read<uint32_t>(data, 12);
+  image->width_ = read<uint32_t>(data, 20);
+  image->height_ = std::max(read<uint32_t>(data, 24), 1u);
+  image->depth_ = std::max(read<uint32_t>(data, 28), 1u);
+  image->numLayers_ = std::max(read<uint32_t>(data, 32), 1u);
+  image->numFaces_ = read<uint32_t>(data, 36);
+  // 0 asks for generated mip levels, only the base level is stored then
+  const uint32_t numLevels = std::max(read<uint32_t>(data, 40), 1u);
+  image->supercompression_ = static_cast<Supercompression>(read<uint32_t>(data, 44));
+  const uint32_t dfdByteOffset = read<uint32_t>(data, 48);
+  const uint32_t dfdByteLength = read<uint32_t>(data, 52);
+
+  if (image->width_ == 0 || (image->numFaces_ != 1 && image->numFaces_ != 6) ||
+      numLevels > 32) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "Invalid KTX2 image dimensions");
+    return nullptr;
+  }
+  if (kHeaderLength + numLevels * kLevelIndexEntryLength > length) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "Truncated KTX2 file");
+    return nullptr;
+  }
+
+  image->levels_.resize(numLevels);
+  for (uint32_t i = 0; i != numLevels; i++) {
+    const size_t entry = kHeaderLength + i * kLevelIndexEntryLength;
+    Level& level = image->levels_[i];
+    level.byteOffset = read<uint64_t>(data, entry);
+    level.byteLength = read<uint64_t>(data, entry + 8);
+    level.uncompressedByteLength = read<uint64_t>(data, entry + 16);
+    if (level.byteOffset > length || level.byteLength > length - level.byteOffset) {
+      igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "Truncated KTX2 file");
+      return nullptr;
+    }
+  }
+
+  // The basic descriptor block follows the total size of the descriptor
+  if (dfdByteLength >= 16 && dfdByteOffset <= length && dfdByteLength <= length - dfdByteOffset) {
+    image->colorModel_ = data[dfdByteOffset + 12];
+    image->isSrgb_ = data[dfdByteOffset + 14] == kTransferFunctionSrgb;
+  }
+
+  igl::Result::setOk(outResult);
+  return image;
+}
+
+bool Ktx2Image::needsTranscoding() const {
+  return supercompression_ == Supercompression::BasisLZ ||
+         (vkFormat_ == kVkFormatUndefined &&
+          (colorModel_ == kColorModelEtc1s || colorModel_ == kColorModelUastc));
+}
+
+igl::TextureFormat Ktx2Image::getNativeFormat() const {
+  using igl::TextureFormat;
+
+  if (needsTranscoding()) {
+    return TextureFormat::Invalid;
+  }
+  // IGL lists the ASTC formats in the VkFormat order, UNORM before SRGB for each block size
+  if (vkFormat_ >= kVkFormatAstc4x4Unorm && vkFormat_ <= kVkFormatAstc12x12Srgb) {
+    return static_cast<TextureFormat>(static_cast<uint32_t>(TextureFormat::RGBA_ASTC_4x4) +
+                                      (vkFormat_ - kVkFormatAstc4x4Unorm));
+  }
+  if (vkFormat_ >= kVkFormatEtc2RGB8Unorm && vkFormat_ <= kVkFormatEacRG11Snorm) {
+    constexpr TextureFormat kEtc2Formats[] = {
+        TextureFormat::RGB8_ETC2,
+        TextureFormat::SRGB8_ETC2,
+        TextureFormat::RGB8_Punchthrough_A1_ETC2,
+        TextureFormat::SRGB8_Punchthrough_A1_ETC2,
+        TextureFormat::RGBA8_EAC_ETC2,
+        TextureFormat::SRGB8_A8_EAC_ETC2,
+        TextureFormat::R_EAC_UNorm,
+        TextureFormat::R_EAC_SNorm,
+        TextureFormat::RG_EAC_UNorm,
+        TextureFormat::RG_EAC_SNorm,
+    };
+    return kEtc2Formats[vkFormat_ - kVkFormatEtc2RGB8Unorm];
+  }
+  switch (vkFormat_) {
+  case kVkFormatRGBA8Unorm:
+    return TextureFormat::RGBA_UNorm8;
+  case kVkFormatRGBA8Srgb:
+    return TextureFormat::RGBA_SRGB;
+  case kVkFormatBC7Unorm:
+    return TextureFormat::RGBA_BC7_UNORM_4x4;
+  default:
+    return TextureFormat::Invalid;
+  }
+}
+
+igl::TextureFormat selectTranscodeTarget(const igl::ICapabilities& capabilities,
+                                         const ITranscoder& transcoder,
+                                         bool srgb) {
+  using igl::TextureFormat;
+
+  // IGL has no sRGB BC7 format
+  const TextureFormat candidates[] = {
+      srgb ? TextureFormat::SRGB8_A8_ASTC_4x4 : TextureFormat::RGBA_ASTC_4x4,
+      srgb ? TextureFormat::Invalid : TextureFormat::RGBA_BC7_UNORM_4x4,
+      srgb ? TextureFormat::SRGB8_A8_EAC_ETC2 : TextureFormat::RGBA8_EAC_ETC2,
+      srgb ? TextureFormat::RGBA_SRGB : TextureFormat::RGBA_UNorm8,
+  };
+  for (const TextureFormat format : candidates) {
+    if (format != TextureFormat::Invalid && transcoder.supportsTarget(format) &&
+        isSampled(capabilities, format)) {
+      return format;
+    }
+  }
+  return TextureFormat::Invalid;
+}
+
+std::shared_ptr<igl::ITexture> createTexture(igl::IDevice& device,
+                                             const Ktx2Image& image,
+                                             ITranscoder* transcoder,
+                                             igl::Result* outResult) {
+  using igl::Result;
+  using igl::TextureDesc;
+  using igl::TextureRangeDesc;
+
+  const bool needsTranscoding = image.needsTranscoding();
+  const uint32_t numLayers = image.getNumLayers();
+  const uint32_t numFaces = image.getNumFaces();
+  const bool isCube = numFaces == 6;
+
+  if (numLayers > 1 && (isCube || image.getDepth() > 1)) {
+    Result::setResult(outResult, Result::Code::Unsupported, "Cube and 3D arrays are unsupported");
+    return nullptr;
+  }
+
+  igl::TextureFormat format = igl::TextureFormat::Invalid;
+  if (needsTranscoding) {
+    if (transcoder == nullptr || image.getDepth() > 1) {
+      Result::setResult(
+          outResult, Result::Code::Unsupported, "The KTX2 image can't be transcoded");
+      return nullptr;
+    }
+    format = selectTranscodeTarget(device, *transcoder, image.isSrgb());
+  } else {
+    if (image.getSupercompression() != Ktx2Image::Supercompression::None) {
+      Result::setResult(outResult, Result::Code::Unsupported, "Unsupported KTX2 supercompression");
+      return nullptr;
+    }
+    format = image.getNativeFormat();
+    if (!isSampled(device, format)) {
+      format = igl::TextureFormat::Invalid;
+    }
+  }
+  if (format == igl::TextureFormat::Invalid) {
+    Result::setResult(outResult, Result::Code::Unsupported, "No supported texture format");
+    return nullptr;
+  }
+
+  const auto usage = TextureDesc::TextureUsageBits::Sampled;
+  TextureDesc desc =
+      isCube ? TextureDesc::newCube(format, image.getWidth(), image.getHeight(), usage)
+      : image.getDepth() > 1
+          ? TextureDesc::new3D(
+                format, image.getWidth(), image.getHeight(), image.getDepth(), usage)
+      : numLayers > 1
+          ? TextureDesc::new2DArray(format, image.getWidth(), image.getHeight(), numLayers, usage)
+          : TextureDesc::new2D(format, image.getWidth(), image.getHeight(), usage);
+  desc.numMipLevels = image.getNumMipLevels();
+
+  auto texture = device.createTexture(desc, outResult);
+  if (!texture) {
+    return nullptr;
+  }
+
+  const auto properties = igl::TextureFormatProperties::fromTextureFormat(format);
+  std::vector<uint8_t> transcoded;
+  for (uint32_t mipLevel = 0; mipLevel != image.getNumMipLevels(); mipLevel++) {
+    const size_t width = std::max<size_t>(image.getWidth() >> mipLevel, 1);
+    const size_t height = std::max<size_t>(image.getHeight() >> mipLevel, 1);
+    const size_t depth = std::max<size_t>(image.getDepth() >> mipLevel, 1);
+    // one layer or face of the level
+    const auto range = depth > 1 ? TextureRangeDesc::new3D(0, 0, 0, width, height, depth, mipLevel)
+                                 : TextureRangeDesc::new2D(0, 0, width, height, mipLevel);
+    const size_t imageLength = properties.getBytesPerRange(range);
+
+    Result result;
+    if (!needsTranscoding) {
+      // layers, then faces, are tightly packed within a level
+      const auto& level = image.getLevel(mipLevel);
+      if (level.byteLength < imageLength * numLayers * numFaces) {
+        Result::setResult(outResult, Result::Code::ArgumentInvalid, "Truncated KTX2 level");
+        return nullptr;
+      }
+      const uint8_t* levelData = image.getData() + level.byteOffset;
+      if (isCube) {
+        for (uint32_t face = 0; face != numFaces && result.isOk(); face++) {
+          result = texture->uploadCube(
+              range, static_cast<igl::TextureCubeFace>(face), levelData + face * imageLength);
+        }
+      } else if (numLayers > 1) {
+        result = texture->upload(
+            TextureRangeDesc::new2DArray(0, 0, width, height, 0, numLayers, mipLevel), levelData);
+      } else {
+        result = texture->upload(range, levelData);
+      }
+    } else {
+      for (uint32_t layer = 0; layer != numLayers && result.isOk(); layer++) {
+        for (uint32_t face = 0; face != numFaces && result.isOk(); face++) {
+          result = transcoder->transcode(image, mipLevel, layer, face, format, transcoded);
+          if (!result.isOk()) {
+            break;
+          }
+          if (transcoded.size() < imageLength) {
+            result = Result(Result::Code::RuntimeError, "Transcoded KTX2 level is too small");
+          } else if (isCube) {
+            result = texture->uploadCube(
+                range, static_cast<igl::TextureCubeFace>(face), transcoded.data());
+          } else if (numLayers > 1) {
+            result = texture->upload(range.atLayer(layer), transcoded.data());
+          } else {
+            result = texture->upload(range, transcoded.data());
+          }
+        }
+      }
+    }
+
+    if (!result.isOk()) {
+      Result::setResult(outResult, std::move(result));
+      return nullptr;
+    }
+  }
+
+  Result::setOk(outResult);
+  return texture;
+}
+
+} // namespace textureloader
+} // namespace iglu
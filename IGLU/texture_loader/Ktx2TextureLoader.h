@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/DeviceFeatures.h>
+#include <igl/IGL.h>
+#include <igl/Texture.h>
+#include <memory>
+#include <vector>
+
+namespace iglu {
+namespace textureloader {
+
+/**
+ * @brief A parsed KTX2 container. The image does not copy the file, which must outlive it.
+ *
+ * Levels stored in a GPU format are uploaded as is. Levels stored as Basis Universal (ETC1S with
+ * BasisLZ supercompression, or UASTC) have to be transcoded by an ITranscoder first.
+ */
+class Ktx2Image {
+ public:
+  enum class Supercompression : uint32_t { None = 0, BasisLZ = 1, Zstandard = 2, Zlib = 3 };
+
+  struct Level {
+    uint64_t byteOffset = 0;
+    uint64_t byteLength = 0;
+    uint64_t uncompressedByteLength = 0;
+  };
+
+  /// Returns nullptr and sets outResult if `data` is not a valid KTX2 file
+  static std::unique_ptr<Ktx2Image> create(const uint8_t* data,
+                                           size_t length,
+                                           igl::Result* outResult);
+
+  [[nodiscard]] const uint8_t* getData() const {
+    return data_;
+  }
+  [[nodiscard]] size_t getLength() const {
+    return length_;
+  }
+
+  [[nodiscard]] uint32_t getVkFormat() const {
+    return vkFormat_;
+  }
+  [[nodiscard]] uint32_t getWidth() const {
+    return width_;
+  }
+  [[nodiscard]] uint32_t getHeight() const {
+    return height_;
+  }
+  // 1 for 2D textures
+  [[nodiscard]] uint32_t getDepth() const {
+    return depth_;
+  }
+  // 1 for textures which are not arrays
+  [[nodiscard]] uint32_t getNumLayers() const {
+    return numLayers_;
+  }
+  // 6 for cube maps, 1 otherwise
+  [[nodiscard]] uint32_t getNumFaces() const {
+    return numFaces_;
+  }
+  [[nodiscard]] uint32_t getNumMipLevels() const {
+    return static_cast<uint32_t>(levels_.size());
+  }
+  [[nodiscard]] const Level& getLevel(uint32_t mipLevel) const {
+    return levels_[mipLevel];
+  }
+  [[nodiscard]] Supercompression getSupercompression() const {
+    return supercompression_;
+  }
+  [[nodiscard]] bool isSrgb() const {
+    return isSrgb_;
+  }
+
+  /// True if the levels are Basis Universal data, which has to be transcoded
+  [[nodiscard]] bool needsTranscoding() const;
+
+  /// The format of the stored levels, or TextureFormat::Invalid if they have to be transcoded or
+  /// the format has no IGL equivalent
+  [[nodiscard]] igl::TextureFormat getNativeFormat() const;
+
+ private:
+  Ktx2Image() = default;
+
+  const uint8_t* data_ = nullptr;
+  size_t length_ = 0;
+  uint32_t vkFormat_ = 0;
+  uint32_t width_ = 0;
+  uint32_t height_ = 0;
+  uint32_t depth_ = 1;
+  uint32_t numLayers_ = 1;
+  uint32_t numFaces_ = 1;
+  Supercompression supercompression_ = Supercompression::None;
+  // color model of the data format descriptor, tells ETC1S and UASTC apart
+  uint8_t colorModel_ = 0;
+  bool isSrgb_ = false;
+  std::vector<Level> levels_;
+};
+
+/**
+ * @brief Transcodes Basis Universal levels to a GPU format. Implemented by applications on top of
+ * a Basis Universal transcoder, which this module does not depend on.
+ */
+class ITranscoder {
+ public:
+  virtual ~ITranscoder() = default;
+
+  /// Returns true if the transcoder can produce `format`
+  [[nodiscard]] virtual bool supportsTarget(igl::TextureFormat format) const = 0;
+
+  /// Transcodes one image of `image` to `format`, tightly packed, into `outData`
+  virtual igl::Result transcode(const Ktx2Image& image,
+                                uint32_t mipLevel,
+                                uint32_t layer,
+                                uint32_t face,
+                                igl::TextureFormat format,
+                                std::vector<uint8_t>& outData) = 0;
+};
+
+/// Picks the format Basis Universal data is transcoded to: ASTC 4x4, BC7, ETC2 and uncompressed
+/// RGBA8, in this order, whichever the device can sample first. Returns TextureFormat::Invalid if
+/// there is none.
+igl::TextureFormat selectTranscodeTarget(const igl::ICapabilities& capabilities,
+                                         const ITranscoder& transcoder,
+                                         bool srgb);
+
+/// Creates a sampled texture holding all the levels of `image`, transcoding them with
+/// `transcoder` if needed. `transcoder` may be nullptr for images stored in a GPU format.
+std::shared_ptr<igl::ITexture> createTexture(igl::IDevice& device,
+                                             const Ktx2Image& image,
+                                             ITranscoder* transcoder,
+                                             igl::Result* outResult);
+
+} // namespace textureloader
+} // namespace iglu
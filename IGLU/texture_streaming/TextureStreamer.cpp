@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/texture_streaming/TextureStreamer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace iglu {
+namespace texturestreaming {
+
+namespace {
+
+size_t getLevelSize(size_t size, uint32_t mipLevel) {
+  return std::max(size >> mipLevel, static_cast<size_t>(1));
+}
+
+} // namespace
+
+TextureStreamer::TextureStreamer(igl::IDevice& device,
+                                 igl::ICommandQueue& queue,
+                                 TextureStreamerDesc desc) :
+  device_(device), queue_(queue), desc_(desc), memoryBudget_(desc.memoryBudget) {}
+
+size_t TextureStreamer::getBytes(const Entry& entry, uint32_t mipLevel) {
+  if (mipLevel >= entry.desc.numMipLevels) {
+    return 0;
+  }
+  auto range = igl::TextureRangeDesc::new2D(0,
+                                            0,
+                                            getLevelSize(entry.desc.width, mipLevel),
+                                            getLevelSize(entry.desc.height, mipLevel));
+  range.numMipLevels = entry.desc.numMipLevels - mipLevel;
+  return igl::TextureFormatProperties::fromTextureFormat(entry.desc.format).getBytesPerRange(range);
+}
+
+uint32_t TextureStreamer::getDesiredMipLevel(const Entry& entry) {
+  if (entry.screenSize <= 0.0f) {
+    return entry.minResidentMipLevel;
+  }
+  const float size = static_cast<float>(std::max(entry.desc.width, entry.desc.height));
+  if (size <= entry.screenSize) {
+    return 0;
+  }
+  const auto mipLevel = static_cast<uint32_t>(std::floor(std::log2(size / entry.screenSize)));
+  return std::min(mipLevel, entry.minResidentMipLevel);
+}
+
+float TextureStreamer::getPriority(const Entry& entry, uint32_t mipLevel) {
+  const size_t size = std::max(getLevelSize(entry.desc.width, mipLevel),
+                               getLevelSize(entry.desc.height, mipLevel));
+  return entry.screenSize / static_cast<float>(size);
+}
+
+TextureHandle TextureStreamer::addTexture(std::shared_ptr<IMipSource> source,
+                                          igl::Result* outResult) {
+  if (!source) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentNull, "source is null");
+    return kInvalidTexture;
+  }
+  Entry entry;
+  entry.desc = source->getDesc();
+  if (entry.desc.type != igl::TextureType::TwoD || entry.desc.numMipLevels == 0) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "Only 2D textures can be streamed");
+    return kInvalidTexture;
+  }
+  entry.source = std::move(source);
+  entry.residentMipLevel = static_cast<uint32_t>(entry.desc.numMipLevels);
+  entry.minResidentMipLevel = static_cast<uint32_t>(entry.desc.numMipLevels) - 1;
+  for (uint32_t mipLevel = 0; mipLevel < entry.desc.numMipLevels; ++mipLevel) {
+    if (std::max(getLevelSize(entry.desc.width, mipLevel),
+                 getLevelSize(entry.desc.height, mipLevel)) <= desc_.initialMaxSize) {
+      entry.minResidentMipLevel = mipLevel;
+      break;
+    }
+  }
+
+  const igl::Result result = setResidentMipLevel(entry, entry.minResidentMipLevel);
+  submitCopies();
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, result);
+    return kInvalidTexture;
+  }
+
+  const TextureHandle handle = nextHandle_++;
+  residentBytes_ += entry.residentBytes;
+  entries_.emplace(handle, std::move(entry));
+  igl::Result::setOk(outResult);
+  return handle;
+}
+
+void TextureStreamer::removeTexture(TextureHandle handle) {
+  const auto it = entries_.find(handle);
+  if (it == entries_.end()) {
+    return;
+  }
+  residentBytes_ -= it->second.residentBytes;
+  entries_.erase(it);
+}
+
+std::shared_ptr<igl::ITexture> TextureStreamer::getTexture(TextureHandle handle) const {
+  const auto it = entries_.find(handle);
+  return it != entries_.end() ? it->second.texture : nullptr;
+}
+
+uint32_t TextureStreamer::getResidentMipLevel(TextureHandle handle) const {
+  const auto it = entries_.find(handle);
+  return it != entries_.end() ? it->second.residentMipLevel : 0;
+}
+
+void TextureStreamer::setScreenSize(TextureHandle handle, float pixels) {
+  const auto it = entries_.find(handle);
+  if (IGL_VERIFY(it != entries_.end())) {
+    it->second.screenSize = std::max(pixels, 0.0f);
+  }
+}
+
+void TextureStreamer::onMemoryPressure() noexcept {
+  hasMemoryPressure_ = true;
+}
+
+void TextureStreamer::setMemoryBudget(size_t bytes) {
+  memoryBudget_ = bytes;
+}
+
+bool TextureStreamer::evictFor(size_t bytes,
+                               float maxPriority,
+                               TextureHandle requester,
+                               std::unordered_map<TextureHandle, uint32_t>& plannedMipLevels,
+                               size_t& plannedBytes) const {
+  std::vector<TextureHandle> victims;
+  while (plannedBytes + bytes > memoryBudget_) {
+    // evict one level of the entry with the least detail on screen once it is evicted. Levels
+    // finer than the screen needs are always evicted before the requested ones are dropped
+    TextureHandle victim = kInvalidTexture;
+    float victimPriority = std::max(maxPriority, std::nextafter(1.0f, 2.0f));
+    for (const auto& [handle, entry] : entries_) {
+      const uint32_t mipLevel = plannedMipLevels[handle];
+      if (handle == requester || mipLevel >= entry.minResidentMipLevel) {
+        continue;
+      }
+      const float priority = getPriority(entry, mipLevel + 1);
+      if (priority < victimPriority) {
+        victim = handle;
+        victimPriority = priority;
+      }
+    }
+    if (victim == kInvalidTexture) {
+      if (requester != kInvalidTexture) {
+        // the levels would be evicted for nothing
+        for (auto it = victims.rbegin(); it != victims.rend(); ++it) {
+          const Entry& entry = entries_.at(*it);
+          uint32_t& mipLevel = plannedMipLevels[*it];
+          mipLevel--;
+          plannedBytes += getBytes(entry, mipLevel) - getBytes(entry, mipLevel + 1);
+        }
+      }
+      return false;
+    }
+    const Entry& entry = entries_.at(victim);
+    uint32_t& mipLevel = plannedMipLevels[victim];
+    plannedBytes -= getBytes(entry, mipLevel) - getBytes(entry, mipLevel + 1);
+    mipLevel++;
+    victims.push_back(victim);
+  }
+  return true;
+}
+
+void TextureStreamer::update() {
+  if (hasMemoryPressure_.exchange(false)) {
+    memoryBudget_ = static_cast<size_t>(static_cast<float>(memoryBudget_) *
+                                        desc_.pressureBudgetScale);
+  }
+
+  std::unordered_map<TextureHandle, uint32_t> plannedMipLevels;
+  std::vector<TextureHandle> requests;
+  for (const auto& [handle, entry] : entries_) {
+    plannedMipLevels[handle] = entry.residentMipLevel;
+    if (getDesiredMipLevel(entry) < entry.residentMipLevel) {
+      requests.push_back(handle);
+    }
+  }
+  size_t plannedBytes = residentBytes_;
+  evictFor(0, std::numeric_limits<float>::max(), kInvalidTexture, plannedMipLevels, plannedBytes);
+
+  // the most undersampled textures are streamed first
+  std::sort(requests.begin(), requests.end(), [this](TextureHandle a, TextureHandle b) {
+    const Entry& entryA = entries_.at(a);
+    const Entry& entryB = entries_.at(b);
+    return getPriority(entryA, entryA.residentMipLevel) >
+           getPriority(entryB, entryB.residentMipLevel);
+  });
+
+  size_t uploadedBytes = 0;
+  for (const TextureHandle handle : requests) {
+    const Entry& entry = entries_.at(handle);
+    uint32_t& plannedMipLevel = plannedMipLevels[handle];
+    const size_t plannedEntryBytes = getBytes(entry, plannedMipLevel);
+    for (uint32_t mipLevel = getDesiredMipLevel(entry); mipLevel < plannedMipLevel; ++mipLevel) {
+      const size_t bytes = getBytes(entry, mipLevel) - plannedEntryBytes;
+      if (uploadedBytes > 0 && uploadedBytes + bytes > desc_.uploadBudgetPerUpdate) {
+        continue;
+      }
+      if (evictFor(bytes,
+                   getPriority(entry, mipLevel),
+                   handle,
+                   plannedMipLevels,
+                   plannedBytes)) {
+        plannedMipLevel = mipLevel;
+        plannedBytes += bytes;
+        uploadedBytes += bytes;
+        break;
+      }
+    }
+    if (uploadedBytes >= desc_.uploadBudgetPerUpdate) {
+      break;
+    }
+  }
+
+  // evictions first, so their memory is released before the streamed levels are allocated
+  for (const bool isEviction : {true, false}) {
+    for (auto& [handle, entry] : entries_) {
+      const uint32_t mipLevel = plannedMipLevels[handle];
+      if (mipLevel == entry.residentMipLevel || (mipLevel > entry.residentMipLevel) != isEviction) {
+        continue;
+      }
+      const size_t oldBytes = entry.residentBytes;
+      const igl::Result result = setResidentMipLevel(entry, mipLevel);
+      if (!result.isOk()) {
+        IGL_LOG_ERROR("Cannot stream texture %s: %s\n",
+                      entry.desc.debugName.c_str(),
+                      result.message.c_str());
+        continue;
+      }
+      residentBytes_ = residentBytes_ - oldBytes + entry.residentBytes;
+    }
+  }
+
+  submitCopies();
+}
+
+void TextureStreamer::submitCopies() {
+  if (commandBuffer_) {
+    blitEncoder_->endEncoding();
+    blitEncoder_ = nullptr;
+    queue_.submit(*commandBuffer_);
+    commandBuffer_ = nullptr;
+  }
+}
+
+igl::Result TextureStreamer::setResidentMipLevel(Entry& entry, uint32_t mipLevel) {
+  const auto numMipLevels = static_cast<uint32_t>(entry.desc.numMipLevels);
+  igl::TextureDesc desc = entry.desc;
+  desc.width = getLevelSize(entry.desc.width, mipLevel);
+  desc.height = getLevelSize(entry.desc.height, mipLevel);
+  desc.numMipLevels = numMipLevels - mipLevel;
+
+  igl::Result result;
+  auto texture = device_.createTexture(desc, &result);
+  if (!result.isOk()) {
+    return result;
+  }
+
+  // the levels both textures hold are copied on the GPU, the other ones are loaded
+  uint32_t firstLoadedLevel = mipLevel;
+  uint32_t endLoadedLevel = std::max(mipLevel, entry.residentMipLevel);
+  if (entry.texture && endLoadedLevel < numMipLevels) {
+    if (!commandBuffer_) {
+      commandBuffer_ = queue_.createCommandBuffer({}, &result);
+      if (commandBuffer_) {
+        blitEncoder_ = commandBuffer_->createBlitCommandEncoder(&result);
+      }
+      if (!blitEncoder_) {
+        commandBuffer_ = nullptr;
+      }
+    }
+    if (blitEncoder_) {
+      for (uint32_t level = endLoadedLevel; level < numMipLevels; ++level) {
+        const size_t width = getLevelSize(entry.desc.width, level);
+        const size_t height = getLevelSize(entry.desc.height, level);
+        blitEncoder_->copyTexture(
+            *entry.texture,
+            igl::TextureRangeDesc::new2D(0, 0, width, height, level - entry.residentMipLevel),
+            *texture,
+            igl::TextureRangeDesc::new2D(0, 0, width, height, level - mipLevel));
+      }
+    } else {
+      // without blit encoders, all the levels are loaded again
+      endLoadedLevel = numMipLevels;
+    }
+  } else if (!entry.texture) {
+    endLoadedLevel = numMipLevels;
+  }
+
+  std::vector<uint8_t> data;
+  for (uint32_t level = firstLoadedLevel; level < endLoadedLevel; ++level) {
+    result = entry.source->loadMipLevel(level, data);
+    if (!result.isOk()) {
+      return result;
+    }
+    const auto range = igl::TextureRangeDesc::new2D(0,
+                                                    0,
+                                                    getLevelSize(entry.desc.width, level),
+                                                    getLevelSize(entry.desc.height, level),
+                                                    level - mipLevel);
+    result = texture->upload(range, data.data());
+    if (!result.isOk()) {
+      return result;
+    }
+  }
+
+  // the previous texture is kept alive by the backends until the copies have executed
+  entry.texture = std::move(texture);
+  entry.residentMipLevel = mipLevel;
+  entry.residentBytes = getBytes(entry, mipLevel);
+  return igl::Result();
+}
+
+} // namespace texturestreaming
+} // namespace iglu
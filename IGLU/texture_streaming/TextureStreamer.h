@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <igl/IGL.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace iglu {
+namespace texturestreaming {
+
+/// Identifies a texture of a TextureStreamer
+using TextureHandle = uint32_t;
+constexpr TextureHandle kInvalidTexture = ~0u;
+
+/**
+ * @brief Provides the mip levels of a streamed texture, e.g. from a file or a network cache.
+ */
+class IMipSource {
+ public:
+  virtual ~IMipSource() = default;
+
+  /// Description of the full texture. Only 2D textures with all their mip levels are streamed.
+  [[nodiscard]] virtual igl::TextureDesc getDesc() const = 0;
+
+  /// Writes the tightly packed pixels of `mipLevel` into `outData`
+  virtual igl::Result loadMipLevel(uint32_t mipLevel, std::vector<uint8_t>& outData) = 0;
+};
+
+/**
+ * @brief Parameters of a TextureStreamer.
+ *
+ *  memoryBudget          - Bytes of texture memory the streamed mip levels may take together. The
+ *                          lowest mip levels of every texture are always resident on top of it
+ *  uploadBudgetPerUpdate - Bytes of mip levels loaded and uploaded per update(), bounds the time a
+ *                          frame spends streaming. At least one texture is streamed per update()
+ *  initialMaxSize        - Textures are created with the mip levels which are at most this large,
+ *                          so they can be drawn right away. These levels are never evicted
+ *  pressureBudgetScale   - The memory budget is scaled by this when memory pressure is reported
+ */
+struct TextureStreamerDesc {
+  size_t memoryBudget = 256 * 1024 * 1024;
+  size_t uploadBudgetPerUpdate = 8 * 1024 * 1024;
+  uint32_t initialMaxSize = 64;
+  float pressureBudgetScale = 0.75f;
+};
+
+/**
+ * @brief Streams the mip levels of textures by how large they appear on screen, within a memory
+ * budget.
+ *
+ * IGL textures cannot allocate only some of their mip levels, so a streamed texture is backed by
+ * an ITexture holding the resident levels only: mip level N of the full texture is mip level 0 of
+ * a texture N times smaller. Streaming levels in or out replaces that texture with a new one. The
+ * levels the two have in common are copied on the GPU and the new ones are loaded from the
+ * IMipSource. Since texture coordinates are normalized, sampling the smaller texture clamps the
+ * level of detail to the resident levels without any sampler change, and the memory of the
+ * levels which are not resident is never allocated.
+ *
+ * Every frame, the application reports the screen size of the visible textures with
+ * setScreenSize(), calls update(), and then binds getTexture(), which may have changed.
+ * update() streams in the levels the textures lack, the most undersampled textures first. When
+ * the budget is exceeded, the levels with the least screen-space detail are evicted first, down to
+ * the ones of TextureStreamerDesc::initialMaxSize.
+ *
+ * Only onMemoryPressure() may be called from another thread, so it can be hooked into
+ * igl::IDevice::setMemoryPressureCallback().
+ */
+class TextureStreamer final {
+ public:
+  TextureStreamer(igl::IDevice& device, igl::ICommandQueue& queue, TextureStreamerDesc desc = {});
+
+  /// Creates the texture with its lowest mip levels loaded. Returns kInvalidTexture on failure
+  TextureHandle addTexture(std::shared_ptr<IMipSource> source, igl::Result* outResult);
+  void removeTexture(TextureHandle handle);
+
+  /// The texture holding the resident mip levels, replaced whenever they change
+  [[nodiscard]] std::shared_ptr<igl::ITexture> getTexture(TextureHandle handle) const;
+  /// The mip level of the full texture which is mip level 0 of getTexture()
+  [[nodiscard]] uint32_t getResidentMipLevel(TextureHandle handle) const;
+
+  /// How large the texture appears on screen, in pixels along its largest axis; 0 if not visible.
+  /// Levels larger than this are not streamed in.
+  void setScreenSize(TextureHandle handle, float pixels);
+
+  /// Evicts mip levels if over budget and streams in the missing ones. Call once per frame
+  void update();
+
+  /// Scales down the memory budget by TextureStreamerDesc::pressureBudgetScale. The levels are
+  /// evicted by the next update()
+  void onMemoryPressure() noexcept;
+
+  void setMemoryBudget(size_t bytes);
+  [[nodiscard]] size_t getMemoryBudget() const {
+    return memoryBudget_;
+  }
+  /// Bytes taken by the resident mip levels of all the textures
+  [[nodiscard]] size_t getResidentBytes() const {
+    return residentBytes_;
+  }
+
+ private:
+  struct Entry {
+    std::shared_ptr<IMipSource> source;
+    igl::TextureDesc desc;
+    std::shared_ptr<igl::ITexture> texture;
+    uint32_t residentMipLevel = 0;
+    // the levels from this one on are never evicted
+    uint32_t minResidentMipLevel = 0;
+    float screenSize = 0.0f;
+    size_t residentBytes = 0;
+  };
+
+  // bytes taken by the levels of `entry` from `mipLevel` on
+  [[nodiscard]] static size_t getBytes(const Entry& entry, uint32_t mipLevel);
+  // the finest level `entry` needs for its screen size
+  [[nodiscard]] static uint32_t getDesiredMipLevel(const Entry& entry);
+  // how undersampled `entry` is with levels from `mipLevel` on, greater than 1 if it lacks detail
+  [[nodiscard]] static float getPriority(const Entry& entry, uint32_t mipLevel);
+
+  // plans the eviction of levels of the entries whose priority after the eviction stays below
+  // `maxPriority`, until `bytes` more fit in the budget. Returns false if they do not fit, in which
+  // case nothing is evicted for `requester` unless it is kInvalidTexture
+  bool evictFor(size_t bytes,
+                float maxPriority,
+                TextureHandle requester,
+                std::unordered_map<TextureHandle, uint32_t>& plannedMipLevels,
+                size_t& plannedBytes) const;
+  // replaces the texture of `entry` with one holding the levels from `mipLevel` on
+  igl::Result setResidentMipLevel(Entry& entry, uint32_t mipLevel);
+  void submitCopies();
+
+  igl::IDevice& device_;
+  igl::ICommandQueue& queue_;
+  TextureStreamerDesc desc_;
+  size_t memoryBudget_ = 0;
+  size_t residentBytes_ = 0;
+  std::atomic<bool> hasMemoryPressure_ = false;
+  TextureHandle nextHandle_ = 0;
+  std::unordered_map<TextureHandle, Entry> entries_;
+  // copies of the resident levels, submitted at the end of update()
+  std::shared_ptr<igl::ICommandBuffer> commandBuffer_;
+  std::unique_ptr<igl::IBlitCommandEncoder> blitEncoder_;
+};
+
+} // namespace texturestreaming
+} // namespace iglu
@@ -8,51 +8,90 @@
 #include <IGLU/uniform/Collection.h>
 #include <IGLU/uniform/Descriptor.h>
 
+#include <algorithm>
+
 namespace iglu {
 namespace uniform {
 
+namespace {
+
+bool compareCrc(const std::pair<uint32_t, uint32_t>& entry, uint32_t crc32) {
+  return entry.first < crc32;
+}
+
+} // namespace
+
+size_t Collection::find(const igl::NameHandle& name) const noexcept {
+  const uint32_t crc32 = name.getCrc32();
+  auto it = std::lower_bound(sortedIndex_.begin(), sortedIndex_.end(), crc32, compareCrc);
+  return it != sortedIndex_.end() && it->first == crc32 ? it->second : kNotFound;
+}
+
+void Collection::insert(const igl::NameHandle& name, std::shared_ptr<Descriptor> value) {
+  const uint32_t crc32 = name.getCrc32();
+  auto it = std::lower_bound(sortedIndex_.begin(), sortedIndex_.end(), crc32, compareCrc);
+  sortedIndex_.insert(it, {crc32, static_cast<uint32_t>(names_.size())});
+  names_.push_back(name);
+  descriptors_.push_back(std::move(value));
+}
+
 void Collection::update(const Collection& changes) {
-  for (const auto& [key, value] : changes.descriptors_) {
+  for (size_t i = 0; i != changes.names_.size(); i++) {
+    const auto& value = changes.descriptors_[i];
+    const size_t index = find(changes.names_[i]);
     // Update should only modify values already in receiver; catch caller error otherwise
-    IGL_ASSERT(descriptors_.find(key) != descriptors_.cend());
-    IGL_ASSERT(descriptors_.find(key)->second->getType() == value->getType());
-    auto indices = descriptors_[key]->getIndices(); // grab before old desc is nuked
-    descriptors_[key] = value;
-    descriptors_[key]->setIndices(indices); // propagate indices to descriptors
+    IGL_ASSERT(index != kNotFound);
+    if (index == kNotFound) {
+      continue;
+    }
+    IGL_ASSERT(descriptors_[index]->getType() == value->getType());
+    auto indices = descriptors_[index]->getIndices(); // grab before old desc is nuked
+    descriptors_[index] = value;
+    descriptors_[index]->setIndices(indices); // propagate indices to descriptors
   }
 }
 
 void Collection::set(const igl::NameHandle& name, std::unique_ptr<Descriptor> value) {
-  if (descriptors_.find(name) == descriptors_.cend()) {
-    names_.push_back(name);
+  const size_t index = find(name);
+  if (index == kNotFound) {
+    insert(name, std::move(value));
+  } else {
+    descriptors_[index] = std::move(value);
   }
-  descriptors_[name] = std::move(value);
 }
 
 void Collection::clear(const igl::NameHandle& name) {
-  names_.erase(std::remove(names_.begin(), names_.end(), name), names_.end());
-  descriptors_.erase(name);
+  const size_t index = find(name);
+  if (index == kNotFound) {
+    return;
+  }
+  names_.erase(names_.begin() + index);
+  descriptors_.erase(descriptors_.begin() + index);
+  sortedIndex_.erase(std::remove_if(sortedIndex_.begin(),
+                                    sortedIndex_.end(),
+                                    [index](const auto& entry) { return entry.second == index; }),
+                     sortedIndex_.end());
+  for (auto& entry : sortedIndex_) {
+    if (entry.second > index) {
+      entry.second--;
+    }
+  }
 }
 
 std::vector<igl::NameHandle> Collection::getNames() const noexcept {
   IGL_LOG_INFO_ONCE("Collection::getNames() is deprecated. Use Collection::names() instead\n");
-  std::vector<igl::NameHandle> ret;
-  ret.reserve(descriptors_.size());
-  for (auto& desc : descriptors_) {
-    ret.push_back(desc.first);
-  }
-  return ret;
+  return names_;
 }
 
 bool Collection::contains(const igl::NameHandle& name) const {
-  return descriptors_.find(name) != descriptors_.end();
+  return find(name) != kNotFound;
 }
 
 const Descriptor& Collection::get(const igl::NameHandle& name) const {
-  auto it = descriptors_.find(name);
-  IGL_ASSERT(descriptors_.cend() != it); // already exists
-  IGL_ASSERT(it->second); // unique_ptr not null
-  return *(it->second);
+  const size_t index = find(name);
+  IGL_ASSERT(index != kNotFound); // already exists
+  IGL_ASSERT(descriptors_[index]); // not null
+  return *descriptors_[index];
 }
 
 Descriptor& Collection::get(const igl::NameHandle& name) {
@@ -60,7 +99,17 @@ Descriptor& Collection::get(const igl::NameHandle& name) {
 }
 
 bool Collection::operator==(const Collection& rhs) const noexcept {
-  return descriptors_ == rhs.descriptors_;
+  if (names_.size() != rhs.names_.size()) {
+    return false;
+  }
+  // same descriptors for the same names, in any order
+  for (size_t i = 0; i != names_.size(); i++) {
+    const size_t index = rhs.find(names_[i]);
+    if (index == kNotFound || descriptors_[i] != rhs.descriptors_[index]) {
+      return false;
+    }
+  }
+  return true;
 }
 
 bool Collection::operator!=(const Collection& rhs) const noexcept {
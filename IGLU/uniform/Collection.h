@@ -12,7 +12,7 @@
 #include <igl/NameHandle.h>
 
 #include <memory>
-#include <unordered_map>
+#include <vector>
 
 namespace iglu {
 namespace uniform {
@@ -23,7 +23,11 @@ class Encoder;
 //
 // Holds a collection of uniform Descriptor instances keyed by igl::NameHandle
 //
-// To submit uniforms to the GPU, use uniform::Encoder.
+// Names and descriptors are stored in two parallel arrays in insertion order, and looked up by
+// binary search in an index sorted by the CRC32 of the names. Iterating over the collection does
+// not chase hash map nodes.
+//
+// To submit uniforms to the GPU, use uniform::Encoder or uniform::CollectionEncoder.
 struct Collection {
  public:
   Collection() = default;
@@ -110,28 +114,39 @@ struct Collection {
     return names_;
   }
 
+  // Parallel to names()
+  const std::vector<std::shared_ptr<Descriptor>>& descriptors() const noexcept {
+    return descriptors_;
+  }
+
   bool operator==(const Collection& rhs) const noexcept;
   bool operator!=(const Collection& rhs) const noexcept;
 
  private:
   template<typename Desc>
   Desc& findOrCreate(const igl::NameHandle& name) {
-    auto& entry = descriptors_[name];
+    const size_t index = find(name);
     // Create entry with the type Desc if it doesn't exist
-    if (!entry) {
-      entry = std::make_unique<Desc>();
-      names_.push_back(name);
+    if (index == kNotFound) {
+      auto desc = std::make_shared<Desc>();
+      Desc& ret = *desc;
+      insert(name, std::move(desc));
+      return ret;
     }
-    return static_cast<Desc&>(*entry);
+    return static_cast<Desc&>(*descriptors_[index]);
   }
 
+  static constexpr size_t kNotFound = ~size_t(0);
+
+  // Returns the position of 'name' in names_ or kNotFound
+  size_t find(const igl::NameHandle& name) const noexcept;
+  void insert(const igl::NameHandle& name, std::shared_ptr<Descriptor> value);
+
  private:
-  //#ifdef WINDOWS_COPY_CTR_WORKAROUND
-  std::unordered_map<igl::NameHandle, std::shared_ptr<Descriptor>> descriptors_;
-  // #else
-  //   std::unordered_map<igl::NameHandle, std::unique_ptr<Descriptor>> descriptors_;
-  // #endif
   std::vector<igl::NameHandle> names_;
+  std::vector<std::shared_ptr<Descriptor>> descriptors_;
+  // (CRC32 of the name, position in names_) sorted by CRC32. NameHandles compare their CRC32.
+  std::vector<std::pair<uint32_t, uint32_t>> sortedIndex_;
 };
 
 } // namespace uniform
@@ -26,5 +26,19 @@ void CollectionEncoder::operator()(
   }
 }
 
+void CollectionEncoder::operator()(const Collection& collection,
+                                   igl::IRenderCommandEncoder& commandEncoder,
+                                   uint8_t bindTarget) const noexcept {
+  const igl::ShaderStage stage = bindTarget == igl::BindTarget::kVertex
+                                     ? igl::ShaderStage::Vertex
+                                     : igl::ShaderStage::Fragment;
+  Encoder uniformEncoder(backendType_);
+  for (const auto& descriptor : collection.descriptors()) {
+    if (descriptor->getIndex(stage) >= 0) {
+      uniformEncoder(commandEncoder, bindTarget, *descriptor);
+    }
+  }
+}
+
 } // namespace uniform
 } // namespace iglu
@@ -34,6 +34,12 @@ class CollectionEncoder {
                   uint8_t bindTarget,
                   const std::vector<igl::NameHandle>& uniformNames) const noexcept;
 
+  // Submits all the uniforms of the collection which have an index for the shader stage of
+  // bindTarget, in storage order and without looking up their names
+  void operator()(const Collection& collection,
+                  igl::IRenderCommandEncoder& commandEncoder,
+                  uint8_t bindTarget) const noexcept;
+
  private:
   igl::BackendType backendType_;
 };
@@ -117,6 +117,30 @@ struct Trait<glm::mat4> {
   static constexpr igl::UniformType kValue = igl::UniformType::Mat4x4;
   static constexpr size_t kPadding = 0;
 };
+template<>
+struct Trait<igl::Float16> {
+  using Aligned = igl::Float16;
+  static constexpr igl::UniformType kValue = igl::UniformType::Float16;
+  static constexpr size_t kPadding = 0;
+};
+template<>
+struct Trait<igl::Float16x2> {
+  using Aligned = igl::Float16x2;
+  static constexpr igl::UniformType kValue = igl::UniformType::Float16x2;
+  static constexpr size_t kPadding = 0;
+};
+template<>
+struct Trait<igl::Float16x3> {
+  using Aligned = igl::Float16x4;
+  static constexpr igl::UniformType kValue = igl::UniformType::Float16x3;
+  static constexpr size_t kPadding = sizeof(Aligned) - sizeof(igl::Float16x3);
+};
+template<>
+struct Trait<igl::Float16x4> {
+  using Aligned = igl::Float16x4;
+  static constexpr igl::UniformType kValue = igl::UniformType::Float16x4;
+  static constexpr size_t kPadding = 0;
+};
 
 } // namespace uniform
 } // namespace iglu
@@ -38,6 +38,7 @@
 #include <gli/texture_cube.hpp>
 
 #include <Compress.h>
+#include <IGLU/scene_cache/SceneCache.h>
 #include <meshoptimizer.h>
 #include <shared/Camera.h>
 #include <shared/UtilsCubemap.h>
@@ -120,7 +121,14 @@
 // @fb-only
 // @fb-only
 
-constexpr uint32_t kMeshCacheVersion = 0xC0DE0009;
+constexpr uint32_t kMeshCacheVersion = 0xC0DE000A;
+constexpr uint32_t kCacheSectionMaterials = iglu::scenecache::makeSectionId('M', 'T', 'L', 'S');
+constexpr uint32_t kCacheSectionVertices = iglu::scenecache::makeSectionId('V', 'E', 'R', 'T');
+constexpr uint32_t kCacheSectionIndices = iglu::scenecache::makeSectionId('I', 'N', 'D', 'X');
+constexpr uint32_t kCacheSectionShapeVertices =
+    iglu::scenecache::makeSectionId('S', 'H', 'P', 'V');
+constexpr uint32_t kCacheSectionShapeVertexCounts =
+    iglu::scenecache::makeSectionId('S', 'H', 'P', 'C');
 constexpr uint32_t kMaxTextures = 512;
 constexpr int kNumSamplesMSAA = 8;
 #if USE_OPENGL_BACKEND
@@ -1277,80 +1285,36 @@ bool loadAndCache(const char* cacheFileName) {
 
   IGL_LOG_INFO("Caching mesh...\n");
 
-  FILE* cacheFile = fopen(cacheFileName, "wb");
-  if (!cacheFile) {
-    return false;
-  }
-  const uint32_t numMaterials = (uint32_t)cachedMaterials_.size();
-  const uint32_t numVertices = (uint32_t)vertexData_.size();
-  const uint32_t numIndices = (uint32_t)indexData_.size();
-  fwrite(&kMeshCacheVersion, sizeof(kMeshCacheVersion), 1, cacheFile);
-  fwrite(&numMaterials, sizeof(numMaterials), 1, cacheFile);
-  fwrite(&numVertices, sizeof(numVertices), 1, cacheFile);
-  fwrite(&numIndices, sizeof(numIndices), 1, cacheFile);
-  fwrite(cachedMaterials_.data(), sizeof(CachedMaterial), numMaterials, cacheFile);
-  fwrite(vertexData_.data(), sizeof(VertexData), numVertices, cacheFile);
-  fwrite(indexData_.data(), sizeof(uint32_t), numIndices, cacheFile);
-  const uint32_t numShapes = (uint32_t)shapeData.size();
-  fwrite(&numShapes, sizeof(numShapes), 1, cacheFile);
-  fwrite(shapeData.data(), sizeof(VertexData), numShapes, cacheFile);
-  const uint32_t numShapeVertices = (uint32_t)shapeVertexCnt_.size();
-  fwrite(&numShapeVertices, sizeof(numShapeVertices), 1, cacheFile);
-  fwrite(shapeVertexCnt_.data(), sizeof(uint32_t), numShapeVertices, cacheFile);
+  iglu::scenecache::SceneCacheWriter writer(kMeshCacheVersion);
+  writer.addSection(kCacheSectionMaterials, cachedMaterials_);
+  writer.addSection(kCacheSectionVertices, vertexData_);
+  writer.addSection(kCacheSectionIndices, indexData_);
+  writer.addSection(kCacheSectionShapeVertices, shapeData);
+  writer.addSection(kCacheSectionShapeVertexCounts, shapeVertexCnt_);
+  const bool cached = writer.write(cacheFileName);
 #if USE_OPENGL_BACKEND
   vertexData_.clear();
   vertexData_.assign(shapeData.begin(), shapeData.end());
 #endif
-  return fclose(cacheFile) == 0;
+  return cached;
 }
 
 bool loadFromCache(const char* cacheFileName) {
-  FILE* cacheFile = fopen(cacheFileName, "rb");
-  IGL_SCOPE_EXIT {
-    if (cacheFile) {
-      fclose(cacheFile);
-    }
-  };
-  if (!cacheFile) {
+  Result result;
+  const auto cache = iglu::scenecache::SceneCache::open(cacheFileName, kMeshCacheVersion, &result);
+  if (!cache) {
+    IGL_LOG_INFO("Cannot use the mesh cache: %s\n", result.message.c_str());
     return false;
   }
-#define CHECK_READ(expected, read) \
-  if ((read) != (expected)) {      \
-    return false;                  \
-  }
-  uint32_t versionProbe = 0;
-  CHECK_READ(1, fread(&versionProbe, sizeof(versionProbe), 1, cacheFile));
-  if (versionProbe != kMeshCacheVersion) {
-    IGL_LOG_INFO("Cache file has wrong version id\n");
-    return false;
-  }
-  uint32_t numMaterials = 0;
-  uint32_t numVertices = 0;
-  uint32_t numIndices = 0;
-  CHECK_READ(1, fread(&numMaterials, sizeof(numMaterials), 1, cacheFile));
-  CHECK_READ(1, fread(&numVertices, sizeof(numVertices), 1, cacheFile));
-  CHECK_READ(1, fread(&numIndices, sizeof(numIndices), 1, cacheFile));
-  cachedMaterials_.resize(numMaterials);
-  vertexData_.resize(numVertices);
-  indexData_.resize(numIndices);
-  CHECK_READ(numMaterials,
-             fread(cachedMaterials_.data(), sizeof(CachedMaterial), numMaterials, cacheFile));
+  cachedMaterials_ = cache->copySection<CachedMaterial>(kCacheSectionMaterials);
 #if !USE_OPENGL_BACKEND
-  CHECK_READ(numVertices, fread(vertexData_.data(), sizeof(VertexData), numVertices, cacheFile));
-  CHECK_READ(numIndices, fread(indexData_.data(), sizeof(uint32_t), numIndices, cacheFile));
+  vertexData_ = cache->copySection<VertexData>(kCacheSectionVertices);
+  indexData_ = cache->copySection<uint32_t>(kCacheSectionIndices);
 #else
-  fseek(cacheFile, sizeof(VertexData) * numVertices + sizeof(uint32_t) * numIndices, SEEK_CUR);
-  CHECK_READ(1, fread(&numVertices, sizeof(numVertices), 1, cacheFile));
-  vertexData_.resize(numVertices);
-  CHECK_READ(numVertices, fread(vertexData_.data(), sizeof(VertexData), numVertices, cacheFile));
-  uint32_t numShapeVertices = 0;
-  CHECK_READ(1, fread(&numShapeVertices, sizeof(numShapeVertices), 1, cacheFile));
-  shapeVertexCnt_.resize(numShapeVertices);
-  CHECK_READ(numShapeVertices,
-             fread(shapeVertexCnt_.data(), sizeof(uint32_t), numShapeVertices, cacheFile));
-#endif
-#undef CHECK_READ
-  return true;
+  vertexData_ = cache->copySection<VertexData>(kCacheSectionShapeVertices);
+  shapeVertexCnt_ = cache->copySection<uint32_t>(kCacheSectionShapeVertexCounts);
+#endif
+  return !cachedMaterials_.empty() && !vertexData_.empty();
 }
 
 void initModel() {
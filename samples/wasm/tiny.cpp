@@ -6,6 +6,10 @@
  */
 
 #include <emscripten.h>
+#include <emscripten/html5.h>
+#if defined(__EMSCRIPTEN_PTHREADS__)
+#include <future>
+#endif
 #include <glm/ext.hpp>
 #include <glm/glm.hpp>
 #include <glm/gtc/random.hpp>
@@ -26,6 +30,7 @@ using glm::vec4;
 
 constexpr uint32_t kNumCubes = 16;
 constexpr uint32_t kNumBufferedFrames = 3;
+constexpr uint32_t kTextureSize = 256;
 constexpr const char* codeVS = R"(#version 300 es
 precision mediump float;
 
@@ -78,6 +83,9 @@ const char* canvas = "#canvas";
 int width_ = 1024;
 int height_ = 768;
 igl::FPSCounter fps_;
+// camera rotation controlled by dragging the mouse
+float cameraYaw_ = 0.0f;
+float cameraPitch_ = 0.0f;
 
 std::shared_ptr<igl::IFramebuffer> framebuffer_;
 std::shared_ptr<ICommandQueue> commandQueue_;
@@ -163,6 +171,38 @@ static std::shared_ptr<ITexture> getNativeDrawable() {
   return drawable;
 }
 
+static std::vector<uint32_t> generateXorPattern(uint32_t base) {
+  std::vector<uint32_t> pixels(kTextureSize * kTextureSize);
+  for (uint32_t y = 0; y != kTextureSize; y++) {
+    for (uint32_t x = 0; x != kTextureSize; x++) {
+      pixels[y * kTextureSize + x] = base + ((x ^ y) << 16) + ((x ^ y) << 8) + (x ^ y);
+    }
+  }
+  return pixels;
+}
+
+static std::shared_ptr<ITexture> createTexture(const std::vector<uint32_t>& pixels,
+                                               const char* debugName) {
+  const TextureDesc desc = TextureDesc::new2D(igl::TextureFormat::RGBA_UNorm8,
+                                              kTextureSize,
+                                              kTextureSize,
+                                              TextureDesc::TextureUsageBits::Sampled,
+                                              debugName);
+  auto texture = device_->createTexture(desc, nullptr);
+  texture->upload(TextureRangeDesc::new2D(0, 0, kTextureSize, kTextureSize), pixels.data());
+  return texture;
+}
+
+static EM_BOOL onMouseMove(int /*eventType*/, const EmscriptenMouseEvent* event, void* /*data*/) {
+  // With pthreads the browser main thread only receives the event and queues this callback to the
+  // thread which registered it, i.e. the render thread
+  if (event->buttons & 1) {
+    cameraYaw_ += 0.005f * event->movementX;
+    cameraPitch_ += 0.005f * event->movementY;
+  }
+  return EM_TRUE;
+}
+
 static void createFramebuffer(const std::shared_ptr<ITexture>& nativeDrawable) {
   FramebufferDesc framebufferDesc;
   framebufferDesc.colorAttachments[0].texture = nativeDrawable;
@@ -278,41 +318,16 @@ bool initialize() {
   }
 
   {
-    const uint32_t texWidth = 256;
-    const uint32_t texHeight = 256;
-    const TextureDesc desc = TextureDesc::new2D(igl::TextureFormat::RGBA_UNorm8,
-                                                texWidth,
-                                                texHeight,
-                                                TextureDesc::TextureUsageBits::Sampled,
-                                                "XOR pattern 1");
-    texture0_ = device_->createTexture(desc, nullptr);
-    std::vector<uint32_t> pixels(texWidth * texHeight);
-    for (uint32_t y = 0; y != texHeight; y++) {
-      for (uint32_t x = 0; x != texWidth; x++) {
-        // create a XOR pattern 1
-        pixels[y * texWidth + x] = 0xFF000000 + ((x ^ y) << 16) + ((x ^ y) << 8) + (x ^ y);
-      }
-    }
-    texture0_->upload(TextureRangeDesc::new2D(0, 0, texWidth, texHeight), pixels.data());
-  }
-
-  {
-    const uint32_t texWidth = 256;
-    const uint32_t texHeight = 256;
-    const TextureDesc desc = TextureDesc::new2D(igl::TextureFormat::RGBA_UNorm8,
-                                                texWidth,
-                                                texHeight,
-                                                TextureDesc::TextureUsageBits::Sampled,
-                                                "XOR pattern 2");
-    texture1_ = device_->createTexture(desc, nullptr);
-    std::vector<uint32_t> pixels(texWidth * texHeight);
-    for (uint32_t y = 0; y != texHeight; y++) {
-      for (uint32_t x = 0; x != texWidth; x++) {
-        // create a XOR pattern 2
-        pixels[y * texWidth + x] = 0x00FF0000 + ((x ^ y) << 16) + ((x ^ y) << 8) + (x ^ y);
-      }
-    }
-    texture1_->upload(TextureRangeDesc::new2D(0, 0, texWidth, texHeight), pixels.data());
+#if defined(__EMSCRIPTEN_PTHREADS__)
+    // generate the pixels on workers, only the thread owning the WebGL context may upload them
+    auto pixels0 = std::async(std::launch::async, generateXorPattern, 0xFF000000u);
+    auto pixels1 = std::async(std::launch::async, generateXorPattern, 0x00FF0000u);
+    texture0_ = createTexture(pixels0.get(), "XOR pattern 1");
+    texture1_ = createTexture(pixels1.get(), "XOR pattern 2");
+#else
+    texture0_ = createTexture(generateXorPattern(0xFF000000u), "XOR pattern 1");
+    texture1_ = createTexture(generateXorPattern(0x00FF0000u), "XOR pattern 2");
+#endif
   }
 
   {
@@ -323,6 +338,8 @@ bool initialize() {
     sampler_ = device_->createSamplerState(desc, nullptr);
   }
 
+  emscripten_set_mousemove_callback(canvas, nullptr, EM_TRUE, onMouseMove);
+
   // initialize random rotation axes for all cubes
   for (uint32_t i = 0; i != kNumCubes; i++) {
     axis_[i] = glm::sphericalRand(1.0f);
@@ -370,7 +387,9 @@ void onDraw(void*) {
   perFrame.proj = glm::perspectiveLH(fov, aspectRatio, 0.1f, 500.0f);
   // place a "camera" behind the cubes, the distance depends on the total number of cubes
   perFrame.view =
-      glm::translate(mat4(1.0f), vec3(0.0f, 0.0f, sqrtf(kNumCubes / 16) * 20.0f * half));
+      glm::translate(mat4(1.0f), vec3(0.0f, 0.0f, sqrtf(kNumCubes / 16) * 20.0f * half)) *
+      glm::rotate(mat4(1.0f), cameraPitch_, vec3(1.0f, 0.0f, 0.0f)) *
+      glm::rotate(mat4(1.0f), cameraYaw_, vec3(0.0f, 1.0f, 0.0f));
   ubPerFrame_[frameIndex]->upload(&perFrame, igl::BufferRange(sizeof(perFrame)));
 
   // rotate cubes around random axes
@@ -8,7 +8,9 @@
 package com.facebook.igl.shell;
 
 import android.content.res.AssetManager;
+import android.view.Display;
 import android.view.Surface;
+import android.view.View;
 
 // Wrapper for our native C++ library, which implements the actual rendering.
 public class SampleLib {
@@ -41,10 +43,19 @@ public class SampleLib {
 
   public static native void render(float displayScale);
 
+  // Feeds the frame pacer of the active renderer with a Choreographer frame time
+  public static native void onVsync(long vsyncTimeNanos, long refreshPeriodNanos);
+
   public static native void touchEvent(boolean isDown, float x, float y, float dx, float dy);
 
   public static native void surfaceDestroyed(Surface surface);
 
+  protected static long getRefreshPeriodNanos(View view) {
+    Display display = view.getDisplay();
+    float refreshRate = (display != null) ? display.getRefreshRate() : 60.0f;
+    return (long) (1000000000.0 / refreshRate);
+  }
+
   protected static class BackendTypeContext {
     int ID;
     String label;
@@ -12,6 +12,7 @@ import android.graphics.PixelFormat;
 import android.opengl.EGL15;
 import android.opengl.GLSurfaceView;
 import android.util.Log;
+import android.view.Choreographer;
 import android.view.MotionEvent;
 import javax.microedition.khronos.egl.EGL10;
 import javax.microedition.khronos.egl.EGLConfig;
@@ -20,7 +21,7 @@ import javax.microedition.khronos.egl.EGLDisplay;
 import javax.microedition.khronos.opengles.GL10;
 
 /// Simple view that sets up a GLES 2.0 rendering context
-class SampleView extends GLSurfaceView {
+class SampleView extends GLSurfaceView implements Choreographer.FrameCallback {
   private static String TAG = "SampleView";
   private float lastTouchX = 0.0f;
   private float lastTouchY = 0.0f;
@@ -41,6 +42,25 @@ class SampleView extends GLSurfaceView {
     setRenderer(new Renderer(context));
   }
 
+  @Override
+  public void onResume() {
+    super.onResume();
+    // vsync timestamps for the native frame pacer
+    Choreographer.getInstance().postFrameCallback(this);
+  }
+
+  @Override
+  public void onPause() {
+    Choreographer.getInstance().removeFrameCallback(this);
+    super.onPause();
+  }
+
+  @Override
+  public void doFrame(long frameTimeNanos) {
+    SampleLib.onVsync(frameTimeNanos, SampleLib.getRefreshPeriodNanos(this));
+    Choreographer.getInstance().postFrameCallback(this);
+  }
+
   @Override
   public boolean onTouchEvent(MotionEvent e) {
     float x = e.getX();
@@ -27,6 +27,7 @@ class VulkanView extends SurfaceView
   private float lastTouchY = 0.0f;
   Context mContext;
   RenderThread mRenderThread;
+  volatile long mRefreshPeriodNanos = 16666667L;
 
   public VulkanView(Context context) {
 
@@ -87,6 +88,7 @@ class VulkanView extends SurfaceView
 
   @Override
   public void surfaceChanged(SurfaceHolder surfaceHolder, int format, int width, int height) {
+    mRefreshPeriodNanos = SampleLib.getRefreshPeriodNanos(this);
     RenderHandler rh = mRenderThread.getHandler();
     if (rh != null) {
       rh.sendSurfaceChanged(format, width, height);
@@ -189,20 +191,8 @@ class VulkanView extends SurfaceView
 
     /** draw frame in response to a vsync event. */
     private void doFrame(long timeStampNanos) {
-      long diff = System.nanoTime() - timeStampNanos;
-      long max = 16666667l - 2000000; // if we're within 2ms, don't bother
-      if (diff > max) {
-        // too much, drop a frame
-        Log.d(
-            TAG,
-            "diff is "
-                + (diff / 1000000.0)
-                + " ms, max "
-                + (max / 1000000.0)
-                + ", skipping render");
-        return;
-      }
-
+      // the native frame pacer skips late and superfluous vsyncs
+      SampleLib.onVsync(timeStampNanos, mRefreshPeriodNanos);
       SampleLib.render(mContext.getResources().getDisplayMetrics().density);
     }
 
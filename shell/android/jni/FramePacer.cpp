@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <dlfcn.h>
+#include <igl/IGL.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+
+struct APerformanceHintManager;
+
+namespace igl::samples {
+
+namespace {
+
+// Used as frame budget until the first vsync arrives
+constexpr int64_t kDefaultRefreshPeriodNanos = 16'666'667;
+constexpr uint32_t kMaxSwapInterval = 4;
+// Weight of the latest frame in the moving averages of the work duration
+constexpr double kWorkSmoothing = 0.1;
+// The swap interval is only lowered once the prediction fits the shorter budget with headroom
+constexpr double kLowerSwapIntervalHeadroom = 0.8;
+
+int64_t getMonotonicTimeNanos() {
+  // same clock as System.nanoTime() and the Choreographer frame times
+  timespec ts = {};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+// APerformanceHint* (API level 33) are loaded at runtime to keep running on older releases
+struct PerformanceHintFunctions {
+  APerformanceHintManager* (*getManager)() = nullptr;
+  APerformanceHintSession* (*createSession)(APerformanceHintManager*,
+                                            const int32_t*,
+                                            size_t,
+                                            int64_t) = nullptr;
+  int (*updateTargetWorkDuration)(APerformanceHintSession*, int64_t) = nullptr;
+  int (*reportActualWorkDuration)(APerformanceHintSession*, int64_t) = nullptr;
+  void (*closeSession)(APerformanceHintSession*) = nullptr;
+
+  [[nodiscard]] bool isAvailable() const {
+    return getManager && createSession && updateTargetWorkDuration && reportActualWorkDuration &&
+           closeSession;
+  }
+};
+
+const PerformanceHintFunctions& getPerformanceHintFunctions() {
+  static const PerformanceHintFunctions functions = [] {
+    PerformanceHintFunctions f;
+    void* lib = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+    if (!lib) {
+      return f;
+    }
+    f.getManager = reinterpret_cast<decltype(f.getManager)>(
+        dlsym(lib, "APerformanceHint_getManager"));
+    f.createSession = reinterpret_cast<decltype(f.createSession)>(
+        dlsym(lib, "APerformanceHint_createSession"));
+    f.updateTargetWorkDuration = reinterpret_cast<decltype(f.updateTargetWorkDuration)>(
+        dlsym(lib, "APerformanceHint_updateTargetWorkDuration"));
+    f.reportActualWorkDuration = reinterpret_cast<decltype(f.reportActualWorkDuration)>(
+        dlsym(lib, "APerformanceHint_reportActualWorkDuration"));
+    f.closeSession = reinterpret_cast<decltype(f.closeSession)>(
+        dlsym(lib, "APerformanceHint_closeSession"));
+    return f;
+  }();
+  return functions;
+}
+
+} // namespace
+
+FramePacer::FramePacer(bool canSkipFrames) : canSkipFrames_(canSkipFrames) {}
+
+FramePacer::~FramePacer() {
+  closePerformanceHintSession();
+}
+
+void FramePacer::onVsync(int64_t vsyncTimeNanos, int64_t refreshPeriodNanos) {
+  std::lock_guard<std::mutex> guard(vsyncMutex_);
+  vsyncTimeNanos_ = vsyncTimeNanos;
+  if (refreshPeriodNanos > 0) {
+    refreshPeriodNanos_ = refreshPeriodNanos;
+  }
+}
+
+int64_t FramePacer::getPredictedWorkDurationNanos() const {
+  // the average alone would miss every other frame of content right at the budget
+  return static_cast<int64_t>(averageWorkNanos_ + 2.0 * workDeviationNanos_);
+}
+
+bool FramePacer::beginFrame() {
+  int64_t vsyncTimeNanos = 0;
+  int64_t refreshPeriodNanos = 0;
+  {
+    std::lock_guard<std::mutex> guard(vsyncMutex_);
+    vsyncTimeNanos = vsyncTimeNanos_;
+    refreshPeriodNanos = refreshPeriodNanos_;
+  }
+
+  int64_t now = getMonotonicTimeNanos();
+
+  if (vsyncTimeNanos <= 0 || refreshPeriodNanos <= 0) {
+    // no vsync timeline yet: render unpaced
+    refreshPeriodOfFrameNanos_ = 0;
+    frameStartNanos_ = now;
+    return true;
+  }
+  refreshPeriodOfFrameNanos_ = refreshPeriodNanos;
+
+  // the latest vsync at or before now, extrapolated from the last known one
+  const int64_t elapsedPeriods =
+      now > vsyncTimeNanos ? (now - vsyncTimeNanos) / refreshPeriodNanos : 0;
+  const int64_t currentVsyncNanos = vsyncTimeNanos + elapsedPeriods * refreshPeriodNanos;
+
+  if (canSkipFrames_ && elapsedPeriods > 0) {
+    // a callback for a newer vsync is already queued behind this one
+    return false;
+  }
+
+  int64_t startVsyncNanos = currentVsyncNanos;
+  if (lastFrameVsyncNanos_ > 0) {
+    const int64_t intervalNanos = static_cast<int64_t>(swapInterval_) * refreshPeriodNanos;
+    // vsync timestamps jitter, so round to the closest vsync of the timeline
+    const int64_t earliestNanos = lastFrameVsyncNanos_ + intervalNanos - refreshPeriodNanos / 2;
+    while (startVsyncNanos < earliestNanos) {
+      startVsyncNanos += refreshPeriodNanos;
+    }
+  }
+
+  if (startVsyncNanos > currentVsyncNanos) {
+    if (canSkipFrames_) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::nanoseconds(startVsyncNanos - now));
+    now = getMonotonicTimeNanos();
+  }
+
+  lastFrameVsyncNanos_ = startVsyncNanos;
+  frameStartNanos_ = now;
+  return true;
+}
+
+void FramePacer::endFrame() {
+  const auto workNanos = static_cast<double>(getMonotonicTimeNanos() - frameStartNanos_);
+
+  if (averageWorkNanos_ == 0.0) {
+    averageWorkNanos_ = workNanos;
+  } else {
+    workDeviationNanos_ += kWorkSmoothing *
+                           (std::abs(workNanos - averageWorkNanos_) - workDeviationNanos_);
+    averageWorkNanos_ += kWorkSmoothing * (workNanos - averageWorkNanos_);
+  }
+
+  const int64_t refreshPeriodNanos =
+      refreshPeriodOfFrameNanos_ > 0 ? refreshPeriodOfFrameNanos_ : kDefaultRefreshPeriodNanos;
+  updateSwapInterval(refreshPeriodNanos);
+  reportWorkDuration(static_cast<int64_t>(swapInterval_) * refreshPeriodNanos,
+                     static_cast<int64_t>(workNanos));
+}
+
+void FramePacer::updateSwapInterval(int64_t refreshPeriodNanos) {
+  const auto predictedNanos = static_cast<double>(getPredictedWorkDurationNanos());
+  const auto periodNanos = static_cast<double>(refreshPeriodNanos);
+
+  const auto fittingSwapInterval = static_cast<uint32_t>(
+      std::clamp(std::ceil(predictedNanos / periodNanos), 1.0, double(kMaxSwapInterval)));
+
+  if (fittingSwapInterval > swapInterval_) {
+    swapInterval_ = fittingSwapInterval;
+  } else if (swapInterval_ > 1 &&
+             predictedNanos < kLowerSwapIntervalHeadroom * (swapInterval_ - 1) * periodNanos) {
+    swapInterval_--;
+  }
+}
+
+void FramePacer::reportWorkDuration(int64_t targetDurationNanos, int64_t actualDurationNanos) {
+  if (isHintSessionUnavailable_ || actualDurationNanos <= 0) {
+    return;
+  }
+  const auto& functions = getPerformanceHintFunctions();
+
+  // the session belongs to a thread and the render thread of a view can be recreated
+  const pid_t threadId = gettid();
+  if (hintSession_ && hintSessionThreadId_ != threadId) {
+    closePerformanceHintSession();
+  }
+
+  if (!hintSession_) {
+    APerformanceHintManager* manager = functions.isAvailable() ? functions.getManager() : nullptr;
+    const int32_t threadIds[] = {threadId};
+    hintSession_ = manager ? functions.createSession(manager, threadIds, 1, targetDurationNanos)
+                           : nullptr;
+    if (!hintSession_) {
+      IGL_LOG_INFO("FramePacer: performance hints are not supported, pacing frames only\n");
+      isHintSessionUnavailable_ = true;
+      return;
+    }
+    hintSessionThreadId_ = threadId;
+    hintTargetNanos_ = targetDurationNanos;
+  }
+
+  if (hintTargetNanos_ != targetDurationNanos) {
+    functions.updateTargetWorkDuration(hintSession_, targetDurationNanos);
+    hintTargetNanos_ = targetDurationNanos;
+  }
+  functions.reportActualWorkDuration(hintSession_, actualDurationNanos);
+}
+
+void FramePacer::closePerformanceHintSession() {
+  if (hintSession_) {
+    getPerformanceHintFunctions().closeSession(hintSession_);
+    hintSession_ = nullptr;
+    hintSessionThreadId_ = 0;
+  }
+}
+
+} // namespace igl::samples
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <sys/types.h>
+
+struct APerformanceHintSession;
+
+namespace igl::samples {
+
+/**
+ * @brief Paces the frames of TinyRenderer to the display refresh, in the spirit of Swappy.
+ *
+ * The vsync timeline is fed by Choreographer callbacks through onVsync(), from any thread. The
+ * render thread brackets every frame with beginFrame() and endFrame(). The pacer predicts the work
+ * duration of the next frame from the previous ones and picks the smallest swap interval (in
+ * refresh periods) that fits it, so content that cannot make every vsync runs at a steady fraction
+ * of the refresh rate instead of alternating between two of them.
+ *
+ * The measured work duration is reported to the Android Dynamic Performance Framework
+ * (APerformanceHintSession, Android 13+) with the frame budget as target, so the CPU governor
+ * scales the clocks of the render thread to the budget instead of racing to idle. Older releases
+ * only get the pacing.
+ */
+class FramePacer final {
+ public:
+  /// With `canSkipFrames`, beginFrame() returns false for vsyncs which should not start a frame,
+  /// which suits render loops driven by Choreographer callbacks. Otherwise it sleeps until the
+  /// frame should start, which suits render loops throttled by buffer swaps (GLSurfaceView)
+  explicit FramePacer(bool canSkipFrames);
+  ~FramePacer();
+
+  FramePacer(const FramePacer&) = delete;
+  FramePacer& operator=(const FramePacer&) = delete;
+
+  /// Records the timestamp of a vsync (System.nanoTime() base) and the refresh period
+  void onVsync(int64_t vsyncTimeNanos, int64_t refreshPeriodNanos);
+
+  /// Returns false if no frame should be rendered for this vsync
+  bool beginFrame();
+  void endFrame();
+
+  [[nodiscard]] uint32_t getSwapInterval() const {
+    return swapInterval_;
+  }
+  [[nodiscard]] int64_t getPredictedWorkDurationNanos() const;
+
+ private:
+  void updateSwapInterval(int64_t refreshPeriodNanos);
+  void reportWorkDuration(int64_t targetDurationNanos, int64_t actualDurationNanos);
+  void closePerformanceHintSession();
+
+ private:
+  const bool canSkipFrames_;
+
+  std::mutex vsyncMutex_;
+  int64_t vsyncTimeNanos_ = 0; // guarded by vsyncMutex_
+  int64_t refreshPeriodNanos_ = 0; // guarded by vsyncMutex_
+
+  // render thread state
+  int64_t refreshPeriodOfFrameNanos_ = 0;
+  int64_t lastFrameVsyncNanos_ = 0;
+  int64_t frameStartNanos_ = 0;
+  double averageWorkNanos_ = 0.0;
+  double workDeviationNanos_ = 0.0;
+  uint32_t swapInterval_ = 1;
+
+  APerformanceHintSession* hintSession_ = nullptr;
+  pid_t hintSessionThreadId_ = 0;
+  int64_t hintTargetNanos_ = 0;
+  bool isHintSessionUnavailable_ = false;
+};
+
+} // namespace igl::samples
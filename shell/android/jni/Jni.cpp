@@ -43,6 +43,10 @@ JNIEXPORT void JNICALL Java_com_facebook_igl_shell_SampleLib_surfaceChanged(JNIE
 JNIEXPORT void JNICALL Java_com_facebook_igl_shell_SampleLib_render(JNIEnv* env,
                                                                     jobject obj,
                                                                     jfloat displayScale);
+JNIEXPORT void JNICALL Java_com_facebook_igl_shell_SampleLib_onVsync(JNIEnv* env,
+                                                                     jobject obj,
+                                                                     jlong vsyncTimeNanos,
+                                                                     jlong refreshPeriodNanos);
 JNIEXPORT void JNICALL Java_com_facebook_igl_shell_SampleLib_surfaceDestroyed(JNIEnv* env,
                                                                               jobject obj,
                                                                               jobject surface);
@@ -111,6 +115,15 @@ JNIEXPORT void JNICALL Java_com_facebook_igl_shell_SampleLib_render(JNIEnv* env,
   }
 }
 
+JNIEXPORT void JNICALL Java_com_facebook_igl_shell_SampleLib_onVsync(JNIEnv* env,
+                                                                     jobject obj,
+                                                                     jlong vsyncTimeNanos,
+                                                                     jlong refreshPeriodNanos) {
+  if (renderers[activeBackendTypeID] != nullptr) {
+    renderers[activeBackendTypeID]->onVsync(vsyncTimeNanos, refreshPeriodNanos);
+  }
+}
+
 JNIEXPORT void JNICALL Java_com_facebook_igl_shell_SampleLib_surfaceDestroyed(JNIEnv* env,
                                                                               jobject obj,
                                                                               jobject surface) {
@@ -22,6 +22,7 @@
 #if IGL_BACKEND_VULKAN
 #include <igl/vulkan/Device.h>
 #include <igl/vulkan/HWDevice.h>
+#include <igl/vulkan/PlatformDevice.h>
 #include <igl/vulkan/VulkanContext.h>
 #endif
 #include <memory>
@@ -35,6 +36,8 @@ void TinyRenderer::init(AAssetManager* mgr,
                         ANativeWindow* nativeWindow,
                         BackendTypeID backendTypeID) {
   backendTypeID_ = backendTypeID;
+  // Vulkan frames are driven by Choreographer callbacks, GL frames by GLSurfaceView
+  framePacer_ = std::make_unique<FramePacer>(backendTypeID_ == BackendTypeID::Vulkan);
   Result result;
   igl::HWDeviceQueryDesc queryDesc(HWDeviceType::IntegratedGpu);
   std::unique_ptr<IDevice> d;
@@ -92,6 +95,7 @@ void TinyRenderer::init(AAssetManager* mgr,
     static_cast<igl::shell::ImageLoaderAndroid&>(platform_->getImageLoader()).setAssetManager(mgr);
     session_ = igl::shell::createDefaultRenderSession(platform_);
     IGL_ASSERT(session_ != nullptr);
+    session_->setShellParams(shellParams_);
     session_->initialize();
   }
 }
@@ -101,6 +105,11 @@ void TinyRenderer::render(float displayScale) {
   IGL_ASSERT(platform_ != nullptr);
   platform_->getInputDispatcher().processEvents();
 
+  IGL_ASSERT(framePacer_ != nullptr);
+  if (!framePacer_->beginFrame()) {
+    return;
+  }
+
   // draw
   Result result;
   igl::SurfaceTextures surfaceTextures;
@@ -120,7 +129,12 @@ void TinyRenderer::render(float displayScale) {
   case BackendTypeID::Vulkan: {
     auto* platformDevice = platform_->getDevice().getPlatformDevice<vulkan::PlatformDevice>();
     surfaceTextures.color = platformDevice->createTextureFromNativeDrawable(&result);
-    surfaceTextures.depth = platformDevice->createTextureFromNativeDepth(width_, height_, &result);
+    // pre-rotated drawables have a swapped extent in landscape
+    const Dimensions dimensions = surfaceTextures.color ? surfaceTextures.color->getDimensions()
+                                                        : Dimensions(width_, height_, 1);
+    surfaceTextures.depth = platformDevice->createTextureFromNativeDepth(
+        (uint32_t)dimensions.width, (uint32_t)dimensions.height, &result);
+    shellParams_.preRotationMatrix = platformDevice->getPreRotationMatrix();
     break;
   }
 #endif
@@ -133,6 +147,14 @@ void TinyRenderer::render(float displayScale) {
   IGL_REPORT_ERROR(result.isOk());
   session_->updateDisplayScale(displayScale);
   session_->update(std::move(surfaceTextures));
+
+  framePacer_->endFrame();
+}
+
+void TinyRenderer::onVsync(int64_t vsyncTimeNanos, int64_t refreshPeriodNanos) {
+  if (framePacer_) {
+    framePacer_->onVsync(vsyncTimeNanos, refreshPeriodNanos);
+  }
 }
 
 void TinyRenderer::onSurfacesChanged(ANativeWindow* surface, int width, int height) {
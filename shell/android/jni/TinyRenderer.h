@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "FramePacer.h"
 #include <android/asset_manager.h>
 #include <android/asset_manager_jni.h>
 #include <android/native_window.h>
@@ -15,6 +16,7 @@
 #include <memory>
 #include <shell/shared/platform/android/PlatformAndroid.h>
 #include <shell/shared/renderSession/RenderSession.h>
+#include <shell/shared/renderSession/ShellParams.h>
 
 namespace igl::samples {
 
@@ -24,6 +26,7 @@ class TinyRenderer final {
  public:
   void init(AAssetManager* mgr, ANativeWindow* nativeWindow, BackendTypeID backendTypeID);
   void render(float displayScale);
+  void onVsync(int64_t vsyncTimeNanos, int64_t refreshPeriodNanos);
   void onSurfacesChanged(ANativeWindow* nativeWindow, int width, int height);
   void onSurfaceDestroyed(ANativeWindow* nativeWindow);
   void touchEvent(bool isDown, float x, float y, float dx, float dy);
@@ -32,6 +35,8 @@ class TinyRenderer final {
   BackendTypeID backendTypeID_;
   std::unique_ptr<igl::shell::RenderSession> session_;
   std::shared_ptr<igl::shell::PlatformAndroid> platform_;
+  std::unique_ptr<FramePacer> framePacer_;
+  igl::shell::ShellParams shellParams_;
   uint32_t width_ = 0;
   uint32_t height_ = 0;
 };
@@ -40,6 +40,7 @@ constexpr auto kSupportedViewConfigType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STE
 XrApp::XrApp(std::unique_ptr<impl::XrAppImpl>&& impl) :
   impl_(std::move(impl)), shellParams_(std::make_unique<ShellParams>()) {
   viewports_.fill({XR_TYPE_VIEW_CONFIGURATION_VIEW});
+  motionVectorViewports_.fill({XR_TYPE_VIEW_CONFIGURATION_VIEW});
   views_.fill({XR_TYPE_VIEW});
 }
 
@@ -47,6 +48,7 @@ XrApp::~XrApp() {
   if (!initialized_)
     return;
 
+  motionVectorSwapchainProviders_.clear();
   swapchainProviders_.clear();
 
   xrDestroySpace(stageSpace_);
@@ -94,18 +96,41 @@ bool XrApp::checkExtensions() {
                              std::begin(requiredExtensionsImpl_),
                              std::end(requiredExtensionsImpl_));
 
+  auto isAvailable = [this](const char* extensionName) {
+    return std::any_of(std::begin(extensions_),
+                       std::end(extensions_),
+                       [extensionName](const XrExtensionProperties& extension) {
+                         return strcmp(extension.extensionName, extensionName) == 0;
+                       });
+  };
+
   for (auto& requiredExtension : requiredExtensions_) {
-    auto it = std::find_if(std::begin(extensions_),
-                           std::end(extensions_),
-                           [&requiredExtension](const XrExtensionProperties& extension) {
-                             return strcmp(extension.extensionName, requiredExtension) == 0;
-                           });
-    if (it == std::end(extensions_)) {
+    if (!isAvailable(requiredExtension)) {
       IGL_LOG_ERROR("Extension %s is required.", requiredExtension);
       return false;
     }
   }
 
+  auto foveationExtensionsImpl = impl_->getXrFoveationExtensions();
+  foveationExtensions_.insert(std::end(foveationExtensions_),
+                              std::begin(foveationExtensionsImpl),
+                              std::end(foveationExtensionsImpl));
+
+  foveationSupported_ = std::all_of(
+      std::begin(foveationExtensions_), std::end(foveationExtensions_), isAvailable);
+  if (foveationSupported_) {
+    requiredExtensions_.insert(std::end(requiredExtensions_),
+                               std::begin(foveationExtensions_),
+                               std::end(foveationExtensions_));
+  }
+  IGL_LOG_INFO("Fixed foveation is %s", foveationSupported_ ? "supported" : "not supported");
+
+  spaceWarpSupported_ = isAvailable(XR_FB_SPACE_WARP_EXTENSION_NAME);
+  if (spaceWarpSupported_) {
+    requiredExtensions_.push_back(XR_FB_SPACE_WARP_EXTENSION_NAME);
+  }
+  IGL_LOG_INFO("Application SpaceWarp is %s", spaceWarpSupported_ ? "supported" : "not supported");
+
   return true;
 }
 
@@ -156,6 +181,9 @@ bool XrApp::createSystem() {
     return false;
   }
 
+  if (spaceWarpSupported_) {
+    systemProps_.next = &spaceWarpProps_;
+  }
   XR_CHECK(xrGetSystemProperties(instance_, systemId_, &systemProps_));
 
   IGL_LOG_INFO(
@@ -167,6 +195,11 @@ bool XrApp::createSystem() {
   IGL_LOG_INFO("System Tracking Properties: OrientationTracking=%s PositionTracking=%s",
                systemProps_.trackingProperties.orientationTracking ? "True" : "False",
                systemProps_.trackingProperties.positionTracking ? "True" : "False");
+  if (spaceWarpSupported_) {
+    IGL_LOG_INFO("System SpaceWarp Properties: MotionVectorWidth=%d MotionVectorHeight=%d",
+                 spaceWarpProps_.recommendedMotionVectorImageRectWidth,
+                 spaceWarpProps_.recommendedMotionVectorImageRectHeight);
+  }
   return true;
 }
 
@@ -268,11 +301,92 @@ void XrApp::createSwapchainProviders(const std::unique_ptr<igl::IDevice>& device
                                               platform_,
                                               session_,
                                               viewports_[i],
-                                              numViewsPerSwapchain));
+                                              numViewsPerSwapchain,
+                                              foveationSupported_));
     swapchainProviders_.back()->initialize();
   }
 }
 
+void XrApp::createMotionVectorSwapchainProviders() {
+  const size_t numSwapchainProviders = useSinglePassStereo_ ? 1 : kNumViews;
+  const size_t numViewsPerSwapchain = useSinglePassStereo_ ? kNumViews : 1;
+  motionVectorSwapchainProviders_.reserve(numSwapchainProviders);
+
+  for (size_t i = 0; i < numSwapchainProviders; i++) {
+    motionVectorViewports_[i] = viewports_[i];
+    motionVectorViewports_[i].recommendedImageRectWidth =
+        spaceWarpProps_.recommendedMotionVectorImageRectWidth;
+    motionVectorViewports_[i].recommendedImageRectHeight =
+        spaceWarpProps_.recommendedMotionVectorImageRectHeight;
+    motionVectorSwapchainProviders_.emplace_back(
+        std::make_unique<XrSwapchainProvider>(impl_->createSwapchainProviderImpl(),
+                                              platform_,
+                                              session_,
+                                              motionVectorViewports_[i],
+                                              numViewsPerSwapchain,
+                                              false,
+                                              true));
+    motionVectorSwapchainProviders_.back()->initialize();
+  }
+}
+
+void XrApp::loadFoveationFunctions() {
+  if (!foveationSupported_) {
+    return;
+  }
+  XR_CHECK(xrGetInstanceProcAddr(instance_,
+                                 "xrCreateFoveationProfileFB",
+                                 (PFN_xrVoidFunction*)(&xrCreateFoveationProfileFB_)));
+  XR_CHECK(xrGetInstanceProcAddr(instance_,
+                                 "xrDestroyFoveationProfileFB",
+                                 (PFN_xrVoidFunction*)(&xrDestroyFoveationProfileFB_)));
+  XR_CHECK(xrGetInstanceProcAddr(
+      instance_, "xrUpdateSwapchainFB", (PFN_xrVoidFunction*)(&xrUpdateSwapchainFB_)));
+  foveationSupported_ =
+      xrCreateFoveationProfileFB_ && xrDestroyFoveationProfileFB_ && xrUpdateSwapchainFB_;
+}
+
+void XrApp::updateFoveation() {
+  if (!foveationSupported_ || foveationLevel_ == appliedFoveationLevel_) {
+    return;
+  }
+
+  XrFoveationLevelProfileCreateInfoFB levelProfileCreateInfo = {
+      .type = XR_TYPE_FOVEATION_LEVEL_PROFILE_CREATE_INFO_FB,
+      .next = nullptr,
+      .level = foveationLevel_,
+      .verticalOffset = 0.0f,
+      .dynamic = XR_FOVEATION_DYNAMIC_DISABLED_FB,
+  };
+  XrFoveationProfileCreateInfoFB profileCreateInfo = {
+      .type = XR_TYPE_FOVEATION_PROFILE_CREATE_INFO_FB,
+      .next = &levelProfileCreateInfo,
+  };
+  XrFoveationProfileFB profile = XR_NULL_HANDLE;
+  XrResult result;
+  XR_CHECK(result = xrCreateFoveationProfileFB_(session_, &profileCreateInfo, &profile));
+  if (result != XR_SUCCESS) {
+    IGL_LOG_ERROR("Failed to create a foveation profile: %d.", result);
+    foveationSupported_ = false;
+    return;
+  }
+
+  XrSwapchainStateFoveationFB foveationState = {
+      .type = XR_TYPE_SWAPCHAIN_STATE_FOVEATION_FB,
+      .next = nullptr,
+      .flags = 0,
+      .profile = profile,
+  };
+  for (const auto& swapchainProvider : swapchainProviders_) {
+    XR_CHECK(xrUpdateSwapchainFB_(swapchainProvider->colorSwapchain(),
+                                  (XrSwapchainStateBaseHeaderFB*)&foveationState));
+  }
+  // the swapchains keep their state once updated
+  XR_CHECK(xrDestroyFoveationProfileFB_(profile));
+
+  appliedFoveationLevel_ = foveationLevel_;
+}
+
 bool XrApp::initialize(const struct android_app* app) {
   if (initialized_) {
     return false;
@@ -300,6 +414,8 @@ bool XrApp::initialize(const struct android_app* app) {
     return false;
   }
 
+  loadFoveationFunctions();
+
   if (!createSystem()) {
     return false;
   }
@@ -341,10 +457,21 @@ void XrApp::createShellSession(std::unique_ptr<igl::IDevice> device, AAssetManag
   static_cast<igl::shell::ImageLoaderAndroid&>(platform_->getImageLoader())
       .setAssetManager(assetMgr);
   renderSession_ = igl::shell::createDefaultRenderSession(platform_);
+  for (auto& buffer : lateLatchedViewBuffers_) {
+    buffer = platform_->getDevice().createBuffer(
+        BufferDesc(BufferDesc::BufferTypeBits::Uniform,
+                   nullptr,
+                   sizeof(LateLatchedView) * kNumViews,
+                   ResourceStorage::Shared,
+                   BufferDesc::BufferAPIHintBits::UniformBlock,
+                   "Buffer: late latched views"),
+        nullptr);
+  }
   shellParams_->shellControlsViewParams = true;
   shellParams_->renderMode = useSinglePassStereo_ ? RenderMode::SinglePassStereo
                                                   : RenderMode::DualPassStereo;
   shellParams_->viewParams.resize(useSinglePassStereo_ ? 2 : 1);
+  shellParams_->motionVectorsSupported = spaceWarpSupported_;
   renderSession_->setShellParams(*shellParams_);
   renderSession_->initialize();
 }
@@ -469,10 +596,19 @@ XrFrameState XrApp::beginFrame() {
 
   XR_CHECK(xrBeginFrame(session_, &beginFrameInfo));
 
+  predictedDisplayTime_ = frameState.predictedDisplayTime;
+  locateViews(frameState.predictedDisplayTime, 0, kNumViews);
+
+  return frameState;
+}
+
+// Only the views [firstView, firstView + numViews) are updated, so that the poses of the views
+// already rendered keep matching the ones submitted in endFrame()
+void XrApp::locateViews(XrTime displayTime, size_t firstView, size_t numViews) {
   XrSpaceLocation loc = {
       loc.type = XR_TYPE_SPACE_LOCATION,
   };
-  XR_CHECK(xrLocateSpace(headSpace_, stageSpace_, frameState.predictedDisplayTime, &loc));
+  XR_CHECK(xrLocateSpace(headSpace_, stageSpace_, displayTime, &loc));
   XrPosef headPose = loc.pose;
 
   XrViewState viewState = {XR_TYPE_VIEW_STATE};
@@ -481,16 +617,19 @@ XrFrameState XrApp::beginFrame() {
       XR_TYPE_VIEW_LOCATE_INFO,
       nullptr,
       viewConfigProps_.viewConfigurationType,
-      frameState.predictedDisplayTime,
+      displayTime,
       headSpace_,
   };
 
-  uint32_t numViews = views_.size();
+  std::array<XrView, kNumViews> views;
+  views.fill({XR_TYPE_VIEW});
+  uint32_t numLocatedViews = views.size();
 
   XR_CHECK(xrLocateViews(
-      session_, &projectionInfo, &viewState, views_.size(), &numViews, views_.data()));
+      session_, &projectionInfo, &viewState, views.size(), &numLocatedViews, views.data()));
 
-  for (size_t i = 0; i < kNumViews; i++) {
+  for (size_t i = firstView; i < firstView + numViews; i++) {
+    views_[i] = views[i];
     XrPosef eyePose = views_[i].pose;
     XrPosef_Multiply(&viewStagePoses_[i], &headPose, &eyePose);
     auto viewTransformXrPosef = XrPosef_Inverse(viewStagePoses_[i]);
@@ -499,8 +638,38 @@ XrFrameState XrApp::beginFrame() {
     viewTransforms_[i] = glm::make_mat4(xrMat4.m);
     cameraPositions_[i] = glm::vec3(eyePose.position.x, eyePose.position.y, eyePose.position.z);
   }
+}
 
-  return frameState;
+// Binds the next buffer of the ring to ShellParams::lateLatchedViewBuffer for the pass rendering
+// the views [firstView, firstView + numViews). The session re-locates them when it latches.
+void XrApp::prepareLateLatch(size_t firstView, size_t numViews, bool latch) {
+  shellParams_->lateLatchedViewBuffer = lateLatchedViewBuffers_[lateLatchedViewBufferIndex_];
+  lateLatchedViewBufferIndex_ = (lateLatchedViewBufferIndex_ + 1) % kNumLateLatchedViewBuffers;
+  writeLateLatchedViews(firstView, numViews);
+
+  if (!latch) {
+    shellParams_->latchViewParams = nullptr;
+    return;
+  }
+  shellParams_->latchViewParams = [this, firstView, numViews]() {
+    locateViews(predictedDisplayTime_, firstView, numViews);
+    writeLateLatchedViews(firstView, numViews);
+  };
+}
+
+void XrApp::writeLateLatchedViews(size_t firstView, size_t numViews) {
+  std::array<LateLatchedView, kNumViews> lateLatchedViews;
+  for (size_t i = 0; i < numViews; i++) {
+    auto& viewParams = shellParams_->viewParams[i];
+    viewParams.viewMatrix = viewTransforms_[firstView + i];
+    viewParams.cameraPosition = cameraPositions_[firstView + i];
+    lateLatchedViews[i].viewMatrix = viewParams.viewMatrix;
+    lateLatchedViews[i].cameraPosition = glm::vec4(viewParams.cameraPosition, 1.0f);
+  }
+  if (shellParams_->lateLatchedViewBuffer) {
+    shellParams_->lateLatchedViewBuffer->upload(
+        lateLatchedViews.data(), igl::BufferRange(sizeof(LateLatchedView) * numViews, 0));
+  }
 }
 
 namespace {
@@ -516,26 +685,47 @@ void XrApp::render() {
   if (useSinglePassStereo_) {
     auto surfaceTextures = swapchainProviders_[0]->getSurfaceTextures();
     for (size_t j = 0; j < shellParams_->viewParams.size(); j++) {
-      shellParams_->viewParams[j].viewMatrix = viewTransforms_[j];
-      shellParams_->viewParams[j].cameraPosition = cameraPositions_[j];
       copyFov(shellParams_->viewParams[j].fov, views_[j].fov);
     }
+    prepareLateLatch(0, kNumViews, true);
     renderSession_->update(std::move(surfaceTextures));
     swapchainProviders_[0]->releaseSwapchainImages();
   } else {
     for (size_t i = 0; i < kNumViews; i++) {
-      shellParams_->viewParams[0].viewMatrix = viewTransforms_[i];
       copyFov(shellParams_->viewParams[0].fov, views_[i].fov);
+      prepareLateLatch(i, 1, true);
       auto surfaceTextures = swapchainProviders_[i]->getSurfaceTextures();
       renderSession_->update(surfaceTextures);
       swapchainProviders_[i]->releaseSwapchainImages();
     }
   }
+
+  motionVectorsRendered_ = spaceWarpSupported_ && renderSession_->appParams().renderMotionVectors;
+  if (!motionVectorsRendered_) {
+    return;
+  }
+  if (motionVectorSwapchainProviders_.empty()) {
+    createMotionVectorSwapchainProviders();
+  }
+  // the motion vectors are rendered with the poses of the colors, which are not latched again
+  if (useSinglePassStereo_) {
+    prepareLateLatch(0, kNumViews, false);
+    renderSession_->updateMotionVectors(motionVectorSwapchainProviders_[0]->getSurfaceTextures());
+    motionVectorSwapchainProviders_[0]->releaseSwapchainImages();
+  } else {
+    for (size_t i = 0; i < kNumViews; i++) {
+      copyFov(shellParams_->viewParams[0].fov, views_[i].fov);
+      prepareLateLatch(i, 1, false);
+      renderSession_->updateMotionVectors(motionVectorSwapchainProviders_[i]->getSurfaceTextures());
+      motionVectorSwapchainProviders_[i]->releaseSwapchainImages();
+    }
+  }
 }
 
 void XrApp::endFrame(XrFrameState frameState) {
   std::array<XrCompositionLayerProjectionView, kNumViews> projectionViews;
   std::array<XrCompositionLayerDepthInfoKHR, kNumViews> depthInfos;
+  std::array<XrCompositionLayerSpaceWarpInfoFB, kNumViews> spaceWarpInfos;
 
   XrCompositionLayerProjection projection = {
       XR_TYPE_COMPOSITION_LAYER_PROJECTION,
@@ -580,6 +770,36 @@ void XrApp::endFrame(XrFrameState frameState) {
     depthInfos[i].maxDepth = appParams.depthParams.maxDepth;
     depthInfos[i].nearZ = appParams.depthParams.nearZ;
     depthInfos[i].farZ = appParams.depthParams.farZ;
+
+    if (!motionVectorsRendered_) {
+      continue;
+    }
+    const size_t provider = useSinglePassStereo_ ? 0 : i;
+    const auto& motionVectorSwapchainProvider = motionVectorSwapchainProviders_[provider];
+    const XrRect2Di motionVectorRect = {
+        {0, 0},
+        {
+            (int32_t)motionVectorViewports_[provider].recommendedImageRectWidth,
+            (int32_t)motionVectorViewports_[provider].recommendedImageRectHeight,
+        }};
+    spaceWarpInfos[i] = {
+        .type = XR_TYPE_COMPOSITION_LAYER_SPACE_WARP_INFO_FB,
+        .next = nullptr,
+        .layerFlags = 0,
+        .motionVectorSubImage = {motionVectorSwapchainProvider->colorSwapchain(),
+                                 motionVectorRect,
+                                 index},
+        // the shell does not move the stage space between frames
+        .appSpaceDeltaPose = {{0.0f, 0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f}},
+        .depthSubImage = {motionVectorSwapchainProvider->depthSwapchain(),
+                          motionVectorRect,
+                          index},
+        .minDepth = appParams.depthParams.minDepth,
+        .maxDepth = appParams.depthParams.maxDepth,
+        .nearZ = appParams.depthParams.nearZ,
+        .farZ = appParams.depthParams.farZ,
+    };
+    depthInfos[i].next = &spaceWarpInfos[i];
   }
 
   const XrCompositionLayerBaseHeader* const layers[] = {
@@ -602,6 +822,8 @@ void XrApp::update() {
     return;
   }
 
+  updateFoveation();
+
   auto frameState = beginFrame();
   render();
   endFrame(frameState);
@@ -63,6 +63,18 @@ class XrApp {
   }
   XrSession session() const;
 
+  // Fixed foveation level of the eye swapchains, applied before the next frame. Ignored unless
+  // the runtime supports XR_FB_foveation.
+  void setFoveationLevel(XrFoveationLevelFB level) {
+    foveationLevel_ = level;
+  }
+  XrFoveationLevelFB foveationLevel() const {
+    return foveationLevel_;
+  }
+  bool foveationSupported() const {
+    return foveationSupported_;
+  }
+
  private:
   bool checkExtensions();
   bool createInstance();
@@ -70,11 +82,17 @@ class XrApp {
   bool enumerateViewConfigurations();
   void enumerateReferenceSpaces();
   void createSwapchainProviders(const std::unique_ptr<igl::IDevice>& device);
+  void loadFoveationFunctions();
+  void updateFoveation();
+  void createMotionVectorSwapchainProviders();
   void handleSessionStateChanges(XrSessionState state);
   void createShellSession(std::unique_ptr<igl::IDevice> device, AAssetManager* assetMgr);
 
   void createSpaces();
   XrFrameState beginFrame();
+  void locateViews(XrTime displayTime, size_t firstView, size_t numViews);
+  void prepareLateLatch(size_t firstView, size_t numViews, bool latch);
+  void writeLateLatchedViews(size_t firstView, size_t numViews);
   void render();
   void endFrame(XrFrameState frameState);
 
@@ -87,6 +105,11 @@ class XrApp {
   std::vector<const char*> requiredExtensions_ = {
       XR_FB_SWAPCHAIN_UPDATE_STATE_EXTENSION_NAME,
   };
+  // enabled only when all of them are available
+  std::vector<const char*> foveationExtensions_ = {
+      XR_FB_FOVEATION_EXTENSION_NAME,
+      XR_FB_FOVEATION_CONFIGURATION_EXTENSION_NAME,
+  };
 
   XrInstanceProperties instanceProps_ = {
       .type = XR_TYPE_INSTANCE_PROPERTIES,
@@ -112,14 +135,39 @@ class XrApp {
 
   bool useSinglePassStereo_ = true;
 
+  // Ring of ShellParams::lateLatchedViewBuffer, one per pass (color and motion vectors of each
+  // swapchain) of the frames in flight
+  static constexpr size_t kNumLateLatchedViewBuffers = 3 * 2 * kNumViews;
+  std::array<std::shared_ptr<igl::IBuffer>, kNumLateLatchedViewBuffers> lateLatchedViewBuffers_;
+  size_t lateLatchedViewBufferIndex_ = 0;
+  XrTime predictedDisplayTime_ = 0;
+
   // If useSinglePassStereo_ is true, only one XrSwapchainProvider will be created.
   std::vector<std::unique_ptr<XrSwapchainProvider>> swapchainProviders_;
+  // XR_FB_space_warp motion vector and depth swapchains, created when the session first renders
+  // motion vectors. Laid out as swapchainProviders_.
+  std::vector<std::unique_ptr<XrSwapchainProvider>> motionVectorSwapchainProviders_;
+  std::array<XrViewConfigurationView, kNumViews> motionVectorViewports_;
+  bool motionVectorsRendered_ = false;
 
   XrSpace headSpace_ = XR_NULL_HANDLE;
   XrSpace localSpace_ = XR_NULL_HANDLE;
   XrSpace stageSpace_ = XR_NULL_HANDLE;
   bool stageSpaceSupported_ = false;
 
+  bool foveationSupported_ = false;
+  XrFoveationLevelFB foveationLevel_ = XR_FOVEATION_LEVEL_HIGH_FB;
+  XrFoveationLevelFB appliedFoveationLevel_ = XR_FOVEATION_LEVEL_MAX_ENUM_FB;
+  PFN_xrCreateFoveationProfileFB xrCreateFoveationProfileFB_ = nullptr;
+  PFN_xrDestroyFoveationProfileFB xrDestroyFoveationProfileFB_ = nullptr;
+  PFN_xrUpdateSwapchainFB xrUpdateSwapchainFB_ = nullptr;
+
+  bool spaceWarpSupported_ = false;
+  XrSystemSpaceWarpPropertiesFB spaceWarpProps_ = {
+      .type = XR_TYPE_SYSTEM_SPACE_WARP_PROPERTIES_FB,
+      .next = nullptr,
+  };
+
   std::unique_ptr<impl::XrAppImpl> impl_;
 
   bool initialized_ = false;
@@ -17,12 +17,16 @@ XrSwapchainProvider::XrSwapchainProvider(
     const std::shared_ptr<igl::shell::PlatformAndroid>& platform,
     const XrSession& session,
     const XrViewConfigurationView& viewport,
-    uint32_t numViews) :
+    uint32_t numViews,
+    bool useFoveation,
+    bool motionVectors) :
   impl_(std::move(impl)),
   platform_(platform),
   session_(session),
   viewport_(viewport),
-  numViews_(numViews) {}
+  numViews_(numViews),
+  useFoveation_(useFoveation),
+  motionVectors_(motionVectors) {}
 XrSwapchainProvider::~XrSwapchainProvider() {
   xrDestroySwapchain(colorSwapchain_);
   xrDestroySwapchain(depthSwapchain_);
@@ -36,15 +40,17 @@ bool XrSwapchainProvider::initialize() {
   XR_CHECK(xrEnumerateSwapchainFormats(
       session_, numSwapchainFormats, &numSwapchainFormats, swapchainFormats.data()));
 
-  auto colorFormat = impl_->preferredColorFormat();
+  auto colorFormat =
+      motionVectors_ ? impl_->preferredMotionVectorFormat() : impl_->preferredColorFormat();
   if (std::any_of(std::begin(swapchainFormats),
                   std::end(swapchainFormats),
                   [&](const auto& format) { return format == colorFormat; })) {
     selectedColorFormat_ = colorFormat;
   }
 
-  colorSwapchain_ =
-      createXrSwapchain(XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT, selectedColorFormat_);
+  colorSwapchain_ = createXrSwapchain(XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT,
+                                      selectedColorFormat_,
+                                      useFoveation_ ? impl_->foveationFlags() : 0);
 
   auto depthFormat = impl_->preferredDepthFormat();
   if (std::any_of(std::begin(swapchainFormats),
@@ -62,13 +68,16 @@ bool XrSwapchainProvider::initialize() {
                          selectedColorFormat_,
                          selectedDepthFormat_,
                          viewport_,
-                         numViews_);
+                         numViews_,
+                         useFoveation_);
 
   return true;
 }
 
-XrSwapchain XrSwapchainProvider::createXrSwapchain(XrSwapchainUsageFlags extraUsageFlags,
-                                                   int64_t format) {
+XrSwapchain XrSwapchainProvider::createXrSwapchain(
+    XrSwapchainUsageFlags extraUsageFlags,
+    int64_t format,
+    XrSwapchainCreateFoveationFlagsFB foveationFlags) {
   XrSwapchainCreateInfo swapChainCreateInfo = {XR_TYPE_SWAPCHAIN_CREATE_INFO, nullptr};
   swapChainCreateInfo.usageFlags = XR_SWAPCHAIN_USAGE_SAMPLED_BIT | extraUsageFlags;
   swapChainCreateInfo.format = format;
@@ -79,6 +88,12 @@ XrSwapchain XrSwapchainProvider::createXrSwapchain(XrSwapchainUsageFlags extraUs
   swapChainCreateInfo.arraySize = numViews_;
   swapChainCreateInfo.mipCount = 1;
 
+  XrSwapchainCreateInfoFoveationFB foveationCreateInfo = {
+      XR_TYPE_SWAPCHAIN_CREATE_INFO_FOVEATION_FB, nullptr, foveationFlags};
+  if (foveationFlags != 0) {
+    swapChainCreateInfo.next = &foveationCreateInfo;
+  }
+
   XrSwapchain swapchain;
   XR_CHECK(xrCreateSwapchain(session_, &swapChainCreateInfo, &swapchain));
   IGL_LOG_INFO("XrSwapchain created");
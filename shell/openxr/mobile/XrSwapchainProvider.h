@@ -29,7 +29,9 @@ class XrSwapchainProvider {
                       const std::shared_ptr<igl::shell::PlatformAndroid>& platform,
                       const XrSession& session,
                       const XrViewConfigurationView& viewport,
-                      uint32_t numViews);
+                      uint32_t numViews,
+                      bool useFoveation = false,
+                      bool motionVectors = false);
   ~XrSwapchainProvider();
 
   bool initialize();
@@ -49,7 +51,9 @@ class XrSwapchainProvider {
   }
 
  private:
-  XrSwapchain createXrSwapchain(XrSwapchainUsageFlags extraUsageFlags, int64_t format);
+  XrSwapchain createXrSwapchain(XrSwapchainUsageFlags extraUsageFlags,
+                                int64_t format,
+                                XrSwapchainCreateFoveationFlagsFB foveationFlags = 0);
 
  private:
   std::unique_ptr<impl::XrSwapchainProviderImpl> impl_;
@@ -64,5 +68,10 @@ class XrSwapchainProvider {
   uint32_t currentImageIndex_;
   const uint32_t numViews_ =
       1; // The number of layers of the underlying swapchain image would match numViews_.
+  // The color swapchain is created with XR_FB_foveation and accepts foveation profiles through
+  // xrUpdateSwapchainFB().
+  const bool useFoveation_ = false;
+  // The color swapchain receives XR_FB_space_warp motion vectors instead of colors.
+  const bool motionVectors_ = false;
 };
 } // namespace igl::shell::openxr::mobile
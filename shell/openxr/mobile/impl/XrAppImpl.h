@@ -20,6 +20,8 @@ class XrAppImpl {
  public:
   virtual ~XrAppImpl() = default;
   virtual std::vector<const char*> getXrRequiredExtensions() const = 0;
+  // extensions needed on top of XR_FB_foveation for foveated swapchains of this graphics API
+  virtual std::vector<const char*> getXrFoveationExtensions() const = 0;
   virtual std::unique_ptr<igl::IDevice> initIGL(XrInstance instance, XrSystemId systemId) = 0;
   virtual XrSession initXrSession(XrInstance instance,
                                   XrSystemId systemId,
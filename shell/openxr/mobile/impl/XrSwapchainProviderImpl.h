@@ -21,13 +21,19 @@ class XrSwapchainProviderImpl {
   virtual ~XrSwapchainProviderImpl() = default;
   virtual int64_t preferredColorFormat() const = 0;
   virtual int64_t preferredDepthFormat() const = 0;
+  // color format of XR_FB_space_warp motion vector swapchains
+  virtual int64_t preferredMotionVectorFormat() const = 0;
+  // flags of XrSwapchainCreateInfoFoveationFB used to create a foveated color swapchain
+  virtual XrSwapchainCreateFoveationFlagsFB foveationFlags() const = 0;
+  // `useFoveation` is true when the color swapchain was created with foveationFlags()
   virtual void enumerateImages(igl::IDevice& device,
                                XrSwapchain colorSwapchain,
                                XrSwapchain depthSwapchain,
                                int64_t selectedColorFormat,
                                int64_t selectedDepthFormat,
                                const XrViewConfigurationView& viewport,
-                               uint32_t numViews) = 0;
+                               uint32_t numViews,
+                               bool useFoveation) = 0;
   virtual igl::SurfaceTextures getSurfaceTextures(igl::IDevice& device,
                                                   const XrSwapchain& colorSwapchain,
                                                   const XrSwapchain& depthSwapchain,
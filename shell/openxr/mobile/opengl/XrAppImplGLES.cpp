@@ -23,6 +23,11 @@ std::vector<const char*> XrAppImplGLES::getXrRequiredExtensions() const {
   };
 }
 
+std::vector<const char*> XrAppImplGLES::getXrFoveationExtensions() const {
+  // the runtime foveates the swapchain textures with QCOM_texture_foveated
+  return {};
+}
+
 std::unique_ptr<igl::IDevice> XrAppImplGLES::initIGL(XrInstance instance, XrSystemId systemId) {
   // Get the graphics requirements.
   PFN_xrGetOpenGLESGraphicsRequirementsKHR pfnGetOpenGLESGraphicsRequirementsKHR = NULL;
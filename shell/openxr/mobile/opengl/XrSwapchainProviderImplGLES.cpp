@@ -92,7 +92,9 @@ void XrSwapchainProviderImplGLES::enumerateImages(igl::IDevice& device,
                                                   int64_t selectedColorFormat,
                                                   int64_t selectedDepthFormat,
                                                   const XrViewConfigurationView& viewport,
-                                                  uint32_t numViews) {
+                                                  uint32_t numViews,
+                                                  bool /*useFoveation*/) {
+  // foveated swapchain textures need no extra attachments on GLES
   enumerateSwapchainImages(device, colorSwapchain, colorImages_);
   enumerateSwapchainImages(device, depthSwapchain, depthImages_);
 }
@@ -29,13 +29,21 @@ class XrSwapchainProviderImplGLES final : public impl::XrSwapchainProviderImpl {
   int64_t preferredDepthFormat() const final {
     return GL_DEPTH_COMPONENT16;
   }
+  int64_t preferredMotionVectorFormat() const final {
+    return GL_RGBA16F;
+  }
+  // the runtime applies QCOM_texture_foveated to the swapchain textures
+  XrSwapchainCreateFoveationFlagsFB foveationFlags() const final {
+    return XR_SWAPCHAIN_CREATE_FOVEATION_SCALED_BIN_BIT_FB;
+  }
   void enumerateImages(igl::IDevice& device,
                        XrSwapchain colorSwapchain,
                        XrSwapchain depthSwapchain,
                        int64_t selectedColorFormat,
                        int64_t selectedDepthFormat,
                        const XrViewConfigurationView& viewport,
-                       uint32_t numViews) final;
+                       uint32_t numViews,
+                       bool useFoveation) final;
   igl::SurfaceTextures getSurfaceTextures(igl::IDevice& device,
                                           const XrSwapchain& colorSwapchain,
                                           const XrSwapchain& depthSwapchain,
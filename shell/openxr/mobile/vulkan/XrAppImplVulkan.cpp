@@ -26,6 +26,12 @@ std::vector<const char*> XrAppImplVulkan::getXrRequiredExtensions() const {
   };
 }
 
+std::vector<const char*> XrAppImplVulkan::getXrFoveationExtensions() const {
+  return {
+      XR_FB_FOVEATION_VULKAN_EXTENSION_NAME,
+  };
+}
+
 std::unique_ptr<igl::IDevice> XrAppImplVulkan::initIGL(XrInstance instance, XrSystemId systemId) {
   // Get the API requirements.
   PFN_xrGetVulkanGraphicsRequirementsKHR pfnGetVulkanGraphicsRequirementsKHR = NULL;
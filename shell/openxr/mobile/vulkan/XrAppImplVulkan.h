@@ -25,6 +25,7 @@ class XrSwapchainProvider;
 class XrAppImplVulkan final : public impl::XrAppImpl {
  public:
   std::vector<const char*> getXrRequiredExtensions() const override;
+  std::vector<const char*> getXrFoveationExtensions() const override;
   std::unique_ptr<igl::IDevice> initIGL(XrInstance instance, XrSystemId systemId) override;
   XrSession initXrSession(XrInstance instance, XrSystemId systemId, igl::IDevice& device) override;
   std::unique_ptr<impl::XrSwapchainProviderImpl> createSwapchainProviderImpl() const override;
@@ -25,7 +25,8 @@ void enumerateSwapchainImages(
     uint32_t numViews,
     VkImageUsageFlags usageFlags,
     VkImageAspectFlags aspectMask,
-    std::vector<std::shared_ptr<igl::vulkan::VulkanTexture>>& outVulkanTextures) {
+    std::vector<std::shared_ptr<igl::vulkan::VulkanTexture>>& outVulkanTextures,
+    std::vector<std::shared_ptr<igl::vulkan::VulkanTexture>>* outFragmentDensityMaps = nullptr) {
   uint32_t numImages = 0;
   XR_CHECK(xrEnumerateSwapchainImages(swapchain, 0, &numImages, NULL));
 
@@ -33,6 +34,13 @@ void enumerateSwapchainImages(
 
   std::vector<XrSwapchainImageVulkanKHR> images(
       numImages, {.type = XR_TYPE_SWAPCHAIN_IMAGE_VULKAN_KHR, .next = nullptr});
+  // the fragment density maps of a foveated swapchain are returned with its images
+  std::vector<XrSwapchainImageFoveationVulkanFB> foveationImages(
+      outFragmentDensityMaps ? numImages : 0,
+      {.type = XR_TYPE_SWAPCHAIN_IMAGE_FOVEATION_VULKAN_FB, .next = nullptr});
+  for (uint32_t i = 0; i < foveationImages.size(); i++) {
+    images[i].next = &foveationImages[i];
+  }
   XR_CHECK(xrEnumerateSwapchainImages(
       swapchain, numImages, &numImages, (XrSwapchainImageBaseHeader*)images.data()));
 
@@ -40,6 +48,35 @@ void enumerateSwapchainImages(
   const auto& ctx = actualDevice.getVulkanContext();
   outVulkanTextures.reserve(numImages);
 
+  for (uint32_t i = 0; i < foveationImages.size(); i++) {
+    auto image = std::make_shared<igl::vulkan::VulkanImage>(
+        ctx,
+        ctx.device_->device_,
+        foveationImages[i].image,
+        fmt::format("Image: fragment density map #{}", i).c_str(),
+        VK_IMAGE_USAGE_FRAGMENT_DENSITY_MAP_BIT_EXT,
+        true,
+        VkExtent3D{foveationImages[i].width, foveationImages[i].height, 1},
+        VK_IMAGE_TYPE_2D,
+        VK_FORMAT_R8G8_UNORM,
+        1,
+        numViews);
+    // the runtime keeps the density maps in this layout; they must never be transitioned
+    image->setImageLayout(VK_IMAGE_LAYOUT_FRAGMENT_DENSITY_MAP_OPTIMAL_EXT,
+                          VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, numViews});
+    auto imageView = image->createImageView(
+        numViews > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D,
+        VK_FORMAT_R8G8_UNORM,
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        0,
+        VK_REMAINING_MIP_LEVELS,
+        0,
+        numViews,
+        fmt::format("Image View: fragment density map #{}", i).c_str());
+    outFragmentDensityMaps->emplace_back(
+        std::make_shared<igl::vulkan::VulkanTexture>(ctx, std::move(image), std::move(imageView)));
+  }
+
   for (uint32_t i = 0; i < numImages; i++) {
     auto image = std::make_shared<igl::vulkan::VulkanImage>(
         ctx,
@@ -75,7 +112,8 @@ std::shared_ptr<igl::ITexture> getSurfaceTexture(
     uint32_t numViews,
     const std::vector<std::shared_ptr<igl::vulkan::VulkanTexture>>& vulkanTextures,
     int64_t externalTextureFormat,
-    std::vector<std::shared_ptr<igl::ITexture>>& inOutTextures) {
+    std::vector<std::shared_ptr<igl::ITexture>>& inOutTextures,
+    uint32_t* outImageIndex = nullptr) {
   uint32_t imageIndex;
   XrSwapchainImageAcquireInfo acquireInfo{XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO};
   XR_CHECK(xrAcquireSwapchainImage(swapchain, &acquireInfo, &imageIndex));
@@ -85,6 +123,9 @@ std::shared_ptr<igl::ITexture> getSurfaceTexture(
   XR_CHECK(xrWaitSwapchainImage(swapchain, &waitInfo));
 
   auto vulkanTexture = vulkanTextures[imageIndex];
+  if (outImageIndex) {
+    *outImageIndex = imageIndex;
+  }
 
   if (imageIndex >= inOutTextures.size()) {
     inOutTextures.resize((size_t)imageIndex + 1, nullptr);
@@ -120,6 +161,40 @@ std::shared_ptr<igl::ITexture> getSurfaceTexture(
 
   return inOutTextures[imageIndex];
 }
+
+std::shared_ptr<igl::ITexture> getFragmentDensityMap(
+    igl::IDevice& device,
+    uint32_t imageIndex,
+    uint32_t numViews,
+    const std::vector<std::shared_ptr<igl::vulkan::VulkanTexture>>& vulkanTextures,
+    std::vector<std::shared_ptr<igl::ITexture>>& inOutTextures) {
+  if (imageIndex >= vulkanTextures.size()) {
+    return nullptr;
+  }
+  if (imageIndex >= inOutTextures.size()) {
+    inOutTextures.resize((size_t)imageIndex + 1, nullptr);
+  }
+  // the size of a density map does not change during the lifetime of its swapchain
+  if (!inOutTextures[imageIndex]) {
+    const auto& actualDevice = static_cast<igl::vulkan::Device&>(device);
+    const VkExtent3D extent = vulkanTextures[imageIndex]->getVulkanImage().extent_;
+    const TextureDesc textureDesc =
+        numViews > 1 ? TextureDesc::new2DArray(TextureFormat::RG_UNorm8,
+                                               extent.width,
+                                               extent.height,
+                                               numViews,
+                                               TextureDesc::TextureUsageBits::Sampled,
+                                               "Fragment Density Map")
+                     : TextureDesc::new2D(TextureFormat::RG_UNorm8,
+                                          extent.width,
+                                          extent.height,
+                                          TextureDesc::TextureUsageBits::Sampled,
+                                          "Fragment Density Map");
+    inOutTextures[imageIndex] = std::make_shared<igl::vulkan::Texture>(
+        actualDevice, vulkanTextures[imageIndex], textureDesc);
+  }
+  return inOutTextures[imageIndex];
+}
 } // namespace
 
 void XrSwapchainProviderImplVulkan::enumerateImages(igl::IDevice& device,
@@ -128,7 +203,9 @@ void XrSwapchainProviderImplVulkan::enumerateImages(igl::IDevice& device,
                                                     int64_t selectedColorFormat,
                                                     int64_t selectedDepthFormat,
                                                     const XrViewConfigurationView& viewport,
-                                                    uint32_t numViews) {
+                                                    uint32_t numViews,
+                                                    bool useFoveation) {
+  const auto& ctx = static_cast<igl::vulkan::Device&>(device).getVulkanContext();
   enumerateSwapchainImages(device,
                            colorSwapchain,
                            selectedColorFormat,
@@ -136,7 +213,9 @@ void XrSwapchainProviderImplVulkan::enumerateImages(igl::IDevice& device,
                            numViews,
                            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
                            VK_IMAGE_ASPECT_COLOR_BIT,
-                           vulkanColorTextures_);
+                           vulkanColorTextures_,
+                           useFoveation && ctx.hasFragmentDensityMap() ? &vulkanFragmentDensityMaps_
+                                                                       : nullptr);
   auto vkDepthFormat = static_cast<VkFormat>(selectedDepthFormat);
   VkImageAspectFlags depthAspectFlags = 0;
   if (vulkan::VulkanImage::isDepthFormat(vkDepthFormat)) {
@@ -163,13 +242,15 @@ igl::SurfaceTextures XrSwapchainProviderImplVulkan::getSurfaceTextures(
     int64_t selectedDepthFormat,
     const XrViewConfigurationView& viewport,
     uint32_t numViews) {
+  uint32_t colorImageIndex = 0;
   auto colorTexture = getSurfaceTexture(device,
                                         colorSwapchain,
                                         viewport,
                                         numViews,
                                         vulkanColorTextures_,
                                         selectedColorFormat,
-                                        colorTextures_);
+                                        colorTextures_,
+                                        &colorImageIndex);
   auto depthTexture = getSurfaceTexture(device,
                                         depthSwapchain,
                                         viewport,
@@ -178,6 +259,12 @@ igl::SurfaceTextures XrSwapchainProviderImplVulkan::getSurfaceTextures(
                                         selectedDepthFormat,
                                         depthTextures_);
 
-  return {colorTexture, depthTexture};
+  auto fragmentDensityMap = getFragmentDensityMap(device,
+                                                  colorImageIndex,
+                                                  numViews,
+                                                  vulkanFragmentDensityMaps_,
+                                                  fragmentDensityMapTextures_);
+
+  return {colorTexture, depthTexture, fragmentDensityMap};
 }
 } // namespace igl::shell::openxr::mobile
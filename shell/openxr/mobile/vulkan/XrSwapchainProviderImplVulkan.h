@@ -30,13 +30,21 @@ class XrSwapchainProviderImplVulkan final : public impl::XrSwapchainProviderImpl
   int64_t preferredDepthFormat() const final {
     return VK_FORMAT_D24_UNORM_S8_UINT;
   }
+  int64_t preferredMotionVectorFormat() const final {
+    return VK_FORMAT_R16G16B16A16_SFLOAT;
+  }
+  // the runtime writes a fragment density map per swapchain image
+  XrSwapchainCreateFoveationFlagsFB foveationFlags() const final {
+    return XR_SWAPCHAIN_CREATE_FOVEATION_FRAGMENT_DENSITY_MAP_BIT_FB;
+  }
   void enumerateImages(igl::IDevice& device,
                        XrSwapchain colorSwapchain,
                        XrSwapchain depthSwapchain,
                        int64_t selectedColorFormat,
                        int64_t selectedDepthFormat,
                        const XrViewConfigurationView& viewport,
-                       uint32_t numViews) final;
+                       uint32_t numViews,
+                       bool useFoveation) final;
   igl::SurfaceTextures getSurfaceTextures(igl::IDevice& device,
                                           const XrSwapchain& colorSwapchain,
                                           const XrSwapchain& depthSwapchain,
@@ -48,5 +56,8 @@ class XrSwapchainProviderImplVulkan final : public impl::XrSwapchainProviderImpl
  private:
   std::vector<std::shared_ptr<igl::vulkan::VulkanTexture>> vulkanColorTextures_;
   std::vector<std::shared_ptr<igl::vulkan::VulkanTexture>> vulkanDepthTextures_;
+  // one per color swapchain image, empty unless the color swapchain is foveated
+  std::vector<std::shared_ptr<igl::vulkan::VulkanTexture>> vulkanFragmentDensityMaps_;
+  std::vector<std::shared_ptr<igl::ITexture>> fragmentDensityMapTextures_;
 };
 } // namespace igl::shell::openxr::mobile
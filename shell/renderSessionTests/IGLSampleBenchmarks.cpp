@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <shell/renderSessions/ColorSession.h>
+#include <shell/renderSessions/DrawStressSession.h>
+#include <shell/renderSessions/MRTSession.h>
+#include <shell/renderSessions/TQMultiRenderPassSession.h>
+#include <shell/renderSessions/TQSession.h>
+#include <shell/renderSessions/Textured3DCubeSession.h>
+#include <shell/shared/testShell/TestShell.h>
+
+// Benchmarks of the sample sessions. The reports are written to $IGL_BENCHMARK_OUTPUT_DIR as
+// IGLSampleBenchmarks.json and IGLSampleBenchmarks.csv when the variable is set.
+class IGLSampleBenchmarks : public igl::shell::TestShell {
+ public:
+  static void TearDownTestSuite() {
+    const char* outputDir = std::getenv("IGL_BENCHMARK_OUTPUT_DIR");
+    if (outputDir == nullptr || results_.empty()) {
+      return;
+    }
+    const std::string path = std::string(outputDir) + "/IGLSampleBenchmarks";
+    std::ofstream json(path + ".json");
+    igl::shell::writeBenchmarkJson(json, results_);
+    std::ofstream csv(path + ".csv");
+    igl::shell::writeBenchmarkCsv(csv, results_);
+    results_.clear();
+  }
+
+ protected:
+  void benchmarkDrawStress(const igl::shell::DrawStressDesc& stressDesc, const char* name) {
+    if (igl::shell::DrawStressSession::resolveUniformMode(platform_->getDevice(),
+                                                          stressDesc.uniformMode) !=
+        stressDesc.uniformMode) {
+      GTEST_SKIP() << "Uniform mode not supported by the backend";
+    }
+    igl::shell::DrawStressSession session(platform_, stressDesc);
+    benchmark(session, name);
+  }
+
+  void benchmark(igl::shell::RenderSession& session, const char* name) {
+    igl::shell::BenchmarkDesc desc;
+    desc.name = name;
+    const auto result = TestShellBase::benchmark(session, desc);
+    EXPECT_EQ(result.cpu.numSamples, desc.numFrames);
+    results_.push_back(result);
+  }
+
+ private:
+  static inline std::vector<igl::shell::BenchmarkResult> results_;
+};
+
+// A textured quad
+TEST_F(IGLSampleBenchmarks, ColorSession) {
+  igl::shell::ColorSession session(platform_);
+  benchmark(session, "ColorSession");
+}
+
+// Draw call overhead: one draw call with its own uniforms per quad
+TEST_F(IGLSampleBenchmarks, DrawStressBindUniform) {
+  igl::shell::DrawStressDesc desc;
+  desc.uniformMode = igl::shell::DrawStressUniformMode::BindUniform;
+  benchmarkDrawStress(desc, "DrawStressBindUniform");
+}
+
+TEST_F(IGLSampleBenchmarks, DrawStressBindBytes) {
+  igl::shell::DrawStressDesc desc;
+  desc.uniformMode = igl::shell::DrawStressUniformMode::BindBytes;
+  benchmarkDrawStress(desc, "DrawStressBindBytes");
+}
+
+TEST_F(IGLSampleBenchmarks, DrawStressBindBuffer) {
+  igl::shell::DrawStressDesc desc;
+  desc.uniformMode = igl::shell::DrawStressUniformMode::BindBuffer;
+  benchmarkDrawStress(desc, "DrawStressBindBuffer");
+}
+
+TEST_F(IGLSampleBenchmarks, DrawStressBindBuffer100k) {
+  igl::shell::DrawStressDesc desc;
+  desc.numDraws = 100000;
+  desc.uniformMode = igl::shell::DrawStressUniformMode::BindBuffer;
+  benchmarkDrawStress(desc, "DrawStressBindBuffer100k");
+}
+
+TEST_F(IGLSampleBenchmarks, DrawStressPushConstants) {
+  igl::shell::DrawStressDesc desc;
+  desc.uniformMode = igl::shell::DrawStressUniformMode::PushConstants;
+  benchmarkDrawStress(desc, "DrawStressPushConstants");
+}
+
+// A different texture for every draw
+TEST_F(IGLSampleBenchmarks, DrawStressTextureSwap) {
+  igl::shell::DrawStressDesc desc;
+  desc.uniformMode = igl::shell::DrawStressUniformMode::BindBuffer;
+  desc.numTextures = 16;
+  benchmarkDrawStress(desc, "DrawStressTextureSwap");
+}
+
+// A different pipeline for every draw
+TEST_F(IGLSampleBenchmarks, DrawStressPipelineSwitch) {
+  igl::shell::DrawStressDesc desc;
+  desc.uniformMode = igl::shell::DrawStressUniformMode::BindBuffer;
+  desc.numPipelines = 8;
+  benchmarkDrawStress(desc, "DrawStressPipelineSwitch");
+}
+
+// Multiple render targets
+TEST_F(IGLSampleBenchmarks, MRTSession) {
+  igl::shell::MRTSession session(platform_);
+  benchmark(session, "MRTSession");
+}
+
+// Two render passes per frame, the second one samples the target of the first one
+TEST_F(IGLSampleBenchmarks, TQMultiRenderPassSession) {
+  igl::shell::TQMultiRenderPassSession session(platform_);
+  benchmark(session, "TQMultiRenderPassSession");
+}
+
+TEST_F(IGLSampleBenchmarks, TQSession) {
+  igl::shell::TQSession session(platform_);
+  benchmark(session, "TQSession");
+}
+
+// A 3D texture and a uniform buffer uploaded every frame
+TEST_F(IGLSampleBenchmarks, Textured3DCubeSession) {
+  igl::shell::Textured3DCubeSession session(platform_);
+  benchmark(session, "Textured3DCubeSession");
+}
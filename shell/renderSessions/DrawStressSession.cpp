@@ -0,0 +1,450 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <igl/NameHandle.h>
+#include <igl/ShaderCreator.h>
+#include <shell/renderSessions/DrawStressSession.h>
+
+namespace igl {
+namespace shell {
+
+namespace {
+
+struct VertexPosUv {
+  iglu::simdtypes::float3 position;
+  iglu::simdtypes::float2 uv;
+};
+
+const VertexPosUv kVertexData[] = {
+    {{-1.0f, 1.0f, 0.0}, {0.0, 0.0}},
+    {{1.0f, 1.0f, 0.0}, {1.0, 0.0}},
+    {{-1.0f, -1.0f, 0.0}, {0.0, 1.0}},
+    {{1.0f, -1.0f, 0.0}, {1.0, 1.0}},
+};
+const uint16_t kIndexData[] = {0, 1, 2, 1, 3, 2};
+
+// Offsets of bindBuffer() into the uniform buffer are kept aligned for the strictest backend
+// (constant buffers of Metal on macOS and GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT).
+constexpr size_t kUniformBufferAlignment = 256;
+
+constexpr uint32_t kTextureSize = 4;
+
+std::string getMetalShaderSource() {
+  return R"(
+              using namespace metal;
+
+              typedef struct {
+                float4 offsetScale;
+                float4 color;
+              } DrawUniforms;
+
+              typedef struct {
+                float3 position [[attribute(0)]];
+                float2 uv [[attribute(1)]];
+              } VertexIn;
+
+              typedef struct {
+                float4 position [[position]];
+                float2 uv;
+                float4 color;
+              } VertexOut;
+
+              vertex VertexOut vertexShader(uint vid [[vertex_id]],
+                                            constant VertexIn * vertices [[buffer(1)]],
+                                            constant DrawUniforms & draw [[buffer(0)]]) {
+                VertexOut out;
+                out.position = float4(vertices[vid].position.xy * draw.offsetScale.zw +
+                                          draw.offsetScale.xy, 0.0, 1.0);
+                out.uv = vertices[vid].uv;
+                out.color = draw.color;
+                return out;
+              }
+
+              fragment float4 fragmentShader(VertexOut IN [[stage_in]],
+                                             texture2d<float> diffuseTex [[texture(0)]],
+                                             sampler linearSampler [[sampler(0)]]) {
+                return IN.color * diffuseTex.sample(linearSampler, IN.uv);
+              }
+    )";
+}
+
+std::string getOpenGLVertexShaderSource() {
+  return R"(#version 100
+                precision highp float;
+                attribute vec3 position;
+                attribute vec2 uv_in;
+                uniform vec4 offsetScale;
+                uniform vec4 color;
+
+                varying vec2 uv;
+                varying vec4 drawColor;
+
+                void main() {
+                  gl_Position = vec4(position.xy * offsetScale.zw + offsetScale.xy, 0.0, 1.0);
+                  uv = uv_in;
+                  drawColor = color;
+                })";
+}
+
+std::string getOpenGLFragmentShaderSource() {
+  return R"(#version 100
+                precision highp float;
+                uniform sampler2D inputImage;
+
+                varying vec2 uv;
+                varying vec4 drawColor;
+
+                void main() {
+                  gl_FragColor = drawColor * texture2D(inputImage, uv);
+                })";
+}
+
+std::string getVulkanVertexShaderSource(bool pushConstants) {
+  const char* drawUniforms = pushConstants ? R"(
+                layout(push_constant) uniform PushConstants {
+                  DrawUniforms draw;
+                } pc;
+
+                DrawUniforms getDrawUniforms() {
+                  return pc.draw;
+                }
+                )"
+                                           : R"(
+                layout(std430, buffer_reference) readonly buffer PerDraw {
+                  DrawUniforms draw;
+                };
+
+                DrawUniforms getDrawUniforms() {
+                  return PerDraw(getBuffer(0)).draw;
+                }
+                )";
+  return std::string(R"(
+                layout(location = 0) in vec3 position;
+                layout(location = 1) in vec2 uv_in;
+                layout(location = 0) out vec2 uv;
+                layout(location = 1) out vec4 color;
+
+                struct DrawUniforms {
+                  vec4 offsetScale;
+                  vec4 color;
+                };
+                )") + drawUniforms +
+         R"(
+                void main() {
+                  const DrawUniforms draw = getDrawUniforms();
+                  gl_Position = vec4(position.xy * draw.offsetScale.zw + draw.offsetScale.xy,
+                                     0.0, 1.0);
+                  uv = uv_in;
+                  color = draw.color;
+                }
+                )";
+}
+
+std::string getVulkanFragmentShaderSource() {
+  return R"(
+                layout(location = 0) in vec2 uv;
+                layout(location = 1) in vec4 color;
+                layout(location = 0) out vec4 out_FragColor;
+
+                void main() {
+                  out_FragColor = color * textureSample2D(0, 0, uv);
+                }
+                )";
+}
+
+std::unique_ptr<IShaderStages> getShaderStagesForBackend(IDevice& device,
+                                                         DrawStressUniformMode uniformMode) {
+  switch (device.getBackendType()) {
+  case igl::BackendType::Vulkan:
+    return igl::ShaderStagesCreator::fromModuleStringInput(
+        device,
+        getVulkanVertexShaderSource(uniformMode == DrawStressUniformMode::PushConstants).c_str(),
+        "main",
+        "",
+        getVulkanFragmentShaderSource().c_str(),
+        "main",
+        "",
+        nullptr);
+  // @fb-only
+    // @fb-only
+  case igl::BackendType::Metal:
+    return igl::ShaderStagesCreator::fromLibraryStringInput(
+        device, getMetalShaderSource().c_str(), "vertexShader", "fragmentShader", "", nullptr);
+  case igl::BackendType::OpenGL:
+    return igl::ShaderStagesCreator::fromModuleStringInput(device,
+                                                           getOpenGLVertexShaderSource().c_str(),
+                                                           "main",
+                                                           "",
+                                                           getOpenGLFragmentShaderSource().c_str(),
+                                                           "main",
+                                                           "",
+                                                           nullptr);
+  }
+  IGL_UNREACHABLE_RETURN(nullptr);
+}
+
+// A distinct tint per texture, so that swapped textures are visible
+iglu::simdtypes::float4 getTint(size_t index) {
+  const float hue = static_cast<float>(index) * 0.618034f;
+  const iglu::simdtypes::float4 tint = {0.5f + 0.5f * std::cos(6.2831853f * hue),
+                                        0.5f + 0.5f * std::cos(6.2831853f * (hue + 0.333333f)),
+                                        0.5f + 0.5f * std::cos(6.2831853f * (hue + 0.666667f)),
+                                        1.0f};
+  return tint;
+}
+
+} // namespace
+
+DrawStressUniformMode DrawStressSession::resolveUniformMode(const IDevice& device,
+                                                            DrawStressUniformMode mode) noexcept {
+  // OpenGL implements neither bindBytes() nor push constants, and its shaders here are GLSL 100
+  if (device.hasFeature(DeviceFeatures::BindUniform)) {
+    return DrawStressUniformMode::BindUniform;
+  }
+  switch (mode) {
+  case DrawStressUniformMode::BindUniform:
+    return DrawStressUniformMode::BindBuffer;
+  case DrawStressUniformMode::BindBytes:
+    return device.hasFeature(DeviceFeatures::BindBytes) ? mode : DrawStressUniformMode::BindBuffer;
+  case DrawStressUniformMode::BindBuffer:
+    return mode;
+  case DrawStressUniformMode::PushConstants:
+    // Metal reports push constants but does not implement bindPushConstants()
+    return device.getBackendType() == BackendType::Vulkan &&
+                   device.hasFeature(DeviceFeatures::PushConstants)
+               ? mode
+               : DrawStressUniformMode::BindBuffer;
+  }
+  IGL_UNREACHABLE_RETURN(DrawStressUniformMode::BindBuffer);
+}
+
+void DrawStressSession::initialize() noexcept {
+  auto& device = getPlatform().getDevice();
+
+  uniformMode_ = resolveUniformMode(device, desc_.uniformMode);
+  if (uniformMode_ != desc_.uniformMode) {
+    IGL_LOG_INFO("DrawStressSession: uniform mode %u is not supported, using %u\n",
+                 static_cast<uint32_t>(desc_.uniformMode),
+                 static_cast<uint32_t>(uniformMode_));
+  }
+
+  // Vertex & Index buffer
+  BufferDesc vbDesc =
+      BufferDesc(BufferDesc::BufferTypeBits::Vertex, kVertexData, sizeof(kVertexData));
+  vb_ = device.createBuffer(vbDesc, nullptr);
+  IGL_ASSERT(vb_ != nullptr);
+  BufferDesc ibDesc =
+      BufferDesc(BufferDesc::BufferTypeBits::Index, kIndexData, sizeof(kIndexData));
+  ib_ = device.createBuffer(ibDesc, nullptr);
+  IGL_ASSERT(ib_ != nullptr);
+
+  VertexInputStateDesc inputDesc;
+  inputDesc.numAttributes = 2;
+  inputDesc.attributes[0] = VertexAttribute(
+      1, VertexAttributeFormat::Float3, offsetof(VertexPosUv, position), "position", 0);
+  inputDesc.attributes[1] =
+      VertexAttribute(1, VertexAttributeFormat::Float2, offsetof(VertexPosUv, uv), "uv_in", 1);
+  inputDesc.numInputBindings = 1;
+  inputDesc.inputBindings[1].stride = sizeof(VertexPosUv);
+  vertexInput_ = device.createVertexInputState(inputDesc, nullptr);
+  IGL_ASSERT(vertexInput_ != nullptr);
+
+  // Sampler & Textures
+  SamplerStateDesc samplerDesc;
+  samplerDesc.minFilter = samplerDesc.magFilter = SamplerMinMagFilter::Linear;
+  sampler_ = device.createSamplerState(samplerDesc, nullptr);
+  IGL_ASSERT(sampler_ != nullptr);
+
+  const uint32_t numTextures = std::max(desc_.numTextures, 1u);
+  textures_.reserve(numTextures);
+  std::vector<uint32_t> pixels(kTextureSize * kTextureSize);
+  for (uint32_t i = 0; i != numTextures; ++i) {
+    const auto tint = getTint(i);
+    const uint32_t rgba = static_cast<uint32_t>(tint[0] * 255.0f) |
+                          static_cast<uint32_t>(tint[1] * 255.0f) << 8 |
+                          static_cast<uint32_t>(tint[2] * 255.0f) << 16 | 0xff000000u;
+    std::fill(pixels.begin(), pixels.end(), rgba);
+    const TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                                   kTextureSize,
+                                                   kTextureSize,
+                                                   TextureDesc::TextureUsageBits::Sampled,
+                                                   "DrawStressSession::textures_");
+    auto texture = device.createTexture(texDesc, nullptr);
+    IGL_ASSERT(texture != nullptr);
+    texture->upload(TextureRangeDesc::new2D(0, 0, kTextureSize, kTextureSize), pixels.data());
+    textures_.push_back(std::move(texture));
+  }
+
+  shaderStages_ = getShaderStagesForBackend(device, uniformMode_);
+  IGL_ASSERT(shaderStages_ != nullptr);
+
+  // Command queue
+  const CommandQueueDesc desc{igl::CommandQueueType::Graphics};
+  commandQueue_ = device.createCommandQueue(desc, nullptr);
+  IGL_ASSERT(commandQueue_ != nullptr);
+
+  renderPass_.colorAttachments.resize(1);
+  renderPass_.colorAttachments[0].loadAction = LoadAction::Clear;
+  renderPass_.colorAttachments[0].storeAction = StoreAction::Store;
+  renderPass_.colorAttachments[0].clearColor = device.backendDebugColor();
+  renderPass_.depthAttachment.loadAction = LoadAction::Clear;
+  renderPass_.depthAttachment.clearDepth = 1.0;
+
+  // Per-draw uniforms: a grid of quads covering the framebuffer
+  const uint32_t numDraws = desc_.numDraws;
+  const uint32_t numColumns =
+      std::max(static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(numDraws)))), 1u);
+  const float cellSize = 2.0f / static_cast<float>(numColumns);
+  drawUniforms_.resize(numDraws);
+  for (uint32_t i = 0; i != numDraws; ++i) {
+    const float x = static_cast<float>(i % numColumns) + 0.5f;
+    const float y = static_cast<float>(i / numColumns) + 0.5f;
+    const iglu::simdtypes::float4 offsetScale = {
+        -1.0f + x * cellSize, 1.0f - y * cellSize, 0.4f * cellSize, 0.4f * cellSize};
+    drawUniforms_[i].offsetScale = offsetScale;
+    drawUniforms_[i].color = getTint(numDraws - i);
+  }
+
+  if (uniformMode_ == DrawStressUniformMode::BindBuffer) {
+    uniformStride_ = (sizeof(DrawUniforms) + kUniformBufferAlignment - 1) /
+                     kUniformBufferAlignment * kUniformBufferAlignment;
+    std::vector<uint8_t> data(uniformStride_ * std::max(numDraws, 1u));
+    for (uint32_t i = 0; i != numDraws; ++i) {
+      std::memcpy(data.data() + i * uniformStride_, &drawUniforms_[i], sizeof(DrawUniforms));
+    }
+    BufferDesc ubDesc;
+    ubDesc.type = BufferDesc::BufferTypeBits::Uniform;
+    ubDesc.data = data.data();
+    ubDesc.length = data.size();
+    ubDesc.storage = ResourceStorage::Shared;
+    ubDesc.debugName = "DrawStressSession::uniformBuffer_";
+    uniformBuffer_ = device.createBuffer(ubDesc, nullptr);
+    IGL_ASSERT(uniformBuffer_ != nullptr);
+  }
+}
+
+void DrawStressSession::createPipelines() {
+  auto& device = getPlatform().getDevice();
+
+  const uint32_t numPipelines = std::max(desc_.numPipelines, 1u);
+  pipelines_.reserve(numPipelines);
+  for (uint32_t i = 0; i != numPipelines; ++i) {
+    RenderPipelineDesc graphicsDesc;
+    graphicsDesc.vertexInputState = vertexInput_;
+    graphicsDesc.shaderStages = shaderStages_;
+    graphicsDesc.targetDesc.colorAttachments.resize(1);
+    graphicsDesc.targetDesc.colorAttachments[0].textureFormat =
+        framebuffer_->getColorAttachment(0)->getProperties().format;
+    graphicsDesc.targetDesc.depthAttachmentFormat =
+        framebuffer_->getDepthAttachment()->getProperties().format;
+    graphicsDesc.fragmentUnitSamplerMap[0] = IGL_NAMEHANDLE("inputImage");
+    graphicsDesc.cullMode = igl::CullMode::Disabled;
+    // every other pipeline blends, so that consecutive pipelines differ in state and not only in
+    // identity
+    if (i % 2 != 0) {
+      auto& colorAttachment = graphicsDesc.targetDesc.colorAttachments[0];
+      colorAttachment.blendEnabled = true;
+      colorAttachment.srcRGBBlendFactor = BlendFactor::SrcAlpha;
+      colorAttachment.dstRGBBlendFactor = BlendFactor::OneMinusSrcAlpha;
+    }
+
+    auto pipeline = device.createRenderPipeline(graphicsDesc, nullptr);
+    IGL_ASSERT(pipeline != nullptr);
+
+    if (uniformMode_ == DrawStressUniformMode::BindUniform) {
+      const std::pair<const char*, size_t> uniforms[] = {
+          {"offsetScale", offsetof(DrawUniforms, offsetScale)},
+          {"color", offsetof(DrawUniforms, color)},
+      };
+      for (const auto& [name, offset] : uniforms) {
+        UniformDesc uniformDesc;
+        uniformDesc.location = pipeline->getIndexByName(name, igl::ShaderStage::Vertex);
+        uniformDesc.type = UniformType::Float4;
+        uniformDesc.offset = offset;
+        uniformDescs_.push_back(uniformDesc);
+      }
+    }
+    pipelines_.push_back(std::move(pipeline));
+  }
+}
+
+void DrawStressSession::update(igl::SurfaceTextures surfaceTextures) noexcept {
+  igl::Result ret;
+  if (framebuffer_ == nullptr) {
+    igl::FramebufferDesc framebufferDesc;
+    framebufferDesc.colorAttachments[0].texture = surfaceTextures.color;
+    framebufferDesc.depthAttachment.texture = surfaceTextures.depth;
+    framebuffer_ = getPlatform().getDevice().createFramebuffer(framebufferDesc, &ret);
+    IGL_ASSERT(ret.isOk());
+    IGL_ASSERT(framebuffer_ != nullptr);
+  } else {
+    framebuffer_->updateDrawable(surfaceTextures.color);
+  }
+
+  if (pipelines_.empty()) {
+    createPipelines();
+  }
+
+  // Command Buffers
+  const CommandBufferDesc cbDesc;
+  auto buffer = commandQueue_->createCommandBuffer(cbDesc, nullptr);
+  IGL_ASSERT(buffer != nullptr);
+  auto drawableSurface = framebuffer_->getColorAttachment(0);
+
+  // Submit commands
+  std::shared_ptr<igl::IRenderCommandEncoder> commands =
+      buffer->createRenderCommandEncoder(renderPass_, framebuffer_);
+  IGL_ASSERT(commands != nullptr);
+  if (commands) {
+    commands->bindBuffer(1, BindTarget::kVertex, vb_, 0);
+    commands->bindSamplerState(0, BindTarget::kFragment, sampler_);
+
+    const size_t numPipelines = pipelines_.size();
+    const size_t numTextures = textures_.size();
+    for (size_t i = 0; i != drawUniforms_.size(); ++i) {
+      const size_t pipelineIndex = i % numPipelines;
+      if (numPipelines > 1 || i == 0) {
+        commands->bindRenderPipelineState(pipelines_[pipelineIndex]);
+      }
+      if (numTextures > 1 || i == 0) {
+        commands->bindTexture(0, BindTarget::kFragment, textures_[i % numTextures].get());
+      }
+
+      const DrawUniforms& uniforms = drawUniforms_[i];
+      switch (uniformMode_) {
+      case DrawStressUniformMode::BindUniform:
+        commands->bindUniform(uniformDescs_[2 * pipelineIndex], &uniforms);
+        commands->bindUniform(uniformDescs_[2 * pipelineIndex + 1], &uniforms);
+        break;
+      case DrawStressUniformMode::BindBytes:
+        commands->bindBytes(0, BindTarget::kVertex, &uniforms, sizeof(uniforms));
+        break;
+      case DrawStressUniformMode::BindBuffer:
+        commands->bindBuffer(0, BindTarget::kAllGraphics, uniformBuffer_, i * uniformStride_);
+        break;
+      case DrawStressUniformMode::PushConstants:
+        commands->bindPushConstants(0, &uniforms, sizeof(uniforms));
+        break;
+      }
+
+      commands->drawIndexed(PrimitiveType::Triangle, 6, IndexFormat::UInt16, *ib_, 0);
+    }
+
+    commands->endEncoding();
+  }
+
+  buffer->present(drawableSurface);
+
+  commandQueue_->submit(*buffer);
+  RenderSession::update(surfaceTextures);
+}
+
+} // namespace shell
+} // namespace igl
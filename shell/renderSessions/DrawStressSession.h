@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/simdtypes/SimdTypes.h>
+#include <igl/IGL.h>
+#include <shell/shared/platform/Platform.h>
+#include <shell/shared/renderSession/RenderSession.h>
+
+namespace igl {
+namespace shell {
+
+/// How the per-draw uniforms of DrawStressSession reach the shaders
+enum class DrawStressUniformMode : uint8_t {
+  /// bindUniform() with the uniform locations (OpenGL)
+  BindUniform,
+  /// bindBytes() with a temporary buffer per draw (Metal)
+  BindBytes,
+  /// bindBuffer() of a single uniform buffer at a different offset per draw
+  BindBuffer,
+  /// bindPushConstants() (Vulkan)
+  PushConstants,
+};
+
+struct DrawStressDesc {
+  /// Number of quads drawn per frame, each with its own draw call and uniforms
+  uint32_t numDraws = 10000;
+  /// Falls back to BindUniform on OpenGL and to BindBuffer when the backend lacks the mode
+  DrawStressUniformMode uniformMode = DrawStressUniformMode::BindBuffer;
+  /// Textures are swapped between consecutive draws when there is more than one
+  uint32_t numTextures = 1;
+  /// Render pipelines are switched between consecutive draws when there is more than one
+  uint32_t numPipelines = 1;
+};
+
+/// Stress test of the binding and submission overhead: draws a grid of small textured quads with
+/// one draw call per quad, optionally swapping textures and pipelines between the draws.
+class DrawStressSession : public RenderSession {
+ public:
+  struct DrawUniforms {
+    /// xy: offset, zw: scale of the unit quad in clip space
+    iglu::simdtypes::float4 offsetScale;
+    iglu::simdtypes::float4 color;
+  };
+
+  DrawStressSession(std::shared_ptr<Platform> platform, DrawStressDesc desc = {}) :
+    RenderSession(std::move(platform)), desc_(desc) {}
+  void initialize() noexcept override;
+  void update(igl::SurfaceTextures surfaceTextures) noexcept override;
+
+  /// Returns the mode used on 'device' when 'mode' is requested
+  static DrawStressUniformMode resolveUniformMode(const IDevice& device,
+                                                  DrawStressUniformMode mode) noexcept;
+
+ private:
+  void createPipelines();
+
+  DrawStressDesc desc_;
+  DrawStressUniformMode uniformMode_ = DrawStressUniformMode::BindBuffer;
+  size_t uniformStride_ = 0;
+
+  std::shared_ptr<ICommandQueue> commandQueue_;
+  std::shared_ptr<IShaderStages> shaderStages_;
+  std::shared_ptr<IVertexInputState> vertexInput_;
+  std::shared_ptr<IBuffer> vb_;
+  std::shared_ptr<IBuffer> ib_;
+  /// Uniforms of all draws, 'uniformStride_' bytes apart (BindBuffer mode only)
+  std::shared_ptr<IBuffer> uniformBuffer_;
+  std::shared_ptr<ISamplerState> sampler_;
+  std::vector<std::shared_ptr<ITexture>> textures_;
+  std::vector<std::shared_ptr<IRenderPipelineState>> pipelines_;
+  std::vector<DrawUniforms> drawUniforms_;
+  std::vector<UniformDesc> uniformDescs_;
+  RenderPassDesc renderPass_;
+  std::shared_ptr<IFramebuffer> framebuffer_;
+};
+
+} // namespace shell
+} // namespace igl
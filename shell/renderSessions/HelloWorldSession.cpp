@@ -142,6 +142,7 @@ void HelloWorldSession::initialize() noexcept {
 void HelloWorldSession::update(igl::SurfaceTextures surfaceTextures) noexcept {
   FramebufferDesc framebufferDesc;
   framebufferDesc.colorAttachments[0].texture = surfaceTextures.color;
+  framebufferDesc.fragmentDensityMap = surfaceTextures.fragmentDensityMap;
 
   const auto dimensions = surfaceTextures.color->getDimensions();
   framebuffer_ = getPlatform().getDevice().createFramebuffer(framebufferDesc, nullptr);
@@ -8,9 +8,9 @@
 #include <shell/renderSessions/ResourceTrackerSession.h>
 
 #include <igl/Device.h>
+#include <igl/MemoryReportTracker.h>
 #include <igl/Texture.h>
 #include <igl/opengl/Device.h>
-#include <iglu/resource_tracker/ResourceTracker.h>
 #include <memory>
 #include <shell/shared/imageLoader/ImageLoader.h>
 
@@ -40,7 +40,8 @@ static uint16_t QUAD_IND[] = {
 void ResourceTrackerSession::initialize() noexcept {
   auto& device = getPlatform().getDevice();
   // Initialize resource tracker
-  auto rt = std::make_shared<iglu::resource_tracker::ResourceTracker>();
+  using ResourceType = igl::MemoryReportTracker::ResourceType;
+  auto rt = std::make_shared<igl::MemoryReportTracker>();
   device.setResourceTracker(rt);
 
   // Create texture desc
@@ -72,27 +73,27 @@ void ResourceTrackerSession::initialize() noexcept {
   bufDesc.length = sizeof(QUAD_IND);
 
   auto untrackedTexture = device.createTexture(texDesc, nullptr);
-  IGL_ASSERT(rt->getResourceStats(ASSETS_TAG).textureStats.count == 0);
-  IGL_ASSERT(rt->getResourceStats(ASSETS_TAG).textureStats.bytesUsedEstimate == 0);
+  IGL_ASSERT(rt->getStats(ASSETS_TAG, ResourceType::Texture).count == 0);
+  IGL_ASSERT(rt->getStats(ASSETS_TAG, ResourceType::Texture).bytes == 0);
   untrackedTexture = nullptr;
 
   rt->pushTag(ASSETS_TAG);
   if (device.getTextureFormatCapabilities(igl::TextureFormat::RGBA_ASTC_5x4) !=
       ICapabilities::TextureFormatCapabilityBits::Unsupported) {
     auto texture = device.createTexture(texDescCompressed, nullptr);
-    IGL_ASSERT(rt->getResourceStats(ASSETS_TAG).textureStats.bytesUsedEstimate ==
+    IGL_ASSERT(rt->getStats(ASSETS_TAG, ResourceType::Texture).bytes ==
                kCompressedExpectedByteCount);
   }
   if (device.getBackendType() != igl::BackendType::OpenGL ||
       static_cast<igl::opengl::Device&>(device).getContext().deviceFeatures().getGLVersion() >=
           opengl::GLVersion::v3_0_ES) {
     auto texture = device.createTexture(texDesc3D, nullptr);
-    IGL_ASSERT(rt->getResourceStats(ASSETS_TAG).textureStats.bytesUsedEstimate ==
+    IGL_ASSERT(rt->getStats(ASSETS_TAG, ResourceType::Texture).bytes ==
                k3DExpectedByteCount);
   }
   {
     auto texture = device.createTexture(texDescCube, nullptr);
-    IGL_ASSERT(rt->getResourceStats(ASSETS_TAG).textureStats.bytesUsedEstimate ==
+    IGL_ASSERT(rt->getStats(ASSETS_TAG, ResourceType::Texture).bytes ==
                kCubeExpectedByteCount);
   }
   auto texture = device.createTexture(texDesc, nullptr);
@@ -106,35 +107,37 @@ void ResourceTrackerSession::initialize() noexcept {
   auto buffer3 = device.createBuffer(bufDesc, nullptr);
   tagGuard = nullptr;
   rt->popTag();
-  IGL_ASSERT(rt->getResourceStats(ASSETS_TAG).textureStats.count == 2);
-  IGL_ASSERT(rt->getResourceStats(ASSETS_TAG).textureStats.bytesUsedEstimate ==
+  IGL_ASSERT(rt->getStats(ASSETS_TAG, ResourceType::Texture).count == 2);
+  IGL_ASSERT(rt->getStats(ASSETS_TAG, ResourceType::Texture).bytes ==
                      texDesc.numMipLevels > 1
                  ? 2 * iglExpectedByteCountWithMipmaps_
                  : 2 * iglExpectedByteCount_);
 
-  IGL_ASSERT(rt->getResourceStats(RENDER_PASS_TAG).textureStats.count == 1);
-  IGL_ASSERT(rt->getResourceStats(RENDER_PASS_TAG).textureStats.bytesUsedEstimate ==
+  IGL_ASSERT(rt->getStats(RENDER_PASS_TAG, ResourceType::Texture).count == 1);
+  IGL_ASSERT(rt->getStats(RENDER_PASS_TAG, ResourceType::Texture).bytes ==
                      texDesc.numMipLevels > 1
                  ? iglExpectedByteCountWithMipmaps_
                  : iglExpectedByteCount_);
 
-  IGL_ASSERT(rt->getResourceStats(ASSETS_TAG).bufferStats.count == 2);
-  IGL_ASSERT(rt->getResourceStats(ASSETS_TAG).bufferStats.bytesUsed == 2 * sizeof(QUAD_IND));
+  IGL_ASSERT(rt->getStats(ASSETS_TAG, ResourceType::Buffer).count == 2);
+  IGL_ASSERT(rt->getStats(ASSETS_TAG, ResourceType::Buffer).bytes == 2 * sizeof(QUAD_IND));
 
-  IGL_ASSERT(rt->getResourceStats(RENDER_PASS_TAG).bufferStats.count == 1);
-  IGL_ASSERT(rt->getResourceStats(RENDER_PASS_TAG).bufferStats.bytesUsed == sizeof(QUAD_IND));
+  IGL_ASSERT(rt->getStats(RENDER_PASS_TAG, ResourceType::Buffer).count == 1);
+  IGL_ASSERT(rt->getStats(RENDER_PASS_TAG, ResourceType::Buffer).bytes == sizeof(QUAD_IND));
 
   // Make nullptr to cause texture destructor and assert resources are removed from tracker
   texture = nullptr;
   buffer = nullptr;
-  IGL_ASSERT(rt->getResourceStats(ASSETS_TAG).textureStats.count == 1);
-  IGL_ASSERT(rt->getResourceStats(ASSETS_TAG).textureStats.bytesUsedEstimate ==
+  IGL_ASSERT(rt->getStats(ASSETS_TAG, ResourceType::Texture).count == 1);
+  IGL_ASSERT(rt->getStats(ASSETS_TAG, ResourceType::Texture).bytes ==
                      texDesc.numMipLevels > 1
                  ? iglExpectedByteCountWithMipmaps_
                  : iglExpectedByteCount_);
 
-  IGL_ASSERT(rt->getResourceStats(ASSETS_TAG).bufferStats.count == 1);
-  IGL_ASSERT(rt->getResourceStats(ASSETS_TAG).bufferStats.bytesUsed == sizeof(QUAD_IND));
+  IGL_ASSERT(rt->getStats(ASSETS_TAG, ResourceType::Buffer).count == 1);
+  IGL_ASSERT(rt->getStats(ASSETS_TAG, ResourceType::Buffer).bytes == sizeof(QUAD_IND));
+
+  IGL_LOG_INFO("%s", rt->dump().c_str());
 }
 
 void ResourceTrackerSession::update(igl::SurfaceTextures surfaceTextures) noexcept {}
@@ -132,11 +132,15 @@ void ShaderLibraryWithDataSession::createShaders(igl::IDevice& device) {
 #else
   std::string metalLibFile = "ShaderLibraryTest-macos.metallib";
 #endif
-  auto data = getPlatform().getFileLoader().loadBinaryData(metalLibFile);
+  auto data = getPlatform().getFileLoader().mapBinaryData(metalLibFile);
+  if (!data) {
+    IGL_LOG_ERROR("Failed to load %s", metalLibFile.c_str());
+    return;
+  }
 
   Result result;
   shaderStages_ = ShaderStagesCreator::fromLibraryBinaryInput(
-      device, data.data(), data.size(), "vertexShader", "fragmentShader", "", &result);
+      device, data->data(), data->size(), "vertexShader", "fragmentShader", "", &result);
   if (!result.isOk()) {
     return;
   }
@@ -11,6 +11,7 @@
 #include <igl/opengl/Device.h>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/RenderCommandEncoder.h>
+#include <shell/shared/renderSession/ShellParams.h>
 #if defined(IGL_PLATFORM_UWP)
 #include "Textured3DCubeSession.h"
 #define M_PI 3.14159265358979323846
@@ -40,18 +41,36 @@ static VertexPosUvw vertexData0[] = {
 static uint16_t indexData[] = {0, 1, 2, 1, 3, 2, 1, 4, 3, 4, 6, 3, 4, 5, 6, 5, 7, 6,
                                5, 0, 7, 0, 2, 7, 5, 4, 0, 4, 1, 0, 2, 3, 7, 3, 6, 7};
 
-static std::string getProlog(igl::IDevice& device) {
+// 'header' holds the directives which have to precede any declaration, e.g. #extension
+static std::string getProlog(igl::IDevice& device, const char* header = "") {
 #if IGL_BACKEND_OPENGL
   const auto shaderVersion = device.getShaderVersion();
   if (shaderVersion.majorVersion >= 3 || shaderVersion.minorVersion >= 30) {
     std::string prependVersionString = igl::opengl::getStringFromShaderVersion(shaderVersion);
-    prependVersionString += "\nprecision highp float;\n";
+    prependVersionString += "\n";
+    prependVersionString += header;
+    prependVersionString += "precision highp float;\n";
     return prependVersionString;
   }
 #endif // IGL_BACKEND_OPENGL
-  return "";
+  return header;
 };
 
+// VIEW_ID indexes the per view matrices of the vertex shaders. Single pass stereo draws both views
+// of the array attachments at once with OVR_multiview2 (OpenGL ES) or multiview (Vulkan).
+static const char* getOpenGLViewIdHeader(bool singlePassStereo) {
+  return singlePassStereo ? "#extension GL_OVR_multiview2 : require\n"
+                            "layout(num_views = 2) in;\n"
+                            "#define VIEW_ID int(gl_ViewID_OVR)\n"
+                          : "#define VIEW_ID 0\n";
+}
+
+static const char* getVulkanViewIdHeader(bool singlePassStereo) {
+  return singlePassStereo ? "#extension GL_EXT_multiview : require\n"
+                            "#define VIEW_ID gl_ViewIndex\n"
+                          : "#define VIEW_ID 0\n";
+}
+
 static std::string getMetalShaderSource() {
   return R"(
           #include <metal_stdlib>
@@ -59,7 +78,7 @@ static std::string getMetalShaderSource() {
           using namespace metal;
 
           struct VertexUniformBlock {
-            float4x4 mvpMatrix;
+            float4x4 mvpMatrix[2];
             float scaleZ;
           };
 
@@ -76,7 +95,7 @@ static std::string getMetalShaderSource() {
           vertex VertexOut vertexShader(VertexIn in [[stage_in]],
                  constant VertexUniformBlock &vUniform[[buffer(1)]]) {
             VertexOut out;
-            out.position = vUniform.mvpMatrix * float4(in.position, 1.0);
+            out.position = vUniform.mvpMatrix[0] * float4(in.position, 1.0);
             out.uvw = in.uvw;
             out.uvw = float3(
                          out.uvw.x, out.uvw.y, (out.uvw.z - 0.5f)*vUniform.scaleZ + 0.5f);
@@ -108,17 +127,17 @@ static std::string getOpenGLFragmentShaderSource(igl::IDevice& device) {
                       })");
 }
 
-static std::string getOpenGLVertexShaderSource(igl::IDevice& device) {
-  return getProlog(device) + R"(
+static std::string getOpenGLVertexShaderSource(igl::IDevice& device, bool singlePassStereo) {
+  return getProlog(device, getOpenGLViewIdHeader(singlePassStereo)) + R"(
                       precision highp float;
-                      uniform mat4 mvpMatrix;
+                      uniform mat4 mvpMatrix[2];
                       uniform float scaleZ;
                       in vec3 position;
                       in vec3 uvw_in;
                       out vec3 uvw;
 
                       void main() {
-                        gl_Position =  mvpMatrix * vec4(position, 1.0);
+                        gl_Position =  mvpMatrix[VIEW_ID] * vec4(position, 1.0);
                         uvw = vec3(uvw_in.x, uvw_in.y, (uvw_in.z-0.5)*scaleZ+0.5);
                       })";
 }
@@ -133,11 +152,11 @@ static const char* getVulkanFragmentShaderSource() {
                       })";
 }
 
-static const char* getVulkanVertexShaderSource() {
-  return R"(
+static std::string getVulkanVertexShaderSource(bool singlePassStereo) {
+  return getVulkanViewIdHeader(singlePassStereo) + std::string(R"(
                       precision highp float;
                       layout(std430, buffer_reference) readonly buffer PerFrame {
-                        mat4 mvpMatrix;
+                        mat4 mvpMatrix[2];
                         float scaleZ;
                       };
                       layout(location = 0) in vec3 position;
@@ -145,16 +164,20 @@ static const char* getVulkanVertexShaderSource() {
                       layout(location = 0) out vec3 uvw;
 
                       void main() {
-                        gl_Position =  PerFrame(getBuffer(1)).mvpMatrix * vec4(position, 1.0);
+                        gl_Position =
+                            PerFrame(getBuffer(1)).mvpMatrix[VIEW_ID] * vec4(position, 1.0);
                         uvw = vec3(uvw_in.x, uvw_in.y, (uvw_in.z-0.5)*PerFrame(getBuffer(1)).scaleZ+0.5);
-                      })";
+                      })");
 }
 
-static std::unique_ptr<IShaderStages> getShaderStagesForBackend(igl::IDevice& device) {
+static std::unique_ptr<IShaderStages> getShaderStagesForBackend(igl::IDevice& device,
+                                                                bool singlePassStereo) {
   switch (device.getBackendType()) {
   case igl::BackendType::Vulkan:
     return igl::ShaderStagesCreator::fromModuleStringInput(device,
-                                                           getVulkanVertexShaderSource(),
+                                                           getVulkanVertexShaderSource(
+                                                               singlePassStereo)
+                                                               .c_str(),
                                                            "main",
                                                            "",
                                                            getVulkanFragmentShaderSource(),
@@ -171,7 +194,7 @@ static std::unique_ptr<IShaderStages> getShaderStagesForBackend(igl::IDevice& de
   case igl::BackendType::OpenGL:
     return igl::ShaderStagesCreator::fromModuleStringInput(
         device,
-        getOpenGLVertexShaderSource(device).c_str(),
+        getOpenGLVertexShaderSource(device, singlePassStereo).c_str(),
         "main",
         "",
         getOpenGLFragmentShaderSource(device).c_str(),
@@ -297,7 +320,7 @@ void Textured3DCubeSession::initialize() noexcept {
   vertexInput0_ = device.createVertexInputState(inputDesc, nullptr);
 
   createSamplerAndTextures(device);
-  shaderStages_ = getShaderStagesForBackend(device);
+  shaderStages_ = getShaderStagesForBackend(device, isSinglePassStereo());
 
   // Command queue: backed by different types of GPU HW queues
   const CommandQueueDesc desc{igl::CommandQueueType::Graphics};
@@ -314,6 +337,10 @@ void Textured3DCubeSession::initialize() noexcept {
   renderPass_.depthAttachment.clearDepth = 1.0;
 }
 
+bool Textured3DCubeSession::isSinglePassStereo() const {
+  return shellParams().renderMode == RenderMode::SinglePassStereo;
+}
+
 void Textured3DCubeSession::setVertexParams(float aspectRatio) {
   // perspective projection
   float fov = 45.0f * (M_PI / 180.0f);
@@ -326,13 +353,32 @@ void Textured3DCubeSession::setVertexParams(float aspectRatio) {
   if (scaleZ <= 0.05f || scaleZ >= 1.0f) {
     ss *= -1.0f;
   }
-  glm::mat4 xform = projectionMat * glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.f, 8.0f)) *
-                    glm::rotate(glm::mat4(1.0f), -0.2f, glm::vec3(1.0f, 0.0f, 0.0f)) *
-                    glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0.0f, 1.0f, 0.0f)) *
-                    glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, 1.0f, scaleZ));
+  const glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.f, 8.0f)) *
+                          glm::rotate(glm::mat4(1.0f), -0.2f, glm::vec3(1.0f, 0.0f, 0.0f)) *
+                          glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0.0f, 1.0f, 0.0f)) *
+                          glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, 1.0f, scaleZ));
 
-  vertexParameters_.mvpMatrix = xform;
+  vertexParameters_.mvpMatrix[0] = vertexParameters_.mvpMatrix[1] = projectionMat * model;
   vertexParameters_.scaleZ = scaleZ;
+
+  if (!isSinglePassStereo() || shellParams().viewParams.size() < 2) {
+    return;
+  }
+  // The view matrices of the host are right-handed: they are mirrored to the left-handed space of
+  // the cube, which keeps the winding of its triangles
+  const glm::mat4 flipZ = glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, 1.0f, -1.0f));
+  for (size_t i = 0; i != 2; ++i) {
+    const ViewParams& viewParams = shellParams().viewParams[i];
+    const float nearZ = 0.1f;
+    const glm::mat4 viewProjection = glm::frustumLH(nearZ * tanf(viewParams.fov.angleLeft),
+                                                    nearZ * tanf(viewParams.fov.angleRight),
+                                                    nearZ * tanf(viewParams.fov.angleDown),
+                                                    nearZ * tanf(viewParams.fov.angleUp),
+                                                    nearZ,
+                                                    100.0f) *
+                                     flipZ * viewParams.viewMatrix * flipZ;
+    vertexParameters_.mvpMatrix[i] = viewProjection * model;
+  }
 }
 
 void Textured3DCubeSession::update(igl::SurfaceTextures surfaceTextures) noexcept {
@@ -349,12 +395,18 @@ void Textured3DCubeSession::update(igl::SurfaceTextures surfaceTextures) noexcep
     igl::FramebufferDesc framebufferDesc;
     framebufferDesc.colorAttachments[0].texture = surfaceTextures.color;
     framebufferDesc.depthAttachment.texture = surfaceTextures.depth;
+    framebufferDesc.fragmentDensityMap = surfaceTextures.fragmentDensityMap;
+    if (isSinglePassStereo()) {
+      // both views are drawn at once into the 2 layers of the attachments
+      framebufferDesc.mode = FramebufferMode::Stereo;
+    }
 
     framebuffer_ = getPlatform().getDevice().createFramebuffer(framebufferDesc, &ret);
     IGL_ASSERT(ret.isOk());
     IGL_ASSERT(framebuffer_ != nullptr);
   } else {
     framebuffer_->updateDrawable(surfaceTextures.color);
+    framebuffer_->updateFragmentDensityMap(surfaceTextures.fragmentDensityMap);
   }
 
   size_t textureUnit = 0;
@@ -388,7 +440,9 @@ void Textured3DCubeSession::update(igl::SurfaceTextures surfaceTextures) noexcep
   igl::UniformDesc e1;
   e1.name = "mvpMatrix";
   e1.type = igl::UniformType::Mat4x4;
+  e1.numElements = 2;
   e1.offset = offsetof(VertexFormat, mvpMatrix);
+  e1.elementStride = sizeof(glm::mat4);
 
   igl::UniformDesc e2;
   e2.name = "scaleZ";
@@ -407,8 +461,12 @@ void Textured3DCubeSession::update(igl::SurfaceTextures surfaceTextures) noexcep
   info.index = 1;
   info.length = sizeof(VertexFormat);
   info.uniforms = std::vector<igl::UniformDesc>{
-      igl::UniformDesc{
-          "mvpMatrix", -1, igl::UniformType::Mat4x4, 1, offsetof(VertexFormat, mvpMatrix), 0},
+      igl::UniformDesc{"mvpMatrix",
+                       -1,
+                       igl::UniformType::Mat4x4,
+                       2,
+                       offsetof(VertexFormat, mvpMatrix),
+                       sizeof(glm::mat4)},
       igl::UniformDesc{
           "scaleZ", -1, igl::UniformType::Float, 1, offsetof(VertexFormat, scaleZ), 0}};
 #endif
@@ -18,7 +18,8 @@ namespace igl {
 namespace shell {
 
 struct VertexFormat {
-  glm::mat4 mvpMatrix;
+  // one per view, only the first one is used unless rendering single pass stereo
+  glm::mat4 mvpMatrix[2];
   float scaleZ;
 };
 
@@ -44,6 +45,7 @@ class Textured3DCubeSession : public RenderSession {
   // utility fns
   void createSamplerAndTextures(const IDevice& /*device*/);
   void setVertexParams(float aspectRatio);
+  bool isSinglePassStereo() const;
 };
 
 } // namespace shell
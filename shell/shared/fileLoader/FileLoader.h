@@ -6,12 +6,39 @@
  */
 
 #pragma once
+#include <memory>
 #include <stdint.h>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace igl::shell {
 
+/// Read-only contents of a file, memory mapped where the platform allows it. The contents stay
+/// valid as long as the view lives and can be passed straight to IBuffer::upload() or
+/// ITexture::upload().
+class FileView {
+ public:
+  virtual ~FileView() = default;
+  [[nodiscard]] virtual const uint8_t* data() const noexcept = 0;
+  [[nodiscard]] virtual size_t size() const noexcept = 0;
+};
+
+/// FileView owning a copy of the contents
+class FileViewVector final : public FileView {
+ public:
+  explicit FileViewVector(std::vector<uint8_t> data) : data_(std::move(data)) {}
+  [[nodiscard]] const uint8_t* data() const noexcept override {
+    return data_.data();
+  }
+  [[nodiscard]] size_t size() const noexcept override {
+    return data_.size();
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
 class FileLoader {
  public:
   FileLoader() = default;
@@ -19,6 +46,15 @@ class FileLoader {
   virtual std::vector<uint8_t> loadBinaryData(const std::string& /* filename */) {
     return std::vector<uint8_t>();
   }
+  /// Maps the contents of 'filename' without copying them. Returns nullptr if the file is empty or
+  /// cannot be read. Falls back to a copy made by loadBinaryData() on platforms without mapping.
+  virtual std::unique_ptr<FileView> mapBinaryData(const std::string& filename) {
+    auto data = loadBinaryData(filename);
+    if (data.empty()) {
+      return nullptr;
+    }
+    return std::make_unique<FileViewVector>(std::move(data));
+  }
   virtual bool fileExists(const std::string& /* filename */) const {
     return false;
   }
@@ -12,6 +12,28 @@
 
 namespace igl::shell {
 
+namespace {
+
+// AASSET_MODE_BUFFER assets are memory mapped when stored uncompressed in the APK
+class FileViewAndroid final : public FileView {
+ public:
+  explicit FileViewAndroid(AAsset* asset) : asset_(asset) {}
+  ~FileViewAndroid() override {
+    AAsset_close(asset_);
+  }
+  [[nodiscard]] const uint8_t* data() const noexcept override {
+    return static_cast<const uint8_t*>(AAsset_getBuffer(asset_));
+  }
+  [[nodiscard]] size_t size() const noexcept override {
+    return static_cast<size_t>(AAsset_getLength64(asset_));
+  }
+
+ private:
+  AAsset* asset_;
+};
+
+} // namespace
+
 std::vector<uint8_t> FileLoaderAndroid::loadBinaryData(const std::string& fileName) {
   std::vector<uint8_t> data;
   if (fileName.empty()) {
@@ -30,6 +52,23 @@ std::vector<uint8_t> FileLoaderAndroid::loadBinaryData(const std::string& fileNa
   return data;
 }
 
+std::unique_ptr<FileView> FileLoaderAndroid::mapBinaryData(const std::string& fileName) {
+  if (fileName.empty()) {
+    return nullptr;
+  }
+
+  AAsset* asset = AAssetManager_open(assetManager_, fileName.c_str(), AASSET_MODE_BUFFER);
+  if (asset == nullptr) {
+    return nullptr;
+  }
+  auto view = std::make_unique<FileViewAndroid>(asset);
+  // AAsset_getBuffer() decompresses compressed assets into a buffer owned by the asset
+  if (view->data() == nullptr || view->size() == 0) {
+    return nullptr;
+  }
+  return view;
+}
+
 bool FileLoaderAndroid::fileExists(const std::string& fileName) const {
   std::vector<uint8_t> data;
   if (fileName.empty()) {
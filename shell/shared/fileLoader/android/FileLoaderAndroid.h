@@ -20,6 +20,7 @@ class FileLoaderAndroid final : public FileLoader {
   FileLoaderAndroid() = default;
   ~FileLoaderAndroid() override = default;
   std::vector<uint8_t> loadBinaryData(const std::string& fileName) override;
+  std::unique_ptr<FileView> mapBinaryData(const std::string& fileName) override;
   bool fileExists(const std::string& fileName) const override;
 
   void setAssetManager(AAssetManager* mgr) {
@@ -16,6 +16,7 @@ class FileLoaderIos final : public FileLoader {
   FileLoaderIos() = default;
   ~FileLoaderIos() override = default;
   std::vector<uint8_t> loadBinaryData(const std::string& fileName) override;
+  std::unique_ptr<FileView> mapBinaryData(const std::string& fileName) override;
   bool fileExists(const std::string& fileName) const override;
 
  private:
@@ -16,6 +16,7 @@ class FileLoaderMac final : public FileLoader {
   FileLoaderMac() = default;
   ~FileLoaderMac() override = default;
   std::vector<uint8_t> loadBinaryData(const std::string& fileName) override;
+  std::unique_ptr<FileView> mapBinaryData(const std::string& fileName) override;
   bool fileExists(const std::string& fileName) const override;
   std::string basePath() const override;
 
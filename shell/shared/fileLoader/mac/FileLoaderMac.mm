@@ -8,11 +8,37 @@
 #include <shell/shared/fileLoader/mac/FileLoaderMac.h>
 
 #import <Foundation/Foundation.h>
+#include <fcntl.h>
 #include <fstream>
 #include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace igl::shell {
 
+namespace {
+
+class FileViewMac final : public FileView {
+ public:
+  FileViewMac(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+  ~FileViewMac() override {
+    munmap(const_cast<uint8_t*>(data_), size_);
+  }
+  [[nodiscard]] const uint8_t* data() const noexcept override {
+    return data_;
+  }
+  [[nodiscard]] size_t size() const noexcept override {
+    return size_;
+  }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+};
+
+} // namespace
+
 std::vector<uint8_t> FileLoaderMac::loadBinaryData(const std::string& fileName) {
   std::vector<uint8_t> data;
   if (fileName.length() == 0) {
@@ -43,6 +69,41 @@ std::vector<uint8_t> FileLoaderMac::loadBinaryData(const std::string& fileName)
   return (data);
 }
 
+std::unique_ptr<FileView> FileLoaderMac::mapBinaryData(const std::string& fileName) {
+  if (fileName.empty()) {
+    return nullptr;
+  }
+
+  NSString* nsFileName = [NSString stringWithUTF8String:fileName.c_str()];
+  if ([nsFileName length] == 0) {
+    return nullptr;
+  }
+
+  NSString* nsPath = [[NSBundle mainBundle] pathForResource:nsFileName ofType:nil];
+  if (nsPath == nil) {
+    return nullptr;
+  }
+
+  const int fd = open([nsPath UTF8String], O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat st = {};
+  // empty files cannot be mapped
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return nullptr;
+  }
+  void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping keeps its own reference to the file
+  close(fd);
+  if (data == MAP_FAILED) {
+    return nullptr;
+  }
+  return std::make_unique<FileViewMac>(static_cast<const uint8_t*>(data),
+                                       static_cast<size_t>(st.st_size));
+}
+
 bool FileLoaderMac::fileExists(const std::string& fileName) const {
   NSString* nsFileName = [NSString stringWithUTF8String:fileName.c_str()];
   if (nsFileName == nil || [nsFileName length] == 0) {
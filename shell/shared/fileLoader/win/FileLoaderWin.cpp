@@ -10,9 +10,37 @@
 #include <fstream>
 #include <iterator>
 #include <string>
+#include <windows.h>
 
 namespace igl::shell {
 
+namespace {
+
+class FileViewWin final : public FileView {
+ public:
+  FileViewWin(HANDLE file, HANDLE mapping, const uint8_t* data, size_t size) :
+    file_(file), mapping_(mapping), data_(data), size_(size) {}
+  ~FileViewWin() override {
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_);
+    CloseHandle(file_);
+  }
+  [[nodiscard]] const uint8_t* data() const noexcept override {
+    return data_;
+  }
+  [[nodiscard]] size_t size() const noexcept override {
+    return size_;
+  }
+
+ private:
+  HANDLE file_;
+  HANDLE mapping_;
+  const uint8_t* data_;
+  size_t size_;
+};
+
+} // namespace
+
 std::vector<uint8_t> FileLoaderWin::loadBinaryData(const std::string& fileName) {
   std::vector<uint8_t> data;
   std::ifstream file(fileName, std::ios::binary);
@@ -34,6 +62,38 @@ std::vector<uint8_t> FileLoaderWin::loadBinaryData(const std::string& fileName)
   return (data);
 }
 
+std::unique_ptr<FileView> FileLoaderWin::mapBinaryData(const std::string& fileName) {
+  HANDLE file = CreateFileA(fileName.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return nullptr;
+  }
+  LARGE_INTEGER fileSize = {};
+  // empty files cannot be mapped
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+    CloseHandle(file);
+    return nullptr;
+  }
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping == nullptr) {
+    CloseHandle(file);
+    return nullptr;
+  }
+  const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (data == nullptr) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return nullptr;
+  }
+  return std::make_unique<FileViewWin>(
+      file, mapping, static_cast<const uint8_t*>(data), static_cast<size_t>(fileSize.QuadPart));
+}
+
 bool FileLoaderWin::fileExists(const std::string& fileName) const {
   std::ifstream file(fileName, std::ios::binary);
   auto exists = (file.rdstate() & std::ifstream::failbit) == 0;
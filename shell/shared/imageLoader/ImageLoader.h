@@ -7,9 +7,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <igl/IGL.h>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace igl::shell {
@@ -31,6 +35,40 @@ class ImageLoader {
   virtual ImageData loadImageData(std::string /*imageName*/) noexcept {
     return checkerboard();
   }
+  /// Decodes 'imageNames' concurrently with loadImageData() on up to 'maxThreads' worker threads
+  /// (0 uses one per hardware thread). The futures are in the order of 'imageNames'.
+  /// @remark loadImageData() has to be thread-safe, and the loader must outlive the futures.
+  std::vector<std::future<ImageData>> loadImageDataAsync(std::vector<std::string> imageNames,
+                                                         size_t maxThreads = 0) {
+    struct Batch {
+      std::vector<std::string> imageNames;
+      std::vector<std::promise<ImageData>> images;
+      std::atomic<size_t> next = 0;
+    };
+    auto batch = std::make_shared<Batch>();
+    batch->imageNames = std::move(imageNames);
+    batch->images.resize(batch->imageNames.size());
+
+    std::vector<std::future<ImageData>> futures;
+    futures.reserve(batch->images.size());
+    for (auto& image : batch->images) {
+      futures.push_back(image.get_future());
+    }
+
+    size_t numThreads =
+        maxThreads != 0 ? maxThreads : std::max(std::thread::hardware_concurrency(), 1u);
+    numThreads = std::min(numThreads, batch->imageNames.size());
+    for (size_t i = 0; i != numThreads; ++i) {
+      // the workers pull the next image until the batch is exhausted
+      std::thread([this, batch]() {
+        for (size_t index = batch->next++; index < batch->imageNames.size();
+             index = batch->next++) {
+          batch->images[index].set_value(loadImageData(batch->imageNames[index]));
+        }
+      }).detach();
+    }
+    return futures;
+  }
   void setHomePath(const std::string& homePath) {
     homePath_ = homePath;
   }
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <shell/shared/netservice/FrameStream.h>
+
+#include <igl/Common.h>
+
+namespace igl::shell::netservice {
+
+namespace {
+
+void writeU32(uint8_t* out, uint32_t value) noexcept {
+  for (size_t i = 0; i != 4; i++) {
+    out[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+void writeU64(uint8_t* out, uint64_t value) noexcept {
+  writeU32(out, static_cast<uint32_t>(value));
+  writeU32(out + 4, static_cast<uint32_t>(value >> 32));
+}
+
+uint32_t readU32(const uint8_t* in) noexcept {
+  uint32_t value = 0;
+  for (size_t i = 0; i != 4; i++) {
+    value |= static_cast<uint32_t>(in[i]) << (8 * i);
+  }
+  return value;
+}
+
+uint64_t readU64(const uint8_t* in) noexcept {
+  return readU32(in) | (static_cast<uint64_t>(readU32(in + 4)) << 32);
+}
+
+} // namespace
+
+// ----------------------------------------------------------------------------
+
+void FramePacketHeader::write(const EncodedFrame& frame, uint8_t out[kSize]) noexcept {
+  IGL_ASSERT(frame.data.size() <= kMaxPayloadSize);
+  writeU32(out, kMagic);
+  out[4] = kVersion;
+  out[5] = static_cast<uint8_t>(frame.codec);
+  out[6] = frame.keyFrame ? kFlagKeyFrame : 0;
+  out[7] = 0;
+  writeU32(out + 8, frame.width);
+  writeU32(out + 12, frame.height);
+  writeU64(out + 16, static_cast<uint64_t>(frame.timestampUs));
+  writeU32(out + 24, static_cast<uint32_t>(frame.data.size()));
+  writeU32(out + 28, 0);
+}
+
+bool FramePacketHeader::read(const uint8_t in[kSize],
+                             EncodedFrame& outFrame,
+                             uint32_t& outSize) noexcept {
+  if (readU32(in) != kMagic || in[4] != kVersion ||
+      in[5] > static_cast<uint8_t>(VideoCodec::HEVC)) {
+    return false;
+  }
+  outSize = readU32(in + 24);
+  if (outSize > kMaxPayloadSize) {
+    return false;
+  }
+  outFrame.codec = static_cast<VideoCodec>(in[5]);
+  outFrame.keyFrame = (in[6] & kFlagKeyFrame) != 0;
+  outFrame.width = readU32(in + 8);
+  outFrame.height = readU32(in + 12);
+  outFrame.timestampUs = static_cast<int64_t>(readU64(in + 16));
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+
+FrameStreamWriter::FrameStreamWriter(std::shared_ptr<OutputStream> stream, size_t maxQueuedFrames) :
+  stream_(std::move(stream)), maxQueuedFrames_(maxQueuedFrames) {
+  IGL_ASSERT(stream_);
+  IGL_ASSERT(maxQueuedFrames_ > 0);
+  stream_->setObserver([this](Stream& /*sender*/, Stream::Event event) {
+    if (event == Stream::Event::HasSpaceAvailable) {
+      flush();
+    } else if (event == Stream::Event::ErrorOccurred || event == Stream::Event::EndEncountered) {
+      numDroppedFrames_ += queue_.size();
+      queue_.clear();
+    }
+  });
+}
+
+FrameStreamWriter::~FrameStreamWriter() {
+  stream_->setObserver(nullptr);
+}
+
+void FrameStreamWriter::send(EncodedFrame frame) noexcept {
+  if (queue_.size() >= maxQueuedFrames_) {
+    // the frame being written has to be finished, the receiver would lose track of the frames
+    const size_t numKept = queue_.front().offset > 0 ? 1 : 0;
+    numDroppedFrames_ += queue_.size() - numKept;
+    queue_.erase(queue_.begin() + static_cast<ptrdiff_t>(numKept), queue_.end());
+    needsKeyFrame_ = true;
+  }
+  if (frame.keyFrame) {
+    needsKeyFrame_ = false;
+  } else if (needsKeyFrame_) {
+    // the frame refers to frames the receiver does not have
+    numDroppedFrames_++;
+    return;
+  }
+
+  PendingFrame& pending = queue_.emplace_back();
+  pending.frame = std::move(frame);
+  FramePacketHeader::write(pending.frame, pending.header);
+
+  flush();
+}
+
+void FrameStreamWriter::flush() noexcept {
+  while (!queue_.empty() && stream_->hasSpaceAvailable()) {
+    PendingFrame& pending = queue_.front();
+    const std::vector<uint8_t>& data = pending.frame.data;
+
+    const uint8_t* bytes = nullptr;
+    size_t length = 0;
+    if (pending.offset < FramePacketHeader::kSize) {
+      bytes = pending.header + pending.offset;
+      length = FramePacketHeader::kSize - pending.offset;
+    } else {
+      const size_t payloadOffset = pending.offset - FramePacketHeader::kSize;
+      bytes = data.data() + payloadOffset;
+      length = data.size() - payloadOffset;
+    }
+
+    const int numWritten = stream_->write(bytes, length);
+    if (numWritten <= 0) {
+      // errors are reported to the observer
+      return;
+    }
+    pending.offset += static_cast<size_t>(numWritten);
+    if (pending.offset == FramePacketHeader::kSize + data.size()) {
+      queue_.pop_front();
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+FrameStreamReader::FrameStreamReader(std::shared_ptr<InputStream> stream,
+                                     VideoEncoder::Callback callback) :
+  stream_(std::move(stream)), callback_(std::move(callback)) {
+  IGL_ASSERT(stream_);
+  IGL_ASSERT(callback_);
+  stream_->setObserver([this](Stream& /*sender*/, Stream::Event event) {
+    if (event == Stream::Event::HasBytesAvailable) {
+      readAvailableBytes();
+    }
+  });
+}
+
+FrameStreamReader::~FrameStreamReader() {
+  stream_->setObserver(nullptr);
+}
+
+void FrameStreamReader::readAvailableBytes() noexcept {
+  for (;;) {
+    if (headerSize_ == FramePacketHeader::kSize && payloadOffset_ == frame_.data.size()) {
+      callback_(std::move(frame_));
+      frame_ = {};
+      headerSize_ = 0;
+      payloadOffset_ = 0;
+    }
+    if (!stream_->hasBytesAvailable()) {
+      return;
+    }
+
+    if (headerSize_ < FramePacketHeader::kSize) {
+      const int numRead =
+          stream_->read(header_ + headerSize_, FramePacketHeader::kSize - headerSize_);
+      if (numRead <= 0) {
+        return;
+      }
+      headerSize_ += static_cast<size_t>(numRead);
+      if (headerSize_ == FramePacketHeader::kSize) {
+        uint32_t payloadSize = 0;
+        if (!FramePacketHeader::read(header_, frame_, payloadSize)) {
+          IGL_LOG_ERROR("FrameStreamReader: the stream does not contain frames\n");
+          stream_->close();
+          return;
+        }
+        frame_.data.resize(payloadSize);
+      }
+    } else {
+      const int numRead =
+          stream_->read(frame_.data.data() + payloadOffset_, frame_.data.size() - payloadOffset_);
+      if (numRead <= 0) {
+        return;
+      }
+      payloadOffset_ += static_cast<size_t>(numRead);
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace igl::shell::netservice
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <shell/shared/netservice/Stream.h>
+#include <vector>
+
+namespace igl {
+class ICommandBuffer;
+class ITexture;
+} // namespace igl
+
+namespace igl::shell::netservice {
+
+// ----------------------------------------------------------------------------
+
+enum class VideoCodec : uint8_t {
+  H264 = 0,
+  HEVC,
+};
+
+/// A compressed frame, as an Annex B byte stream. Key frames start with their parameter sets.
+struct EncodedFrame {
+  std::vector<uint8_t> data;
+  int64_t timestampUs = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  VideoCodec codec = VideoCodec::H264;
+  bool keyFrame = false;
+};
+
+/**
+ * @brief Compresses rendered frames with the hardware video encoder of the platform.
+ *
+ * encode() records a GPU copy of the texture into memory shared with the encoder in
+ * `commandBuffer`, outside of any render pass and before it is committed. The frame is handed to
+ * the encoder once the command buffer completes, without the CPU touching the pixels, and the
+ * encoded frame is passed to the callback later.
+ */
+class VideoEncoder {
+ public:
+  using Callback = std::function<void(EncodedFrame frame)>;
+
+  virtual ~VideoEncoder() = default;
+
+  /// Returns false if the frame was not queued, e.g. the texture format or size is not supported
+  virtual bool encode(igl::ICommandBuffer& commandBuffer,
+                      igl::ITexture& texture,
+                      int64_t timestampUs,
+                      bool forceKeyFrame) noexcept = 0;
+
+  [[nodiscard]] const Callback& callback() const noexcept {
+    return callback_;
+  }
+
+  void setCallback(Callback callback) noexcept {
+    callback_ = std::move(callback);
+  }
+
+ private:
+  Callback callback_;
+};
+
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Header preceding every frame sent by a FrameStreamWriter, little endian.
+ *
+ *  0: magic 'IGLF', 4: version, 5: codec, 6: flags, 7: reserved, 8: width, 12: height,
+ *  16: timestamp in microseconds, 24: payload size, 28: reserved
+ */
+struct FramePacketHeader {
+  static constexpr uint32_t kMagic = 0x464C4749; // 'IGLF'
+  static constexpr uint8_t kVersion = 1;
+  static constexpr size_t kSize = 32;
+  static constexpr uint8_t kFlagKeyFrame = 1;
+  static constexpr uint32_t kMaxPayloadSize = 64 * 1024 * 1024;
+
+  static void write(const EncodedFrame& frame, uint8_t out[kSize]) noexcept;
+  /// Returns false if `in` is not a header of a supported version or announces more than
+  /// kMaxPayloadSize bytes
+  static bool read(const uint8_t in[kSize], EncodedFrame& outFrame, uint32_t& outSize) noexcept;
+};
+
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Sends encoded frames over an OutputStream.
+ *
+ * Frames are written directly from their buffers, resuming partial writes when the stream has
+ * space available again. When more than `maxQueuedFrames` frames are waiting, the frames not
+ * started yet are dropped and so are the next ones until a key frame: pass needsKeyFrame() as
+ * `forceKeyFrame` to VideoEncoder::encode() so that the stream recovers with the next frame.
+ *
+ * Takes over the observer of the stream. Not thread-safe: send() must be called on the thread
+ * the stream is scheduled on.
+ */
+class FrameStreamWriter final {
+ public:
+  explicit FrameStreamWriter(std::shared_ptr<OutputStream> stream, size_t maxQueuedFrames = 3);
+  ~FrameStreamWriter();
+
+  void send(EncodedFrame frame) noexcept;
+
+  [[nodiscard]] bool needsKeyFrame() const noexcept {
+    return needsKeyFrame_;
+  }
+
+  [[nodiscard]] size_t getNumQueuedFrames() const noexcept {
+    return queue_.size();
+  }
+
+  [[nodiscard]] uint64_t getNumDroppedFrames() const noexcept {
+    return numDroppedFrames_;
+  }
+
+ private:
+  void flush() noexcept;
+
+  struct PendingFrame {
+    EncodedFrame frame;
+    uint8_t header[FramePacketHeader::kSize] = {};
+    // bytes of the header and then of the payload already written
+    size_t offset = 0;
+  };
+
+  std::shared_ptr<OutputStream> stream_;
+  size_t maxQueuedFrames_;
+  std::deque<PendingFrame> queue_;
+  bool needsKeyFrame_ = true;
+  uint64_t numDroppedFrames_ = 0;
+};
+
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Receives the frames of a FrameStreamWriter from an InputStream and passes each one to
+ * the callback once complete. Takes over the observer of the stream. The stream is closed if it
+ * does not contain frames.
+ */
+class FrameStreamReader final {
+ public:
+  FrameStreamReader(std::shared_ptr<InputStream> stream, VideoEncoder::Callback callback);
+  ~FrameStreamReader();
+
+ private:
+  void readAvailableBytes() noexcept;
+
+  std::shared_ptr<InputStream> stream_;
+  VideoEncoder::Callback callback_;
+  uint8_t header_[FramePacketHeader::kSize] = {};
+  size_t headerSize_ = 0;
+  EncodedFrame frame_;
+  size_t payloadOffset_ = 0;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace igl::shell::netservice
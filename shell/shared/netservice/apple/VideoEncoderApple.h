@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <shell/shared/netservice/FrameStream.h>
+
+#import <CoreVideo/CoreVideo.h>
+#import <VideoToolbox/VideoToolbox.h>
+
+namespace igl {
+class IDevice;
+} // namespace igl
+
+namespace igl::shell::netservice {
+
+/**
+ * @brief VideoToolbox encoder of Metal textures.
+ *
+ * Frames are blitted on the GPU into IOSurface-backed pixel buffers from the pool of the
+ * compression session, so the encoder reads them without any CPU copy. Textures must be
+ * BGRA8Unorm or BGRA8Unorm_sRGB, have the size given to initialize() and allow blits, which
+ * excludes drawables of layers with framebufferOnly set. Encoded frames are passed to the callback
+ * on the main queue, where the shell schedules its streams.
+ *
+ * The command buffers given to encode() must have completed before the encoder is destroyed.
+ */
+class VideoEncoderApple final : public VideoEncoder {
+ public:
+  struct Config {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    VideoCodec codec = VideoCodec::H264;
+    uint32_t bitRate = 8 * 1024 * 1024;
+    uint32_t frameRate = 60;
+    /// In frames. Key frames are also sent on demand, see FrameStreamWriter::needsKeyFrame()
+    uint32_t maxKeyFrameInterval = 120;
+  };
+
+  VideoEncoderApple() = default;
+  ~VideoEncoderApple() override;
+
+  /// `device` must be a Metal device
+  bool initialize(igl::IDevice& device, const Config& config) noexcept;
+
+  bool encode(igl::ICommandBuffer& commandBuffer,
+              igl::ITexture& texture,
+              int64_t timestampUs,
+              bool forceKeyFrame) noexcept override;
+
+ private:
+  static void didCompressFrame(void* outputCallbackRefCon,
+                               void* sourceFrameRefCon,
+                               OSStatus status,
+                               VTEncodeInfoFlags infoFlags,
+                               CMSampleBufferRef sampleBuffer);
+
+  Config config_;
+  VTCompressionSessionRef session_ = nullptr;
+  CVMetalTextureCacheRef textureCache_ = nullptr;
+};
+
+} // namespace igl::shell::netservice
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <shell/shared/netservice/apple/VideoEncoderApple.h>
+
+#include <igl/metal/CommandBuffer.h>
+#include <igl/metal/Device.h>
+#include <igl/metal/Texture.h>
+
+#import <Metal/Metal.h>
+#import <TargetConditionals.h>
+
+namespace igl::shell::netservice {
+
+namespace {
+
+constexpr uint8_t kStartCode[4] = {0, 0, 0, 1};
+
+OSStatus getParameterSet(CMFormatDescriptionRef format,
+                         VideoCodec codec,
+                         size_t index,
+                         const uint8_t** outParameterSet,
+                         size_t* outSize,
+                         size_t* outCount,
+                         int* outNalUnitHeaderLength) {
+  if (codec == VideoCodec::HEVC) {
+    return CMVideoFormatDescriptionGetHEVCParameterSetAtIndex(
+        format, index, outParameterSet, outSize, outCount, outNalUnitHeaderLength);
+  }
+  return CMVideoFormatDescriptionGetH264ParameterSetAtIndex(
+      format, index, outParameterSet, outSize, outCount, outNalUnitHeaderLength);
+}
+
+void appendNalUnit(std::vector<uint8_t>& data, const uint8_t* nalUnit, size_t size) {
+  data.insert(data.end(), kStartCode, kStartCode + sizeof(kStartCode));
+  data.insert(data.end(), nalUnit, nalUnit + size);
+}
+
+} // namespace
+
+VideoEncoderApple::~VideoEncoderApple() {
+  if (session_) {
+    VTCompressionSessionCompleteFrames(session_, kCMTimeInvalid);
+    VTCompressionSessionInvalidate(session_);
+    CFRelease(session_);
+  }
+  if (textureCache_) {
+    CFRelease(textureCache_);
+  }
+}
+
+bool VideoEncoderApple::initialize(igl::IDevice& device, const Config& config) noexcept {
+  IGL_ASSERT(!session_);
+  if (!IGL_VERIFY(device.getBackendType() == igl::BackendType::Metal)) {
+    return false;
+  }
+  config_ = config;
+
+  // IOSurface-backed pixel buffers can be rendered to by Metal and read by the encoder in place
+  NSDictionary* pixelBufferAttributes = @{
+    (id)kCVPixelBufferPixelFormatTypeKey : @(kCVPixelFormatType_32BGRA),
+    (id)kCVPixelBufferWidthKey : @(config.width),
+    (id)kCVPixelBufferHeightKey : @(config.height),
+    (id)kCVPixelBufferIOSurfacePropertiesKey : @{},
+    (id)kCVPixelBufferMetalCompatibilityKey : @YES,
+  };
+#if TARGET_OS_OSX
+  NSDictionary* encoderSpecification = @{
+    (id)kVTVideoEncoderSpecification_EnableHardwareAcceleratedVideoEncoder : @YES,
+  };
+#else
+  // always hardware accelerated
+  NSDictionary* encoderSpecification = nil;
+#endif
+  OSStatus status = VTCompressionSessionCreate(kCFAllocatorDefault,
+                                               static_cast<int32_t>(config.width),
+                                               static_cast<int32_t>(config.height),
+                                               config.codec == VideoCodec::HEVC
+                                                   ? kCMVideoCodecType_HEVC
+                                                   : kCMVideoCodecType_H264,
+                                               (__bridge CFDictionaryRef)encoderSpecification,
+                                               (__bridge CFDictionaryRef)pixelBufferAttributes,
+                                               kCFAllocatorDefault,
+                                               &didCompressFrame,
+                                               this,
+                                               &session_);
+  if (status != noErr) {
+    IGL_LOG_ERROR("VTCompressionSessionCreate() failed (%d)\n", static_cast<int>(status));
+    session_ = nullptr;
+    return false;
+  }
+
+  // frames are sent as soon as they are encoded: no B-frames, which would delay them
+  VTSessionSetProperty(session_, kVTCompressionPropertyKey_RealTime, kCFBooleanTrue);
+  VTSessionSetProperty(session_, kVTCompressionPropertyKey_AllowFrameReordering, kCFBooleanFalse);
+  VTSessionSetProperty(session_,
+                       kVTCompressionPropertyKey_ProfileLevel,
+                       config.codec == VideoCodec::HEVC ? kVTProfileLevel_HEVC_Main_AutoLevel
+                                                        : kVTProfileLevel_H264_High_AutoLevel);
+  VTSessionSetProperty(
+      session_, kVTCompressionPropertyKey_AverageBitRate, (__bridge CFNumberRef) @(config.bitRate));
+  VTSessionSetProperty(session_,
+                       kVTCompressionPropertyKey_ExpectedFrameRate,
+                       (__bridge CFNumberRef) @(config.frameRate));
+  VTSessionSetProperty(session_,
+                       kVTCompressionPropertyKey_MaxKeyFrameInterval,
+                       (__bridge CFNumberRef) @(config.maxKeyFrameInterval));
+  VTCompressionSessionPrepareToEncodeFrames(session_);
+
+  id<MTLDevice> mtlDevice = static_cast<igl::metal::Device&>(device).get();
+  if (CVMetalTextureCacheCreate(kCFAllocatorDefault, nil, mtlDevice, nil, &textureCache_) !=
+      kCVReturnSuccess) {
+    IGL_LOG_ERROR("CVMetalTextureCacheCreate() failed\n");
+    textureCache_ = nullptr;
+    return false;
+  }
+  return true;
+}
+
+bool VideoEncoderApple::encode(igl::ICommandBuffer& commandBuffer,
+                               igl::ITexture& texture,
+                               int64_t timestampUs,
+                               bool forceKeyFrame) noexcept {
+  IGL_ASSERT(session_ && textureCache_);
+  const auto dimensions = texture.getDimensions();
+  if (!igl::isTextureFormatBGR(texture.getFormat()) || dimensions.width != config_.width ||
+      dimensions.height != config_.height) {
+    IGL_LOG_ERROR_ONCE("VideoEncoderApple: only %ux%u BGRA textures can be encoded\n",
+                       config_.width,
+                       config_.height);
+    return false;
+  }
+
+  CVPixelBufferPoolRef pool = VTCompressionSessionGetPixelBufferPool(session_);
+  CVPixelBufferRef pixelBuffer = nullptr;
+  if (!pool ||
+      CVPixelBufferPoolCreatePixelBuffer(kCFAllocatorDefault, pool, &pixelBuffer) !=
+          kCVReturnSuccess) {
+    return false;
+  }
+  id<MTLTexture> srcTexture = static_cast<igl::metal::Texture&>(texture).get();
+  CVMetalTextureRef cvTexture = nullptr;
+  if (CVMetalTextureCacheCreateTextureFromImage(kCFAllocatorDefault,
+                                                textureCache_,
+                                                pixelBuffer,
+                                                nil,
+                                                srcTexture.pixelFormat,
+                                                config_.width,
+                                                config_.height,
+                                                0,
+                                                &cvTexture) != kCVReturnSuccess) {
+    CVPixelBufferRelease(pixelBuffer);
+    return false;
+  }
+
+  id<MTLCommandBuffer> mtlCommandBuffer =
+      static_cast<igl::metal::CommandBuffer&>(commandBuffer).get();
+  id<MTLBlitCommandEncoder> blitEncoder = [mtlCommandBuffer blitCommandEncoder];
+  [blitEncoder copyFromTexture:srcTexture
+                   sourceSlice:0
+                   sourceLevel:0
+                  sourceOrigin:MTLOriginMake(0, 0, 0)
+                    sourceSize:MTLSizeMake(config_.width, config_.height, 1)
+                     toTexture:CVMetalTextureGetTexture(cvTexture)
+              destinationSlice:0
+              destinationLevel:0
+             destinationOrigin:MTLOriginMake(0, 0, 0)];
+  [blitEncoder endEncoding];
+
+  NSDictionary* frameProperties =
+      forceKeyFrame ? @{(id)kVTEncodeFrameOptionKey_ForceKeyFrame : @YES} : nil;
+  VTCompressionSessionRef session = session_;
+  CFRetain(session);
+  [mtlCommandBuffer addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
+    if (buffer.status == MTLCommandBufferStatusCompleted) {
+      VTCompressionSessionEncodeFrame(session,
+                                      pixelBuffer,
+                                      CMTimeMake(timestampUs, 1000000),
+                                      kCMTimeInvalid,
+                                      (__bridge CFDictionaryRef)frameProperties,
+                                      nullptr,
+                                      nullptr);
+    }
+    CFRelease(cvTexture);
+    CVPixelBufferRelease(pixelBuffer);
+    CFRelease(session);
+  }];
+  return true;
+}
+
+void VideoEncoderApple::didCompressFrame(void* outputCallbackRefCon,
+                                         void* /*sourceFrameRefCon*/,
+                                         OSStatus status,
+                                         VTEncodeInfoFlags infoFlags,
+                                         CMSampleBufferRef sampleBuffer) {
+  if (status != noErr) {
+    IGL_LOG_ERROR("VideoEncoderApple: encoding failed (%d)\n", static_cast<int>(status));
+    return;
+  }
+  if (!sampleBuffer || (infoFlags & kVTEncodeInfo_FrameDropped) != 0) {
+    return;
+  }
+  const auto* encoder = static_cast<const VideoEncoderApple*>(outputCallbackRefCon);
+  const VideoEncoder::Callback callback = encoder->callback();
+  if (!callback) {
+    return;
+  }
+
+  auto frame = std::make_shared<EncodedFrame>();
+  frame->codec = encoder->config_.codec;
+  frame->width = encoder->config_.width;
+  frame->height = encoder->config_.height;
+  const CMTime timestamp = CMSampleBufferGetPresentationTimeStamp(sampleBuffer);
+  frame->timestampUs = CMTimeConvertScale(timestamp, 1000000, kCMTimeRoundingMethod_Default).value;
+  frame->keyFrame = true;
+  CFArrayRef attachments = CMSampleBufferGetSampleAttachmentsArray(sampleBuffer, false);
+  if (attachments && CFArrayGetCount(attachments) > 0) {
+    auto attachment = static_cast<CFDictionaryRef>(CFArrayGetValueAtIndex(attachments, 0));
+    frame->keyFrame = !CFDictionaryContainsKey(attachment, kCMSampleAttachmentKey_NotSync);
+  }
+
+  // VideoToolbox prefixes NAL units with their length, the stream separates them by start codes
+  CMFormatDescriptionRef format = CMSampleBufferGetFormatDescription(sampleBuffer);
+  size_t numParameterSets = 0;
+  int nalUnitHeaderLength = 0;
+  if (getParameterSet(format,
+                      frame->codec,
+                      0,
+                      nullptr,
+                      nullptr,
+                      &numParameterSets,
+                      &nalUnitHeaderLength) != noErr) {
+    return;
+  }
+  if (frame->keyFrame) {
+    for (size_t i = 0; i != numParameterSets; i++) {
+      const uint8_t* parameterSet = nullptr;
+      size_t size = 0;
+      if (getParameterSet(format, frame->codec, i, &parameterSet, &size, nullptr, nullptr) ==
+          noErr) {
+        appendNalUnit(frame->data, parameterSet, size);
+      }
+    }
+  }
+
+  CMBlockBufferRef blockBuffer = CMSampleBufferGetDataBuffer(sampleBuffer);
+  const size_t length = CMBlockBufferGetDataLength(blockBuffer);
+  std::vector<uint8_t> nonContiguousBytes;
+  char* bytes = nullptr;
+  if (CMBlockBufferIsRangeContiguous(blockBuffer, 0, length)) {
+    CMBlockBufferGetDataPointer(blockBuffer, 0, nullptr, nullptr, &bytes);
+  } else {
+    nonContiguousBytes.resize(length);
+    CMBlockBufferCopyDataBytes(blockBuffer, 0, length, nonContiguousBytes.data());
+    bytes = reinterpret_cast<char*>(nonContiguousBytes.data());
+  }
+
+  frame->data.reserve(frame->data.size() + length);
+  const auto* data = reinterpret_cast<const uint8_t*>(bytes);
+  const auto headerLength = static_cast<size_t>(nalUnitHeaderLength);
+  size_t offset = 0;
+  while (offset + headerLength <= length) {
+    size_t nalUnitLength = 0;
+    for (size_t i = 0; i != headerLength; i++) {
+      nalUnitLength = (nalUnitLength << 8) | data[offset + i];
+    }
+    offset += headerLength;
+    if (nalUnitLength > length - offset) {
+      break;
+    }
+    appendNalUnit(frame->data, data + offset, nalUnitLength);
+    offset += nalUnitLength;
+  }
+
+  dispatch_async(dispatch_get_main_queue(), ^{
+    callback(std::move(*frame));
+  });
+}
+
+} // namespace igl::shell::netservice
@@ -25,7 +25,26 @@ InputDispatcher& Platform::getInputDispatcher() noexcept {
 std::shared_ptr<ITexture> Platform::loadTexture(const char* filename,
                                                 igl::TextureFormat format,
                                                 igl::TextureDesc::TextureUsageBits usage) {
-  auto imageData = getImageLoader().loadImageData(filename);
+  return createTexture(getImageLoader().loadImageData(filename), format, usage);
+}
+
+std::vector<std::shared_ptr<ITexture>> Platform::loadTextures(
+    const std::vector<std::string>& filenames,
+    igl::TextureFormat format,
+    igl::TextureDesc::TextureUsageBits usage) {
+  auto images = getImageLoader().loadImageDataAsync(filenames);
+
+  std::vector<std::shared_ptr<ITexture>> textures;
+  textures.reserve(images.size());
+  for (auto& image : images) {
+    textures.push_back(createTexture(image.get(), format, usage));
+  }
+  return textures;
+}
+
+std::shared_ptr<ITexture> Platform::createTexture(const ImageData& imageData,
+                                                  igl::TextureFormat format,
+                                                  igl::TextureDesc::TextureUsageBits usage) {
   igl::TextureDesc texDesc =
       igl::TextureDesc::new2D(format, imageData.width, imageData.height, usage);
   texDesc.numMipLevels = igl::TextureDesc::calcNumMipLevels(texDesc.width, texDesc.height);
@@ -11,6 +11,8 @@
 #include <memory>
 #include <shell/shared/extension/ExtensionLoader.h>
 #include <shell/shared/input/InputDispatcher.h>
+#include <string>
+#include <vector>
 
 namespace igl {
 class IDevice;
@@ -22,6 +24,7 @@ class Extension;
 class FileLoader;
 class ImageLoader;
 class ImageWriter;
+struct ImageData;
 
 class DisplayContext {
  public:
@@ -46,6 +49,12 @@ class Platform {
       const char* filename,
       igl::TextureFormat format = igl::TextureFormat::RGBA_SRGB,
       igl::TextureDesc::TextureUsageBits usage = igl::TextureDesc::TextureUsageBits::Sampled);
+  // Decodes the images in parallel, see ImageLoader::loadImageDataAsync(). The textures are
+  // uploaded on the calling thread while the remaining images are being decoded.
+  std::vector<std::shared_ptr<ITexture>> loadTextures(
+      const std::vector<std::string>& filenames,
+      igl::TextureFormat format = igl::TextureFormat::RGBA_SRGB,
+      igl::TextureDesc::TextureUsageBits usage = igl::TextureDesc::TextureUsageBits::Sampled);
 
  public:
   Extension* createAndInitializeExtension(const char* name) noexcept;
@@ -65,6 +74,10 @@ class Platform {
   }
 
  private:
+  std::shared_ptr<ITexture> createTexture(const ImageData& imageData,
+                                          igl::TextureFormat format,
+                                          igl::TextureDesc::TextureUsageBits usage);
+
   ExtensionLoader extensionLoader_;
   InputDispatcher inputDispatcher_;
   DisplayContext displayContext_;
@@ -17,5 +17,8 @@ struct AppParams {
   DepthParams depthParams;
   ScreenshotTestsParams screenshotTestsParams;
   bool exitRequested = false;
+  // The session renders motion vectors in RenderSession::updateMotionVectors() so that the host
+  // can extrapolate frames, e.g. OpenXR Application SpaceWarp. May change at any time.
+  bool renderMotionVectors = false;
 };
 } // namespace igl::shell
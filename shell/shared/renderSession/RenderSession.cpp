@@ -48,6 +48,12 @@ AppParams& RenderSession::appParamsRef() noexcept {
   return *appParams_;
 }
 
+void RenderSession::latchViewParams() const noexcept {
+  if (shellParams_ && shellParams_->latchViewParams) {
+    shellParams_->latchViewParams();
+  }
+}
+
 Platform& RenderSession::getPlatform() noexcept {
   return *platform_;
 }
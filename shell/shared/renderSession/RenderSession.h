@@ -28,6 +28,13 @@ class RenderSession {
   virtual void initialize() noexcept {}
   // NOLINTNEXTLINE(performance-unnecessary-value-param)
   virtual void update(igl::SurfaceTextures surfaceTextures) noexcept;
+  /// @brief Renders the motion vectors of the frame rendered by the last update() into
+  /// 'surfaceTextures'. Called only when both ShellParams::motionVectorsSupported and
+  /// AppParams::renderMotionVectors are set.
+  /// @remark color receives the per-pixel motion in normalized device coordinates from the
+  /// previous frame to this one (xyz, RGBA16F), depth the depth of the moving geometry.
+  // NOLINTNEXTLINE(performance-unnecessary-value-param)
+  virtual void updateMotionVectors(igl::SurfaceTextures /*surfaceTextures*/) noexcept {}
   virtual void dispose() noexcept {}
 
   void updateDisplayScale(float scale) noexcept;
@@ -50,6 +57,11 @@ class RenderSession {
 
   AppParams& appParamsRef() noexcept;
 
+  /// @brief Updates ShellParams::lateLatchedViewBuffer and viewParams with the latest poses
+  /// predicted by the host, if it supports late latching.
+  /// @remark Call right before submitting the command buffers which read the buffer.
+  void latchViewParams() const noexcept;
+
   std::shared_ptr<IFramebuffer> framebuffer_;
   std::shared_ptr<ICommandQueue> commandQueue_;
 
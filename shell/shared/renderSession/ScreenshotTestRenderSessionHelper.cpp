@@ -7,6 +7,8 @@
 
 #include <shell/shared/renderSession/ScreenshotTestRenderSessionHelper.h>
 
+#include <IGLU/texture_accessor/TextureAccessorFactory.h>
+#include <algorithm>
 #include <cstdlib>
 #include <shell/shared/imageWriter/ImageWriter.h>
 #include <shell/shared/renderSession/AppParams.h>
@@ -14,31 +16,24 @@
 
 namespace igl::shell {
 namespace {
-void SaveFrameBufferToPng(const char* absoluteFilename,
-                          const std::shared_ptr<IFramebuffer>& framebuffer,
-                          Platform& platform) {
-  igl::Result ret;
-  auto drawableSurface = framebuffer->getColorAttachment(0);
-  auto frameBuffersize = drawableSurface->getSize();
-  int const bytesPerPixel = 4;
-  auto bytesPerRow = frameBuffersize.width * bytesPerPixel;
-  const auto rangeDesc =
-      TextureRangeDesc::new2D(0, 0, frameBuffersize.width, frameBuffersize.height);
-  igl::shell::ImageData imageData;
-  imageData.width = frameBuffersize.width;
-  imageData.height = frameBuffersize.height;
-  imageData.bytesPerRow = bytesPerRow;
-  imageData.buffer.resize(frameBuffersize.width * frameBuffersize.height * bytesPerPixel);
-
-  const CommandQueueDesc desc{igl::CommandQueueType::Graphics};
-  auto commandQueue = platform.getDevice().createCommandQueue(desc, nullptr);
-  framebuffer->copyBytesColorAttachment(*commandQueue, 0, imageData.buffer.data(), rangeDesc);
-
-  IGLLog(IGLLogLevel::LOG_INFO, "Writing screenshot to: %s", absoluteFilename);
-  platform.getImageWriter().writeImage(absoluteFilename, imageData);
+// "out.png" -> "out_12.png"
+std::string getFramePath(const std::string& path, int frame) {
+  const size_t separator = path.find_last_of("/\\");
+  const size_t extension = path.find_last_of('.');
+  const size_t pos = extension != std::string::npos &&
+                             (separator == std::string::npos || extension > separator)
+                         ? extension
+                         : path.size();
+  return path.substr(0, pos) + "_" + std::to_string(frame) + path.substr(pos);
 }
 } // namespace
 
+ScreenshotTestRenderSessionHelper::ScreenshotTestRenderSessionHelper() = default;
+
+ScreenshotTestRenderSessionHelper::~ScreenshotTestRenderSessionHelper() {
+  dispose();
+}
+
 void ScreenshotTestRenderSessionHelper::initialize(AppParams& appParams) noexcept {
   const char* screenshotTestsOutPath = std::getenv("SCREENSHOT_TESTS_OUT");
   const char* screenshotTestsFrame = std::getenv("SCREENSHOT_TESTS_FRAME");
@@ -51,26 +46,33 @@ void ScreenshotTestRenderSessionHelper::initialize(AppParams& appParams) noexcep
     int frameCount = atoi(screenshotTestsFrame);
     appParams.screenshotTestsParams.outputPath_ = screenshotTestsOutPath;
     appParams.screenshotTestsParams.frameToCapture_ = frameCount;
+    if (const char* numFrames = std::getenv("SCREENSHOT_TESTS_FRAME_COUNT")) {
+      appParams.screenshotTestsParams.numFramesToCapture_ = std::max(atoi(numFrames), 1);
+    }
   }
 }
 
 bool ScreenshotTestRenderSessionHelper::update(const AppParams& appParams,
-                                               const ShellParams& shellParams,
+                                               const ShellParams& /*shellParams*/,
                                                const igl::SurfaceTextures& surfaceTextures,
                                                Platform& platform) {
-  const std::string& screenshotTestsOutPath = appParams.screenshotTestsParams.outputPath_;
-  if (!screenshotTestsOutPath.empty()) {
-    int frameCount = appParams.screenshotTestsParams.frameToCapture_;
-    if (frameTicked_ == frameCount) {
-      IGLLog(IGLLogLevel::LOG_INFO,
-             "[screenshot test] Saving Screenshot %s",
-             screenshotTestsOutPath.c_str());
-      igl::FramebufferDesc framebufferDesc;
-      framebufferDesc.colorAttachments[0].texture = surfaceTextures.color;
-      framebufferDesc.depthAttachment.texture = surfaceTextures.depth;
-      igl::Result ret;
-      auto framebuffer = platform.getDevice().createFramebuffer(framebufferDesc, &ret);
-      SaveFrameBufferToPng(screenshotTestsOutPath.c_str(), framebuffer, platform);
+  const ScreenshotTestsParams& params = appParams.screenshotTestsParams;
+  if (!params.isScreenshotTestsEnabled()) {
+    ++frameTicked_;
+    return false;
+  }
+
+  retireCaptures(false);
+
+  const int lastFrame = params.frameToCapture_ + params.numFramesToCapture_ - 1;
+  if (frameTicked_ >= params.frameToCapture_ && frameTicked_ <= lastFrame) {
+    std::string path = params.numFramesToCapture_ > 1
+                           ? getFramePath(params.outputPath_, frameTicked_)
+                           : params.outputPath_;
+    IGLLog(IGLLogLevel::LOG_INFO, "[screenshot test] Saving Screenshot %s", path.c_str());
+    requestCapture(std::move(path), surfaceTextures.color, platform);
+    if (frameTicked_ == lastFrame) {
+      dispose();
       return true;
     }
   }
@@ -78,4 +80,99 @@ bool ScreenshotTestRenderSessionHelper::update(const AppParams& appParams,
   return false;
 }
 
+void ScreenshotTestRenderSessionHelper::dispose() noexcept {
+  retireCaptures(true);
+  if (writerThread_.joinable()) {
+    {
+      const std::lock_guard<std::mutex> lock(writeMutex_);
+      stopWriter_ = true;
+    }
+    writeCondition_.notify_one();
+    writerThread_.join();
+    stopWriter_ = false;
+  }
+}
+
+void ScreenshotTestRenderSessionHelper::requestCapture(std::string path,
+                                                       const std::shared_ptr<ITexture>& texture,
+                                                       Platform& platform) {
+  if (!IGL_VERIFY(texture)) {
+    return;
+  }
+  auto& device = platform.getDevice();
+  if (!commandQueue_) {
+    const CommandQueueDesc desc{igl::CommandQueueType::Graphics};
+    commandQueue_ = device.createCommandQueue(desc, nullptr);
+  }
+  if (!writerThread_.joinable()) {
+    imageWriter_ = &platform.getImageWriter();
+    writerThread_ = std::thread([this]() { writerThreadMain(); });
+  }
+
+  // the slots are used round-robin, so the next one is either free or holds the oldest capture
+  Capture& capture = captures_[nextCapture_];
+  nextCapture_ = (nextCapture_ + 1) % kMaxInFlightCaptures;
+  if (capture.inFlight) {
+    retireCapture(capture);
+  }
+
+  const Size size = texture->getSize();
+  if (!capture.accessor || capture.size.width != size.width ||
+      capture.size.height != size.height) {
+    // the accessors read back textures of a single size
+    capture.accessor = iglu::textureaccessor::TextureAccessorFactory::createTextureAccessor(
+        device.getBackendType(), texture, device);
+    capture.size = size;
+  }
+  capture.accessor->requestBytes(*commandQueue_, texture);
+  capture.path = std::move(path);
+  capture.inFlight = true;
+}
+
+void ScreenshotTestRenderSessionHelper::retireCaptures(bool waitAll) {
+  for (size_t i = 0; i != kMaxInFlightCaptures; ++i) {
+    // oldest first
+    Capture& capture = captures_[(nextCapture_ + i) % kMaxInFlightCaptures];
+    if (capture.inFlight &&
+        (waitAll ||
+         capture.accessor->getRequestStatus() == iglu::textureaccessor::RequestStatus::Ready)) {
+      retireCapture(capture);
+    }
+  }
+}
+
+void ScreenshotTestRenderSessionHelper::retireCapture(Capture& capture) {
+  WriteJob job;
+  job.path = std::move(capture.path);
+  job.imageData.width = static_cast<uint32_t>(capture.size.width);
+  job.imageData.height = static_cast<uint32_t>(capture.size.height);
+  job.imageData.bitsPerComponent = 8;
+  job.imageData.bytesPerRow = job.imageData.width * 4;
+  // waits for the readback if it is still in progress
+  job.imageData.buffer = capture.accessor->getBytes();
+  capture.inFlight = false;
+  {
+    const std::lock_guard<std::mutex> lock(writeMutex_);
+    writeQueue_.push_back(std::move(job));
+  }
+  writeCondition_.notify_one();
+}
+
+void ScreenshotTestRenderSessionHelper::writerThreadMain() {
+  std::unique_lock<std::mutex> lock(writeMutex_);
+  while (true) {
+    writeCondition_.wait(lock, [this]() { return stopWriter_ || !writeQueue_.empty(); });
+    if (writeQueue_.empty()) {
+      // stopped and drained
+      return;
+    }
+    WriteJob job = std::move(writeQueue_.front());
+    writeQueue_.pop_front();
+    lock.unlock();
+    IGLLog(IGLLogLevel::LOG_INFO, "Writing screenshot to: %s", job.path.c_str());
+    imageWriter_->writeImage(job.path, job.imageData);
+    lock.lock();
+  }
+}
+
 } // namespace igl::shell
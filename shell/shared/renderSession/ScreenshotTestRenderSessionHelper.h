@@ -7,31 +7,81 @@
 
 #pragma once
 
+#include <shell/shared/imageLoader/ImageLoader.h>
 #include <shell/shared/platform/Platform.h>
 
+#include <array>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 
 namespace igl {
+class ICommandQueue;
 class ITexture;
 } // namespace igl
 
+namespace iglu::textureaccessor {
+class ITextureAccessor;
+} // namespace iglu::textureaccessor
+
 namespace igl::shell {
 struct AppParams;
 struct ShellParams;
 
+// Captures the frames requested by ScreenshotTestsParams. The readbacks are asynchronous: up to
+// kMaxInFlightCaptures frames are read back while the next ones render, and the images are written
+// on a worker thread.
 class ScreenshotTestRenderSessionHelper {
  public:
-  ScreenshotTestRenderSessionHelper() = default;
+  ScreenshotTestRenderSessionHelper();
+  ~ScreenshotTestRenderSessionHelper();
 
   void initialize(AppParams& appParams) noexcept;
   bool update(const AppParams& appParams,
               const ShellParams& shellParams,
               const igl::SurfaceTextures& surfaceTextures,
               Platform& platform);
-  void dispose() noexcept {}
+  // Waits for the pending captures to be written
+  void dispose() noexcept;
 
  private:
+  static constexpr size_t kMaxInFlightCaptures = 3;
+
+  struct Capture {
+    std::unique_ptr<iglu::textureaccessor::ITextureAccessor> accessor;
+    Size size;
+    std::string path;
+    bool inFlight = false;
+  };
+
+  struct WriteJob {
+    std::string path;
+    ImageData imageData;
+  };
+
+  void requestCapture(std::string path,
+                      const std::shared_ptr<ITexture>& texture,
+                      Platform& platform);
+  // Hands the captures read back by the GPU to the writer thread. Waits for all the captures in
+  // flight when 'waitAll' is set.
+  void retireCaptures(bool waitAll);
+  void retireCapture(Capture& capture);
+  void writerThreadMain();
+
   int frameTicked_ = 0;
+  std::shared_ptr<ICommandQueue> commandQueue_;
+  std::array<Capture, kMaxInFlightCaptures> captures_;
+  size_t nextCapture_ = 0;
+
+  const ImageWriter* imageWriter_ = nullptr;
+  std::thread writerThread_;
+  std::mutex writeMutex_;
+  std::condition_variable writeCondition_;
+  std::deque<WriteJob> writeQueue_;
+  bool stopWriter_ = false;
 };
 
 } // namespace igl::shell
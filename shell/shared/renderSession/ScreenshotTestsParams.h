@@ -12,6 +12,9 @@ namespace igl::shell {
 struct ScreenshotTestsParams {
   std::string outputPath_;
   int frameToCapture_ = 0;
+  // Consecutive frames captured from frameToCapture_ on. With more than one frame, the frame number
+  // is appended to the file name of outputPath_, e.g. "out.png" becomes "out_12.png".
+  int numFramesToCapture_ = 1;
   bool isScreenshotTestsEnabled() const {
     return !outputPath_.empty();
   }
@@ -7,12 +7,18 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include <igl/TextureFormat.h>
 #include <shell/shared/renderSession/RenderMode.h>
 #include <shell/shared/renderSession/ViewParams.h>
 
+namespace igl {
+class IBuffer;
+} // namespace igl
+
 namespace igl::shell {
 struct ShellParams {
   std::vector<ViewParams> viewParams;
@@ -21,5 +27,15 @@ struct ShellParams {
   glm::vec2 viewportSize = glm::vec2(1024.0f, 768.0f);
   igl::TextureFormat defaultColorFramebufferFormat = igl::TextureFormat::BGRA_SRGB;
   float viewportScale = 1.f;
+  // rotation of the native drawable relative to the display (Vulkan swapchain pre-rotation on
+  // Android); apply it after the projection matrix when rendering into the native drawable
+  glm::mat4 preRotationMatrix = glm::mat4(1.0f);
+  // the host extrapolates frames from motion vectors, see RenderSession::updateMotionVectors()
+  bool motionVectorsSupported = false;
+  // Optional uniform buffer holding a LateLatchedView per element of viewParams. The host rewrites
+  // it with fresher poses in RenderSession::latchViewParams(), so commands reading their view
+  // matrices from it are not bound to the poses of viewParams. May change with every update().
+  std::shared_ptr<igl::IBuffer> lateLatchedViewBuffer;
+  std::function<void()> latchViewParams;
 };
 } // namespace igl::shell
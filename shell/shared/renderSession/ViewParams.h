@@ -16,4 +16,10 @@ struct ViewParams {
   glm::vec3 cameraPosition = glm::vec3(0);
   Fov fov;
 };
+
+// Element of ShellParams::lateLatchedViewBuffer, laid out for std140 and std430 blocks
+struct LateLatchedView {
+  glm::mat4 viewMatrix = glm::mat4(1);
+  glm::vec4 cameraPosition = glm::vec4(0); // w is unused
+};
 } // namespace igl::shell
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <shell/shared/testShell/Benchmark.h>
+
+namespace igl::shell {
+
+namespace {
+
+void writeStatsJson(std::ostream& os, const char* name, const FrameProfiler::Stats& stats) {
+  os << "\"" << name << "\": {\"averageMs\": " << stats.averageMs << ", \"p50Ms\": " << stats.p50Ms
+     << ", \"p95Ms\": " << stats.p95Ms << ", \"p99Ms\": " << stats.p99Ms
+     << ", \"maxMs\": " << stats.maxMs << "}";
+}
+
+void writeStatsCsv(std::ostream& os, const FrameProfiler::Stats& stats) {
+  os << "," << stats.averageMs << "," << stats.p50Ms << "," << stats.p95Ms << "," << stats.p99Ms
+     << "," << stats.maxMs;
+}
+
+} // namespace
+
+void writeBenchmarkJson(std::ostream& os, const std::vector<BenchmarkResult>& results) {
+  os << "[\n";
+  for (size_t i = 0; i != results.size(); ++i) {
+    const BenchmarkResult& result = results[i];
+    // the names are identifiers of the sessions, which need no escaping
+    os << "  {\"name\": \"" << result.name << "\", \"backend\": \"" << result.backend
+       << "\", \"width\": " << result.width << ", \"height\": " << result.height
+       << ", \"numFrames\": " << result.numFrames << ", ";
+    writeStatsJson(os, "cpu", result.cpu);
+    os << ", ";
+    writeStatsJson(os, "frame", result.frame);
+    os << (i + 1 != results.size() ? "},\n" : "}\n");
+  }
+  os << "]\n";
+}
+
+void writeBenchmarkCsv(std::ostream& os, const std::vector<BenchmarkResult>& results) {
+  os << "name,backend,width,height,numFrames,"
+        "cpuAverageMs,cpuP50Ms,cpuP95Ms,cpuP99Ms,cpuMaxMs,"
+        "frameAverageMs,frameP50Ms,frameP95Ms,frameP99Ms,frameMaxMs\n";
+  for (const BenchmarkResult& result : results) {
+    os << result.name << "," << result.backend << "," << result.width << "," << result.height
+       << "," << result.numFrames;
+    writeStatsCsv(os, result.cpu);
+    writeStatsCsv(os, result.frame);
+    os << "\n";
+  }
+}
+
+} // namespace igl::shell
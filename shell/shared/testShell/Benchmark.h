@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/FrameProfiler.h>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace igl::shell {
+
+/// Describes a headless benchmark run of a RenderSession, see TestShellBase::benchmark()
+struct BenchmarkDesc {
+  std::string name;
+  /// Frames rendered before measuring, e.g. to compile the pipelines and fill the caches
+  size_t numWarmUpFrames = 10;
+  size_t numFrames = 100;
+  /// Size of the offscreen color and depth targets
+  uint32_t width = 1024;
+  uint32_t height = 1024;
+};
+
+struct BenchmarkResult {
+  std::string name;
+  std::string backend;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  size_t numFrames = 0;
+  /// CPU time spent in RenderSession::update()
+  FrameProfiler::Stats cpu;
+  /// RenderSession::update() plus the wait for the GPU to complete the frame
+  FrameProfiler::Stats frame;
+};
+
+/// Writes 'results' as a JSON array of objects
+void writeBenchmarkJson(std::ostream& os, const std::vector<BenchmarkResult>& results);
+/// Writes 'results' as CSV with a header row, one row per result
+void writeBenchmarkCsv(std::ostream& os, const std::vector<BenchmarkResult>& results);
+
+} // namespace igl::shell
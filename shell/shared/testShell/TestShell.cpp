@@ -5,6 +5,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <igl/opengl/Device.h>
 #include <igl/opengl/IContext.h>
 #include <memory>
@@ -80,4 +81,67 @@ void TestShellBase::run(igl::shell::RenderSession& session, size_t numFrames) {
   session.dispose();
 }
 
+BenchmarkResult TestShellBase::benchmark(igl::shell::RenderSession& session,
+                                         const BenchmarkDesc& desc) {
+  auto& device = platform_->getDevice();
+  BenchmarkResult result;
+  result.name = desc.name;
+  result.backend = igl::BackendTypeToString(device.getBackendType());
+  result.width = desc.width;
+  result.height = desc.height;
+  result.numFrames = desc.numFrames;
+
+  igl::Result ret;
+  igl::TextureDesc texDesc = igl::TextureDesc::new2D(
+      offscreenTexture_->getProperties().format,
+      desc.width,
+      desc.height,
+      igl::TextureDesc::TextureUsageBits::Sampled | igl::TextureDesc::TextureUsageBits::Attachment);
+  auto colorTexture = device.createTexture(texDesc, &ret);
+  IGL_ASSERT_MSG(ret.isOk(), ret.message.c_str());
+  texDesc.format = offscreenDepthTexture_->getProperties().format;
+  texDesc.storage = igl::ResourceStorage::Private;
+  auto depthTexture = device.createTexture(texDesc, &ret);
+  IGL_ASSERT_MSG(ret.isOk(), ret.message.c_str());
+  if (!colorTexture || !depthTexture) {
+    return result;
+  }
+
+  // Reading back a pixel of the color target waits for the GPU to complete the frame: the command
+  // queues of the OpenGL and Vulkan backends execute in submission order. On Metal, where the
+  // queues are independent, the frame times are a lower bound.
+  auto commandQueue = device.createCommandQueue({igl::CommandQueueType::Graphics}, &ret);
+  igl::FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = colorTexture;
+  auto framebuffer = device.createFramebuffer(framebufferDesc, &ret);
+  IGL_ASSERT_MSG(ret.isOk(), ret.message.c_str());
+  uint32_t pixel = 0;
+  const auto pixelRange = igl::TextureRangeDesc::new2D(0, 0, 1, 1);
+
+  ShellParams shellParams;
+  shellParams.viewportSize = glm::vec2(desc.width, desc.height);
+  session.setShellParams(shellParams);
+  session.initialize();
+
+  const size_t capacity = std::max<size_t>(desc.numFrames, 1);
+  igl::FrameProfiler cpuProfiler(1000.0 / 60.0, capacity);
+  igl::FrameProfiler frameProfiler(1000.0 / 60.0, capacity);
+  for (size_t i = 0; i != desc.numWarmUpFrames + desc.numFrames; ++i) {
+    const int64_t start = igl::FrameProfiler::now();
+    session.update({colorTexture, depthTexture});
+    const int64_t updated = igl::FrameProfiler::now();
+    framebuffer->copyBytesColorAttachment(*commandQueue, 0, &pixel, pixelRange);
+    const int64_t end = igl::FrameProfiler::now();
+    if (i >= desc.numWarmUpFrames) {
+      cpuProfiler.addSample(igl::FrameProfiler::Track::CpuFrame, start, updated - start);
+      frameProfiler.addSample(igl::FrameProfiler::Track::CpuFrame, start, end - start);
+    }
+  }
+  session.dispose();
+
+  result.cpu = cpuProfiler.getStats(igl::FrameProfiler::Track::CpuFrame);
+  result.frame = frameProfiler.getStats(igl::FrameProfiler::Track::CpuFrame);
+  return result;
+}
+
 } // namespace igl::shell
@@ -11,6 +11,7 @@
 #include <iglu/device/OpenGLFactory.h>
 #include <memory>
 #include <shell/shared/renderSession/RenderSession.h>
+#include <shell/shared/testShell/Benchmark.h>
 #define OFFSCREEN_RT_WIDTH 1
 #define OFFSCREEN_RT_HEIGHT 1
 
@@ -26,6 +27,9 @@ class TestShellBase {
   void TearDown(){};
 
   void run(igl::shell::RenderSession& session, size_t numFrames);
+  // Renders desc.numWarmUpFrames then desc.numFrames measured frames of 'session' into offscreen
+  // targets of the size of 'desc'
+  BenchmarkResult benchmark(igl::shell::RenderSession& session, const BenchmarkDesc& desc);
 
   std::shared_ptr<igl::shell::Platform> platform_;
   std::shared_ptr<igl::ITexture> offscreenTexture_;
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/CommandEncoder.h>
+#include <igl/Common.h>
+
+namespace igl {
+
+class IBuffer;
+class ITexture;
+struct TextureRangeDesc;
+
+/**
+ * @brief Object for encoding copies between buffers and textures into a command buffer
+ *
+ * Create IBlitCommandEncoder object by calling ICommandBuffer::createBlitCommandEncoder. The
+ * copies are executed by the GPU in order with the other encoders of the command buffer, without
+ * any CPU round trip. Commands recorded into the same blit encoder are executed in order as well.
+ * You must always call endEncoding before the encoder is released or before creating another
+ * encoder.
+ */
+class IBlitCommandEncoder : public ICommandEncoder {
+ public:
+  /**
+   * @brief Construct a new IBlitCommandEncoder object recording into `commandBuffer`
+   *
+   */
+  explicit IBlitCommandEncoder(std::shared_ptr<ICommandBuffer> commandBuffer) :
+    ICommandEncoder::ICommandEncoder(std::move(commandBuffer)) {}
+
+  /**
+   * @brief Destroy the IBlitCommandEncoder object
+   *
+   */
+  ~IBlitCommandEncoder() override = default;
+
+  /**
+   * @brief Copies `size` bytes from `source` to `destination`. The ranges must not overlap if both
+   * buffers are the same.
+   *
+   * @param source The buffer to copy from.
+   * @param sourceOffset Where the data begins in bytes from the start of `source`.
+   * @param destination The buffer to copy into.
+   * @param destinationOffset Where the data is written in bytes from the start of `destination`.
+   * @param size The number of bytes to copy.
+   */
+  virtual void copyBuffer(IBuffer& source,
+                          size_t sourceOffset,
+                          IBuffer& destination,
+                          size_t destinationOffset,
+                          size_t size) = 0;
+  /**
+   * @brief Copies the pixels of one mip level of `destination` from `source`. The layers of
+   * `range` are read one after another.
+   *
+   * @param source The buffer to copy from.
+   * @param sourceOffset Where the pixels begin in bytes from the start of `source`.
+   * @param sourceBytesPerRow The number of bytes between two rows in `source`, 0 for tightly
+   * packed rows.
+   * @param destination The texture to copy into.
+   * @param range The region of `destination` to copy into, with a single mip level.
+   */
+  virtual void copyBufferToTexture(IBuffer& source,
+                                   size_t sourceOffset,
+                                   size_t sourceBytesPerRow,
+                                   ITexture& destination,
+                                   const TextureRangeDesc& range) = 0;
+  /**
+   * @brief Copies a region of one mip level of `source` into `destination`. Both textures must
+   * have the same format.
+   *
+   * @param source The texture to copy from.
+   * @param sourceRange The region of `source` to copy, with a single mip level.
+   * @param destination The texture to copy into.
+   * @param destinationRange The region of `destination` to copy into. Only its offset, mip level
+   * and first layer are used, the size of the region is the one of `sourceRange`.
+   */
+  virtual void copyTexture(ITexture& source,
+                           const TextureRangeDesc& sourceRange,
+                           ITexture& destination,
+                           const TextureRangeDesc& destinationRange) = 0;
+  /**
+   * @brief Sets `size` bytes of `buffer` to `value`. On Vulkan, `offset` and `size` must be
+   * multiples of 4.
+   *
+   * @param buffer The buffer to fill.
+   * @param offset Where the filled range begins in bytes from the start of `buffer`.
+   * @param size The number of bytes to fill.
+   * @param value The value of every byte of the range.
+   */
+  virtual void fillBuffer(IBuffer& buffer, size_t offset, size_t size, uint8_t value) = 0;
+  /**
+   * @brief Generates all the mip levels of `texture` from its first mip level.
+   *
+   * @param texture The texture to generate the mip levels of.
+   */
+  virtual void generateMipmaps(ITexture& texture) = 0;
+};
+
+} // namespace igl
@@ -57,7 +57,8 @@ struct BufferDesc {
     UniformBlock = 1 << 1, // Enforces UBO for OpenGL
     Query = 1 << 2,
     Bone = 1 << 3,
-    Ring = 1 << 4, // Metal: Ring buffers with memory for each swapchain image
+    Ring = 1 << 4, // Metal: Ring buffers with memory for each swapchain image. OpenGL: streaming
+                   // dynamic buffers which do not stall on upload
     NoCopy = 1 << 5, // Metal: The buffer should re-use previously allocated memory.
   };
 
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/CacheFile.h>
+
+#include <cstdio>
+#include <igl/Common.h>
+
+namespace igl {
+
+uint64_t hashCacheData(const void* data, size_t size, uint64_t hash) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i != size; i++) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+bool writeCacheFile(const std::string& path,
+                    const void* header,
+                    size_t headerSize,
+                    const void* data,
+                    size_t dataSize) {
+  const std::string tmpPath = path + ".tmp";
+
+  FILE* file = fopen(tmpPath.c_str(), "wb");
+
+  if (!file) {
+    IGL_LOG_ERROR("Cannot open %s for writing\n", tmpPath.c_str());
+    return false;
+  }
+
+  const bool isWritten = fwrite(header, headerSize, 1, file) == 1 &&
+                         (dataSize == 0 || fwrite(data, 1, dataSize, file) == dataSize);
+
+  if (fclose(file) != 0 || !isWritten) {
+    IGL_LOG_ERROR("Cannot write %s\n", tmpPath.c_str());
+    remove(tmpPath.c_str());
+    return false;
+  }
+
+#if IGL_PLATFORM_WIN
+  // rename() does not overwrite existing files on Windows
+  remove(path.c_str());
+#endif // IGL_PLATFORM_WIN
+
+  if (rename(tmpPath.c_str(), path.c_str()) != 0) {
+    IGL_LOG_ERROR("Cannot rename %s into %s\n", tmpPath.c_str(), path.c_str());
+    remove(tmpPath.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace igl
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace igl {
+
+/**
+ * @brief Helpers shared by the on-disk caches of the backends (pipeline caches, SPIR-V caches and
+ * program binaries). Cache files are a fixed-size header followed by a blob whose size and hash
+ * are stored in the header.
+ */
+
+constexpr uint64_t kCacheHashSeed = 0xcbf29ce484222325ull;
+
+/// FNV-1a hash of `size` bytes. Pass the previous result as `hash` to hash several ranges.
+uint64_t hashCacheData(const void* data, size_t size, uint64_t hash = kCacheHashSeed);
+
+/// Writes `header` followed by `data` into `path`, through a temporary file which then replaces
+/// the old one, so that a crash or power loss while writing cannot leave a truncated file behind.
+/// Errors are logged.
+bool writeCacheFile(const std::string& path,
+                    const void* header,
+                    size_t headerSize,
+                    const void* data,
+                    size_t dataSize);
+
+} // namespace igl
@@ -7,10 +7,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <igl/BlitCommandEncoder.h>
 #include <igl/Buffer.h>
 #include <igl/Common.h>
 #include <igl/Framebuffer.h>
+#include <igl/ParallelRenderCommandEncoder.h>
+#include <igl/QueryPool.h>
 #include <igl/RenderCommandEncoder.h>
+#include <igl/Timer.h>
 
 namespace igl {
 
@@ -27,11 +32,42 @@ struct CommandBufferDesc {
 };
 
 /**
- * Struct containing data about the command buffer usage. Currently used to track the number of draw
- * calls performed by this command buffer (see specific method usage below).
+ * @brief Counters of the commands recorded into a command buffer.
+ */
+enum class CommandBufferCounter : uint8_t {
+  /** @brief Draw calls, including indirect ones */
+  Draws,
+  /** @brief Compute dispatches */
+  Dispatches,
+  /** @brief Render and compute pipeline state bindings */
+  PipelineBinds,
+  /** @brief Descriptor set updates (Vulkan), and uniform data bound with bindBytes(),
+   * bindPushConstants() or bindUniform() */
+  BindingUpdates,
+  /** @brief Pipeline and memory barriers */
+  Barriers,
+  /** @brief Bytes of uniform data bound with bindBytes(), bindPushConstants() or bindUniform(),
+   * and on Vulkan the bytes uploaded through the staging buffer since the previous submission */
+  UploadedBytes,
+  /** @brief Vulkan: how many times the staging buffer waited for the GPU to release its memory
+   * since the previous submission */
+  StagingWaits,
+  /** @brief Render passes, i.e. render command encoders */
+  RenderPasses,
+  Count,
+};
+
+/**
+ * Struct containing data about the command buffer usage: one counter per CommandBufferCounter
+ * (see specific method usage below).
  */
 struct CommandBufferStatistics {
-  uint32_t currentDrawCount = 0;
+  // atomic because parallel render command encoders can record from multiple threads
+  std::atomic<uint64_t> counters[static_cast<size_t>(CommandBufferCounter::Count)] = {};
+
+  uint64_t get(CommandBufferCounter counter) const noexcept {
+    return counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+  }
 };
 
 /**
@@ -70,12 +106,47 @@ class ICommandBuffer {
     return createRenderCommandEncoder(renderPass, std::move(framebuffer), nullptr);
   }
 
+  /**
+   * @brief Create a ParallelRenderCommandEncoder which can hand out multiple RenderCommandEncoders
+   * for the same render pass, allowing the pass to be recorded from several threads.
+   * The default implementation sets Result::Code::Unsupported and returns nullptr.
+   * @returns a pointer to the ParallelRenderCommandEncoder
+   */
+  virtual std::unique_ptr<IParallelRenderCommandEncoder> createParallelRenderCommandEncoder(
+      const RenderPassDesc& /*renderPass*/,
+      std::shared_ptr<IFramebuffer> /*framebuffer*/,
+      Result* IGL_NULLABLE outResult) {
+    Result::setResult(outResult, Result::Code::Unsupported, "Parallel encoding is not supported");
+    return nullptr;
+  }
+
+  std::unique_ptr<IParallelRenderCommandEncoder> createParallelRenderCommandEncoder(
+      const RenderPassDesc& renderPass,
+      std::shared_ptr<IFramebuffer> framebuffer) {
+    return createParallelRenderCommandEncoder(renderPass, std::move(framebuffer), nullptr);
+  }
+
   /**
    * @brief Create a ComputeCommandEncoder for encoding compute commands into this CommandBuffer.
    * @returns a pointer to the ComputeCommandEncoder
    */
   virtual std::unique_ptr<IComputeCommandEncoder> createComputeCommandEncoder() = 0;
 
+  /**
+   * @brief Create a BlitCommandEncoder for encoding copies between buffers and textures into this
+   * CommandBuffer. The default implementation sets Result::Code::Unsupported and returns nullptr.
+   * @returns a pointer to the BlitCommandEncoder
+   */
+  virtual std::unique_ptr<IBlitCommandEncoder> createBlitCommandEncoder(
+      Result* IGL_NULLABLE outResult) {
+    Result::setResult(outResult, Result::Code::Unsupported, "Blit encoding is not supported");
+    return nullptr;
+  }
+
+  std::unique_ptr<IBlitCommandEncoder> createBlitCommandEncoder() {
+    return createBlitCommandEncoder(nullptr);
+  }
+
   /**
    * @brief presents the results of the encoded GPU commands the screen as soon as possible (once
    * the commands have completed executing). Should be called before submitting commands via a
@@ -116,23 +187,69 @@ class ICommandBuffer {
    */
   virtual void popDebugGroupLabel() const = 0;
 
+  /**
+   * @brief Starts measuring the GPU time of the commands recorded into this command buffer after
+   * this call. Timers measure whole passes and debug groups, so call this outside of render and
+   * compute command encoders. Has no effect if DeviceFeatures::Timers is not supported.
+   * @see igl::IDevice::createTimer()
+   */
+  virtual void beginTimer(const std::shared_ptr<ITimer>& /*timer*/) {}
+
+  /**
+   * @brief Stops measuring the GPU time. Should be preceded by beginTimer() on the same command
+   * buffer and called before the command buffer is submitted.
+   */
+  virtual void endTimer(const std::shared_ptr<ITimer>& /*timer*/) {}
+
+  /**
+   * @brief Starts collecting pipeline statistics of the commands recorded into this command buffer
+   * after this call into the query `query` of `queryPool`. Call this outside of render and compute
+   * command encoders. Has no effect if DeviceFeatures::PipelineStatisticsQueries is not supported.
+   * @see igl::IDevice::createQueryPool()
+   */
+  virtual void beginPipelineStatisticsQuery(const std::shared_ptr<IQueryPool>& /*queryPool*/,
+                                            uint32_t /*query*/) {}
+
+  /**
+   * @brief Stops collecting pipeline statistics. Should be preceded by
+   * beginPipelineStatisticsQuery() on the same command buffer.
+   */
+  virtual void endPipelineStatisticsQuery(const std::shared_ptr<IQueryPool>& /*queryPool*/,
+                                          uint32_t /*query*/) {}
+
   /**
    * @returns the number of draw operations tracked by this CommandBuffer. This is tracked manually
    * via calls to incrementCurrentDrawCount().
    */
   uint32_t getCurrentDrawCount() const {
-    return statistics_.currentDrawCount;
+    return static_cast<uint32_t>(statistics_.get(CommandBufferCounter::Draws));
   }
   /**
    * @brief Increment a counter representing the number of draw operations tracked by this
    * CommandBuffer.
    */
   void incrementCurrentDrawCount() {
-    statistics_.currentDrawCount++;
+    incrementStatistic(CommandBufferCounter::Draws);
+  }
+
+  /**
+   * @returns the counters of the commands recorded into this CommandBuffer. They are complete once
+   * the CommandBuffer has been submitted and can be read afterwards, e.g. for telemetry.
+   */
+  const CommandBufferStatistics& getStatistics() const {
+    return statistics_;
+  }
+  /**
+   * @brief Adds `value` to a counter of this CommandBuffer. Called by the backends while recording
+   * and submitting commands.
+   */
+  void incrementStatistic(CommandBufferCounter counter, uint64_t value = 1) const {
+    statistics_.counters[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
   }
 
  private:
-  CommandBufferStatistics statistics_;
+  // counters are not part of the logical state, they can be updated on submission
+  mutable CommandBufferStatistics statistics_;
 };
 
 } // namespace igl
@@ -7,10 +7,13 @@
 
 #pragma once
 
+#include <igl/Common.h>
+#include <memory>
 #include <string>
 
 namespace igl {
 
+class ICommandBuffer;
 class IDevice;
 
 class ICommandEncoder {
@@ -14,7 +14,9 @@ namespace igl {
 // Forward struct declarations
 // Forward class declarations
 struct CommandBufferDesc;
+struct TextureRangeDesc;
 class ICommandBuffer;
+class ITexture;
 
 /**
  * Enumeration used in CommandQueueDesc to create a command queue of the correct type.
@@ -47,6 +49,15 @@ struct CommandQueueStatistics {
 /// GPU Fence Handle
 using SubmitHandle = uint64_t;
 
+/**
+ * Used by ICommandQueue::updateTextureTiles() to make the tiles of a sparse texture resident
+ * (Commit) or release their memory (Decommit).
+ */
+enum class TextureTileMapping : uint8_t {
+  Commit,
+  Decommit,
+};
+
 /**
  * Overarching structure used to create specific command buffers that accept device commands.
  * There are three different command queue types: compute, graphics, and memory transfer.
@@ -62,6 +73,20 @@ class ICommandQueue {
   virtual std::shared_ptr<ICommandBuffer> createCommandBuffer(const CommandBufferDesc& desc,
                                                               Result* IGL_NULLABLE outResult) = 0;
   virtual SubmitHandle submit(const ICommandBuffer& commandBuffer, bool endOfFrame = false) = 0;
+  /**
+   * @brief Commits or decommits the memory of all tiles of a sparse texture (created with
+   * TextureDesc::TextureOptionBits::Sparse) which intersect `range`. The range is rounded out to
+   * whole tiles, see ITexture::getTileSize(). The update is executed after all previously submitted
+   * command buffers and before the next submitted one. The content of newly committed tiles is
+   * undefined, and sampling decommitted tiles returns undefined values.
+   *
+   * Requires DeviceFeatures::SparseTextures.
+   */
+  virtual Result updateTextureTiles(ITexture& /*texture*/,
+                                    const TextureRangeDesc& /*range*/,
+                                    TextureTileMapping /*mapping*/) {
+    return Result(Result::Code::Unsupported, "Sparse textures are not supported");
+  }
   uint32_t getLastFrameDrawCount() const {
     return statistics.lastFrameDrawCount;
   }
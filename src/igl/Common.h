@@ -13,6 +13,7 @@
 #include <cstdarg>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <igl/Core.h>
 #include <limits>
 #include <memory>
@@ -238,6 +239,15 @@ constexpr typename std::underlying_type<E>::type EnumToValue(E enumerator) noexc
   return static_cast<typename std::underlying_type<E>::type>(enumerator);
 }
 
+///--------------------------------------
+/// MARK: - Hash utilities
+
+// Mixes the hash of `value` into `seed`. Unlike xor, the order of the combined values matters
+template<typename T>
+void hashCombine(size_t& seed, const T& value) {
+  seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
 ///--------------------------------------
 /// MARK: - ScopeGuard
 
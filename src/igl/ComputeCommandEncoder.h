@@ -52,6 +52,13 @@ class IComputeCommandEncoder : public ICommandEncoder {
    */
   IComputeCommandEncoder() : ICommandEncoder::ICommandEncoder(nullptr) {}
 
+  /**
+   * @brief Construct a new IComputeCommandEncoder object recording into `commandBuffer`
+   *
+   */
+  explicit IComputeCommandEncoder(std::shared_ptr<ICommandBuffer> commandBuffer) :
+    ICommandEncoder::ICommandEncoder(std::move(commandBuffer)) {}
+
   /**
    * @brief Destroy the IComputeCommandEncoder object
    *
@@ -118,6 +125,20 @@ class IComputeCommandEncoder : public ICommandEncoder {
    */
   virtual void dispatchThreadGroups(const Dimensions& threadgroupCount,
                                     const Dimensions& threadgroupSize) = 0;
+  /**
+   * @brief Encodes a compute command whose number of thread groups is read from a buffer on the
+   * GPU, e.g. written by a previous dispatch. This allows sizing a dispatch from the results of GPU
+   * culling or compaction without reading them back to the CPU.
+   *
+   * @param indirectBuffer A buffer created with BufferDesc::BufferTypeBits::Indirect containing
+   * three uint32_t values: the number of thread groups in each dimension.
+   * @param indirectBufferOffset The byte offset of the thread group counts in indirectBuffer, must
+   * be a multiple of 4.
+   * @param threadgroupSize The number of threads in one threadgroup, in each dimension.
+   */
+  virtual void dispatchThreadGroupsIndirect(IBuffer& indirectBuffer,
+                                            size_t indirectBufferOffset,
+                                            const Dimensions& threadgroupSize) = 0;
 };
 
 } // namespace igl
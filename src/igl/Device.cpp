@@ -6,7 +6,11 @@
  */
 
 #include <igl/Device.h>
+#include <igl/QueryPool.h>
+#include <igl/RenderBundle.h>
+#include <igl/RingBuffer.h>
 #include <igl/Shader.h>
+#include <igl/Timer.h>
 
 #include <algorithm>
 #include <utility>
@@ -27,6 +31,88 @@ bool IDevice::verifyScope() {
 
 void IDevice::updateSurface(void* nativeWindowType) {}
 
+std::shared_ptr<ITimer> IDevice::createTimer(Result* outResult) const noexcept {
+  Result::setResult(outResult, Result::Code::Unsupported, "GPU timers are not supported");
+  return nullptr;
+}
+
+std::shared_ptr<IQueryPool> IDevice::createQueryPool(const QueryPoolDesc& /*desc*/,
+                                                     Result* outResult) const noexcept {
+  Result::setResult(outResult, Result::Code::Unsupported, "Query pools are not supported");
+  return nullptr;
+}
+
+std::shared_ptr<IRenderBundle> IDevice::createRenderBundle(Result* outResult) const noexcept {
+  Result::setResult(outResult, Result::Code::Unsupported, "Render bundles are not supported");
+  return nullptr;
+}
+
+std::shared_ptr<ITexture> IDevice::createTextureView(std::shared_ptr<ITexture> /*texture*/,
+                                                     const TextureViewDesc& /*desc*/,
+                                                     Result* outResult) const noexcept {
+  Result::setResult(outResult, Result::Code::Unsupported, "Texture views are not supported");
+  return nullptr;
+}
+
+std::unique_ptr<IRingBuffer> IDevice::createRingBuffer(const RingBufferDesc& /*desc*/,
+                                                      Result* outResult) const noexcept {
+  Result::setResult(outResult, Result::Code::Unsupported, "Ring buffers are not supported");
+  return nullptr;
+}
+
+bool IDevice::getMemoryStatistics(DeviceMemoryStatistics& /*outStatistics*/) const noexcept {
+  return false;
+}
+
+void IDevice::setMemoryPressureCallback(float threshold, MemoryPressureCallback callback) noexcept {
+  memoryPressureThreshold_ = threshold;
+  memoryPressureCallback_ = std::move(callback);
+  heapsUnderPressure_.clear();
+}
+
+void IDevice::checkMemoryPressure() const noexcept {
+  if (!memoryPressureCallback_) {
+    return;
+  }
+
+  DeviceMemoryStatistics stats;
+
+  if (!getMemoryStatistics(stats)) {
+    return;
+  }
+
+  heapsUnderPressure_.resize(stats.heaps.size(), false);
+
+  for (size_t i = 0; i != stats.heaps.size(); i++) {
+    const MemoryHeapStatistics& heap = stats.heaps[i];
+    const bool isUnderPressure =
+        heap.budget && (double)heap.usage > (double)heap.budget * memoryPressureThreshold_;
+    // report only when a heap crosses the threshold
+    if (isUnderPressure && !heapsUnderPressure_[i]) {
+      memoryPressureCallback_(i, heap);
+    }
+    heapsUnderPressure_[i] = isUnderPressure;
+  }
+}
+
+void IDevice::createComputePipelineAsync(const ComputePipelineDesc& desc,
+                                         ComputePipelineCompletionHandler completionHandler) const {
+  Result result;
+  auto pipelineState = createComputePipeline(desc, &result);
+  if (completionHandler) {
+    completionHandler(std::move(pipelineState), std::move(result));
+  }
+}
+
+void IDevice::createRenderPipelineAsync(const RenderPipelineDesc& desc,
+                                        RenderPipelineCompletionHandler completionHandler) const {
+  Result result;
+  auto pipelineState = createRenderPipeline(desc, &result);
+  if (completionHandler) {
+    completionHandler(std::move(pipelineState), std::move(result));
+  }
+}
+
 TextureDesc IDevice::sanitize(const TextureDesc& desc) const {
   TextureDesc sanitized = desc;
   if (desc.width == 0 || desc.height == 0 || desc.depth == 0 || desc.numLayers == 0 ||
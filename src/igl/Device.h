@@ -12,6 +12,7 @@
 #include <igl/IResourceTracker.h>
 #include <igl/PlatformDevice.h>
 #include <igl/Texture.h>
+#include <functional>
 #include <utility>
 #include <vector>
 
@@ -22,7 +23,9 @@ struct CommandQueueDesc;
 struct ComputePipelineDesc;
 struct DepthStencilStateDesc;
 struct FramebufferDesc;
+struct QueryPoolDesc;
 struct RenderPipelineDesc;
+struct RingBufferDesc;
 struct SamplerStateDesc;
 struct ShaderLibraryDesc;
 struct ShaderModuleDesc;
@@ -36,14 +39,56 @@ class IComputePipelineState;
 class IDepthStencilState;
 class IDevice;
 class IFramebuffer;
+class IQueryPool;
+class IRenderBundle;
 class IRenderPipelineState;
+class IRingBuffer;
 class ISamplerState;
 class IShaderLibrary;
 class IShaderModule;
 class IShaderStages;
 class ITexture;
+class ITimer;
 class IVertexInputState;
 
+/**
+ * @brief Usage and budget of a single GPU memory heap, in bytes.
+ *
+ *  usage         - Memory currently allocated from the heap by this process
+ *  budget        - Estimated amount of memory this process can allocate from the heap before
+ *                  allocations start failing or the OS starts reclaiming memory
+ *  isDeviceLocal - Whether the heap is local to the GPU
+ */
+struct MemoryHeapStatistics {
+  uint64_t usage = 0;
+  uint64_t budget = 0;
+  bool isDeviceLocal = false;
+};
+
+/**
+ * @brief Snapshot of the GPU memory used by a device, in bytes.
+ *
+ *  heaps        - Usage and budget of every memory heap
+ *  textureBytes - Memory allocated for textures and other images created by the device, 0 if the
+ *                 backend does not track it
+ *  bufferBytes  - Memory allocated for buffers created by the device, 0 if the backend does not
+ *                 track it
+ *  resizableBarBufferBytes - Part of bufferBytes placed in device-local memory which the CPU
+ *                 writes directly (resizable BAR), so uploads to these buffers skip staging
+ */
+struct DeviceMemoryStatistics {
+  std::vector<MemoryHeapStatistics> heaps;
+  uint64_t textureBytes = 0;
+  uint64_t bufferBytes = 0;
+  uint64_t resizableBarBufferBytes = 0;
+};
+
+/**
+ * @brief Invoked when the usage of the heap `heapIndex` goes above the pressure threshold.
+ */
+using MemoryPressureCallback =
+    std::function<void(size_t heapIndex, const MemoryHeapStatistics& heap)>;
+
 /**
  * @brief Interface to a GPU that is used to draw graphics or do parallel computation.
  */
@@ -109,6 +154,21 @@ class IDevice : public ICapabilities {
                                                   Result* IGL_NULLABLE
                                                       outResult) const noexcept = 0;
 
+  /**
+   * @brief Creates a view aliasing a format, mip or layer subset of an existing texture without
+   * copying it. The view keeps the texture alive. Requires DeviceFeatures::TextureViews.
+   * @see igl::TextureViewDesc
+   * @param texture The texture to alias.
+   * @param desc Description for the desired view.
+   * @param outResult Pointer to where the result (success, failure, etc) is written. Can be null if
+   * no reporting is desired.
+   * @return Shared pointer to the created view or nullptr if views are not supported.
+   */
+  virtual std::shared_ptr<ITexture> createTextureView(std::shared_ptr<ITexture> texture,
+                                                      const TextureViewDesc& desc,
+                                                      Result* IGL_NULLABLE
+                                                          outResult) const noexcept;
+
   /**
    * @brief Creates a vertex input state.
    * @see igl::VertexInputStateDesc
@@ -145,6 +205,39 @@ class IDevice : public ICapabilities {
                                                                      Result* IGL_NULLABLE
                                                                          outResult) const = 0;
 
+  /**
+   * @brief Invoked when an asynchronously created pipeline state is ready to be used or when its
+   * creation has failed. It can be invoked on any thread, including the calling one.
+   */
+  using ComputePipelineCompletionHandler =
+      std::function<void(std::shared_ptr<IComputePipelineState> pipelineState, Result result)>;
+  using RenderPipelineCompletionHandler =
+      std::function<void(std::shared_ptr<IRenderPipelineState> pipelineState, Result result)>;
+
+  /**
+   * @brief Creates a compute pipeline state without blocking the calling thread on shader
+   * compilation, if the backend supports it. The default implementation creates the pipeline
+   * synchronously and invokes the handler before returning.
+   * @see igl::ComputePipelineDesc
+   * @param desc Description for the desired resource. Resources referenced by it should be alive
+   * until the handler is invoked.
+   * @param completionHandler Receives the created pipeline state and the result.
+   */
+  virtual void createComputePipelineAsync(const ComputePipelineDesc& desc,
+                                          ComputePipelineCompletionHandler completionHandler) const;
+
+  /**
+   * @brief Creates a render pipeline state without blocking the calling thread on shader
+   * compilation, if the backend supports it. The default implementation creates the pipeline
+   * synchronously and invokes the handler before returning.
+   * @see igl::RenderPipelineDesc
+   * @param desc Description for the desired resource. Resources referenced by it should be alive
+   * until the handler is invoked.
+   * @param completionHandler Receives the created pipeline state and the result.
+   */
+  virtual void createRenderPipelineAsync(const RenderPipelineDesc& desc,
+                                         RenderPipelineCompletionHandler completionHandler) const;
+
   /**
    * @brief Creates a shader module from either source code or pre-compiled data.
    * @see igl::ShaderModuleDesc
@@ -157,6 +250,61 @@ class IDevice : public ICapabilities {
                                                             Result* IGL_NULLABLE
                                                                 outResult) const = 0;
 
+  /**
+   * @brief Creates a reusable GPU timer.
+   * @see igl::ICommandBuffer::beginTimer()
+   * @param outResult Pointer to where the result (success, failure, etc) is written. Can be null if
+   * no reporting is desired.
+   * @return Shared pointer to the created timer or nullptr if DeviceFeatures::Timers is not
+   * supported.
+   */
+  virtual std::shared_ptr<ITimer> createTimer(Result* IGL_NULLABLE outResult) const noexcept;
+
+  /**
+   * @brief Creates a pool of occlusion or pipeline statistics queries.
+   * @see igl::IQueryPool
+   * @param desc Description for the desired resource.
+   * @param outResult Pointer to where the result (success, failure, etc) is written. Can be null if
+   * no reporting is desired.
+   * @return Shared pointer to the created query pool or nullptr if the query type is not supported,
+   * see DeviceFeatures::OcclusionQueries and DeviceFeatures::PipelineStatisticsQueries.
+   */
+  virtual std::shared_ptr<IQueryPool> createQueryPool(const QueryPoolDesc& desc,
+                                                      Result* IGL_NULLABLE
+                                                          outResult) const noexcept;
+
+  /**
+   * @brief Creates an empty bundle of render commands which can be recorded once and executed by
+   * many render passes.
+   * @see igl::IRenderBundle
+   * @param outResult Pointer to where the result (success, failure, etc) is written. Can be null if
+   * no reporting is desired.
+   * @return Shared pointer to the created bundle or nullptr if the backend does not support render
+   * bundles.
+   */
+  virtual std::shared_ptr<IRenderBundle> createRenderBundle(Result* IGL_NULLABLE
+                                                                outResult) const noexcept;
+
+  /**
+   * @brief Creates a persistently mapped ring buffer for per-frame dynamic data.
+   * @see igl::IRingBuffer
+   * @param desc Description for the desired resource.
+   * @param outResult Pointer to where the result (success, failure, etc) is written. Can be null if
+   * no reporting is desired.
+   * @return Unique pointer to the created ring buffer or nullptr if the backend does not support
+   * persistently mapped buffers.
+   */
+  virtual std::unique_ptr<IRingBuffer> createRingBuffer(const RingBufferDesc& desc,
+                                                        Result* IGL_NULLABLE
+                                                            outResult) const noexcept;
+
+  /**
+   * @brief Queries the current GPU memory usage and budgets.
+   * @param outStatistics Statistics are written here on success.
+   * @return true if the backend supports memory statistics.
+   */
+  virtual bool getMemoryStatistics(DeviceMemoryStatistics& outStatistics) const noexcept;
+
   /**
    * @brief Creates a frame buffer object.
    * @see igl::FramebufferDesc
@@ -210,7 +358,8 @@ class IDevice : public ICapabilities {
 
   /**
    * @brief Allow clients to verify that the scope that they are making IGL calls is current and
-   * valid.
+   * valid. Backends may perform the more expensive checks, e.g. querying the current context,
+   * only in debug builds.
    * @return Whether or not the current scope is valid.
    */
   virtual bool verifyScope();
@@ -293,6 +442,21 @@ class IDevice : public ICapabilities {
     return resourceTracker_;
   }
 
+  /**
+   * @brief Sets a callback which is invoked once every time the usage of a memory heap goes above
+   * `threshold` * budget. Backends check the heaps when command buffers are submitted, so the
+   * callback runs on the submitting thread. Pass an empty callback to disable the checks.
+   * @see igl::IDevice::getMemoryStatistics()
+   * @param threshold Fraction of the heap budget, e.g. 0.9f.
+   */
+  void setMemoryPressureCallback(float threshold, MemoryPressureCallback callback) noexcept;
+
+  /**
+   * @brief Checks the memory heaps against the pressure threshold and invokes the memory pressure
+   * callback for every heap which went above it. Called by backends on submit.
+   */
+  void checkMemoryPressure() const noexcept;
+
   /**
    * @brief Returns a backend-specific color for debugging purposes
    *  - OpenGL: Yellow
@@ -305,6 +469,10 @@ class IDevice : public ICapabilities {
  private:
   int scopeDepth_ = 0;
   std::shared_ptr<IResourceTracker> resourceTracker_;
+  float memoryPressureThreshold_ = 1.0f;
+  MemoryPressureCallback memoryPressureCallback_;
+  // heaps which are above the threshold and have already been reported
+  mutable std::vector<bool> heapsUnderPressure_;
 
   friend struct DeviceScope;
 };
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <igl/Macros.h>
@@ -28,20 +29,30 @@ namespace igl {
  * DepthCompare               Supports setting depth compare function
  * DepthShaderRead            Supports reading depth texture from a shader
  * DrawIndexedIndirect        Supports IRenderCommandEncoder::drawIndexedIndirect
+ * DrawInstanced              Supports IRenderCommandEncoder::drawInstanced and drawIndexedInstanced
  * ExplicitBinding,           Supports uniforms block explicit binding in shaders
  * ExplicitBindingExt,        Supports uniforms block explicit binding in shaders via an extension
+ * FramebufferFetch           Supports reading color attachments in fragment shaders, see
+ *                            RenderPassDesc::framebufferFetch
  * MapBufferRange             Supports mapping buffer data into client address space
  * MinMaxBlend                Supports Min and Max blend operations
+ * MultiDrawIndirectCount     Supports IRenderCommandEncoder::multiDrawIndexedIndirectCount
  * MultipleRenderTargets      Supports MRT - Multiple Render Targets
  * MultiSample                Supports multisample textures
  * MultiSampleResolve         Supports GPU multisampled texture resolve
  * Multiview                  Supports multiview
+ * OcclusionQueries           Supports occlusion queries with IQueryPool
+ * PipelineStatisticsQueries  Supports pipeline statistics queries with IQueryPool
  * PushConstants              Supports push constants(Vulkan)
  * ReadWriteFramebuffer       Supports separate FB reading/writing binding
  * SamplerMinMaxLod           Supports constraining the min and max texture LOD when sampling
+ * ShaderFloat16              Supports half precision arithmetic in shaders and half members in
+ *                            uniform and storage buffers, see UniformType::Float16
  * ShaderLibrary              Supports shader libraries
  * ShaderTextureLod           Supports explicit control of Lod in the shader
  * ShaderTextureLodExt        Supports explicit control of Lod in the shader via an extension
+ * ShadingRate                Supports IRenderCommandEncoder::setShadingRate
+ * SparseTextures             Supports partially resident textures (TextureOptionBits::Sparse)
  * SRGB                       Supports sRGB Textures and FrameBuffer
  * StandardDerivative         Supports Standard Derivative function in shader
  * StandardDerivativeExt      Supports Standard Derivative function in shader via an extension
@@ -57,6 +68,8 @@ namespace igl {
  * TextureHalfFloat           Supports half float texture format
  * TextureNotPot              Supports non power-of-two textures
  * TexturePartialMipChain     Supports mip chains that do not go all the way to 1x1
+ * TextureViews               Supports aliasing textures with IDevice::createTextureView()
+ * Timers                     Supports measuring GPU time with ITimer
  * UniformBlocks,             Supports uniform blocks
  * ValidationLayersEnabled,   Validation layers are enabled
  */
@@ -70,20 +83,28 @@ enum class DeviceFeatures {
   DepthCompare,
   DepthShaderRead,
   DrawIndexedIndirect,
+  DrawInstanced,
   ExplicitBinding,
   ExplicitBindingExt,
+  FramebufferFetch,
   MapBufferRange,
   MinMaxBlend,
+  MultiDrawIndirectCount,
   MultipleRenderTargets,
   MultiSample,
   MultiSampleResolve,
   Multiview,
+  OcclusionQueries,
+  PipelineStatisticsQueries,
   PushConstants,
   ReadWriteFramebuffer,
   SamplerMinMaxLod,
+  ShaderFloat16,
   ShaderLibrary,
   ShaderTextureLod,
   ShaderTextureLodExt,
+  ShadingRate,
+  SparseTextures,
   SRGB,
   SRGBWriteControl,
   StandardDerivative,
@@ -100,11 +121,17 @@ enum class DeviceFeatures {
   TextureHalfFloat,
   TextureNotPot,
   TexturePartialMipChain,
+  TextureViews,
+  Timers,
   UniformBlocks,
   ValidationLayersEnabled,
 };
 // clang-format on
 
+/// Number of DeviceFeatures values, for backends which resolve all of them into a bitset
+constexpr size_t kNumDeviceFeatures =
+    static_cast<size_t>(DeviceFeatures::ValidationLayersEnabled) + 1;
+
 /**
  * @brief DeviceRequirement denotes capturing specific requirements for a feature to be enabled.
  * These should be used in combination with DeviceFeatures to understand how to take advantage of
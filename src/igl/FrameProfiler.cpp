@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/FrameProfiler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <igl/Timer.h>
+
+namespace igl {
+
+namespace {
+
+constexpr double kNanosPerMs = 1e6;
+
+const char* getTrackName(FrameProfiler::Track track) {
+  switch (track) {
+  case FrameProfiler::Track::CpuFrame:
+    return "CPU frame";
+  case FrameProfiler::Track::GpuFrame:
+    return "GPU frame";
+  case FrameProfiler::Track::Wait:
+    return "Wait";
+  }
+  IGL_UNREACHABLE_RETURN("");
+}
+
+// nearest-rank percentile of sorted values
+double getPercentile(const std::vector<double>& sortedValues, double percentile) {
+  const auto rank = static_cast<size_t>(std::ceil(percentile * sortedValues.size()));
+  return sortedValues[std::max(rank, size_t(1)) - 1];
+}
+
+} // namespace
+
+FrameProfiler::FrameProfiler(double targetFrameTimeMs, size_t capacity) :
+  targetFrameTimeMs_(targetFrameTimeMs), capacity_(capacity) {
+  IGL_ASSERT(targetFrameTimeMs > 0.0);
+  IGL_ASSERT(capacity > 0);
+  for (auto& ring : rings_) {
+    ring.samples = std::make_unique<Sample[]>(capacity_);
+  }
+}
+
+int64_t FrameProfiler::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void FrameProfiler::beginFrame() {
+  const int64_t frameStart = now();
+  if (frameStartNanos_ != 0) {
+    const int64_t duration = frameStart - frameStartNanos_;
+    addSample(Track::CpuFrame, frameStartNanos_, duration);
+
+    const auto intervals = std::llround(static_cast<double>(duration) /
+                                        (targetFrameTimeMs_ * kNanosPerMs));
+    if (intervals > 1) {
+      droppedFrameCount_.fetch_add(static_cast<uint64_t>(intervals - 1),
+                                   std::memory_order_relaxed);
+    }
+    frameCount_.fetch_add(1, std::memory_order_relaxed);
+  }
+  frameStartNanos_ = frameStart;
+}
+
+bool FrameProfiler::addGpuTime(const ITimer& timer) {
+  if (!timer.resultsAvailable()) {
+    return false;
+  }
+  const auto duration = static_cast<int64_t>(timer.getElapsedTimeNanos());
+  addSample(Track::GpuFrame, now() - duration, duration);
+  return true;
+}
+
+void FrameProfiler::addSample(Track track, int64_t startNanos, int64_t durationNanos) {
+  Ring& ring = rings_[static_cast<size_t>(track)];
+  const uint64_t index = ring.writeCount.load(std::memory_order_relaxed);
+  Sample& sample = ring.samples[index % capacity_];
+  sample.startNanos.store(startNanos, std::memory_order_relaxed);
+  sample.durationNanos.store(durationNanos, std::memory_order_relaxed);
+  // publishes the sample to the readers
+  ring.writeCount.store(index + 1, std::memory_order_release);
+}
+
+std::vector<double> FrameProfiler::getDurationsMs(Track track) const {
+  const Ring& ring = rings_[static_cast<size_t>(track)];
+  const uint64_t writeCount = ring.writeCount.load(std::memory_order_acquire);
+  const uint64_t count = std::min<uint64_t>(writeCount, capacity_);
+
+  std::vector<double> durations;
+  durations.reserve(count);
+  for (uint64_t i = writeCount - count; i != writeCount; ++i) {
+    const int64_t duration =
+        ring.samples[i % capacity_].durationNanos.load(std::memory_order_relaxed);
+    durations.push_back(static_cast<double>(duration) / kNanosPerMs);
+  }
+  return durations;
+}
+
+FrameProfiler::Stats FrameProfiler::getStats(Track track) const {
+  std::vector<double> durations = getDurationsMs(track);
+
+  Stats stats;
+  if (durations.empty()) {
+    return stats;
+  }
+  std::sort(durations.begin(), durations.end());
+
+  double sum = 0.0;
+  for (const double duration : durations) {
+    sum += duration;
+  }
+  stats.numSamples = durations.size();
+  stats.averageMs = sum / static_cast<double>(durations.size());
+  stats.p50Ms = getPercentile(durations, 0.50);
+  stats.p95Ms = getPercentile(durations, 0.95);
+  stats.p99Ms = getPercentile(durations, 0.99);
+  stats.maxMs = durations.back();
+  return stats;
+}
+
+std::vector<uint32_t> FrameProfiler::getHistogram(Track track,
+                                                  double bucketWidthMs,
+                                                  size_t numBuckets) const {
+  IGL_ASSERT(bucketWidthMs > 0.0);
+  std::vector<uint32_t> histogram(numBuckets, 0);
+  if (numBuckets == 0) {
+    return histogram;
+  }
+  for (const double duration : getDurationsMs(track)) {
+    const auto bucket = static_cast<size_t>(std::max(duration, 0.0) / bucketWidthMs);
+    histogram[std::min(bucket, numBuckets - 1)]++;
+  }
+  return histogram;
+}
+
+uint64_t FrameProfiler::getFrameCount() const {
+  return frameCount_.load(std::memory_order_relaxed);
+}
+
+uint64_t FrameProfiler::getDroppedFrameCount() const {
+  return droppedFrameCount_.load(std::memory_order_relaxed);
+}
+
+float FrameProfiler::getAverageFPS() const {
+  const Stats stats = getStats(Track::CpuFrame);
+  return stats.averageMs > 0.0 ? static_cast<float>(1000.0 / stats.averageMs) : 0.0f;
+}
+
+std::string FrameProfiler::exportChromeTrace() const {
+  std::string trace = "{\"traceEvents\":[";
+  bool first = true;
+  char event[256];
+
+  auto append = [&](int length) {
+    if (length > 0) {
+      trace += first ? "\n" : ",\n";
+      trace.append(event, std::min(static_cast<size_t>(length), sizeof(event) - 1));
+      first = false;
+    }
+  };
+
+  for (size_t t = 0; t != kNumTracks; ++t) {
+    const auto track = static_cast<Track>(t);
+    append(snprintf(event,
+                    sizeof(event),
+                    R"({"name":"thread_name","ph":"M","pid":1,"tid":%zu,"args":{"name":"%s"}})",
+                    t + 1,
+                    getTrackName(track)));
+
+    const Ring& ring = rings_[t];
+    const uint64_t writeCount = ring.writeCount.load(std::memory_order_acquire);
+    const uint64_t count = std::min<uint64_t>(writeCount, capacity_);
+    for (uint64_t i = writeCount - count; i != writeCount; ++i) {
+      const Sample& sample = ring.samples[i % capacity_];
+      // trace timestamps are in microseconds
+      append(snprintf(event,
+                      sizeof(event),
+                      R"({"name":"%s","ph":"X","pid":1,"tid":%zu,"ts":%.3f,"dur":%.3f})",
+                      getTrackName(track),
+                      t + 1,
+                      static_cast<double>(sample.startNanos.load(std::memory_order_relaxed)) / 1e3,
+                      static_cast<double>(sample.durationNanos.load(std::memory_order_relaxed)) /
+                          1e3));
+    }
+  }
+
+  trace += "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return trace;
+}
+
+} // namespace igl
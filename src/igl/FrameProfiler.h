@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <igl/Common.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace igl {
+
+class ITimer;
+
+/**
+ * @brief FrameProfiler records the timings of the last frames to measure frame pacing: CPU frame
+ * times, GPU times from ITimer, and the time spent waiting, e.g. in
+ * ICommandBuffer::waitUntilScheduled() or when acquiring the next drawable. Unlike FPSCounter,
+ * which averages the frame rate, it keeps every sample so spikes show up in the percentiles, the
+ * histograms and the dropped frame count.
+ *
+ * Every track is a ring buffer of the last `capacity` samples. Samples are recorded by one thread,
+ * usually the render thread, without locking; statistics and traces can be read from any thread
+ * at any time. Reading while samples are recorded can include a sample that is being overwritten.
+ */
+class FrameProfiler final {
+ public:
+  enum class Track : uint8_t {
+    /// Time between two calls to beginFrame()
+    CpuFrame,
+    /// GPU time of a frame, from an ITimer
+    GpuFrame,
+    /// Time the CPU spent blocked, see ScopedWait
+    Wait,
+  };
+  static constexpr size_t kNumTracks = 3;
+
+  /// Statistics of the samples of a track, in milliseconds
+  struct Stats {
+    size_t numSamples = 0;
+    double averageMs = 0.0;
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+  };
+
+  /// Measures the time between its construction and its destruction in the Wait track
+  class ScopedWait final {
+   public:
+    explicit ScopedWait(FrameProfiler& profiler) : profiler_(profiler), start_(now()) {}
+    ~ScopedWait() {
+      profiler_.addSample(Track::Wait, start_, now() - start_);
+    }
+    ScopedWait(const ScopedWait&) = delete;
+    ScopedWait& operator=(const ScopedWait&) = delete;
+
+   private:
+    FrameProfiler& profiler_;
+    int64_t start_;
+  };
+
+  /// Frames longer than `targetFrameTimeMs`, usually the display refresh interval, count as
+  /// dropped frames
+  explicit FrameProfiler(double targetFrameTimeMs = 1000.0 / 60.0, size_t capacity = 1024);
+
+  /// Monotonic time in nanoseconds used for all the samples
+  static int64_t now();
+
+  /// Marks the start of a new frame and records the CPU time of the previous one
+  void beginFrame();
+  /// Records the time measured by `timer` if its results are available. The sample ends now.
+  /// @return true if a sample was recorded
+  bool addGpuTime(const ITimer& timer);
+  /// Records a sample which started at `startNanos` (see now()) and lasted `durationNanos`
+  void addSample(Track track, int64_t startNanos, int64_t durationNanos);
+
+  [[nodiscard]] Stats getStats(Track track) const;
+  /// Number of samples in each bucket of `bucketWidthMs`. The last bucket also counts all the
+  /// longer samples.
+  [[nodiscard]] std::vector<uint32_t> getHistogram(Track track,
+                                                   double bucketWidthMs,
+                                                   size_t numBuckets) const;
+  /// Frames recorded by beginFrame() since the profiler was created
+  [[nodiscard]] uint64_t getFrameCount() const;
+  /// Number of target frame intervals missed by all the recorded frames: a frame which takes
+  /// twice the target frame time drops one frame
+  [[nodiscard]] uint64_t getDroppedFrameCount() const;
+  /// Average frame rate over the recorded CPU frames
+  [[nodiscard]] float getAverageFPS() const;
+
+  /// Returns the recorded samples in the Chrome trace event JSON format, which can be loaded in
+  /// Perfetto or chrome://tracing. Every track is a thread of the trace.
+  [[nodiscard]] std::string exportChromeTrace() const;
+
+ private:
+  struct Sample {
+    std::atomic<int64_t> startNanos{0};
+    std::atomic<int64_t> durationNanos{0};
+  };
+
+  struct Ring {
+    std::unique_ptr<Sample[]> samples;
+    // total number of samples written, the next one goes to `writeCount % capacity`
+    std::atomic<uint64_t> writeCount{0};
+  };
+
+  // the durations of the samples of `track` currently in its ring buffer, in milliseconds
+  [[nodiscard]] std::vector<double> getDurationsMs(Track track) const;
+
+  const double targetFrameTimeMs_;
+  const size_t capacity_;
+  Ring rings_[kNumTracks];
+  int64_t frameStartNanos_ = 0;
+  std::atomic<uint64_t> frameCount_{0};
+  std::atomic<uint64_t> droppedFrameCount_{0};
+};
+
+} // namespace igl
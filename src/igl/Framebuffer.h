@@ -42,6 +42,10 @@ struct FramebufferDesc {
   AttachmentDesc depthAttachment;
   /** @brief The stencil texture attachment */
   AttachmentDesc stencilAttachment;
+  /** @brief Optional fragment density map (an RG8 texture with the same number of layers as the
+   * attachments) which lowers the shading rate of regions of the attachments. Only supported by
+   * Vulkan with VK_EXT_fragment_density_map and ignored by other backends. */
+  std::shared_ptr<ITexture> fragmentDensityMap;
 
   std::string debugName;
 
@@ -102,6 +106,10 @@ class IFramebuffer : public ITrackedResource<IFramebuffer> {
   /** @brief Replaces color attachment at index 0 with the 'texture' specified. A null texture is
    * valid and unbinds the current color attachment at index 0. */
   virtual std::shared_ptr<ITexture> updateDrawable(std::shared_ptr<ITexture> texture) = 0;
+
+  /** @brief Replaces the fragment density map, e.g. together with the drawable of a foveated
+   * surface. A null texture disables it. Ignored by backends without fragment density maps. */
+  virtual void updateFragmentDensityMap(std::shared_ptr<ITexture> /*texture*/) {}
 };
 
 } // namespace igl
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <igl/BlitCommandEncoder.h>
 #include <igl/Buffer.h>
 #include <igl/CommandBuffer.h>
 #include <igl/CommandQueue.h>
@@ -17,12 +18,17 @@
 #include <igl/Device.h>
 #include <igl/Framebuffer.h>
 #include <igl/HWDevice.h>
+#include <igl/ParallelRenderCommandEncoder.h>
+#include <igl/QueryPool.h>
+#include <igl/RenderBundle.h>
 #include <igl/RenderCommandEncoder.h>
 #include <igl/RenderPass.h>
 #include <igl/RenderPipelineState.h>
+#include <igl/RingBuffer.h>
 #include <igl/SamplerState.h>
 #include <igl/Shader.h>
 #include <igl/ShaderCreator.h>
 #include <igl/Texture.h>
+#include <igl/Timer.h>
 #include <igl/Uniform.h>
 #include <igl/VertexInputState.h>
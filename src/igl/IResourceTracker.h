@@ -9,6 +9,7 @@
 
 #include <igl/Common.h>
 #include <memory>
+#include <string>
 
 namespace igl {
 
@@ -23,6 +24,43 @@ class IShaderStages;
 template<typename T>
 class ITrackedResource;
 
+/**
+ * @brief Where the memory of a tracked resource lives
+ */
+enum class ResourceMemoryLocation : uint8_t {
+  Device, /// GPU-local memory
+  Host, /// Memory visible to the CPU
+  Lazy, /// Lazily allocated (memoryless) memory which may never be backed by physical memory
+};
+
+/**
+ * @brief Converts the storage mode of a resource to the memory location it is allocated from
+ */
+inline ResourceMemoryLocation toResourceMemoryLocation(ResourceStorage storage) {
+  switch (storage) {
+  case ResourceStorage::Shared:
+  case ResourceStorage::Managed:
+    return ResourceMemoryLocation::Host;
+  case ResourceStorage::Memoryless:
+    return ResourceMemoryLocation::Lazy;
+  case ResourceStorage::Invalid:
+  case ResourceStorage::Private:
+    return ResourceMemoryLocation::Device;
+  }
+  IGL_UNREACHABLE_RETURN(ResourceMemoryLocation::Device);
+}
+
+/**
+ * @brief Describes the memory allocated for a tracked texture or buffer
+ */
+struct ResourceMemoryInfo {
+  /** @brief Size of the allocation in bytes (an estimate for textures) */
+  size_t sizeInBytes = 0;
+  ResourceMemoryLocation location = ResourceMemoryLocation::Device;
+  /** @brief Debug name the resource was created with */
+  std::string debugName;
+};
+
 /**
  * @brief The IResourceTracker interface allows clients to implement their own Resource Trackers.
  * Clients can track Textures, Buffers, Framebuffers or other TrackedResources
@@ -139,6 +177,52 @@ class IResourceTracker {
     IGL_ASSERT_NOT_REACHED();
   }
 
+  /**
+   * @brief Informs the tracker about the memory allocated for a texture. Called right after
+   * didCreate() when the device knows the size of the texture.
+   *
+   * @param texture Texture to be tracked
+   * @param info Size, memory location and debug name of the texture
+   */
+  virtual void didAllocate(const ITexture& texture, const ResourceMemoryInfo& info) noexcept {}
+
+  /**
+   * @brief Informs the tracker that the memory of a texture will be released. Called right before
+   * willDelete(). The texture is partially destroyed and must not be accessed.
+   *
+   * @param texture Texture which will be deleted
+   * @param info The same info which was passed to didAllocate()
+   */
+  virtual void willDeallocate(const ITexture& texture, const ResourceMemoryInfo& info) noexcept {}
+
+  /**
+   * @brief Informs the tracker about the memory allocated for a buffer. Called right after
+   * didCreate().
+   *
+   * @param buffer Buffer to be tracked
+   * @param info Size, memory location and debug name of the buffer
+   */
+  virtual void didAllocate(const IBuffer& buffer, const ResourceMemoryInfo& info) noexcept {}
+
+  /**
+   * @brief Informs the tracker that the memory of a buffer will be released. Called right before
+   * willDelete(). The buffer is partially destroyed and must not be accessed.
+   *
+   * @param buffer Buffer which will be deleted
+   * @param info The same info which was passed to didAllocate()
+   */
+  virtual void willDeallocate(const IBuffer& buffer, const ResourceMemoryInfo& info) noexcept {}
+
+  template<typename T>
+  void didAllocate(const ITrackedResource<T>& resource, const ResourceMemoryInfo& info) noexcept {
+    IGL_ASSERT_NOT_REACHED();
+  }
+  template<typename T>
+  void willDeallocate(const ITrackedResource<T>& resource,
+                      const ResourceMemoryInfo& info) noexcept {
+    IGL_ASSERT_NOT_REACHED();
+  }
+
   /**
    * @brief Associates a name tag with the next resources to be tracked
    *
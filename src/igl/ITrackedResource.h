@@ -25,6 +25,9 @@ class ITrackedResource {
  public:
   virtual ~ITrackedResource() {
     if (resourceTracker_) {
+      if (memoryInfo_) {
+        resourceTracker_->willDeallocate(static_cast<T&>(*this), *memoryInfo_);
+      }
       resourceTracker_->willDelete(static_cast<T&>(*this));
     }
   }
@@ -42,8 +45,25 @@ class ITrackedResource {
     }
   }
 
+  /**
+   * @brief initResourceTracker() sets up tracking with the tracker and reports the memory used by
+   * the resource via IResourceTracker::didAllocate(). Textures and buffers only.
+   */
+  void initResourceTracker(std::shared_ptr<IResourceTracker> tracker,
+                           ResourceMemoryInfo memoryInfo) {
+    if (IGL_VERIFY(!resourceTracker_)) {
+      resourceTracker_ = std::move(tracker);
+      if (resourceTracker_) {
+        resourceTracker_->didCreate(static_cast<T&>(*this));
+        memoryInfo_ = std::make_unique<ResourceMemoryInfo>(std::move(memoryInfo));
+        resourceTracker_->didAllocate(static_cast<T&>(*this), *memoryInfo_);
+      }
+    }
+  }
+
  private:
   std::shared_ptr<IResourceTracker> resourceTracker_;
+  std::unique_ptr<ResourceMemoryInfo> memoryInfo_;
 };
 
 } // namespace igl
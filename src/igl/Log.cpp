@@ -7,12 +7,19 @@
 
 #define IGL_COMMON_SKIP_CHECK
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdarg>
+#include <cstdint>
 #include <cstdio>
 #include <igl/Core.h>
 #include <igl/Log.h>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_set>
 
 #if IGL_PLATFORM_ANDROID
@@ -33,6 +40,207 @@ static IGLLogHandlerFunc* GetHandle() {
   return &sHandler;
 }
 
+static int CallHandler(IGLLogLevel logLevel, const char* IGL_RESTRICT format, ...) {
+  va_list ap;
+  va_start(ap, format);
+  const int result = (*GetHandle())(logLevel, format, ap);
+  va_end(ap);
+  return result;
+}
+
+namespace {
+
+// Longer messages are truncated in asynchronous mode
+constexpr size_t kAsyncMessageLength = 512;
+// Must be a power of two
+constexpr size_t kAsyncQueueSize = 1024;
+// How often a message that keeps repeating is reported
+constexpr auto kRepeatReportInterval = std::chrono::seconds(1);
+
+// Bounded multi-producer, single-consumer ring buffer (Vyukov): a producer claims a slot with a
+// single CAS and never blocks; if the ring is full the message is rejected.
+class AsyncLogQueue {
+ public:
+  AsyncLogQueue() {
+    for (size_t i = 0; i != kAsyncQueueSize; i++) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Returns the vsnprintf() result, or -1 if the queue is full
+  int push(IGLLogLevel logLevel, const char* IGL_RESTRICT format, va_list ap) {
+    size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+      slot = &slots_[pos & (kAsyncQueueSize - 1)];
+      const size_t seq = slot->sequence.load(std::memory_order_acquire);
+      const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return -1;
+      } else {
+        pos = enqueuePos_.load(std::memory_order_relaxed);
+      }
+    }
+    slot->logLevel = logLevel;
+    FOLLY_PUSH_WARNING
+    FOLLY_GNU_DISABLE_WARNING("-Wformat-nonliteral")
+    const int result = vsnprintf(slot->text, kAsyncMessageLength, format, ap);
+    FOLLY_POP_WARNING
+    if (result < 0) {
+      slot->text[0] = 0;
+    }
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return result;
+  }
+
+  // Must only be called from the consumer thread
+  bool pop(IGLLogLevel& logLevel, std::string& text) {
+    Slot& slot = slots_[dequeuePos_ & (kAsyncQueueSize - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != dequeuePos_ + 1) {
+      return false;
+    }
+    logLevel = slot.logLevel;
+    text.assign(slot.text);
+    slot.sequence.store(dequeuePos_ + kAsyncQueueSize, std::memory_order_release);
+    dequeuePos_++;
+    return true;
+  }
+
+ private:
+  struct Slot {
+    std::atomic<size_t> sequence{0};
+    IGLLogLevel logLevel = IGLLogLevel::LOG_INFO;
+    char text[kAsyncMessageLength] = {};
+  };
+  std::array<Slot, kAsyncQueueSize> slots_;
+  std::atomic<size_t> enqueuePos_{0};
+  size_t dequeuePos_ = 0;
+};
+
+std::atomic<bool> sAsyncEnabled{false};
+
+class AsyncLogger {
+ public:
+  AsyncLogger() : thread_([this]() { run(); }) {}
+
+  ~AsyncLogger() {
+    sAsyncEnabled.store(false, std::memory_order_release);
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+  }
+
+  int log(IGLLogLevel logLevel, const char* IGL_RESTRICT format, va_list ap) {
+    const int result = queue_.push(logLevel, format, ap);
+    if (result < 0) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return 0;
+    }
+    pushed_.fetch_add(1, std::memory_order_release);
+    // Not taking the mutex here: a missed wake-up only delays the message until the next timeout
+    wake_.notify_one();
+    return result;
+  }
+
+  void flush() {
+    const uint64_t target = pushed_.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(mutex_);
+    flushRequested_ = true;
+    wake_.notify_one();
+    drained_.wait(lock, [this, target]() { return drainedCount_ >= target && !flushRequested_; });
+  }
+
+ private:
+  void run() {
+    std::string text;
+    std::string lastText;
+    IGLLogLevel logLevel = IGLLogLevel::LOG_INFO;
+    IGLLogLevel lastLogLevel = IGLLogLevel::LOG_INFO;
+    uint32_t repeats = 0;
+    auto lastRepeatReport = std::chrono::steady_clock::now();
+
+    auto reportRepeats = [&]() {
+      if (repeats) {
+        CallHandler(lastLogLevel, "[IGL] Last message repeated %u times\n", repeats);
+        repeats = 0;
+      }
+      lastRepeatReport = std::chrono::steady_clock::now();
+    };
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      const bool flushing = flushRequested_;
+      lock.unlock();
+
+      uint64_t count = 0;
+      while (queue_.pop(logLevel, text)) {
+        if (text == lastText && logLevel == lastLogLevel) {
+          repeats++;
+        } else {
+          reportRepeats();
+          CallHandler(logLevel, "%s", text.c_str());
+          lastText.swap(text);
+          lastLogLevel = logLevel;
+        }
+        count++;
+      }
+      const auto now = std::chrono::steady_clock::now();
+      if (flushing || now - lastRepeatReport >= kRepeatReportInterval) {
+        reportRepeats();
+      }
+      if (const uint32_t dropped = dropped_.exchange(0, std::memory_order_relaxed)) {
+        CallHandler(IGLLogLevel::LOG_WARNING,
+                    "[IGL] %u log messages dropped, the async log queue is full\n",
+                    dropped);
+      }
+
+      lock.lock();
+      drainedCount_ += count;
+      if (flushing) {
+        flushRequested_ = false;
+      }
+      drained_.notify_all();
+      if (stop_ && drainedCount_ >= pushed_.load(std::memory_order_acquire)) {
+        break;
+      }
+      wake_.wait_for(lock, kRepeatReportInterval, [this]() {
+        return stop_ || flushRequested_ ||
+               drainedCount_ != pushed_.load(std::memory_order_acquire);
+      });
+    }
+    reportRepeats();
+  }
+
+ private:
+  AsyncLogQueue queue_;
+  std::atomic<uint64_t> pushed_{0};
+  std::atomic<uint32_t> dropped_{0};
+  // Protected by mutex_
+  uint64_t drainedCount_ = 0;
+  bool flushRequested_ = false;
+  bool stop_ = false;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable drained_;
+  std::thread thread_;
+};
+
+// Created on first use and never destroyed before exit, so a thread still inside
+// IGLLogV() while asynchronous logging is being disabled cannot touch a dead logger
+AsyncLogger& GetAsyncLogger() {
+  static AsyncLogger sLogger;
+  return sLogger;
+}
+
+} // namespace
+
 IGL_API int IGLLog(IGLLogLevel logLevel, const char* IGL_RESTRICT format, ...) {
   va_list ap;
   va_start(ap, format);
@@ -71,6 +279,9 @@ IGL_API int IGLLogOnce(IGLLogLevel logLevel, const char* IGL_RESTRICT format, ..
 }
 
 IGL_API int IGLLogV(IGLLogLevel logLevel, const char* IGL_RESTRICT format, va_list ap) {
+  if (sAsyncEnabled.load(std::memory_order_acquire)) {
+    return GetAsyncLogger().log(logLevel, format, ap);
+  }
   return (*GetHandle())(logLevel, format, ap);
 }
 
@@ -90,3 +301,22 @@ IGL_API void IGLLogSetHandler(IGLLogHandlerFunc handler) {
 IGL_API IGLLogHandlerFunc IGLLogGetHandler() {
   return *GetHandle();
 }
+
+IGL_API void IGLLogSetAsync(bool async) {
+  if (async) {
+    GetAsyncLogger();
+    sAsyncEnabled.store(true, std::memory_order_release);
+  } else if (sAsyncEnabled.exchange(false, std::memory_order_acq_rel)) {
+    GetAsyncLogger().flush();
+  }
+}
+
+IGL_API bool IGLLogIsAsync() {
+  return sAsyncEnabled.load(std::memory_order_acquire);
+}
+
+IGL_API void IGLLogFlush() {
+  if (sAsyncEnabled.load(std::memory_order_acquire)) {
+    GetAsyncLogger().flush();
+  }
+}
@@ -38,22 +38,44 @@ using IGLLogHandlerFunc = int (*)(IGLLogLevel logLevel,
 IGL_API void IGLLogSetHandler(IGLLogHandlerFunc handler);
 IGL_API IGLLogHandlerFunc IGLLogGetHandler(void);
 
+///--------------------------------------
+/// MARK: - Asynchronous logging
+
+// When enabled, IGLLog*() only format the message into a lock-free ring buffer and a background
+// thread passes it on to the handler, so logging from hot paths never waits on stderr/logcat.
+// The handler is then called from that thread with an already formatted message ("%s").
+// Consecutive identical messages are collapsed into a periodic "repeated N times" line, and
+// messages logged while the ring buffer is full are dropped and reported as a count.
+IGL_API void IGLLogSetAsync(bool async);
+IGL_API bool IGLLogIsAsync(void);
+// Blocks until every message logged so far has been passed to the handler
+IGL_API void IGLLogFlush(void);
+
 ///--------------------------------------
 /// MARK: - Macros
 
+// Messages more verbose than IGL_LOG_LEVEL_MAX are compiled out, e.g. -DIGL_LOG_LEVEL_MAX=1 keeps
+// only errors. Values match IGLLogLevel.
+#ifndef IGL_LOG_LEVEL_MAX
+#define IGL_LOG_LEVEL_MAX 3
+#endif
+
 // Debug logging
-#if IGL_DEBUG || defined(IGL_FORCE_ENABLE_LOGS)
+#if (IGL_DEBUG || defined(IGL_FORCE_ENABLE_LOGS)) && IGL_LOG_LEVEL_MAX >= 1
 #define IGL_LOG_ERROR(format, ...)                                        \
   IGLLog(IGLLogLevel::LOG_ERROR, "[IGL] Error in (%s).\n", IGL_FUNCTION); \
   IGLLog(IGLLogLevel::LOG_ERROR, (format), ##__VA_ARGS__)
 #define IGL_LOG_ERROR_ONCE(format, ...) IGLLogOnce(IGLLogLevel::LOG_ERROR, (format), ##__VA_ARGS__)
+#else
+#define IGL_LOG_ERROR(format, ...) static_cast<void>(0)
+#define IGL_LOG_ERROR_ONCE(format, ...) static_cast<void>(0)
+#endif
 
+#if (IGL_DEBUG || defined(IGL_FORCE_ENABLE_LOGS)) && IGL_LOG_LEVEL_MAX >= 3
 #define IGL_LOG_INFO(format, ...) IGLLog(IGLLogLevel::LOG_INFO, (format), ##__VA_ARGS__)
 #define IGL_LOG_INFO_ONCE(format, ...) IGLLogOnce(IGLLogLevel::LOG_INFO, (format), ##__VA_ARGS__)
 #define IGL_DEBUG_LOG(format, ...) IGLLog(IGLLogLevel::LOG_INFO, (format), ##__VA_ARGS__)
 #else
-#define IGL_LOG_ERROR(format, ...) static_cast<void>(0)
-#define IGL_LOG_ERROR_ONCE(format, ...) static_cast<void>(0)
 #define IGL_LOG_INFO(format, ...) static_cast<void>(0)
 #define IGL_LOG_INFO_ONCE(format, ...) static_cast<void>(0)
 #define IGL_DEBUG_LOG(format, ...) static_cast<void>(0)
@@ -348,8 +348,6 @@
 ///--------------------------------------
 /// MARK: Integrated profiling
 
-#if defined(IGL_WITH_TRACY) && defined(__cplusplus)
-#include "tracy/Tracy.hpp"
 // predefined 0xRGB colors for "heavy" point-of-interest operations
 #define IGL_PROFILER_COLOR_WAIT 0xff0000
 #define IGL_PROFILER_COLOR_SUBMIT 0x0000ff
@@ -357,7 +355,14 @@
 #define IGL_PROFILER_COLOR_CREATE 0xff6600
 #define IGL_PROFILER_COLOR_DESTROY 0xffa500
 #define IGL_PROFILER_COLOR_TRANSITION 0xffffff
-//
+#define IGL_PROFILER_COLOR_DRAW 0x00ffff
+#define IGL_PROFILER_COLOR_UPLOAD 0xffff00
+
+// CPU zones, thread names, frame marks and plot counters. With Tracy (IGL_WITH_TRACY), or with
+// ATrace on Android (IGL_WITH_ATRACE), whose sections and counters are recorded by Perfetto and
+// systrace. ATrace has no colors, thread names or frame marks.
+#if defined(IGL_WITH_TRACY) && defined(__cplusplus)
+#include "tracy/Tracy.hpp"
 #define IGL_PROFILER_FUNCTION() ZoneScoped
 #define IGL_PROFILER_FUNCTION_COLOR(color) ZoneScopedC(color)
 #define IGL_PROFILER_ZONE(name, color) \
@@ -367,6 +372,38 @@
 #define IGL_PROFILER_ZONE_END() }
 #define IGL_PROFILER_THREAD(name) tracy::SetThreadName(name)
 #define IGL_PROFILER_FRAME(name) FrameMarkNamed(name)
+#define IGL_PROFILER_PLOT(name, value) TracyPlot(name, static_cast<int64_t>(value))
+#elif defined(IGL_WITH_ATRACE) && IGL_PLATFORM_ANDROID && defined(__cplusplus) && \
+    __ANDROID_API__ >= 23
+#include <android/trace.h>
+namespace igl::detail {
+// an ATrace section lasting for the lifetime of the object
+class ProfilerSection final {
+ public:
+  explicit ProfilerSection(const char* name) {
+    ATrace_beginSection(name);
+  }
+  ~ProfilerSection() {
+    ATrace_endSection();
+  }
+  ProfilerSection(const ProfilerSection&) = delete;
+  ProfilerSection& operator=(const ProfilerSection&) = delete;
+};
+} // namespace igl::detail
+#define IGL_PROFILER_FUNCTION() \
+  const igl::detail::ProfilerSection IGL_CONCAT(iglProfilerSection, __LINE__)(__func__)
+#define IGL_PROFILER_FUNCTION_COLOR(color) IGL_PROFILER_FUNCTION()
+#define IGL_PROFILER_ZONE(name, color) \
+  {                                    \
+    const igl::detail::ProfilerSection iglProfilerZone(name);
+#define IGL_PROFILER_ZONE_END() }
+#define IGL_PROFILER_THREAD(name)
+#define IGL_PROFILER_FRAME(name)
+#if __ANDROID_API__ >= 29
+#define IGL_PROFILER_PLOT(name, value) ATrace_setCounter(name, static_cast<int64_t>(value))
+#else
+#define IGL_PROFILER_PLOT(name, value)
+#endif // __ANDROID_API__ >= 29
 #else
 #define IGL_PROFILER_FUNCTION()
 #define IGL_PROFILER_FUNCTION_COLOR(color)
@@ -374,8 +411,20 @@
 #define IGL_PROFILER_ZONE_END() }
 #define IGL_PROFILER_THREAD(name)
 #define IGL_PROFILER_FRAME(name)
+#define IGL_PROFILER_PLOT(name, value)
 #endif // IGL_WITH_TRACY
 
+// GPU zones measure the commands recorded into a Vulkan command buffer while they are in scope,
+// with the Tracy Vulkan context of the VulkanContext (IGL_WITH_TRACY_GPU)
+#if defined(IGL_WITH_TRACY_GPU) && defined(__cplusplus)
+#define IGL_PROFILER_ZONE_GPU_VK(name, ctx, cmdBuffer) TracyVkZone(ctx, cmdBuffer, name)
+#define IGL_PROFILER_ZONE_GPU_COLOR_VK(name, ctx, cmdBuffer, color) \
+  TracyVkZoneC(ctx, cmdBuffer, name, color)
+#else
+#define IGL_PROFILER_ZONE_GPU_VK(name, ctx, cmdBuffer)
+#define IGL_PROFILER_ZONE_GPU_COLOR_VK(name, ctx, cmdBuffer, color)
+#endif // IGL_WITH_TRACY_GPU
+
 #ifndef IGL_ENUM_TO_STRING
 #define IGL_ENUM_TO_STRING(enum, res) \
   case enum ::res:                    \
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/MemoryReportTracker.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <tuple>
+
+namespace igl {
+
+namespace {
+
+constexpr size_t kNumLocations = 3;
+
+const char* toString(ResourceMemoryLocation location) {
+  switch (location) {
+  case ResourceMemoryLocation::Device:
+    return "device";
+  case ResourceMemoryLocation::Host:
+    return "host";
+  case ResourceMemoryLocation::Lazy:
+    return "lazy";
+  }
+  IGL_UNREACHABLE_RETURN("");
+}
+
+const char* toString(MemoryReportTracker::ResourceType type) {
+  switch (type) {
+  case MemoryReportTracker::ResourceType::Texture:
+    return "textures";
+  case MemoryReportTracker::ResourceType::Buffer:
+    return "buffers";
+  }
+  IGL_UNREACHABLE_RETURN("");
+}
+
+std::string formatBytes(size_t bytes) {
+  char str[64];
+  if (bytes >= 1024 * 1024) {
+    snprintf(str, sizeof(str), "%.2f MB", static_cast<double>(bytes) / (1024.0 * 1024.0));
+  } else if (bytes >= 1024) {
+    snprintf(str, sizeof(str), "%.2f KB", static_cast<double>(bytes) / 1024.0);
+  } else {
+    snprintf(str, sizeof(str), "%zu B", bytes);
+  }
+  return str;
+}
+
+std::string formatStats(const MemoryReportStats& stats) {
+  return formatBytes(stats.bytes) + " in " + std::to_string(stats.count) +
+         (stats.count == 1 ? " allocation" : " allocations");
+}
+
+void add(MemoryReportStats& stats, size_t bytes) {
+  stats.count++;
+  stats.bytes += bytes;
+}
+
+} // namespace
+
+void MemoryReportTracker::didAllocate(const ITexture& texture,
+                                      const ResourceMemoryInfo& info) noexcept {
+  addAllocation(&texture, ResourceType::Texture, info);
+}
+
+void MemoryReportTracker::willDeallocate(const ITexture& texture,
+                                         const ResourceMemoryInfo& /*info*/) noexcept {
+  removeAllocation(&texture);
+}
+
+void MemoryReportTracker::didAllocate(const IBuffer& buffer,
+                                      const ResourceMemoryInfo& info) noexcept {
+  addAllocation(&buffer, ResourceType::Buffer, info);
+}
+
+void MemoryReportTracker::willDeallocate(const IBuffer& buffer,
+                                         const ResourceMemoryInfo& /*info*/) noexcept {
+  removeAllocation(&buffer);
+}
+
+void MemoryReportTracker::pushTag(const char* tag) noexcept {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  tags_.emplace_back(tag ? tag : "");
+}
+
+void MemoryReportTracker::popTag() noexcept {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  IGL_ASSERT(!tags_.empty());
+  if (!tags_.empty()) {
+    tags_.pop_back();
+  }
+}
+
+void MemoryReportTracker::addAllocation(const void* resource,
+                                        ResourceType type,
+                                        const ResourceMemoryInfo& info) {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  const bool inserted =
+      allocations_.emplace(resource, Allocation{tags_.empty() ? "" : tags_.back(), type, info})
+          .second;
+  IGL_ASSERT_MSG(inserted, "Resource is already tracked");
+  if (inserted) {
+    totalBytes_ += info.sizeInBytes;
+    peakBytes_ = std::max(peakBytes_, totalBytes_);
+  }
+}
+
+void MemoryReportTracker::removeAllocation(const void* resource) {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = allocations_.find(resource);
+  IGL_ASSERT_MSG(it != allocations_.end(), "Resource is not tracked");
+  if (it != allocations_.end()) {
+    totalBytes_ -= it->second.info.sizeInBytes;
+    allocations_.erase(it);
+  }
+}
+
+MemoryReportStats MemoryReportTracker::getStats(const std::string& tag, ResourceType type) const {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  MemoryReportStats stats;
+  for (const auto& it : allocations_) {
+    if (it.second.type == type && it.second.tag == tag) {
+      add(stats, it.second.info.sizeInBytes);
+    }
+  }
+  return stats;
+}
+
+MemoryReportStats MemoryReportTracker::getStats(ResourceMemoryLocation location) const {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  MemoryReportStats stats;
+  for (const auto& it : allocations_) {
+    if (it.second.info.location == location) {
+      add(stats, it.second.info.sizeInBytes);
+    }
+  }
+  return stats;
+}
+
+size_t MemoryReportTracker::getTotalBytes() const {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  return totalBytes_;
+}
+
+size_t MemoryReportTracker::getPeakBytes() const {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  return peakBytes_;
+}
+
+std::string MemoryReportTracker::dump() const {
+  const std::lock_guard<std::mutex> lock(mutex_);
+
+  // tag -> (type, location) -> allocations
+  using Group = std::tuple<ResourceType, ResourceMemoryLocation>;
+  std::map<std::string, std::map<Group, std::vector<const Allocation*>>> tags;
+  MemoryReportStats total;
+  MemoryReportStats locations[kNumLocations];
+
+  for (const auto& it : allocations_) {
+    const Allocation& allocation = it.second;
+    tags[allocation.tag][Group(allocation.type, allocation.info.location)].push_back(&allocation);
+    add(total, allocation.info.sizeInBytes);
+    add(locations[static_cast<size_t>(allocation.info.location)], allocation.info.sizeInBytes);
+  }
+
+  std::string report =
+      "Live memory: " + formatStats(total) + ", peak " + formatBytes(peakBytes_) + "\n";
+  for (size_t i = 0; i != kNumLocations; i++) {
+    report += std::string("  ") + toString(static_cast<ResourceMemoryLocation>(i)) + ": " +
+              formatStats(locations[i]) + "\n";
+  }
+
+  for (const auto& tag : tags) {
+    MemoryReportStats tagStats;
+    for (const auto& group : tag.second) {
+      for (const Allocation* allocation : group.second) {
+        add(tagStats, allocation->info.sizeInBytes);
+      }
+    }
+    report += "[" + (tag.first.empty() ? std::string("untagged") : tag.first) +
+              "]: " + formatStats(tagStats) + "\n";
+
+    for (const auto& group : tag.second) {
+      std::vector<const Allocation*> allocations = group.second;
+      std::sort(allocations.begin(), allocations.end(), [](const auto* a, const auto* b) {
+        return a->info.sizeInBytes > b->info.sizeInBytes;
+      });
+      MemoryReportStats groupStats;
+      for (const Allocation* allocation : allocations) {
+        add(groupStats, allocation->info.sizeInBytes);
+      }
+      report += std::string("  ") + toString(std::get<0>(group.first)) + ", " +
+                toString(std::get<1>(group.first)) + ": " + formatStats(groupStats) + "\n";
+      for (const Allocation* allocation : allocations) {
+        report += "    " + formatBytes(allocation->info.sizeInBytes) + " " +
+                  (allocation->info.debugName.empty() ? "<unnamed>" : allocation->info.debugName) +
+                  "\n";
+      }
+    }
+  }
+
+  return report;
+}
+
+} // namespace igl
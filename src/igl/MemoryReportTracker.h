@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/IResourceTracker.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace igl {
+
+/**
+ * @brief Number of live allocations and the bytes they use
+ */
+struct MemoryReportStats {
+  size_t count = 0;
+  size_t bytes = 0;
+};
+
+/**
+ * @brief MemoryReportTracker is a built-in IResourceTracker which keeps a live report of the
+ * memory used by textures and buffers. Allocations are grouped by the tag which was on top of the
+ * tag stack when they were created (see pushTag()), then by resource type and memory location.
+ * dump() returns the report as a human-readable string, e.g. to log it when memory spikes.
+ *
+ * Install it with IDevice::setResourceTracker(). It is safe to create and destroy resources on
+ * multiple threads.
+ */
+class MemoryReportTracker final : public IResourceTracker {
+ public:
+  enum class ResourceType : uint8_t { Texture, Buffer };
+
+  void didCreate(const ITexture& /*texture*/) noexcept override {}
+  void willDelete(const ITexture& /*texture*/) noexcept override {}
+  void didCreate(const IBuffer& /*buffer*/) noexcept override {}
+  void willDelete(const IBuffer& /*buffer*/) noexcept override {}
+  void didCreate(const IFramebuffer& /*framebuffer*/) noexcept override {}
+  void willDelete(const IFramebuffer& /*framebuffer*/) noexcept override {}
+  void didCreate(const ISamplerState& /*samplerState*/) noexcept override {}
+  void willDelete(const ISamplerState& /*samplerState*/) noexcept override {}
+  void didCreate(const IShaderLibrary& /*shaderLibrary*/) noexcept override {}
+  void willDelete(const IShaderLibrary& /*shaderLibrary*/) noexcept override {}
+  void didCreate(const IShaderModule& /*shaderModule*/) noexcept override {}
+  void willDelete(const IShaderModule& /*shaderModule*/) noexcept override {}
+  void didCreate(const IShaderStages& /*shaderStages*/) noexcept override {}
+  void willDelete(const IShaderStages& /*shaderStages*/) noexcept override {}
+
+  void didAllocate(const ITexture& texture, const ResourceMemoryInfo& info) noexcept override;
+  void willDeallocate(const ITexture& texture, const ResourceMemoryInfo& info) noexcept override;
+  void didAllocate(const IBuffer& buffer, const ResourceMemoryInfo& info) noexcept override;
+  void willDeallocate(const IBuffer& buffer, const ResourceMemoryInfo& info) noexcept override;
+
+  void pushTag(const char* tag) noexcept override;
+  void popTag() noexcept override;
+
+  /**
+   * @return Live allocations of the given type created under `tag`. Allocations created with an
+   * empty tag stack use the empty tag.
+   */
+  [[nodiscard]] MemoryReportStats getStats(const std::string& tag, ResourceType type) const;
+  /// @return All live allocations in the given memory location
+  [[nodiscard]] MemoryReportStats getStats(ResourceMemoryLocation location) const;
+  /// @return Bytes used by all live allocations
+  [[nodiscard]] size_t getTotalBytes() const;
+  /// @return The highest value getTotalBytes() has reached since the tracker was created
+  [[nodiscard]] size_t getPeakBytes() const;
+
+  /**
+   * @return The report of all live allocations: totals per memory location followed by every tag,
+   * resource type and memory location with its allocations, largest first.
+   */
+  [[nodiscard]] std::string dump() const;
+
+ private:
+  struct Allocation {
+    std::string tag;
+    ResourceType type = ResourceType::Texture;
+    ResourceMemoryInfo info;
+  };
+
+  void addAllocation(const void* resource, ResourceType type, const ResourceMemoryInfo& info);
+  void removeAllocation(const void* resource);
+
+  mutable std::mutex mutex_;
+  std::vector<std::string> tags_;
+  std::unordered_map<const void*, Allocation> allocations_;
+  size_t totalBytes_ = 0;
+  size_t peakBytes_ = 0;
+};
+
+} // namespace igl
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/CommandEncoder.h>
+#include <igl/Common.h>
+#include <igl/RenderCommandEncoder.h>
+#include <vector>
+
+namespace igl {
+
+/**
+ * @brief IParallelRenderCommandEncoder splits a single render pass into multiple
+ * IRenderCommandEncoders which can be recorded concurrently.
+ *
+ * Every child encoder renders into the same render pass the parallel encoder was created with.
+ * Child encoders may be recorded on different threads, but each individual child encoder must only
+ * be used by one thread at a time. The GPU executes child encoders in the order they were created,
+ * regardless of the order in which their recording finishes.
+ *
+ * All child encoders must have called endEncoding() before endEncoding() is called on the parallel
+ * encoder itself. Child encoders and the parallel encoder must be created and ended before the
+ * owning command buffer is submitted.
+ */
+class IParallelRenderCommandEncoder : public ICommandEncoder {
+ public:
+  using ICommandEncoder::ICommandEncoder;
+
+  ~IParallelRenderCommandEncoder() override = default;
+
+  /**
+   * @brief Create a child RenderCommandEncoder which records commands into the render pass of this
+   * encoder. This function is thread-safe.
+   * @returns a pointer to the RenderCommandEncoder
+   */
+  virtual std::unique_ptr<IRenderCommandEncoder> createRenderCommandEncoder(
+      Result* IGL_NULLABLE outResult) = 0;
+
+  // Use an overload here instead of a default parameter in a pure virtual function.
+  std::unique_ptr<IRenderCommandEncoder> createRenderCommandEncoder() {
+    return createRenderCommandEncoder(nullptr);
+  }
+
+  /**
+   * @brief Create `count` child RenderCommandEncoders at once, e.g. one per worker thread. Since
+   * children execute in creation order, creating them up front fixes the order of the parts of the
+   * pass before any thread starts recording.
+   * @returns the encoders in execution order, or an empty vector if any of them failed
+   */
+  std::vector<std::unique_ptr<IRenderCommandEncoder>> createRenderCommandEncoders(
+      size_t count,
+      Result* IGL_NULLABLE outResult = nullptr) {
+    std::vector<std::unique_ptr<IRenderCommandEncoder>> encoders;
+    encoders.reserve(count);
+    for (size_t i = 0; i != count; i++) {
+      auto encoder = createRenderCommandEncoder(outResult);
+      if (!encoder) {
+        return {};
+      }
+      encoders.push_back(std::move(encoder));
+    }
+    Result::setOk(outResult);
+    return encoders;
+  }
+};
+
+} // namespace igl
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/Common.h>
+#include <string>
+
+namespace igl {
+
+/**
+ * @brief The kind of results collected by an IQueryPool
+ */
+enum class QueryType : uint8_t {
+  /// Samples passing the depth and stencil tests, see IRenderCommandEncoder::beginOcclusionQuery()
+  Occlusion,
+  /// Pipeline statistics, see ICommandBuffer::beginPipelineStatisticsQuery()
+  PipelineStatistics,
+};
+
+/**
+ * @brief Describes an IQueryPool
+ */
+struct QueryPoolDesc {
+  QueryType type = QueryType::Occlusion;
+  /** @brief Number of queries in the pool */
+  uint32_t queryCount = 1;
+  /** @brief Identifier used for debugging */
+  std::string debugName;
+};
+
+/**
+ * @brief Results of a pipeline statistics query
+ */
+struct PipelineStatistics {
+  uint64_t inputAssemblyVertices = 0;
+  uint64_t inputAssemblyPrimitives = 0;
+  uint64_t vertexShaderInvocations = 0;
+  uint64_t clippingInvocations = 0;
+  uint64_t clippingPrimitives = 0;
+  uint64_t fragmentShaderInvocations = 0;
+  uint64_t computeShaderInvocations = 0;
+};
+
+/**
+ * @brief IQueryPool is a fixed-size array of GPU queries of the same type.
+ *
+ * Occlusion queries are recorded into the render pass which has the pool set as
+ * RenderPassDesc::occlusionQueryPool; all queries of the pool are reset when such a render pass
+ * begins. Pipeline statistics queries are recorded into a command buffer, outside of command
+ * encoders, and are reset when they begin.
+ *
+ * Results become available asynchronously once the GPU has executed the command buffer which wrote
+ * them. Getting results never blocks, so pools can be polled every frame. Keep a small ring of
+ * pools to read back results a few frames later without stalling.
+ */
+class IQueryPool {
+ public:
+  virtual ~IQueryPool() = default;
+
+  [[nodiscard]] virtual QueryType getType() const = 0;
+  [[nodiscard]] virtual uint32_t getQueryCount() const = 0;
+
+  /**
+   * @brief Reads back the results of occlusion queries. Never blocks.
+   * @param firstQuery Index of the first query
+   * @param numQueries Number of consecutive queries to read back
+   * @param outSamplesPassed Receives one value per query: non-zero if any samples passed. Backends
+   * which count samples (Vulkan, desktop OpenGL) return the number of samples.
+   * @return false if the results of some queries are not available yet
+   */
+  [[nodiscard]] virtual bool getOcclusionResults(uint32_t firstQuery,
+                                                 uint32_t numQueries,
+                                                 uint64_t* IGL_NONNULL outSamplesPassed) const = 0;
+
+  /**
+   * @brief Reads back the results of pipeline statistics queries. Never blocks.
+   * @param firstQuery Index of the first query
+   * @param numQueries Number of consecutive queries to read back
+   * @param outStatistics Receives one PipelineStatistics per query
+   * @return false if the results of some queries are not available yet
+   */
+  [[nodiscard]] virtual bool getPipelineStatistics(
+      uint32_t /*firstQuery*/,
+      uint32_t /*numQueries*/,
+      PipelineStatistics* IGL_NONNULL /*outStatistics*/) const {
+    return false;
+  }
+};
+
+} // namespace igl
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/Common.h>
+#include <memory>
+
+namespace igl {
+
+class IRenderCommandEncoder;
+
+/**
+ * @brief IRenderBundle holds render commands which are recorded once and executed by any number of
+ * render passes, e.g. the draws of static UI or scenery which do not change between frames.
+ *
+ * Commands are recorded through the IRenderCommandEncoder returned by record() and executed with
+ * IRenderCommandEncoder::executeRenderBundle(). Executing a bundle does not re-encode its commands
+ * on the application side. The resources used by the recorded commands are read when the bundle is
+ * executed, so buffer contents can change between frames, but textures and index and indirect
+ * buffers must stay alive for as long as the bundle is executed.
+ *
+ * A bundle must not be recorded while a render pass which executes it is being encoded.
+ */
+class IRenderBundle {
+ public:
+  virtual ~IRenderBundle() = default;
+
+  /**
+   * @brief Drops the previously recorded commands and returns an encoder which records new ones
+   * into this bundle. The encoder does not belong to a command buffer and must be ended with
+   * endEncoding() before the bundle is executed.
+   * @param outResult Pointer to where the result (success, failure, etc) is written. Can be null if
+   * no reporting is desired.
+   */
+  virtual std::unique_ptr<IRenderCommandEncoder> record(Result* IGL_NULLABLE outResult) = 0;
+
+  /** @brief Returns true if no commands have been recorded */
+  [[nodiscard]] virtual bool empty() const = 0;
+};
+
+} // namespace igl
@@ -17,6 +17,7 @@ namespace igl {
 
 class IBuffer;
 class IDepthStencilState;
+class IRenderBundle;
 class IRenderPipelineState;
 class ISamplerState;
 class ITexture;
@@ -26,6 +27,17 @@ struct RenderCommandEncoderDesc {
   // Placeholder
 };
 
+/// Size in pixels of the blocks whose pixels are all shaded by one fragment shader invocation
+enum class ShadingRate : uint8_t {
+  Rate1x1 = 0,
+  Rate1x2,
+  Rate2x1,
+  Rate2x2,
+  Rate2x4,
+  Rate4x2,
+  Rate4x4,
+};
+
 namespace BindTarget {
 const uint8_t kVertex = 0x0001;
 const uint8_t kFragment = 0x0002;
@@ -85,6 +97,19 @@ class IRenderCommandEncoder : public ICommandEncoder {
                            IndexFormat indexFormat,
                            IBuffer& indexBuffer,
                            size_t indexBufferOffset) = 0;
+  /// Draws `instanceCount` instances. The attributes of the input bindings using
+  /// VertexSampleFunction::Instance advance once per instance. Requires
+  /// DeviceFeatures::DrawInstanced
+  virtual void drawInstanced(PrimitiveType primitiveType,
+                             size_t vertexStart,
+                             size_t vertexCount,
+                             uint32_t instanceCount) = 0;
+  virtual void drawIndexedInstanced(PrimitiveType primitiveType,
+                                    size_t indexCount,
+                                    IndexFormat indexFormat,
+                                    IBuffer& indexBuffer,
+                                    size_t indexBufferOffset,
+                                    uint32_t instanceCount) = 0;
   // NOTE: indexBufferOffset parameter is supported in Metal but not OpenGL
   virtual void drawIndexedIndirect(PrimitiveType primitiveType,
                                    IndexFormat indexFormat,
@@ -103,11 +128,45 @@ class IRenderCommandEncoder : public ICommandEncoder {
                                         size_t indirectBufferOffset,
                                         uint32_t drawCount,
                                         uint32_t stride = 0) = 0;
+  // The number of draws is read from `countBuffer` at `countBufferOffset` (a uint32_t) on the GPU
+  // and clamped to `maxDrawCount`. Requires DeviceFeatures::MultiDrawIndirectCount
+  virtual void multiDrawIndexedIndirectCount(PrimitiveType primitiveType,
+                                             IndexFormat indexFormat,
+                                             IBuffer& indexBuffer,
+                                             IBuffer& indirectBuffer,
+                                             size_t indirectBufferOffset,
+                                             IBuffer& countBuffer,
+                                             size_t countBufferOffset,
+                                             uint32_t maxDrawCount,
+                                             uint32_t stride = 0) = 0;
 
   virtual void setStencilReferenceValue(uint32_t value) = 0;
   virtual void setStencilReferenceValues(uint32_t frontValue, uint32_t backValue) = 0;
   virtual void setBlendColor(Color color) = 0;
   virtual void setDepthBias(float depthBias, float slopeScale, float clamp) = 0;
+
+  // Counts the samples which pass the depth and stencil tests until endOcclusionQuery() into the
+  // query `query` of RenderPassDesc::occlusionQueryPool. Occlusion queries cannot be nested.
+  // Requires DeviceFeatures::OcclusionQueries
+  virtual void beginOcclusionQuery(uint32_t /*query*/) {}
+  virtual void endOcclusionQuery() {}
+
+  // Shades the next draws at `rate`, e.g. 2x2 for low-detail regions such as the sky. Every render
+  // pass starts at 1x1. Rates the device does not support are replaced with the closest smaller
+  // one. On Vulkan, render passes with a FramebufferDesc::fragmentDensityMap take their rates
+  // from it instead. Requires DeviceFeatures::ShadingRate
+  virtual void setShadingRate(ShadingRate /*rate*/) {}
+
+  // Makes the color attachment writes of the previous draws visible to the framebuffer fetches of
+  // the next draws (RenderPassDesc::framebufferFetch). Metal and OpenGL fetches are coherent, so
+  // this only records a barrier on Vulkan. Requires DeviceFeatures::FramebufferFetch
+  virtual void framebufferFetchBarrier() {}
+
+  // Executes the commands recorded into `bundle`, see IDevice::createRenderBundle(). The state
+  // bound by the bundle stays bound afterwards
+  virtual void executeRenderBundle(const IRenderBundle& /*bundle*/) {
+    IGL_ASSERT_NOT_IMPLEMENTED();
+  }
 };
 
 } // namespace igl
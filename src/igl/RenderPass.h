@@ -8,11 +8,13 @@
 #pragma once
 
 #include <igl/Common.h>
+#include <memory>
 #include <vector>
 
 namespace igl {
 
 class IFramebuffer;
+class IQueryPool;
 class ITexture;
 
 /**
@@ -114,6 +116,19 @@ struct RenderPassDesc {
    * @brief stencilAttachment property which is clear to 0 by default
    */
   StencilAttachmentDesc stencilAttachment;
+  /**
+   * @brief Optional pool of occlusion queries written by this render pass. All its queries are
+   * reset when the render pass begins.
+   * @see IRenderCommandEncoder::beginOcclusionQuery()
+   */
+  std::shared_ptr<IQueryPool> occlusionQueryPool;
+  /**
+   * @brief Lets fragment shaders read the color attachments at their own pixel while this render
+   * pass writes them, so that a deferred lighting pass can read the G-buffer written earlier in
+   * the same pass without it ever leaving tile memory. Requires DeviceFeatures::FramebufferFetch.
+   * @see IRenderCommandEncoder::framebufferFetchBarrier()
+   */
+  bool framebufferFetch = false;
 };
 
 } // namespace igl
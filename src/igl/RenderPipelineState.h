@@ -167,6 +167,12 @@ struct RenderPipelineDesc {
 
   /*
    * @brief Describes the organization of per-vertex input data passed to a vertex shader function
+   *
+   * Can be null when the vertex shader fetches its vertices itself (vertex pulling), e.g. from
+   * storage buffers indexed by the vertex index. Such pipelines do not depend on the layout of the
+   * vertices, so meshes with different layouts share them and can be batched into one draw. On
+   * Vulkan, bind buffers created with both BufferTypeBits::Vertex and BufferTypeBits::Storage to
+   * BindTarget::kAllGraphics to read them by device address with getBuffer(slot).
    */
   std::shared_ptr<IVertexInputState> vertexInputState;
 
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/RingBuffer.h>
+
+namespace igl {
+
+RingBufferAllocator::RingBufferAllocator(size_t capacity, size_t alignment) :
+  capacity_(capacity), alignment_(alignment ? alignment : 1) {
+  IGL_ASSERT_MSG((alignment_ & (alignment_ - 1)) == 0, "Alignment must be a power of two");
+}
+
+size_t RingBufferAllocator::allocate(size_t size) {
+  if (size == 0 || size > capacity_) {
+    return kInvalidOffset;
+  }
+
+  size_t offset = (head_ + alignment_ - 1) & ~(alignment_ - 1);
+
+  if (offset + size > capacity_) {
+    // wrap around; the unused tail of the buffer is accounted as padding
+    offset = 0;
+  }
+
+  const size_t padding = offset >= head_ ? offset - head_ : capacity_ - head_;
+
+  // the used bytes form one contiguous (circular) range ending at head_
+  if (used_ + padding + size > capacity_) {
+    return kInvalidOffset;
+  }
+
+  head_ = offset + size;
+  used_ += padding + size;
+  currentFrameBytes_ += padding + size;
+
+  return offset;
+}
+
+void RingBufferAllocator::endFrame() {
+  frames_.push_back(currentFrameBytes_);
+  currentFrameBytes_ = 0;
+}
+
+void RingBufferAllocator::retireFrame() {
+  IGL_ASSERT(!frames_.empty());
+  if (frames_.empty()) {
+    return;
+  }
+  used_ -= frames_.front();
+  frames_.pop_front();
+  if (used_ == 0) {
+    // nothing is in flight, start over to avoid wrapping around
+    head_ = 0;
+  }
+}
+
+} // namespace igl
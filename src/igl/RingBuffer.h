@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <igl/Buffer.h>
+#include <igl/CommandQueue.h>
+#include <igl/Common.h>
+#include <string>
+
+namespace igl {
+
+/**
+ * @brief Describes an IRingBuffer.
+ */
+struct RingBufferDesc {
+  /** @brief Type of the underlying buffer, see igl::BufferDesc::BufferTypeBits */
+  BufferDesc::BufferType type = 0;
+  /** @brief Total capacity in bytes, shared by all frames in flight */
+  size_t length = 0;
+  /**
+   * @brief Alignment of every allocation. Must be a power of two and satisfy the binding
+   * requirements of `type`, e.g. DeviceFeatureLimits::BufferAlignment for uniform buffers.
+   */
+  size_t alignment = 256;
+  /** @brief Identifier used for debugging */
+  std::string debugName;
+};
+
+/**
+ * @brief A sub-range of IRingBuffer::getBuffer() returned by IRingBuffer::allocate().
+ */
+struct RingBufferAllocation {
+  /** @brief CPU pointer to the (persistently mapped) memory of the allocation */
+  void* IGL_NULLABLE data = nullptr;
+  /** @brief Offset of the allocation inside IRingBuffer::getBuffer(), used for binding */
+  size_t offset = 0;
+  /** @brief Size of the allocation in bytes */
+  size_t size = 0;
+
+  [[nodiscard]] bool empty() const {
+    return data == nullptr;
+  }
+};
+
+/**
+ * @brief IRingBuffer hands out aligned sub-ranges of a single persistently mapped buffer for
+ * per-frame dynamic data (uniforms, vertices, indices), without creating or mapping buffers every
+ * frame.
+ *
+ * Allocations made between two calls to endFrame() belong to the same frame. They are recycled
+ * once the GPU has finished executing the submission passed to endFrame(), so the CPU can write
+ * into the allocations directly and never overwrites data which is still in use by the GPU.
+ * allocate() never blocks: if all memory is used by frames in flight, it fails and the ring buffer
+ * should be created with a larger capacity.
+ */
+class IRingBuffer {
+ public:
+  virtual ~IRingBuffer() = default;
+
+  /**
+   * @brief Allocates `size` bytes aligned to RingBufferDesc::alignment for the current frame.
+   * @param outResult InvalidOperation if the ring buffer is full, ArgumentOutOfRange if `size`
+   * exceeds the capacity.
+   * @return An empty allocation on failure.
+   */
+  virtual RingBufferAllocation allocate(size_t size, Result* IGL_NULLABLE outResult) = 0;
+
+  /**
+   * @brief Closes the current frame. Its allocations are recycled once the submission `handle`,
+   * returned by ICommandQueue::submit(), has been executed by the GPU. Backends which do not return
+   * submit handles (OpenGL) insert a fence into the command stream instead.
+   */
+  virtual void endFrame(SubmitHandle handle) = 0;
+
+  /**
+   * @return The buffer all allocations are sub-allocated from. Bind it together with
+   * RingBufferAllocation::offset.
+   */
+  [[nodiscard]] virtual IBuffer& getBuffer() const = 0;
+};
+
+/**
+ * @brief Backend-agnostic bookkeeping of IRingBuffer implementations: allocates aligned ranges in
+ * FIFO order and tracks how many bytes every frame in flight uses. Backends retire frames in the
+ * order they were ended once their GPU work is complete.
+ */
+class RingBufferAllocator final {
+ public:
+  static constexpr size_t kInvalidOffset = SIZE_MAX;
+
+  RingBufferAllocator(size_t capacity, size_t alignment);
+
+  /// @return The offset of the allocated range or kInvalidOffset if there is not enough space
+  [[nodiscard]] size_t allocate(size_t size);
+  /// Closes the current frame. The frame might be empty.
+  void endFrame();
+  /// Frees all allocations of the oldest frame in flight
+  void retireFrame();
+
+  [[nodiscard]] size_t getNumFramesInFlight() const {
+    return frames_.size();
+  }
+  [[nodiscard]] size_t getCapacity() const {
+    return capacity_;
+  }
+
+ private:
+  size_t capacity_ = 0;
+  size_t alignment_ = 1;
+  // the next allocation starts at or after head_
+  size_t head_ = 0;
+  // bytes used by frames in flight and the current frame, including alignment padding
+  size_t used_ = 0;
+  size_t currentFrameBytes_ = 0;
+  // bytes used by every frame in flight, oldest first
+  std::deque<size_t> frames_;
+};
+
+} // namespace igl
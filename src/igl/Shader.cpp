@@ -63,8 +63,46 @@ bool ShaderCompilerOptions::operator!=(const ShaderCompilerOptions& other) const
   return !(*this == other);
 }
 
+ShaderSpecializationConstant ShaderSpecializationConstant::fromBool(uint32_t id,
+                                                                   std::string name,
+                                                                   bool value) {
+  return {id, std::move(name), Type::Bool, value ? 1u : 0u};
+}
+
+ShaderSpecializationConstant ShaderSpecializationConstant::fromInt(uint32_t id,
+                                                                  std::string name,
+                                                                  int32_t value) {
+  ShaderSpecializationConstant constant = {id, std::move(name), Type::Int};
+  memcpy(&constant.value, &value, sizeof(value));
+  return constant;
+}
+
+ShaderSpecializationConstant ShaderSpecializationConstant::fromUInt(uint32_t id,
+                                                                   std::string name,
+                                                                   uint32_t value) {
+  return {id, std::move(name), Type::UInt, value};
+}
+
+ShaderSpecializationConstant ShaderSpecializationConstant::fromFloat(uint32_t id,
+                                                                    std::string name,
+                                                                    float value) {
+  static_assert(sizeof(float) == sizeof(uint32_t));
+  ShaderSpecializationConstant constant = {id, std::move(name), Type::Float};
+  memcpy(&constant.value, &value, sizeof(value));
+  return constant;
+}
+
+bool ShaderSpecializationConstant::operator==(const ShaderSpecializationConstant& other) const {
+  return id == other.id && name == other.name && type == other.type && value == other.value;
+}
+
+bool ShaderSpecializationConstant::operator!=(const ShaderSpecializationConstant& other) const {
+  return !(*this == other);
+}
+
 bool ShaderModuleInfo::operator==(const ShaderModuleInfo& other) const {
-  return stage == other.stage && entryPoint == other.entryPoint;
+  return stage == other.stage && entryPoint == other.entryPoint &&
+         specializationConstants == other.specializationConstants;
 }
 
 bool ShaderModuleInfo::operator!=(const ShaderModuleInfo& other) const {
@@ -252,6 +290,10 @@ size_t std::hash<igl::ShaderModuleInfo>::operator()(igl::ShaderModuleInfo const&
   static_assert(std::is_same_v<uint8_t, std::underlying_type<igl::ShaderStage>::type>);
   size_t hash = std::hash<uint8_t>()(static_cast<uint8_t>(key.stage));
   hash ^= std::hash<std::string>()(key.entryPoint);
+  for (const auto& c : key.specializationConstants) {
+    igl::hashCombine(hash, c.id);
+    igl::hashCombine(hash, c.value);
+  }
   return hash;
 }
 
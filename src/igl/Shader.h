@@ -38,6 +38,34 @@ struct ShaderCompilerOptions {
   bool operator!=(const ShaderCompilerOptions& other) const;
 };
 
+/**
+ * @brief A constant whose value is provided when the shader module is created, so the shader
+ * compiler can fold branches and size arrays or workgroups at that point.
+ * Vulkan: a specialization constant, i.e. `layout (constant_id = id)`.
+ * Metal: a function constant, i.e. `[[function_constant(id)]]`.
+ * OpenGL: `#define name value` injected right after the `#version` directive.
+ */
+struct ShaderSpecializationConstant {
+  enum class Type : uint8_t { Bool, Int, UInt, Float };
+
+  /** @brief The Vulkan constant ID and the Metal function constant index. */
+  uint32_t id = 0;
+  /** @brief The name of the macro defined in OpenGL shaders. */
+  std::string name;
+  /** @brief The type of the constant. */
+  Type type = Type::Int;
+  /** @brief 32-bit value, reinterpreted according to the type. Bool is stored as 0 or 1. */
+  uint32_t value = 0;
+
+  static ShaderSpecializationConstant fromBool(uint32_t id, std::string name, bool value);
+  static ShaderSpecializationConstant fromInt(uint32_t id, std::string name, int32_t value);
+  static ShaderSpecializationConstant fromUInt(uint32_t id, std::string name, uint32_t value);
+  static ShaderSpecializationConstant fromFloat(uint32_t id, std::string name, float value);
+
+  bool operator==(const ShaderSpecializationConstant& other) const;
+  bool operator!=(const ShaderSpecializationConstant& other) const;
+};
+
 /**
  * @brief Metadata about a shader module.
  */
@@ -46,6 +74,8 @@ struct ShaderModuleInfo {
   ShaderStage stage = ShaderStage::Fragment;
   /** @brief The module's entry point. */
   std::string entryPoint;
+  /** @brief Values of the specialization constants used by the module. */
+  std::vector<ShaderSpecializationConstant> specializationConstants;
 
   bool operator==(const ShaderModuleInfo& other) const;
   bool operator!=(const ShaderModuleInfo& other) const;
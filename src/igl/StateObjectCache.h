@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/Common.h>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace igl {
+
+/**
+ * @brief Interns the state objects created by a device, so that equal descriptors give the same
+ * object while it is alive. Encoders can then skip redundant binds by comparing pointers.
+ *
+ * Only weak references are kept: a state is destroyed as soon as the application releases it, and
+ * the next request for its descriptor creates a new one. Thread-safe.
+ */
+template<typename Desc, typename State>
+class StateObjectCache final {
+ public:
+  /**
+   * @brief Returns the live state created for `desc`, or calls `create(outResult)` and interns the
+   * state it returns, unless it is null.
+   */
+  template<typename CreateFunc>
+  std::shared_ptr<State> getOrCreate(const Desc& desc, Result* outResult, CreateFunc&& create) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const auto it = states_.find(desc);
+    if (it != states_.end()) {
+      if (auto state = it->second.lock()) {
+        Result::setOk(outResult);
+        return state;
+      }
+    }
+
+    std::shared_ptr<State> state = create(outResult);
+    if (state) {
+      // forget the states which are not used anymore
+      for (auto i = states_.begin(); i != states_.end();) {
+        i = i->second.expired() ? states_.erase(i) : std::next(i);
+      }
+      states_[desc] = state;
+    }
+    return state;
+  }
+
+  /// Number of interned descriptors, including the ones whose state was released since the last
+  /// insertion
+  [[nodiscard]] size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return states_.size();
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<Desc, std::weak_ptr<State>> states_;
+};
+
+} // namespace igl
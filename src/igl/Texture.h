@@ -8,14 +8,18 @@
 #pragma once
 
 #include <algorithm>
+#include <iterator>
 #include <igl/ColorSpace.h>
 #include <igl/CommandQueue.h>
 #include <igl/Common.h>
 #include <igl/ITrackedResource.h>
 #include <igl/TextureFormat.h>
+#include <vector>
 
 namespace igl {
 
+class ITexture;
+
 /**
  * @brief TextureType denotes the possible storage components of the underlying surface for the
  * texture. For example, TwoD corresponds to 2-dimensional textures.
@@ -105,6 +109,19 @@ struct TextureRangeDesc {
   [[nodiscard]] TextureRangeDesc atLayer(size_t newLayer) const noexcept;
 };
 
+/**
+ * @brief One region of a batched upload, see ITexture::uploadRegions().
+ *
+ *  range       - The range of the texture to update
+ *  data        - The pixels of the range. Regions with a null pointer are skipped.
+ *  bytesPerRow - Number of bytes per row of data. If 0, it is computed assuming no padding.
+ */
+struct TextureRegionUpload {
+  TextureRangeDesc range;
+  const void* IGL_NULLABLE data = nullptr;
+  size_t bytesPerRow = 0;
+};
+
 /**
  * @brief Encapsulates properties of a texture format
  *
@@ -125,7 +142,11 @@ struct TextureRangeDesc {
  *                        - sRGB:       sRGB texture format
  */
 struct TextureFormatProperties {
-  static TextureFormatProperties fromTextureFormat(TextureFormat format);
+  /**
+   * @brief Returns the properties of `format` from a table built at compile time. Usable in
+   * constant expressions.
+   */
+  static constexpr TextureFormatProperties fromTextureFormat(TextureFormat format) noexcept;
 
   enum Flags : uint8_t {
     Depth = 1 << 0,
@@ -149,37 +170,37 @@ struct TextureFormatProperties {
   /**
    * @brief true for TextureFormat::Invalid
    */
-  [[nodiscard]] bool isValid() const noexcept {
+  [[nodiscard]] constexpr bool isValid() const noexcept {
     return format != TextureFormat::Invalid;
   }
   /**
    * @brief true compressed texture formats.
    */
-  [[nodiscard]] bool isCompressed() const noexcept {
+  [[nodiscard]] constexpr bool isCompressed() const noexcept {
     return (flags & Flags::Compressed) != 0;
   }
   /**
    * @brief true sRGB texture formats.
    */
-  [[nodiscard]] bool isSRGB() const noexcept {
+  [[nodiscard]] constexpr bool isSRGB() const noexcept {
     return (flags & Flags::sRGB) != 0;
   }
   /**
    * @brief true depth-only texture formats (e.g., TextureFormat::Z_UNorm24).
    */
-  [[nodiscard]] bool isDepthOnly() const noexcept {
+  [[nodiscard]] constexpr bool isDepthOnly() const noexcept {
     return (flags & Flags::Depth) != 0 && (flags & Flags::Stencil) == 0;
   }
   /**
    * @brief true stencil-only texture formats (e.g., TextureFormat::S_UInt8).
    */
-  [[nodiscard]] bool isStencilOnly() const noexcept {
+  [[nodiscard]] constexpr bool isStencilOnly() const noexcept {
     return (flags & Flags::Depth) == 0 && (flags & Flags::Stencil) != 0;
   }
   /**
    * @brief true depth-only, stencil-only and depth-stencil texture formats.
    */
-  [[nodiscard]] bool isDepthOrStencil() const noexcept {
+  [[nodiscard]] constexpr bool isDepthOrStencil() const noexcept {
     return (flags & Flags::Depth) != 0 || (flags & Flags::Stencil) != 0;
   }
 
@@ -194,7 +215,10 @@ struct TextureFormatProperties {
    * dimensions.
    * @return Calculated number of rows of texture data for the texture format.
    */
-  size_t getRows(TextureRangeDesc range) const noexcept;
+  [[nodiscard]] constexpr size_t getRows(TextureRangeDesc range) const noexcept {
+    const auto texHeight = std::max(range.height, static_cast<size_t>(1));
+    return isCompressed() ? getNumBlocks(texHeight, blockHeight, minBlocksY) : texHeight;
+  }
 
   /**
    * @brief Utility function to calculate the size in bytes per row for a texture format.
@@ -204,7 +228,11 @@ struct TextureFormatProperties {
    * subrange and/or mip level, which may be be less than the full texture width.
    * @return Calculated total size in bytes of a row of texture data for the texture format.
    */
-  [[nodiscard]] size_t getBytesPerRow(size_t texWidth) const noexcept;
+  [[nodiscard]] constexpr size_t getBytesPerRow(size_t texWidth) const noexcept {
+    texWidth = std::max(texWidth, static_cast<size_t>(1));
+    return (isCompressed() ? getNumBlocks(texWidth, blockWidth, minBlocksX) : texWidth) *
+           bytesPerBlock;
+  }
 
   /**
    * @brief Utility function to calculate the size in bytes per row for a texture format.
@@ -214,7 +242,9 @@ struct TextureFormatProperties {
    * subrange and/or mip level, which may be be less than the full texture width.
    * @return Calculated total size in bytes of a row of texture data for the texture format.
    */
-  [[nodiscard]] size_t getBytesPerRow(TextureRangeDesc range) const noexcept;
+  [[nodiscard]] constexpr size_t getBytesPerRow(TextureRangeDesc range) const noexcept {
+    return getBytesPerRow(range.width);
+  }
 
   /**
    * @brief Utility function to calculate the size in bytes per texture layer for a texture format.
@@ -227,9 +257,19 @@ struct TextureFormatProperties {
    * subrange and/or mip level, which may be be less than the full texture dimensions.
    * @return Calculated total size in bytes of a layer of texture data for the texture format.
    */
-  [[nodiscard]] size_t getBytesPerLayer(size_t texWidth,
-                                        size_t texHeight,
-                                        size_t texDepth) const noexcept;
+  [[nodiscard]] constexpr size_t getBytesPerLayer(size_t texWidth,
+                                                  size_t texHeight,
+                                                  size_t texDepth) const noexcept {
+    texWidth = std::max(texWidth, static_cast<size_t>(1));
+    texHeight = std::max(texHeight, static_cast<size_t>(1));
+    texDepth = std::max(texDepth, static_cast<size_t>(1));
+    if (isCompressed()) {
+      return getNumBlocks(texWidth, blockWidth, minBlocksX) *
+             getNumBlocks(texHeight, blockHeight, minBlocksY) *
+             getNumBlocks(texDepth, blockDepth, minBlocksZ) * bytesPerBlock;
+    }
+    return texWidth * texHeight * texDepth * bytesPerBlock;
+  }
 
   /**
    * @brief Utility function to calculate the size in bytes per texture layer for a texture format.
@@ -242,7 +282,9 @@ struct TextureFormatProperties {
    * the subrange and/or mip level, which may be be less than the full texture dimensions.
    * @return Calculated total size in bytes of a layer of texture data for the texture format.
    */
-  size_t getBytesPerLayer(TextureRangeDesc range) const noexcept;
+  [[nodiscard]] constexpr size_t getBytesPerLayer(TextureRangeDesc range) const noexcept {
+    return getBytesPerLayer(range.width, range.height, range.depth);
+  }
 
   /**
    * @brief Utility function to calculate the size in bytes per texture range for a texture format.
@@ -255,8 +297,149 @@ struct TextureFormatProperties {
    * @return Calculated total size in bytes of a the range of texture data for the texture format.
    */
   [[nodiscard]] size_t getBytesPerRange(TextureRangeDesc range) const noexcept;
+
+ private:
+  // number of blocks covering `size` pixels, at least `minBlocks`
+  static constexpr size_t getNumBlocks(size_t size, uint8_t blockSize, uint8_t minBlocks) noexcept {
+    return std::max((size + blockSize - 1) / blockSize, static_cast<size_t>(minBlocks));
+  }
 };
 
+namespace detail {
+
+using Flags = TextureFormatProperties::Flags;
+
+#define IGL_FORMAT_PROPERTIES(fmt, cpp, bpb, bw, bh, bd, mbx, mby, mbz, flgs) \
+  TextureFormatProperties{                                                  \
+      IGL_TO_STRING(fmt), TextureFormat::fmt, cpp, bpb, bw, bh, bd, mbx, mby, mbz, flgs}
+#define IGL_FORMAT_INVALID(fmt) IGL_FORMAT_PROPERTIES(fmt, 1, 1, 1, 1, 1, 1, 1, 1, 0)
+#define IGL_FORMAT_COLOR(fmt, cpp, bpb, flgs) \
+  IGL_FORMAT_PROPERTIES(fmt, cpp, bpb, 1, 1, 1, 1, 1, 1, flgs)
+#define IGL_FORMAT_COMPRESSED(fmt, cpp, bpb, bw, bh, bd, mbx, mby, mbz, flgs) \
+  IGL_FORMAT_PROPERTIES(fmt, cpp, bpb, bw, bh, bd, mbx, mby, mbz, flgs | Flags::Compressed)
+#define IGL_FORMAT_DEPTH(fmt, cpp, bpb) IGL_FORMAT_COLOR(fmt, cpp, bpb, Flags::Depth)
+#define IGL_FORMAT_DEPTH_STENCIL(fmt, cpp, bpb) \
+  IGL_FORMAT_COLOR(fmt, cpp, bpb, Flags::Depth | Flags::Stencil)
+
+// indexed by TextureFormat
+inline constexpr TextureFormatProperties kTextureFormatProperties[] = {
+    IGL_FORMAT_INVALID(Invalid),
+    IGL_FORMAT_COLOR(A_UNorm8, 1, 1, 0),
+    IGL_FORMAT_COLOR(L_UNorm8, 1, 1, 0),
+    IGL_FORMAT_COLOR(R_UNorm8, 1, 1, 0),
+    IGL_FORMAT_COLOR(R_F16, 1, 2, 0),
+    IGL_FORMAT_COLOR(R_UInt16, 1, 2, 0),
+    IGL_FORMAT_COLOR(R_UNorm16, 1, 2, 0),
+    IGL_FORMAT_COLOR(B5G5R5A1_UNorm, 4, 2, 0),
+    IGL_FORMAT_COLOR(B5G6R5_UNorm, 3, 2, 0),
+    IGL_FORMAT_COLOR(ABGR_UNorm4, 4, 2, 0),
+    IGL_FORMAT_COLOR(LA_UNorm8, 2, 2, 0),
+    IGL_FORMAT_COLOR(RG_UNorm8, 2, 2, 0),
+    IGL_FORMAT_COLOR(R4G2B2_UNorm_Apple, 3, 2, 0),
+    IGL_FORMAT_COLOR(R4G2B2_UNorm_Rev_Apple, 3, 2, 0),
+    IGL_FORMAT_COLOR(R5G5B5A1_UNorm, 4, 2, 0),
+    IGL_FORMAT_COLOR(RGBX_UNorm8, 3, 3, 0),
+    IGL_FORMAT_COLOR(RGBA_UNorm8, 4, 4, 0),
+    IGL_FORMAT_COLOR(BGRA_UNorm8, 4, 4, 0),
+    IGL_FORMAT_COLOR(BGRA_UNorm8_Rev, 4, 4, 0),
+    IGL_FORMAT_COLOR(RGBA_SRGB, 4, 4, Flags::sRGB),
+    IGL_FORMAT_COLOR(BGRA_SRGB, 4, 4, Flags::sRGB),
+    IGL_FORMAT_COLOR(RG_F16, 2, 4, 0),
+    IGL_FORMAT_COLOR(RG_UInt16, 2, 4, 0),
+    IGL_FORMAT_COLOR(RG_UNorm16, 2, 4, 0),
+    IGL_FORMAT_COLOR(RGB10_A2_UNorm_Rev, 4, 4, 0),
+    IGL_FORMAT_COLOR(RGB10_A2_Uint_Rev, 4, 4, 0),
+    IGL_FORMAT_COLOR(BGR10_A2_Unorm, 4, 4, 0),
+    IGL_FORMAT_COLOR(R_F32, 1, 4, 0),
+    IGL_FORMAT_COLOR(RGB_F16, 3, 6, 0),
+    IGL_FORMAT_COLOR(RGBA_F16, 4, 8, 0),
+    IGL_FORMAT_COLOR(RGB_F32, 3, 12, 0),
+    IGL_FORMAT_COLOR(RGBA_UInt32, 4, 16, 0),
+    IGL_FORMAT_COLOR(RGBA_F32, 4, 16, 0),
+    IGL_FORMAT_COMPRESSED(RGBA_ASTC_4x4, 4, 16, 4, 4, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(SRGB8_A8_ASTC_4x4, 4, 16, 4, 4, 1, 1, 1, 1, Flags::sRGB),
+    IGL_FORMAT_COMPRESSED(RGBA_ASTC_5x4, 4, 16, 5, 4, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(SRGB8_A8_ASTC_5x4, 4, 16, 5, 4, 1, 1, 1, 1, Flags::sRGB),
+    IGL_FORMAT_COMPRESSED(RGBA_ASTC_5x5, 4, 16, 5, 5, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(SRGB8_A8_ASTC_5x5, 4, 16, 5, 5, 1, 1, 1, 1, Flags::sRGB),
+    IGL_FORMAT_COMPRESSED(RGBA_ASTC_6x5, 4, 16, 6, 5, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(SRGB8_A8_ASTC_6x5, 4, 16, 6, 5, 1, 1, 1, 1, Flags::sRGB),
+    IGL_FORMAT_COMPRESSED(RGBA_ASTC_6x6, 4, 16, 6, 6, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(SRGB8_A8_ASTC_6x6, 4, 16, 6, 6, 1, 1, 1, 1, Flags::sRGB),
+    IGL_FORMAT_COMPRESSED(RGBA_ASTC_8x5, 4, 16, 8, 5, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(SRGB8_A8_ASTC_8x5, 4, 16, 8, 5, 1, 1, 1, 1, Flags::sRGB),
+    IGL_FORMAT_COMPRESSED(RGBA_ASTC_8x6, 4, 16, 8, 6, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(SRGB8_A8_ASTC_8x6, 4, 16, 8, 6, 1, 1, 1, 1, Flags::sRGB),
+    IGL_FORMAT_COMPRESSED(RGBA_ASTC_8x8, 4, 16, 8, 8, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(SRGB8_A8_ASTC_8x8, 4, 16, 8, 8, 1, 1, 1, 1, Flags::sRGB),
+    IGL_FORMAT_COMPRESSED(RGBA_ASTC_10x5, 4, 16, 10, 5, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(SRGB8_A8_ASTC_10x5, 4, 16, 10, 5, 1, 1, 1, 1, Flags::sRGB),
+    IGL_FORMAT_COMPRESSED(RGBA_ASTC_10x6, 4, 16, 10, 6, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(SRGB8_A8_ASTC_10x6, 4, 16, 10, 6, 1, 1, 1, 1, Flags::sRGB),
+    IGL_FORMAT_COMPRESSED(RGBA_ASTC_10x8, 4, 16, 10, 8, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(SRGB8_A8_ASTC_10x8, 4, 16, 10, 8, 1, 1, 1, 1, Flags::sRGB),
+    IGL_FORMAT_COMPRESSED(RGBA_ASTC_10x10, 4, 16, 10, 10, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(SRGB8_A8_ASTC_10x10, 4, 16, 10, 10, 1, 1, 1, 1, Flags::sRGB),
+    IGL_FORMAT_COMPRESSED(RGBA_ASTC_12x10, 4, 16, 12, 10, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(SRGB8_A8_ASTC_12x10, 4, 16, 12, 10, 1, 1, 1, 1, Flags::sRGB),
+    IGL_FORMAT_COMPRESSED(RGBA_ASTC_12x12, 4, 16, 12, 12, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(SRGB8_A8_ASTC_12x12, 4, 16, 12, 12, 1, 1, 1, 1, Flags::sRGB),
+    IGL_FORMAT_COMPRESSED(RGBA_PVRTC_2BPPV1, 4, 8, 8, 4, 1, 2, 2, 1, 0),
+    IGL_FORMAT_COMPRESSED(RGB_PVRTC_2BPPV1, 3, 8, 8, 4, 1, 2, 2, 1, 0),
+    IGL_FORMAT_COMPRESSED(RGBA_PVRTC_4BPPV1, 4, 8, 4, 4, 1, 2, 2, 1, 0),
+    IGL_FORMAT_COMPRESSED(RGB_PVRTC_4BPPV1, 3, 8, 4, 4, 1, 2, 2, 1, 0),
+    IGL_FORMAT_COMPRESSED(RGB8_ETC1, 3, 8, 4, 4, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(RGB8_ETC2, 3, 8, 4, 4, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(SRGB8_ETC2, 3, 8, 4, 4, 1, 1, 1, 1, Flags::sRGB),
+    IGL_FORMAT_COMPRESSED(RGB8_Punchthrough_A1_ETC2, 3, 8, 4, 4, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(SRGB8_Punchthrough_A1_ETC2, 3, 8, 4, 4, 1, 1, 1, 1, Flags::sRGB),
+    IGL_FORMAT_COMPRESSED(RGBA8_EAC_ETC2, 4, 16, 4, 4, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(SRGB8_A8_EAC_ETC2, 4, 16, 4, 4, 1, 1, 1, 1, Flags::sRGB),
+    IGL_FORMAT_COMPRESSED(RG_EAC_UNorm, 2, 16, 4, 4, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(RG_EAC_SNorm, 2, 16, 4, 4, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(R_EAC_UNorm, 1, 8, 4, 4, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(R_EAC_SNorm, 1, 8, 4, 4, 1, 1, 1, 1, 0),
+    IGL_FORMAT_COMPRESSED(RGBA_BC7_UNORM_4x4, 4, 16, 4, 4, 1, 1, 1, 1, 0),
+    IGL_FORMAT_DEPTH_STENCIL(Z_UNorm16, 1, 2),
+    IGL_FORMAT_DEPTH_STENCIL(Z_UNorm24, 1, 3),
+    IGL_FORMAT_DEPTH_STENCIL(Z_UNorm32, 1, 4),
+    IGL_FORMAT_DEPTH(S8_UInt_Z24_UNorm, 2, 4),
+#if IGL_PLATFORM_IOS
+    IGL_FORMAT_DEPTH(S8_UInt_Z32_UNorm, 2, 5),
+#else
+    IGL_FORMAT_DEPTH(S8_UInt_Z32_UNorm, 2, 8),
+#endif
+    IGL_FORMAT_DEPTH(S_UInt8, 1, 1),
+};
+
+#undef IGL_FORMAT_DEPTH_STENCIL
+#undef IGL_FORMAT_DEPTH
+#undef IGL_FORMAT_COMPRESSED
+#undef IGL_FORMAT_COLOR
+#undef IGL_FORMAT_INVALID
+#undef IGL_FORMAT_PROPERTIES
+
+constexpr bool isTextureFormatPropertiesTableValid() noexcept {
+  for (size_t i = 0; i != std::size(kTextureFormatProperties); ++i) {
+    if (kTextureFormatProperties[i].format != static_cast<TextureFormat>(i)) {
+      return false;
+    }
+  }
+  return std::size(kTextureFormatProperties) == static_cast<size_t>(TextureFormat::S_UInt8) + 1;
+}
+static_assert(isTextureFormatPropertiesTableValid(),
+              "kTextureFormatProperties must have one entry per TextureFormat, in order");
+
+} // namespace detail
+
+constexpr TextureFormatProperties TextureFormatProperties::fromTextureFormat(
+    TextureFormat format) noexcept {
+  const auto index = static_cast<size_t>(format);
+  return index < std::size(detail::kTextureFormatProperties)
+             ? detail::kTextureFormatProperties[index]
+             : detail::kTextureFormatProperties[0];
+}
+
 /**
  * @brief TextureCubeFace denotes side of the face in a cubemap setting.
    Based on https://www.khronos.org/opengl/wiki/Cubemap_Texture
@@ -280,10 +463,16 @@ enum class TextureCubeFace : uint8_t { PosX = 0, NegX, PosY, NegY, PosZ, NegZ };
  *  numLayers          - Number of layers for array texture
  *  numSamples         - Number of samples for multisampling
  *  usage              - Bitwise flag for containing a mask of TextureUsageBits
- *  options            - Bitwise flag for containing other options
+ *  options            - Bitwise flag for containing a mask of TextureOptionBits
  *  numMipLevels       - Number of mipmaps to generate
  *  format             - Internal texture format type
- *  storage            - Internal resource storage type
+ *  storage            - Internal resource storage type. ResourceStorage::Memoryless suits
+ *                       attachments which are neither loaded nor stored (e.g. MSAA color or depth)
+ *                       and lets tile-based GPUs keep them in tile memory
+ *  initialData        - Optional pixels of all layers and mip levels, uploaded while the texture is
+ *                       created. Layers (faces of cube textures) follow each other, and every layer
+ *                       holds its mip levels tightly packed, starting with level 0. The pointer is
+ *                       only read during creation and is not compared by operator==.
  */
 struct TextureDesc {
   /**
@@ -301,6 +490,20 @@ struct TextureDesc {
 
   using TextureUsage = uint8_t;
 
+  /**
+   * @brief Bitwise flags for other texture options
+   *
+   *  Sparse - The texture is partially resident: memory is committed and decommitted in tiles
+   *           with ICommandQueue::updateTextureTiles(). Requires DeviceFeatures::SparseTextures
+   *           and is only supported for 2D and 2D array textures with a single sample.
+   *  MutableFormat - Views created with IDevice::createTextureView() may reinterpret the texture
+   *                  as its sRGB/linear counterpart format.
+   */
+  enum TextureOptionBits : uint8_t {
+    Sparse = 1 << 0,
+    MutableFormat = 1 << 1,
+  };
+
   size_t width = 1;
   size_t height = 1;
   size_t depth = 1;
@@ -315,6 +518,8 @@ struct TextureDesc {
 
   std::string debugName = "";
 
+  const void* IGL_NULLABLE initialData = nullptr;
+
   bool operator==(const TextureDesc& rhs) const;
   bool operator!=(const TextureDesc& rhs) const;
 
@@ -478,6 +683,41 @@ struct TextureDesc {
   static uint32_t calcNumMipLevels(size_t width, size_t height);
 };
 
+/**
+ * @brief Descriptor for a view aliasing a subset of an existing texture without copying it
+ *
+ *  type         - Texture type of the view; TextureType::Invalid keeps the texture's type. A 2D
+ *                 texture may be viewed as a 2D array and vice versa, and a cube texture may be
+ *                 viewed as 2D or 2D array faces.
+ *  format       - Format of the view; TextureFormat::Invalid keeps the texture's format. Any other
+ *                 format must be the sRGB/linear counterpart of the texture's format and requires
+ *                 TextureDesc::TextureOptionBits::MutableFormat.
+ *  mipLevel     - First mip level of the texture visible through the view
+ *  numMipLevels - Number of mip levels in the view
+ *  layer        - First layer of the texture visible through the view. Layers of cube textures
+ *                 are faces, six per cube.
+ *  numLayers    - Number of layers in the view
+ */
+struct TextureViewDesc {
+  TextureType type = TextureType::Invalid;
+  TextureFormat format = TextureFormat::Invalid;
+  uint32_t mipLevel = 0;
+  uint32_t numMipLevels = 1;
+  uint32_t layer = 0;
+  uint32_t numLayers = 1;
+
+  std::string debugName = "";
+
+  /**
+   * @brief Replaces the defaulted type and format with the ones of the texture and validates the
+   * view against it.
+   *
+   * @param texture The texture the view aliases
+   * @return Result::Code::Ok if the view is valid for the texture
+   */
+  Result resolve(const ITexture& texture);
+};
+
 /**
  * @brief Interface class for all textures.
  * This should only be used for the purpose of getting information about the texture using the
@@ -521,6 +761,16 @@ class ITexture : public ITrackedResource<ITexture> {
                             const void* IGL_NULLABLE data,
                             size_t bytesPerRow = 0) const = 0;
 
+  /**
+   * @brief Uploads many small ranges at once, e.g. the glyphs added to an atlas during a frame.
+   * Backends which can batch the regions stage them together and copy them with as few commands
+   * as possible. The default implementation calls upload() for every region.
+   *
+   * @param regions     The ranges to update with their data.
+   * @return Result     The result of the first region which failed, if any.
+   */
+  virtual Result uploadRegions(const std::vector<TextureRegionUpload>& regions) const;
+
   // Texture Accessors Methods
   /**
    * @brief Returns the aspect ratio (width / height) of the texture.
@@ -615,6 +865,15 @@ class ITexture : public ITrackedResource<ITexture> {
    * @return uint64_t
    */
   [[nodiscard]] virtual uint64_t getTextureId() const = 0;
+  /**
+   * @brief Returns the size of a tile of a sparse texture (TextureDesc::TextureOptionBits::Sparse),
+   * in texels. Tiles are the granularity of ICommandQueue::updateTextureTiles().
+   *
+   * @return Dimensions. All zeros if the texture is not sparse.
+   */
+  [[nodiscard]] virtual Dimensions getTileSize() const {
+    return Dimensions(0, 0, 0);
+  }
 
   /**
    * @brief Validates the range against texture dimensions at the range's mip level.
@@ -631,6 +890,15 @@ class ITexture : public ITrackedResource<ITexture> {
    */
   [[nodiscard]] TextureRangeDesc getFullRange(size_t mipLevel = 0,
                                               size_t numMipLevels = 1) const noexcept;
+  /**
+   * @brief Splits TextureDesc::initialData into one region per layer and mip level, in the order
+   * they are laid out. The layers of cube textures are their faces.
+   *
+   * @param data Pixels laid out as described by TextureDesc::initialData.
+   * @return One region per layer and mip level.
+   */
+  [[nodiscard]] std::vector<TextureRegionUpload> getInitialDataRegions(const void* IGL_NONNULL
+                                                                           data) const;
   /**
    * @brief A helper function to quickly access TextureFormat.
    *
@@ -652,6 +920,9 @@ struct SurfaceTextures {
   std::shared_ptr<igl::ITexture> color;
   /** @brief The surface's depth texture. */
   std::shared_ptr<igl::ITexture> depth;
+  /** @brief Optional fragment density map of a foveated surface, see
+   * FramebufferDesc::fragmentDensityMap. */
+  std::shared_ptr<igl::ITexture> fragmentDensityMap;
 };
 
 } // namespace igl
@@ -209,6 +209,18 @@ constexpr bool isTextureFormatsRGB(TextureFormat textureFormat) {
   return textureFormat == TextureFormat::RGBA_SRGB || textureFormat == TextureFormat::BGRA_SRGB;
 }
 
+/// Returns the linear counterpart of an sRGB format, or the format itself if it is not sRGB
+constexpr TextureFormat getLinearTextureFormat(TextureFormat textureFormat) {
+  switch (textureFormat) {
+  case TextureFormat::RGBA_SRGB:
+    return TextureFormat::RGBA_UNorm8;
+  case TextureFormat::BGRA_SRGB:
+    return TextureFormat::BGRA_UNorm8;
+  default:
+    return textureFormat;
+  }
+}
+
 constexpr bool isTextureFormatBGR(TextureFormat textureFormat) {
   return textureFormat == TextureFormat::BGRA_SRGB || textureFormat == TextureFormat::BGRA_UNorm8;
 }
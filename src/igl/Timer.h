@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/Common.h>
+
+namespace igl {
+
+/**
+ * @brief ITimer measures the GPU time spent executing the commands recorded between
+ * ICommandBuffer::beginTimer() and ICommandBuffer::endTimer().
+ *
+ * Results become available asynchronously, usually a few frames after the command buffer has been
+ * submitted. resultsAvailable() never blocks, so timers can be polled every frame. To measure every
+ * frame without stalling, keep a small ring of timers and reuse a timer once its results have been
+ * read back.
+ */
+class ITimer {
+ public:
+  virtual ~ITimer() = default;
+
+  /**
+   * @brief Checks if the GPU has finished executing the measured commands. Never blocks.
+   * @returns true if getElapsedTimeNanos() returns the result of the last measurement
+   */
+  [[nodiscard]] virtual bool resultsAvailable() const = 0;
+
+  /**
+   * @returns the GPU time between beginTimer() and endTimer() in nanoseconds, or 0 if the results
+   * are not available yet
+   */
+  [[nodiscard]] virtual uint64_t getElapsedTimeNanos() const = 0;
+};
+
+} // namespace igl
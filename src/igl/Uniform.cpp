@@ -7,8 +7,17 @@
 
 #include <igl/Uniform.h>
 
+#include <cstring>
 #include <igl/Common.h>
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define IGL_UNIFORM_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IGL_UNIFORM_SSE2 1
+#endif
+
 namespace igl {
 
 size_t sizeForUniformType(UniformType type) {
@@ -39,6 +48,14 @@ size_t sizeForUniformType(UniformType type) {
     return sizeof(float[3][3]);
   case UniformType::Mat4x4:
     return sizeof(float[4][4]);
+  case UniformType::Float16:
+    return sizeof(Float16);
+  case UniformType::Float16x2:
+    return sizeof(Float16x2);
+  case UniformType::Float16x3:
+    return sizeof(Float16x3);
+  case UniformType::Float16x4:
+    return sizeof(Float16x4);
   default:
     IGL_ASSERT_NOT_IMPLEMENTED(); // missing enum case
     return 0;
@@ -69,10 +86,129 @@ size_t sizeForUniformElementType(UniformType type) {
   case UniformType::Int4:
     return sizeof(int32_t);
 
+  case UniformType::Float16:
+  case UniformType::Float16x2:
+  case UniformType::Float16x3:
+  case UniformType::Float16x4:
+    return sizeof(Float16);
+
   default:
     IGL_ASSERT_NOT_IMPLEMENTED(); // missing enum case
     return 0;
   }
 }
 
+UniformType halfUniformType(UniformType type) {
+  switch (type) {
+  case UniformType::Float:
+    return UniformType::Float16;
+  case UniformType::Float2:
+    return UniformType::Float16x2;
+  case UniformType::Float3:
+    return UniformType::Float16x3;
+  case UniformType::Float4:
+    return UniformType::Float16x4;
+  default:
+    return type;
+  }
+}
+
+uint16_t floatToHalf(float value) {
+  uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+  const uint32_t absBits = bits & 0x7FFFFFFFu;
+
+  // infinity and NaN, keeping NaNs quiet
+  if (absBits >= 0x7F800000u) {
+    return static_cast<uint16_t>(sign | (absBits > 0x7F800000u ? 0x7E00u : 0x7C00u));
+  }
+  // 2^16 and above overflow, [65520, 65536) rounds up to infinity below
+  if (absBits >= 0x47800000u) {
+    return static_cast<uint16_t>(sign | 0x7C00u);
+  }
+  // below 2^-14: subnormal half, 2^-25 and below round to zero
+  if (absBits < 0x38800000u) {
+    if (absBits <= 0x33000000u) {
+      return sign;
+    }
+    const uint32_t mantissa = (absBits & 0x007FFFFFu) | 0x00800000u;
+    const uint32_t shift = 126u - (absBits >> 23);
+    uint32_t half = mantissa >> shift;
+    const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+    const uint32_t midpoint = 1u << (shift - 1u);
+    if (remainder > midpoint || (remainder == midpoint && (half & 1u))) {
+      half++;
+    }
+    return static_cast<uint16_t>(sign | half);
+  }
+  // normal half: rebias the exponent from 127 to 15 and round the mantissa from 23 to 10 bits
+  uint32_t half = (absBits - 0x38000000u) >> 13;
+  const uint32_t remainder = absBits & 0x1FFFu;
+  if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+    half++;
+  }
+  return static_cast<uint16_t>(sign | half);
+}
+
+float halfToFloat(uint16_t bits) {
+  const uint32_t sign = static_cast<uint32_t>(bits & 0x8000u) << 16;
+  const uint32_t exponent = (bits >> 10) & 0x1Fu;
+  const uint32_t mantissa = bits & 0x3FFu;
+  if (exponent == 0) {
+    // zero and subnormals: mantissa * 2^-24
+    const float magnitude = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+    return sign ? -magnitude : magnitude;
+  }
+  const uint32_t floatBits = exponent == 0x1Fu
+                                 ? sign | 0x7F800000u | (mantissa << 13)
+                                 : sign | ((exponent + 112u) << 23) | (mantissa << 13);
+  float value = 0.0f;
+  std::memcpy(&value, &floatBits, sizeof(value));
+  return value;
+}
+
+void packFloat16(Float16* dst, const float* src, size_t count) {
+  for (size_t i = 0; i != count; i++) {
+    dst[i].bits = floatToHalf(src[i]);
+  }
+}
+
+void unpackFloat16(float* dst, const Float16* src, size_t count) {
+  for (size_t i = 0; i != count; i++) {
+    dst[i] = halfToFloat(src[i].bits);
+  }
+}
+
+void packPaddedFloat3Array(float* dst, const float* src, size_t count) {
+  size_t i = 0;
+#if IGL_UNIFORM_NEON
+  // de-interleaves 4 padded vectors into x, y, z and padding planes and interleaves x, y and z back
+  for (; i + 4 <= count; i += 4) {
+    const float32x4x4_t padded = vld4q_f32(src + i * 4);
+    float32x4x3_t packed;
+    packed.val[0] = padded.val[0];
+    packed.val[1] = padded.val[1];
+    packed.val[2] = padded.val[2];
+    vst3q_f32(dst + i * 3, packed);
+  }
+#elif IGL_UNIFORM_SSE2
+  // turns 4 padded vectors a, b, c and d into (a0 a1 a2 b0), (b1 b2 c0 c1) and (c2 d0 d1 d2)
+  for (; i + 4 <= count; i += 4) {
+    const __m128 a = _mm_loadu_ps(src + i * 4);
+    const __m128 b = _mm_loadu_ps(src + i * 4 + 4);
+    const __m128 c = _mm_loadu_ps(src + i * 4 + 8);
+    const __m128 d = _mm_loadu_ps(src + i * 4 + 12);
+    const __m128 a2b0 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 2, 2));
+    const __m128 c2d0 = _mm_shuffle_ps(c, d, _MM_SHUFFLE(0, 0, 2, 2));
+    _mm_storeu_ps(dst + i * 3, _mm_shuffle_ps(a, a2b0, _MM_SHUFFLE(2, 0, 1, 0)));
+    _mm_storeu_ps(dst + i * 3 + 4, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 2, 1)));
+    _mm_storeu_ps(dst + i * 3 + 8, _mm_shuffle_ps(c2d0, d, _MM_SHUFFLE(2, 1, 2, 0)));
+  }
+#endif
+  for (; i != count; i++) {
+    memcpy(dst + i * 3, src + i * 4, 3 * sizeof(float));
+  }
+}
+
 } // namespace igl
@@ -27,9 +27,52 @@ enum class UniformType : uint8_t {
   Int4,
   Mat2x2,
   Mat3x3,
-  Mat4x4
+  Mat4x4,
+  /// Half precision types, stored as Float16. Require DeviceFeatures::ShaderFloat16.
+  Float16,
+  Float16x2,
+  Float16x3,
+  Float16x4,
 };
 
+/// Converts a float to the bits of an IEEE 754 half float, rounding to nearest even. Values out
+/// of the half range become infinities.
+uint16_t floatToHalf(float value);
+float halfToFloat(uint16_t bits);
+
+/// Half float as stored in buffers: the members of UniformType::Float16 uniforms and the
+/// components of VertexAttributeFormat::HalfFloat attributes
+struct Float16 {
+  uint16_t bits = 0;
+
+  Float16() = default;
+  explicit Float16(float value) : bits(floatToHalf(value)) {}
+  explicit operator float() const {
+    return halfToFloat(bits);
+  }
+};
+
+struct Float16x2 {
+  Float16 x, y;
+};
+
+/// 6 bytes: Metal (half3) and std140 / std430 layouts align it to 8 bytes
+struct Float16x3 {
+  Float16 x, y, z;
+};
+
+struct Float16x4 {
+  Float16 x, y, z, w;
+};
+
+/// Converts `count` floats into consecutive half floats
+void packFloat16(Float16* dst, const float* src, size_t count);
+void unpackFloat16(float* dst, const Float16* src, size_t count);
+
+/// Copies `count` float3 values stored with a padding float each (e.g. simdtypes::float3, or the
+/// columns of a float3x3) into a tightly packed array of 3 * count floats
+void packPaddedFloat3Array(float* dst, const float* src, size_t count);
+
 /// Information required to be specified when binding non-block uniforms
 /// Only used when binding to opengl 2.0 shaders as uniform blocks are not supported in that
 /// version. Code that can use uniform blocks should use uniform blocks.
@@ -45,4 +88,7 @@ struct UniformDesc {
 size_t sizeForUniformType(UniformType type);
 size_t sizeForUniformElementType(UniformType type);
 
+/// Float16x<N> for Float<N> and Float16<xN> for Float16<xN>, otherwise the type itself
+UniformType halfUniformType(UniformType type);
+
 } // namespace igl
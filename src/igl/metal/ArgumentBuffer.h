@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <Metal/Metal.h>
+#include <igl/Buffer.h>
+#include <igl/SamplerState.h>
+#include <igl/Texture.h>
+#include <map>
+#include <vector>
+
+// MTLResidencySet is declared by the iOS 18 and macOS 15 SDKs
+#if (defined(__MAC_OS_X_VERSION_MAX_ALLOWED) && __MAC_OS_X_VERSION_MAX_ALLOWED >= 150000) || \
+    (defined(__IPHONE_OS_VERSION_MAX_ALLOWED) && __IPHONE_OS_VERSION_MAX_ALLOWED >= 180000)
+#define IGL_METAL_HAS_RESIDENCY_SETS 1
+#else
+#define IGL_METAL_HAS_RESIDENCY_SETS 0
+#endif
+
+namespace igl {
+namespace metal {
+
+class IndirectCommandBuffer;
+
+struct ArgumentBufferDesc {
+  enum class ArgumentType : uint8_t { Buffer, Texture, SamplerState, IndirectCommandBuffer };
+
+  struct Argument {
+    ArgumentType type = ArgumentType::Buffer;
+    // [[id(index)]] of the member of the argument buffer struct in the shader
+    size_t index = 0;
+    // only used by textures
+    TextureType textureType = TextureType::TwoD;
+    // true if the shader writes to the buffer or texture. Indirect command buffers are always
+    // writable
+    bool writable = false;
+  };
+
+  std::vector<Argument> arguments;
+};
+
+/**
+ * @brief A Metal argument buffer. The resources of e.g. a material are encoded into it once, and
+ * RenderCommandEncoder::bindArgumentBuffer() binds all of them with a single call, instead of one
+ * setFragmentTexture/setVertexBuffer call per resource and per draw.
+ *
+ * The encoder makes the referenced resources resident with useResource/useHeap, which Metal
+ * requires for resources that are only reachable through an argument buffer. On iOS 18 and
+ * macOS 15, the resources which are only read are made resident with a single residency set per
+ * command buffer instead. Ring buffers are encoded as the buffer current at the time of the call,
+ * so they should be re-encoded every frame.
+ */
+class ArgumentBuffer final {
+ public:
+  struct Resource {
+    id<MTLResource> resource = nil;
+    MTLResourceUsage usage = MTLResourceUsageRead;
+  };
+
+  ArgumentBuffer(id<MTLArgumentEncoder> encoder,
+                 id<MTLBuffer> buffer,
+                 std::vector<ArgumentBufferDesc::Argument> arguments);
+
+  void setBuffer(size_t index, IBuffer& buffer, size_t offset = 0);
+  void setTexture(size_t index, ITexture* texture);
+  void setSamplerState(size_t index, ISamplerState& samplerState);
+  /// Lets a compute kernel encode the commands of `commandBuffer` through this argument buffer
+  void setIndirectCommandBuffer(size_t index, const IndirectCommandBuffer& commandBuffer);
+
+  IGL_INLINE id<MTLBuffer> get() const {
+    return buffer_;
+  }
+
+  /// The resources referenced by the argument buffer, by argument index
+  [[nodiscard]] const std::map<size_t, Resource>& getResources() const {
+    return resources_;
+  }
+
+  /// MTLResidencySet of the resources which are only read, or nil before iOS 18 and macOS 15.
+  /// Written resources still go through useResource, which lets Metal track their hazards
+  [[nodiscard]] id getReadOnlyResidencySet() const;
+
+ private:
+  [[nodiscard]] const ArgumentBufferDesc::Argument* findArgument(
+      size_t index,
+      ArgumentBufferDesc::ArgumentType type) const;
+  void setResource(size_t index, const ArgumentBufferDesc::Argument& argument, id<MTLResource> res);
+
+  id<MTLArgumentEncoder> encoder_;
+  id<MTLBuffer> buffer_;
+  std::vector<ArgumentBufferDesc::Argument> arguments_;
+  std::map<size_t, Resource> resources_;
+  mutable id residencySet_ = nil;
+  mutable bool isResidencySetDirty_ = true;
+};
+
+} // namespace metal
+} // namespace igl
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/ArgumentBuffer.h>
+
+#include <igl/metal/Buffer.h>
+#include <igl/metal/IndirectCommandBuffer.h>
+#include <igl/metal/SamplerState.h>
+#include <igl/metal/Texture.h>
+
+namespace igl {
+namespace metal {
+
+ArgumentBuffer::ArgumentBuffer(id<MTLArgumentEncoder> encoder,
+                               id<MTLBuffer> buffer,
+                               std::vector<ArgumentBufferDesc::Argument> arguments) :
+  encoder_(encoder), buffer_(buffer), arguments_(std::move(arguments)) {
+  [encoder_ setArgumentBuffer:buffer_ offset:0];
+}
+
+const ArgumentBufferDesc::Argument* ArgumentBuffer::findArgument(
+    size_t index,
+    ArgumentBufferDesc::ArgumentType type) const {
+  for (const auto& argument : arguments_) {
+    if (argument.index == index) {
+      IGL_ASSERT_MSG(argument.type == type, "Argument %u has a different type", index);
+      return argument.type == type ? &argument : nullptr;
+    }
+  }
+  IGL_ASSERT_MSG(false, "Argument %u is not part of the argument buffer", index);
+  return nullptr;
+}
+
+void ArgumentBuffer::setResource(size_t index,
+                                 const ArgumentBufferDesc::Argument& argument,
+                                 id<MTLResource> res) {
+  isResidencySetDirty_ = true;
+  if (res == nil) {
+    resources_.erase(index);
+    return;
+  }
+  const bool writable =
+      argument.writable || argument.type == ArgumentBufferDesc::ArgumentType::IndirectCommandBuffer;
+  resources_[index] = {res,
+                       writable ? MTLResourceUsageRead | MTLResourceUsageWrite
+                                : MTLResourceUsageRead};
+}
+
+id ArgumentBuffer::getReadOnlyResidencySet() const {
+#if IGL_METAL_HAS_RESIDENCY_SETS
+  if (@available(macOS 15.0, iOS 18.0, *)) {
+    if (isResidencySetDirty_) {
+      isResidencySetDirty_ = false;
+      if (residencySet_ == nil) {
+        MTLResidencySetDescriptor* desc = [MTLResidencySetDescriptor new];
+        desc.label = @"Argument buffer resources";
+        desc.initialCapacity = resources_.size();
+        NSError* error = nil;
+        residencySet_ = [buffer_.device newResidencySetWithDescriptor:desc error:&error];
+        if (residencySet_ == nil) {
+          IGL_LOG_INFO("Cannot create residency set: %s\n",
+                       [error.localizedDescription UTF8String]);
+          return nil;
+        }
+      }
+      id<MTLResidencySet> residencySet = residencySet_;
+      [residencySet removeAllAllocations];
+      for (const auto& [argumentIndex, resource] : resources_) {
+        if ((resource.usage & MTLResourceUsageWrite) == 0) {
+          [residencySet addAllocation:resource.resource];
+        }
+      }
+      [residencySet commit];
+    }
+    return residencySet_;
+  }
+#endif
+  return nil;
+}
+
+void ArgumentBuffer::setBuffer(size_t index, IBuffer& buffer, size_t offset) {
+  const auto* argument = findArgument(index, ArgumentBufferDesc::ArgumentType::Buffer);
+  if (argument == nullptr) {
+    return;
+  }
+  id<MTLBuffer> metalBuffer = static_cast<Buffer&>(buffer).get();
+  [encoder_ setBuffer:metalBuffer offset:offset atIndex:index];
+  setResource(index, *argument, metalBuffer);
+}
+
+void ArgumentBuffer::setTexture(size_t index, ITexture* texture) {
+  const auto* argument = findArgument(index, ArgumentBufferDesc::ArgumentType::Texture);
+  if (argument == nullptr) {
+    return;
+  }
+  id<MTLTexture> metalTexture = texture ? static_cast<Texture*>(texture)->get() : nil;
+  [encoder_ setTexture:metalTexture atIndex:index];
+  setResource(index, *argument, metalTexture);
+}
+
+void ArgumentBuffer::setSamplerState(size_t index, ISamplerState& samplerState) {
+  // samplers don't need to be made resident
+  if (findArgument(index, ArgumentBufferDesc::ArgumentType::SamplerState) != nullptr) {
+    [encoder_ setSamplerState:static_cast<SamplerState&>(samplerState).get() atIndex:index];
+  }
+}
+
+void ArgumentBuffer::setIndirectCommandBuffer(size_t index,
+                                              const IndirectCommandBuffer& commandBuffer) {
+  const auto* argument =
+      findArgument(index, ArgumentBufferDesc::ArgumentType::IndirectCommandBuffer);
+  if (argument == nullptr) {
+    return;
+  }
+  if (@available(macOS 10.14, iOS 12.0, *)) {
+    [encoder_ setIndirectCommandBuffer:commandBuffer.get() atIndex:index];
+    setResource(index, *argument, commandBuffer.get());
+  }
+}
+
+} // namespace metal
+} // namespace igl
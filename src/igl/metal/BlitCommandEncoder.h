@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <Metal/Metal.h>
+#include <igl/BlitCommandEncoder.h>
+
+namespace igl {
+namespace metal {
+
+class BlitCommandEncoder final : public IBlitCommandEncoder {
+ public:
+  BlitCommandEncoder(std::shared_ptr<ICommandBuffer> commandBuffer,
+                     id<MTLBlitCommandEncoder> encoder);
+  ~BlitCommandEncoder() override = default;
+
+  void endEncoding() override;
+
+  void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
+  void insertDebugEventLabel(const std::string& label, const igl::Color& color) const override;
+  void popDebugGroupLabel() const override;
+
+  void copyBuffer(IBuffer& source,
+                  size_t sourceOffset,
+                  IBuffer& destination,
+                  size_t destinationOffset,
+                  size_t size) override;
+  void copyBufferToTexture(IBuffer& source,
+                           size_t sourceOffset,
+                           size_t sourceBytesPerRow,
+                           ITexture& destination,
+                           const TextureRangeDesc& range) override;
+  void copyTexture(ITexture& source,
+                   const TextureRangeDesc& sourceRange,
+                   ITexture& destination,
+                   const TextureRangeDesc& destinationRange) override;
+  void fillBuffer(IBuffer& buffer, size_t offset, size_t size, uint8_t value) override;
+  void generateMipmaps(ITexture& texture) override;
+
+ private:
+  id<MTLBlitCommandEncoder> encoder_ = nil;
+};
+
+} // namespace metal
+} // namespace igl
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/BlitCommandEncoder.h>
+
+#import <Foundation/Foundation.h>
+
+#import <Metal/Metal.h>
+#include <igl/metal/Buffer.h>
+#include <igl/metal/Texture.h>
+
+namespace igl {
+namespace metal {
+
+BlitCommandEncoder::BlitCommandEncoder(std::shared_ptr<ICommandBuffer> commandBuffer,
+                                       id<MTLBlitCommandEncoder> encoder) :
+  IBlitCommandEncoder(std::move(commandBuffer)), encoder_(encoder) {}
+
+void BlitCommandEncoder::endEncoding() {
+  IGL_ASSERT(encoder_);
+  [encoder_ endEncoding];
+  encoder_ = nil;
+}
+
+void BlitCommandEncoder::pushDebugGroupLabel(const std::string& label,
+                                             const igl::Color& /*color*/) const {
+  IGL_ASSERT(encoder_);
+  IGL_ASSERT(!label.empty());
+  [encoder_ pushDebugGroup:[NSString stringWithUTF8String:label.c_str()] ?: @""];
+}
+
+void BlitCommandEncoder::insertDebugEventLabel(const std::string& label,
+                                               const igl::Color& /*color*/) const {
+  IGL_ASSERT(encoder_);
+  IGL_ASSERT(!label.empty());
+  [encoder_ insertDebugSignpost:[NSString stringWithUTF8String:label.c_str()] ?: @""];
+}
+
+void BlitCommandEncoder::popDebugGroupLabel() const {
+  IGL_ASSERT(encoder_);
+  [encoder_ popDebugGroup];
+}
+
+void BlitCommandEncoder::copyBuffer(IBuffer& source,
+                                    size_t sourceOffset,
+                                    IBuffer& destination,
+                                    size_t destinationOffset,
+                                    size_t size) {
+  IGL_ASSERT(encoder_);
+  auto& srcBuffer = static_cast<Buffer&>(source);
+  auto& dstBuffer = static_cast<Buffer&>(destination);
+  [encoder_ copyFromBuffer:srcBuffer.get()
+              sourceOffset:sourceOffset
+                  toBuffer:dstBuffer.get()
+         destinationOffset:destinationOffset
+                      size:size];
+}
+
+void BlitCommandEncoder::copyBufferToTexture(IBuffer& source,
+                                             size_t sourceOffset,
+                                             size_t sourceBytesPerRow,
+                                             ITexture& destination,
+                                             const TextureRangeDesc& range) {
+  IGL_ASSERT(encoder_);
+  IGL_ASSERT(range.numMipLevels == 1);
+  auto& srcBuffer = static_cast<Buffer&>(source);
+  auto& dstTexture = static_cast<Texture&>(destination);
+
+  const auto properties = destination.getProperties();
+  const size_t bytesPerRow =
+      sourceBytesPerRow ? sourceBytesPerRow : properties.getBytesPerRow(range);
+  // the size of one depth slice of a 3D texture or of one layer of an array texture
+  const size_t bytesPerImage = bytesPerRow * properties.getRows(range);
+
+  // Metal copies one layer at a time
+  for (size_t layer = 0; layer != range.numLayers; ++layer) {
+    [encoder_ copyFromBuffer:srcBuffer.get()
+                   sourceOffset:sourceOffset + layer * bytesPerImage * range.depth
+              sourceBytesPerRow:bytesPerRow
+            sourceBytesPerImage:bytesPerImage
+                     sourceSize:MTLSizeMake(range.width, range.height, range.depth)
+                      toTexture:dstTexture.get()
+               destinationSlice:range.layer + layer
+               destinationLevel:range.mipLevel
+              destinationOrigin:MTLOriginMake(range.x, range.y, range.z)];
+  }
+}
+
+void BlitCommandEncoder::copyTexture(ITexture& source,
+                                     const TextureRangeDesc& sourceRange,
+                                     ITexture& destination,
+                                     const TextureRangeDesc& destinationRange) {
+  IGL_ASSERT(encoder_);
+  IGL_ASSERT(sourceRange.numMipLevels == 1);
+  IGL_ASSERT(source.getFormat() == destination.getFormat());
+  auto& srcTexture = static_cast<Texture&>(source);
+  auto& dstTexture = static_cast<Texture&>(destination);
+
+  for (size_t layer = 0; layer != sourceRange.numLayers; ++layer) {
+    [encoder_ copyFromTexture:srcTexture.get()
+                  sourceSlice:sourceRange.layer + layer
+                  sourceLevel:sourceRange.mipLevel
+                 sourceOrigin:MTLOriginMake(sourceRange.x, sourceRange.y, sourceRange.z)
+                   sourceSize:MTLSizeMake(sourceRange.width, sourceRange.height, sourceRange.depth)
+                    toTexture:dstTexture.get()
+             destinationSlice:destinationRange.layer + layer
+             destinationLevel:destinationRange.mipLevel
+            destinationOrigin:MTLOriginMake(
+                                  destinationRange.x, destinationRange.y, destinationRange.z)];
+  }
+}
+
+void BlitCommandEncoder::fillBuffer(IBuffer& buffer, size_t offset, size_t size, uint8_t value) {
+  IGL_ASSERT(encoder_);
+  auto& mtlBuffer = static_cast<Buffer&>(buffer);
+  [encoder_ fillBuffer:mtlBuffer.get() range:NSMakeRange(offset, size) value:value];
+}
+
+void BlitCommandEncoder::generateMipmaps(ITexture& texture) {
+  IGL_ASSERT(encoder_);
+  if (texture.getNumMipLevels() > 1) {
+    [encoder_ generateMipmapsForTexture:static_cast<Texture&>(texture).get()];
+  }
+}
+
+} // namespace metal
+} // namespace igl
@@ -36,6 +36,13 @@ class BufferSynchronizationManager {
     return maxInFlightBuffers_;
   }
 
+  /**
+   * @brief Returns the number of frames ended with manageEndOfFrameSync()
+   */
+  uint64_t getFrameCount() const noexcept {
+    return frameCount_;
+  }
+
   void manageEndOfFrameSync();
 
   // Upon completion of this command buffer's execution, trigger buffer synchronization.
@@ -44,6 +51,7 @@ class BufferSynchronizationManager {
  private:
   size_t maxInFlightBuffers_ = 1;
   size_t currentInFlightBufferIndex_ = 0;
+  uint64_t frameCount_ = 0;
   dispatch_semaphore_t frameBoundarySemaphore_;
 };
 
@@ -49,6 +49,7 @@ void BufferSynchronizationManager::manageEndOfFrameSync() {
 
   // increment currentInFlightBufferIndex
   currentInFlightBufferIndex_ = (currentInFlightBufferIndex_ + 1) % maxInFlightBuffers_;
+  frameCount_++;
 }
 
 }
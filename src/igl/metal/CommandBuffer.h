@@ -9,29 +9,46 @@
 
 #include <Metal/Metal.h>
 #include <igl/CommandBuffer.h>
+#include <igl/metal/DeviceStatistics.h>
+#include <vector>
 
 namespace igl {
 namespace metal {
 
+class UploadArena;
+
 class CommandBuffer final : public ICommandBuffer,
                             public std::enable_shared_from_this<CommandBuffer> {
  public:
-  explicit CommandBuffer(id<MTLCommandBuffer> value);
+  explicit CommandBuffer(id<MTLCommandBuffer> value,
+                         std::shared_ptr<UploadArena> uploadArena = nullptr,
+                         const DeviceStatistics* deviceStatistics = nullptr);
   ~CommandBuffer() override = default;
 
   std::unique_ptr<IComputeCommandEncoder> createComputeCommandEncoder() override;
 
+  std::unique_ptr<IBlitCommandEncoder> createBlitCommandEncoder(Result* outResult) override;
+
   std::unique_ptr<IRenderCommandEncoder> createRenderCommandEncoder(
       const RenderPassDesc& renderPass,
       std::shared_ptr<IFramebuffer> framebuffer,
       Result* outResult) override;
 
+  std::unique_ptr<IParallelRenderCommandEncoder> createParallelRenderCommandEncoder(
+      const RenderPassDesc& renderPass,
+      std::shared_ptr<IFramebuffer> framebuffer,
+      Result* outResult) override;
+
   void present(std::shared_ptr<ITexture> surface) const override;
 
   void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
 
   void popDebugGroupLabel() const override;
 
+  void beginTimer(const std::shared_ptr<ITimer>& timer) override;
+
+  void endTimer(const std::shared_ptr<ITimer>& timer) override;
+
   void waitUntilScheduled() override;
 
   void waitUntilCompleted() override;
@@ -40,8 +57,31 @@ class CommandBuffer final : public ICommandBuffer,
     return value_;
   }
 
+  // nullptr if the command buffer was not created by a CommandQueue
+  IGL_INLINE const std::shared_ptr<UploadArena>& getUploadArena() const {
+    return uploadArena_;
+  }
+
+  // Samples the start and end of the render pass into the timestamps of the command buffer when
+  // DeviceStatistics::getEncoderTimestampsEnabled() is on
+  void sampleEncoderTimestamps(MTLRenderPassDescriptor* descriptor);
+
+  // Makes the allocations of an MTLResidencySet resident for the whole command buffer, once
+  void useResidencySet(id residencySet);
+
  private:
+  friend class CommandQueue;
+
+  // index of the first of the two samples of the next timed encoder, or false if it is not timed
+  bool nextEncoderSampleIndex(DeviceStatistics::EncoderType type, NSUInteger& outIndex);
+
   id<MTLCommandBuffer> value_;
+  std::shared_ptr<UploadArena> uploadArena_;
+  const DeviceStatistics* deviceStatistics_;
+  // MTLCounterSampleBuffer of the timed encoders; nil until the first one is created
+  id timestampSampleBuffer_ = nil;
+  std::vector<DeviceStatistics::EncoderType> timedEncoders_;
+  std::vector<id> residencySets_;
 };
 
 } // namespace metal
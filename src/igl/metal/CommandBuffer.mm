@@ -10,24 +10,79 @@
 #import <Foundation/Foundation.h>
 
 #import <Metal/Metal.h>
+#include <algorithm>
+#include <igl/metal/ArgumentBuffer.h>
+#include <igl/metal/BlitCommandEncoder.h>
 #include <igl/metal/ComputeCommandEncoder.h>
+#include <igl/metal/ParallelRenderCommandEncoder.h>
 #include <igl/metal/RenderCommandEncoder.h>
 #include <igl/metal/Texture.h>
+#include <igl/metal/Timer.h>
 
 namespace igl {
 namespace metal {
 
-CommandBuffer::CommandBuffer(id<MTLCommandBuffer> value) : value_(value) {}
+CommandBuffer::CommandBuffer(id<MTLCommandBuffer> value,
+                             std::shared_ptr<UploadArena> uploadArena,
+                             const DeviceStatistics* deviceStatistics) :
+  value_(value), uploadArena_(std::move(uploadArena)), deviceStatistics_(deviceStatistics) {}
 
 std::unique_ptr<IComputeCommandEncoder> CommandBuffer::createComputeCommandEncoder() {
-  return std::make_unique<ComputeCommandEncoder>(value_);
+  id<MTLComputeCommandEncoder> encoder = nil;
+  NSUInteger sampleIndex = 0;
+  if (nextEncoderSampleIndex(DeviceStatistics::EncoderType::Compute, sampleIndex)) {
+    if (@available(macOS 11.0, iOS 14.0, *)) {
+      MTLComputePassDescriptor* descriptor = [MTLComputePassDescriptor computePassDescriptor];
+      descriptor.dispatchType = MTLDispatchTypeConcurrent;
+      descriptor.sampleBufferAttachments[0].sampleBuffer = timestampSampleBuffer_;
+      descriptor.sampleBufferAttachments[0].startOfEncoderSampleIndex = sampleIndex;
+      descriptor.sampleBufferAttachments[0].endOfEncoderSampleIndex = sampleIndex + 1;
+      encoder = [value_ computeCommandEncoderWithDescriptor:descriptor];
+    }
+  }
+  if (encoder == nil) {
+    if (@available(macOS 10.14, iOS 12.0, *)) {
+      // the encoder inserts barriers between dependent dispatches, see ComputeCommandEncoder
+      encoder = [value_ computeCommandEncoderWithDispatchType:MTLDispatchTypeConcurrent];
+    } else {
+      encoder = [value_ computeCommandEncoder];
+    }
+  }
+  return std::make_unique<ComputeCommandEncoder>(shared_from_this(), encoder, uploadArena_);
+}
+
+std::unique_ptr<IBlitCommandEncoder> CommandBuffer::createBlitCommandEncoder(Result* outResult) {
+  id<MTLBlitCommandEncoder> encoder = [value_ blitCommandEncoder];
+  if (encoder == nil) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Could not create blit encoder");
+    return nullptr;
+  }
+  Result::setOk(outResult);
+  return std::make_unique<BlitCommandEncoder>(shared_from_this(), encoder);
 }
 
 std::unique_ptr<IRenderCommandEncoder> CommandBuffer::createRenderCommandEncoder(
     const RenderPassDesc& renderPass,
     std::shared_ptr<IFramebuffer> framebuffer,
     Result* outResult) {
-  return RenderCommandEncoder::create(shared_from_this(), renderPass, framebuffer, outResult);
+  auto encoder =
+      RenderCommandEncoder::create(shared_from_this(), renderPass, framebuffer, outResult);
+  if (encoder) {
+    incrementStatistic(CommandBufferCounter::RenderPasses);
+  }
+  return encoder;
+}
+
+std::unique_ptr<IParallelRenderCommandEncoder> CommandBuffer::createParallelRenderCommandEncoder(
+    const RenderPassDesc& renderPass,
+    std::shared_ptr<IFramebuffer> framebuffer,
+    Result* outResult) {
+  auto encoder = ParallelRenderCommandEncoder::create(
+      shared_from_this(), renderPass, framebuffer, outResult);
+  if (encoder) {
+    incrementStatistic(CommandBufferCounter::RenderPasses);
+  }
+  return encoder;
 }
 
 void CommandBuffer::present(std::shared_ptr<ITexture> surface) const {
@@ -51,6 +106,69 @@ void CommandBuffer::popDebugGroupLabel() const {
   [value_ popDebugGroup];
 }
 
+void CommandBuffer::beginTimer(const std::shared_ptr<ITimer>& timer) {
+  if (!IGL_VERIFY(timer)) {
+    return;
+  }
+  static_cast<Timer&>(*timer).begin();
+}
+
+void CommandBuffer::endTimer(const std::shared_ptr<ITimer>& timer) {
+  if (!IGL_VERIFY(timer)) {
+    return;
+  }
+  // the block keeps the timer alive until the command buffer has completed
+  std::shared_ptr<Timer> mtlTimer = std::static_pointer_cast<Timer>(timer);
+  [value_ addCompletedHandler:^(id<MTLCommandBuffer> commandBuffer) {
+    mtlTimer->onCompleted(commandBuffer);
+  }];
+}
+
+void CommandBuffer::useResidencySet(id residencySet) {
+#if IGL_METAL_HAS_RESIDENCY_SETS
+  if (@available(macOS 15.0, iOS 18.0, *)) {
+    if (residencySet == nil ||
+        std::find(residencySets_.begin(), residencySets_.end(), residencySet) !=
+            residencySets_.end()) {
+      return;
+    }
+    residencySets_.push_back(residencySet);
+    [value_ useResidencySet:residencySet];
+  }
+#endif
+}
+
+void CommandBuffer::sampleEncoderTimestamps(MTLRenderPassDescriptor* descriptor) {
+  NSUInteger sampleIndex = 0;
+  if (!nextEncoderSampleIndex(DeviceStatistics::EncoderType::Render, sampleIndex)) {
+    return;
+  }
+  if (@available(macOS 11.0, iOS 14.0, *)) {
+    descriptor.sampleBufferAttachments[0].sampleBuffer = timestampSampleBuffer_;
+    descriptor.sampleBufferAttachments[0].startOfVertexSampleIndex = sampleIndex;
+    descriptor.sampleBufferAttachments[0].endOfVertexSampleIndex = MTLCounterDontSample;
+    descriptor.sampleBufferAttachments[0].startOfFragmentSampleIndex = MTLCounterDontSample;
+    descriptor.sampleBufferAttachments[0].endOfFragmentSampleIndex = sampleIndex + 1;
+  }
+}
+
+bool CommandBuffer::nextEncoderSampleIndex(DeviceStatistics::EncoderType type,
+                                           NSUInteger& outIndex) {
+  if (deviceStatistics_ == nullptr ||
+      timedEncoders_.size() == DeviceStatistics::kMaxTimedEncoders) {
+    return false;
+  }
+  if (timestampSampleBuffer_ == nil) {
+    timestampSampleBuffer_ = deviceStatistics_->acquireSampleBuffer(value_.device);
+    if (timestampSampleBuffer_ == nil) {
+      return false;
+    }
+  }
+  outIndex = 2 * timedEncoders_.size();
+  timedEncoders_.push_back(type);
+  return true;
+}
+
 void CommandBuffer::waitUntilScheduled() {
   [value_ waitUntilScheduled];
 }
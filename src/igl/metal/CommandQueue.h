@@ -10,22 +10,39 @@
 #import <Metal/MTLCommandQueue.h>
 #include <igl/CommandQueue.h>
 #include <igl/metal/Device.h>
+#include <vector>
 
 namespace igl {
 namespace metal {
 
 class BufferSynchronizationManager;
 class DeviceStatistics;
+class TextureUploader;
+class UploadArena;
 
 class CommandQueue final : public ICommandQueue {
  public:
-  CommandQueue(id<MTLCommandQueue> value,
+  CommandQueue(const IDevice& device,
+               id<MTLCommandQueue> value,
                std::shared_ptr<BufferSynchronizationManager> syncManager,
+               std::shared_ptr<UploadArena> uploadArena,
+               std::shared_ptr<TextureUploader> textureUploader,
                DeviceStatistics& deviceStatistics) noexcept;
   std::shared_ptr<ICommandBuffer> createCommandBuffer(const CommandBufferDesc& desc,
                                                       Result* outResult) override;
+  /// Returns a handle which completes with the command buffer: the value the shared event of the
+  /// queue is signaled with. Handles increase monotonically. 0 if shared events are not supported
   SubmitHandle submit(const igl::ICommandBuffer& commandBuffer, bool endOfFrame = false) override;
 
+  /// True once the command buffer of `handle` and all the previous ones have completed. Never
+  /// blocks
+  [[nodiscard]] bool isCompleted(SubmitHandle handle) const;
+  /// Blocks until isCompleted(handle)
+  void waitUntilCompleted(SubmitHandle handle) const;
+  /// Command buffers created afterwards wait on the GPU for `handle` of `producer`, e.g. an async
+  /// compute queue, before they start
+  void waitForSubmitHandle(const CommandQueue& producer, SubmitHandle handle);
+
   IGL_INLINE id<MTLCommandQueue> get() const {
     return value_;
   }
@@ -34,9 +51,20 @@ class CommandQueue final : public ICommandQueue {
   void startCapture(id<MTLCommandQueue> queue);
   void stopCapture();
 
+  const IDevice& device_;
   id<MTLCommandQueue> value_;
   std::shared_ptr<BufferSynchronizationManager> bufferSyncManager_;
+  std::shared_ptr<UploadArena> uploadArena_;
+  std::shared_ptr<TextureUploader> textureUploader_;
   DeviceStatistics& deviceStatistics_;
+  // MTLSharedEvent signaled with the submit handles, nil before iOS 12 and macOS 10.14
+  id sharedEvent_ = nil;
+  SubmitHandle lastSubmitHandle_ = 0;
+  struct EventWait {
+    id event = nil;
+    SubmitHandle value = 0;
+  };
+  std::vector<EventWait> pendingWaits_;
 };
 
 } // namespace metal
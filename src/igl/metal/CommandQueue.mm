@@ -12,6 +12,7 @@
 #include <igl/metal/BufferSynchronizationManager.h>
 #include <igl/metal/CommandBuffer.h>
 #include <igl/metal/DeviceStatistics.h>
+#include <igl/metal/TextureUploader.h>
 
 // @brief Number of command buffers to be automatically captured for GPU debugging. Zero (0)
 // means no command buffers will be recorded and the capture code is deactivated.
@@ -26,10 +27,22 @@ constexpr uint32_t kIGLMetalEndCommandBufferToCapture =
 namespace igl {
 namespace metal {
 
-CommandQueue::CommandQueue(id<MTLCommandQueue> value,
+CommandQueue::CommandQueue(const IDevice& device,
+                           id<MTLCommandQueue> value,
                            std::shared_ptr<BufferSynchronizationManager> syncManager,
+                           std::shared_ptr<UploadArena> uploadArena,
+                           std::shared_ptr<TextureUploader> textureUploader,
                            DeviceStatistics& deviceStatistics) noexcept :
-  value_(value), bufferSyncManager_(std::move(syncManager)), deviceStatistics_(deviceStatistics) {
+  device_(device),
+  value_(value),
+  bufferSyncManager_(std::move(syncManager)),
+  uploadArena_(std::move(uploadArena)),
+  textureUploader_(std::move(textureUploader)),
+  deviceStatistics_(deviceStatistics) {
+  if (@available(macOS 10.14, iOS 12.0, *)) {
+    sharedEvent_ = [value_.device newSharedEvent];
+    [(id<MTLSharedEvent>)sharedEvent_ setLabel:@"Submit handles"];
+  }
   if constexpr (kIGLMetalNumberCommandBuffersToCapture > 0 &&
                 kIGLMetalBeginCommandBufferToCapture == 0) {
     startCapture(value_);
@@ -39,25 +52,52 @@ CommandQueue::CommandQueue(id<MTLCommandQueue> value,
 std::shared_ptr<ICommandBuffer> CommandQueue::createCommandBuffer(const CommandBufferDesc& /*desc*/,
                                                                   Result* outResult) {
   id<MTLCommandBuffer> metalObject = [value_ commandBuffer];
-  auto resource = std::make_shared<CommandBuffer>(metalObject);
+  if (@available(macOS 10.14, iOS 12.0, *)) {
+    // encoded before any work of the command buffer
+    for (const auto& wait : pendingWaits_) {
+      [metalObject encodeWaitForEvent:wait.event value:wait.value];
+    }
+  }
+  pendingWaits_.clear();
+  if (textureUploader_) {
+    // textures uploaded so far can be used by this command buffer
+    textureUploader_->encodeWaitForUploads(metalObject);
+  }
+  auto resource = std::make_shared<CommandBuffer>(metalObject, uploadArena_, &deviceStatistics_);
   Result::setOk(outResult);
   return resource;
 }
 
 SubmitHandle CommandQueue::submit(const igl::ICommandBuffer& commandBuffer, bool endOfFrame) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_SUBMIT);
+
   incrementDrawCount(commandBuffer.getCurrentDrawCount());
+  IGL_PROFILER_PLOT("IGL draws per submit", commandBuffer.getCurrentDrawCount());
   deviceStatistics_.incrementDrawCount(commandBuffer.getCurrentDrawCount());
 
   if (endOfFrame) {
     bufferSyncManager_->markCommandBufferAsEndOfFrame(commandBuffer);
   }
 
-  [static_cast<const CommandBuffer&>(commandBuffer).get() commit];
+  const auto& metalCommandBuffer = static_cast<const CommandBuffer&>(commandBuffer);
+  deviceStatistics_.addCompletedHandler(metalCommandBuffer.get(),
+                                        metalCommandBuffer.timestampSampleBuffer_,
+                                        metalCommandBuffer.timedEncoders_);
+  SubmitHandle handle = 0;
+  if (@available(macOS 10.14, iOS 12.0, *)) {
+    if (sharedEvent_ != nil) {
+      handle = ++lastSubmitHandle_;
+      [metalCommandBuffer.get() encodeSignalEvent:sharedEvent_ value:handle];
+    }
+  }
+  [metalCommandBuffer.get() commit];
 
   if (endOfFrame) {
     bufferSyncManager_->manageEndOfFrameSync();
   }
 
+  device_.checkMemoryPressure();
+
   if constexpr (kIGLMetalNumberCommandBuffersToCapture > 0) {
     static uint32_t currentCommandBuffer = 0;
     if ((currentCommandBuffer + 1) == kIGLMetalBeginCommandBufferToCapture) {
@@ -69,7 +109,42 @@ SubmitHandle CommandQueue::submit(const igl::ICommandBuffer& commandBuffer, bool
     ++currentCommandBuffer;
   }
 
-  return SubmitHandle{};
+  return handle;
+}
+
+bool CommandQueue::isCompleted(SubmitHandle handle) const {
+  if (@available(macOS 10.14, iOS 12.0, *)) {
+    if (sharedEvent_ != nil) {
+      return ((id<MTLSharedEvent>)sharedEvent_).signaledValue >= handle;
+    }
+  }
+  return handle == 0;
+}
+
+void CommandQueue::waitUntilCompleted(SubmitHandle handle) const {
+  if (sharedEvent_ == nil || isCompleted(handle)) {
+    return;
+  }
+  if (@available(macOS 10.14, iOS 12.0, *)) {
+    static MTLSharedEventListener* listener = [[MTLSharedEventListener alloc] init];
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    [(id<MTLSharedEvent>)sharedEvent_ notifyListener:listener
+                                             atValue:handle
+                                               block:^(id<MTLSharedEvent> /*event*/,
+                                                       uint64_t /*value*/) {
+                                                 dispatch_semaphore_signal(semaphore);
+                                               }];
+    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+  }
+}
+
+void CommandQueue::waitForSubmitHandle(const CommandQueue& producer, SubmitHandle handle) {
+  if (!IGL_VERIFY(producer.sharedEvent_ != nil || handle == 0)) {
+    return;
+  }
+  if (handle != 0 && &producer != this) {
+    pendingWaits_.push_back({producer.sharedEvent_, handle});
+  }
 }
 
 void CommandQueue::startCapture(id<MTLCommandQueue> queue) {
@@ -9,14 +9,23 @@
 
 #include <Metal/Metal.h>
 #include <igl/ComputeCommandEncoder.h>
+#include <igl/metal/ArgumentBuffer.h>
+#include <igl/metal/PushConstantBlock.h>
+#include <unordered_map>
+#include <vector>
 
 namespace igl {
 namespace metal {
 class Buffer;
+class UploadArena;
 
+/// Dispatches run concurrently on iOS 12 and macOS 10.14 and later. A dispatch only waits for the
+/// previous ones through a memory barrier if it binds a resource one of them wrote.
 class ComputeCommandEncoder final : public IComputeCommandEncoder {
  public:
-  explicit ComputeCommandEncoder(id<MTLCommandBuffer> buffer);
+  ComputeCommandEncoder(std::shared_ptr<ICommandBuffer> commandBuffer,
+                        id<MTLComputeCommandEncoder> encoder,
+                        std::shared_ptr<UploadArena> uploadArena = nullptr);
   ~ComputeCommandEncoder() override = default;
 
   void endEncoding() override;
@@ -28,6 +37,9 @@ class ComputeCommandEncoder final : public IComputeCommandEncoder {
   // total number of threads per grid is threadgroupCount * threadgroupSize
   void dispatchThreadGroups(const Dimensions& threadgroupCount,
                             const Dimensions& threadgroupSize) override;
+  void dispatchThreadGroupsIndirect(IBuffer& indirectBuffer,
+                                    size_t indirectBufferOffset,
+                                    const Dimensions& threadgroupSize) override;
   void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
   void insertDebugEventLabel(const std::string& label, const igl::Color& color) const override;
   void popDebugGroupLabel() const override;
@@ -37,8 +49,30 @@ class ComputeCommandEncoder final : public IComputeCommandEncoder {
   void bindBytes(size_t index, const void* data, size_t length) override;
   void bindPushConstants(size_t offset, const void* data, size_t length) override;
 
+  /// Binds all the resources of `argumentBuffer` as the buffer at `index` and makes them resident,
+  /// e.g. an indirect command buffer the kernel encodes draws into
+  void bindArgumentBuffer(size_t index, const ArgumentBuffer& argumentBuffer);
+
+ private:
+  // Encodes a barrier if a resource bound to the next dispatch was written by a previous one
+  void insertDispatchBarrier(id<MTLResource> indirectBuffer = nil);
+  // All bound buffers and textures are treated as written by the dispatch
+  void didDispatch();
+  // passes the push constants if they changed since the previous dispatch
+  void flushPushConstants();
+
  private:
   id<MTLComputeCommandEncoder> encoder_ = nil;
+  // Hazard tracking: the resources bound by index, including the ones of argument buffers, and
+  // the ones written by dispatches since the last barrier. Buffers bound with bindBytes() are
+  // never written.
+  std::unordered_map<size_t, id<MTLResource>> boundBuffers_;
+  std::unordered_map<size_t, id<MTLResource>> boundTextures_;
+  std::unordered_map<size_t, std::vector<ArgumentBuffer::Resource>> boundArgumentResources_;
+  std::vector<id<MTLResource>> unsyncedBuffers_;
+  std::vector<id<MTLResource>> unsyncedTextures_;
+  std::shared_ptr<UploadArena> uploadArena_;
+  PushConstantBlock pushConstants_;
   // 4 KB - page aligned memory for metal managed resource
   static constexpr uint32_t MAX_RECOMMENDED_BYTES = 4 * 1024;
 };
@@ -10,20 +10,45 @@
 #import <Foundation/Foundation.h>
 
 #import <Metal/Metal.h>
+#include <igl/metal/ArgumentBuffer.h>
 #include <igl/metal/Buffer.h>
+#include <igl/metal/CommandBuffer.h>
 #include <igl/metal/ComputePipelineState.h>
 #include <igl/metal/Framebuffer.h>
 #include <igl/metal/SamplerState.h>
 #include <igl/metal/Texture.h>
+#include <igl/metal/UploadArena.h>
+
+#include <algorithm>
 
 namespace igl {
 namespace metal {
 
-ComputeCommandEncoder::ComputeCommandEncoder(id<MTLCommandBuffer> buffer) {
-  id<MTLComputeCommandEncoder> computeEncoder = [buffer computeCommandEncoder];
-  encoder_ = computeEncoder;
+namespace {
+
+bool isUnsynced(const std::vector<id<MTLResource>>& unsynced, id<MTLResource> resource) {
+  return std::find(unsynced.begin(), unsynced.end(), resource) != unsynced.end();
+}
+
+void markUnsynced(std::vector<id<MTLResource>>& unsynced, id<MTLResource> resource) {
+  if (!isUnsynced(unsynced, resource)) {
+    unsynced.push_back(resource);
+  }
+}
+
+bool isTexture(id<MTLResource> resource) {
+  return [resource conformsToProtocol:@protocol(MTLTexture)];
 }
 
+} // namespace
+
+ComputeCommandEncoder::ComputeCommandEncoder(std::shared_ptr<ICommandBuffer> commandBuffer,
+                                             id<MTLComputeCommandEncoder> encoder,
+                                             std::shared_ptr<UploadArena> uploadArena) :
+  IComputeCommandEncoder(std::move(commandBuffer)),
+  encoder_(encoder),
+  uploadArena_(std::move(uploadArena)) {}
+
 void ComputeCommandEncoder::endEncoding() {
   IGL_ASSERT(encoder_);
   [encoder_ endEncoding];
@@ -54,6 +79,7 @@ void ComputeCommandEncoder::bindComputePipelineState(
   if (pipelineState) {
     auto& iglPipelineState = static_cast<ComputePipelineState&>(*pipelineState);
     [encoder_ setComputePipelineState:iglPipelineState.get()];
+    getCommandBuffer().incrementStatistic(CommandBufferCounter::PipelineBinds);
   }
 }
 
@@ -68,7 +94,84 @@ void ComputeCommandEncoder::dispatchThreadGroups(const Dimensions& threadgroupCo
   tgs.width = threadgroupSize.width;
   tgs.height = threadgroupSize.height;
   tgs.depth = threadgroupSize.depth;
+  flushPushConstants();
+  insertDispatchBarrier();
   [encoder_ dispatchThreadgroups:tgc threadsPerThreadgroup:tgs];
+  getCommandBuffer().incrementStatistic(CommandBufferCounter::Dispatches);
+  didDispatch();
+}
+
+void ComputeCommandEncoder::dispatchThreadGroupsIndirect(IBuffer& indirectBuffer,
+                                                         size_t indirectBufferOffset,
+                                                         const Dimensions& threadgroupSize) {
+  IGL_ASSERT(encoder_);
+  auto& indirectBufferRef = static_cast<Buffer&>(indirectBuffer);
+
+  MTLSize tgs;
+  tgs.width = threadgroupSize.width;
+  tgs.height = threadgroupSize.height;
+  tgs.depth = threadgroupSize.depth;
+  flushPushConstants();
+  // the thread group counts may have been written by a previous dispatch
+  insertDispatchBarrier(indirectBufferRef.get());
+  [encoder_ dispatchThreadgroupsWithIndirectBuffer:indirectBufferRef.get()
+                              indirectBufferOffset:indirectBufferOffset
+                             threadsPerThreadgroup:tgs];
+  getCommandBuffer().incrementStatistic(CommandBufferCounter::Dispatches);
+  didDispatch();
+}
+
+void ComputeCommandEncoder::insertDispatchBarrier(id<MTLResource> indirectBuffer) {
+  if (unsyncedBuffers_.empty() && unsyncedTextures_.empty()) {
+    return;
+  }
+  bool needsBufferBarrier = indirectBuffer != nil && isUnsynced(unsyncedBuffers_, indirectBuffer);
+  bool needsTextureBarrier = false;
+  for (const auto& [index, buffer] : boundBuffers_) {
+    needsBufferBarrier = needsBufferBarrier || isUnsynced(unsyncedBuffers_, buffer);
+  }
+  for (const auto& [index, texture] : boundTextures_) {
+    needsTextureBarrier = needsTextureBarrier || isUnsynced(unsyncedTextures_, texture);
+  }
+  for (const auto& [index, resources] : boundArgumentResources_) {
+    for (const auto& resource : resources) {
+      needsBufferBarrier = needsBufferBarrier || isUnsynced(unsyncedBuffers_, resource.resource);
+      needsTextureBarrier = needsTextureBarrier || isUnsynced(unsyncedTextures_, resource.resource);
+    }
+  }
+
+  // a barrier covers all the previous writes within its scope
+  MTLBarrierScope scope = 0;
+  if (needsBufferBarrier) {
+    scope |= MTLBarrierScopeBuffers;
+    unsyncedBuffers_.clear();
+  }
+  if (needsTextureBarrier) {
+    scope |= MTLBarrierScopeTextures;
+    unsyncedTextures_.clear();
+  }
+  if (scope != 0) {
+    if (@available(macOS 10.14, iOS 12.0, *)) {
+      [encoder_ memoryBarrierWithScope:scope];
+    }
+  }
+}
+
+void ComputeCommandEncoder::didDispatch() {
+  for (const auto& [index, buffer] : boundBuffers_) {
+    markUnsynced(unsyncedBuffers_, buffer);
+  }
+  for (const auto& [index, texture] : boundTextures_) {
+    markUnsynced(unsyncedTextures_, texture);
+  }
+  for (const auto& [index, resources] : boundArgumentResources_) {
+    for (const auto& resource : resources) {
+      if ((resource.usage & MTLResourceUsageWrite) != 0) {
+        markUnsynced(isTexture(resource.resource) ? unsyncedTextures_ : unsyncedBuffers_,
+                     resource.resource);
+      }
+    }
+  }
 }
 
 void ComputeCommandEncoder::bindUniform(const UniformDesc& /*uniformDesc*/, const void* /*data*/) {
@@ -83,6 +186,7 @@ void ComputeCommandEncoder::bindTexture(size_t index, ITexture* texture) {
   if (texture) {
     auto& iglTexture = static_cast<Texture&>(*texture);
     [encoder_ setTexture:iglTexture.get() atIndex:index];
+    boundTextures_[index] = iglTexture.get();
   }
 }
 
@@ -93,13 +197,47 @@ void ComputeCommandEncoder::bindBuffer(size_t index,
   if (buffer) {
     auto& iglBuffer = static_cast<Buffer&>(*buffer);
     [encoder_ setBuffer:iglBuffer.get() offset:offset atIndex:index];
+    boundBuffers_[index] = iglBuffer.get();
+    boundArgumentResources_.erase(index);
   }
 }
 
+void ComputeCommandEncoder::bindArgumentBuffer(size_t index, const ArgumentBuffer& argumentBuffer) {
+  IGL_ASSERT(encoder_);
+  // resources which are only referenced by an argument buffer are not made resident by Metal
+  id residencySet = argumentBuffer.getReadOnlyResidencySet();
+  auto& resources = boundArgumentResources_[index];
+  resources.clear();
+  for (const auto& [argumentIndex, resource] : argumentBuffer.getResources()) {
+    resources.push_back(resource);
+    if (residencySet == nil || (resource.usage & MTLResourceUsageWrite) != 0) {
+      [encoder_ useResource:resource.resource usage:resource.usage];
+    }
+  }
+  if (residencySet != nil) {
+    static_cast<CommandBuffer&>(getCommandBuffer()).useResidencySet(residencySet);
+  }
+  [encoder_ setBuffer:argumentBuffer.get() offset:0 atIndex:index];
+  boundBuffers_.erase(index);
+}
+
 void ComputeCommandEncoder::bindBytes(size_t index, const void* data, size_t length) {
   IGL_ASSERT(encoder_);
   if (data) {
+    // inline bytes are never written by the kernel
+    boundBuffers_.erase(index);
+    boundArgumentResources_.erase(index);
+    getCommandBuffer().incrementStatistic(CommandBufferCounter::BindingUpdates);
+    getCommandBuffer().incrementStatistic(CommandBufferCounter::UploadedBytes, length);
     if (length > MAX_RECOMMENDED_BYTES) {
+      // Metal copies inline bytes into the command buffer, which is only meant for small data
+      if (uploadArena_) {
+        const auto allocation = uploadArena_->allocate(data, length);
+        if (allocation.buffer != nil) {
+          [encoder_ setBuffer:allocation.buffer offset:allocation.offset atIndex:index];
+          return;
+        }
+      }
       IGL_LOG_INFO(
           "It is recommended to use bindBuffer instead of bindBytes when binding > 4kb: %u",
           length);
@@ -108,10 +246,20 @@ void ComputeCommandEncoder::bindBytes(size_t index, const void* data, size_t len
   }
 }
 
-void ComputeCommandEncoder::bindPushConstants(size_t /*offset*/,
-                                              const void* /*data*/,
-                                              size_t /*length*/) {
-  IGL_ASSERT_NOT_IMPLEMENTED();
+void ComputeCommandEncoder::bindPushConstants(size_t offset, const void* data, size_t length) {
+  IGL_ASSERT(encoder_);
+  getCommandBuffer().incrementStatistic(CommandBufferCounter::BindingUpdates);
+  getCommandBuffer().incrementStatistic(CommandBufferCounter::UploadedBytes, length);
+  pushConstants_.set(offset, data, length);
+}
+
+void ComputeCommandEncoder::flushPushConstants() {
+  if (!pushConstants_.isDirty()) {
+    return;
+  }
+  size_t length = 0;
+  const void* bytes = pushConstants_.getDirtyBytes(length);
+  [encoder_ setBytes:bytes length:length atIndex:PushConstantBlock::kBufferIndex];
 }
 
 } // namespace metal
@@ -8,15 +8,31 @@
 #pragma once
 
 #import <Metal/Metal.h>
+#include <igl/DepthStencilState.h>
 #include <igl/Device.h>
+#include <igl/StateObjectCache.h>
+#include <igl/VertexInputState.h>
 #include <igl/metal/DeviceFeatureSet.h>
 #include <igl/metal/DeviceStatistics.h>
 #include <igl/metal/PlatformDevice.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 
 namespace igl {
 namespace metal {
 
 class BufferSynchronizationManager;
+struct PipelineArchive;
+class TextureUploader;
+class UploadArena;
+
+/// Receives the label of a pipeline created with a pipeline archive, how long creating it took and
+/// whether it was found in the archive or had to be compiled
+using PipelineArchiveFeedbackCallback =
+    std::function<void(const char* debugName, uint64_t durationNs, bool archiveHit)>;
 
 class Device : public IDevice {
   friend class HWDevice;
@@ -38,6 +54,9 @@ class Device : public IDevice {
                                                     Result* outResult) const override;
   std::shared_ptr<ITexture> createTexture(const TextureDesc& desc,
                                           Result* outResult) const noexcept override;
+  std::shared_ptr<ITexture> createTextureView(std::shared_ptr<ITexture> texture,
+                                              const TextureViewDesc& desc,
+                                              Result* outResult) const noexcept override;
   std::shared_ptr<IVertexInputState> createVertexInputState(const VertexInputStateDesc& desc,
                                                             Result* outResult) const override;
 
@@ -46,6 +65,10 @@ class Device : public IDevice {
                                                                Result* outResult) const override;
   std::shared_ptr<IRenderPipelineState> createRenderPipeline(const RenderPipelineDesc& desc,
                                                              Result* outResult) const override;
+  void createComputePipelineAsync(const ComputePipelineDesc& desc,
+                                  ComputePipelineCompletionHandler completionHandler) const override;
+  void createRenderPipelineAsync(const RenderPipelineDesc& desc,
+                                 RenderPipelineCompletionHandler completionHandler) const override;
 
   // Shaders
   std::unique_ptr<IShaderLibrary> createShaderLibrary(const ShaderLibraryDesc& desc,
@@ -57,6 +80,13 @@ class Device : public IDevice {
   std::unique_ptr<IShaderStages> createShaderStages(const ShaderStagesDesc& desc,
                                                     Result* outResult) const override;
 
+  std::shared_ptr<ITimer> createTimer(Result* outResult) const noexcept override;
+
+  std::shared_ptr<IQueryPool> createQueryPool(const QueryPoolDesc& desc,
+                                              Result* outResult) const noexcept override;
+
+  bool getMemoryStatistics(DeviceMemoryStatistics& outStatistics) const noexcept override;
+
   // Platform-specific extensions
   const PlatformDevice& getPlatformDevice() const noexcept override;
 
@@ -74,6 +104,11 @@ class Device : public IDevice {
   // Device Statistics
   size_t getCurrentDrawCount() const override;
 
+  /// Draw counts and GPU times of the command buffers submitted to the queues of this device
+  DeviceStatistics& getDeviceStatistics() noexcept {
+    return deviceStatistics_;
+  }
+
   BackendType getBackendType() const override {
     return BackendType::Metal;
   }
@@ -82,6 +117,24 @@ class Device : public IDevice {
     return NormalizedZRange::ZeroToOne;
   }
 
+  /// Loads the MTLBinaryArchive at `path`, or starts an empty one if there is none or it cannot be
+  /// used (e.g. after an OS update). Render and compute pipelines created afterwards are looked up
+  /// in the archive first, and the ones which were not in it are compiled into it, so that the
+  /// next run creates them without compiling. Requires iOS 14 or macOS 11.
+  /// `feedback` is called for every pipeline created with the archive, possibly from background
+  /// threads of the asynchronous creation functions.
+  Result loadPipelineArchive(const std::string& path,
+                             PipelineArchiveFeedbackCallback feedback = nullptr);
+  /// Writes the archive back to the path it was loaded from if pipelines were added to it. Also
+  /// done on destruction.
+  Result savePipelineArchive() const;
+
+  /// Returns the descriptor createTexture() allocates `desc` with, or nil if it is invalid.
+  /// `outStorage` is the storage the texture gets, which can differ from the requested one.
+  MTLTextureDescriptor* createTextureDescriptor(const TextureDesc& desc,
+                                                ResourceStorage& outStorage,
+                                                Result* outResult) const;
+
   static MTLStorageMode toMTLStorageMode(ResourceStorage storage);
   static MTLResourceOptions toMTLResourceStorageMode(ResourceStorage storage);
 
@@ -91,12 +144,37 @@ class Device : public IDevice {
 
   std::unique_ptr<IBuffer> createBufferNoCopy(const BufferDesc& desc, Result* outResult) const;
 
+  // create a new state object, the public functions return the interned ones
+  std::shared_ptr<IVertexInputState> newVertexInputState(const VertexInputStateDesc& desc,
+                                                         Result* outResult) const;
+  std::shared_ptr<IDepthStencilState> newDepthStencilState(const DepthStencilStateDesc& desc,
+                                                           Result* outResult) const;
+
+  MTLRenderPipelineDescriptor* createRenderPipelineDescriptor(const RenderPipelineDesc& desc,
+                                                              Result* outResult) const;
+
+  // newLibraryWithSource: through shaderLibraries_
+  id<MTLLibrary> newLibraryWithSource(const ShaderInput& input, NSError** error) const;
+
   id<MTLDevice> device_;
   PlatformDevice platformDevice_;
 
   DeviceFeatureSet deviceFeatureSet_;
   std::shared_ptr<BufferSynchronizationManager> bufferSyncManager_;
+  // transient data of bindBytes(), shared by the command queues
+  std::shared_ptr<UploadArena> uploadArena_;
+  // uploads into private textures, which the command queues wait for
+  std::shared_ptr<TextureUploader> textureUploader_;
   DeviceStatistics deviceStatistics_;
+  // shared with the blocks of asynchronous pipeline creation, which can outlive the device
+  std::shared_ptr<PipelineArchive> pipelineArchive_;
+  // equal descriptors share one state object, see StateObjectCache
+  mutable StateObjectCache<DepthStencilStateDesc, IDepthStencilState> depthStencilStates_;
+  mutable StateObjectCache<VertexInputStateDesc, IVertexInputState> vertexInputStates_;
+  // libraries compiled from MSL sources, keyed by compile options and source, so that modules and
+  // pipelines sharing a source only compile it once
+  mutable std::mutex shaderLibrariesMutex_;
+  mutable std::unordered_map<std::string, id<MTLLibrary>> shaderLibraries_;
 };
 
 } // namespace metal
@@ -15,12 +15,18 @@
 #include <igl/metal/DepthStencilState.h>
 #include <igl/metal/Framebuffer.h>
 #include <igl/metal/PlatformDevice.h>
+#include <igl/metal/QueryPool.h>
 #include <igl/metal/RenderPipelineState.h>
 #include <igl/metal/Result.h>
 #include <igl/metal/SamplerState.h>
 #include <igl/metal/Shader.h>
 #include <igl/metal/Texture.h>
+#include <igl/metal/TextureUploader.h>
+#include <igl/metal/Timer.h>
+#include <igl/metal/UploadArena.h>
 #include <igl/metal/VertexInputState.h>
+#include <chrono>
+#include <mutex>
 #include <sstream>
 #include <unordered_set>
 
@@ -31,19 +37,196 @@ namespace metal {
 // Max number of Metal drawables in the resource pool managed by Core Animation is 3.
 #define IGL_METAL_MAX_IN_FLIGHT_BUFFERS 3
 
+struct PipelineArchive {
+  // MTLBinaryArchive, which is only available on iOS 14 and macOS 11
+  id archive = nil;
+  NSURL* url = nil;
+  std::mutex mutex;
+  bool dirty = false;
+  PipelineArchiveFeedbackCallback feedback;
+};
+
+namespace {
+
+void reportArchiveFeedback(const PipelineArchive& pipelineArchive,
+                           NSString* label,
+                           std::chrono::steady_clock::time_point start,
+                           bool archiveHit) {
+  if (!pipelineArchive.feedback) {
+    return;
+  }
+  const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+  pipelineArchive.feedback(label != nil ? [label UTF8String] : "",
+                           static_cast<uint64_t>(duration.count()),
+                           archiveHit);
+}
+
+// Pipelines are looked up in the archive without compiling them first. On a miss, the pipeline is
+// compiled into the archive and created from it, so that it is only compiled once.
+id<MTLRenderPipelineState> newRenderPipelineState(id<MTLDevice> device,
+                                                  PipelineArchive* pipelineArchive,
+                                                  MTLRenderPipelineDescriptor* desc,
+                                                  MTLPipelineOption options,
+                                                  MTLRenderPipelineReflection** reflection,
+                                                  NSError** error) {
+  if (@available(macOS 11.0, iOS 14.0, *)) {
+    if (pipelineArchive != nullptr && pipelineArchive->archive != nil) {
+      id<MTLBinaryArchive> archive = pipelineArchive->archive;
+      desc.binaryArchives = @[archive];
+      const auto start = std::chrono::steady_clock::now();
+      NSError* missError = nil;
+      id<MTLRenderPipelineState> metalObject =
+          [device newRenderPipelineStateWithDescriptor:desc
+                                               options:options |
+                                                       MTLPipelineOptionFailOnBinaryArchiveMiss
+                                            reflection:reflection
+                                                 error:&missError];
+      if (metalObject != nil) {
+        reportArchiveFeedback(*pipelineArchive, desc.label, start, true);
+        return metalObject;
+      }
+      {
+        std::lock_guard<std::mutex> lock(pipelineArchive->mutex);
+        if ([archive addRenderPipelineFunctionsWithDescriptor:desc error:&missError]) {
+          pipelineArchive->dirty = true;
+        }
+      }
+      metalObject = [device newRenderPipelineStateWithDescriptor:desc
+                                                         options:options
+                                                      reflection:reflection
+                                                           error:error];
+      if (metalObject != nil) {
+        reportArchiveFeedback(*pipelineArchive, desc.label, start, false);
+      }
+      return metalObject;
+    }
+  }
+  return [device newRenderPipelineStateWithDescriptor:desc
+                                              options:options
+                                           reflection:reflection
+                                                error:error];
+}
+
+id<MTLComputePipelineState> newComputePipelineState(id<MTLDevice> device,
+                                                    PipelineArchive* pipelineArchive,
+                                                    MTLComputePipelineDescriptor* desc,
+                                                    MTLComputePipelineReflection** reflection,
+                                                    NSError** error) {
+  if (@available(macOS 11.0, iOS 14.0, *)) {
+    if (pipelineArchive != nullptr && pipelineArchive->archive != nil) {
+      id<MTLBinaryArchive> archive = pipelineArchive->archive;
+      desc.binaryArchives = @[archive];
+      const auto start = std::chrono::steady_clock::now();
+      NSError* missError = nil;
+      id<MTLComputePipelineState> metalObject =
+          [device newComputePipelineStateWithDescriptor:desc
+                                                options:MTLPipelineOptionFailOnBinaryArchiveMiss
+                                             reflection:reflection
+                                                  error:&missError];
+      if (metalObject != nil) {
+        reportArchiveFeedback(*pipelineArchive, desc.label, start, true);
+        return metalObject;
+      }
+      {
+        std::lock_guard<std::mutex> lock(pipelineArchive->mutex);
+        if ([archive addComputePipelineFunctionsWithDescriptor:desc error:&missError]) {
+          pipelineArchive->dirty = true;
+        }
+      }
+      metalObject = [device newComputePipelineStateWithDescriptor:desc
+                                                          options:MTLPipelineOptionNone
+                                                       reflection:reflection
+                                                            error:error];
+      if (metalObject != nil) {
+        reportArchiveFeedback(*pipelineArchive, desc.label, start, false);
+      }
+      return metalObject;
+    }
+  }
+  return [device newComputePipelineStateWithDescriptor:desc
+                                               options:MTLPipelineOptionNone
+                                            reflection:reflection
+                                                 error:error];
+}
+
+} // namespace
+
 Device::Device(id<MTLDevice> device) :
   device_(device), platformDevice_(*this), deviceFeatureSet_(device) {
   bufferSyncManager_ =
       std::make_shared<BufferSynchronizationManager>(IGL_METAL_MAX_IN_FLIGHT_BUFFERS);
+  uploadArena_ = std::make_shared<UploadArena>(device_, bufferSyncManager_);
+  textureUploader_ = std::make_shared<TextureUploader>(device_);
+}
+
+Device::~Device() {
+  savePipelineArchive();
+}
+
+Result Device::loadPipelineArchive(const std::string& path,
+                                   PipelineArchiveFeedbackCallback feedback) {
+  if (@available(macOS 11.0, iOS 14.0, *)) {
+    auto pipelineArchive = std::make_shared<PipelineArchive>();
+    pipelineArchive->feedback = std::move(feedback);
+    pipelineArchive->url = [NSURL fileURLWithPath:[NSString stringWithUTF8String:path.c_str()]];
+
+    NSError* error = nil;
+    MTLBinaryArchiveDescriptor* desc = [MTLBinaryArchiveDescriptor new];
+    if ([[NSFileManager defaultManager] fileExistsAtPath:pipelineArchive->url.path]) {
+      desc.url = pipelineArchive->url;
+      pipelineArchive->archive = [device_ newBinaryArchiveWithDescriptor:desc error:&error];
+    }
+    if (pipelineArchive->archive == nil) {
+      if (error != nil) {
+        IGL_LOG_INFO("Discarding pipeline archive: %s\n", [error.localizedDescription UTF8String]);
+      }
+      // start over with an empty archive, which is written to the same file
+      desc.url = nil;
+      error = nil;
+      pipelineArchive->archive = [device_ newBinaryArchiveWithDescriptor:desc error:&error];
+    }
+    Result result;
+    setResultFrom(&result, error);
+    if (pipelineArchive->archive != nil) {
+      pipelineArchive_ = std::move(pipelineArchive);
+    }
+    return result;
+  }
+  return Result(Result::Code::Unsupported, "Binary archives require iOS 14 or macOS 11");
 }
 
-Device::~Device() = default;
+Result Device::savePipelineArchive() const {
+  if (!pipelineArchive_) {
+    return Result();
+  }
+  if (@available(macOS 11.0, iOS 14.0, *)) {
+    std::lock_guard<std::mutex> lock(pipelineArchive_->mutex);
+    if (!pipelineArchive_->dirty) {
+      return Result();
+    }
+    NSError* error = nil;
+    id<MTLBinaryArchive> archive = pipelineArchive_->archive;
+    if ([archive serializeToURL:pipelineArchive_->url error:&error]) {
+      pipelineArchive_->dirty = false;
+    }
+    Result result;
+    setResultFrom(&result, error);
+    return result;
+  }
+  return Result();
+}
 
 std::shared_ptr<ICommandQueue> Device::createCommandQueue(const CommandQueueDesc& /*desc*/,
                                                           Result* outResult) {
   id<MTLCommandQueue> metalObject = [device_ newCommandQueue];
   auto resource =
-      std::make_shared<CommandQueue>(metalObject, bufferSyncManager_, deviceStatistics_);
+      std::make_shared<CommandQueue>(*this,
+                                     metalObject,
+                                     bufferSyncManager_,
+                                     uploadArena_,
+                                     textureUploader_,
+                                     deviceStatistics_);
   Result::setOk(outResult);
   return resource;
 }
@@ -77,7 +260,10 @@ std::unique_ptr<IBuffer> Device::createBuffer(const BufferDesc& desc,
   std::unique_ptr<IBuffer> resource = std::make_unique<Buffer>(
       std::move(metalObject), options, desc.hint, 0 /* No accepted hints */);
   if (getResourceTracker()) {
-    resource->initResourceTracker(getResourceTracker());
+    resource->initResourceTracker(getResourceTracker(),
+                                  {resource->getSizeInBytes(),
+                                   toResourceMemoryLocation(resource->storage()),
+                                   desc.debugName});
   }
   Result::setOk(outResult);
   return resource;
@@ -98,7 +284,10 @@ std::unique_ptr<IBuffer> Device::createRingBuffer(const BufferDesc& desc,
       std::make_unique<RingBuffer>(std::move(bufferRing), options, bufferSyncManager_, desc.hint);
 
   if (getResourceTracker()) {
-    resource->initResourceTracker(getResourceTracker());
+    resource->initResourceTracker(getResourceTracker(),
+                                  {resource->getSizeInBytes(),
+                                   toResourceMemoryLocation(resource->storage()),
+                                   desc.debugName});
   }
   Result::setOk(outResult);
   return resource;
@@ -119,7 +308,10 @@ std::unique_ptr<IBuffer> Device::createBufferNoCopy(const BufferDesc& desc,
   std::unique_ptr<IBuffer> resource = std::make_unique<Buffer>(
       metalObject, options, desc.hint, BufferDesc::BufferAPIHintBits::NoCopy);
   if (getResourceTracker()) {
-    resource->initResourceTracker(getResourceTracker());
+    resource->initResourceTracker(getResourceTracker(),
+                                  {resource->getSizeInBytes(),
+                                   toResourceMemoryLocation(resource->storage()),
+                                   desc.debugName});
   }
   Result::setOk(outResult);
   return resource;
@@ -130,8 +322,9 @@ std::shared_ptr<ISamplerState> Device::createSamplerState(const SamplerStateDesc
   return platformDevice_.createSamplerState(desc, outResult);
 }
 
-std::shared_ptr<ITexture> Device::createTexture(const TextureDesc& desc,
-                                                Result* outResult) const noexcept {
+MTLTextureDescriptor* Device::createTextureDescriptor(const TextureDesc& desc,
+                                                      ResourceStorage& outStorage,
+                                                      Result* outResult) const {
   const auto sanitized = sanitize(desc);
 
   MTLTextureDescriptor* metalDesc = [MTLTextureDescriptor new];
@@ -144,7 +337,7 @@ std::shared_ptr<ITexture> Device::createTexture(const TextureDesc& desc,
         "Invalid Texture Format : " +
             std::string(TextureFormatProperties::fromTextureFormat(sanitized.format).name));
     IGL_ASSERT_MSG(0, outResult->message.c_str());
-    return nullptr;
+    return nil;
   }
   metalDesc.width = sanitized.width;
   metalDesc.height = sanitized.height;
@@ -174,10 +367,39 @@ std::shared_ptr<ITexture> Device::createTexture(const TextureDesc& desc,
   }
 #endif
   metalDesc.usage = Texture::toMTLTextureUsage(sanitized.usage);
-  metalDesc.storageMode = toMTLStorageMode(sanitized.storage);
+  if ((sanitized.options & TextureDesc::TextureOptionBits::MutableFormat) != 0) {
+    metalDesc.usage |= MTLTextureUsagePixelFormatView;
+  }
+
+  ResourceStorage storage = sanitized.storage;
+#if IGL_PLATFORM_MACOS || IGL_PLATFORM_MACCATALYST
+  // memoryless textures live in tile memory which only Apple silicon GPUs have
+  if (storage == ResourceStorage::Memoryless) {
+    storage = ResourceStorage::Private;
+    if (@available(macOS 11.0, macCatalyst 14.0, *)) {
+      if ([device_ supportsFamily:MTLGPUFamilyApple7]) {
+        storage = ResourceStorage::Memoryless;
+      }
+    }
+  }
+#endif
+  metalDesc.storageMode = toMTLStorageMode(storage);
 
   metalDesc.resourceOptions =
-      MTLResourceCPUCacheModeDefaultCache | toMTLResourceStorageMode(sanitized.storage);
+      MTLResourceCPUCacheModeDefaultCache | toMTLResourceStorageMode(storage);
+
+  outStorage = storage;
+  Result::setOk(outResult);
+  return metalDesc;
+}
+
+std::shared_ptr<ITexture> Device::createTexture(const TextureDesc& desc,
+                                                Result* outResult) const noexcept {
+  ResourceStorage storage = desc.storage;
+  MTLTextureDescriptor* metalDesc = createTextureDescriptor(desc, storage, outResult);
+  if (metalDesc == nil) {
+    return nullptr;
+  }
 
   id<MTLTexture> metalObject = [device_ newTextureWithDescriptor:metalDesc];
   if (!metalObject) {
@@ -186,9 +408,69 @@ std::shared_ptr<ITexture> Device::createTexture(const TextureDesc& desc,
     return nullptr;
   }
   auto iglObject = std::make_shared<Texture>(metalObject);
+  if (storage == ResourceStorage::Private) {
+    iglObject->uploader_ = textureUploader_;
+  }
+  if (desc.initialData) {
+    if (storage == ResourceStorage::Memoryless) {
+      Result::setResult(outResult,
+                        Result::Code::ArgumentInvalid,
+                        "Memoryless textures cannot have initial data");
+      return nullptr;
+    }
+    const Result result = iglObject->uploadInitialData(desc.initialData);
+    if (!result.isOk()) {
+      Result::setResult(outResult, result);
+      return nullptr;
+    }
+  }
   if (getResourceTracker()) {
-    iglObject->initResourceTracker(getResourceTracker());
+    iglObject->initResourceTracker(
+        getResourceTracker(),
+        {iglObject->getEstimatedSizeInBytes(), toResourceMemoryLocation(storage), desc.debugName});
+  }
+  Result::setOk(outResult);
+  return iglObject;
+}
+
+std::shared_ptr<ITexture> Device::createTextureView(std::shared_ptr<ITexture> texture,
+                                                    const TextureViewDesc& desc,
+                                                    Result* outResult) const noexcept {
+  auto* source = static_cast<Texture*>(texture.get());
+  if (!IGL_VERIFY(source && source->get())) {
+    Result::setResult(outResult, Result::Code::ArgumentNull, "Texture is null");
+    return nullptr;
+  }
+  TextureViewDesc viewDesc = desc;
+  const Result result = viewDesc.resolve(*source);
+  if (!result.isOk()) {
+    Result::setResult(outResult, result);
+    return nullptr;
+  }
+
+  id<MTLTexture> parent = source->get();
+  if (viewDesc.format != source->getFormat() &&
+      (parent.usage & MTLTextureUsagePixelFormatView) == 0) {
+    Result::setResult(outResult,
+                      Result::Code::ArgumentInvalid,
+                      "Reinterpreting the format requires TextureOptionBits::MutableFormat");
+    return nullptr;
+  }
+
+  id<MTLTexture> metalObject =
+      [parent newTextureViewWithPixelFormat:Texture::textureFormatToMTLPixelFormat(viewDesc.format)
+                                textureType:Texture::convertType(viewDesc.type, parent.sampleCount)
+                                     levels:NSMakeRange(viewDesc.mipLevel, viewDesc.numMipLevels)
+                                     slices:NSMakeRange(viewDesc.layer, viewDesc.numLayers)];
+  if (!metalObject) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Failed to create Metal texture view");
+    return nullptr;
   }
+  if (!viewDesc.debugName.empty()) {
+    metalObject.label = [NSString stringWithUTF8String:viewDesc.debugName.c_str()];
+  }
+  auto iglObject = std::make_shared<Texture>(metalObject);
+  iglObject->uploader_ = source->uploader_;
   Result::setOk(outResult);
   return iglObject;
 }
@@ -196,6 +478,14 @@ std::shared_ptr<ITexture> Device::createTexture(const TextureDesc& desc,
 std::shared_ptr<igl::IVertexInputState> Device::createVertexInputState(
     const VertexInputStateDesc& desc,
     Result* outResult) const {
+  return vertexInputStates_.getOrCreate(desc, outResult, [this, &desc](Result* result) {
+    return newVertexInputState(desc, result);
+  });
+}
+
+std::shared_ptr<igl::IVertexInputState> Device::newVertexInputState(
+    const VertexInputStateDesc& desc,
+    Result* outResult) const {
   // Avoid buffer overrun in numAttributes.
   if (desc.numAttributes > IGL_VERTEX_ATTRIBUTES_MAX) {
     Result::setResult(outResult,
@@ -292,6 +582,14 @@ std::shared_ptr<igl::IVertexInputState> Device::createVertexInputState(
 std::shared_ptr<igl::IDepthStencilState> Device::createDepthStencilState(
     const DepthStencilStateDesc& desc,
     Result* outResult) const {
+  return depthStencilStates_.getOrCreate(desc, outResult, [this, &desc](Result* result) {
+    return newDepthStencilState(desc, result);
+  });
+}
+
+std::shared_ptr<igl::IDepthStencilState> Device::newDepthStencilState(
+    const DepthStencilStateDesc& desc,
+    Result* outResult) const {
   MTLDepthStencilDescriptor* metalDesc = [MTLDepthStencilDescriptor new];
 
   metalDesc.depthCompareFunction = DepthStencilState::convertCompareFunction(desc.compareFunction);
@@ -309,6 +607,8 @@ std::shared_ptr<igl::IDepthStencilState> Device::createDepthStencilState(
 std::shared_ptr<igl::IComputePipelineState> Device::createComputePipeline(
     const ComputePipelineDesc& desc,
     Result* outResult) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
   NSError* error = nil;
 
   if (IGL_UNEXPECTED(desc.shaderStages == nullptr)) {
@@ -327,12 +627,10 @@ std::shared_ptr<igl::IComputePipelineState> Device::createComputePipeline(
   MTLComputePipelineDescriptor* descriptor = [[MTLComputePipelineDescriptor alloc] init];
   descriptor.computeFunction =
       static_cast<ShaderModule*>(desc.shaderStages->getComputeModule().get())->get();
+  descriptor.label = [NSString stringWithUTF8String:desc.debugName.c_str()];
   MTLComputePipelineReflection* reflection = nil;
-  id<MTLComputePipelineState> metalObject =
-      [device_ newComputePipelineStateWithDescriptor:descriptor
-                                             options:MTLPipelineOptionNone
-                                          reflection:&reflection
-                                               error:&error];
+  id<MTLComputePipelineState> metalObject = newComputePipelineState(
+      device_, pipelineArchive_.get(), descriptor, &reflection, &error);
   setResultFrom(outResult, error);
   if (error != nil) {
     return nullptr;
@@ -343,17 +641,71 @@ std::shared_ptr<igl::IComputePipelineState> Device::createComputePipeline(
   return computePipelineState;
 }
 
-std::shared_ptr<igl::IRenderPipelineState> Device::createRenderPipeline(
-    const RenderPipelineDesc& desc,
-    Result* outResult) const {
-  // TODO
-  //  Size drawableSize = IGLNativeDrawableSize(layer_);
-  //  graphicsDesc.viewportState.viewportCount = 1;
-  //  graphicsDesc.viewportState.viewports[0] = (Viewport){0.0, 0.0, drawableSize.width,
-  //  drawableSize.height, 0.0, 1.0};
+void Device::createComputePipelineAsync(const ComputePipelineDesc& desc,
+                                        ComputePipelineCompletionHandler completionHandler) const {
+  if (IGL_UNEXPECTED(desc.shaderStages == nullptr) ||
+      !IGL_VERIFY(desc.shaderStages->getType() == ShaderStagesType::Compute) ||
+      !IGL_VERIFY(desc.shaderStages->getComputeModule())) {
+    // reuse the validation and error reporting of the synchronous path
+    IDevice::createComputePipelineAsync(desc, std::move(completionHandler));
+    return;
+  }
 
-  NSError* error = nil;
+  MTLComputePipelineDescriptor* descriptor = [[MTLComputePipelineDescriptor alloc] init];
+  descriptor.computeFunction =
+      static_cast<ShaderModule*>(desc.shaderStages->getComputeModule().get())->get();
+  descriptor.label = [NSString stringWithUTF8String:desc.debugName.c_str()];
+
+  if (pipelineArchive_) {
+    // looking up the archive and compiling into it are synchronous, so they run on a background
+    // queue instead of in Metal's asynchronous pipeline creation
+    const std::shared_ptr<PipelineArchive> pipelineArchive = pipelineArchive_;
+    id<MTLDevice> device = device_;
+    __block ComputePipelineCompletionHandler handler = std::move(completionHandler);
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+      MTLComputePipelineReflection* reflection = nil;
+      NSError* error = nil;
+      id<MTLComputePipelineState> metalObject =
+          newComputePipelineState(device, pipelineArchive.get(), descriptor, &reflection, &error);
+      if (!handler) {
+        return;
+      }
+      Result ret;
+      setResultFrom(&ret, error);
+      if (error != nil) {
+        handler(nullptr, std::move(ret));
+        return;
+      }
+      handler(std::make_shared<ComputePipelineState>(metalObject, reflection), std::move(ret));
+    });
+    return;
+  }
+
+  __block ComputePipelineCompletionHandler handler = std::move(completionHandler);
+  [device_ newComputePipelineStateWithDescriptor:descriptor
+                                         options:MTLPipelineOptionNone
+                               completionHandler:^(id<MTLComputePipelineState> metalObject,
+                                                   MTLComputePipelineReflection* reflection,
+                                                   NSError* error) {
+                                 if (!handler) {
+                                   return;
+                                 }
+                                 Result ret;
+                                 setResultFrom(&ret, error);
+                                 if (error != nil) {
+                                   handler(nullptr, std::move(ret));
+                                   return;
+                                 }
+                                 handler(std::make_shared<ComputePipelineState>(metalObject,
+                                                                                reflection),
+                                         std::move(ret));
+                               }];
+}
+
+MTLRenderPipelineDescriptor* Device::createRenderPipelineDescriptor(const RenderPipelineDesc& desc,
+                                                                   Result* outResult) const {
   MTLRenderPipelineDescriptor* metalDesc = [MTLRenderPipelineDescriptor new];
+  metalDesc.label = [NSString stringWithUTF8String:desc.debugName.toConstChar()];
 
   metalDesc.sampleCount = desc.sampleCount;
 
@@ -367,11 +719,11 @@ std::shared_ptr<igl::IRenderPipelineState> Device::createRenderPipeline(
   if (!IGL_VERIFY(desc.shaderStages)) {
     Result::setResult(
         outResult, Result::Code::RuntimeError, "RenderPipeline requires shader stages");
-    return nullptr;
+    return nil;
   }
   if (!IGL_VERIFY(desc.shaderStages->getType() == ShaderStagesType::Render)) {
     Result::setResult(outResult, Result::Code::ArgumentInvalid, "Shader stages not for render");
-    return nullptr;
+    return nil;
   }
 
   // Vertex shader is required
@@ -379,7 +731,7 @@ std::shared_ptr<igl::IRenderPipelineState> Device::createRenderPipeline(
   if (!IGL_VERIFY(vertexModule)) {
     Result::setResult(
         outResult, Result::Code::RuntimeError, "RenderPipeline requires vertex module");
-    return nullptr;
+    return nil;
   }
 
   auto vertexFunc = static_cast<ShaderModule*>(vertexModule.get());
@@ -388,7 +740,7 @@ std::shared_ptr<igl::IRenderPipelineState> Device::createRenderPipeline(
   if (!IGL_VERIFY(metalDesc.vertexFunction)) {
     Result::setResult(
         outResult, Result::Code::RuntimeError, "RenderPipeline requires non-null vertex function");
-    return nullptr;
+    return nil;
   }
 
   // Fragment shader is optional
@@ -419,15 +771,37 @@ std::shared_ptr<igl::IRenderPipelineState> Device::createRenderPipeline(
   metalDesc.stencilAttachmentPixelFormat =
       Texture::textureFormatToMTLPixelFormat(desc.targetDesc.stencilAttachmentFormat);
 
+  Result::setOk(outResult);
+  return metalDesc;
+}
+
+std::shared_ptr<igl::IRenderPipelineState> Device::createRenderPipeline(
+    const RenderPipelineDesc& desc,
+    Result* outResult) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  // TODO
+  //  Size drawableSize = IGLNativeDrawableSize(layer_);
+  //  graphicsDesc.viewportState.viewportCount = 1;
+  //  graphicsDesc.viewportState.viewports[0] = (Viewport){0.0, 0.0, drawableSize.width,
+  //  drawableSize.height, 0.0, 1.0};
+
+  MTLRenderPipelineDescriptor* metalDesc = createRenderPipelineDescriptor(desc, outResult);
+  if (metalDesc == nil) {
+    return nullptr;
+  }
+
+  NSError* error = nil;
   MTLRenderPipelineReflection* reflection = nil;
 
   // Create reflection for use later in binding, etc.
   id<MTLRenderPipelineState> metalObject =
-      [device_ newRenderPipelineStateWithDescriptor:metalDesc
-                                            options:MTLPipelineOptionArgumentInfo |
-                                                    MTLPipelineOptionBufferTypeInfo
-                                         reflection:&reflection
-                                              error:&error];
+      newRenderPipelineState(device_,
+                             pipelineArchive_.get(),
+                             metalDesc,
+                             MTLPipelineOptionArgumentInfo | MTLPipelineOptionBufferTypeInfo,
+                             &reflection,
+                             &error);
   setResultFrom(outResult, error);
   if (error != nil) {
     IGL_LOG_ERROR("%s\n", [error.localizedDescription UTF8String]);
@@ -438,6 +812,107 @@ std::shared_ptr<igl::IRenderPipelineState> Device::createRenderPipeline(
       metalObject, reflection, desc.cullMode, desc.frontFaceWinding, desc.polygonFillMode);
 }
 
+void Device::createRenderPipelineAsync(const RenderPipelineDesc& desc,
+                                       RenderPipelineCompletionHandler completionHandler) const {
+  Result result;
+  MTLRenderPipelineDescriptor* metalDesc = createRenderPipelineDescriptor(desc, &result);
+  if (metalDesc == nil) {
+    if (completionHandler) {
+      completionHandler(nullptr, std::move(result));
+    }
+    return;
+  }
+
+  const CullMode cullMode = desc.cullMode;
+  const WindingMode frontFaceWinding = desc.frontFaceWinding;
+  const PolygonFillMode polygonFillMode = desc.polygonFillMode;
+
+  if (pipelineArchive_) {
+    // looking up the archive and compiling into it are synchronous, so they run on a background
+    // queue instead of in Metal's asynchronous pipeline creation
+    const std::shared_ptr<PipelineArchive> pipelineArchive = pipelineArchive_;
+    id<MTLDevice> device = device_;
+    __block RenderPipelineCompletionHandler handler = std::move(completionHandler);
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+      MTLRenderPipelineReflection* reflection = nil;
+      NSError* error = nil;
+      id<MTLRenderPipelineState> metalObject =
+          newRenderPipelineState(device,
+                                 pipelineArchive.get(),
+                                 metalDesc,
+                                 MTLPipelineOptionArgumentInfo | MTLPipelineOptionBufferTypeInfo,
+                                 &reflection,
+                                 &error);
+      if (!handler) {
+        return;
+      }
+      Result ret;
+      setResultFrom(&ret, error);
+      if (error != nil) {
+        IGL_LOG_ERROR("%s\n", [error.localizedDescription UTF8String]);
+        handler(nullptr, std::move(ret));
+        return;
+      }
+      handler(std::make_shared<RenderPipelineState>(
+                  metalObject, reflection, cullMode, frontFaceWinding, polygonFillMode),
+              std::move(ret));
+    });
+    return;
+  }
+
+  // Metal compiles the pipeline on its own worker threads and invokes the block on one of them
+  __block RenderPipelineCompletionHandler handler = std::move(completionHandler);
+  [device_ newRenderPipelineStateWithDescriptor:metalDesc
+                                        options:MTLPipelineOptionArgumentInfo |
+                                                MTLPipelineOptionBufferTypeInfo
+                              completionHandler:^(id<MTLRenderPipelineState> metalObject,
+                                                  MTLRenderPipelineReflection* reflection,
+                                                  NSError* error) {
+                                if (!handler) {
+                                  return;
+                                }
+                                Result ret;
+                                setResultFrom(&ret, error);
+                                if (error != nil) {
+                                  IGL_LOG_ERROR("%s\n", [error.localizedDescription UTF8String]);
+                                  handler(nullptr, std::move(ret));
+                                  return;
+                                }
+                                handler(std::make_shared<RenderPipelineState>(metalObject,
+                                                                              reflection,
+                                                                              cullMode,
+                                                                              frontFaceWinding,
+                                                                              polygonFillMode),
+                                        std::move(ret));
+                              }];
+}
+
+namespace {
+MTLFunctionConstantValues* toMTLFunctionConstantValues(
+    const std::vector<ShaderSpecializationConstant>& constants) {
+  MTLFunctionConstantValues* values = [MTLFunctionConstantValues new];
+  for (const auto& c : constants) {
+    switch (c.type) {
+    case ShaderSpecializationConstant::Type::Bool: {
+      const bool value = c.value != 0;
+      [values setConstantValue:&value type:MTLDataTypeBool atIndex:c.id];
+      break;
+    }
+    case ShaderSpecializationConstant::Type::Int:
+      [values setConstantValue:&c.value type:MTLDataTypeInt atIndex:c.id];
+      break;
+    case ShaderSpecializationConstant::Type::UInt:
+      [values setConstantValue:&c.value type:MTLDataTypeUInt atIndex:c.id];
+      break;
+    case ShaderSpecializationConstant::Type::Float:
+      [values setConstantValue:&c.value type:MTLDataTypeFloat atIndex:c.id];
+      break;
+    }
+  }
+  return values;
+}
+} // namespace
+
 std::unique_ptr<IShaderLibrary> Device::createShaderLibrary(const ShaderLibraryDesc& desc,
                                                             Result* outResult) const {
   if (IGL_UNEXPECTED(desc.moduleInfo.empty())) {
@@ -466,11 +941,7 @@ std::unique_ptr<IShaderLibrary> Device::createShaderLibrary(const ShaderLibraryD
       Result::setResult(outResult, Result::Code::ArgumentNull);
       return nullptr;
     }
-    MTLCompileOptions* compileOpts = [MTLCompileOptions new];
-    compileOpts.fastMathEnabled = desc.input.options.fastMathEnabled;
-
-    NSString* shaderSource = [NSString stringWithUTF8String:desc.input.source];
-    metalLibrary = [device_ newLibraryWithSource:shaderSource options:compileOpts error:&error];
+    metalLibrary = newLibraryWithSource(desc.input, &error);
   }
 
   if (!metalLibrary) {
@@ -491,7 +962,20 @@ std::unique_ptr<IShaderLibrary> Device::createShaderLibrary(const ShaderLibraryD
       return nullptr;
     }
 
-    auto metalFunction = [metalLibrary newFunctionWithName:shaderEntrypoint];
+    id<MTLFunction> metalFunction = nil;
+    if (info.specializationConstants.empty()) {
+      metalFunction = [metalLibrary newFunctionWithName:shaderEntrypoint];
+    } else {
+      NSError* constantsError = nil;
+      metalFunction = [metalLibrary
+          newFunctionWithName:shaderEntrypoint
+               constantValues:toMTLFunctionConstantValues(info.specializationConstants)
+                        error:&constantsError];
+      if (!metalFunction) {
+        setResultFrom(outResult, constantsError);
+        return nullptr;
+      }
+    }
     if (!metalFunction) {
       IGL_ASSERT_MSG(0, "Could not find function '%s' in library\n", info.entryPoint.c_str());
       Result::setResult(
@@ -510,6 +994,32 @@ std::unique_ptr<IShaderLibrary> Device::createShaderLibrary(const ShaderLibraryD
   return shaderLibrary;
 }
 
+id<MTLLibrary> Device::newLibraryWithSource(const ShaderInput& input, NSError** error) const {
+  std::string key = input.options.fastMathEnabled ? "1" : "0";
+  key += input.source;
+  {
+    std::lock_guard<std::mutex> lock(shaderLibrariesMutex_);
+    auto it = shaderLibraries_.find(key);
+    if (it != shaderLibraries_.end()) {
+      return it->second;
+    }
+  }
+
+  // compiled outside of the lock, a concurrent compile of the same source just wastes some time
+  MTLCompileOptions* compileOpts = [MTLCompileOptions new];
+  compileOpts.fastMathEnabled = input.options.fastMathEnabled;
+
+  NSString* shaderSource = [NSString stringWithUTF8String:input.source];
+  id<MTLLibrary> metalLibrary = [device_ newLibraryWithSource:shaderSource
+                                                      options:compileOpts
+                                                        error:error];
+  if (metalLibrary != nil) {
+    std::lock_guard<std::mutex> lock(shaderLibrariesMutex_);
+    shaderLibraries_.emplace(std::move(key), metalLibrary);
+  }
+  return metalLibrary;
+}
+
 std::shared_ptr<IShaderModule> Device::createShaderModule(const ShaderModuleDesc& desc,
                                                           Result* outResult) const {
   auto libraryDesc =
@@ -539,6 +1049,55 @@ std::unique_ptr<IShaderStages> Device::createShaderStages(const ShaderStagesDesc
   return std::move(stages);
 }
 
+std::shared_ptr<ITimer> Device::createTimer(Result* outResult) const noexcept {
+  Result::setOk(outResult);
+  return std::make_shared<Timer>();
+}
+
+std::shared_ptr<IQueryPool> Device::createQueryPool(const QueryPoolDesc& desc,
+                                                    Result* outResult) const noexcept {
+  if (desc.type != QueryType::Occlusion) {
+    Result::setResult(outResult, Result::Code::Unsupported, "Query type is not supported");
+    return nullptr;
+  }
+  if (desc.queryCount == 0) {
+    Result::setResult(outResult, Result::Code::ArgumentInvalid, "Query count cannot be zero");
+    return nullptr;
+  }
+
+  // visibility results are written as one 64-bit value per query
+  id<MTLBuffer> buffer = [device_ newBufferWithLength:desc.queryCount * sizeof(uint64_t)
+                                              options:MTLResourceStorageModeShared];
+  if (buffer == nil) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create a query pool");
+    return nullptr;
+  }
+  if (!desc.debugName.empty()) {
+    buffer.label = [NSString stringWithUTF8String:desc.debugName.c_str()];
+  }
+
+  Result::setOk(outResult);
+  return std::make_shared<QueryPool>(buffer, desc);
+}
+
+bool Device::getMemoryStatistics(DeviceMemoryStatistics& outStatistics) const noexcept {
+  // Metal does not expose memory heaps; report everything as a single device-local heap
+  outStatistics.heaps.resize(1);
+  MemoryHeapStatistics& heap = outStatistics.heaps[0];
+  heap.isDeviceLocal = true;
+  heap.usage = 0;
+  heap.budget = 0;
+  if (@available(macOS 10.13, iOS 11.0, *)) {
+    heap.usage = device_.currentAllocatedSize;
+  }
+  if (@available(macOS 10.12, iOS 16.0, *)) {
+    heap.budget = device_.recommendedMaxWorkingSetSize;
+  }
+  outStatistics.textureBytes = 0;
+  outStatistics.bufferBytes = 0;
+  return true;
+}
+
 const PlatformDevice& Device::getPlatformDevice() const noexcept {
   return platformDevice_;
 }
@@ -625,6 +1184,11 @@ MTLStorageMode Device::toMTLStorageMode(ResourceStorage storage) {
   case ResourceStorage::Shared:
     return MTLStorageModeShared;
 #if IGL_PLATFORM_MACOS || IGL_PLATFORM_MACCATALYST
+  case ResourceStorage::Memoryless:
+    if (@available(macOS 11.0, macCatalyst 14.0, *)) {
+      return MTLStorageModeMemoryless;
+    }
+    return MTLStorageModePrivate;
   case ResourceStorage::Managed:
   default:
     return MTLStorageModeManaged;
@@ -644,6 +1208,11 @@ MTLResourceOptions Device::toMTLResourceStorageMode(ResourceStorage storage) {
   case ResourceStorage::Shared:
     return MTLResourceStorageModeShared;
 #if IGL_PLATFORM_MACOS || IGL_PLATFORM_MACCATALYST
+  case ResourceStorage::Memoryless:
+    if (@available(macOS 11.0, macCatalyst 14.0, *)) {
+      return MTLResourceStorageModeMemoryless;
+    }
+    return MTLResourceStorageModePrivate;
   case ResourceStorage::Managed:
   default:
     return MTLResourceStorageModeManaged;
@@ -6,6 +6,7 @@
  */
 
 #include <igl/metal/DeviceFeatureSet.h>
+#include <igl/metal/PushConstantBlock.h>
 
 #include <vector>
 
@@ -94,6 +95,15 @@ void DeviceFeatureSet::getFeatureSet(id<MTLDevice> device) {
 
   // get max buffer length
   maxBufferLength_ = [device maxBufferLength];
+
+  // all iOS GPUs are tile-based; on macOS only Apple silicon GPUs are
+#if IGL_PLATFORM_IOS
+  supportsProgrammableBlending_ = true;
+#elif IGL_PLATFORM_MACOS
+  if (@available(macOS 10.15, *)) {
+    supportsProgrammableBlending_ = [device supportsFamily:MTLGPUFamilyApple1];
+  }
+#endif
 }
 
 bool DeviceFeatureSet::hasFeature(DeviceFeatures feature) const {
@@ -122,6 +132,7 @@ bool DeviceFeatureSet::hasFeature(DeviceFeatures feature) const {
   case DeviceFeatures::Texture3D:
   case DeviceFeatures::SRGB:
   case DeviceFeatures::DrawIndexedIndirect:
+  case DeviceFeatures::DrawInstanced:
     return true;
   // on Metal and Vulkan, the framebuffer pixel format dictates sRGB control.
   case DeviceFeatures::SRGBWriteControl:
@@ -129,6 +140,9 @@ bool DeviceFeatureSet::hasFeature(DeviceFeatures feature) const {
   // No current Metal devices support packed, uncompressed RGB textures.
   case DeviceFeatures::TextureFormatRGB:
     return false;
+  // programmable blending: fragment functions read the attachments with [[color(n)]]
+  case DeviceFeatures::FramebufferFetch:
+    return supportsProgrammableBlending_;
   case DeviceFeatures::ExplicitBindingExt:
   case DeviceFeatures::StandardDerivativeExt:
   case DeviceFeatures::ShaderTextureLodExt:
@@ -146,6 +160,14 @@ bool DeviceFeatureSet::hasFeature(DeviceFeatures feature) const {
 #endif
   case DeviceFeatures::TextureExternalImage:
     return false;
+  case DeviceFeatures::MultiDrawIndirectCount:
+    return false;
+  case DeviceFeatures::SparseTextures:
+    return false;
+  // rasterization rate maps warp the render targets and need a resolve pass of their own, they do
+  // not fit per-draw shading rates
+  case DeviceFeatures::ShadingRate:
+    return false;
   case DeviceFeatures::Compute:
     return true;
   case DeviceFeatures::TextureBindless:
@@ -154,22 +176,33 @@ bool DeviceFeatureSet::hasFeature(DeviceFeatures feature) const {
     return false;
   case DeviceFeatures::Multiview:
     return false;
+  case DeviceFeatures::OcclusionQueries:
+    return true;
+  case DeviceFeatures::PipelineStatisticsQueries:
+    return false;
   case DeviceFeatures::BindUniform:
     return false;
   case DeviceFeatures::TexturePartialMipChain:
     return true;
+  case DeviceFeatures::TextureViews:
+    return true;
   case DeviceFeatures::BufferRing:
     return true;
   case DeviceFeatures::BufferNoCopy:
     return true;
   case DeviceFeatures::ShaderLibrary:
     return true;
+  // half is a native type of the Metal Shading Language
+  case DeviceFeatures::ShaderFloat16:
+    return true;
   case DeviceFeatures::BindBytes:
     return true;
   case DeviceFeatures::TextureArrayExt:
     return false;
   case DeviceFeatures::SamplerMinMaxLod:
     return true;
+  case DeviceFeatures::Timers:
+    return true;
   case DeviceFeatures::ValidationLayersEnabled:
     return false;
   }
@@ -231,7 +264,7 @@ bool DeviceFeatureSet::getFeatureLimits(DeviceFeatureLimits featureLimits, size_
     result = maxMultisampleCount_;
     return true;
   case DeviceFeatureLimits::MaxPushConstantBytes:
-    result = 4096;
+    result = PushConstantBlock::kMaxSize;
     return true;
   case DeviceFeatureLimits::MaxUniformBufferBytes:
     result = maxBufferLength_;
@@ -7,22 +7,67 @@
 
 #pragma once
 
+#include <Metal/Metal.h>
 #include <cstdint>
+#include <memory>
 #include <stddef.h>
+#include <vector>
 
 namespace igl::metal {
 
+class CommandBuffer;
 class CommandQueue;
 
 class DeviceStatistics {
  public:
+  /// GPU times in milliseconds. The averages are exponential moving averages over about the last
+  /// kAverageWindow samples.
+  struct GpuTimes {
+    uint64_t commandBufferCount = 0;
+    double lastCommandBufferMs = 0.0;
+    double averageCommandBufferMs = 0.0;
+    // only collected while encoder timestamps are enabled
+    double averageRenderPassMs = 0.0;
+    double averageComputePassMs = 0.0;
+  };
+  static constexpr double kAverageWindow = 32.0;
+  // encoders past this count in a command buffer are not timed
+  static constexpr size_t kMaxTimedEncoders = 64;
+
+  DeviceStatistics();
+
   [[nodiscard]] size_t getDrawCount() const noexcept;
 
+  /// Can be called from any thread. Never waits: the times are updated by the completion handlers
+  /// of the submitted command buffers.
+  [[nodiscard]] GpuTimes getGpuTimes() const noexcept;
+
+  /// Samples GPU timestamps at the start and end of every render and compute encoder. This needs a
+  /// MTLCounterSampleBuffer per command buffer in flight, so it is off by default. Has no effect on
+  /// GPUs which cannot sample counters at stage boundaries, or before iOS 14 and macOS 11.
+  void setEncoderTimestampsEnabled(bool enabled) noexcept;
+  [[nodiscard]] bool getEncoderTimestampsEnabled() const noexcept;
+
  private:
+  friend class CommandBuffer;
   friend class CommandQueue;
+
+  enum class EncoderType : uint8_t { Render, Compute };
+  struct State;
+
   void incrementDrawCount(uint32_t newDrawCount) noexcept;
+  // returns a MTLCounterSampleBuffer of 2 * kMaxTimedEncoders timestamps, or nil if encoder
+  // timestamps are disabled or unsupported
+  id acquireSampleBuffer(id<MTLDevice> device) const;
+  // collects the times of `commandBuffer` once it has completed; `encoders` are the encoders
+  // sampled in `sampleBuffer`, in order
+  void addCompletedHandler(id<MTLCommandBuffer> commandBuffer,
+                           id sampleBuffer,
+                           std::vector<EncoderType> encoders) const;
 
   size_t currentDrawCount_ = 0;
+  // shared with the completion handlers, which can outlive the device
+  std::shared_ptr<State> state_;
 };
 
 } // namespace igl::metal
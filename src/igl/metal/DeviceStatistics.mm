@@ -7,8 +7,41 @@
 
 #include <igl/metal/DeviceStatistics.h>
 
+#include <atomic>
+#include <igl/Common.h>
+#include <mutex>
+
 namespace igl::metal {
 
+struct DeviceStatistics::State {
+  std::atomic<bool> encoderTimestampsEnabled{false};
+  std::atomic<uint64_t> commandBufferCount{0};
+  std::atomic<double> lastCommandBufferMs{0.0};
+  std::atomic<double> averageCommandBufferMs{0.0};
+  std::atomic<double> averageRenderPassMs{0.0};
+  std::atomic<double> averageComputePassMs{0.0};
+
+  // sample buffers of the completed command buffers, ready for reuse
+  std::mutex sampleBufferMutex;
+  std::vector<id> freeSampleBuffers;
+};
+
+namespace {
+
+void updateAverage(std::atomic<double>& average, double sample) {
+  double current = average.load(std::memory_order_relaxed);
+  double next = 0.0;
+  do {
+    // the first sample seeds the average
+    next = current == 0.0 ? sample
+                          : current + (sample - current) / DeviceStatistics::kAverageWindow;
+  } while (!average.compare_exchange_weak(current, next, std::memory_order_relaxed));
+}
+
+} // namespace
+
+DeviceStatistics::DeviceStatistics() : state_(std::make_shared<State>()) {}
+
 void DeviceStatistics::incrementDrawCount(uint32_t newDrawCount) noexcept {
   currentDrawCount_ += newDrawCount;
 }
@@ -17,4 +50,123 @@ size_t DeviceStatistics::getDrawCount() const noexcept {
   return currentDrawCount_;
 }
 
+DeviceStatistics::GpuTimes DeviceStatistics::getGpuTimes() const noexcept {
+  GpuTimes times;
+  times.commandBufferCount = state_->commandBufferCount.load(std::memory_order_relaxed);
+  times.lastCommandBufferMs = state_->lastCommandBufferMs.load(std::memory_order_relaxed);
+  times.averageCommandBufferMs = state_->averageCommandBufferMs.load(std::memory_order_relaxed);
+  times.averageRenderPassMs = state_->averageRenderPassMs.load(std::memory_order_relaxed);
+  times.averageComputePassMs = state_->averageComputePassMs.load(std::memory_order_relaxed);
+  return times;
+}
+
+void DeviceStatistics::setEncoderTimestampsEnabled(bool enabled) noexcept {
+  state_->encoderTimestampsEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool DeviceStatistics::getEncoderTimestampsEnabled() const noexcept {
+  return state_->encoderTimestampsEnabled.load(std::memory_order_relaxed);
+}
+
+id DeviceStatistics::acquireSampleBuffer(id<MTLDevice> device) const {
+  if (!getEncoderTimestampsEnabled()) {
+    return nil;
+  }
+  if (@available(macOS 11.0, iOS 14.0, *)) {
+    {
+      std::lock_guard<std::mutex> lock(state_->sampleBufferMutex);
+      if (!state_->freeSampleBuffers.empty()) {
+        id sampleBuffer = state_->freeSampleBuffers.back();
+        state_->freeSampleBuffers.pop_back();
+        return sampleBuffer;
+      }
+    }
+
+    if (![device supportsCounterSampling:MTLCounterSamplingPointAtStageBoundary]) {
+      return nil;
+    }
+    id<MTLCounterSet> timestampCounterSet = nil;
+    for (id<MTLCounterSet> counterSet in device.counterSets) {
+      if ([counterSet.name isEqualToString:MTLCommonCounterSetTimestamp]) {
+        timestampCounterSet = counterSet;
+        break;
+      }
+    }
+    if (timestampCounterSet == nil) {
+      return nil;
+    }
+
+    MTLCounterSampleBufferDescriptor* desc = [MTLCounterSampleBufferDescriptor new];
+    desc.counterSet = timestampCounterSet;
+    desc.storageMode = MTLStorageModeShared;
+    desc.sampleCount = 2 * kMaxTimedEncoders;
+    desc.label = @"Encoder timestamps";
+    NSError* error = nil;
+    id<MTLCounterSampleBuffer> sampleBuffer = [device newCounterSampleBufferWithDescriptor:desc
+                                                                                     error:&error];
+    IGL_ASSERT_MSG(sampleBuffer != nil,
+                   "Cannot create counter sample buffer: %s",
+                   error.localizedDescription.UTF8String);
+    return sampleBuffer;
+  }
+  return nil;
+}
+
+void DeviceStatistics::addCompletedHandler(id<MTLCommandBuffer> commandBuffer,
+                                           id sampleBuffer,
+                                           std::vector<EncoderType> encoders) const {
+  // CPU and GPU timestamps taken now and on completion give the length of a GPU timestamp tick
+  MTLTimestamp cpuStart = 0;
+  MTLTimestamp gpuStart = 0;
+  if (sampleBuffer != nil) {
+    if (@available(macOS 11.0, iOS 14.0, *)) {
+      [commandBuffer.device sampleTimestamps:&cpuStart gpuTimestamp:&gpuStart];
+    }
+  }
+
+  // the block keeps the state alive until the command buffer has completed
+  std::shared_ptr<State> state = state_;
+  [commandBuffer addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
+    if (buffer.status == MTLCommandBufferStatusCompleted) {
+      const double commandBufferMs = (buffer.GPUEndTime - buffer.GPUStartTime) * 1000.0;
+      state->lastCommandBufferMs.store(commandBufferMs, std::memory_order_relaxed);
+      updateAverage(state->averageCommandBufferMs, commandBufferMs);
+      state->commandBufferCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (sampleBuffer == nil) {
+      return;
+    }
+
+    if (@available(macOS 11.0, iOS 14.0, *)) {
+      if (buffer.status == MTLCommandBufferStatusCompleted) {
+        MTLTimestamp cpuEnd = 0;
+        MTLTimestamp gpuEnd = 0;
+        [buffer.device sampleTimestamps:&cpuEnd gpuTimestamp:&gpuEnd];
+        const double nanosPerTick = gpuEnd > gpuStart ? static_cast<double>(cpuEnd - cpuStart) /
+                                                            static_cast<double>(gpuEnd - gpuStart)
+                                                      : 1.0;
+
+        id<MTLCounterSampleBuffer> counterSampleBuffer = sampleBuffer;
+        NSData* data =
+            [counterSampleBuffer resolveCounterRange:NSMakeRange(0, 2 * encoders.size())];
+        const auto* timestamps = static_cast<const MTLCounterResultTimestamp*>(data.bytes);
+        for (size_t i = 0; data != nil && i < encoders.size(); i++) {
+          const uint64_t start = timestamps[2 * i].timestamp;
+          const uint64_t end = timestamps[2 * i + 1].timestamp;
+          if (start == MTLCounterErrorValue || end == MTLCounterErrorValue || end < start) {
+            continue;
+          }
+          const double encoderMs = static_cast<double>(end - start) * nanosPerTick * 1e-6;
+          updateAverage(encoders[i] == EncoderType::Render ? state->averageRenderPassMs
+                                                           : state->averageComputePassMs,
+                        encoderMs);
+        }
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(state->sampleBufferMutex);
+    state->freeSampleBuffers.push_back(sampleBuffer);
+  }];
+}
+
 } // namespace igl::metal
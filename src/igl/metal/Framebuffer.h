@@ -7,8 +7,13 @@
 
 #pragma once
 
+#include <array>
+#include <igl/Common.h>
 #include <igl/Framebuffer.h>
+#include <utility>
+#include <vector>
 
+@class MTLRenderPassDescriptor;
 @protocol MTLTexture;
 
 namespace igl {
@@ -20,6 +25,10 @@ namespace metal {
 
 class Framebuffer : public IFramebuffer {
  public:
+  /// Load and store actions, layer and mip level of every color attachment, then of the depth and
+  /// stencil attachments, as packed by RenderCommandEncoder::createRenderPassDescriptor()
+  using RenderPassConfig = std::array<uint32_t, IGL_COLOR_ATTACHMENTS_MAX + 2>;
+
   explicit Framebuffer(FramebufferDesc value);
   ~Framebuffer() override = default;
 
@@ -59,6 +68,12 @@ class Framebuffer : public IFramebuffer {
     return value_;
   }
 
+  /// Render pass descriptors targeting this framebuffer, reused by the render passes with the same
+  /// configuration. Cleared when updateDrawable() adds or removes an attachment.
+  MTLRenderPassDescriptor* findRenderPassDescriptor(const RenderPassConfig& config) const;
+  void cacheRenderPassDescriptor(const RenderPassConfig& config,
+                                 MTLRenderPassDescriptor* descriptor);
+
  private:
   void copyBytes(ICommandQueue& cmdQueue,
                  const std::shared_ptr<ITexture>& iglTexture,
@@ -69,7 +84,11 @@ class Framebuffer : public IFramebuffer {
                        id<MTLTexture> texture,
                        const TextureRangeDesc& range) const = 0;
 
+  static constexpr size_t kMaxRenderPassDescriptors = 4;
+
   FramebufferDesc value_;
+  // least recently created first
+  std::vector<std::pair<RenderPassConfig, MTLRenderPassDescriptor*>> renderPassDescriptors_;
 };
 
 } // namespace metal
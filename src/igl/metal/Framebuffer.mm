@@ -142,7 +142,26 @@ void Framebuffer::copyBytes(ICommandQueue& cmdQueue,
   }
 }
 
+MTLRenderPassDescriptor* Framebuffer::findRenderPassDescriptor(
+    const RenderPassConfig& config) const {
+  for (const auto& entry : renderPassDescriptors_) {
+    if (entry.first == config) {
+      return entry.second;
+    }
+  }
+  return nil;
+}
+
+void Framebuffer::cacheRenderPassDescriptor(const RenderPassConfig& config,
+                                            MTLRenderPassDescriptor* descriptor) {
+  if (renderPassDescriptors_.size() == kMaxRenderPassDescriptors) {
+    renderPassDescriptors_.erase(renderPassDescriptors_.begin());
+  }
+  renderPassDescriptors_.emplace_back(config, descriptor);
+}
+
 std::shared_ptr<ITexture> Framebuffer::updateDrawable(std::shared_ptr<ITexture> texture) {
+  const bool hadColorAttachment = value_.colorAttachments.count(0) != 0;
   if (texture == nullptr && getColorAttachment(0) != nullptr) {
     // Removing an existing texture attachment
     value_.colorAttachments.erase(0);
@@ -152,6 +171,11 @@ std::shared_ptr<ITexture> Framebuffer::updateDrawable(std::shared_ptr<ITexture>
     value_.colorAttachments[0].texture = texture;
   }
 
+  // the cached descriptors only have the textures of their attachments replaced
+  if (hadColorAttachment != (value_.colorAttachments.count(0) != 0)) {
+    renderPassDescriptors_.clear();
+  }
+
   return texture;
 }
 
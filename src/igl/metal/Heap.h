@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#import <Metal/Metal.h>
+#include <igl/Buffer.h>
+#include <igl/Texture.h>
+#include <memory>
+#include <string>
+
+namespace igl {
+namespace metal {
+
+class Device;
+
+struct HeapDesc {
+  enum class HeapType : uint8_t {
+    // Metal picks where resources go. Resources marked aliasable can be reused by later ones.
+    Automatic,
+    // Resources are placed at offsets chosen by the caller, and alias where they overlap
+    Placement,
+  };
+
+  HeapType type = HeapType::Automatic;
+  size_t size = 0;
+  ResourceStorage storage = ResourceStorage::Private;
+  std::string debugName;
+};
+
+/**
+ * @brief A MTLHeap that buffers and textures are sub-allocated from. Allocating from a heap is much
+ * cheaper than allocating from the device, and all of its resources are made resident with one
+ * useHeap call.
+ *
+ * Transient render targets which are never used at the same time in a frame can share memory:
+ * on automatic heaps by calling makeAliasable() once a texture has been used for the last time in
+ * the frame, and on placement heaps by placing them at overlapping offsets. The caller must make
+ * sure that GPU work using aliased resources does not overlap, e.g. with a fence.
+ */
+class Heap final {
+ public:
+  Heap(const Device& device, id<MTLHeap> heap, HeapDesc::HeapType type);
+
+  /// Returns nullptr if the heap is full
+  std::unique_ptr<IBuffer> createBuffer(const BufferDesc& desc, Result* outResult) const;
+
+  /// Only for automatic heaps. Returns nullptr if the heap is full.
+  std::shared_ptr<ITexture> createTexture(const TextureDesc& desc, Result* outResult) const;
+
+  /// Only for placement heaps. `offset` must be aligned to getTextureAlignment()
+  std::shared_ptr<ITexture> createTexture(const TextureDesc& desc,
+                                          size_t offset,
+                                          Result* outResult) const;
+
+  /// The memory a texture described by `desc` takes in a heap, to plan placement offsets
+  [[nodiscard]] size_t getTextureSize(const TextureDesc& desc) const;
+  [[nodiscard]] size_t getTextureAlignment(const TextureDesc& desc) const;
+
+  /// Lets subsequent allocations from an automatic heap reuse the memory of `texture`
+  static void makeAliasable(ITexture& texture);
+
+  [[nodiscard]] size_t getSize() const;
+  [[nodiscard]] size_t getUsedSize() const;
+
+  IGL_INLINE id<MTLHeap> get() const {
+    return heap_;
+  }
+
+ private:
+  [[nodiscard]] MTLSizeAndAlign getTextureSizeAndAlign(const TextureDesc& desc) const;
+  // `offset` is nullptr on automatic heaps
+  std::shared_ptr<ITexture> allocateTexture(const TextureDesc& desc,
+                                            const size_t* offset,
+                                            Result* outResult) const;
+
+  const Device& device_;
+  id<MTLHeap> heap_;
+  HeapDesc::HeapType type_;
+};
+
+} // namespace metal
+} // namespace igl
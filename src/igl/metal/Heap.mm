@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/Heap.h>
+
+#include <cstring>
+#include <igl/IResourceTracker.h>
+#include <igl/metal/Buffer.h>
+#include <igl/metal/Device.h>
+#include <igl/metal/Texture.h>
+
+namespace igl {
+namespace metal {
+
+Heap::Heap(const Device& device, id<MTLHeap> heap, HeapDesc::HeapType type) :
+  device_(device), heap_(heap), type_(type) {}
+
+std::unique_ptr<IBuffer> Heap::createBuffer(const BufferDesc& desc, Result* outResult) const {
+  if (desc.hint & (BufferDesc::BufferAPIHintBits::Ring | BufferDesc::BufferAPIHintBits::NoCopy)) {
+    Result::setResult(outResult,
+                      Result::Code::Unsupported,
+                      "Ring and no-copy buffers cannot be allocated from a heap");
+    return nullptr;
+  }
+  if (desc.data != nullptr && heap_.storageMode == MTLStorageModePrivate) {
+    Result::setResult(outResult,
+                      Result::Code::ArgumentInvalid,
+                      "Buffers allocated from a private heap cannot have initial data");
+    return nullptr;
+  }
+
+  const MTLResourceOptions options = MTLResourceOptionCPUCacheModeDefault |
+                                     (heap_.storageMode << MTLResourceStorageModeShift);
+  id<MTLBuffer> metalObject = [heap_ newBufferWithLength:desc.length options:options];
+  if (metalObject == nil) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Heap is full");
+    return nullptr;
+  }
+  if (desc.data != nullptr) {
+    memcpy(metalObject.contents, desc.data, desc.length);
+#if IGL_PLATFORM_MACOS
+    if (heap_.storageMode == MTLStorageModeManaged) {
+      [metalObject didModifyRange:NSMakeRange(0, desc.length)];
+    }
+#endif
+  }
+
+  std::unique_ptr<IBuffer> resource = std::make_unique<Buffer>(
+      metalObject, options, desc.hint, 0 /* No accepted hints */);
+  if (device_.getResourceTracker()) {
+    resource->initResourceTracker(device_.getResourceTracker(),
+                                  {resource->getSizeInBytes(),
+                                   toResourceMemoryLocation(resource->storage()),
+                                   desc.debugName});
+  }
+  Result::setOk(outResult);
+  return resource;
+}
+
+std::shared_ptr<ITexture> Heap::createTexture(const TextureDesc& desc, Result* outResult) const {
+  if (!IGL_VERIFY(type_ == HeapDesc::HeapType::Automatic)) {
+    Result::setResult(outResult,
+                      Result::Code::ArgumentInvalid,
+                      "Textures are placed at an offset in placement heaps");
+    return nullptr;
+  }
+  return allocateTexture(desc, nullptr, outResult);
+}
+
+std::shared_ptr<ITexture> Heap::createTexture(const TextureDesc& desc,
+                                              size_t offset,
+                                              Result* outResult) const {
+  if (!IGL_VERIFY(type_ == HeapDesc::HeapType::Placement)) {
+    Result::setResult(outResult,
+                      Result::Code::ArgumentInvalid,
+                      "Textures cannot be placed at an offset in automatic heaps");
+    return nullptr;
+  }
+  return allocateTexture(desc, &offset, outResult);
+}
+
+std::shared_ptr<ITexture> Heap::allocateTexture(const TextureDesc& desc,
+                                                const size_t* offset,
+                                                Result* outResult) const {
+  ResourceStorage storage = desc.storage;
+  MTLTextureDescriptor* metalDesc = device_.createTextureDescriptor(desc, storage, outResult);
+  if (metalDesc == nil) {
+    return nullptr;
+  }
+  // the resources of a heap all have its storage mode
+  metalDesc.storageMode = heap_.storageMode;
+  metalDesc.resourceOptions = MTLResourceCPUCacheModeDefaultCache |
+                              (heap_.storageMode << MTLResourceStorageModeShift);
+
+  id<MTLTexture> metalObject = nil;
+  if (offset != nullptr) {
+    if (@available(macOS 10.15, iOS 13.0, *)) {
+      metalObject = [heap_ newTextureWithDescriptor:metalDesc offset:*offset];
+    }
+  } else {
+    metalObject = [heap_ newTextureWithDescriptor:metalDesc];
+  }
+  if (metalObject == nil) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Heap is full");
+    return nullptr;
+  }
+
+  auto iglObject = std::make_shared<Texture>(metalObject);
+  if (device_.getResourceTracker()) {
+    iglObject->initResourceTracker(device_.getResourceTracker(),
+                                   {iglObject->getEstimatedSizeInBytes(),
+                                    toResourceMemoryLocation(storage),
+                                    desc.debugName});
+  }
+  Result::setOk(outResult);
+  return iglObject;
+}
+
+MTLSizeAndAlign Heap::getTextureSizeAndAlign(const TextureDesc& desc) const {
+  ResourceStorage storage = desc.storage;
+  Result result;
+  MTLTextureDescriptor* metalDesc = device_.createTextureDescriptor(desc, storage, &result);
+  if (metalDesc == nil) {
+    return {0, 0};
+  }
+  metalDesc.storageMode = heap_.storageMode;
+  return [device_.get() heapTextureSizeAndAlignWithDescriptor:metalDesc];
+}
+
+size_t Heap::getTextureSize(const TextureDesc& desc) const {
+  return getTextureSizeAndAlign(desc).size;
+}
+
+size_t Heap::getTextureAlignment(const TextureDesc& desc) const {
+  return getTextureSizeAndAlign(desc).align;
+}
+
+void Heap::makeAliasable(ITexture& texture) {
+  id<MTLTexture> metalTexture = static_cast<Texture&>(texture).get();
+  IGL_ASSERT_MSG(metalTexture.heap != nil, "Only textures allocated from a heap can be aliased");
+  [metalTexture makeAliasable];
+}
+
+size_t Heap::getSize() const {
+  return heap_.size;
+}
+
+size_t Heap::getUsedSize() const {
+  return heap_.usedSize;
+}
+
+} // namespace metal
+} // namespace igl
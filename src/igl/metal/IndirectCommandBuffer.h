@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <Metal/Metal.h>
+#include <igl/Buffer.h>
+#include <igl/RenderCommandEncoder.h>
+#include <string>
+#include <vector>
+
+namespace igl {
+namespace metal {
+
+struct IndirectCommandBufferDesc {
+  enum class CommandType : uint8_t { Draw, DrawIndexed };
+
+  CommandType commandType = CommandType::DrawIndexed;
+  size_t maxCommandCount = 0;
+  std::string debugName;
+};
+
+/**
+ * @brief A Metal indirect command buffer of draws. The commands are encoded once, either on the
+ * CPU or by a compute kernel (e.g. a culling and LOD pass writing `render_command`s through an
+ * argument buffer, see ArgumentBuffer::setIndirectCommandBuffer()), and the whole list is then
+ * executed by RenderCommandEncoder::executeIndirectCommands() without per-draw CPU encoding.
+ *
+ * Commands inherit the pipeline state and the buffers bound to the render encoder which executes
+ * them. Index buffers are referenced by the commands themselves, so they must be known to this
+ * object to be made resident: the ones passed to encodeDrawIndexed() are tracked, and the ones
+ * used by commands encoded on the GPU must be passed to addResource().
+ */
+class IndirectCommandBuffer final {
+ public:
+  IndirectCommandBuffer(id<MTLIndirectCommandBuffer> buffer, const IndirectCommandBufferDesc& desc);
+
+  void encodeDraw(size_t commandIndex,
+                  PrimitiveType primitiveType,
+                  size_t vertexStart,
+                  size_t vertexCount,
+                  uint32_t instanceCount = 1,
+                  uint32_t baseInstance = 0);
+  void encodeDrawIndexed(size_t commandIndex,
+                         PrimitiveType primitiveType,
+                         size_t indexCount,
+                         IndexFormat indexFormat,
+                         IBuffer& indexBuffer,
+                         size_t indexBufferOffset,
+                         uint32_t instanceCount = 1,
+                         int32_t baseVertex = 0,
+                         uint32_t baseInstance = 0);
+  /// Turns `count` commands starting at `start` into no-ops
+  void reset(size_t start, size_t count);
+
+  /// Makes `buffer` resident whenever the commands are executed
+  void addResource(IBuffer& buffer);
+
+  [[nodiscard]] size_t getMaxCommandCount() const {
+    return desc_.maxCommandCount;
+  }
+
+  /// The buffers referenced by the commands
+  [[nodiscard]] const std::vector<id<MTLResource>>& getResources() const {
+    return resources_;
+  }
+
+  IGL_INLINE id<MTLIndirectCommandBuffer> get() const {
+    return buffer_;
+  }
+
+ private:
+  void addResource(id<MTLResource> resource);
+
+  id<MTLIndirectCommandBuffer> buffer_;
+  IndirectCommandBufferDesc desc_;
+  std::vector<id<MTLResource>> resources_;
+};
+
+} // namespace metal
+} // namespace igl
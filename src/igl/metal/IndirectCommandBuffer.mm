@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/IndirectCommandBuffer.h>
+
+#include <algorithm>
+#include <igl/metal/Buffer.h>
+#include <igl/metal/RenderCommandEncoder.h>
+
+namespace igl {
+namespace metal {
+
+IndirectCommandBuffer::IndirectCommandBuffer(id<MTLIndirectCommandBuffer> buffer,
+                                             const IndirectCommandBufferDesc& desc) :
+  buffer_(buffer), desc_(desc) {}
+
+void IndirectCommandBuffer::encodeDraw(size_t commandIndex,
+                                       PrimitiveType primitiveType,
+                                       size_t vertexStart,
+                                       size_t vertexCount,
+                                       uint32_t instanceCount,
+                                       uint32_t baseInstance) {
+  IGL_ASSERT(desc_.commandType == IndirectCommandBufferDesc::CommandType::Draw);
+  if (!IGL_VERIFY(commandIndex < desc_.maxCommandCount)) {
+    return;
+  }
+  id<MTLIndirectRenderCommand> command = [buffer_ indirectRenderCommandAtIndex:commandIndex];
+  [command drawPrimitives:RenderCommandEncoder::convertPrimitiveType(primitiveType)
+              vertexStart:vertexStart
+              vertexCount:vertexCount
+            instanceCount:instanceCount
+             baseInstance:baseInstance];
+}
+
+void IndirectCommandBuffer::encodeDrawIndexed(size_t commandIndex,
+                                              PrimitiveType primitiveType,
+                                              size_t indexCount,
+                                              IndexFormat indexFormat,
+                                              IBuffer& indexBuffer,
+                                              size_t indexBufferOffset,
+                                              uint32_t instanceCount,
+                                              int32_t baseVertex,
+                                              uint32_t baseInstance) {
+  IGL_ASSERT(desc_.commandType == IndirectCommandBufferDesc::CommandType::DrawIndexed);
+  if (!IGL_VERIFY(commandIndex < desc_.maxCommandCount)) {
+    return;
+  }
+  id<MTLBuffer> metalIndexBuffer = static_cast<Buffer&>(indexBuffer).get();
+  id<MTLIndirectRenderCommand> command = [buffer_ indirectRenderCommandAtIndex:commandIndex];
+  [command drawIndexedPrimitives:RenderCommandEncoder::convertPrimitiveType(primitiveType)
+                      indexCount:indexCount
+                       indexType:RenderCommandEncoder::convertIndexType(indexFormat)
+                     indexBuffer:metalIndexBuffer
+               indexBufferOffset:indexBufferOffset
+                   instanceCount:instanceCount
+                      baseVertex:baseVertex
+                    baseInstance:baseInstance];
+  addResource(metalIndexBuffer);
+}
+
+void IndirectCommandBuffer::reset(size_t start, size_t count) {
+  if (!IGL_VERIFY(start + count <= desc_.maxCommandCount)) {
+    return;
+  }
+  [buffer_ resetWithRange:NSMakeRange(start, count)];
+}
+
+void IndirectCommandBuffer::addResource(IBuffer& buffer) {
+  addResource(static_cast<Buffer&>(buffer).get());
+}
+
+void IndirectCommandBuffer::addResource(id<MTLResource> resource) {
+  if (std::find(resources_.begin(), resources_.end(), resource) == resources_.end()) {
+    resources_.push_back(resource);
+  }
+}
+
+} // namespace metal
+} // namespace igl
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <Metal/Metal.h>
+#include <igl/ParallelRenderCommandEncoder.h>
+#include <igl/RenderPass.h>
+#include <igl/metal/CommandBuffer.h>
+
+namespace igl {
+namespace metal {
+
+class ParallelRenderCommandEncoder final : public IParallelRenderCommandEncoder {
+ public:
+  static std::unique_ptr<ParallelRenderCommandEncoder> create(
+      const std::shared_ptr<CommandBuffer>& commandBuffer,
+      const RenderPassDesc& renderPass,
+      const std::shared_ptr<IFramebuffer>& framebuffer,
+      Result* outResult);
+
+  ~ParallelRenderCommandEncoder() override = default;
+
+  std::unique_ptr<IRenderCommandEncoder> createRenderCommandEncoder(Result* outResult) override;
+
+  void endEncoding() override;
+
+  void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
+  void insertDebugEventLabel(const std::string& label, const igl::Color& color) const override;
+  void popDebugGroupLabel() const override;
+
+ private:
+  explicit ParallelRenderCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer);
+
+  std::shared_ptr<CommandBuffer> commandBuffer_;
+  id<MTLParallelRenderCommandEncoder> encoder_ = nil;
+};
+
+} // namespace metal
+} // namespace igl
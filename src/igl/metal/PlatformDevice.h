@@ -9,6 +9,7 @@
 
 #import <CoreVideo/CVMetalTextureCache.h>
 #import <CoreVideo/CVPixelBuffer.h>
+#import <IOSurface/IOSurfaceRef.h>
 #import <Metal/Metal.h>
 #import <QuartzCore/CALayer.h>
 #import <QuartzCore/CAMetalLayer.h>
@@ -24,8 +25,15 @@ struct FramebufferDesc;
 
 namespace metal {
 
+class ArgumentBuffer;
+struct ArgumentBufferDesc;
 class Device;
 class Framebuffer;
+class Heap;
+struct HeapDesc;
+class IndirectCommandBuffer;
+struct IndirectCommandBufferDesc;
+class ResourceLoader;
 class SamplerState;
 
 class PlatformDevice final : public IPlatformDevice {
@@ -40,6 +48,33 @@ class PlatformDevice final : public IPlatformDevice {
   std::shared_ptr<Framebuffer> createFramebuffer(const FramebufferDesc& desc,
                                                  Result* outResult) const;
 
+  /// Creates an argument buffer with the layout described by `desc`
+  /// @param desc the arguments, which must match the argument buffer struct in the shader
+  /// @param outResult optional result
+  /// @return pointer to generated ArgumentBuffer or nullptr if argument buffers are not supported
+  std::unique_ptr<ArgumentBuffer> createArgumentBuffer(const ArgumentBufferDesc& desc,
+                                                       Result* outResult) const;
+
+  /// Creates a heap to sub-allocate buffers and textures from
+  /// @param desc type, size and storage of the heap
+  /// @param outResult optional result
+  /// @return pointer to generated Heap or nullptr
+  std::unique_ptr<Heap> createHeap(const HeapDesc& desc, Result* outResult) const;
+
+  /// Creates an indirect command buffer of draws, encoded on the CPU or by a compute kernel
+  /// @param desc type and maximum number of the commands
+  /// @param outResult optional result
+  /// @return pointer to generated IndirectCommandBuffer or nullptr if indirect command buffers are
+  /// not supported
+  std::unique_ptr<IndirectCommandBuffer> createIndirectCommandBuffer(
+      const IndirectCommandBufferDesc& desc,
+      Result* outResult) const;
+
+  /// Creates a loader which streams asset files into buffers and textures, through a
+  /// MTLIOCommandQueue when Metal 3 is available
+  /// @return pointer to generated ResourceLoader
+  std::unique_ptr<ResourceLoader> createResourceLoader() const;
+
   /// Creates a texture from a native drawable
   /// @param nativeDrawable drawable. For Metal is MUST be CAMetalDrawable
   /// @param outResult optional result
@@ -86,6 +121,21 @@ class PlatformDevice final : public IPlatformDevice {
                                                                        size_t planeIndex,
                                                                        Result* outResult);
 
+  /// Creates a texture sharing the memory of a plane of an IOSurface, nothing is copied. Unlike
+  /// createTextureFromNativePixelBuffer() this does not go through the texture cache, so the
+  /// texture can also be rendered to when `usage` allows it.
+  /// @param surface source surface
+  /// @param format the format of the plane
+  /// @param planeIndex the plane of a planar surface, 0 otherwise
+  /// @param usage usage of the texture
+  /// @param outResult optional result
+  /// @return pointer to generated Texture or nullptr
+  std::unique_ptr<ITexture> createTextureFromIOSurface(IOSurfaceRef surface,
+                                                       TextureFormat format,
+                                                       size_t planeIndex,
+                                                       TextureDesc::TextureUsage usage,
+                                                       Result* outResult);
+
   /// Get a size of a given native drawable surface.
   /// @param nativeDrawable drawable surface. For Metal is MUST be CAMetalLayer
   /// @param outResult Optional result.
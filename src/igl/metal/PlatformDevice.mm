@@ -13,9 +13,14 @@
 
 #import <QuartzCore/QuartzCore.h>
 
+#include <algorithm>
+#include <igl/metal/ArgumentBuffer.h>
 #include <igl/metal/DepthStencilState.h>
 #include <igl/metal/Device.h>
 #include <igl/metal/Framebuffer.h>
+#include <igl/metal/Heap.h>
+#include <igl/metal/IndirectCommandBuffer.h>
+#include <igl/metal/ResourceLoader.h>
 #include <igl/metal/SamplerState.h>
 #include <igl/metal/Texture.h>
 
@@ -47,6 +52,10 @@ std::shared_ptr<SamplerState> PlatformDevice::createSamplerState(const SamplerSt
     metalDesc.compareFunction =
         DepthStencilState::convertCompareFunction(desc.depthCompareFunction);
   }
+  if (@available(macOS 10.13, iOS 11.0, *)) {
+    // lets the sampler be encoded into an ArgumentBuffer
+    metalDesc.supportArgumentBuffers = YES;
+  }
 
   id<MTLSamplerState> metalObject = [device_.get() newSamplerStateWithDescriptor:metalDesc];
   auto resource = std::make_shared<SamplerState>(metalObject);
@@ -57,6 +66,119 @@ std::shared_ptr<SamplerState> PlatformDevice::createSamplerState(const SamplerSt
   return resource;
 }
 
+std::unique_ptr<ArgumentBuffer> PlatformDevice::createArgumentBuffer(
+    const ArgumentBufferDesc& desc,
+    Result* outResult) const {
+  if (@available(macOS 10.13, iOS 11.0, *)) {
+    NSMutableArray<MTLArgumentDescriptor*>* arguments = [NSMutableArray array];
+    for (const auto& argument : desc.arguments) {
+      MTLArgumentDescriptor* metalArgument = [MTLArgumentDescriptor argumentDescriptor];
+      metalArgument.index = argument.index;
+      metalArgument.access =
+          argument.writable ? MTLArgumentAccessReadWrite : MTLArgumentAccessReadOnly;
+      switch (argument.type) {
+      case ArgumentBufferDesc::ArgumentType::Buffer:
+        metalArgument.dataType = MTLDataTypePointer;
+        break;
+      case ArgumentBufferDesc::ArgumentType::Texture:
+        metalArgument.dataType = MTLDataTypeTexture;
+        metalArgument.textureType = Texture::convertType(argument.textureType, 1);
+        break;
+      case ArgumentBufferDesc::ArgumentType::SamplerState:
+        metalArgument.dataType = MTLDataTypeSampler;
+        break;
+      case ArgumentBufferDesc::ArgumentType::IndirectCommandBuffer:
+        if (@available(macOS 10.14, iOS 12.0, *)) {
+          metalArgument.dataType = MTLDataTypeIndirectCommandBuffer;
+          metalArgument.access = MTLArgumentAccessReadWrite;
+        }
+        break;
+      }
+      [arguments addObject:metalArgument];
+    }
+
+    id<MTLArgumentEncoder> encoder = [device_.get() newArgumentEncoderWithArguments:arguments];
+    id<MTLBuffer> buffer = nil;
+    if (encoder != nil) {
+      buffer = [device_.get() newBufferWithLength:encoder.encodedLength
+                                          options:MTLResourceStorageModeShared];
+    }
+    if (buffer == nil) {
+      Result::setResult(outResult, Result::Code::RuntimeError, "Could not create argument buffer");
+      return nullptr;
+    }
+    Result::setOk(outResult);
+    return std::make_unique<ArgumentBuffer>(encoder, buffer, desc.arguments);
+  }
+  Result::setResult(outResult, Result::Code::Unsupported, "Argument buffers are not supported");
+  return nullptr;
+}
+
+std::unique_ptr<Heap> PlatformDevice::createHeap(const HeapDesc& desc, Result* outResult) const {
+  MTLHeapDescriptor* metalDesc = [MTLHeapDescriptor new];
+  metalDesc.size = desc.size;
+  metalDesc.storageMode = Device::toMTLStorageMode(desc.storage);
+  if (desc.type == HeapDesc::HeapType::Placement) {
+    if (@available(macOS 10.15, iOS 13.0, *)) {
+      metalDesc.type = MTLHeapTypePlacement;
+    } else {
+      Result::setResult(outResult, Result::Code::Unsupported, "Placement heaps are not supported");
+      return nullptr;
+    }
+  }
+
+  id<MTLHeap> heap = [device_.get() newHeapWithDescriptor:metalDesc];
+  if (heap == nil) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Could not create heap");
+    return nullptr;
+  }
+  if (!desc.debugName.empty()) {
+    heap.label = [NSString stringWithUTF8String:desc.debugName.c_str()];
+  }
+  Result::setOk(outResult);
+  return std::make_unique<Heap>(device_, heap, desc.type);
+}
+
+std::unique_ptr<IndirectCommandBuffer> PlatformDevice::createIndirectCommandBuffer(
+    const IndirectCommandBufferDesc& desc,
+    Result* outResult) const {
+  if (!IGL_VERIFY(desc.maxCommandCount > 0)) {
+    Result::setResult(outResult, Result::Code::ArgumentInvalid, "maxCommandCount cannot be 0");
+    return nullptr;
+  }
+  // inheriting the pipeline state needs iOS 13
+  if (@available(macOS 10.14, iOS 13.0, *)) {
+    MTLIndirectCommandBufferDescriptor* metalDesc = [MTLIndirectCommandBufferDescriptor new];
+    metalDesc.commandTypes = desc.commandType == IndirectCommandBufferDesc::CommandType::Draw
+                                 ? MTLIndirectCommandTypeDraw
+                                 : MTLIndirectCommandTypeDrawIndexed;
+    metalDesc.inheritPipelineState = YES;
+    metalDesc.inheritBuffers = YES;
+
+    id<MTLIndirectCommandBuffer> buffer =
+        [device_.get() newIndirectCommandBufferWithDescriptor:metalDesc
+                                              maxCommandCount:desc.maxCommandCount
+                                                      options:MTLResourceStorageModeShared];
+    if (buffer == nil) {
+      Result::setResult(
+          outResult, Result::Code::RuntimeError, "Could not create indirect command buffer");
+      return nullptr;
+    }
+    if (!desc.debugName.empty()) {
+      buffer.label = [NSString stringWithUTF8String:desc.debugName.c_str()];
+    }
+    Result::setOk(outResult);
+    return std::make_unique<IndirectCommandBuffer>(buffer, desc);
+  }
+  Result::setResult(
+      outResult, Result::Code::Unsupported, "Indirect command buffers are not supported");
+  return nullptr;
+}
+
+std::unique_ptr<ResourceLoader> PlatformDevice::createResourceLoader() const {
+  return std::make_unique<ResourceLoader>(device_.get());
+}
+
 std::shared_ptr<Framebuffer> PlatformDevice::createFramebuffer(const FramebufferDesc& desc,
                                                                Result* outResult) const {
   return std::static_pointer_cast<Framebuffer>(device_.createFramebuffer(desc, outResult));
@@ -181,6 +303,55 @@ std::unique_ptr<ITexture> PlatformDevice::createTextureFromNativePixelBufferWith
   return resultTexture;
 }
 
+std::unique_ptr<ITexture> PlatformDevice::createTextureFromIOSurface(
+    IOSurfaceRef surface,
+    TextureFormat format,
+    size_t planeIndex,
+    TextureDesc::TextureUsage usage,
+    Result* outResult) {
+  MTLPixelFormat const metalFormat = Texture::textureFormatToMTLPixelFormat(format);
+  if (surface == nullptr || metalFormat == MTLPixelFormatInvalid) {
+    Result::setResult(outResult, Result::Code::ArgumentInvalid, "Invalid IOSurface or format");
+    return nullptr;
+  }
+  const size_t planeCount = IOSurfaceGetPlaneCount(surface);
+  if (planeIndex >= std::max<size_t>(planeCount, 1)) {
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "Invalid plane index");
+    return nullptr;
+  }
+  const bool isPlanar = planeCount > 0;
+
+  MTLTextureDescriptor* metalDesc = [MTLTextureDescriptor
+      texture2DDescriptorWithPixelFormat:metalFormat
+                                   width:(isPlanar ? IOSurfaceGetWidthOfPlane(surface, planeIndex)
+                                                   : IOSurfaceGetWidth(surface))
+                                  height:(isPlanar ? IOSurfaceGetHeightOfPlane(surface, planeIndex)
+                                                   : IOSurfaceGetHeight(surface))
+                               mipmapped:NO];
+  metalDesc.usage = Texture::toMTLTextureUsage(usage);
+  metalDesc.storageMode = MTLStorageModeShared;
+#if IGL_PLATFORM_MACOS
+  metalDesc.storageMode = MTLStorageModeManaged;
+#endif
+
+  id<MTLTexture> metalTexture = [device_.get() newTextureWithDescriptor:metalDesc
+                                                              iosurface:surface
+                                                                  plane:planeIndex];
+  if (metalTexture == nil) {
+    Result::setResult(outResult,
+                      Result::Code::RuntimeError,
+                      "Failed to create a Metal texture from an IOSurface");
+    return nullptr;
+  }
+
+  auto resultTexture = std::make_unique<Texture>(metalTexture);
+  if (auto resourceTracker = device_.getResourceTracker()) {
+    resultTexture->initResourceTracker(resourceTracker);
+  }
+  Result::setOk(outResult);
+  return resultTexture;
+}
+
 Size PlatformDevice::getNativeDrawableSize(CALayer* nativeDrawable, Result* outResult) {
 #if (!TARGET_OS_SIMULATOR || __IPHONE_OS_VERSION_MAX_ALLOWED >= 130000)
   Result::setOk(outResult);
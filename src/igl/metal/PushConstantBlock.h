@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <Metal/Metal.h>
+#include <array>
+#include <cstdint>
+
+namespace igl::metal {
+
+/**
+ * @brief Emulates the push constants of the Vulkan backend. bindPushConstants() writes into a CPU
+ * copy of the block, which the encoders pass as inline bytes at kBufferIndex before the next draw
+ * or dispatch, only if it has changed. Shaders read the block from this index, e.g.
+ * `constant PushConstants& pc [[buffer(30)]]`, which must not be used by other bindings.
+ */
+class PushConstantBlock final {
+ public:
+  /// The last buffer index of the argument table, far from the low indices of vertex buffers
+  static constexpr NSUInteger kBufferIndex = 30;
+  /// The largest size Metal accepts for inline bytes, reported as MaxPushConstantBytes
+  static constexpr size_t kMaxSize = 4096;
+
+  /// Copies `length` bytes of `data` at `offset` of the block
+  void set(size_t offset, const void* data, size_t length);
+
+  /// True if the block has been written since the last call to getDirtyBytes()
+  [[nodiscard]] bool isDirty() const {
+    return isDirty_;
+  }
+  /// Returns the bytes written so far and clears the dirty flag
+  const void* getDirtyBytes(size_t& outLength);
+
+ private:
+  std::array<uint8_t, kMaxSize> bytes_ = {};
+  // up to the end of the furthest write, 16-byte aligned like the members of MSL structures
+  size_t size_ = 0;
+  bool isDirty_ = false;
+};
+
+} // namespace igl::metal
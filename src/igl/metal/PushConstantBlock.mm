@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/PushConstantBlock.h>
+
+#include <algorithm>
+#include <cstring>
+#include <igl/Common.h>
+
+namespace igl::metal {
+
+void PushConstantBlock::set(size_t offset, const void* data, size_t length) {
+  if (!IGL_VERIFY(data && offset + length <= kMaxSize)) {
+    IGL_LOG_ERROR("Push constants size exceeded %u (max %u bytes)\n",
+                  static_cast<uint32_t>(offset + length),
+                  static_cast<uint32_t>(kMaxSize));
+    return;
+  }
+  const size_t size = std::min((offset + length + 15) / 16 * 16, kMaxSize);
+  if (size > size_) {
+    size_ = size;
+    isDirty_ = true;
+  }
+  if (memcmp(bytes_.data() + offset, data, length) != 0) {
+    memcpy(bytes_.data() + offset, data, length);
+    isDirty_ = true;
+  }
+}
+
+const void* PushConstantBlock::getDirtyBytes(size_t& outLength) {
+  isDirty_ = false;
+  outLength = size_;
+  return bytes_.data();
+}
+
+} // namespace igl::metal
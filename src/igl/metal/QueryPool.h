@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <Metal/Metal.h>
+#include <atomic>
+#include <igl/QueryPool.h>
+
+namespace igl {
+namespace metal {
+
+/**
+ * @brief Wraps the visibility result buffer of a render pass. Queries use
+ * MTLVisibilityResultModeBoolean, so results are non-zero if any samples passed. Results become
+ * available from the completion handler of the command buffer which contains the render pass.
+ */
+class QueryPool final : public IQueryPool {
+ public:
+  QueryPool(id<MTLBuffer> buffer, const QueryPoolDesc& desc);
+  ~QueryPool() override = default;
+
+  [[nodiscard]] QueryType getType() const override {
+    return desc_.type;
+  }
+  [[nodiscard]] uint32_t getQueryCount() const override {
+    return desc_.queryCount;
+  }
+
+  [[nodiscard]] bool getOcclusionResults(uint32_t firstQuery,
+                                         uint32_t numQueries,
+                                         uint64_t* outSamplesPassed) const override;
+
+  // clears all results; called when a render pass using this pool is created
+  void reset();
+  // called from the completion handler of the command buffer of the render pass
+  void onCompleted();
+
+  IGL_INLINE id<MTLBuffer> get() const {
+    return buffer_;
+  }
+
+ private:
+  id<MTLBuffer> buffer_;
+  QueryPoolDesc desc_;
+  // written from the completion handler thread
+  std::atomic<bool> resultsAvailable_{false};
+};
+
+} // namespace metal
+} // namespace igl
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/QueryPool.h>
+
+#import <Foundation/Foundation.h>
+#include <cstring>
+
+namespace igl {
+namespace metal {
+
+QueryPool::QueryPool(id<MTLBuffer> buffer, const QueryPoolDesc& desc) :
+  buffer_(buffer), desc_(desc) {}
+
+void QueryPool::reset() {
+  resultsAvailable_.store(false, std::memory_order_release);
+  // Metal only writes the results of the queries which are used by the render pass
+  memset(buffer_.contents, 0, buffer_.length);
+}
+
+void QueryPool::onCompleted() {
+  resultsAvailable_.store(true, std::memory_order_release);
+}
+
+bool QueryPool::getOcclusionResults(uint32_t firstQuery,
+                                    uint32_t numQueries,
+                                    uint64_t* outSamplesPassed) const {
+  if (!IGL_VERIFY(outSamplesPassed) ||
+      !IGL_VERIFY(numQueries > 0 && firstQuery + numQueries <= desc_.queryCount)) {
+    return false;
+  }
+
+  if (!resultsAvailable_.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  memcpy(outSamplesPassed,
+         static_cast<const uint64_t*>(buffer_.contents) + firstQuery,
+         numQueries * sizeof(uint64_t));
+
+  return true;
+}
+
+} // namespace metal
+} // namespace igl
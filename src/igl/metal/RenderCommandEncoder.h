@@ -13,10 +13,15 @@
 #include <igl/RenderPass.h>
 #include <igl/RenderPipelineState.h>
 #include <igl/metal/CommandBuffer.h>
+#include <igl/metal/PushConstantBlock.h>
+#include <unordered_map>
 
 namespace igl {
 namespace metal {
+class ArgumentBuffer;
+class IndirectCommandBuffer;
 class Buffer;
+class QueryPool;
 
 class RenderCommandEncoder final : public IRenderCommandEncoder {
  public:
@@ -26,6 +31,11 @@ class RenderCommandEncoder final : public IRenderCommandEncoder {
       const std::shared_ptr<IFramebuffer>& framebuffer,
       Result* outResult);
 
+  // wraps an encoder created elsewhere, e.g. by a MTLParallelRenderCommandEncoder
+  static std::unique_ptr<RenderCommandEncoder> create(
+      const std::shared_ptr<CommandBuffer>& commandBuffer,
+      id<MTLRenderCommandEncoder> encoder);
+
   ~RenderCommandEncoder() override = default;
 
   void endEncoding() override;
@@ -52,12 +62,38 @@ class RenderCommandEncoder final : public IRenderCommandEncoder {
   void bindTexture(size_t index, uint8_t target, ITexture* texture) override;
   void bindUniform(const UniformDesc& uniformDesc, const void* data) override;
 
+  /// Binds all the resources of `argumentBuffer` with a single call, as the buffer at `index`, and
+  /// makes them resident for the rest of the encoder if they aren't yet
+  void bindArgumentBuffer(size_t index, uint8_t target, const ArgumentBuffer& argumentBuffer);
+
+  /// Executes `count` commands of `commandBuffer` starting at `start`, with the pipeline state and
+  /// buffers currently bound
+  void executeIndirectCommands(const IndirectCommandBuffer& commandBuffer,
+                               size_t start,
+                               size_t count);
+  /// Same, with the range of commands read on the GPU from `rangeBuffer` at `rangeBufferOffset`
+  /// as a MTLIndirectCommandBufferExecutionRange, e.g. written by the compute pass which encoded
+  /// the commands. Requires iOS 13 or macOS 10.14
+  void executeIndirectCommands(const IndirectCommandBuffer& commandBuffer,
+                               IBuffer& rangeBuffer,
+                               size_t rangeBufferOffset);
+
   void draw(PrimitiveType primitiveType, size_t vertexStart, size_t vertexCount) override;
   void drawIndexed(PrimitiveType primitiveType,
                    size_t indexCount,
                    IndexFormat indexFormat,
                    IBuffer& indexBuffer,
                    size_t indexBufferOffset) override;
+  void drawInstanced(PrimitiveType primitiveType,
+                     size_t vertexStart,
+                     size_t vertexCount,
+                     uint32_t instanceCount) override;
+  void drawIndexedInstanced(PrimitiveType primitiveType,
+                            size_t indexCount,
+                            IndexFormat indexFormat,
+                            IBuffer& indexBuffer,
+                            size_t indexBufferOffset,
+                            uint32_t instanceCount) override;
   void drawIndexedIndirect(PrimitiveType primitiveType,
                            IndexFormat indexFormat,
                            IBuffer& indexBuffer,
@@ -75,17 +111,33 @@ class RenderCommandEncoder final : public IRenderCommandEncoder {
                                 size_t indirectBufferOffset,
                                 uint32_t drawCount,
                                 uint32_t stride) override;
+  void multiDrawIndexedIndirectCount(PrimitiveType primitiveType,
+                                     IndexFormat indexFormat,
+                                     IBuffer& indexBuffer,
+                                     IBuffer& indirectBuffer,
+                                     size_t indirectBufferOffset,
+                                     IBuffer& countBuffer,
+                                     size_t countBufferOffset,
+                                     uint32_t maxDrawCount,
+                                     uint32_t stride) override;
 
   void setStencilReferenceValue(uint32_t value) override;
   void setStencilReferenceValues(uint32_t frontValue, uint32_t backValue) override;
   void setBlendColor(Color color) override;
   void setDepthBias(float depthBias, float slopeScale, float clamp) override;
 
+  void beginOcclusionQuery(uint32_t query) override;
+  void endOcclusionQuery() override;
+
   static MTLPrimitiveType convertPrimitiveType(PrimitiveType value);
   static MTLIndexType convertIndexType(IndexFormat value);
   static MTLLoadAction convertLoadAction(LoadAction value);
   static MTLStoreAction convertStoreAction(StoreAction value);
   static MTLClearColor convertClearColor(Color value);
+  static MTLRenderPassDescriptor* createRenderPassDescriptor(
+      const RenderPassDesc& renderPass,
+      const std::shared_ptr<IFramebuffer>& framebuffer,
+      Result* outResult);
 
  private:
   explicit RenderCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer);
@@ -97,8 +149,22 @@ class RenderCommandEncoder final : public IRenderCommandEncoder {
   void bindCullMode(const CullMode& cullMode);
   void bindFrontFacingWinding(const WindingMode& frontFaceWinding);
   void bindPolygonFillMode(const PolygonFillMode& polygonFillMode);
+  void useResource(id<MTLResource> resource, MTLResourceUsage usage, uint8_t target);
+  // passes the push constants to both stages if they changed since the previous draw
+  void flushPushConstants();
 
   id<MTLRenderCommandEncoder> encoder_ = nil;
+  id<MTLDepthStencilState> currentDepthStencilState_ = nil;
+  std::shared_ptr<QueryPool> occlusionQueryPool_;
+  bool isOcclusionQueryActive_ = false;
+
+  struct Residency {
+    MTLResourceUsage usage = 0;
+    uint8_t target = 0;
+  };
+  // resources and heaps made resident with useResource/useHeap during this encoder
+  std::unordered_map<const void*, Residency> residentResources_;
+  PushConstantBlock pushConstants_;
   // 4 KB - page aligned memory for metal managed resource
   static constexpr uint32_t MAX_RECOMMENDED_BYTES = 4 * 1024;
 };
@@ -10,12 +10,16 @@
 #import <Foundation/Foundation.h>
 #import <Metal/Metal.h>
 #include <igl/RenderPass.h>
+#include <igl/metal/ArgumentBuffer.h>
 #include <igl/metal/Buffer.h>
 #include <igl/metal/DepthStencilState.h>
 #include <igl/metal/Framebuffer.h>
+#include <igl/metal/IndirectCommandBuffer.h>
+#include <igl/metal/QueryPool.h>
 #include <igl/metal/RenderPipelineState.h>
 #include <igl/metal/SamplerState.h>
 #include <igl/metal/Texture.h>
+#include <igl/metal/UploadArena.h>
 
 namespace igl {
 namespace metal {
@@ -23,19 +27,42 @@ namespace metal {
 RenderCommandEncoder::RenderCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer) :
   IRenderCommandEncoder::IRenderCommandEncoder(commandBuffer) {}
 
-void RenderCommandEncoder::initialize(const std::shared_ptr<CommandBuffer>& commandBuffer,
-                                      const RenderPassDesc& renderPass,
-                                      const std::shared_ptr<IFramebuffer>& framebuffer,
-                                      Result* outResult) {
+namespace {
+
+template<typename T>
+uint32_t packAttachmentConfig(const T& attachment) {
+  return static_cast<uint32_t>(attachment.loadAction) |
+         (static_cast<uint32_t>(attachment.storeAction) << 8) |
+         (static_cast<uint32_t>(attachment.layer) << 16) |
+         (static_cast<uint32_t>(attachment.mipmapLevel) << 24);
+}
+
+id<MTLTexture> getMTLTexture(const std::shared_ptr<ITexture>& texture) {
+  return texture ? static_cast<Texture&>(*texture).get() : nil;
+}
+
+} // namespace
+
+// Descriptors are cached by the framebuffer per load and store configuration: passes reusing one
+// only write the textures, which change with the drawable, the clear values and the resources of
+// the pass, and allocate no Objective-C objects. Metal copies the descriptor when creating the
+// encoder, so it can be modified again right after; as the framebuffer itself, it must not be
+// used to begin render passes from several threads at once.
+MTLRenderPassDescriptor* RenderCommandEncoder::createRenderPassDescriptor(
+    const RenderPassDesc& renderPass,
+    const std::shared_ptr<IFramebuffer>& framebuffer,
+    Result* outResult) {
   Result::setOk(outResult);
   if (!IGL_VERIFY(framebuffer)) {
     Result::setResult(outResult, Result::Code::ArgumentNull);
-    return;
+    return nil;
   }
-  MTLRenderPassDescriptor* metalRenderPassDesc = [MTLRenderPassDescriptor renderPassDescriptor];
-  const FramebufferDesc& desc = static_cast<const Framebuffer&>(*framebuffer).get();
+  auto& metalFramebuffer = static_cast<Framebuffer&>(*framebuffer);
+  const FramebufferDesc& desc = metalFramebuffer.get();
 
   // Colors
+  size_t numColorAttachments = 0;
+  Framebuffer::RenderPassConfig config{};
   for (const auto& attachment : desc.colorAttachments) {
     size_t index = attachment.first;
 
@@ -48,66 +75,105 @@ void RenderCommandEncoder::initialize(const std::shared_ptr<CommandBuffer>& comm
       break;
     }
 
-    auto& iglTexture = attachment.second.texture;
-    MTLRenderPassColorAttachmentDescriptor* metalColorAttachment =
-        metalRenderPassDesc.colorAttachments[index];
-
     static const char* kNullColorAttachmentMsg = "Render pass color attachment cannot be null";
-    IGL_ASSERT_MSG(iglTexture, kNullColorAttachmentMsg);
-    if (iglTexture) {
-      metalColorAttachment.texture = static_cast<Texture&>(*iglTexture).get();
-    } else {
+    IGL_ASSERT_MSG(attachment.second.texture, kNullColorAttachmentMsg);
+    if (!attachment.second.texture) {
       Result::setResult(outResult, Result::Code::ArgumentNull, kNullColorAttachmentMsg);
     }
 
-    auto& iglResolveTexture = attachment.second.resolveTexture;
-    if (iglResolveTexture &&
-        renderPass.colorAttachments[index].storeAction == igl::StoreAction::MsaaResolve) {
-      metalColorAttachment.resolveTexture = static_cast<Texture&>(*iglResolveTexture).get();
-    }
+    config[index] = packAttachmentConfig(renderPass.colorAttachments[index]);
+    numColorAttachments++;
+  }
+  config[IGL_COLOR_ATTACHMENTS_MAX] = packAttachmentConfig(renderPass.depthAttachment);
+  config[IGL_COLOR_ATTACHMENTS_MAX + 1] = packAttachmentConfig(renderPass.stencilAttachment);
+
+  MTLRenderPassDescriptor* metalRenderPassDesc = metalFramebuffer.findRenderPassDescriptor(config);
+  const bool isCached = metalRenderPassDesc != nil;
+  if (!isCached) {
+    metalRenderPassDesc = [MTLRenderPassDescriptor renderPassDescriptor];
+    metalFramebuffer.cacheRenderPassDescriptor(config, metalRenderPassDesc);
+  }
 
-    auto& iglColorAttachment = renderPass.colorAttachments[index];
-    metalColorAttachment.loadAction = convertLoadAction(iglColorAttachment.loadAction);
-    metalColorAttachment.storeAction = convertStoreAction(iglColorAttachment.storeAction);
+  auto colorAttachment = desc.colorAttachments.begin();
+  for (size_t i = 0; i != numColorAttachments; i++, colorAttachment++) {
+    const size_t index = colorAttachment->first;
+    const auto& iglColorAttachment = renderPass.colorAttachments[index];
+    MTLRenderPassColorAttachmentDescriptor* metalColorAttachment =
+        metalRenderPassDesc.colorAttachments[index];
+
+    if (!isCached) {
+      metalColorAttachment.loadAction = convertLoadAction(iglColorAttachment.loadAction);
+      metalColorAttachment.storeAction = convertStoreAction(iglColorAttachment.storeAction);
+      metalColorAttachment.slice = iglColorAttachment.layer;
+      metalColorAttachment.level = iglColorAttachment.mipmapLevel;
+    }
+    metalColorAttachment.texture = getMTLTexture(colorAttachment->second.texture);
+    if (iglColorAttachment.storeAction == igl::StoreAction::MsaaResolve) {
+      metalColorAttachment.resolveTexture = getMTLTexture(colorAttachment->second.resolveTexture);
+    }
     metalColorAttachment.clearColor = convertClearColor(iglColorAttachment.clearColor);
-    metalColorAttachment.slice = iglColorAttachment.layer;
-    metalColorAttachment.level = iglColorAttachment.mipmapLevel;
   }
 
   // Depth
   if (desc.depthAttachment.texture) {
-    metalRenderPassDesc.depthAttachment.texture =
-        static_cast<Texture&>(*desc.depthAttachment.texture).get();
-    metalRenderPassDesc.depthAttachment.loadAction =
-        convertLoadAction(renderPass.depthAttachment.loadAction);
-    metalRenderPassDesc.depthAttachment.storeAction =
-        convertStoreAction(renderPass.depthAttachment.storeAction);
-    metalRenderPassDesc.depthAttachment.clearDepth = renderPass.depthAttachment.clearDepth;
-
-    if (desc.depthAttachment.resolveTexture &&
-        renderPass.depthAttachment.storeAction == igl::StoreAction::MsaaResolve) {
-      metalRenderPassDesc.depthAttachment.resolveTexture =
-          static_cast<Texture&>(*desc.depthAttachment.resolveTexture).get();
+    MTLRenderPassDepthAttachmentDescriptor* depthAttachment = metalRenderPassDesc.depthAttachment;
+    if (!isCached) {
+      depthAttachment.loadAction = convertLoadAction(renderPass.depthAttachment.loadAction);
+      depthAttachment.storeAction = convertStoreAction(renderPass.depthAttachment.storeAction);
+    }
+    depthAttachment.texture = getMTLTexture(desc.depthAttachment.texture);
+    if (renderPass.depthAttachment.storeAction == igl::StoreAction::MsaaResolve) {
+      depthAttachment.resolveTexture = getMTLTexture(desc.depthAttachment.resolveTexture);
     }
+    depthAttachment.clearDepth = renderPass.depthAttachment.clearDepth;
   }
 
   // Stencil
   if (desc.stencilAttachment.texture) {
-    metalRenderPassDesc.stencilAttachment.texture =
-        static_cast<Texture&>(*desc.stencilAttachment.texture).get();
-    metalRenderPassDesc.stencilAttachment.loadAction =
-        convertLoadAction(renderPass.stencilAttachment.loadAction);
-    metalRenderPassDesc.stencilAttachment.storeAction =
-        convertStoreAction(renderPass.stencilAttachment.storeAction);
-    metalRenderPassDesc.stencilAttachment.clearStencil = renderPass.stencilAttachment.clearStencil;
-
-    if (desc.stencilAttachment.resolveTexture &&
-        renderPass.stencilAttachment.storeAction == igl::StoreAction::MsaaResolve) {
-      metalRenderPassDesc.stencilAttachment.resolveTexture =
-          static_cast<Texture&>(*desc.stencilAttachment.resolveTexture).get();
+    MTLRenderPassStencilAttachmentDescriptor* stencilAttachment =
+        metalRenderPassDesc.stencilAttachment;
+    if (!isCached) {
+      stencilAttachment.loadAction = convertLoadAction(renderPass.stencilAttachment.loadAction);
+      stencilAttachment.storeAction = convertStoreAction(renderPass.stencilAttachment.storeAction);
     }
+    stencilAttachment.texture = getMTLTexture(desc.stencilAttachment.texture);
+    if (renderPass.stencilAttachment.storeAction == igl::StoreAction::MsaaResolve) {
+      stencilAttachment.resolveTexture = getMTLTexture(desc.stencilAttachment.resolveTexture);
+    }
+    stencilAttachment.clearStencil = renderPass.stencilAttachment.clearStencil;
+  }
+
+  // resources of the previous pass using this descriptor
+  metalRenderPassDesc.visibilityResultBuffer = nil;
+  if (@available(macOS 11.0, iOS 14.0, *)) {
+    metalRenderPassDesc.sampleBufferAttachments[0].sampleBuffer = nil;
   }
 
+  return metalRenderPassDesc;
+}
+
+void RenderCommandEncoder::initialize(const std::shared_ptr<CommandBuffer>& commandBuffer,
+                                      const RenderPassDesc& renderPass,
+                                      const std::shared_ptr<IFramebuffer>& framebuffer,
+                                      Result* outResult) {
+  MTLRenderPassDescriptor* metalRenderPassDesc =
+      createRenderPassDescriptor(renderPass, framebuffer, outResult);
+  if (!metalRenderPassDesc) {
+    return;
+  }
+
+  if (renderPass.occlusionQueryPool) {
+    occlusionQueryPool_ = std::static_pointer_cast<QueryPool>(renderPass.occlusionQueryPool);
+    occlusionQueryPool_->reset();
+    metalRenderPassDesc.visibilityResultBuffer = occlusionQueryPool_->get();
+
+    std::shared_ptr<QueryPool> pool = occlusionQueryPool_;
+    [commandBuffer->get() addCompletedHandler:^(id<MTLCommandBuffer> /*commandBuffer*/) {
+      pool->onCompleted();
+    }];
+  }
+
+  commandBuffer->sampleEncoderTimestamps(metalRenderPassDesc);
   encoder_ = [commandBuffer->get() renderCommandEncoderWithDescriptor:metalRenderPassDesc];
 }
 
@@ -121,11 +187,22 @@ std::unique_ptr<RenderCommandEncoder> RenderCommandEncoder::create(
   return encoder;
 }
 
+std::unique_ptr<RenderCommandEncoder> RenderCommandEncoder::create(
+    const std::shared_ptr<CommandBuffer>& commandBuffer,
+    id<MTLRenderCommandEncoder> encoder) {
+  IGL_ASSERT(encoder);
+  std::unique_ptr<RenderCommandEncoder> renderEncoder(new RenderCommandEncoder(commandBuffer));
+  renderEncoder->encoder_ = encoder;
+  return renderEncoder;
+}
+
 void RenderCommandEncoder::endEncoding() {
+  IGL_ASSERT_MSG(!isOcclusionQueryActive_, "Did you forget to call endOcclusionQuery()?");
   // @fb-only
   // @fb-only
   [encoder_ endEncoding];
   encoder_ = nil;
+  residentResources_.clear();
 }
 
 void RenderCommandEncoder::pushDebugGroupLabel(const std::string& label,
@@ -209,6 +286,7 @@ void RenderCommandEncoder::bindRenderPipelineState(
   auto& metalPipelineState = static_cast<RenderPipelineState&>(*pipelineState);
 
   [encoder_ setRenderPipelineState:metalPipelineState.get()];
+  getCommandBuffer().incrementStatistic(CommandBufferCounter::PipelineBinds);
 
   bindCullMode(metalPipelineState.getCullMode());
   bindFrontFacingWinding(metalPipelineState.getWindingMode());
@@ -219,7 +297,12 @@ void RenderCommandEncoder::bindDepthStencilState(
     const std::shared_ptr<IDepthStencilState>& depthStencilState) {
   IGL_ASSERT(encoder_);
   if (depthStencilState) {
-    [encoder_ setDepthStencilState:static_cast<DepthStencilState&>(*depthStencilState).get()];
+    id<MTLDepthStencilState> metalState = static_cast<DepthStencilState&>(*depthStencilState).get();
+    // the device returns the same object for equal descriptors
+    if (metalState != currentDepthStencilState_) {
+      [encoder_ setDepthStencilState:metalState];
+      currentDepthStencilState_ = metalState;
+    }
   }
 }
 
@@ -232,6 +315,33 @@ void RenderCommandEncoder::setDepthBias(float depthBias, float slopeScale, float
   [encoder_ setDepthBias:depthBias slopeScale:slopeScale clamp:clamp];
 }
 
+void RenderCommandEncoder::beginOcclusionQuery(uint32_t query) {
+  IGL_ASSERT(encoder_);
+  IGL_ASSERT_MSG(occlusionQueryPool_, "RenderPassDesc::occlusionQueryPool is not set");
+  IGL_ASSERT_MSG(!isOcclusionQueryActive_, "Occlusion queries cannot be nested");
+  IGL_ASSERT(!occlusionQueryPool_ || query < occlusionQueryPool_->getQueryCount());
+
+  if (!occlusionQueryPool_ || isOcclusionQueryActive_) {
+    return;
+  }
+
+  [encoder_ setVisibilityResultMode:MTLVisibilityResultModeBoolean
+                             offset:query * sizeof(uint64_t)];
+  isOcclusionQueryActive_ = true;
+}
+
+void RenderCommandEncoder::endOcclusionQuery() {
+  IGL_ASSERT(encoder_);
+  IGL_ASSERT(isOcclusionQueryActive_);
+
+  if (!isOcclusionQueryActive_) {
+    return;
+  }
+
+  [encoder_ setVisibilityResultMode:MTLVisibilityResultModeDisabled offset:0];
+  isOcclusionQueryActive_ = false;
+}
+
 void RenderCommandEncoder::setStencilReferenceValue(uint32_t value) {
   IGL_ASSERT(encoder_);
   [encoder_ setStencilReferenceValue:value];
@@ -272,7 +382,23 @@ void RenderCommandEncoder::bindBytes(size_t index,
                  "Bind target is not valid: %d",
                  bindTarget);
   if (data) {
+    getCommandBuffer().incrementStatistic(CommandBufferCounter::BindingUpdates);
+    getCommandBuffer().incrementStatistic(CommandBufferCounter::UploadedBytes, length);
     if (length > MAX_RECOMMENDED_BYTES) {
+      // Metal copies inline bytes into the command buffer, which is only meant for small data
+      const auto& uploadArena = static_cast<CommandBuffer&>(getCommandBuffer()).getUploadArena();
+      if (uploadArena) {
+        const auto allocation = uploadArena->allocate(data, length);
+        if (allocation.buffer != nil) {
+          if ((bindTarget & BindTarget::kVertex) != 0) {
+            [encoder_ setVertexBuffer:allocation.buffer offset:allocation.offset atIndex:index];
+          }
+          if ((bindTarget & BindTarget::kFragment) != 0) {
+            [encoder_ setFragmentBuffer:allocation.buffer offset:allocation.offset atIndex:index];
+          }
+          return;
+        }
+      }
       IGL_LOG_INFO(
           "It is recommended to use bindBuffer instead of bindBytes when binding > 4kb: %u",
           length);
@@ -286,10 +412,21 @@ void RenderCommandEncoder::bindBytes(size_t index,
   }
 }
 
-void RenderCommandEncoder::bindPushConstants(size_t /*offset*/,
-                                             const void* /*data*/,
-                                             size_t /*length*/) {
-  IGL_ASSERT_NOT_IMPLEMENTED();
+void RenderCommandEncoder::bindPushConstants(size_t offset, const void* data, size_t length) {
+  IGL_ASSERT(encoder_);
+  getCommandBuffer().incrementStatistic(CommandBufferCounter::BindingUpdates);
+  getCommandBuffer().incrementStatistic(CommandBufferCounter::UploadedBytes, length);
+  pushConstants_.set(offset, data, length);
+}
+
+void RenderCommandEncoder::flushPushConstants() {
+  if (!pushConstants_.isDirty()) {
+    return;
+  }
+  size_t length = 0;
+  const void* bytes = pushConstants_.getDirtyBytes(length);
+  [encoder_ setVertexBytes:bytes length:length atIndex:PushConstantBlock::kBufferIndex];
+  [encoder_ setFragmentBytes:bytes length:length atIndex:PushConstantBlock::kBufferIndex];
 }
 
 void RenderCommandEncoder::bindTexture(size_t index, uint8_t bindTarget, ITexture* texture) {
@@ -310,6 +447,107 @@ void RenderCommandEncoder::bindTexture(size_t index, uint8_t bindTarget, ITextur
   }
 }
 
+void RenderCommandEncoder::bindArgumentBuffer(size_t index,
+                                              uint8_t bindTarget,
+                                              const ArgumentBuffer& argumentBuffer) {
+  IGL_ASSERT(encoder_);
+  IGL_ASSERT_MSG(bindTarget == BindTarget::kVertex || bindTarget == BindTarget::kFragment ||
+                     bindTarget == BindTarget::kAllGraphics,
+                 "Bind target is not valid: %d",
+                 bindTarget);
+
+  // resources which are only referenced by an argument buffer are not made resident by Metal.
+  // Written resources still go through useResource() so Metal tracks their hazards
+  id residencySet = argumentBuffer.getReadOnlyResidencySet();
+  for (const auto& [argumentIndex, resource] : argumentBuffer.getResources()) {
+    if (residencySet == nil || (resource.usage & MTLResourceUsageWrite) != 0) {
+      useResource(resource.resource, resource.usage, bindTarget);
+    }
+  }
+  if (residencySet != nil) {
+    static_cast<CommandBuffer&>(getCommandBuffer()).useResidencySet(residencySet);
+  }
+
+  if ((bindTarget & BindTarget::kVertex) != 0) {
+    [encoder_ setVertexBuffer:argumentBuffer.get() offset:0 atIndex:index];
+  }
+  if ((bindTarget & BindTarget::kFragment) != 0) {
+    [encoder_ setFragmentBuffer:argumentBuffer.get() offset:0 atIndex:index];
+  }
+}
+
+void RenderCommandEncoder::executeIndirectCommands(const IndirectCommandBuffer& commandBuffer,
+                                                   size_t start,
+                                                   size_t count) {
+  IGL_ASSERT(encoder_);
+  if (!IGL_VERIFY(start + count <= commandBuffer.getMaxCommandCount())) {
+    return;
+  }
+  if (@available(macOS 10.14, iOS 12.0, *)) {
+    getCommandBuffer().incrementCurrentDrawCount();
+    // indirect command buffers which inherit buffers read the push constants of the encoder
+    flushPushConstants();
+    for (id<MTLResource> resource : commandBuffer.getResources()) {
+      useResource(resource, MTLResourceUsageRead, BindTarget::kVertex);
+    }
+    [encoder_ executeCommandsInBuffer:commandBuffer.get() withRange:NSMakeRange(start, count)];
+  }
+}
+
+void RenderCommandEncoder::executeIndirectCommands(const IndirectCommandBuffer& commandBuffer,
+                                                   IBuffer& rangeBuffer,
+                                                   size_t rangeBufferOffset) {
+  IGL_ASSERT(encoder_);
+  if (@available(macOS 10.14, iOS 13.0, *)) {
+    getCommandBuffer().incrementCurrentDrawCount();
+    // indirect command buffers which inherit buffers read the push constants of the encoder
+    flushPushConstants();
+    for (id<MTLResource> resource : commandBuffer.getResources()) {
+      useResource(resource, MTLResourceUsageRead, BindTarget::kVertex);
+    }
+    [encoder_ executeCommandsInBuffer:commandBuffer.get()
+                       indirectBuffer:static_cast<Buffer&>(rangeBuffer).get()
+                 indirectBufferOffset:rangeBufferOffset];
+  } else {
+    IGL_ASSERT_NOT_IMPLEMENTED();
+  }
+}
+
+void RenderCommandEncoder::useResource(id<MTLResource> resource,
+                                       MTLResourceUsage usage,
+                                       uint8_t bindTarget) {
+  if (@available(macOS 10.15, iOS 13.0, *)) {
+    // a heap makes all its resources resident with a single call, but only for reading
+    id<MTLHeap> heap = (usage & MTLResourceUsageWrite) == 0 ? resource.heap : nil;
+    const void* key = heap != nil ? (__bridge const void*)heap : (__bridge const void*)resource;
+    auto& residency = residentResources_[key];
+    if ((residency.usage & usage) == usage && (residency.target & bindTarget) == bindTarget) {
+      return;
+    }
+    residency.usage |= usage;
+    residency.target |= bindTarget;
+
+    MTLRenderStages stages = 0;
+    if ((residency.target & BindTarget::kVertex) != 0) {
+      stages |= MTLRenderStageVertex;
+    }
+    if ((residency.target & BindTarget::kFragment) != 0) {
+      stages |= MTLRenderStageFragment;
+    }
+    if (heap != nil) {
+      [encoder_ useHeap:heap stages:stages];
+    } else {
+      [encoder_ useResource:resource usage:residency.usage stages:stages];
+    }
+  } else {
+    auto& residency = residentResources_[(__bridge const void*)resource];
+    if ((residency.usage & usage) != usage) {
+      residency.usage |= usage;
+      [encoder_ useResource:resource usage:residency.usage];
+    }
+  }
+}
+
 void RenderCommandEncoder::bindUniform(const UniformDesc& /*uniformDesc*/, const void* /*data*/) {
   // DO NOT IMPLEMENT!
   // This is only for backends that MUST use single uniforms in some situations.
@@ -338,10 +576,24 @@ void RenderCommandEncoder::bindSamplerState(size_t index,
 void RenderCommandEncoder::draw(PrimitiveType primitiveType,
                                 size_t vertexStart,
                                 size_t vertexCount) {
+  drawInstanced(primitiveType, vertexStart, vertexCount, 1);
+}
+
+void RenderCommandEncoder::drawInstanced(PrimitiveType primitiveType,
+                                         size_t vertexStart,
+                                         size_t vertexCount,
+                                         uint32_t instanceCount) {
+  if (instanceCount == 0) {
+    return;
+  }
   getCommandBuffer().incrementCurrentDrawCount();
   IGL_ASSERT(encoder_);
+  flushPushConstants();
   MTLPrimitiveType metalPrimitive = convertPrimitiveType(primitiveType);
-  [encoder_ drawPrimitives:metalPrimitive vertexStart:vertexStart vertexCount:vertexCount];
+  [encoder_ drawPrimitives:metalPrimitive
+               vertexStart:vertexStart
+               vertexCount:vertexCount
+             instanceCount:instanceCount];
 }
 
 void RenderCommandEncoder::drawIndexed(PrimitiveType primitiveType,
@@ -349,8 +601,21 @@ void RenderCommandEncoder::drawIndexed(PrimitiveType primitiveType,
                                        IndexFormat indexFormat,
                                        IBuffer& indexBuffer,
                                        size_t indexBufferOffset) {
+  drawIndexedInstanced(primitiveType, indexCount, indexFormat, indexBuffer, indexBufferOffset, 1);
+}
+
+void RenderCommandEncoder::drawIndexedInstanced(PrimitiveType primitiveType,
+                                                size_t indexCount,
+                                                IndexFormat indexFormat,
+                                                IBuffer& indexBuffer,
+                                                size_t indexBufferOffset,
+                                                uint32_t instanceCount) {
+  if (instanceCount == 0) {
+    return;
+  }
   getCommandBuffer().incrementCurrentDrawCount();
   IGL_ASSERT(encoder_);
+  flushPushConstants();
   auto& buffer = (Buffer&)(indexBuffer);
   MTLPrimitiveType metalPrimitive = convertPrimitiveType(primitiveType);
   MTLIndexType indexType = convertIndexType(indexFormat);
@@ -359,7 +624,8 @@ void RenderCommandEncoder::drawIndexed(PrimitiveType primitiveType,
                        indexCount:indexCount
                         indexType:indexType
                       indexBuffer:buffer.get()
-                indexBufferOffset:indexBufferOffset];
+                indexBufferOffset:indexBufferOffset
+                    instanceCount:instanceCount];
 }
 
 void RenderCommandEncoder::drawIndexedIndirect(PrimitiveType primitiveType,
@@ -369,6 +635,7 @@ void RenderCommandEncoder::drawIndexedIndirect(PrimitiveType primitiveType,
                                                size_t indirectBufferOffset) {
   getCommandBuffer().incrementCurrentDrawCount();
   IGL_ASSERT(encoder_);
+  flushPushConstants();
   auto& indexBufferRef = (Buffer&)(indexBuffer);
   auto& indirectBufferRef = (Buffer&)(indirectBuffer);
   MTLPrimitiveType metalPrimitive = convertPrimitiveType(primitiveType);
@@ -390,6 +657,7 @@ void RenderCommandEncoder::multiDrawIndirect(PrimitiveType primitiveType,
                                              uint32_t drawCount,
                                              uint32_t stride) {
   IGL_ASSERT(encoder_);
+  flushPushConstants();
   stride = stride ? stride : sizeof(MTLDrawPrimitivesIndirectArguments);
   auto& indirectBufferRef = (Buffer&)(indirectBuffer);
   MTLPrimitiveType metalPrimitive = convertPrimitiveType(primitiveType);
@@ -414,6 +682,7 @@ void RenderCommandEncoder::multiDrawIndexedIndirect(PrimitiveType primitiveType,
                                                     uint32_t drawCount,
                                                     uint32_t stride) {
   IGL_ASSERT(encoder_);
+  flushPushConstants();
   stride = stride ? stride : sizeof(MTLDrawIndexedPrimitivesIndirectArguments);
   auto& indexBufferRef = (Buffer&)(indexBuffer);
   auto& indirectBufferRef = (Buffer&)(indirectBuffer);
@@ -431,6 +700,19 @@ void RenderCommandEncoder::multiDrawIndexedIndirect(PrimitiveType primitiveType,
   }
 }
 
+void RenderCommandEncoder::multiDrawIndexedIndirectCount(PrimitiveType /*primitiveType*/,
+                                                         IndexFormat /*indexFormat*/,
+                                                         IBuffer& /*indexBuffer*/,
+                                                         IBuffer& /*indirectBuffer*/,
+                                                         size_t /*indirectBufferOffset*/,
+                                                         IBuffer& /*countBuffer*/,
+                                                         size_t /*countBufferOffset*/,
+                                                         uint32_t /*maxDrawCount*/,
+                                                         uint32_t /*stride*/) {
+  // needs indirect command buffers encoded by a compute pass
+  IGL_ASSERT_NOT_IMPLEMENTED();
+}
+
 MTLPrimitiveType RenderCommandEncoder::convertPrimitiveType(PrimitiveType value) {
   switch (value) {
   case PrimitiveType::Point:
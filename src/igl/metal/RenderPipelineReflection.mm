@@ -42,6 +42,14 @@ igl::UniformType metalDataTypeToIGLUniformType(MTLDataType type) {
     return igl::UniformType::Mat3x3;
   case MTLDataTypeFloat4x4:
     return igl::UniformType::Mat4x4;
+  case MTLDataTypeHalf:
+    return igl::UniformType::Float16;
+  case MTLDataTypeHalf2:
+    return igl::UniformType::Float16x2;
+  case MTLDataTypeHalf3:
+    return igl::UniformType::Float16x3;
+  case MTLDataTypeHalf4:
+    return igl::UniformType::Float16x4;
   default:
     IGL_LOG_ERROR("Unsupported MTLDataType: %ld\n", type);
     return igl::UniformType::Invalid;
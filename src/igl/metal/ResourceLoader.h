@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#import <Metal/Metal.h>
+#include <functional>
+#include <igl/Buffer.h>
+#include <igl/Texture.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace igl {
+namespace metal {
+
+/// How an asset file was compressed, e.g. with MTLIOCreateCompressionContext()
+enum class IOCompression : uint8_t { None, Zlib, LZFSE, LZ4, LZMA, LZBitmap };
+
+/**
+ * @brief Loads the contents of asset files straight into buffers and textures. With Metal 3
+ * (macOS 13, iOS 16) the loads go through a MTLIOCommandQueue, which reads and decompresses the
+ * files without a CPU staging copy. Elsewhere, uncompressed files are read on the CPU and uploaded
+ * with IBuffer::upload() and ITexture::upload(), and compressed ones are not supported.
+ *
+ * Loads are queued until commit(), and the resources must not be used by the GPU before the
+ * completion of their loads. Not thread-safe.
+ */
+class ResourceLoader final {
+ public:
+  explicit ResourceLoader(id<MTLDevice> device);
+
+  /// True if the loads go through a MTLIOCommandQueue
+  [[nodiscard]] bool isDirect() const {
+    return ioQueue_ != nil;
+  }
+
+  /// Loads `range.size` bytes at `fileOffset` in the file at `path` into `buffer` at
+  /// `range.offset`
+  Result loadBuffer(IBuffer& buffer,
+                    const BufferRange& range,
+                    const std::string& path,
+                    size_t fileOffset = 0,
+                    IOCompression compression = IOCompression::None);
+
+  /// Loads the texels of `range`, a single mip level, from the file at `path`. The texels start at
+  /// `fileOffset` and are laid out as ITexture::upload() expects them, with rows of `bytesPerRow`
+  Result loadTexture(ITexture& texture,
+                     const TextureRangeDesc& range,
+                     size_t bytesPerRow,
+                     const std::string& path,
+                     size_t fileOffset = 0,
+                     IOCompression compression = IOCompression::None);
+
+  /// Submits the loads queued since the last commit. `completion` is called from an arbitrary
+  /// thread once they have landed in the resources, or right away if the loads were done on the
+  /// CPU.
+  void commit(std::function<void(Result)> completion = nullptr);
+
+  /// Waits for the loads of the last commit
+  void waitUntilCompleted();
+
+ private:
+  // returns the MTLIOFileHandle of `path`, opened once
+  id getFileHandle(const std::string& path, IOCompression compression, Result* outResult);
+  static Result readFile(const std::string& path,
+                         size_t fileOffset,
+                         size_t length,
+                         std::vector<uint8_t>& outData);
+
+  id<MTLDevice> device_;
+  // MTLIOCommandQueue, nil before Metal 3
+  id ioQueue_ = nil;
+  // MTLIOCommandBuffer of the loads queued since the last commit
+  id pendingCommandBuffer_ = nil;
+  id lastCommittedCommandBuffer_ = nil;
+  std::unordered_map<std::string, id> fileHandles_;
+};
+
+} // namespace metal
+} // namespace igl
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/ResourceLoader.h>
+
+#include <fstream>
+#include <igl/metal/Buffer.h>
+#include <igl/metal/Result.h>
+#include <igl/metal/Texture.h>
+
+namespace igl {
+namespace metal {
+
+namespace {
+
+API_AVAILABLE(macos(13.0), ios(16.0))
+MTLIOCompressionMethod toMTLIOCompressionMethod(IOCompression compression) {
+  switch (compression) {
+  case IOCompression::None:
+  case IOCompression::Zlib:
+    return MTLIOCompressionMethodZlib;
+  case IOCompression::LZFSE:
+    return MTLIOCompressionMethodLZFSE;
+  case IOCompression::LZ4:
+    return MTLIOCompressionMethodLZ4;
+  case IOCompression::LZMA:
+    return MTLIOCompressionMethodLZMA;
+  case IOCompression::LZBitmap:
+    return MTLIOCompressionMethodLZBitmap;
+  }
+}
+
+} // namespace
+
+ResourceLoader::ResourceLoader(id<MTLDevice> device) : device_(device) {
+  if (@available(macOS 13.0, iOS 16.0, *)) {
+    MTLIOCommandQueueDescriptor* desc = [MTLIOCommandQueueDescriptor new];
+    desc.type = MTLIOCommandQueueTypeConcurrent;
+    desc.priority = MTLIOPriorityNormal;
+    NSError* error = nil;
+    ioQueue_ = [device_ newIOCommandQueueWithDescriptor:desc error:&error];
+  }
+}
+
+id ResourceLoader::getFileHandle(const std::string& path,
+                                 IOCompression compression,
+                                 Result* outResult) {
+  auto it = fileHandles_.find(path);
+  if (it != fileHandles_.end()) {
+    Result::setOk(outResult);
+    return it->second;
+  }
+
+  id handle = nil;
+  if (@available(macOS 13.0, iOS 16.0, *)) {
+    NSURL* url = [NSURL fileURLWithPath:[NSString stringWithUTF8String:path.c_str()]];
+    NSError* error = nil;
+    if (@available(macOS 14.0, iOS 17.0, *)) {
+      handle = compression == IOCompression::None
+                   ? [device_ newIOFileHandleWithURL:url error:&error]
+                   : [device_ newIOFileHandleWithURL:url
+                                   compressionMethod:toMTLIOCompressionMethod(compression)
+                                               error:&error];
+    } else {
+      handle = compression == IOCompression::None
+                   ? [device_ newIOHandleWithURL:url error:&error]
+                   : [device_ newIOHandleWithURL:url
+                               compressionMethod:toMTLIOCompressionMethod(compression)
+                                           error:&error];
+    }
+    if (handle == nil) {
+      setResultFrom(outResult, error);
+      return nil;
+    }
+  }
+  fileHandles_[path] = handle;
+  Result::setOk(outResult);
+  return handle;
+}
+
+Result ResourceLoader::readFile(const std::string& path,
+                                size_t fileOffset,
+                                size_t length,
+                                std::vector<uint8_t>& outData) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return Result(Result::Code::RuntimeError, "Cannot open file");
+  }
+  outData.resize(length);
+  file.seekg(static_cast<std::streamoff>(fileOffset));
+  file.read(reinterpret_cast<char*>(outData.data()), static_cast<std::streamsize>(length));
+  if (static_cast<size_t>(file.gcount()) != length) {
+    return Result(Result::Code::RuntimeError, "File is too short");
+  }
+  return Result();
+}
+
+Result ResourceLoader::loadBuffer(IBuffer& buffer,
+                                  const BufferRange& range,
+                                  const std::string& path,
+                                  size_t fileOffset,
+                                  IOCompression compression) {
+  if (!IGL_VERIFY(range.offset + range.size <= buffer.getSizeInBytes())) {
+    return Result(Result::Code::ArgumentOutOfRange, "Range is out of the buffer");
+  }
+
+  if (!isDirect()) {
+    if (compression != IOCompression::None) {
+      return Result(Result::Code::Unsupported, "Compressed files need a MTLIOCommandQueue");
+    }
+    std::vector<uint8_t> data;
+    Result result = readFile(path, fileOffset, range.size, data);
+    return result.isOk() ? buffer.upload(data.data(), range) : result;
+  }
+
+  Result result;
+  id handle = getFileHandle(path, compression, &result);
+  if (handle == nil) {
+    return result;
+  }
+  if (@available(macOS 13.0, iOS 16.0, *)) {
+    if (pendingCommandBuffer_ == nil) {
+      pendingCommandBuffer_ = [(id<MTLIOCommandQueue>)ioQueue_ commandBuffer];
+    }
+    [(id<MTLIOCommandBuffer>)pendingCommandBuffer_ loadBuffer:static_cast<Buffer&>(buffer).get()
+                                                       offset:range.offset
+                                                         size:range.size
+                                                 sourceHandle:handle
+                                           sourceHandleOffset:fileOffset];
+  }
+  return result;
+}
+
+Result ResourceLoader::loadTexture(ITexture& texture,
+                                   const TextureRangeDesc& range,
+                                   size_t bytesPerRow,
+                                   const std::string& path,
+                                   size_t fileOffset,
+                                   IOCompression compression) {
+  if (!IGL_VERIFY(range.numMipLevels == 1)) {
+    return Result(Result::Code::ArgumentInvalid, "Textures are loaded one mip level at a time");
+  }
+  if (bytesPerRow == 0) {
+    bytesPerRow = texture.getProperties().getBytesPerRow(range);
+  }
+  const size_t bytesPerImage = bytesPerRow * range.height;
+  const size_t bytesPerLayer = bytesPerImage * range.depth;
+
+  if (!isDirect()) {
+    if (compression != IOCompression::None) {
+      return Result(Result::Code::Unsupported, "Compressed files need a MTLIOCommandQueue");
+    }
+    std::vector<uint8_t> data;
+    Result result = readFile(path, fileOffset, bytesPerLayer * range.numLayers, data);
+    return result.isOk() ? texture.upload(range, data.data(), bytesPerRow) : result;
+  }
+
+  Result result;
+  id handle = getFileHandle(path, compression, &result);
+  if (handle == nil) {
+    return result;
+  }
+  if (@available(macOS 13.0, iOS 16.0, *)) {
+    if (pendingCommandBuffer_ == nil) {
+      pendingCommandBuffer_ = [(id<MTLIOCommandQueue>)ioQueue_ commandBuffer];
+    }
+    for (size_t layer = 0; layer < range.numLayers; layer++) {
+      [(id<MTLIOCommandBuffer>)pendingCommandBuffer_
+                  loadTexture:static_cast<Texture&>(texture).get()
+                        slice:range.layer + layer
+                        level:range.mipLevel
+                         size:MTLSizeMake(range.width, range.height, range.depth)
+            sourceBytesPerRow:bytesPerRow
+          sourceBytesPerImage:bytesPerImage
+            destinationOrigin:MTLOriginMake(range.x, range.y, range.z)
+                 sourceHandle:handle
+           sourceHandleOffset:fileOffset + layer * bytesPerLayer];
+    }
+  }
+  return result;
+}
+
+void ResourceLoader::commit(std::function<void(Result)> completion) {
+  if (pendingCommandBuffer_ == nil) {
+    // nothing queued, or the loads were done on the CPU
+    if (completion) {
+      completion(Result());
+    }
+    return;
+  }
+  if (@available(macOS 13.0, iOS 16.0, *)) {
+    id<MTLIOCommandBuffer> commandBuffer = pendingCommandBuffer_;
+    if (completion) {
+      [commandBuffer addCompletedHandler:^(id<MTLIOCommandBuffer> buffer) {
+        Result result;
+        if (buffer.status != MTLIOStatusComplete) {
+          setResultFrom(&result, buffer.error);
+          if (result.isOk()) {
+            result = Result(Result::Code::RuntimeError, "Loads were cancelled");
+          }
+        }
+        completion(result);
+      }];
+    }
+    [commandBuffer commit];
+    lastCommittedCommandBuffer_ = commandBuffer;
+  }
+  pendingCommandBuffer_ = nil;
+}
+
+void ResourceLoader::waitUntilCompleted() {
+  if (@available(macOS 13.0, iOS 16.0, *)) {
+    [(id<MTLIOCommandBuffer>)lastCommittedCommandBuffer_ waitUntilCompleted];
+  }
+}
+
+} // namespace metal
+} // namespace igl
@@ -12,6 +12,7 @@
 #include <igl/Macros.h>
 #include <igl/Texture.h>
 #include <igl/metal/CommandQueue.h>
+#include <memory>
 
 #if IGL_PLATFORM_APPLE
 NS_ASSUME_NONNULL_BEGIN
@@ -20,6 +21,7 @@ NS_ASSUME_NONNULL_BEGIN
 namespace igl {
 namespace metal {
 class PlatformDevice;
+class TextureUploader;
 
 class Texture final : public ITexture {
   friend class Device;
@@ -40,6 +42,11 @@ class Texture final : public ITexture {
 
   Result getBytes(const TextureRangeDesc& range, void* outData, size_t bytesPerRow = 0) const;
 
+  /// Uploads into private storage are copied on the GPU. Command buffers created afterwards wait
+  /// for them, and the CPU can wait for them too.
+  [[nodiscard]] bool isUploadCompleted() const;
+  void waitForUpload() const;
+
   // Accessors
   Dimensions getDimensions() const override;
   size_t getNumLayers() const override;
@@ -70,9 +77,25 @@ class Texture final : public ITexture {
   // Given bytes per row of an input texture, return bytesPerRow value
   // accepted by Texture::upload and MTL replaceRegion.
   size_t toMetalBytesPerRow(size_t bytesPerRow) const;
+  // replaceRegion: for CPU-accessible storage, a staged blit for private storage. Slice i is read
+  // from `sliceLength` bytes at data + i * sliceStride
+  Result uploadRegion(MTLRegion region,
+                      NSUInteger mipLevel,
+                      NSUInteger firstSlice,
+                      size_t numSlices,
+                      const void* data,
+                      size_t sliceStride,
+                      size_t sliceLength,
+                      size_t bytesPerRow,
+                      size_t bytesPerImage) const;
+  // uploads TextureDesc::initialData: a single staged blit for private storage
+  Result uploadInitialData(const void* data) const;
 
   id<MTLTexture> _Nullable value_;
   id<CAMetalDrawable> _Nullable drawable_;
+  // set by Device for textures with private storage
+  std::shared_ptr<TextureUploader> uploader_;
+  mutable SubmitHandle lastUploadHandle_ = 0;
 };
 
 } // namespace metal
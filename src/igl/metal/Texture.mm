@@ -7,6 +7,7 @@
 
 #include <igl/metal/Texture.h>
 
+#include <igl/metal/TextureUploader.h>
 #include <vector>
 
 namespace {
@@ -106,6 +107,8 @@ Texture::~Texture() {
 }
 
 Result Texture::upload(const TextureRangeDesc& range, const void* data, size_t bytesPerRow) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_UPLOAD);
+
   if (range.numMipLevels > 1) {
     IGL_ASSERT_NOT_IMPLEMENTED();
     return Result(Result::Code::Unimplemented, "Can't upload more than 1 mip-level");
@@ -122,38 +125,117 @@ Result Texture::upload(const TextureRangeDesc& range, const void* data, size_t b
   }
   const auto numLayers = std::max(range.numLayers, static_cast<size_t>(1));
   const auto byteIncrement = numLayers > 1 ? getProperties().getBytesPerLayer(range.atLayer(0)) : 0;
-  for (auto i = 0; i < numLayers; ++i) {
-    MTLRegion region;
-    switch (getType()) {
-    case TextureType::TwoD:
-    case TextureType::TwoDArray:
-      region = MTLRegionMake2D(range.x, range.y, range.width, range.height);
-      [get() replaceRegion:region
-               mipmapLevel:range.mipLevel
-                     slice:range.layer + i
-                 withBytes:data
-               bytesPerRow:toMetalBytesPerRow(bytesPerRow)
-             bytesPerImage:0];
-      break;
-    case TextureType::ThreeD:
-      region = MTLRegionMake3D(range.x, range.y, range.z, range.width, range.height, range.depth);
-      [get() replaceRegion:region
-               mipmapLevel:range.mipLevel
-                     slice:0 /* 3D array textures not supported */
-                 withBytes:data
-               bytesPerRow:toMetalBytesPerRow(bytesPerRow)
-             bytesPerImage:toMetalBytesPerRow(bytesPerRow * range.height)];
-      break;
-    default:
-      IGL_ASSERT(false && "Unknown texture type");
-      break;
+  const auto rowsPerImage = getProperties().getRows(range);
+  switch (getType()) {
+  case TextureType::TwoD:
+  case TextureType::TwoDArray:
+    return uploadRegion(MTLRegionMake2D(range.x, range.y, range.width, range.height),
+                        range.mipLevel,
+                        range.layer,
+                        numLayers,
+                        data,
+                        byteIncrement,
+                        bytesPerRow * rowsPerImage,
+                        bytesPerRow,
+                        0);
+  case TextureType::ThreeD:
+    return uploadRegion(
+        MTLRegionMake3D(range.x, range.y, range.z, range.width, range.height, range.depth),
+        range.mipLevel,
+        0 /* 3D array textures not supported */,
+        1,
+        data,
+        0,
+        bytesPerRow * rowsPerImage * std::max(range.depth, static_cast<size_t>(1)),
+        bytesPerRow,
+        bytesPerRow * range.height);
+  default:
+    IGL_ASSERT(false && "Unknown texture type");
+    break;
+  }
+  return Result(Result::Code::Ok);
+}
+
+Result Texture::uploadRegion(MTLRegion region,
+                             NSUInteger mipLevel,
+                             NSUInteger firstSlice,
+                             size_t numSlices,
+                             const void* data,
+                             size_t sliceStride,
+                             size_t sliceLength,
+                             size_t bytesPerRow,
+                             size_t bytesPerImage) const {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  if (uploader_ && get().storageMode == MTLStorageModePrivate) {
+    std::vector<TextureUploader::Copy> copies;
+    copies.reserve(numSlices);
+    for (size_t i = 0; i != numSlices; ++i) {
+      copies.push_back({region,
+                        mipLevel,
+                        firstSlice + i,
+                        toMetalBytesPerRow(bytesPerRow),
+                        toMetalBytesPerRow(bytesPerImage),
+                        bytes + i * sliceStride,
+                        sliceLength});
     }
+    Result result;
+    lastUploadHandle_ = uploader_->upload(get(), copies, &result);
+    return result;
+  }
+  for (size_t i = 0; i != numSlices; ++i) {
+    [get() replaceRegion:region
+             mipmapLevel:mipLevel
+                   slice:firstSlice + i
+               withBytes:bytes + i * sliceStride
+             bytesPerRow:toMetalBytesPerRow(bytesPerRow)
+           bytesPerImage:toMetalBytesPerRow(bytesPerImage)];
+  }
+  return Result(Result::Code::Ok);
+}
 
-    data = static_cast<const uint8_t*>(data) + byteIncrement;
+Result Texture::uploadInitialData(const void* data) const {
+  const auto regions = getInitialDataRegions(data);
+  std::vector<TextureUploader::Copy> copies;
+  copies.reserve(regions.size());
+  for (const auto& upload : regions) {
+    const auto& range = upload.range;
+    const size_t bytesPerRow = getProperties().getBytesPerRow(range);
+    const size_t bytesPerImage = bytesPerRow * getProperties().getRows(range);
+    copies.push_back({MTLRegionMake3D(0, 0, 0, range.width, range.height, range.depth),
+                      range.mipLevel,
+                      range.layer,
+                      toMetalBytesPerRow(bytesPerRow),
+                      getType() == TextureType::ThreeD ? toMetalBytesPerRow(bytesPerImage) : 0,
+                      upload.data,
+                      getProperties().getBytesPerRange(range)});
+  }
+
+  if (uploader_ && get().storageMode == MTLStorageModePrivate) {
+    Result result;
+    lastUploadHandle_ = uploader_->upload(get(), copies, &result);
+    return result;
+  }
+  for (const auto& copy : copies) {
+    [get() replaceRegion:copy.region
+             mipmapLevel:copy.mipLevel
+                   slice:copy.slice
+               withBytes:copy.data
+             bytesPerRow:copy.bytesPerRow
+           bytesPerImage:copy.bytesPerImage];
   }
   return Result(Result::Code::Ok);
 }
 
+bool Texture::isUploadCompleted() const {
+  return !uploader_ || uploader_->isCompleted(lastUploadHandle_);
+}
+
+void Texture::waitForUpload() const {
+  if (uploader_) {
+    uploader_->waitUntilCompleted(lastUploadHandle_);
+  }
+}
+
 Result Texture::getBytes(const TextureRangeDesc& range, void* outData, size_t bytesPerRow) const {
   if (!outData) {
     return Result(Result::Code::ArgumentNull, "Need a valid output buffer");
@@ -218,14 +300,15 @@ Result Texture::uploadCube(const TextureRangeDesc& range,
     bytesPerRow = getProperties().getBytesPerRow(range);
   }
   if (data) {
-    MTLRegion region = MTLRegionMake2D(range.x, range.y, range.width, range.height);
-    int layer = static_cast<int>(face);
-    [get() replaceRegion:region
-             mipmapLevel:range.mipLevel
-                   slice:layer
-               withBytes:data
-             bytesPerRow:toMetalBytesPerRow(bytesPerRow)
-           bytesPerImage:0];
+    return uploadRegion(MTLRegionMake2D(range.x, range.y, range.width, range.height),
+                        range.mipLevel,
+                        static_cast<NSUInteger>(face),
+                        1,
+                        data,
+                        0,
+                        bytesPerRow * getProperties().getRows(range),
+                        bytesPerRow,
+                        0);
   }
   return Result(Result::Code::Ok);
 }
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <Metal/Metal.h>
+#include <cstdint>
+#include <igl/CommandQueue.h>
+#include <mutex>
+#include <vector>
+
+namespace igl::metal {
+
+/**
+ * @brief Uploads into textures with MTLStorageModePrivate, which replaceRegion: cannot write.
+ * Private storage lets Apple GPUs keep textures losslessly compressed, which saves read bandwidth.
+ *
+ * The data is copied into a shared staging buffer and a blit encoder on a dedicated queue copies it
+ * into the texture. Staging buffers are recycled once their copy has completed. Every upload
+ * signals a shared event with its handle. The command queues of the device make the command
+ * buffers they create wait for the latest upload on the GPU, so the CPU never waits.
+ */
+class TextureUploader final {
+ public:
+  struct Copy {
+    MTLRegion region = {};
+    NSUInteger mipLevel = 0;
+    NSUInteger slice = 0;
+    size_t bytesPerRow = 0;
+    size_t bytesPerImage = 0;
+    const void* data = nullptr;
+    size_t length = 0;
+  };
+
+  explicit TextureUploader(id<MTLDevice> device);
+
+  /// Encodes and commits the copies into `texture`. Returns the handle the upload completes with,
+  /// or 0 if shared events are not supported, in which case the upload has completed on return
+  SubmitHandle upload(id<MTLTexture> texture, const std::vector<Copy>& copies, Result* outResult);
+
+  /// True once the upload of `handle` and all the previous ones have completed. Never blocks
+  [[nodiscard]] bool isCompleted(SubmitHandle handle) const;
+  /// Blocks until isCompleted(handle)
+  void waitUntilCompleted(SubmitHandle handle) const;
+
+  /// Makes `commandBuffer` wait on the GPU for all uploads committed so far
+  void encodeWaitForUploads(id<MTLCommandBuffer> commandBuffer) const;
+
+ private:
+  struct StagingBuffer {
+    id<MTLBuffer> buffer = nil;
+    SubmitHandle handle = 0;
+  };
+
+  // a staging buffer of at least `length` bytes whose previous copy has completed
+  id<MTLBuffer> acquireStagingBuffer(size_t length);
+
+  id<MTLDevice> device_;
+  id<MTLCommandQueue> queue_ = nil;
+  // MTLSharedEvent signaled with the upload handles, nil before iOS 12 and macOS 10.14
+  id sharedEvent_ = nil;
+  SubmitHandle lastHandle_ = 0;
+  std::vector<StagingBuffer> stagingBuffers_;
+  mutable std::mutex mutex_;
+};
+
+} // namespace igl::metal
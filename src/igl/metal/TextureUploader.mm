@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/TextureUploader.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace igl::metal {
+
+namespace {
+
+constexpr size_t kMinStagingBufferSize = 256 * 1024;
+// completed buffers are released beyond this count, so a burst of uploads does not pin its memory
+constexpr size_t kMaxStagingBuffers = 4;
+// a multiple of the bytes per pixel and per block of all the formats
+constexpr size_t kCopyAlignment = 256;
+
+size_t alignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+TextureUploader::TextureUploader(id<MTLDevice> device) : device_(device) {
+  queue_ = [device_ newCommandQueue];
+  queue_.label = @"Texture uploads";
+  if (@available(macOS 10.14, iOS 12.0, *)) {
+    sharedEvent_ = [device_ newSharedEvent];
+    [(id<MTLSharedEvent>)sharedEvent_ setLabel:@"Texture upload handles"];
+  }
+}
+
+id<MTLBuffer> TextureUploader::acquireStagingBuffer(size_t length) {
+  StagingBuffer* reusable = nullptr;
+  size_t numCompleted = 0;
+  for (auto& staging : stagingBuffers_) {
+    if (!isCompleted(staging.handle)) {
+      continue;
+    }
+    numCompleted++;
+    if (staging.buffer.length >= length &&
+        (!reusable || staging.buffer.length < reusable->buffer.length)) {
+      reusable = &staging;
+    }
+  }
+  if (reusable) {
+    return reusable->buffer;
+  }
+
+  if (numCompleted >= kMaxStagingBuffers) {
+    // replace the smallest completed buffer, which is too small for this upload
+    auto smallest = stagingBuffers_.end();
+    for (auto it = stagingBuffers_.begin(); it != stagingBuffers_.end(); ++it) {
+      if (isCompleted(it->handle) &&
+          (smallest == stagingBuffers_.end() || it->buffer.length < smallest->buffer.length)) {
+        smallest = it;
+      }
+    }
+    stagingBuffers_.erase(smallest);
+  }
+
+  id<MTLBuffer> buffer = [device_ newBufferWithLength:std::max(length, kMinStagingBufferSize)
+                                              options:MTLResourceStorageModeShared |
+                                                      MTLResourceCPUCacheModeWriteCombined];
+  if (buffer != nil) {
+    buffer.label = @"Texture upload staging";
+    stagingBuffers_.push_back({buffer, 0});
+  }
+  return buffer;
+}
+
+SubmitHandle TextureUploader::upload(id<MTLTexture> texture,
+                                     const std::vector<Copy>& copies,
+                                     Result* outResult) {
+  size_t length = 0;
+  for (const auto& copy : copies) {
+    length = alignUp(length, kCopyAlignment) + copy.length;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  id<MTLBuffer> buffer = acquireStagingBuffer(length);
+  if (buffer == nil) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Could not allocate staging buffer");
+    return 0;
+  }
+
+  id<MTLCommandBuffer> commandBuffer = [queue_ commandBuffer];
+  id<MTLBlitCommandEncoder> encoder = [commandBuffer blitCommandEncoder];
+  auto* contents = static_cast<uint8_t*>(buffer.contents);
+  size_t offset = 0;
+  for (const auto& copy : copies) {
+    offset = alignUp(offset, kCopyAlignment);
+    memcpy(contents + offset, copy.data, copy.length);
+    [encoder copyFromBuffer:buffer
+               sourceOffset:offset
+          sourceBytesPerRow:copy.bytesPerRow
+        sourceBytesPerImage:copy.bytesPerImage
+                 sourceSize:copy.region.size
+                  toTexture:texture
+           destinationSlice:copy.slice
+           destinationLevel:copy.mipLevel
+          destinationOrigin:copy.region.origin];
+    offset += copy.length;
+  }
+  [encoder endEncoding];
+
+  SubmitHandle handle = 0;
+  if (@available(macOS 10.14, iOS 12.0, *)) {
+    if (sharedEvent_ != nil) {
+      handle = ++lastHandle_;
+      [commandBuffer encodeSignalEvent:sharedEvent_ value:handle];
+    }
+  }
+  [commandBuffer commit];
+  if (handle == 0) {
+    // without shared events, other queues cannot wait for the upload on the GPU
+    [commandBuffer waitUntilCompleted];
+  }
+
+  for (auto& staging : stagingBuffers_) {
+    if (staging.buffer == buffer) {
+      staging.handle = handle;
+    }
+  }
+
+  Result::setOk(outResult);
+  return handle;
+}
+
+bool TextureUploader::isCompleted(SubmitHandle handle) const {
+  if (@available(macOS 10.14, iOS 12.0, *)) {
+    if (sharedEvent_ != nil) {
+      return ((id<MTLSharedEvent>)sharedEvent_).signaledValue >= handle;
+    }
+  }
+  return true;
+}
+
+void TextureUploader::waitUntilCompleted(SubmitHandle handle) const {
+  if (sharedEvent_ == nil || isCompleted(handle)) {
+    return;
+  }
+  if (@available(macOS 10.14, iOS 12.0, *)) {
+    static MTLSharedEventListener* listener = [[MTLSharedEventListener alloc] init];
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    [(id<MTLSharedEvent>)sharedEvent_ notifyListener:listener
+                                             atValue:handle
+                                               block:^(id<MTLSharedEvent> /*event*/,
+                                                       uint64_t /*value*/) {
+                                                 dispatch_semaphore_signal(semaphore);
+                                               }];
+    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+  }
+}
+
+void TextureUploader::encodeWaitForUploads(id<MTLCommandBuffer> commandBuffer) const {
+  SubmitHandle handle = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    handle = lastHandle_;
+  }
+  if (handle == 0 || isCompleted(handle)) {
+    return;
+  }
+  if (@available(macOS 10.14, iOS 12.0, *)) {
+    [commandBuffer encodeWaitForEvent:sharedEvent_ value:handle];
+  }
+}
+
+} // namespace igl::metal
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <Metal/Metal.h>
+#include <atomic>
+#include <igl/Timer.h>
+
+namespace igl {
+namespace metal {
+
+/**
+ * @brief Measures GPU time using the GPUStartTime/GPUEndTime of the command buffer, which are
+ * reported by its completion handler. The measured time covers the whole command buffer the timer
+ * was ended in.
+ */
+class Timer final : public ITimer {
+ public:
+  Timer() = default;
+  ~Timer() override = default;
+
+  [[nodiscard]] bool resultsAvailable() const override;
+  [[nodiscard]] uint64_t getElapsedTimeNanos() const override;
+
+  void begin();
+  // called from the completion handler of the command buffer the timer was ended in
+  void onCompleted(id<MTLCommandBuffer> commandBuffer);
+
+ private:
+  // written from the completion handler thread
+  std::atomic<bool> resultsAvailable_{false};
+  std::atomic<uint64_t> elapsedTimeNanos_{0};
+};
+
+} // namespace metal
+} // namespace igl
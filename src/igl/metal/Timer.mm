@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/Timer.h>
+
+#import <Foundation/Foundation.h>
+
+namespace igl {
+namespace metal {
+
+bool Timer::resultsAvailable() const {
+  return resultsAvailable_.load(std::memory_order_acquire);
+}
+
+uint64_t Timer::getElapsedTimeNanos() const {
+  return resultsAvailable() ? elapsedTimeNanos_.load(std::memory_order_relaxed) : 0;
+}
+
+void Timer::begin() {
+  resultsAvailable_.store(false, std::memory_order_release);
+  elapsedTimeNanos_.store(0, std::memory_order_relaxed);
+}
+
+void Timer::onCompleted(id<MTLCommandBuffer> commandBuffer) {
+  uint64_t elapsedTimeNanos = 0;
+  if (@available(macOS 10.15, iOS 10.3, *)) {
+    const CFTimeInterval elapsed = commandBuffer.GPUEndTime - commandBuffer.GPUStartTime;
+    elapsedTimeNanos = elapsed > 0 ? static_cast<uint64_t>(elapsed * 1e9) : 0;
+  }
+  elapsedTimeNanos_.store(elapsedTimeNanos, std::memory_order_relaxed);
+  resultsAvailable_.store(true, std::memory_order_release);
+}
+
+} // namespace metal
+} // namespace igl
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <Metal/Metal.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace igl::metal {
+
+class BufferSynchronizationManager;
+
+/**
+ * @brief Per-frame linear allocator for transient shader data, such as the constants passed to
+ * bindBytes(). Each in-flight frame has its own pages of shared memory, and a frame's pages are
+ * recycled when the BufferSynchronizationManager comes back to its in-flight index, the same way
+ * ring buffers are.
+ */
+class UploadArena final {
+ public:
+  // Buffer offsets of the constant address space must be 256-byte aligned on macOS
+  static constexpr size_t kAlignment = 256;
+  static constexpr size_t kDefaultPageSize = 256 * 1024;
+
+  struct Allocation {
+    id<MTLBuffer> buffer = nil;
+    size_t offset = 0;
+  };
+
+  UploadArena(id<MTLDevice> device,
+              std::shared_ptr<const BufferSynchronizationManager> syncManager,
+              size_t pageSize = kDefaultPageSize);
+
+  /// Copies `length` bytes of `data` into the pages of the current frame. Can be called from any
+  /// thread. Allocations larger than a page get a page of their own.
+  Allocation allocate(const void* data, size_t length);
+
+  /// The memory taken by the pages of all the frames
+  [[nodiscard]] size_t getAllocatedSize() const;
+
+ private:
+  struct Frame {
+    std::vector<id<MTLBuffer>> pages;
+    size_t currentPage = 0;
+    size_t offset = 0;
+    // BufferSynchronizationManager::getFrameCount() when the frame was last allocated from
+    uint64_t frameCount = 0;
+  };
+
+  id<MTLDevice> device_;
+  std::shared_ptr<const BufferSynchronizationManager> syncManager_;
+  size_t pageSize_;
+  std::vector<Frame> frames_;
+  mutable std::mutex mutex_;
+};
+
+} // namespace igl::metal
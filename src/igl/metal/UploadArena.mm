@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/UploadArena.h>
+
+#include <algorithm>
+#include <cstring>
+#include <igl/Common.h>
+#include <igl/metal/BufferSynchronizationManager.h>
+
+namespace igl::metal {
+
+UploadArena::UploadArena(id<MTLDevice> device,
+                         std::shared_ptr<const BufferSynchronizationManager> syncManager,
+                         size_t pageSize) :
+  device_(device), syncManager_(std::move(syncManager)), pageSize_(pageSize) {
+  frames_.resize(syncManager_->getMaxInflightBuffers());
+}
+
+UploadArena::Allocation UploadArena::allocate(const void* data, size_t length) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto& frame = frames_[syncManager_->getCurrentInFlightBufferIndex()];
+  if (frame.frameCount != syncManager_->getFrameCount()) {
+    // the GPU is done with what this frame held the last time its in-flight index was current
+    frame.frameCount = syncManager_->getFrameCount();
+    frame.currentPage = 0;
+    frame.offset = 0;
+  }
+
+  size_t offset = (frame.offset + kAlignment - 1) & ~(kAlignment - 1);
+  while (frame.currentPage < frame.pages.size() &&
+         offset + length > frame.pages[frame.currentPage].length) {
+    frame.currentPage++;
+    offset = 0;
+  }
+  if (frame.currentPage == frame.pages.size()) {
+    id<MTLBuffer> page =
+        [device_ newBufferWithLength:std::max(pageSize_, length)
+                             options:MTLResourceStorageModeShared |
+                                     MTLResourceCPUCacheModeWriteCombined];
+    if (!IGL_VERIFY(page != nil)) {
+      return {};
+    }
+    frame.pages.push_back(page);
+  }
+
+  id<MTLBuffer> page = frame.pages[frame.currentPage];
+  memcpy(static_cast<uint8_t*>(page.contents) + offset, data, length);
+  frame.offset = offset + length;
+  return {page, offset};
+}
+
+size_t UploadArena::getAllocatedSize() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t size = 0;
+  for (const auto& frame : frames_) {
+    for (id<MTLBuffer> page : frame.pages) {
+      size += page.length;
+    }
+  }
+  return size;
+}
+
+} // namespace igl::metal
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/BindlessTextureBlock.h>
+
+#include <igl/opengl/IContext.h>
+
+namespace igl {
+namespace opengl {
+
+std::string BindlessTextureBlock::getShaderPrologue(ShaderStage stage) {
+  // vertex textures are in xy, fragment textures in zw
+  const std::string handle = stage == ShaderStage::Vertex ? "xy" : "zw";
+
+  return std::string(R"(#version 450
+#extension GL_ARB_bindless_texture : require
+
+layout (std140) uniform )") +
+         kBlockName + R"( {
+  uvec4 slots[)" + std::to_string(IGL_TEXTURE_SAMPLERS_MAX) +
+         R"(]; // see BindlessTextureBlock
+} iglBindlessTextures;
+uvec2 iglTextureHandle(uint slot) {
+  return iglBindlessTextures.slots[slot].)" +
+         handle + R"(;
+}
+ivec2 textureSize2D(uint slotTexture, uint slotSampler) {
+  return textureSize(sampler2D(iglTextureHandle(slotTexture)), 0);
+}
+vec4 textureSample2D(uint slotTexture, uint slotSampler, vec2 uv) {
+  return texture(sampler2D(iglTextureHandle(slotTexture)), uv);
+}
+float textureSample2DShadow(uint slotTexture, uint slotSampler, vec3 uvw) {
+  return texture(sampler2DShadow(iglTextureHandle(slotTexture)), uvw);
+}
+vec4 textureSample2DArray(uint slotTexture, uint slotSampler, vec3 uvw) {
+  return texture(sampler2DArray(iglTextureHandle(slotTexture)), uvw);
+}
+vec4 textureSampleCube(uint slotTexture, uint slotSampler, vec3 uvw) {
+  return texture(samplerCube(iglTextureHandle(slotTexture)), uvw);
+}
+vec4 textureSample3D(uint slotTexture, uint slotSampler, vec3 uvw) {
+  return texture(sampler3D(iglTextureHandle(slotTexture)), uvw);
+}
+)";
+}
+
+bool BindlessTextureBlock::assignBinding(IContext& context, GLuint program) {
+  const GLuint blockIndex = context.getUniformBlockIndex(program, kBlockName);
+  if (blockIndex == GL_INVALID_INDEX) {
+    return false;
+  }
+  context.uniformBlockBinding(program, blockIndex, kBindingIndex);
+  return true;
+}
+
+void BindlessTextureBlock::clear() {
+  slots_.fill(0);
+  isDirty_ = true;
+}
+
+void BindlessTextureBlock::setHandle(size_t index, size_t component, uint64_t handle) {
+  if (!IGL_VERIFY(index < IGL_TEXTURE_SAMPLERS_MAX)) {
+    return;
+  }
+  const auto low = static_cast<uint32_t>(handle & 0xFFFFFFFFull);
+  const auto high = static_cast<uint32_t>(handle >> 32);
+  uint32_t* slot = slots_.data() + 4 * index + component;
+  if (slot[0] != low || slot[1] != high) {
+    slot[0] = low;
+    slot[1] = high;
+    isDirty_ = true;
+  }
+}
+
+uint64_t BindlessTextureBlock::getHandle(size_t index, size_t component) const {
+  if (!IGL_VERIFY(index < IGL_TEXTURE_SAMPLERS_MAX)) {
+    return 0;
+  }
+  const uint32_t* slot = slots_.data() + 4 * index + component;
+  return (static_cast<uint64_t>(slot[1]) << 32) | slot[0];
+}
+
+void BindlessTextureBlock::bind(PackedUniformRing& ring) {
+  if (isDirty_ || rangeGeneration_ != ring.getGeneration()) {
+    rangeOffset_ = ring.upload(slots_.data(), sizeof(slots_));
+    rangeGeneration_ = ring.getGeneration();
+    isDirty_ = false;
+  }
+  ring.bindRange(rangeOffset_, sizeof(slots_));
+}
+
+} // namespace opengl
+} // namespace igl
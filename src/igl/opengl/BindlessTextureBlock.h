@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <igl/Common.h>
+#include <igl/Shader.h>
+#include <igl/opengl/GLIncludes.h>
+#include <igl/opengl/PackedUniformRing.h>
+#include <string>
+
+namespace igl {
+namespace opengl {
+
+class IContext;
+
+/**
+ * @brief Bindless textures (GL_ARB_bindless_texture), modeled after the bindless descriptor set
+ * of the Vulkan backend. Instead of binding textures to texture units before every draw,
+ * RenderCommandAdapter writes the resident handles of the textures set on the encoder into a
+ * std140 uniform block named kBlockName, which is streamed through a PackedUniformRing.
+ *
+ * Every slot holds the handle of the texture combined with the sampler state set at the same
+ * index, for the vertex stage in `xy` and for the fragment stage in `zw`. Shader modules without
+ * a `#version` directive get getShaderPrologue() prepended, which declares the block and the
+ * textureSample*() helpers of the Vulkan backend, so shader bodies can be shared with it. The
+ * sampler slot argument of the helpers is ignored, since the handles already include the
+ * sampler state.
+ */
+class BindlessTextureBlock final {
+ public:
+  static constexpr const char* kBlockName = "IGLBindlessTextures";
+  /// The uniform buffer binding of the block, next to the one of the packed uniform block
+  static constexpr GLuint kBindingIndex = PackedUniformRing::kBindingIndex + 1;
+
+  /// Returns the source inserted in front of vertex and fragment shaders without a `#version`
+  static std::string getShaderPrologue(ShaderStage stage);
+
+  /// Assigns the block of `program` to kBindingIndex. Returns false if the program has no active
+  /// bindless texture block
+  static bool assignBinding(IContext& context, GLuint program);
+
+  void setVertexTexture(size_t index, uint64_t handle) {
+    setHandle(index, 0, handle);
+  }
+  void setFragmentTexture(size_t index, uint64_t handle) {
+    setHandle(index, 2, handle);
+  }
+  uint64_t getVertexTexture(size_t index) const {
+    return getHandle(index, 0);
+  }
+  uint64_t getFragmentTexture(size_t index) const {
+    return getHandle(index, 2);
+  }
+
+  /// Sets all handles to 0
+  void clear();
+
+  /// Uploads the block if it has changed and binds it
+  void bind(PackedUniformRing& ring);
+
+ private:
+  void setHandle(size_t index, size_t component, uint64_t handle);
+  uint64_t getHandle(size_t index, size_t component) const;
+
+ private:
+  // uvec4 per slot, GLSL turns a uvec2 of (low, high) bits into a sampler
+  std::array<uint32_t, 4 * IGL_TEXTURE_SAMPLERS_MAX> slots_ = {};
+  bool isDirty_ = true;
+  size_t rangeOffset_ = 0;
+  uint64_t rangeGeneration_ = 0;
+};
+
+} // namespace opengl
+} // namespace igl
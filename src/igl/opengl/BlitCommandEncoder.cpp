@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/BlitCommandEncoder.h>
+
+#include <igl/opengl/Buffer.h>
+#include <igl/opengl/CommandBuffer.h>
+#include <igl/opengl/Errors.h>
+#include <igl/opengl/TextureBuffer.h>
+#include <vector>
+
+namespace igl {
+namespace opengl {
+
+namespace {
+
+// Uniform buffers are CPU memory, everything else has a GL buffer
+ArrayBuffer* getArrayBuffer(IBuffer& buffer) {
+  auto& glBuffer = static_cast<Buffer&>(buffer);
+  if (glBuffer.getType() == Buffer::Type::Uniform) {
+    return nullptr;
+  }
+  return &static_cast<ArrayBuffer&>(glBuffer);
+}
+
+GLenum getCopyTarget(const Texture& texture) {
+  const auto* textureBuffer = dynamic_cast<const TextureBufferBase*>(&texture);
+  return textureBuffer ? textureBuffer->getTarget() : GL_RENDERBUFFER;
+}
+
+} // namespace
+
+BlitCommandEncoder::BlitCommandEncoder(std::shared_ptr<ICommandBuffer> commandBuffer,
+                                       IContext& context) :
+  IBlitCommandEncoder(std::move(commandBuffer)), WithContext(context) {}
+
+void BlitCommandEncoder::endEncoding() {
+  getContext().checkErrorsAtPassEnd("BlitCommandEncoder::endEncoding");
+}
+
+void BlitCommandEncoder::pushDebugGroupLabel(const std::string& label,
+                                             const igl::Color& /*color*/) const {
+  IGL_ASSERT(!label.empty());
+  getContext().pushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, label.length(), label.c_str());
+}
+
+void BlitCommandEncoder::insertDebugEventLabel(const std::string& label,
+                                               const igl::Color& /*color*/) const {
+  IGL_ASSERT(!label.empty());
+  getContext().debugMessageInsert(GL_DEBUG_SOURCE_APPLICATION,
+                                  GL_DEBUG_TYPE_MARKER,
+                                  0,
+                                  GL_DEBUG_SEVERITY_LOW,
+                                  label.length(),
+                                  label.c_str());
+}
+
+void BlitCommandEncoder::popDebugGroupLabel() const {
+  getContext().popDebugGroup();
+}
+
+void BlitCommandEncoder::copyBuffer(IBuffer& source,
+                                    size_t sourceOffset,
+                                    IBuffer& destination,
+                                    size_t destinationOffset,
+                                    size_t size) {
+  auto* src = getArrayBuffer(source);
+  auto* dst = getArrayBuffer(destination);
+  if (!IGL_VERIFY(src && dst)) {
+    return;
+  }
+  auto& context = getContext();
+  if (!context.deviceFeatures().hasInternalFeature(InternalFeatures::CopyBuffer)) {
+    IGL_LOG_ERROR("BlitCommandEncoder::copyBuffer: glCopyBufferSubData is not supported\n");
+    return;
+  }
+  src->bindForTarget(GL_COPY_READ_BUFFER);
+  dst->bindForTarget(GL_COPY_WRITE_BUFFER);
+  context.copyBufferSubData(GL_COPY_READ_BUFFER,
+                            GL_COPY_WRITE_BUFFER,
+                            static_cast<GLintptr>(sourceOffset),
+                            static_cast<GLintptr>(destinationOffset),
+                            static_cast<GLsizeiptr>(size));
+  context.bindBuffer(GL_COPY_READ_BUFFER, 0);
+  context.bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void BlitCommandEncoder::copyBufferToTexture(IBuffer& source,
+                                             size_t sourceOffset,
+                                             size_t sourceBytesPerRow,
+                                             ITexture& destination,
+                                             const TextureRangeDesc& range) {
+  auto* src = getArrayBuffer(source);
+  auto* dst = dynamic_cast<TextureBuffer*>(&destination);
+  if (!IGL_VERIFY(src && dst)) {
+    return;
+  }
+  const Result result = dst->uploadFromBuffer(src->getId(), sourceOffset, range, sourceBytesPerRow);
+  if (!result.isOk()) {
+    IGL_LOG_ERROR("BlitCommandEncoder::copyBufferToTexture: %s\n", result.message.c_str());
+  }
+}
+
+void BlitCommandEncoder::copyTexture(ITexture& source,
+                                     const TextureRangeDesc& sourceRange,
+                                     ITexture& destination,
+                                     const TextureRangeDesc& destinationRange) {
+  auto& context = getContext();
+  if (!context.deviceFeatures().hasInternalFeature(InternalFeatures::CopyImage)) {
+    IGL_LOG_ERROR("BlitCommandEncoder::copyTexture: glCopyImageSubData is not supported\n");
+    return;
+  }
+  const auto& src = static_cast<const Texture&>(source);
+  const auto& dst = static_cast<const Texture&>(destination);
+  // layers of array textures are addressed by the z coordinate
+  context.copyImageSubData(src.getId(),
+                           getCopyTarget(src),
+                           static_cast<GLint>(sourceRange.mipLevel),
+                           static_cast<GLint>(sourceRange.x),
+                           static_cast<GLint>(sourceRange.y),
+                           static_cast<GLint>(sourceRange.z + sourceRange.layer),
+                           dst.getId(),
+                           getCopyTarget(dst),
+                           static_cast<GLint>(destinationRange.mipLevel),
+                           static_cast<GLint>(destinationRange.x),
+                           static_cast<GLint>(destinationRange.y),
+                           static_cast<GLint>(destinationRange.z + destinationRange.layer),
+                           static_cast<GLsizei>(sourceRange.width),
+                           static_cast<GLsizei>(sourceRange.height),
+                           static_cast<GLsizei>(sourceRange.depth * sourceRange.numLayers));
+}
+
+void BlitCommandEncoder::fillBuffer(IBuffer& buffer, size_t offset, size_t size, uint8_t value) {
+  const std::vector<uint8_t> data(size, value);
+  const Result result = buffer.upload(data.data(), BufferRange(size, offset));
+  if (!result.isOk()) {
+    IGL_LOG_ERROR("BlitCommandEncoder::fillBuffer: %s\n", result.message.c_str());
+  }
+}
+
+void BlitCommandEncoder::generateMipmaps(ITexture& texture) {
+  auto* textureBuffer = dynamic_cast<TextureBufferBase*>(&texture);
+  if (!IGL_VERIFY(textureBuffer)) {
+    return;
+  }
+  auto& context = getContext();
+  context.bindTexture(textureBuffer->getTarget(), textureBuffer->getId());
+  context.generateMipmap(textureBuffer->getTarget());
+  context.bindTexture(textureBuffer->getTarget(), 0);
+}
+
+} // namespace opengl
+} // namespace igl
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/BlitCommandEncoder.h>
+#include <igl/Common.h>
+#include <igl/opengl/IContext.h>
+
+namespace igl {
+class ICommandBuffer;
+namespace opengl {
+
+// GL has no blit encoders, the copies are issued immediately on the context thread
+class BlitCommandEncoder final : public IBlitCommandEncoder, public WithContext {
+ public:
+  BlitCommandEncoder(std::shared_ptr<ICommandBuffer> commandBuffer, IContext& context);
+  ~BlitCommandEncoder() override = default;
+
+  void endEncoding() override;
+
+  void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
+  void insertDebugEventLabel(const std::string& label, const igl::Color& color) const override;
+  void popDebugGroupLabel() const override;
+
+  void copyBuffer(IBuffer& source,
+                  size_t sourceOffset,
+                  IBuffer& destination,
+                  size_t destinationOffset,
+                  size_t size) override;
+  // requires pixel buffer objects
+  void copyBufferToTexture(IBuffer& source,
+                           size_t sourceOffset,
+                           size_t sourceBytesPerRow,
+                           ITexture& destination,
+                           const TextureRangeDesc& range) override;
+  // requires GL 4.3 or GLES 3.2
+  void copyTexture(ITexture& source,
+                   const TextureRangeDesc& sourceRange,
+                   ITexture& destination,
+                   const TextureRangeDesc& destinationRange) override;
+  // uploads the filled range from the CPU
+  void fillBuffer(IBuffer& buffer, size_t offset, size_t size, uint8_t value) override;
+  void generateMipmaps(ITexture& texture) override;
+};
+
+} // namespace opengl
+} // namespace igl
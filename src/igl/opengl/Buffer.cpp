@@ -9,11 +9,50 @@
 
 #include <igl/CommandBuffer.h>
 #include <igl/Device.h>
+#include <igl/IGLSafeC.h>
 #include <igl/opengl/Errors.h>
 
 namespace igl {
 namespace opengl {
 
+namespace {
+
+GLenum getBufferTarget(IContext& context, BufferDesc::BufferType type) {
+  if (type & BufferDesc::BufferTypeBits::Storage) {
+    if (context.deviceFeatures().hasFeature(DeviceFeatures::Compute)) {
+      return GL_SHADER_STORAGE_BUFFER;
+    }
+    IGL_ASSERT_NOT_IMPLEMENTED();
+  } else if (type & BufferDesc::BufferTypeBits::Uniform) {
+    return GL_UNIFORM_BUFFER;
+  } else if (type & BufferDesc::BufferTypeBits::Vertex) {
+    return GL_ARRAY_BUFFER;
+  } else if (type & BufferDesc::BufferTypeBits::Index) {
+    return GL_ELEMENT_ARRAY_BUFFER;
+  } else {
+    IGL_ASSERT_NOT_IMPLEMENTED();
+  }
+  return GL_NONE;
+}
+
+// the ring grows up to kMaxStreamingBuffers when the GPU is still reading all of its buffers
+constexpr size_t kNumStreamingBuffers = 3;
+constexpr size_t kMaxStreamingBuffers = 8;
+
+ArrayBuffer::StreamingMode chooseStreamingMode(const IContext& context) {
+  const auto& features = context.deviceFeatures();
+  if (!features.hasInternalFeature(InternalFeatures::Sync)) {
+    return ArrayBuffer::StreamingMode::Orphan;
+  }
+  if (features.hasInternalFeature(InternalFeatures::BufferStorage) &&
+      features.hasFeature(DeviceFeatures::MapBufferRange)) {
+    return ArrayBuffer::StreamingMode::Persistent;
+  }
+  return ArrayBuffer::StreamingMode::FencedRing;
+}
+
+} // namespace
+
 // ********************************
 // ****  ArrayBuffer
 // ********************************
@@ -26,6 +65,18 @@ ArrayBuffer::ArrayBuffer(IContext& context, BufferDesc::BufferAPIHint requestedA
 }
 
 ArrayBuffer::~ArrayBuffer() {
+  if (!streamingBuffers_.empty()) {
+    // iD_ is one of the streaming buffers
+    for (auto& buffer : streamingBuffers_) {
+      if (buffer.fence) {
+        getContext().deleteSync(buffer.fence);
+      }
+      getContext().deleteBuffers(1, &buffer.id);
+    }
+    streamingBuffers_.clear();
+    getContext().unbindBuffer(target_);
+    iD_ = 0;
+  }
   if (iD_ != 0) {
     getContext().deleteBuffers(1, &iD_);
     getContext().unbindBuffer(target_);
@@ -63,23 +114,14 @@ void ArrayBuffer::initialize(const BufferDesc& desc, Result* outResult) {
     return;
   }
 
+  if (isDynamic_ && (requestedApiHints() & BufferDesc::BufferAPIHintBits::Ring)) {
+    initializeStreaming(desc, outResult);
+    return;
+  }
+
   getContext().genBuffers(1, &iD_);
 
-  if (desc.type & BufferDesc::BufferTypeBits::Storage) {
-    if (getContext().deviceFeatures().hasFeature(DeviceFeatures::Compute)) {
-      target_ = GL_SHADER_STORAGE_BUFFER;
-    } else {
-      IGL_ASSERT_NOT_IMPLEMENTED();
-    }
-  } else if (desc.type & BufferDesc::BufferTypeBits::Uniform) {
-    target_ = GL_UNIFORM_BUFFER;
-  } else if (desc.type & BufferDesc::BufferTypeBits::Vertex) {
-    target_ = GL_ARRAY_BUFFER;
-  } else if (desc.type & BufferDesc::BufferTypeBits::Index) {
-    target_ = GL_ELEMENT_ARRAY_BUFFER;
-  } else {
-    IGL_ASSERT_NOT_IMPLEMENTED();
-  }
+  target_ = getBufferTarget(getContext(), desc.type);
 
   size_ = desc.length;
 
@@ -102,13 +144,184 @@ void ArrayBuffer::initialize(const BufferDesc& desc, Result* outResult) {
   Result::setOk(outResult);
 }
 
+void ArrayBuffer::initializePersistent(const BufferDesc& desc, Result* outResult) {
+  // persistent and coherent: CPU writes become visible to the GPU without flushing or unmapping
+  const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+  getContext().genBuffers(1, &iD_);
+
+  target_ = getBufferTarget(getContext(), desc.type);
+  size_ = desc.length;
+  isDynamic_ = true;
+
+  getContext().bindBuffer(target_, iD_);
+  getContext().bufferStorage(target_, size_, desc.data, flags);
+  persistentData_ = static_cast<uint8_t*>(getContext().mapBufferRange(target_, 0, size_, flags));
+  getContext().bindBuffer(target_, 0);
+
+  if (persistentData_ == nullptr) {
+    getContext().deleteBuffers(1, &iD_);
+    iD_ = 0;
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot map persistent buffer");
+    return;
+  }
+
+  Result::setOk(outResult);
+}
+
+void ArrayBuffer::initializeStreaming(const BufferDesc& desc, Result* outResult) {
+  target_ = getBufferTarget(getContext(), desc.type);
+  size_ = desc.length;
+  streamingMode_ = chooseStreamingMode(getContext());
+
+  shadowData_.resize(size_);
+  if (desc.data) {
+    checked_memcpy(shadowData_.data(), shadowData_.size(), desc.data, size_);
+  }
+
+  if (streamingMode_ == StreamingMode::Orphan) {
+    getContext().genBuffers(1, &iD_);
+    getContext().bindBuffer(target_, iD_);
+    getContext().bufferData(target_, size_, desc.data, GL_STREAM_DRAW);
+    getContext().bindBuffer(target_, 0);
+    Result::setOk(outResult);
+    return;
+  }
+
+  streamingBuffers_.resize(kNumStreamingBuffers);
+  for (size_t i = 0; i != streamingBuffers_.size(); i++) {
+    if (!createStreamingBuffer(i == 0 ? desc.data : nullptr, streamingBuffers_[i])) {
+      // the destructor deletes the buffers created so far
+      streamingBuffers_.resize(i + 1);
+      Result::setResult(
+          outResult, Result::Code::RuntimeError, "Cannot create streaming buffer storage");
+      return;
+    }
+  }
+
+  currentStreamingBuffer_ = 0;
+  iD_ = streamingBuffers_[0].id;
+
+  Result::setOk(outResult);
+}
+
+bool ArrayBuffer::createStreamingBuffer(const void* data, StreamingBuffer& outBuffer) {
+  getContext().genBuffers(1, &outBuffer.id);
+  getContext().bindBuffer(target_, outBuffer.id);
+
+  if (streamingMode_ == StreamingMode::Persistent) {
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    getContext().bufferStorage(target_, size_, data, flags);
+    outBuffer.data = static_cast<uint8_t*>(getContext().mapBufferRange(target_, 0, size_, flags));
+  } else {
+    getContext().bufferData(target_, size_, data, GL_DYNAMIC_DRAW);
+  }
+
+  getContext().bindBuffer(target_, 0);
+
+  return streamingMode_ != StreamingMode::Persistent || outBuffer.data != nullptr;
+}
+
+size_t ArrayBuffer::acquireStreamingBuffer() {
+  const size_t numBuffers = streamingBuffers_.size();
+
+  // the current buffer has just been fenced, start with the oldest one
+  for (size_t i = 1; i != numBuffers; i++) {
+    const size_t index = (currentStreamingBuffer_ + i) % numBuffers;
+    auto& buffer = streamingBuffers_[index];
+    if (buffer.fence) {
+      GLint status = 0;
+      getContext().getSynciv(buffer.fence, GL_SYNC_STATUS, sizeof(GLint), nullptr, &status);
+      if (status != GL_SIGNALED) {
+        continue;
+      }
+      getContext().deleteSync(buffer.fence);
+      buffer.fence = nullptr;
+    }
+    return index;
+  }
+
+  if (numBuffers < kMaxStreamingBuffers) {
+    StreamingBuffer buffer;
+    if (createStreamingBuffer(nullptr, buffer)) {
+      streamingBuffers_.push_back(buffer);
+      return numBuffers;
+    }
+    getContext().deleteBuffers(1, &buffer.id);
+  }
+
+  // the GPU is too far behind, wait for it
+  getContext().finish();
+
+  for (auto& buffer : streamingBuffers_) {
+    if (buffer.fence) {
+      getContext().deleteSync(buffer.fence);
+      buffer.fence = nullptr;
+    }
+  }
+
+  return (currentStreamingBuffer_ + 1) % numBuffers;
+}
+
+Result ArrayBuffer::uploadStreaming(const void* data, const BufferRange& range) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_UPLOAD);
+
+  if (range.offset + range.size > size_) {
+    return Result(Result::Code::ArgumentOutOfRange, "Upload range exceeds buffer size");
+  }
+
+  checked_memcpy_offset(shadowData_.data(), shadowData_.size(), range.offset, data, range.size);
+
+  if (streamingMode_ == StreamingMode::Orphan) {
+    // the driver detaches the old storage, which the GPU may still be reading, instead of waiting
+    getContext().bindBuffer(target_, iD_);
+    getContext().bufferData(target_, size_, shadowData_.data(), GL_STREAM_DRAW);
+    getContext().bindBuffer(target_, 0);
+    return Result();
+  }
+
+  // every command issued so far, including the draws reading the current buffer, precedes the fence
+  auto& current = streamingBuffers_[currentStreamingBuffer_];
+  if (current.fence) {
+    getContext().deleteSync(current.fence);
+  }
+  current.fence = getContext().fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  currentStreamingBuffer_ = acquireStreamingBuffer();
+
+  auto& next = streamingBuffers_[currentStreamingBuffer_];
+  if (streamingMode_ == StreamingMode::Persistent) {
+    checked_memcpy(next.data, size_, shadowData_.data(), size_);
+  } else {
+    getContext().bindBuffer(target_, next.id);
+    getContext().bufferSubData(target_, 0, size_, shadowData_.data());
+    getContext().bindBuffer(target_, 0);
+  }
+
+  iD_ = next.id;
+
+  return Result();
+}
+
 // upload data to the buffer at the given offset with the given size
 Result ArrayBuffer::upload(const void* data, const BufferRange& range) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_UPLOAD);
+
   // static buffers can only upload data once during creation
   if (!isDynamic_) {
     return Result(Result::Code::InvalidOperation, "Can't upload to static buffers");
   }
 
+  if (isStreaming()) {
+    return uploadStreaming(data, range);
+  }
+
+  if (persistentData_ != nullptr) {
+    // immutable storage cannot be updated with glBufferSubData()
+    checked_memcpy_offset(persistentData_, size_, range.offset, data, range.size);
+    return Result();
+  }
+
   getContext().bindBuffer(target_, iD_);
 
   getContext().bufferSubData(target_, range.offset, range.size, data);
@@ -125,6 +338,17 @@ void* ArrayBuffer::map(const BufferRange& range, Result* outResult) {
     return nullptr;
   }
 
+  if (persistentData_ != nullptr) {
+    Result::setOk(outResult);
+    return persistentData_ + range.offset;
+  }
+
+  if (isStreaming()) {
+    // the GL buffers of the ring are write-only, but the shadow copy has the same contents
+    Result::setOk(outResult);
+    return shadowData_.data() + range.offset;
+  }
+
   bind();
 
   void* srcData = nullptr;
@@ -140,6 +364,9 @@ void* ArrayBuffer::map(const BufferRange& range, Result* outResult) {
 }
 
 void ArrayBuffer::unmap() {
+  if (persistentData_ != nullptr || isStreaming()) {
+    return;
+  }
   bind();
   getContext().unmapBuffer(target_);
 }
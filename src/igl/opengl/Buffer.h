@@ -12,6 +12,7 @@
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/IContext.h>
 #include <igl/opengl/WithContext.h>
+#include <vector>
 
 namespace igl {
 class ICommandBuffer;
@@ -50,13 +51,36 @@ class ArrayBuffer : public Buffer {
   void unmap() override;
 
   BufferDesc::BufferAPIHint acceptedApiHints() const noexcept override {
-    return 0;
+    return isStreaming() ? BufferDesc::BufferAPIHintBits::Ring : 0;
   }
 
   ResourceStorage storage() const noexcept override {
     return ResourceStorage::Managed;
   }
 
+  /**
+   * @brief How a dynamic buffer created with BufferAPIHintBits::Ring avoids stalling when it is
+   * uploaded to while the GPU may still read it. Chosen by initialize() from the context features.
+   */
+  enum class StreamingMode : uint8_t {
+    // glBufferSubData(), the driver synchronizes implicitly
+    None,
+    // a ring of immutable buffers mapped with GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT
+    Persistent,
+    // a ring of buffers updated with glBufferSubData() only after their fence has signaled
+    FencedRing,
+    // glBufferData() reallocates the storage on every upload
+    Orphan,
+  };
+
+  IGL_INLINE StreamingMode getStreamingMode() const noexcept {
+    return streamingMode_;
+  }
+
+  IGL_INLINE bool isStreaming() const noexcept {
+    return streamingMode_ != StreamingMode::None;
+  }
+
   size_t getSizeInBytes() const override {
     return size_;
   }
@@ -70,12 +94,20 @@ class ArrayBuffer : public Buffer {
   }
 
   void initialize(const BufferDesc& desc, Result* outResult) override;
+  // allocates immutable storage which stays mapped for writing until destruction, see IRingBuffer
+  void initializePersistent(const BufferDesc& desc, Result* outResult);
+
+  IGL_INLINE uint8_t* getPersistentData() const noexcept {
+    return persistentData_;
+  }
 
   void bind();
   void unbind();
 
   void bindBase(size_t index, Result* outResult);
 
+  // Streaming buffers switch to another GL buffer on upload, so they have to be uploaded to before
+  // being bound for a draw
   void bindForTarget(GLenum target);
 
   Type getType() const noexcept override {
@@ -94,6 +126,29 @@ class ArrayBuffer : public Buffer {
   size_t size_;
 
   bool isDynamic_;
+
+  // non-null for buffers created by initializePersistent()
+  uint8_t* persistentData_ = nullptr;
+
+  struct StreamingBuffer {
+    GLuint id = 0;
+    // non-null in StreamingMode::Persistent
+    uint8_t* data = nullptr;
+    // inserted when the ring moves on to the next buffer
+    GLsync fence = nullptr;
+  };
+
+  void initializeStreaming(const BufferDesc& desc, Result* outResult);
+  Result uploadStreaming(const void* data, const BufferRange& range);
+  bool createStreamingBuffer(const void* data, StreamingBuffer& outBuffer);
+  // Returns the index of a buffer which the GPU no longer reads, waits for the GPU if needed
+  size_t acquireStreamingBuffer();
+
+  StreamingMode streamingMode_ = StreamingMode::None;
+  std::vector<StreamingBuffer> streamingBuffers_;
+  size_t currentStreamingBuffer_ = 0;
+  // CPU copy of the contents, partial uploads need the rest of the buffer for the next GL buffer
+  std::vector<uint8_t> shadowData_;
 };
 
 class UniformBlockBuffer : public ArrayBuffer {
@@ -110,7 +165,7 @@ class UniformBlockBuffer : public ArrayBuffer {
   void bindRange(size_t index, size_t offset, Result* outResult);
 
   BufferDesc::BufferAPIHint acceptedApiHints() const noexcept override {
-    return BufferDesc::BufferAPIHintBits::UniformBlock;
+    return BufferDesc::BufferAPIHintBits::UniformBlock | ArrayBuffer::acceptedApiHints();
   }
 };
 
@@ -7,10 +7,14 @@
 
 #include <igl/opengl/CommandBuffer.h>
 
+#include <igl/opengl/BlitCommandEncoder.h>
 #include <igl/opengl/ComputeCommandEncoder.h>
 #include <igl/opengl/Errors.h>
+#include <igl/opengl/DeferredRenderCommandEncoder.h>
 #include <igl/opengl/IContext.h>
+#include <igl/opengl/ParallelRenderCommandEncoder.h>
 #include <igl/opengl/RenderCommandEncoder.h>
+#include <igl/opengl/Timer.h>
 
 namespace igl {
 namespace opengl {
@@ -23,14 +27,42 @@ std::unique_ptr<IRenderCommandEncoder> CommandBuffer::createRenderCommandEncoder
     const RenderPassDesc& renderPass,
     std::shared_ptr<IFramebuffer> framebuffer,
     Result* outResult) {
-  return RenderCommandEncoder::create(shared_from_this(), renderPass, framebuffer, outResult);
+  replayDeferredRenderPasses();
+  auto encoder =
+      RenderCommandEncoder::create(shared_from_this(), renderPass, framebuffer, outResult);
+  if (encoder) {
+    incrementStatistic(CommandBufferCounter::RenderPasses);
+  }
+  return encoder;
+}
+
+std::unique_ptr<IParallelRenderCommandEncoder> CommandBuffer::createParallelRenderCommandEncoder(
+    const RenderPassDesc& renderPass,
+    std::shared_ptr<IFramebuffer> framebuffer,
+    Result* outResult) {
+  if (!framebuffer) {
+    Result::setResult(outResult, Result::Code::ArgumentNull, "framebuffer was null");
+    return nullptr;
+  }
+  Result::setOk(outResult);
+  incrementStatistic(CommandBufferCounter::RenderPasses);
+  return std::make_unique<ParallelRenderCommandEncoder>(
+      shared_from_this(), renderPass, std::move(framebuffer));
 }
 
 std::unique_ptr<IComputeCommandEncoder> CommandBuffer::createComputeCommandEncoder() {
-  return std::make_unique<ComputeCommandEncoder>(shared_from_this()->getContext());
+  replayDeferredRenderPasses();
+  return std::make_unique<ComputeCommandEncoder>(shared_from_this(), getContext());
+}
+
+std::unique_ptr<IBlitCommandEncoder> CommandBuffer::createBlitCommandEncoder(Result* outResult) {
+  replayDeferredRenderPasses();
+  Result::setOk(outResult);
+  return std::make_unique<BlitCommandEncoder>(shared_from_this(), getContext());
 }
 
 void CommandBuffer::present(std::shared_ptr<ITexture> surface) const {
+  const_cast<CommandBuffer*>(this)->replayDeferredRenderPasses();
   context_->present(surface);
 }
 
@@ -39,22 +71,66 @@ void CommandBuffer::waitUntilScheduled() {
 }
 
 void CommandBuffer::waitUntilCompleted() {
-  context_->finish();
+  if (lastSubmitHandle_) {
+    context_->waitForSubmitHandle(lastSubmitHandle_);
+  } else {
+    context_->finish();
+  }
 }
 
 void CommandBuffer::pushDebugGroupLabel(const std::string& label,
                                         const igl::Color& /*color*/) const {
   IGL_ASSERT(!label.empty());
+  const_cast<CommandBuffer*>(this)->replayDeferredRenderPasses();
   getContext().pushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, label.length(), label.c_str());
 }
 
 void CommandBuffer::popDebugGroupLabel() const {
+  const_cast<CommandBuffer*>(this)->replayDeferredRenderPasses();
   getContext().popDebugGroup();
 }
 
+void CommandBuffer::beginTimer(const std::shared_ptr<ITimer>& timer) {
+  if (!IGL_VERIFY(timer)) {
+    return;
+  }
+  replayDeferredRenderPasses();
+  static_cast<Timer&>(*timer).begin();
+}
+
+void CommandBuffer::endTimer(const std::shared_ptr<ITimer>& timer) {
+  if (!IGL_VERIFY(timer)) {
+    return;
+  }
+  replayDeferredRenderPasses();
+  static_cast<Timer&>(*timer).end();
+}
+
 IContext& CommandBuffer::getContext() const {
   return *context_;
 }
 
+void CommandBuffer::addDeferredRenderPass(const RenderPassDesc& renderPass,
+                                          std::shared_ptr<IFramebuffer> framebuffer,
+                                          std::vector<std::unique_ptr<CommandStream>> streams) {
+  deferredRenderPasses_.push_back({renderPass, std::move(framebuffer), std::move(streams)});
+}
+
+void CommandBuffer::replayDeferredRenderPasses() {
+  for (auto& pass : deferredRenderPasses_) {
+    Result result;
+    auto encoder = RenderCommandEncoder::create(
+        shared_from_this(), pass.renderPass, pass.framebuffer, &result);
+    if (!IGL_VERIFY(result.isOk())) {
+      continue;
+    }
+    for (const auto& stream : pass.streams) {
+      DeferredRenderCommandEncoder::replay(*stream, *encoder);
+    }
+    encoder->endEncoding();
+  }
+  deferredRenderPasses_.clear();
+}
+
 } // namespace opengl
 } // namespace igl
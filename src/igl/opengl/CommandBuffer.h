@@ -8,9 +8,14 @@
 #pragma once
 
 #include <igl/CommandBuffer.h>
+#include <igl/CommandQueue.h>
+#include <igl/RenderPass.h>
+#include <igl/opengl/CommandStream.h>
+#include <vector>
 
 namespace igl {
 namespace opengl {
+class BlitCommandEncoder;
 class ComputeCommandEncoder;
 class IContext;
 class PipelineState;
@@ -28,8 +33,18 @@ class CommandBuffer final : public ICommandBuffer,
       std::shared_ptr<IFramebuffer> framebuffer,
       Result* outResult) override;
 
+  /// Child encoders record without GL calls and can be used on any thread, see
+  /// ParallelRenderCommandEncoder
+  std::unique_ptr<IParallelRenderCommandEncoder> createParallelRenderCommandEncoder(
+      const RenderPassDesc& renderPass,
+      std::shared_ptr<IFramebuffer> framebuffer,
+      Result* outResult) override;
+
   std::unique_ptr<IComputeCommandEncoder> createComputeCommandEncoder() override;
 
+  /// Copies are issued immediately, after the deferred render passes encoded so far
+  std::unique_ptr<IBlitCommandEncoder> createBlitCommandEncoder(Result* outResult) override;
+
   void present(std::shared_ptr<ITexture> surface) const override;
 
   void waitUntilScheduled() override;
@@ -40,10 +55,33 @@ class CommandBuffer final : public ICommandBuffer,
 
   void popDebugGroupLabel() const override;
 
+  void beginTimer(const std::shared_ptr<ITimer>& timer) override;
+
+  void endTimer(const std::shared_ptr<ITimer>& timer) override;
+
   IContext& getContext() const;
 
  private:
+  friend class CommandQueue;
+  friend class ParallelRenderCommandEncoder;
+
+  struct DeferredRenderPass {
+    RenderPassDesc renderPass;
+    std::shared_ptr<IFramebuffer> framebuffer;
+    std::vector<std::unique_ptr<CommandStream>> streams;
+  };
+
+  void addDeferredRenderPass(const RenderPassDesc& renderPass,
+                             std::shared_ptr<IFramebuffer> framebuffer,
+                             std::vector<std::unique_ptr<CommandStream>> streams);
+  // Replays the deferred render passes on the context thread. Called by CommandQueue::submit() and
+  // before any command which is issued immediately, so that GL sees all commands in encoding order
+  void replayDeferredRenderPasses();
+
   std::shared_ptr<IContext> context_;
+  std::vector<DeferredRenderPass> deferredRenderPasses_;
+  // set by CommandQueue::submit(), 0 if the context does not support sync objects
+  SubmitHandle lastSubmitHandle_ = 0;
 };
 
 } // namespace opengl
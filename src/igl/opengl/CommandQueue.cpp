@@ -39,12 +39,23 @@ std::shared_ptr<ICommandBuffer> CommandQueue::createCommandBuffer(const CommandB
 }
 
 SubmitHandle CommandQueue::submit(const ICommandBuffer& commandBuffer, bool /* endOfFrame */) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_SUBMIT);
+
   const auto& cb = static_cast<const CommandBuffer&>(commandBuffer);
+  auto* glCommandBuffer = const_cast<CommandBuffer*>(&cb);
+
+  // render passes recorded by parallel encoders are issued now, on the context thread
+  glCommandBuffer->replayDeferredRenderPasses();
+
   incrementDrawCount(cb.getCurrentDrawCount());
+  IGL_PROFILER_PLOT("IGL draws per submit", cb.getCurrentDrawCount());
 
   activeCommandBuffers_--;
 
-  return SubmitHandle{};
+  // GL commands have already been issued while encoding, the fence follows all of them
+  glCommandBuffer->lastSubmitHandle_ = context_->insertSubmitFence();
+
+  return glCommandBuffer->lastSubmitHandle_;
 }
 
 } // namespace opengl
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/CommandStream.h>
+
+#include <algorithm>
+
+namespace igl {
+namespace opengl {
+
+void* CommandStream::append(uint32_t opcode, size_t size) {
+  IGL_ASSERT(size <= UINT32_MAX);
+
+  const size_t entrySize = sizeof(Header) + alignSize(size);
+
+  if (currentChunk_ < chunks_.size() &&
+      chunks_[currentChunk_].used + entrySize > chunks_[currentChunk_].capacity) {
+    if (chunks_[currentChunk_].used != 0) {
+      currentChunk_++;
+    }
+  }
+  if (currentChunk_ == chunks_.size() || chunks_[currentChunk_].capacity < entrySize) {
+    // commands larger than a chunk get a chunk of their own
+    const size_t capacity = std::max(kChunkSize, entrySize);
+    Chunk chunk;
+    chunk.data = std::unique_ptr<uint8_t[]>(new uint8_t[capacity]);
+    chunk.capacity = capacity;
+    chunks_.insert(chunks_.begin() + currentChunk_, std::move(chunk));
+  }
+
+  Chunk& chunk = chunks_[currentChunk_];
+  const Header header = {opcode, static_cast<uint32_t>(size)};
+  memcpy(chunk.data.get() + chunk.used, &header, sizeof(Header));
+  void* payload = chunk.data.get() + chunk.used + sizeof(Header);
+  chunk.used += entrySize;
+
+  return payload;
+}
+
+uint32_t CommandStream::retain(std::shared_ptr<void> object) {
+  objects_.push_back(std::move(object));
+  return static_cast<uint32_t>(objects_.size() - 1);
+}
+
+void CommandStream::reset() {
+  for (auto& chunk : chunks_) {
+    chunk.used = 0;
+  }
+  currentChunk_ = 0;
+  objects_.clear();
+}
+
+} // namespace opengl
+} // namespace igl
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <igl/Common.h>
+#include <memory>
+#include <vector>
+
+namespace igl {
+namespace opengl {
+
+/**
+ * @brief Compact binary stream of commands, recorded without a GL context and read back in
+ * recording order. Each command is an opcode followed by a trivially copyable payload, packed back
+ * to back into arena chunks, so recording a command does not allocate once the stream has warmed
+ * up. reset() keeps the chunks for the next recording.
+ *
+ * A stream is recorded by one thread at a time and makes no GL calls.
+ */
+class CommandStream final {
+ public:
+  static constexpr size_t kChunkSize = 16u * 1024u;
+
+  /// Appends a command with `size` bytes of payload and returns the payload to be filled in. The
+  /// payload is aligned to 8 bytes and stays valid until reset()
+  void* append(uint32_t opcode, size_t size);
+
+  /// Keeps `object` alive until reset() and returns the index to pass to getObject()
+  uint32_t retain(std::shared_ptr<void> object);
+
+  template<typename T>
+  std::shared_ptr<T> getObject(uint32_t index) const {
+    IGL_ASSERT(index < objects_.size());
+    return std::static_pointer_cast<T>(objects_[index]);
+  }
+
+  /// Calls `func(opcode, payload, size)` for every command in recording order
+  template<typename Func>
+  void forEach(Func&& func) const {
+    for (const auto& chunk : chunks_) {
+      size_t offset = 0;
+      while (offset < chunk.used) {
+        Header header;
+        memcpy(&header, chunk.data.get() + offset, sizeof(Header));
+        func(header.opcode, chunk.data.get() + offset + sizeof(Header), header.size);
+        offset += sizeof(Header) + alignSize(header.size);
+      }
+    }
+  }
+
+  bool empty() const {
+    return chunks_.empty() || chunks_[0].used == 0;
+  }
+
+  /// Drops all commands and retained objects, but keeps the chunks
+  void reset();
+
+ private:
+  struct Header {
+    uint32_t opcode;
+    uint32_t size;
+  };
+
+  struct Chunk {
+    std::unique_ptr<uint8_t[]> data;
+    size_t capacity = 0;
+    size_t used = 0;
+  };
+
+  static constexpr size_t alignSize(size_t size) {
+    return (size + 7u) & ~size_t(7u);
+  }
+
+ private:
+  // chunks after currentChunk_ are empty and recycled by append()
+  std::vector<Chunk> chunks_;
+  size_t currentChunk_ = 0;
+  std::vector<std::shared_ptr<void>> objects_;
+};
+
+} // namespace opengl
+} // namespace igl
@@ -41,20 +41,31 @@ void ComputeCommandAdapter::setTexture(ITexture* texture, size_t index) {
     return;
   }
   textureStates_[index] = texture;
-  SET_DIRTY(textureStatesDirty_, index);
+  if (boundTextures_[index] != texture) {
+    SET_DIRTY(textureStatesDirty_, index);
+  }
 }
 
 void ComputeCommandAdapter::clearBuffers() {
   buffersDirty_.reset();
 }
 
-void ComputeCommandAdapter::setBuffer(std::shared_ptr<Buffer> buffer, size_t offset, int index) {
+void ComputeCommandAdapter::setBuffer(const std::shared_ptr<IBuffer>& buffer,
+                                      size_t offset,
+                                      int index) {
   IGL_ASSERT_MSG(index >= 0, "Invalid index passed to setVertexBuffer");
   IGL_ASSERT_MSG(index < IGL_VERTEX_BUFFER_MAX,
                  "Buffer index is beyond max, may want to increase limit");
   if (index >= 0 && index < uniformAdapter_.getMaxUniforms() && buffer) {
-    buffers_[index] = {std::move(buffer), offset};
-    SET_DIRTY(buffersDirty_, index);
+    // glBindBufferBase binds the whole buffer, the offset doesn't change the binding
+    if (boundBuffers_[index] != buffer.get()) {
+      SET_DIRTY(buffersDirty_, index);
+    }
+    BufferState& bufferState = buffers_[index];
+    if (bufferState.resource != buffer) {
+      bufferState.resource = std::static_pointer_cast<Buffer>(buffer);
+    }
+    bufferState.offset = offset;
   }
 }
 
@@ -68,7 +79,11 @@ void ComputeCommandAdapter::setUniform(const UniformDesc& uniformDesc,
   uniformAdapter_.setUniform(uniformDesc, data, outResult);
 }
 
-void ComputeCommandAdapter::setBlockUniform(const std::shared_ptr<Buffer>& buffer,
+void ComputeCommandAdapter::setPushConstants(size_t offset, const void* data, size_t length) {
+  pushConstants_.set(offset, data, length);
+}
+
+void ComputeCommandAdapter::setBlockUniform(const std::shared_ptr<IBuffer>& buffer,
                                             size_t offset,
                                             int index,
                                             Result* outResult) {
@@ -84,17 +99,35 @@ void ComputeCommandAdapter::dispatchThreadGroups(const Dimensions& threadgroupCo
   didDispatch();
 }
 
+void ComputeCommandAdapter::dispatchThreadGroupsIndirect(Buffer& indirectBuffer,
+                                                         size_t indirectBufferOffset) {
+  willDispatch();
+  // reading the thread group counts written by a previous dispatch needs its own barrier bit
+  if (std::find(unsyncedStorageBuffers_.begin(), unsyncedStorageBuffers_.end(), &indirectBuffer) !=
+      unsyncedStorageBuffers_.end()) {
+    getContext().memoryBarrier(GL_COMMAND_BARRIER_BIT);
+  }
+  auto& arrayBuffer = static_cast<ArrayBuffer&>(indirectBuffer);
+  arrayBuffer.bindForTarget(GL_DISPATCH_INDIRECT_BUFFER);
+  getContext().dispatchComputeIndirect(static_cast<GLintptr>(indirectBufferOffset));
+  didDispatch();
+}
+
 void ComputeCommandAdapter::setPipelineState(
     const std::shared_ptr<IComputePipelineState>& newValue) {
+  if (newValue == pipelineState_) {
+    return;
+  }
   if (pipelineState_) {
-    clearDependentResources(newValue);
+    clearDependentResources(newValue.get());
   }
   pipelineState_ = newValue;
   setDirty(StateMask::PIPELINE);
+  // the binding points of the resources depend on the pipeline
+  resetBindings();
 }
 
-void ComputeCommandAdapter::clearDependentResources(
-    const std::shared_ptr<IComputePipelineState>& newValue) {}
+void ComputeCommandAdapter::clearDependentResources(IComputePipelineState* newValue) {}
 
 void ComputeCommandAdapter::willDispatch() {
   Result ret;
@@ -105,6 +138,8 @@ void ComputeCommandAdapter::willDispatch() {
     return;
   }
 
+  insertDispatchBarriers();
+
   for (size_t bufferIndex = 0; bufferIndex < IGL_VERTEX_BUFFER_MAX; ++bufferIndex) {
     if (!IS_DIRTY(buffersDirty_, bufferIndex)) {
       continue;
@@ -116,6 +151,7 @@ void ComputeCommandAdapter::willDispatch() {
       IGL_LOG_INFO_ONCE(ret.message.c_str());
       continue;
     }
+    boundBuffers_[bufferIndex] = bufferState.resource.get();
   }
 
   if (isDirty(StateMask::PIPELINE)) {
@@ -124,7 +160,12 @@ void ComputeCommandAdapter::willDispatch() {
   }
 
   // Bind uniforms to be used for compute
-  uniformAdapter_.bindToPipeline(getContext());
+  uniformAdapter_.bindToPipeline(getContext(), pipelineState->getShaderStages());
+  if (pushConstants_.hasData() && pipelineState->getShaderStages()->usesPushConstants()) {
+    if (auto* pushConstantRing = getContext().getPushConstantRing()) {
+      pushConstants_.bind(*pushConstantRing);
+    }
+  }
 
   for (size_t index = 0; index < textureStates_.size(); index++) {
     if (!IS_DIRTY(textureStatesDirty_, index)) {
@@ -138,12 +179,66 @@ void ComputeCommandAdapter::willDispatch() {
         IGL_LOG_INFO_ONCE(ret.message.c_str());
         continue;
       }
+      boundTextures_[index] = texture;
+    }
+  }
+}
+
+void ComputeCommandAdapter::insertDispatchBarriers() {
+  // A single barrier bit covers the writes to all resources of its kind, so only the kinds of the
+  // resources which were written since and are used again need one
+  GLbitfield barriers = 0;
+  if (!unsyncedStorageBuffers_.empty()) {
+    for (const auto& bufferState : buffers_) {
+      if (bufferState.resource &&
+          std::find(unsyncedStorageBuffers_.begin(),
+                    unsyncedStorageBuffers_.end(),
+                    bufferState.resource.get()) != unsyncedStorageBuffers_.end()) {
+        barriers |= GL_SHADER_STORAGE_BARRIER_BIT;
+        unsyncedStorageBuffers_.clear();
+        break;
+      }
+    }
+  }
+  if (!unsyncedImages_.empty()) {
+    for (const auto* texture : textureStates_) {
+      if (texture && std::find(unsyncedImages_.begin(), unsyncedImages_.end(), texture) !=
+                         unsyncedImages_.end()) {
+        barriers |= GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+        unsyncedImages_.clear();
+        break;
+      }
+    }
+  }
+  if (barriers != 0) {
+    getContext().memoryBarrier(barriers);
+  }
+}
+
+void ComputeCommandAdapter::resetBindings() {
+  boundBuffers_.fill(nullptr);
+  boundTextures_.fill(nullptr);
+  for (size_t index = 0; index < buffers_.size(); ++index) {
+    if (buffers_[index].resource) {
+      SET_DIRTY(buffersDirty_, index);
+    }
+  }
+  for (size_t index = 0; index < textureStates_.size(); ++index) {
+    if (textureStates_[index]) {
+      SET_DIRTY(textureStatesDirty_, index);
     }
   }
 }
 
 void ComputeCommandAdapter::didDispatch() {
-  getContext().memoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+  // Barriers are deferred until a later dispatch or the end of the pass uses the written resources
+  for (const auto* texture : textureStates_) {
+    if (texture && std::find(unsyncedImages_.begin(), unsyncedImages_.end(), texture) ==
+                       unsyncedImages_.end()) {
+      unsyncedImages_.push_back(texture);
+    }
+    hasImageWrites_ = hasImageWrites_ || texture != nullptr;
+  }
 
   if (pipelineState_ == nullptr) {
     return;
@@ -154,21 +249,51 @@ void ComputeCommandAdapter::didDispatch() {
     return;
   }
   if (pipelineState->getIsUsingShaderStorageBuffers()) {
-    getContext().memoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT |
-                               GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    for (const auto& bufferState : buffers_) {
+      const Buffer* buffer = bufferState.resource.get();
+      if (buffer && std::find(unsyncedStorageBuffers_.begin(),
+                              unsyncedStorageBuffers_.end(),
+                              buffer) == unsyncedStorageBuffers_.end()) {
+        unsyncedStorageBuffers_.push_back(buffer);
+      }
+    }
+    hasBufferWrites_ = true;
   }
 }
 
 void ComputeCommandAdapter::endEncoding() {
+  // The commands after the pass may consume the writes in any way
+  GLbitfield barriers = 0;
+  if (hasImageWrites_) {
+    barriers |= GL_TEXTURE_FETCH_BARRIER_BIT;
+  }
+  if (hasBufferWrites_) {
+    barriers |= GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT |
+                GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT |
+                GL_COMMAND_BARRIER_BIT;
+  }
+  if (barriers != 0) {
+    getContext().memoryBarrier(barriers);
+  }
+  unsyncedStorageBuffers_.clear();
+  unsyncedImages_.clear();
+  hasBufferWrites_ = false;
+  hasImageWrites_ = false;
+
   pipelineState_ = nullptr;
   textureStates_ = TextureStates();
+  buffers_.fill({});
 
   buffersDirty_.reset();
   textureStatesDirty_.reset();
   dirtyStateBits_ = EnumToValue(StateMask::NONE);
+  // the GL bindings may change before the next compute pass
+  boundBuffers_.fill(nullptr);
+  boundTextures_.fill(nullptr);
 
   uniformAdapter_.shrinkUniformUsage();
   uniformAdapter_.clearUniformBuffers();
+  pushConstants_.clear();
 }
 
 } // namespace opengl
@@ -12,10 +12,12 @@
 #include <functional>
 #include <igl/Buffer.h>
 #include <igl/Common.h>
+#include <igl/opengl/PushConstantBlock.h>
 #include <igl/opengl/UnbindPolicy.h>
 #include <igl/opengl/UniformAdapter.h>
 #include <igl/opengl/WithContext.h>
 #include <unordered_map>
+#include <vector>
 
 namespace igl {
 
@@ -31,9 +33,11 @@ class ComputeCommandAdapter final : public WithContext {
   using StateBits = uint8_t;
   enum class StateMask : StateBits { NONE = 0, PIPELINE = 1 << 1 };
 
+  // The bound buffers and the pipeline are owned by the adapter. They are only assigned when a
+  // different object is bound, so rebinding the same object does not touch reference counts.
   struct BufferState {
     std::shared_ptr<Buffer> resource;
-    size_t offset;
+    size_t offset = 0;
   };
 
   using TextureState = ITexture*;
@@ -46,25 +50,31 @@ class ComputeCommandAdapter final : public WithContext {
   void setTexture(ITexture* texture, size_t index);
 
   void clearBuffers();
-  void setBuffer(std::shared_ptr<Buffer> buffer, size_t offset, int index);
+  void setBuffer(const std::shared_ptr<IBuffer>& buffer, size_t offset, int index);
 
   void clearUniformBuffers();
-  void setBlockUniform(const std::shared_ptr<Buffer>& buffer,
+  void setBlockUniform(const std::shared_ptr<IBuffer>& buffer,
                        size_t offset,
                        int index,
                        Result* outResult = nullptr);
   void setUniform(const UniformDesc& uniformDesc, const void* data, Result* outResult = nullptr);
+  void setPushConstants(size_t offset, const void* data, size_t length);
 
   void setPipelineState(const std::shared_ptr<IComputePipelineState>& newValue);
   void dispatchThreadGroups(const Dimensions& threadgroupCount,
                             const Dimensions& /*threadgroupSize*/);
+  void dispatchThreadGroupsIndirect(Buffer& indirectBuffer, size_t indirectBufferOffset);
 
   void endEncoding();
 
  private:
-  void clearDependentResources(const std::shared_ptr<IComputePipelineState>& newValue);
+  void clearDependentResources(IComputePipelineState* newValue);
   void willDispatch();
   void didDispatch();
+  // Issues the barriers needed before the next dispatch reads or writes the bound resources
+  void insertDispatchBarriers();
+  // Forgets which resources are bound, e.g. because the GL state may have been changed since
+  void resetBindings();
 
   bool isDirty(StateMask mask) const {
     return (dirtyStateBits_ & EnumToValue(mask)) != 0;
@@ -82,8 +92,23 @@ class ComputeCommandAdapter final : public WithContext {
   std::bitset<IGL_TEXTURE_SAMPLERS_MAX> textureStatesDirty_;
   TextureStates textureStates_;
   UniformAdapter uniformAdapter_;
+  PushConstantBlock pushConstants_;
   StateBits dirtyStateBits_ = EnumToValue(StateMask::NONE);
   std::shared_ptr<IComputePipelineState> pipelineState_;
+
+  // Shadow of the resources bound to the GL binding points of the current pipeline, used to skip
+  // redundant binds. nullptr when unknown.
+  std::array<const Buffer*, IGL_VERTEX_BUFFER_MAX> boundBuffers_{};
+  std::array<const ITexture*, IGL_TEXTURE_SAMPLERS_MAX> boundTextures_{};
+
+  // Hazard tracking: resources written by dispatches since the last barrier making these writes
+  // visible to later dispatches. All bound storage buffers and images are treated as written.
+  std::vector<const Buffer*> unsyncedStorageBuffers_;
+  std::vector<const ITexture*> unsyncedImages_;
+  // Whether dispatches of this encoder wrote storage buffers or images, which endEncoding() makes
+  // visible to the commands following the compute pass
+  bool hasBufferWrites_ = false;
+  bool hasImageWrites_ = false;
 };
 } // namespace opengl
 } // namespace igl
@@ -25,7 +25,9 @@ namespace opengl {
 ///----------------------------------------------------------------------------
 /// MARK: - ComputeCommandEncoder
 
-ComputeCommandEncoder::ComputeCommandEncoder(IContext& context) : WithContext(context) {
+ComputeCommandEncoder::ComputeCommandEncoder(std::shared_ptr<ICommandBuffer> commandBuffer,
+                                             IContext& context) :
+  IComputeCommandEncoder(std::move(commandBuffer)), WithContext(context) {
   auto& oglContext = getContext();
 
   auto& pool = oglContext.getComputeAdapterPool();
@@ -43,12 +45,14 @@ void ComputeCommandEncoder::endEncoding() {
   if (IGL_VERIFY(adapter_)) {
     adapter_->endEncoding();
     getContext().getComputeAdapterPool().push_back(std::move(adapter_));
+    getContext().checkErrorsAtPassEnd("ComputeCommandEncoder::endEncoding");
   }
 }
 
 void ComputeCommandEncoder::bindComputePipelineState(
     const std::shared_ptr<IComputePipelineState>& pipelineState) {
   if (IGL_VERIFY(adapter_)) {
+    getCommandBuffer().incrementStatistic(CommandBufferCounter::PipelineBinds);
     adapter_->setPipelineState(pipelineState);
   }
 }
@@ -56,10 +60,22 @@ void ComputeCommandEncoder::bindComputePipelineState(
 void ComputeCommandEncoder::dispatchThreadGroups(const Dimensions& threadgroupCount,
                                                  const Dimensions& threadgroupSize) {
   if (IGL_VERIFY(adapter_)) {
+    getCommandBuffer().incrementStatistic(CommandBufferCounter::Dispatches);
     adapter_->dispatchThreadGroups(threadgroupCount, threadgroupSize);
   }
 }
 
+void ComputeCommandEncoder::dispatchThreadGroupsIndirect(IBuffer& indirectBuffer,
+                                                         size_t indirectBufferOffset,
+                                                         const Dimensions& /*threadgroupSize*/) {
+  IGL_ASSERT_MSG(indirectBufferOffset % 4 == 0, "indirectBufferOffset must be a multiple of 4");
+  if (IGL_VERIFY(adapter_)) {
+    getCommandBuffer().incrementStatistic(CommandBufferCounter::Dispatches);
+    adapter_->dispatchThreadGroupsIndirect(static_cast<Buffer&>(indirectBuffer),
+                                           indirectBufferOffset);
+  }
+}
+
 void ComputeCommandEncoder::pushDebugGroupLabel(const std::string& label,
                                                 const igl::Color& /*color*/) const {
   IGL_ASSERT(!label.empty());
@@ -87,6 +103,10 @@ void ComputeCommandEncoder::bindUniform(const UniformDesc& uniformDesc, const vo
                  uniformDesc.location);
   IGL_ASSERT_MSG(data != nullptr, "Data cannot be null");
   if (IGL_VERIFY(adapter_) && data) {
+    getCommandBuffer().incrementStatistic(CommandBufferCounter::BindingUpdates);
+    getCommandBuffer().incrementStatistic(
+        CommandBufferCounter::UploadedBytes,
+        sizeForUniformType(uniformDesc.type) * uniformDesc.numElements);
     adapter_->setUniform(uniformDesc, data);
   }
 }
@@ -101,8 +121,7 @@ void ComputeCommandEncoder::bindBuffer(size_t index,
                                        const std::shared_ptr<IBuffer>& buffer,
                                        size_t offset) {
   if (IGL_VERIFY(adapter_) && buffer) {
-    auto glBuffer = std::static_pointer_cast<Buffer>(buffer);
-    adapter_->setBuffer(glBuffer, offset, static_cast<int>(index));
+    adapter_->setBuffer(buffer, offset, static_cast<int>(index));
   }
 }
 
@@ -110,10 +129,10 @@ void ComputeCommandEncoder::bindBytes(size_t /*index*/, const void* /*data*/, si
   IGL_ASSERT_NOT_IMPLEMENTED();
 }
 
-void ComputeCommandEncoder::bindPushConstants(size_t /*offset*/,
-                                              const void* /*data*/,
-                                              size_t /*length*/) {
-  IGL_ASSERT_NOT_IMPLEMENTED();
+void ComputeCommandEncoder::bindPushConstants(size_t offset, const void* data, size_t length) {
+  if (IGL_VERIFY(adapter_)) {
+    adapter_->setPushConstants(offset, data, length);
+  }
 }
 
 } // namespace opengl
@@ -27,7 +27,7 @@ class ComputeCommandAdapter;
 
 class ComputeCommandEncoder final : public IComputeCommandEncoder, public WithContext {
  public:
-  explicit ComputeCommandEncoder(IContext& context);
+  ComputeCommandEncoder(std::shared_ptr<ICommandBuffer> commandBuffer, IContext& context);
   ~ComputeCommandEncoder() override;
   void bindComputePipelineState(
       const std::shared_ptr<IComputePipelineState>& pipelineState) override;
@@ -36,6 +36,9 @@ class ComputeCommandEncoder final : public IComputeCommandEncoder, public WithCo
   // total number of threads per grid is threadgroupCount * threadgroupSize
   void dispatchThreadGroups(const Dimensions& threadgroupCount,
                             const Dimensions& threadgroupSize) override;
+  void dispatchThreadGroupsIndirect(IBuffer& indirectBuffer,
+                                    size_t indirectBufferOffset,
+                                    const Dimensions& threadgroupSize) override;
   void endEncoding() override;
 
   void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
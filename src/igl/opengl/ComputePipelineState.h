@@ -39,6 +39,10 @@ class ComputePipelineState final : public WithContext, public IComputePipelineSt
 
   int getIndexByName(const NameHandle& name) const override;
 
+  ShaderStages* getShaderStages() const {
+    return shaderStages_.get();
+  }
+
   bool getIsUsingShaderStorageBuffers() {
     return usingShaderStorageBuffers_;
   }
@@ -0,0 +1,497 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/DeferredRenderCommandEncoder.h>
+
+#include <igl/Buffer.h>
+#include <igl/DepthStencilState.h>
+#include <igl/RenderPipelineState.h>
+#include <igl/SamplerState.h>
+#include <igl/opengl/CommandStream.h>
+#include <igl/opengl/RenderBundle.h>
+#include <type_traits>
+
+namespace igl {
+namespace opengl {
+
+namespace {
+
+enum class Opcode : uint32_t {
+  PushDebugGroupLabel,
+  InsertDebugEventLabel,
+  PopDebugGroupLabel,
+  BindViewport,
+  BindScissorRect,
+  BindRenderPipelineState,
+  BindDepthStencilState,
+  BindUniform,
+  BindPushConstants,
+  BindBuffer,
+  BindSamplerState,
+  BindTexture,
+  Draw,
+  DrawIndexed,
+  DrawIndexedIndirect,
+  SetStencilReferenceValue,
+  SetStencilReferenceValues,
+  SetBlendColor,
+  SetDepthBias,
+  BeginOcclusionQuery,
+  EndOcclusionQuery,
+};
+
+struct BindUniformCmd {
+  int location;
+  UniformType type;
+  size_t numElements;
+  size_t elementStride;
+  // followed by the uniform data
+};
+
+struct BindPushConstantsCmd {
+  size_t offset;
+  size_t length;
+  // followed by the push constant data
+};
+
+struct BindBufferCmd {
+  int index;
+  uint8_t target;
+  uint32_t buffer;
+  size_t offset;
+};
+
+struct BindSamplerStateCmd {
+  size_t index;
+  uint8_t target;
+  uint32_t samplerState;
+};
+
+struct BindTextureCmd {
+  size_t index;
+  uint8_t target;
+  ITexture* texture;
+};
+
+struct DrawCmd {
+  PrimitiveType primitiveType;
+  size_t vertexStart;
+  size_t vertexCount;
+  uint32_t instanceCount;
+};
+
+struct DrawIndexedCmd {
+  PrimitiveType primitiveType;
+  size_t indexCount;
+  IndexFormat indexFormat;
+  IBuffer* indexBuffer;
+  size_t indexBufferOffset;
+  uint32_t instanceCount;
+};
+
+struct DrawIndexedIndirectCmd {
+  PrimitiveType primitiveType;
+  IndexFormat indexFormat;
+  IBuffer* indexBuffer;
+  IBuffer* indirectBuffer;
+  size_t indirectBufferOffset;
+};
+
+struct StencilReferenceValuesCmd {
+  uint32_t frontValue;
+  uint32_t backValue;
+};
+
+struct BlendColorCmd {
+  float r;
+  float g;
+  float b;
+  float a;
+};
+
+struct DepthBiasCmd {
+  float depthBias;
+  float slopeScale;
+  float clamp;
+};
+
+template<typename T>
+void record(CommandStream& stream, Opcode opcode, const T& payload) {
+  static_assert(std::is_trivially_copyable<T>::value, "Payloads are copied as bytes");
+  memcpy(stream.append(static_cast<uint32_t>(opcode), sizeof(T)), &payload, sizeof(T));
+}
+
+template<typename T>
+T read(const uint8_t* payload) {
+  T value;
+  memcpy(&value, payload, sizeof(T));
+  return value;
+}
+
+} // namespace
+
+DeferredRenderCommandEncoder::DeferredRenderCommandEncoder(
+    std::shared_ptr<ICommandBuffer> commandBuffer,
+    CommandStream& stream) :
+  IRenderCommandEncoder(std::move(commandBuffer)), stream_(stream) {}
+
+void DeferredRenderCommandEncoder::replay(const CommandStream& stream,
+                                          IRenderCommandEncoder& encoder) {
+  stream.forEach([&stream, &encoder](uint32_t opcode, const uint8_t* payload, size_t size) {
+    switch (static_cast<Opcode>(opcode)) {
+    case Opcode::PushDebugGroupLabel:
+      encoder.pushDebugGroupLabel(std::string(reinterpret_cast<const char*>(payload), size));
+      break;
+    case Opcode::InsertDebugEventLabel:
+      encoder.insertDebugEventLabel(std::string(reinterpret_cast<const char*>(payload), size));
+      break;
+    case Opcode::PopDebugGroupLabel:
+      encoder.popDebugGroupLabel();
+      break;
+    case Opcode::BindViewport:
+      encoder.bindViewport(read<Viewport>(payload));
+      break;
+    case Opcode::BindScissorRect:
+      encoder.bindScissorRect(read<ScissorRect>(payload));
+      break;
+    case Opcode::BindRenderPipelineState:
+      encoder.bindRenderPipelineState(
+          stream.getObject<IRenderPipelineState>(read<uint32_t>(payload)));
+      break;
+    case Opcode::BindDepthStencilState:
+      encoder.bindDepthStencilState(stream.getObject<IDepthStencilState>(read<uint32_t>(payload)));
+      break;
+    case Opcode::BindUniform: {
+      const auto cmd = read<BindUniformCmd>(payload);
+      UniformDesc desc;
+      desc.location = cmd.location;
+      desc.type = cmd.type;
+      desc.numElements = cmd.numElements;
+      desc.elementStride = cmd.elementStride;
+      encoder.bindUniform(desc, payload + sizeof(BindUniformCmd));
+      break;
+    }
+    case Opcode::BindPushConstants: {
+      const auto cmd = read<BindPushConstantsCmd>(payload);
+      encoder.bindPushConstants(cmd.offset, payload + sizeof(BindPushConstantsCmd), cmd.length);
+      break;
+    }
+    case Opcode::BindBuffer: {
+      const auto cmd = read<BindBufferCmd>(payload);
+      encoder.bindBuffer(
+          cmd.index, cmd.target, stream.getObject<IBuffer>(cmd.buffer), cmd.offset);
+      break;
+    }
+    case Opcode::BindSamplerState: {
+      const auto cmd = read<BindSamplerStateCmd>(payload);
+      encoder.bindSamplerState(
+          cmd.index, cmd.target, stream.getObject<ISamplerState>(cmd.samplerState));
+      break;
+    }
+    case Opcode::BindTexture: {
+      const auto cmd = read<BindTextureCmd>(payload);
+      encoder.bindTexture(cmd.index, cmd.target, cmd.texture);
+      break;
+    }
+    case Opcode::Draw: {
+      const auto cmd = read<DrawCmd>(payload);
+      encoder.drawInstanced(
+          cmd.primitiveType, cmd.vertexStart, cmd.vertexCount, cmd.instanceCount);
+      break;
+    }
+    case Opcode::DrawIndexed: {
+      const auto cmd = read<DrawIndexedCmd>(payload);
+      encoder.drawIndexedInstanced(cmd.primitiveType,
+                                   cmd.indexCount,
+                                   cmd.indexFormat,
+                                   *cmd.indexBuffer,
+                                   cmd.indexBufferOffset,
+                                   cmd.instanceCount);
+      break;
+    }
+    case Opcode::DrawIndexedIndirect: {
+      const auto cmd = read<DrawIndexedIndirectCmd>(payload);
+      encoder.drawIndexedIndirect(cmd.primitiveType,
+                                  cmd.indexFormat,
+                                  *cmd.indexBuffer,
+                                  *cmd.indirectBuffer,
+                                  cmd.indirectBufferOffset);
+      break;
+    }
+    case Opcode::SetStencilReferenceValue:
+      encoder.setStencilReferenceValue(read<uint32_t>(payload));
+      break;
+    case Opcode::SetStencilReferenceValues: {
+      const auto cmd = read<StencilReferenceValuesCmd>(payload);
+      encoder.setStencilReferenceValues(cmd.frontValue, cmd.backValue);
+      break;
+    }
+    case Opcode::SetBlendColor: {
+      const auto cmd = read<BlendColorCmd>(payload);
+      encoder.setBlendColor(Color(cmd.r, cmd.g, cmd.b, cmd.a));
+      break;
+    }
+    case Opcode::SetDepthBias: {
+      const auto cmd = read<DepthBiasCmd>(payload);
+      encoder.setDepthBias(cmd.depthBias, cmd.slopeScale, cmd.clamp);
+      break;
+    }
+    case Opcode::BeginOcclusionQuery:
+      encoder.beginOcclusionQuery(read<uint32_t>(payload));
+      break;
+    case Opcode::EndOcclusionQuery:
+      encoder.endOcclusionQuery();
+      break;
+    }
+  });
+}
+
+void DeferredRenderCommandEncoder::endEncoding() {
+  IGL_ASSERT(isEncoding_);
+  isEncoding_ = false;
+}
+
+void DeferredRenderCommandEncoder::recordLabel(uint32_t opcode, const std::string& label) const {
+  IGL_ASSERT(isEncoding_);
+  IGL_ASSERT(!label.empty());
+  memcpy(stream_.append(opcode, label.length()), label.data(), label.length());
+}
+
+void DeferredRenderCommandEncoder::pushDebugGroupLabel(const std::string& label,
+                                                       const igl::Color& /*color*/) const {
+  recordLabel(static_cast<uint32_t>(Opcode::PushDebugGroupLabel), label);
+}
+
+void DeferredRenderCommandEncoder::insertDebugEventLabel(const std::string& label,
+                                                         const igl::Color& /*color*/) const {
+  recordLabel(static_cast<uint32_t>(Opcode::InsertDebugEventLabel), label);
+}
+
+void DeferredRenderCommandEncoder::popDebugGroupLabel() const {
+  IGL_ASSERT(isEncoding_);
+  stream_.append(static_cast<uint32_t>(Opcode::PopDebugGroupLabel), 0);
+}
+
+void DeferredRenderCommandEncoder::bindViewport(const Viewport& viewport) {
+  IGL_ASSERT(isEncoding_);
+  record(stream_, Opcode::BindViewport, viewport);
+}
+
+void DeferredRenderCommandEncoder::bindScissorRect(const ScissorRect& rect) {
+  IGL_ASSERT(isEncoding_);
+  record(stream_, Opcode::BindScissorRect, rect);
+}
+
+void DeferredRenderCommandEncoder::bindRenderPipelineState(
+    const std::shared_ptr<IRenderPipelineState>& pipelineState) {
+  IGL_ASSERT(isEncoding_);
+  record(stream_, Opcode::BindRenderPipelineState, stream_.retain(pipelineState));
+}
+
+void DeferredRenderCommandEncoder::bindDepthStencilState(
+    const std::shared_ptr<IDepthStencilState>& depthStencilState) {
+  IGL_ASSERT(isEncoding_);
+  record(stream_, Opcode::BindDepthStencilState, stream_.retain(depthStencilState));
+}
+
+void DeferredRenderCommandEncoder::bindUniform(const UniformDesc& uniformDesc, const void* data) {
+  IGL_ASSERT_MSG(uniformDesc.location >= 0,
+                 "Invalid location passed to bindUniformBuffer: %d",
+                 uniformDesc.location);
+  IGL_ASSERT_MSG(data != nullptr, "Data cannot be null");
+  IGL_ASSERT(isEncoding_);
+  if (!data) {
+    return;
+  }
+
+  // the same range UniformAdapter::setUniform() reads
+  const size_t length = (uniformDesc.elementStride != 0 ? uniformDesc.elementStride
+                                                        : sizeForUniformType(uniformDesc.type)) *
+                        uniformDesc.numElements;
+
+  const BindUniformCmd cmd = {
+      uniformDesc.location, uniformDesc.type, uniformDesc.numElements, uniformDesc.elementStride};
+  auto* payload = static_cast<uint8_t*>(
+      stream_.append(static_cast<uint32_t>(Opcode::BindUniform), sizeof(cmd) + length));
+  memcpy(payload, &cmd, sizeof(cmd));
+  memcpy(payload + sizeof(cmd), static_cast<const uint8_t*>(data) + uniformDesc.offset, length);
+}
+
+void DeferredRenderCommandEncoder::bindBuffer(int index,
+                                              uint8_t target,
+                                              const std::shared_ptr<IBuffer>& buffer,
+                                              size_t bufferOffset) {
+  IGL_ASSERT_MSG(index >= 0, "Invalid index passed to bindBuffer: %d", index);
+  IGL_ASSERT(isEncoding_);
+  if (buffer) {
+    record(stream_,
+           Opcode::BindBuffer,
+           BindBufferCmd{index, target, stream_.retain(buffer), bufferOffset});
+  }
+}
+
+void DeferredRenderCommandEncoder::bindBytes(size_t /*index*/,
+                                             uint8_t /*target*/,
+                                             const void* /*data*/,
+                                             size_t /*length*/) {
+  IGL_ASSERT_NOT_IMPLEMENTED();
+}
+
+void DeferredRenderCommandEncoder::bindPushConstants(size_t offset,
+                                                     const void* data,
+                                                     size_t length) {
+  IGL_ASSERT_MSG(data != nullptr, "Data cannot be null");
+  IGL_ASSERT(isEncoding_);
+  if (!data || length == 0) {
+    return;
+  }
+
+  const BindPushConstantsCmd cmd = {offset, length};
+  auto* payload = static_cast<uint8_t*>(
+      stream_.append(static_cast<uint32_t>(Opcode::BindPushConstants), sizeof(cmd) + length));
+  memcpy(payload, &cmd, sizeof(cmd));
+  memcpy(payload + sizeof(cmd), data, length);
+}
+
+void DeferredRenderCommandEncoder::bindSamplerState(
+    size_t index,
+    uint8_t target,
+    const std::shared_ptr<ISamplerState>& samplerState) {
+  IGL_ASSERT(isEncoding_);
+  record(stream_,
+         Opcode::BindSamplerState,
+         BindSamplerStateCmd{index, target, stream_.retain(samplerState)});
+}
+
+void DeferredRenderCommandEncoder::bindTexture(size_t index, uint8_t target, ITexture* texture) {
+  IGL_ASSERT(isEncoding_);
+  record(stream_, Opcode::BindTexture, BindTextureCmd{index, target, texture});
+}
+
+void DeferredRenderCommandEncoder::draw(PrimitiveType primitiveType,
+                                        size_t vertexStart,
+                                        size_t vertexCount) {
+  drawInstanced(primitiveType, vertexStart, vertexCount, 1);
+}
+
+void DeferredRenderCommandEncoder::drawIndexed(PrimitiveType primitiveType,
+                                               size_t indexCount,
+                                               IndexFormat indexFormat,
+                                               IBuffer& indexBuffer,
+                                               size_t indexBufferOffset) {
+  drawIndexedInstanced(primitiveType, indexCount, indexFormat, indexBuffer, indexBufferOffset, 1);
+}
+
+void DeferredRenderCommandEncoder::drawInstanced(PrimitiveType primitiveType,
+                                                 size_t vertexStart,
+                                                 size_t vertexCount,
+                                                 uint32_t instanceCount) {
+  IGL_ASSERT(isEncoding_);
+  // the draw count is incremented by the replay
+  record(stream_, Opcode::Draw, DrawCmd{primitiveType, vertexStart, vertexCount, instanceCount});
+}
+
+void DeferredRenderCommandEncoder::drawIndexedInstanced(PrimitiveType primitiveType,
+                                                        size_t indexCount,
+                                                        IndexFormat indexFormat,
+                                                        IBuffer& indexBuffer,
+                                                        size_t indexBufferOffset,
+                                                        uint32_t instanceCount) {
+  IGL_ASSERT(isEncoding_);
+  record(stream_,
+         Opcode::DrawIndexed,
+         DrawIndexedCmd{primitiveType,
+                        indexCount,
+                        indexFormat,
+                        &indexBuffer,
+                        indexBufferOffset,
+                        instanceCount});
+}
+
+void DeferredRenderCommandEncoder::drawIndexedIndirect(PrimitiveType primitiveType,
+                                                       IndexFormat indexFormat,
+                                                       IBuffer& indexBuffer,
+                                                       IBuffer& indirectBuffer,
+                                                       size_t indirectBufferOffset) {
+  IGL_ASSERT(isEncoding_);
+  record(stream_,
+         Opcode::DrawIndexedIndirect,
+         DrawIndexedIndirectCmd{
+             primitiveType, indexFormat, &indexBuffer, &indirectBuffer, indirectBufferOffset});
+}
+
+void DeferredRenderCommandEncoder::multiDrawIndirect(PrimitiveType /*primitiveType*/,
+                                                     IBuffer& /*indirectBuffer*/,
+                                                     size_t /*indirectBufferOffset*/,
+                                                     uint32_t /*drawCount*/,
+                                                     uint32_t /*stride*/) {
+  IGL_ASSERT_NOT_IMPLEMENTED();
+}
+
+void DeferredRenderCommandEncoder::multiDrawIndexedIndirect(PrimitiveType /*primitiveType*/,
+                                                            IndexFormat /*indexFormat*/,
+                                                            IBuffer& /*indexBuffer*/,
+                                                            IBuffer& /*indirectBuffer*/,
+                                                            size_t /*indirectBufferOffset*/,
+                                                            uint32_t /*drawCount*/,
+                                                            uint32_t /*stride*/) {
+  IGL_ASSERT_NOT_IMPLEMENTED();
+}
+
+void DeferredRenderCommandEncoder::multiDrawIndexedIndirectCount(
+    PrimitiveType /*primitiveType*/,
+    IndexFormat /*indexFormat*/,
+    IBuffer& /*indexBuffer*/,
+    IBuffer& /*indirectBuffer*/,
+    size_t /*indirectBufferOffset*/,
+    IBuffer& /*countBuffer*/,
+    size_t /*countBufferOffset*/,
+    uint32_t /*maxDrawCount*/,
+    uint32_t /*stride*/) {
+  IGL_ASSERT_NOT_IMPLEMENTED();
+}
+
+void DeferredRenderCommandEncoder::setStencilReferenceValue(uint32_t value) {
+  IGL_ASSERT(isEncoding_);
+  record(stream_, Opcode::SetStencilReferenceValue, value);
+}
+
+void DeferredRenderCommandEncoder::setStencilReferenceValues(uint32_t frontValue,
+                                                             uint32_t backValue) {
+  IGL_ASSERT(isEncoding_);
+  record(stream_,
+         Opcode::SetStencilReferenceValues,
+         StencilReferenceValuesCmd{frontValue, backValue});
+}
+
+void DeferredRenderCommandEncoder::setBlendColor(Color color) {
+  IGL_ASSERT(isEncoding_);
+  record(stream_, Opcode::SetBlendColor, BlendColorCmd{color.r, color.g, color.b, color.a});
+}
+
+void DeferredRenderCommandEncoder::setDepthBias(float depthBias, float slopeScale, float clamp) {
+  IGL_ASSERT(isEncoding_);
+  record(stream_, Opcode::SetDepthBias, DepthBiasCmd{depthBias, slopeScale, clamp});
+}
+
+void DeferredRenderCommandEncoder::beginOcclusionQuery(uint32_t query) {
+  IGL_ASSERT(isEncoding_);
+  record(stream_, Opcode::BeginOcclusionQuery, query);
+}
+
+void DeferredRenderCommandEncoder::endOcclusionQuery() {
+  IGL_ASSERT(isEncoding_);
+  stream_.append(static_cast<uint32_t>(Opcode::EndOcclusionQuery), 0);
+}
+
+void DeferredRenderCommandEncoder::executeRenderBundle(const IRenderBundle& bundle) {
+  IGL_ASSERT(isEncoding_);
+  static_cast<const RenderBundle&>(bundle).replay(*this);
+}
+
+} // namespace opengl
+} // namespace igl
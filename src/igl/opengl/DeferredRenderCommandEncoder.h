@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/Common.h>
+#include <igl/RenderCommandEncoder.h>
+
+namespace igl {
+namespace opengl {
+
+class CommandStream;
+
+/**
+ * @brief Records render commands into a CommandStream instead of issuing GL calls, so it can be
+ * used on threads without a current GL context. replay() issues the recorded commands into a
+ * RenderCommandEncoder on the context thread, see ParallelRenderCommandEncoder.
+ *
+ * Pipeline, depth stencil, sampler and buffer objects are retained by the stream and uniform values
+ * are copied into it. Textures and the index and indirect buffers of draws are referenced by raw
+ * pointer, so they have to stay alive until the owning command buffer has been submitted.
+ */
+class DeferredRenderCommandEncoder final : public IRenderCommandEncoder {
+ public:
+  DeferredRenderCommandEncoder(std::shared_ptr<ICommandBuffer> commandBuffer,
+                               CommandStream& stream);
+  ~DeferredRenderCommandEncoder() override = default;
+
+  /// Issues the commands of `stream` into `encoder`
+  static void replay(const CommandStream& stream, IRenderCommandEncoder& encoder);
+
+  void endEncoding() override;
+
+  void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
+  void insertDebugEventLabel(const std::string& label, const igl::Color& color) const override;
+  void popDebugGroupLabel() const override;
+
+  void bindViewport(const Viewport& viewport) override;
+  void bindScissorRect(const ScissorRect& rect) override;
+
+  void bindRenderPipelineState(const std::shared_ptr<IRenderPipelineState>& pipelineState) override;
+  void bindDepthStencilState(const std::shared_ptr<IDepthStencilState>& depthStencilState) override;
+
+  void bindUniform(const UniformDesc& uniformDesc, const void* data) override;
+  void bindBuffer(int index,
+                  uint8_t target,
+                  const std::shared_ptr<IBuffer>& buffer,
+                  size_t bufferOffset) override;
+  void bindBytes(size_t index, uint8_t target, const void* data, size_t length) override;
+  void bindPushConstants(size_t offset, const void* data, size_t length) override;
+  void bindSamplerState(size_t index,
+                        uint8_t target,
+                        const std::shared_ptr<ISamplerState>& samplerState) override;
+  void bindTexture(size_t index, uint8_t target, ITexture* texture) override;
+
+  void draw(PrimitiveType primitiveType, size_t vertexStart, size_t vertexCount) override;
+  void drawIndexed(PrimitiveType primitiveType,
+                   size_t indexCount,
+                   IndexFormat indexFormat,
+                   IBuffer& indexBuffer,
+                   size_t indexBufferOffset) override;
+  void drawInstanced(PrimitiveType primitiveType,
+                     size_t vertexStart,
+                     size_t vertexCount,
+                     uint32_t instanceCount) override;
+  void drawIndexedInstanced(PrimitiveType primitiveType,
+                            size_t indexCount,
+                            IndexFormat indexFormat,
+                            IBuffer& indexBuffer,
+                            size_t indexBufferOffset,
+                            uint32_t instanceCount) override;
+  void drawIndexedIndirect(PrimitiveType primitiveType,
+                           IndexFormat indexFormat,
+                           IBuffer& indexBuffer,
+                           IBuffer& indirectBuffer,
+                           size_t indirectBufferOffset) override;
+  void multiDrawIndirect(PrimitiveType primitiveType,
+                         IBuffer& indirectBuffer,
+                         size_t indirectBufferOffset,
+                         uint32_t drawCount,
+                         uint32_t stride) override;
+  void multiDrawIndexedIndirect(PrimitiveType primitiveType,
+                                IndexFormat indexFormat,
+                                IBuffer& indexBuffer,
+                                IBuffer& indirectBuffer,
+                                size_t indirectBufferOffset,
+                                uint32_t drawCount,
+                                uint32_t stride) override;
+  void multiDrawIndexedIndirectCount(PrimitiveType primitiveType,
+                                     IndexFormat indexFormat,
+                                     IBuffer& indexBuffer,
+                                     IBuffer& indirectBuffer,
+                                     size_t indirectBufferOffset,
+                                     IBuffer& countBuffer,
+                                     size_t countBufferOffset,
+                                     uint32_t maxDrawCount,
+                                     uint32_t stride) override;
+
+  void setStencilReferenceValue(uint32_t value) override;
+  void setStencilReferenceValues(uint32_t frontValue, uint32_t backValue) override;
+  void setBlendColor(Color color) override;
+  void setDepthBias(float depthBias, float slopeScale, float clamp) override;
+
+  void beginOcclusionQuery(uint32_t query) override;
+  void endOcclusionQuery() override;
+
+  // copies the commands of the bundle into the stream
+  void executeRenderBundle(const IRenderBundle& bundle) override;
+
+ private:
+  void recordLabel(uint32_t opcode, const std::string& label) const;
+
+ private:
+  CommandStream& stream_;
+  bool isEncoding_ = true;
+};
+
+} // namespace opengl
+} // namespace igl
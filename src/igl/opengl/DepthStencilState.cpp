@@ -44,15 +44,6 @@ GLenum DepthStencilState::convertCompareFunction(igl::CompareFunction value) {
   IGL_UNREACHABLE_RETURN(GL_ALWAYS);
 }
 
-void DepthStencilState::setStencilReferenceValue(uint32_t value) {
-  desc_.backFaceStencil.readMask = desc_.frontFaceStencil.readMask = value;
-}
-
-void DepthStencilState::setStencilReferenceValues(uint32_t frontValue, uint32_t backValue) {
-  desc_.backFaceStencil.readMask = backValue;
-  desc_.frontFaceStencil.readMask = frontValue;
-}
-
 GLenum DepthStencilState::convertStencilOperation(igl::StencilOperation value) {
   switch (value) {
   case StencilOperation::Keep:
@@ -76,6 +67,10 @@ GLenum DepthStencilState::convertStencilOperation(igl::StencilOperation value) {
 }
 
 void DepthStencilState::bind() {
+  bind(desc_.frontFaceStencil.readMask, desc_.backFaceStencil.readMask);
+}
+
+void DepthStencilState::bind(uint32_t frontReferenceValue, uint32_t backReferenceValue) {
   getContext().depthMask(desc_.isDepthWriteEnabled);
 
   // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glDepthFunc.xhtml
@@ -92,10 +87,8 @@ void DepthStencilState::bind() {
     GLuint mask{0xff};
     GLenum frontCompareFunc = convertCompareFunction(desc_.frontFaceStencil.stencilCompareFunction);
     GLenum backCompareFunc = convertCompareFunction(desc_.backFaceStencil.stencilCompareFunction);
-    getContext().stencilFuncSeparate(
-        GL_FRONT, frontCompareFunc, desc_.frontFaceStencil.readMask, mask);
-    getContext().stencilFuncSeparate(
-        GL_BACK, backCompareFunc, desc_.backFaceStencil.readMask, mask);
+    getContext().stencilFuncSeparate(GL_FRONT, frontCompareFunc, frontReferenceValue, mask);
+    getContext().stencilFuncSeparate(GL_BACK, backCompareFunc, backReferenceValue, mask);
 
     GLenum sfail = convertStencilOperation(desc_.backFaceStencil.stencilFailureOperation);
     GLenum dpfail = convertStencilOperation(desc_.backFaceStencil.depthFailureOperation);
@@ -26,14 +26,14 @@ class DepthStencilState final : public WithContext, public IDepthStencilState {
 
   Result create(const DepthStencilStateDesc& desc);
   void bind();
+  // The stencil reference values belong to the encoder: this object is shared by everyone
+  // creating a depth stencil state with the same descriptor
+  void bind(uint32_t frontReferenceValue, uint32_t backReferenceValue);
   void unbind();
 
   static GLenum convertCompareFunction(igl::CompareFunction value);
   static GLenum convertStencilOperation(igl::StencilOperation value);
 
-  void setStencilReferenceValue(uint32_t value);
-  void setStencilReferenceValues(uint32_t frontValue, uint32_t backValue);
-
  private:
   DepthStencilStateDesc desc_;
 };
@@ -18,11 +18,15 @@
 #include <igl/opengl/Errors.h>
 #include <igl/opengl/Framebuffer.h>
 #include <igl/opengl/IContext.h>
+#include <igl/opengl/QueryPool.h>
+#include <igl/opengl/RenderBundle.h>
 #include <igl/opengl/RenderPipelineState.h>
+#include <igl/opengl/RingBuffer.h>
 #include <igl/opengl/SamplerState.h>
 #include <igl/opengl/Shader.h>
 #include <igl/opengl/TextureBuffer.h>
 #include <igl/opengl/TextureTarget.h>
+#include <igl/opengl/Timer.h>
 #include <igl/opengl/UniformBuffer.h>
 #include <igl/opengl/VertexInputState.h>
 
@@ -89,11 +93,37 @@ std::unique_ptr<T> createUniqueResource(const Desc& desc,
       desc, outResult, std::forward<Params>(constructorParams)...);
 }
 
+// Pipeline states need a linked program. Waits if the driver still links it in the background
+bool finishLink(const std::shared_ptr<IShaderStages>& shaderStages, Result* outResult) {
+  if (!shaderStages) {
+    return true;
+  }
+  Result result = static_cast<ShaderStages&>(*shaderStages).finishLink();
+  if (!result.isOk()) {
+    IGL_ASSERT_MSG(0, result.message.c_str());
+    Result::setResult(outResult, std::move(result));
+    return false;
+  }
+  return true;
+}
+
+bool isLinkComplete(const std::shared_ptr<IShaderStages>& shaderStages) {
+  return !shaderStages || static_cast<const ShaderStages&>(*shaderStages).isLinkComplete();
+}
+
 } // namespace
 
 Device::Device(std::unique_ptr<IContext> context) :
   context_(std::move(context)), deviceFeatureSet_(getContext().deviceFeatures()) {}
-Device::~Device() = default;
+Device::~Device() {
+  // these make GL calls, which IContext cannot do in its destructor
+  context_->enableAsyncTextureUploads(false);
+  context_->enableVertexArrayCache(false);
+  context_->enablePackedUniforms(false);
+  context_->enableBindlessTextures(false);
+  context_->releasePushConstantRing();
+  context_->releaseSubmitFences();
+}
 
 // debug markers useful in GPU captures
 void Device::pushMarker(int len, const char* name) {
@@ -124,7 +154,10 @@ std::unique_ptr<IBuffer> Device::createBuffer(const BufferDesc& desc,
   if (resource) {
     resource->initialize(desc, outResult);
     if (getResourceTracker()) {
-      resource->initResourceTracker(getResourceTracker());
+      resource->initResourceTracker(getResourceTracker(),
+                                    {resource->getSizeInBytes(),
+                                     toResourceMemoryLocation(resource->storage()),
+                                     desc.debugName});
     }
   } else {
     Result::setResult(outResult, Result::Code::RuntimeError, "Could not instantiate buffer.");
@@ -136,7 +169,9 @@ std::unique_ptr<IBuffer> Device::createBuffer(const BufferDesc& desc,
 std::shared_ptr<IDepthStencilState> Device::createDepthStencilState(
     const DepthStencilStateDesc& desc,
     Result* outResult) const {
-  return createSharedResource<DepthStencilState>(desc, outResult, getContext());
+  return depthStencilStates_.getOrCreate(desc, outResult, [&](Result* result) {
+    return createSharedResource<DepthStencilState>(desc, result, getContext());
+  });
 }
 
 std::shared_ptr<ISamplerState> Device::createSamplerState(const SamplerStateDesc& desc,
@@ -184,7 +219,10 @@ std::shared_ptr<ITexture> Device::createTexture(const TextureDesc& desc,
     if (!result.isOk()) {
       texture = nullptr;
     } else if (getResourceTracker()) {
-      texture->initResourceTracker(getResourceTracker());
+      texture->initResourceTracker(getResourceTracker(),
+                                   {texture->getEstimatedSizeInBytes(),
+                                    toResourceMemoryLocation(sanitized.storage),
+                                    desc.debugName});
     }
 
     Result::setResult(outResult, std::move(result));
@@ -198,21 +236,80 @@ std::shared_ptr<ITexture> Device::createTexture(const TextureDesc& desc,
 
 std::shared_ptr<IVertexInputState> Device::createVertexInputState(const VertexInputStateDesc& desc,
                                                                   Result* outResult) const {
-  return createSharedResource<VertexInputState>(desc, outResult);
+  return vertexInputStates_.getOrCreate(desc, outResult, [&](Result* result) {
+    return createSharedResource<VertexInputState>(desc, result);
+  });
 }
 
 // Pipelines
 std::shared_ptr<IRenderPipelineState> Device::createRenderPipeline(const RenderPipelineDesc& desc,
                                                                    Result* outResult) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  if (!finishLink(desc.shaderStages, outResult)) {
+    return nullptr;
+  }
   return createSharedResource<RenderPipelineState>(desc, outResult, getContext());
 }
 
 std::shared_ptr<IComputePipelineState> Device::createComputePipeline(
     const ComputePipelineDesc& desc,
     Result* outResult) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  if (!finishLink(desc.shaderStages, outResult)) {
+    return nullptr;
+  }
   return createSharedResource<ComputePipelineState>(desc, outResult, getContext());
 }
 
+void Device::createComputePipelineAsync(const ComputePipelineDesc& desc,
+                                        ComputePipelineCompletionHandler completionHandler) const {
+  processPendingPipelines();
+
+  if (isLinkComplete(desc.shaderStages)) {
+    IDevice::createComputePipelineAsync(desc, std::move(completionHandler));
+    return;
+  }
+
+  pendingComputePipelines_.push_back({desc, std::move(completionHandler)});
+}
+
+void Device::createRenderPipelineAsync(const RenderPipelineDesc& desc,
+                                       RenderPipelineCompletionHandler completionHandler) const {
+  processPendingPipelines();
+
+  if (isLinkComplete(desc.shaderStages)) {
+    IDevice::createRenderPipelineAsync(desc, std::move(completionHandler));
+    return;
+  }
+
+  pendingRenderPipelines_.push_back({desc, std::move(completionHandler)});
+}
+
+void Device::processPendingPipelines() const {
+  // GL objects can only be created on the context thread, so the pipeline states whose programs
+  // have been linked are created here
+  for (size_t i = 0; i < pendingComputePipelines_.size();) {
+    if (isLinkComplete(pendingComputePipelines_[i].desc.shaderStages)) {
+      PendingComputePipeline pending = std::move(pendingComputePipelines_[i]);
+      pendingComputePipelines_.erase(pendingComputePipelines_.begin() + i);
+      IDevice::createComputePipelineAsync(pending.desc, std::move(pending.completionHandler));
+    } else {
+      i++;
+    }
+  }
+  for (size_t i = 0; i < pendingRenderPipelines_.size();) {
+    if (isLinkComplete(pendingRenderPipelines_[i].desc.shaderStages)) {
+      PendingRenderPipeline pending = std::move(pendingRenderPipelines_[i]);
+      pendingRenderPipelines_.erase(pendingRenderPipelines_.begin() + i);
+      IDevice::createRenderPipelineAsync(pending.desc, std::move(pending.completionHandler));
+    } else {
+      i++;
+    }
+  }
+}
+
 // Shaders
 
 std::unique_ptr<igl::IShaderLibrary> Device::createShaderLibrary(const ShaderLibraryDesc& /*desc*/,
@@ -233,6 +330,8 @@ std::shared_ptr<IShaderModule> Device::createShaderModule(const ShaderModuleDesc
 
 std::unique_ptr<IShaderStages> Device::createShaderStages(const ShaderStagesDesc& desc,
                                                           Result* outResult) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
   // Need to pass desc twice.
   // The first instance is for the createUniqueResource pattern.
   // The second instance is so it also gets passed to the ShaderStages constructor.
@@ -243,6 +342,57 @@ std::unique_ptr<IShaderStages> Device::createShaderStages(const ShaderStagesDesc
   return stages;
 }
 
+std::shared_ptr<ITimer> Device::createTimer(Result* outResult) const noexcept {
+  if (!deviceFeatureSet_.hasFeature(DeviceFeatures::Timers)) {
+    Result::setResult(outResult, Result::Code::Unsupported, "Timer queries are not supported");
+    return nullptr;
+  }
+  Result::setOk(outResult);
+  return std::make_shared<Timer>(getContext());
+}
+
+std::shared_ptr<IQueryPool> Device::createQueryPool(const QueryPoolDesc& desc,
+                                                    Result* outResult) const noexcept {
+  if (desc.type != QueryType::Occlusion ||
+      !deviceFeatureSet_.hasFeature(DeviceFeatures::OcclusionQueries)) {
+    Result::setResult(outResult, Result::Code::Unsupported, "Query type is not supported");
+    return nullptr;
+  }
+  if (desc.queryCount == 0) {
+    Result::setResult(outResult, Result::Code::ArgumentInvalid, "Query count cannot be zero");
+    return nullptr;
+  }
+  Result::setOk(outResult);
+  return std::make_shared<QueryPool>(getContext(), desc);
+}
+
+std::shared_ptr<IRenderBundle> Device::createRenderBundle(Result* outResult) const noexcept {
+  Result::setOk(outResult);
+  return std::make_shared<RenderBundle>();
+}
+
+std::unique_ptr<IRingBuffer> Device::createRingBuffer(const RingBufferDesc& desc,
+                                                      Result* outResult) const noexcept {
+  const bool hasBufferStorage =
+      deviceFeatureSet_.hasInternalFeature(InternalFeatures::BufferStorage);
+  const bool hasUniformBlocks = !(desc.type & BufferDesc::BufferTypeBits::Uniform) ||
+                                deviceFeatureSet_.hasFeature(DeviceFeatures::UniformBlocks);
+  if (!hasBufferStorage || !hasUniformBlocks ||
+      !deviceFeatureSet_.hasInternalFeature(InternalFeatures::Sync)) {
+    Result::setResult(
+        outResult, Result::Code::Unsupported, "Persistently mapped buffers are not supported");
+    return nullptr;
+  }
+  Result result;
+  auto ringBuffer = std::make_unique<RingBuffer>(getContext(), desc, &result);
+  if (!result.isOk()) {
+    Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+  Result::setOk(outResult);
+  return ringBuffer;
+}
+
 std::shared_ptr<IFramebuffer> Device::createFramebuffer(const FramebufferDesc& desc,
                                                         Result* outResult) {
   IGL_ASSERT(deviceFeatureSet_.hasInternalFeature(InternalFeatures::FramebufferObject));
@@ -279,6 +429,8 @@ void Device::beginScope() {
 
   // UnbindPolicy is fixed for duration of this scope
   cachedUnbindPolicy_ = getContext().getUnbindPolicy();
+
+  processPendingPipelines();
 }
 
 void Device::endScope() {
@@ -295,7 +447,8 @@ void Device::endScope() {
   IDevice::endScope();
 
   // Clear current context, if we are supposed to.
-  if (cachedUnbindPolicy_ == UnbindPolicy::ClearContext && !verifyScope()) {
+  // Only the outermost scope clears the context. Checking the depth avoids querying the context.
+  if (cachedUnbindPolicy_ == UnbindPolicy::ClearContext && !IDevice::verifyScope()) {
     context_->clearCurrentContext();
   }
 }
@@ -304,7 +457,12 @@ void Device::updateSurface(void* nativeWindowType) {}
 
 bool Device::verifyScope() {
   IGL_ASSERT(context_);
+#if IGL_DEBUG
   return IDevice::verifyScope() && context_->isCurrentContext();
+#else
+  // Release builds only track the scope depth: querying the current context is a platform call
+  return IDevice::verifyScope();
+#endif
 }
 
 size_t Device::getCurrentDrawCount() const {
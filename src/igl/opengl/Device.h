@@ -9,12 +9,18 @@
 
 #include <cstdio>
 #include <cstring>
+#include <igl/ComputePipelineState.h>
+#include <igl/DepthStencilState.h>
 #include <igl/Device.h>
+#include <igl/RenderPipelineState.h>
+#include <igl/StateObjectCache.h>
+#include <igl/VertexInputState.h>
 #include <igl/opengl/DeviceFeatureSet.h>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/IContext.h>
 #include <igl/opengl/PlatformDevice.h>
 #include <igl/opengl/UnbindPolicy.h>
+#include <vector>
 
 namespace igl {
 namespace opengl {
@@ -57,6 +63,14 @@ class Device : public IDevice {
   std::shared_ptr<IRenderPipelineState> createRenderPipeline(const RenderPipelineDesc& desc,
                                                              Result* outResult) const override;
 
+  // With GL_KHR_parallel_shader_compile, the pipeline state is created once the driver has linked
+  // the program in the background. Pending pipelines are checked by every call of these functions
+  // and at the beginning of every device scope. Handlers are invoked on the context thread.
+  void createComputePipelineAsync(const ComputePipelineDesc& desc,
+                                  ComputePipelineCompletionHandler completionHandler) const override;
+  void createRenderPipelineAsync(const RenderPipelineDesc& desc,
+                                 RenderPipelineCompletionHandler completionHandler) const override;
+
   // Shaders
   std::unique_ptr<IShaderLibrary> createShaderLibrary(const ShaderLibraryDesc& desc,
                                                       Result* outResult) const override;
@@ -67,6 +81,16 @@ class Device : public IDevice {
   std::unique_ptr<IShaderStages> createShaderStages(const ShaderStagesDesc& desc,
                                                     Result* outResult) const override;
 
+  std::shared_ptr<ITimer> createTimer(Result* outResult) const noexcept override;
+
+  std::shared_ptr<IQueryPool> createQueryPool(const QueryPoolDesc& desc,
+                                              Result* outResult) const noexcept override;
+
+  std::shared_ptr<IRenderBundle> createRenderBundle(Result* outResult) const noexcept override;
+
+  std::unique_ptr<IRingBuffer> createRingBuffer(const RingBufferDesc& desc,
+                                                Result* outResult) const noexcept override;
+
   std::shared_ptr<IFramebuffer> createFramebuffer(const FramebufferDesc& desc,
                                                   Result* outResult) override;
 
@@ -103,6 +127,23 @@ class Device : public IDevice {
   }
 
  private:
+  void processPendingPipelines() const;
+
+ private:
+  struct PendingComputePipeline {
+    ComputePipelineDesc desc;
+    ComputePipelineCompletionHandler completionHandler;
+  };
+  struct PendingRenderPipeline {
+    RenderPipelineDesc desc;
+    RenderPipelineCompletionHandler completionHandler;
+  };
+  mutable std::vector<PendingComputePipeline> pendingComputePipelines_;
+  mutable std::vector<PendingRenderPipeline> pendingRenderPipelines_;
+  // equal descriptors share one state object, see StateObjectCache
+  mutable StateObjectCache<DepthStencilStateDesc, IDepthStencilState> depthStencilStates_;
+  mutable StateObjectCache<VertexInputStateDesc, IVertexInputState> vertexInputStates_;
+
   GLint defaultFrameBufferID_;
   GLint defaultFrameBufferWidth_;
   GLint defaultFrameBufferHeight_;
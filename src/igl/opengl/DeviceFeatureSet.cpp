@@ -10,6 +10,7 @@
 #include <igl/Common.h>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/IContext.h>
+#include <igl/opengl/PushConstantBlock.h>
 #include <igl/opengl/Texture.h>
 
 namespace igl::opengl {
@@ -88,6 +89,20 @@ bool hasDesktopOrESExtension(const DeviceFeatureSet& dfs,
 bool hasDesktopOrESExtension(const DeviceFeatureSet& dfs, const char* extension) {
   return hasDesktopOrESExtension(dfs, extension, extension);
 }
+
+// Resolves every bit of `bits` with `isSupported` and returns whether any of them has changed
+template<typename Enum, size_t N, typename Func>
+bool resolveBits(std::bitset<N>& bits, Func&& isSupported) {
+  bool changed = false;
+  for (size_t i = 0; i != N; i++) {
+    const bool supported = isSupported(static_cast<Enum>(i));
+    if (bits[i] != supported) {
+      bits[i] = supported;
+      changed = true;
+    }
+  }
+  return changed;
+}
 } // namespace
 
 bool DeviceFeatureSet::usesOpenGLES() noexcept {
@@ -98,16 +113,48 @@ bool DeviceFeatureSet::usesOpenGLES() noexcept {
 #endif
 }
 
-DeviceFeatureSet::DeviceFeatureSet(IContext& glContext) : glContext_(glContext) {}
+DeviceFeatureSet::DeviceFeatureSet(IContext& glContext) : glContext_(glContext) {
+  resolveCapabilities();
+}
 
 void DeviceFeatureSet::initializeVersion(GLVersion version) {
   version_ = version;
+  resolveCapabilities();
 }
 
 void DeviceFeatureSet::initializeExtensions(std::string extensions,
                                             std::unordered_set<std::string> supportedExtensions) {
   extensions_ = std::move(extensions);
   supportedExtensions_ = std::move(supportedExtensions);
+  resolveCapabilities();
+}
+
+void DeviceFeatureSet::resolveCapabilities() {
+  // The is*Supported() functions query each other through the bitsets. Their dependencies have no
+  // cycles, so re-resolving everything until nothing changes yields the same result as resolving
+  // each value after its dependencies. This takes as many passes as the longest dependency chain.
+  extensionBits_.reset();
+  featureBits_.reset();
+  internalFeatureBits_.reset();
+  textureFeatureBits_.reset();
+  textureCapabilityCache_.clear();
+
+  constexpr size_t kMaxPasses = 8;
+  for (size_t pass = 0; pass != kMaxPasses; pass++) {
+    bool changed = false;
+    changed |= resolveBits<Extensions>(
+        extensionBits_, [this](Extensions e) { return isExtensionSupported(e); });
+    changed |= resolveBits<InternalFeatures>(
+        internalFeatureBits_, [this](InternalFeatures f) { return isInternalFeatureSupported(f); });
+    changed |= resolveBits<DeviceFeatures>(
+        featureBits_, [this](DeviceFeatures f) { return isFeatureSupported(f); });
+    changed |= resolveBits<TextureFeatures>(
+        textureFeatureBits_, [this](TextureFeatures f) { return isTextureFeatureSupported(f); });
+    if (!changed) {
+      return;
+    }
+  }
+  IGL_ASSERT_MSG(false, "Device feature dependencies must not form a cycle");
 }
 
 GLVersion DeviceFeatureSet::getGLVersion() const noexcept {
@@ -118,6 +165,10 @@ ShaderVersion DeviceFeatureSet::getShaderVersion() const {
   return ::igl::opengl::getShaderVersion(version_);
 }
 
+bool DeviceFeatureSet::hasFunction(GLFunction function) const {
+  return glContext_.getDispatchTable().isAvailable(function);
+}
+
 bool DeviceFeatureSet::isSupported(const std::string& extensionName) const {
   if (!extensions_.empty()) {
     return extensions_.find(extensionName) != std::string::npos;
@@ -134,6 +185,8 @@ bool DeviceFeatureSet::isExtensionSupported(Extensions extension) const {
     return hasDesktopExtension(*this, "GL_ARB_bindless_texture");
   case Extensions::BindlessTextureNv:
     return hasDesktopOrESExtension(*this, "GL_NV_bindless_texture");
+  case Extensions::BufferStorage:
+    return hasESExtension(*this, "GL_EXT_buffer_storage");
   case Extensions::Debug:
     return hasDesktopOrESExtension(*this, "GL_KHR_debug");
   case Extensions::DebugMarker:
@@ -166,10 +219,17 @@ bool DeviceFeatureSet::isExtensionSupported(Extensions extension) const {
     return hasESExtension(*this, "GL_EXT_multisampled_render_to_texture");
   case Extensions::MultiSampleImg:
     return hasESExtension(*this, "GL_IMG_multisampled_render_to_texture");
+  case Extensions::OcclusionQueryBoolean:
+    return hasESExtension(*this, "GL_EXT_occlusion_query_boolean");
+  case Extensions::ParallelShaderCompile:
+    return isSupported("GL_KHR_parallel_shader_compile") ||
+           isSupported("GL_ARB_parallel_shader_compile");
   case Extensions::RequiredInternalFormat:
     return hasESExtension(*this, "GL_OES_required_internalformat");
   case Extensions::ShaderImageLoadStore:
     return hasESExtension(*this, "GL_EXT_shader_image_load_store");
+  case Extensions::ShadingRate:
+    return hasESExtension(*this, "GL_QCOM_shading_rate");
   case Extensions::Srgb:
     return hasESExtension(*this, "GL_EXT_sRGB");
   case Extensions::SrgbWriteControl:
@@ -197,6 +257,8 @@ bool DeviceFeatureSet::isExtensionSupported(Extensions extension) const {
     return hasDesktopExtension(*this, "GL_EXT_texture_sRGB");
   case Extensions::TextureType2_10_10_10_Rev:
     return hasESExtension(*this, "GL_EXT_texture_type_2_10_10_10_REV");
+  case Extensions::TimerQuery:
+    return hasESExtension(*this, "GL_EXT_disjoint_timer_query");
   case Extensions::VertexArrayObject:
     return hasESExtension(*this, "GL_OES_vertex_array_object");
   }
@@ -318,8 +380,14 @@ bool DeviceFeatureSet::isFeatureSupported(DeviceFeatures feature) const {
   case DeviceFeatures::ExplicitBindingExt:
     return hasDesktopExtension(*this, "GL_ARB_shading_language_420pack");
 
+  case DeviceFeatures::FramebufferFetch:
+    // the fetches of the coherent extension need no barriers; shaders read gl_LastFragData or
+    // inout color outputs
+    return isSupported("GL_EXT_shader_framebuffer_fetch");
+
   case DeviceFeatures::PushConstants:
-    return false;
+    // emulated with a uniform block, see PushConstantBlock
+    return hasFeature(DeviceFeatures::UniformBlocks);
 
   case DeviceFeatures::BufferDeviceAddress:
     return false;
@@ -328,18 +396,36 @@ bool DeviceFeatureSet::isFeatureSupported(DeviceFeatures feature) const {
     return hasDesktopOrESVersion(*this, GLVersion::v3_0, GLVersion::v3_0_ES) &&
            isSupported("GL_OVR_multiview2");
 
+  case DeviceFeatures::OcclusionQueries:
+    return hasInternalFeature(InternalFeatures::OcclusionQuery);
+
+  case DeviceFeatures::PipelineStatisticsQueries:
+    return false;
+
   case DeviceFeatures::TexturePartialMipChain:
     return hasDesktopOrESVersion(*this, GLVersion::v2_0, GLVersion::v3_0_ES) ||
            hasESExtension(*this, "GL_APPLE_texture_max_level");
 
+  case DeviceFeatures::TextureViews:
+    return false;
+
   case DeviceFeatures::BindUniform:
     return true;
   case DeviceFeatures::BufferRing:
     return false;
+  case DeviceFeatures::MultiDrawIndirectCount:
+    return false;
+  case DeviceFeatures::SparseTextures:
+    return false;
+  case DeviceFeatures::ShadingRate:
+    return hasExtension(Extensions::ShadingRate);
   case DeviceFeatures::BufferNoCopy:
     return false;
   case DeviceFeatures::ShaderLibrary:
     return false;
+  // GLSL has no 16-bit types, mediump only lets drivers lower the precision of 32-bit ones
+  case DeviceFeatures::ShaderFloat16:
+    return false;
   case DeviceFeatures::BindBytes:
     return false;
   case DeviceFeatures::SRGB:
@@ -358,6 +444,13 @@ bool DeviceFeatureSet::isFeatureSupported(DeviceFeatures feature) const {
     return hasDesktopOrESVersionOrExtension(
         *this, GLVersion::v4_0, GLVersion::v3_1_ES, "GL_ARB_draw_indirect");
 
+  case DeviceFeatures::DrawInstanced:
+    // glVertexAttribDivisor() is core since OpenGL 3.3
+    return hasDesktopOrESVersion(*this, GLVersion::v3_3, GLVersion::v3_0_ES);
+
+  case DeviceFeatures::Timers:
+    return hasInternalFeature(InternalFeatures::TimerQuery);
+
   case DeviceFeatures::ValidationLayersEnabled:
     return false;
   }
@@ -367,13 +460,26 @@ bool DeviceFeatureSet::isFeatureSupported(DeviceFeatures feature) const {
 
 bool DeviceFeatureSet::isInternalFeatureSupported(InternalFeatures feature) const {
   switch (feature) {
+  case InternalFeatures::BufferStorage:
+    return hasDesktopVersionOrExtension(*this, GLVersion::v4_4, "GL_ARB_buffer_storage") ||
+           hasExtension(Extensions::BufferStorage);
+
   case InternalFeatures::ClearDepthf:
     return hasDesktopOrESVersion(*this, GLVersion::v4_1, GLVersion::v2_0_ES);
 
+  case InternalFeatures::CopyBuffer:
+    return hasDesktopOrESVersion(*this, GLVersion::v3_1, GLVersion::v3_0_ES);
+
+  case InternalFeatures::CopyImage:
+    return hasDesktopOrESVersion(*this, GLVersion::v4_3, GLVersion::v3_2_ES);
+
   case InternalFeatures::Debug:
     return hasDesktopOrESVersion(*this, GLVersion::v4_3, GLVersion::v3_2_ES) ||
            hasExtension(Extensions::Debug) || hasExtension(Extensions::DebugMarker);
 
+  case InternalFeatures::EGLImage:
+    return isSupported("GL_OES_EGL_image");
+
   case InternalFeatures::FramebufferBlit:
     // TODO: Add support for GL_ANGLE_framebuffer_blit
     return hasDesktopOrESVersionOrExtension(
@@ -395,6 +501,10 @@ bool DeviceFeatureSet::isInternalFeatureSupported(InternalFeatures feature) cons
   case InternalFeatures::MapBuffer:
     return hasDesktopVersion(*this, GLVersion::v2_0) || hasExtension(Extensions::MapBuffer);
 
+  case InternalFeatures::OcclusionQuery:
+    return hasDesktopOrESVersion(*this, GLVersion::v2_0, GLVersion::v3_0_ES) ||
+           hasExtension(Extensions::OcclusionQueryBoolean);
+
   case InternalFeatures::PixelBufferObject:
     return hasDesktopOrESVersionOrExtension(*this,
                                             GLVersion::v2_1,
@@ -405,6 +515,10 @@ bool DeviceFeatureSet::isInternalFeatureSupported(InternalFeatures feature) cons
   case InternalFeatures::PolygonFillMode:
     return hasDesktopVersion(*this, GLVersion::v2_0);
 
+  case InternalFeatures::ProgramBinary:
+    return hasDesktopOrESVersionOrExtension(
+        *this, GLVersion::v4_1, GLVersion::v3_0_ES, "GL_ARB_get_program_binary");
+
   case InternalFeatures::ProgramInterfaceQuery:
     return hasDesktopOrESVersion(*this, GLVersion::v4_3, GLVersion::v3_1_ES) ||
            hasDesktopExtension(*this, "GL_ARB_program_interface_query");
@@ -416,11 +530,19 @@ bool DeviceFeatureSet::isInternalFeatureSupported(InternalFeatures feature) cons
     return hasDesktopOrESVersion(*this, GLVersion::v3_2, GLVersion::v3_0_ES) ||
            hasDesktopExtension(*this, "GL_ARB_sync") || hasExtension(Extensions::Sync);
 
+  case InternalFeatures::TimerQuery:
+    return hasDesktopVersionOrExtension(*this, GLVersion::v3_3, "GL_ARB_timer_query") ||
+           hasExtension(Extensions::TimerQuery);
+
   case InternalFeatures::TexStorage:
     return hasDesktopOrESVersionOrExtension(
                *this, GLVersion::v4_2, GLVersion::v3_0_ES, "GL_ARB_texture_storage") ||
            hasExtension(Extensions::TexStorage);
 
+  case InternalFeatures::TexStorageMultisample:
+    return hasDesktopOrESVersion(*this, GLVersion::v4_3, GLVersion::v3_1_ES) ||
+           hasDesktopExtension(*this, "GL_ARB_texture_storage_multisample");
+
   case InternalFeatures::ShaderImageLoadStore:
     return hasDesktopOrESVersion(*this, GLVersion::v4_2, GLVersion::v3_1_ES) ||
            hasDesktopExtension(*this, "GL_ARB_shader_image_load_store") ||
@@ -743,62 +865,6 @@ bool DeviceFeatureSet::isTextureFeatureSupported(TextureFeatures feature) const
   return false;
 }
 
-bool DeviceFeatureSet::hasExtension(Extensions extension) const {
-  const uint64_t extensionIndex = static_cast<uint64_t>(extension);
-  IGL_ASSERT(extensionIndex < 64);
-  const uint64_t extensionBit = 1ull << extensionIndex;
-  if ((extensionCacheInitialized_ & extensionBit) == 0) {
-    if (isExtensionSupported(extension)) {
-      extensionCache_ |= extensionBit;
-    }
-    extensionCacheInitialized_ |= extensionBit;
-  }
-
-  return (extensionCache_ & extensionBit) != 0;
-}
-
-bool DeviceFeatureSet::hasFeature(DeviceFeatures feature) const {
-  const uint64_t featureIndex = static_cast<uint64_t>(feature);
-  IGL_ASSERT(featureIndex < 64);
-  const uint64_t featureBit = 1ull << featureIndex;
-  if ((featureCacheInitialized_ & featureBit) == 0) {
-    if (isFeatureSupported(feature)) {
-      featureCache_ |= featureBit;
-    }
-    featureCacheInitialized_ |= featureBit;
-  }
-
-  return (featureCache_ & featureBit) != 0;
-}
-
-bool DeviceFeatureSet::hasInternalFeature(InternalFeatures feature) const {
-  const uint32_t featureIndex = static_cast<uint32_t>(feature);
-  IGL_ASSERT(featureIndex < 32);
-  const uint32_t featureBit = 1u << featureIndex;
-  if ((internalFeatureCacheInitialized_ & featureBit) == 0) {
-    if (isInternalFeatureSupported(feature)) {
-      internalFeatureCache_ |= featureBit;
-    }
-    internalFeatureCacheInitialized_ |= featureBit;
-  }
-
-  return (internalFeatureCache_ & featureBit) != 0;
-}
-
-bool DeviceFeatureSet::hasTextureFeature(TextureFeatures feature) const {
-  const uint64_t featureIndex = static_cast<uint64_t>(feature);
-  IGL_ASSERT(featureIndex < 64);
-  const uint64_t featureBit = 1ull << featureIndex;
-  if ((textureFeatureCacheInitialized_ & featureBit) == 0) {
-    if (isTextureFeatureSupported(feature)) {
-      textureFeatureCache_ |= featureBit;
-    }
-    textureFeatureCacheInitialized_ |= featureBit;
-  }
-
-  return (textureFeatureCache_ & featureBit) != 0;
-}
-
 bool DeviceFeatureSet::hasRequirement(DeviceRequirement requirement) const {
   switch (requirement) {
   case DeviceRequirement::ExplicitBindingExtReq:
@@ -845,6 +911,10 @@ bool DeviceFeatureSet::hasRequirement(DeviceRequirement requirement) const {
 
 bool DeviceFeatureSet::hasInternalRequirement(InternalRequirement requirement) const {
   switch (requirement) {
+  case InternalRequirement::BufferStorageExtReq:
+    // OpenGL ES only provides BufferStorage through GL_EXT_buffer_storage
+    return !hasDesktopVersionOrExtension(*this, GLVersion::v4_4, "GL_ARB_buffer_storage");
+
   case InternalRequirement::ColorTexImageRgb5A1Unsized:
     return usesOpenGLES() && !hasESVersion(*this, GLVersion::v3_0_ES);
 
@@ -897,6 +967,10 @@ bool DeviceFeatureSet::hasInternalRequirement(InternalRequirement requirement) c
              hasExtension(Extensions::FramebufferObject) ||
              hasESVersion(*this, GLVersion::v3_0_ES));
 
+  case InternalRequirement::OcclusionQueryExtReq:
+    // OpenGL ES 2 only exposes occlusion queries through GL_EXT_occlusion_query_boolean
+    return usesOpenGLES() && !hasESVersion(*this, GLVersion::v3_0_ES);
+
   case InternalRequirement::ShaderImageLoadStoreExtReq:
     return !usesOpenGLES() && !hasDesktopVersion(*this, GLVersion::v4_2);
 
@@ -919,6 +993,10 @@ bool DeviceFeatureSet::hasInternalRequirement(InternalRequirement requirement) c
     // GL_HALF_FLOAT.
     return usesOpenGLES() && !hasESVersion(*this, GLVersion::v3_0_ES);
 
+  case InternalRequirement::TimerQueryExtReq:
+    // OpenGL ES only exposes timestamp queries through GL_EXT_disjoint_timer_query
+    return usesOpenGLES();
+
   case InternalRequirement::UnmapBufferExtReq:
     // OpenGL ES 2 does not include UnmapBuffer
     return usesOpenGLES() && !hasESVersion(*this, GLVersion::v3_0_ES);
@@ -964,7 +1042,7 @@ bool DeviceFeatureSet::getFeatureLimits(DeviceFeatureLimits featureLimits, size_
     result = (size_t)tsize;
     return true;
   case DeviceFeatureLimits::MaxPushConstantBytes:
-    result = 0;
+    result = hasFeature(DeviceFeatures::PushConstants) ? PushConstantBlock::kMaxSize : 0;
     return true;
   case DeviceFeatureLimits::MaxUniformBufferBytes:
     tsize = 0;
@@ -974,7 +1052,8 @@ bool DeviceFeatureSet::getFeatureLimits(DeviceFeatureLimits featureLimits, size_
     result = (size_t)tsize;
     return true;
   case DeviceFeatureLimits::PushConstantsAlignment:
-    result = 0;
+    // std140 members are at least 4-byte aligned
+    result = hasFeature(DeviceFeatures::PushConstants) ? 4 : 0;
     return true;
   case DeviceFeatureLimits::ShaderStorageBufferOffsetAlignment:
     tsize = 256;
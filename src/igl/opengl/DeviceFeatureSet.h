@@ -7,8 +7,10 @@
 
 #pragma once
 
+#include <bitset>
 #include <igl/DeviceFeatures.h>
 #include <igl/Texture.h>
+#include <igl/opengl/GLFunc.h>
 #include <igl/opengl/Version.h>
 #include <string>
 #include <unordered_map>
@@ -23,6 +25,7 @@ enum class Extensions {
   AppleRgb422,                // GL_APPLE_rgb_422 is supported
   BindlessTextureArb,         // GL_ARB_bindless_texture is supported
   BindlessTextureNv,          // GL_NV_bindless_texture is supported
+  BufferStorage,              // GL_EXT_buffer_storage is supported
   Debug,                      // GL_KHR_debug is supported
   DebugMarker,                // GL_EXT_debug_marker is supported
   Depth24,                    // GL_OES_depth24 is supported
@@ -39,8 +42,11 @@ enum class Extensions {
   MultiSampleApple,           // GL_APPLE_framebuffer_multisample is supported
   MultiSampleExt,             // GL_EXT_multisampled_render_to_texture is supported
   MultiSampleImg,             // GL_IMG_multisampled_render_to_texture is supported
+  OcclusionQueryBoolean,      // GL_EXT_occlusion_query_boolean is supported
+  ParallelShaderCompile,      // GL_KHR_parallel_shader_compile or GL_ARB_parallel_shader_compile
   RequiredInternalFormat,     // GL_OES_required_internalformat is supported
   ShaderImageLoadStore,       // GL_EXT_shader_image_load_store is supported
+  ShadingRate,                // GL_QCOM_shading_rate is supported
   Srgb,                       // GL_EXT_sRGB is supported
   SrgbWriteControl,           // GL_EXT_sRGB_write_control is supported
   Sync,                       // GL_APPLE_sync is supported
@@ -54,32 +60,46 @@ enum class Extensions {
   TextureRgExt,               // GL_EXT_texture_rg is supported
   TextureSrgb,                // GL_EXT_texture_sRGB is supported
   TextureType2_10_10_10_Rev,  // GL_EXT_texture_type_2_10_10_10_REV is supporteds
+  TimerQuery,                 // GL_EXT_disjoint_timer_query is supported
   VertexArrayObject,          // GL_OES_vertex_array_object is supported
 };
 // clang-format on
 
+constexpr size_t kNumExtensions = static_cast<size_t>(Extensions::VertexArrayObject) + 1;
+
 // clang-format off
 enum class InternalFeatures {
+  BufferStorage,             // glBufferStorage is supported
   ClearDepthf,               // glClearDepthf is supported
+  CopyBuffer,                // glCopyBufferSubData is supported
+  CopyImage,                 // glCopyImageSubData is supported
   Debug,                     // Debug messages and group markers are supported
+  EGLImage,                  // glEGLImageTargetTexture2DOES is supported
   FramebufferBlit,           // BlitFramebuffer is supported
   FramebufferObject,         // Framebuffer objects are supported
   GetStringi,                // GetStringi is supported
   InvalidateFramebuffer,     // glInvalidateFramebuffer is supported
   MapBuffer,                 // glMapBuffer is supported
+  OcclusionQuery,            // Occlusion queries are supported
   PixelBufferObject,         // PBOs are available
   PolygonFillMode,           // glPolygonFillMode is supported
+  ProgramBinary,             // glGetProgramBinary and glProgramBinary are supported
   ProgramInterfaceQuery,     // Querying info about shader program interfaces is supported
   SeamlessCubeMap,           // GL_TEXTURE_CUBE_MAP_SEAMLESS is supported
   ShaderImageLoadStore,      // Shader image load/store is supported
   Sync,                      // Sync objects are supported
   TexStorage,                // glTexStorage* is available
+  TexStorageMultisample,     // glTexStorage2DMultisample is available
   TextureCompare,            // GL_TEXTURE_COMPARE_MODE and GL_TEXTURE_COMPARE_FUNC are supported
+  TimerQuery,                // Timestamp queries are supported
   UnmapBuffer,               // glUnmapBuffer is supported
   VertexArrayObject,         // VAOS are available
 };
 // clang-format on
 
+constexpr size_t kNumInternalFeatures =
+    static_cast<size_t>(InternalFeatures::VertexArrayObject) + 1;
+
 // clang-format off
 enum class TextureFeatures {
   ColorFilterable16f,           // XXX16F textures can use GL_LINEAR filtering
@@ -145,7 +165,11 @@ enum class TextureFeatures {
   };
 // clang-format on
 
+constexpr size_t kNumTextureFeatures =
+    static_cast<size_t>(TextureFeatures::TextureTypeUInt8888Rev) + 1;
+
 enum class InternalRequirement {
+  BufferStorageExtReq,
   ColorTexImageRgb10A2Unsized,
   ColorTexImageRgb5A1Unsized,
   ColorTexImageRgba4Unsized,
@@ -159,12 +183,14 @@ enum class InternalRequirement {
   MapBufferExtReq,
   MapBufferRangeExtReq,
   MultiSampleExtReq,
+  OcclusionQueryExtReq,
   ShaderImageLoadStoreExtReq,
   SyncExtReq,
   SwizzleAlphaTexturesReq,
   TexStorageExtReq,
   Texture3DExtReq,
   TextureHalfFloatExtReq,
+  TimerQueryExtReq,
   UnmapBufferExtReq,
   VertexArrayObjectExtReq,
 };
@@ -185,14 +211,26 @@ class DeviceFeatureSet final {
 
   bool isSupported(const std::string& extensionName) const;
 
-  bool hasExtension(Extensions extension) const;
-  bool hasFeature(DeviceFeatures feature) const;
-  bool hasInternalFeature(InternalFeatures feature) const;
-  bool hasTextureFeature(TextureFeatures feature) const;
+  // Resolved by initializeVersion() and initializeExtensions(), so each query is a single bit test
+  bool hasExtension(Extensions extension) const {
+    return extensionBits_[static_cast<size_t>(extension)];
+  }
+  bool hasFeature(DeviceFeatures feature) const {
+    return featureBits_[static_cast<size_t>(feature)];
+  }
+  bool hasInternalFeature(InternalFeatures feature) const {
+    return internalFeatureBits_[static_cast<size_t>(feature)];
+  }
+  bool hasTextureFeature(TextureFeatures feature) const {
+    return textureFeatureBits_[static_cast<size_t>(feature)];
+  }
 
   bool hasRequirement(DeviceRequirement requirement) const;
   bool hasInternalRequirement(InternalRequirement requirement) const;
 
+  // Whether the context resolved the entry point of an igl* function
+  bool hasFunction(GLFunction function) const;
+
   bool getFeatureLimits(DeviceFeatureLimits featureLimits, size_t& result) const;
 
   ICapabilities::TextureFormatCapabilities getTextureFormatCapabilities(TextureFormat format) const;
@@ -203,6 +241,7 @@ class DeviceFeatureSet final {
 
  private:
   ICapabilities::TextureFormatCapabilities getCompressedTextureCapabilities() const;
+  void resolveCapabilities();
   bool isExtensionSupported(Extensions extension) const;
   bool isFeatureSupported(DeviceFeatures feature) const;
   bool isInternalFeatureSupported(InternalFeatures feature) const;
@@ -212,14 +251,10 @@ class DeviceFeatureSet final {
   std::string extensions_;
   mutable std::unordered_map<TextureFormat, ICapabilities::TextureFormatCapabilities>
       textureCapabilityCache_;
-  mutable uint64_t extensionCache_ = 0;
-  mutable uint64_t extensionCacheInitialized_ = 0;
-  mutable uint64_t featureCache_ = 0;
-  mutable uint64_t featureCacheInitialized_ = 0;
-  mutable uint32_t internalFeatureCache_ = 0;
-  mutable uint32_t internalFeatureCacheInitialized_ = 0;
-  mutable uint64_t textureFeatureCache_ = 0;
-  mutable uint64_t textureFeatureCacheInitialized_ = 0;
+  std::bitset<kNumExtensions> extensionBits_;
+  std::bitset<kNumDeviceFeatures> featureBits_;
+  std::bitset<kNumInternalFeatures> internalFeatureBits_;
+  std::bitset<kNumTextureFeatures> textureFeatureBits_;
   IContext& glContext_;
   GLVersion version_ = GLVersion::NotAvailable;
 };
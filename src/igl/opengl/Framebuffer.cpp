@@ -14,6 +14,7 @@
 #include <igl/opengl/DummyTexture.h>
 #include <igl/opengl/Errors.h>
 #include <igl/opengl/Texture.h>
+#include <igl/opengl/TextureBufferBase.h>
 
 #include <algorithm>
 #if !IGL_PLATFORM_ANDROID
@@ -40,6 +41,18 @@ namespace opengl {
 
 namespace {
 
+// lets tile-based GPUs skip loading or storing attachments from/to memory
+void invalidateAttachments(IContext& context, GLsizei numAttachments, const GLenum* attachments) {
+  if (numAttachments > 0 &&
+      context.deviceFeatures().hasInternalFeature(InternalFeatures::InvalidateFramebuffer)) {
+    context.invalidateFramebuffer(GL_FRAMEBUFFER, numAttachments, attachments);
+  }
+}
+
+} // namespace
+
+namespace {
+
 Result checkFramebufferStatus(IContext& context) {
   auto code = Result::Code::Ok;
   std::string message;
@@ -81,9 +94,10 @@ FramebufferBindingGuard::FramebufferBindingGuard(IContext& context) :
   currentDrawFramebuffer_(0) {
   context_.getIntegerv(GL_RENDERBUFFER_BINDING, reinterpret_cast<GLint*>(&currentRenderbuffer_));
 
-  // Only restore currently bound framebuffer if it's valid
-  Result result = checkFramebufferStatus(context_);
-  if (result.isOk()) {
+  // Only restore currently bound framebuffer if it's valid. Restoring an incomplete one is
+  // harmless though, so the status check, a round trip to the driver, is skipped when the bindings
+  // are answered by the state cache.
+  if (context_.isStateCacheEnabled() || checkFramebufferStatus(context_).isOk()) {
     if (context_.deviceFeatures().hasFeature(DeviceFeatures::ReadWriteFramebuffer)) {
       context_.getIntegerv(GL_READ_FRAMEBUFFER_BINDING,
                            reinterpret_cast<GLint*>(&currentReadFramebuffer_));
@@ -135,7 +149,55 @@ void Framebuffer::copyBytesColorAttachment(ICommandQueue& /* unused */,
     return;
   }
 
+  readColorAttachment(pixelBytes, range, bytesPerRow);
+}
+
+std::unique_ptr<FramebufferReadback> Framebuffer::copyBytesColorAttachmentAsync(
+    size_t index,
+    const TextureRangeDesc& range,
+    size_t bytesPerRow) const {
+  // Only support attachment 0 because that's what glReadPixels supports
   auto itexture = getColorAttachment(index);
+  if (index != 0 || itexture == nullptr) {
+    IGL_ASSERT_MSG(0, "Invalid index: %d", index);
+    return nullptr;
+  }
+
+  if (bytesPerRow == 0) {
+    bytesPerRow = itexture->getProperties().getBytesPerRow(range);
+  }
+  const size_t size = bytesPerRow * range.height;
+
+  const auto& features = getContext().deviceFeatures();
+  if (!features.hasInternalFeature(InternalFeatures::PixelBufferObject) ||
+      !features.hasInternalFeature(InternalFeatures::Sync) ||
+      !features.hasInternalFeature(InternalFeatures::UnmapBuffer) ||
+      !features.hasFeature(DeviceFeatures::MapBufferRange)) {
+    std::vector<uint8_t> bytes(size);
+    readColorAttachment(bytes.data(), range, bytesPerRow);
+    return std::make_unique<FramebufferReadback>(getContext(), std::move(bytes));
+  }
+
+  GLuint buffer = 0;
+  getContext().genBuffers(1, &buffer);
+  getContext().bindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+  getContext().bufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)size, nullptr, GL_STREAM_READ);
+
+  // with a pixel pack buffer bound, glReadPixels() queues a copy into it instead of stalling
+  readColorAttachment(nullptr, range, bytesPerRow);
+
+  GLsync fence = getContext().fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  getContext().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  // makes sure the fence eventually signals without anyone waiting on it
+  getContext().flush();
+
+  return std::make_unique<FramebufferReadback>(getContext(), buffer, fence, size);
+}
+
+void Framebuffer::readColorAttachment(void* pixelBytes,
+                                      const TextureRangeDesc& range,
+                                      size_t bytesPerRow) const {
+  auto itexture = getColorAttachment(0);
   if (itexture != nullptr) {
     FramebufferBindingGuard guard(getContext());
 
@@ -223,11 +285,17 @@ void Framebuffer::copyTextureColorAttachment(ICommandQueue& /*cmdQueue*/,
     return;
   }
 
+  auto& dest = static_cast<Texture&>(*destTexture);
+
+  // both copies stay on the GPU without going through the texture unit state
+  if (copyImageColorAttachment(dest, range) || blitColorAttachment(dest, range)) {
+    return;
+  }
+
   FramebufferBindingGuard guard(getContext());
 
   bindBufferForRead();
 
-  auto& dest = static_cast<Texture&>(*destTexture);
   dest.bind();
 
   getContext().copyTexSubImage2D(GL_TEXTURE_2D,
@@ -240,6 +308,66 @@ void Framebuffer::copyTextureColorAttachment(ICommandQueue& /*cmdQueue*/,
                                  static_cast<GLsizei>(range.height));
 }
 
+bool Framebuffer::copyImageColorAttachment(Texture& dest, const TextureRangeDesc& range) const {
+  if (!getContext().deviceFeatures().hasInternalFeature(InternalFeatures::CopyImage)) {
+    return false;
+  }
+  auto* src = dynamic_cast<TextureBufferBase*>(getColorAttachment(0).get());
+  auto* dst = dynamic_cast<TextureBufferBase*>(&dest);
+  // glCopyImageSubData() requires matching formats and sample counts
+  if (!src || !dst || src->getId() == 0 || dst->getId() == 0 ||
+      src->getFormat() != dst->getFormat() || src->getSamples() != dst->getSamples()) {
+    return false;
+  }
+
+  getContext().copyImageSubData(src->getId(),
+                                src->getTarget(),
+                                static_cast<GLint>(range.mipLevel),
+                                static_cast<GLint>(range.x),
+                                static_cast<GLint>(range.y),
+                                static_cast<GLint>(range.layer),
+                                dst->getId(),
+                                dst->getTarget(),
+                                0,
+                                0,
+                                0,
+                                0,
+                                static_cast<GLsizei>(range.width),
+                                static_cast<GLsizei>(range.height),
+                                1);
+  return true;
+}
+
+bool Framebuffer::blitColorAttachment(Texture& dest, const TextureRangeDesc& range) const {
+  if (!getContext().deviceFeatures().hasInternalFeature(InternalFeatures::FramebufferBlit)) {
+    return false;
+  }
+  auto* dst = dynamic_cast<TextureBufferBase*>(&dest);
+  if (!dst || dst->getId() == 0 || dst->getTarget() != GL_TEXTURE_2D) {
+    return false;
+  }
+
+  FramebufferBindingGuard guard(getContext());
+
+  bindBufferForRead();
+
+  GLuint drawFramebufferId = 0;
+  getContext().genFramebuffers(1, &drawFramebufferId);
+  getContext().bindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebufferId);
+  getContext().framebufferTexture2D(
+      GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, dst->getId(), 0);
+
+  const auto x0 = static_cast<GLint>(range.x);
+  const auto y0 = static_cast<GLint>(range.y);
+  const auto width = static_cast<GLint>(range.width);
+  const auto height = static_cast<GLint>(range.height);
+  getContext().blitFramebuffer(
+      x0, y0, x0 + width, y0 + height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+  getContext().deleteFramebuffers(1, &drawFramebufferId);
+  return true;
+}
+
 void Framebuffer::attachAsColorLayer(const std::shared_ptr<ITexture>& texture,
                                      uint32_t layer) const {
   if (texture) {
@@ -313,9 +441,16 @@ std::shared_ptr<ITexture> CustomFramebuffer::updateDrawable(std::shared_ptr<ITex
     bindBuffer();
     curAttachment.detachAsColor(0);
     renderTarget_.colorAttachments.erase(0);
+    implicitResolve_ = false;
   }
 
   if (texture != nullptr && getColorAttachment(0) != texture) {
+    if (implicitResolve_ && texture->getSamples() == colorAttachment0->getSamples()) {
+      // the resolve texture stays attached, the multisampled storage is implicit
+      renderTarget_.colorAttachments[0].texture = texture;
+      return texture;
+    }
+    implicitResolve_ = false;
     FramebufferBindingGuard guard(getContext());
     bindBuffer();
     attachAsColor(texture, 0);
@@ -369,12 +504,26 @@ void CustomFramebuffer::prepareResource(Result* outResult) {
 
   std::vector<GLenum> drawBuffers;
 
+  implicitResolve_ = canResolveImplicitly();
+
   // attach the textures and render buffers to the frame buffer
   for (const auto& colorAttachment : renderTarget_.colorAttachments) {
     auto const colorAttachmentTexture = colorAttachment.second.texture;
     if (colorAttachmentTexture != nullptr) {
       size_t index = colorAttachment.first;
-      attachAsColor(colorAttachmentTexture, static_cast<uint32_t>(index));
+      if (implicitResolve_) {
+        // the multisampled storage only lives in tile memory and is resolved into the texture
+        const auto& resolveTexture = static_cast<Texture&>(*colorAttachment.second.resolveTexture);
+        getContext().framebufferTexture2DMultisample(
+            GL_FRAMEBUFFER,
+            GL_COLOR_ATTACHMENT0,
+            GL_TEXTURE_2D,
+            resolveTexture.getId(),
+            0,
+            static_cast<GLsizei>(colorAttachmentTexture->getSamples()));
+      } else {
+        attachAsColor(colorAttachmentTexture, static_cast<uint32_t>(index));
+      }
       drawBuffers.push_back(static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + index));
     }
   }
@@ -402,6 +551,10 @@ void CustomFramebuffer::prepareResource(Result* outResult) {
     return;
   }
 
+  if (implicitResolve_) {
+    return;
+  }
+
   // Check if resolve framebuffer is needed
   FramebufferDesc resolveDesc;
   auto createResolveFramebuffer = false;
@@ -443,6 +596,47 @@ void CustomFramebuffer::prepareResource(Result* outResult) {
   }
 }
 
+bool CustomFramebuffer::canResolveImplicitly() const {
+  if (renderTarget_.mode != FramebufferMode::Mono ||
+      !getContext().deviceFeatures().hasExtension(Extensions::MultiSampleExt)) {
+    return false;
+  }
+  // GL_EXT_multisampled_render_to_texture only applies to GL_COLOR_ATTACHMENT0
+  if (renderTarget_.colorAttachments.size() != 1) {
+    return false;
+  }
+  const auto& colorAttachment = renderTarget_.colorAttachments.begin();
+  const auto& texture = colorAttachment->second.texture;
+  const auto& resolveTexture = colorAttachment->second.resolveTexture;
+  if (colorAttachment->first != 0 || texture == nullptr || resolveTexture == nullptr ||
+      texture->getSamples() <= 1) {
+    return false;
+  }
+  // Renderbuffers, which are only usable as attachments, cannot take the implicit resolve
+  if (resolveTexture->getSamples() != 1 || resolveTexture->getType() != TextureType::TwoD ||
+      (resolveTexture->getUsage() & TextureDesc::TextureUsageBits::Sampled) == 0 ||
+      static_cast<Texture&>(*resolveTexture).isImplicitStorage() ||
+      resolveTexture->getDimensions().width != texture->getDimensions().width ||
+      resolveTexture->getDimensions().height != texture->getDimensions().height) {
+    return false;
+  }
+
+  // Depth and stencil are never resolved implicitly, and have to be multisampled renderbuffers
+  // with the same number of samples
+  for (const auto* attachment :
+       {&renderTarget_.depthAttachment, &renderTarget_.stencilAttachment}) {
+    if (attachment->resolveTexture != nullptr) {
+      return false;
+    }
+    if (attachment->texture != nullptr &&
+        (attachment->texture->getSamples() != texture->getSamples() ||
+         attachment->texture->getUsage() != TextureDesc::TextureUsageBits::Attachment)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 Viewport CustomFramebuffer::getViewport() const {
   auto texture = getColorAttachment(0);
 
@@ -487,6 +681,26 @@ void CustomFramebuffer::bind(const RenderPassDesc& renderPass) const {
                     (uint32_t)renderPass.colorAttachments[index].mipmapLevel);
     }
   }
+  // the previous contents of DontCare attachments are not loaded
+  GLenum attachments[IGL_COLOR_ATTACHMENTS_MAX + 2];
+  GLsizei numAttachments = 0;
+  for (const auto& colorAttachment : renderTarget_.colorAttachments) {
+    const size_t index = colorAttachment.first;
+    if (colorAttachment.second.texture != nullptr && index < renderPass_.colorAttachments.size() &&
+        renderPass_.colorAttachments[index].loadAction == LoadAction::DontCare) {
+      attachments[numAttachments++] = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(index);
+    }
+  }
+  if (renderTarget_.depthAttachment.texture != nullptr &&
+      renderPass_.depthAttachment.loadAction == LoadAction::DontCare) {
+    attachments[numAttachments++] = GL_DEPTH_ATTACHMENT;
+  }
+  if (renderTarget_.stencilAttachment.texture != nullptr &&
+      renderPass_.stencilAttachment.loadAction == LoadAction::DontCare) {
+    attachments[numAttachments++] = GL_STENCIL_ATTACHMENT;
+  }
+  invalidateAttachments(getContext(), numAttachments, attachments);
+
   // clear the buffers if we're not loading previous contents
   GLbitfield clearMask = 0;
   auto colorAttachment0 = renderTarget_.colorAttachments.find(0);
@@ -521,15 +735,17 @@ void CustomFramebuffer::bind(const RenderPassDesc& renderPass) const {
 }
 
 void CustomFramebuffer::unbind() const {
-  // discard the depthStencil if we don't need to store its contents
-  GLenum attachments[3];
+  // discard the attachments if we don't need to store their contents; multisampled attachments
+  // are discarded after they have been resolved
+  GLenum attachments[IGL_COLOR_ATTACHMENTS_MAX + 2];
   GLsizei numAttachments = 0;
-  auto colorAttachment0 = renderTarget_.colorAttachments.find(0);
 
-  if (colorAttachment0 != renderTarget_.colorAttachments.end() &&
-      colorAttachment0->second.texture != nullptr &&
-      renderPass_.colorAttachments[0].storeAction != StoreAction::Store) {
-    attachments[numAttachments++] = GL_COLOR_ATTACHMENT0;
+  for (const auto& colorAttachment : renderTarget_.colorAttachments) {
+    const size_t index = colorAttachment.first;
+    if (colorAttachment.second.texture != nullptr && index < renderPass_.colorAttachments.size() &&
+        renderPass_.colorAttachments[index].storeAction != StoreAction::Store) {
+      attachments[numAttachments++] = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(index);
+    }
   }
   if (renderTarget_.depthAttachment.texture != nullptr) {
     if (renderPass_.depthAttachment.storeAction != StoreAction::Store) {
@@ -544,10 +760,9 @@ void CustomFramebuffer::unbind() const {
   }
 
   if (numAttachments > 0) {
-    auto& features = getContext().deviceFeatures();
-    if (features.hasInternalFeature(InternalFeatures::InvalidateFramebuffer)) {
-      getContext().invalidateFramebuffer(GL_FRAMEBUFFER, numAttachments, attachments);
-    }
+    // resolving might have bound another framebuffer
+    bindBuffer();
+    invalidateAttachments(getContext(), numAttachments, attachments);
   }
 }
 
@@ -666,6 +881,9 @@ Viewport CurrentFramebuffer::getViewport() const {
 }
 
 void CurrentFramebuffer::bind(const RenderPassDesc& renderPass) const {
+  // Cache renderPass for unbind
+  renderPass_ = renderPass;
+
   bindBuffer();
 #if !IGL_OPENGL_ES
   // OpenGL ES doesn't need to call glEnable. All it needs is an sRGB framebuffer.
@@ -704,7 +922,27 @@ void CurrentFramebuffer::bind(const RenderPassDesc& renderPass) const {
 }
 
 void CurrentFramebuffer::unbind() const {
-  // no-op
+  // discard the buffers if we don't need to store their contents; the default framebuffer uses
+  // different enums for its buffers
+  const bool isDefault = frameBufferID_ == 0;
+  GLenum attachments[3];
+  GLsizei numAttachments = 0;
+
+  if (!renderPass_.colorAttachments.empty() &&
+      renderPass_.colorAttachments[0].storeAction == StoreAction::DontCare) {
+    attachments[numAttachments++] = isDefault ? GL_COLOR : GL_COLOR_ATTACHMENT0;
+  }
+  if (renderPass_.depthAttachment.storeAction == StoreAction::DontCare) {
+    attachments[numAttachments++] = isDefault ? GL_DEPTH : GL_DEPTH_ATTACHMENT;
+  }
+  if (renderPass_.stencilAttachment.storeAction == StoreAction::DontCare) {
+    attachments[numAttachments++] = isDefault ? GL_STENCIL : GL_STENCIL_ATTACHMENT;
+  }
+
+  if (numAttachments > 0) {
+    bindBuffer();
+    invalidateAttachments(getContext(), numAttachments, attachments);
+  }
 }
 
 } // namespace opengl
@@ -9,8 +9,10 @@
 
 #include <igl/Framebuffer.h>
 #include <igl/RenderPass.h>
+#include <igl/opengl/FramebufferReadback.h>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/IContext.h>
+#include <memory>
 
 namespace igl {
 class ICommandBuffer;
@@ -63,6 +65,13 @@ class Framebuffer : public WithContext, public IFramebuffer {
                                   size_t index,
                                   std::shared_ptr<ITexture> destTexture,
                                   const TextureRangeDesc& range) const override;
+
+  /// Same as copyBytesColorAttachment(), but reads the pixels into a pixel pack buffer and returns
+  /// without waiting for the GPU. The pixels are retrieved from the returned readback.
+  std::unique_ptr<FramebufferReadback> copyBytesColorAttachmentAsync(size_t index,
+                                                                     const TextureRangeDesc& range,
+                                                                     size_t bytesPerRow = 0) const;
+
   inline GLuint getId() const {
     return frameBufferID_;
   }
@@ -74,6 +83,19 @@ class Framebuffer : public WithContext, public IFramebuffer {
  protected:
   void attachAsColorLayer(const std::shared_ptr<ITexture>& texture, uint32_t layer) const;
 
+ private:
+  // glReadPixels() of color attachment 0, into a bound pixel pack buffer if `pixelBytes` is an
+  // offset into it
+  void readColorAttachment(void* pixelBytes,
+                           const TextureRangeDesc& range,
+                           size_t bytesPerRow) const;
+  // glCopyImageSubData() of the color attachment into `dest`
+  bool copyImageColorAttachment(Texture& dest, const TextureRangeDesc& range) const;
+  // glBlitFramebuffer() of the color attachment into `dest`
+  bool blitColorAttachment(Texture& dest, const TextureRangeDesc& range) const;
+
+ protected:
+
   // NOLINTNEXTLINE(misc-non-private-member-variables-in-classes)
   GLuint frameBufferID_ = 0;
 
@@ -122,6 +144,9 @@ class CustomFramebuffer final : public Framebuffer {
 
  private:
   void prepareResource(Result* outResult);
+  // True if the multisampled color attachment can be rendered straight into its resolve texture
+  // with GL_EXT_multisampled_render_to_texture, which resolves on tile-based GPUs for free
+  bool canResolveImplicitly() const;
   void attachAsColor(const std::shared_ptr<ITexture>& texture,
                      uint32_t index = 0,
                      uint32_t face = 0,
@@ -130,6 +155,8 @@ class CustomFramebuffer final : public Framebuffer {
   void attachAsStencil(const std::shared_ptr<ITexture>& texture) const;
 
   bool initialized_ = false;
+  // The resolve texture is attached in place of the multisampled color attachment
+  bool implicitResolve_ = false;
 
   FramebufferDesc renderTarget_; // attachments
   mutable RenderPassDesc renderPass_;
@@ -157,6 +184,7 @@ class CurrentFramebuffer final : public Framebuffer {
  private:
   Viewport viewport_;
   std::shared_ptr<ITexture> colorAttachment_;
+  mutable RenderPassDesc renderPass_;
 };
 
 } // namespace opengl
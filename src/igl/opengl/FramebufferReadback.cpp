@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/FramebufferReadback.h>
+
+#include <cstring>
+#include <igl/opengl/IContext.h>
+
+namespace igl {
+namespace opengl {
+
+FramebufferReadback::FramebufferReadback(IContext& context,
+                                         GLuint buffer,
+                                         GLsync fence,
+                                         size_t size) :
+  WithContext(context), buffer_(buffer), fence_(fence), size_(size) {}
+
+FramebufferReadback::FramebufferReadback(IContext& context, std::vector<uint8_t> bytes) :
+  WithContext(context), size_(bytes.size()), bytes_(std::move(bytes)) {}
+
+FramebufferReadback::~FramebufferReadback() {
+  if (fence_) {
+    getContext().deleteSync(fence_);
+  }
+  if (buffer_) {
+    getContext().deleteBuffers(1, &buffer_);
+  }
+}
+
+bool FramebufferReadback::isReady() const {
+  if (!fence_) {
+    return true;
+  }
+  GLint status = 0;
+  getContext().getSynciv(fence_, GL_SYNC_STATUS, sizeof(GLint), nullptr, &status);
+  if (status != GL_SIGNALED) {
+    return false;
+  }
+  getContext().deleteSync(fence_);
+  fence_ = nullptr;
+  return true;
+}
+
+Result FramebufferReadback::getBytes(void* pixelBytes) {
+  if (!pixelBytes) {
+    return Result(Result::Code::ArgumentNull, "pixelBytes is null");
+  }
+  if (!buffer_) {
+    if (!bytes_.empty()) {
+      memcpy(pixelBytes, bytes_.data(), bytes_.size());
+    }
+    return Result();
+  }
+
+  if (fence_) {
+    getContext().clientWaitSync(fence_, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    getContext().deleteSync(fence_);
+    fence_ = nullptr;
+  }
+
+  getContext().bindBuffer(GL_PIXEL_PACK_BUFFER, buffer_);
+  const void* src =
+      getContext().mapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)size_, GL_MAP_READ_BIT);
+  Result result;
+  if (src) {
+    memcpy(pixelBytes, src, size_);
+    getContext().unmapBuffer(GL_PIXEL_PACK_BUFFER);
+  } else {
+    result = Result(Result::Code::RuntimeError, "Could not map the pixel pack buffer");
+  }
+  getContext().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  return result;
+}
+
+} // namespace opengl
+} // namespace igl
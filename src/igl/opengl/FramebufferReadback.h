@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <igl/Common.h>
+#include <igl/opengl/GLIncludes.h>
+#include <igl/opengl/WithContext.h>
+#include <vector>
+
+namespace igl {
+namespace opengl {
+
+/**
+ * @brief A color attachment readback started by Framebuffer::copyBytesColorAttachmentAsync().
+ *
+ * glReadPixels() writes into a GL_PIXEL_PACK_BUFFER followed by a fence, so the call returns
+ * without waiting for the GPU to finish rendering. The pixels are copied out of the buffer once
+ * the fence has signaled. Contexts without pixel buffer objects or sync objects read the pixels
+ * synchronously, in which case the readback is ready right away.
+ *
+ * Must be destroyed on the thread of the context that created it.
+ */
+class FramebufferReadback final : public WithContext {
+ public:
+  /// Takes ownership of `buffer`, holding `size` bytes of pixels once `fence` has signaled
+  FramebufferReadback(IContext& context, GLuint buffer, GLsync fence, size_t size);
+  /// A readback whose pixels have already been read
+  FramebufferReadback(IContext& context, std::vector<uint8_t> bytes);
+  ~FramebufferReadback() override;
+
+  /// Returns true if getBytes() will not wait for the GPU
+  [[nodiscard]] bool isReady() const;
+  /// Copies the pixels into `pixelBytes`, waiting for the GPU if the readback is not ready yet.
+  /// The rows are laid out as requested from copyBytesColorAttachmentAsync()
+  Result getBytes(void* pixelBytes);
+
+  [[nodiscard]] size_t getSize() const {
+    return size_;
+  }
+
+ private:
+  GLuint buffer_ = 0;
+  mutable GLsync fence_ = nullptr;
+  size_t size_ = 0;
+  std::vector<uint8_t> bytes_;
+};
+
+} // namespace opengl
+} // namespace igl
@@ -8,6 +8,7 @@
 #include <igl/opengl/GLFunc.h>
 
 #include <igl/IGL.h>
+#include <type_traits>
 
 #if IGL_EGL
 #include <EGL/egl.h>
@@ -353,15 +354,29 @@ void iglRenderbufferStorageMultisampleAPPLE(GLenum target,
 /// MARK: - GL_APPLE_sync
 
 #if defined(GL_APPLE_sync)
+#define CAN_CALL_glClientWaitSyncAPPLE CAN_CALL_OPENGL_ES
 #define CAN_CALL_glDeleteSyncAPPLE CAN_CALL_OPENGL_ES
 #define CAN_CALL_glFenceSyncAPPLE CAN_CALL_OPENGL_ES
 #define CAN_CALL_glGetSyncivAPPLE CAN_CALL_OPENGL_ES
+#define CAN_CALL_glWaitSyncAPPLE CAN_CALL_OPENGL_ES
 #else
+#define CAN_CALL_glClientWaitSyncAPPLE 0
 #define CAN_CALL_glDeleteSyncAPPLE 0
 #define CAN_CALL_glFenceSyncAPPLE 0
 #define CAN_CALL_glGetSyncivAPPLE 0
+#define CAN_CALL_glWaitSyncAPPLE 0
 #endif
 
+GLenum iglClientWaitSyncAPPLE(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+  GLEXTENSION_METHOD_BODY_WITH_RETURN(CAN_CALL_glClientWaitSyncAPPLE,
+                                      glClientWaitSyncAPPLE,
+                                      PFNIGLCLIENTWAITSYNCPROC,
+                                      GL_WAIT_FAILED,
+                                      sync,
+                                      flags,
+                                      timeout);
+}
+
 void iglDeleteSyncAPPLE(GLsync sync) {
   GLEXTENSION_METHOD_BODY(
       CAN_CALL_glDeleteSyncAPPLE, glDeleteSyncAPPLE, PFNIGLDELETESYNCPROC, sync);
@@ -383,15 +398,22 @@ void iglGetSyncivAPPLE(GLsync sync, GLenum pname, GLsizei bufSize, GLsizei* leng
                           values);
 }
 
+void iglWaitSyncAPPLE(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glWaitSyncAPPLE, glWaitSyncAPPLE, PFNIGLWAITSYNCPROC, sync, flags, timeout);
+}
+
 ///--------------------------------------
 /// MARK: - GL_ARB_bindless_texture
 
 #if defined(GL_ARB_bindless_texture)
 #define CAN_CALL_glGetTextureHandleARB CAN_CALL_OPENGL
+#define CAN_CALL_glGetTextureSamplerHandleARB CAN_CALL_OPENGL
 #define CAN_CALL_glMakeTextureHandleResidentARB CAN_CALL_OPENGL
 #define CAN_CALL_glMakeTextureHandleNonResidentARB CAN_CALL_OPENGL
 #else
 #define CAN_CALL_glGetTextureHandleARB 0
+#define CAN_CALL_glGetTextureSamplerHandleARB 0
 #define CAN_CALL_glMakeTextureHandleResidentARB 0
 #define CAN_CALL_glMakeTextureHandleNonResidentARB 0
 #endif
@@ -404,6 +426,15 @@ GLuint64 iglGetTextureHandleARB(GLuint texture) {
                                       texture);
 }
 
+GLuint64 iglGetTextureSamplerHandleARB(GLuint texture, GLuint sampler) {
+  GLEXTENSION_METHOD_BODY_WITH_RETURN(CAN_CALL_glGetTextureSamplerHandleARB,
+                                      glGetTextureSamplerHandleARB,
+                                      PFNIGLGETTEXTURESAMPLERHANDLEPROC,
+                                      GL_ZERO,
+                                      texture,
+                                      sampler);
+}
+
 void iglMakeTextureHandleResidentARB(GLuint64 handle) {
   GLEXTENSION_METHOD_BODY(CAN_CALL_glMakeTextureHandleResidentARB,
                           glMakeTextureHandleResidentARB,
@@ -418,13 +449,34 @@ void iglMakeTextureHandleNonResidentARB(GLuint64 handle) {
                           handle);
 }
 
+///--------------------------------------
+/// MARK: - GL_ARB_buffer_storage
+
+#if defined(GL_VERSION_4_4) || defined(GL_ARB_buffer_storage)
+#define CAN_CALL_glBufferStorage CAN_CALL_OPENGL
+#else
+#define CAN_CALL_glBufferStorage 0
+#endif
+
+void iglBufferStorage(GLenum target, GLsizeiptr size, const GLvoid* data, GLbitfield flags) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glBufferStorage,
+                          glBufferStorage,
+                          PFNIGLBUFFERSTORAGEPROC,
+                          target,
+                          size,
+                          data,
+                          flags);
+}
+
 ///--------------------------------------
 /// MARK: - GL_ARB_compute_shader
 
 #if defined(GL_VERSION_4_3) || defined(GL_ES_VERSION_3_1) || defined(GL_ARB_compute_shader)
 #define CAN_CALL_glDispatchCompute CAN_CALL
+#define CAN_CALL_glDispatchComputeIndirect CAN_CALL
 #else
 #define CAN_CALL_glDispatchCompute 0
+#define CAN_CALL_glDispatchComputeIndirect 0
 #endif
 
 void iglDispatchCompute(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z) {
@@ -436,6 +488,81 @@ void iglDispatchCompute(GLuint num_groups_x, GLuint num_groups_y, GLuint num_gro
                           num_groups_z);
 }
 
+void iglDispatchComputeIndirect(GLintptr indirect) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glDispatchComputeIndirect,
+                          glDispatchComputeIndirect,
+                          PFNIGLDISPATCHCOMPUTEINDIRECTPROC,
+                          indirect);
+}
+
+///--------------------------------------
+/// MARK: - GL_ARB_copy_buffer
+
+#if defined(GL_VERSION_3_1) || defined(GL_ES_VERSION_3_0) || defined(GL_ARB_copy_buffer)
+#define CAN_CALL_glCopyBufferSubData CAN_CALL
+#else
+#define CAN_CALL_glCopyBufferSubData 0
+#endif
+
+void iglCopyBufferSubData(GLenum readTarget,
+                          GLenum writeTarget,
+                          GLintptr readOffset,
+                          GLintptr writeOffset,
+                          GLsizeiptr size) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glCopyBufferSubData,
+                          glCopyBufferSubData,
+                          PFNIGLCOPYBUFFERSUBDATAPROC,
+                          readTarget,
+                          writeTarget,
+                          readOffset,
+                          writeOffset,
+                          size);
+}
+
+///--------------------------------------
+/// MARK: - GL_ARB_copy_image
+
+#if defined(GL_VERSION_4_3) || defined(GL_ES_VERSION_3_2) || defined(GL_ARB_copy_image)
+#define CAN_CALL_glCopyImageSubData CAN_CALL
+#else
+#define CAN_CALL_glCopyImageSubData 0
+#endif
+
+void iglCopyImageSubData(GLuint srcName,
+                         GLenum srcTarget,
+                         GLint srcLevel,
+                         GLint srcX,
+                         GLint srcY,
+                         GLint srcZ,
+                         GLuint dstName,
+                         GLenum dstTarget,
+                         GLint dstLevel,
+                         GLint dstX,
+                         GLint dstY,
+                         GLint dstZ,
+                         GLsizei srcWidth,
+                         GLsizei srcHeight,
+                         GLsizei srcDepth) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glCopyImageSubData,
+                          glCopyImageSubData,
+                          PFNIGLCOPYIMAGESUBDATAPROC,
+                          srcName,
+                          srcTarget,
+                          srcLevel,
+                          srcX,
+                          srcY,
+                          srcZ,
+                          dstName,
+                          dstTarget,
+                          dstLevel,
+                          dstX,
+                          dstY,
+                          dstZ,
+                          srcWidth,
+                          srcHeight,
+                          srcDepth);
+}
+
 ///--------------------------------------
 /// MARK: - GL_ARB_draw_indirect
 
@@ -701,6 +828,99 @@ void iglRenderbufferStorageMultisample(GLenum target,
                           height)
 }
 
+///--------------------------------------
+/// MARK: - GL_ARB_get_program_binary
+
+#if defined(GL_VERSION_4_1) || defined(GL_ES_VERSION_3_0) || defined(GL_ARB_get_program_binary)
+#define CAN_CALL_glGetProgramBinary CAN_CALL
+#define CAN_CALL_glProgramBinary CAN_CALL
+#define CAN_CALL_glProgramParameteri CAN_CALL
+#else
+#define CAN_CALL_glGetProgramBinary 0
+#define CAN_CALL_glProgramBinary 0
+#define CAN_CALL_glProgramParameteri 0
+#endif
+
+void iglGetProgramBinary(GLuint program,
+                         GLsizei bufSize,
+                         GLsizei* length,
+                         GLenum* binaryFormat,
+                         void* binary) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glGetProgramBinary,
+                          glGetProgramBinary,
+                          PFNIGLGETPROGRAMBINARYPROC,
+                          program,
+                          bufSize,
+                          length,
+                          binaryFormat,
+                          binary);
+}
+
+void iglProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glProgramBinary,
+                          glProgramBinary,
+                          PFNIGLPROGRAMBINARYPROC,
+                          program,
+                          binaryFormat,
+                          binary,
+                          length);
+}
+
+void iglProgramParameteri(GLuint program, GLenum pname, GLint value) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glProgramParameteri,
+                          glProgramParameteri,
+                          PFNIGLPROGRAMPARAMETERIPROC,
+                          program,
+                          pname,
+                          value);
+}
+
+///--------------------------------------
+/// MARK: - GL_ARB_instanced_arrays
+
+#if defined(GL_VERSION_3_3) || defined(GL_ES_VERSION_3_0) || defined(GL_ARB_instanced_arrays)
+#define CAN_CALL_glDrawArraysInstanced CAN_CALL
+#define CAN_CALL_glDrawElementsInstanced CAN_CALL
+#define CAN_CALL_glVertexAttribDivisor CAN_CALL
+#else
+#define CAN_CALL_glDrawArraysInstanced 0
+#define CAN_CALL_glDrawElementsInstanced 0
+#define CAN_CALL_glVertexAttribDivisor 0
+#endif
+
+void iglDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glDrawArraysInstanced,
+                          glDrawArraysInstanced,
+                          PFNIGLDRAWARRAYSINSTANCEDPROC,
+                          mode,
+                          first,
+                          count,
+                          instancecount);
+}
+
+void iglDrawElementsInstanced(GLenum mode,
+                              GLsizei count,
+                              GLenum type,
+                              const GLvoid* indices,
+                              GLsizei instancecount) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glDrawElementsInstanced,
+                          glDrawElementsInstanced,
+                          PFNIGLDRAWELEMENTSINSTANCEDPROC,
+                          mode,
+                          count,
+                          type,
+                          indices,
+                          instancecount);
+}
+
+void iglVertexAttribDivisor(GLuint index, GLuint divisor) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glVertexAttribDivisor,
+                          glVertexAttribDivisor,
+                          PFNIGLVERTEXATTRIBDIVISORPROC,
+                          index,
+                          divisor);
+}
+
 ///--------------------------------------
 /// MARK: - GL_ARB_invalidate_subdata
 
@@ -739,6 +959,65 @@ void* iglMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbit
                                       access);
 }
 
+///--------------------------------------
+/// MARK: - GL_ARB_occlusion_query
+
+#if defined(GL_VERSION_1_5) || defined(GL_ES_VERSION_3_0) || defined(GL_ARB_occlusion_query)
+#define CAN_CALL_glBeginQuery CAN_CALL
+#define CAN_CALL_glDeleteQueries CAN_CALL
+#define CAN_CALL_glEndQuery CAN_CALL
+#define CAN_CALL_glGenQueries CAN_CALL
+#define CAN_CALL_glGetQueryObjectuiv CAN_CALL
+#else
+#define CAN_CALL_glBeginQuery 0
+#define CAN_CALL_glDeleteQueries 0
+#define CAN_CALL_glEndQuery 0
+#define CAN_CALL_glGenQueries 0
+#define CAN_CALL_glGetQueryObjectuiv 0
+#endif
+
+void iglBeginQuery(GLenum target, GLuint id) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glBeginQuery, glBeginQuery, PFNIGLBEGINQUERYPROC, target, id);
+}
+
+void iglDeleteQueries(GLsizei n, const GLuint* ids) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glDeleteQueries, glDeleteQueries, PFNIGLDELETEQUERIESPROC, n, ids);
+}
+
+void iglEndQuery(GLenum target) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glEndQuery, glEndQuery, PFNIGLENDQUERYPROC, target);
+}
+
+void iglGenQueries(GLsizei n, GLuint* ids) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glGenQueries, glGenQueries, PFNIGLGENQUERIESPROC, n, ids);
+}
+
+void iglGetQueryObjectuiv(GLuint id, GLenum pname, GLuint* params) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glGetQueryObjectuiv,
+                          glGetQueryObjectuiv,
+                          PFNIGLGETQUERYOBJECTUIVPROC,
+                          id,
+                          pname,
+                          params);
+}
+
+///--------------------------------------
+/// MARK: - GL_ARB_parallel_shader_compile
+
+#if defined(GL_ARB_parallel_shader_compile)
+#define CAN_CALL_glMaxShaderCompilerThreadsARB CAN_CALL
+#else
+#define CAN_CALL_glMaxShaderCompilerThreadsARB 0
+#endif
+
+void iglMaxShaderCompilerThreadsARB(GLuint count) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glMaxShaderCompilerThreadsARB,
+                          glMaxShaderCompilerThreadsARB,
+                          PFNIGLMAXSHADERCOMPILERTHREADSPROC,
+                          count);
+}
+
 ///--------------------------------------
 /// MARK: - GL_ARB_program_interface_query
 
@@ -815,6 +1094,49 @@ void iglGetProgramResourceName(GLuint program,
                           name)
 }
 
+///--------------------------------------
+/// MARK: - GL_ARB_sampler_objects
+
+#if defined(GL_VERSION_3_3) || defined(GL_ES_VERSION_3_0) || defined(GL_ARB_sampler_objects)
+#define CAN_CALL_glDeleteSamplers CAN_CALL
+#define CAN_CALL_glGenSamplers CAN_CALL
+#define CAN_CALL_glSamplerParameterf CAN_CALL
+#define CAN_CALL_glSamplerParameteri CAN_CALL
+#else
+#define CAN_CALL_glDeleteSamplers 0
+#define CAN_CALL_glGenSamplers 0
+#define CAN_CALL_glSamplerParameterf 0
+#define CAN_CALL_glSamplerParameteri 0
+#endif
+
+void iglDeleteSamplers(GLsizei n, const GLuint* samplers) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glDeleteSamplers, glDeleteSamplers, PFNIGLDELETESAMPLERSPROC, n, samplers);
+}
+
+void iglGenSamplers(GLsizei n, GLuint* samplers) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glGenSamplers, glGenSamplers, PFNIGLGENSAMPLERSPROC, n, samplers);
+}
+
+void iglSamplerParameterf(GLuint sampler, GLenum pname, GLfloat param) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glSamplerParameterf,
+                          glSamplerParameterf,
+                          PFNIGLSAMPLERPARAMETERFPROC,
+                          sampler,
+                          pname,
+                          param);
+}
+
+void iglSamplerParameteri(GLuint sampler, GLenum pname, GLint param) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glSamplerParameteri,
+                          glSamplerParameteri,
+                          PFNIGLSAMPLERPARAMETERIPROC,
+                          sampler,
+                          pname,
+                          param);
+}
+
 ///--------------------------------------
 /// MARK: - GL_ARB_shader_image_load_store
 
@@ -854,15 +1176,29 @@ void iglMemoryBarrier(GLbitfield barriers) {
 /// MARK: - GL_ARB_sync
 
 #if defined(GL_VERSION_3_2) || defined(GL_ES_VERSION_3_0) || defined(GL_ARB_sync)
+#define CAN_CALL_glClientWaitSync CAN_CALL
 #define CAN_CALL_glDeleteSync CAN_CALL
 #define CAN_CALL_glFenceSync CAN_CALL
 #define CAN_CALL_glGetSynciv CAN_CALL
+#define CAN_CALL_glWaitSync CAN_CALL
 #else
+#define CAN_CALL_glClientWaitSync 0
 #define CAN_CALL_glDeleteSync 0
 #define CAN_CALL_glFenceSync 0
 #define CAN_CALL_glGetSynciv 0
+#define CAN_CALL_glWaitSync 0
 #endif
 
+GLenum iglClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+  GLEXTENSION_METHOD_BODY_WITH_RETURN(CAN_CALL_glClientWaitSync,
+                                      glClientWaitSync,
+                                      PFNIGLCLIENTWAITSYNCPROC,
+                                      GL_WAIT_FAILED,
+                                      sync,
+                                      flags,
+                                      timeout);
+}
+
 void iglDeleteSync(GLsync sync) {
   GLEXTENSION_METHOD_BODY(CAN_CALL_glDeleteSync, glDeleteSync, PFNIGLDELETESYNCPROC, sync);
 }
@@ -877,6 +1213,10 @@ void iglGetSynciv(GLsync sync, GLenum pname, GLsizei bufSize, GLsizei* length, G
       CAN_CALL_glGetSynciv, glGetSynciv, PFNIGLGETSYNCIVPROC, sync, pname, bufSize, length, values);
 }
 
+void iglWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glWaitSync, glWaitSync, PFNIGLWAITSYNCPROC, sync, flags, timeout);
+}
+
 ///--------------------------------------
 /// MARK: - GL_ARB_texture_storage
 
@@ -936,6 +1276,58 @@ void iglTexStorage3D(GLenum target,
                           depth);
 }
 
+///--------------------------------------
+/// MARK: - GL_ARB_texture_storage_multisample
+
+#if defined(GL_VERSION_4_3) || defined(GL_ES_VERSION_3_1) || \
+    defined(GL_ARB_texture_storage_multisample)
+#define CAN_CALL_glTexStorage2DMultisample CAN_CALL
+#else
+#define CAN_CALL_glTexStorage2DMultisample 0
+#endif
+
+void iglTexStorage2DMultisample(GLenum target,
+                                GLsizei samples,
+                                GLenum internalformat,
+                                GLsizei width,
+                                GLsizei height,
+                                GLboolean fixedsamplelocations) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glTexStorage2DMultisample,
+                          glTexStorage2DMultisample,
+                          PFNIGLTEXSTORAGE2DMULTISAMPLEPROC,
+                          target,
+                          samples,
+                          internalformat,
+                          width,
+                          height,
+                          fixedsamplelocations);
+}
+
+///--------------------------------------
+/// MARK: - GL_ARB_timer_query
+
+#if defined(GL_VERSION_3_3) || defined(GL_ARB_timer_query)
+#define CAN_CALL_glGetQueryObjectui64v CAN_CALL_OPENGL
+#define CAN_CALL_glQueryCounter CAN_CALL_OPENGL
+#else
+#define CAN_CALL_glGetQueryObjectui64v 0
+#define CAN_CALL_glQueryCounter 0
+#endif
+
+void iglGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glGetQueryObjectui64v,
+                          glGetQueryObjectui64v,
+                          PFNIGLGETQUERYOBJECTUI64VPROC,
+                          id,
+                          pname,
+                          params);
+}
+
+void iglQueryCounter(GLuint id, GLenum target) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glQueryCounter, glQueryCounter, PFNIGLQUERYCOUNTERPROC, id, target);
+}
+
 ///--------------------------------------
 /// MARK: - GL_ARB_uniform_buffer_object
 
@@ -1066,6 +1458,25 @@ void iglGenVertexArrays(GLsizei n, GLuint* vertexArrays) {
       CAN_CALL_glGenVertexArrays, glGenVertexArrays, PFNIGLGENVERTEXARRAYSPROC, n, vertexArrays);
 }
 
+///--------------------------------------
+/// MARK: - GL_EXT_buffer_storage
+
+#if defined(GL_EXT_buffer_storage)
+#define CAN_CALL_glBufferStorageEXT CAN_CALL
+#else
+#define CAN_CALL_glBufferStorageEXT 0
+#endif
+
+void iglBufferStorageEXT(GLenum target, GLsizeiptr size, const GLvoid* data, GLbitfield flags) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glBufferStorageEXT,
+                          glBufferStorageEXT,
+                          PFNIGLBUFFERSTORAGEPROC,
+                          target,
+                          size,
+                          data,
+                          flags);
+}
+
 ///--------------------------------------
 /// MARK: - GL_EXT_debug_marker
 
@@ -1126,6 +1537,49 @@ void iglDiscardFramebufferEXT(GLenum target, GLsizei numAttachments, const GLenu
                           attachments);
 }
 
+///--------------------------------------
+/// MARK: - GL_EXT_disjoint_timer_query
+
+// Query objects are shared with GL_EXT_occlusion_query_boolean
+#if defined(GL_EXT_disjoint_timer_query) || defined(GL_EXT_occlusion_query_boolean)
+#define CAN_CALL_glDeleteQueriesEXT CAN_CALL_OPENGL_ES
+#define CAN_CALL_glGenQueriesEXT CAN_CALL_OPENGL_ES
+#else
+#define CAN_CALL_glDeleteQueriesEXT 0
+#define CAN_CALL_glGenQueriesEXT 0
+#endif
+
+#if defined(GL_EXT_disjoint_timer_query)
+#define CAN_CALL_glGetQueryObjectui64vEXT CAN_CALL_OPENGL_ES
+#define CAN_CALL_glQueryCounterEXT CAN_CALL_OPENGL_ES
+#else
+#define CAN_CALL_glGetQueryObjectui64vEXT 0
+#define CAN_CALL_glQueryCounterEXT 0
+#endif
+
+void iglDeleteQueriesEXT(GLsizei n, const GLuint* ids) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glDeleteQueriesEXT, glDeleteQueriesEXT, PFNIGLDELETEQUERIESPROC, n, ids);
+}
+
+void iglGenQueriesEXT(GLsizei n, GLuint* ids) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glGenQueriesEXT, glGenQueriesEXT, PFNIGLGENQUERIESPROC, n, ids);
+}
+
+void iglGetQueryObjectui64vEXT(GLuint id, GLenum pname, GLuint64* params) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glGetQueryObjectui64vEXT,
+                          glGetQueryObjectui64vEXT,
+                          PFNIGLGETQUERYOBJECTUI64VPROC,
+                          id,
+                          pname,
+                          params);
+}
+
+void iglQueryCounterEXT(GLuint id, GLenum target) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glQueryCounterEXT, glQueryCounterEXT, PFNIGLQUERYCOUNTERPROC, id, target);
+}
+
 ///--------------------------------------
 /// MARK: - GL_EXT_draw_buffers
 
@@ -1327,6 +1781,37 @@ void iglRenderbufferStorageMultisampleEXT(GLenum target,
                           height)
 }
 
+///--------------------------------------
+/// MARK: - GL_EXT_occlusion_query_boolean
+
+#if defined(GL_EXT_disjoint_timer_query) || defined(GL_EXT_occlusion_query_boolean)
+#define CAN_CALL_glBeginQueryEXT CAN_CALL_OPENGL_ES
+#define CAN_CALL_glEndQueryEXT CAN_CALL_OPENGL_ES
+#define CAN_CALL_glGetQueryObjectuivEXT CAN_CALL_OPENGL_ES
+#else
+#define CAN_CALL_glBeginQueryEXT 0
+#define CAN_CALL_glEndQueryEXT 0
+#define CAN_CALL_glGetQueryObjectuivEXT 0
+#endif
+
+void iglBeginQueryEXT(GLenum target, GLuint id) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glBeginQueryEXT, glBeginQueryEXT, PFNIGLBEGINQUERYPROC, target, id);
+}
+
+void iglEndQueryEXT(GLenum target) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glEndQueryEXT, glEndQueryEXT, PFNIGLENDQUERYPROC, target);
+}
+
+void iglGetQueryObjectuivEXT(GLuint id, GLenum pname, GLuint* params) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glGetQueryObjectuivEXT,
+                          glGetQueryObjectuivEXT,
+                          PFNIGLGETQUERYOBJECTUIVPROC,
+                          id,
+                          pname,
+                          params);
+}
+
 ///--------------------------------------
 /// MARK: - GL_EXT_shader_image_load_store
 
@@ -1477,14 +1962,11 @@ void iglRenderbufferStorageMultisampleIMG(GLenum target,
 #define CAN_CALL_glPushDebugGroupKHR 0
 #endif
 
+// Desktop OpenGL exposes GL_KHR_debug without the suffix
 #if IGL_OPENGL
-#define DebugMessageInsertKHR glDebugMessageInsert
-#define PopDebugGroupKHR glPopDebugGroup
-#define PushDebugGroupKHR glPushDebugGroup
-#else
-#define DebugMessageInsertKHR glDebugMessageInsertKHR
-#define PopDebugGroupKHR glPopDebugGroupKHR
-#define PushDebugGroupKHR glPushDebugGroupKHR
+#define glDebugMessageInsertKHR glDebugMessageInsert
+#define glPopDebugGroupKHR glPopDebugGroup
+#define glPushDebugGroupKHR glPushDebugGroup
 #endif
 
 void iglDebugMessageInsertKHR(GLenum source,
@@ -1494,7 +1976,7 @@ void iglDebugMessageInsertKHR(GLenum source,
                               GLsizei length,
                               const GLchar* buf) {
   GLEXTENSION_METHOD_BODY(CAN_CALL_glDebugMessageInsertKHR,
-                          DebugMessageInsertKHR,
+                          glDebugMessageInsertKHR,
                           PFNIGLDEBUGMESSAGEINSERTPROC,
                           source,
                           type,
@@ -1505,11 +1987,11 @@ void iglDebugMessageInsertKHR(GLenum source,
 }
 
 void iglPopDebugGroupKHR() {
-  GLEXTENSION_METHOD_BODY(CAN_CALL_glPopDebugGroupKHR, PopDebugGroupKHR, PFNIGLPOPDEBUGGROUPPROC);
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glPopDebugGroupKHR, glPopDebugGroupKHR, PFNIGLPOPDEBUGGROUPPROC);
 }
 void iglPushDebugGroupKHR(GLenum source, GLuint id, GLsizei length, const GLchar* message) {
   GLEXTENSION_METHOD_BODY(CAN_CALL_glPushDebugGroupKHR,
-                          PushDebugGroupKHR,
+                          glPushDebugGroupKHR,
                           PFNIGLPUSHDEBUGGROUPPROC,
                           source,
                           id,
@@ -1517,15 +1999,33 @@ void iglPushDebugGroupKHR(GLenum source, GLuint id, GLsizei length, const GLchar
                           message);
 }
 
+///--------------------------------------
+/// MARK: - GL_KHR_parallel_shader_compile
+
+#if defined(GL_KHR_parallel_shader_compile)
+#define CAN_CALL_glMaxShaderCompilerThreadsKHR CAN_CALL
+#else
+#define CAN_CALL_glMaxShaderCompilerThreadsKHR 0
+#endif
+
+void iglMaxShaderCompilerThreadsKHR(GLuint count) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glMaxShaderCompilerThreadsKHR,
+                          glMaxShaderCompilerThreadsKHR,
+                          PFNIGLMAXSHADERCOMPILERTHREADSPROC,
+                          count);
+}
+
 ///--------------------------------------
 /// MARK: - GL_NV_bindless_texture
 
 #if defined(GL_NV_bindless_texture)
 #define CAN_CALL_glGetTextureHandleNV CAN_CALL
+#define CAN_CALL_glGetTextureSamplerHandleNV CAN_CALL
 #define CAN_CALL_glMakeTextureHandleResidentNV CAN_CALL
 #define CAN_CALL_glMakeTextureHandleNonResidentNV CAN_CALL
 #else
 #define CAN_CALL_glGetTextureHandleNV 0
+#define CAN_CALL_glGetTextureSamplerHandleNV 0
 #define CAN_CALL_glMakeTextureHandleResidentNV 0
 #define CAN_CALL_glMakeTextureHandleNonResidentNV 0
 #endif
@@ -1538,6 +2038,15 @@ GLuint64 iglGetTextureHandleNV(GLuint texture) {
                                       texture);
 }
 
+GLuint64 iglGetTextureSamplerHandleNV(GLuint texture, GLuint sampler) {
+  GLEXTENSION_METHOD_BODY_WITH_RETURN(CAN_CALL_glGetTextureSamplerHandleNV,
+                                      glGetTextureSamplerHandleNV,
+                                      PFNIGLGETTEXTURESAMPLERHANDLEPROC,
+                                      GL_ZERO,
+                                      texture,
+                                      sampler);
+}
+
 void iglMakeTextureHandleResidentNV(GLuint64 handle) {
   GLEXTENSION_METHOD_BODY(CAN_CALL_glMakeTextureHandleResidentNV,
                           glMakeTextureHandleResidentNV,
@@ -1606,6 +2115,23 @@ void iglFramebufferTextureMultisampleMultiviewOVR(GLenum target,
                           numViews)
 }
 
+///--------------------------------------
+/// MARK: - GL_OES_EGL_image
+
+#if defined(GL_OES_EGL_image)
+#define CAN_CALL_glEGLImageTargetTexture2DOES CAN_CALL_OPENGL_ES
+#else
+#define CAN_CALL_glEGLImageTargetTexture2DOES 0
+#endif
+
+void iglEGLImageTargetTexture2DOES(GLenum target, void* image) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glEGLImageTargetTexture2DOES,
+                          glEGLImageTargetTexture2DOES,
+                          PFNIGLEGLIMAGETARGETTEXTURE2DPROC,
+                          target,
+                          image);
+}
+
 ///--------------------------------------
 /// MARK: - GL_OES_mapbuffer
 
@@ -1778,4 +2304,66 @@ void iglGenVertexArraysOES(GLsizei n, GLuint* vertexArrays) {
                           vertexArrays);
 }
 
+///--------------------------------------
+/// MARK: - GL_QCOM_shading_rate
+
+#if defined(GL_QCOM_shading_rate)
+#define CAN_CALL_glShadingRateQCOM CAN_CALL_OPENGL_ES
+#else
+#define CAN_CALL_glShadingRateQCOM 0
+#endif
+
+void iglShadingRateQCOM(GLenum rate) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glShadingRateQCOM, glShadingRateQCOM, PFNIGLSHADINGRATEPROC, rate);
+}
+
 IGL_EXTERN_END
+
+// Resolves funcName the same way GLEXTENSION_METHOD_BODY calls it, or nullptr if it is unavailable
+#define GLEXTENSION_ADDRESS_1_1(funcName, funcType) (funcType)funcName
+#define GLEXTENSION_ADDRESS_1_0(funcName, funcType) (funcType)funcName
+#define GLEXTENSION_ADDRESS_0_1(funcName, funcType) (funcType)IGL_GET_PROC_ADDRESS(#funcName)
+#define GLEXTENSION_ADDRESS_0_0(funcName, funcType) (funcType) nullptr
+
+#define GLEXTENSION_ADDRESS_EXPAND(canCall, canLoad, funcName, funcType) \
+  GLEXTENSION_ADDRESS_##canCall##_##canLoad(funcName, funcType)
+
+#if CAN_LOAD
+#define GLEXTENSION_ADDRESS(canCall, funcName, funcType) \
+  GLEXTENSION_ADDRESS_EXPAND(canCall, 1, funcName, funcType)
+#else
+#define GLEXTENSION_ADDRESS(canCall, funcName, funcType) \
+  GLEXTENSION_ADDRESS_EXPAND(canCall, 0, funcName, funcType)
+#endif
+
+namespace igl {
+namespace opengl {
+namespace {
+
+// The few wrappers that adapt their arguments (e.g. iglClearDepth) are kept even if the function
+// is available
+template<typename WrapperType, typename FuncType>
+WrapperType resolveFunction(FuncType address, WrapperType wrapper) {
+  if constexpr (std::is_same_v<WrapperType, FuncType>) {
+    return address != nullptr ? address : wrapper;
+  } else {
+    return wrapper;
+  }
+}
+
+} // namespace
+
+void GLDispatchTable::load() {
+#define IGL_GL_FUNCTION_LOAD(name, funcType)                                         \
+  {                                                                                  \
+    const auto address = GLEXTENSION_ADDRESS(CAN_CALL_gl##name, gl##name, funcType); \
+    available_.set(static_cast<size_t>(GLFunction::name), address != nullptr);       \
+    name = resolveFunction(address, &igl##name);                                     \
+  }
+  IGL_GL_FUNCTIONS(IGL_GL_FUNCTION_LOAD)
+#undef IGL_GL_FUNCTION_LOAD
+}
+
+} // namespace opengl
+} // namespace igl
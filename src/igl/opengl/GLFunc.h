@@ -7,6 +7,9 @@
 
 #pragma once
 
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/Macros.h>
 
@@ -31,6 +34,7 @@ IGL_EXTERN_BEGIN
 // definitions use a PFNIGL prefix to ensure they don't collide with function pointer types
 // defined by other OpenGL loaders. These definitions also omit any extension-specific suffix (e.g.,
 // EXT) unless it is needed to disambiguate them.
+using PFNIGLBEGINQUERYPROC = void (*)(GLenum target, GLuint id);
 using PFNIGLBINDBUFFERBASEPROC = void (*)(GLenum target, GLuint index, GLuint buffer);
 using PFNIGLBINDBUFFERRANGEPROC =
     void (*)(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
@@ -54,7 +58,12 @@ using PFNIGLBLITFRAMEBUFFERPROC = void (*)(GLint srcX0,
                                            GLint dstY1,
                                            GLbitfield mask,
                                            GLenum filter);
+using PFNIGLBUFFERSTORAGEPROC = void (*)(GLenum target,
+                                         GLsizeiptr size,
+                                         const GLvoid* data,
+                                         GLbitfield flags);
 using PFNIGLCHECKFRAMEBUFFERSTATUSPROC = GLenum (*)(GLenum target);
+using PFNIGLCLIENTWAITSYNCPROC = GLenum (*)(GLsync sync, GLbitfield flags, GLuint64 timeout);
 using PFNIGLCLEARDEPTHPROC = void (*)(GLdouble depth);
 using PFNIGLCLEARDEPTHFPROC = void (*)(GLfloat depth);
 using PFNIGLCOMPRESSEDTEXIMAGE3DPROC = void (*)(GLenum target,
@@ -77,6 +86,26 @@ using PFNIGLCOMPRESSEDTEXSUBIMAGE3DPROC = void (*)(GLenum target,
                                                    GLenum format,
                                                    GLsizei imageSize,
                                                    const GLvoid* data);
+using PFNIGLCOPYBUFFERSUBDATAPROC = void (*)(GLenum readTarget,
+                                             GLenum writeTarget,
+                                             GLintptr readOffset,
+                                             GLintptr writeOffset,
+                                             GLsizeiptr size);
+using PFNIGLCOPYIMAGESUBDATAPROC = void (*)(GLuint srcName,
+                                            GLenum srcTarget,
+                                            GLint srcLevel,
+                                            GLint srcX,
+                                            GLint srcY,
+                                            GLint srcZ,
+                                            GLuint dstName,
+                                            GLenum dstTarget,
+                                            GLint dstLevel,
+                                            GLint dstX,
+                                            GLint dstY,
+                                            GLint dstZ,
+                                            GLsizei srcWidth,
+                                            GLsizei srcHeight,
+                                            GLsizei srcDepth);
 using PFNIGLCREATEMEMORYOBJECTSPROC = void (*)(GLsizei n, GLuint* memoryObjects);
 using PFNIGLDEBUGMESSAGEINSERTPROC = void (*)(GLenum source,
                                               GLenum type,
@@ -86,7 +115,9 @@ using PFNIGLDEBUGMESSAGEINSERTPROC = void (*)(GLenum source,
                                               const GLchar* buf);
 using PFNIGLDELETEFRAMEBUFFERSPROC = void (*)(GLsizei n, const GLuint* framebuffers);
 using PFNIGLDELETEMEMORYOBJECTSPROC = void (*)(GLsizei n, const GLuint* memoryObjects);
+using PFNIGLDELETEQUERIESPROC = void (*)(GLsizei n, const GLuint* ids);
 using PFNIGLDELETERENDERBUFFERSPROC = void (*)(GLsizei n, const GLuint* renderbuffers);
+using PFNIGLDELETESAMPLERSPROC = void (*)(GLsizei n, const GLuint* samplers);
 using PFNIGLDELETESYNCPROC = void (*)(GLsync sync);
 using PFNIGLDELETEVERTEXARRAYSPROC = void (*)(GLsizei n, const GLuint* vertexArrays);
 using PFNIGLDISCARDFRAMEBUFFERPROC = void (*)(GLenum target,
@@ -95,8 +126,20 @@ using PFNIGLDISCARDFRAMEBUFFERPROC = void (*)(GLenum target,
 using PFNIGLDISPATCHCOMPUTEPROC = void (*)(GLuint num_groups_x,
                                            GLuint num_groups_y,
                                            GLuint num_groups_z);
+using PFNIGLDISPATCHCOMPUTEINDIRECTPROC = void (*)(GLintptr indirect);
+using PFNIGLDRAWARRAYSINSTANCEDPROC = void (*)(GLenum mode,
+                                               GLint first,
+                                               GLsizei count,
+                                               GLsizei instancecount);
 using PFNIGLDRAWBUFFERSPROC = void (*)(GLsizei, const GLenum*);
 using PFNIGLDRAWELEMENTSINDIRECTPROC = void (*)(GLenum mode, GLenum type, const GLvoid* indirect);
+using PFNIGLDRAWELEMENTSINSTANCEDPROC = void (*)(GLenum mode,
+                                                 GLsizei count,
+                                                 GLenum type,
+                                                 const GLvoid* indices,
+                                                 GLsizei instancecount);
+using PFNIGLEGLIMAGETARGETTEXTURE2DPROC = void (*)(GLenum target, void* image);
+using PFNIGLENDQUERYPROC = void (*)(GLenum target);
 using PFNIGLFENCESYNCPROC = GLsync (*)(GLenum condition, GLbitfield flags);
 using PFNIGLFRAMEBUFFERRENDERBUFFERPROC = void (*)(GLenum target,
                                                    GLenum attachment,
@@ -127,7 +170,9 @@ using PFNIGLFRAMEBUFFERTEXTUREMULTIVIEWPROC = void (*)(GLenum target,
                                                        GLsizei numViews);
 using PFNIGLGENERATEMIPMAPPROC = void (*)(GLenum target);
 using PFNIGLGENFRAMEBUFFERSPROC = void (*)(GLsizei n, GLuint* framebuffers);
+using PFNIGLGENQUERIESPROC = void (*)(GLsizei n, GLuint* ids);
 using PFNIGLGENRENDERBUFFERSPROC = void (*)(GLsizei n, GLuint* renderbuffers);
+using PFNIGLGENSAMPLERSPROC = void (*)(GLsizei n, GLuint* samplers);
 using PFNIGLGENVERTEXARRAYSPROC = void (*)(GLsizei n, GLuint* vertexArrays);
 using PFNIGLGETACTIVEUNIFORMSIVPROC = void (*)(GLuint program,
                                                GLsizei uniformCount,
@@ -147,6 +192,11 @@ using PFNIGLGETFRAMEBUFFERATTACHMENTPARAMETERIVPROC = void (*)(GLenum target,
                                                                GLenum attachment,
                                                                GLenum pname,
                                                                GLint* params);
+using PFNIGLGETPROGRAMBINARYPROC = void (*)(GLuint program,
+                                            GLsizei bufSize,
+                                            GLsizei* length,
+                                            GLenum* binaryFormat,
+                                            void* binary);
 using PFNIGLGETPROGRAMINTERFACEIVPROC = void (*)(GLuint program,
                                                  GLenum programInterface,
                                                  GLenum pname,
@@ -168,11 +218,14 @@ using PFNIGLGETPROGRAMRESOURCENAMEPROC = void (*)(GLuint program,
                                                   GLsizei bufSize,
                                                   GLsizei* length,
                                                   char* name);
+using PFNIGLGETQUERYOBJECTUI64VPROC = void (*)(GLuint id, GLenum pname, GLuint64* params);
+using PFNIGLGETQUERYOBJECTUIVPROC = void (*)(GLuint id, GLenum pname, GLuint* params);
 using PFNIGLGETRENDERBUFFERPARAMETERIVPROC = void (*)(GLenum target, GLenum pname, GLint* params);
 using PFNIGLGETSTRINGIPROC = const GLubyte* (*)(GLenum name, GLint index);
 using PFNIGLGETSYNCIVPROC =
     void (*)(GLsync sync, GLenum pname, GLsizei bufSize, GLsizei* length, GLint* values);
 using PFNIGLGETTEXTUREHANDLEPROC = GLuint64 (*)(GLuint texture);
+using PFNIGLGETTEXTURESAMPLERHANDLEPROC = GLuint64 (*)(GLuint texture, GLuint sampler);
 using PFNIGLGETUNIFORMBLOCKINDEXPROC = GLuint (*)(GLuint program, const GLchar* name);
 using PFNIGLIMPORTMEMORYFDPROC = void (*)(GLuint memory,
                                           GLuint64 size,
@@ -191,20 +244,30 @@ using PFNIGLMAPBUFFERRANGEPROC = void* (*)(GLenum target,
                                            GLintptr offset,
                                            GLsizeiptr length,
                                            GLbitfield access);
+using PFNIGLMAXSHADERCOMPILERTHREADSPROC = void (*)(GLuint count);
 using PFNIGLMEMORYBARRIERPROC = void (*)(GLbitfield barriers);
 using PFNIGLPOPDEBUGGROUPPROC = void (*)();
 using PFNIGLPOPGROUPMARKERPROC = void (*)();
+using PFNIGLPROGRAMBINARYPROC = void (*)(GLuint program,
+                                         GLenum binaryFormat,
+                                         const void* binary,
+                                         GLsizei length);
+using PFNIGLPROGRAMPARAMETERIPROC = void (*)(GLuint program, GLenum pname, GLint value);
 using PFNIGLPUSHDEBUGGROUPPROC = void (*)(GLenum source,
                                           GLuint id,
                                           GLsizei length,
                                           const GLchar* message);
 using PFNIGLPUSHGROUPMARKERPROC = void (*)(GLsizei length, const GLchar* marker);
+using PFNIGLQUERYCOUNTERPROC = void (*)(GLuint id, GLenum target);
 using PFNIGLRENDERBUFFERSTORAGEPROC = void (*)(GLenum target,
                                                GLenum internalformat,
                                                GLsizei width,
                                                GLsizei height);
 using PFNIGLRENDERBUFFERSTORAGEMULTISAMPLEPROC =
     void (*)(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height);
+using PFNIGLSAMPLERPARAMETERFPROC = void (*)(GLuint sampler, GLenum pname, GLfloat param);
+using PFNIGLSAMPLERPARAMETERIPROC = void (*)(GLuint sampler, GLenum pname, GLint param);
+using PFNIGLSHADINGRATEPROC = void (*)(GLenum rate);
 using PFNIGLTEXIMAGE3DPROC = void (*)(GLenum target,
                                       GLint level,
                                       GLint internalformat,
@@ -238,6 +301,12 @@ using PFNIGLTEXSTORAGE3DPROC = void (*)(GLenum target,
                                         GLsizei width,
                                         GLsizei height,
                                         GLsizei depth);
+using PFNIGLTEXSTORAGE2DMULTISAMPLEPROC = void (*)(GLenum target,
+                                                   GLsizei samples,
+                                                   GLenum internalformat,
+                                                   GLsizei width,
+                                                   GLsizei height,
+                                                   GLboolean fixedsamplelocations);
 using PFNIGLTEXSTORAGEMEM2DPROC = void (*)(GLenum target,
                                            GLsizei levels,
                                            GLenum internalFormat,
@@ -257,6 +326,8 @@ using PFNIGLUNIFORMBLOCKBINDINGPROC = void (*)(GLuint pid,
                                                GLuint uniformBlockIndex,
                                                GLuint uniformBlockBinding);
 using PFNIGLUNMAPBUFFERPROC = void (*)(GLenum target);
+using PFNIGLVERTEXATTRIBDIVISORPROC = void (*)(GLuint index, GLuint divisor);
+using PFNIGLWAITSYNCPROC = void (*)(GLsync sync, GLbitfield flags, GLuint64 timeout);
 
 ///--------------------------------------
 /// MARK: - OpenGL ES / OpenGL
@@ -328,21 +399,58 @@ void iglRenderbufferStorageMultisampleAPPLE(GLenum target,
 ///--------------------------------------
 /// MARK: - GL_APPLE_sync
 
+GLenum iglClientWaitSyncAPPLE(GLsync sync, GLbitfield flags, GLuint64 timeout);
 void iglDeleteSyncAPPLE(GLsync sync);
 GLsync iglFenceSyncAPPLE(GLenum condition, GLbitfield flags);
 void iglGetSyncivAPPLE(GLsync sync, GLenum pname, GLsizei bufSize, GLsizei* length, GLint* values);
+void iglWaitSyncAPPLE(GLsync sync, GLbitfield flags, GLuint64 timeout);
 
 ///--------------------------------------
 /// MARK: - GL_ARB_bindless_texture
 
 GLuint64 iglGetTextureHandleARB(GLuint texture);
+GLuint64 iglGetTextureSamplerHandleARB(GLuint texture, GLuint sampler);
 void iglMakeTextureHandleResidentARB(GLuint64 handle);
 void iglMakeTextureHandleNonResidentARB(GLuint64 handle);
 
+///--------------------------------------
+/// MARK: - GL_ARB_buffer_storage
+
+void iglBufferStorage(GLenum target, GLsizeiptr size, const GLvoid* data, GLbitfield flags);
+
 ///--------------------------------------
 /// MARK: - GL_ARB_compute_shader
 
 void iglDispatchCompute(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z);
+void iglDispatchComputeIndirect(GLintptr indirect);
+
+///--------------------------------------
+/// MARK: - GL_ARB_copy_buffer
+
+void iglCopyBufferSubData(GLenum readTarget,
+                          GLenum writeTarget,
+                          GLintptr readOffset,
+                          GLintptr writeOffset,
+                          GLsizeiptr size);
+
+///--------------------------------------
+/// MARK: - GL_ARB_copy_image
+
+void iglCopyImageSubData(GLuint srcName,
+                         GLenum srcTarget,
+                         GLint srcLevel,
+                         GLint srcX,
+                         GLint srcY,
+                         GLint srcZ,
+                         GLuint dstName,
+                         GLenum dstTarget,
+                         GLint dstLevel,
+                         GLint dstX,
+                         GLint dstY,
+                         GLint dstZ,
+                         GLsizei srcWidth,
+                         GLsizei srcHeight,
+                         GLsizei srcDepth);
 
 ///--------------------------------------
 /// MARK: - GL_ARB_draw_indirect
@@ -403,6 +511,28 @@ void iglRenderbufferStorageMultisample(GLenum target,
                                        GLsizei width,
                                        GLsizei height);
 
+///--------------------------------------
+/// MARK: - GL_ARB_get_program_binary
+
+void iglGetProgramBinary(GLuint program,
+                         GLsizei bufSize,
+                         GLsizei* length,
+                         GLenum* binaryFormat,
+                         void* binary);
+void iglProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+void iglProgramParameteri(GLuint program, GLenum pname, GLint value);
+
+///--------------------------------------
+/// MARK: - GL_ARB_instanced_arrays
+
+void iglDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
+void iglDrawElementsInstanced(GLenum mode,
+                              GLsizei count,
+                              GLenum type,
+                              const GLvoid* indices,
+                              GLsizei instancecount);
+void iglVertexAttribDivisor(GLuint index, GLuint divisor);
+
 ///--------------------------------------
 /// MARK: - GL_ARB_invalidate_subdata
 
@@ -413,6 +543,20 @@ void iglInvalidateFramebuffer(GLenum target, GLsizei numAttachments, const GLenu
 
 void* iglMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
 
+///--------------------------------------
+/// MARK: - GL_ARB_occlusion_query
+
+void iglBeginQuery(GLenum target, GLuint id);
+void iglDeleteQueries(GLsizei n, const GLuint* ids);
+void iglEndQuery(GLenum target);
+void iglGenQueries(GLsizei n, GLuint* ids);
+void iglGetQueryObjectuiv(GLuint id, GLenum pname, GLuint* params);
+
+///--------------------------------------
+/// MARK: - GL_ARB_parallel_shader_compile
+
+void iglMaxShaderCompilerThreadsARB(GLuint count);
+
 ///--------------------------------------
 /// MARK: - GL_ARB_program_interface_query
 
@@ -433,6 +577,14 @@ void iglGetProgramResourceName(GLuint program,
                                GLsizei* length,
                                char* name);
 
+///--------------------------------------
+/// MARK: - GL_ARB_sampler_objects
+
+void iglDeleteSamplers(GLsizei n, const GLuint* samplers);
+void iglGenSamplers(GLsizei n, GLuint* samplers);
+void iglSamplerParameterf(GLuint sampler, GLenum pname, GLfloat param);
+void iglSamplerParameteri(GLuint sampler, GLenum pname, GLint param);
+
 ///--------------------------------------
 /// MARK: - GL_ARB_shader_image_load_store
 
@@ -448,9 +600,11 @@ void iglMemoryBarrier(GLbitfield barriers);
 ///--------------------------------------
 /// MARK: - GL_ARB_sync
 
+GLenum iglClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
 void iglDeleteSync(GLsync sync);
 GLsync iglFenceSync(GLenum condition, GLbitfield flags);
 void iglGetSynciv(GLsync sync, GLenum pname, GLsizei bufSize, GLsizei* length, GLint* values);
+void iglWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
 
 ///--------------------------------------
 /// MARK: - GL_ARB_texture_storage
@@ -468,6 +622,22 @@ void iglTexStorage3D(GLenum target,
                      GLsizei height,
                      GLsizei depth);
 
+///--------------------------------------
+/// MARK: - GL_ARB_texture_storage_multisample
+
+void iglTexStorage2DMultisample(GLenum target,
+                                GLsizei samples,
+                                GLenum internalformat,
+                                GLsizei width,
+                                GLsizei height,
+                                GLboolean fixedsamplelocations);
+
+///--------------------------------------
+/// MARK: - GL_ARB_timer_query
+
+void iglGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params);
+void iglQueryCounter(GLuint id, GLenum target);
+
 ///--------------------------------------
 /// MARK: - GL_ARB_uniform_buffer_object
 
@@ -498,6 +668,11 @@ void iglBindVertexArray(GLuint vao);
 void iglDeleteVertexArrays(GLsizei n, const GLuint* vertexArrays);
 void iglGenVertexArrays(GLsizei n, GLuint* vertexArrays);
 
+///--------------------------------------
+/// MARK: - GL_EXT_buffer_storage
+
+void iglBufferStorageEXT(GLenum target, GLsizeiptr size, const GLvoid* data, GLbitfield flags);
+
 ///--------------------------------------
 /// MARK: - GL_EXT_debug_marker
 
@@ -518,6 +693,14 @@ void iglPushGroupMarkerEXT(GLenum source, GLuint id, GLsizei length, const GLcha
 
 void iglDiscardFramebufferEXT(GLenum target, GLsizei numAttachments, const GLenum* attachments);
 
+///--------------------------------------
+/// MARK: - GL_EXT_disjoint_timer_query
+
+void iglDeleteQueriesEXT(GLsizei n, const GLuint* ids);
+void iglGenQueriesEXT(GLsizei n, GLuint* ids);
+void iglGetQueryObjectui64vEXT(GLuint id, GLenum pname, GLuint64* params);
+void iglQueryCounterEXT(GLuint id, GLenum target);
+
 ///--------------------------------------
 /// MARK: - GL_EXT_draw_buffers
 
@@ -583,6 +766,13 @@ void iglRenderbufferStorageMultisampleEXT(GLenum target,
                                           GLsizei width,
                                           GLsizei height);
 
+///--------------------------------------
+/// MARK: - GL_EXT_occlusion_query_boolean
+
+void iglBeginQueryEXT(GLenum target, GLuint id);
+void iglEndQueryEXT(GLenum target);
+void iglGetQueryObjectuivEXT(GLuint id, GLenum pname, GLuint* params);
+
 ///--------------------------------------
 /// MARK: - GL_EXT_shader_image_load_store
 
@@ -638,10 +828,16 @@ void iglDebugMessageInsertKHR(GLenum source,
 void iglPopDebugGroupKHR();
 void iglPushDebugGroupKHR(GLenum source, GLuint id, GLsizei length, const GLchar* message);
 
+///--------------------------------------
+/// MARK: - GL_KHR_parallel_shader_compile
+
+void iglMaxShaderCompilerThreadsKHR(GLuint count);
+
 ///--------------------------------------
 /// MARK: - GL_NV_bindless_texture
 
 GLuint64 iglGetTextureHandleNV(GLuint texture);
+GLuint64 iglGetTextureSamplerHandleNV(GLuint texture, GLuint sampler);
 void iglMakeTextureHandleResidentNV(GLuint64 handle);
 void iglMakeTextureHandleNonResidentNV(GLuint64 handle);
 
@@ -665,6 +861,11 @@ void iglFramebufferTextureMultisampleMultiviewOVR(GLenum target,
                                                   GLsizei samples,
                                                   GLint baseViewIndex,
                                                   GLsizei numViews);
+///--------------------------------------
+/// MARK: - GL_OES_EGL_image
+
+void iglEGLImageTargetTexture2DOES(GLenum target, void* image);
+
 ///--------------------------------------
 /// MARK: - GL_OES_mapbuffer
 
@@ -723,4 +924,196 @@ void iglBindVertexArrayOES(GLuint vao);
 void iglDeleteVertexArraysOES(GLsizei n, const GLuint* vertexArrays);
 void iglGenVertexArraysOES(GLsizei n, GLuint* vertexArrays);
 
+///--------------------------------------
+/// MARK: - GL_QCOM_shading_rate
+
+void iglShadingRateQCOM(GLenum rate);
+
 IGL_EXTERN_END
+
+// All of the functions above as X(Name, funcType), where igl##Name is the wrapper and gl##Name the
+// function it calls.
+#define IGL_GL_FUNCTIONS(X)                                                                      \
+  X(DebugMessageInsert, PFNIGLDEBUGMESSAGEINSERTPROC)                                            \
+  X(ClearDepth, PFNIGLCLEARDEPTHPROC)                                                            \
+  X(CompressedTexImage3D, PFNIGLCOMPRESSEDTEXIMAGE3DPROC)                                        \
+  X(CompressedTexSubImage3D, PFNIGLCOMPRESSEDTEXSUBIMAGE3DPROC)                                  \
+  X(DrawBuffers, PFNIGLDRAWBUFFERSPROC)                                                          \
+  X(GetStringi, PFNIGLGETSTRINGIPROC)                                                            \
+  X(MapBuffer, PFNIGLMAPBUFFERPROC)                                                              \
+  X(PopDebugGroup, PFNIGLPOPDEBUGGROUPPROC)                                                      \
+  X(PushDebugGroup, PFNIGLPUSHDEBUGGROUPPROC)                                                    \
+  X(TexImage3D, PFNIGLTEXIMAGE3DPROC)                                                            \
+  X(TexSubImage3D, PFNIGLTEXSUBIMAGE3DPROC)                                                      \
+  X(UnmapBuffer, PFNIGLUNMAPBUFFERPROC)                                                          \
+  X(RenderbufferStorageMultisampleAPPLE, PFNIGLRENDERBUFFERSTORAGEMULTISAMPLEPROC)               \
+  X(ClientWaitSyncAPPLE, PFNIGLCLIENTWAITSYNCPROC)                                               \
+  X(DeleteSyncAPPLE, PFNIGLDELETESYNCPROC)                                                       \
+  X(FenceSyncAPPLE, PFNIGLFENCESYNCPROC)                                                         \
+  X(GetSyncivAPPLE, PFNIGLGETSYNCIVPROC)                                                         \
+  X(WaitSyncAPPLE, PFNIGLWAITSYNCPROC)                                                           \
+  X(GetTextureHandleARB, PFNIGLGETTEXTUREHANDLEPROC)                                             \
+  X(GetTextureSamplerHandleARB, PFNIGLGETTEXTURESAMPLERHANDLEPROC)                               \
+  X(MakeTextureHandleResidentARB, PFNIGLMAKETEXTUREHANDLERESIDENTPROC)                           \
+  X(MakeTextureHandleNonResidentARB, PFNIGLMAKETEXTUREHANDLENONRESIDENTPROC)                     \
+  X(BufferStorage, PFNIGLBUFFERSTORAGEPROC)                                                      \
+  X(DispatchCompute, PFNIGLDISPATCHCOMPUTEPROC)                                                  \
+  X(DispatchComputeIndirect, PFNIGLDISPATCHCOMPUTEINDIRECTPROC)                                  \
+  X(CopyBufferSubData, PFNIGLCOPYBUFFERSUBDATAPROC)                                              \
+  X(CopyImageSubData, PFNIGLCOPYIMAGESUBDATAPROC)                                                \
+  X(DrawElementsIndirect, PFNIGLDRAWELEMENTSINDIRECTPROC)                                        \
+  X(ClearDepthf, PFNIGLCLEARDEPTHFPROC)                                                          \
+  X(BindFramebuffer, PFNIGLBINDFRAMEBUFFERPROC)                                                  \
+  X(BindRenderbuffer, PFNIGLBINDRENDERBUFFERPROC)                                                \
+  X(BlitFramebuffer, PFNIGLBLITFRAMEBUFFERPROC)                                                  \
+  X(CheckFramebufferStatus, PFNIGLCHECKFRAMEBUFFERSTATUSPROC)                                    \
+  X(DeleteFramebuffers, PFNIGLDELETEFRAMEBUFFERSPROC)                                            \
+  X(DeleteRenderbuffers, PFNIGLDELETERENDERBUFFERSPROC)                                          \
+  X(FramebufferRenderbuffer, PFNIGLFRAMEBUFFERRENDERBUFFERPROC)                                  \
+  X(FramebufferTexture2D, PFNIGLFRAMEBUFFERTEXTURE2DPROC)                                        \
+  X(FramebufferTextureLayer, PFNIGLFRAMEBUFFERTEXTURELAYERPROC)                                  \
+  X(GenerateMipmap, PFNIGLGENERATEMIPMAPPROC)                                                    \
+  X(GenFramebuffers, PFNIGLGENFRAMEBUFFERSPROC)                                                  \
+  X(GenRenderbuffers, PFNIGLGENRENDERBUFFERSPROC)                                                \
+  X(GetFramebufferAttachmentParameteriv, PFNIGLGETFRAMEBUFFERATTACHMENTPARAMETERIVPROC)          \
+  X(GetRenderbufferParameteriv, PFNIGLGETRENDERBUFFERPARAMETERIVPROC)                            \
+  X(IsFramebuffer, PFNIGLISFRAMEBUFFERPROC)                                                      \
+  X(IsRenderbuffer, PFNIGLISRENDERBUFFERPROC)                                                    \
+  X(RenderbufferStorage, PFNIGLRENDERBUFFERSTORAGEPROC)                                          \
+  X(RenderbufferStorageMultisample, PFNIGLRENDERBUFFERSTORAGEMULTISAMPLEPROC)                    \
+  X(GetProgramBinary, PFNIGLGETPROGRAMBINARYPROC)                                                \
+  X(ProgramBinary, PFNIGLPROGRAMBINARYPROC)                                                      \
+  X(ProgramParameteri, PFNIGLPROGRAMPARAMETERIPROC)                                              \
+  X(DrawArraysInstanced, PFNIGLDRAWARRAYSINSTANCEDPROC)                                          \
+  X(DrawElementsInstanced, PFNIGLDRAWELEMENTSINSTANCEDPROC)                                      \
+  X(VertexAttribDivisor, PFNIGLVERTEXATTRIBDIVISORPROC)                                          \
+  X(InvalidateFramebuffer, PFNIGLINVALIDATEFRAMEBUFFERPROC)                                      \
+  X(MapBufferRange, PFNIGLMAPBUFFERRANGEPROC)                                                    \
+  X(BeginQuery, PFNIGLBEGINQUERYPROC)                                                            \
+  X(DeleteQueries, PFNIGLDELETEQUERIESPROC)                                                      \
+  X(EndQuery, PFNIGLENDQUERYPROC)                                                                \
+  X(GenQueries, PFNIGLGENQUERIESPROC)                                                            \
+  X(GetQueryObjectuiv, PFNIGLGETQUERYOBJECTUIVPROC)                                              \
+  X(MaxShaderCompilerThreadsARB, PFNIGLMAXSHADERCOMPILERTHREADSPROC)                             \
+  X(GetProgramInterfaceiv, PFNIGLGETPROGRAMINTERFACEIVPROC)                                      \
+  X(GetProgramResourceIndex, PFNIGLGETPROGRAMRESOURCEINDEXPROC)                                  \
+  X(GetProgramResourceiv, PFNIGLGETPROGRAMRESOURCEIVPROC)                                        \
+  X(GetProgramResourceName, PFNIGLGETPROGRAMRESOURCENAMEPROC)                                    \
+  X(DeleteSamplers, PFNIGLDELETESAMPLERSPROC)                                                    \
+  X(GenSamplers, PFNIGLGENSAMPLERSPROC)                                                          \
+  X(SamplerParameterf, PFNIGLSAMPLERPARAMETERFPROC)                                              \
+  X(SamplerParameteri, PFNIGLSAMPLERPARAMETERIPROC)                                              \
+  X(BindImageTexture, PFNIGLBINDIMAGETEXTUREPROC)                                                \
+  X(MemoryBarrier, PFNIGLMEMORYBARRIERPROC)                                                      \
+  X(ClientWaitSync, PFNIGLCLIENTWAITSYNCPROC)                                                    \
+  X(DeleteSync, PFNIGLDELETESYNCPROC)                                                            \
+  X(FenceSync, PFNIGLFENCESYNCPROC)                                                              \
+  X(GetSynciv, PFNIGLGETSYNCIVPROC)                                                              \
+  X(WaitSync, PFNIGLWAITSYNCPROC)                                                                \
+  X(TexStorage1D, PFNIGLTEXSTORAGE1DPROC)                                                        \
+  X(TexStorage2D, PFNIGLTEXSTORAGE2DPROC)                                                        \
+  X(TexStorage3D, PFNIGLTEXSTORAGE3DPROC)                                                        \
+  X(TexStorage2DMultisample, PFNIGLTEXSTORAGE2DMULTISAMPLEPROC)                                  \
+  X(GetQueryObjectui64v, PFNIGLGETQUERYOBJECTUI64VPROC)                                          \
+  X(QueryCounter, PFNIGLQUERYCOUNTERPROC)                                                        \
+  X(BindBufferBase, PFNIGLBINDBUFFERBASEPROC)                                                    \
+  X(BindBufferRange, PFNIGLBINDBUFFERRANGEPROC)                                                  \
+  X(GetActiveUniformsiv, PFNIGLGETACTIVEUNIFORMSIVPROC)                                          \
+  X(GetActiveUniformBlockiv, PFNIGLGETACTIVEUNIFORMBLOCKIVPROC)                                  \
+  X(GetActiveUniformBlockName, PFNIGLGETACTIVEUNIFORMBLOCKNAMEPROC)                              \
+  X(GetUniformBlockIndex, PFNIGLGETUNIFORMBLOCKINDEXPROC)                                        \
+  X(UniformBlockBinding, PFNIGLUNIFORMBLOCKBINDINGPROC)                                          \
+  X(BindVertexArray, PFNIGLBINDVERTEXARRAYPROC)                                                  \
+  X(DeleteVertexArrays, PFNIGLDELETEVERTEXARRAYSPROC)                                            \
+  X(GenVertexArrays, PFNIGLGENVERTEXARRAYSPROC)                                                  \
+  X(BufferStorageEXT, PFNIGLBUFFERSTORAGEPROC)                                                   \
+  X(InsertEventMarkerEXT, PFNIGLINSERTEVENTMARKERPROC)                                           \
+  X(PopGroupMarkerEXT, PFNIGLPOPGROUPMARKERPROC)                                                 \
+  X(PushGroupMarkerEXT, PFNIGLPUSHGROUPMARKERPROC)                                               \
+  X(DiscardFramebufferEXT, PFNIGLDISCARDFRAMEBUFFERPROC)                                         \
+  X(DeleteQueriesEXT, PFNIGLDELETEQUERIESPROC)                                                   \
+  X(GenQueriesEXT, PFNIGLGENQUERIESPROC)                                                         \
+  X(GetQueryObjectui64vEXT, PFNIGLGETQUERYOBJECTUI64VPROC)                                       \
+  X(QueryCounterEXT, PFNIGLQUERYCOUNTERPROC)                                                     \
+  X(DrawBuffersEXT, PFNIGLDRAWBUFFERSPROC)                                                       \
+  X(BlitFramebufferEXT, PFNIGLBLITFRAMEBUFFERPROC)                                               \
+  X(MapBufferRangeEXT, PFNIGLMAPBUFFERRANGEPROC)                                                 \
+  X(CreateMemoryObjectsEXT, PFNIGLCREATEMEMORYOBJECTSPROC)                                       \
+  X(DeleteMemoryObjectsEXT, PFNIGLDELETEMEMORYOBJECTSPROC)                                       \
+  X(TexStorageMem2DEXT, PFNIGLTEXSTORAGEMEM2DPROC)                                               \
+  X(TexStorageMem3DEXT, PFNIGLTEXSTORAGEMEM3DPROC)                                               \
+  X(ImportMemoryFdEXT, PFNIGLIMPORTMEMORYFDPROC)                                                 \
+  X(FramebufferTexture2DMultisampleEXT, PFNIGLFRAMEBUFFERTEXTURE2DMULTISAMPLEPROC)               \
+  X(RenderbufferStorageMultisampleEXT, PFNIGLRENDERBUFFERSTORAGEMULTISAMPLEPROC)                 \
+  X(BeginQueryEXT, PFNIGLBEGINQUERYPROC)                                                         \
+  X(EndQueryEXT, PFNIGLENDQUERYPROC)                                                             \
+  X(GetQueryObjectuivEXT, PFNIGLGETQUERYOBJECTUIVPROC)                                           \
+  X(BindImageTextureEXT, PFNIGLBINDIMAGETEXTUREPROC)                                             \
+  X(MemoryBarrierEXT, PFNIGLMEMORYBARRIERPROC)                                                   \
+  X(TexStorage1DEXT, PFNIGLTEXSTORAGE1DPROC)                                                     \
+  X(TexStorage2DEXT, PFNIGLTEXSTORAGE2DPROC)                                                     \
+  X(TexStorage3DEXT, PFNIGLTEXSTORAGE3DPROC)                                                     \
+  X(FramebufferTexture2DMultisampleIMG, PFNIGLFRAMEBUFFERTEXTURE2DMULTISAMPLEPROC)               \
+  X(RenderbufferStorageMultisampleIMG, PFNIGLRENDERBUFFERSTORAGEMULTISAMPLEPROC)                 \
+  X(DebugMessageInsertKHR, PFNIGLDEBUGMESSAGEINSERTPROC)                                         \
+  X(PopDebugGroupKHR, PFNIGLPOPDEBUGGROUPPROC)                                                   \
+  X(PushDebugGroupKHR, PFNIGLPUSHDEBUGGROUPPROC)                                                 \
+  X(MaxShaderCompilerThreadsKHR, PFNIGLMAXSHADERCOMPILERTHREADSPROC)                             \
+  X(GetTextureHandleNV, PFNIGLGETTEXTUREHANDLEPROC)                                              \
+  X(GetTextureSamplerHandleNV, PFNIGLGETTEXTURESAMPLERHANDLEPROC)                                \
+  X(MakeTextureHandleResidentNV, PFNIGLMAKETEXTUREHANDLERESIDENTPROC)                            \
+  X(MakeTextureHandleNonResidentNV, PFNIGLMAKETEXTUREHANDLENONRESIDENTPROC)                      \
+  X(FramebufferTextureMultiviewOVR, PFNIGLFRAMEBUFFERTEXTUREMULTIVIEWPROC)                       \
+  X(FramebufferTextureMultisampleMultiviewOVR, PFNIGLFRAMEBUFFERTEXTUREMULTISAMPLEMULTIVIEWPROC) \
+  X(EGLImageTargetTexture2DOES, PFNIGLEGLIMAGETARGETTEXTURE2DPROC)                               \
+  X(MapBufferOES, PFNIGLMAPBUFFERPROC)                                                           \
+  X(UnmapBufferOES, PFNIGLUNMAPBUFFERPROC)                                                       \
+  X(CompressedTexImage3DOES, PFNIGLCOMPRESSEDTEXIMAGE3DPROC)                                     \
+  X(CompressedTexSubImage3DOES, PFNIGLCOMPRESSEDTEXSUBIMAGE3DPROC)                               \
+  X(TexImage3DOES, PFNIGLTEXIMAGE3DPROC)                                                         \
+  X(TexSubImage3DOES, PFNIGLTEXSUBIMAGE3DPROC)                                                   \
+  X(BindVertexArrayOES, PFNIGLBINDVERTEXARRAYPROC)                                               \
+  X(DeleteVertexArraysOES, PFNIGLDELETEVERTEXARRAYSPROC)                                         \
+  X(GenVertexArraysOES, PFNIGLGENVERTEXARRAYSPROC)                                               \
+  X(ShadingRateQCOM, PFNIGLSHADINGRATEPROC)
+
+namespace igl {
+namespace opengl {
+
+/// Identifies a function in GLDispatchTable.
+enum class GLFunction : uint16_t {
+#define IGL_GL_FUNCTION_ENUM(name, funcType) name,
+  IGL_GL_FUNCTIONS(IGL_GL_FUNCTION_ENUM)
+#undef IGL_GL_FUNCTION_ENUM
+};
+
+#define IGL_GL_FUNCTION_COUNT(name, funcType) +1
+constexpr size_t kNumGLFunctions = 0 IGL_GL_FUNCTIONS(IGL_GL_FUNCTION_COUNT);
+#undef IGL_GL_FUNCTION_COUNT
+
+/**
+ * @brief Function pointers for the igl* wrappers above, resolved once per context by load().
+ *
+ * Calling through the table jumps straight to the GL function: there is no per-call check whether
+ * it has been loaded yet, and the pointers are not shared with other contexts. Functions which are
+ * not available point to their igl* wrapper instead, which asserts when called, so the pointers are
+ * never null. Use isAvailable() to find out whether a function was resolved.
+ */
+struct GLDispatchTable {
+#define IGL_GL_FUNCTION_POINTER(name, funcType) decltype(&igl##name) name = nullptr;
+  IGL_GL_FUNCTIONS(IGL_GL_FUNCTION_POINTER)
+#undef IGL_GL_FUNCTION_POINTER
+
+  /// Resolves all functions. The context they belong to must be current.
+  void load();
+
+  bool isAvailable(GLFunction function) const {
+    return available_.test(static_cast<size_t>(function));
+  }
+
+ private:
+  std::bitset<kNumGLFunctions> available_;
+};
+
+} // namespace opengl
+} // namespace igl
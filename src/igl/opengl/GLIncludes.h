@@ -103,6 +103,12 @@
 #ifndef GL_ALPHA8
 #define GL_ALPHA8 0x803C
 #endif
+#ifndef GL_ALREADY_SIGNALED
+#define GL_ALREADY_SIGNALED 0x911a
+#endif
+#ifndef GL_ANY_SAMPLES_PASSED
+#define GL_ANY_SAMPLES_PASSED 0x8c2f
+#endif
 #ifndef GL_BLUE
 #define GL_BLUE 0x1905
 #endif
@@ -124,12 +130,21 @@
 #ifndef GL_BUFFER_UPDATE_BARRIER_BIT
 #define GL_BUFFER_UPDATE_BARRIER_BIT 0x200
 #endif
+#ifndef GL_COLOR
+#define GL_COLOR 0x1800
+#endif
 #ifndef GL_COLOR_ATTACHMENT1
 #define GL_COLOR_ATTACHMENT1 0x8ce1
 #endif
+#ifndef GL_COMMAND_BARRIER_BIT
+#define GL_COMMAND_BARRIER_BIT 0x40
+#endif
 #ifndef GL_COMPARE_REF_TO_TEXTURE
 #define GL_COMPARE_REF_TO_TEXTURE 0x884e
 #endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91b1
+#endif
 #ifndef GL_COMPRESSED_R11_EAC
 #define GL_COMPRESSED_R11_EAC 0x9270
 #endif
@@ -265,6 +280,9 @@
 #ifndef GL_COMPUTE_SHADER
 #define GL_COMPUTE_SHADER 0x91B9
 #endif
+#ifndef GL_CONDITION_SATISFIED
+#define GL_CONDITION_SATISFIED 0x911c
+#endif
 #ifndef GL_COPY_READ_BUFFER
 #define GL_COPY_READ_BUFFER 0x8f36
 #endif
@@ -298,6 +316,9 @@
 #ifndef GL_DEPTH32F_STENCIL8
 #define GL_DEPTH32F_STENCIL8 0x8CAD
 #endif
+#ifndef GL_DISPATCH_INDIRECT_BUFFER
+#define GL_DISPATCH_INDIRECT_BUFFER 0x90EE
+#endif
 #ifndef GL_DRAW_FRAMEBUFFER
 #define GL_DRAW_FRAMEBUFFER 0x8CA9
 #endif
@@ -430,9 +451,27 @@
 #ifndef GL_LUMINANCE8_ALPHA8
 #define GL_LUMINANCE8_ALPHA8 0x8045
 #endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x80
+#endif
+#ifndef GL_MAP_INVALIDATE_BUFFER_BIT
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x8
+#endif
+#ifndef GL_MAP_INVALIDATE_RANGE_BIT
+#define GL_MAP_INVALIDATE_RANGE_BIT 0x4
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x40
+#endif
 #ifndef GL_MAP_READ_BIT
 #define GL_MAP_READ_BIT 0x1
 #endif
+#ifndef GL_MAP_UNSYNCHRONIZED_BIT
+#define GL_MAP_UNSYNCHRONIZED_BIT 0x20
+#endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x2
+#endif
 #ifndef GL_MAX
 #define GL_MAX 0x8008
 #endif
@@ -469,12 +508,30 @@
 #ifndef GL_NUM_EXTENSIONS
 #define GL_NUM_EXTENSIONS 0x821d
 #endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87fe
+#endif
 #ifndef GL_PIXEL_PACK_BUFFER
 #define GL_PIXEL_PACK_BUFFER 0x88eb
 #endif
 #ifndef GL_PIXEL_UNPACK_BUFFER
 #define GL_PIXEL_UNPACK_BUFFER 0x88ec
 #endif
+#ifndef GL_PROGRAM_BINARY_FORMATS
+#define GL_PROGRAM_BINARY_FORMATS 0x87ff
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
 #ifndef GL_R16
 #define GL_R16 0x822A
 #endif
@@ -562,6 +619,9 @@
 #ifndef GL_RGBA8
 #define GL_RGBA8 0x8058
 #endif
+#ifndef GL_SAMPLES_PASSED
+#define GL_SAMPLES_PASSED 0x8914
+#endif
 #ifndef GL_SAMPLER_1D
 #define GL_SAMPLER_1D 0x8B5D
 #endif
@@ -577,6 +637,9 @@
 #ifndef GL_SAMPLER_EXTERNAL_OES
 #define GL_SAMPLER_EXTERNAL_OES 0x8D66
 #endif
+#ifndef GL_SHADER_IMAGE_ACCESS_BARRIER_BIT
+#define GL_SHADER_IMAGE_ACCESS_BARRIER_BIT 0x20
+#endif
 #ifndef GL_SHADER_STORAGE_BARRIER_BIT
 #define GL_SHADER_STORAGE_BARRIER_BIT 0x2000
 #endif
@@ -586,6 +649,24 @@
 #ifndef GL_SHADER_STORAGE_BUFFER
 #define GL_SHADER_STORAGE_BUFFER 0x90d2
 #endif
+#ifndef GL_SHADING_RATE_1X1_PIXELS_QCOM
+#define GL_SHADING_RATE_1X1_PIXELS_QCOM 0x96A6
+#endif
+#ifndef GL_SHADING_RATE_1X2_PIXELS_QCOM
+#define GL_SHADING_RATE_1X2_PIXELS_QCOM 0x96A7
+#endif
+#ifndef GL_SHADING_RATE_2X1_PIXELS_QCOM
+#define GL_SHADING_RATE_2X1_PIXELS_QCOM 0x96A8
+#endif
+#ifndef GL_SHADING_RATE_2X2_PIXELS_QCOM
+#define GL_SHADING_RATE_2X2_PIXELS_QCOM 0x96A9
+#endif
+#ifndef GL_SHADING_RATE_4X2_PIXELS_QCOM
+#define GL_SHADING_RATE_4X2_PIXELS_QCOM 0x96AC
+#endif
+#ifndef GL_SHADING_RATE_4X4_PIXELS_QCOM
+#define GL_SHADING_RATE_4X4_PIXELS_QCOM 0x96AE
+#endif
 #ifndef GL_SIGNALED
 #define GL_SIGNALED 0x9119
 #endif
@@ -622,6 +703,9 @@
 #ifndef GL_STREAM_READ
 #define GL_STREAM_READ 0x88e1
 #endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x1
+#endif
 #ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
 #define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
 #endif
@@ -682,9 +766,21 @@
 #ifndef GL_TEXTURE_WRAP_R
 #define GL_TEXTURE_WRAP_R 0x8072
 #endif
+#ifndef GL_TIMEOUT_EXPIRED
+#define GL_TIMEOUT_EXPIRED 0x911b
+#endif
+#ifndef GL_TIMEOUT_IGNORED
+#define GL_TIMEOUT_IGNORED 0xffffffffffffffffull
+#endif
+#ifndef GL_TIMESTAMP
+#define GL_TIMESTAMP 0x8e28
+#endif
 #ifndef GL_TRANSFORM_FEEDBACK_BUFFER
 #define GL_TRANSFORM_FEEDBACK_BUFFER 0x8c8e
 #endif
+#ifndef GL_UNIFORM_ARRAY_STRIDE
+#define GL_UNIFORM_ARRAY_STRIDE 0x8a3c
+#endif
 #ifndef GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES
 #define GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES 0x8a43
 #endif
@@ -700,6 +796,12 @@
 #ifndef GL_UNIFORM_BUFFER
 #define GL_UNIFORM_BUFFER 0x8a11
 #endif
+#ifndef GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+#define GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 0x8a34
+#endif
+#ifndef GL_UNIFORM_MATRIX_STRIDE
+#define GL_UNIFORM_MATRIX_STRIDE 0x8a3d
+#endif
 #ifndef GL_UNIFORM_OFFSET
 #define GL_UNIFORM_OFFSET 0x8a3b
 #endif
@@ -739,3 +841,6 @@
 #ifndef GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT
 #define GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT 0x1
 #endif
+#ifndef GL_WAIT_FAILED
+#define GL_WAIT_FAILED 0x911d
+#endif
@@ -8,15 +8,23 @@
 #include <igl/DeviceFeatures.h>
 #include <igl/opengl/IContext.h>
 
+#include <algorithm>
 #include <cstring>
 #include <igl/Assert.h>
+#include <igl/opengl/BindlessTextureBlock.h>
 #include <igl/opengl/Errors.h>
 #include <igl/opengl/GLFunc.h>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/Macros.h>
+#include <igl/opengl/PackedUniformRing.h>
+#include <igl/opengl/PixelUnpackBufferRing.h>
+#include <igl/opengl/PushConstantBlock.h>
+#include <igl/opengl/ProgramBinaryCache.h>
+#include <igl/opengl/VertexArrayCache.h>
 #include <optional>
 #include <sstream>
 #include <string>
+#include <unordered_set>
 
 // Uncomment to enable GL API logging
 // #define IGL_API_LOG
@@ -35,50 +43,78 @@
 #define APILOG(format, ...) static_cast<void>(0)
 #endif // defined(IGL_API_LOG) && (IGL_DEBUG || defined(IGL_FORCE_ENABLE_LOGS))
 
-#define GLCALL(funcName)                                         \
-  IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup()); \
+// Querying the current context costs a platform call (eglGetCurrentContext() etc.) per GL call, so
+// it is only checked in debug builds or when IGL_GL_VERIFY_CURRENT_CONTEXT is defined.
+#if IGL_DEBUG || defined(IGL_GL_VERIFY_CURRENT_CONTEXT)
+#define IGL_VERIFY_CURRENT_CONTEXT() \
+  IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup())
+#else
+#define IGL_VERIFY_CURRENT_CONTEXT() static_cast<void>(0)
+#endif
+
+// Counts every call, and the calls of every entry point while enableCallCountsByName() is on
+#define GLCALL_COUNT()                                            \
   callCounter_++;                                                \
+  if (callCountsByName_) {                                       \
+    (*callCountsByName_)[__func__]++;                            \
+  }
+
+#define GLCALL(funcName)                                         \
+  IGL_VERIFY_CURRENT_CONTEXT();                                  \
+  GLCALL_COUNT();                                                \
   gl##funcName
 
 #define IGLCALL(funcName)                                        \
-  IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup()); \
-  callCounter_++;                                                \
-  igl##funcName
+  IGL_VERIFY_CURRENT_CONTEXT();                                  \
+  GLCALL_COUNT();                                                \
+  glDispatch_.funcName
 
 #define GLCALL_WITH_RETURN(ret, funcName)                        \
-  IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup()); \
-  callCounter_++;                                                \
+  IGL_VERIFY_CURRENT_CONTEXT();                                  \
+  GLCALL_COUNT();                                                \
   ret = gl##funcName
 
 #define IGLCALL_WITH_RETURN(ret, funcName)                       \
-  IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup()); \
-  callCounter_++;                                                \
-  ret = igl##funcName
+  IGL_VERIFY_CURRENT_CONTEXT();                                  \
+  GLCALL_COUNT();                                                \
+  ret = glDispatch_.funcName
 
 #define GLCALL_PROC(funcPtr, ...)                                \
-  IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup()); \
+  IGL_VERIFY_CURRENT_CONTEXT();                                  \
   if (funcPtr) {                                                 \
-    callCounter_++;                                              \
+    GLCALL_COUNT();                                              \
     (*funcPtr)(__VA_ARGS__);                                     \
   }
 
 #define GLCALL_PROC_WITH_RETURN(ret, funcPtr, returnOnError, ...) \
-  IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup());  \
+  IGL_VERIFY_CURRENT_CONTEXT();                                   \
   if (funcPtr) {                                                  \
-    callCounter_++;                                               \
+    GLCALL_COUNT();                                               \
     ret = (*funcPtr)(__VA_ARGS__);                                \
   } else {                                                        \
     ret = returnOnError;                                          \
   }
 
+// Sampled error checking costs one compare per call while it is disabled
+#define GLCHECK_SAMPLED_ERRORS()                                  \
+  if (errorCheckCountdown_ != 0 && --errorCheckCountdown_ == 0) { \
+    sampleErrors(__FUNCTION__, __LINE__);                         \
+  }
+
 #if IGL_DEBUG
 #define GLCHECK_ERRORS()                      \
   do {                                        \
-    if (alwaysCheckError_)                    \
+    if (alwaysCheckError_) {                  \
       checkForErrors(__FUNCTION__, __LINE__); \
+    } else {                                  \
+      GLCHECK_SAMPLED_ERRORS()                \
+    }                                         \
   } while (false)
 #else
-#define GLCHECK_ERRORS()
+#define GLCHECK_ERRORS()     \
+  do {                       \
+    GLCHECK_SAMPLED_ERRORS() \
+  } while (false)
 #endif // IGL_DEBUG
 
 #define RESULT_CASE(res) \
@@ -200,6 +236,7 @@ std::string GLenumToString(GLenum code) {
     RESULT_CASE(GL_DEPTH24_STENCIL8)
     RESULT_CASE(GL_DEPTH32F_STENCIL8)
     RESULT_CASE(GL_DEPTH_TEST)
+    RESULT_CASE(GL_DISPATCH_INDIRECT_BUFFER)
     RESULT_CASE(GL_DITHER)
     RESULT_CASE(GL_DONT_CARE)
     RESULT_CASE(GL_DRAW_FRAMEBUFFER)
@@ -555,6 +592,7 @@ IContext::~IContext() {
   );
   // Clear the zombie guard explicitly so our "secret" stays secret.
   zombieGuard_ = 0;
+  saveProgramBinaryCache();
 }
 
 // Creates a global map to ensure multiple IContexts are not created for a single glContext
@@ -588,6 +626,15 @@ void IContext::unregisterContext(void* glContext) {
 #endif
 }
 
+void IContext::presentWithDamage(std::shared_ptr<ITexture> surface,
+                                 const std::vector<ScissorRect>& /*damage*/) const {
+  present(std::move(surface));
+}
+
+bool IContext::setSwapInterval(int /*interval*/) {
+  return false;
+}
+
 void IContext::flushDeletionQueue() {
   deletionQueues_.flushDeletionQueue(*this);
 }
@@ -597,6 +644,12 @@ bool IContext::shouldQueueAPI() const {
 }
 
 void IContext::activeTexture(GLenum texture) {
+  if (stateCacheEnabled_) {
+    if (stateCache_.activeTexture == texture) {
+      return;
+    }
+    stateCache_.activeTexture = texture;
+  }
   GLCALL(ActiveTexture)(texture);
   APILOG("glActiveTexture(%s)\n", GL_ENUM_TO_STRING(texture));
   GLCHECK_ERRORS();
@@ -608,6 +661,22 @@ void IContext::attachShader(GLuint program, GLuint shader) {
   GLCHECK_ERRORS();
 }
 
+void IContext::beginQuery(GLenum target, GLuint id) {
+  if (beginQueryProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::OcclusionQueryExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::OcclusionQueryBoolean)) {
+        beginQueryProc_ = glDispatch_.BeginQueryEXT;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::OcclusionQuery)) {
+      beginQueryProc_ = glDispatch_.BeginQuery;
+    }
+  }
+
+  GLCALL_PROC(beginQueryProc_, target, id);
+  APILOG("glBeginQuery(%s, %u)\n", GL_ENUM_TO_STRING(target), id);
+  GLCHECK_ERRORS();
+}
+
 void IContext::bindAttribLocation(GLuint program, GLuint index, const GLchar* name) {
   GLCALL(BindAttribLocation)(program, index, name);
   APILOG("glBindAttribLocation(%u, %u, %s)\n", program, index, name);
@@ -615,12 +684,23 @@ void IContext::bindAttribLocation(GLuint program, GLuint index, const GLchar* na
 }
 
 void IContext::bindBuffer(GLenum target, GLuint buffer) {
+  if (stateCacheEnabled_) {
+    auto it = stateCache_.buffers.find(target);
+    if (it != stateCache_.buffers.end() && it->second == buffer) {
+      return;
+    }
+    stateCache_.buffers[target] = buffer;
+  }
   GLCALL(BindBuffer)(target, buffer);
   APILOG("glBindBuffer(%s, %u)\n", GL_ENUM_TO_STRING(target), buffer);
   GLCHECK_ERRORS();
 }
 
 void IContext::bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+  if (stateCacheEnabled_) {
+    // also changes the generic binding point of `target`
+    stateCache_.buffers[target] = buffer;
+  }
   IGLCALL(BindBufferBase)(target, index, buffer);
   APILOG("glBindBufferBase(%s, %u, %u)\n", GL_ENUM_TO_STRING(target), index, buffer);
   GLCHECK_ERRORS();
@@ -631,24 +711,56 @@ void IContext::bindBufferRange(GLenum target,
                                GLuint buffer,
                                GLintptr offset,
                                GLsizeiptr size) {
+  if (stateCacheEnabled_) {
+    // also changes the generic binding point of `target`
+    stateCache_.buffers[target] = buffer;
+  }
   IGLCALL(BindBufferRange)(target, index, buffer, offset, size);
   APILOG("glBindBufferRange(%s, %u, %u)\n", GL_ENUM_TO_STRING(target), index, buffer);
   GLCHECK_ERRORS();
 }
 
 void IContext::bindFramebuffer(GLenum target, GLuint framebuffer) {
+  if (stateCacheEnabled_) {
+    const bool bindsRead = target != GL_DRAW_FRAMEBUFFER;
+    const bool bindsDraw = target != GL_READ_FRAMEBUFFER;
+    if ((!bindsRead || stateCache_.readFramebuffer == framebuffer) &&
+        (!bindsDraw || stateCache_.drawFramebuffer == framebuffer)) {
+      return;
+    }
+    if (bindsRead) {
+      stateCache_.readFramebuffer = framebuffer;
+    }
+    if (bindsDraw) {
+      stateCache_.drawFramebuffer = framebuffer;
+    }
+  }
   IGLCALL(BindFramebuffer)(target, framebuffer);
   APILOG("glBindFramebuffer(%s, %u)\n", GL_ENUM_TO_STRING(target), framebuffer);
   GLCHECK_ERRORS();
 }
 
 void IContext::bindRenderbuffer(GLenum target, GLuint renderbuffer) {
+  if (stateCacheEnabled_) {
+    if (stateCache_.renderbuffer == renderbuffer) {
+      return;
+    }
+    stateCache_.renderbuffer = renderbuffer;
+  }
   IGLCALL(BindRenderbuffer)(target, renderbuffer);
   APILOG("glBindRenderbuffer(%s, %u)\n", GL_ENUM_TO_STRING(target), renderbuffer);
   GLCHECK_ERRORS();
 }
 
 void IContext::bindTexture(GLenum target, GLuint texture) {
+  if (stateCacheEnabled_ && stateCache_.activeTexture != StateCache::kUnknown) {
+    const uint64_t key = (static_cast<uint64_t>(stateCache_.activeTexture) << 32) | target;
+    auto it = stateCache_.textures.find(key);
+    if (it != stateCache_.textures.end() && it->second == texture) {
+      return;
+    }
+    stateCache_.textures[key] = texture;
+  }
   GLCALL(BindTexture)(target, texture);
   APILOG("glBindTexture(%s, %u)\n", GL_ENUM_TO_STRING(target), texture);
   GLCHECK_ERRORS();
@@ -664,10 +776,10 @@ void IContext::bindImageTexture(GLuint unit,
   if (bindImageTexturerProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::ShaderImageLoadStoreExtReq)) {
       if (deviceFeatureSet_.hasExtension(Extensions::ShaderImageLoadStore)) {
-        bindImageTexturerProc_ = iglBindImageTextureEXT;
+        bindImageTexturerProc_ = glDispatch_.BindImageTextureEXT;
       }
     } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::ShaderImageLoadStore)) {
-      bindImageTexturerProc_ = iglBindImageTexture;
+      bindImageTexturerProc_ = glDispatch_.BindImageTexture;
     }
   }
   GLCALL_PROC(bindImageTexturerProc_, unit, texture, level, layered, layer, access, format);
@@ -686,12 +798,20 @@ void IContext::bindVertexArray(GLuint vao) {
   if (bindVertexArrayProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::VertexArrayObjectExtReq)) {
       if (deviceFeatureSet_.hasExtension(Extensions::VertexArrayObject)) {
-        bindVertexArrayProc_ = iglBindVertexArrayOES;
+        bindVertexArrayProc_ = glDispatch_.BindVertexArrayOES;
       }
     } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::VertexArrayObject)) {
-      bindVertexArrayProc_ = iglBindVertexArray;
+      bindVertexArrayProc_ = glDispatch_.BindVertexArray;
     }
   }
+  if (stateCacheEnabled_) {
+    if (stateCache_.vertexArray == vao) {
+      return;
+    }
+    stateCache_.vertexArray = vao;
+    // the element array buffer binding is part of the vertex array state
+    stateCache_.buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+  }
   GLCALL_PROC(bindVertexArrayProc_, vao);
   APILOG("glBindVertexArray(%u)\n", vao);
   GLCHECK_ERRORS();
@@ -746,10 +866,10 @@ void IContext::blitFramebuffer(GLint srcX0,
   if (blitFramebufferProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::FramebufferBlitExtReq)) {
       if (deviceFeatureSet_.hasExtension(Extensions::FramebufferBlit)) {
-        blitFramebufferProc_ = iglBlitFramebufferEXT;
+        blitFramebufferProc_ = glDispatch_.BlitFramebufferEXT;
       }
     } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::FramebufferBlit)) {
-      blitFramebufferProc_ = iglBlitFramebuffer;
+      blitFramebufferProc_ = glDispatch_.BlitFramebuffer;
     }
   }
   GLCALL_PROC(
@@ -778,6 +898,25 @@ void IContext::bufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GL
   GLCHECK_ERRORS();
 }
 
+void IContext::bufferStorage(GLenum target,
+                             GLsizeiptr size,
+                             const GLvoid* data,
+                             GLbitfield flags) {
+  if (bufferStorageProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::BufferStorageExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::BufferStorage)) {
+        bufferStorageProc_ = glDispatch_.BufferStorageEXT;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::BufferStorage)) {
+      bufferStorageProc_ = glDispatch_.BufferStorage;
+    }
+  }
+
+  GLCALL_PROC(bufferStorageProc_, target, size, data, flags);
+  APILOG("glBufferStorage(%s, %zu, %p, 0x%x)\n", GL_ENUM_TO_STRING(target), size, data, flags);
+  GLCHECK_ERRORS();
+}
+
 void IContext::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data) {
   GLCALL(BufferSubData)(target, offset, size, data);
   APILOG("glBufferSubData(%s, %zu, %zu, %p)\n", GL_ENUM_TO_STRING(target), offset, size, data);
@@ -811,9 +950,9 @@ void IContext::clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alph
 void IContext::clearDepthf(GLfloat depth) {
   if (clearDepthfProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::ClearDepthf)) {
-      clearDepthfProc_ = iglClearDepthf;
+      clearDepthfProc_ = glDispatch_.ClearDepthf;
     } else {
-      clearDepthfProc_ = iglClearDepth;
+      clearDepthfProc_ = glDispatch_.ClearDepth;
     }
   }
 
@@ -828,6 +967,30 @@ void IContext::clearStencil(GLint s) {
   GLCHECK_ERRORS();
 }
 
+GLenum IContext::clientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+  if (clientWaitSyncProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::SyncExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::Sync)) {
+        clientWaitSyncProc_ = glDispatch_.ClientWaitSyncAPPLE;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::Sync)) {
+      clientWaitSyncProc_ = glDispatch_.ClientWaitSync;
+    }
+  }
+
+  GLenum ret;
+
+  GLCALL_PROC_WITH_RETURN(ret, clientWaitSyncProc_, GL_WAIT_FAILED, sync, flags, timeout);
+  APILOG("glClientWaitSync(%p, %u, %llu) = %s\n",
+         sync,
+         flags,
+         (unsigned long long)timeout,
+         GL_ENUM_TO_STRING(ret));
+  GLCHECK_ERRORS();
+
+  return ret;
+}
+
 void IContext::colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) {
   GLCALL(ColorMask)(red, green, blue, alpha);
   APILOG("glColorMask(%s, %s, %s, %s)\n",
@@ -902,10 +1065,10 @@ void IContext::compressedTexImage3D(GLenum target,
     if (deviceFeatureSet_.hasFeature(DeviceFeatures::Texture3D)) {
       if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::Texture3DExtReq)) {
         if (deviceFeatureSet_.hasExtension(Extensions::Texture3D)) {
-          compressedTexImage3DProc_ = iglCompressedTexImage3DOES;
+          compressedTexImage3DProc_ = glDispatch_.CompressedTexImage3DOES;
         }
       } else {
-        compressedTexImage3DProc_ = iglCompressedTexImage3D;
+        compressedTexImage3DProc_ = glDispatch_.CompressedTexImage3D;
       }
     }
   }
@@ -994,10 +1157,10 @@ void IContext::compressedTexSubImage3D(GLenum target,
     if (deviceFeatureSet_.hasFeature(DeviceFeatures::Texture3D)) {
       if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::Texture3DExtReq)) {
         if (deviceFeatureSet_.hasExtension(Extensions::Texture3D)) {
-          compressedTexSubImage3DProc_ = iglCompressedTexSubImage3DOES;
+          compressedTexSubImage3DProc_ = glDispatch_.CompressedTexSubImage3DOES;
         }
       } else {
-        compressedTexSubImage3DProc_ = iglCompressedTexSubImage3D;
+        compressedTexSubImage3DProc_ = glDispatch_.CompressedTexSubImage3D;
       }
     }
   }
@@ -1028,6 +1191,71 @@ void IContext::compressedTexSubImage3D(GLenum target,
   GLCHECK_ERRORS();
 }
 
+void IContext::copyBufferSubData(GLenum readTarget,
+                                 GLenum writeTarget,
+                                 GLintptr readOffset,
+                                 GLintptr writeOffset,
+                                 GLsizeiptr size) {
+  IGLCALL(CopyBufferSubData)(readTarget, writeTarget, readOffset, writeOffset, size);
+  APILOG("glCopyBufferSubData(%s, %s, %ld, %ld, %ld)\n",
+         GL_ENUM_TO_STRING(readTarget),
+         GL_ENUM_TO_STRING(writeTarget),
+         static_cast<long>(readOffset),
+         static_cast<long>(writeOffset),
+         static_cast<long>(size));
+  GLCHECK_ERRORS();
+}
+
+void IContext::copyImageSubData(GLuint srcName,
+                                GLenum srcTarget,
+                                GLint srcLevel,
+                                GLint srcX,
+                                GLint srcY,
+                                GLint srcZ,
+                                GLuint dstName,
+                                GLenum dstTarget,
+                                GLint dstLevel,
+                                GLint dstX,
+                                GLint dstY,
+                                GLint dstZ,
+                                GLsizei srcWidth,
+                                GLsizei srcHeight,
+                                GLsizei srcDepth) {
+  IGLCALL(CopyImageSubData)
+  (srcName,
+   srcTarget,
+   srcLevel,
+   srcX,
+   srcY,
+   srcZ,
+   dstName,
+   dstTarget,
+   dstLevel,
+   dstX,
+   dstY,
+   dstZ,
+   srcWidth,
+   srcHeight,
+   srcDepth);
+  APILOG("glCopyImageSubData(%u, %s, %d, %d, %d, %d, %u, %s, %d, %d, %d, %d, %u, %u, %u)\n",
+         srcName,
+         GL_ENUM_TO_STRING(srcTarget),
+         srcLevel,
+         srcX,
+         srcY,
+         srcZ,
+         dstName,
+         GL_ENUM_TO_STRING(dstTarget),
+         dstLevel,
+         dstX,
+         dstY,
+         dstZ,
+         srcWidth,
+         srcHeight,
+         srcDepth);
+  GLCHECK_ERRORS();
+}
+
 void IContext::copyTexImage2D(GLenum target,
                               GLint level,
                               GLenum internalFormat,
@@ -1112,12 +1340,12 @@ void IContext::debugMessageInsert(GLenum source,
     if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::Debug)) {
       if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::DebugExtReq)) {
         if (deviceFeatureSet_.hasExtension(Extensions::Debug)) {
-          debugMessageInsertProc_ = iglDebugMessageInsertKHR;
+          debugMessageInsertProc_ = glDispatch_.DebugMessageInsertKHR;
         } else if (deviceFeatureSet_.hasExtension(Extensions::DebugMarker)) {
-          debugMessageInsertProc_ = iglInsertEventMarkerEXT;
+          debugMessageInsertProc_ = glDispatch_.InsertEventMarkerEXT;
         }
       } else {
-        debugMessageInsertProc_ = iglDebugMessageInsert;
+        debugMessageInsertProc_ = glDispatch_.DebugMessageInsert;
       }
     }
   }
@@ -1135,9 +1363,16 @@ void IContext::debugMessageInsert(GLenum source,
 
 void IContext::deleteBuffers(GLsizei n, const GLuint* buffers) {
   if (isDestructionAllowed() && IGL_VERIFY(buffers != nullptr)) {
+    if (vertexArrayCache_) {
+      // a new buffer may get the same ID
+      vertexArrayCache_->evictBuffers(n, buffers);
+    }
     if (shouldQueueAPI()) {
       deletionQueues_.queueDeleteBuffers(n, buffers);
     } else {
+      if (stateCacheEnabled_) {
+        stateCache_.forgetBuffers(n, buffers);
+      }
       GLCALL(DeleteBuffers)(n, buffers);
       APILOG("glDeleteBuffers(%u, %p)\n", n, buffers);
       GLCHECK_ERRORS();
@@ -1164,6 +1399,16 @@ void IContext::deleteFramebuffers(GLsizei n, const GLuint* framebuffers) {
     if (shouldQueueAPI()) {
       deletionQueues_.queueDeleteFramebuffers(n, framebuffers);
     } else {
+      if (stateCacheEnabled_) {
+        for (GLsizei i = 0; i < n; ++i) {
+          if (stateCache_.readFramebuffer == framebuffers[i]) {
+            stateCache_.readFramebuffer = StateCache::kUnknown;
+          }
+          if (stateCache_.drawFramebuffer == framebuffers[i]) {
+            stateCache_.drawFramebuffer = StateCache::kUnknown;
+          }
+        }
+      }
       IGLCALL(DeleteFramebuffers)(n, framebuffers);
       APILOG("glDeleteFramebuffers(%u, %p)\n", n, framebuffers);
       GLCHECK_ERRORS();
@@ -1176,6 +1421,9 @@ void IContext::deleteProgram(GLuint program) {
     if (shouldQueueAPI()) {
       deletionQueues_.queueDeleteProgram(program);
     } else {
+      if (stateCacheEnabled_ && stateCache_.program == program) {
+        stateCache_.program = StateCache::kUnknown;
+      }
       GLCALL(DeleteProgram)(program);
       APILOG("glDeleteProgram(%u)\n", program);
       GLCHECK_ERRORS();
@@ -1183,11 +1431,48 @@ void IContext::deleteProgram(GLuint program) {
   }
 }
 
+void IContext::deleteQueries(GLsizei n, const GLuint* ids) {
+  if (deleteQueriesProc_ == nullptr) {
+    // Query objects are shared by timer and occlusion queries
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::TimerQueryExtReq) &&
+        deviceFeatureSet_.hasExtension(Extensions::TimerQuery)) {
+      deleteQueriesProc_ = glDispatch_.DeleteQueriesEXT;
+    } else if (deviceFeatureSet_.hasInternalRequirement(
+                   InternalRequirement::OcclusionQueryExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::OcclusionQueryBoolean)) {
+        deleteQueriesProc_ = glDispatch_.DeleteQueriesEXT;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::TimerQuery) ||
+               deviceFeatureSet_.hasInternalFeature(InternalFeatures::OcclusionQuery)) {
+      deleteQueriesProc_ = glDispatch_.DeleteQueries;
+    }
+  }
+
+  if (isDestructionAllowed() && IGL_VERIFY(ids != nullptr)) {
+    GLCALL_PROC(deleteQueriesProc_, n, ids);
+    APILOG("glDeleteQueries(%u, %p)\n", n, ids);
+    GLCHECK_ERRORS();
+  }
+}
+
+void IContext::deleteSamplers(GLsizei n, const GLuint* samplers) {
+  if (isDestructionAllowed() && IGL_VERIFY(samplers != nullptr)) {
+    IGLCALL(DeleteSamplers)(n, samplers);
+    APILOG("glDeleteSamplers(%u, %p)\n", n, samplers);
+    GLCHECK_ERRORS();
+  }
+}
+
 void IContext::deleteRenderbuffers(GLsizei n, const GLuint* renderbuffers) {
   if (isDestructionAllowed() && IGL_VERIFY(renderbuffers != nullptr)) {
     if (shouldQueueAPI()) {
       deletionQueues_.queueDeleteRenderbuffers(n, renderbuffers);
     } else {
+      if (stateCacheEnabled_ &&
+          std::find(renderbuffers, renderbuffers + n, stateCache_.renderbuffer) !=
+              renderbuffers + n) {
+        stateCache_.renderbuffer = StateCache::kUnknown;
+      }
       IGLCALL(DeleteRenderbuffers)(n, renderbuffers);
       APILOG("glDeleteRenderbuffers(%u, %p)\n", n, renderbuffers);
       GLCHECK_ERRORS();
@@ -1199,16 +1484,24 @@ void IContext::deleteVertexArrays(GLsizei n, const GLuint* vertexArrays) {
   if (deleteVertexArraysProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::VertexArrayObjectExtReq)) {
       if (deviceFeatureSet_.hasExtension(Extensions::VertexArrayObject)) {
-        deleteVertexArraysProc_ = iglDeleteVertexArraysOES;
+        deleteVertexArraysProc_ = glDispatch_.DeleteVertexArraysOES;
       }
     } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::VertexArrayObject)) {
-      deleteVertexArraysProc_ = iglDeleteVertexArrays;
+      deleteVertexArraysProc_ = glDispatch_.DeleteVertexArrays;
     }
   }
   if (isDestructionAllowed() && IGL_VERIFY(vertexArrays != nullptr)) {
     if (shouldQueueAPI()) {
       deletionQueues_.queueDeleteVertexArrays(n, vertexArrays);
     } else {
+      if (stateCacheEnabled_) {
+        for (GLsizei i = 0; i < n; ++i) {
+          if (stateCache_.vertexArray == vertexArrays[i]) {
+            stateCache_.vertexArray = StateCache::kUnknown;
+            stateCache_.buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+          }
+        }
+      }
       GLCALL_PROC(deleteVertexArraysProc_, n, vertexArrays);
       APILOG("glDeleteVertexArrays(%u, %p)\n", n, vertexArrays);
       GLCHECK_ERRORS();
@@ -1232,10 +1525,10 @@ void IContext::deleteSync(GLsync sync) {
   if (deleteSyncProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::SyncExtReq)) {
       if (deviceFeatureSet_.hasExtension(Extensions::Sync)) {
-        deleteSyncProc_ = iglDeleteSyncAPPLE;
+        deleteSyncProc_ = glDispatch_.DeleteSyncAPPLE;
       }
     } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::Sync)) {
-      deleteSyncProc_ = iglDeleteSync;
+      deleteSyncProc_ = glDispatch_.DeleteSync;
     }
   }
 
@@ -1249,6 +1542,9 @@ void IContext::deleteTextures(const std::vector<GLuint>& textures) {
     if (shouldQueueAPI()) {
       deletionQueues_.queueDeleteTextures(textures);
     } else {
+      if (stateCacheEnabled_) {
+        stateCache_.forgetTextures(textures);
+      }
       GLCALL(DeleteTextures)(static_cast<GLsizei>(textures.size()), textures.data());
       APILOG("glDeleteTextures(%u, %p)\n", textures.size(), textures.data());
       GLCHECK_ERRORS();
@@ -1281,6 +1577,9 @@ void IContext::detachShader(GLuint program, GLuint shader) {
 }
 
 void IContext::disable(GLenum cap) {
+  if (stateCacheEnabled_ && stateCache_.updateCapability(cap, false)) {
+    return;
+  }
   GLCALL(Disable)(cap);
   APILOG("glDisable(%s)\n", GL_ENUM_TO_STRING(cap));
   GLCHECK_ERRORS();
@@ -1301,15 +1600,31 @@ void IContext::drawArrays(GLenum mode, GLint first, GLsizei count) {
   APILOG_DEC_DRAW_COUNT();
 }
 
+void IContext::drawArraysInstanced(GLenum mode,
+                                   GLint first,
+                                   GLsizei count,
+                                   GLsizei instancecount) {
+  drawCallCount_++;
+
+  IGLCALL(DrawArraysInstanced)(mode, first, count, instancecount);
+  APILOG("glDrawArraysInstanced(%s, %d, %u, %u)\n",
+         GL_ENUM_TO_STRING(mode),
+         first,
+         count,
+         instancecount);
+  GLCHECK_ERRORS();
+  APILOG_DEC_DRAW_COUNT();
+}
+
 void IContext::drawBuffers(GLsizei n, GLenum* buffers) {
   if (drawBuffersProc_ == nullptr) {
     if (deviceFeatureSet_.hasFeature(DeviceFeatures::MultipleRenderTargets)) {
       if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::DrawBuffersExtReq)) {
         if (deviceFeatureSet_.hasExtension(Extensions::DrawBuffers)) {
-          drawBuffersProc_ = iglDrawBuffersEXT;
+          drawBuffersProc_ = glDispatch_.DrawBuffersEXT;
         }
       } else {
-        drawBuffersProc_ = iglDrawBuffers;
+        drawBuffersProc_ = glDispatch_.DrawBuffers;
       }
     }
   }
@@ -1343,7 +1658,33 @@ void IContext::drawElementsIndirect(GLenum mode, GLenum type, const GLvoid* indi
   APILOG_DEC_DRAW_COUNT();
 }
 
+void IContext::drawElementsInstanced(GLenum mode,
+                                     GLsizei count,
+                                     GLenum type,
+                                     const GLvoid* indices,
+                                     GLsizei instancecount) {
+  drawCallCount_++;
+  IGLCALL(DrawElementsInstanced)(mode, count, type, indices, instancecount);
+  APILOG("glDrawElementsInstanced(%s, %u, %s, %p, %u)\n",
+         GL_ENUM_TO_STRING(mode),
+         count,
+         GL_ENUM_TO_STRING(type),
+         indices,
+         instancecount);
+  GLCHECK_ERRORS();
+  APILOG_DEC_DRAW_COUNT();
+}
+
+void IContext::eglImageTargetTexture2D(GLenum target, void* image) {
+  IGLCALL(EGLImageTargetTexture2DOES)(target, image);
+  APILOG("glEGLImageTargetTexture2DOES(%s, %p)\n", GL_ENUM_TO_STRING(target), image);
+  GLCHECK_ERRORS();
+}
+
 void IContext::enable(GLenum cap) {
+  if (stateCacheEnabled_ && stateCache_.updateCapability(cap, true)) {
+    return;
+  }
   GLCALL(Enable)(cap);
   APILOG("glEnable(%s)\n", GL_ENUM_TO_STRING(cap));
   GLCHECK_ERRORS();
@@ -1355,14 +1696,30 @@ void IContext::enableVertexAttribArray(GLuint index) {
   GLCHECK_ERRORS();
 }
 
+void IContext::endQuery(GLenum target) {
+  if (endQueryProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::OcclusionQueryExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::OcclusionQueryBoolean)) {
+        endQueryProc_ = glDispatch_.EndQueryEXT;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::OcclusionQuery)) {
+      endQueryProc_ = glDispatch_.EndQuery;
+    }
+  }
+
+  GLCALL_PROC(endQueryProc_, target);
+  APILOG("glEndQuery(%s)\n", GL_ENUM_TO_STRING(target));
+  GLCHECK_ERRORS();
+}
+
 GLsync IContext::fenceSync(GLenum condition, GLbitfield flags) {
   if (fenceSyncProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::SyncExtReq)) {
       if (deviceFeatureSet_.hasExtension(Extensions::Sync)) {
-        fenceSyncProc_ = iglFenceSyncAPPLE;
+        fenceSyncProc_ = glDispatch_.FenceSyncAPPLE;
       }
     } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::Sync)) {
-      fenceSyncProc_ = iglFenceSync;
+      fenceSyncProc_ = glDispatch_.FenceSync;
     }
   }
 
@@ -1425,9 +1782,9 @@ void IContext::framebufferTexture2DMultisample(GLenum target,
     // Use runtime checks to determine which of several potential methods are supported by the
     // context.
     if (deviceFeatureSet_.hasExtension(Extensions::MultiSampleExt)) {
-      framebufferTexture2DMultisampleProc_ = iglFramebufferTexture2DMultisampleEXT;
+      framebufferTexture2DMultisampleProc_ = glDispatch_.FramebufferTexture2DMultisampleEXT;
     } else if (deviceFeatureSet_.hasExtension(Extensions::MultiSampleImg)) {
-      framebufferTexture2DMultisampleProc_ = iglFramebufferTexture2DMultisampleIMG;
+      framebufferTexture2DMultisampleProc_ = glDispatch_.FramebufferTexture2DMultisampleIMG;
     }
   }
 
@@ -1508,6 +1865,34 @@ void IContext::genFramebuffers(GLsizei n, GLuint* framebuffers) {
   GLCHECK_ERRORS();
 }
 
+void IContext::genQueries(GLsizei n, GLuint* ids) {
+  if (genQueriesProc_ == nullptr) {
+    // Query objects are shared by timer and occlusion queries
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::TimerQueryExtReq) &&
+        deviceFeatureSet_.hasExtension(Extensions::TimerQuery)) {
+      genQueriesProc_ = glDispatch_.GenQueriesEXT;
+    } else if (deviceFeatureSet_.hasInternalRequirement(
+                   InternalRequirement::OcclusionQueryExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::OcclusionQueryBoolean)) {
+        genQueriesProc_ = glDispatch_.GenQueriesEXT;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::TimerQuery) ||
+               deviceFeatureSet_.hasInternalFeature(InternalFeatures::OcclusionQuery)) {
+      genQueriesProc_ = glDispatch_.GenQueries;
+    }
+  }
+
+  GLCALL_PROC(genQueriesProc_, n, ids);
+  APILOG("glGenQueries(%u, %p) = %u\n", n, ids, ids == nullptr ? 0 : *ids);
+  GLCHECK_ERRORS();
+}
+
+void IContext::genSamplers(GLsizei n, GLuint* samplers) {
+  IGLCALL(GenSamplers)(n, samplers);
+  APILOG("glGenSamplers(%u, %p) = %u\n", n, samplers, samplers == nullptr ? 0 : *samplers);
+  GLCHECK_ERRORS();
+}
+
 void IContext::genRenderbuffers(GLsizei n, GLuint* renderbuffers) {
   IGLCALL(GenRenderbuffers)(n, renderbuffers);
   APILOG("glGenRenderbuffers(%u, %p) = %u\n",
@@ -1527,10 +1912,10 @@ void IContext::genVertexArrays(GLsizei n, GLuint* vertexArrays) {
   if (genVertexArraysProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::VertexArrayObjectExtReq)) {
       if (deviceFeatureSet_.hasExtension(Extensions::VertexArrayObject)) {
-        genVertexArraysProc_ = iglGenVertexArraysOES;
+        genVertexArraysProc_ = glDispatch_.GenVertexArraysOES;
       }
     } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::VertexArrayObject)) {
-      genVertexArraysProc_ = iglGenVertexArrays;
+      genVertexArraysProc_ = glDispatch_.GenVertexArrays;
     }
   }
   GLCALL_PROC(genVertexArraysProc_, n, vertexArrays);
@@ -1701,6 +2086,10 @@ void IContext::getFramebufferAttachmentParameteriv(GLenum target,
 }
 
 void IContext::getIntegerv(GLenum pname, GLint* params) const {
+  // each query is a round trip to the driver, which is particularly slow on WebGL
+  if (stateCacheEnabled_ && params != nullptr && stateCache_.getBinding(pname, *params)) {
+    return;
+  }
   GLCALL(GetIntegerv)(pname, params);
   APILOG("glGetIntegerv(%s, %p) = %d\n",
          GL_ENUM_TO_STRING(pname),
@@ -1709,6 +2098,16 @@ void IContext::getIntegerv(GLenum pname, GLint* params) const {
   GLCHECK_ERRORS();
 }
 
+void IContext::getProgramBinary(GLuint program,
+                                GLsizei bufSize,
+                                GLsizei* length,
+                                GLenum* binaryFormat,
+                                void* binary) const {
+  IGLCALL(GetProgramBinary)(program, bufSize, length, binaryFormat, binary);
+  APILOG("glGetProgramBinary(%u, %u, %p, %p, %p)\n", program, bufSize, length, binaryFormat, binary);
+  GLCHECK_ERRORS();
+}
+
 void IContext::getProgramiv(GLuint program, GLenum pname, GLint* params) const {
   GLCALL(GetProgramiv)(program, pname, params);
   APILOG("glGetProgramiv(%u, %s, %p) = %d\n",
@@ -1806,6 +2205,46 @@ void IContext::getProgramResourceName(GLuint program,
   GLCHECK_ERRORS();
 }
 
+void IContext::getQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params) const {
+  if (getQueryObjectui64vProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::TimerQueryExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::TimerQuery)) {
+        getQueryObjectui64vProc_ = glDispatch_.GetQueryObjectui64vEXT;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::TimerQuery)) {
+      getQueryObjectui64vProc_ = glDispatch_.GetQueryObjectui64v;
+    }
+  }
+
+  GLCALL_PROC(getQueryObjectui64vProc_, id, pname, params);
+  APILOG("glGetQueryObjectui64v(%u, %s, %p) = %llu\n",
+         id,
+         GL_ENUM_TO_STRING(pname),
+         params,
+         static_cast<unsigned long long>(params == nullptr ? 0 : *params));
+  GLCHECK_ERRORS();
+}
+
+void IContext::getQueryObjectuiv(GLuint id, GLenum pname, GLuint* params) const {
+  if (getQueryObjectuivProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::OcclusionQueryExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::OcclusionQueryBoolean)) {
+        getQueryObjectuivProc_ = glDispatch_.GetQueryObjectuivEXT;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::OcclusionQuery)) {
+      getQueryObjectuivProc_ = glDispatch_.GetQueryObjectuiv;
+    }
+  }
+
+  GLCALL_PROC(getQueryObjectuivProc_, id, pname, params);
+  APILOG("glGetQueryObjectuiv(%u, %s, %p) = %u\n",
+         id,
+         GL_ENUM_TO_STRING(pname),
+         params,
+         params == nullptr ? 0 : *params);
+  GLCHECK_ERRORS();
+}
+
 void IContext::getRenderbufferParameteriv(GLenum target, GLenum pname, GLint* params) const {
   IGLCALL(GetRenderbufferParameteriv)(target, pname, params);
   APILOG("glGetRenderbufferParameteriv(%s, %s, %p) = %d\n",
@@ -1902,10 +2341,10 @@ void IContext::getSynciv(GLsync sync,
   if (getSyncivProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::SyncExtReq)) {
       if (deviceFeatureSet_.hasExtension(Extensions::Sync)) {
-        getSyncivProc_ = iglGetSyncivAPPLE;
+        getSyncivProc_ = glDispatch_.GetSyncivAPPLE;
       }
     } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::Sync)) {
-      getSyncivProc_ = iglGetSynciv;
+      getSyncivProc_ = glDispatch_.GetSynciv;
     }
   }
   GLCALL_PROC(getSyncivProc_, sync, pname, bufSize, length, values);
@@ -2011,10 +2450,10 @@ void IContext::invalidateFramebuffer(IGL_MAYBE_UNUSED GLenum target,
     if (deviceFeatureSet_.hasInternalRequirement(
             InternalRequirement::InvalidateFramebufferExtReq)) {
       if (deviceFeatureSet_.hasExtension(Extensions::DiscardFramebuffer)) {
-        invalidateFramebufferProc_ = iglDiscardFramebufferEXT;
+        invalidateFramebufferProc_ = glDispatch_.DiscardFramebufferEXT;
       }
     } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::InvalidateFramebuffer)) {
-      invalidateFramebufferProc_ = iglInvalidateFramebuffer;
+      invalidateFramebufferProc_ = glDispatch_.InvalidateFramebuffer;
     }
   }
   GLCALL_PROC(invalidateFramebufferProc_, target, numAttachments, attachments);
@@ -2116,10 +2555,10 @@ void IContext::linkProgram(GLuint program) {
 void* IContext::mapBuffer(GLenum target, GLbitfield access) {
   if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::MapBufferExtReq)) {
     if (deviceFeatureSet_.hasExtension(Extensions::MapBuffer)) {
-      mapBufferProc_ = iglMapBufferOES;
+      mapBufferProc_ = glDispatch_.MapBufferOES;
     }
   } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::MapBuffer)) {
-    mapBufferProc_ = iglMapBuffer;
+    mapBufferProc_ = glDispatch_.MapBuffer;
   }
   void* ret = nullptr;
   GLCALL_PROC_WITH_RETURN(ret, mapBufferProc_, nullptr, target, access);
@@ -2135,10 +2574,10 @@ void* IContext::mapBufferRange(GLenum target,
   if (mapBufferRangeProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::MapBufferRangeExtReq)) {
       if (deviceFeatureSet_.hasExtension(Extensions::MapBufferRange)) {
-        mapBufferRangeProc_ = iglMapBufferRangeEXT;
+        mapBufferRangeProc_ = glDispatch_.MapBufferRangeEXT;
       }
     } else if (deviceFeatureSet_.hasFeature(DeviceFeatures::MapBufferRange)) {
-      mapBufferRangeProc_ = iglMapBufferRange;
+      mapBufferRangeProc_ = glDispatch_.MapBufferRange;
     }
   }
   void* ret = nullptr;
@@ -2154,6 +2593,13 @@ void* IContext::mapBufferRange(GLenum target,
 }
 
 void IContext::pixelStorei(GLenum pname, GLint param) {
+  if (stateCacheEnabled_) {
+    auto result = stateCache_.pixelStore.emplace(pname, param);
+    if (!result.second && result.first->second == param) {
+      return;
+    }
+    result.first->second = param;
+  }
   GLCALL(PixelStorei)(pname, param);
   APILOG("glPixelStorei(%s, %d)\n", GL_ENUM_TO_STRING(pname), param);
   GLCHECK_ERRORS();
@@ -2165,17 +2611,32 @@ void IContext::polygonOffset(GLfloat factor, GLfloat units) {
   GLCHECK_ERRORS();
 }
 
+void IContext::programBinary(GLuint program,
+                             GLenum binaryFormat,
+                             const void* binary,
+                             GLsizei length) {
+  IGLCALL(ProgramBinary)(program, binaryFormat, binary, length);
+  APILOG("glProgramBinary(%u, 0x%x, %p, %u)\n", program, binaryFormat, binary, length);
+  GLCHECK_ERRORS();
+}
+
+void IContext::programParameteri(GLuint program, GLenum pname, GLint value) {
+  IGLCALL(ProgramParameteri)(program, pname, value);
+  APILOG("glProgramParameteri(%u, %s, %d)\n", program, GL_ENUM_TO_STRING(pname), value);
+  GLCHECK_ERRORS();
+}
+
 void IContext::pushDebugGroup(GLenum source, GLuint id, GLsizei length, const GLchar* message) {
   if (pushDebugGroupProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::Debug)) {
       if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::DebugExtReq)) {
         if (deviceFeatureSet_.hasExtension(Extensions::Debug)) {
-          pushDebugGroupProc_ = iglPushDebugGroupKHR;
+          pushDebugGroupProc_ = glDispatch_.PushDebugGroupKHR;
         } else if (deviceFeatureSet_.hasExtension(Extensions::DebugMarker)) {
-          pushDebugGroupProc_ = iglPushGroupMarkerEXT;
+          pushDebugGroupProc_ = glDispatch_.PushGroupMarkerEXT;
         }
       } else {
-        pushDebugGroupProc_ = iglPushDebugGroup;
+        pushDebugGroupProc_ = glDispatch_.PushDebugGroup;
       }
     }
   }
@@ -2190,12 +2651,12 @@ void IContext::popDebugGroup() {
     if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::Debug)) {
       if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::DebugExtReq)) {
         if (deviceFeatureSet_.hasExtension(Extensions::Debug)) {
-          popDebugGroupProc_ = iglPopDebugGroupKHR;
+          popDebugGroupProc_ = glDispatch_.PopDebugGroupKHR;
         } else if (deviceFeatureSet_.hasExtension(Extensions::DebugMarker)) {
-          popDebugGroupProc_ = iglPopGroupMarkerEXT;
+          popDebugGroupProc_ = glDispatch_.PopGroupMarkerEXT;
         }
       } else {
-        popDebugGroupProc_ = iglPopDebugGroup;
+        popDebugGroupProc_ = glDispatch_.PopDebugGroup;
       }
     }
   }
@@ -2205,6 +2666,22 @@ void IContext::popDebugGroup() {
   GLCHECK_ERRORS();
 }
 
+void IContext::queryCounter(GLuint id, GLenum target) {
+  if (queryCounterProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::TimerQueryExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::TimerQuery)) {
+        queryCounterProc_ = glDispatch_.QueryCounterEXT;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::TimerQuery)) {
+      queryCounterProc_ = glDispatch_.QueryCounter;
+    }
+  }
+
+  GLCALL_PROC(queryCounterProc_, id, target);
+  APILOG("glQueryCounter(%u, %s)\n", id, GL_ENUM_TO_STRING(target));
+  GLCHECK_ERRORS();
+}
+
 void IContext::readPixels(GLint x,
                           GLint y,
                           GLsizei width,
@@ -2252,14 +2729,17 @@ void IContext::renderbufferStorageMultisample(GLenum target,
     // Use runtime checks to determine which of several potential methods are supported by the
     // context.
     if (deviceFeatureSet_.hasFeature(DeviceFeatures::MultiSample)) {
-      if (!deviceFeatureSet_.hasInternalRequirement(InternalRequirement::MultiSampleExtReq)) {
-        renderbufferStorageMultisampleProc_ = iglRenderbufferStorageMultisample;
-      } else if (deviceFeatureSet_.hasExtension(Extensions::MultiSampleExt)) {
-        renderbufferStorageMultisampleProc_ = iglRenderbufferStorageMultisampleEXT;
+      // Renderbuffers attached next to a texture rendered with implicit multisample resolve must
+      // be allocated by GL_EXT_multisampled_render_to_texture, and behave like core ones otherwise
+      if (deviceFeatureSet_.hasExtension(Extensions::MultiSampleExt)) {
+        renderbufferStorageMultisampleProc_ = glDispatch_.RenderbufferStorageMultisampleEXT;
+      } else if (!deviceFeatureSet_.hasInternalRequirement(
+                     InternalRequirement::MultiSampleExtReq)) {
+        renderbufferStorageMultisampleProc_ = glDispatch_.RenderbufferStorageMultisample;
       } else if (deviceFeatureSet_.hasExtension(Extensions::MultiSampleImg)) {
-        renderbufferStorageMultisampleProc_ = iglRenderbufferStorageMultisampleIMG;
+        renderbufferStorageMultisampleProc_ = glDispatch_.RenderbufferStorageMultisampleIMG;
       } else if (deviceFeatureSet_.hasExtension(Extensions::MultiSampleApple)) {
-        renderbufferStorageMultisampleProc_ = iglRenderbufferStorageMultisampleAPPLE;
+        renderbufferStorageMultisampleProc_ = glDispatch_.RenderbufferStorageMultisampleAPPLE;
       }
     }
   }
@@ -2318,6 +2798,21 @@ void IContext::sampleCoverage(GLfloat value, GLboolean invert) {
   GLCHECK_ERRORS();
 }
 
+void IContext::samplerParameterf(GLuint sampler, GLenum pname, GLfloat param) {
+  IGLCALL(SamplerParameterf)(sampler, pname, param);
+  APILOG("glSamplerParameterf(%u, %s, %f)\n", sampler, GL_ENUM_TO_STRING(pname), param);
+  GLCHECK_ERRORS();
+}
+
+void IContext::samplerParameteri(GLuint sampler, GLenum pname, GLint param) {
+  IGLCALL(SamplerParameteri)(sampler, pname, param);
+  APILOG("glSamplerParameteri(%u, %s, %s)\n",
+         sampler,
+         GL_ENUM_TO_STRING(pname),
+         GL_ENUM_TO_STRING(param));
+  GLCHECK_ERRORS();
+}
+
 void IContext::scissor(GLint x, GLint y, GLsizei width, GLsizei height) {
   GLCALL(Scissor)(x, y, width, height);
   APILOG("glScissor(%d, %d, %u, %u)\n", x, y, width, height);
@@ -2325,6 +2820,9 @@ void IContext::scissor(GLint x, GLint y, GLsizei width, GLsizei height) {
 }
 
 void IContext::setEnabled(bool shouldEnable, GLenum cap) {
+  if (stateCacheEnabled_ && stateCache_.updateCapability(cap, shouldEnable)) {
+    return;
+  }
   if (shouldEnable) {
     GLCALL(Enable)(cap);
     APILOG("glEnable(%s)\n", GL_ENUM_TO_STRING(cap));
@@ -2335,6 +2833,18 @@ void IContext::setEnabled(bool shouldEnable, GLenum cap) {
   GLCHECK_ERRORS();
 }
 
+void IContext::shadingRate(GLenum rate) {
+  if (shadingRateProc_ == nullptr) {
+    if (deviceFeatureSet_.hasExtension(Extensions::ShadingRate)) {
+      shadingRateProc_ = glDispatch_.ShadingRateQCOM;
+    }
+  }
+
+  GLCALL_PROC(shadingRateProc_, rate);
+  APILOG("glShadingRateQCOM(0x%x)\n", rate);
+  GLCHECK_ERRORS();
+}
+
 void IContext::shaderBinary(GLsizei n,
                             const GLuint* shaders,
                             GLenum binaryformat,
@@ -2486,10 +2996,10 @@ void IContext::texStorage1D(GLenum target, GLsizei levels, GLenum internalformat
   if (texStorage1DProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::TexStorageExtReq)) {
       if (deviceFeatureSet_.hasExtension(Extensions::TexStorage)) {
-        texStorage1DProc_ = iglTexStorage1DEXT;
+        texStorage1DProc_ = glDispatch_.TexStorage1DEXT;
       }
     } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::TexStorage)) {
-      texStorage1DProc_ = iglTexStorage1D;
+      texStorage1DProc_ = glDispatch_.TexStorage1D;
     }
   }
 
@@ -2510,10 +3020,10 @@ void IContext::texStorage2D(GLenum target,
   if (texStorage2DProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::TexStorageExtReq)) {
       if (deviceFeatureSet_.hasExtension(Extensions::TexStorage)) {
-        texStorage2DProc_ = iglTexStorage2DEXT;
+        texStorage2DProc_ = glDispatch_.TexStorage2DEXT;
       }
     } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::TexStorage)) {
-      texStorage2DProc_ = iglTexStorage2D;
+      texStorage2DProc_ = glDispatch_.TexStorage2D;
     }
   }
 
@@ -2527,6 +3037,25 @@ void IContext::texStorage2D(GLenum target,
   GLCHECK_ERRORS();
 }
 
+void IContext::texStorage2DMultisample(GLenum target,
+                                       GLsizei samples,
+                                       GLenum internalformat,
+                                       GLsizei width,
+                                       GLsizei height,
+                                       GLboolean fixedsamplelocations) {
+  IGL_ASSERT(deviceFeatureSet_.hasInternalFeature(InternalFeatures::TexStorageMultisample));
+  IGLCALL(TexStorage2DMultisample)
+  (target, samples, internalformat, width, height, fixedsamplelocations);
+  APILOG("glTexStorage2DMultisample(%s, %u, %s, %u, %u, %s)\n",
+         GL_ENUM_TO_STRING(target),
+         samples,
+         GL_ENUM_TO_STRING(internalformat),
+         width,
+         height,
+         GL_BOOL_TO_STRING(fixedsamplelocations));
+  GLCHECK_ERRORS();
+}
+
 void IContext::texStorage3D(GLenum target,
                             GLsizei levels,
                             GLenum internalformat,
@@ -2536,10 +3065,10 @@ void IContext::texStorage3D(GLenum target,
   if (texStorage3DProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::TexStorageExtReq)) {
       if (deviceFeatureSet_.hasExtension(Extensions::TexStorage)) {
-        texStorage3DProc_ = iglTexStorage3DEXT;
+        texStorage3DProc_ = glDispatch_.TexStorage3DEXT;
       }
     } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::TexStorage)) {
-      texStorage3DProc_ = iglTexStorage3D;
+      texStorage3DProc_ = glDispatch_.TexStorage3D;
     }
   }
   GLCALL_PROC(texStorage3DProc_, target, levels, internalformat, width, height, depth);
@@ -2607,10 +3136,10 @@ void IContext::texImage3D(GLenum target,
     if (deviceFeatureSet_.hasFeature(DeviceFeatures::Texture3D)) {
       if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::Texture3DExtReq)) {
         if (deviceFeatureSet_.hasExtension(Extensions::Texture3D)) {
-          texImage3DProc_ = iglTexImage3DOES;
+          texImage3DProc_ = glDispatch_.TexImage3DOES;
         }
       } else {
-        texImage3DProc_ = iglTexImage3D;
+        texImage3DProc_ = glDispatch_.TexImage3D;
       }
     }
   }
@@ -2715,10 +3244,10 @@ void IContext::texSubImage3D(GLenum target,
     if (deviceFeatureSet_.hasFeature(DeviceFeatures::Texture3D)) {
       if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::Texture3DExtReq)) {
         if (deviceFeatureSet_.hasExtension(Extensions::Texture3D)) {
-          texSubImage3DProc_ = iglTexSubImage3DOES;
+          texSubImage3DProc_ = glDispatch_.TexSubImage3DOES;
         }
       } else {
-        texSubImage3DProc_ = iglTexSubImage3D;
+        texSubImage3DProc_ = glDispatch_.TexSubImage3D;
       }
     }
   }
@@ -2965,10 +3494,10 @@ void IContext::unmapBuffer(GLenum target) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::UnmapBufferExtReq)) {
       if (deviceFeatureSet_.hasExtension(Extensions::MapBuffer) ||
           deviceFeatureSet_.hasExtension(Extensions::MapBufferRange)) {
-        unmapBufferProc_ = iglUnmapBufferOES;
+        unmapBufferProc_ = glDispatch_.UnmapBufferOES;
       }
     } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::UnmapBuffer)) {
-      unmapBufferProc_ = iglUnmapBuffer;
+      unmapBufferProc_ = glDispatch_.UnmapBuffer;
     }
   }
   GLCALL_PROC(unmapBufferProc_, target);
@@ -2977,6 +3506,12 @@ void IContext::unmapBuffer(GLenum target) {
 }
 
 void IContext::useProgram(GLuint program) {
+  if (stateCacheEnabled_) {
+    if (stateCache_.program == program) {
+      return;
+    }
+    stateCache_.program = program;
+  }
   GLCALL(UseProgram)(program);
   APILOG("glUseProgram(%u)\n", program);
   GLCHECK_ERRORS();
@@ -3057,12 +3592,28 @@ void IContext::viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
   GLCHECK_ERRORS();
 }
 
+void IContext::waitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+  if (waitSyncProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::SyncExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::Sync)) {
+        waitSyncProc_ = glDispatch_.WaitSyncAPPLE;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::Sync)) {
+      waitSyncProc_ = glDispatch_.WaitSync;
+    }
+  }
+
+  GLCALL_PROC(waitSyncProc_, sync, flags, timeout);
+  APILOG("glWaitSync(%p, %u, %llu)\n", sync, flags, (unsigned long long)timeout);
+  GLCHECK_ERRORS();
+}
+
 GLuint64 IContext::getTextureHandle(GLuint texture) {
   if (getTextureHandleProc_ == nullptr) {
     if (deviceFeatureSet_.hasExtension(Extensions::BindlessTextureArb)) {
-      getTextureHandleProc_ = iglGetTextureHandleARB;
+      getTextureHandleProc_ = glDispatch_.GetTextureHandleARB;
     } else if (deviceFeatureSet_.hasExtension(Extensions::BindlessTextureNv)) {
-      getTextureHandleProc_ = iglGetTextureHandleNV;
+      getTextureHandleProc_ = glDispatch_.GetTextureHandleNV;
     }
   }
 
@@ -3073,12 +3624,28 @@ GLuint64 IContext::getTextureHandle(GLuint texture) {
   return ret;
 }
 
+GLuint64 IContext::getTextureSamplerHandle(GLuint texture, GLuint sampler) {
+  if (getTextureSamplerHandleProc_ == nullptr) {
+    if (deviceFeatureSet_.hasExtension(Extensions::BindlessTextureArb)) {
+      getTextureSamplerHandleProc_ = glDispatch_.GetTextureSamplerHandleARB;
+    } else if (deviceFeatureSet_.hasExtension(Extensions::BindlessTextureNv)) {
+      getTextureSamplerHandleProc_ = glDispatch_.GetTextureSamplerHandleNV;
+    }
+  }
+
+  GLuint64 ret;
+  GLCALL_PROC_WITH_RETURN(ret, getTextureSamplerHandleProc_, GL_ZERO, texture, sampler);
+  APILOG("glGetTextureSamplerHandle(%u, %u) = %llu\n", texture, sampler, ret);
+  GLCHECK_ERRORS();
+  return ret;
+}
+
 void IContext::makeTextureHandleResident(GLuint64 handle) {
   if (makeTextureHandleResidentProc_ == nullptr) {
     if (deviceFeatureSet_.hasExtension(Extensions::BindlessTextureArb)) {
-      makeTextureHandleResidentProc_ = iglMakeTextureHandleResidentARB;
+      makeTextureHandleResidentProc_ = glDispatch_.MakeTextureHandleResidentARB;
     } else if (deviceFeatureSet_.hasExtension(Extensions::BindlessTextureNv)) {
-      makeTextureHandleResidentProc_ = iglMakeTextureHandleResidentNV;
+      makeTextureHandleResidentProc_ = glDispatch_.MakeTextureHandleResidentNV;
     }
   }
 
@@ -3090,9 +3657,9 @@ void IContext::makeTextureHandleResident(GLuint64 handle) {
 void IContext::makeTextureHandleNonResident(GLuint64 handle) {
   if (makeTextureHandleNonResidentProc_ == nullptr) {
     if (deviceFeatureSet_.hasExtension(Extensions::BindlessTextureArb)) {
-      makeTextureHandleNonResidentProc_ = iglMakeTextureHandleNonResidentARB;
+      makeTextureHandleNonResidentProc_ = glDispatch_.MakeTextureHandleNonResidentARB;
     } else if (deviceFeatureSet_.hasExtension(Extensions::BindlessTextureNv)) {
-      makeTextureHandleNonResidentProc_ = iglMakeTextureHandleNonResidentNV;
+      makeTextureHandleNonResidentProc_ = glDispatch_.MakeTextureHandleNonResidentNV;
     }
   }
 
@@ -3107,14 +3674,33 @@ void IContext::dispatchCompute(GLuint num_groups_x, GLuint num_groups_y, GLuint
   GLCHECK_ERRORS();
 }
 
+void IContext::dispatchComputeIndirect(GLintptr indirect) {
+  IGLCALL(DispatchComputeIndirect)(indirect);
+  APILOG("glDispatchComputeIndirect(%ld)\n", static_cast<long>(indirect));
+  GLCHECK_ERRORS();
+}
+
+void IContext::maxShaderCompilerThreads(GLuint count) {
+  if (maxShaderCompilerThreadsProc_ == nullptr) {
+    if (deviceFeatureSet_.isSupported("GL_KHR_parallel_shader_compile")) {
+      maxShaderCompilerThreadsProc_ = glDispatch_.MaxShaderCompilerThreadsKHR;
+    } else if (deviceFeatureSet_.isSupported("GL_ARB_parallel_shader_compile")) {
+      maxShaderCompilerThreadsProc_ = glDispatch_.MaxShaderCompilerThreadsARB;
+    }
+  }
+  GLCALL_PROC(maxShaderCompilerThreadsProc_, count);
+  APILOG("glMaxShaderCompilerThreads(%u)\n", count);
+  GLCHECK_ERRORS();
+}
+
 void IContext::memoryBarrier(GLbitfield barriers) {
   if (memoryBarrierProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::ShaderImageLoadStoreExtReq)) {
       if (deviceFeatureSet_.hasExtension(Extensions::ShaderImageLoadStore)) {
-        memoryBarrierProc_ = iglMemoryBarrierEXT;
+        memoryBarrierProc_ = glDispatch_.MemoryBarrierEXT;
       }
     } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::ShaderImageLoadStore)) {
-      memoryBarrierProc_ = iglMemoryBarrier;
+      memoryBarrierProc_ = glDispatch_.MemoryBarrier;
     }
   }
   GLCALL_PROC(memoryBarrierProc_, barriers);
@@ -3122,6 +3708,12 @@ void IContext::memoryBarrier(GLbitfield barriers) {
   GLCHECK_ERRORS();
 }
 
+void IContext::vertexAttribDivisor(GLuint index, GLuint divisor) {
+  IGLCALL(VertexAttribDivisor)(index, divisor);
+  APILOG("glVertexAttribDivisor(%u, %u)\n", index, divisor);
+  GLCHECK_ERRORS();
+}
+
 void IContext::vertexAttribPointer(GLuint indx,
                                    GLint size,
                                    GLenum type,
@@ -3165,6 +3757,290 @@ void IContext::enableAutomaticErrorCheck(bool enable) {
 #endif
 }
 
+void IContext::enableSampledErrorCheck(bool enable,
+                                       uint32_t callInterval,
+                                       bool checkAtPassEnd,
+                                       std::function<void(const SampledError&)> callback) {
+  errorCheckInterval_ = enable ? callInterval : 0;
+  errorCheckAtPassEnd_ = enable && checkAtPassEnd;
+  sampledErrorCallback_ = enable ? std::move(callback) : nullptr;
+  currentErrorCheckInterval_ = errorCheckInterval_;
+  errorCheckCountdown_ = errorCheckInterval_;
+  errorFreeCalls_ = 0;
+}
+
+void IContext::checkErrorsAtPassEnd(const char* passName) {
+  if (!errorCheckAtPassEnd_ || alwaysCheckError_) {
+    return;
+  }
+  const GLenum error = getError();
+  if (error != GL_NO_ERROR) {
+    reportSampledError(error, passName, 0, false);
+  }
+}
+
+void IContext::sampleErrors(const char* callerName, size_t lineNum) const {
+  const GLenum error = getError();
+  if (error != GL_NO_ERROR) {
+    reportSampledError(error, callerName, lineNum, currentErrorCheckInterval_ == 1);
+    // check more often in case the error recurs, to find the call which causes it
+    currentErrorCheckInterval_ = std::max(currentErrorCheckInterval_ / 2, 1u);
+    errorFreeCalls_ = 0;
+  } else if (currentErrorCheckInterval_ != errorCheckInterval_) {
+    errorFreeCalls_ += currentErrorCheckInterval_;
+    if (errorFreeCalls_ >= errorCheckInterval_) {
+      currentErrorCheckInterval_ = errorCheckInterval_;
+      errorFreeCalls_ = 0;
+    }
+  }
+  errorCheckCountdown_ = currentErrorCheckInterval_;
+}
+
+void IContext::reportSampledError(GLenum error,
+                                  const char* callerName,
+                                  size_t lineNum,
+                                  bool isExact) const {
+  lastError_ = error;
+  if (sampledErrorCallback_) {
+    sampledErrorCallback_(SampledError{error, callerName, lineNum, isExact});
+  } else {
+    IGL_LOG_ERROR("[IGL] OpenGL error %s %s:%zu 0x%04X: %s\n",
+                  isExact ? "in" : "at or before",
+                  callerName,
+                  lineNum,
+                  error,
+                  GL_ERROR_TO_STRING(error));
+  }
+}
+
+void IContext::enableStateCache(bool enable) {
+  if (stateCacheEnabled_ != enable) {
+    stateCacheEnabled_ = enable;
+    // the state might have changed while the cache was disabled
+    stateCache_.clear();
+  }
+}
+
+void IContext::invalidateStateCache() {
+  stateCache_.clear();
+}
+
+bool IContext::enableProgramBinaryCache(std::string filePath, size_t maxFileSize) {
+  programBinaryCache_ = ProgramBinaryCache::create(*this, std::move(filePath), maxFileSize);
+  return programBinaryCache_ != nullptr;
+}
+
+bool IContext::saveProgramBinaryCache() {
+  return programBinaryCache_ ? programBinaryCache_->save() : false;
+}
+
+bool IContext::enableAsyncTextureUploads(bool enable, size_t numBuffers, size_t maxUploadSize) {
+  if (pixelUnpackBufferRing_) {
+    pixelUnpackBufferRing_->destroy();
+    pixelUnpackBufferRing_ = nullptr;
+  }
+  if (!enable) {
+    return true;
+  }
+  if (!PixelUnpackBufferRing::isSupported(*this)) {
+    return false;
+  }
+  pixelUnpackBufferRing_ =
+      std::make_unique<PixelUnpackBufferRing>(*this, numBuffers, maxUploadSize);
+  return true;
+}
+
+bool IContext::enableVertexArrayCache(bool enable, size_t maxSize) {
+  if (vertexArrayCache_) {
+    vertexArrayCache_->destroy();
+    vertexArrayCache_ = nullptr;
+  }
+  if (!enable) {
+    return true;
+  }
+  if (!deviceFeatureSet_.hasInternalFeature(InternalFeatures::VertexArrayObject)) {
+    return false;
+  }
+  vertexArrayCache_ = std::make_unique<VertexArrayCache>(*this, maxSize);
+  return true;
+}
+
+bool IContext::enablePackedUniforms(bool enable, size_t ringSize) {
+  if (packedUniformRing_) {
+    packedUniformRing_->destroy();
+    packedUniformRing_ = nullptr;
+  }
+  if (!enable) {
+    return true;
+  }
+  if (!deviceFeatureSet_.hasFeature(DeviceFeatures::UniformBlocks)) {
+    return false;
+  }
+  packedUniformRing_ = std::make_unique<PackedUniformRing>(*this, ringSize);
+  return true;
+}
+
+bool IContext::enableBindlessTextures(bool enable, size_t ringSize) {
+  if (bindlessTextureRing_) {
+    bindlessTextureRing_->destroy();
+    bindlessTextureRing_ = nullptr;
+  }
+  if (!enable) {
+    return true;
+  }
+  if (!deviceFeatureSet_.hasFeature(DeviceFeatures::TextureBindless) ||
+      !deviceFeatureSet_.hasFeature(DeviceFeatures::UniformBlocks)) {
+    return false;
+  }
+  bindlessTextureRing_ =
+      std::make_unique<PackedUniformRing>(*this, ringSize, BindlessTextureBlock::kBindingIndex);
+  return true;
+}
+
+PackedUniformRing* IContext::getPushConstantRing() {
+  if (!pushConstantRing_ && deviceFeatureSet_.hasFeature(DeviceFeatures::UniformBlocks)) {
+    // room for a few hundred draws between orphanings of the storage
+    pushConstantRing_ = std::make_unique<PackedUniformRing>(
+        *this, 64u * 1024u, PushConstantBlock::kBindingIndex);
+  }
+  return pushConstantRing_.get();
+}
+
+void IContext::releasePushConstantRing() {
+  if (pushConstantRing_) {
+    pushConstantRing_->destroy();
+    pushConstantRing_ = nullptr;
+  }
+}
+
+uint64_t IContext::insertSubmitFence() {
+  if (!deviceFeatureSet_.hasInternalFeature(InternalFeatures::Sync)) {
+    return 0;
+  }
+
+  GLsync fence = fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  if (!fence) {
+    return 0;
+  }
+
+  const uint64_t handle = nextSubmitHandle_++;
+  submitFences_.emplace_back(handle, fence);
+
+  return handle;
+}
+
+bool IContext::isSubmitHandleComplete(uint64_t handle) {
+  return retireSubmitFences(handle, 0);
+}
+
+void IContext::waitForSubmitHandle(uint64_t handle) {
+  constexpr GLuint64 kTimeoutNs = 1000000000ull;
+
+  while (!retireSubmitFences(handle, kTimeoutNs)) {
+  }
+}
+
+bool IContext::retireSubmitFences(uint64_t handle, GLuint64 timeoutNs) {
+  while (!submitFences_.empty() && submitFences_.front().first <= handle) {
+    const auto [frontHandle, fence] = submitFences_.front();
+    // the flush makes sure the fence gets signaled eventually when only polling it
+    const GLenum status = clientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNs);
+    if (status == GL_TIMEOUT_EXPIRED) {
+      return false;
+    }
+    IGL_ASSERT_MSG(status != GL_WAIT_FAILED, "glClientWaitSync() failed");
+    deleteSync(fence);
+    submitFences_.pop_front();
+    lastCompletedSubmitHandle_ = frontHandle;
+  }
+
+  // all older fences have been retired
+  return handle <= lastCompletedSubmitHandle_ || submitFences_.empty();
+}
+
+void IContext::releaseSubmitFences() {
+  for (const auto& [handle, fence] : submitFences_) {
+    deleteSync(fence);
+  }
+  submitFences_.clear();
+  lastCompletedSubmitHandle_ = nextSubmitHandle_ - 1;
+}
+
+void IContext::StateCache::clear() {
+  activeTexture = kUnknown;
+  program = kUnknown;
+  vertexArray = kUnknown;
+  readFramebuffer = kUnknown;
+  drawFramebuffer = kUnknown;
+  renderbuffer = kUnknown;
+  textures.clear();
+  buffers.clear();
+  capabilities.clear();
+  pixelStore.clear();
+}
+
+bool IContext::StateCache::getBinding(GLenum pname, GLint& value) const {
+  GLuint binding = kUnknown;
+  switch (pname) {
+  case GL_ACTIVE_TEXTURE:
+    binding = activeTexture;
+    break;
+  case GL_CURRENT_PROGRAM:
+    binding = program;
+    break;
+  // same value as GL_DRAW_FRAMEBUFFER_BINDING
+  case GL_FRAMEBUFFER_BINDING:
+    binding = drawFramebuffer;
+    break;
+  case GL_READ_FRAMEBUFFER_BINDING:
+    binding = readFramebuffer;
+    break;
+  case GL_RENDERBUFFER_BINDING:
+    binding = renderbuffer;
+    break;
+  default: {
+    auto it = pixelStore.find(pname);
+    if (it == pixelStore.end()) {
+      return false;
+    }
+    value = it->second;
+    return true;
+  }
+  }
+  if (binding == kUnknown) {
+    return false;
+  }
+  value = static_cast<GLint>(binding);
+  return true;
+}
+
+bool IContext::StateCache::updateCapability(GLenum cap, bool enabled) {
+  auto result = capabilities.emplace(cap, enabled);
+  if (!result.second && result.first->second == enabled) {
+    return true;
+  }
+  result.first->second = enabled;
+  return false;
+}
+
+// Deleting an object unbinds it in the current context only. Forgetting the bindings instead of
+// setting them to 0 also covers deletions through another context of the sharegroup.
+void IContext::StateCache::forgetBuffers(GLsizei n, const GLuint* deletedBuffers) {
+  for (GLsizei i = 0; i < n; ++i) {
+    for (auto it = buffers.begin(); it != buffers.end();) {
+      it = it->second == deletedBuffers[i] ? buffers.erase(it) : std::next(it);
+    }
+  }
+}
+
+void IContext::StateCache::forgetTextures(const std::vector<GLuint>& deletedTextures) {
+  for (GLuint texture : deletedTextures) {
+    for (auto it = textures.begin(); it != textures.end();) {
+      it = it->second == texture ? textures.erase(it) : std::next(it);
+    }
+  }
+}
+
 /** Returns current `callCounter_` value. Exposed for testing only. */
 unsigned int IContext::getCallCount() const {
   return callCounter_;
@@ -3174,8 +4050,27 @@ unsigned int IContext::getCurrentDrawCount() const {
   return drawCallCount_;
 }
 
+unsigned int IContext::getCallCount(const char* entryPoint) const {
+  if (!callCountsByName_) {
+    return 0;
+  }
+  const auto it = callCountsByName_->find(entryPoint);
+  return it != callCountsByName_->end() ? it->second : 0;
+}
+
+void IContext::enableCallCountsByName(bool enable) {
+  if (enable) {
+    callCountsByName_ = std::make_unique<std::unordered_map<std::string, unsigned int>>();
+  } else {
+    callCountsByName_.reset();
+  }
+}
+
 void IContext::resetCounters() {
   callCounter_ = 0;
+  if (callCountsByName_) {
+    callCountsByName_->clear();
+  }
 }
 
 bool IContext::addRef() {
@@ -3209,6 +4104,8 @@ void IContext::initialize(Result* result) {
     return;
   }
 
+  glDispatch_.load();
+
   GLVersion glVersion = GLVersion::NotAvailable;
 
   const char* version = (char*)getString(GL_VERSION);
@@ -3274,12 +4171,24 @@ void IContext::initialize(Result* result) {
   if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::SeamlessCubeMap)) {
     enable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
   }
+
+#if !IGL_PLATFORM_EMSCRIPTEN
+  // WebGL compiles in parallel by default and exposes no thread count
+  if (deviceFeatureSet_.hasExtension(Extensions::ParallelShaderCompile)) {
+    // let the driver choose the number of compiler threads
+    maxShaderCompilerThreads(0xffffffff);
+  }
+#endif // !IGL_PLATFORM_EMSCRIPTEN
 }
 
 const DeviceFeatureSet& IContext::deviceFeatures() const {
   return deviceFeatureSet_;
 }
 
+const GLDispatchTable& IContext::getDispatchTable() const {
+  return glDispatch_;
+}
+
 void IContext::apiLogNextNDraws(const unsigned int n) {
   apiLogDrawsLeft_ = n;
 }
@@ -3294,6 +4203,11 @@ void IContext::apiLogEnd() {
 
 void IContext::SynchronizedDeletionQueues::flushDeletionQueue(IContext& context) {
   if (IGL_VERIFY(context.isCurrentContext() || context.isCurrentSharegroup())) {
+    // called on every setCurrent(), usually with nothing queued
+    if (!hasQueuedOperations_.load(std::memory_order_acquire)) {
+      return;
+    }
+    IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_DESTROY);
     swapScratchDeletionQueues();
 
     if (!scratchBuffersQueue_.empty()) {
@@ -3345,6 +4259,7 @@ void IContext::SynchronizedDeletionQueues::flushDeletionQueue(IContext& context)
 void IContext::SynchronizedDeletionQueues::swapScratchDeletionQueues() {
   std::lock_guard<std::mutex> guard(deletionQueueMutex_);
 
+  hasQueuedOperations_.store(false, std::memory_order_relaxed);
   std::swap(scratchBuffersQueue_, buffersQueue_);
   std::swap(scratchUnbindBuffersQueue_, unbindBuffersQueue_);
   std::swap(scratchFramebuffersQueue_, framebuffersQueue_);
@@ -3357,53 +4272,56 @@ void IContext::SynchronizedDeletionQueues::swapScratchDeletionQueues() {
 
 void IContext::SynchronizedDeletionQueues::queueDeleteBuffers(GLsizei n, const GLuint* buffers) {
   std::lock_guard<std::mutex> guard(deletionQueueMutex_);
-  for (GLsizei i = 0; i < n; ++i) {
-    buffersQueue_.push_back(buffers[i]);
-  }
+  buffersQueue_.insert(buffersQueue_.end(), buffers, buffers + n);
+  hasQueuedOperations_.store(true, std::memory_order_release);
 }
 
 void IContext::SynchronizedDeletionQueues::queueUnbindBuffer(GLenum target) {
   std::lock_guard<std::mutex> guard(deletionQueueMutex_);
-  unbindBuffersQueue_.insert(target);
+  if (std::find(unbindBuffersQueue_.begin(), unbindBuffersQueue_.end(), target) ==
+      unbindBuffersQueue_.end()) {
+    unbindBuffersQueue_.push_back(target);
+  }
+  hasQueuedOperations_.store(true, std::memory_order_release);
 }
 
 void IContext::SynchronizedDeletionQueues::queueDeleteFramebuffers(GLsizei n,
                                                                    const GLuint* framebuffers) {
   std::lock_guard<std::mutex> guard(deletionQueueMutex_);
-  for (GLsizei i = 0; i < n; ++i) {
-    framebuffersQueue_.push_back(framebuffers[i]);
-  }
+  framebuffersQueue_.insert(framebuffersQueue_.end(), framebuffers, framebuffers + n);
+  hasQueuedOperations_.store(true, std::memory_order_release);
 }
 
 void IContext::SynchronizedDeletionQueues::queueDeleteRenderbuffers(GLsizei n,
                                                                     const GLuint* renderbuffers) {
   std::lock_guard<std::mutex> guard(deletionQueueMutex_);
-  for (GLsizei i = 0; i < n; ++i) {
-    renderbuffersQueue_.push_back(renderbuffers[i]);
-  }
+  renderbuffersQueue_.insert(renderbuffersQueue_.end(), renderbuffers, renderbuffers + n);
+  hasQueuedOperations_.store(true, std::memory_order_release);
 }
 
 void IContext::SynchronizedDeletionQueues::queueDeleteVertexArrays(GLsizei n,
                                                                    const GLuint* vertexArrays) {
   std::lock_guard<std::mutex> guard(deletionQueueMutex_);
-  for (GLsizei i = 0; i < n; ++i) {
-    vertexArraysQueue_.push_back(vertexArrays[i]);
-  }
+  vertexArraysQueue_.insert(vertexArraysQueue_.end(), vertexArrays, vertexArrays + n);
+  hasQueuedOperations_.store(true, std::memory_order_release);
 }
 
 void IContext::SynchronizedDeletionQueues::queueDeleteProgram(GLuint program) {
   std::lock_guard<std::mutex> guard(deletionQueueMutex_);
   programQueue_.push_back(program);
+  hasQueuedOperations_.store(true, std::memory_order_release);
 }
 
 void IContext::SynchronizedDeletionQueues::queueDeleteShader(GLuint shaderId) {
   std::lock_guard<std::mutex> guard(deletionQueueMutex_);
   shaderQueue_.push_back(shaderId);
+  hasQueuedOperations_.store(true, std::memory_order_release);
 }
 
 void IContext::SynchronizedDeletionQueues::queueDeleteTextures(
     const std::vector<GLuint>& textures) {
   std::lock_guard<std::mutex> guard(deletionQueueMutex_);
   texturesQueue_.insert(std::end(texturesQueue_), std::begin(textures), std::end(textures));
+  hasQueuedOperations_.store(true, std::memory_order_release);
 }
 } // namespace igl::opengl
@@ -18,10 +18,14 @@
 #include <igl/opengl/UnbindPolicy.h>
 #include <igl/opengl/Version.h>
 #include <igl/opengl/WithContext.h>
+#include <atomic>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <unordered_map>
-#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace igl {
@@ -30,6 +34,11 @@ class ITexture;
 
 namespace igl::opengl {
 
+class PackedUniformRing;
+class PixelUnpackBufferRing;
+class ProgramBinaryCache;
+class VertexArrayCache;
+
 // We might extend this to other enums presenting API versions on desktops, etc.
 // For the time being, we only need to differentiate gles2 and gles3
 enum class RenderingAPI { GLES2, GLES3, GL };
@@ -46,6 +55,16 @@ class IContext {
   virtual bool isCurrentContext() const = 0;
   virtual bool isCurrentSharegroup() const = 0;
   virtual void present(std::shared_ptr<ITexture> surface) const = 0;
+  /// Same as present(), but only the `damage` rectangles (window coordinates, origin at the bottom
+  /// left) changed since the previous frame. Platforms that can pass damage to the compositor
+  /// (EGL_KHR_swap_buffers_with_damage) let it recomposite only those regions.
+  virtual void presentWithDamage(std::shared_ptr<ITexture> surface,
+                                 const std::vector<ScissorRect>& damage) const;
+  /// Sets the number of vertical blanks a buffer swap waits for, 0 disabling vsync. A negative
+  /// interval requests adaptive vsync: swaps wait for |interval| vertical blanks, but a late swap
+  /// tears instead of missing a whole refresh (EXT_swap_control_tear). Returns false if the
+  /// platform does not support the interval. The context has to be current.
+  virtual bool setSwapInterval(int interval);
 
   IContext();
   virtual ~IContext();
@@ -60,6 +79,7 @@ class IContext {
   /// MARK: - GL APIs
   void activeTexture(GLenum texture);
   void attachShader(GLuint program, GLuint shader);
+  void beginQuery(GLenum target, GLuint id);
   void bindAttribLocation(GLuint program, GLuint index, const GLchar* name);
   void bindBuffer(GLenum target, GLuint buffer);
   void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
@@ -95,12 +115,14 @@ class IContext {
                        GLbitfield mask,
                        GLenum filter);
   void bufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
+  void bufferStorage(GLenum target, GLsizeiptr size, const GLvoid* data, GLbitfield flags);
   void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
   virtual GLenum checkFramebufferStatus(GLenum target);
   void clear(GLbitfield mask);
   void clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
   void clearDepthf(GLfloat depth);
   void clearStencil(GLint s);
+  GLenum clientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
   void colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
   void compileShader(GLuint shader);
   void compressedTexImage1D(GLenum target,
@@ -154,6 +176,26 @@ class IContext {
                                GLenum format,
                                GLsizei imageSize,
                                const GLvoid* data);
+  void copyBufferSubData(GLenum readTarget,
+                         GLenum writeTarget,
+                         GLintptr readOffset,
+                         GLintptr writeOffset,
+                         GLsizeiptr size);
+  void copyImageSubData(GLuint srcName,
+                        GLenum srcTarget,
+                        GLint srcLevel,
+                        GLint srcX,
+                        GLint srcY,
+                        GLint srcZ,
+                        GLuint dstName,
+                        GLenum dstTarget,
+                        GLint dstLevel,
+                        GLint dstX,
+                        GLint dstY,
+                        GLint dstZ,
+                        GLsizei srcWidth,
+                        GLsizei srcHeight,
+                        GLsizei srcDepth);
   void copyTexImage2D(GLenum target,
                       GLint level,
                       GLenum internalFormat,
@@ -184,8 +226,10 @@ class IContext {
   void deleteFramebuffers(GLsizei n, const GLuint* framebuffers);
   void deleteMemoryObjects(GLsizei n, const GLuint* objects);
   void deleteRenderbuffers(GLsizei n, const GLuint* renderbuffers);
+  void deleteSamplers(GLsizei n, const GLuint* samplers);
   void deleteVertexArrays(GLsizei n, const GLuint* vertexArrays);
   void deleteProgram(GLuint program);
+  void deleteQueries(GLsizei n, const GLuint* ids);
   void deleteShader(GLuint shaderId);
   void deleteSync(GLsync sync);
   void deleteTextures(const std::vector<GLuint>& textures);
@@ -196,11 +240,19 @@ class IContext {
   virtual void disable(GLenum cap);
   void disableVertexAttribArray(GLuint index);
   void drawArrays(GLenum mode, GLint first, GLsizei count);
+  void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
   void drawBuffers(GLsizei n, GLenum* buffers);
   void drawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices);
   void drawElementsIndirect(GLenum mode, GLenum type, const GLvoid* indirect);
+  void drawElementsInstanced(GLenum mode,
+                             GLsizei count,
+                             GLenum type,
+                             const GLvoid* indices,
+                             GLsizei instancecount);
+  void eglImageTargetTexture2D(GLenum target, void* image);
   virtual void enable(GLenum cap);
   void enableVertexAttribArray(GLuint index);
+  void endQuery(GLenum target);
   GLsync fenceSync(GLenum condition, GLbitfield flags);
   void finish();
   void flush();
@@ -229,7 +281,9 @@ class IContext {
   void generateMipmap(GLenum target);
   void genBuffers(GLsizei n, GLuint* buffers);
   void genFramebuffers(GLsizei n, GLuint* framebuffers);
+  void genQueries(GLsizei n, GLuint* ids);
   void genRenderbuffers(GLsizei n, GLuint* renderbuffers);
+  void genSamplers(GLsizei n, GLuint* samplers);
   void genTextures(GLsizei n, GLuint* textures);
   void genVertexArrays(GLsizei n, GLuint* vertexArrays);
   void getActiveAttrib(GLuint program,
@@ -269,6 +323,11 @@ class IContext {
                                            GLenum pname,
                                            GLint* params) const;
   void getIntegerv(GLenum pname, GLint* params) const;
+  void getProgramBinary(GLuint program,
+                        GLsizei bufSize,
+                        GLsizei* length,
+                        GLenum* binaryFormat,
+                        void* binary) const;
   void getProgramiv(GLuint program, GLenum pname, GLint* params) const;
   void getProgramInterfaceiv(GLuint program,
                              GLenum programInterface,
@@ -290,6 +349,8 @@ class IContext {
                               GLsizei bufSize,
                               GLsizei* length,
                               char* name) const;
+  void getQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params) const;
+  void getQueryObjectuiv(GLuint id, GLenum pname, GLuint* params) const;
   void getRenderbufferParameteriv(GLenum target, GLenum pname, GLint* params) const;
   void getShaderiv(GLuint shader, GLenum pname, GLint* params) const;
   void getShaderInfoLog(GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog) const;
@@ -326,7 +387,10 @@ class IContext {
   void pixelStorei(GLenum pname, GLint param);
   void polygonOffset(GLfloat factor, GLfloat units);
   void popDebugGroup();
+  void programBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+  void programParameteri(GLuint program, GLenum pname, GLint value);
   void pushDebugGroup(GLenum source, GLuint id, GLsizei length, const GLchar* message);
+  void queryCounter(GLuint id, GLenum target);
   void readPixels(GLint x,
                   GLint y,
                   GLsizei width,
@@ -355,8 +419,11 @@ class IContext {
                                               GLint baseViewIndex,
                                               GLsizei numViews);
   void sampleCoverage(GLfloat value, GLboolean invert);
+  void samplerParameterf(GLuint sampler, GLenum pname, GLfloat param);
+  void samplerParameteri(GLuint sampler, GLenum pname, GLint param);
   void scissor(GLint x, GLint y, GLsizei width, GLsizei height);
   virtual void setEnabled(bool shouldEnable, GLenum cap);
+  void shadingRate(GLenum rate);
   void shaderBinary(GLsizei n,
                     const GLuint* shaders,
                     GLenum binaryformat,
@@ -375,6 +442,12 @@ class IContext {
                     GLenum internalformat,
                     GLsizei width,
                     GLsizei height);
+  void texStorage2DMultisample(GLenum target,
+                               GLsizei samples,
+                               GLenum internalformat,
+                               GLsizei width,
+                               GLsizei height,
+                               GLboolean fixedsamplelocations);
   void texStorage3D(GLenum target,
                     GLsizei levels,
                     GLenum internalformat,
@@ -487,6 +560,7 @@ class IContext {
   void vertexAttrib3fv(GLuint indx, const GLfloat* values);
   void vertexAttrib4f(GLuint indx, GLfloat x, GLfloat y, GLfloat z, GLfloat w);
   void vertexAttrib4fv(GLuint indx, const GLfloat* values);
+  void vertexAttribDivisor(GLuint index, GLuint divisor);
   void vertexAttribPointer(GLuint indx,
                            GLint size,
                            GLenum type,
@@ -494,20 +568,32 @@ class IContext {
                            GLsizei stride,
                            const GLvoid* ptr);
   void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+  void waitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
 
   void dispatchCompute(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z);
+  void dispatchComputeIndirect(GLintptr indirect);
+  void maxShaderCompilerThreads(GLuint count);
   void memoryBarrier(GLbitfield barriers);
   GLuint64 getTextureHandle(GLuint texture);
+  GLuint64 getTextureSamplerHandle(GLuint texture, GLuint sampler);
   void makeTextureHandleResident(GLuint64 handle);
   void makeTextureHandleNonResident(GLuint64 handle);
 
   /** Returns current `callCounter_` value. Exposed for testing only. */
   unsigned int getCallCount() const;
+  /**
+   * Returns how many times the IContext entry point `entryPoint` (e.g. "bindTexture") reached GL
+   * since enableCallCountsByName(true) or resetCounters(). Exposed for testing only.
+   */
+  unsigned int getCallCount(const char* entryPoint) const;
+  /** Starts or stops counting the calls of every entry point. Off by default. */
+  void enableCallCountsByName(bool enable);
 
   unsigned int getCurrentDrawCount() const;
 
   // Utility functions
   [[nodiscard]] const DeviceFeatureSet& deviceFeatures() const;
+  [[nodiscard]] const GLDispatchTable& getDispatchTable() const;
   /// Calls bindBuffer(target, 0) or enqueues to run when deletion queue is flushed
   void unbindBuffer(GLenum target);
 
@@ -566,6 +652,136 @@ class IContext {
    */
   void enableAutomaticErrorCheck(bool enable);
 
+  /// A GL error found by sampled error checking
+  struct SampledError {
+    GLenum error = GL_NO_ERROR;
+    /// The IContext function after which the error was found, and its line
+    const char* callerName = nullptr;
+    size_t lineNum = 0;
+    /// True if the error was checked right after the call which caused it. Otherwise any call
+    /// since the previous check may have caused it.
+    bool isExact = false;
+  };
+
+  /** Enables or disables sampled error checking, which unlike enableAutomaticErrorCheck() is also
+   * available in release builds. getError() is called after every `callInterval`-th GL call (0
+   * to not sample calls) and, if `checkAtPassEnd` is true, whenever a render or compute pass
+   * ends. Errors are passed to `callback`, or logged if it is empty.
+   *
+   * Once an error is found the interval is halved after each further error, so that an error
+   * which keeps recurring is narrowed down to the failing call. The interval is restored after
+   * `callInterval` calls without errors. Has no effect while automatic error checking is enabled.
+   */
+  void enableSampledErrorCheck(bool enable,
+                               uint32_t callInterval = 1000,
+                               bool checkAtPassEnd = true,
+                               std::function<void(const SampledError&)> callback = nullptr);
+  /// Called by the command encoders when a pass ends
+  void checkErrorsAtPassEnd(const char* passName);
+
+  /** Enables or disables the shadow state cache. When enabled, binds of programs, vertex arrays,
+   * textures, buffers, framebuffers and renderbuffers, active texture unit changes, pixel store
+   * changes and enable/disable calls which would not change the GL state are dropped instead of
+   * being sent to the driver. getIntegerv() answers queries of the cached bindings without a GL
+   * call. Disabled by default.
+   *
+   * The cache assumes that the GL state of this context is only changed through IContext. Call
+   * invalidateStateCache() after external code has issued GL calls on this context.
+   */
+  void enableStateCache(bool enable);
+  bool isStateCacheEnabled() const {
+    return stateCacheEnabled_;
+  }
+  /// Forgets all cached state, so that the next call of each kind is sent to the driver.
+  void invalidateStateCache();
+
+  /** Caches the binaries of linked programs in `filePath`, so that later launches can load them
+   * instead of linking from source. Binaries from the file are used right away, new binaries are
+   * written by saveProgramBinaryCache() and on destruction. Returns false if the driver cannot
+   * retrieve program binaries.
+   */
+  bool enableProgramBinaryCache(std::string filePath, size_t maxFileSize = 32u * 1024u * 1024u);
+  /// Returns nullptr unless enableProgramBinaryCache() has succeeded
+  ProgramBinaryCache* getProgramBinaryCache() const {
+    return programBinaryCache_.get();
+  }
+  bool saveProgramBinaryCache();
+
+  /** Enables or disables staging of texture uploads through a ring of pixel unpack buffers, see
+   * PixelUnpackBufferRing. Compressed textures and uploads larger than `maxUploadSize` bytes are
+   * always uploaded directly. Returns false if the context cannot map and fence pixel unpack
+   * buffers. opengl::Device disables it on destruction, otherwise it has to be disabled before the
+   * GL context is destroyed.
+   */
+  bool enableAsyncTextureUploads(bool enable,
+                                 size_t numBuffers = 4,
+                                 size_t maxUploadSize = 16u * 1024u * 1024u);
+  /// Returns nullptr unless async texture uploads are enabled
+  PixelUnpackBufferRing* getPixelUnpackBufferRing() const {
+    return pixelUnpackBufferRing_.get();
+  }
+
+  /** Enables or disables caching of vertex array objects in RenderCommandAdapter, see
+   * VertexArrayCache. Returns false if the context does not support vertex array objects.
+   * opengl::Device disables it on destruction, otherwise it has to be disabled before the GL
+   * context is destroyed.
+   */
+  bool enableVertexArrayCache(bool enable, size_t maxSize = 1024);
+  /// Returns nullptr unless the vertex array cache is enabled
+  VertexArrayCache* getVertexArrayCache() const {
+    return vertexArrayCache_.get();
+  }
+
+  /** Enables or disables packing of loose uniforms into a std140 uniform block, see
+   * PackedUniformBlock. Render programs linked while it is enabled upload all of their packable
+   * uniforms as one buffer range per draw, streamed through a PackedUniformRing of `ringSize`
+   * bytes, and need it to stay enabled. Shader modules have to be created while it is enabled,
+   * too. Returns false if the context does not support uniform blocks. opengl::Device disables it
+   * on destruction, otherwise it has to be disabled before the GL context is destroyed.
+   */
+  bool enablePackedUniforms(bool enable, size_t ringSize = 1024u * 1024u);
+  /// Returns nullptr unless packed uniforms are enabled
+  PackedUniformRing* getPackedUniformRing() const {
+    return packedUniformRing_.get();
+  }
+
+  /** Enables or disables bindless textures, see BindlessTextureBlock. Render programs whose
+   * shaders declare the bindless texture block read the handles of their textures from it instead
+   * of texture units. The handles are streamed through a PackedUniformRing of `ringSize` bytes.
+   * Shader modules have to be created while it is enabled to get the shader prologue. Textures
+   * become immutable once their handles are created: only their contents can be updated, and
+   * sampler states are applied with sampler objects. Returns false if the context does not support
+   * GL_ARB_bindless_texture. opengl::Device disables it on destruction, otherwise it has to be
+   * disabled before the GL context is destroyed.
+   */
+  bool enableBindlessTextures(bool enable, size_t ringSize = 256u * 1024u);
+  /// Returns nullptr unless bindless textures are enabled
+  PackedUniformRing* getBindlessTextureRing() const {
+    return bindlessTextureRing_.get();
+  }
+
+  /** Returns the ring push constants are streamed through, see PushConstantBlock. It is created on
+   * first use, and is nullptr if the context does not support uniform blocks. opengl::Device
+   * releases it on destruction, otherwise releasePushConstantRing() has to be called before the GL
+   * context is destroyed.
+   */
+  PackedUniformRing* getPushConstantRing();
+  void releasePushConstantRing();
+
+  /** Inserts a fence after all GL commands issued so far and returns a handle for it, which is
+   * greater than all previous handles. Returns 0 if the context does not support sync objects.
+   * Used as the SubmitHandle of CommandQueue::submit().
+   */
+  uint64_t insertSubmitFence();
+  /// Polls without blocking whether the GPU has finished the commands preceding `handle`. Handle 0
+  /// is always complete
+  bool isSubmitHandleComplete(uint64_t handle);
+  /// Blocks until the GPU has finished the commands preceding `handle`
+  void waitForSubmitHandle(uint64_t handle);
+  /// Deletes the fences of all pending handles, which then count as complete. opengl::Device calls
+  /// it on destruction
+  void releaseSubmitFences();
+
   // Manages an adapter pool as recreating this every frame causes unwanted memory allocations.
   // @fb-only
   // @fb-only
@@ -589,49 +805,75 @@ class IContext {
 
  private:
   bool alwaysCheckError_ = false; // TRUE to check error after each OGL call
+
+  // Sampled error checking
+  void sampleErrors(const char* callerName, size_t lineNum) const;
+  void reportSampledError(GLenum error, const char* callerName, size_t lineNum, bool isExact) const;
+  uint32_t errorCheckInterval_ = 0;
+  bool errorCheckAtPassEnd_ = false;
+  std::function<void(const SampledError&)> sampledErrorCallback_;
+  mutable uint32_t currentErrorCheckInterval_ = 0; // halved while narrowing down an error
+  mutable uint32_t errorCheckCountdown_ = 0; // calls until the next check, 0 when not sampling
+  mutable uint32_t errorFreeCalls_ = 0; // checked calls without errors while narrowing down
   mutable GLenum lastError_ = GL_NO_ERROR;
   mutable unsigned int callCounter_ = 0;
+  // calls by entry point, null unless enableCallCountsByName() is on
+  std::unique_ptr<std::unordered_map<std::string, unsigned int>> callCountsByName_;
   unsigned int drawCallCount_ = 0;
-  int lockCount_ = 0; // used by DestructionGuard
+  std::atomic<int> lockCount_{0}; // used by DestructionGuard, read by SharedContextPool workers
   int refCount_ = 0; // used by addRef/releaseRef
 
   // API Logging
   unsigned int apiLogDrawsLeft_ = 0;
   bool apiLogEnabled_ = false;
 
+  PFNIGLBEGINQUERYPROC beginQueryProc_ = nullptr;
   PFNIGLBINDIMAGETEXTUREPROC bindImageTexturerProc_ = nullptr;
   PFNIGLBINDVERTEXARRAYPROC bindVertexArrayProc_ = nullptr;
   PFNIGLBLITFRAMEBUFFERPROC blitFramebufferProc_ = nullptr;
+  PFNIGLBUFFERSTORAGEPROC bufferStorageProc_ = nullptr;
   PFNIGLCLEARDEPTHFPROC clearDepthfProc_ = nullptr;
+  PFNIGLCLIENTWAITSYNCPROC clientWaitSyncProc_ = nullptr;
   PFNIGLCOMPRESSEDTEXIMAGE3DPROC compressedTexImage3DProc_ = nullptr;
   PFNIGLCOMPRESSEDTEXSUBIMAGE3DPROC compressedTexSubImage3DProc_ = nullptr;
   PFNIGLDEBUGMESSAGEINSERTPROC debugMessageInsertProc_ = nullptr;
+  PFNIGLDELETEQUERIESPROC deleteQueriesProc_ = nullptr;
   PFNIGLDELETESYNCPROC deleteSyncProc_ = nullptr;
   PFNIGLDELETEVERTEXARRAYSPROC deleteVertexArraysProc_ = nullptr;
   PFNIGLDRAWBUFFERSPROC drawBuffersProc_ = nullptr;
+  PFNIGLENDQUERYPROC endQueryProc_ = nullptr;
   PFNIGLFENCESYNCPROC fenceSyncProc_ = nullptr;
   PFNIGLFRAMEBUFFERTEXTURE2DMULTISAMPLEPROC framebufferTexture2DMultisampleProc_ = nullptr;
   PFNIGLINVALIDATEFRAMEBUFFERPROC invalidateFramebufferProc_ = nullptr;
+  PFNIGLGENQUERIESPROC genQueriesProc_ = nullptr;
   PFNIGLGENVERTEXARRAYSPROC genVertexArraysProc_ = nullptr;
+  mutable PFNIGLGETQUERYOBJECTUI64VPROC getQueryObjectui64vProc_ = nullptr;
+  mutable PFNIGLGETQUERYOBJECTUIVPROC getQueryObjectuivProc_ = nullptr;
   mutable PFNIGLGETSYNCIVPROC getSyncivProc_ = nullptr;
   PFNIGLGETTEXTUREHANDLEPROC getTextureHandleProc_ = nullptr;
   PFNIGLMAKETEXTUREHANDLERESIDENTPROC makeTextureHandleResidentProc_ = nullptr;
   PFNIGLMAKETEXTUREHANDLENONRESIDENTPROC makeTextureHandleNonResidentProc_ = nullptr;
+  PFNIGLGETTEXTURESAMPLERHANDLEPROC getTextureSamplerHandleProc_ = nullptr;
   PFNIGLMAPBUFFERPROC mapBufferProc_ = nullptr;
   PFNIGLMAPBUFFERRANGEPROC mapBufferRangeProc_ = nullptr;
+  PFNIGLMAXSHADERCOMPILERTHREADSPROC maxShaderCompilerThreadsProc_ = nullptr;
   PFNIGLMEMORYBARRIERPROC memoryBarrierProc_ = nullptr;
   PFNIGLPOPDEBUGGROUPPROC popDebugGroupProc_ = nullptr;
   PFNIGLPUSHDEBUGGROUPPROC pushDebugGroupProc_ = nullptr;
+  PFNIGLQUERYCOUNTERPROC queryCounterProc_ = nullptr;
   PFNIGLRENDERBUFFERSTORAGEMULTISAMPLEPROC renderbufferStorageMultisampleProc_ = nullptr;
+  PFNIGLSHADINGRATEPROC shadingRateProc_ = nullptr;
   PFNIGLTEXIMAGE3DPROC texImage3DProc_ = nullptr;
   PFNIGLTEXSTORAGE1DPROC texStorage1DProc_ = nullptr;
   PFNIGLTEXSTORAGE2DPROC texStorage2DProc_ = nullptr;
   PFNIGLTEXSTORAGE3DPROC texStorage3DProc_ = nullptr;
   PFNIGLTEXSUBIMAGE3DPROC texSubImage3DProc_ = nullptr;
   PFNIGLUNMAPBUFFERPROC unmapBufferProc_ = nullptr;
+  PFNIGLWAITSYNCPROC waitSyncProc_ = nullptr;
 
   /// Responsible for holding onto operations queued for deletion when not in context.
-  /// All operations to non-scratch queues are suyncronized by one mutex
+  /// All operations to non-scratch queues are suyncronized by one mutex. Flushing skips the mutex
+  /// while nothing is queued, and deletes the queued objects with one call per object type.
   struct SynchronizedDeletionQueues {
    public:
     void flushDeletionQueue(IContext& context);
@@ -652,7 +894,7 @@ class IContext {
     // These are swapped with the main queues then read to perform operations. They can be read from
     // flushDeletionQueue w/o synchronization.
     std::vector<GLuint> scratchBuffersQueue_;
-    std::unordered_set<GLenum> scratchUnbindBuffersQueue_;
+    std::vector<GLenum> scratchUnbindBuffersQueue_;
     std::vector<GLuint> scratchFramebuffersQueue_;
     std::vector<GLuint> scratchRenderbuffersQueue_;
     std::vector<GLuint> scratchVertexArraysQueue_;
@@ -662,11 +904,14 @@ class IContext {
 
     // Guards all the non-scratch queues.
     std::mutex deletionQueueMutex_;
+    // Set while any of the non-scratch queues is not empty
+    std::atomic<bool> hasQueuedOperations_{false};
 
     // Resources queued for deletion
     std::vector<GLuint> buffersQueue_;
-    // These are the targets for the buffers that we enqueued for deletion that we need to unbind
-    std::unordered_set<GLenum> unbindBuffersQueue_;
+    // These are the targets for the buffers that we enqueued for deletion that we need to unbind,
+    // without duplicates
+    std::vector<GLenum> unbindBuffersQueue_;
     std::vector<GLuint> framebuffersQueue_;
     std::vector<GLuint> renderbuffersQueue_;
     std::vector<GLuint> vertexArraysQueue_;
@@ -677,6 +922,52 @@ class IContext {
 
   SynchronizedDeletionQueues deletionQueues_;
 
+  /// Shadow copy of the GL state used to drop redundant calls, see enableStateCache().
+  /// Missing entries and kUnknown mean the state is not known.
+  struct StateCache {
+    static constexpr GLuint kUnknown = ~0u;
+
+    GLenum activeTexture = kUnknown;
+    GLuint program = kUnknown;
+    GLuint vertexArray = kUnknown;
+    GLuint readFramebuffer = kUnknown;
+    GLuint drawFramebuffer = kUnknown;
+    GLuint renderbuffer = kUnknown;
+    // keyed by (texture unit << 32) | target
+    std::unordered_map<uint64_t, GLuint> textures;
+    std::unordered_map<GLenum, GLuint> buffers;
+    std::unordered_map<GLenum, bool> capabilities;
+    std::unordered_map<GLenum, GLint> pixelStore;
+
+    void clear();
+    // Returns true if `cap` is already in the requested state, otherwise records the new state
+    bool updateCapability(GLenum cap, bool enabled);
+    // Forgets every binding of the deleted objects
+    void forgetBuffers(GLsizei n, const GLuint* buffers);
+    void forgetTextures(const std::vector<GLuint>& textures);
+    // Returns true and sets `value` if the binding queried by `pname` is known
+    bool getBinding(GLenum pname, GLint& value) const;
+  };
+
+  bool stateCacheEnabled_ = false;
+  StateCache stateCache_;
+
+  std::unique_ptr<ProgramBinaryCache> programBinaryCache_;
+  std::unique_ptr<PixelUnpackBufferRing> pixelUnpackBufferRing_;
+  std::unique_ptr<VertexArrayCache> vertexArrayCache_;
+  std::unique_ptr<PackedUniformRing> packedUniformRing_;
+  std::unique_ptr<PackedUniformRing> bindlessTextureRing_;
+  std::unique_ptr<PackedUniformRing> pushConstantRing_;
+
+  // Retires the fences of handles up to `handle`, waiting up to `timeoutNs` for each of them.
+  // Returns true if `handle` is complete
+  bool retireSubmitFences(uint64_t handle, GLuint64 timeoutNs);
+
+  // fences of pending submit handles, oldest first
+  std::deque<std::pair<uint64_t, GLsync>> submitFences_;
+  uint64_t nextSubmitHandle_ = 1;
+  uint64_t lastCompletedSubmitHandle_ = 0;
+
   UnbindPolicy unbindPolicy_ = UnbindPolicy::Default;
 
   void getGLMajorAndMinorVersions(GLint& majorVersion, GLint& minorVersion) const;
@@ -685,6 +976,8 @@ class IContext {
   std::vector<std::unique_ptr<RenderCommandAdapter>> renderAdapterPool_;
   std::vector<std::unique_ptr<ComputeCommandAdapter>> computeAdapterPool_;
 
+  // Entry points of the igl* functions, resolved in initialize()
+  GLDispatchTable glDispatch_;
   DeviceFeatureSet deviceFeatureSet_;
 
   // For framebufferTexture2DMultisample
@@ -11,9 +11,42 @@
 #include <cstdint>
 #include <igl/Common.h>
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define IGL_MEMCPY_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IGL_MEMCPY_SSE2 1
+#endif
+
 namespace igl {
 namespace opengl {
 
+namespace {
+
+// Copies numVectors 16-byte vectors. Loads and stores are unaligned, so 4-byte alignment is enough
+inline void copyVectors(void* dst, const void* src, size_t numVectors) {
+  auto* d = static_cast<uint8_t*>(dst);
+  const auto* s = static_cast<const uint8_t*>(src);
+#if IGL_MEMCPY_NEON
+  for (size_t i = 0; i != numVectors; i++) {
+    vst1q_u8(d + i * 16, vld1q_u8(s + i * 16));
+  }
+#elif IGL_MEMCPY_SSE2
+  for (size_t i = 0; i != numVectors; i++) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i * 16),
+                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i * 16)));
+  }
+#else
+  for (size_t i = 0; i != numVectors; i++) {
+    *((uint64_t*)(d + i * 16)) = *((const uint64_t*)(s + i * 16));
+    *((uint64_t*)(d + i * 16) + 1) = *((const uint64_t*)(s + i * 16) + 1);
+  }
+#endif
+}
+
+} // namespace
+
 void optimizedMemcpy(void* dst, const void* src, size_t size) {
   size_t optimizationCase = size;
 
@@ -36,13 +69,23 @@ void optimizedMemcpy(void* dst, const void* src, size_t size) {
     *((uint64_t*)dst) = *((const uint64_t*)src);
     *((uint32_t*)(dst) + 2) = *((const uint32_t*)(src) + 2);
     break;
+  // vec4, mat2, mat3x4 and mat4
   case 16:
-    *((uint64_t*)dst) = *((const uint64_t*)src);
-    *((uint64_t*)(dst) + 1) = *((const uint64_t*)(src) + 1);
+    copyVectors(dst, src, 1);
+    break;
+  case 32:
+    copyVectors(dst, src, 2);
+    break;
+  case 48:
+    copyVectors(dst, src, 3);
+    break;
+  case 64:
+    copyVectors(dst, src, 4);
     break;
   default:
     memcpy(dst, src, size);
   }
 }
+
 } // namespace opengl
 } // namespace igl
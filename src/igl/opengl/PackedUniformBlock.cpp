@@ -0,0 +1,434 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/PackedUniformBlock.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <igl/opengl/IContext.h>
+#include <igl/opengl/PackedUniformRing.h>
+#include <iterator>
+#include <unordered_set>
+
+namespace igl {
+namespace opengl {
+
+namespace {
+
+struct LooseUniform {
+  std::string type;
+  std::string name;
+  std::string arraySize; // empty if the uniform is not an array
+  // the declaration in the source, including the semicolon
+  size_t begin = 0;
+  size_t end = 0;
+};
+
+bool isIdentifierChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool isSpace(char c) {
+  return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+// Returns true if the GLSL version of `source` has uniform blocks
+bool hasUniformBlocks(const std::string& source) {
+  const size_t pos = source.find("#version");
+  if (pos == std::string::npos) {
+    return false;
+  }
+  const int version = std::atoi(source.c_str() + pos + strlen("#version"));
+  const size_t lineEnd = source.find('\n', pos);
+  const bool isES = source.find(" es", pos) < lineEnd;
+  return isES ? version >= 300 : version >= 140;
+}
+
+bool isPackableType(const std::string& type) {
+  static const char* const kTypes[] = {"float",
+                                       "vec2",
+                                       "vec3",
+                                       "vec4",
+                                       "int",
+                                       "ivec2",
+                                       "ivec3",
+                                       "ivec4",
+                                       "bool",
+                                       "mat2",
+                                       "mat3",
+                                       "mat4"};
+  return std::any_of(std::begin(kTypes), std::end(kTypes), [&type](const char* packableType) {
+    return type == packableType;
+  });
+}
+
+// Parses `uniform [precision] type name[arraySize]` without the semicolon
+bool parseDeclaration(const std::string& statement, LooseUniform& outUniform) {
+  std::vector<std::string> tokens;
+  for (size_t i = 0; i < statement.size();) {
+    if (isSpace(statement[i])) {
+      i++;
+    } else if (isIdentifierChar(statement[i])) {
+      const size_t begin = i;
+      while (i < statement.size() && isIdentifierChar(statement[i])) {
+        i++;
+      }
+      tokens.emplace_back(statement, begin, i - begin);
+    } else {
+      tokens.emplace_back(1, statement[i++]);
+    }
+  }
+
+  size_t i = 0;
+  if (tokens.size() < 3 || tokens[i++] != "uniform") {
+    return false;
+  }
+  if (tokens[i] == "lowp" || tokens[i] == "mediump" || tokens[i] == "highp") {
+    i++;
+  }
+  if (i + 2 > tokens.size()) {
+    return false;
+  }
+  outUniform.type = tokens[i++];
+  outUniform.name = tokens[i++];
+  if (!isPackableType(outUniform.type) || !isIdentifierChar(outUniform.name[0]) ||
+      std::isdigit(static_cast<unsigned char>(outUniform.name[0])) ||
+      outUniform.name.rfind("gl_", 0) == 0) {
+    return false;
+  }
+  if (i == tokens.size()) {
+    return true;
+  }
+  if (i + 3 == tokens.size() && tokens[i] == "[" &&
+      std::isdigit(static_cast<unsigned char>(tokens[i + 1][0])) && tokens[i + 2] == "]") {
+    outUniform.arraySize = tokens[i + 1];
+    return true;
+  }
+  return false;
+}
+
+// Finds the declarations of loose uniforms at global scope which are not inside preprocessor
+// conditionals
+std::vector<LooseUniform> findLooseUniforms(const std::string& source) {
+  std::vector<LooseUniform> uniforms;
+
+  // the current statement with comments replaced by spaces
+  std::string statement;
+  size_t statementBegin = std::string::npos;
+  int braceDepth = 0;
+  int conditionalDepth = 0;
+  bool isLineStart = true;
+
+  auto endStatement = [&statement, &statementBegin]() {
+    statement.clear();
+    statementBegin = std::string::npos;
+  };
+
+  for (size_t i = 0; i < source.size(); i++) {
+    const char c = source[i];
+    const char next = i + 1 < source.size() ? source[i + 1] : '\0';
+
+    if (c == '\n') {
+      isLineStart = true;
+      statement += ' ';
+      continue;
+    }
+    if (isLineStart && c == '#') {
+      size_t end = i;
+      while (end < source.size() && source[end] != '\n') {
+        // continuation lines
+        end += source[end] == '\\' ? 2 : 1;
+      }
+      const size_t directive = std::min(source.find_first_not_of(" \t", i + 1), source.size());
+      if (source.compare(directive, 2, "if") == 0) {
+        conditionalDepth++;
+      } else if (source.compare(directive, 5, "endif") == 0) {
+        conditionalDepth--;
+      }
+      endStatement();
+      i = end - 1;
+      continue;
+    }
+    if (!isSpace(c)) {
+      isLineStart = false;
+    }
+    if (c == '/' && next == '/') {
+      i = std::min(source.find('\n', i), source.size()) - 1;
+      statement += ' ';
+      continue;
+    }
+    if (c == '/' && next == '*') {
+      const size_t end = source.find("*/", i + 2);
+      i = end == std::string::npos ? source.size() : end + 1;
+      statement += ' ';
+      continue;
+    }
+    if (c == '{' || c == '}') {
+      braceDepth += c == '{' ? 1 : -1;
+      endStatement();
+      continue;
+    }
+    if (c == ';') {
+      LooseUniform uniform;
+      if (braceDepth == 0 && conditionalDepth == 0 && statementBegin != std::string::npos &&
+          parseDeclaration(statement, uniform)) {
+        uniform.begin = statementBegin;
+        uniform.end = i + 1;
+        uniforms.push_back(std::move(uniform));
+      }
+      endStatement();
+      continue;
+    }
+    if (statementBegin == std::string::npos && !isSpace(c)) {
+      statementBegin = i;
+    }
+    statement += c;
+  }
+
+  return uniforms;
+}
+
+// Replaces the first declaration with the block and removes the others
+void replaceDeclarations(std::string& source,
+                         const std::vector<LooseUniform>& uniforms,
+                         const std::string& block) {
+  for (size_t i = uniforms.size(); i-- > 0;) {
+    source.replace(uniforms[i].begin, uniforms[i].end - uniforms[i].begin, i == 0 ? block : "");
+  }
+}
+
+UniformType toUniformType(GLenum type) {
+  switch (type) {
+  case GL_FLOAT:
+    return UniformType::Float;
+  case GL_FLOAT_VEC2:
+    return UniformType::Float2;
+  case GL_FLOAT_VEC3:
+    return UniformType::Float3;
+  case GL_FLOAT_VEC4:
+    return UniformType::Float4;
+  case GL_BOOL:
+    return UniformType::Boolean;
+  case GL_INT:
+    return UniformType::Int;
+  case GL_INT_VEC2:
+    return UniformType::Int2;
+  case GL_INT_VEC3:
+    return UniformType::Int3;
+  case GL_INT_VEC4:
+    return UniformType::Int4;
+  case GL_FLOAT_MAT2:
+    return UniformType::Mat2x2;
+  case GL_FLOAT_MAT3:
+    return UniformType::Mat3x3;
+  case GL_FLOAT_MAT4:
+    return UniformType::Mat4x4;
+  default:
+    return UniformType::Invalid;
+  }
+}
+
+} // namespace
+
+bool PackedUniformBlock::packShaderSources(std::string& vertexSource,
+                                           std::string& fragmentSource) {
+  if (!hasUniformBlocks(vertexSource) || !hasUniformBlocks(fragmentSource)) {
+    return false;
+  }
+
+  std::vector<LooseUniform> vertexUniforms = findLooseUniforms(vertexSource);
+  std::vector<LooseUniform> fragmentUniforms = findLooseUniforms(fragmentSource);
+
+  // both stages have to declare the same block, so it holds the uniforms of both stages
+  std::vector<LooseUniform> members;
+  std::unordered_set<std::string> conflicts;
+  for (const auto* uniforms : {&vertexUniforms, &fragmentUniforms}) {
+    for (const auto& uniform : *uniforms) {
+      const auto it =
+          std::find_if(members.begin(), members.end(), [&uniform](const LooseUniform& member) {
+            return member.name == uniform.name;
+          });
+      if (it == members.end()) {
+        members.push_back(uniform);
+      } else if (it->type != uniform.type || it->arraySize != uniform.arraySize) {
+        conflicts.insert(uniform.name);
+      }
+    }
+  }
+
+  auto isConflict = [&conflicts](const LooseUniform& uniform) {
+    return conflicts.count(uniform.name) != 0;
+  };
+  members.erase(std::remove_if(members.begin(), members.end(), isConflict), members.end());
+  vertexUniforms.erase(std::remove_if(vertexUniforms.begin(), vertexUniforms.end(), isConflict),
+                       vertexUniforms.end());
+  fragmentUniforms.erase(
+      std::remove_if(fragmentUniforms.begin(), fragmentUniforms.end(), isConflict),
+      fragmentUniforms.end());
+
+  if (members.empty()) {
+    return false;
+  }
+
+  std::string block = std::string("layout(std140) uniform ") + kBlockName + " {\n";
+  for (const auto& member : members) {
+    // the block has to match in both stages, including precision. bool takes no precision
+    block += member.type == "bool" ? "  " : "  highp ";
+    block += member.type + " " + member.name;
+    if (!member.arraySize.empty()) {
+      block += "[" + member.arraySize + "]";
+    }
+    block += ";\n";
+  }
+  block += "};";
+
+  replaceDeclarations(vertexSource, vertexUniforms, block);
+  replaceDeclarations(fragmentSource, fragmentUniforms, block);
+
+  return true;
+}
+
+std::unique_ptr<PackedUniformBlock> PackedUniformBlock::create(IContext& context, GLuint program) {
+  const GLuint blockIndex = context.getUniformBlockIndex(program, kBlockName);
+  if (blockIndex == GL_INVALID_INDEX) {
+    return nullptr;
+  }
+
+  GLint dataSize = 0;
+  GLint numUniforms = 0;
+  GLint maxNameLength = 0;
+  context.getActiveUniformBlockiv(program, blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &dataSize);
+  context.getActiveUniformBlockiv(
+      program, blockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &numUniforms);
+  context.getProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+  if (dataSize <= 0 || numUniforms <= 0 || maxNameLength <= 0) {
+    return nullptr;
+  }
+
+  std::vector<GLint> indices(numUniforms);
+  context.getActiveUniformBlockiv(
+      program, blockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES, indices.data());
+  const std::vector<GLuint> uniformIndices(indices.begin(), indices.end());
+
+  std::vector<GLint> offsets(numUniforms);
+  std::vector<GLint> arrayStrides(numUniforms);
+  std::vector<GLint> matrixStrides(numUniforms);
+  context.getActiveUniformsiv(
+      program, numUniforms, uniformIndices.data(), GL_UNIFORM_OFFSET, offsets.data());
+  context.getActiveUniformsiv(
+      program, numUniforms, uniformIndices.data(), GL_UNIFORM_ARRAY_STRIDE, arrayStrides.data());
+  context.getActiveUniformsiv(
+      program, numUniforms, uniformIndices.data(), GL_UNIFORM_MATRIX_STRIDE, matrixStrides.data());
+
+  auto block = std::make_unique<PackedUniformBlock>();
+  block->data_.resize(dataSize);
+
+  std::vector<GLchar> name(maxNameLength);
+  for (GLint i = 0; i != numUniforms; i++) {
+    GLsizei length = 0;
+    GLint size = 0;
+    GLenum type = GL_NONE;
+    context.getActiveUniform(
+        program, uniformIndices[i], maxNameLength, &length, &size, &type, name.data());
+    if (length >= 4 && std::strncmp(name.data() + length - 3, "[0]", 3) == 0) {
+      length -= 3; // remove '[0]' for arrays
+    }
+
+    Member member;
+    member.name.assign(name.data(), length);
+    member.type = toUniformType(type);
+    member.arrayLength = size > 0 ? static_cast<size_t>(size) : 1;
+    member.offset = static_cast<size_t>(std::max(offsets[i], 0));
+    member.arrayStride = static_cast<size_t>(std::max(arrayStrides[i], 0));
+    member.matrixStride = static_cast<size_t>(std::max(matrixStrides[i], 0));
+    block->members_.push_back(std::move(member));
+  }
+
+  context.uniformBlockBinding(program, blockIndex, PackedUniformRing::kBindingIndex);
+
+  return block;
+}
+
+GLint PackedUniformBlock::getLocation(const std::string& name) const {
+  for (size_t i = 0; i != members_.size(); i++) {
+    if (members_[i].name == name) {
+      return kLocationBase + static_cast<GLint>(i);
+    }
+  }
+  return -1;
+}
+
+void PackedUniformBlock::write(const UniformDesc& desc, const uint8_t* data) {
+  const auto index = static_cast<size_t>(desc.location - kLocationBase);
+  if (!IGL_VERIFY(index < members_.size())) {
+    return;
+  }
+
+  const Member& member = members_[index];
+  const size_t typeSize = sizeForUniformType(desc.type);
+  const size_t stride = desc.elementStride != 0 ? desc.elementStride : typeSize;
+  const size_t numElements = std::min(desc.numElements, member.arrayLength);
+
+  // matrices are written column by column
+  size_t numColumns = 0;
+  switch (desc.type) {
+  case UniformType::Mat2x2:
+    numColumns = 2;
+    break;
+  case UniformType::Mat3x3:
+    numColumns = 3;
+    break;
+  case UniformType::Mat4x4:
+    numColumns = 4;
+    break;
+  default:
+    break;
+  }
+
+  for (size_t i = 0; i != numElements; i++) {
+    const uint8_t* src = data + i * stride;
+    const size_t offset = member.offset + i * member.arrayStride;
+    if (desc.type == UniformType::Boolean) {
+      // bools take 4 bytes in std140
+      const int32_t value = *src ? 1 : 0;
+      writeBytes(offset, &value, sizeof(value));
+    } else if (numColumns != 0) {
+      for (size_t column = 0; column != numColumns; column++) {
+        writeBytes(offset + column * member.matrixStride,
+                   src + column * (stride / numColumns),
+                   numColumns * sizeof(float));
+      }
+    } else {
+      writeBytes(offset, src, typeSize);
+    }
+  }
+}
+
+void PackedUniformBlock::writeBytes(size_t offset, const void* src, size_t size) {
+  if (!IGL_VERIFY(offset + size <= data_.size())) {
+    return;
+  }
+  uint8_t* dst = data_.data() + offset;
+  if (memcmp(dst, src, size) != 0) {
+    memcpy(dst, src, size);
+    isDirty_ = true;
+  }
+}
+
+void PackedUniformBlock::bind(PackedUniformRing& ring) {
+  if (isDirty_ || rangeGeneration_ != ring.getGeneration()) {
+    rangeOffset_ = ring.upload(data_.data(), data_.size());
+    rangeGeneration_ = ring.getGeneration();
+    isDirty_ = false;
+  }
+  ring.bindRange(rangeOffset_, data_.size());
+}
+
+} // namespace opengl
+} // namespace igl
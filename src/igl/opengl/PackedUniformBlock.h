@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/Uniform.h>
+#include <igl/opengl/GLIncludes.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace igl {
+namespace opengl {
+
+class IContext;
+class PackedUniformRing;
+
+/**
+ * @brief Emulates the loose uniforms of a program with a std140 uniform block, so that all of
+ * them are uploaded with one buffer range per draw instead of one glUniform*() call each.
+ *
+ * packShaderSources() moves the loose uniform declarations of both stages into an identical block
+ * named kBlockName. The members of the linked block get pseudo locations starting at
+ * kLocationBase, which RenderPipelineReflection reports in place of real uniform locations, so
+ * clients keep binding them with UniformDesc. UniformAdapter writes their values into a CPU copy
+ * of the block, which is uploaded through PackedUniformRing when it has changed.
+ */
+class PackedUniformBlock final {
+ public:
+  static constexpr const char* kBlockName = "IGLPackedUniforms";
+  /// Locations returned by the driver are small integers, so pseudo locations start well above
+  static constexpr GLint kLocationBase = 1 << 20;
+
+  static bool isPackedLocation(GLint location) {
+    return location >= kLocationBase;
+  }
+
+  /// Moves the loose uniform declarations of both sources into a uniform block. Declarations the
+  /// simple parser does not understand, e.g. inside preprocessor conditionals or with several
+  /// declarators, stay loose, and so do uniforms which are declared differently in both sources.
+  /// Returns false and leaves the sources untouched if the GLSL version has no uniform blocks or
+  /// there is nothing to pack
+  static bool packShaderSources(std::string& vertexSource, std::string& fragmentSource);
+
+  /// Returns nullptr if `program` has no active packed uniform block. Assigns the block to
+  /// PackedUniformRing::kBindingIndex
+  static std::unique_ptr<PackedUniformBlock> create(IContext& context, GLuint program);
+
+  /// Returns the pseudo location of the member `name`, or -1
+  GLint getLocation(const std::string& name) const;
+
+  /// Writes the value of a uniform with a pseudo location into the block
+  void write(const UniformDesc& desc, const uint8_t* data);
+
+  /// Uploads the block if it has changed and binds it
+  void bind(PackedUniformRing& ring);
+
+ private:
+  struct Member {
+    std::string name;
+    UniformType type = UniformType::Invalid;
+    size_t arrayLength = 1;
+    size_t offset = 0;
+    size_t arrayStride = 0;
+    size_t matrixStride = 0;
+  };
+
+  void writeBytes(size_t offset, const void* src, size_t size);
+
+ private:
+  std::vector<Member> members_;
+  std::vector<uint8_t> data_;
+  bool isDirty_ = true;
+  size_t rangeOffset_ = 0;
+  uint64_t rangeGeneration_ = 0;
+};
+
+} // namespace opengl
+} // namespace igl
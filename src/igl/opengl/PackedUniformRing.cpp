@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/PackedUniformRing.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <igl/opengl/IContext.h>
+
+namespace igl {
+namespace opengl {
+
+namespace {
+
+// unique across rings, so a range uploaded into a destroyed ring never looks valid
+std::atomic<uint64_t> sNextGeneration = 1;
+
+} // namespace
+
+PackedUniformRing::PackedUniformRing(IContext& context, size_t size, GLuint bindingIndex) :
+  context_(context), size_(size), bindingIndex_(bindingIndex) {
+  GLint alignment = 0;
+  context_.getIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  if (alignment > 0) {
+    alignment_ = static_cast<size_t>(alignment);
+  }
+}
+
+size_t PackedUniformRing::upload(const void* data, size_t size) {
+  IGL_ASSERT(data && size > 0);
+
+  if (!buffer_) {
+    context_.genBuffers(1, &buffer_);
+  }
+
+  context_.bindBuffer(GL_UNIFORM_BUFFER, buffer_);
+
+  size_t offset = (offset_ + alignment_ - 1) / alignment_ * alignment_;
+
+  if (!isAllocated_ || offset + size > size_) {
+    size_ = std::max(size_, size);
+    // the driver keeps the old storage alive for the draws which still read from it
+    context_.bufferData(GL_UNIFORM_BUFFER, (GLsizeiptr)size_, nullptr, GL_STREAM_DRAW);
+    isAllocated_ = true;
+    generation_ = sNextGeneration++;
+    boundSize_ = 0;
+    offset = 0;
+  }
+
+  void* dst = nullptr;
+  if (context_.deviceFeatures().hasFeature(DeviceFeatures::MapBufferRange) &&
+      context_.deviceFeatures().hasInternalFeature(InternalFeatures::UnmapBuffer)) {
+    // nothing has been written to this range since the storage was orphaned
+    dst = context_.mapBufferRange(GL_UNIFORM_BUFFER,
+                                  (GLintptr)offset,
+                                  (GLsizeiptr)size,
+                                  GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+                                      GL_MAP_UNSYNCHRONIZED_BIT);
+  }
+  if (dst) {
+    memcpy(dst, data, size);
+    context_.unmapBuffer(GL_UNIFORM_BUFFER);
+  } else {
+    context_.bufferSubData(GL_UNIFORM_BUFFER, (GLintptr)offset, (GLsizeiptr)size, data);
+  }
+
+  offset_ = offset + size;
+
+  return offset;
+}
+
+void PackedUniformRing::bindRange(size_t offset, size_t size) {
+  if (offset == boundOffset_ && size == boundSize_) {
+    return;
+  }
+  context_.bindBufferRange(
+      GL_UNIFORM_BUFFER, bindingIndex_, buffer_, (GLintptr)offset, (GLsizeiptr)size);
+  boundOffset_ = offset;
+  boundSize_ = size;
+}
+
+void PackedUniformRing::destroy() {
+  if (buffer_) {
+    context_.deleteBuffers(1, &buffer_);
+    buffer_ = 0;
+  }
+  isAllocated_ = false;
+  offset_ = 0;
+  boundSize_ = 0;
+}
+
+} // namespace opengl
+} // namespace igl
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/Common.h>
+#include <igl/opengl/GLIncludes.h>
+
+namespace igl {
+namespace opengl {
+
+class IContext;
+
+/**
+ * @brief Streams the std140 images of PackedUniformBlock into one uniform buffer. Every upload
+ * goes into storage which has not been written since the buffer was last orphaned, so no upload
+ * waits for the GPU. When the buffer is full, its storage is orphaned with glBufferData() and the
+ * driver keeps the old storage alive until the draws reading it are done.
+ *
+ * The destructor makes no GL calls, call destroy() while the context is still alive.
+ */
+class PackedUniformRing final {
+ public:
+  /// The uniform buffer binding of the packed uniform block. It is outside of the bindings
+  /// available to IGL clients, so it never clashes with setUniformBuffer()
+  static constexpr GLuint kBindingIndex = static_cast<GLuint>(IGL_UNIFORM_BLOCKS_BINDING_MAX);
+
+  /// Ranges are bound to `bindingIndex`, other rings (e.g. the one of BindlessTextureBlock) use
+  /// another binding
+  PackedUniformRing(IContext& context, size_t size, GLuint bindingIndex = kBindingIndex);
+
+  /// Copies `size` bytes of `data` into unused storage and returns their offset in the buffer.
+  /// Orphans the storage first if the ring is full, which changes getGeneration()
+  size_t upload(const void* data, size_t size);
+
+  /// Offsets returned by upload() are only valid while the generation stays the same
+  uint64_t getGeneration() const {
+    return generation_;
+  }
+
+  /// Binds a range returned by upload() to the binding index of the ring
+  void bindRange(size_t offset, size_t size);
+
+  /// Deletes the buffer
+  void destroy();
+
+ private:
+  IContext& context_;
+  GLuint buffer_ = 0;
+  size_t size_ = 0;
+  GLuint bindingIndex_ = kBindingIndex;
+  size_t alignment_ = 256;
+  size_t offset_ = 0;
+  bool isAllocated_ = false;
+  uint64_t generation_ = 0;
+  size_t boundOffset_ = 0;
+  size_t boundSize_ = 0;
+};
+
+} // namespace opengl
+} // namespace igl
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/ParallelRenderCommandEncoder.h>
+
+#include <igl/opengl/CommandBuffer.h>
+#include <igl/opengl/DeferredRenderCommandEncoder.h>
+
+namespace igl {
+namespace opengl {
+
+ParallelRenderCommandEncoder::ParallelRenderCommandEncoder(
+    const std::shared_ptr<CommandBuffer>& commandBuffer,
+    const RenderPassDesc& renderPass,
+    std::shared_ptr<IFramebuffer> framebuffer) :
+  IParallelRenderCommandEncoder(commandBuffer),
+  commandBuffer_(commandBuffer),
+  renderPass_(renderPass),
+  framebuffer_(std::move(framebuffer)) {
+  IGL_ASSERT(commandBuffer);
+}
+
+ParallelRenderCommandEncoder::~ParallelRenderCommandEncoder() {
+  IGL_ASSERT(!isEncoding_); // did you forget to call endEncoding()?
+  endEncoding();
+}
+
+std::unique_ptr<IRenderCommandEncoder> ParallelRenderCommandEncoder::createRenderCommandEncoder(
+    Result* outResult) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (!IGL_VERIFY(isEncoding_)) {
+    Result::setResult(outResult,
+                      Result::Code::InvalidOperation,
+                      "The parallel render command encoder is not encoding");
+    return nullptr;
+  }
+
+  streams_.push_back(std::make_unique<CommandStream>());
+  // labels recorded from now on go after this encoder
+  labelEncoder_.reset();
+
+  Result::setOk(outResult);
+  return std::make_unique<DeferredRenderCommandEncoder>(commandBuffer_, *streams_.back());
+}
+
+void ParallelRenderCommandEncoder::endEncoding() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (!isEncoding_) {
+    return;
+  }
+
+  isEncoding_ = false;
+  labelEncoder_.reset();
+
+  commandBuffer_->addDeferredRenderPass(renderPass_, std::move(framebuffer_), std::move(streams_));
+  streams_.clear();
+}
+
+DeferredRenderCommandEncoder& ParallelRenderCommandEncoder::getLabelEncoder() const {
+  if (!labelEncoder_) {
+    streams_.push_back(std::make_unique<CommandStream>());
+    labelEncoder_ =
+        std::make_unique<DeferredRenderCommandEncoder>(commandBuffer_, *streams_.back());
+  }
+  return *labelEncoder_;
+}
+
+void ParallelRenderCommandEncoder::pushDebugGroupLabel(const std::string& label,
+                                                       const igl::Color& color) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  IGL_ASSERT(isEncoding_);
+  getLabelEncoder().pushDebugGroupLabel(label, color);
+}
+
+void ParallelRenderCommandEncoder::insertDebugEventLabel(const std::string& label,
+                                                         const igl::Color& color) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  IGL_ASSERT(isEncoding_);
+  getLabelEncoder().insertDebugEventLabel(label, color);
+}
+
+void ParallelRenderCommandEncoder::popDebugGroupLabel() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  IGL_ASSERT(isEncoding_);
+  getLabelEncoder().popDebugGroupLabel();
+}
+
+} // namespace opengl
+} // namespace igl
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include <igl/Common.h>
+#include <igl/ParallelRenderCommandEncoder.h>
+#include <igl/RenderPass.h>
+#include <igl/opengl/CommandStream.h>
+
+namespace igl {
+namespace opengl {
+
+class CommandBuffer;
+class DeferredRenderCommandEncoder;
+
+/**
+ * @brief Hands out DeferredRenderCommandEncoders which record into their own CommandStream and
+ * can be used on any thread, since recording makes no GL calls. endEncoding() passes the streams to
+ * the command buffer, which replays them in creation order into a single RenderCommandEncoder on
+ * the context thread, at the latest in CommandQueue::submit().
+ *
+ * The child encoders of a pass are replayed back to back, so the GL state set by one of them is
+ * still bound when the next one starts.
+ */
+class ParallelRenderCommandEncoder final : public IParallelRenderCommandEncoder {
+ public:
+  ParallelRenderCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer,
+                               const RenderPassDesc& renderPass,
+                               std::shared_ptr<IFramebuffer> framebuffer);
+
+  ~ParallelRenderCommandEncoder() override;
+
+  std::unique_ptr<IRenderCommandEncoder> createRenderCommandEncoder(Result* outResult) override;
+
+  void endEncoding() override;
+
+  // Recorded in order with the child encoders, between the commands of the ones created before
+  // and after
+  void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
+  void insertDebugEventLabel(const std::string& label, const igl::Color& color) const override;
+  void popDebugGroupLabel() const override;
+
+ private:
+  // returns an encoder recording into a stream after the last child encoder
+  DeferredRenderCommandEncoder& getLabelEncoder() const;
+
+ private:
+  std::shared_ptr<CommandBuffer> commandBuffer_;
+  RenderPassDesc renderPass_;
+  std::shared_ptr<IFramebuffer> framebuffer_;
+  bool isEncoding_ = true;
+
+  mutable std::mutex mutex_;
+  mutable std::vector<std::unique_ptr<CommandStream>> streams_;
+  mutable std::unique_ptr<DeferredRenderCommandEncoder> labelEncoder_;
+};
+
+} // namespace opengl
+} // namespace igl
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/PixelUnpackBufferRing.h>
+
+#include <cstring>
+#include <igl/opengl/IContext.h>
+
+namespace igl {
+namespace opengl {
+
+PixelUnpackBufferRing::PixelUnpackBufferRing(IContext& context,
+                                             size_t numBuffers,
+                                             size_t maxUploadSize) :
+  context_(context), maxUploadSize_(maxUploadSize), slots_(numBuffers) {
+  IGL_ASSERT(numBuffers > 0);
+}
+
+bool PixelUnpackBufferRing::isSupported(const IContext& context) {
+  const auto& features = context.deviceFeatures();
+  return features.hasInternalFeature(InternalFeatures::PixelBufferObject) &&
+         features.hasInternalFeature(InternalFeatures::Sync) &&
+         features.hasInternalFeature(InternalFeatures::UnmapBuffer) &&
+         features.hasFeature(DeviceFeatures::MapBufferRange);
+}
+
+bool PixelUnpackBufferRing::isSlotFree(Slot& slot) {
+  if (!slot.fence) {
+    return true;
+  }
+  GLint status = 0;
+  context_.getSynciv(slot.fence, GL_SYNC_STATUS, sizeof(GLint), nullptr, &status);
+  if (status != GL_SIGNALED) {
+    return false;
+  }
+  context_.deleteSync(slot.fence);
+  slot.fence = nullptr;
+  return true;
+}
+
+bool PixelUnpackBufferRing::beginUpload(const void* data, size_t size) {
+  if (!data) {
+    return false;
+  }
+  return beginUpload(size, [data, size](uint8_t* dst) { memcpy(dst, data, size); });
+}
+
+bool PixelUnpackBufferRing::beginUpload(size_t size,
+                                        const std::function<void(uint8_t* dst)>& fill) {
+  IGL_ASSERT(!activeSlot_);
+
+  if (size == 0 || size > maxUploadSize_) {
+    return false;
+  }
+
+  Slot* slot = nullptr;
+
+  // buffers are fenced in ring order, so the oldest upload is the most likely to be finished
+  for (size_t i = 0; i != slots_.size() && !slot; i++) {
+    Slot& candidate = slots_[(nextSlot_ + i) % slots_.size()];
+    if (isSlotFree(candidate)) {
+      slot = &candidate;
+      nextSlot_ = (nextSlot_ + i + 1) % slots_.size();
+    }
+  }
+
+  if (!slot) {
+    return false;
+  }
+
+  if (!slot->buffer) {
+    context_.genBuffers(1, &slot->buffer);
+  }
+
+  context_.bindBuffer(GL_PIXEL_UNPACK_BUFFER, slot->buffer);
+
+  if (slot->size < size) {
+    context_.bufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)size, nullptr, GL_STREAM_DRAW);
+    slot->size = size;
+  }
+
+  // the fence of this buffer has signaled, so the GPU is done with its previous contents
+  void* dst =
+      context_.mapBufferRange(GL_PIXEL_UNPACK_BUFFER,
+                              0,
+                              (GLsizeiptr)size,
+                              GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT |
+                                  GL_MAP_UNSYNCHRONIZED_BIT);
+  if (!dst) {
+    context_.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return false;
+  }
+
+  fill(static_cast<uint8_t*>(dst));
+  context_.unmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+  activeSlot_ = slot;
+
+  return true;
+}
+
+void PixelUnpackBufferRing::endUpload() {
+  IGL_ASSERT(activeSlot_);
+
+  activeSlot_->fence = context_.fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  activeSlot_ = nullptr;
+
+  context_.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void PixelUnpackBufferRing::destroy() {
+  for (Slot& slot : slots_) {
+    if (slot.fence) {
+      context_.deleteSync(slot.fence);
+    }
+    if (slot.buffer) {
+      context_.deleteBuffers(1, &slot.buffer);
+    }
+    slot = {};
+  }
+  activeSlot_ = nullptr;
+}
+
+} // namespace opengl
+} // namespace igl
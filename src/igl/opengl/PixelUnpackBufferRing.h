@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <igl/opengl/GLIncludes.h>
+#include <vector>
+
+namespace igl {
+namespace opengl {
+
+class IContext;
+
+/**
+ * @brief Stages texture uploads through a small ring of GL_PIXEL_UNPACK_BUFFER objects. The data
+ * is copied into a buffer mapped with GL_MAP_UNSYNCHRONIZED_BIT and glTexSubImage*() reads it from
+ * the buffer, so the driver can return without copying the data or stalling on the texture. Every
+ * buffer is guarded by a fence and only reused after the GPU has consumed its previous upload.
+ *
+ * The destructor makes no GL calls, call destroy() while the context is still alive.
+ */
+class PixelUnpackBufferRing final {
+ public:
+  /// Uploads larger than `maxUploadSize` bytes are not staged
+  PixelUnpackBufferRing(IContext& context, size_t numBuffers, size_t maxUploadSize);
+
+  /// Returns true if the context supports mapping and fencing pixel unpack buffers
+  static bool isSupported(const IContext& context);
+
+  /// Copies `size` bytes of `data` into a free buffer and binds it to GL_PIXEL_UNPACK_BUFFER. The
+  /// upload then has to be issued with a null data pointer, followed by endUpload(). Returns false
+  /// and binds nothing if all buffers are still in use or the upload is too large
+  bool beginUpload(const void* data, size_t size);
+  /// Same as above, but `fill` writes the `size` bytes of the upload into the mapped buffer. Used
+  /// to stage several uploads in one buffer, which are then issued with their offsets as pointers
+  bool beginUpload(size_t size, const std::function<void(uint8_t* dst)>& fill);
+  /// Fences the buffer bound by beginUpload() and unbinds it
+  void endUpload();
+
+  /// Deletes all buffers and fences
+  void destroy();
+
+ private:
+  struct Slot {
+    GLuint buffer = 0;
+    size_t size = 0;
+    GLsync fence = nullptr;
+  };
+
+  // Returns true if the GPU has consumed the previous upload of `slot`
+  bool isSlotFree(Slot& slot);
+
+ private:
+  IContext& context_;
+  size_t maxUploadSize_ = 0;
+  std::vector<Slot> slots_;
+  size_t nextSlot_ = 0;
+  Slot* activeSlot_ = nullptr;
+};
+
+} // namespace opengl
+} // namespace igl
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/ProgramBinaryCache.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <igl/CacheFile.h>
+#include <igl/opengl/IContext.h>
+
+namespace {
+
+/*
+ On-disk layout: ProgramBinaryFileHeader followed by `numEntries` entries. Every entry is a
+ ProgramBinaryEntryHeader followed by the program binary.
+ */
+const uint32_t kProgramBinaryFileMagic = 0x42504749; // "IGPB"
+const uint32_t kProgramBinaryFileVersion = 1;
+
+struct ProgramBinaryFileHeader {
+  uint32_t magic = kProgramBinaryFileMagic;
+  uint32_t version = kProgramBinaryFileVersion;
+  uint64_t driverHash = 0;
+  uint64_t numEntries = 0;
+  uint64_t dataSize = 0;
+  uint64_t dataHash = 0;
+};
+
+struct ProgramBinaryEntryHeader {
+  uint64_t key = 0;
+  uint32_t binaryFormat = 0;
+  uint32_t size = 0;
+};
+
+} // namespace
+
+namespace igl {
+namespace opengl {
+
+std::unique_ptr<ProgramBinaryCache> ProgramBinaryCache::create(IContext& context,
+                                                               std::string filePath,
+                                                               size_t maxFileSize) {
+  if (!context.deviceFeatures().hasInternalFeature(InternalFeatures::ProgramBinary)) {
+    return nullptr;
+  }
+
+  // some drivers expose the API without supporting any binary format
+  GLint numFormats = 0;
+  context.getIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+  if (numFormats <= 0) {
+    return nullptr;
+  }
+
+  return std::make_unique<ProgramBinaryCache>(context, std::move(filePath), maxFileSize);
+}
+
+ProgramBinaryCache::ProgramBinaryCache(IContext& context,
+                                       std::string filePath,
+                                       size_t maxFileSize) :
+  context_(context), filePath_(std::move(filePath)), maxFileSize_(maxFileSize) {
+  GLint numFormats = 0;
+  context_.getIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+  if (numFormats > 0) {
+    std::vector<GLint> formats(numFormats);
+    context_.getIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+    supportedFormats_.assign(formats.begin(), formats.end());
+  }
+
+  std::string driver;
+  for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+    const auto* str = reinterpret_cast<const char*>(context_.getString(name));
+    driver += str ? str : "";
+    driver += '\n';
+  }
+  driverHash_ = hashCacheData(driver.data(), driver.size());
+
+  loadFile();
+}
+
+void ProgramBinaryCache::prepareProgram(GLuint program) const {
+  context_.programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+bool ProgramBinaryCache::loadProgram(uint64_t key, GLuint program) {
+  const auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return false;
+  }
+
+  const Entry& entry = it->second;
+
+  context_.programBinary(
+      program, entry.binaryFormat, entry.binary.data(), static_cast<GLsizei>(entry.binary.size()));
+
+  GLint status = GL_FALSE;
+  context_.getProgramiv(program, GL_LINK_STATUS, &status);
+
+  if (status == GL_FALSE) {
+    // the driver was updated without changing its version string, or the binary is corrupted
+    IGL_LOG_INFO("Program binary %llx was rejected by the driver\n", (unsigned long long)key);
+    entries_.erase(it);
+    isDirty_ = true;
+    return false;
+  }
+
+  return true;
+}
+
+void ProgramBinaryCache::storeProgram(uint64_t key, GLuint program) {
+  GLint length = 0;
+  context_.getProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    return;
+  }
+
+  Entry entry;
+  entry.binary.resize(length);
+
+  GLsizei size = 0;
+  context_.getProgramBinary(program, length, &size, &entry.binaryFormat, entry.binary.data());
+  if (size <= 0) {
+    return;
+  }
+  entry.binary.resize(size);
+
+  entries_[key] = std::move(entry);
+  isDirty_ = true;
+}
+
+void ProgramBinaryCache::loadFile() {
+  FILE* file = fopen(filePath_.c_str(), "rb");
+
+  if (!file) {
+    IGL_LOG_INFO("Program binary cache file %s not found\n", filePath_.c_str());
+    return;
+  }
+
+  ProgramBinaryFileHeader header;
+  std::vector<uint8_t> data;
+
+  const bool isHeaderValid = fread(&header, sizeof(header), 1, file) == 1 &&
+                             header.magic == kProgramBinaryFileMagic &&
+                             header.version == kProgramBinaryFileVersion &&
+                             header.driverHash == driverHash_ && header.dataSize <= maxFileSize_;
+
+  if (isHeaderValid) {
+    data.resize(header.dataSize);
+    if (fread(data.data(), 1, data.size(), file) != data.size() ||
+        hashCacheData(data.data(), data.size()) != header.dataHash) {
+      data.clear();
+    }
+  }
+
+  fclose(file);
+
+  if (data.empty()) {
+    IGL_LOG_INFO("Program binary cache file %s is stale or corrupted. Ignoring it\n",
+                 filePath_.c_str());
+    return;
+  }
+
+  size_t offset = 0;
+
+  for (uint64_t i = 0; i != header.numEntries; i++) {
+    ProgramBinaryEntryHeader entryHeader;
+    if (data.size() - offset < sizeof(entryHeader)) {
+      break;
+    }
+    memcpy(&entryHeader, data.data() + offset, sizeof(entryHeader));
+    offset += sizeof(entryHeader);
+    if (data.size() - offset < entryHeader.size) {
+      break;
+    }
+    const bool isFormatSupported = std::find(supportedFormats_.begin(),
+                                             supportedFormats_.end(),
+                                             entryHeader.binaryFormat) != supportedFormats_.end();
+    if (isFormatSupported) {
+      Entry& entry = entries_[entryHeader.key];
+      entry.binaryFormat = entryHeader.binaryFormat;
+      entry.binary.assign(data.begin() + offset, data.begin() + offset + entryHeader.size);
+    }
+    offset += entryHeader.size;
+  }
+}
+
+bool ProgramBinaryCache::save() {
+  if (!isDirty_ || filePath_.empty()) {
+    return true;
+  }
+
+  std::vector<uint8_t> data;
+  uint64_t numEntries = 0;
+
+  for (const auto& it : entries_) {
+    ProgramBinaryEntryHeader entryHeader;
+    entryHeader.key = it.first;
+    entryHeader.binaryFormat = it.second.binaryFormat;
+    entryHeader.size = static_cast<uint32_t>(it.second.binary.size());
+    if (data.size() + sizeof(entryHeader) + entryHeader.size > maxFileSize_) {
+      IGL_LOG_INFO("Program binary cache exceeds the limit of %u bytes. Not saving all programs\n",
+                   (uint32_t)maxFileSize_);
+      break;
+    }
+    const auto* headerBytes = reinterpret_cast<const uint8_t*>(&entryHeader);
+    data.insert(data.end(), headerBytes, headerBytes + sizeof(entryHeader));
+    data.insert(data.end(), it.second.binary.begin(), it.second.binary.end());
+    numEntries++;
+  }
+
+  ProgramBinaryFileHeader header;
+  header.driverHash = driverHash_;
+  header.numEntries = numEntries;
+  header.dataSize = data.size();
+  header.dataHash = hashCacheData(data.data(), data.size());
+
+  if (!writeCacheFile(filePath_, &header, sizeof(header), data.data(), data.size())) {
+    return false;
+  }
+
+  isDirty_ = false;
+
+  return true;
+}
+
+} // namespace opengl
+} // namespace igl
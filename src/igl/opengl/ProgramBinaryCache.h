@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/opengl/GLIncludes.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace igl {
+namespace opengl {
+
+class IContext;
+
+/**
+ * @brief Keeps binaries of linked GL programs and persists them in a file, so that programs can be
+ * loaded with glProgramBinary() instead of being linked from source on the next launch.
+ *
+ * Programs are identified by a key computed from the hashes of their shader sources. The file is
+ * bound to the driver: it is ignored when the GL vendor, renderer or version string has changed.
+ * A binary which the driver rejects is dropped, and the program has to be linked from source.
+ */
+class ProgramBinaryCache final {
+ public:
+  /// Returns nullptr if the context cannot retrieve program binaries. Loads `filePath` if exists.
+  static std::unique_ptr<ProgramBinaryCache> create(IContext& context,
+                                                    std::string filePath,
+                                                    size_t maxFileSize);
+
+  ProgramBinaryCache(IContext& context, std::string filePath, size_t maxFileSize);
+
+  /// Sets GL_PROGRAM_BINARY_RETRIEVABLE_HINT, must be called before linking `program`
+  void prepareProgram(GLuint program) const;
+  /// Loads the cached binary into `program`. Returns false if there is no binary for `key` or the
+  /// driver has rejected it
+  bool loadProgram(uint64_t key, GLuint program);
+  /// Retrieves the binary of the linked `program`
+  void storeProgram(uint64_t key, GLuint program);
+
+  /// Writes the cache into its file if new binaries have been added since the last save
+  bool save();
+
+  size_t getNumPrograms() const {
+    return entries_.size();
+  }
+
+ private:
+  void loadFile();
+
+ private:
+  struct Entry {
+    GLenum binaryFormat = 0;
+    std::vector<uint8_t> binary;
+  };
+
+  IContext& context_;
+  std::string filePath_;
+  size_t maxFileSize_ = 0;
+  // hash of the vendor, renderer and version strings of the driver
+  uint64_t driverHash_ = 0;
+  std::vector<GLenum> supportedFormats_;
+  std::unordered_map<uint64_t, Entry> entries_;
+  bool isDirty_ = false;
+};
+
+} // namespace opengl
+} // namespace igl
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/PushConstantBlock.h>
+
+#include <cstring>
+#include <igl/opengl/IContext.h>
+
+namespace igl {
+namespace opengl {
+
+bool PushConstantBlock::assignBinding(IContext& context, GLuint program) {
+  const GLuint blockIndex = context.getUniformBlockIndex(program, kBlockName);
+  if (blockIndex == GL_INVALID_INDEX) {
+    return false;
+  }
+  context.uniformBlockBinding(program, blockIndex, kBindingIndex);
+  return true;
+}
+
+void PushConstantBlock::set(size_t offset, const void* data, size_t length) {
+  if (!IGL_VERIFY(data && offset + length <= kMaxSize)) {
+    IGL_LOG_ERROR("Push constants size exceeded %u (max %u bytes)\n",
+                  static_cast<uint32_t>(offset + length),
+                  static_cast<uint32_t>(kMaxSize));
+    return;
+  }
+  hasData_ = true;
+  if (memcmp(bytes_.data() + offset, data, length) != 0) {
+    memcpy(bytes_.data() + offset, data, length);
+    isDirty_ = true;
+  }
+}
+
+void PushConstantBlock::clear() {
+  bytes_.fill(0);
+  hasData_ = false;
+  isDirty_ = true;
+}
+
+void PushConstantBlock::bind(PackedUniformRing& ring) {
+  if (!hasData_) {
+    return;
+  }
+  if (isDirty_ || rangeGeneration_ != ring.getGeneration()) {
+    rangeOffset_ = ring.upload(bytes_.data(), bytes_.size());
+    rangeGeneration_ = ring.getGeneration();
+    isDirty_ = false;
+  }
+  ring.bindRange(rangeOffset_, bytes_.size());
+}
+
+} // namespace opengl
+} // namespace igl
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <igl/Common.h>
+#include <igl/opengl/GLIncludes.h>
+#include <igl/opengl/PackedUniformRing.h>
+
+namespace igl {
+namespace opengl {
+
+class IContext;
+
+/**
+ * @brief Emulates the push constants of the Vulkan backend with a std140 uniform block named
+ * kBlockName, which shaders declare instead of a `layout(push_constant)` block:
+ *
+ *   layout(std140) uniform IGLPushConstants { mat4 mvp; vec4 color; } pc;
+ *
+ * bindPushConstants() writes into a CPU copy of the block. Before a draw or a dispatch, the block
+ * is streamed through a PackedUniformRing only if its contents have changed, and its range is
+ * bound. The whole block is bound, since GL requires the range to cover the block declared by the
+ * shader, which may be larger than the bytes written so far.
+ */
+class PushConstantBlock final {
+ public:
+  static constexpr const char* kBlockName = "IGLPushConstants";
+  /// The uniform buffer binding of the block, next to the one of BindlessTextureBlock
+  static constexpr GLuint kBindingIndex = PackedUniformRing::kBindingIndex + 2;
+  /// The size guaranteed by Vulkan, reported as DeviceFeatureLimits::MaxPushConstantBytes
+  static constexpr size_t kMaxSize = 128;
+
+  /// Assigns the block of `program` to kBindingIndex. Returns false if the program has no active
+  /// push constant block
+  static bool assignBinding(IContext& context, GLuint program);
+
+  /// Copies `length` bytes of `data` at `offset` of the block
+  void set(size_t offset, const void* data, size_t length);
+
+  /// True once set() has been called since the last clear()
+  bool hasData() const {
+    return hasData_;
+  }
+
+  /// Forgets the contents of the block
+  void clear();
+
+  /// Uploads the block if it has changed and binds it
+  void bind(PackedUniformRing& ring);
+
+ private:
+  std::array<uint8_t, kMaxSize> bytes_ = {};
+  bool hasData_ = false;
+  bool isDirty_ = true;
+  size_t rangeOffset_ = 0;
+  uint64_t rangeGeneration_ = 0;
+};
+
+} // namespace opengl
+} // namespace igl
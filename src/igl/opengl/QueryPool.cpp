@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/QueryPool.h>
+
+#include <algorithm>
+#include <igl/opengl/DeviceFeatureSet.h>
+#include <igl/opengl/IContext.h>
+
+namespace igl {
+namespace opengl {
+
+QueryPool::QueryPool(IContext& context, const QueryPoolDesc& desc) :
+  WithContext(context),
+  desc_(desc),
+  target_(DeviceFeatureSet::usesOpenGLES() ? GL_ANY_SAMPLES_PASSED : GL_SAMPLES_PASSED),
+  queries_(desc.queryCount, 0),
+  isIssued_(desc.queryCount, false) {
+  IGL_ASSERT(desc_.type == QueryType::Occlusion);
+  getContext().genQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+}
+
+QueryPool::~QueryPool() {
+  getContext().deleteQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+}
+
+void QueryPool::reset() {
+  std::fill(isIssued_.begin(), isIssued_.end(), false);
+}
+
+void QueryPool::begin(uint32_t query) {
+  IGL_ASSERT(query < queries_.size());
+  getContext().beginQuery(target_, queries_[query]);
+  isIssued_[query] = true;
+}
+
+void QueryPool::end() {
+  getContext().endQuery(target_);
+}
+
+bool QueryPool::getOcclusionResults(uint32_t firstQuery,
+                                    uint32_t numQueries,
+                                    uint64_t* outSamplesPassed) const {
+  if (!IGL_VERIFY(outSamplesPassed) ||
+      !IGL_VERIFY(numQueries > 0 && firstQuery + numQueries <= queries_.size())) {
+    return false;
+  }
+
+  for (uint32_t i = firstQuery; i != firstQuery + numQueries; i++) {
+    GLuint available = 0;
+    if (isIssued_[i]) {
+      getContext().getQueryObjectuiv(queries_[i], GL_QUERY_RESULT_AVAILABLE, &available);
+    }
+    if (!available) {
+      return false;
+    }
+  }
+
+  for (uint32_t i = 0; i != numQueries; i++) {
+    GLuint result = 0;
+    getContext().getQueryObjectuiv(queries_[firstQuery + i], GL_QUERY_RESULT, &result);
+    outSamplesPassed[i] = result;
+  }
+
+  return true;
+}
+
+} // namespace opengl
+} // namespace igl
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/QueryPool.h>
+#include <igl/opengl/GLIncludes.h>
+#include <igl/opengl/WithContext.h>
+#include <vector>
+
+namespace igl {
+namespace opengl {
+
+/**
+ * @brief One GL query object per occlusion query. OpenGL ES only supports GL_ANY_SAMPLES_PASSED,
+ * while desktop OpenGL counts the samples with GL_SAMPLES_PASSED.
+ */
+class QueryPool final : public WithContext, public IQueryPool {
+ public:
+  QueryPool(IContext& context, const QueryPoolDesc& desc);
+  ~QueryPool() override;
+
+  [[nodiscard]] QueryType getType() const override {
+    return desc_.type;
+  }
+  [[nodiscard]] uint32_t getQueryCount() const override {
+    return desc_.queryCount;
+  }
+
+  [[nodiscard]] bool getOcclusionResults(uint32_t firstQuery,
+                                         uint32_t numQueries,
+                                         uint64_t* outSamplesPassed) const override;
+
+  // forgets the results of all queries; called when a render pass using this pool begins
+  void reset();
+  void begin(uint32_t query);
+  void end();
+
+ private:
+  QueryPoolDesc desc_;
+  GLenum target_ = GL_SAMPLES_PASSED;
+  std::vector<GLuint> queries_;
+  // queries which have been ended since the last reset()
+  std::vector<bool> isIssued_;
+};
+
+} // namespace opengl
+} // namespace igl
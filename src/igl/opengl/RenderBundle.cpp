@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/RenderBundle.h>
+
+#include <igl/opengl/DeferredRenderCommandEncoder.h>
+
+namespace igl {
+namespace opengl {
+
+std::unique_ptr<IRenderCommandEncoder> RenderBundle::record(Result* outResult) {
+  // keeps the chunks of the previous recording
+  stream_.reset();
+  Result::setOk(outResult);
+  return std::make_unique<DeferredRenderCommandEncoder>(nullptr, stream_);
+}
+
+void RenderBundle::replay(IRenderCommandEncoder& encoder) const {
+  DeferredRenderCommandEncoder::replay(stream_, encoder);
+}
+
+} // namespace opengl
+} // namespace igl
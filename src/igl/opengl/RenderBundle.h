@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/RenderBundle.h>
+#include <igl/opengl/CommandStream.h>
+
+namespace igl {
+namespace opengl {
+
+/**
+ * @brief Render commands recorded into a CommandStream by a DeferredRenderCommandEncoder and
+ * replayed into every render pass which executes the bundle. Recording makes no GL calls.
+ */
+class RenderBundle final : public IRenderBundle {
+ public:
+  std::unique_ptr<IRenderCommandEncoder> record(Result* outResult) override;
+
+  [[nodiscard]] bool empty() const override {
+    return stream_.empty();
+  }
+
+  /// Issues the recorded commands into `encoder`
+  void replay(IRenderCommandEncoder& encoder) const;
+
+ private:
+  CommandStream stream_;
+};
+
+} // namespace opengl
+} // namespace igl
@@ -63,6 +63,7 @@ void RenderCommandAdapter::initialize(const RenderPassDesc& renderPass,
   if (activeVAO_) {
     activeVAO_->bind();
   }
+  cachedVAO_ = 0;
   const auto& openglFramebuffer = static_cast<const Framebuffer&>(*framebuffer);
   openglFramebuffer.bind(renderPass);
 
@@ -87,6 +88,10 @@ void RenderCommandAdapter::setScissorRect(const ScissorRect& rect) {
 
 void RenderCommandAdapter::setDepthStencilState(
     const std::shared_ptr<IDepthStencilState>& newValue) {
+  // the device returns the same object for equal descriptors
+  if (depthStencilState_ == newValue) {
+    return;
+  }
   depthStencilState_ = newValue;
   setDirty(StateMask::DEPTH_STENCIL);
 }
@@ -96,8 +101,8 @@ void RenderCommandAdapter::setStencilReferenceValue(uint32_t value, Result* outR
     Result::setResult(outResult, Result::Code::InvalidOperation, "depth stencil state is null");
     return;
   }
-  auto& depthStencilState = static_cast<DepthStencilState&>(*depthStencilState_);
-  depthStencilState.setStencilReferenceValue(value);
+  hasStencilReferenceValues_ = true;
+  frontStencilReferenceValue_ = backStencilReferenceValue_ = value;
   setDirty(StateMask::DEPTH_STENCIL);
   Result::setOk(outResult);
 }
@@ -109,8 +114,9 @@ void RenderCommandAdapter::setStencilReferenceValues(uint32_t frontValue,
     Result::setResult(outResult, Result::Code::InvalidOperation, "depth stencil state is null");
     return;
   }
-  auto& depthStencilState = static_cast<DepthStencilState&>(*depthStencilState_);
-  depthStencilState.setStencilReferenceValues(frontValue, backValue);
+  hasStencilReferenceValues_ = true;
+  frontStencilReferenceValue_ = frontValue;
+  backStencilReferenceValue_ = backValue;
   setDirty(StateMask::DEPTH_STENCIL);
   Result::setOk(outResult);
 }
@@ -128,7 +134,7 @@ void RenderCommandAdapter::clearVertexBuffers() {
   vertexBuffersDirty_.reset();
 }
 
-void RenderCommandAdapter::setVertexBuffer(std::shared_ptr<Buffer> buffer,
+void RenderCommandAdapter::setVertexBuffer(const std::shared_ptr<IBuffer>& buffer,
                                            size_t offset,
                                            int index,
                                            Result* outResult) {
@@ -136,7 +142,11 @@ void RenderCommandAdapter::setVertexBuffer(std::shared_ptr<Buffer> buffer,
   IGL_ASSERT_MSG(index < IGL_VERTEX_BUFFER_MAX,
                  "Buffer index is beyond max, may want to increase limit");
   if (index >= 0 && index < IGL_VERTEX_BUFFER_MAX && buffer) {
-    vertexBuffers_[index] = {std::move(buffer), offset};
+    BufferState& bufferState = vertexBuffers_[index];
+    if (bufferState.resource != buffer) {
+      bufferState.resource = std::static_pointer_cast<Buffer>(buffer);
+    }
+    bufferState.offset = offset;
     SET_DIRTY(vertexBuffersDirty_, index);
     Result::setOk(outResult);
   } else {
@@ -154,7 +164,11 @@ void RenderCommandAdapter::setUniform(const UniformDesc& uniformDesc,
   uniformAdapter_.setUniform(uniformDesc, data, outResult);
 }
 
-void RenderCommandAdapter::setUniformBuffer(const std::shared_ptr<Buffer>& buffer,
+void RenderCommandAdapter::setPushConstants(size_t offset, const void* data, size_t length) {
+  pushConstants_.set(offset, data, length);
+}
+
+void RenderCommandAdapter::setUniformBuffer(const std::shared_ptr<IBuffer>& buffer,
                                             size_t offset,
                                             int index,
                                             Result* outResult) {
@@ -183,7 +197,9 @@ void RenderCommandAdapter::setVertexSamplerState(const std::shared_ptr<ISamplerS
     Result::setResult(outResult, Result::Code::ArgumentInvalid);
     return;
   }
-  vertexTextureStates_[index].second = samplerState;
+  if (vertexTextureStates_[index].second != samplerState) {
+    vertexTextureStates_[index].second = samplerState;
+  }
   SET_DIRTY(vertexTextureStatesDirty_, index);
   Result::setOk(outResult);
 }
@@ -211,28 +227,30 @@ void RenderCommandAdapter::setFragmentSamplerState(
     Result::setResult(outResult, Result::Code::ArgumentInvalid);
     return;
   }
-  fragmentTextureStates_[index].second = samplerState;
+  if (fragmentTextureStates_[index].second != samplerState) {
+    fragmentTextureStates_[index].second = samplerState;
+  }
   SET_DIRTY(fragmentTextureStatesDirty_, index);
   Result::setOk(outResult);
 }
 
 // When pipelineState is modified, all dependent resources are cleared
-void RenderCommandAdapter::clearDependentResources(
-    const std::shared_ptr<IRenderPipelineState>& newValue,
-    Result* outResult) {
+void RenderCommandAdapter::clearDependentResources(IRenderPipelineState* newValue,
+                                                   Result* outResult) {
   auto curStateOpenGL = static_cast<opengl::RenderPipelineState*>(pipelineState_.get());
   if (!IGL_VERIFY(curStateOpenGL)) {
     Result::setResult(outResult, Result::Code::RuntimeError, "pipeline state is null");
     return;
   }
 
-  auto newStateOpenGL = static_cast<opengl::RenderPipelineState*>(newValue.get());
+  auto newStateOpenGL = static_cast<opengl::RenderPipelineState*>(newValue);
 
   if (!newStateOpenGL || !curStateOpenGL->matchesShaderProgram(*newStateOpenGL)) {
     // Don't use previously set resources. Uniforms/texture locations not same between programs
     uniformAdapter_.clearUniformBuffers();
     clearVertexTexture();
     clearFragmentTexture();
+    bindlessTextures_.clear();
   }
 
   if (!newStateOpenGL || !curStateOpenGL->matchesVertexInputState(*newStateOpenGL)) {
@@ -251,15 +269,25 @@ void RenderCommandAdapter::setPipelineState(const std::shared_ptr<IRenderPipelin
                                             Result* outResult) {
   Result::setOk(outResult);
   if (pipelineState_) {
-    clearDependentResources(newValue, outResult); // Only clear if pipeline state was previously set
+    // Only clear if pipeline state was previously set
+    clearDependentResources(newValue.get(), outResult);
+  }
+  if (pipelineState_ != newValue) {
+    pipelineState_ = newValue;
   }
-  pipelineState_ = newValue;
   setDirty(StateMask::PIPELINE);
 }
 
-void RenderCommandAdapter::drawArrays(GLenum mode, GLint first, GLsizei count) {
+void RenderCommandAdapter::drawArrays(GLenum mode,
+                                      GLint first,
+                                      GLsizei count,
+                                      GLsizei instanceCount) {
   willDraw();
-  getContext().drawArrays(toMockWireframeMode(mode), first, count);
+  if (instanceCount == 1) {
+    getContext().drawArrays(toMockWireframeMode(mode), first, count);
+  } else {
+    getContext().drawArraysInstanced(toMockWireframeMode(mode), first, count, instanceCount);
+  }
   didDraw();
 }
 
@@ -267,10 +295,18 @@ void RenderCommandAdapter::drawElements(GLenum mode,
                                         GLsizei indexCount,
                                         GLenum indexType,
                                         Buffer& indexBuffer,
-                                        const GLvoid* indexOffset) {
-  willDraw();
-  bindBufferWithShaderStorageBufferOverride(indexBuffer, GL_ELEMENT_ARRAY_BUFFER);
-  getContext().drawElements(toMockWireframeMode(mode), indexCount, indexType, indexOffset);
+                                        const GLvoid* indexOffset,
+                                        GLsizei instanceCount) {
+  willDraw(&indexBuffer);
+  if (!cachedVAO_) {
+    bindBufferWithShaderStorageBufferOverride(indexBuffer, GL_ELEMENT_ARRAY_BUFFER);
+  }
+  if (instanceCount == 1) {
+    getContext().drawElements(toMockWireframeMode(mode), indexCount, indexType, indexOffset);
+  } else {
+    getContext().drawElementsInstanced(
+        toMockWireframeMode(mode), indexCount, indexType, indexOffset, instanceCount);
+  }
   didDraw();
 }
 
@@ -279,8 +315,10 @@ void RenderCommandAdapter::drawElementsIndirect(GLenum mode,
                                                 Buffer& indexBuffer,
                                                 Buffer& indirectBuffer,
                                                 const GLvoid* indirectBufferOffset) {
-  willDraw();
-  bindBufferWithShaderStorageBufferOverride(indexBuffer, GL_ELEMENT_ARRAY_BUFFER);
+  willDraw(&indexBuffer);
+  if (!cachedVAO_) {
+    bindBufferWithShaderStorageBufferOverride(indexBuffer, GL_ELEMENT_ARRAY_BUFFER);
+  }
   if (getContext().deviceFeatures().hasFeature(DeviceFeatures::DrawIndexedIndirect)) {
     bindBufferWithShaderStorageBufferOverride(indirectBuffer, GL_DRAW_INDIRECT_BUFFER);
     getContext().drawElementsIndirect(toMockWireframeMode(mode), indexType, indirectBufferOffset);
@@ -299,11 +337,16 @@ void RenderCommandAdapter::endEncoding() {
 
   pipelineState_ = nullptr;
   depthStencilState_ = nullptr;
+  hasStencilReferenceValues_ = false;
 
+  // the adapter is reused by later encoders, which must not see the buffers of this one
+  vertexBuffers_.fill({});
   uniformAdapter_.shrinkUniformUsage();
   uniformAdapter_.clearUniformBuffers();
   vertexTextureStates_ = TextureStates();
   fragmentTextureStates_ = TextureStates();
+  bindlessTextures_.clear();
+  pushConstants_.clear();
 
   vertexBuffersDirty_.reset();
   vertexTextureStatesDirty_.reset();
@@ -311,12 +354,14 @@ void RenderCommandAdapter::endEncoding() {
   dirtyStateBits_ = EnumToValue(StateMask::NONE);
 }
 
-void RenderCommandAdapter::willDraw() {
+void RenderCommandAdapter::willDraw(Buffer* indexBuffer) {
+  IGL_PROFILER_FUNCTION();
+
   Result ret;
   auto pipelineState = static_cast<RenderPipelineState*>(pipelineState_.get());
 
   // Vertex Buffers must be bound before pipelineState->bind()
-  if (pipelineState) {
+  if (pipelineState && !bindCachedVertexArray(*pipelineState, indexBuffer)) {
     for (size_t bufferIndex = 0; bufferIndex < IGL_VERTEX_BUFFER_MAX; ++bufferIndex) {
       if (IS_DIRTY(vertexBuffersDirty_, bufferIndex)) {
         auto& bufferState = vertexBuffers_[bufferIndex];
@@ -326,15 +371,19 @@ void RenderCommandAdapter::willDraw() {
         CLEAR_DIRTY(vertexBuffersDirty_, bufferIndex);
       }
     }
-    if (isDirty(StateMask::PIPELINE)) {
-      pipelineState->bind();
-      clearDirty(StateMask::PIPELINE);
-    }
+  }
+  if (pipelineState && isDirty(StateMask::PIPELINE)) {
+    pipelineState->bind();
+    clearDirty(StateMask::PIPELINE);
   }
 
   auto depthStencilState = static_cast<DepthStencilState*>(depthStencilState_.get());
   if (depthStencilState && isDirty(StateMask::DEPTH_STENCIL)) {
-    depthStencilState->bind();
+    if (hasStencilReferenceValues_) {
+      depthStencilState->bind(frontStencilReferenceValue_, backStencilReferenceValue_);
+    } else {
+      depthStencilState->bind();
+    }
     clearDirty(StateMask::DEPTH_STENCIL);
   }
 
@@ -357,7 +406,18 @@ void RenderCommandAdapter::willDraw() {
   static size_t kFragmentTextureStatesSize = fragmentTextureStates_.size();
   if (pipelineState) {
     // Bind uniforms to be used for render
-    uniformAdapter_.bindToPipeline(getContext());
+    uniformAdapter_.bindToPipeline(getContext(), pipelineState->getShaderStages());
+    if (pushConstants_.hasData() && pipelineState->getShaderStages()->usesPushConstants()) {
+      if (auto* pushConstantRing = getContext().getPushConstantRing()) {
+        pushConstants_.bind(*pushConstantRing);
+      }
+    }
+    if (auto* bindlessTextureRing = getContext().getBindlessTextureRing()) {
+      if (pipelineState->getShaderStages()->usesBindlessTextures()) {
+        bindBindlessTextures(*bindlessTextureRing);
+        return;
+      }
+    }
     for (size_t index = 0; index < kVertexTextureStatesSize; index++) {
       if (!IS_DIRTY(vertexTextureStatesDirty_, index)) {
         continue;
@@ -402,6 +462,25 @@ void RenderCommandAdapter::willDraw() {
   }
 }
 
+void RenderCommandAdapter::bindBindlessTextures(PackedUniformRing& ring) {
+  auto getHandle = [](const TextureState& textureState) -> uint64_t {
+    auto* texture = static_cast<Texture*>(textureState.first);
+    auto* samplerState = static_cast<SamplerState*>(textureState.second.get());
+    return texture ? texture->getBindlessHandle(samplerState) : 0;
+  };
+  for (size_t index = 0; index < IGL_TEXTURE_SAMPLERS_MAX; index++) {
+    if (IS_DIRTY(vertexTextureStatesDirty_, index)) {
+      bindlessTextures_.setVertexTexture(index, getHandle(vertexTextureStates_[index]));
+      CLEAR_DIRTY(vertexTextureStatesDirty_, index);
+    }
+    if (IS_DIRTY(fragmentTextureStatesDirty_, index)) {
+      bindlessTextures_.setFragmentTexture(index, getHandle(fragmentTextureStates_[index]));
+      CLEAR_DIRTY(fragmentTextureStatesDirty_, index);
+    }
+  }
+  bindlessTextures_.bind(ring);
+}
+
 void RenderCommandAdapter::unbindTexture(IContext& context,
                                          size_t textureUnit,
                                          TextureState& textureState) {
@@ -436,7 +515,84 @@ void RenderCommandAdapter::didDraw() {
   // Placeholder stub in case we want to add something later
 }
 
+bool RenderCommandAdapter::bindCachedVertexArray(RenderPipelineState& pipelineState,
+                                                 Buffer* indexBuffer) {
+  auto* cache = getContext().getVertexArrayCache();
+  if (!cache) {
+    return false;
+  }
+
+  const GLuint indexBufferId = indexBuffer ? static_cast<ArrayBuffer*>(indexBuffer)->getId() : 0;
+
+  // nothing has changed since the last draw, and the bound vertex array object is still alive.
+  // Non-indexed draws work with any index buffer
+  if (cachedVAO_ && cachedVAOGeneration_ == cache->getGeneration() && vertexBuffersDirty_.none() &&
+      !isDirty(StateMask::PIPELINE) && (!indexBuffer || indexBufferId == cachedVAOIndexBuffer_)) {
+    return true;
+  }
+
+  auto& key = cachedVAOKey_;
+  key.pipelineId = pipelineState.getVertexArrayCacheId();
+  key.indexBuffer = indexBufferId;
+  key.vertexBuffers.clear();
+  for (size_t bufferIndex = 0; bufferIndex < IGL_VERTEX_BUFFER_MAX; ++bufferIndex) {
+    const auto& bufferState = vertexBuffers_[bufferIndex];
+    if (bufferState.resource && pipelineState.usesVertexBuffer(bufferIndex)) {
+      key.vertexBuffers.push_back({static_cast<uint32_t>(bufferIndex),
+                                   static_cast<ArrayBuffer&>(*bufferState.resource).getId(),
+                                   bufferState.offset});
+    }
+  }
+
+  GLuint vertexArray = cache->find(key);
+
+  if (vertexArray) {
+    getContext().bindVertexArray(vertexArray);
+  } else {
+    vertexArray = cache->insert(key);
+    if (!vertexArray) {
+      restoreVertexArray();
+      return false;
+    }
+    getContext().bindVertexArray(vertexArray);
+    for (const auto& binding : key.vertexBuffers) {
+      const auto& bufferState = vertexBuffers_[binding.index];
+      bindBufferWithShaderStorageBufferOverride(*bufferState.resource, GL_ARRAY_BUFFER);
+      pipelineState.bindVertexAttributes(binding.index, bufferState.offset);
+    }
+    if (indexBuffer) {
+      bindBufferWithShaderStorageBufferOverride(*indexBuffer, GL_ELEMENT_ARRAY_BUFFER);
+    }
+    // the attributes stay enabled in the cached vertex array object
+    pipelineState.releaseVertexAttributes();
+  }
+
+  vertexBuffersDirty_.reset();
+  cachedVAO_ = vertexArray;
+  cachedVAOGeneration_ = cache->getGeneration();
+  cachedVAOIndexBuffer_ = key.indexBuffer;
+
+  return true;
+}
+
+void RenderCommandAdapter::restoreVertexArray() {
+  if (!cachedVAO_) {
+    return;
+  }
+  cachedVAO_ = 0;
+  if (activeVAO_) {
+    activeVAO_->bind();
+  }
+  // the attributes of the vertex buffers have only been set up in the cached vertex array object
+  for (size_t bufferIndex = 0; bufferIndex < IGL_VERTEX_BUFFER_MAX; ++bufferIndex) {
+    if (vertexBuffers_[bufferIndex].resource) {
+      SET_DIRTY(vertexBuffersDirty_, bufferIndex);
+    }
+  }
+}
+
 void RenderCommandAdapter::unbindVertexAttributes() {
+  restoreVertexArray();
   auto pipelineState = static_cast<RenderPipelineState*>(pipelineState_.get());
   if (pipelineState) {
     pipelineState->unbindVertexAttributes();
@@ -12,9 +12,12 @@
 #include <functional>
 #include <igl/Buffer.h>
 #include <igl/Common.h>
+#include <igl/opengl/BindlessTextureBlock.h>
+#include <igl/opengl/PushConstantBlock.h>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/UnbindPolicy.h>
 #include <igl/opengl/UniformAdapter.h>
+#include <igl/opengl/VertexArrayCache.h>
 #include <igl/opengl/WithContext.h>
 
 namespace igl {
@@ -27,6 +30,7 @@ class IRenderPipelineState;
 
 namespace opengl {
 class Buffer;
+class RenderPipelineState;
 class VertexArrayObject;
 
 class RenderCommandAdapter final : public WithContext {
@@ -35,9 +39,12 @@ class RenderCommandAdapter final : public WithContext {
   enum class StateMask : StateBits { NONE = 0, PIPELINE = 1 << 1, DEPTH_STENCIL = 1 << 2 };
 
  private:
+  // The bound buffers, samplers, pipeline and depth stencil state are owned by the adapter. They
+  // are only assigned when a different object is bound, so rebinding the same object does not
+  // touch reference counts.
   struct BufferState {
     std::shared_ptr<Buffer> resource;
-    size_t offset;
+    size_t offset = 0;
   };
 
   using TextureState = std::pair<ITexture*, std::shared_ptr<ISamplerState>>;
@@ -63,17 +70,18 @@ class RenderCommandAdapter final : public WithContext {
   void setDepthBias(float depthBias, float slopeScale);
 
   void clearVertexBuffers();
-  void setVertexBuffer(std::shared_ptr<Buffer> buffer,
+  void setVertexBuffer(const std::shared_ptr<IBuffer>& buffer,
                        size_t offset,
                        int index,
                        Result* outResult = nullptr);
 
   void clearUniformBuffers();
-  void setUniformBuffer(const std::shared_ptr<Buffer>& buffer,
+  void setUniformBuffer(const std::shared_ptr<IBuffer>& buffer,
                         size_t offset,
                         int index,
                         Result* outResult = nullptr);
   void setUniform(const UniformDesc& uniformDesc, const void* data, Result* outResult = nullptr);
+  void setPushConstants(size_t offset, const void* data, size_t length);
 
   void clearVertexTexture();
   void setVertexTexture(ITexture* texture, size_t index, Result* outResult = nullptr);
@@ -90,12 +98,13 @@ class RenderCommandAdapter final : public WithContext {
   void setPipelineState(const std::shared_ptr<IRenderPipelineState>& newValue,
                         Result* outResult = nullptr);
 
-  void drawArrays(GLenum mode, GLint first, GLsizei count);
+  void drawArrays(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount = 1);
   void drawElements(GLenum mode,
                     GLsizei indexCount,
                     GLenum indexType,
                     Buffer& indexBuffer,
-                    const GLvoid* indexOffset);
+                    const GLvoid* indexOffset,
+                    GLsizei instanceCount = 1);
   void drawElementsIndirect(GLenum mode,
                             GLenum indexType,
                             Buffer& indexBuffer,
@@ -111,12 +120,20 @@ class RenderCommandAdapter final : public WithContext {
  private:
   RenderCommandAdapter(IContext& context);
 
-  void clearDependentResources(const std::shared_ptr<IRenderPipelineState>& newValue,
-                               Result* outResult = nullptr);
-  void willDraw();
+  void clearDependentResources(IRenderPipelineState* newValue, Result* outResult = nullptr);
+  // `indexBuffer` is null for non-indexed draws
+  void willDraw(Buffer* indexBuffer = nullptr);
   void didDraw();
+  // Binds the vertex array object of the current vertex input from VertexArrayCache, setting it up
+  // first if it is new. Returns false if the cache is disabled
+  bool bindCachedVertexArray(RenderPipelineState& pipelineState, Buffer* indexBuffer);
+  // Switches from a cached vertex array object back to the one of this adapter
+  void restoreVertexArray();
   void unbindVertexAttributes();
   void unbindResources();
+  // Writes the handles of the dirty textures into bindlessTextures_ instead of binding them to
+  // texture units
+  void bindBindlessTextures(PackedUniformRing& ring);
 
   void bindBufferWithShaderStorageBufferOverride(Buffer& buffer,
                                                  GLenum overrideTargetForShaderStorageBuffer);
@@ -147,11 +164,23 @@ class RenderCommandAdapter final : public WithContext {
   std::bitset<IGL_TEXTURE_SAMPLERS_MAX> fragmentTextureStatesDirty_;
   TextureStates vertexTextureStates_;
   TextureStates fragmentTextureStates_;
+  BindlessTextureBlock bindlessTextures_;
+  // kept across pipeline changes, as Vulkan keeps push constants across compatible layouts
+  PushConstantBlock pushConstants_;
   UniformAdapter uniformAdapter_;
   StateBits dirtyStateBits_ = EnumToValue(StateMask::NONE);
   std::shared_ptr<IRenderPipelineState> pipelineState_;
   std::shared_ptr<IDepthStencilState> depthStencilState_;
+  // set by the encoder, kept here because depth stencil states are shared between encoders
+  bool hasStencilReferenceValues_ = false;
+  uint32_t frontStencilReferenceValue_ = 0;
+  uint32_t backStencilReferenceValue_ = 0;
   std::shared_ptr<VertexArrayObject> activeVAO_ = nullptr;
+  // the vertex array object from VertexArrayCache which is bound, 0 if activeVAO_ is bound
+  GLuint cachedVAO_ = 0;
+  uint64_t cachedVAOGeneration_ = 0;
+  GLuint cachedVAOIndexBuffer_ = 0;
+  VertexArrayCache::Key cachedVAOKey_;
 
   UnbindPolicy cachedUnbindPolicy_;
   bool useVAO_ = false;
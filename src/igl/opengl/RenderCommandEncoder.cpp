@@ -14,6 +14,8 @@
 #include <igl/opengl/Errors.h>
 #include <igl/opengl/Framebuffer.h>
 #include <igl/opengl/IContext.h>
+#include <igl/opengl/QueryPool.h>
+#include <igl/opengl/RenderBundle.h>
 #include <igl/opengl/RenderCommandAdapter.h>
 #include <igl/opengl/RenderPipelineState.h>
 #include <igl/opengl/SamplerState.h>
@@ -24,6 +26,31 @@
 
 namespace igl {
 namespace opengl {
+
+namespace {
+
+// GL_QCOM_shading_rate has no 2x4 rate
+GLenum toGLShadingRate(ShadingRate rate) {
+  switch (rate) {
+  case ShadingRate::Rate1x1:
+    return GL_SHADING_RATE_1X1_PIXELS_QCOM;
+  case ShadingRate::Rate1x2:
+    return GL_SHADING_RATE_1X2_PIXELS_QCOM;
+  case ShadingRate::Rate2x1:
+    return GL_SHADING_RATE_2X1_PIXELS_QCOM;
+  case ShadingRate::Rate2x2:
+  case ShadingRate::Rate2x4:
+    return GL_SHADING_RATE_2X2_PIXELS_QCOM;
+  case ShadingRate::Rate4x2:
+    return GL_SHADING_RATE_4X2_PIXELS_QCOM;
+  case ShadingRate::Rate4x4:
+    return GL_SHADING_RATE_4X4_PIXELS_QCOM;
+  }
+  IGL_UNREACHABLE_RETURN(GL_SHADING_RATE_1X1_PIXELS_QCOM);
+}
+
+} // namespace
+
 RenderCommandEncoder::RenderCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer) :
   IRenderCommandEncoder(commandBuffer), WithContext(commandBuffer->getContext()) {}
 
@@ -77,10 +104,16 @@ void RenderCommandEncoder::beginEncoding(const RenderPassDesc& renderPass,
   }
   framebuffer_ = std::static_pointer_cast<igl::opengl::Framebuffer>(framebuffer);
   resolveFramebuffer_ = framebuffer_->getResolveFramebuffer();
+  occlusionQueryPool_ = std::static_pointer_cast<QueryPool>(renderPass.occlusionQueryPool);
+  if (occlusionQueryPool_) {
+    occlusionQueryPool_->reset();
+  }
   Result::setOk(outResult);
 }
 
 void RenderCommandEncoder::endEncoding() {
+  IGL_ASSERT_MSG(!isOcclusionQueryActive_, "Did you forget to call endOcclusionQuery()?");
+
   if (IGL_VERIFY(adapter_)) {
     // Restore caller state
     getContext().setEnabled(scissorEnabled_, GL_SCISSOR_TEST);
@@ -89,6 +122,9 @@ void RenderCommandEncoder::endEncoding() {
     getContext().setEnabled(false, GL_POLYGON_OFFSET_FILL);
     adapter_->setDepthBias(0.0f, 0.0f);
 
+    // The shading rate is context state, the next render pass starts at 1x1
+    setShadingRate(ShadingRate::Rate1x1);
+
     adapter_->endEncoding();
     getContext().getAdapterPool().push_back(std::move(adapter_));
 
@@ -148,6 +184,11 @@ void RenderCommandEncoder::endEncoding() {
         IGL_ASSERT_NOT_REACHED();
       }
     }
+
+    // invalidate the attachments which are not stored, after they have been resolved
+    framebuffer_->unbind();
+
+    getContext().checkErrorsAtPassEnd("RenderCommandEncoder::endEncoding");
   }
 }
 
@@ -190,6 +231,7 @@ void RenderCommandEncoder::bindScissorRect(const ScissorRect& rect) {
 void RenderCommandEncoder::bindRenderPipelineState(
     const std::shared_ptr<IRenderPipelineState>& pipelineState) {
   if (IGL_VERIFY(adapter_)) {
+    getCommandBuffer().incrementStatistic(CommandBufferCounter::PipelineBinds);
     adapter_->setPipelineState(pipelineState);
   }
 }
@@ -207,6 +249,10 @@ void RenderCommandEncoder::bindUniform(const UniformDesc& uniformDesc, const voi
                  uniformDesc.location);
   IGL_ASSERT_MSG(data != nullptr, "Data cannot be null");
   if (IGL_VERIFY(adapter_) && data) {
+    getCommandBuffer().incrementStatistic(CommandBufferCounter::BindingUpdates);
+    getCommandBuffer().incrementStatistic(
+        CommandBufferCounter::UploadedBytes,
+        sizeForUniformType(uniformDesc.type) * uniformDesc.numElements);
     adapter_->setUniform(uniformDesc, data);
   }
 }
@@ -218,15 +264,20 @@ void RenderCommandEncoder::bindBuffer(int index,
   IGL_ASSERT_MSG(index >= 0, "Invalid index passed to bindBuffer: %d", index);
   // bindTarget (which can be BindTarget::kVertex or kFragment) is unused in OGL backend
   if (IGL_VERIFY(adapter_) && buffer) {
-    auto glBuffer = std::static_pointer_cast<Buffer>(buffer);
-    auto bufferType = glBuffer->getType();
+    auto& glBuffer = static_cast<Buffer&>(*buffer);
+    auto bufferType = glBuffer.getType();
 
     if (bufferType == Buffer::Type::Uniform) {
-      IGL_ASSERT_NOT_IMPLEMENTED();
+      // CPU uniform buffers can back uniform blocks only where the context has them (not GLES 2)
+      if (getContext().deviceFeatures().hasFeature(DeviceFeatures::UniformBlocks)) {
+        adapter_->setUniformBuffer(buffer, offset, index);
+      } else {
+        IGL_ASSERT_NOT_IMPLEMENTED();
+      }
     } else if (bufferType == Buffer::Type::UniformBlock) {
-      adapter_->setUniformBuffer(glBuffer, offset, index);
+      adapter_->setUniformBuffer(buffer, offset, index);
     } else if (bufferType == Buffer::Type::Attribute && (bindTarget & BindTarget::kVertex) != 0) {
-      adapter_->setVertexBuffer(std::move(glBuffer), offset, index);
+      adapter_->setVertexBuffer(buffer, offset, index);
     }
   }
 }
@@ -238,10 +289,12 @@ void RenderCommandEncoder::bindBytes(size_t /*index*/,
   IGL_ASSERT_NOT_IMPLEMENTED();
 }
 
-void RenderCommandEncoder::bindPushConstants(size_t /*offset*/,
-                                             const void* /*data*/,
-                                             size_t /*length*/) {
-  IGL_ASSERT_NOT_IMPLEMENTED();
+void RenderCommandEncoder::bindPushConstants(size_t offset, const void* data, size_t length) {
+  if (IGL_VERIFY(adapter_)) {
+    getCommandBuffer().incrementStatistic(CommandBufferCounter::BindingUpdates);
+    getCommandBuffer().incrementStatistic(CommandBufferCounter::UploadedBytes, length);
+    adapter_->setPushConstants(offset, data, length);
+  }
 }
 
 void RenderCommandEncoder::bindSamplerState(size_t index,
@@ -305,11 +358,7 @@ constexpr int toGlType(IndexFormat format) {
 void RenderCommandEncoder::draw(PrimitiveType primitiveType,
                                 size_t vertexStart,
                                 size_t vertexCount) {
-  if (IGL_VERIFY(adapter_)) {
-    getCommandBuffer().incrementCurrentDrawCount();
-    auto mode = toGlPrimitive(primitiveType);
-    adapter_->drawArrays(mode, (GLsizei)vertexStart, (GLsizei)vertexCount);
-  }
+  drawInstanced(primitiveType, vertexStart, vertexCount, 1);
 }
 
 void RenderCommandEncoder::drawIndexed(PrimitiveType primitiveType,
@@ -317,12 +366,34 @@ void RenderCommandEncoder::drawIndexed(PrimitiveType primitiveType,
                                        IndexFormat indexFormat,
                                        IBuffer& indexBuffer,
                                        size_t indexBufferOffset) {
+  drawIndexedInstanced(primitiveType, indexCount, indexFormat, indexBuffer, indexBufferOffset, 1);
+}
+
+void RenderCommandEncoder::drawInstanced(PrimitiveType primitiveType,
+                                         size_t vertexStart,
+                                         size_t vertexCount,
+                                         uint32_t instanceCount) {
+  if (IGL_VERIFY(adapter_)) {
+    getCommandBuffer().incrementCurrentDrawCount();
+    auto mode = toGlPrimitive(primitiveType);
+    adapter_->drawArrays(
+        mode, (GLsizei)vertexStart, (GLsizei)vertexCount, (GLsizei)instanceCount);
+  }
+}
+
+void RenderCommandEncoder::drawIndexedInstanced(PrimitiveType primitiveType,
+                                                size_t indexCount,
+                                                IndexFormat indexFormat,
+                                                IBuffer& indexBuffer,
+                                                size_t indexBufferOffset,
+                                                uint32_t instanceCount) {
   if (IGL_VERIFY(adapter_)) {
     getCommandBuffer().incrementCurrentDrawCount();
     auto mode = toGlPrimitive(primitiveType);
     auto type = toGlType(indexFormat);
     auto offset = reinterpret_cast<void*>(indexBufferOffset);
-    adapter_->drawElements(mode, (GLsizei)indexCount, type, (Buffer&)indexBuffer, offset);
+    adapter_->drawElements(
+        mode, (GLsizei)indexCount, type, (Buffer&)indexBuffer, offset, (GLsizei)instanceCount);
   }
 }
 
@@ -359,6 +430,18 @@ void RenderCommandEncoder::multiDrawIndexedIndirect(PrimitiveType /*primitiveTyp
   IGL_ASSERT_NOT_IMPLEMENTED();
 }
 
+void RenderCommandEncoder::multiDrawIndexedIndirectCount(PrimitiveType /*primitiveType*/,
+                                                         IndexFormat /*indexFormat*/,
+                                                         IBuffer& /*indexBuffer*/,
+                                                         IBuffer& /*indirectBuffer*/,
+                                                         size_t /*indirectBufferOffset*/,
+                                                         IBuffer& /*countBuffer*/,
+                                                         size_t /*countBufferOffset*/,
+                                                         uint32_t /*maxDrawCount*/,
+                                                         uint32_t /*stride*/) {
+  IGL_ASSERT_NOT_IMPLEMENTED();
+}
+
 void RenderCommandEncoder::setStencilReferenceValue(uint32_t value) {
   if (IGL_VERIFY(adapter_)) {
     adapter_->setStencilReferenceValue(value);
@@ -383,5 +466,41 @@ void RenderCommandEncoder::setDepthBias(float depthBias, float slopeScale, float
   }
 }
 
+void RenderCommandEncoder::setShadingRate(ShadingRate rate) {
+  if (rate == shadingRate_ ||
+      !getContext().deviceFeatures().hasExtension(Extensions::ShadingRate)) {
+    return;
+  }
+  getContext().shadingRate(toGLShadingRate(rate));
+  shadingRate_ = rate;
+}
+
+void RenderCommandEncoder::beginOcclusionQuery(uint32_t query) {
+  IGL_ASSERT_MSG(occlusionQueryPool_, "RenderPassDesc::occlusionQueryPool is not set");
+  IGL_ASSERT_MSG(!isOcclusionQueryActive_, "Occlusion queries cannot be nested");
+
+  if (!occlusionQueryPool_ || isOcclusionQueryActive_) {
+    return;
+  }
+
+  occlusionQueryPool_->begin(query);
+  isOcclusionQueryActive_ = true;
+}
+
+void RenderCommandEncoder::endOcclusionQuery() {
+  IGL_ASSERT(isOcclusionQueryActive_);
+
+  if (!isOcclusionQueryActive_) {
+    return;
+  }
+
+  occlusionQueryPool_->end();
+  isOcclusionQueryActive_ = false;
+}
+
+void RenderCommandEncoder::executeRenderBundle(const IRenderBundle& bundle) {
+  static_cast<const RenderBundle&>(bundle).replay(*this);
+}
+
 } // namespace opengl
 } // namespace igl
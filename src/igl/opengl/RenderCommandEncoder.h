@@ -23,6 +23,7 @@ namespace opengl {
 
 class RenderCommandAdapter;
 class CommandBuffer;
+class QueryPool;
 
 class RenderCommandEncoder final : public IRenderCommandEncoder, public WithContext {
  public:
@@ -74,6 +75,16 @@ class RenderCommandEncoder final : public IRenderCommandEncoder, public WithCont
                    IndexFormat indexFormat,
                    IBuffer& indexBuffer,
                    size_t indexBufferOffset) override;
+  void drawInstanced(PrimitiveType primitiveType,
+                     size_t vertexStart,
+                     size_t vertexCount,
+                     uint32_t instanceCount) override;
+  void drawIndexedInstanced(PrimitiveType primitiveType,
+                            size_t indexCount,
+                            IndexFormat indexFormat,
+                            IBuffer& indexBuffer,
+                            size_t indexBufferOffset,
+                            uint32_t instanceCount) override;
   void drawIndexedIndirect(PrimitiveType primitiveType,
                            IndexFormat indexFormat,
                            IBuffer& indexBuffer,
@@ -91,17 +102,35 @@ class RenderCommandEncoder final : public IRenderCommandEncoder, public WithCont
                                 size_t indirectBufferOffset,
                                 uint32_t drawCount,
                                 uint32_t stride) override;
+  void multiDrawIndexedIndirectCount(PrimitiveType primitiveType,
+                                     IndexFormat indexFormat,
+                                     IBuffer& indexBuffer,
+                                     IBuffer& indirectBuffer,
+                                     size_t indirectBufferOffset,
+                                     IBuffer& countBuffer,
+                                     size_t countBufferOffset,
+                                     uint32_t maxDrawCount,
+                                     uint32_t stride) override;
 
   void setStencilReferenceValue(uint32_t value) override;
   void setStencilReferenceValues(uint32_t frontValue, uint32_t backValue) override;
   void setBlendColor(Color color) override;
   void setDepthBias(float depthBias, float slopeScale, float clamp) override;
+  void setShadingRate(ShadingRate rate) override;
+
+  void beginOcclusionQuery(uint32_t query) override;
+  void endOcclusionQuery() override;
+
+  void executeRenderBundle(const IRenderBundle& bundle) override;
 
  private:
   std::unique_ptr<RenderCommandAdapter> adapter_;
   bool scissorEnabled_ = false;
   std::shared_ptr<igl::opengl::Framebuffer> resolveFramebuffer_;
   std::shared_ptr<igl::opengl::Framebuffer> framebuffer_;
+  std::shared_ptr<QueryPool> occlusionQueryPool_;
+  bool isOcclusionQueryActive_ = false;
+  ShadingRate shadingRate_ = ShadingRate::Rate1x1;
 };
 
 } // namespace opengl
@@ -73,10 +73,11 @@ namespace igl {
 namespace opengl {
 
 RenderPipelineReflection::RenderPipelineReflection(IContext& context, const ShaderStages& stages) {
+  const PackedUniformBlock* packedUniforms = stages.getPackedUniforms();
   if (context.deviceFeatures().hasFeature(DeviceFeatures::UniformBlocks)) {
-    generateUniformBlocksDictionary(context, stages.getProgramID());
+    generateUniformBlocksDictionary(context, stages.getProgramID(), packedUniforms);
   }
-  generateUniformDictionary(context, stages.getProgramID());
+  generateUniformDictionary(context, stages.getProgramID(), packedUniforms);
   generateAttributeDictionary(context, stages.getProgramID());
   generateShaderStorageBufferObjectDictionary(context, stages.getProgramID());
   cacheDescriptors();
@@ -84,7 +85,9 @@ RenderPipelineReflection::RenderPipelineReflection(IContext& context, const Shad
 
 RenderPipelineReflection::~RenderPipelineReflection() = default;
 
-void RenderPipelineReflection::generateUniformDictionary(IContext& context, GLuint pid) {
+void RenderPipelineReflection::generateUniformDictionary(IContext& context,
+                                                         GLuint pid,
+                                                         const PackedUniformBlock* packedUniforms) {
   IGL_ASSERT(pid != 0);
   uniformDictionary_.clear();
 
@@ -101,7 +104,7 @@ void RenderPipelineReflection::generateUniformDictionary(IContext& context, GLui
 
     context.getActiveUniform(pid, i, maxUniformNameLength, &length, &size, &type, cname.data());
     GLint location = context.getUniformLocation(pid, cname.data());
-    if (location < 0) {
+    if (location < 0 && !packedUniforms) {
       // this uniform belongs to a block;
       continue;
     }
@@ -110,12 +113,22 @@ void RenderPipelineReflection::generateUniformDictionary(IContext& context, GLui
       length = length - 3; // remove '[0]' for arrays
     }
     auto name = std::string(cname.data(), cname.data() + length);
+    if (location < 0) {
+      location = packedUniforms->getLocation(name);
+      if (location < 0) {
+        // this uniform belongs to a block;
+        continue;
+      }
+    }
     UniformDesc u(size, location, type);
     uniformDictionary_.insert(std::make_pair(igl::genNameHandle(name), u));
   }
 }
 
-void RenderPipelineReflection::generateUniformBlocksDictionary(IContext& context, GLuint pid) {
+void RenderPipelineReflection::generateUniformBlocksDictionary(
+    IContext& context,
+    GLuint pid,
+    const PackedUniformBlock* packedUniforms) {
   IGL_ASSERT(pid != 0);
   uniformBlocksDictionary_.clear();
 
@@ -148,6 +161,10 @@ void RenderPipelineReflection::generateUniformBlocksDictionary(IContext& context
                                       uniformBlockNameData.data());
     std::string uniformBlockName(uniformBlockNameData.begin(),
                                  uniformBlockNameData.begin() + blockNameLength);
+    if (packedUniforms && uniformBlockName == PackedUniformBlock::kBlockName) {
+      // its members are reported as uniforms
+      continue;
+    }
 
     context.getActiveUniformBlockiv(
         pid, blockDesc.blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &blockDesc.size);
@@ -70,8 +70,13 @@ class RenderPipelineReflection final : public IRenderPipelineReflection {
   std::unordered_map<std::string, int> attributeDictionary_;
   std::unordered_map<NameHandle, int> shaderStorageBufferObjectDictionary_;
 
-  void generateUniformDictionary(IContext& context, GLuint pid);
-  void generateUniformBlocksDictionary(IContext& context, GLuint pid);
+  // members of the packed uniform block are reported as uniforms with their pseudo locations
+  void generateUniformDictionary(IContext& context,
+                                 GLuint pid,
+                                 const PackedUniformBlock* packedUniforms);
+  void generateUniformBlocksDictionary(IContext& context,
+                                       GLuint pid,
+                                       const PackedUniformBlock* packedUniforms);
   void generateShaderStorageBufferObjectDictionary(IContext& context, GLuint pid);
   void generateAttributeDictionary(IContext& context, GLuint pid);
 
@@ -7,7 +7,10 @@
 
 #include <igl/opengl/RenderPipelineState.h>
 
+#include <algorithm>
+#include <atomic>
 #include <igl/RenderCommandEncoder.h> // for igl::BindTarget
+#include <igl/opengl/VertexArrayCache.h>
 #include <igl/opengl/VertexInputState.h>
 
 namespace igl {
@@ -24,11 +27,17 @@ void logBlendFactorError(IGL_MAYBE_UNUSED const char* value) {
 } // namespace
 
 RenderPipelineState::RenderPipelineState(IContext& context) : WithContext(context) {
+  static std::atomic<uint64_t> nextVertexArrayCacheId = 1;
+  vertexArrayCacheId_ = nextVertexArrayCacheId++;
   activeAttributesLocations_.reserve(64);
   unitSamplerLocationMap_.fill(-1);
 }
 
-RenderPipelineState::~RenderPipelineState() = default;
+RenderPipelineState::~RenderPipelineState() {
+  if (auto* cache = getContext().getVertexArrayCache()) {
+    cache->evictPipeline(vertexArrayCacheId_);
+  }
+}
 
 GLenum RenderPipelineState::convertBlendOp(BlendOp value) {
   // sets blending equation for both RGA and Alpha
@@ -113,7 +122,9 @@ Result RenderPipelineState::create(const RenderPipelineDesc& desc) {
     return Result(Result::Code::ArgumentInvalid, "Missing required shader module(s).");
   }
 
-  reflection_ = std::make_shared<RenderPipelineReflection>(getContext(), *shaderStages_);
+  // the reflection enumerates every uniform, block and attribute of the program, it is built on
+  // first use. The names of the descriptor are looked up with one query each instead
+  const GLuint programID = shaderStages_->getProgramID();
 
   mFramebufferDesc = desc.targetDesc;
 
@@ -126,7 +137,7 @@ Result RenderPipelineState::create(const RenderPipelineDesc& desc) {
     // For each bufferIndex, storage the list of associated attribute locations
     for (const auto& [index, attribList] : bufferAttribMap) {
       for (const auto& attrib : attribList) {
-        const int loc = getIndexByName(igl::genNameHandle(attrib.name), ShaderStage::Vertex);
+        const int loc = getContext().getAttribLocation(programID, attrib.name.c_str());
         if (loc < 0) {
           IGL_LOG_ERROR("Vertex attribute (%s) not found in shader.", attrib.name.c_str());
         }
@@ -140,7 +151,7 @@ Result RenderPipelineState::create(const RenderPipelineDesc& desc) {
 
   // Note this work is only done once. Beyond this point, there is no more query by name
   for (const auto& [textureUnit, samplerName] : desc.fragmentUnitSamplerMap) {
-    const int loc = reflection_->getIndexByName(samplerName);
+    const int loc = getContext().getUniformLocation(programID, samplerName.toConstChar());
     if (loc >= 0) {
       unitSamplerLocationMap_[textureUnit] = loc;
     } else {
@@ -150,9 +161,11 @@ Result RenderPipelineState::create(const RenderPipelineDesc& desc) {
 
   for (const auto& [bindingIndex, names] : desc.uniformBlockBindingMap) {
     const auto& [blockName, instanceName] = names;
-    int blockIndex = reflection_->getIndexByName(blockName);
+    const GLuint index = getContext().getUniformBlockIndex(programID, blockName.toConstChar());
+    int blockIndex = index != GL_INVALID_INDEX ? static_cast<int>(index) : -1;
     if (blockIndex < 0 && !instanceName.toString().empty()) {
-      blockIndex = reflection_->getIndexByName(instanceName);
+      // instance names are only known to the reflection
+      blockIndex = getReflection().getIndexByName(instanceName);
     }
     if (blockIndex >= 0) {
       uniformBlockBindingMap_[blockIndex] = bindingIndex;
@@ -162,7 +175,7 @@ Result RenderPipelineState::create(const RenderPipelineDesc& desc) {
   }
 
   for (const auto& [textureUnit, samplerName] : desc.vertexUnitSamplerMap) {
-    const int loc = reflection_->getIndexByName(samplerName);
+    const int loc = getContext().getUniformLocation(programID, samplerName.toConstChar());
     if (loc < 0) {
       IGL_LOG_ERROR("Sampler uniform (%s) not found in shader.\n", samplerName.toConstChar());
       continue;
@@ -291,6 +304,10 @@ void RenderPipelineState::bindVertexAttributes(size_t bufferIndex, size_t buffer
         attribute.normalized,
         attribute.stride,
         reinterpret_cast<const char*>(attribute.bufferOffset) + bufferOffset);
+    if (attribute.divisor) {
+      getContext().vertexAttribDivisor(location, attribute.divisor);
+      instancedAttributesLocations_.push_back(location);
+    }
   }
 }
 
@@ -299,6 +316,11 @@ void RenderPipelineState::unbindVertexAttributes() {
     getContext().disableVertexAttribArray(l);
   }
   activeAttributesLocations_.clear();
+  // the divisors are not part of the pipeline state of the next draws
+  for (const auto& l : instancedAttributesLocations_) {
+    getContext().vertexAttribDivisor(l, 0);
+  }
+  instancedAttributesLocations_.clear();
 }
 
 // Looks up the location the of the specified texture unit via its name,
@@ -330,7 +352,10 @@ Result RenderPipelineState::bindTextureUnit(const size_t unit, uint8_t bindTarge
     return Result{Result::Code::RuntimeError, "Unable to find sampler location\n"};
   }
 
-  getContext().uniform1i(samplerLocation, static_cast<GLint>(unit));
+  const auto value = static_cast<GLint>(unit);
+  if (shaderStages_->updateUniformShadow(samplerLocation, &value, sizeof(value))) {
+    getContext().uniform1i(samplerLocation, value);
+  }
   getContext().activeTexture(static_cast<GLenum>(GL_TEXTURE0 + unit));
 
   return Result();
@@ -345,17 +370,83 @@ bool RenderPipelineState::matchesVertexInputState(const RenderPipelineState& rhs
 }
 
 int RenderPipelineState::getIndexByName(const NameHandle& name, ShaderStage /*stage*/) const {
-  if (reflection_ == nullptr) {
+  if (shaderStages_ == nullptr) {
     return -1;
   }
-  return reflection_->getIndexByName(name);
+  if (const auto* uniform = getUniformLocation(name)) {
+    return uniform->location;
+  }
+  // attributes and shader storage buffers
+  return getReflection().getIndexByName(name);
 }
 
-int RenderPipelineState::getIndexByName(const std::string& name, ShaderStage /*stage*/) const {
+const RenderPipelineReflection& RenderPipelineState::getReflection() const {
+  IGL_ASSERT(shaderStages_);
   if (reflection_ == nullptr) {
-    return -1;
+    IGL_PROFILER_FUNCTION();
+    reflection_ = std::make_shared<RenderPipelineReflection>(getContext(), *shaderStages_);
+    buildUniformLocations();
+  }
+  return *reflection_;
+}
+
+int RenderPipelineState::getIndexByName(const std::string& name, ShaderStage stage) const {
+  return getIndexByName(igl::genNameHandle(name), stage);
+}
+
+void RenderPipelineState::buildUniformLocations() const {
+  uniformLocations_.clear();
+
+  // uniforms come first, so they win over uniform blocks of the same name as in
+  // RenderPipelineReflection::getIndexByName()
+  for (const auto& buffer : reflection_->allUniformBuffers()) {
+    if (!buffer.isUniformBlock && !buffer.members.empty()) {
+      UniformLocation uniform;
+      uniform.nameCrc32 = buffer.name.getCrc32();
+      uniform.location = buffer.bufferIndex;
+      uniform.type = buffer.members[0].type;
+      uniform.numElements = buffer.members[0].arrayLength;
+      uniformLocations_.push_back(uniform);
+    }
+  }
+  for (const auto& texture : reflection_->allTextures()) {
+    UniformLocation uniform;
+    uniform.nameCrc32 = igl::genNameHandle(texture.name).getCrc32();
+    uniform.location = texture.textureIndex;
+    uniformLocations_.push_back(uniform);
+  }
+  for (const auto& buffer : reflection_->allUniformBuffers()) {
+    if (buffer.isUniformBlock) {
+      UniformLocation uniform;
+      uniform.nameCrc32 = buffer.name.getCrc32();
+      uniform.location = buffer.bufferIndex;
+      uniform.isUniformBlock = true;
+      uniformLocations_.push_back(uniform);
+    }
   }
-  return reflection_->getIndexByName(igl::genNameHandle(name));
+
+  std::stable_sort(uniformLocations_.begin(),
+                   uniformLocations_.end(),
+                   [](const UniformLocation& a, const UniformLocation& b) {
+                     return a.nameCrc32 < b.nameCrc32;
+                   });
+}
+
+const RenderPipelineState::UniformLocation* RenderPipelineState::getUniformLocation(
+    const NameHandle& name) const {
+  if (shaderStages_ == nullptr) {
+    return nullptr;
+  }
+  // builds uniformLocations_
+  getReflection();
+
+  const uint32_t crc32 = name.getCrc32();
+  const auto it = std::lower_bound(
+      uniformLocations_.begin(),
+      uniformLocations_.end(),
+      crc32,
+      [](const UniformLocation& uniform, uint32_t value) { return uniform.nameCrc32 < value; });
+  return it != uniformLocations_.end() && it->nameCrc32 == crc32 ? &*it : nullptr;
 }
 
 int RenderPipelineState::getUniformBlockBindingPoint(const NameHandle& uniformBlockName) const {
@@ -364,6 +455,10 @@ int RenderPipelineState::getUniformBlockBindingPoint(const NameHandle& uniformBl
 }
 
 std::shared_ptr<IRenderPipelineReflection> RenderPipelineState::renderPipelineReflection() {
+  if (shaderStages_ == nullptr) {
+    return nullptr;
+  }
+  getReflection();
   return reflection_;
 }
 
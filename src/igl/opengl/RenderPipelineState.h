@@ -34,6 +34,18 @@ class RenderPipelineState final : public WithContext, public IRenderPipelineStat
   friend class Device;
 
  public:
+  /// An active uniform, sampler or uniform block of the program, resolved when the pipeline is
+  /// created
+  struct UniformLocation {
+    uint32_t nameCrc32 = 0;
+    // the uniform location, or the block index of uniform blocks
+    GLint location = -1;
+    // Invalid for samplers and uniform blocks
+    UniformType type = UniformType::Invalid;
+    size_t numElements = 1;
+    bool isUniformBlock = false;
+  };
+
   explicit RenderPipelineState(IContext& context);
   ~RenderPipelineState() override;
 
@@ -44,13 +56,31 @@ class RenderPipelineState final : public WithContext, public IRenderPipelineStat
 
   void bindVertexAttributes(size_t bufferIndex, size_t offset);
   void unbindVertexAttributes();
+  // Forgets the attributes enabled by bindVertexAttributes() without disabling them, for vertex
+  // array objects of VertexArrayCache, which keep their attributes enabled
+  void releaseVertexAttributes() {
+    activeAttributesLocations_.clear();
+    instancedAttributesLocations_.clear();
+  }
+  bool usesVertexBuffer(size_t bufferIndex) const {
+    return !bufferAttribLocations_[bufferIndex].empty();
+  }
+  // Unique for the lifetime of the process, unlike `this`
+  uint64_t getVertexArrayCacheId() const {
+    return vertexArrayCacheId_;
+  }
 
   bool matchesShaderProgram(const RenderPipelineState& rhs) const;
   bool matchesVertexInputState(const RenderPipelineState& rhs) const;
 
+  /// Name lookups build the reflection of the program on first use, see getReflection()
   int getIndexByName(const NameHandle& name, ShaderStage stage) const override;
   int getIndexByName(const std::string& name, ShaderStage stage) const override;
 
+  /// Looks `name` up in a flat table sorted by name hash instead of the reflection dictionaries.
+  /// Returns nullptr if the program has no such uniform, sampler or uniform block
+  const UniformLocation* getUniformLocation(const NameHandle& name) const;
+
   int getUniformBlockBindingPoint(const NameHandle& uniformBlockName) const;
   std::shared_ptr<IRenderPipelineReflection> renderPipelineReflection() override;
   void setRenderPipelineReflection(
@@ -70,6 +100,17 @@ class RenderPipelineState final : public WithContext, public IRenderPipelineStat
 
   std::unordered_map<int, size_t>& uniformBlockBindingMap();
 
+  ShaderStages* getShaderStages() const {
+    return shaderStages_.get();
+  }
+
+ private:
+  // Enumerating the active uniforms, blocks and attributes takes hundreds of queries for large
+  // programs, so it is deferred until the reflection or a name lookup is first needed. Pipelines
+  // which are only bound with indices never build it
+  const RenderPipelineReflection& getReflection() const;
+  void buildUniformLocations() const;
+
  private:
   std::shared_ptr<VertexInputState> vertexInputState_;
 
@@ -77,19 +118,25 @@ class RenderPipelineState final : public WithContext, public IRenderPipelineStat
   std::vector<int> bufferAttribLocations_[IGL_VERTEX_BUFFER_MAX];
 
   std::shared_ptr<ShaderStages> shaderStages_;
-  std::shared_ptr<RenderPipelineReflection> reflection_;
+  // built by getReflection()
+  mutable std::shared_ptr<RenderPipelineReflection> reflection_;
   RenderPipelineDesc::TargetDesc mFramebufferDesc;
   std::unordered_map<size_t, size_t> vertexTextureUnitRemap;
   std::array<GLint, IGL_TEXTURE_SAMPLERS_MAX> unitSamplerLocationMap_;
   std::unordered_map<int, size_t> uniformBlockBindingMap_;
+  // sorted by nameCrc32, built by getReflection()
+  mutable std::vector<UniformLocation> uniformLocations_;
   std::array<GLboolean, 4> colorMask_ = {GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE};
   std::vector<int> activeAttributesLocations_;
+  // the subset of activeAttributesLocations_ with a vertex attribute divisor
+  std::vector<int> instancedAttributesLocations_;
   BlendMode blendMode_ = {GL_FUNC_ADD, GL_FUNC_ADD, GL_ONE, GL_ZERO, GL_ONE, GL_ZERO};
   CullMode cullMode_ = igl::CullMode::Back;
   WindingMode frontFaceWinding_ = igl::WindingMode::CounterClockwise;
   PolygonFillMode polygonFillMode_ = igl::PolygonFillMode::Fill;
 
   bool blendEnabled_ = false;
+  uint64_t vertexArrayCacheId_ = 0;
 };
 
 } // namespace opengl
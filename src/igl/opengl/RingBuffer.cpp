@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/RingBuffer.h>
+
+#include <igl/opengl/Buffer.h>
+#include <igl/opengl/IContext.h>
+
+namespace igl {
+namespace opengl {
+
+RingBuffer::RingBuffer(IContext& context, const RingBufferDesc& desc, Result* outResult) :
+  WithContext(context), allocator_(desc.length, desc.alignment) {
+  if (desc.length == 0) {
+    Result::setResult(outResult, Result::Code::ArgumentInvalid, "Ring buffer length is 0");
+    return;
+  }
+
+  // only uniform blocks can be bound with an offset
+  if (desc.type & BufferDesc::BufferTypeBits::Uniform) {
+    buffer_ =
+        std::make_unique<UniformBlockBuffer>(context, BufferDesc::BufferAPIHintBits::UniformBlock);
+  } else {
+    buffer_ = std::make_unique<ArrayBuffer>(context, 0);
+  }
+
+  Result result;
+  buffer_->initializePersistent(
+      BufferDesc(desc.type, nullptr, desc.length, ResourceStorage::Shared, 0, desc.debugName),
+      &result);
+  if (!result.isOk()) {
+    buffer_ = nullptr;
+    Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  Result::setOk(outResult);
+}
+
+void RingBuffer::retireFrames() {
+  while (!frames_.empty() && getContext().isSubmitHandleComplete(frames_.front())) {
+    frames_.pop_front();
+    allocator_.retireFrame();
+  }
+}
+
+RingBufferAllocation RingBuffer::allocate(size_t size, Result* outResult) {
+  if (!IGL_VERIFY(buffer_)) {
+    Result::setResult(outResult, Result::Code::InvalidOperation, "Ring buffer is not mapped");
+    return {};
+  }
+
+  if (size > allocator_.getCapacity()) {
+    Result::setResult(
+        outResult, Result::Code::ArgumentOutOfRange, "Allocation exceeds ring buffer length");
+    return {};
+  }
+
+  retireFrames();
+
+  const size_t offset = allocator_.allocate(size);
+
+  if (offset == RingBufferAllocator::kInvalidOffset) {
+    Result::setResult(outResult, Result::Code::InvalidOperation, "Ring buffer is full");
+    return {};
+  }
+
+  Result::setOk(outResult);
+
+  return {buffer_->getPersistentData() + offset, offset, size};
+}
+
+void RingBuffer::endFrame(SubmitHandle handle) {
+  // callers which do not track their submits pass an empty handle
+  frames_.push_back(handle ? handle : getContext().insertSubmitFence());
+  allocator_.endFrame();
+}
+
+IBuffer& RingBuffer::getBuffer() const {
+  IGL_ASSERT(buffer_);
+  return *buffer_;
+}
+
+} // namespace opengl
+} // namespace igl
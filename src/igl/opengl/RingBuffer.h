@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <deque>
+#include <igl/RingBuffer.h>
+#include <igl/opengl/GLIncludes.h>
+#include <igl/opengl/WithContext.h>
+
+namespace igl {
+namespace opengl {
+
+class ArrayBuffer;
+
+/**
+ * @brief Sub-allocates per-frame data from immutable buffer storage which is mapped with
+ * GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT for its whole lifetime. Every frame is guarded by the
+ * submit handle passed to endFrame(), or by a new submit fence if the handle is empty.
+ */
+class RingBuffer final : public WithContext, public IRingBuffer {
+ public:
+  RingBuffer(IContext& context, const RingBufferDesc& desc, Result* outResult);
+
+  RingBufferAllocation allocate(size_t size, Result* outResult) override;
+  void endFrame(SubmitHandle handle) override;
+  [[nodiscard]] IBuffer& getBuffer() const override;
+
+ private:
+  void retireFrames();
+
+ private:
+  std::unique_ptr<ArrayBuffer> buffer_;
+  RingBufferAllocator allocator_;
+  // submit handles of all frames in flight, oldest first
+  std::deque<SubmitHandle> frames_;
+};
+
+} // namespace opengl
+} // namespace igl
@@ -38,6 +38,36 @@ SamplerState::SamplerState(IContext& context, const SamplerStateDesc& desc) :
   hash_ = h(desc);
 }
 
+SamplerState::~SamplerState() {
+  if (samplerObject_ != 0) {
+    getContext().deleteSamplers(1, &samplerObject_);
+  }
+}
+
+GLuint SamplerState::getSamplerObject() {
+  if (samplerObject_ != 0) {
+    return samplerObject_;
+  }
+
+  getContext().genSamplers(1, &samplerObject_);
+  if (samplerObject_ == 0) {
+    return 0;
+  }
+  getContext().samplerParameteri(samplerObject_, GL_TEXTURE_MIN_FILTER, minMipFilter_);
+  getContext().samplerParameteri(samplerObject_, GL_TEXTURE_MAG_FILTER, magFilter_);
+  getContext().samplerParameterf(samplerObject_, GL_TEXTURE_MIN_LOD, mipLodMin_);
+  getContext().samplerParameterf(samplerObject_, GL_TEXTURE_MAX_LOD, mipLodMax_);
+  getContext().samplerParameteri(samplerObject_, GL_TEXTURE_WRAP_S, addressU_);
+  getContext().samplerParameteri(samplerObject_, GL_TEXTURE_WRAP_T, addressV_);
+  getContext().samplerParameteri(samplerObject_, GL_TEXTURE_WRAP_R, addressW_);
+  getContext().samplerParameteri(samplerObject_,
+                                 GL_TEXTURE_COMPARE_MODE,
+                                 depthCompareEnabled_ ? GL_COMPARE_REF_TO_TEXTURE : GL_NONE);
+  getContext().samplerParameteri(samplerObject_, GL_TEXTURE_COMPARE_FUNC, depthCompareFunction_);
+
+  return samplerObject_;
+}
+
 void SamplerState::bind(ITexture* t) {
   if (IGL_UNEXPECTED(t == nullptr)) {
     return;
@@ -18,8 +18,17 @@ namespace opengl {
 class SamplerState final : public WithContext, public ISamplerState {
  public:
   SamplerState(IContext& context, const SamplerStateDesc& desc);
+  ~SamplerState() override;
   void bind(ITexture* texture);
 
+  // Samplers with equal descriptors have equal hashes
+  size_t getHash() const {
+    return hash_;
+  }
+  // A sampler object with this state, created on first use. Bindless texture handles combine a
+  // texture with a sampler object, see BindlessTextureBlock
+  GLuint getSamplerObject();
+
   static GLint convertMinMipFilter(SamplerMinMagFilter minFilter, SamplerMipFilter mipFilter);
   static GLint convertMagFilter(SamplerMinMagFilter magFilter);
   static GLint convertAddressMode(SamplerAddressMode addressMode);
@@ -30,6 +39,7 @@ class SamplerState final : public WithContext, public ISamplerState {
 
  private:
   size_t hash_ = std::numeric_limits<size_t>::max();
+  GLuint samplerObject_ = 0;
   GLint minMipFilter_;
   GLint magFilter_;
   GLfloat mipLodMin_;
@@ -9,9 +9,14 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <igl/CacheFile.h>
+#include <igl/opengl/BindlessTextureBlock.h>
 #include <igl/opengl/CommandBuffer.h>
 #include <igl/opengl/Device.h>
 #include <igl/opengl/Errors.h>
+#include <igl/opengl/ProgramBinaryCache.h>
+#include <igl/opengl/PushConstantBlock.h>
 #include <string>
 
 #if IGL_SHADER_DUMP
@@ -22,6 +27,72 @@
 namespace igl {
 namespace opengl {
 
+namespace {
+
+std::string getSpecializationConstantValue(const ShaderSpecializationConstant& constant) {
+  char str[32] = {};
+  switch (constant.type) {
+  case ShaderSpecializationConstant::Type::Bool:
+    return constant.value ? "true" : "false";
+  case ShaderSpecializationConstant::Type::Int:
+    snprintf(str, sizeof(str), "%d", static_cast<int32_t>(constant.value));
+    break;
+  case ShaderSpecializationConstant::Type::UInt:
+    snprintf(str, sizeof(str), "%uu", constant.value);
+    break;
+  case ShaderSpecializationConstant::Type::Float: {
+    float value = 0.0f;
+    memcpy(&value, &constant.value, sizeof(value));
+    // the exponent form is always parsed as a float literal and round-trips exactly
+    snprintf(str, sizeof(str), "%.8e", value);
+    break;
+  }
+  }
+  return str;
+}
+
+// GLSL has no specialization constants, so every constant becomes a `#define` which has to come
+// after the `#version` directive
+std::string injectSpecializationConstants(
+    const char* source,
+    const std::vector<ShaderSpecializationConstant>& constants) {
+  std::string defines;
+  for (const auto& c : constants) {
+    defines += "#define " + c.name + " " + getSpecializationConstantValue(c) + "\n";
+  }
+
+  std::string result(source);
+
+  size_t pos = result.find("#version");
+  if (pos != std::string::npos) {
+    pos = result.find('\n', pos);
+    if (pos == std::string::npos) {
+      result += '\n';
+      pos = result.size();
+    } else {
+      pos++;
+    }
+  } else {
+    pos = 0;
+  }
+
+  result.insert(pos, defines);
+
+  return result;
+}
+
+// Identifies a program in the program binary cache by the hashes of its shader sources
+uint64_t getProgramKey(ShaderStagesType type, std::initializer_list<size_t> shaderHashes) {
+  uint64_t key = hashCacheData(&type, sizeof(type));
+  for (size_t hash : shaderHashes) {
+    const auto value = static_cast<uint64_t>(hash);
+    key = hashCacheData(&value, sizeof(value), key);
+  }
+  return key;
+}
+
+} // namespace
+
 ShaderStages::ShaderStages(const ShaderStagesDesc& desc, IContext& context) :
   IShaderStages(desc), WithContext(context), programID_(0) {}
 
@@ -58,15 +129,39 @@ void ShaderStages::createRenderProgram(Result* result) {
     return;
   }
 
+  if (getContext().getPackedUniformRing()) {
+    const GLuint packedProgramID = createPackedRenderProgram(vertexShader, fragmentShader);
+    if (packedProgramID != 0) {
+      setProgram(packedProgramID);
+      packedUniforms_ = PackedUniformBlock::create(getContext(), programID_);
+      Result::setResult(result, Result::Code::Ok);
+      return;
+    }
+  }
+
+  const uint64_t programKey = getProgramKey(
+      getType(), {vertexShader.getHash(), fragmentShader.getHash()});
+
   // always create a new temp program ID
   // we'll set or update this object's program ID after the linking succeeds
   // otherwise we won't modify this program, so we can still use it
-  GLuint programID = getContext().createProgram();
+  GLuint programID = createProgramFromCache(programKey);
+  if (programID != 0) {
+    setProgram(programID);
+    Result::setResult(result, Result::Code::Ok);
+    return;
+  }
+  programID = getContext().createProgram();
   if (programID == 0) {
     Result::setResult(result, Result::Code::RuntimeError, "Failed to create GL program");
     return;
   }
 
+  ProgramBinaryCache* programBinaryCache = getContext().getProgramBinaryCache();
+  if (programBinaryCache) {
+    programBinaryCache->prepareProgram(programID);
+  }
+
   // attach the shaders and link them
   getContext().attachShader(programID, vertexShaderID);
   getContext().attachShader(programID, fragmentShaderID);
@@ -76,34 +171,92 @@ void ShaderStages::createRenderProgram(Result* result) {
   getContext().detachShader(programID, vertexShaderID);
   getContext().detachShader(programID, fragmentShaderID);
 
-  // check to see if the linking succeeded
-  GLint status;
-  getContext().getProgramiv(programID, GL_LINK_STATUS, &status);
-  if (status == GL_FALSE) {
-    // Get the size of log
-    GLsizei logSize = 0;
-    getContext().getProgramiv(programID, GL_INFO_LOG_LENGTH, &logSize);
+  completeProgram(programID, programKey, result);
+}
 
-    // Pre-allocate vector for storage
-    std::vector<GLchar> log(logSize);
-    getContext().getProgramInfoLog(programID, logSize, nullptr, log.data());
+GLuint ShaderStages::createPackedRenderProgram(const ShaderModule& vertexShader,
+                                               const ShaderModule& fragmentShader) {
+  std::string vertexSource = vertexShader.getSource();
+  std::string fragmentSource = fragmentShader.getSource();
+  if (vertexSource.empty() || fragmentSource.empty() ||
+      !PackedUniformBlock::packShaderSources(vertexSource, fragmentSource)) {
+    return 0;
+  }
 
-    // Create actual string from it
-    const std::string errorLog(log.begin(), log.end());
-    IGL_LOG_ERROR("failed to link shaders:\n%s\n", errorLog.c_str());
+  // packed programs are cached separately from programs linked from the original shaders
+  constexpr size_t kPackedUniformsKey = 0x5041434b; // "PACK"
+  const uint64_t programKey = getProgramKey(
+      getType(), {vertexShader.getHash(), fragmentShader.getHash(), kPackedUniformsKey});
 
-    getContext().deleteProgram(programID);
-    Result::setResult(result, Result::Code::RuntimeError, errorLog);
-    return;
+  GLuint programID = createProgramFromCache(programKey);
+  if (programID != 0) {
+    return programID;
   }
 
-  // now that the program successfully linked, set the program
-  if (programID_ != 0) {
-    getContext().deleteProgram(programID_);
+  // the packed shaders are compiled and linked synchronously, so that a failure can fall back to
+  // the original shaders
+  const GLuint vertexShaderID = compilePackedShader(GL_VERTEX_SHADER, vertexSource);
+  const GLuint fragmentShaderID =
+      vertexShaderID != 0 ? compilePackedShader(GL_FRAGMENT_SHADER, fragmentSource) : 0;
+
+  if (vertexShaderID != 0 && fragmentShaderID != 0) {
+    programID = getContext().createProgram();
+  }
+
+  if (programID != 0) {
+    ProgramBinaryCache* programBinaryCache = getContext().getProgramBinaryCache();
+    if (programBinaryCache) {
+      programBinaryCache->prepareProgram(programID);
+    }
+
+    getContext().attachShader(programID, vertexShaderID);
+    getContext().attachShader(programID, fragmentShaderID);
+    getContext().linkProgram(programID);
+    getContext().detachShader(programID, vertexShaderID);
+    getContext().detachShader(programID, fragmentShaderID);
+
+    GLint status = GL_FALSE;
+    getContext().getProgramiv(programID, GL_LINK_STATUS, &status);
+    if (status == GL_FALSE) {
+      getContext().deleteProgram(programID);
+      programID = 0;
+    } else if (programBinaryCache) {
+      programBinaryCache->storeProgram(programKey, programID);
+    }
+  }
+
+  if (vertexShaderID != 0) {
+    getContext().deleteShader(vertexShaderID);
+  }
+  if (fragmentShaderID != 0) {
+    getContext().deleteShader(fragmentShaderID);
+  }
+
+  if (programID == 0) {
+    IGL_LOG_INFO("Cannot pack the uniforms of a program, using the original shaders\n");
+  }
+
+  return programID;
+}
+
+GLuint ShaderStages::compilePackedShader(GLenum shaderType, const std::string& source) {
+  const GLuint shaderID = getContext().createShader(shaderType);
+  if (shaderID == 0) {
+    return 0;
   }
-  programID_ = programID;
 
-  Result::setResult(result, Result::Code::Ok);
+  const GLchar* src = source.c_str();
+  getContext().shaderSource(shaderID, 1, &src, nullptr);
+  getContext().compileShader(shaderID);
+
+  GLint status = GL_FALSE;
+  getContext().getShaderiv(shaderID, GL_COMPILE_STATUS, &status);
+  if (status == GL_FALSE) {
+    getContext().deleteShader(shaderID);
+    return 0;
+  }
+
+  return shaderID;
 }
 
 void ShaderStages::createComputeProgram(Result* result) {
@@ -123,15 +276,28 @@ void ShaderStages::createComputeProgram(Result* result) {
     return;
   }
 
+  const uint64_t programKey = getProgramKey(getType(), {shader.getHash()});
+
   // always create a new temp program ID
   // we'll set or update this object's program ID after the linking succeeds
   // otherwise we won't modify this program, so we can still use it
-  GLuint programID = getContext().createProgram();
+  GLuint programID = createProgramFromCache(programKey);
+  if (programID != 0) {
+    setProgram(programID);
+    Result::setResult(result, Result::Code::Ok);
+    return;
+  }
+  programID = getContext().createProgram();
   if (programID == 0) {
     Result::setResult(result, Result::Code::RuntimeError, "Failed to create compute GL program");
     return;
   }
 
+  ProgramBinaryCache* programBinaryCache = getContext().getProgramBinaryCache();
+  if (programBinaryCache) {
+    programBinaryCache->prepareProgram(programID);
+  }
+
   // attach the shaders and link them
   getContext().attachShader(programID, shaderID);
   getContext().linkProgram(programID);
@@ -139,6 +305,23 @@ void ShaderStages::createComputeProgram(Result* result) {
   // detach the shaders now that they've been linked
   getContext().detachShader(programID, shaderID);
 
+  completeProgram(programID, programKey, result);
+}
+
+void ShaderStages::completeProgram(GLuint programID, uint64_t programKey, Result* result) {
+  if (getContext().deviceFeatures().hasExtension(Extensions::ParallelShaderCompile)) {
+    // the driver compiles and links in the background, the status is checked by finishLink()
+    setProgram(programID);
+    programKey_ = programKey;
+    isLinkPending_ = true;
+    Result::setResult(result, Result::Code::Ok);
+    return;
+  }
+
+  Result::setResult(result, checkLinkStatus(programID, programKey));
+}
+
+Result ShaderStages::checkLinkStatus(GLuint programID, uint64_t programKey) {
   // check to see if the linking succeeded
   GLint status;
   getContext().getProgramiv(programID, GL_LINK_STATUS, &status);
@@ -152,21 +335,133 @@ void ShaderStages::createComputeProgram(Result* result) {
     getContext().getProgramInfoLog(programID, logSize, nullptr, log.data());
 
     // Create actual string from it
-    const std::string errorLog(log.begin(), log.end());
-    IGL_LOG_ERROR("failed to link compute shaders:\n%s\n", errorLog.c_str());
+    std::string errorLog(log.begin(), log.end());
+
+    // with parallel compilation, a failed compilation is only noticed when linking
+    for (const auto& module : {getVertexModule(), getFragmentModule(), getComputeModule()}) {
+      if (module) {
+        Result compileResult = static_cast<ShaderModule&>(*module).getCompileResult();
+        if (!compileResult.isOk()) {
+          errorLog = compileResult.message;
+          break;
+        }
+      }
+    }
+
+    IGL_LOG_ERROR("failed to link %sshaders:\n%s\n",
+                  getType() == ShaderStagesType::Compute ? "compute " : "",
+                  errorLog.c_str());
 
     getContext().deleteProgram(programID);
-    Result::setResult(result, Result::Code::RuntimeError, errorLog);
-    return;
+    return Result(Result::Code::RuntimeError, errorLog);
+  }
+
+  ProgramBinaryCache* programBinaryCache = getContext().getProgramBinaryCache();
+  if (programBinaryCache) {
+    programBinaryCache->storeProgram(programKey, programID);
   }
 
   // now that the program successfully linked, set the program
+  setProgram(programID);
+
+  return Result();
+}
+
+bool ShaderStages::isLinkComplete() const {
+  if (!isLinkPending_) {
+    return true;
+  }
+  GLint status = GL_FALSE;
+  getContext().getProgramiv(programID_, GL_COMPLETION_STATUS_KHR, &status);
+  return status == GL_TRUE;
+}
+
+Result ShaderStages::finishLink() {
+  if (isLinkPending_) {
+    isLinkPending_ = false;
+    const GLuint programID = programID_;
+    programID_ = 0;
+    linkResult_ = checkLinkStatus(programID, programKey_);
+  }
+  return linkResult_;
+}
+
+GLuint ShaderStages::createProgramFromCache(uint64_t programKey) {
+  ProgramBinaryCache* programBinaryCache = getContext().getProgramBinaryCache();
+  if (!programBinaryCache) {
+    return 0;
+  }
+
+  GLuint programID = getContext().createProgram();
+  if (programID != 0 && !programBinaryCache->loadProgram(programKey, programID)) {
+    // a program which failed to load a binary is linked from source as a new program
+    getContext().deleteProgram(programID);
+    programID = 0;
+  }
+
+  return programID;
+}
+
+void ShaderStages::setProgram(GLuint programID) {
   if (programID_ != 0) {
     getContext().deleteProgram(programID_);
   }
   programID_ = programID;
+  packedUniforms_ = nullptr;
+  hasCheckedBindlessTextures_ = false;
+  usesBindlessTextures_ = false;
+  hasCheckedPushConstants_ = false;
+  usesPushConstants_ = false;
+  uniformShadows_.clear();
+  uniformShadowData_.clear();
+}
+
+bool ShaderStages::usesBindlessTextures() {
+  if (!hasCheckedBindlessTextures_ && programID_ != 0) {
+    hasCheckedBindlessTextures_ = true;
+    usesBindlessTextures_ = getContext().getBindlessTextureRing() != nullptr &&
+                            BindlessTextureBlock::assignBinding(getContext(), programID_);
+  }
+  return usesBindlessTextures_;
+}
 
-  Result::setResult(result, Result::Code::Ok);
+bool ShaderStages::usesPushConstants() {
+  if (!hasCheckedPushConstants_ && programID_ != 0) {
+    hasCheckedPushConstants_ = true;
+    usesPushConstants_ = getContext().deviceFeatures().hasFeature(DeviceFeatures::UniformBlocks) &&
+                         PushConstantBlock::assignBinding(getContext(), programID_);
+  }
+  return usesPushConstants_;
+}
+
+bool ShaderStages::updateUniformShadow(GLint location, const void* data, size_t size) {
+  // locations are assigned by the driver and are usually small, don't shadow unusual ones
+  constexpr GLint kMaxShadowedLocation = 4096;
+  if (location < 0 || location >= kMaxShadowedLocation || !data || size == 0) {
+    return true;
+  }
+
+  if (static_cast<size_t>(location) >= uniformShadows_.size()) {
+    uniformShadows_.resize(static_cast<size_t>(location) + 1);
+  }
+
+  UniformShadow& shadow = uniformShadows_[location];
+  const auto* bytes = static_cast<const uint8_t*>(data);
+
+  if (shadow.size == size &&
+      std::memcmp(uniformShadowData_.data() + shadow.offset, bytes, size) == 0) {
+    return false;
+  }
+
+  if (size > shadow.capacity) {
+    shadow.offset = uniformShadowData_.size();
+    shadow.capacity = size;
+    uniformShadowData_.resize(uniformShadowData_.size() + size);
+  }
+  shadow.size = size;
+  std::memcpy(uniformShadowData_.data() + shadow.offset, bytes, size);
+
+  return true;
 }
 
 // link the given shaders into this shader program
@@ -184,6 +479,9 @@ Result ShaderStages::create(const ShaderStagesDesc& /*desc*/) {
 }
 
 void ShaderStages::bind() {
+  if (isLinkPending_) {
+    finishLink();
+  }
   getContext().useProgram(programID_);
 }
 
@@ -239,8 +537,28 @@ Result ShaderModule::create(const ShaderModuleDesc& desc) {
   GLuint shaderID = getContext().createShader(shaderType_);
 
   // compile the shader
+  std::string specializedSource;
   const GLchar* src = (GLchar*)desc.input.source;
 
+  // like the Vulkan backend, shaders without a header get the bindless declarations prepended
+  std::string bindlessSource;
+  if (getContext().getBindlessTextureRing() && shaderType_ != GL_COMPUTE_SHADER &&
+      std::strstr(src, "#version") == nullptr) {
+    bindlessSource = BindlessTextureBlock::getShaderPrologue(desc.info.stage) + src;
+    src = bindlessSource.c_str();
+  }
+
+  if (!desc.info.specializationConstants.empty()) {
+    specializedSource = injectSpecializationConstants(src, desc.info.specializationConstants);
+    src = specializedSource.c_str();
+  }
+
+  if (getContext().getPackedUniformRing()) {
+    source_ = src;
+  } else {
+    source_.clear();
+  }
+
 #if IGL_SHADER_DUMP
   auto hash = std::hash<const GLchar*>()(src);
   std::string shaderStageExt;
@@ -272,6 +590,19 @@ Result ShaderModule::create(const ShaderModuleDesc& desc) {
   getContext().shaderSource(shaderID, 1, &src, nullptr);
   getContext().compileShader(shaderID);
 
+  // the hash covers the injected specialization constants
+  hash_ = std::hash<std::string_view>()(std::string_view(src, strlen(src)));
+
+  if (getContext().deviceFeatures().hasExtension(Extensions::ParallelShaderCompile)) {
+    // querying the status would wait for the compiler, leave it to getCompileResult()
+    if (shaderID_ != 0) {
+      getContext().deleteShader(shaderID_);
+    }
+    shaderID_ = shaderID;
+    isCompilePending_ = true;
+    return Result();
+  }
+
   // see if the compilation succeeded
   GLint status;
   getContext().getShaderiv(shaderID, GL_COMPILE_STATUS, &status);
@@ -304,10 +635,33 @@ Result ShaderModule::create(const ShaderModuleDesc& desc) {
   }
   shaderID_ = shaderID;
 
-  hash_ =
-      std::hash<std::string_view>()(std::string_view(desc.input.source, strlen(desc.input.source)));
-
   return Result();
 }
+
+Result ShaderModule::getCompileResult() {
+  if (!isCompilePending_) {
+    return compileResult_;
+  }
+  isCompilePending_ = false;
+
+  GLint status;
+  getContext().getShaderiv(shaderID_, GL_COMPILE_STATUS, &status);
+  if (status == GL_FALSE) {
+    GLsizei logSize = 0;
+    getContext().getShaderiv(shaderID_, GL_INFO_LOG_LENGTH, &logSize);
+
+    std::vector<GLchar> log(logSize);
+    getContext().getShaderInfoLog(shaderID_, logSize, nullptr, log.data());
+
+    const std::string errorLog(log.begin(), log.end());
+    IGL_LOG_ERROR("failed to compile %s shader:\n%s\n",
+                  (shaderType_ == GL_VERTEX_SHADER ? "vertex" : "fragment"),
+                  errorLog.c_str());
+
+    compileResult_ = Result(Result::Code::ArgumentInvalid, errorLog);
+  }
+
+  return compileResult_;
+}
 } // namespace opengl
 } // namespace igl
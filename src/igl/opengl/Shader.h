@@ -14,7 +14,11 @@
 #include <igl/Shader.h>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/IContext.h>
+#include <igl/opengl/PackedUniformBlock.h>
+#include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace igl {
 class ICommandBuffer;
@@ -39,6 +43,17 @@ class ShaderModule : public WithContext, public IShaderModule {
     return hash_;
   }
 
+  /// With parallel shader compilation (GL_KHR_parallel_shader_compile), create() does not wait
+  /// for the compiler, and compile errors are reported here instead. Blocks until the compiler is
+  /// done.
+  Result getCompileResult();
+
+  /// The GLSL source including specialization constants. Only kept while packed uniforms are
+  /// enabled, see IContext::enablePackedUniforms(), otherwise empty
+  const std::string& getSource() const {
+    return source_;
+  }
+
   ShaderModule(IContext& context, ShaderModuleInfo info);
 
  private:
@@ -50,6 +65,11 @@ class ShaderModule : public WithContext, public IShaderModule {
 
   // Hash of the shader source
   size_t hash_ = 0;
+
+  bool isCompilePending_ = false;
+  Result compileResult_;
+
+  std::string source_;
 };
 
 class ShaderStages final : public IShaderStages, public WithContext {
@@ -68,12 +88,71 @@ class ShaderStages final : public IShaderStages, public WithContext {
     return programID_;
   }
 
+  /// With parallel shader compilation (GL_KHR_parallel_shader_compile), create() does not wait
+  /// for the driver to link the program. Returns false while the driver is still working on it
+  bool isLinkComplete() const;
+  /// Waits until the program is linked and returns the compile or link errors. The program can
+  /// only be used after this call; bind() and pipeline creation call it implicitly
+  Result finishLink();
+
+  /// Returns nullptr unless the program was linked with packed uniforms, see
+  /// IContext::enablePackedUniforms()
+  PackedUniformBlock* getPackedUniforms() const {
+    return packedUniforms_.get();
+  }
+
+  /// Returns true if the linked program declares the block of BindlessTextureBlock while
+  /// bindless textures are enabled, see IContext::enableBindlessTextures(). Assigns the binding
+  /// of the block on the first call
+  bool usesBindlessTextures();
+
+  /// Returns true if the linked program declares the block of PushConstantBlock. Assigns the
+  /// binding of the block on the first call
+  bool usesPushConstants();
+
+  /// Records `size` bytes of `data` as the value of the uniform at `location`. Returns false if
+  /// the program already holds this value, so the glUniform*() call can be skipped. GL keeps
+  /// uniform values per program, which is why the shadow copy lives here and not in the pipeline
+  /// states sharing this program
+  bool updateUniformShadow(GLint location, const void* data, size_t size);
+
  private:
   void createRenderProgram(Result* result);
   void createComputeProgram(Result* result);
+  // Returns 0 if the program binary cache has no usable binary for `programKey`
+  GLuint createProgramFromCache(uint64_t programKey);
+  void completeProgram(GLuint programID, uint64_t programKey, Result* result);
+  Result checkLinkStatus(GLuint programID, uint64_t programKey);
+  void setProgram(GLuint programID);
+  // Returns 0 if the shaders have nothing to pack or the packed shaders fail to compile or link
+  GLuint createPackedRenderProgram(const ShaderModule& vertexShader,
+                                   const ShaderModule& fragmentShader);
+  GLuint compilePackedShader(GLenum shaderType, const std::string& source);
 
   // the GL shader program ID
   GLuint programID_;
+
+  // the link status has not been checked yet, see finishLink()
+  bool isLinkPending_ = false;
+  uint64_t programKey_ = 0;
+  Result linkResult_;
+
+  std::unique_ptr<PackedUniformBlock> packedUniforms_;
+  // usesBindlessTextures() has looked for the block of the current program
+  bool hasCheckedBindlessTextures_ = false;
+  bool usesBindlessTextures_ = false;
+  // usesPushConstants() has looked for the block of the current program
+  bool hasCheckedPushConstants_ = false;
+  bool usesPushConstants_ = false;
+
+  struct UniformShadow {
+    size_t offset = 0;
+    size_t size = 0;
+    size_t capacity = 0;
+  };
+  // indexed by uniform location, the values are stored in uniformShadowData_
+  std::vector<UniformShadow> uniformShadows_;
+  std::vector<uint8_t> uniformShadowData_;
 };
 
 } // namespace opengl
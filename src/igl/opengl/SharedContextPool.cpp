@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/SharedContextPool.h>
+
+#include <igl/opengl/DestructionGuard.h>
+#include <igl/opengl/IContext.h>
+#include <optional>
+
+namespace igl {
+namespace opengl {
+
+SharedContextPool::SharedContextPool(std::shared_ptr<IContext> mainContext,
+                                     std::vector<std::shared_ptr<IContext>> workerContexts) :
+  mainContext_(std::move(mainContext)), workerContexts_(std::move(workerContexts)) {
+  IGL_ASSERT(mainContext_);
+  // a context can only be current on one thread
+  mainContext_->setCurrent();
+
+  workers_.reserve(workerContexts_.size());
+  for (const auto& context : workerContexts_) {
+    if (IGL_VERIFY(context)) {
+      workers_.emplace_back([this, context]() { workerLoop(context); });
+    }
+  }
+}
+
+SharedContextPool::~SharedContextPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    if (!mainContext_->isDestructionAllowed()) {
+      // the sharegroup is being torn down, drop the uploads which did not start yet
+      pendingJobs_.clear();
+    }
+  }
+  jobAvailable_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+
+  if (mainContext_->isDestructionAllowed()) {
+    for (const auto& [jobId, fence] : completedJobs_) {
+      mainContext_->deleteSync(fence);
+    }
+  }
+  completedJobs_.clear();
+}
+
+SharedContextPool::JobId SharedContextPool::enqueue(Job job) {
+  JobId jobId = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobId = nextJobId_++;
+    pendingJobs_.emplace_back(jobId, std::move(job));
+    outstandingJobs_.insert(jobId);
+  }
+  jobAvailable_.notify_one();
+  return jobId;
+}
+
+size_t SharedContextPool::syncCompletedJobs() {
+  IGL_ASSERT(mainContext_->isCurrentContext());
+
+  std::vector<std::pair<JobId, GLsync>> completedJobs;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    completedJobs.swap(completedJobs_);
+  }
+
+  for (const auto& [jobId, fence] : completedJobs) {
+    if (fence != nullptr) {
+      // the GPU of the main context waits, the CPU doesn't
+      mainContext_->waitSync(fence, 0, GL_TIMEOUT_IGNORED);
+      mainContext_->deleteSync(fence);
+    }
+  }
+
+  if (!completedJobs.empty()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& completedJob : completedJobs) {
+      outstandingJobs_.erase(completedJob.first);
+    }
+  }
+  return completedJobs.size();
+}
+
+bool SharedContextPool::isJobVisible(JobId jobId) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return jobId != 0 && jobId < nextJobId_ && outstandingJobs_.count(jobId) == 0;
+}
+
+void SharedContextPool::waitIdle() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  jobFinished_.wait(lock, [this]() { return pendingJobs_.empty() && numRunningJobs_ == 0; });
+}
+
+void SharedContextPool::workerLoop(const std::shared_ptr<IContext>& context) {
+  context->setCurrent();
+
+  while (true) {
+    std::pair<JobId, Job> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      jobAvailable_.wait(lock, [this]() { return stopping_ || !pendingJobs_.empty(); });
+      if (pendingJobs_.empty()) {
+        break;
+      }
+      job = std::move(pendingJobs_.front());
+      pendingJobs_.pop_front();
+      numRunningJobs_++;
+    }
+
+    {
+      // Deletions are disabled on the main context while its owner holds a DestructionGuard, and
+      // must be on the worker contexts of the same sharegroup as well
+      std::optional<DestructionGuard> guard;
+      if (!mainContext_->isDestructionAllowed()) {
+        guard.emplace(context);
+      }
+      job.second(*context);
+    }
+
+    // The fence has to reach the GPU before another context can wait for it
+    GLsync fence = context->fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    context->flush();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      completedJobs_.emplace_back(job.first, fence);
+      numRunningJobs_--;
+    }
+    jobFinished_.notify_all();
+  }
+
+  context->clearCurrentContext();
+}
+
+} // namespace opengl
+} // namespace igl
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <igl/opengl/GLIncludes.h>
+
+namespace igl {
+namespace opengl {
+
+class IContext;
+
+/**
+ * @brief Runs GL jobs, such as texture uploads and shader compilation, on background threads so
+ * that they don't stall the render thread. Each worker thread owns one of the given contexts, which
+ * must share objects with the main context, e.g. egl::Context::createOffscreenShareContext().
+ *
+ * A job only writes GL objects through the context it is given. Once it returns, the worker
+ * inserts a fence, and syncCompletedJobs() makes the main context wait for it on the GPU
+ * (glWaitSync) before the main context uses the objects written by the job.
+ *
+ * While the owner of the main context holds a DestructionGuard, jobs run with deletions disabled on
+ * their context as well, and destroying the pool drops the jobs which did not start, since the
+ * sharegroup is being torn down.
+ */
+class SharedContextPool final {
+ public:
+  using Job = std::function<void(IContext& context)>;
+  using JobId = uint64_t;
+
+  /// The worker contexts may be current on the calling thread, which must also be the main context
+  /// thread. The main context is made current again once they have been handed to the workers.
+  SharedContextPool(std::shared_ptr<IContext> mainContext,
+                    std::vector<std::shared_ptr<IContext>> workerContexts);
+  /// Waits for the running jobs. Must be called on the main context thread.
+  ~SharedContextPool();
+
+  SharedContextPool(const SharedContextPool&) = delete;
+  SharedContextPool& operator=(const SharedContextPool&) = delete;
+
+  /// Queues `job` to run on the next idle worker. Can be called from any thread.
+  JobId enqueue(Job job);
+
+  /// Makes the results of the jobs which finished running usable on the main context, without
+  /// blocking the CPU. Must be called on the main context thread, typically once per frame.
+  /// Returns the number of jobs made visible.
+  size_t syncCompletedJobs();
+
+  /// Returns true once syncCompletedJobs() has made the results of `jobId` visible
+  [[nodiscard]] bool isJobVisible(JobId jobId) const;
+
+  /// Blocks until every queued job has finished running on a worker
+  void waitIdle();
+
+  [[nodiscard]] size_t getNumWorkers() const {
+    return workers_.size();
+  }
+
+ private:
+  void workerLoop(const std::shared_ptr<IContext>& context);
+
+  std::shared_ptr<IContext> mainContext_;
+  std::vector<std::shared_ptr<IContext>> workerContexts_;
+  std::vector<std::thread> workers_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable jobAvailable_;
+  std::condition_variable jobFinished_;
+  std::deque<std::pair<JobId, Job>> pendingJobs_;
+  // fences of the jobs which finished running, in completion order
+  std::vector<std::pair<JobId, GLsync>> completedJobs_;
+  // jobs which have not been made visible on the main context yet
+  std::unordered_set<JobId> outstandingJobs_;
+  size_t numRunningJobs_ = 0;
+  JobId nextJobId_ = 1;
+  bool stopping_ = false;
+};
+
+} // namespace opengl
+} // namespace igl
@@ -14,6 +14,7 @@
 namespace igl {
 class ICommandBuffer;
 namespace opengl {
+class SamplerState;
 
 // Texture is the base class for the OpenGL backend. It represents:
 // 1. traditional textures (sampled/output by shaders)
@@ -38,6 +39,11 @@ class Texture : public WithContext, public ITexture {
   size_t getNumMipLevels() const override;
   bool isRequiredGenerateMipmap() const override;
   uint64_t getTextureId() const override;
+  // Returns the resident bindless handle of this texture combined with `samplerState`, or the one
+  // of getTextureId() if `samplerState` is null. Returns 0 if the texture cannot be sampled
+  virtual uint64_t getBindlessHandle(SamplerState* /*samplerState*/) const {
+    return 0;
+  }
 
   virtual Result create(const TextureDesc& desc, bool hasStorageAlready);
 
@@ -8,6 +8,9 @@
 #include <igl/opengl/TextureBuffer.h>
 
 #include <igl/opengl/Errors.h>
+#include <cstring>
+#include <igl/opengl/PixelUnpackBufferRing.h>
+#include <igl/opengl/SamplerState.h>
 #include <utility>
 
 namespace igl {
@@ -46,6 +49,9 @@ TextureBuffer::~TextureBuffer() {
     if (textureHandle_ != 0) {
       getContext().makeTextureHandleNonResident(textureHandle_);
     }
+    for (const auto& samplerHandle : samplerHandles_) {
+      getContext().makeTextureHandleNonResident(samplerHandle.second);
+    }
     getContext().deleteTextures({textureID});
   }
 }
@@ -59,6 +65,28 @@ uint64_t TextureBuffer::getTextureId() const {
   return textureHandle_;
 }
 
+uint64_t TextureBuffer::getBindlessHandle(SamplerState* samplerState) const {
+  if (!samplerState) {
+    return getTextureId();
+  }
+  // samplers with the same state share handles, GL keeps a sampler object alive while handles
+  // use it
+  const size_t samplerHash = samplerState->getHash();
+  for (const auto& samplerHandle : samplerHandles_) {
+    if (samplerHandle.first == samplerHash) {
+      return samplerHandle.second;
+    }
+  }
+  const uint64_t handle =
+      getContext().getTextureSamplerHandle(getId(), samplerState->getSamplerObject());
+  if (!IGL_VERIFY(handle != 0)) {
+    return 0;
+  }
+  getContext().makeTextureHandleResident(handle);
+  samplerHandles_.emplace_back(samplerHash, handle);
+  return handle;
+}
+
 // create a 2D texture given the specified dimensions and format
 Result TextureBuffer::create(const TextureDesc& desc, bool hasStorageAlready) {
   Result result = Super::create(desc, hasStorageAlready);
@@ -97,7 +125,13 @@ Result TextureBuffer::createTexture(const TextureDesc& desc) {
     return Result(Result::Code::Unsupported, "Unsupported texture target");
   }
 
-  if (!toFormatDescGL(desc.format, desc.usage, formatDescGL_)) {
+  // Immutable storage is preferred whenever the format supports it, since drivers have to validate
+  // and may reallocate textures whose levels are defined one by one with glTexImage*. Requesting
+  // it makes toFormatDescGL() pick a sized internal format.
+  immutableStorage_ = canUseTexStorage(desc);
+  const auto usage = immutableStorage_ ? desc.usage | TextureDesc::TextureUsageBits::Storage
+                                       : desc.usage;
+  if (!toFormatDescGL(desc.format, usage, formatDescGL_)) {
     // can't create a texture with the given format
     return Result(Result::Code::ArgumentInvalid, "Invalid texture format");
   }
@@ -125,18 +159,24 @@ Result TextureBuffer::createTexture(const TextureDesc& desc) {
     // No further initialization needed for external image textures
     return Result{};
   } else {
-    return initialize();
+    if (desc.initialData && desc.numMipLevels != getNumMipLevels()) {
+      // ES 2.0 allocates the full mip chain, see Texture::create()
+      return Result(Result::Code::Unsupported, "Initial data requires a full mip chain");
+    }
+    return initialize(desc.initialData);
   }
 }
 
-Result TextureBuffer::initialize() const {
+Result TextureBuffer::initialize(const void* initialData) const {
   const auto target = getTarget();
   if (target == 0) {
     return Result{Result::Code::InvalidOperation, "Unknown texture type"};
   }
   getContext().bindTexture(target, getId());
   setMaxMipLevel();
-  if (getNumMipLevels() == 1) { // Change default min filter to ensure mipmapping is disabled
+  // Change default min filter to ensure mipmapping is disabled. Multisample textures have no
+  // sampler state.
+  if (getNumMipLevels() == 1 && getSamples() <= 1) {
     getContext().texParameteri(target, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
   }
   if (!getProperties().isCompressed()) {
@@ -150,11 +190,35 @@ Result TextureBuffer::initialize() const {
       result = initializeWithTexStorage();
     }
   }
+  if (result.isOk() && initialData) {
+    result = uploadInitialData(initialData);
+  }
 
   getContext().bindTexture(getTarget(), 0);
   return result;
 }
 
+Result TextureBuffer::uploadInitialData(const void* data) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_UPLOAD);
+
+  const auto target = getTarget();
+  const auto regions = getInitialDataRegions(data);
+  for (const auto& region : regions) {
+    Result result;
+    if (target == GL_TEXTURE_CUBE_MAP) {
+      // the layers of cube textures are their faces
+      getContext().pixelStorei(GL_UNPACK_ALIGNMENT, getAlignment(0, region.range.mipLevel));
+      result = upload2D(sCubeFaceTargets[region.range.layer], region.range.atLayer(0), region.data);
+    } else {
+      result = upload(target, region.range, region.data);
+    }
+    if (!result.isOk()) {
+      return result;
+    }
+  }
+  return Result{};
+}
+
 Result TextureBuffer::initializeWithUpload() const {
   const auto target = getTarget();
   for (size_t i = 0; i < getNumMipLevels(); ++i) {
@@ -172,6 +236,15 @@ Result TextureBuffer::initializeWithTexStorage() const {
   const auto target = getTarget();
   switch (getType()) {
   case TextureType::TwoD:
+    if (getSamples() > 1) {
+      getContext().texStorage2DMultisample(target,
+                                           (GLsizei)getSamples(),
+                                           glInternalFormat_,
+                                           (GLsizei)range.width,
+                                           (GLsizei)range.height,
+                                           GL_TRUE);
+      break;
+    }
     getContext().texStorage2D(
         target, range.numMipLevels, glInternalFormat_, (GLsizei)range.width, (GLsizei)range.height);
     break;
@@ -518,6 +591,8 @@ Result TextureBuffer::upload3D(GLenum target,
 Result TextureBuffer::upload(const TextureRangeDesc& range,
                              const void* data,
                              size_t bytesPerRow) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_UPLOAD);
+
   if (data == nullptr) {
     return Result{};
   }
@@ -527,12 +602,114 @@ Result TextureBuffer::upload(const TextureRangeDesc& range,
   }
   getContext().bindTexture(target, getId());
 
-  auto result = upload(target, range, data, bytesPerRow);
+  // stage the data in a pixel unpack buffer, so the driver reads it from there at offset 0
+  auto* ring = getContext().getPixelUnpackBufferRing();
+  const bool isStaged = ring && !getProperties().isCompressed() &&
+                        ring->beginUpload(data, getUploadSize(range, bytesPerRow));
+
+  auto result = upload(target, range, isStaged ? nullptr : data, bytesPerRow);
+
+  if (isStaged) {
+    ring->endUpload();
+  }
 
   getContext().bindTexture(getTarget(), 0);
   return result;
 }
 
+Result TextureBuffer::uploadFromBuffer(GLuint buffer,
+                                       size_t offset,
+                                       const TextureRangeDesc& range,
+                                       size_t bytesPerRow) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_UPLOAD);
+
+  const auto target = getTarget();
+  if (target == 0) {
+    return Result{Result::Code::InvalidOperation, "Unknown texture type"};
+  }
+  if (!getContext().deviceFeatures().hasInternalFeature(InternalFeatures::PixelBufferObject)) {
+    return Result{Result::Code::Unsupported, "Pixel buffer objects are not supported"};
+  }
+  getContext().bindTexture(target, getId());
+  getContext().bindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+
+  // with a pixel unpack buffer bound, the data pointer is an offset into that buffer
+  // NOLINTNEXTLINE(performance-no-int-to-ptr)
+  auto result = upload(target, range, reinterpret_cast<const void*>(offset), bytesPerRow);
+
+  getContext().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  getContext().bindTexture(target, 0);
+  return result;
+}
+
+Result TextureBuffer::uploadRegions(const std::vector<TextureRegionUpload>& regions) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_UPLOAD);
+
+  auto* ring = getContext().getPixelUnpackBufferRing();
+  const auto target = getTarget();
+  if (!ring || getProperties().isCompressed() || target == 0 ||
+      target == GL_TEXTURE_CUBE_MAP) {
+    return ITexture::uploadRegions(regions);
+  }
+
+  // stage all the regions in one pixel unpack buffer, each at an offset aligned for any format
+  constexpr size_t kOffsetAlignment = 16;
+  std::vector<size_t> offsets(regions.size());
+  size_t stagingSize = 0;
+  for (size_t i = 0; i != regions.size(); ++i) {
+    const auto& region = regions[i];
+    if (!region.data) {
+      continue;
+    }
+    offsets[i] = (stagingSize + kOffsetAlignment - 1) / kOffsetAlignment * kOffsetAlignment;
+    stagingSize = offsets[i] + getUploadSize(region.range, region.bytesPerRow);
+  }
+
+  if (stagingSize == 0) {
+    return Result{};
+  }
+
+  getContext().bindTexture(target, getId());
+
+  const bool isStaged = ring->beginUpload(stagingSize, [&](uint8_t* dst) {
+    for (size_t i = 0; i != regions.size(); ++i) {
+      if (regions[i].data) {
+        memcpy(dst + offsets[i],
+               regions[i].data,
+               getUploadSize(regions[i].range, regions[i].bytesPerRow));
+      }
+    }
+  });
+
+  Result result;
+  for (size_t i = 0; i != regions.size() && result.isOk(); ++i) {
+    const auto& region = regions[i];
+    if (!region.data) {
+      continue;
+    }
+    // with a pixel unpack buffer bound, the data pointer is an offset into the buffer
+    const void* data = isStaged ? reinterpret_cast<const void*>(offsets[i]) : region.data;
+    result = upload(target, region.range, data, region.bytesPerRow);
+  }
+
+  if (isStaged) {
+    ring->endUpload();
+  }
+
+  getContext().bindTexture(target, 0);
+  return result;
+}
+
+size_t TextureBuffer::getUploadSize(const TextureRangeDesc& range, size_t bytesPerRow) const {
+  // the number of bytes read by glTexSubImage*(): every row but the last one is padded to
+  // GL_UNPACK_ALIGNMENT
+  const auto alignment = static_cast<size_t>(getAlignment(bytesPerRow, range.mipLevel));
+  const auto pixelBytesPerRow = getProperties().getBytesPerRow(range.width);
+  const auto paddedBytesPerRow = (pixelBytesPerRow + alignment - 1) / alignment * alignment;
+  const auto numRows = range.height * range.depth * range.numLayers;
+  return numRows == 0 ? 0 : paddedBytesPerRow * (numRows - 1) + pixelBytesPerRow;
+}
+
 Result TextureBuffer::upload(GLenum target,
                              const TextureRangeDesc& range,
                              const void* data,
@@ -606,9 +783,22 @@ bool TextureBuffer::canInitialize() const {
 }
 
 bool TextureBuffer::supportsTexStorage() const {
-  return (getUsage() & TextureDesc::TextureUsageBits::Storage) != 0 &&
-         contains(getContext().deviceFeatures().getTextureFormatCapabilities(getFormat()),
-                  ICapabilities::TextureFormatCapabilityBits::Storage);
+  return immutableStorage_;
+}
+
+bool TextureBuffer::canUseTexStorage(const TextureDesc& desc) const {
+  const auto& deviceFeatures = getContext().deviceFeatures();
+  if (desc.type == TextureType::ExternalImage ||
+      !contains(deviceFeatures.getTextureFormatCapabilities(desc.format),
+                ICapabilities::TextureFormatCapabilityBits::Storage)) {
+    return false;
+  }
+  if (desc.numSamples > 1) {
+    // there is no glTexStorage3DMultisample wrapper for multisample arrays
+    return desc.type == TextureType::TwoD &&
+           deviceFeatures.hasInternalFeature(InternalFeatures::TexStorageMultisample);
+  }
+  return true;
 }
 
 } // namespace opengl
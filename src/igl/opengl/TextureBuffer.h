@@ -8,6 +8,8 @@
 #pragma once
 
 #include <igl/opengl/TextureBufferBase.h>
+#include <utility>
+#include <vector>
 
 namespace igl {
 namespace opengl {
@@ -28,14 +30,24 @@ class TextureBuffer : public TextureBufferBase {
                     TextureCubeFace face,
                     const void* data,
                     size_t bytesPerRow = 0) const override;
+  Result uploadRegions(const std::vector<TextureRegionUpload>& regions) const override;
+
+  // Uploads the pixels read by the GPU from `buffer` bound as the pixel unpack buffer, starting
+  // `offset` bytes from its beginning
+  Result uploadFromBuffer(GLuint buffer,
+                          size_t offset,
+                          const TextureRangeDesc& range,
+                          size_t bytesPerRow = 0) const;
 
   // Texture overrides
   Result create(const TextureDesc& desc, bool hasStorageAlready) override;
   void bindImage(size_t unit) override;
   uint64_t getTextureId() const override;
+  uint64_t getBindlessHandle(SamplerState* samplerState) const override;
 
  protected:
-  Result initialize() const;
+  // `initialData` is TextureDesc::initialData, uploaded while the texture is still bound
+  Result initialize(const void* initialData = nullptr) const;
   Result initializeWithUpload() const;
   Result initializeWithTexStorage() const;
   Result upload(GLenum target,
@@ -55,8 +67,17 @@ class TextureBuffer : public TextureBufferBase {
  private:
   Result createTexture(const TextureDesc& desc);
   bool canInitialize() const;
+  Result uploadInitialData(const void* data) const;
   bool supportsTexStorage() const;
+  // whether immutable storage can be allocated for the texture described by desc
+  bool canUseTexStorage(const TextureDesc& desc) const;
+  // the number of bytes read from the data of an uncompressed upload
+  size_t getUploadSize(const TextureRangeDesc& range, size_t bytesPerRow) const;
   mutable uint64_t textureHandle_ = 0;
+  // resident handles combined with sampler objects, by SamplerState::getHash()
+  mutable std::vector<std::pair<size_t, uint64_t>> samplerHandles_;
+  // storage is allocated with glTexStorage* and uploads use glTexSubImage*
+  bool immutableStorage_ = false;
 };
 
 } // namespace opengl
@@ -30,7 +30,9 @@ ulong_t TextureTarget::getUsage() const {
 Result TextureTarget::create(const TextureDesc& desc, bool hasStorageAlready) {
   Result result = Super::create(desc, hasStorageAlready);
   if (result.isOk()) {
-    if (desc.usage & TextureDesc::TextureUsageBits::Attachment) {
+    if (desc.initialData) {
+      result = Result(Result::Code::ArgumentInvalid, "Render buffers cannot have initial data");
+    } else if (desc.usage & TextureDesc::TextureUsageBits::Attachment) {
       result = createRenderBuffer(desc, hasStorageAlready);
     } else {
       result = Result(Result::Code::Unsupported, "invalid usage!");
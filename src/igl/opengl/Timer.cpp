@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/Timer.h>
+
+#include <igl/opengl/IContext.h>
+
+namespace igl {
+namespace opengl {
+
+Timer::Timer(IContext& context) : WithContext(context) {
+  getContext().genQueries(2, queries_);
+}
+
+Timer::~Timer() {
+  getContext().deleteQueries(2, queries_);
+}
+
+void Timer::begin() {
+  getContext().queryCounter(queries_[0], GL_TIMESTAMP);
+  isPending_ = false;
+  hasResults_ = false;
+  elapsedTimeNanos_ = 0;
+}
+
+void Timer::end() {
+  getContext().queryCounter(queries_[1], GL_TIMESTAMP);
+  isPending_ = true;
+}
+
+bool Timer::resultsAvailable() const {
+  if (hasResults_ || !isPending_) {
+    return hasResults_;
+  }
+
+  // the second timestamp is written last, so the first one is available as well
+  GLuint64 available = 0;
+  getContext().getQueryObjectui64v(queries_[1], GL_QUERY_RESULT_AVAILABLE, &available);
+  if (!available) {
+    return false;
+  }
+
+  GLuint64 start = 0;
+  GLuint64 end = 0;
+  getContext().getQueryObjectui64v(queries_[0], GL_QUERY_RESULT, &start);
+  getContext().getQueryObjectui64v(queries_[1], GL_QUERY_RESULT, &end);
+
+  elapsedTimeNanos_ = end > start ? end - start : 0;
+  hasResults_ = true;
+
+  return true;
+}
+
+uint64_t Timer::getElapsedTimeNanos() const {
+  return resultsAvailable() ? elapsedTimeNanos_ : 0;
+}
+
+} // namespace opengl
+} // namespace igl
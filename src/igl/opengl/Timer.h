@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/Timer.h>
+#include <igl/opengl/GLIncludes.h>
+#include <igl/opengl/WithContext.h>
+
+namespace igl {
+namespace opengl {
+
+/**
+ * @brief Measures GPU time using a pair of GL_TIMESTAMP queries. Timestamps are used instead of
+ * GL_TIME_ELAPSED queries because the latter cannot be nested.
+ */
+class Timer final : public WithContext, public ITimer {
+ public:
+  explicit Timer(IContext& context);
+  ~Timer() override;
+
+  [[nodiscard]] bool resultsAvailable() const override;
+  [[nodiscard]] uint64_t getElapsedTimeNanos() const override;
+
+  void begin();
+  void end();
+
+ private:
+  GLuint queries_[2] = {};
+  bool isPending_ = false;
+  mutable bool hasResults_ = false;
+  mutable uint64_t elapsedTimeNanos_ = 0;
+};
+
+} // namespace opengl
+} // namespace igl
@@ -7,6 +7,9 @@
 
 #include <igl/opengl/Buffer.h>
 #include <igl/opengl/Memcpy.h>
+#include <igl/opengl/PackedUniformBlock.h>
+#include <igl/opengl/PackedUniformRing.h>
+#include <igl/opengl/Shader.h>
 #include <igl/opengl/UniformAdapter.h>
 #include <igl/opengl/UniformBuffer.h>
 
@@ -52,6 +55,9 @@ void UniformAdapter::clearUniformBuffers() {
   usedUniformDataBytes_ = 0;
   uniforms_.clear();
   uniformBuffersDirtyMask_ = 0;
+  for (auto& uniformBinding : uniformBufferBindingMap_) {
+    uniformBinding.second.first = nullptr;
+  }
 
 #if IGL_DEBUG
   std::fill(uniformsDirty_.begin(), uniformsDirty_.end(), false);
@@ -65,7 +71,9 @@ void UniformAdapter::setUniform(const UniformDesc& uniformDesc,
   IGL_ASSERT_MSG(location >= 0, "Invalid uniformDesc->location passed to setUniform");
 
   // Early out if any of the parameters are invalid.
-  if (location < 0 || location >= maxUniforms_ || !data) {
+  const bool isLocationValid =
+      location >= 0 && (location < maxUniforms_ || PackedUniformBlock::isPackedLocation(location));
+  if (!isLocationValid || !data) {
     Result::setResult(outResult, Result::Code::ArgumentInvalid);
     IGL_LOG_INFO_ONCE("IGL WARNING: Invalid parameters found for setUniform. Location (%d) \n",
                       location);
@@ -117,12 +125,14 @@ void UniformAdapter::setUniform(const UniformDesc& uniformDesc,
   //
   // Instead, we assert in local dev builds to catch if we're setting uniform block
   // in same location previously set (in either uniform or block) during the draw call.
-  IGL_ASSERT(!uniformsDirty_[location]);
-  uniformsDirty_[location] = true;
+  if (location < maxUniforms_) {
+    IGL_ASSERT(!uniformsDirty_[location]);
+    uniformsDirty_[location] = true;
+  }
 #endif // IGL_DEBUG
 
   IGL_ASSERT(uniforms_.size() < maxUniforms_);
-  uniforms_.emplace_back(uniformDesc, dataOffset);
+  uniforms_.emplace_back(uniformDesc, dataOffset, length);
   Result::setOk(outResult);
 }
 
@@ -135,7 +145,11 @@ void UniformAdapter::setUniformBuffer(const std::shared_ptr<IBuffer>& buffer,
                  "Uniform buffer index is beyond max");
   IGL_ASSERT_MSG(buffer, "invalid buffer passed to setUniformBuffer");
   if (bindingIndex >= 0 && bindingIndex < IGL_UNIFORM_BLOCKS_BINDING_MAX && buffer) {
-    uniformBufferBindingMap_[bindingIndex] = {buffer, offset};
+    auto& uniformBinding = uniformBufferBindingMap_[bindingIndex];
+    if (uniformBinding.first != buffer) {
+      uniformBinding.first = buffer;
+    }
+    uniformBinding.second = offset;
     uniformBuffersDirtyMask_ |= 1 << bindingIndex;
     Result::setOk(outResult);
   } else {
@@ -143,13 +157,27 @@ void UniformAdapter::setUniformBuffer(const std::shared_ptr<IBuffer>& buffer,
   }
 }
 
-void UniformAdapter::bindToPipeline(IContext& context) {
+void UniformAdapter::bindToPipeline(IContext& context, ShaderStages* shaderStages) {
+  PackedUniformBlock* packedUniforms = shaderStages ? shaderStages->getPackedUniforms() : nullptr;
+
   // bind uniforms
   for (const auto& uniform : uniforms_) {
     const auto& uniformDesc = uniform.desc;
     IGL_ASSERT(uniformDesc.location >= 0);
     IGL_ASSERT_MSG(uniformData_.data(), "Uniform data must be non-null");
     auto start = uniformData_.data() + uniform.dataOffset;
+    if (PackedUniformBlock::isPackedLocation(uniformDesc.location)) {
+      IGL_ASSERT_MSG(packedUniforms, "Packed uniform location used with an unpacked program");
+      if (packedUniforms) {
+        packedUniforms->write(uniformDesc, start);
+      }
+      continue;
+    }
+    if (shaderStages &&
+        !shaderStages->updateUniformShadow(uniformDesc.location, start, uniform.length)) {
+      // the program already holds this value
+      continue;
+    }
     if (uniformDesc.numElements > 1 || uniformDesc.type == UniformType::Mat3x3) {
       IGL_ASSERT_MSG(uniformDesc.elementStride > 0,
                      "stride has to be larger than 0 for uniform at offset %zu",
@@ -169,10 +197,22 @@ void UniformAdapter::bindToPipeline(IContext& context) {
   std::fill(uniformsDirty_.begin(), uniformsDirty_.end(), false);
 #endif
 
+  // the packed block is bound on every draw, another program may have used the binding since
+  if (packedUniforms) {
+    if (auto* packedUniformRing = context.getPackedUniformRing()) {
+      packedUniforms->bind(*packedUniformRing);
+    }
+  }
+
   // bind uniform block buffers
   for (size_t bindingIndex = 0; bindingIndex < IGL_UNIFORM_BLOCKS_BINDING_MAX; ++bindingIndex) {
     if (uniformBuffersDirtyMask_ & (1 << bindingIndex)) {
-      auto uniformBinding = uniformBufferBindingMap_.at(bindingIndex);
+      const auto& uniformBinding = uniformBufferBindingMap_.at(bindingIndex);
+      if (static_cast<Buffer&>(*uniformBinding.first).getType() == Buffer::Type::Uniform) {
+        static_cast<UniformBuffer&>(*uniformBinding.first)
+            .bindRange(bindingIndex, uniformBinding.second, nullptr);
+        continue;
+      }
       auto* bufferState = static_cast<UniformBlockBuffer*>(uniformBinding.first.get());
       IGL_ASSERT(bufferState);
       if (uniformBinding.second) {
@@ -17,6 +17,7 @@
 namespace igl {
 namespace opengl {
 class IContext;
+class ShaderStages;
 
 class UniformAdapter {
  public:
@@ -39,15 +40,19 @@ class UniformAdapter {
     return maxUniforms_;
   }
 
-  void bindToPipeline(IContext& context);
+  /// Uploads the pending uniforms into the bound program. Values which `shaderStages` already
+  /// holds are skipped
+  void bindToPipeline(IContext& context, ShaderStages* shaderStages);
 
  private:
   struct UniformState {
     UniformState() = default;
-    UniformState(UniformDesc d, std::ptrdiff_t o) : desc(std::move(d)), dataOffset(o) {}
+    UniformState(UniformDesc d, std::ptrdiff_t o, std::ptrdiff_t l) :
+      desc(std::move(d)), dataOffset(o), length(l) {}
 
     UniformDesc desc;
     std::ptrdiff_t dataOffset = 0;
+    std::ptrdiff_t length = 0;
   };
 
   std::vector<UniformState> uniforms_;
@@ -34,6 +34,11 @@ UniformBuffer::UniformBuffer(IContext& context, BufferDesc::BufferAPIHint reques
 
 UniformBuffer::~UniformBuffer() {
   isDynamic_ = false;
+  if (bufferId_ != 0) {
+    getContext().deleteBuffers(1, &bufferId_);
+    getContext().unbindBuffer(GL_UNIFORM_BUFFER);
+    bufferId_ = 0;
+  }
 }
 
 bool UniformBuffer::initializeCommon(const BufferDesc& desc, Result* outResult) {
@@ -74,6 +79,10 @@ Result UniformBuffer::upload(const void* data, const BufferRange& range) {
 
   checked_memcpy_offset(uniformData_.data(), uniformData_.size(), range.offset, data, range.size);
 
+  if (bufferId_ != 0) {
+    uploadToGpu();
+  }
+
   return Result();
 }
 
@@ -89,7 +98,43 @@ void* UniformBuffer::map(const BufferRange& range, Result* outResult) {
   return uniformData_.data() + range.offset;
 }
 
-void UniformBuffer::unmap() {}
+void UniformBuffer::unmap() {
+  // the data may have been written through the pointer returned by map()
+  if (bufferId_ != 0) {
+    uploadToGpu();
+  }
+}
+
+void UniformBuffer::bindRange(size_t index, size_t offset, Result* outResult) {
+  if (!getContext().deviceFeatures().hasFeature(DeviceFeatures::UniformBlocks)) {
+    static const char* kErrorMsg = "Uniform Blocks are not supported";
+    IGL_REPORT_ERROR_MSG(1, kErrorMsg);
+    Result::setResult(outResult, Result::Code::Unimplemented, kErrorMsg);
+    return;
+  }
+  IGL_ASSERT_MSG(
+      offset < getSizeInBytes(), "Offset is invalid! (%d %d)", offset, getSizeInBytes());
+
+  if (bufferId_ == 0) {
+    getContext().genBuffers(1, &bufferId_);
+    uploadToGpu();
+  }
+  getContext().bindBufferRange(GL_UNIFORM_BUFFER,
+                               (GLuint)index,
+                               bufferId_,
+                               (GLintptr)offset,
+                               getSizeInBytes() - offset);
+  Result::setOk(outResult);
+}
+
+void UniformBuffer::uploadToGpu() {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_UPLOAD);
+
+  // respecifying the whole storage orphans the old one instead of synchronizing with the GPU
+  getContext().bindBuffer(GL_UNIFORM_BUFFER, bufferId_);
+  getContext().bufferData(
+      GL_UNIFORM_BUFFER, uniformData_.size(), uniformData_.data(), GL_STREAM_DRAW);
+}
 
 void UniformBuffer::printUniforms(GLint program) {
   GLint i;
@@ -172,6 +217,12 @@ void UniformBuffer::bindUniform(IContext& context,
     case UniformType::Mat4x4:
       context.uniformMatrix4fv(shaderLocation, count, false, uniformFloats);
       break;
+    case UniformType::Float16:
+    case UniformType::Float16x2:
+    case UniformType::Float16x3:
+    case UniformType::Float16x4:
+      IGL_ASSERT_MSG(false, "Half uniforms are not supported on OpenGL");
+      return;
     case UniformType::Invalid:
       IGL_ASSERT_MSG(false, "Invalid Uniform Type");
       return;
@@ -239,6 +290,12 @@ void UniformBuffer::bindUniformArray(IContext& context,
       primitivesPerElement = 4;
       baseType = UniformBaseType::FloatMatrix;
       break;
+    case UniformType::Float16:
+    case UniformType::Float16x2:
+    case UniformType::Float16x3:
+    case UniformType::Float16x4:
+      IGL_ASSERT_MSG(false, "Half uniforms are not supported on OpenGL");
+      return;
     case UniformType::Invalid:
       IGL_ASSERT_MSG(false, "Invalid Uniform Type");
       return;
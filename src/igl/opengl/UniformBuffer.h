@@ -67,14 +67,26 @@ class UniformBuffer final : public Buffer {
                                size_t numElements,
                                size_t stride);
 
+  // On contexts with uniform blocks (GL 3.1, GLES 3), the buffer can also be bound to a std140
+  // uniform block with bindBuffer(), which binds a GPU copy of the data with one
+  // glBindBufferRange() instead of uploading every member with glUniform*(). The GPU copy is
+  // created on first use. Afterwards every upload() and unmap() respecifies its whole storage with
+  // glBufferData(), so the driver orphans the storage which earlier draws still read instead of
+  // waiting for them.
+  void bindRange(size_t index, size_t offset, Result* outResult);
+
  private:
   bool initializeCommon(const BufferDesc& desc, Result* outResult);
   void printUniforms(GLint program);
+  void uploadToGpu();
 
   // Copy of data from the client
   std::vector<uint8_t> uniformData_;
 
   bool isDynamic_; // TODO: Add support for dynamic uniforms
+
+  // GL_UNIFORM_BUFFER mirroring uniformData_, 0 until the buffer is bound as a uniform block
+  GLuint bufferId_ = 0;
 };
 
 } // namespace opengl
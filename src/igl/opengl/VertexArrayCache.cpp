@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/VertexArrayCache.h>
+
+#include <algorithm>
+#include <functional>
+#include <igl/opengl/IContext.h>
+
+namespace igl {
+namespace opengl {
+
+size_t VertexArrayCache::KeyHasher::operator()(const Key& key) const {
+  size_t hash = 0;
+  hashCombine(hash, key.pipelineId);
+  hashCombine(hash, key.indexBuffer);
+  for (const auto& binding : key.vertexBuffers) {
+    hashCombine(hash, binding.index);
+    hashCombine(hash, binding.buffer);
+    hashCombine(hash, binding.offset);
+  }
+  return hash;
+}
+
+VertexArrayCache::VertexArrayCache(IContext& context, size_t maxSize) :
+  context_(context), maxSize_(maxSize) {}
+
+GLuint VertexArrayCache::find(const Key& key) const {
+  const auto it = entries_.find(key);
+  return it != entries_.end() ? it->second : 0;
+}
+
+GLuint VertexArrayCache::insert(const Key& key) {
+  if (entries_.size() >= maxSize_) {
+    evictIf([](const Key& /*key*/) { return true; });
+  }
+
+  GLuint vertexArray = 0;
+  context_.genVertexArrays(1, &vertexArray);
+  if (vertexArray) {
+    entries_[key] = vertexArray;
+  }
+
+  return vertexArray;
+}
+
+void VertexArrayCache::evictBuffers(GLsizei n, const GLuint* buffers) {
+  if (entries_.empty()) {
+    return;
+  }
+
+  evictIf([n, buffers](const Key& key) {
+    for (GLsizei i = 0; i != n; i++) {
+      if (buffers[i] == 0) {
+        continue;
+      }
+      if (key.indexBuffer == buffers[i] ||
+          std::any_of(key.vertexBuffers.begin(),
+                      key.vertexBuffers.end(),
+                      [buffer = buffers[i]](const auto& binding) {
+                        return binding.buffer == buffer;
+                      })) {
+        return true;
+      }
+    }
+    return false;
+  });
+}
+
+void VertexArrayCache::evictPipeline(uint64_t pipelineId) {
+  evictIf([pipelineId](const Key& key) { return key.pipelineId == pipelineId; });
+}
+
+void VertexArrayCache::destroy() {
+  evictIf([](const Key& /*key*/) { return true; });
+}
+
+template<typename Predicate>
+void VertexArrayCache::evictIf(Predicate predicate) {
+  std::vector<GLuint> vertexArrays;
+
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (predicate(it->first)) {
+      vertexArrays.push_back(it->second);
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  if (!vertexArrays.empty()) {
+    context_.deleteVertexArrays(static_cast<GLsizei>(vertexArrays.size()), vertexArrays.data());
+    generation_++;
+  }
+}
+
+} // namespace opengl
+} // namespace igl
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <igl/opengl/GLIncludes.h>
+#include <unordered_map>
+#include <vector>
+
+namespace igl {
+namespace opengl {
+
+class IContext;
+
+/**
+ * @brief Keeps a vertex array object for every combination of render pipeline, vertex buffer
+ * bindings and index buffer seen by RenderCommandAdapter, so that a repeated combination is set up
+ * with a single glBindVertexArray() instead of re-specifying every vertex attribute.
+ *
+ * Entries referencing a deleted buffer or pipeline are evicted. The destructor makes no GL calls,
+ * call destroy() while the context is still alive.
+ */
+class VertexArrayCache final {
+ public:
+  struct VertexBufferBinding {
+    uint32_t index = 0;
+    GLuint buffer = 0;
+    size_t offset = 0;
+
+    bool operator==(const VertexBufferBinding& other) const {
+      return index == other.index && buffer == other.buffer && offset == other.offset;
+    }
+  };
+
+  struct Key {
+    // see RenderPipelineState::getVertexArrayCacheId()
+    uint64_t pipelineId = 0;
+    GLuint indexBuffer = 0;
+    // every vertex buffer used by the pipeline, ordered by index
+    std::vector<VertexBufferBinding> vertexBuffers;
+
+    bool operator==(const Key& other) const {
+      return pipelineId == other.pipelineId && indexBuffer == other.indexBuffer &&
+             vertexBuffers == other.vertexBuffers;
+    }
+  };
+
+  struct KeyHasher {
+    size_t operator()(const Key& key) const;
+  };
+
+  VertexArrayCache(IContext& context, size_t maxSize);
+
+  /// Returns the vertex array object of `key`, or 0 if it is not cached
+  GLuint find(const Key& key) const;
+  /// Creates a vertex array object for `key`, which has to be set up by the caller. All entries
+  /// are evicted first if the cache is full
+  GLuint insert(const Key& key);
+
+  void evictBuffers(GLsizei n, const GLuint* buffers);
+  void evictPipeline(uint64_t pipelineId);
+
+  /// Changes whenever vertex array objects are deleted, so that a vertex array object which has
+  /// been bound before is known to be still alive while the generation stays the same
+  uint64_t getGeneration() const {
+    return generation_;
+  }
+
+  size_t size() const {
+    return entries_.size();
+  }
+
+  /// Deletes all vertex array objects
+  void destroy();
+
+ private:
+  template<typename Predicate>
+  void evictIf(Predicate predicate);
+
+ private:
+  IContext& context_;
+  size_t maxSize_ = 0;
+  std::unordered_map<Key, GLuint, KeyHasher> entries_;
+  uint64_t generation_ = 0;
+};
+
+} // namespace opengl
+} // namespace igl
@@ -303,6 +303,8 @@ Result VertexInputState::create(const VertexInputStateDesc& desc) {
     attribInfo.name = desc.attributes[i].name;
     attribInfo.stride = desc.inputBindings[bufferIndex].stride;
     attribInfo.bufferOffset = desc.attributes[i].offset;
+    attribInfo.divisor =
+        desc.inputBindings[bufferIndex].sampleFunction == VertexSampleFunction::Instance ? 1 : 0;
 
     toOGLAttribute(desc.attributes[i],
                    attribInfo.numComponents,
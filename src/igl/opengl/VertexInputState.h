@@ -26,6 +26,8 @@ struct OGLAttribute {
   GLint numComponents = 0;
   GLenum componentType = GL_FLOAT;
   GLboolean normalized = false;
+  // 1 for the attributes of VertexSampleFunction::Instance bindings, which advance per instance
+  GLuint divisor = 0;
 
   OGLAttribute() = default;
 };
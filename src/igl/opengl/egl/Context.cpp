@@ -12,6 +12,7 @@
 #include <igl/opengl/egl/Context.h>
 
 #include <cassert>
+#include <cstring>
 #include <igl/Macros.h>
 #include <igl/opengl/Errors.h>
 #include <igl/opengl/GLIncludes.h>
@@ -177,6 +178,50 @@ EGLConfig chooseConfig(EGLDisplay display) {
   return context;
 }
 
+/*static*/ std::unique_ptr<Context> Context::createOffscreenShareContext(
+    Context& existingContext,
+    size_t width,
+    size_t height,
+    Result* outResult) {
+  EGLDisplay display = existingContext.display_;
+  EGLConfig config = existingContext.config_;
+  if (config == EGL_NO_CONFIG_KHR) {
+    config = chooseConfig(display);
+  }
+
+  EGLContext newContext =
+      eglCreateContext(display, config, existingContext.context_, contextAttribs);
+  CHECK_EGL_ERRORS();
+  if (newContext == EGL_NO_CONTEXT) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "eglCreateContext failed");
+    return nullptr;
+  }
+
+  EGLint pbufferAttribs[] = {
+      EGL_WIDTH,
+      EGLint(width),
+      EGL_HEIGHT,
+      EGLint(height),
+      EGL_NONE, // Terminator
+  };
+  EGLSurface surface = eglCreatePbufferSurface(display, config, pbufferAttribs);
+  CHECK_EGL_ERRORS();
+  if (surface == EGL_NO_SURFACE) {
+    eglDestroyContext(display, newContext);
+    CHECK_EGL_ERRORS();
+    Result::setResult(outResult, Result::Code::RuntimeError, "eglCreatePbufferSurface failed");
+    return nullptr;
+  }
+
+  auto context = createShareContext(existingContext, newContext, surface, surface, outResult);
+  if (context) {
+    // destroyed with the context
+    context->contextOwned_ = true;
+    context->surface_ = surface;
+  }
+  return context;
+}
+
 Context::Context(RenderingAPI api, EGLNativeWindowType window) :
   Context(api, false, window, 0, 0) {}
 
@@ -317,6 +362,52 @@ void Context::present(std::shared_ptr<ITexture> /*surface*/) const {
 #endif
 }
 
+void Context::presentWithDamage(std::shared_ptr<ITexture> surface,
+                                const std::vector<ScissorRect>& damage) const {
+#if defined(FORCE_USE_ANGLE)
+  present(std::move(surface));
+#else
+  const SwapBuffersWithDamageProc swapBuffersWithDamage = getSwapBuffersWithDamage();
+  if (damage.empty() || !swapBuffersWithDamage || drawSurface_ == EGL_NO_SURFACE) {
+    present(std::move(surface));
+    return;
+  }
+  std::vector<EGLint> rects;
+  rects.reserve(damage.size() * 4);
+  for (const ScissorRect& rect : damage) {
+    rects.push_back(static_cast<EGLint>(rect.x));
+    rects.push_back(static_cast<EGLint>(rect.y));
+    rects.push_back(static_cast<EGLint>(rect.width));
+    rects.push_back(static_cast<EGLint>(rect.height));
+  }
+  swapBuffersWithDamage(display_, drawSurface_, rects.data(), static_cast<EGLint>(damage.size()));
+#endif
+}
+
+bool Context::setSwapInterval(int interval) {
+  if (interval < 0) {
+    return false;
+  }
+  const EGLBoolean success = eglSwapInterval(display_, interval);
+  CHECK_EGL_ERRORS();
+  return success == EGL_TRUE;
+}
+
+Context::SwapBuffersWithDamageProc Context::getSwapBuffersWithDamage() const {
+  if (!isSwapBuffersWithDamageResolved_) {
+    isSwapBuffersWithDamageResolved_ = true;
+    const char* extensions = eglQueryString(display_, EGL_EXTENSIONS);
+    if (extensions && strstr(extensions, "EGL_KHR_swap_buffers_with_damage")) {
+      swapBuffersWithDamage_ = reinterpret_cast<SwapBuffersWithDamageProc>(
+          eglGetProcAddress("eglSwapBuffersWithDamageKHR"));
+    } else if (extensions && strstr(extensions, "EGL_EXT_swap_buffers_with_damage")) {
+      swapBuffersWithDamage_ = reinterpret_cast<SwapBuffersWithDamageProc>(
+          eglGetProcAddress("eglSwapBuffersWithDamageEXT"));
+    }
+  }
+  return swapBuffersWithDamage_;
+}
+
 void Context::setPresentationTime(long long presentationTimeNs) {
   // This is a workaround that we cannot call the eglPresentationTimeANDROID directly from
   // <EGL/eglext.h> due to some EGL api bugs.
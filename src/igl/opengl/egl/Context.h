@@ -30,6 +30,13 @@ class Context final : public IContext {
                                                      EGLSurface readSurface,
                                                      EGLSurface drawSurface,
                                                      Result* outResult);
+  /// Creates a context sharing objects with an existing context, which owns a pbuffer surface of
+  /// the given size. Meant for background threads, e.g. the workers of a SharedContextPool.
+  /// The new context is current on the calling thread when this returns.
+  static std::unique_ptr<Context> createOffscreenShareContext(Context& existingContext,
+                                                              size_t width,
+                                                              size_t height,
+                                                              Result* outResult);
   /// Create a new context for default display. This constructor makes the assumption that the EGL
   /// surfaces to be associated with this context are already present and set to current.
   Context(RenderingAPI api, EGLNativeWindowType window);
@@ -49,6 +56,10 @@ class Context final : public IContext {
   bool isCurrentContext() const override;
   bool isCurrentSharegroup() const override;
   void present(std::shared_ptr<ITexture> surface) const override;
+  void presentWithDamage(std::shared_ptr<ITexture> surface,
+                         const std::vector<ScissorRect>& damage) const override;
+  /// EGL has no adaptive vsync, negative intervals are not supported
+  bool setSwapInterval(int interval) override;
 
   void setPresentationTime(long long presentationTimeNs);
   void updateSurfaces(EGLSurface readSurface, EGLSurface drawSurface);
@@ -73,6 +84,10 @@ class Context final : public IContext {
           size_t width,
           size_t height);
 
+  using SwapBuffersWithDamageProc = EGLBoolean (*)(EGLDisplay, EGLSurface, const EGLint*, EGLint);
+  // eglSwapBuffersWithDamageKHR/EXT, or nullptr if the display supports neither
+  SwapBuffersWithDamageProc getSwapBuffersWithDamage() const;
+
   bool contextOwned_ = false;
   FOLLY_PUSH_WARNING
   FOLLY_GNU_DISABLE_WARNING("-Wzero-as-null-pointer-constant")
@@ -87,6 +102,9 @@ class Context final : public IContext {
   // Since EGLContext does not expose a Share Group, this must be set manually via the
   // constructor and should be a list of all the contexts in the group including this context_
   std::shared_ptr<std::vector<EGLContext>> sharegroup_;
+
+  mutable bool isSwapBuffersWithDamageResolved_ = false;
+  mutable SwapBuffersWithDamageProc swapBuffersWithDamage_ = nullptr;
 };
 
 } // namespace egl
@@ -10,8 +10,11 @@
 #include <igl/opengl/egl/Context.h>
 #include <igl/opengl/egl/Device.h>
 #include <igl/opengl/egl/PlatformDevice.h>
+#include <igl/opengl/egl/TextureBuffer.h>
+#include <cstring>
 #include <sstream>
 #include <utility>
+#include <vector>
 
 namespace igl {
 namespace opengl {
@@ -145,6 +148,133 @@ std::shared_ptr<ITexture> PlatformDevice::createTextureFromNativeDepth(Result* o
   return texture;
 }
 
+#if IGL_PLATFORM_ANDROID && __ANDROID_API__ >= 26
+std::shared_ptr<ITexture> PlatformDevice::createTextureFromNativeHardwareBuffer(
+    AHardwareBuffer* hardwareBuffer,
+    Result* outResult) {
+  if (hardwareBuffer == nullptr) {
+    Result::setResult(outResult, Result::Code::ArgumentNull, "Hardware buffer is null");
+    return nullptr;
+  }
+  static auto getNativeClientBuffer =
+      reinterpret_cast<PFNEGLGETNATIVECLIENTBUFFERANDROIDPROC>(
+          eglGetProcAddress("eglGetNativeClientBufferANDROID"));
+  if (getNativeClientBuffer == nullptr) {
+    Result::setResult(outResult,
+                      Result::Code::Unsupported,
+                      "EGL_ANDROID_get_native_client_buffer is not supported");
+    return nullptr;
+  }
+
+  AHardwareBuffer_Desc desc = {};
+  AHardwareBuffer_describe(hardwareBuffer, &desc);
+  // the contents of the buffer must be kept, the driver could discard them otherwise
+  const EGLint attributes[] = {EGL_IMAGE_PRESERVED_KHR, EGL_TRUE, EGL_NONE};
+  return createTextureFromImage(EGL_NATIVE_BUFFER_ANDROID,
+                                getNativeClientBuffer(hardwareBuffer),
+                                attributes,
+                                desc.width,
+                                desc.height,
+                                outResult);
+}
+#endif // IGL_PLATFORM_ANDROID && __ANDROID_API__ >= 26
+
+#if IGL_PLATFORM_LINUX
+std::shared_ptr<ITexture> PlatformDevice::createTextureFromDmaBuf(const DmaBufDesc& desc,
+                                                                  Result* outResult) {
+  if (desc.numPlanes == 0 || desc.numPlanes > DmaBufDesc::kMaxPlanes) {
+    Result::setResult(outResult, Result::Code::ArgumentInvalid, "Invalid number of planes");
+    return nullptr;
+  }
+  const auto* context = static_cast<Context*>(getSharedContext().get());
+  if (context == nullptr) {
+    Result::setResult(outResult, Result::Code::InvalidOperation, "No EGL context found!");
+    return nullptr;
+  }
+  const char* extensions = eglQueryString(context->getDisplay(), EGL_EXTENSIONS);
+  if (extensions == nullptr || strstr(extensions, "EGL_EXT_image_dma_buf_import") == nullptr) {
+    Result::setResult(
+        outResult, Result::Code::Unsupported, "EGL_EXT_image_dma_buf_import is not supported");
+    return nullptr;
+  }
+  const bool hasModifier = desc.modifier != DmaBufDesc::kNoModifier;
+  if (hasModifier && strstr(extensions, "EGL_EXT_image_dma_buf_import_modifiers") == nullptr) {
+    Result::setResult(outResult,
+                      Result::Code::Unsupported,
+                      "EGL_EXT_image_dma_buf_import_modifiers is not supported");
+    return nullptr;
+  }
+
+  constexpr EGLint kPlaneAttributes[DmaBufDesc::kMaxPlanes][5] = {
+      {EGL_DMA_BUF_PLANE0_FD_EXT,
+       EGL_DMA_BUF_PLANE0_OFFSET_EXT,
+       EGL_DMA_BUF_PLANE0_PITCH_EXT,
+       EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT,
+       EGL_DMA_BUF_PLANE0_MODIFIER_HI_EXT},
+      {EGL_DMA_BUF_PLANE1_FD_EXT,
+       EGL_DMA_BUF_PLANE1_OFFSET_EXT,
+       EGL_DMA_BUF_PLANE1_PITCH_EXT,
+       EGL_DMA_BUF_PLANE1_MODIFIER_LO_EXT,
+       EGL_DMA_BUF_PLANE1_MODIFIER_HI_EXT},
+      {EGL_DMA_BUF_PLANE2_FD_EXT,
+       EGL_DMA_BUF_PLANE2_OFFSET_EXT,
+       EGL_DMA_BUF_PLANE2_PITCH_EXT,
+       EGL_DMA_BUF_PLANE2_MODIFIER_LO_EXT,
+       EGL_DMA_BUF_PLANE2_MODIFIER_HI_EXT},
+  };
+  std::vector<EGLint> attributes = {EGL_WIDTH,
+                                    static_cast<EGLint>(desc.width),
+                                    EGL_HEIGHT,
+                                    static_cast<EGLint>(desc.height),
+                                    EGL_LINUX_DRM_FOURCC_EXT,
+                                    static_cast<EGLint>(desc.drmFourcc)};
+  for (uint32_t i = 0; i != desc.numPlanes; i++) {
+    const auto& plane = desc.planes[i];
+    attributes.insert(attributes.end(),
+                      {kPlaneAttributes[i][0],
+                       plane.fd,
+                       kPlaneAttributes[i][1],
+                       static_cast<EGLint>(plane.offset),
+                       kPlaneAttributes[i][2],
+                       static_cast<EGLint>(plane.pitch)});
+    if (hasModifier) {
+      attributes.insert(attributes.end(),
+                        {kPlaneAttributes[i][3],
+                         static_cast<EGLint>(desc.modifier & 0xffffffff),
+                         kPlaneAttributes[i][4],
+                         static_cast<EGLint>(desc.modifier >> 32)});
+    }
+  }
+  attributes.push_back(EGL_NONE);
+
+  return createTextureFromImage(
+      EGL_LINUX_DMA_BUF_EXT, nullptr, attributes.data(), desc.width, desc.height, outResult);
+}
+#endif // IGL_PLATFORM_LINUX
+
+std::shared_ptr<ITexture> PlatformDevice::createTextureFromImage(EGLenum target,
+                                                                 EGLClientBuffer buffer,
+                                                                 const EGLint* attributes,
+                                                                 size_t width,
+                                                                 size_t height,
+                                                                 Result* outResult) {
+  const auto* context = static_cast<Context*>(getSharedContext().get());
+  if (context == nullptr) {
+    Result::setResult(outResult, Result::Code::InvalidOperation, "No EGL context found!");
+    return nullptr;
+  }
+  auto texture = std::make_shared<TextureBuffer>(getContext(), context->getDisplay());
+  const Result subResult = texture->createWithImage(target, buffer, attributes, width, height);
+  Result::setResult(outResult, subResult.code, subResult.message);
+  if (!subResult.isOk()) {
+    return nullptr;
+  }
+  if (auto resourceTracker = owner_.getResourceTracker()) {
+    texture->initResourceTracker(resourceTracker);
+  }
+  return texture;
+}
+
 void PlatformDevice::updateSurfaces(EGLSurface readSurface,
                                     EGLSurface drawSurface,
                                     Result* outResult) {
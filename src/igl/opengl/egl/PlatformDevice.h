@@ -12,6 +12,10 @@
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/PlatformDevice.h>
 
+#if IGL_PLATFORM_ANDROID && __ANDROID_API__ >= 26
+#include <android/hardware_buffer.h>
+#endif // IGL_PLATFORM_ANDROID && __ANDROID_API__ >= 26
+
 namespace igl {
 namespace opengl {
 
@@ -22,6 +26,28 @@ namespace egl {
 class Device;
 class Context;
 
+/// Describes a Linux dma-buf image, e.g. a frame exported by a V4L2 or VA-API video decoder
+struct DmaBufDesc {
+  static constexpr size_t kMaxPlanes = 3;
+  /// DRM_FORMAT_MOD_INVALID, the driver picks the layout of the planes
+  static constexpr uint64_t kNoModifier = 0x00ffffffffffffffull;
+
+  struct Plane {
+    int fd = -1;
+    uint32_t offset = 0;
+    uint32_t pitch = 0;
+  };
+
+  uint32_t width = 0;
+  uint32_t height = 0;
+  /// The DRM_FORMAT_* code of the image, e.g. DRM_FORMAT_NV12
+  uint32_t drmFourcc = 0;
+  /// The DRM format modifier of all the planes, e.g. for tiled or compressed layouts
+  uint64_t modifier = kNoModifier;
+  uint32_t numPlanes = 1;
+  Plane planes[kMaxPlanes];
+};
+
 class PlatformDevice : public opengl::PlatformDevice {
  public:
   static constexpr igl::PlatformDeviceType Type = igl::PlatformDeviceType::OpenGLEgl;
@@ -39,6 +65,20 @@ class PlatformDevice : public opengl::PlatformDevice {
   /// Returns a texture representing the EGL depth texture associated with this device's context.
   std::shared_ptr<ITexture> createTextureFromNativeDepth(Result* outResult);
 
+#if IGL_PLATFORM_ANDROID && __ANDROID_API__ >= 26
+  /// Returns an external image texture sharing the memory of `hardwareBuffer`, e.g. a camera or
+  /// video decoder frame, without copying it. Sample it with samplerExternalOES.
+  std::shared_ptr<ITexture> createTextureFromNativeHardwareBuffer(AHardwareBuffer* hardwareBuffer,
+                                                                  Result* outResult);
+#endif // IGL_PLATFORM_ANDROID && __ANDROID_API__ >= 26
+
+#if IGL_PLATFORM_LINUX
+  /// Returns an external image texture sharing the memory of the dma-buf described by `desc`
+  /// without copying it. Requires EGL_EXT_image_dma_buf_import. The file descriptors are not
+  /// closed. Sample the texture with samplerExternalOES.
+  std::shared_ptr<ITexture> createTextureFromDmaBuf(const DmaBufDesc& desc, Result* outResult);
+#endif // IGL_PLATFORM_LINUX
+
   /// This function must be called every time the currently bound EGL read and/or draw surfaces
   /// change, in order to notify IGL of these changes.
   void updateSurfaces(EGLSurface readSurface, EGLSurface drawSurface, Result* outResult);
@@ -56,6 +96,12 @@ class PlatformDevice : public opengl::PlatformDevice {
   std::shared_ptr<ViewTextureTarget> drawableTexture_;
 
   std::pair<EGLint, EGLint> getSurfaceDimensions(const Context& context, Result* outResult);
+  std::shared_ptr<ITexture> createTextureFromImage(EGLenum target,
+                                                   EGLClientBuffer buffer,
+                                                   const EGLint* attributes,
+                                                   size_t width,
+                                                   size_t height,
+                                                   Result* outResult);
 };
 
 } // namespace egl
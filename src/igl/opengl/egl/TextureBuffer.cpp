@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/egl/TextureBuffer.h>
+
+#include <igl/opengl/DeviceFeatureSet.h>
+#include <igl/opengl/IContext.h>
+
+namespace igl {
+namespace opengl {
+namespace egl {
+namespace {
+
+// The image functions are loaded at runtime like eglPresentationTimeANDROID, since EGL_KHR_image
+// is not exported by every EGL library
+PFNEGLCREATEIMAGEKHRPROC getCreateImageProc() {
+  static auto proc =
+      reinterpret_cast<PFNEGLCREATEIMAGEKHRPROC>(eglGetProcAddress("eglCreateImageKHR"));
+  return proc;
+}
+
+PFNEGLDESTROYIMAGEKHRPROC getDestroyImageProc() {
+  static auto proc =
+      reinterpret_cast<PFNEGLDESTROYIMAGEKHRPROC>(eglGetProcAddress("eglDestroyImageKHR"));
+  return proc;
+}
+
+} // namespace
+
+TextureBuffer::TextureBuffer(IContext& context,
+                             EGLDisplay display,
+                             TextureDesc::TextureUsage usage) :
+  Super(context, TextureFormat::RGBA_UNorm8), display_(display), usage_(usage) {}
+
+TextureBuffer::~TextureBuffer() {
+  // the GL texture keeps the memory of the image alive until it is deleted
+  if (image_ != EGL_NO_IMAGE_KHR) {
+    if (auto destroyImage = getDestroyImageProc()) {
+      destroyImage(display_, image_);
+    }
+  }
+}
+
+Result TextureBuffer::create(const TextureDesc& /*desc*/, bool /*hasStorageAlready*/) {
+  return Result(Result::Code::Unsupported,
+                "igl::opengl::egl::TextureBuffer does not support this creation");
+}
+
+Result TextureBuffer::createWithImage(EGLenum target,
+                                      EGLClientBuffer buffer,
+                                      const EGLint* attributes,
+                                      size_t width,
+                                      size_t height) {
+  if (image_ != EGL_NO_IMAGE_KHR) {
+    return Result(Result::Code::InvalidOperation,
+                  "TextureBuffer has already been created with an EGLImage");
+  }
+  const auto& deviceFeatures = getContext().deviceFeatures();
+  if (!deviceFeatures.hasInternalFeature(InternalFeatures::EGLImage) ||
+      !deviceFeatures.hasFeature(DeviceFeatures::TextureExternalImage)) {
+    return Result(Result::Code::Unsupported, "EGLImage textures are not supported");
+  }
+  auto createImage = getCreateImageProc();
+  if (createImage == nullptr || getDestroyImageProc() == nullptr) {
+    return Result(Result::Code::Unsupported, "EGL_KHR_image is not supported");
+  }
+
+  image_ = createImage(display_, EGL_NO_CONTEXT, target, buffer, attributes);
+  if (image_ == EGL_NO_IMAGE_KHR) {
+    return Result(Result::Code::RuntimeError,
+                  "Failed to create an EGLImage: " + std::to_string(eglGetError()));
+  }
+
+  const TextureDesc desc = TextureDesc::newExternalImage(getFormat(), width, height, usage_);
+  Result result = Super::create(desc, true);
+  if (!result.isOk()) {
+    return result;
+  }
+  getContext().bindTexture(getTarget(), getId());
+  getContext().eglImageTargetTexture2D(getTarget(), image_);
+  return Result();
+}
+
+Result TextureBuffer::upload(const TextureRangeDesc& /*range*/,
+                             const void* /*data*/,
+                             size_t /*bytesPerRow*/) const {
+  return Result(Result::Code::Unsupported,
+                "igl::opengl::egl::TextureBuffer shares the memory of its EGLImage");
+}
+
+} // namespace egl
+} // namespace opengl
+} // namespace igl
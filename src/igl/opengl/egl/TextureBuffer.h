@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <igl/opengl/TextureBuffer.h>
+
+namespace igl {
+namespace opengl {
+namespace egl {
+
+/// An external image texture (GL_TEXTURE_EXTERNAL_OES) sampling an EGLImage, e.g. created from an
+/// Android hardware buffer or a Linux dma-buf. The texture shares the memory of the image, nothing
+/// is copied. YUV images are converted to RGB by the driver when sampled with samplerExternalOES.
+class TextureBuffer final : public opengl::TextureBuffer {
+  using Super = opengl::TextureBuffer;
+
+ public:
+  /// @param display The display the EGLImage is created on
+  /// @param usage Usage of the texture, the image is read-only unless the driver can render to it
+  TextureBuffer(IContext& context,
+                EGLDisplay display,
+                TextureDesc::TextureUsage usage = TextureDesc::TextureUsageBits::Sampled);
+  ~TextureBuffer() override;
+
+  // Disable those creation methods
+  Result create(const TextureDesc& desc, bool hasStorageAlready) override;
+
+  /// Creates an EGLImage from `buffer` and binds it to this texture.
+  /// @param target The type of `buffer`, e.g. EGL_NATIVE_BUFFER_ANDROID or EGL_LINUX_DMA_BUF_EXT
+  /// @param buffer The client buffer, may be null for targets fully described by `attributes`
+  /// @param attributes EGL_NONE terminated attributes of eglCreateImageKHR
+  /// @param width Width of the image
+  /// @param height Height of the image
+  Result createWithImage(EGLenum target,
+                         EGLClientBuffer buffer,
+                         const EGLint* attributes,
+                         size_t width,
+                         size_t height);
+
+  Result upload(const TextureRangeDesc& range, const void* data, size_t bytesPerRow) const override;
+
+ private:
+  EGLDisplay display_ = EGL_NO_DISPLAY;
+  EGLImageKHR image_ = EGL_NO_IMAGE_KHR;
+  TextureDesc::TextureUsage usage_ = 0;
+};
+
+} // namespace egl
+} // namespace opengl
+} // namespace igl
@@ -12,6 +12,7 @@
 #include <X11/X.h>
 #include <dlfcn.h>
 
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -50,6 +51,8 @@ typedef GLXPbuffer (*PFNGLXCREATEPBUFFERPROC)(Display*, GLXFBConfig, const int*)
 typedef void (*PFNGLXDESTROYPBUFFER)(Display*, GLXPbuffer);
 typedef Bool (*PFNGLXMAKECURRENTPROC)(Display*, GLXDrawable, GLXContext);
 typedef void (*PFNGLXSWAPBUFFERSPROC)(Display*, GLXDrawable);
+typedef const char* (*PFNGLXQUERYEXTENSIONSSTRINGPROC)(Display*, int);
+typedef void (*PFNGLXSWAPINTERVALEXTPROC)(Display*, GLXDrawable, int);
 
 typedef GLXContext (*PFNGLXGETCURRENTCONTEXTPROC)();
 
@@ -88,6 +91,8 @@ struct GLXSharedModule {
     glXMakeCurrent = loadGlxFunction<PFNGLXMAKECURRENTPROC>("glXMakeCurrent");
     glXSwapBuffers = loadGlxFunction<PFNGLXSWAPBUFFERSPROC>("glXSwapBuffers");
     glXGetCurrentContext = loadGlxFunction<PFNGLXGETCURRENTCONTEXTPROC>("glXGetCurrentContext");
+    glXQueryExtensionsString =
+        loadGlxFunction<PFNGLXQUERYEXTENSIONSSTRINGPROC>("glXQueryExtensionsString");
   }
 
   ~GLXSharedModule() {
@@ -132,6 +137,7 @@ struct GLXSharedModule {
   PFNGLXMAKECURRENTPROC glXMakeCurrent = nullptr;
   PFNGLXSWAPBUFFERSPROC glXSwapBuffers = nullptr;
   PFNGLXGETCURRENTCONTEXTPROC glXGetCurrentContext = nullptr;
+  PFNGLXQUERYEXTENSIONSSTRINGPROC glXQueryExtensionsString = nullptr;
 };
 
 Context::Context(std::shared_ptr<GLXSharedModule> module,
@@ -267,6 +273,25 @@ void Context::present(std::shared_ptr<ITexture> surface) const {
   module_->glXMakeCurrent(display_, windowHandle_, contextHandle_);
 }
 
+bool Context::setSwapInterval(int interval) {
+  if (offscreen_ || !windowHandle_) {
+    return false;
+  }
+  const char* extensions = module_->glXQueryExtensionsString(display_, DefaultScreen(display_));
+  if (!extensions || !strstr(extensions, "GLX_EXT_swap_control") ||
+      (interval < 0 && !strstr(extensions, "GLX_EXT_swap_control_tear"))) {
+    return false;
+  }
+  // glXGetProcAddress() returns non-null for any name, the extension check above is what counts
+  auto glXSwapIntervalEXT = reinterpret_cast<PFNGLXSWAPINTERVALEXTPROC>(
+      module_->glXGetProcAddress(reinterpret_cast<const GLubyte*>("glXSwapIntervalEXT")));
+  if (!glXSwapIntervalEXT) {
+    return false;
+  }
+  glXSwapIntervalEXT(display_, windowHandle_, interval);
+  return true;
+}
+
 std::shared_ptr<GLXSharedModule> Context::getSharedModule() const {
   return module_;
 }
@@ -42,6 +42,7 @@ class Context : public IContext {
   bool isCurrentContext() const override;
   bool isCurrentSharegroup() const override;
   void present(std::shared_ptr<ITexture> surface) const override;
+  bool setSwapInterval(int interval) override;
 
   std::shared_ptr<GLXSharedModule> getSharedModule() const;
 
@@ -8,6 +8,10 @@
 #include <igl/opengl/Texture.h>
 #include <igl/opengl/webgl/Context.h>
 
+#if defined(__EMSCRIPTEN_PTHREADS__)
+#include <emscripten/threading.h>
+#endif
+
 namespace igl::opengl::webgl {
 
 Context::Context(RenderingAPI api, const char* canvasName) {
@@ -32,6 +36,14 @@ void Context::initialize(EmscriptenWebGLContextAttributes& attributes,
                          const char* canvasName,
                          int width,
                          int height) {
+#if defined(__EMSCRIPTEN_PTHREADS__)
+  if (!emscripten_is_main_browser_thread()) {
+    // The canvas is an OffscreenCanvas transferred to this worker. Never proxy GL calls back to the
+    // main thread, and swap in present() since a render loop may not return to the event loop.
+    attributes.proxyContextToMainThread = EMSCRIPTEN_WEBGL_CONTEXT_PROXY_DISALLOW;
+    attributes.explicitSwapControl = EM_TRUE;
+  }
+#endif
   context_ = emscripten_webgl_create_context(canvasName, &attributes);
   if (width != -1 && height != -1) {
     emscripten_set_canvas_element_size(canvasName, width, height);
@@ -44,6 +56,12 @@ void Context::initialize(EmscriptenWebGLContextAttributes& attributes,
     // Initialize through base class.
     IContext::initialize(&result);
     IGL_ASSERT(result.isOk());
+
+    // Every GL call crosses from wasm to JS, and queries and glGetError() additionally wait for the
+    // browser's GL process. Drop redundant state changes, answer binding queries from the state
+    // cache and don't check errors after each call; sampled error checking can still be enabled.
+    enableStateCache(true);
+    enableAutomaticErrorCheck(false);
   }
 }
 
@@ -13,6 +13,23 @@
 
 namespace igl::opengl::webgl {
 
+namespace {
+
+// clang-format off
+EM_JS(int, iglTexSubImage2DFromImageSource,
+      (GLenum target, GLint level, GLint x, GLint y, GLenum format, GLenum type, int sourceId), {
+  const sources = Module["iglImageSources"];
+  const source = sources ? sources[sourceId] : undefined;
+  if (!source) {
+    return 0;
+  }
+  GLctx.texSubImage2D(target, level, x, y, format, type, source);
+  return 1;
+});
+// clang-format on
+
+} // namespace
+
 PlatformDevice::PlatformDevice(Device& owner) : opengl::PlatformDevice(owner) {}
 
 std::shared_ptr<ITexture> PlatformDevice::createTextureFromNativeDrawable(Result* outResult) {
@@ -47,6 +64,38 @@ std::shared_ptr<ITexture> PlatformDevice::createTextureFromNativeDrawable(Result
   return drawableTexture_;
 }
 
+Result PlatformDevice::uploadFromImageSource(const ITexture& texture,
+                                             int sourceId,
+                                             size_t x,
+                                             size_t y,
+                                             size_t mipLevel) {
+  auto* textureBuffer = dynamic_cast<const TextureBuffer*>(&texture);
+  if (textureBuffer == nullptr || texture.getType() != TextureType::TwoD ||
+      texture.getProperties().isCompressed()) {
+    return Result(Result::Code::ArgumentInvalid, "Only 2D TextureBuffers are supported");
+  }
+
+  Texture::FormatDescGL formatDescGL;
+  if (!textureBuffer->toFormatDescGL(
+          texture.getFormat(), textureBuffer->getUsage(), formatDescGL)) {
+    return Result(Result::Code::ArgumentInvalid, "Invalid texture format");
+  }
+
+  // the storage of the texture is allocated, so the source is uploaded with texSubImage2D and the
+  // binding goes through the context to keep its state cache up to date
+  getContext().bindTexture(GL_TEXTURE_2D, textureBuffer->getId());
+  if (!iglTexSubImage2DFromImageSource(GL_TEXTURE_2D,
+                                       static_cast<GLint>(mipLevel),
+                                       static_cast<GLint>(x),
+                                       static_cast<GLint>(y),
+                                       formatDescGL.format,
+                                       formatDescGL.type,
+                                       sourceId)) {
+    return Result(Result::Code::ArgumentInvalid, "Unknown image source");
+  }
+  return Result();
+}
+
 bool PlatformDevice::isType(PlatformDeviceType t) const noexcept {
   return t == Type || opengl::PlatformDevice::isType(t);
 }
@@ -34,6 +34,17 @@ class PlatformDevice : public opengl::PlatformDevice {
   /// Returns a texture representing the EGL Surface associated with this device's context.
   std::shared_ptr<ITexture> createTextureFromNativeDrawable(Result* outResult);
 
+  /// Uploads a browser image source (ImageBitmap, ImageData, HTMLImageElement, HTMLCanvasElement,
+  /// HTMLVideoElement or OffscreenCanvas) to `texture` at (x, y) of `mipLevel`. The browser decodes
+  /// and uploads the image itself, so the pixels are never copied through the wasm heap. The
+  /// source is Module.iglImageSources[sourceId], which the application populates from JS. The
+  /// texture has to be a 2D texture with an uncompressed format.
+  Result uploadFromImageSource(const ITexture& texture,
+                               int sourceId,
+                               size_t x = 0,
+                               size_t y = 0,
+                               size_t mipLevel = 0);
+
  protected:
   bool isType(PlatformDeviceType t) const noexcept override;
 
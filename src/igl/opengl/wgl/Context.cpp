@@ -14,14 +14,20 @@
 #define NOMINMAX
 #endif // NOMINMAX
 #include <windows.h>
-#ifdef DISABLE_WGL_VSYNC
-#include <GL/wglext.h>
-#endif
+
+#include <cstring>
 
 namespace igl {
 namespace opengl {
 namespace wgl {
 
+namespace {
+
+using PFNIGLWGLSWAPINTERVALEXTPROC = BOOL(WINAPI*)(int interval);
+using PFNIGLWGLGETEXTENSIONSSTRINGEXTPROC = const char*(WINAPI*)();
+
+} // namespace
+
 Context::Context(RenderingAPI api) : contextOwned_(true) {
   // This ctor path will own the wgl render context. Therefore creation to the window, DC & render
   // context must be done and in sequence. Creating a dummy window is necessary to get the device
@@ -163,13 +169,35 @@ void Context::setCurrent() {
   }
   flushDeletionQueue();
 
-#ifdef DISABLE_WGL_VSYNC
-  static PFNWGLSWAPINTERVALEXTPROC wglSwapIntervalEXT =
-      (PFNWGLSWAPINTERVALEXTPROC)wglGetProcAddress("wglSwapIntervalEXT");
-  if (IGL_VERIFY(wglSwapIntervalEXT)) {
-    wglSwapIntervalEXT(0);
+  if (swapInterval_.has_value()) {
+    applySwapInterval(*swapInterval_);
+  }
+}
+
+bool Context::setSwapInterval(int interval) {
+  if (!applySwapInterval(interval)) {
+    return false;
+  }
+  swapInterval_ = interval;
+  return true;
+}
+
+bool Context::applySwapInterval(int interval) const {
+  // both entry points are only valid while a context is current
+  static auto wglGetExtensionsStringEXT = reinterpret_cast<PFNIGLWGLGETEXTENSIONSSTRINGEXTPROC>(
+      wglGetProcAddress("wglGetExtensionsStringEXT"));
+  static auto wglSwapIntervalEXT =
+      reinterpret_cast<PFNIGLWGLSWAPINTERVALEXTPROC>(wglGetProcAddress("wglSwapIntervalEXT"));
+  if (!wglSwapIntervalEXT) {
+    return false;
+  }
+  if (interval < 0) {
+    const char* extensions = wglGetExtensionsStringEXT ? wglGetExtensionsStringEXT() : nullptr;
+    if (!extensions || !strstr(extensions, "WGL_EXT_swap_control_tear")) {
+      return false;
+    }
   }
-#endif
+  return wglSwapIntervalEXT(interval) == TRUE;
 }
 
 void Context::clearCurrentContext() const {
@@ -14,6 +14,8 @@
 #endif
 #include <windows.h>
 
+#include <optional>
+
 namespace igl {
 class ITexture;
 namespace opengl {
@@ -37,16 +39,25 @@ class Context : public IContext {
   bool isCurrentContext() const override;
   bool isCurrentSharegroup() const override;
   void present(std::shared_ptr<ITexture> surface) const override;
+  /// The interval is reapplied whenever the context is made current
+  bool setSwapInterval(int interval) override;
   HDC getDeviceContext() const {
     return deviceContext_;
   }
 
  private:
+  bool applySwapInterval(int interval) const;
+
   const bool contextOwned_ = false;
   HDC deviceContext_;
   HGLRC renderContext_;
   HWND dummyWindow_;
   std::vector<HGLRC> sharegroup_;
+#ifdef DISABLE_WGL_VSYNC
+  std::optional<int> swapInterval_ = 0;
+#else
+  std::optional<int> swapInterval_;
+#endif
 };
 
 } // namespace wgl
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "util/Common.h"
+#include "util/TestDevice.h"
+
+#include <cstring>
+#include <igl/BlitCommandEncoder.h>
+#include <vector>
+
+namespace igl {
+namespace tests {
+
+//
+// BlitCommandEncoderTest
+//
+// Copies between buffers on the GPU, read back by mapping the destination buffer.
+//
+class BlitCommandEncoderTest : public ::testing::Test {
+ public:
+  BlitCommandEncoderTest() = default;
+  ~BlitCommandEncoderTest() override = default;
+
+  // Set up common resources. This will create a device and a command queue
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+  }
+
+  void TearDown() override {}
+
+  std::shared_ptr<IBuffer> createBuffer(const std::vector<uint8_t>& data) const {
+    Result ret;
+    const BufferDesc desc(BufferDesc::BufferTypeBits::Storage,
+                          data.data(),
+                          data.size(),
+                          ResourceStorage::Shared);
+    auto buffer = iglDev_->createBuffer(desc, &ret);
+    EXPECT_TRUE(ret.isOk()) << ret.message;
+    return buffer;
+  }
+
+  std::vector<uint8_t> readBuffer(IBuffer& buffer, size_t size) const {
+    Result ret;
+    const auto* data = static_cast<const uint8_t*>(buffer.map(BufferRange(size, 0), &ret));
+    if (!ret.isOk() || data == nullptr) {
+      return {};
+    }
+    std::vector<uint8_t> result(data, data + size);
+    buffer.unmap();
+    return result;
+  }
+
+  // Member variables
+ public:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+};
+
+//
+// copyBuffer
+//
+// Copies the middle of a buffer to the beginning of another one, the rest is left untouched.
+//
+TEST_F(BlitCommandEncoderTest, copyBuffer) {
+  if (!iglDev_->hasFeature(DeviceFeatures::MapBufferRange)) {
+    GTEST_SKIP() << "Buffers cannot be read back";
+  }
+  const std::vector<uint8_t> sourceData = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+  const std::vector<uint8_t> destinationData(sourceData.size(), 0);
+  auto source = createBuffer(sourceData);
+  auto destination = createBuffer(destinationData);
+  ASSERT_TRUE(source != nullptr && destination != nullptr);
+
+  Result ret;
+  auto cmdBuffer = cmdQueue_->createCommandBuffer(CommandBufferDesc{}, &ret);
+  ASSERT_TRUE(cmdBuffer != nullptr);
+  auto encoder = cmdBuffer->createBlitCommandEncoder(&ret);
+  if (!encoder) {
+    GTEST_SKIP() << "Blit encoding is not supported";
+  }
+  encoder->copyBuffer(*source, 4, *destination, 0, 8);
+  encoder->endEncoding();
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  const std::vector<uint8_t> expected = {5, 6, 7, 8, 9, 10, 11, 12, 0, 0, 0, 0, 0, 0, 0, 0};
+  ASSERT_EQ(readBuffer(*destination, expected.size()), expected);
+}
+
+//
+// fillBuffer
+//
+// Fills the second half of a buffer.
+//
+TEST_F(BlitCommandEncoderTest, fillBuffer) {
+  if (!iglDev_->hasFeature(DeviceFeatures::MapBufferRange)) {
+    GTEST_SKIP() << "Buffers cannot be read back";
+  }
+  const std::vector<uint8_t> data(16, 1);
+  auto buffer = createBuffer(data);
+  ASSERT_TRUE(buffer != nullptr);
+
+  Result ret;
+  auto cmdBuffer = cmdQueue_->createCommandBuffer(CommandBufferDesc{}, &ret);
+  ASSERT_TRUE(cmdBuffer != nullptr);
+  auto encoder = cmdBuffer->createBlitCommandEncoder(&ret);
+  if (!encoder) {
+    GTEST_SKIP() << "Blit encoding is not supported";
+  }
+  encoder->fillBuffer(*buffer, 8, 8, 0xab);
+  encoder->endEncoding();
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  const std::vector<uint8_t> expected = {
+      1, 1, 1, 1, 1, 1, 1, 1, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab};
+  ASSERT_EQ(readBuffer(*buffer, expected.size()), expected);
+}
+
+} // namespace tests
+} // namespace igl
@@ -10,6 +10,7 @@
 #include <igl/opengl/Device.h>
 
 #include <string>
+#include <vector>
 
 namespace igl {
 namespace tests {
@@ -237,5 +238,87 @@ TEST_F(BufferTest, mapUniformBuffer) {
   ASSERT_EQ(color.a, bufferData[3]);
 }
 
+//
+// mapMultipleSmallBuffers
+//
+// Small buffers may share the same underlying storage; make sure their contents do not overlap
+//
+TEST_F(BufferTest, mapMultipleSmallBuffers) {
+  if (!mapBufferTestsSupported) {
+    GTEST_SKIP() << "Map buffer range is not supported";
+  }
+
+  constexpr size_t kNumBuffers = 8;
+  constexpr size_t kNumElements = 5;
+
+  std::vector<std::shared_ptr<IBuffer>> buffers;
+  for (size_t i = 0; i != kNumBuffers; i++) {
+    uint16_t indexData[kNumElements];
+    for (size_t j = 0; j != kNumElements; j++) {
+      indexData[j] = static_cast<uint16_t>(i * kNumElements + j);
+    }
+    Result ret;
+    BufferDesc bufferDesc = BufferDesc(
+        BufferDesc::BufferTypeBits::Index, indexData, sizeof(indexData), ResourceStorage::Shared);
+    buffers.emplace_back(iglDev_->createBuffer(bufferDesc, &ret));
+    ASSERT_EQ(ret.code, Result::Code::Ok);
+    ASSERT_TRUE(buffers.back() != nullptr);
+  }
+
+  for (size_t i = 0; i != kNumBuffers; i++) {
+    Result ret;
+    const auto* data = static_cast<const uint16_t*>(
+        buffers[i]->map(BufferRange(kNumElements * sizeof(uint16_t), 0), &ret));
+    ASSERT_EQ(ret.code, Result::Code::Ok);
+    ASSERT_TRUE(data != nullptr);
+    for (size_t j = 0; j != kNumElements; j++) {
+      ASSERT_EQ(data[j], i * kNumElements + j);
+    }
+    buffers[i]->unmap();
+  }
+}
+
+//
+// ringHintedBufferUploads
+//
+// OpenGL streams dynamic buffers created with the Ring hint through several GL buffers. Partial
+// uploads must keep the rest of the contents, no matter how often the GL buffer changes
+//
+TEST_F(BufferTest, ringHintedBufferUploads) {
+  if (iglDev_->getBackendType() != BackendType::OpenGL) {
+    GTEST_SKIP() << "Streaming buffers are specific to OpenGL";
+  }
+
+  constexpr size_t kNumElements = 16;
+
+  std::vector<uint16_t> vertexData(kNumElements, 0);
+  Result ret;
+  BufferDesc bufferDesc = BufferDesc(BufferDesc::BufferTypeBits::Vertex,
+                                     vertexData.data(),
+                                     kNumElements * sizeof(uint16_t),
+                                     ResourceStorage::Shared,
+                                     BufferDesc::BufferAPIHintBits::Ring);
+  std::shared_ptr<IBuffer> buffer = iglDev_->createBuffer(bufferDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_TRUE(buffer != nullptr);
+  ASSERT_TRUE(buffer->acceptedApiHints() & BufferDesc::BufferAPIHintBits::Ring);
+
+  // more uploads than buffers in the ring
+  for (size_t i = 0; i != kNumElements; i++) {
+    const auto value = static_cast<uint16_t>(i + 1);
+    ret = buffer->upload(&value, BufferRange(sizeof(uint16_t), i * sizeof(uint16_t)));
+    ASSERT_EQ(ret.code, Result::Code::Ok);
+  }
+
+  const auto* data = static_cast<const uint16_t*>(
+      buffer->map(BufferRange(kNumElements * sizeof(uint16_t), 0), &ret));
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_TRUE(data != nullptr);
+  for (size_t i = 0; i != kNumElements; i++) {
+    ASSERT_EQ(data[i], i + 1);
+  }
+  buffer->unmap();
+}
+
 } // namespace tests
 } // namespace igl
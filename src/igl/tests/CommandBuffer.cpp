@@ -54,5 +54,69 @@ TEST_F(CommandBufferTest, pushPopDebugGroupLabel) {
   cmdBuf_->popDebugGroupLabel();
 }
 
+//
+// Check beginTimer and endTimer
+//
+// Results are resolved asynchronously, so only check that they are reported once the command
+// buffer has completed.
+//
+TEST_F(CommandBufferTest, beginEndTimer) {
+  if (!iglDev_->hasFeature(DeviceFeatures::Timers)) {
+    GTEST_SKIP() << "GPU timers are not supported";
+  }
+
+  Result result;
+  std::shared_ptr<ITimer> timer = iglDev_->createTimer(&result);
+  ASSERT_EQ(result.code, Result::Code::Ok);
+  ASSERT_TRUE(timer != nullptr);
+  ASSERT_FALSE(timer->resultsAvailable());
+
+  cmdBuf_->beginTimer(timer);
+  cmdBuf_->pushDebugGroupLabel("TEST");
+  cmdBuf_->popDebugGroupLabel();
+  cmdBuf_->endTimer(timer);
+
+  cmdQueue_->submit(*cmdBuf_);
+  cmdBuf_->waitUntilCompleted();
+
+  // completion handlers on Metal are not guaranteed to have run yet
+  if (timer->resultsAvailable()) {
+    ASSERT_LT(timer->getElapsedTimeNanos(), 1000000000ull);
+  }
+}
+
+//
+// Check begin/endPipelineStatisticsQuery
+//
+TEST_F(CommandBufferTest, beginEndPipelineStatisticsQuery) {
+  QueryPoolDesc desc;
+  desc.type = QueryType::PipelineStatistics;
+
+  Result result;
+  std::shared_ptr<IQueryPool> pool = iglDev_->createQueryPool(desc, &result);
+  if (!iglDev_->hasFeature(DeviceFeatures::PipelineStatisticsQueries)) {
+    ASSERT_EQ(result.code, Result::Code::Unsupported);
+    ASSERT_TRUE(pool == nullptr);
+    return;
+  }
+  ASSERT_EQ(result.code, Result::Code::Ok);
+  ASSERT_TRUE(pool != nullptr);
+  ASSERT_EQ(pool->getType(), QueryType::PipelineStatistics);
+
+  PipelineStatistics statistics;
+  // nothing has been recorded yet
+  ASSERT_FALSE(pool->getPipelineStatistics(0, 1, &statistics));
+
+  cmdBuf_->beginPipelineStatisticsQuery(pool, 0);
+  cmdBuf_->endPipelineStatisticsQuery(pool, 0);
+
+  cmdQueue_->submit(*cmdBuf_);
+  cmdBuf_->waitUntilCompleted();
+
+  if (pool->getPipelineStatistics(0, 1, &statistics)) {
+    ASSERT_EQ(statistics.vertexShaderInvocations, 0u);
+  }
+}
+
 } // namespace tests
 } // namespace igl
@@ -92,11 +92,13 @@ class ComputeCommandEncoderTest : public ::testing::Test {
 
   /**
    * @brief This function binds bufferIn and bufferOut to a new computePiplineState and encodes the
-   * computePipelineState to a new computeCommandEncoder.
+   * computePipelineState to a new computeCommandEncoder. The number of thread groups is read from
+   * indirectBuffer if it is not null.
    */
   void encodeCompute(const std::shared_ptr<igl::ICommandBuffer>& cmdBuffer,
                      const std::shared_ptr<igl::IBuffer>& bufferIn,
-                     const std::shared_ptr<igl::IBuffer>& bufferOut) {
+                     const std::shared_ptr<igl::IBuffer>& bufferOut,
+                     const std::shared_ptr<igl::IBuffer>& indirectBuffer = nullptr) {
     ASSERT_TRUE(computeStages_ != nullptr);
     ComputePipelineDesc computeDesc;
     computeDesc.shaderStages = computeStages_;
@@ -116,7 +118,11 @@ class ComputeCommandEncoderTest : public ::testing::Test {
 
     Dimensions threadgroupSize(dataIn.size(), 1, 1);
     Dimensions threadgroupCount(1, 1, 1);
-    computeEncoder->dispatchThreadGroups(threadgroupCount, threadgroupSize);
+    if (indirectBuffer) {
+      computeEncoder->dispatchThreadGroupsIndirect(*indirectBuffer, 0, threadgroupSize);
+    } else {
+      computeEncoder->dispatchThreadGroups(threadgroupCount, threadgroupSize);
+    }
     computeEncoder->endEncoding();
   }
 
@@ -202,4 +208,87 @@ TEST_F(ComputeCommandEncoderTest, canUseOutputBufferFromOnePassAsInputToNext) {
   bufferOut2_->unmap();
 }
 
+TEST_F(ComputeCommandEncoderTest, canSpecializeConstants) {
+#if IGL_PLATFORM_LINUX && !IGL_PLATFORM_LINUX_USE_EGL
+  GTEST_SKIP() << "Fix this test on Linux";
+#endif
+  if (!isDeviceCompatible(*iglDev_)) {
+    return;
+  }
+
+  const char* source = iglDev_->getBackendType() == igl::BackendType::OpenGL
+                           ? igl::tests::data::shader::OGL_SPECIALIZED_COMPUTE_SHADER
+                           : igl::tests::data::shader::MTL_SPECIALIZED_COMPUTE_SHADER;
+  ShaderModuleInfo info = {ShaderStage::Compute, igl::tests::data::shader::specializedComputeFunc};
+  info.specializationConstants = {
+      ShaderSpecializationConstant::fromFloat(
+          igl::tests::data::shader::specializedComputeScaleId, "kScale", 3.0f),
+      ShaderSpecializationConstant::fromInt(
+          igl::tests::data::shader::specializedComputeOffsetId, "kOffset", -1),
+  };
+  igl::Result ret;
+  auto computeModule = ShaderModuleCreator::fromStringInput(*iglDev_, source, info, "", &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message.c_str();
+  computeStages_ = ShaderStagesCreator::fromComputeModule(*iglDev_, computeModule, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message.c_str();
+
+  CommandBufferDesc cbDesc;
+  auto cmdBuffer = cmdQueue_->createCommandBuffer(cbDesc, nullptr);
+  ASSERT_TRUE(cmdBuffer != nullptr);
+
+  encodeCompute(cmdBuffer, bufferIn_, bufferOut0_);
+
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  std::vector<float> bytes(dataIn.size());
+  auto range = BufferRange(sizeof(float) * dataIn.size(), 0);
+  auto* data = bufferOut0_->map(range, &ret);
+  ASSERT_TRUE(data != nullptr);
+  ASSERT_TRUE(ret.isOk());
+  memcpy(bytes.data(), data, sizeof(float) * dataIn.size());
+  for (int i = 0; i < dataIn.size(); i++) {
+    ASSERT_EQ(dataIn[i] * 3.0f - 1.0f, bytes[i]);
+  }
+  bufferOut0_->unmap();
+}
+
+TEST_F(ComputeCommandEncoderTest, canDispatchIndirect) {
+#if IGL_PLATFORM_LINUX && !IGL_PLATFORM_LINUX_USE_EGL
+  GTEST_SKIP() << "Fix this test on Linux";
+#endif
+  if (!isDeviceCompatible(*iglDev_)) {
+    return;
+  }
+
+  const std::vector<uint32_t> threadgroupCount = {1, 1, 1};
+  const BufferDesc indirectDesc(
+      BufferDesc::BufferTypeBits::Indirect | BufferDesc::BufferTypeBits::Storage,
+      threadgroupCount.data(),
+      sizeof(uint32_t) * threadgroupCount.size());
+  const std::shared_ptr<IBuffer> indirectBuffer = iglDev_->createBuffer(indirectDesc, nullptr);
+  ASSERT_TRUE(indirectBuffer != nullptr);
+
+  CommandBufferDesc cbDesc;
+  auto cmdBuffer = cmdQueue_->createCommandBuffer(cbDesc, nullptr);
+  ASSERT_TRUE(cmdBuffer != nullptr);
+
+  encodeCompute(cmdBuffer, bufferIn_, bufferOut0_, indirectBuffer);
+
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  std::vector<float> bytes(dataIn.size());
+  auto range = BufferRange(sizeof(float) * dataIn.size(), 0);
+  igl::Result ret;
+  auto* data = bufferOut0_->map(range, &ret);
+  ASSERT_TRUE(data != nullptr);
+  ASSERT_TRUE(ret.isOk());
+  memcpy(bytes.data(), data, sizeof(float) * dataIn.size());
+  for (int i = 0; i < dataIn.size(); i++) {
+    ASSERT_EQ(dataIn[i] * 2.0f, bytes[i]);
+  }
+  bufferOut0_->unmap();
+}
+
 } // namespace igl::tests
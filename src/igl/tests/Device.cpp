@@ -11,7 +11,10 @@
 #include "util/Common.h"
 #include "util/TestDevice.h"
 
+#include <chrono>
+#include <future>
 #include <string>
+#include <utility>
 
 // Use a 1x1 Framebuffer for this test
 #define OFFSCREEN_RT_WIDTH 1
@@ -176,6 +179,55 @@ TEST_F(DeviceTest, LastDrawStat) {
   ASSERT_EQ(drawCount, 1);
 }
 
+//
+// Async Render Pipeline
+//
+// Check that createRenderPipelineAsync() eventually delivers a usable pipeline state.
+//
+TEST_F(DeviceTest, CreateRenderPipelineAsync) {
+  std::promise<std::pair<std::shared_ptr<IRenderPipelineState>, Result>> promise;
+  auto future = promise.get_future();
+
+  iglDev_->createRenderPipelineAsync(
+      renderPipelineDesc_,
+      [&promise](std::shared_ptr<IRenderPipelineState> pipelineState, Result result) {
+        promise.set_value(std::make_pair(std::move(pipelineState), std::move(result)));
+      });
+
+  // backends which finish pipelines on the calling thread do it at the beginning of a device scope
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (future.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready &&
+         std::chrono::steady_clock::now() < deadline) {
+    const DeviceScope scope(*iglDev_);
+  }
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+
+  const auto [pipelineState, ret] = future.get();
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(pipelineState != nullptr);
+}
+
+//
+// Memory Statistics
+//
+// Backends which report memory statistics should report at least one heap and account for the
+// offscreen texture created in SetUp().
+//
+TEST_F(DeviceTest, GetMemoryStatistics) {
+  DeviceMemoryStatistics stats;
+
+  if (!iglDev_->getMemoryStatistics(stats)) {
+    GTEST_SKIP() << "Memory statistics are not supported";
+  }
+
+  ASSERT_FALSE(stats.heaps.empty());
+
+  if (iglDev_->getBackendType() == igl::BackendType::Vulkan) {
+    ASSERT_GT(stats.textureBytes, 0u);
+  }
+  ASSERT_LE(stats.resizableBarBufferBytes, stats.bufferBytes);
+}
+
 //
 // Get Backend Type
 //
@@ -103,6 +103,7 @@ TEST_F(DeviceFeatureSetTest, hasFeatureForMacOSOrWinOrAndroidTest) {
     EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::BufferRing));
     EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::BufferNoCopy));
     EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::ShaderLibrary));
+    EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::ShaderFloat16));
     EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::BindBytes));
     EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::BufferDeviceAddress));
 
@@ -179,6 +180,7 @@ TEST_F(DeviceFeatureSetTest, hasFeatureForMacOSOrWinOrAndroidTest) {
       EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::TextureExternalImage));
       EXPECT_TRUE(iglDev_->hasFeature(DeviceFeatures::Multiview));
       EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::BindUniform));
+      EXPECT_TRUE(iglDev_->hasFeature(DeviceFeatures::OcclusionQueries));
       EXPECT_TRUE(iglDev_->hasFeature(DeviceFeatures::TexturePartialMipChain));
       EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::BufferRing));
       EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::BufferNoCopy));
@@ -205,11 +207,17 @@ TEST_F(DeviceFeatureSetTest, hasFeatureForMacOSOrWinOrAndroidTest) {
       EXPECT_TRUE(iglDev_->hasFeature(DeviceFeatures::TexturePartialMipChain));
       EXPECT_TRUE(iglDev_->hasFeature(DeviceFeatures::BufferRing));
       EXPECT_TRUE(iglDev_->hasFeature(DeviceFeatures::BufferNoCopy));
+      EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::MultiDrawIndirectCount));
+      EXPECT_TRUE(iglDev_->hasFeature(DeviceFeatures::OcclusionQueries));
+      EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::PipelineStatisticsQueries));
       EXPECT_TRUE(iglDev_->hasFeature(DeviceFeatures::ShaderLibrary));
+      EXPECT_TRUE(iglDev_->hasFeature(DeviceFeatures::ShaderFloat16));
       EXPECT_TRUE(iglDev_->hasFeature(DeviceFeatures::BindBytes));
       EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::BufferDeviceAddress));
       EXPECT_TRUE(iglDev_->hasFeature(DeviceFeatures::ShaderTextureLod));
       EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::ShaderTextureLodExt));
+      EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::ShadingRate));
+      EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::SparseTextures));
       EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::StandardDerivativeExt));
       EXPECT_TRUE(iglDev_->hasFeature(DeviceFeatures::SamplerMinMaxLod));
       EXPECT_TRUE(iglDev_->hasFeature(DeviceFeatures::DrawIndexedIndirect));
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <igl/FrameProfiler.h>
+#include <igl/Timer.h>
+#include <thread>
+
+namespace igl {
+namespace tests {
+
+namespace {
+
+constexpr int64_t kNanosPerMs = 1000000;
+
+class FakeTimer final : public ITimer {
+ public:
+  explicit FakeTimer(uint64_t elapsedNanos) : elapsedNanos_(elapsedNanos) {}
+  [[nodiscard]] bool resultsAvailable() const override {
+    return elapsedNanos_ != 0;
+  }
+  [[nodiscard]] uint64_t getElapsedTimeNanos() const override {
+    return elapsedNanos_;
+  }
+
+ private:
+  uint64_t elapsedNanos_;
+};
+
+} // namespace
+
+TEST(FrameProfilerTest, Percentiles) {
+  FrameProfiler profiler(16.0, 200);
+
+  // 1..100 ms
+  for (int64_t i = 1; i <= 100; ++i) {
+    profiler.addSample(FrameProfiler::Track::CpuFrame, i * 1000, i * kNanosPerMs);
+  }
+
+  const auto stats = profiler.getStats(FrameProfiler::Track::CpuFrame);
+  EXPECT_EQ(stats.numSamples, 100u);
+  EXPECT_DOUBLE_EQ(stats.averageMs, 50.5);
+  EXPECT_DOUBLE_EQ(stats.p50Ms, 50.0);
+  EXPECT_DOUBLE_EQ(stats.p95Ms, 95.0);
+  EXPECT_DOUBLE_EQ(stats.p99Ms, 99.0);
+  EXPECT_DOUBLE_EQ(stats.maxMs, 100.0);
+
+  EXPECT_EQ(profiler.getStats(FrameProfiler::Track::Wait).numSamples, 0u);
+}
+
+TEST(FrameProfilerTest, RingBufferKeepsLastSamples) {
+  FrameProfiler profiler(16.0, 4);
+
+  for (int64_t i = 1; i <= 10; ++i) {
+    profiler.addSample(FrameProfiler::Track::Wait, 0, i * kNanosPerMs);
+  }
+
+  const auto stats = profiler.getStats(FrameProfiler::Track::Wait);
+  EXPECT_EQ(stats.numSamples, 4u);
+  EXPECT_DOUBLE_EQ(stats.averageMs, 8.5);
+  EXPECT_DOUBLE_EQ(stats.maxMs, 10.0);
+}
+
+TEST(FrameProfilerTest, Histogram) {
+  FrameProfiler profiler;
+
+  profiler.addSample(FrameProfiler::Track::CpuFrame, 0, 1 * kNanosPerMs);
+  profiler.addSample(FrameProfiler::Track::CpuFrame, 0, 5 * kNanosPerMs);
+  profiler.addSample(FrameProfiler::Track::CpuFrame, 0, 6 * kNanosPerMs);
+  profiler.addSample(FrameProfiler::Track::CpuFrame, 0, 100 * kNanosPerMs);
+
+  const auto histogram = profiler.getHistogram(FrameProfiler::Track::CpuFrame, 4.0, 3);
+  ASSERT_EQ(histogram.size(), 3u);
+  EXPECT_EQ(histogram[0], 1u);
+  EXPECT_EQ(histogram[1], 2u);
+  // longer samples end up in the last bucket
+  EXPECT_EQ(histogram[2], 1u);
+}
+
+TEST(FrameProfilerTest, Frames) {
+  FrameProfiler profiler(0.5);
+
+  profiler.beginFrame();
+  EXPECT_EQ(profiler.getFrameCount(), 0u);
+  {
+    const FrameProfiler::ScopedWait wait(profiler);
+    // at least 4 target frame times
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  profiler.beginFrame();
+
+  EXPECT_EQ(profiler.getFrameCount(), 1u);
+  EXPECT_GE(profiler.getDroppedFrameCount(), 3u);
+  EXPECT_EQ(profiler.getStats(FrameProfiler::Track::Wait).numSamples, 1u);
+  EXPECT_GE(profiler.getStats(FrameProfiler::Track::Wait).maxMs, 2.0);
+
+  profiler.beginFrame();
+  EXPECT_EQ(profiler.getFrameCount(), 2u);
+  EXPECT_EQ(profiler.getStats(FrameProfiler::Track::CpuFrame).numSamples, 2u);
+  EXPECT_GT(profiler.getAverageFPS(), 0.0f);
+}
+
+TEST(FrameProfilerTest, GpuTime) {
+  FrameProfiler profiler;
+
+  EXPECT_FALSE(profiler.addGpuTime(FakeTimer(0)));
+  EXPECT_TRUE(profiler.addGpuTime(FakeTimer(2 * kNanosPerMs)));
+
+  const auto stats = profiler.getStats(FrameProfiler::Track::GpuFrame);
+  EXPECT_EQ(stats.numSamples, 1u);
+  EXPECT_DOUBLE_EQ(stats.maxMs, 2.0);
+}
+
+TEST(FrameProfilerTest, ChromeTrace) {
+  FrameProfiler profiler;
+
+  profiler.addSample(FrameProfiler::Track::CpuFrame, 2000, 16 * kNanosPerMs);
+
+  const std::string trace = profiler.exportChromeTrace();
+  EXPECT_EQ(trace.find("{\"traceEvents\":["), 0u);
+  EXPECT_NE(
+      trace.find(R"({"name":"thread_name","ph":"M","pid":1,"tid":3,"args":{"name":"Wait"}})"),
+      std::string::npos);
+  EXPECT_NE(
+      trace.find(R"({"name":"CPU frame","ph":"X","pid":1,"tid":1,"ts":2.000,"dur":16000.000})"),
+      std::string::npos);
+}
+
+} // namespace tests
+} // namespace igl
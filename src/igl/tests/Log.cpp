@@ -5,11 +5,14 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <cstdio>
 #include <gtest/gtest.h>
 #include <igl/IGL.h>
+#include <mutex>
 #include <random>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace igl {
 namespace tests {
@@ -39,5 +42,42 @@ TEST(LogTest, LogOnceRaceCondition) {
   t4.join();
 };
 
+namespace {
+std::mutex sCapturedMutex;
+std::vector<std::string> sCaptured;
+
+int captureHandler(IGLLogLevel /*logLevel*/, const char* IGL_RESTRICT format, va_list ap) {
+  char buffer[256];
+  const int result = vsnprintf(buffer, sizeof(buffer), format, ap);
+  std::lock_guard<std::mutex> guard(sCapturedMutex);
+  sCaptured.emplace_back(buffer);
+  return result;
+}
+} // namespace
+
+TEST(LogTest, AsyncLogCollapsesRepeats) {
+  const IGLLogHandlerFunc oldHandler = IGLLogGetHandler();
+  IGLLogSetHandler(captureHandler);
+  sCaptured.clear();
+
+  IGLLogSetAsync(true);
+  ASSERT_TRUE(IGLLogIsAsync());
+  IGLLog(IGLLogLevel::LOG_INFO, "first %d\n", 1);
+  for (int i = 0; i != 5; i++) {
+    IGLLog(IGLLogLevel::LOG_INFO, "same\n");
+  }
+  IGLLog(IGLLogLevel::LOG_INFO, "last\n");
+  IGLLogFlush();
+  IGLLogSetAsync(false);
+  EXPECT_FALSE(IGLLogIsAsync());
+
+  IGLLogSetHandler(oldHandler);
+
+  const std::vector<std::string> expected = {
+      "first 1\n", "same\n", "[IGL] Last message repeated 4 times\n", "last\n"};
+  std::lock_guard<std::mutex> guard(sCapturedMutex);
+  EXPECT_EQ(sCaptured, expected);
+}
+
 } // namespace tests
 } // namespace igl
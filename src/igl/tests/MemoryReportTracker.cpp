@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "util/Common.h"
+#include "util/TestDevice.h"
+#include <igl/MemoryReportTracker.h>
+
+#include <string>
+
+namespace igl {
+namespace tests {
+
+class MemoryReportTrackerTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+
+    tracker_ = std::make_shared<MemoryReportTracker>();
+    iglDev_->setResourceTracker(tracker_);
+  }
+
+  void TearDown() override {
+    iglDev_->setResourceTracker(nullptr);
+  }
+
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  std::shared_ptr<MemoryReportTracker> tracker_;
+};
+
+TEST_F(MemoryReportTrackerTest, TracksBuffersPerTag) {
+  constexpr size_t kBufferSize = 256;
+
+  BufferDesc desc(BufferDesc::BufferTypeBits::Uniform,
+                  nullptr,
+                  kBufferSize,
+                  ResourceStorage::Shared,
+                  0,
+                  "uniforms");
+
+  auto untagged = iglDev_->createBuffer(desc, nullptr);
+  ASSERT_TRUE(untagged != nullptr);
+
+  std::unique_ptr<IBuffer> tagged;
+  {
+    const ResourceTrackerTagGuard guard(tracker_, "frame");
+    tagged = iglDev_->createBuffer(desc, nullptr);
+    ASSERT_TRUE(tagged != nullptr);
+  }
+
+  using ResourceType = MemoryReportTracker::ResourceType;
+  EXPECT_EQ(tracker_->getStats("", ResourceType::Buffer).count, 1u);
+  EXPECT_EQ(tracker_->getStats("frame", ResourceType::Buffer).count, 1u);
+  EXPECT_EQ(tracker_->getStats("frame", ResourceType::Buffer).bytes, tagged->getSizeInBytes());
+  EXPECT_EQ(tracker_->getStats("frame", ResourceType::Texture).count, 0u);
+  EXPECT_EQ(tracker_->getTotalBytes(), untagged->getSizeInBytes() + tagged->getSizeInBytes());
+
+  const std::string report = tracker_->dump();
+  EXPECT_NE(report.find("[frame]"), std::string::npos);
+  EXPECT_NE(report.find("uniforms"), std::string::npos);
+
+  const size_t peakBytes = tracker_->getTotalBytes();
+  tagged = nullptr;
+  EXPECT_EQ(tracker_->getStats("frame", ResourceType::Buffer).count, 0u);
+  EXPECT_EQ(tracker_->getTotalBytes(), untagged->getSizeInBytes());
+  EXPECT_EQ(tracker_->getPeakBytes(), peakBytes);
+}
+
+} // namespace tests
+} // namespace igl
@@ -9,6 +9,7 @@
 #include <functional>
 #include <gtest/gtest.h>
 #include <memory>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -16,6 +17,7 @@
 #include "data/TextureData.h"
 #include "data/VertexIndexData.h"
 #include "util/Common.h"
+#include "util/DriverCallCounter.h"
 
 #include <igl/Buffer.h>
 #include <igl/DepthStencilState.h>
@@ -210,6 +212,8 @@ class RenderCommandEncoderTest : public ::testing::Test {
 
     cmdQueue_->submit(*cmdBuffer);
     cmdBuffer->waitUntilCompleted();
+
+    lastCmdBuffer_ = std::move(cmdBuffer);
   }
 
   void verifyFrameBuffer(const std::vector<uint32_t>& expectedPixels) {
@@ -306,6 +310,8 @@ class RenderCommandEncoderTest : public ::testing::Test {
 
   std::shared_ptr<IRenderPipelineState> renderPipelineState_;
   std::shared_ptr<IDepthStencilState> depthStencilState_;
+  // the command buffer submitted by the last call to encodeAndSubmit()
+  std::shared_ptr<ICommandBuffer> lastCmdBuffer_;
 
   const std::string backend_ = IGL_BACKEND_TYPE;
 
@@ -431,6 +437,98 @@ TEST_F(RenderCommandEncoderTest, shouldDrawATriangle) {
   verifyFrameBuffer(expectedPixels);
 }
 
+//
+// Check drawInstanced
+//
+// Without per-instance attributes, all the instances cover the same triangle.
+//
+TEST_F(RenderCommandEncoderTest, shouldDrawInstanced) {
+  if (!iglDev_->hasFeature(DeviceFeatures::DrawInstanced)) {
+    GTEST_SKIP() << "Instanced drawing is not supported";
+  }
+  initializeBuffers(
+      // clang-format off
+      {
+        -1.0f - quarterPixel, -1.0f,                0.0f, 1.0f,
+         1.0f,                -1.0f,                0.0f, 1.0f,
+         1.0f,                 1.0f + quarterPixel, 0.0f, 1.0f,
+      },
+      {
+        0.0f, 0.0f,
+        1.0f, 0.0f,
+        1.0f, 1.0f,
+      } // clang-format on
+  );
+
+  encodeAndSubmit([](const std::unique_ptr<igl::IRenderCommandEncoder>& encoder) {
+    encoder->drawInstanced(PrimitiveType::Triangle, 0, 3, 2);
+    // no instances: nothing is drawn
+    encoder->drawInstanced(PrimitiveType::Triangle, 0, 3, 0);
+  });
+
+  auto grayColor = data::texture::TEX_RGBA_GRAY_4x4[0];
+  // clang-format off
+  std::vector<uint32_t> expectedPixels {
+    backgroundColorHex, backgroundColorHex, backgroundColorHex, grayColor,
+    backgroundColorHex, backgroundColorHex, grayColor,          grayColor,
+    backgroundColorHex, grayColor,          grayColor,          grayColor,
+    grayColor,          grayColor,          grayColor,          grayColor,
+  };
+
+  verifyFrameBuffer(expectedPixels);
+}
+
+//
+// Check begin/endOcclusionQuery
+//
+// Results are resolved asynchronously, so only check them once they are reported.
+//
+TEST_F(RenderCommandEncoderTest, shouldCountOcclusionQueries) {
+  if (!iglDev_->hasFeature(DeviceFeatures::OcclusionQueries)) {
+    GTEST_SKIP() << "Occlusion queries are not supported";
+  }
+
+  Result ret;
+  QueryPoolDesc desc;
+  desc.type = QueryType::Occlusion;
+  desc.queryCount = 2;
+  std::shared_ptr<IQueryPool> pool = iglDev_->createQueryPool(desc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(pool != nullptr);
+  ASSERT_EQ(pool->getQueryCount(), 2u);
+
+  initializeBuffers(
+      // clang-format off
+      {
+        -1.0f, -1.0f, 0.0f, 1.0f,
+         1.0f, -1.0f, 0.0f, 1.0f,
+         1.0f,  1.0f, 0.0f, 1.0f,
+      },
+      {
+        0.0f, 0.0f,
+        1.0f, 0.0f,
+        1.0f, 1.0f,
+      } // clang-format on
+  );
+
+  renderPass_.occlusionQueryPool = pool;
+  encodeAndSubmit([](const std::unique_ptr<igl::IRenderCommandEncoder>& encoder) {
+    encoder->beginOcclusionQuery(0);
+    encoder->draw(PrimitiveType::Triangle, 0, 3);
+    encoder->endOcclusionQuery();
+    // nothing is drawn
+    encoder->beginOcclusionQuery(1);
+    encoder->endOcclusionQuery();
+  });
+  renderPass_.occlusionQueryPool = nullptr;
+
+  uint64_t samplesPassed[2] = {};
+  if (pool->getOcclusionResults(0, 2, samplesPassed)) {
+    ASSERT_NE(samplesPassed[0], 0u);
+    ASSERT_EQ(samplesPassed[1], 0u);
+  }
+}
+
 TEST_F(RenderCommandEncoderTest, shouldDrawTriangleStrip) {
   initializeBuffers(
       // clang-format off
@@ -459,6 +557,41 @@ TEST_F(RenderCommandEncoderTest, shouldDrawTriangleStrip) {
   });
 }
 
+TEST_F(RenderCommandEncoderTest, shouldDrawWithShadingRate) {
+  if (!iglDev_->hasFeature(DeviceFeatures::ShadingRate)) {
+    GTEST_SKIP() << "Shading rates are not supported";
+  }
+
+  initializeBuffers(
+      // clang-format off
+      {
+        -1.0f,  1.0f, 0.0f, 1.0f,
+        -1.0f, -1.0f, 0.0f, 1.0f,
+         1.0f,  1.0f, 0.0f, 1.0f,
+         1.0f, -1.0f, 0.0f, 1.0f,
+      },
+      {
+        0.0, 1.0,
+        0.0, 0.0,
+        1.0, 1.0,
+        1.0, 0.0,
+      } // clang-format on
+  );
+
+  // the texture is uniform, so coarser shading must not change the result
+  encodeAndSubmit([](const std::unique_ptr<igl::IRenderCommandEncoder>& encoder) {
+    encoder->setShadingRate(ShadingRate::Rate2x2);
+    encoder->draw(PrimitiveType::TriangleStrip, 0, 4);
+    encoder->setShadingRate(ShadingRate::Rate1x1);
+  });
+
+  verifyFrameBuffer([](const std::vector<uint32_t>& pixels) {
+    for (auto& pixel : pixels) {
+      ASSERT_EQ(pixel, data::texture::TEX_RGBA_GRAY_4x4[0]);
+    }
+  });
+}
+
 TEST_F(RenderCommandEncoderTest, shouldNotDraw) {
   initializeBuffers(
       // clang-format off
@@ -495,5 +628,152 @@ TEST_F(RenderCommandEncoderTest, shouldNotDraw) {
   });
 }
 
+TEST_F(RenderCommandEncoderTest, shouldCountStatistics) {
+  initializeBuffers(
+      // clang-format off
+      { quarterPixel, quarterPixel, 0.0f, 1.0f },
+      { 0.5, 0.5 } // clang-format on
+  );
+
+  encodeAndSubmit([](const std::unique_ptr<igl::IRenderCommandEncoder>& encoder) {
+    encoder->draw(PrimitiveType::Point, 0, 1);
+    encoder->draw(PrimitiveType::Point, 0, 1);
+  });
+
+  ASSERT_TRUE(lastCmdBuffer_ != nullptr);
+  const CommandBufferStatistics& statistics = lastCmdBuffer_->getStatistics();
+  ASSERT_EQ(statistics.get(CommandBufferCounter::Draws), 2u);
+  ASSERT_EQ(lastCmdBuffer_->getCurrentDrawCount(), 2u);
+  ASSERT_EQ(statistics.get(CommandBufferCounter::RenderPasses), 1u);
+  ASSERT_GE(statistics.get(CommandBufferCounter::PipelineBinds), 1u);
+  ASSERT_EQ(statistics.get(CommandBufferCounter::Dispatches), 0u);
+}
+
+// Redundant state changes should not scale with the number of draws: a scene of 100 draws sharing
+// their bindings must reach the driver with as many binding calls as a single draw
+TEST_F(RenderCommandEncoderTest, shouldNotRebindStateForEveryDraw) {
+  initializeBuffers(
+      // clang-format off
+      { quarterPixel, quarterPixel, 0.0f, 1.0f },
+      { 0.5, 0.5 } // clang-format on
+  );
+
+  const std::vector<const char*> kBindingEntryPoints = {"activeTexture",
+                                                        "bindBuffer",
+                                                        "bindTexture",
+                                                        "bindVertexArray",
+                                                        "useProgram",
+                                                        "vertexAttribPointer"};
+  struct Counts {
+    uint64_t draws = 0;
+    uint64_t pipelineBinds = 0;
+    uint64_t bindingUpdates = 0;
+    std::vector<unsigned int> glBindingCalls;
+    unsigned int glDrawCalls = 0;
+  };
+  auto drawPoints = [&](uint32_t numDraws) {
+    util::DriverCallCounter counter(*iglDev_);
+    encodeAndSubmit([numDraws](const std::unique_ptr<igl::IRenderCommandEncoder>& encoder) {
+      for (uint32_t i = 0; i != numDraws; ++i) {
+        encoder->draw(PrimitiveType::Point, 0, 1);
+      }
+    });
+    Counts counts;
+    if (lastCmdBuffer_) {
+      counter.add(*lastCmdBuffer_);
+    }
+    counts.draws = counter.get(CommandBufferCounter::Draws);
+    counts.pipelineBinds = counter.get(CommandBufferCounter::PipelineBinds);
+    counts.bindingUpdates = counter.get(CommandBufferCounter::BindingUpdates);
+    for (const char* entryPoint : kBindingEntryPoints) {
+      counts.glBindingCalls.push_back(counter.getGLCallCount(entryPoint));
+    }
+    counts.glDrawCalls = counter.getGLCallCount("drawArrays");
+    return counts;
+  };
+
+  const Counts oneDraw = drawPoints(1);
+  const Counts manyDraws = drawPoints(100);
+
+  ASSERT_EQ(oneDraw.draws, 1u);
+  ASSERT_EQ(manyDraws.draws, 100u);
+  // the first render may also create and bind objects which later renders find cached
+  ASSERT_LE(manyDraws.pipelineBinds, oneDraw.pipelineBinds);
+  ASSERT_LE(manyDraws.bindingUpdates, oneDraw.bindingUpdates);
+  for (size_t i = 0; i != kBindingEntryPoints.size(); ++i) {
+    ASSERT_LE(manyDraws.glBindingCalls[i], oneDraw.glBindingCalls[i]) << kBindingEntryPoints[i];
+  }
+  ASSERT_EQ(manyDraws.glDrawCalls, 100 * oneDraw.glDrawCalls);
+}
+
+TEST_F(RenderCommandEncoderTest, shouldDrawWithParallelEncoders) {
+  initializeBuffers(
+      // clang-format off
+      {
+        -1.0f,  1.0f, 0.0f, 1.0f,
+         1.0f,  1.0f, 0.0f, 1.0f,
+        -1.0f, -1.0f, 0.0f, 1.0f,
+         1.0f,  1.0f, 0.0f, 1.0f,
+         1.0f, -1.0f, 0.0f, 1.0f,
+        -1.0f, -1.0f, 0.0f, 1.0f,
+      },
+      {
+        0.0, 1.0,
+        1.0, 1.0,
+        0.0, 0.0,
+        1.0, 1.0,
+        1.0, 0.0,
+        0.0, 0.0,
+      } // clang-format on
+  );
+
+  Result ret;
+
+  auto cmdBuffer = cmdQueue_->createCommandBuffer({}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(cmdBuffer != nullptr);
+
+  auto parallelEncoder =
+      cmdBuffer->createParallelRenderCommandEncoder(renderPass_, framebuffer_, &ret);
+  if (ret.code == Result::Code::Unsupported) {
+    GTEST_SKIP() << "Parallel render command encoders are not supported";
+  }
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(parallelEncoder != nullptr);
+
+  // every child encoder draws one of the two triangles covering the framebuffer
+  auto encoders = parallelEncoder->createRenderCommandEncoders(2, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_EQ(encoders.size(), 2u);
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i != encoders.size(); i++) {
+    threads.emplace_back([this, &encoder = encoders[i], i]() {
+      encoder->bindTexture(textureUnit_, BindTarget::kFragment, texture_);
+      encoder->bindSamplerState(textureUnit_, BindTarget::kFragment, samp_);
+      encoder->bindBuffer(data::shader::simplePosIndex, BindTarget::kVertex, vb_, 0);
+      encoder->bindBuffer(data::shader::simpleUvIndex, BindTarget::kVertex, uv_, 0);
+      encoder->bindRenderPipelineState(renderPipelineState_);
+      encoder->bindDepthStencilState(depthStencilState_);
+      encoder->draw(PrimitiveType::Triangle, 3 * i, 3);
+      encoder->endEncoding();
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  parallelEncoder->endEncoding();
+
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  verifyFrameBuffer([](const std::vector<uint32_t>& pixels) {
+    for (auto& pixel : pixels) {
+      ASSERT_EQ(pixel, data::texture::TEX_RGBA_GRAY_4x4[0]);
+    }
+  });
+}
+
 } // namespace tests
 } // namespace igl
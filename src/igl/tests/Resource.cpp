@@ -85,6 +85,61 @@ TEST_F(ResourceTest, DepthStencilCreate) {
   ASSERT_TRUE(ds != nullptr);
 }
 
+//
+// State caches
+//
+// Check that equal descriptors give the same state object while it is alive
+//
+TEST_F(ResourceTest, DepthStencilStatesAreShared) {
+  Result ret;
+
+  DepthStencilStateDesc dsDesc;
+  dsDesc.compareFunction = CompareFunction::LessEqual;
+  dsDesc.isDepthWriteEnabled = true;
+
+  auto first = iglDev_->createDepthStencilState(dsDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  auto second = iglDev_->createDepthStencilState(dsDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_EQ(first, second);
+
+  dsDesc.isDepthWriteEnabled = false;
+  auto third = iglDev_->createDepthStencilState(dsDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_NE(first, third);
+
+  // released states are created again
+  first.reset();
+  second.reset();
+  dsDesc.isDepthWriteEnabled = true;
+  first = iglDev_->createDepthStencilState(dsDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_TRUE(first != nullptr);
+}
+
+TEST_F(ResourceTest, VertexInputStatesAreShared) {
+  Result ret;
+
+  VertexInputStateDesc inputDesc;
+  inputDesc.attributes[0].format = VertexAttributeFormat::Float4;
+  inputDesc.attributes[0].bufferIndex = 0;
+  inputDesc.attributes[0].name = "position";
+  inputDesc.attributes[0].location = 0;
+  inputDesc.inputBindings[0].stride = sizeof(float) * 4;
+  inputDesc.numAttributes = inputDesc.numInputBindings = 1;
+
+  auto first = iglDev_->createVertexInputState(inputDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  auto second = iglDev_->createVertexInputState(inputDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_EQ(first, second);
+
+  inputDesc.inputBindings[0].stride = sizeof(float) * 8;
+  auto third = iglDev_->createVertexInputState(inputDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_NE(first, third);
+}
+
 //
 // Buffer
 //
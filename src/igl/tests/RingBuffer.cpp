@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <igl/RingBuffer.h>
+
+namespace igl {
+namespace tests {
+
+TEST(RingBufferAllocatorTest, AllocateAligned) {
+  RingBufferAllocator allocator(1024, 256);
+
+  EXPECT_EQ(allocator.allocate(16), 0u);
+  EXPECT_EQ(allocator.allocate(300), 256u);
+  EXPECT_EQ(allocator.allocate(256), 768u);
+  // full
+  EXPECT_EQ(allocator.allocate(1), RingBufferAllocator::kInvalidOffset);
+  EXPECT_EQ(allocator.allocate(2048), RingBufferAllocator::kInvalidOffset);
+}
+
+TEST(RingBufferAllocatorTest, RetireFrames) {
+  RingBufferAllocator allocator(1024, 256);
+
+  // frame 0
+  EXPECT_EQ(allocator.allocate(512), 0u);
+  allocator.endFrame();
+  // frame 1
+  EXPECT_EQ(allocator.allocate(256), 512u);
+  allocator.endFrame();
+  EXPECT_EQ(allocator.getNumFramesInFlight(), 2u);
+
+  // frame 2 does not fit after frame 1 and wraps around into frame 0
+  EXPECT_EQ(allocator.allocate(512), RingBufferAllocator::kInvalidOffset);
+  allocator.retireFrame();
+  EXPECT_EQ(allocator.allocate(512), 0u);
+  allocator.endFrame();
+
+  allocator.retireFrame();
+  allocator.retireFrame();
+  EXPECT_EQ(allocator.getNumFramesInFlight(), 0u);
+
+  // nothing in flight, the whole ring buffer is available again
+  EXPECT_EQ(allocator.allocate(1024), 0u);
+}
+
+} // namespace tests
+} // namespace igl
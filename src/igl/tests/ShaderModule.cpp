@@ -8,6 +8,7 @@
 #include "data/ShaderData.h"
 #include "util/Common.h"
 
+#include <cstring>
 #include <gtest/gtest.h>
 #include <igl/IGL.h>
 
@@ -119,5 +120,43 @@ TEST_F(ShaderModuleTest, CompileShaderModuleNoResult) {
       *iglDev_, source, {ShaderStage::Vertex, "vertexShader"}, "", nullptr);
   ASSERT_TRUE(shaderModule != nullptr);
 }
+
+TEST_F(ShaderModuleTest, ShaderModuleInfoSpecializationConstants) {
+  ShaderModuleInfo info = {ShaderStage::Vertex, "vertexShader"};
+  ShaderModuleInfo specializedInfo = info;
+  specializedInfo.specializationConstants = {
+      ShaderSpecializationConstant::fromFloat(0, "kScale", 0.5f),
+      ShaderSpecializationConstant::fromInt(1, "kOffset", -3),
+  };
+
+  ASSERT_NE(info, specializedInfo);
+
+  ShaderModuleInfo otherInfo = specializedInfo;
+  ASSERT_EQ(otherInfo, specializedInfo);
+  ASSERT_EQ(std::hash<ShaderModuleInfo>()(otherInfo),
+            std::hash<ShaderModuleInfo>()(specializedInfo));
+
+  otherInfo.specializationConstants[1] = ShaderSpecializationConstant::fromInt(1, "kOffset", 3);
+  ASSERT_NE(otherInfo, specializedInfo);
+
+  // swapping the ids and the values of the constants changes the hash
+  ShaderModuleInfo swappedInfo = info;
+  swappedInfo.specializationConstants = {
+      ShaderSpecializationConstant::fromUInt(0, "kA", 1),
+      ShaderSpecializationConstant::fromUInt(1, "kB", 0),
+  };
+  ShaderModuleInfo unswappedInfo = info;
+  unswappedInfo.specializationConstants = {
+      ShaderSpecializationConstant::fromUInt(0, "kA", 0),
+      ShaderSpecializationConstant::fromUInt(1, "kB", 1),
+  };
+  ASSERT_NE(std::hash<ShaderModuleInfo>()(swappedInfo),
+            std::hash<ShaderModuleInfo>()(unswappedInfo));
+
+  float scale = 0.0f;
+  memcpy(&scale, &specializedInfo.specializationConstants[0].value, sizeof(scale));
+  ASSERT_EQ(scale, 0.5f);
+  ASSERT_EQ(static_cast<int32_t>(specializedInfo.specializationConstants[1].value), -3);
+}
 } // namespace tests
 } // namespace igl
@@ -389,6 +389,20 @@ TEST(TextureFormatProperties, getBytesPerRange) {
   }
 }
 
+TEST(TextureFormatProperties, Constexpr) {
+  constexpr auto props = TextureFormatProperties::fromTextureFormat(TextureFormat::RGBA_ASTC_8x8);
+  static_assert(props.format == TextureFormat::RGBA_ASTC_8x8);
+  static_assert(props.isCompressed());
+  // 3 blocks x 2 blocks
+  static_assert(props.getBytesPerLayer(20, 10, 1) == 3 * 2 * 16);
+  static_assert(!TextureFormatProperties::fromTextureFormat(TextureFormat::Invalid).isValid());
+
+  for (uint8_t i = 0; i <= static_cast<uint8_t>(TextureFormat::S_UInt8); ++i) {
+    const auto format = static_cast<TextureFormat>(i);
+    EXPECT_EQ(TextureFormatProperties::fromTextureFormat(format).format, format);
+  }
+}
+
 //
 // Texture Passthrough Test
 //
@@ -542,6 +556,123 @@ TEST_F(TextureTest, PassthroughSubTexture) {
   ASSERT_EQ(pixels[OFFSCREEN_TEX_HEIGHT * OFFSCREEN_TEX_HEIGHT - 1], singlePixelColor);
 }
 
+//
+// Upload Regions Test
+//
+// Same as above, but the texture is filled with a batch of regions: the first row, and one region
+// per pixel of the second row.
+//
+TEST_F(TextureTest, UploadRegions) {
+  Result ret;
+  std::shared_ptr<IRenderPipelineState> pipelineState;
+
+  TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                           OFFSCREEN_TEX_WIDTH,
+                                           OFFSCREEN_TEX_HEIGHT,
+                                           TextureDesc::TextureUsageBits::Sampled);
+  inputTexture_ = iglDev_->createTexture(texDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_TRUE(inputTexture_ != nullptr);
+
+  const uint32_t secondRow[] = {0x44332211, 0x88776655};
+  const std::vector<TextureRegionUpload> regions = {
+      {TextureRangeDesc::new2D(0, 0, OFFSCREEN_TEX_WIDTH, 1), data::texture::TEX_RGBA_2x2},
+      {TextureRangeDesc::new2D(0, 1, 1, 1), &secondRow[0]},
+      // regions without data are skipped
+      {TextureRangeDesc::new2D(0, 1, 1, 1), nullptr},
+      {TextureRangeDesc::new2D(1, 1, 1, 1), &secondRow[1]},
+  };
+  ret = inputTexture_->uploadRegions(regions);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+
+  pipelineState = iglDev_->createRenderPipeline(renderPipelineDesc_, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_TRUE(pipelineState != nullptr);
+
+  cmdBuf_ = cmdQueue_->createCommandBuffer(cbDesc_, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_TRUE(cmdBuf_ != nullptr);
+
+  auto cmds = cmdBuf_->createRenderCommandEncoder(renderPass_, framebuffer_);
+  cmds->bindBuffer(data::shader::simplePosIndex, BindTarget::kVertex, vb_, 0);
+  cmds->bindBuffer(data::shader::simpleUvIndex, BindTarget::kVertex, uv_, 0);
+
+  cmds->bindRenderPipelineState(pipelineState);
+
+  cmds->bindTexture(textureUnit_, BindTarget::kFragment, inputTexture_);
+  cmds->bindSamplerState(textureUnit_, BindTarget::kFragment, samp_);
+
+  cmds->drawIndexed(PrimitiveType::Triangle, 6, IndexFormat::UInt16, *ib_, 0);
+
+  cmds->endEncoding();
+
+  cmdQueue_->submit(*cmdBuf_);
+
+  cmdBuf_->waitUntilCompleted();
+
+  const auto rangeDesc = TextureRangeDesc::new2D(0, 0, OFFSCREEN_TEX_WIDTH, OFFSCREEN_TEX_HEIGHT);
+  auto pixels = std::vector<uint32_t>(OFFSCREEN_TEX_WIDTH * OFFSCREEN_TEX_HEIGHT);
+
+  framebuffer_->copyBytesColorAttachment(*cmdQueue_, 0, pixels.data(), rangeDesc);
+
+  for (size_t i = 0; i < OFFSCREEN_TEX_WIDTH; i++) {
+    ASSERT_EQ(pixels[i], data::texture::TEX_RGBA_2x2[i]);
+    ASSERT_EQ(pixels[OFFSCREEN_TEX_WIDTH + i], secondRow[i]);
+  }
+}
+
+//
+// Texture Initial Data Test
+//
+// This test creates a texture with TextureDesc::initialData and renders it like Passthrough.
+//
+TEST_F(TextureTest, InitialData) {
+  Result ret;
+
+  TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                           OFFSCREEN_TEX_WIDTH,
+                                           OFFSCREEN_TEX_HEIGHT,
+                                           TextureDesc::TextureUsageBits::Sampled);
+  texDesc.initialData = data::texture::TEX_RGBA_2x2;
+  inputTexture_ = iglDev_->createTexture(texDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_TRUE(inputTexture_ != nullptr);
+
+  auto pipelineState = iglDev_->createRenderPipeline(renderPipelineDesc_, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_TRUE(pipelineState != nullptr);
+
+  cmdBuf_ = cmdQueue_->createCommandBuffer(cbDesc_, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_TRUE(cmdBuf_ != nullptr);
+
+  auto cmds = cmdBuf_->createRenderCommandEncoder(renderPass_, framebuffer_);
+  cmds->bindBuffer(data::shader::simplePosIndex, BindTarget::kVertex, vb_, 0);
+  cmds->bindBuffer(data::shader::simpleUvIndex, BindTarget::kVertex, uv_, 0);
+
+  cmds->bindRenderPipelineState(pipelineState);
+
+  cmds->bindTexture(textureUnit_, BindTarget::kFragment, inputTexture_);
+  cmds->bindSamplerState(textureUnit_, BindTarget::kFragment, samp_);
+
+  cmds->drawIndexed(PrimitiveType::Triangle, 6, IndexFormat::UInt16, *ib_, 0);
+
+  cmds->endEncoding();
+
+  cmdQueue_->submit(*cmdBuf_);
+
+  cmdBuf_->waitUntilCompleted();
+
+  const auto rangeDesc = TextureRangeDesc::new2D(0, 0, OFFSCREEN_TEX_WIDTH, OFFSCREEN_TEX_HEIGHT);
+  auto pixels = std::vector<uint32_t>(OFFSCREEN_TEX_WIDTH * OFFSCREEN_TEX_HEIGHT);
+
+  framebuffer_->copyBytesColorAttachment(*cmdQueue_, 0, pixels.data(), rangeDesc);
+
+  for (size_t i = 0; i < OFFSCREEN_TEX_WIDTH * OFFSCREEN_TEX_HEIGHT; i++) {
+    ASSERT_EQ(pixels[i], data::texture::TEX_RGBA_2x2[i]);
+  }
+}
+
 //
 // Framebuffer to Texture Copy Test
 //
@@ -947,6 +1078,51 @@ TEST_F(TextureTest, ValidateRange2D) {
   EXPECT_FALSE(ret.isOk());
 }
 
+//
+// Texture View Desc Resolve
+//
+// This test validates the defaults and checks of TextureViewDesc::resolve.
+//
+TEST_F(TextureTest, TextureViewDescResolve) {
+  if (!iglDev_->hasFeature(DeviceFeatures::SRGB)) {
+    GTEST_SKIP() << "sRGB textures are not supported";
+  }
+  Result ret;
+  auto texDesc = TextureDesc::new2D(
+      TextureFormat::RGBA_SRGB, 8, 8, TextureDesc::TextureUsageBits::Sampled);
+  texDesc.numMipLevels = 4;
+  auto tex = iglDev_->createTexture(texDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  TextureViewDesc viewDesc;
+  viewDesc.mipLevel = 3;
+  EXPECT_TRUE(viewDesc.resolve(*tex).isOk());
+  EXPECT_EQ(viewDesc.type, TextureType::TwoD);
+  EXPECT_EQ(viewDesc.format, TextureFormat::RGBA_SRGB);
+
+  viewDesc = {};
+  viewDesc.format = TextureFormat::RGBA_UNorm8;
+  viewDesc.type = TextureType::TwoDArray;
+  EXPECT_TRUE(viewDesc.resolve(*tex).isOk());
+
+  viewDesc = {};
+  viewDesc.format = TextureFormat::BGRA_UNorm8;
+  EXPECT_FALSE(viewDesc.resolve(*tex).isOk());
+
+  viewDesc = {};
+  viewDesc.mipLevel = 2;
+  viewDesc.numMipLevels = 3;
+  EXPECT_FALSE(viewDesc.resolve(*tex).isOk());
+
+  viewDesc = {};
+  viewDesc.layer = 1;
+  EXPECT_FALSE(viewDesc.resolve(*tex).isOk());
+
+  viewDesc = {};
+  viewDesc.type = TextureType::ThreeD;
+  EXPECT_FALSE(viewDesc.resolve(*tex).isOk());
+}
+
 //
 // Texture Validate Range Cube
 //
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include <igl/Uniform.h>
+#include <limits>
+
+namespace igl {
+namespace tests {
+
+//
+// Float16Conversion Test
+//
+// Exact values round trip, others round to the nearest half float.
+//
+TEST(UniformTest, Float16Conversion) {
+  EXPECT_EQ(floatToHalf(0.0f), 0x0000);
+  EXPECT_EQ(floatToHalf(-0.0f), 0x8000);
+  EXPECT_EQ(floatToHalf(1.0f), 0x3C00);
+  EXPECT_EQ(floatToHalf(-2.5f), 0xC100);
+  EXPECT_EQ(floatToHalf(65504.0f), 0x7BFF);
+  // smallest normal and subnormal
+  EXPECT_EQ(floatToHalf(std::ldexp(1.0f, -14)), 0x0400);
+  EXPECT_EQ(floatToHalf(std::ldexp(1.0f, -24)), 0x0001);
+  // ties round to even
+  EXPECT_EQ(floatToHalf(1.0f + std::ldexp(1.0f, -11)), 0x3C00);
+  EXPECT_EQ(floatToHalf(1.0f + std::ldexp(3.0f, -11)), 0x3C02);
+  EXPECT_EQ(floatToHalf(std::ldexp(1.0f, -25)), 0x0000);
+  // out of range
+  EXPECT_EQ(floatToHalf(65520.0f), 0x7C00);
+  EXPECT_EQ(floatToHalf(-1e10f), 0xFC00);
+  EXPECT_EQ(floatToHalf(std::numeric_limits<float>::infinity()), 0x7C00);
+  EXPECT_TRUE(std::isnan(halfToFloat(floatToHalf(std::numeric_limits<float>::quiet_NaN()))));
+
+  for (uint32_t bits = 0; bits != 0x7C00; bits++) {
+    ASSERT_EQ(floatToHalf(halfToFloat(static_cast<uint16_t>(bits))), bits);
+  }
+}
+
+//
+// Float16Types Test
+//
+// Half uniform types match the size of the packed half floats.
+//
+TEST(UniformTest, Float16Types) {
+  EXPECT_EQ(sizeForUniformType(UniformType::Float16), sizeof(Float16));
+  EXPECT_EQ(sizeForUniformType(UniformType::Float16x2), sizeof(Float16x2));
+  EXPECT_EQ(sizeForUniformType(UniformType::Float16x3), sizeof(Float16x3));
+  EXPECT_EQ(sizeForUniformType(UniformType::Float16x4), sizeof(Float16x4));
+  EXPECT_EQ(sizeForUniformElementType(UniformType::Float16x4), 2u);
+  EXPECT_EQ(halfUniformType(UniformType::Float3), UniformType::Float16x3);
+  EXPECT_EQ(halfUniformType(UniformType::Int), UniformType::Int);
+
+  const float values[4] = {1.0f, -0.5f, 0.25f, 1024.0f};
+  Float16x4 packed;
+  packFloat16(&packed.x, values, 4);
+  EXPECT_EQ(packed.w.bits, 0x6400);
+  float unpacked[4] = {};
+  unpackFloat16(unpacked, &packed.x, 4);
+  for (size_t i = 0; i != 4; i++) {
+    EXPECT_EQ(unpacked[i], values[i]);
+  }
+  EXPECT_EQ(static_cast<float>(Float16(3.0f)), 3.0f);
+}
+
+//
+// PackPaddedFloat3Array Test
+//
+// Verify padded float3 values are packed for counts which are and are not multiples of 4.
+//
+TEST(UniformTest, PackPaddedFloat3Array) {
+  constexpr size_t kMaxCount = 11;
+  float src[kMaxCount * 4];
+  for (size_t i = 0; i != kMaxCount * 4; i++) {
+    src[i] = (i % 4 == 3) ? -1.0f : static_cast<float>(i);
+  }
+
+  for (size_t count = 0; count <= kMaxCount; count++) {
+    float dst[kMaxCount * 3 + 1];
+    for (float& value : dst) {
+      value = -2.0f;
+    }
+    packPaddedFloat3Array(dst, src, count);
+    for (size_t i = 0; i != count; i++) {
+      for (size_t j = 0; j != 3; j++) {
+        ASSERT_EQ(dst[i * 3 + j], src[i * 4 + j]);
+      }
+    }
+    ASSERT_EQ(dst[count * 3], -2.0f);
+  }
+}
+
+} // namespace tests
+} // namespace igl
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <benchmark/benchmark.h>
+#include <igl/NameHandle.h>
+#include <igl/RenderPipelineState.h>
+#include <igl/Texture.h>
+#include <string>
+#include <vector>
+
+namespace igl::tests {
+
+namespace {
+
+std::vector<std::string> uniformNames(size_t count) {
+  std::vector<std::string> names;
+  names.reserve(count);
+  for (size_t i = 0; i != count; ++i) {
+    names.push_back("u_uniformWithATypicallyLongName" + std::to_string(i));
+  }
+  return names;
+}
+
+} // namespace
+
+// NameHandle from strings only known at runtime, e.g. names coming from shader reflection
+void BM_NameHandle_GenFromRuntimeString(benchmark::State& state) {
+  const std::vector<std::string> names = uniformNames(64);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(genNameHandle(names[i++ & 63]));
+  }
+}
+BENCHMARK(BM_NameHandle_GenFromRuntimeString);
+
+void BM_TextureFormatProperties_FromTextureFormat(benchmark::State& state) {
+  const auto numFormats = static_cast<uint32_t>(TextureFormat::S_UInt8) + 1;
+  uint32_t i = 0;
+  for (auto _ : state) {
+    const auto format = static_cast<TextureFormat>(i++ % numFormats);
+    benchmark::DoNotOptimize(TextureFormatProperties::fromTextureFormat(format));
+  }
+}
+BENCHMARK(BM_TextureFormatProperties_FromTextureFormat);
+
+void BM_TextureFormatProperties_GetBytesPerRange(benchmark::State& state) {
+  const auto properties = TextureFormatProperties::fromTextureFormat(TextureFormat::RGBA_ASTC_4x4);
+  auto range = TextureRangeDesc::new2D(0, 0, 1024, 1024);
+  range.numMipLevels = 11;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(properties.getBytesPerRange(range));
+  }
+}
+BENCHMARK(BM_TextureFormatProperties_GetBytesPerRange);
+
+// A pipeline with the state of a typical material: two color attachments, blending and samplers
+void BM_RenderPipelineDesc_Hash(benchmark::State& state) {
+  RenderPipelineDesc desc;
+  desc.targetDesc.colorAttachments.resize(2);
+  desc.targetDesc.colorAttachments[0].textureFormat = TextureFormat::RGBA_SRGB;
+  desc.targetDesc.colorAttachments[0].blendEnabled = true;
+  desc.targetDesc.colorAttachments[0].srcRGBBlendFactor = BlendFactor::SrcAlpha;
+  desc.targetDesc.colorAttachments[0].dstRGBBlendFactor = BlendFactor::OneMinusSrcAlpha;
+  desc.targetDesc.colorAttachments[1].textureFormat = TextureFormat::RGBA_UNorm8;
+  desc.targetDesc.depthAttachmentFormat = TextureFormat::Z_UNorm24;
+  desc.cullMode = CullMode::Back;
+  desc.fragmentUnitSamplerMap[0] = IGL_NAMEHANDLE("diffuseTexture");
+  desc.fragmentUnitSamplerMap[1] = IGL_NAMEHANDLE("normalTexture");
+  desc.fragmentUnitSamplerMap[2] = IGL_NAMEHANDLE("shadowTexture");
+  desc.debugName = IGL_NAMEHANDLE("material");
+  const std::hash<RenderPipelineDesc> hash;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(hash(desc));
+  }
+}
+BENCHMARK(BM_RenderPipelineDesc_Hash);
+
+} // namespace igl::tests
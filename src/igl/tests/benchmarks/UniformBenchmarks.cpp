@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/uniform/Collection.h>
+#include <IGLU/uniform/CollectionEncoder.h>
+#include <benchmark/benchmark.h>
+#include <glm/glm.hpp>
+#include <igl/RenderCommandEncoder.h>
+#include <string>
+
+namespace igl::tests {
+
+namespace {
+
+// Discards every command, so that the benchmarks measure the CPU cost of the uniform encoders and
+// not the one of a backend
+class NullRenderCommandEncoder final : public IRenderCommandEncoder {
+ public:
+  NullRenderCommandEncoder() : IRenderCommandEncoder(nullptr) {}
+
+  void endEncoding() override {}
+  void pushDebugGroupLabel(const std::string& /*label*/, const Color& /*color*/) const override {}
+  void insertDebugEventLabel(const std::string& /*label*/, const Color& /*color*/) const override {}
+  void popDebugGroupLabel() const override {}
+  void bindViewport(const Viewport& /*viewport*/) override {}
+  void bindScissorRect(const ScissorRect& /*rect*/) override {}
+  void bindRenderPipelineState(
+      const std::shared_ptr<IRenderPipelineState>& /*pipelineState*/) override {}
+  void bindDepthStencilState(
+      const std::shared_ptr<IDepthStencilState>& /*depthStencilState*/) override {}
+  void bindBuffer(int /*index*/,
+                  uint8_t /*target*/,
+                  const std::shared_ptr<IBuffer>& /*buffer*/,
+                  size_t /*bufferOffset*/) override {}
+  void bindBytes(size_t /*index*/, uint8_t /*target*/, const void* data, size_t length) override {
+    benchmark::DoNotOptimize(data);
+    benchmark::DoNotOptimize(length);
+  }
+  void bindPushConstants(size_t /*offset*/, const void* /*data*/, size_t /*length*/) override {}
+  void bindSamplerState(size_t /*index*/,
+                        uint8_t /*target*/,
+                        const std::shared_ptr<ISamplerState>& /*samplerState*/) override {}
+  void bindUniform(const UniformDesc& uniformDesc, const void* data) override {
+    benchmark::DoNotOptimize(uniformDesc.location);
+    benchmark::DoNotOptimize(data);
+  }
+  void draw(PrimitiveType /*primitiveType*/,
+            size_t /*vertexStart*/,
+            size_t /*vertexCount*/) override {}
+  void drawIndexed(PrimitiveType /*primitiveType*/,
+                   size_t /*indexCount*/,
+                   IndexFormat /*indexFormat*/,
+                   IBuffer& /*indexBuffer*/,
+                   size_t /*indexBufferOffset*/) override {}
+  void drawInstanced(PrimitiveType /*primitiveType*/,
+                     size_t /*vertexStart*/,
+                     size_t /*vertexCount*/,
+                     uint32_t /*instanceCount*/) override {}
+  void drawIndexedInstanced(PrimitiveType /*primitiveType*/,
+                            size_t /*indexCount*/,
+                            IndexFormat /*indexFormat*/,
+                            IBuffer& /*indexBuffer*/,
+                            size_t /*indexBufferOffset*/,
+                            uint32_t /*instanceCount*/) override {}
+  void drawIndexedIndirect(PrimitiveType /*primitiveType*/,
+                           IndexFormat /*indexFormat*/,
+                           IBuffer& /*indexBuffer*/,
+                           IBuffer& /*indirectBuffer*/,
+                           size_t /*indirectBufferOffset*/) override {}
+  void multiDrawIndirect(PrimitiveType /*primitiveType*/,
+                         IBuffer& /*indirectBuffer*/,
+                         size_t /*indirectBufferOffset*/,
+                         uint32_t /*drawCount*/,
+                         uint32_t /*stride*/) override {}
+  void multiDrawIndexedIndirect(PrimitiveType /*primitiveType*/,
+                                IndexFormat /*indexFormat*/,
+                                IBuffer& /*indexBuffer*/,
+                                IBuffer& /*indirectBuffer*/,
+                                size_t /*indirectBufferOffset*/,
+                                uint32_t /*drawCount*/,
+                                uint32_t /*stride*/) override {}
+  void multiDrawIndexedIndirectCount(PrimitiveType /*primitiveType*/,
+                                     IndexFormat /*indexFormat*/,
+                                     IBuffer& /*indexBuffer*/,
+                                     IBuffer& /*indirectBuffer*/,
+                                     size_t /*indirectBufferOffset*/,
+                                     IBuffer& /*countBuffer*/,
+                                     size_t /*countBufferOffset*/,
+                                     uint32_t /*maxDrawCount*/,
+                                     uint32_t /*stride*/) override {}
+  void setStencilReferenceValue(uint32_t /*value*/) override {}
+  void setStencilReferenceValues(uint32_t /*frontValue*/, uint32_t /*backValue*/) override {}
+  void setBlendColor(Color /*color*/) override {}
+  void setDepthBias(float /*depthBias*/, float /*slopeScale*/, float /*clamp*/) override {}
+};
+
+// The uniforms of a typical material: matrices, colors and scalars, all used by the fragment
+// shader
+iglu::uniform::Collection createCollection(std::vector<NameHandle>& names) {
+  iglu::uniform::Collection collection;
+  for (int i = 0; i != 4; ++i) {
+    names.push_back(genNameHandle("matrix" + std::to_string(i)));
+    collection.set(names.back(), glm::mat4(1.0f));
+  }
+  for (int i = 0; i != 8; ++i) {
+    names.push_back(genNameHandle("color" + std::to_string(i)));
+    collection.set(names.back(), glm::vec4(1.0f));
+  }
+  for (int i = 0; i != 4; ++i) {
+    names.push_back(genNameHandle("scalar" + std::to_string(i)));
+    collection.set(names.back(), 1.0f);
+  }
+  for (size_t i = 0; i != names.size(); ++i) {
+    collection.get(names[i]).setIndex(ShaderStage::Fragment, static_cast<int>(i));
+  }
+  return collection;
+}
+
+void encodeCollection(benchmark::State& state, BackendType backendType, bool byName) {
+  std::vector<NameHandle> names;
+  const iglu::uniform::Collection collection = createCollection(names);
+  const iglu::uniform::CollectionEncoder encoder(backendType);
+  NullRenderCommandEncoder commandEncoder;
+  for (auto _ : state) {
+    if (byName) {
+      encoder(collection, commandEncoder, BindTarget::kFragment, names);
+    } else {
+      encoder(collection, commandEncoder, BindTarget::kFragment);
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * names.size()));
+}
+
+} // namespace
+
+// bindBytes() of the aligned uniform data
+void BM_UniformCollection_EncodeMetal(benchmark::State& state) {
+  encodeCollection(state, BackendType::Metal, false);
+}
+BENCHMARK(BM_UniformCollection_EncodeMetal);
+
+// Same as above with a lookup of every uniform by name
+void BM_UniformCollection_EncodeMetalByName(benchmark::State& state) {
+  encodeCollection(state, BackendType::Metal, true);
+}
+BENCHMARK(BM_UniformCollection_EncodeMetalByName);
+
+#if IGL_BACKEND_OPENGL
+// bindUniform() of the packed uniform data
+void BM_UniformCollection_EncodeOpenGL(benchmark::State& state) {
+  encodeCollection(state, BackendType::OpenGL, false);
+}
+BENCHMARK(BM_UniformCollection_EncodeOpenGL);
+#endif // IGL_BACKEND_OPENGL
+
+} // namespace igl::tests
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <igl/opengl/Memcpy.h>
+#include <vector>
+
+namespace igl::tests {
+
+// From a single float to a large uniform block. The baseline is BM_Memcpy with the same sizes.
+void BM_OptimizedMemcpy(benchmark::State& state) {
+  const auto size = static_cast<size_t>(state.range(0));
+  // float alignment, as expected by optimizedMemcpy()
+  std::vector<float> src(size / sizeof(float), 1.0f);
+  std::vector<float> dst(size / sizeof(float));
+  for (auto _ : state) {
+    igl::opengl::optimizedMemcpy(dst.data(), src.data(), size);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+BENCHMARK(BM_OptimizedMemcpy)->RangeMultiplier(4)->Range(4, 64 << 10);
+
+void BM_Memcpy(benchmark::State& state) {
+  const auto size = static_cast<size_t>(state.range(0));
+  std::vector<float> src(size / sizeof(float), 1.0f);
+  std::vector<float> dst(size / sizeof(float));
+  for (auto _ : state) {
+    std::memcpy(dst.data(), src.data(), size);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+BENCHMARK(BM_Memcpy)->RangeMultiplier(4)->Range(4, 64 << 10);
+
+} // namespace igl::tests
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <benchmark/benchmark.h>
+#include <igl/tests/util/device/vulkan/TestDevice.h>
+#include <igl/vulkan/Device.h>
+#include <igl/vulkan/ResourcesBinder.h>
+#include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
+
+namespace igl::tests {
+
+namespace {
+
+// Bindings with a typical number of textures, samplers and buffers
+vulkan::Bindings createBindings() {
+  vulkan::Bindings bindings;
+  for (uint32_t i = 0; i != 8; ++i) {
+    bindings.slots[i].texture = 100 + i;
+    bindings.slots[i].sampler = i % 2;
+  }
+  for (uint32_t i = 0; i != 4; ++i) {
+    bindings.slots[i].buffer = 0x10000000ull + 256 * i;
+  }
+  return bindings;
+}
+
+} // namespace
+
+// The lookup key of the descriptor set caches
+void BM_Bindings_Hash(benchmark::State& state) {
+  const vulkan::Bindings bindings = createBindings();
+  const vulkan::Bindings::HashFunction hash;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(hash(bindings));
+  }
+}
+BENCHMARK(BM_Bindings_Hash);
+
+// Equal bindings, i.e. the whole struct is compared
+void BM_Bindings_Equal(benchmark::State& state) {
+  const vulkan::Bindings bindings = createBindings();
+  const vulkan::Bindings other = createBindings();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(bindings == other);
+  }
+}
+BENCHMARK(BM_Bindings_Equal);
+
+// Acquires and submits an empty command buffer, which includes waiting for the GPU whenever all
+// the command buffers of VulkanImmediateCommands are in flight
+void BM_VulkanImmediateCommands_AcquireSubmit(benchmark::State& state) {
+  const std::shared_ptr<IDevice> device = util::device::vulkan::createTestDevice();
+  if (!device) {
+    state.SkipWithError("Vulkan is not available");
+    return;
+  }
+  vulkan::VulkanImmediateCommands& immediate =
+      *static_cast<vulkan::Device&>(*device).getVulkanContext().immediate_;
+  for (auto _ : state) {
+    const auto& wrapper = immediate.acquire();
+    benchmark::DoNotOptimize(immediate.submit(wrapper));
+  }
+  immediate.waitAll();
+}
+BENCHMARK(BM_VulkanImmediateCommands_AcquireSubmit);
+
+} // namespace igl::tests
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <cstddef> // For size_t/
+#include <cstdint>
 #include <igl/opengl/Macros.h>
 
 namespace igl {
@@ -33,6 +34,10 @@ const char simpleComputeInput[] = "floatsIn";
 const char simpleComputeOutput[] = "floatsOut";
 const size_t simpleComputeInputIndex = 0;
 const size_t simpleComputeOutputIndex = 1;
+// Computes floatsOut = floatsIn * kScale + kOffset with specialization constants
+const char specializedComputeFunc[] = "specializedKernel";
+const uint32_t specializedComputeScaleId = 0;
+const uint32_t specializedComputeOffsetId = 1;
 
 // clang-format off
 //-----------------------------------------------------------------------------
@@ -229,6 +234,25 @@ const char OGL_SIMPLE_COMPUTE_SHADER[] =
             fOut[id] = fIn[id] * 2.0f;
         });
 
+// Same as OGL_SIMPLE_COMPUTE_SHADER, with kScale and kOffset defined by specialization constants
+const char OGL_SPECIALIZED_COMPUTE_SHADER[] =
+  IGL_TO_STRING(VERSION(310 es)
+        precision highp float;
+
+        layout (local_size_x = 6, local_size_y = 1, local_size_z = 1) in;
+        layout (std430, binding = 0) readonly buffer floatsIn {
+          float fIn[];
+        };
+        layout (std430, binding = 1) writeonly buffer floatsOut {
+          float fOut[];
+        };
+
+        void main() {
+            uint id = gl_LocalInvocationIndex;
+
+            fOut[id] = fIn[id] * kScale + float(kOffset);
+        });
+
 const char OGL_SIMPLE_VERT_SHADER_UNIFORM_BLOCKS[] =
       IGL_TO_STRING(VERSION(300 es)
       in vec4 position_in; out vec3 uv;
@@ -378,6 +402,20 @@ const char MTL_SIMPLE_COMPUTE_SHADER[] =
         floatsOut[gid.x] = floatsIn[gid.x] * 2.0;
       });
 
+// Same as MTL_SIMPLE_COMPUTE_SHADER, with kScale and kOffset defined by function constants
+const char MTL_SPECIALIZED_COMPUTE_SHADER[] =
+  IGL_TO_STRING(using namespace metal;
+
+      constant float kScale [[function_constant(0)]];
+      constant int kOffset [[function_constant(1)]];
+
+      kernel void specializedKernel(
+          device float* floatsIn [[buffer(0)]],
+          device float* floatsOut [[buffer(1)]],
+          uint2 gid [[thread_position_in_grid]]) {
+        floatsOut[gid.x] = floatsIn[gid.x] * kScale + float(kOffset);
+      });
+
 const char MTL_SIMPLE_SHADER_TXT_1D_ARRAY[] =
     IGL_TO_STRING(using namespace metal;
 
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+
+#include <IGLU/dynamic_resolution/DynamicResolution.h>
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace tests {
+
+using iglu::dynamicresolution::DynamicResolutionController;
+using iglu::dynamicresolution::DynamicResolutionDesc;
+
+namespace {
+
+// GPU time of a frame which takes `fullResolutionMs` at scale 1
+float getGpuTimeMs(float fullResolutionMs, float scale) {
+  return fullResolutionMs * scale * scale;
+}
+
+} // namespace
+
+class DynamicResolutionTest : public ::testing::Test {
+ public:
+  DynamicResolutionTest() = default;
+  ~DynamicResolutionTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+  void TearDown() override {}
+
+ public:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+};
+
+TEST_F(DynamicResolutionTest, ScalesDownToBudget) {
+  DynamicResolutionDesc desc;
+  desc.targetGpuTimeMs = 10.0f;
+  DynamicResolutionController controller(*iglDev_, desc);
+  ASSERT_EQ(controller.getScale(), desc.maxScale);
+
+  for (int frame = 0; frame != 100; frame++) {
+    const float scale = controller.getScale();
+    controller.addGpuTimeSample(getGpuTimeMs(20.0f, scale), scale);
+  }
+
+  const float scale = controller.getScale();
+  EXPECT_LT(scale, 0.75f);
+  EXPECT_GE(scale, desc.minScale);
+  EXPECT_LE(getGpuTimeMs(20.0f, scale), desc.targetGpuTimeMs);
+  EXPECT_GT(getGpuTimeMs(20.0f, scale + 2 * desc.scaleStep), desc.targetGpuTimeMs * desc.headroom);
+}
+
+TEST_F(DynamicResolutionTest, ClampsToMinScale) {
+  DynamicResolutionDesc desc;
+  desc.targetGpuTimeMs = 10.0f;
+  DynamicResolutionController controller(*iglDev_, desc);
+
+  for (int frame = 0; frame != 100; frame++) {
+    const float scale = controller.getScale();
+    controller.addGpuTimeSample(getGpuTimeMs(100.0f, scale), scale);
+  }
+  EXPECT_EQ(controller.getScale(), desc.minScale);
+}
+
+TEST_F(DynamicResolutionTest, ScalesUpGradually) {
+  DynamicResolutionDesc desc;
+  desc.targetGpuTimeMs = 10.0f;
+  DynamicResolutionController controller(*iglDev_, desc);
+
+  for (int frame = 0; frame != 100; frame++) {
+    const float scale = controller.getScale();
+    controller.addGpuTimeSample(getGpuTimeMs(100.0f, scale), scale);
+  }
+  ASSERT_EQ(controller.getScale(), desc.minScale);
+
+  // the load drops: the scale must grow back, but not faster than allowed after rounding
+  const float maxIncrease = std::max(desc.maxScaleIncreasePerFrame, desc.scaleStep) + 1e-4f;
+  float previousScale = controller.getScale();
+  for (int frame = 0; frame != 200; frame++) {
+    const float scale = controller.getScale();
+    controller.addGpuTimeSample(getGpuTimeMs(2.0f, scale), scale);
+    EXPECT_LE(controller.getScale(), previousScale + maxIncrease);
+    previousScale = controller.getScale();
+  }
+  EXPECT_EQ(controller.getScale(), desc.maxScale);
+}
+
+TEST_F(DynamicResolutionTest, IgnoresStaleSamples) {
+  DynamicResolutionDesc desc;
+  desc.targetGpuTimeMs = 10.0f;
+  DynamicResolutionController controller(*iglDev_, desc);
+
+  for (int frame = 0; frame != 100; frame++) {
+    const float scale = controller.getScale();
+    controller.addGpuTimeSample(getGpuTimeMs(20.0f, scale), scale);
+  }
+  const float scale = controller.getScale();
+
+  // late results of frames rendered at full resolution are normalized to the current scale
+  for (int frame = 0; frame != 3; frame++) {
+    controller.addGpuTimeSample(getGpuTimeMs(20.0f, 1.0f), 1.0f);
+  }
+  EXPECT_GE(controller.getScale(), scale - desc.scaleStep);
+}
+
+TEST_F(DynamicResolutionTest, Viewport) {
+  DynamicResolutionDesc desc;
+  desc.targetGpuTimeMs = 10.0f;
+  desc.minScale = 0.5f;
+  DynamicResolutionController controller(*iglDev_, desc);
+
+  const Dimensions outputSize(1000, 500, 1);
+  const Dimensions renderTargetSize = controller.getRenderTargetSize(outputSize);
+  EXPECT_EQ(renderTargetSize, Dimensions(1000, 500, 1));
+
+  for (int frame = 0; frame != 100; frame++) {
+    const float scale = controller.getScale();
+    controller.addGpuTimeSample(getGpuTimeMs(100.0f, scale), scale);
+  }
+  ASSERT_EQ(controller.getScale(), 0.5f);
+
+  // the render targets do not change size
+  EXPECT_EQ(controller.getRenderTargetSize(outputSize), renderTargetSize);
+  EXPECT_EQ(controller.getScaledSize(outputSize), Dimensions(500, 250, 1));
+
+  const Viewport viewport = controller.getViewport(outputSize);
+  EXPECT_EQ(viewport.x, 0.0f);
+  EXPECT_EQ(viewport.y, 0.0f);
+  EXPECT_EQ(viewport.width, 500.0f);
+  EXPECT_EQ(viewport.height, 250.0f);
+
+  const ScissorRect scissor = controller.getScissor(outputSize);
+  EXPECT_EQ(scissor.x, 0u);
+  EXPECT_EQ(scissor.y, 0u);
+  EXPECT_EQ(scissor.width, 500u);
+  EXPECT_EQ(scissor.height, 250u);
+
+  const Size uvScale = controller.getUVScale(outputSize);
+  EXPECT_FLOAT_EQ(uvScale.width, 0.5f);
+  EXPECT_FLOAT_EQ(uvScale.height, 0.5f);
+  const Size uvMax = controller.getUVMax(outputSize);
+  EXPECT_FLOAT_EQ(uvMax.width, 499.5f / 1000.0f);
+  EXPECT_FLOAT_EQ(uvMax.height, 249.5f / 500.0f);
+}
+
+TEST_F(DynamicResolutionTest, TimersDoNotBlock) {
+  DynamicResolutionController controller(*iglDev_);
+
+  for (int frame = 0; frame != 3; frame++) {
+    Result ret;
+    auto cmdBuffer = cmdQueue_->createCommandBuffer({}, &ret);
+    ASSERT_TRUE(ret.isOk());
+    controller.beginFrame(*cmdBuffer);
+    controller.endFrame(*cmdBuffer);
+    cmdQueue_->submit(*cmdBuffer);
+    cmdBuffer->waitUntilCompleted();
+  }
+  EXPECT_GE(controller.getScale(), DynamicResolutionDesc().minScale);
+  EXPECT_LE(controller.getScale(), DynamicResolutionDesc().maxScale);
+}
+
+} // namespace tests
+} // namespace igl
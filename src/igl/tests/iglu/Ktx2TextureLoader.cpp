@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/texture_loader/Ktx2TextureLoader.h>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace igl {
+namespace tests {
+
+namespace {
+
+using iglu::textureloader::Ktx2Image;
+
+void write32(std::vector<uint8_t>& data, size_t offset, uint32_t value) {
+  memcpy(data.data() + offset, &value, sizeof(value));
+}
+
+void write64(std::vector<uint8_t>& data, size_t offset, uint64_t value) {
+  memcpy(data.data() + offset, &value, sizeof(value));
+}
+
+// A 4x4 image with 3 mip levels and a data format descriptor, but no level data
+std::vector<uint8_t> createKtx2(uint32_t vkFormat, uint32_t supercompression, uint8_t colorModel) {
+  constexpr uint8_t kIdentifier[12] = {
+      0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+  constexpr uint32_t kNumLevels = 3;
+  constexpr size_t kDfdOffset = 80 + kNumLevels * 24;
+  constexpr size_t kDfdLength = 44;
+
+  std::vector<uint8_t> data(kDfdOffset + kDfdLength + 32, 0);
+  memcpy(data.data(), kIdentifier, sizeof(kIdentifier));
+  write32(data, 12, vkFormat);
+  write32(data, 20, 4); // width
+  write32(data, 24, 4); // height
+  write32(data, 36, 1); // faces
+  write32(data, 40, kNumLevels);
+  write32(data, 44, supercompression);
+  write32(data, 48, kDfdOffset);
+  write32(data, 52, kDfdLength);
+  for (uint32_t i = 0; i != kNumLevels; i++) {
+    write64(data, 80 + i * 24, kDfdOffset + kDfdLength);
+    write64(data, 80 + i * 24 + 8, 32 >> i);
+  }
+  data[kDfdOffset + 12] = colorModel;
+  data[kDfdOffset + 14] = 2; // sRGB transfer function
+  return data;
+}
+
+} // namespace
+
+//
+// Ktx2TextureLoaderTest
+//
+// Parsing of KTX2 containers and selection of the formats they are uploaded as.
+//
+TEST(Ktx2TextureLoaderTest, ParseNativeFormat) {
+  const auto data = createKtx2(157 /* VK_FORMAT_ASTC_4x4_UNORM_BLOCK */, 0, 0);
+
+  Result result;
+  auto image = Ktx2Image::create(data.data(), data.size(), &result);
+  ASSERT_TRUE(result.isOk());
+  ASSERT_NE(image, nullptr);
+  ASSERT_EQ(image->getWidth(), 4u);
+  ASSERT_EQ(image->getHeight(), 4u);
+  ASSERT_EQ(image->getDepth(), 1u);
+  ASSERT_EQ(image->getNumLayers(), 1u);
+  ASSERT_EQ(image->getNumFaces(), 1u);
+  ASSERT_EQ(image->getNumMipLevels(), 3u);
+  ASSERT_EQ(image->getLevel(1).byteLength, 16u);
+  ASSERT_TRUE(image->isSrgb());
+  ASSERT_FALSE(image->needsTranscoding());
+  ASSERT_EQ(image->getNativeFormat(), TextureFormat::RGBA_ASTC_4x4);
+
+  const auto etc2 = createKtx2(152 /* VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK */, 0, 0);
+  image = Ktx2Image::create(etc2.data(), etc2.size(), &result);
+  ASSERT_TRUE(result.isOk());
+  ASSERT_EQ(image->getNativeFormat(), TextureFormat::SRGB8_A8_EAC_ETC2);
+
+  const auto astc = createKtx2(184 /* VK_FORMAT_ASTC_12x12_SRGB_BLOCK */, 0, 0);
+  image = Ktx2Image::create(astc.data(), astc.size(), &result);
+  ASSERT_TRUE(result.isOk());
+  ASSERT_EQ(image->getNativeFormat(), TextureFormat::SRGB8_A8_ASTC_12x12);
+}
+
+TEST(Ktx2TextureLoaderTest, ParseBasis) {
+  // ETC1S is always BasisLZ supercompressed
+  auto data = createKtx2(0, 1, 163);
+  Result result;
+  auto image = Ktx2Image::create(data.data(), data.size(), &result);
+  ASSERT_TRUE(result.isOk());
+  ASSERT_TRUE(image->needsTranscoding());
+  ASSERT_EQ(image->getNativeFormat(), TextureFormat::Invalid);
+
+  // UASTC, optionally Zstandard supercompressed
+  data = createKtx2(0, 2, 166);
+  image = Ktx2Image::create(data.data(), data.size(), &result);
+  ASSERT_TRUE(result.isOk());
+  ASSERT_TRUE(image->needsTranscoding());
+  ASSERT_EQ(image->getSupercompression(), Ktx2Image::Supercompression::Zstandard);
+}
+
+TEST(Ktx2TextureLoaderTest, ParseInvalid) {
+  auto data = createKtx2(157, 0, 0);
+  Result result;
+
+  ASSERT_EQ(Ktx2Image::create(data.data(), 40, &result), nullptr);
+  ASSERT_FALSE(result.isOk());
+
+  data[0] = 0;
+  ASSERT_EQ(Ktx2Image::create(data.data(), data.size(), &result), nullptr);
+  ASSERT_FALSE(result.isOk());
+
+  // level past the end of the file
+  data = createKtx2(157, 0, 0);
+  write64(data, 80 + 8, data.size());
+  ASSERT_EQ(Ktx2Image::create(data.data(), data.size(), &result), nullptr);
+  ASSERT_FALSE(result.isOk());
+}
+
+} // namespace tests
+} // namespace igl
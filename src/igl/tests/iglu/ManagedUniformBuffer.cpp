@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+
+#include <IGLU/managedUniformBuffer/ManagedUniformBuffer.h>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace tests {
+
+class ManagedUniformBufferTest : public ::testing::Test {
+ public:
+  ManagedUniformBufferTest() = default;
+  ~ManagedUniformBufferTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+  void TearDown() override {}
+
+  static iglu::ManagedUniformBufferInfo createInfo() {
+    iglu::ManagedUniformBufferInfo info;
+    info.index = 1;
+    info.length = sizeof(float[8]);
+    info.uniforms.resize(2);
+    info.uniforms[0].name = "color";
+    info.uniforms[0].type = UniformType::Float4;
+    info.uniforms[0].offset = 0;
+    info.uniforms[1].name = "scale";
+    info.uniforms[1].type = UniformType::Float4;
+    info.uniforms[1].offset = sizeof(float[4]);
+    return info;
+  }
+
+ public:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+};
+
+//
+// UpdateDataByIndex Test
+//
+// Uniforms resolved once by name are updated through their index.
+//
+TEST_F(ManagedUniformBufferTest, UpdateDataByIndex) {
+  iglu::ManagedUniformBuffer buffer(*iglDev_, createInfo());
+  ASSERT_TRUE(buffer.result.isOk()) << buffer.result.message;
+
+  const int scaleIndex = buffer.getUniformIndex("scale");
+  EXPECT_EQ(scaleIndex, 1);
+  EXPECT_EQ(buffer.getUniformIndex("missing"), -1);
+
+  const float scale[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+  EXPECT_TRUE(buffer.updateData(scaleIndex, scale, sizeof(scale)));
+  EXPECT_EQ(std::memcmp(static_cast<const uint8_t*>(buffer.getData()) + sizeof(float[4]),
+                        scale,
+                        sizeof(scale)),
+            0);
+
+  EXPECT_FALSE(buffer.updateData(2, scale, sizeof(scale)));
+  EXPECT_FALSE(buffer.updateData(-1, scale, sizeof(scale)));
+}
+
+//
+// RingBufferMode Test
+//
+// A buffer sub-allocated from a ring buffer does not create its own buffer.
+//
+TEST_F(ManagedUniformBufferTest, RingBufferMode) {
+  RingBufferDesc ringBufferDesc;
+  ringBufferDesc.type = BufferDesc::BufferTypeBits::Uniform;
+  ringBufferDesc.length = 4096;
+  auto ringBuffer = iglDev_->createRingBuffer(ringBufferDesc, nullptr);
+  if (!ringBuffer) {
+    GTEST_SKIP() << "Ring buffers are not supported";
+  }
+
+  iglu::ManagedUniformBufferInfo info = createInfo();
+  info.ringBuffer = ringBuffer.get();
+  iglu::ManagedUniformBuffer buffer(*iglDev_, info);
+  ASSERT_TRUE(buffer.result.isOk()) << buffer.result.message;
+
+  const float color[4] = {0.5f, 0.5f, 0.5f, 1.0f};
+  EXPECT_TRUE(buffer.updateData("color", color, sizeof(color)));
+  EXPECT_EQ(std::memcmp(buffer.getData(), color, sizeof(color)), 0);
+}
+
+} // namespace tests
+} // namespace igl
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/simple_renderer/MeshPreparation.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace tests {
+
+using iglu::vertexdata::MeshAttributes;
+using iglu::vertexdata::MeshPreparationDesc;
+using iglu::vertexdata::PreparedMesh;
+
+namespace {
+
+struct Vertex {
+  float position[3];
+  float normal[3];
+  float uv[2];
+};
+
+// A quad as an unindexed triangle list, facing -Z
+const Vertex kQuad[] = {
+    {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f}},
+    {{1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {2.0f, 0.0f}},
+    {{1.0f, 1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {2.0f, 2.0f}},
+    {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f}},
+    {{1.0f, 1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {2.0f, 2.0f}},
+    {{0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 2.0f}},
+};
+
+MeshAttributes quadAttributes() {
+  MeshAttributes attributes;
+  attributes.positions = kQuad[0].position;
+  attributes.positionStride = sizeof(Vertex);
+  attributes.normals = kQuad[0].normal;
+  attributes.normalStride = sizeof(Vertex);
+  attributes.uvs = kQuad[0].uv;
+  attributes.uvStride = sizeof(Vertex);
+  attributes.numVertices = sizeof(kQuad) / sizeof(kQuad[0]);
+  return attributes;
+}
+
+} // namespace
+
+//
+// Quantized Test
+//
+// Equal vertices are merged and the attributes are packed in 16 bytes per vertex.
+//
+TEST(MeshPreparationTest, Quantized) {
+  const PreparedMesh mesh = iglu::vertexdata::prepareMesh(quadAttributes());
+
+  ASSERT_EQ(mesh.numVertices, 4u);
+  ASSERT_EQ(mesh.numIndices, 6u);
+  EXPECT_EQ(mesh.indexFormat, IndexFormat::UInt16);
+  EXPECT_EQ(mesh.indices.size(), 6 * sizeof(uint16_t));
+
+  const VertexInputStateDesc& inputDesc = mesh.inputStateDesc;
+  ASSERT_EQ(inputDesc.numAttributes, 3u);
+  EXPECT_EQ(inputDesc.attributes[0].format, VertexAttributeFormat::HalfFloat4);
+  EXPECT_EQ(inputDesc.attributes[1].format, VertexAttributeFormat::Short2Norm);
+  EXPECT_EQ(inputDesc.attributes[2].format, VertexAttributeFormat::UShort2Norm);
+  ASSERT_EQ(inputDesc.numInputBindings, 1u);
+  EXPECT_EQ(inputDesc.inputBindings[0].stride, 16u);
+  EXPECT_EQ(mesh.vertices.size(), 4 * 16u);
+
+  EXPECT_EQ(mesh.uvOffset[0], 0.0f);
+  EXPECT_EQ(mesh.uvScale[0], 2.0f);
+
+  // decodes the octahedral normal of the first vertex
+  int16_t encoded[2];
+  std::memcpy(encoded, mesh.vertices.data() + inputDesc.attributes[1].offset, sizeof(encoded));
+  float n[3] = {std::max(encoded[0] / 32767.0f, -1.0f), std::max(encoded[1] / 32767.0f, -1.0f)};
+  n[2] = 1.0f - std::abs(n[0]) - std::abs(n[1]);
+  const float t = std::max(-n[2], 0.0f);
+  n[0] += n[0] >= 0.0f ? -t : t;
+  n[1] += n[1] >= 0.0f ? -t : t;
+  EXPECT_NEAR(n[0], 0.0f, 1e-3f);
+  EXPECT_NEAR(n[1], 0.0f, 1e-3f);
+  EXPECT_NEAR(n[2], -1.0f, 1e-3f);
+}
+
+//
+// HalfUVs Test
+//
+// Half float uvs keep their values, with no remapping to the range of the mesh.
+//
+TEST(MeshPreparationTest, HalfUVs) {
+  MeshPreparationDesc desc;
+  desc.halfUVs = true;
+  const PreparedMesh mesh = iglu::vertexdata::prepareMesh(quadAttributes(), desc);
+
+  ASSERT_EQ(mesh.numVertices, 4u);
+  const VertexInputStateDesc& inputDesc = mesh.inputStateDesc;
+  ASSERT_EQ(inputDesc.numAttributes, 3u);
+  EXPECT_EQ(inputDesc.attributes[2].format, VertexAttributeFormat::HalfFloat2);
+  EXPECT_EQ(inputDesc.inputBindings[0].stride, 16u);
+  EXPECT_EQ(mesh.uvOffset[0], 0.0f);
+  EXPECT_EQ(mesh.uvScale[0], 1.0f);
+
+  for (size_t i = 0; i != mesh.numVertices; ++i) {
+    Float16 uv[2];
+    std::memcpy(uv, mesh.vertices.data() + i * 16 + inputDesc.attributes[2].offset, sizeof(uv));
+    for (const Float16 c : uv) {
+      EXPECT_TRUE(static_cast<float>(c) == 0.0f || static_cast<float>(c) == 2.0f);
+    }
+  }
+}
+
+//
+// Unquantized Test
+//
+// Without quantization the attributes are interleaved as floats.
+//
+TEST(MeshPreparationTest, Unquantized) {
+  MeshPreparationDesc desc;
+  desc.quantize = false;
+  const PreparedMesh mesh = iglu::vertexdata::prepareMesh(quadAttributes(), desc);
+
+  ASSERT_EQ(mesh.numVertices, 4u);
+  EXPECT_EQ(mesh.inputStateDesc.inputBindings[0].stride, sizeof(Vertex));
+  EXPECT_EQ(mesh.inputStateDesc.attributes[0].format, VertexAttributeFormat::Float3);
+
+  // every index refers to a vertex with the same position as the source triangle list
+  const auto* indices = reinterpret_cast<const uint16_t*>(mesh.indices.data());
+  float positions[6][3];
+  for (size_t i = 0; i != mesh.numIndices; ++i) {
+    std::memcpy(positions[i], mesh.vertices.data() + indices[i] * sizeof(Vertex), sizeof(float[3]));
+  }
+  for (const Vertex& vertex : kQuad) {
+    bool found = false;
+    for (const auto& position : positions) {
+      found |= std::memcmp(position, vertex.position, sizeof(float[3])) == 0;
+    }
+    EXPECT_TRUE(found);
+  }
+
+  EXPECT_TRUE(iglu::vertexdata::prepareMesh(MeshAttributes{}).vertices.empty());
+}
+
+} // namespace tests
+} // namespace igl
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/meshlet/MeshletBuilder.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace igl {
+namespace tests {
+
+//
+// BuildMeshlets Test
+//
+// A grid is split into meshlets which respect the limits and cover every triangle once.
+//
+TEST(MeshletTest, BuildMeshlets) {
+  constexpr uint32_t kSize = 32;
+  std::vector<float> positions;
+  for (uint32_t y = 0; y != kSize; ++y) {
+    for (uint32_t x = 0; x != kSize; ++x) {
+      positions.insert(positions.end(), {float(x), float(y), 0.0f});
+    }
+  }
+  std::vector<uint32_t> indices;
+  for (uint32_t y = 0; y != kSize - 1; ++y) {
+    for (uint32_t x = 0; x != kSize - 1; ++x) {
+      const uint32_t v = y * kSize + x;
+      indices.insert(indices.end(), {v, v + 1, v + kSize, v + 1, v + kSize + 1, v + kSize});
+    }
+  }
+
+  iglu::meshlet::MeshletBuilderDesc desc;
+  const iglu::meshlet::MeshletMesh mesh = iglu::meshlet::buildMeshlets(positions.data(),
+                                                                       sizeof(float) * 3,
+                                                                       kSize * kSize,
+                                                                       indices.data(),
+                                                                       indices.size(),
+                                                                       desc);
+
+  ASSERT_FALSE(mesh.meshlets.empty());
+  ASSERT_EQ(mesh.cullData.size(), mesh.meshlets.size());
+  EXPECT_EQ(mesh.indices.size(), indices.size());
+
+  uint32_t firstIndex = 0;
+  for (size_t i = 0; i != mesh.meshlets.size(); ++i) {
+    const iglu::meshlet::Meshlet& meshlet = mesh.meshlets[i];
+    EXPECT_LE(meshlet.vertexCount, desc.maxVertices);
+    EXPECT_LE(meshlet.triangleCount, desc.maxTriangles);
+    EXPECT_EQ(mesh.cullData[i].firstIndex, firstIndex);
+    EXPECT_EQ(mesh.cullData[i].indexCount, meshlet.triangleCount * 3);
+    EXPECT_GT(mesh.cullData[i].sphere[3], 0.0f);
+    firstIndex += mesh.cullData[i].indexCount;
+  }
+}
+
+} // namespace tests
+} // namespace igl
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+
+#include <IGLU/occlusion_culling/DepthPyramid.h>
+#include <IGLU/occlusion_culling/OcclusionCuller.h>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace tests {
+
+using iglu::occlusion::DepthPyramid;
+using iglu::occlusion::OcclusionCuller;
+using iglu::occlusion::OcclusionCullerDesc;
+
+class OcclusionCullingTest : public ::testing::Test {
+ public:
+  OcclusionCullingTest() = default;
+  ~OcclusionCullingTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+
+  void TearDown() override {}
+
+ protected:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+};
+
+TEST_F(OcclusionCullingTest, PyramidLevels) {
+  const auto levels = DepthPyramid::computeLevels(8, 8);
+  ASSERT_EQ(levels.size(), 3u);
+  EXPECT_EQ(levels[0].width, 4u);
+  EXPECT_EQ(levels[1].offset, 16u);
+  EXPECT_EQ(levels[2].width, 1u);
+  EXPECT_EQ(levels[2].offset, 20u);
+
+  // odd and non-square sizes are rounded down, down to 1x1
+  const auto oddLevels = DepthPyramid::computeLevels(5, 3);
+  ASSERT_EQ(oddLevels.size(), 2u);
+  EXPECT_EQ(oddLevels[0].width, 2u);
+  EXPECT_EQ(oddLevels[0].height, 1u);
+  EXPECT_EQ(oddLevels[1].width, 1u);
+  EXPECT_EQ(oddLevels[1].height, 1u);
+  EXPECT_EQ(oddLevels[1].offset, 2u);
+
+  EXPECT_TRUE(DepthPyramid::computeLevels(1, 1).empty());
+}
+
+TEST_F(OcclusionCullingTest, CreatePyramidAndCuller) {
+  Result ret;
+  const DepthPyramid pyramid(*iglDev_, 64, 32, &ret);
+  if (!DepthPyramid::isSupported(*iglDev_)) {
+    EXPECT_EQ(ret.code, Result::Code::Unsupported);
+    EXPECT_TRUE(pyramid.getBuffer() == nullptr);
+    GTEST_SKIP() << "Depth pyramids are not supported";
+  }
+  ASSERT_TRUE(ret.isOk()) << ret.message.c_str();
+  ASSERT_TRUE(pyramid.getBuffer() != nullptr);
+  EXPECT_EQ(pyramid.getLevels().size(), 6u);
+
+  if (!OcclusionCuller::isSupported(*iglDev_)) {
+    return;
+  }
+  OcclusionCullerDesc desc;
+  desc.instances.resize(3);
+  desc.instances[1].sphere[3] = 1.0f;
+  desc.instances[1].indexCount = 36;
+  desc.debugName = "test";
+  const OcclusionCuller culler(*iglDev_, pyramid, std::move(desc), &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message.c_str();
+  EXPECT_EQ(culler.numInstances(), 3u);
+  EXPECT_EQ(culler.isCompacted(), iglDev_->hasFeature(DeviceFeatures::MultiDrawIndirectCount));
+  ASSERT_TRUE(culler.getDrawCommandBuffer() != nullptr);
+  EXPECT_EQ(culler.getDrawCommandBuffer()->getSizeInBytes(),
+            OcclusionCuller::kDrawCommandsOffset + 3 * IGL_DRAW_ELEMENTS_INDIRECT_COMMAND_SIZE);
+}
+
+TEST_F(OcclusionCullingTest, NoInstances) {
+  if (!OcclusionCuller::isSupported(*iglDev_)) {
+    GTEST_SKIP() << "Occlusion culling is not supported";
+  }
+  Result ret;
+  const DepthPyramid pyramid(*iglDev_, 16, 16, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message.c_str();
+
+  const OcclusionCuller culler(*iglDev_, pyramid, OcclusionCullerDesc(), &ret);
+  EXPECT_EQ(ret.code, Result::Code::ArgumentInvalid);
+  EXPECT_EQ(culler.numInstances(), 0u);
+}
+
+} // namespace tests
+} // namespace igl
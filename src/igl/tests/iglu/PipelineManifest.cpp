@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../data/ShaderData.h"
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+
+#include <IGLU/pipeline_manifest/PipelineRecorder.h>
+#include <IGLU/pipeline_manifest/PipelineWarmUp.h>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace tests {
+
+using iglu::pipelinemanifest::PipelineManifest;
+using iglu::pipelinemanifest::PipelineRecorder;
+using iglu::pipelinemanifest::RenderPipelineVariant;
+using iglu::pipelinemanifest::WarmedUpPipelines;
+
+class PipelineManifestTest : public ::testing::Test {
+ public:
+  PipelineManifestTest() = default;
+  ~PipelineManifestTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+  void TearDown() override {}
+
+  // creates the simple pipeline of the tests through the recorder
+  std::shared_ptr<IRenderPipelineState> createPipeline(PipelineRecorder& recorder) {
+    const char* vertexSource = nullptr;
+    const char* fragmentSource = nullptr;
+    const char* vertexEntryPoint = data::shader::shaderFunc;
+    const char* fragmentEntryPoint = data::shader::shaderFunc;
+    switch (iglDev_->getBackendType()) {
+    case BackendType::OpenGL:
+      vertexSource = data::shader::OGL_SIMPLE_VERT_SHADER;
+      fragmentSource = data::shader::OGL_SIMPLE_FRAG_SHADER;
+      break;
+    case BackendType::Vulkan:
+      vertexSource = data::shader::VULKAN_SIMPLE_VERT_SHADER;
+      fragmentSource = data::shader::VULKAN_SIMPLE_FRAG_SHADER;
+      break;
+    case BackendType::Metal:
+      vertexSource = fragmentSource = data::shader::MTL_SIMPLE_SHADER;
+      vertexEntryPoint = data::shader::simpleVertFunc;
+      fragmentEntryPoint = data::shader::simpleFragFunc;
+      break;
+    default:
+      return nullptr;
+    }
+
+    Result ret;
+    auto vertexModule = recorder.createShaderModule(
+        ShaderModuleDesc::fromStringInput(
+            vertexSource, {ShaderStage::Vertex, vertexEntryPoint}, "simple.vert"),
+        &ret);
+    EXPECT_TRUE(ret.isOk()) << ret.message;
+    auto fragmentModule = recorder.createShaderModule(
+        ShaderModuleDesc::fromStringInput(
+            fragmentSource, {ShaderStage::Fragment, fragmentEntryPoint}, "simple.frag"),
+        &ret);
+    EXPECT_TRUE(ret.isOk()) << ret.message;
+
+    VertexInputStateDesc inputDesc;
+    inputDesc.attributes[0].format = VertexAttributeFormat::Float4;
+    inputDesc.attributes[0].bufferIndex = data::shader::simplePosIndex;
+    inputDesc.attributes[0].name = data::shader::simplePos;
+    inputDesc.attributes[0].location = 0;
+    inputDesc.inputBindings[0].stride = sizeof(float) * 4;
+    inputDesc.attributes[1].format = VertexAttributeFormat::Float2;
+    inputDesc.attributes[1].bufferIndex = data::shader::simpleUvIndex;
+    inputDesc.attributes[1].name = data::shader::simpleUv;
+    inputDesc.attributes[1].location = 1;
+    inputDesc.inputBindings[1].stride = sizeof(float) * 2;
+    inputDesc.numAttributes = inputDesc.numInputBindings = 2;
+
+    RenderPipelineDesc desc;
+    desc.vertexInputState = recorder.createVertexInputState(inputDesc, &ret);
+    EXPECT_TRUE(ret.isOk()) << ret.message;
+    desc.shaderStages = ShaderStagesCreator::fromRenderModules(
+        *iglDev_, std::move(vertexModule), std::move(fragmentModule), &ret);
+    EXPECT_TRUE(ret.isOk()) << ret.message;
+    desc.targetDesc.colorAttachments.resize(1);
+    desc.targetDesc.colorAttachments[0].textureFormat = TextureFormat::RGBA_UNorm8;
+    desc.fragmentUnitSamplerMap[0] = IGL_NAMEHANDLE(data::shader::simpleSampler);
+    desc.debugName = IGL_NAMEHANDLE("simple");
+
+    auto pipelineState = recorder.createRenderPipeline(desc, &ret);
+    EXPECT_TRUE(ret.isOk()) << ret.message;
+    return pipelineState;
+  }
+
+ public:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+};
+
+//
+// Serialize Test
+//
+// A deserialized manifest has the same records. Truncated data is rejected.
+//
+TEST_F(PipelineManifestTest, Serialize) {
+  PipelineManifest manifest;
+  auto& module = manifest.shaderModules.emplace_back();
+  module.info = {ShaderStage::Compute, "main"};
+  module.info.specializationConstants.push_back(
+      ShaderSpecializationConstant::fromUInt(3, "kSize", 64));
+  module.code = "void main() {}";
+  auto& vertexInputState = manifest.vertexInputStates.emplace_back();
+  vertexInputState.numAttributes = 1;
+  vertexInputState.attributes[0] = {0, VertexAttributeFormat::Float3, 12, "position", 0};
+  vertexInputState.numInputBindings = 1;
+  vertexInputState.inputBindings[0].stride = 24;
+  auto& renderPipeline = manifest.renderPipelines.emplace_back();
+  renderPipeline.vertexInputState = 0;
+  renderPipeline.desc.targetDesc.colorAttachments.resize(1);
+  renderPipeline.desc.targetDesc.colorAttachments[0].textureFormat = TextureFormat::BGRA_UNorm8;
+  renderPipeline.desc.targetDesc.depthAttachmentFormat = TextureFormat::Z_UNorm24;
+  renderPipeline.desc.cullMode = CullMode::Back;
+  renderPipeline.desc.uniformBlockBindingMap[1] = {IGL_NAMEHANDLE("block"),
+                                                   IGL_NAMEHANDLE("instance")};
+  renderPipeline.desc.sampleCount = 4;
+  auto& variant = renderPipeline.variants.emplace_back();
+  variant.primitiveType = PrimitiveType::Line;
+  variant.depthStencilState.compareFunction = CompareFunction::Less;
+  auto& computePipeline = manifest.computePipelines.emplace_back();
+  computePipeline.desc.buffersMap[2] = IGL_NAMEHANDLE("buffer");
+  computePipeline.desc.debugName = "compute";
+
+  const std::vector<uint8_t> data = manifest.serialize();
+
+  Result ret;
+  const PipelineManifest result = PipelineManifest::deserialize(data.data(), data.size(), &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  ASSERT_EQ(result.shaderModules.size(), 1u);
+  EXPECT_EQ(result.shaderModules[0], module);
+  ASSERT_EQ(result.vertexInputStates.size(), 1u);
+  EXPECT_EQ(result.vertexInputStates[0], vertexInputState);
+  ASSERT_EQ(result.renderPipelines.size(), 1u);
+  EXPECT_EQ(result.renderPipelines[0].desc, renderPipeline.desc);
+  EXPECT_EQ(result.renderPipelines[0].vertexInputState, 0);
+  ASSERT_EQ(result.renderPipelines[0].variants.size(), 1u);
+  EXPECT_EQ(result.renderPipelines[0].variants[0], variant);
+  ASSERT_EQ(result.computePipelines.size(), 1u);
+  EXPECT_EQ(result.computePipelines[0].desc, computePipeline.desc);
+
+  const PipelineManifest truncated =
+      PipelineManifest::deserialize(data.data(), data.size() - 1, &ret);
+  EXPECT_FALSE(ret.isOk());
+  EXPECT_TRUE(truncated.shaderModules.empty());
+}
+
+//
+// RecordAndWarmUp Test
+//
+// Pipelines created through the recorder are recreated from the manifest.
+//
+TEST_F(PipelineManifestTest, RecordAndWarmUp) {
+  PipelineRecorder recorder(*iglDev_);
+  const auto pipelineState = createPipeline(recorder);
+  if (!pipelineState) {
+    GTEST_SKIP() << "Unsupported backend";
+  }
+  recorder.addRenderPipelineVariant(pipelineState, RenderPipelineVariant{});
+  // equal descriptors are recorded once
+  ASSERT_TRUE(createPipeline(recorder) != nullptr);
+
+  const PipelineManifest manifest = recorder.getManifest();
+  EXPECT_EQ(manifest.shaderModules.size(), 2u);
+  EXPECT_EQ(manifest.vertexInputStates.size(), 1u);
+  ASSERT_EQ(manifest.renderPipelines.size(), 1u);
+  EXPECT_EQ(manifest.renderPipelines[0].variants.size(), 1u);
+
+  const std::vector<uint8_t> data = manifest.serialize();
+  Result ret;
+  const PipelineManifest replayed = PipelineManifest::deserialize(data.data(), data.size(), &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+
+  auto future = iglu::pipelinemanifest::warmUpPipelines(*iglDev_, replayed);
+  // OpenGL creates the pipeline states when a device scope is entered
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (future.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready &&
+         std::chrono::steady_clock::now() < deadline) {
+    const DeviceScope scope(*iglDev_);
+  }
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+
+  const WarmedUpPipelines& pipelines = future.get();
+  EXPECT_TRUE(pipelines.result.isOk()) << pipelines.result.message;
+  ASSERT_EQ(pipelines.renderPipelines.size(), 1u);
+  EXPECT_TRUE(pipelines.renderPipelines[0] != nullptr);
+}
+
+} // namespace tests
+} // namespace igl
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+
+#include <IGLU/render_graph/RenderGraph.h>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace tests {
+
+using iglu::rendergraph::PassBuilder;
+using iglu::rendergraph::RenderGraph;
+
+class RenderGraphTest : public ::testing::Test {
+ public:
+  RenderGraphTest() = default;
+  ~RenderGraphTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+
+    texDesc_ = TextureDesc::new2D(TextureFormat::RGBA_UNorm8, 16, 16, 0);
+
+    Result ret;
+    output_ = iglDev_->createTexture(
+        TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                           16,
+                           16,
+                           TextureDesc::TextureUsageBits::Attachment |
+                               TextureDesc::TextureUsageBits::Sampled),
+        &ret);
+    ASSERT_TRUE(ret.isOk());
+  }
+  void TearDown() override {}
+
+ public:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  std::shared_ptr<ITexture> output_;
+  TextureDesc texDesc_;
+};
+
+//
+// cullUnusedPasses Test
+//
+// Passes whose results are never read are not executed
+//
+TEST_F(RenderGraphTest, cullUnusedPasses) {
+  RenderGraph graph(*iglDev_);
+  const auto scene = graph.createTexture("scene", texDesc_);
+  const auto unused = graph.createTexture("unused", texDesc_);
+  const auto output = graph.importTexture("output", output_);
+
+  graph.addRenderPass(
+      "scene", [&](PassBuilder& builder) { builder.writeColor(0, scene); }, [](auto&) {});
+  graph.addRenderPass(
+      "unused", [&](PassBuilder& builder) { builder.writeColor(0, unused); }, [](auto&) {});
+  graph.addRenderPass(
+      "composite",
+      [&](PassBuilder& builder) {
+        builder.read(scene);
+        builder.writeColor(0, output);
+      },
+      [](auto&) {});
+
+  ASSERT_TRUE(graph.compile().isOk());
+  ASSERT_FALSE(graph.isPassCulled("scene"));
+  ASSERT_TRUE(graph.isPassCulled("unused"));
+  ASSERT_FALSE(graph.isPassCulled("composite"));
+  ASSERT_TRUE(graph.getTexture(scene) != nullptr);
+  ASSERT_TRUE(graph.getTexture(unused) == nullptr);
+
+  int executedPasses = 0;
+  graph.reset();
+  graph.addRenderPass(
+      "scene",
+      [&](PassBuilder& builder) { builder.writeColor(0, graph.importTexture("output", output_)); },
+      [&](IRenderCommandEncoder&) { executedPasses++; });
+  ASSERT_TRUE(graph.compile().isOk());
+  ASSERT_TRUE(graph.execute(*cmdQueue_).isOk());
+  ASSERT_EQ(executedPasses, 1);
+}
+
+//
+// aliasTransientTextures Test
+//
+// Transient textures whose lifetimes don't overlap share the same texture, across frames too
+//
+TEST_F(RenderGraphTest, aliasTransientTextures) {
+  RenderGraph graph(*iglDev_);
+  for (int frame = 0; frame != 2; frame++) {
+    const auto a = graph.createTexture("a", texDesc_);
+    const auto b = graph.createTexture("b", texDesc_);
+    const auto c = graph.createTexture("c", texDesc_);
+    const auto output = graph.importTexture("output", output_);
+
+    graph.addRenderPass(
+        "a", [&](PassBuilder& builder) { builder.writeColor(0, a); }, [](auto&) {});
+    graph.addRenderPass(
+        "b",
+        [&](PassBuilder& builder) {
+          builder.read(a);
+          builder.writeColor(0, b);
+        },
+        [](auto&) {});
+    graph.addRenderPass(
+        "c",
+        [&](PassBuilder& builder) {
+          builder.read(b);
+          builder.writeColor(0, c);
+        },
+        [](auto&) {});
+    graph.addRenderPass(
+        "output",
+        [&](PassBuilder& builder) {
+          builder.read(c);
+          builder.writeColor(0, output);
+        },
+        [](auto&) {});
+
+    ASSERT_TRUE(graph.compile().isOk());
+    // `a` is not used anymore when `c` is written
+    ASSERT_EQ(graph.getTexture(a), graph.getTexture(c));
+    ASSERT_NE(graph.getTexture(a), graph.getTexture(b));
+    ASSERT_EQ(graph.getPooledTextureCount(), 2u);
+    graph.reset();
+  }
+}
+
+} // namespace tests
+} // namespace igl
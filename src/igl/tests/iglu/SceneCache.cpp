@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/scene_cache/SceneCache.h>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+
+namespace igl {
+namespace tests {
+
+using iglu::scenecache::makeSectionId;
+using iglu::scenecache::SceneCache;
+using iglu::scenecache::SceneCacheWriter;
+
+namespace {
+
+constexpr uint32_t kContentVersion = 42;
+constexpr uint32_t kVertices = makeSectionId('V', 'E', 'R', 'T');
+constexpr uint32_t kIndices = makeSectionId('I', 'N', 'D', 'X');
+constexpr uint32_t kNames = makeSectionId('N', 'A', 'M', 'E');
+
+struct Vertex {
+  float position[3];
+  uint32_t normal;
+};
+
+std::vector<uint8_t> readFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+} // namespace
+
+class SceneCacheTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    path_ = ::testing::TempDir() + "SceneCacheTest.data";
+
+    vertices_ = {{{0, 1, 2}, 3}, {{4, 5, 6}, 7}, {{8, 9, 10}, 11}};
+    indices_ = {0, 1, 2, 2, 1};
+    names_ = {'a', 'b', 'c'};
+
+    SceneCacheWriter writer(kContentVersion);
+    writer.addSection(kVertices, vertices_);
+    writer.addSection(kIndices, indices_);
+    writer.addSection(kNames, names_);
+    Result ret;
+    ASSERT_TRUE(writer.write(path_, &ret));
+    ASSERT_TRUE(ret.isOk());
+  }
+
+  void TearDown() override {
+    std::remove(path_.c_str());
+  }
+
+ protected:
+  std::string path_;
+  std::vector<Vertex> vertices_;
+  std::vector<uint32_t> indices_;
+  std::vector<char> names_;
+};
+
+TEST_F(SceneCacheTest, RoundTrip) {
+  Result ret;
+  auto cache = SceneCache::open(path_, kContentVersion, &ret);
+  ASSERT_TRUE(cache != nullptr);
+  ASSERT_TRUE(ret.isOk());
+
+  const auto vertices = cache->getSection<Vertex>(kVertices);
+  ASSERT_EQ(vertices.count, vertices_.size());
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(vertices.data) % 16, 0u);
+  for (size_t i = 0; i != vertices_.size(); i++) {
+    EXPECT_EQ(vertices[i].position[2], vertices_[i].position[2]);
+    EXPECT_EQ(vertices[i].normal, vertices_[i].normal);
+  }
+
+  EXPECT_EQ(cache->copySection<uint32_t>(kIndices), indices_);
+
+  // sections follow odd-sized ones at aligned offsets
+  const auto names = cache->getSection<char>(kNames);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(names.data) % 16, 0u);
+  EXPECT_EQ(std::vector<char>(names.begin(), names.end()), names_);
+}
+
+TEST_F(SceneCacheTest, MissingOrMismatchedSections) {
+  auto cache = SceneCache::open(path_, kContentVersion);
+  ASSERT_TRUE(cache != nullptr);
+
+  EXPECT_FALSE(cache->hasSection(makeSectionId('N', 'O', 'N', 'E')));
+  EXPECT_TRUE(cache->getSection<uint32_t>(makeSectionId('N', 'O', 'N', 'E')).empty());
+  // the element size has to match
+  EXPECT_TRUE(cache->hasSection(kVertices));
+  EXPECT_TRUE(cache->getSection<uint32_t>(kVertices).empty());
+}
+
+TEST_F(SceneCacheTest, RejectsOtherContentVersions) {
+  Result ret;
+  EXPECT_TRUE(SceneCache::open(path_, kContentVersion + 1, &ret) == nullptr);
+  EXPECT_FALSE(ret.isOk());
+}
+
+TEST_F(SceneCacheTest, RejectsTruncatedFiles) {
+  auto data = readFile(path_);
+  ASSERT_FALSE(data.empty());
+  EXPECT_TRUE(SceneCache::fromMemory(data, kContentVersion) != nullptr);
+
+  data.resize(data.size() - 1);
+  Result ret;
+  EXPECT_TRUE(SceneCache::fromMemory(data, kContentVersion, &ret) == nullptr);
+  EXPECT_FALSE(ret.isOk());
+
+  EXPECT_TRUE(SceneCache::fromMemory({}, kContentVersion) == nullptr);
+}
+
+TEST_F(SceneCacheTest, MissingFile) {
+  Result ret;
+  EXPECT_TRUE(SceneCache::open(path_ + ".missing", kContentVersion, &ret) == nullptr);
+  EXPECT_FALSE(ret.isOk());
+}
+
+} // namespace tests
+} // namespace igl
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../data/ShaderData.h"
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+
+#include <IGLU/shader_bundle/ShaderBundle.h>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace tests {
+
+using iglu::shaderbundle::ShaderBundle;
+using iglu::shaderbundle::ShaderBundleEntry;
+
+class ShaderBundleTest : public ::testing::Test {
+ public:
+  ShaderBundleTest() = default;
+  ~ShaderBundleTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+  void TearDown() override {}
+
+  // a bundle with the simple shaders of the tests as sources for the family of the device
+  ShaderBundle createBundle() const {
+    ShaderBundle bundle;
+    const ShaderFamily family = iglDev_->getShaderVersion().family;
+    auto add = [&bundle, family](ShaderStage stage, const char* entryPoint, const char* source) {
+      bundle.entries.push_back({family, ShaderInputType::String, stage, entryPoint, source});
+    };
+    switch (iglDev_->getBackendType()) {
+    case BackendType::OpenGL:
+      add(ShaderStage::Vertex, data::shader::shaderFunc, data::shader::OGL_SIMPLE_VERT_SHADER);
+      add(ShaderStage::Fragment, data::shader::shaderFunc, data::shader::OGL_SIMPLE_FRAG_SHADER);
+      break;
+    case BackendType::Vulkan:
+      add(ShaderStage::Vertex, data::shader::shaderFunc, data::shader::VULKAN_SIMPLE_VERT_SHADER);
+      add(ShaderStage::Fragment,
+          data::shader::shaderFunc,
+          data::shader::VULKAN_SIMPLE_FRAG_SHADER);
+      break;
+    case BackendType::Metal:
+      add(ShaderStage::Vertex, data::shader::simpleVertFunc, data::shader::MTL_SIMPLE_SHADER);
+      add(ShaderStage::Fragment, data::shader::simpleFragFunc, data::shader::MTL_SIMPLE_SHADER);
+      break;
+    default:
+      break;
+    }
+    return bundle;
+  }
+
+ protected:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+};
+
+//
+// SerializeRoundTrip
+//
+// A bundle survives serialization, and truncated data is rejected.
+//
+TEST_F(ShaderBundleTest, SerializeRoundTrip) {
+  ShaderBundle bundle = createBundle();
+  bundle.entries.push_back(
+      {ShaderFamily::SpirV, ShaderInputType::Binary, ShaderStage::Compute, "main", {'\0', '\1'}});
+
+  const std::vector<uint8_t> data = bundle.serialize();
+
+  Result ret;
+  const ShaderBundle loaded = ShaderBundle::deserialize(data.data(), data.size(), &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  ASSERT_EQ(loaded.entries.size(), bundle.entries.size());
+  for (size_t i = 0; i != bundle.entries.size(); i++) {
+    ASSERT_EQ(loaded.entries[i].family, bundle.entries[i].family);
+    ASSERT_EQ(loaded.entries[i].inputType, bundle.entries[i].inputType);
+    ASSERT_EQ(loaded.entries[i].stage, bundle.entries[i].stage);
+    ASSERT_EQ(loaded.entries[i].entryPoint, bundle.entries[i].entryPoint);
+    ASSERT_EQ(loaded.entries[i].data, bundle.entries[i].data);
+  }
+
+  const ShaderBundle truncated = ShaderBundle::deserialize(data.data(), data.size() - 1, &ret);
+  ASSERT_FALSE(ret.isOk());
+  ASSERT_TRUE(truncated.entries.empty());
+}
+
+//
+// FindPrefersBinaries
+//
+// Binaries are picked over sources of the same family and stage.
+//
+TEST_F(ShaderBundleTest, FindPrefersBinaries) {
+  ShaderBundle bundle;
+  bundle.entries.push_back(
+      {ShaderFamily::SpirV, ShaderInputType::String, ShaderStage::Vertex, "main", "source"});
+  bundle.entries.push_back(
+      {ShaderFamily::SpirV, ShaderInputType::Binary, ShaderStage::Vertex, "main", "binary"});
+
+  const ShaderBundleEntry* entry = bundle.find(ShaderFamily::SpirV, ShaderStage::Vertex);
+  ASSERT_NE(entry, nullptr);
+  ASSERT_EQ(entry->data, "binary");
+  ASSERT_EQ(bundle.find(ShaderFamily::SpirV, ShaderStage::Fragment), nullptr);
+  ASSERT_EQ(bundle.find(ShaderFamily::Metal, ShaderStage::Vertex), nullptr);
+}
+
+//
+// CreateRenderShaderStages
+//
+// Shader stages are created from the entries of the family of the device.
+//
+TEST_F(ShaderBundleTest, CreateRenderShaderStages) {
+  const ShaderBundle bundle = createBundle();
+  if (bundle.entries.empty()) {
+    GTEST_SKIP() << "No test shaders for this backend";
+  }
+
+  Result ret;
+  auto stages = bundle.createRenderShaderStages(*iglDev_, "simple", &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  ASSERT_NE(stages, nullptr);
+
+  const ShaderBundle empty;
+  stages = empty.createRenderShaderStages(*iglDev_, "empty", &ret);
+  ASSERT_FALSE(ret.isOk());
+  ASSERT_EQ(stages, nullptr);
+}
+
+} // namespace tests
+} // namespace igl
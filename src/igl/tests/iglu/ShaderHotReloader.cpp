@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../data/ShaderData.h"
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+
+#include <IGLU/shader_hot_reload/ShaderHotReloader.h>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <thread>
+
+namespace igl {
+namespace tests {
+
+using iglu::shaderhotreload::ShaderHotReloader;
+using iglu::shaderhotreload::ShaderSource;
+
+class ShaderHotReloaderTest : public ::testing::Test {
+ public:
+  ShaderHotReloaderTest() = default;
+  ~ShaderHotReloaderTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+
+    switch (iglDev_->getBackendType()) {
+    case BackendType::OpenGL:
+      vertex_ = {"simple.vert", {ShaderStage::Vertex, data::shader::shaderFunc}};
+      vertex_.code = data::shader::OGL_SIMPLE_VERT_SHADER;
+      fragment_ = {"simple.frag", {ShaderStage::Fragment, data::shader::shaderFunc}};
+      fragment_.code = data::shader::OGL_SIMPLE_FRAG_SHADER;
+      break;
+    case BackendType::Vulkan:
+      vertex_ = {"simple.vert", {ShaderStage::Vertex, data::shader::shaderFunc}};
+      vertex_.code = data::shader::VULKAN_SIMPLE_VERT_SHADER;
+      fragment_ = {"simple.frag", {ShaderStage::Fragment, data::shader::shaderFunc}};
+      fragment_.code = data::shader::VULKAN_SIMPLE_FRAG_SHADER;
+      break;
+    case BackendType::Metal:
+      // both functions come from the same source
+      vertex_ = {"simple.metal", {ShaderStage::Vertex, data::shader::simpleVertFunc}};
+      vertex_.code = data::shader::MTL_SIMPLE_SHADER;
+      fragment_ = {"simple.metal", {ShaderStage::Fragment, data::shader::simpleFragFunc}};
+      fragment_.code = data::shader::MTL_SIMPLE_SHADER;
+      break;
+    default:
+      GTEST_SKIP() << "Unsupported backend";
+    }
+
+    VertexInputStateDesc inputDesc;
+    inputDesc.attributes[0].format = VertexAttributeFormat::Float4;
+    inputDesc.attributes[0].bufferIndex = data::shader::simplePosIndex;
+    inputDesc.attributes[0].name = data::shader::simplePos;
+    inputDesc.attributes[0].location = 0;
+    inputDesc.inputBindings[0].stride = sizeof(float) * 4;
+    inputDesc.attributes[1].format = VertexAttributeFormat::Float2;
+    inputDesc.attributes[1].bufferIndex = data::shader::simpleUvIndex;
+    inputDesc.attributes[1].name = data::shader::simpleUv;
+    inputDesc.attributes[1].location = 1;
+    inputDesc.inputBindings[1].stride = sizeof(float) * 2;
+    inputDesc.numAttributes = inputDesc.numInputBindings = 2;
+
+    Result ret;
+    desc_.vertexInputState = iglDev_->createVertexInputState(inputDesc, &ret);
+    ASSERT_TRUE(ret.isOk());
+    desc_.targetDesc.colorAttachments.resize(1);
+    desc_.targetDesc.colorAttachments[0].textureFormat = TextureFormat::RGBA_UNorm8;
+    desc_.fragmentUnitSamplerMap[0] = IGL_NAMEHANDLE(data::shader::simpleSampler);
+  }
+  void TearDown() override {}
+
+  // calls update() until `done` returns true or a timeout
+  template<typename Func>
+  static bool waitFor(ShaderHotReloader& reloader, Func&& done) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < deadline) {
+      if (done(reloader.update())) {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+  }
+
+ public:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  ShaderSource vertex_;
+  ShaderSource fragment_;
+  RenderPipelineDesc desc_;
+};
+
+//
+// RebuildPipeline Test
+//
+// A new source rebuilds the pipelines using it. A broken source keeps the previous pipeline.
+//
+TEST_F(ShaderHotReloaderTest, RebuildPipeline) {
+  ShaderHotReloader reloader(*iglDev_, std::chrono::milliseconds(0));
+
+  Result ret;
+  const auto handle = reloader.addRenderPipeline(desc_, vertex_, fragment_, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  ASSERT_NE(handle, ShaderHotReloader::kInvalidPipeline);
+  const auto original = reloader.getRenderPipeline(handle);
+  ASSERT_TRUE(original != nullptr);
+  EXPECT_EQ(reloader.update(), 0u);
+
+  reloader.updateSource(fragment_.path, "this is not a shader");
+  ASSERT_TRUE(waitFor(reloader, [&](size_t) { return !reloader.getLastResult(handle).isOk(); }));
+  EXPECT_EQ(reloader.getRenderPipeline(handle), original);
+
+  reloader.updateSource(fragment_.path, fragment_.code);
+  ASSERT_TRUE(waitFor(reloader, [](size_t numSwapped) { return numSwapped == 1; }));
+  EXPECT_TRUE(reloader.getLastResult(handle).isOk());
+  EXPECT_TRUE(reloader.getRenderPipeline(handle) != nullptr);
+  EXPECT_NE(reloader.getRenderPipeline(handle), original);
+}
+
+} // namespace tests
+} // namespace igl
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/simdtypes/SimdKernels.h>
+#include <gtest/gtest.h>
+
+namespace igl {
+namespace tests {
+
+using namespace iglu::simdtypes;
+
+namespace {
+
+// the unit cube [-1, 1]
+const FrustumPlanes kFrustum = {{{1.0f, 0.0f, 0.0f, 1.0f},
+                                 {-1.0f, 0.0f, 0.0f, 1.0f},
+                                 {0.0f, 1.0f, 0.0f, 1.0f},
+                                 {0.0f, -1.0f, 0.0f, 1.0f},
+                                 {0.0f, 0.0f, 1.0f, 1.0f},
+                                 {0.0f, 0.0f, -1.0f, 1.0f}}};
+
+} // namespace
+
+//
+// MultiplyBatch Test
+//
+TEST(SimdKernelsTest, MultiplyBatch) {
+  float4x4 parent(2.0f);
+  parent.columns[3] = float4{1.0f, 2.0f, 3.0f, 1.0f};
+  float4x4 matrices[5] = {float4x4(1.0f),
+                          float4x4(3.0f),
+                          float4x4(1.0f),
+                          float4x4(1.0f),
+                          float4x4(1.0f)};
+  matrices[2].columns[3] = float4{1.0f, 0.0f, 0.0f, 1.0f};
+
+  multiplyBatch(parent, matrices, matrices, 5);
+
+  EXPECT_EQ(matrices[0].columns[3][1], 2.0f);
+  EXPECT_EQ(matrices[1].columns[0][0], 6.0f);
+  EXPECT_EQ(matrices[1].columns[3][0], 3.0f);
+  EXPECT_EQ(matrices[2].columns[3][0], 3.0f);
+  EXPECT_EQ(matrices[4].columns[2][2], 2.0f);
+}
+
+//
+// NormalMatrixBatch Test
+//
+// The normal matrix of a scale is the inverse scale.
+//
+TEST(SimdKernelsTest, NormalMatrixBatch) {
+  const float4x4 model(float4{2.0f, 4.0f, 8.0f, 1.0f});
+  float3x4 normalMatrix;
+  normalMatrixBatch(&model, &normalMatrix, 1);
+
+  EXPECT_FLOAT_EQ(normalMatrix.columns[0][0], 0.5f);
+  EXPECT_FLOAT_EQ(normalMatrix.columns[1][1], 0.25f);
+  EXPECT_FLOAT_EQ(normalMatrix.columns[2][2], 0.125f);
+  EXPECT_EQ(normalMatrix.columns[0][1], 0.0f);
+  EXPECT_EQ(normalMatrix.columns[2][3], 0.0f);
+}
+
+//
+// CullSpheres Test
+//
+// Covers both the vectorized batches of 4 and the scalar remainder.
+//
+TEST(SimdKernelsTest, CullSpheres) {
+  const float centerX[6] = {0.0f, 2.0f, 1.5f, -3.0f, 0.0f, 0.5f};
+  const float centerYZ[6] = {};
+  const float radius[6] = {0.1f, 0.5f, 0.6f, 1.0f, 0.1f, 0.1f};
+  uint8_t visible[6] = {};
+
+  EXPECT_EQ(cullSpheres(kFrustum, {centerX, centerYZ, centerYZ, radius}, 6, visible), 4u);
+  const uint8_t expected[6] = {1, 0, 1, 0, 1, 1};
+  for (size_t i = 0; i != 6; ++i) {
+    EXPECT_EQ(visible[i], expected[i]) << i;
+  }
+}
+
+//
+// CullAabbs Test
+//
+TEST(SimdKernelsTest, CullAabbs) {
+  const float minX[5] = {-0.5f, 1.5f, 0.9f, -5.0f, 2.0f};
+  const float maxX[5] = {0.5f, 2.0f, 3.0f, -4.0f, 3.0f};
+  const float minYZ[5] = {};
+  const float maxYZ[5] = {0.1f, 0.1f, 0.1f, 0.1f, 0.1f};
+  uint8_t visible[5] = {};
+
+  EXPECT_EQ(cullAabbs(kFrustum, {minX, minYZ, minYZ, maxX, maxYZ, maxYZ}, 5, visible), 2u);
+  const uint8_t expected[5] = {1, 0, 1, 0, 0};
+  for (size_t i = 0; i != 5; ++i) {
+    EXPECT_EQ(visible[i], expected[i]) << i;
+  }
+}
+
+} // namespace tests
+} // namespace igl
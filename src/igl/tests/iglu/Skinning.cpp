@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+
+#include <IGLU/skinning/Skinner.h>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace tests {
+
+using iglu::skinning::SkinInfluence;
+using iglu::skinning::SkinnedMeshDesc;
+using iglu::skinning::Skinner;
+using iglu::skinning::SkinningVertex;
+
+namespace {
+
+// column-major
+void setTranslation(float* m, float x, float y, float z) {
+  for (int i = 0; i != 16; i++) {
+    m[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+  }
+  m[12] = x;
+  m[13] = y;
+  m[14] = z;
+}
+
+SkinnedMeshDesc createMesh() {
+  SkinnedMeshDesc desc;
+  desc.vertices.resize(2);
+  desc.vertices[0].position[0] = 1.0f;
+  desc.vertices[0].normal[2] = 2.0f;
+  desc.vertices[1].position[1] = 1.0f;
+  desc.vertices[1].normal[2] = 1.0f;
+
+  desc.numJoints = 2;
+  desc.influences.resize(2);
+  // the first vertex follows the first joint, the second one both joints equally
+  desc.influences[0].weights[0] = 1.0f;
+  desc.influences[1].weights[0] = 0.5f;
+  desc.influences[1].weights[1] = 0.5f;
+  desc.influences[1].joints[1] = 1;
+
+  desc.numMorphTargets = 1;
+  desc.morphTargetDeltas.resize(2);
+  desc.morphTargetDeltas[0].position[2] = 1.0f;
+  desc.morphTargetDeltas[1].position[2] = 2.0f;
+  desc.debugName = "test";
+  return desc;
+}
+
+} // namespace
+
+class SkinningTest : public ::testing::Test {
+ public:
+  SkinningTest() = default;
+  ~SkinningTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+
+  void TearDown() override {}
+
+ protected:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+};
+
+TEST_F(SkinningTest, RestPose) {
+  const SkinnedMeshDesc desc = createMesh();
+  SkinningVertex out[2];
+  Skinner::skin(desc, nullptr, nullptr, out);
+
+  EXPECT_FLOAT_EQ(out[0].position[0], 1.0f);
+  EXPECT_FLOAT_EQ(out[0].position[2], 0.0f);
+  EXPECT_FLOAT_EQ(out[0].position[3], 1.0f);
+  // normals are normalized
+  EXPECT_FLOAT_EQ(out[0].normal[2], 1.0f);
+  EXPECT_FLOAT_EQ(out[0].normal[3], 0.0f);
+}
+
+TEST_F(SkinningTest, MorphTargetsThenJoints) {
+  const SkinnedMeshDesc desc = createMesh();
+  float joints[32];
+  setTranslation(joints, 0.0f, 0.0f, 0.0f);
+  setTranslation(joints + 16, 2.0f, 0.0f, 0.0f);
+  const float morphWeights[] = {0.5f};
+
+  SkinningVertex out[2];
+  Skinner::skin(desc, joints, morphWeights, out);
+
+  EXPECT_FLOAT_EQ(out[0].position[0], 1.0f);
+  EXPECT_FLOAT_EQ(out[0].position[2], 0.5f);
+  // blended translation of both joints
+  EXPECT_FLOAT_EQ(out[1].position[0], 1.0f);
+  EXPECT_FLOAT_EQ(out[1].position[1], 1.0f);
+  EXPECT_FLOAT_EQ(out[1].position[2], 1.0f);
+  // translations do not affect normals
+  EXPECT_FLOAT_EQ(out[1].normal[0], 0.0f);
+  EXPECT_FLOAT_EQ(out[1].normal[2], 1.0f);
+}
+
+TEST_F(SkinningTest, OutOfRangeJointsAreClamped) {
+  SkinnedMeshDesc desc = createMesh();
+  desc.influences[0].joints[0] = 100;
+  float joints[32];
+  setTranslation(joints, 0.0f, 0.0f, 0.0f);
+  setTranslation(joints + 16, 0.0f, 3.0f, 0.0f);
+
+  SkinningVertex out[2];
+  Skinner::skin(desc, joints, nullptr, out);
+
+  EXPECT_FLOAT_EQ(out[0].position[1], 3.0f);
+}
+
+TEST_F(SkinningTest, CreateAndSkin) {
+  Result ret;
+  Skinner skinner(*iglDev_, createMesh(), &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message.c_str();
+  ASSERT_TRUE(skinner.getOutputBuffer() != nullptr);
+  EXPECT_EQ(skinner.numVertices(), 2u);
+  EXPECT_EQ(skinner.usesCompute(), Skinner::isComputeSupported(*iglDev_));
+
+  if (!skinner.usesCompute()) {
+    float joints[32];
+    setTranslation(joints, 0.0f, 0.0f, 0.0f);
+    setTranslation(joints + 16, 2.0f, 0.0f, 0.0f);
+    const float morphWeights[] = {1.0f};
+    skinner.skinOnCpu(joints, morphWeights, &ret);
+    EXPECT_TRUE(ret.isOk()) << ret.message.c_str();
+  }
+}
+
+TEST_F(SkinningTest, MismatchedInfluences) {
+  SkinnedMeshDesc desc = createMesh();
+  desc.influences.pop_back();
+
+  Result ret;
+  const Skinner skinner(*iglDev_, std::move(desc), &ret);
+  EXPECT_EQ(ret.code, Result::Code::ArgumentInvalid);
+  EXPECT_TRUE(skinner.getOutputBuffer() == nullptr);
+}
+
+} // namespace tests
+} // namespace igl
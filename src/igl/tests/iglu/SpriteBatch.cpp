@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+
+#include <IGLU/sprite_batch/SpriteBatch.h>
+#include <IGLU/sprite_batch/TextureAtlas.h>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <vector>
+
+namespace igl {
+namespace tests {
+
+using iglu::spritebatch::AtlasRegion;
+using iglu::spritebatch::SpriteBatch;
+using iglu::spritebatch::TextureAtlas;
+using iglu::spritebatch::TextureAtlasDesc;
+
+namespace {
+
+constexpr uint32_t kPageSize = 64;
+
+bool overlap(const AtlasRegion& a, const AtlasRegion& b) {
+  return a.page == b.page && a.x < b.x + b.width && b.x < a.x + a.width &&
+         a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+} // namespace
+
+class SpriteBatchTest : public ::testing::Test {
+ public:
+  SpriteBatchTest() = default;
+  ~SpriteBatchTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+
+    desc_.pageSize = kPageSize;
+    desc_.maxPages = 2;
+    desc_.debugName = "test";
+    pixels_.resize(size_t(kPageSize) * kPageSize, 0xFF00FF00);
+  }
+
+  void TearDown() override {}
+
+ protected:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  TextureAtlasDesc desc_;
+  std::vector<uint32_t> pixels_;
+};
+
+TEST_F(SpriteBatchTest, AtlasRegionsDoNotOverlap) {
+  TextureAtlas atlas(*iglDev_, desc_);
+  std::vector<AtlasRegion> regions;
+  Result ret;
+  for (uint32_t i = 0; i != 20; i++) {
+    regions.push_back(atlas.add(5 + i % 4, 3 + i % 7, pixels_.data(), &ret));
+    ASSERT_TRUE(ret.isOk()) << ret.message.c_str();
+    ASSERT_FALSE(regions.back().empty());
+  }
+  EXPECT_EQ(atlas.getNumPages(), 1u);
+
+  for (size_t i = 0; i != regions.size(); i++) {
+    EXPECT_LE(regions[i].x + regions[i].width, kPageSize);
+    EXPECT_LE(regions[i].y + regions[i].height, kPageSize);
+    for (size_t j = i + 1; j != regions.size(); j++) {
+      EXPECT_FALSE(overlap(regions[i], regions[j])) << i << " " << j;
+    }
+  }
+
+  EXPECT_FLOAT_EQ(regions[0].uvMin[0], float(regions[0].x) / kPageSize);
+  EXPECT_FLOAT_EQ(regions[0].uvMax[1], float(regions[0].y + regions[0].height) / kPageSize);
+
+  ret = atlas.flush();
+  EXPECT_TRUE(ret.isOk()) << ret.message.c_str();
+}
+
+TEST_F(SpriteBatchTest, AtlasGrowsThenFills) {
+  TextureAtlas atlas(*iglDev_, desc_);
+  Result ret;
+  // a single image of this size fits a page
+  const uint32_t size = kPageSize / 2 + 1;
+  const AtlasRegion first = atlas.add(size, size, pixels_.data(), &ret);
+  ASSERT_TRUE(ret.isOk());
+  const AtlasRegion second = atlas.add(size, size, pixels_.data(), &ret);
+  ASSERT_TRUE(ret.isOk());
+  EXPECT_EQ(first.page, 0u);
+  EXPECT_EQ(second.page, 1u);
+  EXPECT_EQ(atlas.getNumPages(), 2u);
+  EXPECT_NE(atlas.getPageTexture(0), atlas.getPageTexture(1));
+
+  const AtlasRegion third = atlas.add(size, size, pixels_.data(), &ret);
+  EXPECT_EQ(ret.code, Result::Code::RuntimeError);
+  EXPECT_TRUE(third.empty());
+
+  // the pages are reused
+  atlas.clear();
+  const AtlasRegion fourth = atlas.add(size, size, pixels_.data(), &ret);
+  ASSERT_TRUE(ret.isOk());
+  EXPECT_EQ(fourth.page, 0u);
+  EXPECT_EQ(fourth.x, 0u);
+  EXPECT_EQ(fourth.y, 0u);
+  EXPECT_EQ(atlas.getNumPages(), 2u);
+}
+
+TEST_F(SpriteBatchTest, AtlasRejectsLargeImages) {
+  TextureAtlas atlas(*iglDev_, desc_);
+  Result ret;
+  const AtlasRegion region = atlas.add(kPageSize, 1, pixels_.data(), &ret);
+  EXPECT_EQ(ret.code, Result::Code::ArgumentOutOfRange);
+  EXPECT_TRUE(region.empty());
+  EXPECT_EQ(atlas.getNumPages(), 0u);
+}
+
+TEST_F(SpriteBatchTest, OneDrawPerTexture) {
+  TextureAtlas atlas(*iglDev_, desc_);
+  Result ret;
+  const uint32_t size = kPageSize / 2 + 1;
+  const AtlasRegion a = atlas.add(size, size, pixels_.data(), &ret);
+  const AtlasRegion b = atlas.add(size, size, pixels_.data(), &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(a.page, b.page);
+  ret = atlas.flush();
+  ASSERT_TRUE(ret.isOk()) << ret.message.c_str();
+
+  SpriteBatch batch(*iglDev_, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message.c_str();
+
+  auto target = iglDev_->createTexture(
+      TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                         kPageSize,
+                         kPageSize,
+                         TextureDesc::TextureUsageBits::Sampled |
+                             TextureDesc::TextureUsageBits::Attachment),
+      &ret);
+  ASSERT_TRUE(ret.isOk());
+  FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = target;
+  auto framebuffer = iglDev_->createFramebuffer(framebufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  RenderPassDesc renderPass;
+  renderPass.colorAttachments.resize(1);
+  renderPass.colorAttachments[0].loadAction = LoadAction::Clear;
+  renderPass.colorAttachments[0].storeAction = StoreAction::Store;
+
+  auto cmdBuffer = cmdQueue_->createCommandBuffer({}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto encoder = cmdBuffer->createRenderCommandEncoder(renderPass, framebuffer);
+  ASSERT_TRUE(encoder != nullptr);
+
+  // interleaved pages still need a single draw each
+  batch.begin(float(kPageSize), float(kPageSize));
+  for (int i = 0; i != 10; i++) {
+    batch.draw(atlas, i % 2 ? a : b, float(i), float(i), 8.0f, 8.0f);
+  }
+  EXPECT_EQ(batch.getNumSprites(), 10u);
+  EXPECT_EQ(batch.end(*iglDev_, *encoder, *framebuffer), 2u);
+
+  encoder->endEncoding();
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  batch.begin(float(kPageSize), float(kPageSize));
+  EXPECT_EQ(batch.getNumSprites(), 0u);
+}
+
+} // namespace tests
+} // namespace igl
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+
+#include <IGLU/texture_streaming/TextureStreamer.h>
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace tests {
+
+using iglu::texturestreaming::IMipSource;
+using iglu::texturestreaming::kInvalidTexture;
+using iglu::texturestreaming::TextureHandle;
+using iglu::texturestreaming::TextureStreamer;
+using iglu::texturestreaming::TextureStreamerDesc;
+
+namespace {
+
+constexpr size_t kTextureSize = 256;
+constexpr uint32_t kNumMipLevels = 9;
+
+// Every level is filled with its mip level index
+class MipSource final : public IMipSource {
+ public:
+  [[nodiscard]] TextureDesc getDesc() const override {
+    auto desc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                   kTextureSize,
+                                   kTextureSize,
+                                   TextureDesc::TextureUsageBits::Sampled);
+    desc.numMipLevels = kNumMipLevels;
+    return desc;
+  }
+
+  Result loadMipLevel(uint32_t mipLevel, std::vector<uint8_t>& outData) override {
+    const size_t size = std::max(kTextureSize >> mipLevel, static_cast<size_t>(1));
+    outData.assign(size * size * 4, static_cast<uint8_t>(mipLevel));
+    loadedMipLevels.push_back(mipLevel);
+    return Result();
+  }
+
+  std::vector<uint32_t> loadedMipLevels;
+};
+
+// Bytes of an RGBA8 texture holding the levels from `mipLevel` on
+size_t getBytes(uint32_t mipLevel) {
+  size_t bytes = 0;
+  for (uint32_t level = mipLevel; level < kNumMipLevels; ++level) {
+    const size_t size = std::max(kTextureSize >> level, static_cast<size_t>(1));
+    bytes += size * size * 4;
+  }
+  return bytes;
+}
+
+} // namespace
+
+class TextureStreamerTest : public ::testing::Test {
+ public:
+  TextureStreamerTest() = default;
+  ~TextureStreamerTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+  void TearDown() override {}
+
+ public:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+};
+
+//
+// addTextureLoadsLowestMips Test
+//
+// New textures only hold the mip levels up to TextureStreamerDesc::initialMaxSize
+//
+TEST_F(TextureStreamerTest, addTextureLoadsLowestMips) {
+  TextureStreamer streamer(*iglDev_, *cmdQueue_);
+  auto source = std::make_shared<MipSource>();
+
+  Result ret;
+  const TextureHandle handle = streamer.addTexture(source, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  ASSERT_NE(handle, kInvalidTexture);
+
+  // 256 >> 2 == 64
+  ASSERT_EQ(streamer.getResidentMipLevel(handle), 2u);
+  auto texture = streamer.getTexture(handle);
+  ASSERT_TRUE(texture != nullptr);
+  ASSERT_EQ(texture->getDimensions().width, 64u);
+  ASSERT_EQ(texture->getNumMipLevels(), kNumMipLevels - 2);
+  ASSERT_EQ(source->loadedMipLevels.size(), kNumMipLevels - 2);
+  ASSERT_EQ(streamer.getResidentBytes(), getBytes(2));
+}
+
+//
+// streamInByScreenSize Test
+//
+// Only the levels needed for the screen size are streamed in, and only the missing ones are loaded
+//
+TEST_F(TextureStreamerTest, streamInByScreenSize) {
+  TextureStreamer streamer(*iglDev_, *cmdQueue_);
+  auto source = std::make_shared<MipSource>();
+  const TextureHandle handle = streamer.addTexture(source, nullptr);
+  ASSERT_NE(handle, kInvalidTexture);
+  source->loadedMipLevels.clear();
+
+  streamer.setScreenSize(handle, 128.0f);
+  streamer.update();
+  ASSERT_EQ(streamer.getResidentMipLevel(handle), 1u);
+  ASSERT_EQ(source->loadedMipLevels, std::vector<uint32_t>({1}));
+  ASSERT_EQ(streamer.getTexture(handle)->getDimensions().width, 128u);
+
+  streamer.setScreenSize(handle, 1000.0f);
+  streamer.update();
+  ASSERT_EQ(streamer.getResidentMipLevel(handle), 0u);
+  ASSERT_EQ(streamer.getResidentBytes(), getBytes(0));
+}
+
+//
+// evictOverBudget Test
+//
+// Textures which appear larger on screen get the budget first
+//
+TEST_F(TextureStreamerTest, evictOverBudget) {
+  TextureStreamerDesc desc;
+  desc.memoryBudget = getBytes(0) + getBytes(2);
+  TextureStreamer streamer(*iglDev_, *cmdQueue_, desc);
+
+  const TextureHandle small = streamer.addTexture(std::make_shared<MipSource>(), nullptr);
+  const TextureHandle large = streamer.addTexture(std::make_shared<MipSource>(), nullptr);
+  ASSERT_NE(small, kInvalidTexture);
+  ASSERT_NE(large, kInvalidTexture);
+
+  streamer.setScreenSize(small, 256.0f);
+  streamer.update();
+  ASSERT_EQ(streamer.getResidentMipLevel(small), 0u);
+
+  streamer.setScreenSize(small, 64.0f);
+  streamer.setScreenSize(large, 256.0f);
+  streamer.update();
+  ASSERT_EQ(streamer.getResidentMipLevel(large), 0u);
+  ASSERT_EQ(streamer.getResidentMipLevel(small), 2u);
+  ASSERT_LE(streamer.getResidentBytes(), desc.memoryBudget);
+}
+
+//
+// memoryPressure Test
+//
+// Memory pressure lowers the budget and evicts the levels which no longer fit
+//
+TEST_F(TextureStreamerTest, memoryPressure) {
+  TextureStreamerDesc desc;
+  desc.memoryBudget = getBytes(0);
+  desc.pressureBudgetScale = 0.5f;
+  TextureStreamer streamer(*iglDev_, *cmdQueue_, desc);
+
+  const TextureHandle handle = streamer.addTexture(std::make_shared<MipSource>(), nullptr);
+  ASSERT_NE(handle, kInvalidTexture);
+  streamer.setScreenSize(handle, 256.0f);
+  streamer.update();
+  ASSERT_EQ(streamer.getResidentMipLevel(handle), 0u);
+
+  streamer.onMemoryPressure();
+  streamer.update();
+  ASSERT_EQ(streamer.getMemoryBudget(), getBytes(0) / 2);
+  ASSERT_EQ(streamer.getResidentMipLevel(handle), 1u);
+  ASSERT_LE(streamer.getResidentBytes(), streamer.getMemoryBudget());
+}
+
+} // namespace tests
+} // namespace igl
@@ -349,5 +349,36 @@ TEST_F(UniformCollectionTest, DescriptorVector) {
   TestUniformData(mat4Vector, c.getOrCreate<std::vector<glm::mat4>>(mat4UniformNameHandle));
 }
 
+//
+// Clear Test
+//
+// Names keep their insertion order and remaining uniforms are still found after a clear.
+//
+TEST_F(UniformCollectionTest, Clear) {
+  uniform::Collection c;
+  const auto aNameHandle = igl::genNameHandle("a");
+  const auto bNameHandle = igl::genNameHandle("b");
+  const auto cNameHandle = igl::genNameHandle("c");
+  c.set(aNameHandle, 1.f);
+  c.set(bNameHandle, 2.f);
+  c.set(cNameHandle, 3.f);
+  ASSERT_EQ(c.names().size(), 3u);
+  EXPECT_EQ(c.names()[0], aNameHandle);
+  EXPECT_EQ(c.names()[2], cNameHandle);
+
+  c.clear(aNameHandle);
+  EXPECT_FALSE(c.contains(aNameHandle));
+  ASSERT_EQ(c.names().size(), 2u);
+  ASSERT_EQ(c.descriptors().size(), 2u);
+  EXPECT_EQ(c.names()[0], bNameHandle);
+  EXPECT_EQ(*c.getOrCreate<float>(bNameHandle), 2.f);
+  EXPECT_EQ(*c.getOrCreate<float>(cNameHandle), 3.f);
+
+  // set() replaces the existing value
+  c.set(cNameHandle, 4.f);
+  EXPECT_EQ(c.names().size(), 2u);
+  EXPECT_EQ(*c.getOrCreate<float>(cNameHandle), 4.f);
+}
+
 } // namespace tests
 } // namespace iglu
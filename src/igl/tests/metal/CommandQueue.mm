@@ -52,5 +52,48 @@ TEST_F(CommandQueueTest, Submit) {
   ASSERT_TRUE(cmdBuf_ != nullptr);
   cmdQueue_->submit(*(cmdBuf_.get()));
 }
+
+TEST_F(CommandQueueTest, SubmitHandles) {
+  auto& queue = static_cast<metal::CommandQueue&>(*cmdQueue_);
+
+  Result ret;
+  cmdBuf_ = cmdQueue_->createCommandBuffer(cbDesc_, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  const SubmitHandle first = cmdQueue_->submit(*cmdBuf_);
+  if (first == 0) {
+    GTEST_SKIP() << "Shared events are not supported";
+  }
+
+  cmdBuf_ = cmdQueue_->createCommandBuffer(cbDesc_, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  const SubmitHandle second = cmdQueue_->submit(*cmdBuf_);
+  ASSERT_GT(second, first);
+
+  queue.waitUntilCompleted(second);
+  ASSERT_TRUE(queue.isCompleted(first));
+  ASSERT_TRUE(queue.isCompleted(second));
+  ASSERT_FALSE(queue.isCompleted(second + 1));
+}
+
+TEST_F(CommandQueueTest, WaitForOtherQueue) {
+  Result ret;
+  auto producer = iglDev_->createCommandQueue({CommandQueueType::Compute}, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+
+  auto producerBuffer = producer->createCommandBuffer(cbDesc_, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  const SubmitHandle handle = producer->submit(*producerBuffer);
+  if (handle == 0) {
+    GTEST_SKIP() << "Shared events are not supported";
+  }
+
+  // The consumer only completes after the producer
+  auto& consumer = static_cast<metal::CommandQueue&>(*cmdQueue_);
+  consumer.waitForSubmitHandle(static_cast<metal::CommandQueue&>(*producer), handle);
+  cmdBuf_ = cmdQueue_->createCommandBuffer(cbDesc_, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  consumer.waitUntilCompleted(cmdQueue_->submit(*cmdBuf_));
+  ASSERT_TRUE(static_cast<metal::CommandQueue&>(*producer).isCompleted(handle));
+}
 } // namespace tests
 } // namespace igl
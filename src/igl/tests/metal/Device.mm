@@ -40,5 +40,50 @@ TEST_F(DeviceMetalTest, GetShaderVersion) {
   ASSERT_GT(iglShaderVersion.minorVersion, 0);
 }
 
+TEST_F(DeviceMetalTest, LoadPipelineArchive) {
+  auto& device = static_cast<metal::Device&>(*iglDev_);
+  const std::string path =
+      std::string([NSTemporaryDirectory() UTF8String]) + "/igl_pipeline_archive_test.bin";
+  [[NSFileManager defaultManager] removeItemAtPath:[NSString stringWithUTF8String:path.c_str()]
+                                             error:nil];
+
+  const Result result = device.loadPipelineArchive(path);
+  if (result.code == Result::Code::Unsupported) {
+    GTEST_SKIP() << "Binary archives are not supported";
+  }
+  // A missing file starts an empty archive, and an archive without new pipelines is not written
+  ASSERT_TRUE(result.isOk());
+  ASSERT_TRUE(device.savePipelineArchive().isOk());
+  ASSERT_FALSE([[NSFileManager defaultManager]
+      fileExistsAtPath:[NSString stringWithUTF8String:path.c_str()]]);
+}
+
+TEST_F(DeviceMetalTest, CollectGpuTimes) {
+  auto& statistics = static_cast<metal::Device&>(*iglDev_).getDeviceStatistics();
+  ASSERT_FALSE(statistics.getEncoderTimestampsEnabled());
+  statistics.setEncoderTimestampsEnabled(true);
+
+  Result ret;
+  auto cmdQueue = iglDev_->createCommandQueue({CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto cmdBuffer = cmdQueue->createCommandBuffer(CommandBufferDesc{}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto encoder = cmdBuffer->createComputeCommandEncoder();
+  ASSERT_NE(encoder, nullptr);
+  encoder->endEncoding();
+  cmdQueue->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  // completion handlers can run after waitUntilCompleted() returns
+  for (int i = 0; i < 100 && statistics.getGpuTimes().commandBufferCount == 0; i++) {
+    [NSThread sleepForTimeInterval:0.01];
+  }
+  const auto times = statistics.getGpuTimes();
+  ASSERT_EQ(times.commandBufferCount, 1u);
+  ASSERT_GE(times.averageCommandBufferMs, 0.0);
+  ASSERT_EQ(times.averageRenderPassMs, 0.0);
+  statistics.setEncoderTimestampsEnabled(false);
+}
+
 } // namespace tests
 } // namespace igl
@@ -58,6 +58,7 @@ TEST_F(DeviceFeatureSetMTLTest, HasFeatureTest) {
   ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::MinMaxBlend), true);
   ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::TexturePartialMipChain), true);
   ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::ShaderLibrary), true);
+  ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::ShaderFloat16), true);
   ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::BindBytes), true);
   ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::SRGB), true);
   ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::DrawIndexedIndirect), true);
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/Heap.h>
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <igl/metal/PlatformDevice.h>
+
+namespace igl {
+namespace tests {
+
+class HeapMTLTest : public ::testing::Test {
+ public:
+  HeapMTLTest() = default;
+  ~HeapMTLTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+
+    ASSERT_NE(iglDev_, nullptr);
+    ASSERT_NE(cmdQueue_, nullptr);
+
+    platformDevice_ = iglDev_->getPlatformDevice<metal::PlatformDevice>();
+    ASSERT_NE(platformDevice_, nullptr);
+  }
+  void TearDown() override {}
+
+ public:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  const metal::PlatformDevice* platformDevice_ = nullptr;
+};
+
+TEST_F(HeapMTLTest, AllocateFromAutomaticHeap) {
+  metal::HeapDesc desc;
+  desc.size = 1024 * 1024;
+  desc.storage = ResourceStorage::Shared;
+
+  Result ret;
+  auto heap = platformDevice_->createHeap(desc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(heap, nullptr);
+  ASSERT_GE(heap->getSize(), desc.size);
+
+  const uint32_t data[4] = {1, 2, 3, 4};
+  auto buffer =
+      heap->createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Uniform, data, sizeof(data)), &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(buffer, nullptr);
+  ASSERT_GT(heap->getUsedSize(), 0u);
+
+  const TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                                 64,
+                                                 64,
+                                                 TextureDesc::TextureUsageBits::Sampled);
+  auto texture = heap->createTexture(texDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(texture, nullptr);
+
+  // Textures are placed at an offset in placement heaps only
+  ASSERT_EQ(heap->createTexture(texDesc, 0, &ret), nullptr);
+  ASSERT_FALSE(ret.isOk());
+}
+
+TEST_F(HeapMTLTest, AliasTexturesInPlacementHeap) {
+  const TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                                 64,
+                                                 64,
+                                                 TextureDesc::TextureUsageBits::Attachment);
+
+  metal::HeapDesc desc;
+  desc.type = metal::HeapDesc::HeapType::Placement;
+  desc.size = 1024 * 1024;
+
+  Result ret;
+  auto heap = platformDevice_->createHeap(desc, &ret);
+  if (!ret.isOk()) {
+    GTEST_SKIP() << "Placement heaps are not supported";
+  }
+  ASSERT_GT(heap->getTextureSize(texDesc), 0u);
+  ASSERT_GT(heap->getTextureAlignment(texDesc), 0u);
+
+  // Both textures share the same memory
+  auto texture0 = heap->createTexture(texDesc, 0, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto texture1 = heap->createTexture(texDesc, 0, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(texture0, nullptr);
+  ASSERT_NE(texture1, nullptr);
+}
+
+} // namespace tests
+} // namespace igl
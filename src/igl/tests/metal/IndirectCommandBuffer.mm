@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/IndirectCommandBuffer.h>
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <igl/metal/ArgumentBuffer.h>
+#include <igl/metal/PlatformDevice.h>
+
+namespace igl {
+namespace tests {
+
+class IndirectCommandBufferMTLTest : public ::testing::Test {
+ public:
+  IndirectCommandBufferMTLTest() = default;
+  ~IndirectCommandBufferMTLTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+
+    ASSERT_NE(iglDev_, nullptr);
+    ASSERT_NE(cmdQueue_, nullptr);
+
+    platformDevice_ = iglDev_->getPlatformDevice<metal::PlatformDevice>();
+    ASSERT_NE(platformDevice_, nullptr);
+  }
+  void TearDown() override {}
+
+ public:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  const metal::PlatformDevice* platformDevice_ = nullptr;
+};
+
+TEST_F(IndirectCommandBufferMTLTest, EncodeDrawsOnCpu) {
+  metal::IndirectCommandBufferDesc desc;
+  desc.commandType = metal::IndirectCommandBufferDesc::CommandType::DrawIndexed;
+  desc.maxCommandCount = 16;
+
+  Result ret;
+  auto commandBuffer = platformDevice_->createIndirectCommandBuffer(desc, &ret);
+  if (ret.code == Result::Code::Unsupported) {
+    GTEST_SKIP() << "Indirect command buffers are not supported";
+  }
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(commandBuffer, nullptr);
+  ASSERT_EQ(commandBuffer->getMaxCommandCount(), desc.maxCommandCount);
+
+  const uint16_t indices[3] = {0, 1, 2};
+  std::shared_ptr<IBuffer> indexBuffer = iglDev_->createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Index, indices, sizeof(indices)), &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  // Index buffers are tracked once to be made resident when the commands are executed
+  commandBuffer->encodeDrawIndexed(
+      0, PrimitiveType::Triangle, 3, IndexFormat::UInt16, *indexBuffer, 0);
+  commandBuffer->encodeDrawIndexed(
+      1, PrimitiveType::Triangle, 3, IndexFormat::UInt16, *indexBuffer, 0, 4);
+  ASSERT_EQ(commandBuffer->getResources().size(), 1u);
+  commandBuffer->reset(0, 2);
+}
+
+TEST_F(IndirectCommandBufferMTLTest, EncodeIntoArgumentBuffer) {
+  metal::IndirectCommandBufferDesc desc;
+  desc.commandType = metal::IndirectCommandBufferDesc::CommandType::Draw;
+  desc.maxCommandCount = 4;
+
+  Result ret;
+  auto commandBuffer = platformDevice_->createIndirectCommandBuffer(desc, &ret);
+  if (ret.code == Result::Code::Unsupported) {
+    GTEST_SKIP() << "Indirect command buffers are not supported";
+  }
+  ASSERT_NE(commandBuffer, nullptr);
+
+  metal::ArgumentBufferDesc argumentDesc;
+  argumentDesc.arguments.push_back({metal::ArgumentBufferDesc::ArgumentType::IndirectCommandBuffer,
+                                    0});
+  auto argumentBuffer = platformDevice_->createArgumentBuffer(argumentDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(argumentBuffer, nullptr);
+
+  // Kernels encode the commands, so the indirect command buffer is made resident for writing
+  argumentBuffer->setIndirectCommandBuffer(0, *commandBuffer);
+  ASSERT_EQ(argumentBuffer->getResources().size(), 1u);
+  ASSERT_EQ(argumentBuffer->getResources().at(0).resource, commandBuffer->get());
+  ASSERT_NE(argumentBuffer->getResources().at(0).usage & MTLResourceUsageWrite, 0u);
+}
+
+} // namespace tests
+} // namespace igl
@@ -7,6 +7,8 @@
 
 #include <igl/metal/PlatformDevice.h>
 
+#include <igl/metal/ArgumentBuffer.h>
+
 #include "../util/Common.h"
 #include "../util/TestDevice.h"
 
@@ -42,5 +44,43 @@ TEST_F(PlatformDeviceTest, GetPlatformDeviceParentCls) {
   ASSERT_NE(pd, nullptr);
 }
 
+TEST_F(PlatformDeviceTest, CreateArgumentBuffer) {
+  auto pd = iglDev_->getPlatformDevice<metal::PlatformDevice>();
+  ASSERT_NE(pd, nullptr);
+
+  metal::ArgumentBufferDesc desc;
+  desc.arguments.push_back({metal::ArgumentBufferDesc::ArgumentType::Buffer, 0});
+  desc.arguments.push_back({metal::ArgumentBufferDesc::ArgumentType::Texture, 1});
+  desc.arguments.push_back({metal::ArgumentBufferDesc::ArgumentType::SamplerState, 2});
+
+  Result ret;
+  auto argumentBuffer = pd->createArgumentBuffer(desc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(argumentBuffer, nullptr);
+
+  auto buffer = iglDev_->createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Uniform, nullptr, 16),
+                                      &ret);
+  ASSERT_TRUE(ret.isOk());
+  const TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                                 1,
+                                                 1,
+                                                 TextureDesc::TextureUsageBits::Sampled);
+  auto texture = iglDev_->createTexture(texDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto sampler = iglDev_->createSamplerState(SamplerStateDesc(), &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  argumentBuffer->setBuffer(0, *buffer);
+  argumentBuffer->setTexture(1, texture.get());
+  argumentBuffer->setSamplerState(2, *sampler);
+
+  // samplers don't have to be made resident
+  ASSERT_EQ(argumentBuffer->getResources().size(), 2u);
+  ASSERT_EQ(argumentBuffer->getResources().at(1).usage, MTLResourceUsageRead);
+
+  argumentBuffer->setTexture(1, nullptr);
+  ASSERT_EQ(argumentBuffer->getResources().size(), 1u);
+}
+
 } // namespace tests
 } // namespace igl
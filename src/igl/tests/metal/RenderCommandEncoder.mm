@@ -6,6 +6,7 @@
  */
 
 #include <igl/metal/RenderCommandEncoder.h>
+#include <igl/metal/Texture.h>
 
 #include "../util/Common.h"
 
@@ -92,6 +93,51 @@ TEST_F(RenderCommandEncoderMTLTest, CreateRenderCommandEncoderAll) {
   encoder->endEncoding();
 }
 
+//
+// CachedRenderPassDescriptor
+//
+// Render passes with the same load and store actions reuse the descriptor of the framebuffer,
+// with their own clear values
+//
+TEST_F(RenderCommandEncoderMTLTest, CachedRenderPassDescriptor) {
+  const TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                                 OFFSCREEN_RT_WIDTH,
+                                                 OFFSCREEN_RT_HEIGHT,
+                                                 TextureDesc::TextureUsageBits::Attachment);
+  Result ret;
+  std::shared_ptr<ITexture> offscreenTexture = device_->createTexture(texDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = offscreenTexture;
+  auto framebuffer = device_->createFramebuffer(framebufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  RenderPassDesc rpDesc;
+  rpDesc.colorAttachments.resize(1);
+  rpDesc.colorAttachments[0].loadAction = LoadAction::Clear;
+  rpDesc.colorAttachments[0].clearColor = {1.0f, 0.0f, 0.0f, 1.0f};
+  MTLRenderPassDescriptor* first =
+      metal::RenderCommandEncoder::createRenderPassDescriptor(rpDesc, framebuffer, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_EQ(first.colorAttachments[0].loadAction, MTLLoadActionClear);
+
+  rpDesc.colorAttachments[0].clearColor = {0.0f, 1.0f, 0.0f, 1.0f};
+  MTLRenderPassDescriptor* second =
+      metal::RenderCommandEncoder::createRenderPassDescriptor(rpDesc, framebuffer, &ret);
+  ASSERT_TRUE(ret.isOk());
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(second.colorAttachments[0].clearColor.green, 1.0);
+  EXPECT_EQ(second.colorAttachments[0].texture,
+            static_cast<metal::Texture&>(*offscreenTexture).get());
+
+  rpDesc.colorAttachments[0].loadAction = LoadAction::Load;
+  MTLRenderPassDescriptor* third =
+      metal::RenderCommandEncoder::createRenderPassDescriptor(rpDesc, framebuffer, &ret);
+  ASSERT_TRUE(ret.isOk());
+  EXPECT_NE(first, third);
+  EXPECT_EQ(third.colorAttachments[0].loadAction, MTLLoadActionLoad);
+}
+
 TEST_F(RenderCommandEncoderMTLTest, ToMTLPrimitiveType) {
   std::vector<std::pair<PrimitiveType, MTLPrimitiveType>> inputAndExpectedList = {
       std::make_pair(PrimitiveType::Line, MTLPrimitiveTypeLine),
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/ResourceLoader.h>
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <igl/metal/PlatformDevice.h>
+
+namespace igl {
+namespace tests {
+
+class ResourceLoaderMTLTest : public ::testing::Test {
+ public:
+  ResourceLoaderMTLTest() = default;
+  ~ResourceLoaderMTLTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+
+    ASSERT_NE(iglDev_, nullptr);
+    ASSERT_NE(cmdQueue_, nullptr);
+
+    platformDevice_ = iglDev_->getPlatformDevice<metal::PlatformDevice>();
+    ASSERT_NE(platformDevice_, nullptr);
+
+    path_ = std::string([NSTemporaryDirectory() UTF8String]) + "/igl_resource_loader_test.bin";
+    std::ofstream file(path_, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(kData), sizeof(kData));
+  }
+  void TearDown() override {
+    std::remove(path_.c_str());
+  }
+
+ public:
+  static constexpr uint32_t kData[4] = {1, 2, 3, 4};
+
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  const metal::PlatformDevice* platformDevice_ = nullptr;
+  std::string path_;
+};
+
+TEST_F(ResourceLoaderMTLTest, LoadBuffer) {
+  Result ret;
+  BufferDesc bufferDesc(BufferDesc::BufferTypeBits::Storage, nullptr, sizeof(kData));
+  bufferDesc.storage = ResourceStorage::Shared;
+  auto buffer = iglDev_->createBuffer(bufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  auto loader = platformDevice_->createResourceLoader();
+  ASSERT_NE(loader, nullptr);
+
+  // Skip the first element of the file
+  ret = loader->loadBuffer(*buffer, BufferRange(sizeof(uint32_t) * 3, 0), path_, sizeof(uint32_t));
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+
+  loader->commit();
+  loader->waitUntilCompleted();
+
+  const auto* contents =
+      static_cast<const uint32_t*>(buffer->map(BufferRange(sizeof(kData)), &ret));
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_EQ(contents[0], 2u);
+  ASSERT_EQ(contents[2], 4u);
+  buffer->unmap();
+}
+
+TEST_F(ResourceLoaderMTLTest, MissingFile) {
+  Result ret;
+  auto buffer = iglDev_->createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Storage, nullptr, sizeof(kData)), &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  auto loader = platformDevice_->createResourceLoader();
+  ret = loader->loadBuffer(*buffer, BufferRange(sizeof(kData), 0), path_ + ".missing");
+  ASSERT_FALSE(ret.isOk());
+}
+
+} // namespace tests
+} // namespace igl
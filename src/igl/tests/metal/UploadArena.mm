@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/UploadArena.h>
+
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <igl/metal/BufferSynchronizationManager.h>
+#include <vector>
+
+namespace igl {
+namespace tests {
+
+class UploadArenaMTLTest : public ::testing::Test {
+ public:
+  UploadArenaMTLTest() = default;
+  ~UploadArenaMTLTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    device_ = MTLCreateSystemDefaultDevice();
+    ASSERT_NE(device_, nil);
+    syncManager_ = std::make_shared<metal::BufferSynchronizationManager>(kMaxInFlightBuffers);
+  }
+  void TearDown() override {}
+
+ public:
+  static constexpr size_t kMaxInFlightBuffers = 3;
+  static constexpr size_t kPageSize = 4096;
+
+  id<MTLDevice> device_ = nil;
+  std::shared_ptr<metal::BufferSynchronizationManager> syncManager_;
+};
+
+TEST_F(UploadArenaMTLTest, AllocationsAreAlignedAndCopied) {
+  metal::UploadArena arena(device_, syncManager_, kPageSize);
+
+  const std::vector<uint8_t> data(100, 42);
+  const auto first = arena.allocate(data.data(), data.size());
+  const auto second = arena.allocate(data.data(), data.size());
+  ASSERT_NE(first.buffer, nil);
+  ASSERT_EQ(first.buffer, second.buffer);
+  ASSERT_EQ(second.offset % metal::UploadArena::kAlignment, 0u);
+  ASSERT_GE(second.offset, first.offset + data.size());
+  ASSERT_EQ(memcmp(static_cast<uint8_t*>(second.buffer.contents) + second.offset,
+                   data.data(),
+                   data.size()),
+            0);
+
+  // Larger than a page
+  const std::vector<uint8_t> large(kPageSize * 2, 1);
+  const auto third = arena.allocate(large.data(), large.size());
+  ASSERT_NE(third.buffer, first.buffer);
+  ASSERT_EQ(third.offset, 0u);
+  ASSERT_GE(third.buffer.length, large.size());
+}
+
+TEST_F(UploadArenaMTLTest, FramesAreRecycled) {
+  metal::UploadArena arena(device_, syncManager_, kPageSize);
+
+  const std::vector<uint8_t> data(kPageSize, 7);
+  const auto first = arena.allocate(data.data(), data.size());
+
+  // Every in-flight frame gets its own pages
+  syncManager_->manageEndOfFrameSync();
+  const auto second = arena.allocate(data.data(), data.size());
+  ASSERT_NE(first.buffer, second.buffer);
+
+  // Coming back to the same in-flight index reuses its pages from the start
+  for (size_t i = 1; i < kMaxInFlightBuffers; i++) {
+    syncManager_->manageEndOfFrameSync();
+  }
+  ASSERT_EQ(syncManager_->getCurrentInFlightBufferIndex(), 0u);
+  const auto third = arena.allocate(data.data(), data.size());
+  ASSERT_EQ(first.buffer, third.buffer);
+  ASSERT_EQ(third.offset, 0u);
+  ASSERT_EQ(arena.getAllocatedSize(), 2 * kPageSize);
+}
+
+} // namespace tests
+} // namespace igl
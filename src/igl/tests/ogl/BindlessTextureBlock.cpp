@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/BindlessTextureBlock.h>
+
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <string>
+
+namespace igl {
+namespace tests {
+
+//
+// BindlessTextureBlockOGLTest
+//
+// Tests the layout of the bindless texture block and the shader prologue declaring it.
+//
+class BindlessTextureBlockOGLTest : public ::testing::Test {
+ public:
+  BindlessTextureBlockOGLTest() = default;
+  ~BindlessTextureBlockOGLTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+  }
+
+  void TearDown() override {}
+};
+
+//
+// Handles
+//
+// Vertex and fragment handles of the same slot are independent and keep all 64 bits.
+//
+TEST_F(BindlessTextureBlockOGLTest, Handles) {
+  opengl::BindlessTextureBlock block;
+
+  const uint64_t vertexHandle = 0x123456789abcdef0ull;
+  const uint64_t fragmentHandle = 0xfedcba9876543210ull;
+  block.setVertexTexture(3, vertexHandle);
+  block.setFragmentTexture(3, fragmentHandle);
+
+  ASSERT_EQ(block.getVertexTexture(3), vertexHandle);
+  ASSERT_EQ(block.getFragmentTexture(3), fragmentHandle);
+  ASSERT_EQ(block.getVertexTexture(2), 0u);
+  ASSERT_EQ(block.getFragmentTexture(4), 0u);
+
+  block.clear();
+  ASSERT_EQ(block.getVertexTexture(3), 0u);
+  ASSERT_EQ(block.getFragmentTexture(3), 0u);
+}
+
+//
+// ShaderPrologue
+//
+// Each stage reads its own half of the slots through the helpers of the Vulkan backend.
+//
+TEST_F(BindlessTextureBlockOGLTest, ShaderPrologue) {
+  const std::string vertexPrologue =
+      opengl::BindlessTextureBlock::getShaderPrologue(ShaderStage::Vertex);
+  const std::string fragmentPrologue =
+      opengl::BindlessTextureBlock::getShaderPrologue(ShaderStage::Fragment);
+
+  for (const auto& prologue : {vertexPrologue, fragmentPrologue}) {
+    ASSERT_EQ(prologue.find("#version"), 0u);
+    ASSERT_NE(prologue.find("GL_ARB_bindless_texture"), std::string::npos);
+    ASSERT_NE(prologue.find(opengl::BindlessTextureBlock::kBlockName), std::string::npos);
+    ASSERT_NE(prologue.find("vec4 textureSample2D(uint slotTexture, uint slotSampler, vec2 uv)"),
+              std::string::npos);
+  }
+  ASSERT_NE(vertexPrologue.find("slots[slot].xy"), std::string::npos);
+  ASSERT_NE(fragmentPrologue.find("slots[slot].zw"), std::string::npos);
+}
+
+} // namespace tests
+} // namespace igl
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/CommandStream.h>
+
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <vector>
+
+namespace igl {
+namespace tests {
+
+//
+// CommandStreamOGLTest
+//
+// Tests the arena backed command stream used by deferred render command encoders.
+//
+class CommandStreamOGLTest : public ::testing::Test {
+ public:
+  CommandStreamOGLTest() = default;
+  ~CommandStreamOGLTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+  }
+
+  void TearDown() override {}
+};
+
+//
+// RecordAndRead
+//
+// Commands are read back in recording order, including commands spanning several chunks and
+// commands larger than a chunk. reset() drops the commands and the retained objects.
+//
+TEST_F(CommandStreamOGLTest, RecordAndRead) {
+  opengl::CommandStream stream;
+  ASSERT_TRUE(stream.empty());
+
+  auto object = std::make_shared<int>(42);
+  const uint32_t objectIndex = stream.retain(object);
+  ASSERT_EQ(object.use_count(), 2);
+
+  const size_t kNumCommands = 2 * opengl::CommandStream::kChunkSize / 16;
+  for (uint32_t i = 0; i != kNumCommands; i++) {
+    const uint32_t value = i * 3;
+    memcpy(stream.append(i, sizeof(value)), &value, sizeof(value));
+  }
+  const std::vector<uint8_t> large(opengl::CommandStream::kChunkSize * 2, 7);
+  memcpy(stream.append(kNumCommands, large.size()), large.data(), large.size());
+  stream.append(kNumCommands + 1, 0);
+  ASSERT_FALSE(stream.empty());
+
+  uint32_t expectedOpcode = 0;
+  stream.forEach([&](uint32_t opcode, const uint8_t* payload, size_t size) {
+    ASSERT_EQ(opcode, expectedOpcode);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(payload) % 8, 0u);
+    if (opcode < kNumCommands) {
+      uint32_t value = 0;
+      ASSERT_EQ(size, sizeof(value));
+      memcpy(&value, payload, sizeof(value));
+      ASSERT_EQ(value, opcode * 3);
+    } else if (opcode == kNumCommands) {
+      ASSERT_EQ(size, large.size());
+      ASSERT_EQ(memcmp(payload, large.data(), size), 0);
+    } else {
+      ASSERT_EQ(size, 0u);
+    }
+    expectedOpcode++;
+  });
+  ASSERT_EQ(expectedOpcode, kNumCommands + 2);
+  ASSERT_EQ(*stream.getObject<int>(objectIndex), 42);
+
+  stream.reset();
+  ASSERT_TRUE(stream.empty());
+  ASSERT_EQ(object.use_count(), 1);
+
+  stream.append(5, 0);
+  size_t numCommands = 0;
+  stream.forEach([&](uint32_t opcode, const uint8_t* /*payload*/, size_t /*size*/) {
+    ASSERT_EQ(opcode, 5u);
+    numCommands++;
+  });
+  ASSERT_EQ(numCommands, 1u);
+}
+
+} // namespace tests
+} // namespace igl
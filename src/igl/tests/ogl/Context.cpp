@@ -5,12 +5,19 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include "../util/Common.h"
 #include "../util/TestDevice.h"
 
+#include <cstdio>
+#include <filesystem>
 #include <gtest/gtest.h>
 #include <igl/opengl/Device.h>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/IContext.h>
+#include <igl/opengl/ProgramBinaryCache.h>
+#include <igl/opengl/Shader.h>
+#include <igl/opengl/VertexArrayCache.h>
+#include <vector>
 
 #define DUMMY_FILE_NAME "dummy_file_name"
 #define DUMMY_LINE_NUM 0
@@ -213,6 +220,39 @@ TEST_F(ContextOGLTest, CheckForErrorsInvalidEnum) {
   ASSERT_EQ(ret, GL_INVALID_ENUM);
 }
 
+/// Sampled error checking reports errors at the sampled calls and narrows down recurring errors
+/// to the failing call.
+TEST_F(ContextOGLTest, SampledErrorCheck) {
+  std::vector<opengl::IContext::SampledError> errors;
+  context_->enableSampledErrorCheck(
+      true, 4, false, [&errors](const opengl::IContext::SampledError& error) {
+        errors.push_back(error);
+      });
+
+  // GL_INVALID_ENUM, found by the check after the 4th call
+  context_->activeTexture(GL_SRC_ALPHA);
+  for (int i = 0; i != 3; i++) {
+    context_->activeTexture(GL_TEXTURE0);
+  }
+  ASSERT_EQ(errors.size(), 1u);
+  ASSERT_EQ(errors[0].error, GL_INVALID_ENUM);
+  ASSERT_FALSE(errors[0].isExact);
+
+  // the interval is halved after each error until the failing call is checked right away
+  for (int i = 0; i != 2; i++) {
+    context_->activeTexture(GL_TEXTURE0);
+    context_->activeTexture(GL_SRC_ALPHA);
+  }
+  ASSERT_EQ(errors.size(), 3u);
+  ASSERT_FALSE(errors[1].isExact);
+  ASSERT_TRUE(errors[2].isExact);
+
+  context_->enableSampledErrorCheck(false);
+  context_->activeTexture(GL_SRC_ALPHA);
+  ASSERT_EQ(errors.size(), 3u);
+  ASSERT_EQ(context_->checkForErrors(DUMMY_FILE_NAME, DUMMY_LINE_NUM), GL_INVALID_ENUM);
+}
+
 #ifndef GL_UNSIGNED_SHORT_4_4_4_4
 #define GL_UNSIGNED_SHORT_4_4_4_4 0x8033
 #endif
@@ -310,5 +350,166 @@ TEST_F(ContextOGLTest, CheckForErrorsInvalidFrameBufferOperation) {
   context_->deleteFramebuffers(1, &frameBuffer);
 }
 
+/// The shadow state cache should drop binds which do not change the GL state, and it should send
+/// everything to OpenGL again after being invalidated.
+TEST_F(ContextOGLTest, StateCacheDropsRedundantBinds) {
+  context_->enableStateCache(true);
+
+  GLuint textures[2];
+  context_->genTextures(2, textures);
+  context_->activeTexture(GL_TEXTURE0);
+  context_->bindTexture(GL_TEXTURE_2D, textures[0]);
+  context_->enable(GL_BLEND);
+
+  const unsigned int callCount = context_->getCallCount();
+  context_->activeTexture(GL_TEXTURE0);
+  context_->bindTexture(GL_TEXTURE_2D, textures[0]);
+  context_->setEnabled(true, GL_BLEND);
+  ASSERT_EQ(callCount, context_->getCallCount());
+
+  // A different texture has to reach OpenGL
+  context_->bindTexture(GL_TEXTURE_2D, textures[1]);
+  ASSERT_EQ(callCount + 1, context_->getCallCount());
+
+  // After invalidation, the same bind is sent again
+  context_->invalidateStateCache();
+  context_->activeTexture(GL_TEXTURE0);
+  context_->bindTexture(GL_TEXTURE_2D, textures[0]);
+  ASSERT_EQ(callCount + 3, context_->getCallCount());
+
+  GLint retrievedTexture = -1;
+  context_->getIntegerv(GL_TEXTURE_BINDING_2D, &retrievedTexture);
+  ASSERT_EQ(textures[0], retrievedTexture);
+
+  // Deleting a bound texture forgets its binding
+  context_->deleteTextures({textures[0]});
+  context_->bindTexture(GL_TEXTURE_2D, textures[1]);
+  context_->getIntegerv(GL_TEXTURE_BINDING_2D, &retrievedTexture);
+  ASSERT_EQ(textures[1], retrievedTexture);
+
+  // Clean up
+  context_->bindTexture(GL_TEXTURE_2D, 0);
+  context_->deleteTextures({textures[1]});
+  context_->disable(GL_BLEND);
+  context_->enableStateCache(false);
+}
+
+/// With the state cache enabled, framebuffer binds and pixel store parameters which do not change
+/// the GL state are dropped, and queries for them are answered without reaching OpenGL.
+TEST_F(ContextOGLTest, StateCacheAnswersBindingQueries) {
+  context_->enableStateCache(true);
+
+  GLuint framebufferId = 0;
+  context_->genFramebuffers(1, &framebufferId);
+  context_->bindFramebuffer(GL_FRAMEBUFFER, framebufferId);
+  context_->pixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  const unsigned int callCount = context_->getCallCount();
+  context_->bindFramebuffer(GL_FRAMEBUFFER, framebufferId);
+  context_->pixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  GLint retrievedValue = -1;
+  context_->getIntegerv(GL_FRAMEBUFFER_BINDING, &retrievedValue);
+  ASSERT_EQ(framebufferId, retrievedValue);
+  context_->getIntegerv(GL_UNPACK_ALIGNMENT, &retrievedValue);
+  ASSERT_EQ(1, retrievedValue);
+  ASSERT_EQ(callCount, context_->getCallCount());
+
+  // Clean up
+  context_->pixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  context_->bindFramebuffer(GL_FRAMEBUFFER, 0);
+  context_->deleteFramebuffers(1, &framebufferId);
+  context_->enableStateCache(false);
+}
+
+/// Linked programs should be stored in the program binary cache, and a new context should be able
+/// to create the same programs from the cache file.
+TEST_F(ContextOGLTest, ProgramBinaryCache) {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "igl_ProgramBinaryCacheTest.bin").string();
+  std::remove(path.c_str());
+
+  if (!context_->enableProgramBinaryCache(path)) {
+    GTEST_SKIP() << "Program binaries are not supported";
+  }
+
+  std::unique_ptr<IShaderStages> stages;
+  util::createSimpleShaderStages(device_, stages);
+  ASSERT_TRUE(stages != nullptr);
+  ASSERT_EQ(context_->getProgramBinaryCache()->getNumPrograms(), 1u);
+  ASSERT_TRUE(context_->saveProgramBinaryCache());
+  stages = nullptr;
+
+  // A fresh cache reads the binary back from the file and the program is created from it
+  ASSERT_TRUE(context_->enableProgramBinaryCache(path));
+  ASSERT_EQ(context_->getProgramBinaryCache()->getNumPrograms(), 1u);
+  util::createSimpleShaderStages(device_, stages);
+  ASSERT_TRUE(stages != nullptr);
+  ASSERT_NE(static_cast<opengl::ShaderStages&>(*stages).getProgramID(), 0u);
+
+  stages = nullptr;
+  std::remove(path.c_str());
+}
+
+TEST_F(ContextOGLTest, SubmitFences) {
+  ASSERT_TRUE(context_->isSubmitHandleComplete(0));
+
+  const uint64_t first = context_->insertSubmitFence();
+  if (first == 0) {
+    GTEST_SKIP() << "Sync objects are not supported";
+  }
+  const uint64_t second = context_->insertSubmitFence();
+  ASSERT_GT(second, first);
+
+  // waiting for a handle also completes all older handles
+  context_->waitForSubmitHandle(second);
+  ASSERT_TRUE(context_->isSubmitHandleComplete(first));
+  ASSERT_TRUE(context_->isSubmitHandleComplete(second));
+
+  const uint64_t third = context_->insertSubmitFence();
+  context_->finish();
+  ASSERT_TRUE(context_->isSubmitHandleComplete(third));
+}
+
+TEST_F(ContextOGLTest, VertexArrayCache) {
+  if (!context_->enableVertexArrayCache(true)) {
+    GTEST_SKIP() << "Vertex array objects are not supported";
+  }
+  auto* cache = context_->getVertexArrayCache();
+  ASSERT_NE(cache, nullptr);
+
+  GLuint buffers[2];
+  context_->genBuffers(2, buffers);
+
+  opengl::VertexArrayCache::Key key;
+  key.pipelineId = 1;
+  key.indexBuffer = buffers[1];
+  key.vertexBuffers.push_back({0, buffers[0], 16});
+
+  ASSERT_EQ(cache->find(key), 0u);
+  const GLuint vertexArray = cache->insert(key);
+  ASSERT_NE(vertexArray, 0u);
+  ASSERT_EQ(cache->find(key), vertexArray);
+
+  // A different offset is a different vertex input
+  auto otherKey = key;
+  otherKey.vertexBuffers[0].offset = 0;
+  ASSERT_EQ(cache->find(otherKey), 0u);
+
+  // Deleting a buffer evicts every entry which references it
+  const uint64_t generation = cache->getGeneration();
+  context_->deleteBuffers(1, &buffers[1]);
+  ASSERT_EQ(cache->find(key), 0u);
+  ASSERT_NE(cache->getGeneration(), generation);
+
+  cache->insert(key);
+  cache->evictPipeline(key.pipelineId);
+  ASSERT_EQ(cache->size(), 0u);
+
+  context_->deleteBuffers(1, &buffers[0]);
+  ASSERT_TRUE(context_->enableVertexArrayCache(false));
+  ASSERT_EQ(context_->getVertexArrayCache(), nullptr);
+}
+
 } // namespace tests
 } // namespace igl
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <igl/opengl/Framebuffer.h>
+#include <vector>
+
+namespace igl {
+namespace tests {
+
+#define OFFSCREEN_RT_WIDTH 4
+#define OFFSCREEN_RT_HEIGHT 4
+
+//
+// FramebufferOGLTest
+//
+// Unit tests for the copy paths of igl::opengl::Framebuffer.
+//
+class FramebufferOGLTest : public ::testing::Test {
+ public:
+  FramebufferOGLTest() = default;
+  ~FramebufferOGLTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+
+    framebuffer_ = createFramebuffer();
+    ASSERT_TRUE(framebuffer_ != nullptr);
+  }
+  void TearDown() override {}
+
+  std::shared_ptr<IFramebuffer> createFramebuffer() const {
+    const TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                                   OFFSCREEN_RT_WIDTH,
+                                                   OFFSCREEN_RT_HEIGHT,
+                                                   TextureDesc::TextureUsageBits::Sampled |
+                                                       TextureDesc::TextureUsageBits::Attachment);
+    Result ret;
+    FramebufferDesc framebufferDesc;
+    framebufferDesc.colorAttachments[0].texture = iglDev_->createTexture(texDesc, &ret);
+    if (!ret.isOk()) {
+      return nullptr;
+    }
+    return iglDev_->createFramebuffer(framebufferDesc, &ret);
+  }
+
+  void clear(const std::shared_ptr<IFramebuffer>& framebuffer, const Color& color) const {
+    RenderPassDesc renderPass;
+    renderPass.colorAttachments.resize(1);
+    renderPass.colorAttachments[0].loadAction = LoadAction::Clear;
+    renderPass.colorAttachments[0].storeAction = StoreAction::Store;
+    renderPass.colorAttachments[0].clearColor = color;
+
+    Result ret;
+    auto cmdBuf = cmdQueue_->createCommandBuffer({}, &ret);
+    ASSERT_TRUE(ret.isOk());
+    auto cmds = cmdBuf->createRenderCommandEncoder(renderPass, framebuffer);
+    cmds->endEncoding();
+    cmdQueue_->submit(*cmdBuf);
+  }
+
+ protected:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  std::shared_ptr<IFramebuffer> framebuffer_;
+};
+
+//
+// CopyBytesColorAttachmentAsync
+//
+// The asynchronous readback returns the same pixels as the synchronous one.
+//
+TEST_F(FramebufferOGLTest, CopyBytesColorAttachmentAsync) {
+  clear(framebuffer_, {0.501f, 0.501f, 0.501f, 0.501f});
+
+  const auto rangeDesc = TextureRangeDesc::new2D(0, 0, OFFSCREEN_RT_WIDTH, OFFSCREEN_RT_HEIGHT);
+  auto& framebuffer = static_cast<opengl::Framebuffer&>(*framebuffer_);
+  auto readback = framebuffer.copyBytesColorAttachmentAsync(0, rangeDesc);
+  ASSERT_NE(readback, nullptr);
+  ASSERT_EQ(readback->getSize(), OFFSCREEN_RT_WIDTH * OFFSCREEN_RT_HEIGHT * sizeof(uint32_t));
+
+  std::vector<uint32_t> pixels(OFFSCREEN_RT_WIDTH * OFFSCREEN_RT_HEIGHT);
+  const Result ret = readback->getBytes(pixels.data());
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  ASSERT_TRUE(readback->isReady());
+  for (const uint32_t pixel : pixels) {
+    ASSERT_EQ(pixel, 0x80808080);
+  }
+}
+
+//
+// CopyTextureColorAttachment
+//
+// A copy of the color attachment lands in the destination texture, whichever GL path copies it.
+//
+TEST_F(FramebufferOGLTest, CopyTextureColorAttachment) {
+  auto destFramebuffer = createFramebuffer();
+  ASSERT_TRUE(destFramebuffer != nullptr);
+
+  clear(framebuffer_, {0.501f, 0.501f, 0.501f, 0.501f});
+  clear(destFramebuffer, {0, 0, 0, 0});
+
+  const auto rangeDesc = TextureRangeDesc::new2D(0, 0, OFFSCREEN_RT_WIDTH, OFFSCREEN_RT_HEIGHT);
+  framebuffer_->copyTextureColorAttachment(
+      *cmdQueue_, 0, destFramebuffer->getColorAttachment(0), rangeDesc);
+
+  std::vector<uint32_t> pixels(OFFSCREEN_RT_WIDTH * OFFSCREEN_RT_HEIGHT);
+  destFramebuffer->copyBytesColorAttachment(*cmdQueue_, 0, pixels.data(), rangeDesc);
+  for (const uint32_t pixel : pixels) {
+    ASSERT_EQ(pixel, 0x80808080);
+  }
+}
+
+} // namespace tests
+} // namespace igl
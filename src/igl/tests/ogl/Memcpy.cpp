@@ -67,5 +67,30 @@ TEST_F(MemcpyOGLTest, optimizedMemcpyAlignmentPermutation) {
   }
 }
 
+//
+// opengl::optimizedMemcpy
+//
+// Verify the vector sizes (vec4 up to mat4) are copied exactly, with 4 byte aligned pointers.
+//
+TEST_F(MemcpyOGLTest, optimizedMemcpyVectorSizes) {
+  uint32_t src[20];
+  uint32_t dst[20];
+  for (uint32_t i = 0; i != 20; i++) {
+    src[i] = i + 1;
+  }
+
+  for (size_t size : {16, 32, 48, 64}) {
+    for (size_t offset = 0; offset != 4; offset++) {
+      memset(dst, 0, sizeof(dst));
+      opengl::optimizedMemcpy(dst + offset, src, size);
+      const size_t count = size / sizeof(uint32_t);
+      for (size_t i = 0; i != 20; i++) {
+        const bool copied = i >= offset && i < offset + count;
+        ASSERT_EQ(dst[i], copied ? src[i - offset] : 0u);
+      }
+    }
+  }
+}
+
 } // namespace tests
 } // namespace igl
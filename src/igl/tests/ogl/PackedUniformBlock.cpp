@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/PackedUniformBlock.h>
+
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <string>
+
+namespace igl {
+namespace tests {
+
+//
+// PackedUniformBlockOGLTest
+//
+// Tests the rewriting of loose uniform declarations into the packed uniform block.
+//
+class PackedUniformBlockOGLTest : public ::testing::Test {
+ public:
+  PackedUniformBlockOGLTest() = default;
+  ~PackedUniformBlockOGLTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+  }
+
+  void TearDown() override {}
+};
+
+//
+// PackShaderSources
+//
+// Both stages get the same block holding the uniforms of both stages. Declarations which cannot
+// be packed are left alone.
+//
+TEST_F(PackedUniformBlockOGLTest, PackShaderSources) {
+  std::string vertexSource =
+      "#version 300 es\n"
+      "in vec4 position;\n"
+      "uniform mat4 mvp; // transform\n"
+      "uniform highp float scale;\n"
+      "#ifdef USE_OFFSET\n"
+      "uniform vec4 offset;\n"
+      "#endif\n"
+      "uniform float a, b;\n"
+      "void main() { gl_Position = mvp * position * scale; }\n";
+  std::string fragmentSource =
+      "#version 300 es\n"
+      "precision mediump float;\n"
+      "uniform sampler2D image;\n"
+      "uniform /* tint */ lowp vec4 color;\n"
+      "uniform float scale;\n"
+      "uniform vec3 lights[4];\n"
+      "out vec4 fragColor;\n"
+      "void main() { fragColor = color * scale; }\n";
+
+  ASSERT_TRUE(opengl::PackedUniformBlock::packShaderSources(vertexSource, fragmentSource));
+
+  const std::string block =
+      "layout(std140) uniform IGLPackedUniforms {\n"
+      "  highp mat4 mvp;\n"
+      "  highp float scale;\n"
+      "  highp vec4 color;\n"
+      "  highp vec3 lights[4];\n"
+      "};";
+  ASSERT_NE(vertexSource.find(block), std::string::npos);
+  ASSERT_NE(fragmentSource.find(block), std::string::npos);
+
+  ASSERT_EQ(vertexSource.find("uniform mat4 mvp;"), std::string::npos);
+  ASSERT_EQ(fragmentSource.find("uniform float scale;"), std::string::npos);
+  ASSERT_NE(vertexSource.find("uniform vec4 offset;"), std::string::npos);
+  ASSERT_NE(vertexSource.find("uniform float a, b;"), std::string::npos);
+  ASSERT_NE(fragmentSource.find("uniform sampler2D image;"), std::string::npos);
+}
+
+//
+// PackShaderSourcesConflicts
+//
+// Uniforms declared differently in both stages stay loose, and sources without uniform blocks are
+// not touched.
+//
+TEST_F(PackedUniformBlockOGLTest, PackShaderSourcesConflicts) {
+  std::string vertexSource = "#version 300 es\nuniform vec2 size;\nvoid main() {}\n";
+  std::string fragmentSource = "#version 300 es\nuniform vec4 size;\nvoid main() {}\n";
+  ASSERT_FALSE(opengl::PackedUniformBlock::packShaderSources(vertexSource, fragmentSource));
+
+  std::string oldVertexSource = "#version 100\nuniform float scale;\nvoid main() {}\n";
+  std::string oldFragmentSource = "#version 100\nuniform float scale;\nvoid main() {}\n";
+  const std::string originalSource = oldVertexSource;
+  ASSERT_FALSE(opengl::PackedUniformBlock::packShaderSources(oldVertexSource, oldFragmentSource));
+  ASSERT_EQ(oldVertexSource, originalSource);
+}
+
+} // namespace tests
+} // namespace igl
@@ -170,6 +170,49 @@ TEST_F(PipelineStateOGLTest, GetIndexByName) {
   ASSERT_NE(idx, -1);
 }
 
+//
+// UniformLocations
+//
+// This test checks the uniform table resolved at pipeline creation and the per-program
+// shadow copy of uniform values.
+//
+TEST_F(PipelineStateOGLTest, UniformLocations) {
+  Result ret;
+
+  std::unique_ptr<IShaderStages> stages;
+  igl::tests::util::createSimpleShaderStages(iglDev_, stages);
+  shaderStages_ = std::move(stages);
+
+  renderPipelineDesc_.shaderStages = shaderStages_;
+
+  auto pipelineState = iglDev_->createRenderPipeline(renderPipelineDesc_, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(pipelineState != nullptr);
+
+  const auto& glPipelineState =
+      static_cast<const igl::opengl::RenderPipelineState&>(*pipelineState);
+
+  const auto* sampler =
+      glPipelineState.getUniformLocation(igl::genNameHandle(data::shader::simpleSampler));
+  ASSERT_NE(sampler, nullptr);
+  ASSERT_GE(sampler->location, 0);
+  ASSERT_FALSE(sampler->isUniformBlock);
+  ASSERT_EQ(sampler->location,
+            pipelineState->getIndexByName(igl::genNameHandle(data::shader::simpleSampler),
+                                          igl::ShaderStage::Fragment));
+  ASSERT_EQ(glPipelineState.getUniformLocation(igl::genNameHandle("notAUniform")), nullptr);
+
+  auto* glShaderStages = glPipelineState.getShaderStages();
+  ASSERT_NE(glShaderStages, nullptr);
+
+  const GLint unit0 = 0;
+  const GLint unit1 = 1;
+  ASSERT_TRUE(glShaderStages->updateUniformShadow(sampler->location, &unit0, sizeof(unit0)));
+  ASSERT_FALSE(glShaderStages->updateUniformShadow(sampler->location, &unit0, sizeof(unit0)));
+  ASSERT_TRUE(glShaderStages->updateUniformShadow(sampler->location, &unit1, sizeof(unit1)));
+  ASSERT_FALSE(glShaderStages->updateUniformShadow(sampler->location, &unit1, sizeof(unit1)));
+}
+
 // Test static conversions from IGL ops to OGL ops
 TEST_F(PipelineStateOGLTest, ConvertOps) {
   //----------------
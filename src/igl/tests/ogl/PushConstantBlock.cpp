@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/TestDevice.h"
+
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <igl/opengl/Device.h>
+#include <igl/opengl/IContext.h>
+#include <igl/opengl/PushConstantBlock.h>
+
+namespace igl {
+namespace tests {
+
+//
+// PushConstantBlockOGLTest
+//
+// Tests the emulation of push constants with a uniform block.
+//
+class PushConstantBlockOGLTest : public ::testing::Test {
+ public:
+  PushConstantBlockOGLTest() = default;
+  ~PushConstantBlockOGLTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    iglDev_ = util::createTestDevice();
+    ASSERT_TRUE(iglDev_ != nullptr);
+    context_ = &static_cast<opengl::Device&>(*iglDev_).getContext();
+    ASSERT_TRUE(context_ != nullptr);
+  }
+
+  void TearDown() override {}
+
+ public:
+  std::shared_ptr<IDevice> iglDev_;
+  opengl::IContext* context_{};
+};
+
+//
+// Features
+//
+// Push constants are reported wherever uniform blocks are supported, with the size of Vulkan.
+//
+TEST_F(PushConstantBlockOGLTest, Features) {
+  const bool hasUniformBlocks = iglDev_->hasFeature(DeviceFeatures::UniformBlocks);
+  ASSERT_EQ(iglDev_->hasFeature(DeviceFeatures::PushConstants), hasUniformBlocks);
+
+  size_t maxBytes = 0;
+  iglDev_->getFeatureLimits(DeviceFeatureLimits::MaxPushConstantBytes, maxBytes);
+  ASSERT_EQ(maxBytes, hasUniformBlocks ? opengl::PushConstantBlock::kMaxSize : 0u);
+}
+
+//
+// UploadOnlyChanges
+//
+// Binding the block again is free unless its contents have changed.
+//
+TEST_F(PushConstantBlockOGLTest, UploadOnlyChanges) {
+  opengl::PackedUniformRing* ring = context_->getPushConstantRing();
+  if (ring == nullptr) {
+    GTEST_SKIP() << "Uniform blocks are not supported";
+  }
+
+  const float data[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+  const float otherData[4] = {5.0f, 6.0f, 7.0f, 8.0f};
+  opengl::PushConstantBlock block;
+  ASSERT_FALSE(block.hasData());
+  block.set(0, data, sizeof(data));
+  ASSERT_TRUE(block.hasData());
+
+  const uint64_t generation = ring->getGeneration();
+  block.bind(*ring);
+  const size_t offset0 = ring->upload(data, sizeof(data));
+
+  // same contents, nothing is uploaded
+  block.set(0, data, sizeof(data));
+  block.bind(*ring);
+  const size_t offset1 = ring->upload(data, sizeof(data));
+
+  // new contents, the block is uploaded again
+  block.set(0, otherData, sizeof(otherData));
+  block.bind(*ring);
+  const size_t offset2 = ring->upload(data, sizeof(data));
+
+  ASSERT_EQ(ring->getGeneration(), generation);
+  ASSERT_LT(offset1 - offset0, offset2 - offset1);
+
+  block.clear();
+  ASSERT_FALSE(block.hasData());
+}
+
+} // namespace tests
+} // namespace igl
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/RenderBundle.h>
+
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <igl/opengl/CommandStream.h>
+#include <igl/opengl/DeferredRenderCommandEncoder.h>
+
+namespace igl {
+namespace tests {
+
+namespace {
+
+size_t countCommands(const opengl::CommandStream& stream) {
+  size_t numCommands = 0;
+  stream.forEach([&](uint32_t /*opcode*/, const uint8_t* /*payload*/, size_t /*size*/) {
+    numCommands++;
+  });
+  return numCommands;
+}
+
+} // namespace
+
+//
+// RenderBundleOGLTest
+//
+// Tests recording render bundles and executing them from deferred render command encoders.
+//
+class RenderBundleOGLTest : public ::testing::Test {
+ public:
+  RenderBundleOGLTest() = default;
+  ~RenderBundleOGLTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+  }
+
+  void TearDown() override {}
+};
+
+//
+// RecordAndExecute
+//
+// A bundle can be executed several times and keeps its commands until it is recorded again.
+//
+TEST_F(RenderBundleOGLTest, RecordAndExecute) {
+  opengl::RenderBundle bundle;
+  ASSERT_TRUE(bundle.empty());
+
+  Result ret;
+  auto bundleEncoder = bundle.record(&ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(bundleEncoder != nullptr);
+  bundleEncoder->bindViewport({0.0f, 0.0f, 64.0f, 64.0f, 0.0f, 1.0f});
+  bundleEncoder->setStencilReferenceValue(1);
+  bundleEncoder->draw(PrimitiveType::Triangle, 0, 3);
+  bundleEncoder->endEncoding();
+  ASSERT_FALSE(bundle.empty());
+
+  opengl::CommandStream stream;
+  opengl::DeferredRenderCommandEncoder encoder(nullptr, stream);
+  encoder.executeRenderBundle(bundle);
+  encoder.executeRenderBundle(bundle);
+  encoder.endEncoding();
+  ASSERT_EQ(countCommands(stream), 6u);
+
+  bundleEncoder = bundle.record(&ret);
+  ASSERT_TRUE(bundle.empty());
+  bundleEncoder->endEncoding();
+}
+
+} // namespace tests
+} // namespace igl
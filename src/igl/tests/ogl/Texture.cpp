@@ -13,6 +13,7 @@
 #include <igl/opengl/TextureBuffer.h>
 #include <igl/opengl/TextureTarget.h>
 #include <string>
+#include <vector>
 
 #if IGL_PLATFORM_IOS
 #include <igl/opengl/ios/HWDevice.h>
@@ -320,5 +321,39 @@ TEST_F(TextureOGLTest, TextureAlignment) {
   }
 }
 
+//
+// Async Texture Uploads Test
+//
+// Uploads through the pixel unpack buffer ring, including more uploads in a row than the ring has
+// buffers, so some of them fall back to direct uploads
+//
+TEST_F(TextureOGLTest, AsyncTextureUploads) {
+  if (!context_->enableAsyncTextureUploads(true, 2)) {
+    GTEST_SKIP() << "Pixel unpack buffers cannot be mapped and fenced";
+  }
+  ASSERT_NE(context_->getPixelUnpackBufferRing(), nullptr);
+
+  constexpr size_t width = 16;
+  const std::vector<uint32_t> pixels(width * width, 0xff00ff00);
+
+  Result ret;
+  const TextureDesc texDesc = TextureDesc::new2D(
+      TextureFormat::RGBA_UNorm8, width, width, TextureDesc::TextureUsageBits::Sampled);
+  auto texture = device_->createTexture(texDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  for (int i = 0; i != 4; i++) {
+    ret = texture->upload(TextureRangeDesc::new2D(0, 0, width, width), pixels.data());
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+  }
+  // a sub-rect with a padded stride
+  ret = texture->upload(TextureRangeDesc::new2D(1, 1, 3, 3), pixels.data(), width * 4);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  ASSERT_EQ(context_->getError(), GL_NO_ERROR);
+
+  ASSERT_TRUE(context_->enableAsyncTextureUploads(false));
+  ASSERT_EQ(context_->getPixelUnpackBufferRing(), nullptr);
+}
+
 } // namespace tests
 } // namespace igl
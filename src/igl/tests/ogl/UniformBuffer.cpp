@@ -16,6 +16,7 @@
 #include <igl/IGL.h>
 #include <igl/NameHandle.h>
 #include <igl/opengl/PlatformDevice.h>
+#include <igl/opengl/UniformBuffer.h>
 #include <string>
 
 // to not use extra curly braces in initializer lists
@@ -1221,5 +1222,38 @@ TEST_F(UniformBufferTest, UniformArrayBinding) {
   }
 }
 
+//
+// UniformBufferAsUniformBlock
+//
+// A uniform buffer created without the UniformBlock hint can back a uniform block where the
+// context has uniform blocks, and keeps accepting uploads once its GPU copy exists.
+//
+TEST_F(UniformBufferTest, UniformBufferAsUniformBlock) {
+  Result ret;
+  std::array<float, 8> values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+  BufferDesc bufDesc(BufferDesc::BufferTypeBits::Uniform, values.data(), sizeof(values));
+  auto buffer = iglDev_->createBuffer(bufDesc, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  auto& uniformBuffer = static_cast<opengl::UniformBuffer&>(*buffer);
+
+  uniformBuffer.bindRange(0, 0, &ret);
+  if (!iglDev_->hasFeature(DeviceFeatures::UniformBlocks)) {
+    ASSERT_EQ(ret.code, Result::Code::Unimplemented);
+    return;
+  }
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+
+  values[0] = 42.0f;
+  ret = buffer->upload(values.data(), BufferRange(sizeof(float), 0));
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  uniformBuffer.bindRange(0, 0, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+
+  const auto* data = static_cast<const float*>(buffer->map(BufferRange(sizeof(values), 0), &ret));
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  ASSERT_EQ(data[0], 42.0f);
+  buffer->unmap();
+}
+
 } // namespace tests
 } // namespace igl
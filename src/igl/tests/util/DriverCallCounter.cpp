@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "DriverCallCounter.h"
+
+#include <igl/opengl/IContext.h>
+#include <igl/opengl/PlatformDevice.h>
+
+namespace igl {
+namespace tests {
+namespace util {
+
+DriverCallCounter::DriverCallCounter(IDevice& device) {
+#if IGL_BACKEND_OPENGL
+  if (device.getBackendType() == BackendType::OpenGL) {
+    context_ = &device.getPlatformDevice<opengl::PlatformDevice>()->getContext();
+    context_->enableCallCountsByName(true);
+  }
+#endif // IGL_BACKEND_OPENGL
+}
+
+DriverCallCounter::~DriverCallCounter() {
+#if IGL_BACKEND_OPENGL
+  if (context_) {
+    context_->enableCallCountsByName(false);
+  }
+#endif // IGL_BACKEND_OPENGL
+}
+
+void DriverCallCounter::add(const ICommandBuffer& commandBuffer) {
+  const CommandBufferStatistics& statistics = commandBuffer.getStatistics();
+  for (size_t i = 0; i != static_cast<size_t>(CommandBufferCounter::Count); ++i) {
+    counters_[i] += statistics.get(static_cast<CommandBufferCounter>(i));
+  }
+}
+
+uint64_t DriverCallCounter::get(CommandBufferCounter counter) const {
+  return counters_[static_cast<size_t>(counter)];
+}
+
+unsigned int DriverCallCounter::getGLCallCount(const char* entryPoint) const {
+#if IGL_BACKEND_OPENGL
+  return context_ ? context_->getCallCount(entryPoint) : 0;
+#else
+  return 0;
+#endif // IGL_BACKEND_OPENGL
+}
+
+} // namespace util
+} // namespace tests
+} // namespace igl
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace opengl {
+class IContext;
+} // namespace opengl
+
+namespace tests {
+namespace util {
+
+/// Counts what a scripted render sends to the driver, so tests can catch CPU overhead regressions
+/// of the encoders. The statistics of the command buffers passed to add() are accumulated on every
+/// backend (on Vulkan they count pipeline binds and descriptor updates). On OpenGL, the calls of
+/// every IContext entry point are also counted while the counter is alive.
+class DriverCallCounter final {
+ public:
+  explicit DriverCallCounter(IDevice& device);
+  ~DriverCallCounter();
+
+  DriverCallCounter(const DriverCallCounter&) = delete;
+  DriverCallCounter& operator=(const DriverCallCounter&) = delete;
+
+  /// Accumulates the statistics of a command buffer after its commands were encoded
+  void add(const ICommandBuffer& commandBuffer);
+  /// Sum of `counter` over the command buffers passed to add()
+  [[nodiscard]] uint64_t get(CommandBufferCounter counter) const;
+  /// Calls of an IContext entry point (e.g. "bindTexture") so far, always 0 on other backends
+  [[nodiscard]] unsigned int getGLCallCount(const char* entryPoint) const;
+
+ private:
+  opengl::IContext* context_ = nullptr;
+  uint64_t counters_[static_cast<size_t>(CommandBufferCounter::Count)] = {};
+};
+
+} // namespace util
+} // namespace tests
+} // namespace igl
@@ -5,9 +5,27 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 #include <gtest/gtest.h>
 #include <igl/IGL.h>
+#include <igl/vulkan/CommandBuffer.h>
+#include <igl/vulkan/Device.h>
+#include <igl/vulkan/DeviceGroup.h>
+#include <igl/vulkan/HWDevice.h>
+#include <igl/vulkan/SamplerState.h>
+#include <igl/vulkan/Texture.h>
+#include <igl/vulkan/VulkanBuffer.h>
+#include <igl/vulkan/VulkanImage.h>
+#include <igl/vulkan/VulkanMipmapGenerator.h>
+#include <igl/vulkan/VulkanTexture.h>
 
+#include "../data/ShaderData.h"
 #include "../util/TestDevice.h"
 
 namespace igl {
@@ -48,5 +66,495 @@ TEST_F(DeviceVulkanTest, CreateCommandQueue) {
   ASSERT_NE(cmdQueue, nullptr);
 }
 
+/// CreateShaderModules
+/// Compile several shader modules concurrently
+TEST_F(DeviceVulkanTest, CreateShaderModules) {
+  auto& device = static_cast<vulkan::Device&>(*iglDev_);
+
+  const std::vector<ShaderModuleDesc> descs = {
+      ShaderModuleDesc::fromStringInput(
+          data::shader::VULKAN_SIMPLE_VERT_SHADER, {ShaderStage::Vertex, "main"}, "vert"),
+      ShaderModuleDesc::fromStringInput(
+          data::shader::VULKAN_SIMPLE_FRAG_SHADER, {ShaderStage::Fragment, "main"}, "frag"),
+      ShaderModuleDesc::fromStringInput(
+          data::shader::VULKAN_SIMPLE_FRAG_SHADER_FLOAT, {ShaderStage::Fragment, "main"}, "frag1"),
+  };
+
+  Result ret;
+  const auto modules = device.createShaderModules(descs, &ret);
+
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_EQ(modules.size(), descs.size());
+  for (const auto& m : modules) {
+    EXPECT_NE(m, nullptr);
+  }
+}
+
+/// GrowBindlessDescriptorSet
+/// Create more textures than the initial capacity of the bindless arrays
+TEST_F(DeviceVulkanTest, GrowBindlessDescriptorSet) {
+  const auto& ctx = static_cast<vulkan::Device&>(*iglDev_).getVulkanContext();
+
+  const uint32_t initialMaxTextures = ctx.bindlessMaxTextures_;
+  const uint32_t numTextures = 2 * initialMaxTextures;
+
+  Result ret;
+  auto cmdQueue = iglDev_->createCommandQueue({CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  const TextureDesc texDesc = TextureDesc::new2D(
+      TextureFormat::RGBA_UNorm8, 1, 1, TextureDesc::TextureUsageBits::Sampled);
+
+  std::vector<std::shared_ptr<ITexture>> textures;
+  for (uint32_t i = 0; i != numTextures; i++) {
+    textures.push_back(iglDev_->createTexture(texDesc, &ret));
+    ASSERT_TRUE(ret.isOk());
+  }
+
+  // the descriptor set is updated when a new encoder is created
+  auto cmdBuffer = cmdQueue->createCommandBuffer({}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto encoder = cmdBuffer->createComputeCommandEncoder();
+  ASSERT_NE(encoder, nullptr);
+  encoder->endEncoding();
+  cmdQueue->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  EXPECT_GT(ctx.bindlessMaxTextures_, initialMaxTextures);
+}
+
+/// CreateTexturesConcurrently
+/// Textures created from several threads get distinct bindless indices
+TEST_F(DeviceVulkanTest, CreateTexturesConcurrently) {
+  constexpr uint32_t kNumThreads = 4;
+  constexpr uint32_t kNumTexturesPerThread = 32;
+
+  const TextureDesc texDesc = TextureDesc::new2D(
+      TextureFormat::RGBA_UNorm8, 1, 1, TextureDesc::TextureUsageBits::Sampled);
+
+  std::array<std::vector<std::shared_ptr<ITexture>>, kNumThreads> textures;
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t != kNumThreads; t++) {
+    threads.emplace_back([this, &texDesc, &list = textures[t]]() {
+      for (uint32_t i = 0; i != kNumTexturesPerThread; i++) {
+        list.push_back(iglDev_->createTexture(texDesc, nullptr));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::unordered_set<uint64_t> ids;
+  for (const auto& list : textures) {
+    for (const auto& texture : list) {
+      ASSERT_NE(texture, nullptr);
+      EXPECT_TRUE(ids.insert(texture->getTextureId()).second);
+    }
+  }
+  EXPECT_EQ(ids.size(), kNumThreads * kNumTexturesPerThread);
+}
+
+/// GenerateMipmapCompute
+/// Storage textures of supported formats generate mipmaps with a compute dispatch
+TEST_F(DeviceVulkanTest, GenerateMipmapCompute) {
+  const auto& ctx = static_cast<vulkan::Device&>(*iglDev_).getVulkanContext();
+
+  Result ret;
+  auto cmdQueue = iglDev_->createCommandQueue({CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                           64,
+                                           64,
+                                           TextureDesc::TextureUsageBits::Sampled |
+                                               TextureDesc::TextureUsageBits::Storage);
+  texDesc.numMipLevels = 7;
+
+  auto texture = iglDev_->createTexture(texDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  const std::vector<uint32_t> pixels(64 * 64, 0xff0000ff);
+  ASSERT_TRUE(texture->upload(TextureRangeDesc::new2D(0, 0, 64, 64), pixels.data()).isOk());
+
+  const auto& image = static_cast<vulkan::Texture&>(*texture).getVulkanTexture().getVulkanImage();
+  const VkImageLayout layout = image.imageLayout_;
+
+  texture->generateMipmap(*cmdQueue);
+  ctx.waitIdle();
+
+  EXPECT_EQ(image.imageLayout_, layout);
+
+  if (ctx.mipmapGenerator_ && ctx.mipmapGenerator_->isSupported(image)) {
+    EXPECT_EQ(image.storageMipViews_.size(), 7u);
+  } else {
+    // the blit path does not need storage views
+    EXPECT_TRUE(image.storageMipViews_.empty());
+  }
+}
+
+/// ShareSamplers
+/// Sampler states with equal descriptors share the same bindless sampler
+TEST_F(DeviceVulkanTest, ShareSamplers) {
+  Result ret;
+  SamplerStateDesc desc = SamplerStateDesc::newLinear();
+
+  auto sampler0 = iglDev_->createSamplerState(desc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto sampler1 = iglDev_->createSamplerState(desc, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  desc.addressModeU = SamplerAddressMode::Clamp;
+  auto sampler2 = iglDev_->createSamplerState(desc, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  const auto& s0 = static_cast<const vulkan::SamplerState&>(*sampler0);
+  const auto& s1 = static_cast<const vulkan::SamplerState&>(*sampler1);
+  const auto& s2 = static_cast<const vulkan::SamplerState&>(*sampler2);
+
+  EXPECT_NE(s0.getSamplerId(), 0u);
+  EXPECT_EQ(s0.getSamplerId(), s1.getSamplerId());
+  EXPECT_NE(s0.getSamplerId(), s2.getSamplerId());
+}
+
+/// CacheFramebufferImageViews
+/// Rendering into the same mip-level and layer of a texture reuses its image view
+TEST_F(DeviceVulkanTest, CacheFramebufferImageViews) {
+  Result ret;
+  const TextureDesc desc = TextureDesc::new2DArray(
+      TextureFormat::RGBA_UNorm8, 16, 16, 2, TextureDesc::TextureUsageBits::Attachment);
+
+  auto texture = iglDev_->createTexture(desc, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  const auto& tex = static_cast<const vulkan::Texture&>(*texture);
+
+  const VkImageView layer0 = tex.getVkImageViewForFramebuffer(0, 0, FramebufferMode::Mono);
+  const VkImageView layer1 = tex.getVkImageViewForFramebuffer(0, 1, FramebufferMode::Mono);
+
+  EXPECT_NE(layer0, VK_NULL_HANDLE);
+  EXPECT_NE(layer0, layer1);
+  EXPECT_EQ(layer0, tex.getVkImageViewForFramebuffer(0, 0, FramebufferMode::Mono));
+  EXPECT_EQ(layer1, tex.getVkImageViewForFramebuffer(0, 1, FramebufferMode::Mono));
+  EXPECT_NE(layer0, tex.getVkImageViewForFramebuffer(0, 0, FramebufferMode::Stereo));
+}
+
+/// TrackLayerLayouts
+/// Uploading a single layer of a texture array changes the layout of this layer only
+TEST_F(DeviceVulkanTest, TrackLayerLayouts) {
+  Result ret;
+  const TextureDesc desc = TextureDesc::new2DArray(
+      TextureFormat::RGBA_UNorm8, 16, 16, 2, TextureDesc::TextureUsageBits::Sampled);
+
+  auto texture = iglDev_->createTexture(desc, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  const std::vector<uint32_t> pixels(16 * 16, 0xff0000ff);
+  ASSERT_TRUE(
+      texture->upload(TextureRangeDesc::new2DArray(0, 0, 16, 16, 1, 1), pixels.data()).isOk());
+
+  const auto& image = static_cast<vulkan::Texture&>(*texture).getVulkanTexture().getVulkanImage();
+
+  EXPECT_EQ(image.getImageLayout(0, 0), VK_IMAGE_LAYOUT_UNDEFINED);
+  EXPECT_EQ(image.getImageLayout(0, 1), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+  ASSERT_TRUE(
+      texture->upload(TextureRangeDesc::new2DArray(0, 0, 16, 16, 0, 1), pixels.data()).isOk());
+
+  EXPECT_EQ(image.getImageLayout(0, 0), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  EXPECT_EQ(image.imageLayout_, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  EXPECT_TRUE(image.subresourceLayouts_.empty());
+}
+
+/// DefragmentMemory
+/// Defragmentation keeps the bindless indices of moved textures
+TEST_F(DeviceVulkanTest, DefragmentMemory) {
+  const auto& ctx = static_cast<vulkan::Device&>(*iglDev_).getVulkanContext();
+
+  Result ret;
+  const TextureDesc desc = TextureDesc::new2D(
+      TextureFormat::RGBA_UNorm8, 64, 64, TextureDesc::TextureUsageBits::Sampled);
+  const std::vector<uint32_t> pixels(64 * 64, 0xff0000ff);
+
+  std::vector<std::shared_ptr<ITexture>> textures;
+  for (size_t i = 0; i != 16; i++) {
+    textures.push_back(iglDev_->createTexture(desc, &ret));
+    ASSERT_TRUE(ret.isOk());
+    ASSERT_TRUE(
+        textures.back()->upload(TextureRangeDesc::new2D(0, 0, 64, 64), pixels.data()).isOk());
+  }
+
+  // leave holes in the memory blocks
+  for (size_t i = 0; i < textures.size(); i += 2) {
+    textures[i] = nullptr;
+  }
+  ctx.waitIdle();
+
+  std::vector<uint64_t> textureIds;
+  for (const auto& texture : textures) {
+    textureIds.push_back(texture ? texture->getTextureId() : 0);
+  }
+
+  bool isFinished = false;
+  for (size_t i = 0; i != 100 && !isFinished; i++) {
+    isFinished = ctx.defragmentMemory(std::chrono::milliseconds(10));
+  }
+  EXPECT_TRUE(isFinished);
+
+  for (size_t i = 0; i != textures.size(); i++) {
+    if (textures[i]) {
+      const auto& tex = static_cast<const vulkan::Texture&>(*textures[i]);
+      EXPECT_EQ(tex.getTextureId(), textureIds[i]);
+      EXPECT_NE(tex.getVkImage(), VK_NULL_HANDLE);
+      EXPECT_NE(tex.getVkImageView(), VK_NULL_HANDLE);
+    }
+  }
+}
+
+/// ReadbackBufferAsync
+/// Read a device-local buffer back into a host-visible one without a synchronous wait
+TEST_F(DeviceVulkanTest, ReadbackBufferAsync) {
+  const auto& ctx = static_cast<vulkan::Device&>(*iglDev_).getVulkanContext();
+
+  const std::array<uint32_t, 4> data = {1, 2, 3, 4};
+
+  Result ret;
+  auto srcBuffer = ctx.createBuffer(sizeof(data),
+                                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                    &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto dstBuffer = ctx.createBuffer(sizeof(data),
+                                    VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                    &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  ctx.stagingDevice_->bufferSubData(*srcBuffer, 0, sizeof(data), data.data());
+
+  const auto handle =
+      ctx.stagingDevice_->getBufferSubDataAsync(*srcBuffer, 0, sizeof(data), *dstBuffer, 0);
+  ctx.stagingDevice_->waitReadback(handle, *dstBuffer);
+
+  EXPECT_TRUE(ctx.stagingDevice_->isReadbackReady(handle));
+  EXPECT_EQ(memcmp(dstBuffer->getMappedPtr(), data.data(), sizeof(data)), 0);
+}
+
+/// StagingChunks
+/// Upload a buffer larger than a staging chunk, which is streamed through several chunks, and
+/// read it back
+TEST_F(DeviceVulkanTest, StagingChunks) {
+  const auto& ctx = static_cast<vulkan::Device&>(*iglDev_).getVulkanContext();
+
+  const size_t size = ctx.config_.stagingChunkSize * 2 + 256;
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i != size; i++) {
+    data[i] = static_cast<uint8_t>(i * 7);
+  }
+
+  Result ret;
+  auto buffer = ctx.createBuffer(size,
+                                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                     VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                 &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  ctx.stagingDevice_->bufferSubData(*buffer, 0, size, data.data());
+
+  std::vector<uint8_t> readback(size);
+  ctx.stagingDevice_->getBufferSubData(*buffer, 0, size, readback.data());
+  EXPECT_EQ(readback, data);
+
+  // chunks added by the upload are released once idle, uploads keep working afterwards
+  for (int i = 0; i != 100; i++) {
+    ctx.stagingDevice_->releaseIdleChunks();
+  }
+  const std::array<uint8_t, 4> tail = {1, 2, 3, 4};
+  ctx.stagingDevice_->bufferSubData(*buffer, size - tail.size(), tail.size(), tail.data());
+  ctx.stagingDevice_->getBufferSubData(*buffer, 0, size, readback.data());
+  EXPECT_EQ(memcmp(readback.data() + size - tail.size(), tail.data(), tail.size()), 0);
+}
+
+/// ComputeQueueDependency
+/// Submit a compute command buffer and make a graphics command buffer wait for it. The compute
+/// queue is the async compute queue if the device has one, the graphics queue otherwise
+TEST_F(DeviceVulkanTest, ComputeQueueDependency) {
+  Result ret;
+  auto computeQueue = iglDev_->createCommandQueue({CommandQueueType::Compute}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto graphicsQueue = iglDev_->createCommandQueue({CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  auto computeBuffer = computeQueue->createCommandBuffer({}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto encoder = computeBuffer->createComputeCommandEncoder();
+  ASSERT_NE(encoder, nullptr);
+  encoder->endEncoding();
+  const SubmitHandle computeHandle = computeQueue->submit(*computeBuffer);
+  EXPECT_NE(computeHandle, 0u);
+
+  auto graphicsBuffer = graphicsQueue->createCommandBuffer({}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  static_cast<vulkan::CommandBuffer&>(*graphicsBuffer)
+      .waitForCommandBuffer(static_cast<const vulkan::CommandBuffer&>(*computeBuffer));
+  graphicsQueue->submit(*graphicsBuffer);
+
+  graphicsBuffer->waitUntilCompleted();
+  computeBuffer->waitUntilCompleted();
+}
+
+/// HeadlessContext
+/// A headless context has no surface and no swapchain even if a size is given, textures and
+/// offscreen rendering still work
+TEST(DeviceVulkanHeadlessTest, HeadlessContext) {
+  igl::setDebugBreakEnabled(false);
+
+  vulkan::VulkanContextConfig config;
+  config.headless = true;
+  config.enableValidation = false;
+
+  auto ctx = vulkan::HWDevice::createContext(config, nullptr);
+  ASSERT_NE(ctx, nullptr);
+
+  Result ret;
+  const std::vector<HWDeviceDesc> devices =
+      vulkan::HWDevice::queryDevices(*ctx, HWDeviceQueryDesc(HWDeviceType::Unknown), &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_FALSE(devices.empty());
+
+  auto device = vulkan::HWDevice::create(std::move(ctx), devices[0], 64, 64, 0, nullptr, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(device, nullptr);
+
+  auto& headlessCtx = static_cast<vulkan::Device&>(*device).getVulkanContext();
+  EXPECT_FALSE(headlessCtx.hasSurface());
+  EXPECT_FALSE(headlessCtx.hasSwapchain());
+  EXPECT_FALSE(headlessCtx.initSwapchain(64, 64).isOk());
+
+  const TextureDesc desc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                              64,
+                                              64,
+                                              TextureDesc::TextureUsageBits::Attachment |
+                                                  TextureDesc::TextureUsageBits::Sampled);
+  auto texture = device->createTexture(desc, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = texture;
+  auto framebuffer = device->createFramebuffer(framebufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(framebuffer, nullptr);
+}
+
+/// PipelineCacheFile
+/// A saved pipeline cache is loaded back, a file with a mismatching header or a truncated one is
+/// rejected
+TEST(DeviceVulkanHeadlessTest, PipelineCacheFile) {
+  igl::setDebugBreakEnabled(false);
+
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "igl_PipelineCacheFileTest.bin").string();
+  std::remove(path.c_str());
+
+  vulkan::VulkanContextConfig config;
+  config.headless = true;
+  config.enableValidation = false;
+  config.pipelineCacheFilePath = path;
+
+  auto ctx = vulkan::HWDevice::createContext(config, nullptr);
+  ASSERT_NE(ctx, nullptr);
+
+  Result ret;
+  const std::vector<HWDeviceDesc> devices =
+      vulkan::HWDevice::queryDevices(*ctx, HWDeviceQueryDesc(HWDeviceType::Unknown), &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_FALSE(devices.empty());
+
+  auto device = vulkan::HWDevice::create(std::move(ctx), devices[0], 64, 64, 0, nullptr, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(device, nullptr);
+
+  const auto& vulkanCtx = static_cast<vulkan::Device&>(*device).getVulkanContext();
+
+  EXPECT_TRUE(vulkanCtx.loadPipelineCacheFile().empty());
+  ASSERT_TRUE(vulkanCtx.savePipelineCache());
+  EXPECT_EQ(vulkanCtx.loadPipelineCacheFile(), vulkanCtx.getPipelineCacheData());
+
+  std::vector<uint8_t> fileData(std::filesystem::file_size(path));
+  FILE* file = fopen(path.c_str(), "rb");
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(fread(fileData.data(), 1, fileData.size(), file), fileData.size());
+  fclose(file);
+
+  auto writeFile = [&path](const std::vector<uint8_t>& bytes) {
+    FILE* f = fopen(path.c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    ASSERT_EQ(fwrite(bytes.data(), 1, bytes.size(), f), bytes.size());
+    fclose(f);
+  };
+
+  // a different magic, version, device ID or pipeline cache UUID, or corrupted data
+  for (const size_t offset : {0u, 4u, 12u, 20u, static_cast<unsigned>(fileData.size() - 1)}) {
+    std::vector<uint8_t> corrupted = fileData;
+    corrupted[offset] ^= 0xFF;
+    writeFile(corrupted);
+    EXPECT_TRUE(vulkanCtx.loadPipelineCacheFile().empty()) << "offset " << offset;
+  }
+
+  // a truncated file
+  writeFile(std::vector<uint8_t>(fileData.begin(), fileData.end() - 1));
+  EXPECT_TRUE(vulkanCtx.loadPipelineCacheFile().empty());
+
+  writeFile(fileData);
+  EXPECT_FALSE(vulkanCtx.loadPipelineCacheFile().empty());
+
+  std::remove(path.c_str());
+}
+
+/// DeviceGroupDispatch
+/// Jobs are spread over all devices of a group and retired once the GPU has finished them
+TEST(DeviceVulkanGroupTest, DeviceGroupDispatch) {
+  igl::setDebugBreakEnabled(false);
+
+  vulkan::VulkanContextConfig config;
+  config.enableValidation = false;
+
+  Result ret;
+  auto group = vulkan::DeviceGroup::create(config,
+                                           HWDeviceQueryDesc(HWDeviceType::Unknown),
+                                           vulkan::DeviceGroup::Policy::RoundRobin,
+                                           &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(group, nullptr);
+  ASSERT_GE(group->getNumDevices(), 1u);
+
+  const size_t numJobs = 2 * group->getNumDevices();
+  std::vector<size_t> numJobsPerDevice(group->getNumDevices(), 0);
+
+  for (size_t i = 0; i != numJobs; i++) {
+    const auto job =
+        group->dispatch([](IDevice& /*device*/, ICommandBuffer& commandBuffer, size_t) {
+          auto encoder = commandBuffer.createComputeCommandEncoder();
+          encoder->endEncoding();
+        });
+    ASSERT_LT(job.deviceIndex, group->getNumDevices());
+    EXPECT_NE(job.handle, 0u);
+    numJobsPerDevice[job.deviceIndex]++;
+  }
+
+  for (size_t numJobsOfDevice : numJobsPerDevice) {
+    EXPECT_EQ(numJobsOfDevice, 2u);
+  }
+
+  group->waitIdle();
+
+  for (size_t i = 0; i != group->getNumDevices(); i++) {
+    EXPECT_EQ(group->getNumPendingJobs(i), 0u);
+  }
+}
+
 } // namespace tests
 } // namespace igl
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <igl/vulkan/VulkanDestructionQueue.h>
+#include <thread>
+#include <vector>
+
+namespace igl::tests {
+
+using namespace vulkan;
+
+TEST(VulkanDestructionQueueTest, PushPop) {
+  VulkanDestructionQueue queue(3);
+
+  VulkanDestructionQueue::Entry entry;
+  EXPECT_FALSE(queue.pop(entry));
+
+  // the capacity is rounded up to 4
+  for (uint64_t i = 1; i <= 4; i++) {
+    entry.object = i;
+    EXPECT_TRUE(queue.push(entry));
+  }
+  entry.object = 5;
+  EXPECT_FALSE(queue.push(entry));
+
+  for (uint64_t i = 1; i <= 4; i++) {
+    ASSERT_TRUE(queue.pop(entry));
+    EXPECT_EQ(entry.object, i);
+  }
+  EXPECT_FALSE(queue.pop(entry));
+}
+
+TEST(VulkanDestructionQueueTest, MultipleProducers) {
+  constexpr uint64_t kNumThreads = 4;
+  constexpr uint64_t kNumEntriesPerThread = 10000;
+
+  VulkanDestructionQueue queue(64);
+
+  std::vector<std::thread> producers;
+  for (uint64_t t = 0; t != kNumThreads; t++) {
+    producers.emplace_back([&queue, t]() {
+      VulkanDestructionQueue::Entry entry;
+      entry.type = VulkanDestructionQueue::Entry::Type::Sampler;
+      for (uint64_t i = 0; i != kNumEntriesPerThread; i++) {
+        entry.object = t * kNumEntriesPerThread + i;
+        while (!queue.push(entry)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  std::vector<bool> isPopped(kNumThreads * kNumEntriesPerThread, false);
+  // entries of every producer keep their order
+  std::vector<int64_t> lastPopped(kNumThreads, -1);
+
+  for (uint64_t n = 0; n != isPopped.size();) {
+    VulkanDestructionQueue::Entry entry;
+    if (!queue.pop(entry)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_LT(entry.object, isPopped.size());
+    EXPECT_FALSE(isPopped[entry.object]);
+    isPopped[entry.object] = true;
+    const uint64_t t = entry.object / kNumEntriesPerThread;
+    EXPECT_LT(lastPopped[t], int64_t(entry.object));
+    lastPopped[t] = int64_t(entry.object);
+    n++;
+  }
+
+  for (auto& p : producers) {
+    p.join();
+  }
+
+  VulkanDestructionQueue::Entry entry;
+  EXPECT_FALSE(queue.pop(entry));
+}
+
+} // namespace igl::tests
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <igl/vulkan/VulkanSpirvCache.h>
+
+namespace igl::tests {
+
+using namespace vulkan;
+
+namespace {
+
+glslang_resource_t getResource() {
+  glslang_resource_t resource;
+  memset(&resource, 0, sizeof(resource));
+  ivkGlslangResource(&resource, nullptr);
+  return resource;
+}
+
+} // namespace
+
+TEST(VulkanSpirvCacheTest, KeyDependsOnSourceStageAndResource) {
+  const char* source = "void main() {}";
+  const glslang_resource_t resource = getResource();
+  glslang_resource_t otherResource = resource;
+  otherResource.max_draw_buffers++;
+
+  const uint64_t key = VulkanSpirvCache::getKey(VK_SHADER_STAGE_VERTEX_BIT, source, resource);
+
+  EXPECT_EQ(key, VulkanSpirvCache::getKey(VK_SHADER_STAGE_VERTEX_BIT, source, resource));
+  EXPECT_NE(key, VulkanSpirvCache::getKey(VK_SHADER_STAGE_FRAGMENT_BIT, source, resource));
+  EXPECT_NE(key, VulkanSpirvCache::getKey(VK_SHADER_STAGE_VERTEX_BIT, source, otherResource));
+  EXPECT_NE(key, VulkanSpirvCache::getKey(VK_SHADER_STAGE_VERTEX_BIT, "void main(){}", resource));
+}
+
+TEST(VulkanSpirvCacheTest, SaveAndLoad) {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "igl_VulkanSpirvCacheTest.bin").string();
+
+  const std::vector<uint32_t> spirv1 = {0x07230203, 1, 2, 3};
+  const std::vector<uint32_t> spirv2 = {0x07230203, 4};
+
+  {
+    VulkanSpirvCache cache;
+    cache.insert(1, spirv1);
+    cache.insert(2, spirv2);
+    ASSERT_TRUE(cache.save(path));
+  }
+
+  VulkanSpirvCache cache;
+  ASSERT_TRUE(cache.load(path));
+  EXPECT_EQ(cache.size(), 2u);
+
+  std::vector<uint32_t> spirv;
+  ASSERT_TRUE(cache.find(1, spirv));
+  EXPECT_EQ(spirv, spirv1);
+  ASSERT_TRUE(cache.find(2, spirv));
+  EXPECT_EQ(spirv, spirv2);
+  EXPECT_FALSE(cache.find(3, spirv));
+
+  // a truncated file is ignored
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+  VulkanSpirvCache truncatedCache;
+  EXPECT_FALSE(truncatedCache.load(path));
+  EXPECT_EQ(truncatedCache.size(), 0u);
+
+  std::remove(path.c_str());
+}
+
+} // namespace igl::tests
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <atomic>
+#include <vector>
+#include <gtest/gtest.h>
+#include <igl/vulkan/VulkanWorkerPool.h>
+
+namespace igl::tests {
+
+using namespace vulkan;
+
+TEST(VulkanWorkerPoolTest, RunsAllTasksWithBoundedThreads) {
+  std::atomic<uint32_t> numRun = 0;
+  std::vector<std::shared_future<void>> futures;
+
+  VulkanWorkerPool pool(2);
+
+  for (uint32_t i = 0; i != 64; i++) {
+    futures.push_back(pool.push([&numRun]() { numRun++; }));
+  }
+  for (auto& f : futures) {
+    f.wait();
+  }
+
+  EXPECT_EQ(numRun, 64u);
+  EXPECT_LE(pool.getNumThreads(), 2u);
+}
+
+TEST(VulkanWorkerPoolTest, DestructorRunsQueuedTasks) {
+  std::atomic<uint32_t> numRun = 0;
+
+  {
+    VulkanWorkerPool pool(1);
+    for (uint32_t i = 0; i != 16; i++) {
+      pool.push([&numRun]() { numRun++; });
+    }
+  }
+
+  EXPECT_EQ(numRun, 16u);
+}
+
+TEST(VulkanWorkerPoolTest, NoThreadsUntilUsed) {
+  VulkanWorkerPool pool(4);
+
+  EXPECT_EQ(pool.getNumThreads(), 0u);
+
+  pool.push([]() {}).wait();
+
+  EXPECT_GE(pool.getNumThreads(), 1u);
+}
+
+} // namespace igl::tests
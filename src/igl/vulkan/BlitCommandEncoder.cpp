@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/BlitCommandEncoder.h>
+
+#include <igl/vulkan/Buffer.h>
+#include <igl/vulkan/Texture.h>
+#include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanImage.h>
+#include <igl/vulkan/VulkanMipmapGenerator.h>
+#include <igl/vulkan/VulkanTexture.h>
+
+namespace igl {
+namespace vulkan {
+
+namespace {
+
+const VulkanImage& getVulkanImage(const ITexture& texture) {
+  return static_cast<const Texture&>(texture).getVulkanTexture().getVulkanImage();
+}
+
+// buffer-image copies address a single aspect of depth-stencil images
+VkImageAspectFlags getCopyAspectFlags(const VulkanImage& image) {
+  const VkImageAspectFlags flags = image.getImageAspectFlags();
+  return (flags & VK_IMAGE_ASPECT_DEPTH_BIT) ? VK_IMAGE_ASPECT_DEPTH_BIT : flags;
+}
+
+VkOffset3D getOffset(const TextureRangeDesc& range) {
+  return VkOffset3D{static_cast<int32_t>(range.x),
+                    static_cast<int32_t>(range.y),
+                    static_cast<int32_t>(range.z)};
+}
+
+VkExtent3D getExtent(const TextureRangeDesc& range) {
+  return VkExtent3D{static_cast<uint32_t>(range.width),
+                    static_cast<uint32_t>(range.height),
+                    static_cast<uint32_t>(range.depth)};
+}
+
+} // namespace
+
+BlitCommandEncoder::BlitCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer,
+                                       const VulkanContext& ctx) :
+  IBlitCommandEncoder(commandBuffer),
+  ctx_(ctx),
+  commandBuffer_(commandBuffer),
+  cmdBuffer_(commandBuffer ? commandBuffer->getVkCommandBuffer() : VK_NULL_HANDLE) {
+  IGL_PROFILER_FUNCTION();
+
+  IGL_ASSERT(commandBuffer);
+
+  isEncoding_ = true;
+}
+
+void BlitCommandEncoder::endEncoding() {
+  IGL_PROFILER_FUNCTION();
+
+  if (!isEncoding_) {
+    return;
+  }
+
+  isEncoding_ = false;
+
+  // makes the results of the transfers visible to everything which follows, including the host
+  // reading mapped buffers after the command buffer has completed. The barrier is batched with the
+  // ones of the next encoder
+  if (cmdBuffer_ != VK_NULL_HANDLE && transferStages_ != 0) {
+    commandBuffer_->getBarrierBatch().memoryBarrier(
+        VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+        VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR |
+            VK_ACCESS_2_HOST_READ_BIT_KHR,
+        transferStages_,
+        VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR | VK_PIPELINE_STAGE_2_HOST_BIT_KHR);
+  }
+}
+
+void BlitCommandEncoder::pushDebugGroupLabel(const std::string& label,
+                                             const igl::Color& color) const {
+  IGL_ASSERT(!label.empty());
+
+  ivkCmdBeginDebugUtilsLabel(cmdBuffer_, label.c_str(), color.toFloatPtr());
+}
+
+void BlitCommandEncoder::insertDebugEventLabel(const std::string& label,
+                                               const igl::Color& color) const {
+  IGL_ASSERT(!label.empty());
+
+  ivkCmdInsertDebugUtilsLabel(cmdBuffer_, label.c_str(), color.toFloatPtr());
+}
+
+void BlitCommandEncoder::popDebugGroupLabel() const {
+  ivkCmdEndDebugUtilsLabel(cmdBuffer_);
+}
+
+void BlitCommandEncoder::beginTransfer(VkPipelineStageFlags2KHR stage) {
+  // the first transfer waits for any previous write, the following ones for the previous transfers.
+  // Clears only write, see VK_ACCESS_2_TRANSFER_READ_BIT
+  commandBuffer_->getBarrierBatch().memoryBarrier(
+      transferStages_ != 0 ? VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR : VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+      stage == VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR
+          ? VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR
+          : VK_ACCESS_2_TRANSFER_READ_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+      transferStages_ != 0 ? transferStages_ : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR,
+      stage);
+  commandBuffer_->flushBarriers();
+
+  transferStages_ |= stage;
+}
+
+void BlitCommandEncoder::endTextureWrite(const ITexture& texture,
+                                         const VkImageSubresourceRange& range) const {
+  // render command encoders expect sampled images to be in SHADER_READ_ONLY_OPTIMAL. Other images
+  // are transitioned from the tracked layout when they are used next
+  const VulkanImage& image = getVulkanImage(texture);
+  if (image.isSampledImage()) {
+    image.transitionLayout(cmdBuffer_,
+                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                           VK_PIPELINE_STAGE_TRANSFER_BIT,
+                           VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                               VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                           range);
+  }
+}
+
+void BlitCommandEncoder::copyBuffer(IBuffer& source,
+                                    size_t sourceOffset,
+                                    IBuffer& destination,
+                                    size_t destinationOffset,
+                                    size_t size) {
+  IGL_PROFILER_FUNCTION();
+
+  const auto& srcBuffer = static_cast<const Buffer&>(source);
+  const auto& dstBuffer = static_cast<const Buffer&>(destination);
+  if (!IGL_VERIFY(sourceOffset + size <= srcBuffer.getSizeInBytes() &&
+                  destinationOffset + size <= dstBuffer.getSizeInBytes())) {
+    return;
+  }
+
+  beginTransfer(VK_PIPELINE_STAGE_2_COPY_BIT_KHR);
+
+  const VkBufferCopy copy = {srcBuffer.getVkBufferOffset() + sourceOffset,
+                             dstBuffer.getVkBufferOffset() + destinationOffset,
+                             size};
+  vkCmdCopyBuffer(cmdBuffer_, srcBuffer.getVkBuffer(), dstBuffer.getVkBuffer(), 1, &copy);
+}
+
+void BlitCommandEncoder::copyBufferToTexture(IBuffer& source,
+                                             size_t sourceOffset,
+                                             size_t sourceBytesPerRow,
+                                             ITexture& destination,
+                                             const TextureRangeDesc& range) {
+  IGL_PROFILER_FUNCTION();
+  IGL_ASSERT(range.numMipLevels == 1);
+
+  const auto& srcBuffer = static_cast<const Buffer&>(source);
+  const VulkanImage& image = getVulkanImage(destination);
+  const auto properties = destination.getProperties();
+
+  const VkImageSubresourceRange subresourceRange = {image.getImageAspectFlags(),
+                                                    static_cast<uint32_t>(range.mipLevel),
+                                                    1,
+                                                    static_cast<uint32_t>(range.layer),
+                                                    static_cast<uint32_t>(range.numLayers)};
+
+  beginTransfer(VK_PIPELINE_STAGE_2_COPY_BIT_KHR);
+
+  image.transitionLayout(cmdBuffer_,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         subresourceRange);
+
+  // Vulkan expects the row length in texels, 0 means tightly packed
+  const uint32_t bufferRowLength =
+      sourceBytesPerRow == 0
+          ? 0
+          : static_cast<uint32_t>(sourceBytesPerRow / properties.bytesPerBlock *
+                                  properties.blockWidth);
+  VkBufferImageCopy copy =
+      ivkGetBufferImageCopy3D(static_cast<uint32_t>(srcBuffer.getVkBufferOffset() + sourceOffset),
+                              getOffset(range),
+                              getExtent(range),
+                              VkImageSubresourceLayers{getCopyAspectFlags(image),
+                                                       static_cast<uint32_t>(range.mipLevel),
+                                                       static_cast<uint32_t>(range.layer),
+                                                       static_cast<uint32_t>(range.numLayers)});
+  copy.bufferRowLength = bufferRowLength;
+  vkCmdCopyBufferToImage(cmdBuffer_,
+                         srcBuffer.getVkBuffer(),
+                         image.getVkImage(),
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         1,
+                         &copy);
+
+  endTextureWrite(destination, subresourceRange);
+}
+
+void BlitCommandEncoder::copyTexture(ITexture& source,
+                                     const TextureRangeDesc& sourceRange,
+                                     ITexture& destination,
+                                     const TextureRangeDesc& destinationRange) {
+  IGL_PROFILER_FUNCTION();
+  IGL_ASSERT(sourceRange.numMipLevels == 1);
+  IGL_ASSERT(source.getFormat() == destination.getFormat());
+
+  const VulkanImage& srcImage = getVulkanImage(source);
+  const VulkanImage& dstImage = getVulkanImage(destination);
+
+  const VkImageSubresourceRange srcRange = {srcImage.getImageAspectFlags(),
+                                            static_cast<uint32_t>(sourceRange.mipLevel),
+                                            1,
+                                            static_cast<uint32_t>(sourceRange.layer),
+                                            static_cast<uint32_t>(sourceRange.numLayers)};
+  const VkImageSubresourceRange dstRange = {dstImage.getImageAspectFlags(),
+                                            static_cast<uint32_t>(destinationRange.mipLevel),
+                                            1,
+                                            static_cast<uint32_t>(destinationRange.layer),
+                                            static_cast<uint32_t>(sourceRange.numLayers)};
+
+  beginTransfer(VK_PIPELINE_STAGE_2_COPY_BIT_KHR);
+
+  srcImage.transitionLayout(cmdBuffer_,
+                            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                            VK_PIPELINE_STAGE_TRANSFER_BIT,
+                            srcRange);
+  dstImage.transitionLayout(cmdBuffer_,
+                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                            VK_PIPELINE_STAGE_TRANSFER_BIT,
+                            dstRange);
+
+  const VkImageCopy copy = {
+      .srcSubresource = {srcRange.aspectMask,
+                         srcRange.baseMipLevel,
+                         srcRange.baseArrayLayer,
+                         srcRange.layerCount},
+      .srcOffset = getOffset(sourceRange),
+      .dstSubresource = {dstRange.aspectMask,
+                         dstRange.baseMipLevel,
+                         dstRange.baseArrayLayer,
+                         dstRange.layerCount},
+      .dstOffset = getOffset(destinationRange),
+      .extent = getExtent(sourceRange),
+  };
+  vkCmdCopyImage(cmdBuffer_,
+                 srcImage.getVkImage(),
+                 VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                 dstImage.getVkImage(),
+                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                 1,
+                 &copy);
+
+  endTextureWrite(source, srcRange);
+  endTextureWrite(destination, dstRange);
+}
+
+void BlitCommandEncoder::fillBuffer(IBuffer& buffer, size_t offset, size_t size, uint8_t value) {
+  IGL_PROFILER_FUNCTION();
+
+  const auto& vkBuffer = static_cast<const Buffer&>(buffer);
+  if (!IGL_VERIFY(offset + size <= vkBuffer.getSizeInBytes())) {
+    return;
+  }
+  IGL_ASSERT_MSG((offset % 4) == 0 && (size % 4) == 0,
+                 "vkCmdFillBuffer() requires an offset and a size which are multiples of 4");
+
+  beginTransfer(VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR);
+
+  // vkCmdFillBuffer() writes 4 bytes at a time
+  const uint32_t data = 0x01010101u * value;
+  vkCmdFillBuffer(
+      cmdBuffer_, vkBuffer.getVkBuffer(), vkBuffer.getVkBufferOffset() + offset, size, data);
+}
+
+void BlitCommandEncoder::generateMipmaps(ITexture& texture) {
+  IGL_PROFILER_FUNCTION();
+
+  if (texture.getNumMipLevels() <= 1) {
+    return;
+  }
+
+  beginTransfer(VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT_KHR);
+
+  const VulkanImage& image = getVulkanImage(texture);
+  if (ctx_.mipmapGenerator_ && ctx_.mipmapGenerator_->isSupported(image)) {
+    ctx_.mipmapGenerator_->generate(cmdBuffer_, image, commandBuffer_->getSubmitHandle());
+  } else {
+    image.generateMipmap(cmdBuffer_);
+  }
+}
+
+} // namespace vulkan
+} // namespace igl
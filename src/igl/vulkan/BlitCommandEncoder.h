@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/BlitCommandEncoder.h>
+#include <igl/Common.h>
+#include <igl/vulkan/CommandBuffer.h>
+
+namespace igl {
+
+class IBuffer;
+class ITexture;
+
+namespace vulkan {
+
+class BlitCommandEncoder : public IBlitCommandEncoder {
+ public:
+  BlitCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer,
+                     const VulkanContext& ctx);
+  ~BlitCommandEncoder() override {
+    IGL_ASSERT(!isEncoding_); // did you forget to call endEncoding()?
+    endEncoding();
+  }
+
+  void endEncoding() override;
+
+  void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
+  void insertDebugEventLabel(const std::string& label, const igl::Color& color) const override;
+  void popDebugGroupLabel() const override;
+
+  void copyBuffer(IBuffer& source,
+                  size_t sourceOffset,
+                  IBuffer& destination,
+                  size_t destinationOffset,
+                  size_t size) override;
+  void copyBufferToTexture(IBuffer& source,
+                           size_t sourceOffset,
+                           size_t sourceBytesPerRow,
+                           ITexture& destination,
+                           const TextureRangeDesc& range) override;
+  void copyTexture(ITexture& source,
+                   const TextureRangeDesc& sourceRange,
+                   ITexture& destination,
+                   const TextureRangeDesc& destinationRange) override;
+  void fillBuffer(IBuffer& buffer, size_t offset, size_t size, uint8_t value) override;
+  void generateMipmaps(ITexture& texture) override;
+
+  VkCommandBuffer getVkCommandBuffer() const {
+    return cmdBuffer_;
+  }
+
+ private:
+  // records the pending barriers of the command buffer and makes the previous transfers of this
+  // encoder visible to the next one, which runs in `stage` (VK_KHR_synchronization2)
+  void beginTransfer(VkPipelineStageFlags2KHR stage);
+  // transitions the destination of a copy back into a layout which shaders can sample from
+  void endTextureWrite(const ITexture& texture, const VkImageSubresourceRange& range) const;
+
+ private:
+  const VulkanContext& ctx_;
+  std::shared_ptr<CommandBuffer> commandBuffer_;
+  VkCommandBuffer cmdBuffer_ = VK_NULL_HANDLE;
+  bool isEncoding_ = false;
+  // the stages of the transfers recorded so far
+  VkPipelineStageFlags2KHR transferStages_ = 0;
+};
+
+} // namespace vulkan
+} // namespace igl
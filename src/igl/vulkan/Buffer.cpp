@@ -11,6 +11,7 @@
 #include <igl/vulkan/Device.h>
 #include <igl/vulkan/SyncManager.h>
 #include <igl/vulkan/VulkanBuffer.h>
+#include <igl/vulkan/VulkanBufferPool.h>
 #include <igl/vulkan/VulkanContext.h>
 #include <igl/vulkan/VulkanDevice.h>
 #include <igl/vulkan/VulkanHelpers.h>
@@ -25,6 +26,18 @@ namespace vulkan {
 
 Buffer::Buffer(const igl::vulkan::Device& device) : device_(device) {}
 
+Buffer::~Buffer() {
+  if (!isPooled_) {
+    return;
+  }
+
+  const VulkanContext& ctx = device_.getVulkanContext();
+
+  for (size_t i = 0; i != buffers_.size(); i++) {
+    ctx.bufferPool_->free({buffers_[i], bufferOffsets_[i], desc_.length});
+  }
+}
+
 Result Buffer::create(const BufferDesc& desc) {
   desc_ = desc;
 
@@ -34,12 +47,11 @@ Result Buffer::create(const BufferDesc& desc) {
     desc_.storage = ResourceStorage::Shared;
   }
 
-  /* Use staging device to transfer data into the buffer when the storage is private to the device
+  /* Use staging device to transfer data into the buffer when the storage is private to the device.
+   * Blit command encoders can copy from and into any buffer
    */
   VkBufferUsageFlags usageFlags =
-      (desc_.storage == ResourceStorage::Private)
-          ? VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT
-          : 0;
+      VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 
   if (desc_.type == 0) {
     return Result(Result::Code::InvalidOperation, "Invalid buffer type");
@@ -66,7 +78,7 @@ Result Buffer::create(const BufferDesc& desc) {
         VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT_KHR;
   }
 
-  const VkMemoryPropertyFlags memFlags = resourceStorageToVkMemoryPropertyFlags(desc_.storage);
+  VkMemoryPropertyFlags memFlags = resourceStorageToVkMemoryPropertyFlags(desc_.storage);
 
   // Store the flag that determines if this buffer contains sub-allocations (i.e. is a ring-buffer)
   isRingBuffer_ = ((desc_.hint & BufferDesc::BufferAPIHintBits::Ring) != 0);
@@ -74,18 +86,49 @@ Result Buffer::create(const BufferDesc& desc) {
   const auto numBuffers =
       isRingBuffer_ ? device_.getVulkanContext().syncManager_->maxResourceCount() : 1u;
 
+  // small device-local buffers are written directly by the CPU through resizable BAR; uploads
+  // become memcpy() instead of a staging copy and a queue submit
+  if (desc_.storage == ResourceStorage::Private && ctx.useResizableBar(desc_.length * numBuffers)) {
+    memFlags |= VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  }
+
   if (isRingBuffer_) {
     // Resize the local copy of the data
     localData_ = std::make_unique<uint8_t[]>(desc_.length);
   }
 
   buffers_.reserve(numBuffers);
+  bufferOffsets_.reserve(numBuffers);
   bufferPatches_.resize(numBuffers, BufferRange());
+
+  if (ctx.bufferPool_) {
+    for (size_t bufferIndex = 0; bufferIndex < numBuffers; ++bufferIndex) {
+      const VulkanBufferPool::Allocation allocation =
+          ctx.bufferPool_->allocate(desc_.length, usageFlags, memFlags);
+      if (allocation.empty()) {
+        break;
+      }
+      buffers_.push_back(allocation.buffer);
+      bufferOffsets_.push_back(allocation.offset);
+    }
+    if (buffers_.size() == numBuffers) {
+      isPooled_ = true;
+      return Result();
+    }
+    // return partial sub-allocations of a ring buffer and fall back to dedicated buffers
+    for (size_t i = 0; i != buffers_.size(); i++) {
+      ctx.bufferPool_->free({buffers_[i], bufferOffsets_[i], desc_.length});
+    }
+    buffers_.clear();
+    bufferOffsets_.clear();
+  }
+
   Result result;
   for (size_t bufferIndex = 0; bufferIndex < numBuffers; ++bufferIndex) {
     std::string bufferName = desc_.debugName + " - sub-buffer " + std::to_string(bufferIndex);
     buffers_.emplace_back(
         ctx.createBuffer(desc_.length, usageFlags, memFlags, &result, bufferName.c_str()));
+    bufferOffsets_.push_back(0);
     IGL_VERIFY(result.isOk());
   }
 
@@ -97,6 +140,12 @@ const std::shared_ptr<VulkanBuffer>& Buffer::currentVulkanBuffer() const {
   return buffers_[isRingBuffer_ ? device_.getVulkanContext().syncManager_->currentIndex() : 0u];
 }
 
+VkDeviceSize Buffer::getVkBufferOffset() const {
+  IGL_ASSERT_MSG(!bufferOffsets_.empty(), "There are no sub-allocations available for this buffer");
+  return bufferOffsets_[isRingBuffer_ ? device_.getVulkanContext().syncManager_->currentIndex()
+                                      : 0u];
+}
+
 BufferRange Buffer::getUpdateRange() const {
   size_t start = std::numeric_limits<size_t>::max();
   size_t end = 0;
@@ -165,12 +214,13 @@ igl::Result Buffer::upload(const void* data, const BufferRange& range) {
     }
     // use staging to upload data to device-local buffers
     ctx.stagingDevice_->bufferSubData(*currentVulkanBuffer(),
-                                      currentUpdateRange.offset,
+                                      getVkBufferOffset() + currentUpdateRange.offset,
                                       currentUpdateRange.size,
                                       localData_.get() + currentUpdateRange.offset);
   } else {
     // use staging to upload data to device-local buffers
-    ctx.stagingDevice_->bufferSubData(*currentVulkanBuffer(), range.offset, range.size, data);
+    ctx.stagingDevice_->bufferSubData(
+        *currentVulkanBuffer(), getVkBufferOffset() + range.offset, range.size, data);
   }
   return igl::Result();
 }
@@ -183,7 +233,7 @@ uint64_t Buffer::gpuAddress(size_t offset) const {
   IGL_ASSERT_MSG((offset & 7) == 0,
                  "Buffer offset must be 8 bytes aligned as per GLSL_EXT_buffer_reference spec.");
 
-  return (uint64_t)currentVulkanBuffer()->getVkDeviceAddress() + offset;
+  return (uint64_t)currentVulkanBuffer()->getVkDeviceAddress() + getVkBufferOffset() + offset;
 }
 
 VkBuffer Buffer::getVkBuffer() const {
@@ -217,14 +267,15 @@ void* Buffer::map(const BufferRange& range, igl::Result* outResult) {
     // handle DEVICE_LOCAL buffers
     tmpBuffer_.resize(range.size);
     const VulkanContext& ctx = device_.getVulkanContext();
-    ctx.stagingDevice_->getBufferSubData(*buffer, range.offset, range.size, tmpBuffer_.data());
+    ctx.stagingDevice_->getBufferSubData(
+        *buffer, getVkBufferOffset() + range.offset, range.size, tmpBuffer_.data());
     return tmpBuffer_.data();
   }
 
   IGL_ASSERT(buffer->getMemoryPropertyFlags() & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
   // Vulkan mapped buffers are always coherent in our implementation
-  return buffer->getMappedPtr() + range.offset;
+  return buffer->getMappedPtr() + getVkBufferOffset() + range.offset;
 }
 
 void Buffer::unmap() {
@@ -21,7 +21,7 @@ class Buffer final : public igl::IBuffer {
 
  public:
   explicit Buffer(const igl::vulkan::Device& device);
-  ~Buffer() override = default;
+  ~Buffer() override;
 
   Result upload(const void* data, const BufferRange& range) override;
 
@@ -37,6 +37,9 @@ class Buffer final : public igl::IBuffer {
   uint64_t gpuAddress(size_t offset) const override;
 
   VkBuffer getVkBuffer() const;
+  /// Offset of this buffer's data inside getVkBuffer(), non-zero for sub-allocated buffers. Add it
+  /// to every offset passed to Vulkan commands together with getVkBuffer().
+  VkDeviceSize getVkBufferOffset() const;
   BufferDesc::BufferType getBufferType() const {
     return desc_.type;
   }
@@ -51,6 +54,10 @@ class Buffer final : public igl::IBuffer {
   bool isRingBuffer_ = false;
   uint32_t previousBufferIndex_ = UINT32_MAX;
   std::vector<std::shared_ptr<VulkanBuffer>> buffers_;
+  // offsets of every sub-buffer inside the corresponding VkBuffer
+  std::vector<VkDeviceSize> bufferOffsets_;
+  // the buffers were sub-allocated from VulkanContext::bufferPool_
+  bool isPooled_ = false;
   std::unique_ptr<uint8_t[]> localData_;
   std::vector<BufferRange> bufferPatches_;
 
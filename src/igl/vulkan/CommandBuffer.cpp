@@ -7,12 +7,15 @@
 
 #include <igl/vulkan/CommandBuffer.h>
 
+#include <igl/vulkan/BlitCommandEncoder.h>
 #include <igl/vulkan/Buffer.h>
 #include <igl/vulkan/ComputeCommandEncoder.h>
-#include <igl/vulkan/EnhancedShaderDebuggingStore.h>
 #include <igl/vulkan/Framebuffer.h>
+#include <igl/vulkan/ParallelRenderCommandEncoder.h>
+#include <igl/vulkan/QueryPool.h>
 #include <igl/vulkan/RenderCommandEncoder.h>
 #include <igl/vulkan/Texture.h>
+#include <igl/vulkan/Timer.h>
 #include <igl/vulkan/VulkanContext.h>
 #include <igl/vulkan/VulkanImage.h>
 #include <igl/vulkan/VulkanTexture.h>
@@ -20,8 +23,10 @@
 namespace igl {
 namespace vulkan {
 
-CommandBuffer::CommandBuffer(VulkanContext& ctx, CommandBufferDesc desc) :
-  ctx_(ctx), wrapper_(ctx_.immediate_->acquire()), desc_(std::move(desc)) {
+CommandBuffer::CommandBuffer(VulkanContext& ctx,
+                             VulkanImmediateCommands& immediate,
+                             CommandBufferDesc desc) :
+  ctx_(ctx), immediate_(immediate), wrapper_(immediate_.acquire()), desc_(std::move(desc)) {
   IGL_ASSERT(wrapper_.cmdBuf_ != VK_NULL_HANDLE);
 }
 
@@ -29,9 +34,18 @@ std::unique_ptr<IComputeCommandEncoder> CommandBuffer::createComputeCommandEncod
   return std::make_unique<ComputeCommandEncoder>(shared_from_this(), ctx_);
 }
 
+std::unique_ptr<IBlitCommandEncoder> CommandBuffer::createBlitCommandEncoder(Result* outResult) {
+  Result::setOk(outResult);
+  return std::make_unique<BlitCommandEncoder>(shared_from_this(), ctx_);
+}
+
 namespace {
 
-void transitionColorAttachment(VkCommandBuffer buffer, const std::shared_ptr<ITexture>& colorTex) {
+void transitionColorAttachment(VulkanBarrierBatch& batch,
+                               const std::shared_ptr<ITexture>& colorTex,
+                               uint32_t mipLevel,
+                               uint32_t layer,
+                               FramebufferMode mode) {
   // We really shouldn't get a null here, but just in case.
   if (!IGL_VERIFY(colorTex)) {
     return;
@@ -45,35 +59,40 @@ void transitionColorAttachment(VkCommandBuffer buffer, const std::shared_ptr<ITe
   }
   IGL_ASSERT_MSG(colorImg.imageFormat_ != VK_FORMAT_UNDEFINED, "Invalid color attachment format");
   colorImg.transitionLayout(
-      buffer,
+      batch,
       VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, // wait for all subsequent fragment/compute shaders
-      VkImageSubresourceRange{
-          VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
+      vkTex.getVkImageSubresourceRangeForFramebuffer(mipLevel, layer, mode));
 }
 
 } // namespace
 
-std::unique_ptr<IRenderCommandEncoder> CommandBuffer::createRenderCommandEncoder(
-    const RenderPassDesc& renderPass,
-    std::shared_ptr<IFramebuffer> framebuffer,
-    Result* outResult) {
-  IGL_PROFILER_FUNCTION();
-  IGL_ASSERT(framebuffer);
+void CommandBuffer::prepareFramebuffer(const RenderPassDesc& renderPass,
+                                       const std::shared_ptr<IFramebuffer>& framebuffer) {
+  const FramebufferMode mode = static_cast<const Framebuffer&>(*framebuffer).getDesc().mode;
 
-  framebuffer_ = framebuffer;
+  // all attachments render into the same mip-level and layer, see RenderCommandEncoder
+  uint32_t mipLevel = static_cast<uint32_t>(renderPass.depthAttachment.mipmapLevel);
+  uint32_t layer = static_cast<uint32_t>(renderPass.depthAttachment.layer);
 
-  // prepare all the color attachments
   const auto& indices = framebuffer->getColorAttachmentIndices();
+  for (auto i : indices) {
+    if (i < renderPass.colorAttachments.size()) {
+      mipLevel = static_cast<uint32_t>(renderPass.colorAttachments[i].mipmapLevel);
+      layer = static_cast<uint32_t>(renderPass.colorAttachments[i].layer);
+    }
+  }
+
+  // prepare all the color attachments
   for (auto i : indices) {
     const auto colorTex = framebuffer->getColorAttachment(i);
-    transitionColorAttachment(wrapper_.cmdBuf_, colorTex);
+    transitionColorAttachment(barriers_, colorTex, mipLevel, layer, mode);
     // handle MSAA
     const auto colorResolveTex = framebuffer->getResolveColorAttachment(i);
     if (colorResolveTex) {
-      transitionColorAttachment(wrapper_.cmdBuf_, colorResolveTex);
+      transitionColorAttachment(barriers_, colorResolveTex, mipLevel, layer, mode);
     }
   }
 
@@ -83,24 +102,76 @@ std::unique_ptr<IRenderCommandEncoder> CommandBuffer::createRenderCommandEncoder
     const auto& vkDepthTex = static_cast<Texture&>(*depthTex);
     const auto& depthImg = vkDepthTex.getVulkanTexture().getVulkanImage();
     IGL_ASSERT_MSG(depthImg.imageFormat_ != VK_FORMAT_UNDEFINED, "Invalid depth attachment format");
-    const VkImageAspectFlags flags =
-        vkDepthTex.getVulkanTexture().getVulkanImage().getImageAspectFlags();
+    // render passes and dynamic rendering pick the mip-level of depth attachments differently
+    VkImageSubresourceRange range =
+        vkDepthTex.getVkImageSubresourceRangeForFramebuffer(0, layer, mode);
+    range.levelCount = VK_REMAINING_MIP_LEVELS;
     depthImg.transitionLayout(
-        wrapper_.cmdBuf_,
+        barriers_,
         VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
         VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, // wait for subsequent fragment shaders
-        VkImageSubresourceRange{flags, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
+        range);
   }
 
+#if defined(VK_EXT_fragment_density_map)
+  // prepare the fragment density map, which is only read. Density maps owned by an external
+  // producer (e.g. an OpenXR runtime) are expected to be tracked in the final layout already
+  const auto& densityMap =
+      static_cast<const Framebuffer&>(*framebuffer).getDesc().fragmentDensityMap;
+  if (densityMap) {
+    const auto& vkDensityMap = static_cast<Texture&>(*densityMap);
+    vkDensityMap.getVulkanTexture().getVulkanImage().transitionLayout(
+        barriers_,
+        VK_IMAGE_LAYOUT_FRAGMENT_DENSITY_MAP_OPTIMAL_EXT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, // wait for uploads
+        VK_PIPELINE_STAGE_FRAGMENT_DENSITY_PROCESS_BIT_EXT,
+        vkDensityMap.getVkImageSubresourceRangeForFramebuffer(0, layer, mode));
+  }
+#endif // VK_EXT_fragment_density_map
+}
+
+std::unique_ptr<IRenderCommandEncoder> CommandBuffer::createRenderCommandEncoder(
+    const RenderPassDesc& renderPass,
+    std::shared_ptr<IFramebuffer> framebuffer,
+    Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+  IGL_ASSERT(framebuffer);
+
+  framebuffer_ = framebuffer;
+
+  prepareFramebuffer(renderPass, framebuffer);
+
   auto encoder =
       RenderCommandEncoder::create(shared_from_this(), ctx_, renderPass, framebuffer, outResult);
 
-  if (ctx_.enhancedShaderDebuggingStore_) {
-    encoder->binder().bindBuffer(
-        EnhancedShaderDebuggingStore::kBufferIndex,
-        static_cast<igl::vulkan::Buffer*>(ctx_.enhancedShaderDebuggingStore_->vertexBuffer().get()),
-        0);
+  if (encoder) {
+    incrementStatistic(CommandBufferCounter::RenderPasses);
+  }
+
+  if (encoder && !ctx_.config_.enhancedShaderDebuggingSampled) {
+    encoder->setShaderDebuggingEnabled(true);
+  }
+
+  return encoder;
+}
+
+std::unique_ptr<IParallelRenderCommandEncoder> CommandBuffer::createParallelRenderCommandEncoder(
+    const RenderPassDesc& renderPass,
+    std::shared_ptr<IFramebuffer> framebuffer,
+    Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+  IGL_ASSERT(framebuffer);
+
+  framebuffer_ = framebuffer;
+
+  prepareFramebuffer(renderPass, framebuffer);
+
+  auto encoder = ParallelRenderCommandEncoder::create(
+      shared_from_this(), ctx_, renderPass, framebuffer, outResult);
+
+  if (encoder) {
+    incrementStatistic(CommandBufferCounter::RenderPasses);
   }
 
   return encoder;
@@ -125,7 +196,7 @@ void CommandBuffer::present(std::shared_ptr<ITexture> surface) const {
                                                  ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
                                                  : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     img.transitionLayout(
-        wrapper_.cmdBuf_,
+        barriers_,
         VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
         srcStage,
         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, // wait for all subsequent operations
@@ -145,7 +216,7 @@ void CommandBuffer::present(std::shared_ptr<ITexture> surface) const {
                                               : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     // set the result of the previous render pass
     img.transitionLayout(
-        wrapper_.cmdBuf_,
+        barriers_,
         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
         srcStage,
         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
@@ -162,14 +233,77 @@ void CommandBuffer::popDebugGroupLabel() const {
   ivkCmdEndDebugUtilsLabel(wrapper_.cmdBuf_);
 }
 
+void CommandBuffer::beginTimer(const std::shared_ptr<ITimer>& timer) {
+  if (!IGL_VERIFY(timer)) {
+    return;
+  }
+  // timestamps should include the pending layout transitions
+  flushBarriers();
+  static_cast<Timer&>(*timer).begin(wrapper_.cmdBuf_);
+}
+
+void CommandBuffer::endTimer(const std::shared_ptr<ITimer>& timer) {
+  if (!IGL_VERIFY(timer)) {
+    return;
+  }
+  flushBarriers();
+  static_cast<Timer&>(*timer).end(wrapper_.cmdBuf_);
+}
+
+void CommandBuffer::beginPipelineStatisticsQuery(const std::shared_ptr<IQueryPool>& queryPool,
+                                                 uint32_t query) {
+  if (!IGL_VERIFY(queryPool) ||
+      !IGL_VERIFY(queryPool->getType() == QueryType::PipelineStatistics)) {
+    return;
+  }
+  static_cast<QueryPool&>(*queryPool).begin(wrapper_.cmdBuf_, wrapper_.handle_, query);
+}
+
+void CommandBuffer::endPipelineStatisticsQuery(const std::shared_ptr<IQueryPool>& queryPool,
+                                               uint32_t query) {
+  if (!IGL_VERIFY(queryPool) ||
+      !IGL_VERIFY(queryPool->getType() == QueryType::PipelineStatistics)) {
+    return;
+  }
+  static_cast<QueryPool&>(*queryPool).end(wrapper_.cmdBuf_, query);
+}
+
 void CommandBuffer::waitUntilCompleted() {
-  ctx_.immediate_->wait(lastSubmitHandle_);
+  immediate_.wait(lastSubmitHandle_);
 
   lastSubmitHandle_ = VulkanImmediateCommands::SubmitHandle();
 }
 
 void CommandBuffer::waitUntilScheduled() {}
 
+void CommandBuffer::flushBarriers() const {
+  incrementStatistic(CommandBufferCounter::Barriers,
+                     barriers_.flush(wrapper_.cmdBuf_, ctx_.getCmdPipelineBarrier2()));
+}
+
+bool CommandBuffer::isAsyncCompute() const {
+  return &immediate_ == ctx_.computeImmediate_.get();
+}
+
+void CommandBuffer::waitForCommandBuffer(const CommandBuffer& other) {
+  // submits to the same queue are ordered by the pipeline barriers recorded in command buffers;
+  // an empty handle means the other command buffer has been waited for already
+  if (&other.immediate_ == &immediate_ || other.lastSubmitHandle_.empty()) {
+    return;
+  }
+
+  IGL_ASSERT(other.immediate_.hasTimelineSemaphore());
+  // the other queue may defer its submits, the value this queue waits for has to be signaled by an
+  // issued submit
+  other.immediate_.flush();
+  IGL_ASSERT(waitSemaphore_ == VK_NULL_HANDLE ||
+             waitSemaphore_ == other.immediate_.getTimelineSemaphore());
+
+  waitSemaphore_ = other.immediate_.getTimelineSemaphore();
+  // 0 if the other command buffer is already completed
+  waitValue_ = std::max(waitValue_, other.immediate_.getSignalValue(other.lastSubmitHandle_));
+}
+
 std::shared_ptr<igl::IFramebuffer> CommandBuffer::getFramebuffer() const {
   return framebuffer_;
 }
@@ -9,6 +9,7 @@
 
 #include <igl/CommandBuffer.h>
 #include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanBarrierBatch.h>
 #include <igl/vulkan/VulkanImmediateCommands.h>
 
 namespace igl {
@@ -20,21 +21,38 @@ class VulkanContext;
 class CommandBuffer final : public ICommandBuffer,
                             public std::enable_shared_from_this<CommandBuffer> {
  public:
-  CommandBuffer(VulkanContext& ctx, CommandBufferDesc desc);
+  CommandBuffer(VulkanContext& ctx, VulkanImmediateCommands& immediate, CommandBufferDesc desc);
 
   std::unique_ptr<IComputeCommandEncoder> createComputeCommandEncoder() override;
 
+  std::unique_ptr<IBlitCommandEncoder> createBlitCommandEncoder(Result* outResult) override;
+
   virtual std::unique_ptr<IRenderCommandEncoder> createRenderCommandEncoder(
       const RenderPassDesc& renderPass,
       std::shared_ptr<IFramebuffer> framebuffer,
       Result* outResult) override;
 
+  std::unique_ptr<IParallelRenderCommandEncoder> createParallelRenderCommandEncoder(
+      const RenderPassDesc& renderPass,
+      std::shared_ptr<IFramebuffer> framebuffer,
+      Result* outResult) override;
+
   void present(std::shared_ptr<ITexture> surface) const override;
 
   void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
 
   void popDebugGroupLabel() const override;
 
+  void beginTimer(const std::shared_ptr<ITimer>& timer) override;
+
+  void endTimer(const std::shared_ptr<ITimer>& timer) override;
+
+  void beginPipelineStatisticsQuery(const std::shared_ptr<IQueryPool>& queryPool,
+                                    uint32_t query) override;
+
+  void endPipelineStatisticsQuery(const std::shared_ptr<IQueryPool>& queryPool,
+                                  uint32_t query) override;
+
   void waitUntilCompleted() override;
 
   void waitUntilScheduled() override;
@@ -43,18 +61,46 @@ class CommandBuffer final : public ICommandBuffer,
     return wrapper_.cmdBuf_;
   }
 
+  // the handle this command buffer is going to be submitted with
+  VulkanImmediateCommands::SubmitHandle getSubmitHandle() const {
+    return wrapper_.handle_;
+  }
+
+  // barriers recorded by this command buffer are batched until the next render pass, dispatch or
+  // submit
+  VulkanBarrierBatch& getBarrierBatch() const {
+    return barriers_;
+  }
+
+  // record all pending barriers into the underlying VkCommandBuffer
+  void flushBarriers() const;
+
   bool isFromSwapchain() const {
     return isFromSwapchain_;
   }
 
+  // true if this command buffer is submitted to the async compute queue
+  bool isAsyncCompute() const;
+
+  // the submit of this command buffer waits until `other`, which has to be submitted already, is
+  // completed. Required for any data dependency between command buffers of different queues
+  void waitForCommandBuffer(const CommandBuffer& other);
+
   std::shared_ptr<igl::IFramebuffer> getFramebuffer() const;
 
   std::shared_ptr<ITexture> getPresentedSurface() const;
 
+ private:
+  // transition the subresources of the framebuffer's attachments rendered into by `renderPass`
+  // into the attachment-optimal layouts
+  void prepareFramebuffer(const RenderPassDesc& renderPass,
+                          const std::shared_ptr<IFramebuffer>& framebuffer);
+
  private:
   friend class CommandQueue;
 
   VulkanContext& ctx_;
+  VulkanImmediateCommands& immediate_;
   const VulkanImmediateCommands::CommandBufferWrapper& wrapper_;
   CommandBufferDesc desc_;
   // was present() called with a swapchain image?
@@ -62,8 +108,13 @@ class CommandBuffer final : public ICommandBuffer,
 
   std::shared_ptr<igl::IFramebuffer> framebuffer_;
   mutable std::shared_ptr<ITexture> presentedSurface_;
+  mutable VulkanBarrierBatch barriers_;
 
   VulkanImmediateCommands::SubmitHandle lastSubmitHandle_ = {};
+
+  // timeline semaphore of another queue to wait on before executing this command buffer
+  VkSemaphore waitSemaphore_ = VK_NULL_HANDLE;
+  uint64_t waitValue_ = 0;
 };
 
 } // namespace vulkan
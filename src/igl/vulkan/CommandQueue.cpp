@@ -11,10 +11,14 @@
 #include <igl/vulkan/EnhancedShaderDebuggingStore.h>
 #include <igl/vulkan/RenderCommandEncoder.h>
 #include <igl/vulkan/SyncManager.h>
+#include <igl/vulkan/Texture.h>
 #include <igl/vulkan/VulkanContext.h>
 #include <igl/vulkan/VulkanDevice.h>
 #include <igl/vulkan/VulkanHelpers.h>
+#include <igl/vulkan/VulkanImage.h>
+#include <igl/vulkan/VulkanStagingDevice.h>
 #include <igl/vulkan/VulkanSwapchain.h>
+#include <igl/vulkan/VulkanTexture.h>
 
 namespace igl {
 namespace vulkan {
@@ -33,33 +37,90 @@ std::shared_ptr<ICommandBuffer> CommandQueue::createCommandBuffer(const CommandB
 
   isInsideFrame_ = true;
 
-  return std::make_shared<CommandBuffer>(device_.getVulkanContext(), desc);
+  VulkanContext& ctx = device_.getVulkanContext();
+
+  // compute queues fall back to the graphics queue if there is no async compute queue
+  const bool useAsyncCompute = desc_.type == CommandQueueType::Compute && ctx.computeImmediate_;
+
+  return std::make_shared<CommandBuffer>(
+      ctx, useAsyncCompute ? *ctx.computeImmediate_ : *ctx.immediate_, desc);
 }
 
-SubmitHandle CommandQueue::submit(const ICommandBuffer& cmdBuffer, bool /* endOfFrame */) {
+SubmitHandle CommandQueue::submit(const ICommandBuffer& cmdBuffer, bool endOfFrame) {
   IGL_PROFILER_FUNCTION();
   VulkanContext& ctx = device_.getVulkanContext();
 
+#if IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
   if (ctx.enhancedShaderDebuggingStore_) {
     ctx.enhancedShaderDebuggingStore_->installBufferBarrier(cmdBuffer);
   }
+#endif // IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
 
   incrementDrawCount(cmdBuffer.getCurrentDrawCount());
+  IGL_PROFILER_PLOT("IGL draws per submit", cmdBuffer.getCurrentDrawCount());
 
   IGL_ASSERT(isInsideFrame_);
 
   auto* vkCmdBuffer =
       const_cast<vulkan::CommandBuffer*>(static_cast<const vulkan::CommandBuffer*>(&cmdBuffer));
+
+  // the staging uploads are recorded and submitted separately, attribute them to this submission
+  const VulkanStagingDevice::Statistics stagingStats = ctx.stagingDevice_->takeStatistics();
+  ctx.stagingDevice_->releaseIdleChunks();
+  cmdBuffer.incrementStatistic(CommandBufferCounter::UploadedBytes, stagingStats.uploadedBytes);
+  cmdBuffer.incrementStatistic(CommandBufferCounter::StagingWaits, stagingStats.waits);
+#if defined(IGL_WITH_TRACY_GPU)
+  if (ctx.tracyCtx_ && desc_.type == CommandQueueType::Graphics) {
+    // reads back the finished GPU zones and resets their queries
+    TracyVkCollect(ctx.tracyCtx_, vkCmdBuffer->getVkCommandBuffer());
+  }
+#endif // IGL_WITH_TRACY_GPU
+#if IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
   const bool presentIfNotDebugging = ctx.enhancedShaderDebuggingStore_ == nullptr;
+#else
+  const bool presentIfNotDebugging = true;
+#endif // IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
   auto submitHandle = endCommandBuffer(ctx, vkCmdBuffer, presentIfNotDebugging);
 
+#if IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
   if (ctx.enhancedShaderDebuggingStore_) {
     enhancedShaderDebuggingPass(ctx, vkCmdBuffer);
   }
+#endif // IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
+
+  if (endOfFrame) {
+    // issues the submits deferred with VulkanContextConfig::enableDeferredSubmits
+    vkCmdBuffer->immediate_.flush();
+  }
 
   return submitHandle;
 }
 
+Result CommandQueue::updateTextureTiles(ITexture& texture,
+                                        const TextureRangeDesc& range,
+                                        TextureTileMapping mapping) {
+  IGL_PROFILER_FUNCTION();
+
+  const auto [result, _] = texture.validateRange(range);
+  if (!result.isOk()) {
+    return result;
+  }
+
+  const VulkanImage& image = static_cast<Texture&>(texture).getVulkanTexture().getVulkanImage();
+  if (!IGL_VERIFY(image.isSparse())) {
+    return Result(Result::Code::ArgumentInvalid, "The texture is not sparse");
+  }
+
+  return image.updateSparseTiles(
+      (uint32_t)range.mipLevel,
+      (uint32_t)range.numMipLevels,
+      (uint32_t)range.layer,
+      (uint32_t)range.numLayers,
+      VkOffset3D{(int32_t)range.x, (int32_t)range.y, 0},
+      VkExtent3D{(uint32_t)range.width, (uint32_t)range.height, 1},
+      mapping == TextureTileMapping::Commit);
+}
+
 SubmitHandle CommandQueue::endCommandBuffer(const igl::vulkan::VulkanContext& ctx,
                                             igl::vulkan::CommandBuffer* cmdBuffer,
                                             bool present) {
@@ -74,20 +135,40 @@ SubmitHandle CommandQueue::endCommandBuffer(const igl::vulkan::VulkanContext& ct
     ctx.immediate_->waitSemaphore(ctx.swapchain_->acquireSemaphore_->vkSemaphore_);
   }
 
-  cmdBuffer->lastSubmitHandle_ = ctx.immediate_->submit(cmdBuffer->wrapper_);
+  cmdBuffer->flushBarriers();
+  ctx.flushMappedMemoryRanges();
+
+  VulkanImmediateCommands& immediate = cmdBuffer->immediate_;
+
+  if (cmdBuffer->waitSemaphore_) {
+    immediate.waitTimelineSemaphore(cmdBuffer->waitSemaphore_, cmdBuffer->waitValue_);
+    cmdBuffer->waitSemaphore_ = VK_NULL_HANDLE;
+    cmdBuffer->waitValue_ = 0;
+  }
+
+  cmdBuffer->lastSubmitHandle_ = immediate.submit(cmdBuffer->wrapper_);
+
+  // Everything else in the context (dynamic uniforms, deferred destruction, etc.) is tracked with
+  // graphics submit handles. Make sure one of them completes after the async compute work
+  const VulkanImmediateCommands::SubmitHandle graphicsHandle =
+      cmdBuffer->isAsyncCompute() ? ctx.retireAsyncComputeSubmit(cmdBuffer->lastSubmitHandle_)
+                                  : cmdBuffer->lastSubmitHandle_;
 
   if (shouldPresent) {
     ctx.present();
   }
-  ctx.DUBs_->markSubmit(cmdBuffer->lastSubmitHandle_);
-  ctx.syncManager_->markSubmit(cmdBuffer->lastSubmitHandle_);
+  device_.checkMemoryPressure();
+  ctx.DUBs_->markSubmit(graphicsHandle);
+  ctx.syncManager_->markSubmit(graphicsHandle);
   ctx.processDeferredTasks();
+  ctx.savePipelineCachePeriodically();
 
   isInsideFrame_ = false;
 
-  return cmdBuffer->lastSubmitHandle_.handle();
+  return graphicsHandle.handle();
 }
 
+#if IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
 void CommandQueue::enhancedShaderDebuggingPass(const igl::vulkan::VulkanContext& ctx,
                                                const igl::vulkan::CommandBuffer* cmdBuffer) {
   IGL_PROFILER_FUNCTION();
@@ -162,21 +243,23 @@ void CommandQueue::enhancedShaderDebuggingPass(const igl::vulkan::VulkanContext&
                          lineBuffer->getVkBuffer(),
                          0, /* src access flag */
                          0, /* dst access flag */
-                         0,
-                         VK_WHOLE_SIZE,
+                         lineBuffer->getVkBufferOffset(),
+                         lineBuffer->getSizeInBytes(),
                          VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
                          VK_PIPELINE_STAGE_TRANSFER_BIT);
 
   // Reset instanceCount of the buffer
   vkCmdFillBuffer(vkResetCmdBuffer,
                   lineBuffer->getVkBuffer(),
-                  offsetof(EnhancedShaderDebuggingStore::Header, command_) +
+                  lineBuffer->getVkBufferOffset() +
+                      offsetof(EnhancedShaderDebuggingStore::Header, command_) +
                       offsetof(VkDrawIndirectCommand, instanceCount),
                   sizeof(uint32_t), // reset only the instance count
                   0);
 
   endCommandBuffer(ctx, resetCmdBuffer, true);
 }
+#endif // IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
 
 } // namespace vulkan
 } // namespace igl
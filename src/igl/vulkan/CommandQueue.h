@@ -25,6 +25,10 @@ class CommandQueue final : public ICommandQueue {
   std::shared_ptr<ICommandBuffer> createCommandBuffer(const CommandBufferDesc& desc,
                                                       Result* outResult) override;
   SubmitHandle submit(const ICommandBuffer& commandBuffer, bool endOfFrame = false) override;
+  // sparse binding operations are ordered with the submits to the graphics queue
+  Result updateTextureTiles(ITexture& texture,
+                            const TextureRangeDesc& range,
+                            TextureTileMapping mapping) override;
 
   const CommandQueueDesc& getCommandQueueDesc() const {
     return desc_;
@@ -35,8 +39,10 @@ class CommandQueue final : public ICommandQueue {
                                 igl::vulkan::CommandBuffer* cmdBuffer,
                                 bool present);
 
+#if IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
   void enhancedShaderDebuggingPass(const igl::vulkan::VulkanContext& ctx,
                                    const igl::vulkan::CommandBuffer* cmdBuffer);
+#endif // IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
 
  private:
   igl::vulkan::Device& device_;
@@ -11,6 +11,7 @@
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
+#include <iterator>
 
 #if defined(VK_USE_PLATFORM_WIN32_KHR)
 #include <windows.h>
@@ -58,177 +59,117 @@ void setResultFrom(Result* outResult, VkResult result) {
   *outResult = getResultFromVkResult(result);
 }
 
-VkFormat textureFormatToVkFormat(igl::TextureFormat format) {
-  using TextureFormat = ::igl::TextureFormat;
-  switch (format) {
-  case TextureFormat::Invalid:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::A_UNorm8:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::L_UNorm8:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::R_UNorm8:
-    return VK_FORMAT_R8_UNORM;
-  case TextureFormat::R_UNorm16:
-    return VK_FORMAT_R16_UNORM;
-  case TextureFormat::R_F16:
-    return VK_FORMAT_R16_SFLOAT;
-  case TextureFormat::R_UInt16:
-    return VK_FORMAT_R16_UINT;
-  case TextureFormat::B5G5R5A1_UNorm:
-    return VK_FORMAT_B5G5R5A1_UNORM_PACK16;
-  case TextureFormat::B5G6R5_UNorm:
-    return VK_FORMAT_B5G6R5_UNORM_PACK16;
-  case TextureFormat::ABGR_UNorm4:
-    return VK_FORMAT_B4G4R4A4_UNORM_PACK16;
-  case TextureFormat::LA_UNorm8:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RG_UNorm8:
-    return VK_FORMAT_R8G8_UNORM;
-  case TextureFormat::RG_UNorm16:
-    return VK_FORMAT_R16G16_UNORM;
-  case TextureFormat::R4G2B2_UNorm_Apple:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::R4G2B2_UNorm_Rev_Apple:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::R5G5B5A1_UNorm:
-    return VK_FORMAT_R5G5B5A1_UNORM_PACK16;
-  case TextureFormat::RGBX_UNorm8:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::BGRA_UNorm8:
-    return VK_FORMAT_B8G8R8A8_UNORM;
-  case TextureFormat::BGRA_UNorm8_Rev:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGBA_UNorm8:
-    return VK_FORMAT_R8G8B8A8_UNORM;
-  case TextureFormat::RGBA_SRGB:
-    return VK_FORMAT_R8G8B8A8_SRGB;
-  case TextureFormat::BGRA_SRGB:
-    return VK_FORMAT_B8G8R8A8_SRGB;
-  case TextureFormat::RG_F16:
-    return VK_FORMAT_R16G16_SFLOAT;
-  case TextureFormat::RG_UInt16:
-    return VK_FORMAT_R16G16_UINT;
-  case TextureFormat::RGB10_A2_UNorm_Rev:
-    return VK_FORMAT_A2R10G10B10_UNORM_PACK32;
-  case TextureFormat::RGB10_A2_Uint_Rev:
-    return VK_FORMAT_A2R10G10B10_UINT_PACK32;
-  case TextureFormat::BGR10_A2_Unorm:
-    return VK_FORMAT_A2B10G10R10_UNORM_PACK32;
-  case TextureFormat::R_F32:
-    return VK_FORMAT_R32_SFLOAT;
-  case TextureFormat::RGB_F16:
-    return VK_FORMAT_R16G16B16_SFLOAT;
-  case TextureFormat::RGBA_F16:
-    return VK_FORMAT_R16G16B16A16_SFLOAT;
-  case TextureFormat::RGB_F32:
-    return VK_FORMAT_R32G32B32_SFLOAT;
-  case TextureFormat::RGBA_UInt32:
-    return VK_FORMAT_R32G32B32A32_UINT;
-  case TextureFormat::RGBA_F32:
-    return VK_FORMAT_R32G32B32A32_SFLOAT;
-  case TextureFormat::RGBA_ASTC_4x4:
-    return VK_FORMAT_ASTC_4x4_SRGB_BLOCK;
-  case TextureFormat::SRGB8_A8_ASTC_4x4:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGBA_ASTC_5x4:
-    return VK_FORMAT_ASTC_5x4_SRGB_BLOCK;
-  case TextureFormat::SRGB8_A8_ASTC_5x4:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGBA_ASTC_5x5:
-    return VK_FORMAT_ASTC_5x5_SRGB_BLOCK;
-  case TextureFormat::SRGB8_A8_ASTC_5x5:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGBA_ASTC_6x5:
-    return VK_FORMAT_ASTC_6x5_SRGB_BLOCK;
-  case TextureFormat::SRGB8_A8_ASTC_6x5:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGBA_ASTC_6x6:
-    return VK_FORMAT_ASTC_6x6_SRGB_BLOCK;
-  case TextureFormat::SRGB8_A8_ASTC_6x6:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGBA_ASTC_8x5:
-    return VK_FORMAT_ASTC_8x5_SRGB_BLOCK;
-  case TextureFormat::SRGB8_A8_ASTC_8x5:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGBA_ASTC_8x6:
-    return VK_FORMAT_ASTC_8x6_SRGB_BLOCK;
-  case TextureFormat::SRGB8_A8_ASTC_8x6:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGBA_ASTC_8x8:
-    return VK_FORMAT_ASTC_8x8_SRGB_BLOCK;
-  case TextureFormat::SRGB8_A8_ASTC_8x8:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGBA_ASTC_10x5:
-    return VK_FORMAT_ASTC_10x5_SRGB_BLOCK;
-  case TextureFormat::SRGB8_A8_ASTC_10x5:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGBA_ASTC_10x6:
-    return VK_FORMAT_ASTC_10x6_SRGB_BLOCK;
-  case TextureFormat::SRGB8_A8_ASTC_10x6:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGBA_ASTC_10x8:
-    return VK_FORMAT_ASTC_10x8_SRGB_BLOCK;
-  case TextureFormat::SRGB8_A8_ASTC_10x8:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGBA_ASTC_10x10:
-    return VK_FORMAT_ASTC_10x10_SRGB_BLOCK;
-  case TextureFormat::SRGB8_A8_ASTC_10x10:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGBA_ASTC_12x10:
-    return VK_FORMAT_ASTC_12x10_SRGB_BLOCK;
-  case TextureFormat::SRGB8_A8_ASTC_12x10:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGBA_ASTC_12x12:
-    return VK_FORMAT_ASTC_12x12_SRGB_BLOCK;
-  case TextureFormat::SRGB8_A8_ASTC_12x12:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGBA_PVRTC_2BPPV1:
-    return VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG;
-  case TextureFormat::RGB_PVRTC_2BPPV1:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGBA_PVRTC_4BPPV1:
-    return VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG;
-  case TextureFormat::RGB_PVRTC_4BPPV1:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGB8_ETC1:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RGB8_ETC2:
-    return VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
-  case TextureFormat::SRGB8_ETC2:
-    return VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK;
-  case TextureFormat::RGB8_Punchthrough_A1_ETC2:
-    return VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK;
-  case TextureFormat::SRGB8_Punchthrough_A1_ETC2:
-    return VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK;
-  case TextureFormat::RGBA8_EAC_ETC2:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::SRGB8_A8_EAC_ETC2:
-    return VK_FORMAT_UNDEFINED;
-  case TextureFormat::RG_EAC_UNorm:
-    return VK_FORMAT_EAC_R11G11_UNORM_BLOCK;
-  case TextureFormat::RG_EAC_SNorm:
-    return VK_FORMAT_EAC_R11G11_SNORM_BLOCK;
-  case TextureFormat::R_EAC_UNorm:
-    return VK_FORMAT_EAC_R11_UNORM_BLOCK;
-  case TextureFormat::R_EAC_SNorm:
-    return VK_FORMAT_EAC_R11_SNORM_BLOCK;
-  case TextureFormat::RGBA_BC7_UNORM_4x4:
-    return VK_FORMAT_BC7_UNORM_BLOCK;
-  case TextureFormat::Z_UNorm16:
-    return VK_FORMAT_D16_UNORM;
-  case TextureFormat::Z_UNorm24:
-    return VK_FORMAT_D24_UNORM_S8_UINT;
-  case TextureFormat::Z_UNorm32:
-    return VK_FORMAT_D32_SFLOAT;
-  case TextureFormat::S8_UInt_Z24_UNorm:
-    return VK_FORMAT_D24_UNORM_S8_UINT;
-  case TextureFormat::S8_UInt_Z32_UNorm:
-    return VK_FORMAT_D32_SFLOAT_S8_UINT;
-  case TextureFormat::S_UInt8:
-    return VK_FORMAT_S8_UINT;
+namespace {
+
+struct VkFormatMapping {
+  igl::TextureFormat format;
+  VkFormat vkFormat;
+};
+
+// indexed by TextureFormat
+constexpr VkFormatMapping kTextureFormatToVkFormat[] = {
+    {TextureFormat::Invalid, VK_FORMAT_UNDEFINED},
+    {TextureFormat::A_UNorm8, VK_FORMAT_UNDEFINED},
+    {TextureFormat::L_UNorm8, VK_FORMAT_UNDEFINED},
+    {TextureFormat::R_UNorm8, VK_FORMAT_R8_UNORM},
+    {TextureFormat::R_F16, VK_FORMAT_R16_SFLOAT},
+    {TextureFormat::R_UInt16, VK_FORMAT_R16_UINT},
+    {TextureFormat::R_UNorm16, VK_FORMAT_R16_UNORM},
+    {TextureFormat::B5G5R5A1_UNorm, VK_FORMAT_B5G5R5A1_UNORM_PACK16},
+    {TextureFormat::B5G6R5_UNorm, VK_FORMAT_B5G6R5_UNORM_PACK16},
+    {TextureFormat::ABGR_UNorm4, VK_FORMAT_B4G4R4A4_UNORM_PACK16},
+    {TextureFormat::LA_UNorm8, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RG_UNorm8, VK_FORMAT_R8G8_UNORM},
+    {TextureFormat::R4G2B2_UNorm_Apple, VK_FORMAT_UNDEFINED},
+    {TextureFormat::R4G2B2_UNorm_Rev_Apple, VK_FORMAT_UNDEFINED},
+    {TextureFormat::R5G5B5A1_UNorm, VK_FORMAT_R5G5B5A1_UNORM_PACK16},
+    {TextureFormat::RGBX_UNorm8, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGBA_UNorm8, VK_FORMAT_R8G8B8A8_UNORM},
+    {TextureFormat::BGRA_UNorm8, VK_FORMAT_B8G8R8A8_UNORM},
+    {TextureFormat::BGRA_UNorm8_Rev, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGBA_SRGB, VK_FORMAT_R8G8B8A8_SRGB},
+    {TextureFormat::BGRA_SRGB, VK_FORMAT_B8G8R8A8_SRGB},
+    {TextureFormat::RG_F16, VK_FORMAT_R16G16_SFLOAT},
+    {TextureFormat::RG_UInt16, VK_FORMAT_R16G16_UINT},
+    {TextureFormat::RG_UNorm16, VK_FORMAT_R16G16_UNORM},
+    {TextureFormat::RGB10_A2_UNorm_Rev, VK_FORMAT_A2R10G10B10_UNORM_PACK32},
+    {TextureFormat::RGB10_A2_Uint_Rev, VK_FORMAT_A2R10G10B10_UINT_PACK32},
+    {TextureFormat::BGR10_A2_Unorm, VK_FORMAT_A2B10G10R10_UNORM_PACK32},
+    {TextureFormat::R_F32, VK_FORMAT_R32_SFLOAT},
+    {TextureFormat::RGB_F16, VK_FORMAT_R16G16B16_SFLOAT},
+    {TextureFormat::RGBA_F16, VK_FORMAT_R16G16B16A16_SFLOAT},
+    {TextureFormat::RGB_F32, VK_FORMAT_R32G32B32_SFLOAT},
+    {TextureFormat::RGBA_UInt32, VK_FORMAT_R32G32B32A32_UINT},
+    {TextureFormat::RGBA_F32, VK_FORMAT_R32G32B32A32_SFLOAT},
+    {TextureFormat::RGBA_ASTC_4x4, VK_FORMAT_ASTC_4x4_SRGB_BLOCK},
+    {TextureFormat::SRGB8_A8_ASTC_4x4, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGBA_ASTC_5x4, VK_FORMAT_ASTC_5x4_SRGB_BLOCK},
+    {TextureFormat::SRGB8_A8_ASTC_5x4, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGBA_ASTC_5x5, VK_FORMAT_ASTC_5x5_SRGB_BLOCK},
+    {TextureFormat::SRGB8_A8_ASTC_5x5, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGBA_ASTC_6x5, VK_FORMAT_ASTC_6x5_SRGB_BLOCK},
+    {TextureFormat::SRGB8_A8_ASTC_6x5, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGBA_ASTC_6x6, VK_FORMAT_ASTC_6x6_SRGB_BLOCK},
+    {TextureFormat::SRGB8_A8_ASTC_6x6, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGBA_ASTC_8x5, VK_FORMAT_ASTC_8x5_SRGB_BLOCK},
+    {TextureFormat::SRGB8_A8_ASTC_8x5, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGBA_ASTC_8x6, VK_FORMAT_ASTC_8x6_SRGB_BLOCK},
+    {TextureFormat::SRGB8_A8_ASTC_8x6, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGBA_ASTC_8x8, VK_FORMAT_ASTC_8x8_SRGB_BLOCK},
+    {TextureFormat::SRGB8_A8_ASTC_8x8, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGBA_ASTC_10x5, VK_FORMAT_ASTC_10x5_SRGB_BLOCK},
+    {TextureFormat::SRGB8_A8_ASTC_10x5, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGBA_ASTC_10x6, VK_FORMAT_ASTC_10x6_SRGB_BLOCK},
+    {TextureFormat::SRGB8_A8_ASTC_10x6, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGBA_ASTC_10x8, VK_FORMAT_ASTC_10x8_SRGB_BLOCK},
+    {TextureFormat::SRGB8_A8_ASTC_10x8, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGBA_ASTC_10x10, VK_FORMAT_ASTC_10x10_SRGB_BLOCK},
+    {TextureFormat::SRGB8_A8_ASTC_10x10, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGBA_ASTC_12x10, VK_FORMAT_ASTC_12x10_SRGB_BLOCK},
+    {TextureFormat::SRGB8_A8_ASTC_12x10, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGBA_ASTC_12x12, VK_FORMAT_ASTC_12x12_SRGB_BLOCK},
+    {TextureFormat::SRGB8_A8_ASTC_12x12, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGBA_PVRTC_2BPPV1, VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG},
+    {TextureFormat::RGB_PVRTC_2BPPV1, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGBA_PVRTC_4BPPV1, VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG},
+    {TextureFormat::RGB_PVRTC_4BPPV1, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGB8_ETC1, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RGB8_ETC2, VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK},
+    {TextureFormat::SRGB8_ETC2, VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK},
+    {TextureFormat::RGB8_Punchthrough_A1_ETC2, VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK},
+    {TextureFormat::SRGB8_Punchthrough_A1_ETC2, VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK},
+    {TextureFormat::RGBA8_EAC_ETC2, VK_FORMAT_UNDEFINED},
+    {TextureFormat::SRGB8_A8_EAC_ETC2, VK_FORMAT_UNDEFINED},
+    {TextureFormat::RG_EAC_UNorm, VK_FORMAT_EAC_R11G11_UNORM_BLOCK},
+    {TextureFormat::RG_EAC_SNorm, VK_FORMAT_EAC_R11G11_SNORM_BLOCK},
+    {TextureFormat::R_EAC_UNorm, VK_FORMAT_EAC_R11_UNORM_BLOCK},
+    {TextureFormat::R_EAC_SNorm, VK_FORMAT_EAC_R11_SNORM_BLOCK},
+    {TextureFormat::RGBA_BC7_UNORM_4x4, VK_FORMAT_BC7_UNORM_BLOCK},
+    {TextureFormat::Z_UNorm16, VK_FORMAT_D16_UNORM},
+    {TextureFormat::Z_UNorm24, VK_FORMAT_D24_UNORM_S8_UINT},
+    {TextureFormat::Z_UNorm32, VK_FORMAT_D32_SFLOAT},
+    {TextureFormat::S8_UInt_Z24_UNorm, VK_FORMAT_D24_UNORM_S8_UINT},
+    {TextureFormat::S8_UInt_Z32_UNorm, VK_FORMAT_D32_SFLOAT_S8_UINT},
+    {TextureFormat::S_UInt8, VK_FORMAT_S8_UINT},
+};
+
+constexpr bool isTextureFormatToVkFormatValid() {
+  for (size_t i = 0; i != std::size(kTextureFormatToVkFormat); ++i) {
+    if (kTextureFormatToVkFormat[i].format != static_cast<TextureFormat>(i)) {
+      return false;
+    }
   }
-  IGL_UNREACHABLE_RETURN(VK_FORMAT_UNDEFINED);
+  return std::size(kTextureFormatToVkFormat) == static_cast<size_t>(TextureFormat::S_UInt8) + 1;
+}
+static_assert(isTextureFormatToVkFormatValid(),
+              "kTextureFormatToVkFormat must have one entry per TextureFormat, in order");
+
+} // namespace
+
+VkFormat textureFormatToVkFormat(igl::TextureFormat format) {
+  const auto index = static_cast<size_t>(format);
+  return index < std::size(kTextureFormatToVkFormat) ? kTextureFormatToVkFormat[index].vkFormat
+                                                     : VK_FORMAT_UNDEFINED;
 }
 
 igl::ColorSpace vkColorSpaceToColorSpace(VkColorSpaceKHR colorSpace) {
@@ -442,6 +383,46 @@ VkCompareOp compareFunctionToVkCompareOp(igl::CompareFunction func) {
   return VK_COMPARE_OP_ALWAYS;
 }
 
+VkStencilOp stencilOperationToVkStencilOp(igl::StencilOperation op) {
+  switch (op) {
+  case igl::StencilOperation::Keep:
+    return VK_STENCIL_OP_KEEP;
+  case igl::StencilOperation::Zero:
+    return VK_STENCIL_OP_ZERO;
+  case igl::StencilOperation::Replace:
+    return VK_STENCIL_OP_REPLACE;
+  case igl::StencilOperation::IncrementClamp:
+    return VK_STENCIL_OP_INCREMENT_AND_CLAMP;
+  case igl::StencilOperation::DecrementClamp:
+    return VK_STENCIL_OP_DECREMENT_AND_CLAMP;
+  case igl::StencilOperation::Invert:
+    return VK_STENCIL_OP_INVERT;
+  case igl::StencilOperation::IncrementWrap:
+    return VK_STENCIL_OP_INCREMENT_AND_WRAP;
+  case igl::StencilOperation::DecrementWrap:
+    return VK_STENCIL_OP_DECREMENT_AND_WRAP;
+  }
+  IGL_ASSERT(false);
+  return VK_STENCIL_OP_KEEP;
+}
+
+VkPrimitiveTopology primitiveTypeToVkPrimitiveTopology(igl::PrimitiveType t) {
+  switch (t) {
+  case igl::PrimitiveType::Point:
+    return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+  case igl::PrimitiveType::Line:
+    return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+  case igl::PrimitiveType::LineStrip:
+    return VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
+  case igl::PrimitiveType::Triangle:
+    return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+  case igl::PrimitiveType::TriangleStrip:
+    return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+  }
+  IGL_ASSERT_MSG(false, "Implement PrimitiveType = %u", (uint32_t)t);
+  return VK_PRIMITIVE_TOPOLOGY_MAX_ENUM;
+}
+
 VkSampleCountFlagBits getVulkanSampleCountFlags(size_t numSamples) {
   if (numSamples <= 1) {
     return VK_SAMPLE_COUNT_1_BIT;
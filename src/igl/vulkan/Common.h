@@ -12,16 +12,27 @@
 // set to 1 to see very verbose debug console logs with Vulkan commands
 #define IGL_VULKAN_PRINT_COMMANDS 0
 
+// set to 0 to compile out enhanced shader debugging (VulkanContextConfig::enhancedShaderDebugging):
+// shaders get an empty drawLine() and no binding slot is reserved for the lines buffer
+#if !defined(IGL_VULKAN_ENHANCED_SHADER_DEBUGGING)
+#define IGL_VULKAN_ENHANCED_SHADER_DEBUGGING 1
+#endif // !defined(IGL_VULKAN_ENHANCED_SHADER_DEBUGGING)
+
 #if !defined(VK_NO_PROTOTYPES)
 #define VK_NO_PROTOTYPES 1
 #endif // !defined(VK_NO_PROTOTYPES)
 
 #include <igl/Macros.h>
 #include <volk.h>
+
+#if defined(IGL_WITH_TRACY_GPU)
+#include "tracy/TracyVulkan.hpp"
+#endif // IGL_WITH_TRACY_GPU
 #if IGL_PLATFORM_MACOS
 #include <vulkan/vulkan_metal.h>
 #endif
 
+#include <igl/Buffer.h>
 #include <igl/Common.h>
 #include <igl/DepthStencilState.h>
 #include <igl/Texture.h>
@@ -74,6 +85,8 @@ igl::TextureFormat vkFormatToTextureFormat(VkFormat format);
 igl::ColorSpace vkColorSpaceToColorSpace(VkColorSpaceKHR colorSpace);
 VkMemoryPropertyFlags resourceStorageToVkMemoryPropertyFlags(igl::ResourceStorage resourceStorage);
 VkCompareOp compareFunctionToVkCompareOp(igl::CompareFunction func);
+VkStencilOp stencilOperationToVkStencilOp(igl::StencilOperation op);
+VkPrimitiveTopology primitiveTypeToVkPrimitiveTopology(igl::PrimitiveType t);
 VkSampleCountFlagBits getVulkanSampleCountFlags(size_t numSamples);
 VkSurfaceFormatKHR colorSpaceToVkSurfaceFormat(igl::ColorSpace colorSpace, bool isBGR = false);
 
@@ -7,6 +7,7 @@
 
 #include <igl/vulkan/ComputeCommandEncoder.h>
 
+#include <algorithm>
 #include <igl/vulkan/Buffer.h>
 #include <igl/vulkan/ComputePipelineState.h>
 #include <igl/vulkan/Texture.h>
@@ -20,7 +21,9 @@ namespace vulkan {
 
 ComputeCommandEncoder::ComputeCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer,
                                              const VulkanContext& ctx) :
+  IComputeCommandEncoder(commandBuffer),
   ctx_(ctx),
+  commandBuffer_(commandBuffer),
   cmdBuffer_(commandBuffer ? commandBuffer->getVkCommandBuffer() : VK_NULL_HANDLE),
   binder_(commandBuffer, ctx_, VK_PIPELINE_BIND_POINT_COMPUTE) {
   IGL_PROFILER_FUNCTION();
@@ -28,7 +31,7 @@ ComputeCommandEncoder::ComputeCommandEncoder(const std::shared_ptr<CommandBuffer
   IGL_ASSERT(commandBuffer);
 
   ctx_.checkAndUpdateDescriptorSets();
-  ctx_.DUBs_->update(cmdBuffer_, VK_PIPELINE_BIND_POINT_COMPUTE, nullptr);
+  ctx_.DUBs_->update(cmdBuffer_, VK_PIPELINE_BIND_POINT_COMPUTE, nullptr, 0);
 
   isEncoding_ = true;
 }
@@ -41,6 +44,26 @@ void ComputeCommandEncoder::endEncoding() {
   }
 
   isEncoding_ = false;
+
+  // makes the resources written by the dispatches visible to the following indirect draws, vertex
+  // fetching and shaders. The async compute queue is synchronized with semaphores instead. The
+  // barrier is batched with the ones of the next encoder
+  if (cmdBuffer_ != VK_NULL_HANDLE && hasDispatches_ && !commandBuffer_->isAsyncCompute()) {
+    commandBuffer_->getBarrierBatch().memoryBarrier(
+        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR,
+        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR | VK_ACCESS_2_INDEX_READ_BIT_KHR |
+            VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT_KHR | VK_ACCESS_2_SHADER_READ_BIT_KHR |
+            VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+        VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR | VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR |
+            VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR |
+            VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR |
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR |
+            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR);
+  }
+  unsyncedBuffers_.clear();
+  unsyncedImages_.clear();
+  hasDispatches_ = false;
 }
 
 void ComputeCommandEncoder::bindComputePipelineState(
@@ -63,10 +86,112 @@ void ComputeCommandEncoder::dispatchThreadGroups(const Dimensions& threadgroupCo
                                                  const Dimensions& /*threadgroupSize*/) {
   IGL_PROFILER_FUNCTION();
 
+  insertDispatchBarriers();
+  commandBuffer_->flushBarriers();
   binder_.updateBindings();
   // threadgroupSize is controlled inside compute shaders
   vkCmdDispatch(
       cmdBuffer_, threadgroupCount.width, threadgroupCount.height, threadgroupCount.depth);
+  commandBuffer_->incrementStatistic(CommandBufferCounter::Dispatches);
+  didDispatch();
+}
+
+void ComputeCommandEncoder::dispatchThreadGroupsIndirect(IBuffer& indirectBuffer,
+                                                         size_t indirectBufferOffset,
+                                                         const Dimensions& /*threadgroupSize*/) {
+  IGL_PROFILER_FUNCTION();
+
+  IGL_ASSERT_MSG(indirectBufferOffset % 4 == 0, "indirectBufferOffset must be a multiple of 4");
+
+  const igl::vulkan::Buffer* bufIndirect = static_cast<igl::vulkan::Buffer*>(&indirectBuffer);
+  const VkDeviceSize offset = bufIndirect->getVkBufferOffset() + indirectBufferOffset;
+
+  // the thread group counts may have been written by a previous dispatch of this encoder, while
+  // the barrier in endEncoding() only covers the dispatches of the previous compute passes
+  auto it = std::find(unsyncedBuffers_.begin(), unsyncedBuffers_.end(), bufIndirect);
+  if (it != unsyncedBuffers_.end()) {
+    unsyncedBuffers_.erase(it);
+    commandBuffer_->getBarrierBatch().bufferBarrier(
+        bufIndirect->getVkBuffer(),
+        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR,
+        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR |
+            VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR,
+        bufIndirect->getVkBufferOffset(),
+        bufIndirect->getSizeInBytes(),
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+        VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR);
+  }
+  insertDispatchBarriers();
+  commandBuffer_->flushBarriers();
+  binder_.updateBindings();
+  // threadgroupSize is controlled inside compute shaders
+  vkCmdDispatchIndirect(cmdBuffer_, bufIndirect->getVkBuffer(), offset);
+  commandBuffer_->incrementStatistic(CommandBufferCounter::Dispatches);
+  didDispatch();
+}
+
+void ComputeCommandEncoder::insertDispatchBarriers() {
+  VulkanBarrierBatch& batch = commandBuffer_->getBarrierBatch();
+
+  if (!unsyncedBuffers_.empty()) {
+    for (const igl::vulkan::Buffer* buf : boundBuffers_) {
+      auto it = buf ? std::find(unsyncedBuffers_.begin(), unsyncedBuffers_.end(), buf)
+                    : unsyncedBuffers_.end();
+      if (it == unsyncedBuffers_.end()) {
+        continue;
+      }
+      unsyncedBuffers_.erase(it);
+      batch.bufferBarrier(buf->getVkBuffer(),
+                          VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR,
+                          VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR |
+                              VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR,
+                          buf->getVkBufferOffset(),
+                          buf->getSizeInBytes(),
+                          VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                          VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR);
+    }
+  }
+
+  if (!unsyncedImages_.empty()) {
+    for (const VulkanImage* image : boundImages_) {
+      auto it = image ? std::find(unsyncedImages_.begin(), unsyncedImages_.end(), image)
+                      : unsyncedImages_.end();
+      if (it == unsyncedImages_.end()) {
+        continue;
+      }
+      unsyncedImages_.erase(it);
+      batch.imageBarrier(image->getVkImage(),
+                         VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR,
+                         VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR |
+                             VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR,
+                         VK_IMAGE_LAYOUT_GENERAL,
+                         VK_IMAGE_LAYOUT_GENERAL,
+                         VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                         VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                         VkImageSubresourceRange{image->getImageAspectFlags(),
+                                                 0,
+                                                 VK_REMAINING_MIP_LEVELS,
+                                                 0,
+                                                 VK_REMAINING_ARRAY_LAYERS});
+    }
+  }
+}
+
+void ComputeCommandEncoder::didDispatch() {
+  hasDispatches_ = true;
+
+  for (const igl::vulkan::Buffer* buf : boundBuffers_) {
+    if (buf && std::find(unsyncedBuffers_.begin(), unsyncedBuffers_.end(), buf) ==
+                   unsyncedBuffers_.end()) {
+      unsyncedBuffers_.push_back(buf);
+    }
+  }
+  for (const VulkanImage* image : boundImages_) {
+    if (image && std::find(unsyncedImages_.begin(), unsyncedImages_.end(), image) ==
+                     unsyncedImages_.end()) {
+      unsyncedImages_.push_back(image);
+    }
+  }
 }
 
 void ComputeCommandEncoder::pushDebugGroupLabel(const std::string& label,
@@ -105,20 +230,32 @@ void ComputeCommandEncoder::bindTexture(size_t index, ITexture* texture) {
     return;
   }
 
-  // "frame graph" heuristics: if we are already in VK_IMAGE_LAYOUT_GENERAL, wait for the previous
-  // compute shader, otherwise wait for previous attachment writes
-  const VkPipelineStageFlags srcStage =
-      (vkImage.imageLayout_ == VK_IMAGE_LAYOUT_GENERAL) ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
-      : vkImage.isDepthOrStencilFormat_                 ? VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
-                                        : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-  vkImage.transitionLayout(
-      cmdBuffer_,
-      VK_IMAGE_LAYOUT_GENERAL,
-      srcStage,
-      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-      VkImageSubresourceRange{
-          vkImage.getImageAspectFlags(), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
+  // An image which is entirely in VK_IMAGE_LAYOUT_GENERAL needs no transition: the writes of the
+  // previous dispatches of this encoder are tracked by insertDispatchBarriers() and the ones of the
+  // previous passes are covered by their endEncoding()
+  if (vkImage.imageLayout_ != VK_IMAGE_LAYOUT_GENERAL || !vkImage.subresourceLayouts_.empty()) {
+    // "frame graph" heuristics: if we are already in VK_IMAGE_LAYOUT_GENERAL, wait for the previous
+    // compute shader, otherwise wait for previous attachment writes. The async compute queue has
+    // no graphics stages: attachment writes are covered by CommandBuffer::waitForCommandBuffer()
+    const VkPipelineStageFlags srcStage =
+        (vkImage.imageLayout_ == VK_IMAGE_LAYOUT_GENERAL) ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+        : commandBuffer_->isAsyncCompute()                ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT
+        : vkImage.isDepthOrStencilFormat_ ? VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
+                                          : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    vkImage.transitionLayout(commandBuffer_->getBarrierBatch(),
+                             VK_IMAGE_LAYOUT_GENERAL,
+                             srcStage,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VkImageSubresourceRange{vkImage.getImageAspectFlags(),
+                                                     0,
+                                                     VK_REMAINING_MIP_LEVELS,
+                                                     0,
+                                                     VK_REMAINING_ARRAY_LAYERS});
+  }
 
+  if (index < kMaxBindingSlots) {
+    boundImages_[index] = &vkImage;
+  }
   binder_.bindTexture(index, static_cast<igl::vulkan::Texture*>(texture));
 }
 
@@ -142,6 +279,9 @@ void ComputeCommandEncoder::bindBuffer(size_t index,
     return;
   }
 
+  if (index < kMaxBindingSlots) {
+    boundBuffers_[index] = buf;
+  }
   binder_.bindBuffer((int)index, buf, offset);
 }
 
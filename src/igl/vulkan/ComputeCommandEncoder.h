@@ -7,10 +7,12 @@
 
 #pragma once
 
+#include <array>
 #include <igl/Common.h>
 #include <igl/ComputeCommandEncoder.h>
 #include <igl/vulkan/CommandBuffer.h>
 #include <igl/vulkan/ResourcesBinder.h>
+#include <vector>
 
 namespace igl {
 
@@ -21,6 +23,9 @@ class ITexture;
 
 namespace vulkan {
 
+class Buffer;
+class VulkanImage;
+
 class ComputeCommandEncoder : public IComputeCommandEncoder {
  public:
   ComputeCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer,
@@ -34,6 +39,9 @@ class ComputeCommandEncoder : public IComputeCommandEncoder {
       const std::shared_ptr<IComputePipelineState>& pipelineState) override;
   void dispatchThreadGroups(const Dimensions& threadgroupCount,
                             const Dimensions& threadgroupSize) override;
+  void dispatchThreadGroupsIndirect(IBuffer& indirectBuffer,
+                                    size_t indirectBufferOffset,
+                                    const Dimensions& threadgroupSize) override;
   void endEncoding() override;
 
   void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
@@ -49,12 +57,32 @@ class ComputeCommandEncoder : public IComputeCommandEncoder {
     return cmdBuffer_;
   }
 
+ private:
+  // Records the barriers making the writes of the previous dispatches of this encoder visible to
+  // the next one. Only the bound resources written since their last barrier need one, so
+  // independent dispatches are not synchronized with each other
+  void insertDispatchBarriers();
+  // All bound storage buffers and images are treated as written by the dispatch
+  void didDispatch();
+
  private:
   const VulkanContext& ctx_;
+  std::shared_ptr<CommandBuffer> commandBuffer_;
   VkCommandBuffer cmdBuffer_ = VK_NULL_HANDLE;
   bool isEncoding_ = false;
 
   igl::vulkan::ResourcesBinder binder_;
+
+  // Raw pointers, the caller keeps the bound resources alive until the commands are submitted
+  std::array<const igl::vulkan::Buffer*, kMaxBindingSlots> boundBuffers_{};
+  std::array<const VulkanImage*, kMaxBindingSlots> boundImages_{};
+  // Hazard tracking: resources written by dispatches of this encoder since the last barrier
+  // covering them. Resources accessed through buffer device addresses in push constants are not
+  // tracked
+  std::vector<const igl::vulkan::Buffer*> unsyncedBuffers_;
+  std::vector<const VulkanImage*> unsyncedImages_;
+  // whether endEncoding() has to make the writes of this pass visible to the following commands
+  bool hasDispatches_ = false;
 };
 
 } // namespace vulkan
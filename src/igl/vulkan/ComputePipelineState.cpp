@@ -28,19 +28,27 @@ ComputePipelineState::ComputePipelineState(const igl::vulkan::Device& device,
 
 ComputePipelineState ::~ComputePipelineState() {
   if (pipeline_ != VK_NULL_HANDLE) {
-    device_.getVulkanContext().deferredTask(std::packaged_task<void()>(
-        [device = device_.getVulkanContext().device_->getVkDevice(), pipeline = pipeline_]() {
-          vkDestroyPipeline(device, pipeline, nullptr);
-        }));
+    device_.getVulkanContext().deferredDestroy(VulkanContext::DestructionType::Pipeline,
+                                               (uint64_t)pipeline_);
   }
 }
 
 VkPipeline ComputePipelineState::getVkPipeline() const {
+  const VulkanContext& ctx = device_.getVulkanContext();
+
   if (pipeline_ != VK_NULL_HANDLE) {
-    return pipeline_;
+    if (bindlessGeneration_ == ctx.bindlessGeneration_) {
+      return pipeline_;
+    }
+    // the pipeline layout has been recreated since this pipeline was built
+    ctx.deferredDestroy(VulkanContext::DestructionType::Pipeline, (uint64_t)pipeline_);
+    pipeline_ = VK_NULL_HANDLE;
   }
 
-  const VulkanContext& ctx = device_.getVulkanContext();
+  // this can run on a worker thread (see Device::createComputePipelineAsync()), so the layout is
+  // taken together with its generation: the pipeline is rebuilt if the layout is replaced
+  const VkPipelineLayout layout =
+      ctx.getVkPipelineLayout(VK_PIPELINE_BIND_POINT_COMPUTE, bindlessGeneration_);
 
   const auto& shaderModule = desc_.shaderStages->getComputeModule();
 
@@ -48,13 +56,13 @@ VkPipeline ComputePipelineState::getVkPipeline() const {
       .shaderStage(ivkGetPipelineShaderStageCreateInfo(
           VK_SHADER_STAGE_COMPUTE_BIT,
           igl::vulkan::ShaderModule::getVkShaderModule(shaderModule),
-          shaderModule->info().entryPoint.c_str()))
+          shaderModule->info().entryPoint.c_str(),
+          igl::vulkan::ShaderModule::getVkSpecializationInfo(shaderModule)))
+      .creationFeedback(ctx.getPipelineCreationFeedback())
+      .createFlags(ctx.getPipelineCreateFlags())
       .build(ctx.device_->getVkDevice(),
-             // TODO: use ctx.pipelineCache_
-             // @fb-only
-             // @fb-only
-             VK_NULL_HANDLE,
-             ctx.pipelineLayoutCompute_->getVkPipelineLayout(),
+             ctx.pipelineCache_,
+             layout,
              &pipeline_,
              desc_.debugName.c_str());
 
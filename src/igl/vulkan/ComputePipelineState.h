@@ -35,6 +35,8 @@ class ComputePipelineState final : public IComputePipelineState {
   ComputePipelineDesc desc_;
 
   mutable VkPipeline pipeline_ = VK_NULL_HANDLE;
+  // VulkanContext::bindlessGeneration_ at the time `pipeline_` was built
+  mutable uint32_t bindlessGeneration_ = 0;
 };
 
 } // namespace vulkan
@@ -7,7 +7,10 @@
 
 #include <igl/vulkan/Device.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstring>
+#include <thread>
 #include <igl/vulkan/Buffer.h>
 #include <igl/vulkan/CommandQueue.h>
 #include <igl/vulkan/Common.h>
@@ -16,15 +19,22 @@
 #include <igl/vulkan/EnhancedShaderDebuggingStore.h>
 #include <igl/vulkan/Framebuffer.h>
 #include <igl/vulkan/PlatformDevice.h>
+#include <igl/vulkan/QueryPool.h>
 #include <igl/vulkan/RenderPipelineState.h>
+#include <igl/vulkan/RingBuffer.h>
 #include <igl/vulkan/SamplerState.h>
 #include <igl/vulkan/ShaderModule.h>
 #include <igl/vulkan/Texture.h>
+#include <igl/vulkan/Timer.h>
 #include <igl/vulkan/VertexInputState.h>
 #include <igl/vulkan/VulkanContext.h>
 #include <igl/vulkan/VulkanDevice.h>
 #include <igl/vulkan/VulkanHelpers.h>
+#include <igl/vulkan/VulkanImage.h>
+#include <igl/vulkan/VulkanImageView.h>
 #include <igl/vulkan/VulkanShaderModule.h>
+#include <igl/vulkan/VulkanSpirvCache.h>
+#include <igl/vulkan/VulkanTexture.h>
 
 #if IGL_SHADER_DUMP && IGL_DEBUG
 #include <filesystem>
@@ -57,10 +67,53 @@ VkShaderStageFlagBits shaderStageToVkShaderStage(igl::ShaderStage stage) {
 namespace igl {
 namespace vulkan {
 
-Device::Device(std::unique_ptr<VulkanContext> ctx) : ctx_(std::move(ctx)), platformDevice_(*this) {
+Device::Device(std::unique_ptr<VulkanContext> ctx) :
+  ctx_(std::move(ctx)),
+  platformDevice_(*this),
+  // leave one core to the rendering thread
+  workerPool_(std::max(2u, std::thread::hardware_concurrency()) - 1) {
+#if IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
   if (ctx_->enhancedShaderDebuggingStore_) {
     ctx_->enhancedShaderDebuggingStore_->initialize(this);
   }
+#endif // IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
+}
+
+Device::~Device() {
+  // Tasks can schedule new tasks (e.g. completion handlers creating pipelines), so they are waited
+  // for without holding the lock, until no task is left
+  for (;;) {
+    std::vector<PendingTask> tasks;
+    {
+      std::lock_guard<std::mutex> lock(pendingTasksMutex_);
+      tasks.swap(pendingTasks_);
+    }
+    if (tasks.empty()) {
+      break;
+    }
+    for (auto& t : tasks) {
+      t.future.wait();
+    }
+  }
+}
+
+std::shared_future<void> Device::runTask(std::function<void()> task,
+                                         std::shared_ptr<void> keepAlive) const {
+  std::shared_future<void> future = workerPool_.push(std::move(task));
+
+  std::lock_guard<std::mutex> lock(pendingTasksMutex_);
+
+  // drop the tasks which have already finished
+  pendingTasks_.erase(std::remove_if(pendingTasks_.begin(),
+                                     pendingTasks_.end(),
+                                     [](const PendingTask& t) {
+                                       return t.future.wait_for(std::chrono::seconds(0)) ==
+                                              std::future_status::ready;
+                                     }),
+                      pendingTasks_.end());
+  pendingTasks_.push_back({future, std::move(keepAlive)});
+
+  return future;
 }
 
 std::shared_ptr<ICommandQueue> Device::createCommandQueue(const CommandQueueDesc& desc,
@@ -80,6 +133,12 @@ std::unique_ptr<IBuffer> Device::createBuffer(const BufferDesc& desc,
     return nullptr;
   }
 
+  if (getResourceTracker()) {
+    buffer->initResourceTracker(
+        getResourceTracker(),
+        {buffer->getSizeInBytes(), toResourceMemoryLocation(buffer->storage()), desc.debugName});
+  }
+
   if (!desc.data) {
     return buffer;
   }
@@ -94,8 +153,10 @@ std::unique_ptr<IBuffer> Device::createBuffer(const BufferDesc& desc,
 std::shared_ptr<IDepthStencilState> Device::createDepthStencilState(
     const DepthStencilStateDesc& desc,
     Result* outResult) const {
-  Result::setOk(outResult);
-  return std::make_shared<vulkan::DepthStencilState>(desc);
+  return depthStencilStates_.getOrCreate(desc, outResult, [&desc](Result* result) {
+    Result::setOk(result);
+    return std::make_shared<vulkan::DepthStencilState>(desc);
+  });
 }
 
 std::unique_ptr<IShaderStages> Device::createShaderStages(const ShaderStagesDesc& desc,
@@ -118,7 +179,30 @@ std::shared_ptr<ISamplerState> Device::createSamplerState(const SamplerStateDesc
                                                           Result* outResult) const {
   auto samplerState = std::make_shared<vulkan::SamplerState>(*this);
 
-  Result::setResult(outResult, samplerState->create(desc));
+  std::lock_guard<std::mutex> lock(samplersMutex_);
+
+  const auto it = samplers_.find(desc);
+
+  if (it != samplers_.end()) {
+    if (auto sampler = it->second.lock()) {
+      samplerState->desc_ = desc;
+      samplerState->sampler_ = std::move(sampler);
+      Result::setOk(outResult);
+      return samplerState;
+    }
+  }
+
+  const Result result = samplerState->create(desc);
+
+  if (result.isOk()) {
+    // forget the samplers which are not used anymore
+    for (auto i = samplers_.begin(); i != samplers_.end();) {
+      i = i->second.expired() ? samplers_.erase(i) : std::next(i);
+    }
+    samplers_[desc] = samplerState->sampler_;
+  }
+
+  Result::setResult(outResult, result);
 
   return samplerState;
 }
@@ -131,18 +215,128 @@ std::shared_ptr<ITexture> Device::createTexture(const TextureDesc& desc,
 
   const Result res = texture->create(sanitized);
 
+  if (res.isOk() && getResourceTracker()) {
+    texture->initResourceTracker(getResourceTracker(),
+                                 {texture->getEstimatedSizeInBytes(),
+                                  toResourceMemoryLocation(sanitized.storage),
+                                  desc.debugName});
+  }
+
   Result::setResult(outResult, res);
 
   return res.isOk() ? texture : nullptr;
 }
 
+std::shared_ptr<ITexture> Device::createTextureView(std::shared_ptr<ITexture> texture,
+                                                    const TextureViewDesc& desc,
+                                                    Result* outResult) const noexcept {
+  auto* source = static_cast<vulkan::Texture*>(texture.get());
+  if (!IGL_VERIFY(source && source->texture_)) {
+    Result::setResult(outResult, Result::Code::ArgumentNull, "Texture is null");
+    return nullptr;
+  }
+  TextureViewDesc viewDesc = desc;
+  Result result = viewDesc.resolve(*source);
+  if (!result.isOk()) {
+    Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+  const VulkanTexture& vkTexture = *source->texture_;
+  const VulkanImage& image = vkTexture.getVulkanImage();
+  if (image.isExternallyManaged_ || image.samples_ != VK_SAMPLE_COUNT_1_BIT) {
+    Result::setResult(outResult,
+                      Result::Code::Unsupported,
+                      "Views of swapchain and multisampled textures are not supported");
+    return nullptr;
+  }
+
+  const VkFormat vkFormat = viewDesc.format == source->getFormat()
+                                ? vkTexture.getViewFormat()
+                                : textureFormatToVkFormat(viewDesc.format);
+  if (vkFormat != image.imageFormat_ &&
+      (image.vkImageCreateInfo_.flags & VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT) == 0) {
+    Result::setResult(outResult,
+                      Result::Code::ArgumentInvalid,
+                      "Reinterpreting the format requires TextureOptionBits::MutableFormat");
+    return nullptr;
+  }
+
+  VkImageViewType viewType = VK_IMAGE_VIEW_TYPE_2D;
+  switch (viewDesc.type) {
+  case TextureType::TwoDArray:
+    viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    break;
+  case TextureType::ThreeD:
+    viewType = VK_IMAGE_VIEW_TYPE_3D;
+    break;
+  case TextureType::Cube:
+    if (viewDesc.numLayers != 6) {
+      Result::setResult(outResult, Result::Code::Unsupported, "Cube array views are unsupported");
+      return nullptr;
+    }
+    viewType = VK_IMAGE_VIEW_TYPE_CUBE;
+    break;
+  default:
+    break;
+  }
+
+  // layers of cube textures are addressed as faces, like VkImage array layers
+  const uint32_t baseLayer = vkTexture.getBaseLayer() + viewDesc.layer;
+  const uint32_t baseLevel = vkTexture.getBaseLevel() + viewDesc.mipLevel;
+  const VkImageAspectFlags aspect =
+      image.isDepthOrStencilFormat_ ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+  const std::string debugNameImageView =
+      !viewDesc.debugName.empty() ? IGL_FORMAT("Image View: {}", viewDesc.debugName.c_str()) : "";
+
+  std::shared_ptr<VulkanImageView> imageView = image.createImageView(viewType,
+                                                                     vkFormat,
+                                                                     aspect,
+                                                                     baseLevel,
+                                                                     viewDesc.numMipLevels,
+                                                                     baseLayer,
+                                                                     viewDesc.numLayers,
+                                                                     debugNameImageView.c_str());
+  if (!IGL_VERIFY(imageView)) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create VulkanImageView");
+    return nullptr;
+  }
+  // the view keeps a VkImageView of this image, so its memory cannot be moved anymore
+  image.hasTextureViews_ = true;
+
+  TextureDesc textureDesc = source->desc_;
+  const Dimensions dimensions = source->getDimensions();
+  textureDesc.width = std::max<size_t>(dimensions.width >> viewDesc.mipLevel, 1);
+  textureDesc.height = std::max<size_t>(dimensions.height >> viewDesc.mipLevel, 1);
+  textureDesc.depth = std::max<size_t>(dimensions.depth >> viewDesc.mipLevel, 1);
+  textureDesc.numLayers = viewDesc.type == TextureType::Cube ? 1 : viewDesc.numLayers;
+  textureDesc.numMipLevels = viewDesc.numMipLevels;
+  textureDesc.type = viewDesc.type;
+  textureDesc.format = viewDesc.format;
+  textureDesc.debugName = viewDesc.debugName;
+
+  std::shared_ptr<VulkanTexture> texture = ctx_->createTexture(
+      vkTexture.image_, std::move(imageView), &result, vkFormat, baseLevel, baseLayer);
+  if (!result.isOk()) {
+    Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+
+  auto view =
+      std::make_shared<vulkan::Texture>(*this, std::move(texture), std::move(textureDesc));
+  view->isView_ = true;
+
+  Result::setOk(outResult);
+  return view;
+}
+
 std::shared_ptr<IVertexInputState> Device::createVertexInputState(const VertexInputStateDesc& desc,
                                                                   Result* outResult) const {
   // VertexInputState is compiled into the RenderPipelineState at a later stage. For now, we just
   // have to store the description.
-  Result::setOk(outResult);
-
-  return std::make_shared<vulkan::VertexInputState>(desc);
+  return vertexInputStates_.getOrCreate(desc, outResult, [&desc](Result* result) {
+    Result::setOk(result);
+    return std::make_shared<vulkan::VertexInputState>(desc);
+  });
 }
 
 std::shared_ptr<IComputePipelineState> Device::createComputePipeline(
@@ -165,6 +359,39 @@ std::shared_ptr<IComputePipelineState> Device::createComputePipeline(
   return std::make_shared<ComputePipelineState>(*this, desc);
 }
 
+void Device::createComputePipelineAsync(const ComputePipelineDesc& desc,
+                                        ComputePipelineCompletionHandler completionHandler) const {
+  IGL_PROFILER_FUNCTION();
+
+  Result result;
+  auto pipelineState =
+      std::static_pointer_cast<ComputePipelineState>(createComputePipeline(desc, &result));
+
+  if (!result.isOk()) {
+    if (completionHandler) {
+      completionHandler(nullptr, std::move(result));
+    }
+    return;
+  }
+
+  // VkDevice and VkPipelineCache are internally synchronized, so the expensive
+  // vkCreateComputePipelines() call can safely run on another thread. The pipeline state is not
+  // handed over to the application until its VkPipeline is ready.
+  auto task = [pipelineState, handler = std::move(completionHandler)]() {
+    const VkPipeline pipeline = pipelineState->getVkPipeline();
+    if (!handler) {
+      return;
+    }
+    if (pipeline == VK_NULL_HANDLE) {
+      handler(nullptr, Result(Result::Code::RuntimeError, "Cannot create a compute pipeline"));
+      return;
+    }
+    handler(pipelineState, Result());
+  };
+
+  runTask(std::move(task), pipelineState);
+}
+
 std::shared_ptr<IRenderPipelineState> Device::createRenderPipeline(const RenderPipelineDesc& desc,
                                                                    Result* outResult) const {
   if (IGL_UNEXPECTED(desc.shaderStages == nullptr)) {
@@ -194,7 +421,68 @@ std::shared_ptr<IRenderPipelineState> Device::createRenderPipeline(const RenderP
     return nullptr;
   }
 
-  return std::make_shared<RenderPipelineState>(*this, desc);
+  return std::make_shared<RenderPipelineState>(*this, desc, getRenderPipelineVariants(desc));
+}
+
+std::shared_ptr<RenderPipelineVariants> Device::getRenderPipelineVariants(
+    const RenderPipelineDesc& desc) const {
+  std::lock_guard<std::mutex> lock(renderPipelineVariantsMutex_);
+
+  std::shared_ptr<RenderPipelineVariants> variants = renderPipelineVariants_[desc].lock();
+
+  if (!variants) {
+    // forget the descriptors which are not used anymore
+    for (auto it = renderPipelineVariants_.begin(); it != renderPipelineVariants_.end();) {
+      it = it->second.expired() ? renderPipelineVariants_.erase(it) : std::next(it);
+    }
+    variants = std::make_shared<RenderPipelineVariants>(*ctx_);
+    renderPipelineVariants_[desc] = variants;
+  }
+
+  return variants;
+}
+
+std::shared_future<void> Device::warmUpRenderPipeline(
+    const std::shared_ptr<IRenderPipelineState>& pipelineState,
+    const std::vector<RenderPipelineVariantDesc>& variants) const {
+  IGL_PROFILER_FUNCTION();
+
+  auto* rps = static_cast<RenderPipelineState*>(pipelineState.get());
+
+  if (!IGL_VERIFY(rps)) {
+    return {};
+  }
+
+  // render passes can only be created on this thread
+  std::vector<std::pair<RenderPipelineDynamicState, VkRenderPass>> states;
+  states.reserve(variants.size());
+  for (const auto& v : variants) {
+    const RenderPipelineDynamicState dynamicState = rps->getDynamicState(v);
+    states.emplace_back(dynamicState, ctx_->getRenderPass(dynamicState.renderPassIndex_).pass);
+  }
+
+  auto task = [this, rps, states = std::move(states)]() {
+    IGL_PROFILER_THREAD("Pipeline warm-up");
+    for (const auto& s : states) {
+      if (rps->variants_->find(s.first) == VK_NULL_HANDLE) {
+        // this is a worker thread already: no need to fast-link
+        rps->buildVkPipeline(s.first, s.second, false);
+        pipelineVariantsWarmedUp_++;
+      }
+    }
+  };
+
+  return runTask(std::move(task), pipelineState);
+}
+
+Device::RenderPipelineVariantStats Device::getRenderPipelineVariantStats() const {
+  RenderPipelineVariantStats stats;
+  stats.hits = pipelineVariantHits_;
+  stats.misses = pipelineVariantMisses_;
+  stats.warmedUp = pipelineVariantsWarmedUp_;
+  stats.fastLinked = pipelineVariantsFastLinked_;
+  stats.optimized = pipelineVariantsOptimized_;
+  return stats;
 }
 
 std::shared_ptr<IShaderModule> Device::createShaderModule(const ShaderModuleDesc& desc,
@@ -217,6 +505,58 @@ std::shared_ptr<IShaderModule> Device::createShaderModule(const ShaderModuleDesc
   return std::make_shared<ShaderModule>(desc.info, std::move(vulkanShaderModule));
 }
 
+std::vector<std::shared_ptr<IShaderModule>> Device::createShaderModules(
+    const std::vector<ShaderModuleDesc>& descs,
+    Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
+
+  std::vector<std::shared_ptr<IShaderModule>> modules(descs.size());
+  std::vector<Result> results(descs.size());
+
+  // glslang does not parallelize internally, so every worker pulls the next module to compile.
+  // The first module missing from the SPIR-V cache initializes glslang through
+  // VulkanContext::initGlslang(), which is thread-safe, and the per-thread glslang state is
+  // allocated on first use.
+  std::atomic<size_t> nextIndex = 0;
+
+  auto compile = [this, &descs, &modules, &results, &nextIndex]() {
+    for (size_t i = nextIndex++; i < descs.size(); i = nextIndex++) {
+      modules[i] = createShaderModule(descs[i], &results[i]);
+    }
+  };
+
+  const size_t numWorkers =
+      std::min(descs.size(), size_t(std::max(1u, std::thread::hardware_concurrency())));
+
+  std::vector<std::future<void>> futures;
+  futures.reserve(numWorkers);
+
+  // the calling thread is one of the workers
+  for (size_t i = 1; i < numWorkers; i++) {
+    futures.push_back(std::async(std::launch::async, [&compile]() {
+      IGL_PROFILER_THREAD("Shader compilation");
+      compile();
+    }));
+  }
+
+  compile();
+
+  for (auto& f : futures) {
+    f.wait();
+  }
+
+  Result::setOk(outResult);
+
+  for (auto& r : results) {
+    if (!r.isOk()) {
+      Result::setResult(outResult, std::move(r));
+      break;
+    }
+  }
+
+  return modules;
+}
+
 std::shared_ptr<VulkanShaderModule> Device::createShaderModule(const void* data,
                                                                size_t length,
                                                                const std::string& debugName,
@@ -288,14 +628,30 @@ std::shared_ptr<VulkanShaderModule> Device::createShaderModule(ShaderStage stage
       extraExtensions += "#extension GL_EXT_debug_printf : enable\n";
     }
 
+#if IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
+    const bool includeDrawLineBody = ctx_->enhancedShaderDebuggingStore_ != nullptr;
+#else
+    const bool includeDrawLineBody = false;
+#endif // IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
     const std::string enhancedShaderDebuggingCode =
-        EnhancedShaderDebuggingStore::recordLineShaderCode(
-            ctx_->enhancedShaderDebuggingStore_ != nullptr, ctx_->extensions_);
+        EnhancedShaderDebuggingStore::recordLineShaderCode(includeDrawLineBody, ctx_->extensions_);
 
     if (ctx_->vkPhysicalDeviceShaderFloat16Int8Features_.shaderFloat16 == VK_TRUE) {
       extraExtensions += "#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require\n";
     }
 
+    // framebuffer fetch: subpassLoad(kFramebufferFetch<i>) reads the i-th color attachment at the
+    // current pixel, see RenderPassDesc::framebufferFetch
+    std::string framebufferFetchCode;
+    if (ctx_->dslInputAttachments_) {
+      for (uint32_t i = 0; i != IGL_COLOR_ATTACHMENTS_MAX; i++) {
+        framebufferFetchCode += IGL_FORMAT(
+            "layout (input_attachment_index = {0}, set = 2, binding = {0}) "
+            "uniform subpassInput kFramebufferFetch{0};\n",
+            i);
+      }
+    }
+
     // there's no header provided in the shader source, let's insert our own header
     if (vkStage == VK_SHADER_STAGE_VERTEX_BIT || vkStage == VK_SHADER_STAGE_COMPUTE_BIT) {
       sourcePatched += R"(
@@ -382,22 +738,41 @@ std::shared_ptr<VulkanShaderModule> Device::createShaderModule(ShaderStage stage
         return textureLod(samplerCube(kTexturesCube[nonuniformEXT(idxTex)],
                                    kSamplers[nonuniformEXT(idxSmp)]), uvw, lod);
       }
-      )" + enhancedShaderDebuggingCode;
+      )" + framebufferFetchCode +
+                       enhancedShaderDebuggingCode;
     }
     sourcePatched += source;
     source = sourcePatched.c_str();
   }
 
+  // zero-initialize the padding because the whole struct is hashed by the SPIR-V cache
   glslang_resource_t glslangResource;
+  memset(&glslangResource, 0, sizeof(glslangResource));
   ivkGlslangResource(&glslangResource, &ctx_->getVkPhysicalDeviceProperties());
 
+  const uint64_t cacheKey = VulkanSpirvCache::getKey(vkStage, source, glslangResource);
+
+  std::vector<uint32_t> spirv;
+
+  if (!ctx_->spirvCache_->find(cacheKey, spirv)) {
+    ctx_->initGlslang();
+    const Result result = igl::vulkan::compileShader(vkStage, source, spirv, &glslangResource);
+
+    if (!result.isOk()) {
+      Result::setResult(outResult, result);
+      return nullptr;
+    }
+
+    ctx_->spirvCache_->insert(cacheKey, spirv);
+  }
+
   VkShaderModule vkShaderModule = VK_NULL_HANDLE;
-  const Result result =
-      igl::vulkan::compileShader(device, vkStage, source, &vkShaderModule, &glslangResource);
+  const VkResult result = ivkCreateShaderModuleFromSPIRV(
+      device, spirv.data(), spirv.size() * sizeof(uint32_t), &vkShaderModule);
 
-  Result::setResult(outResult, result);
+  setResultFrom(outResult, result);
 
-  if (!result.isOk()) {
+  if (result != VK_SUCCESS) {
     return nullptr;
   }
 
@@ -419,6 +794,84 @@ std::shared_ptr<IFramebuffer> Device::createFramebuffer(const FramebufferDesc& d
   return resource;
 }
 
+std::shared_ptr<ITimer> Device::createTimer(Result* outResult) const noexcept {
+  Result result;
+  auto timer = std::make_shared<Timer>(*ctx_, &result);
+  if (!result.isOk()) {
+    Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+  Result::setOk(outResult);
+  return timer;
+}
+
+std::shared_ptr<IQueryPool> Device::createQueryPool(const QueryPoolDesc& desc,
+                                                    Result* outResult) const noexcept {
+  Result result;
+  auto queryPool = std::make_shared<QueryPool>(*ctx_, desc, &result);
+  if (!result.isOk()) {
+    Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+  Result::setOk(outResult);
+  return queryPool;
+}
+
+std::unique_ptr<IRingBuffer> Device::createRingBuffer(const RingBufferDesc& desc,
+                                                      Result* outResult) const noexcept {
+  Result result;
+  auto ringBuffer = std::make_unique<RingBuffer>(*this, desc, &result);
+  if (!result.isOk()) {
+    Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+  Result::setOk(outResult);
+  return ringBuffer;
+}
+
+bool Device::getMemoryStatistics(DeviceMemoryStatistics& outStatistics) const noexcept {
+  VkPhysicalDeviceMemoryProperties memProperties;
+  vkGetPhysicalDeviceMemoryProperties(ctx_->vkPhysicalDevice_, &memProperties);
+
+  outStatistics.heaps.resize(memProperties.memoryHeapCount);
+
+  for (uint32_t i = 0; i != memProperties.memoryHeapCount; i++) {
+    outStatistics.heaps[i].isDeviceLocal =
+        (memProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+    // the same heuristic as VMA uses without VK_EXT_memory_budget
+    outStatistics.heaps[i].budget = memProperties.memoryHeaps[i].size * 8 / 10;
+  }
+
+  if (IGL_VULKAN_USE_VMA) {
+    // VMA tracks its own allocations and takes VK_EXT_memory_budget into account when available
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS] = {};
+    vmaGetHeapBudgets((VmaAllocator)ctx_->getVmaAllocator(), budgets);
+    for (uint32_t i = 0; i != memProperties.memoryHeapCount; i++) {
+      outStatistics.heaps[i].usage = budgets[i].usage;
+      outStatistics.heaps[i].budget = budgets[i].budget;
+    }
+  } else if (ctx_->useMemoryBudget_) {
+#if defined(VK_EXT_memory_budget)
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget = {};
+    budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+    VkPhysicalDeviceMemoryProperties2 memProperties2 = {};
+    memProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    memProperties2.pNext = &budget;
+    vkGetPhysicalDeviceMemoryProperties2(ctx_->vkPhysicalDevice_, &memProperties2);
+    for (uint32_t i = 0; i != memProperties.memoryHeapCount; i++) {
+      outStatistics.heaps[i].usage = budget.heapUsage[i];
+      outStatistics.heaps[i].budget = budget.heapBudget[i];
+    }
+#endif // VK_EXT_memory_budget
+  }
+
+  outStatistics.textureBytes = ctx_->imageMemoryBytes_;
+  outStatistics.bufferBytes = ctx_->bufferMemoryBytes_;
+  outStatistics.resizableBarBufferBytes = ctx_->resizableBarBufferMemoryBytes_;
+
+  return true;
+}
+
 const PlatformDevice& Device::getPlatformDevice() const noexcept {
   return platformDevice_;
 }
@@ -510,6 +963,12 @@ bool Device::hasFeature(DeviceFeatures feature) const {
     return true;
   case DeviceFeatures::MinMaxBlend:
     return true;
+  case DeviceFeatures::MultiDrawIndirectCount:
+    return ctx_->vkCmdDrawIndexedIndirectCount_ != nullptr;
+  case DeviceFeatures::SparseTextures:
+    return ctx_->useSparseResidency_;
+  case DeviceFeatures::ShadingRate:
+    return ctx_->hasFragmentShadingRate();
   case DeviceFeatures::TextureExternalImage:
     return false;
   case DeviceFeatures::Compute:
@@ -518,6 +977,9 @@ bool Device::hasFeature(DeviceFeatures feature) const {
     return true;
   case DeviceFeatures::ExplicitBindingExt:
     return false;
+  case DeviceFeatures::FramebufferFetch:
+    // input attachments need render passes
+    return ctx_->dslInputAttachments_ != nullptr;
   case DeviceFeatures::TextureBindless:
     return ctx_->vkPhysicalDeviceDescriptorIndexingProperties_
                .shaderSampledImageArrayNonUniformIndexingNative == VK_TRUE;
@@ -527,16 +989,27 @@ bool Device::hasFeature(DeviceFeatures feature) const {
     return true;
   case DeviceFeatures::Multiview:
     return ctx_->vkPhysicalDeviceMultiviewFeatures_.multiview == VK_TRUE;
+  case DeviceFeatures::OcclusionQueries:
+    return true;
+  case DeviceFeatures::PipelineStatisticsQueries:
+    return ctx_->usePipelineStatistics_;
   case DeviceFeatures::BindUniform:
     return false;
   case DeviceFeatures::TexturePartialMipChain:
     return true;
+  case DeviceFeatures::TextureViews:
+    return true;
+  case DeviceFeatures::Timers:
+    return deviceProperties.limits.timestampComputeAndGraphics == VK_TRUE;
   case DeviceFeatures::BufferRing:
     return false;
   case DeviceFeatures::BufferNoCopy:
     return false;
   case DeviceFeatures::ShaderLibrary:
     return true;
+  // 16-bit storage buffer access is always enabled, see ivkCreateDevice()
+  case DeviceFeatures::ShaderFloat16:
+    return ctx_->vkPhysicalDeviceShaderFloat16Int8Features_.shaderFloat16 == VK_TRUE;
   case DeviceFeatures::BindBytes:
     return false;
   case DeviceFeatures::TextureArrayExt:
@@ -549,6 +1022,7 @@ bool Device::hasFeature(DeviceFeatures feature) const {
   case DeviceFeatures::SamplerMinMaxLod:
     return true;
   case DeviceFeatures::DrawIndexedIndirect:
+  case DeviceFeatures::DrawInstanced:
     return true;
   case DeviceFeatures::ValidationLayersEnabled:
     return ctx_->areValidationLayersEnabled();
@@ -7,23 +7,40 @@
 
 #pragma once
 
+#include <igl/DepthStencilState.h>
 #include <igl/Device.h>
 #include <igl/Shader.h>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/PlatformDevice.h>
+#include <igl/RenderPipelineState.h>
+#include <igl/SamplerState.h>
+#include <igl/StateObjectCache.h>
+#include <igl/VertexInputState.h>
 #include <igl/vulkan/VulkanSemaphore.h>
+#include <igl/vulkan/VulkanWorkerPool.h>
+#include <atomic>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace igl {
 namespace vulkan {
 
+class RenderPipelineState;
+class RenderPipelineVariants;
 class VulkanContext;
+class VulkanSampler;
 class VulkanShaderModule;
 struct DeviceQueues;
+struct RenderPipelineVariantDesc;
 
 class Device final : public IDevice {
  public:
   explicit Device(std::unique_ptr<VulkanContext> ctx);
+  ~Device() override;
 
   // Command Queue
   std::shared_ptr<ICommandQueue> createCommandQueue(const CommandQueueDesc& desc,
@@ -42,6 +59,9 @@ class Device final : public IDevice {
                                                     Result* outResult) const override;
   std::shared_ptr<ITexture> createTexture(const TextureDesc& desc,
                                           Result* outResult) const noexcept override;
+  std::shared_ptr<ITexture> createTextureView(std::shared_ptr<ITexture> texture,
+                                              const TextureViewDesc& desc,
+                                              Result* outResult) const noexcept override;
 
   std::shared_ptr<IVertexInputState> createVertexInputState(const VertexInputStateDesc& desc,
                                                             Result* outResult) const override;
@@ -51,6 +71,36 @@ class Device final : public IDevice {
                                                                Result* outResult) const override;
   std::shared_ptr<IRenderPipelineState> createRenderPipeline(const RenderPipelineDesc& desc,
                                                              Result* outResult) const override;
+  void createComputePipelineAsync(const ComputePipelineDesc& desc,
+                                  ComputePipelineCompletionHandler completionHandler) const override;
+
+  // Compiles the given variants of a render pipeline on a background thread, so the first draw
+  // call using them does not stall. Should be called on the rendering thread.
+  std::shared_future<void> warmUpRenderPipeline(
+      const std::shared_ptr<IRenderPipelineState>& pipelineState,
+      const std::vector<RenderPipelineVariantDesc>& variants) const;
+
+  struct RenderPipelineVariantStats {
+    // a VkPipeline was found in the variant cache when it was needed for a draw call
+    uint32_t hits = 0;
+    // a VkPipeline had to be compiled synchronously inside a draw call
+    uint32_t misses = 0;
+    // VkPipelines compiled ahead of time by warmUpRenderPipeline()
+    uint32_t warmedUp = 0;
+    // VkPipelines fast-linked from pipeline libraries (VK_EXT_graphics_pipeline_library)
+    uint32_t fastLinked = 0;
+    // fast-linked VkPipelines replaced by link-time optimized ones built on background threads
+    uint32_t optimized = 0;
+  };
+
+  RenderPipelineVariantStats getRenderPipelineVariantStats() const;
+
+  // Compiles the shader modules concurrently on worker threads and blocks until all of them are
+  // created. Every descriptor gets an entry in the returned vector, null if the module could not be
+  // created; `outResult` receives the first error.
+  std::vector<std::shared_ptr<IShaderModule>> createShaderModules(
+      const std::vector<ShaderModuleDesc>& descs,
+      Result* outResult) const;
 
   // Shaders
   std::unique_ptr<IShaderLibrary> createShaderLibrary(const ShaderLibraryDesc& desc,
@@ -62,6 +112,16 @@ class Device final : public IDevice {
   std::shared_ptr<IFramebuffer> createFramebuffer(const FramebufferDesc& desc,
                                                   Result* outResult) override;
 
+  std::shared_ptr<ITimer> createTimer(Result* outResult) const noexcept override;
+
+  std::shared_ptr<IQueryPool> createQueryPool(const QueryPoolDesc& desc,
+                                              Result* outResult) const noexcept override;
+
+  std::unique_ptr<IRingBuffer> createRingBuffer(const RingBufferDesc& desc,
+                                                Result* outResult) const noexcept override;
+
+  bool getMemoryStatistics(DeviceMemoryStatistics& outStatistics) const noexcept override;
+
   // Platform-specific extensions
   const PlatformDevice& getPlatformDevice() const noexcept override;
 
@@ -94,9 +154,48 @@ class Device final : public IDevice {
                                                          const std::string& debugName,
                                                          Result* outResult) const;
 
+  std::shared_ptr<RenderPipelineVariants> getRenderPipelineVariants(
+      const RenderPipelineDesc& desc) const;
+  // runs `task` on `workerPool_`; `keepAlive` is released on the thread destroying the device
+  std::shared_future<void> runTask(std::function<void()> task,
+                                   std::shared_ptr<void> keepAlive) const;
+
+ private:
+  friend class RenderPipelineState;
+
   std::unique_ptr<VulkanContext> ctx_;
 
   PlatformDevice platformDevice_;
+
+  // Tasks running on worker threads; all of them are waited for in the destructor. The objects
+  // used by a task are kept alive here, so they are released on the thread owning the device.
+  struct PendingTask {
+    std::shared_future<void> future;
+    std::shared_ptr<void> keepAlive;
+  };
+  mutable std::mutex pendingTasksMutex_;
+  mutable std::vector<PendingTask> pendingTasks_;
+  // bounds the number of threads used by background tasks, whatever the number of pipelines
+  mutable VulkanWorkerPool workerPool_;
+
+  // render pipeline variants shared between render pipeline states with equal descriptors
+  mutable std::mutex renderPipelineVariantsMutex_;
+  mutable std::unordered_map<RenderPipelineDesc, std::weak_ptr<RenderPipelineVariants>>
+      renderPipelineVariants_;
+  mutable std::atomic<uint32_t> pipelineVariantHits_ = 0;
+  mutable std::atomic<uint32_t> pipelineVariantMisses_ = 0;
+  mutable std::atomic<uint32_t> pipelineVariantsWarmedUp_ = 0;
+  mutable std::atomic<uint32_t> pipelineVariantsFastLinked_ = 0;
+  mutable std::atomic<uint32_t> pipelineVariantsOptimized_ = 0;
+
+  // VulkanSamplers shared between sampler states with equal descriptors: identical samplers take
+  // only one VkSampler and one slot of the bindless sampler array
+  mutable std::mutex samplersMutex_;
+  mutable std::unordered_map<SamplerStateDesc, std::weak_ptr<VulkanSampler>> samplers_;
+
+  // equal descriptors share one state object, see StateObjectCache
+  mutable StateObjectCache<DepthStencilStateDesc, IDepthStencilState> depthStencilStates_;
+  mutable StateObjectCache<VertexInputStateDesc, IVertexInputState> vertexInputStates_;
 };
 
 } // namespace vulkan
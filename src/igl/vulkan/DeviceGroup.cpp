@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/DeviceGroup.h>
+
+#include <igl/vulkan/Device.h>
+#include <igl/vulkan/HWDevice.h>
+#include <igl/vulkan/VulkanContext.h>
+
+namespace igl {
+namespace vulkan {
+
+std::unique_ptr<DeviceGroup> DeviceGroup::create(const VulkanContextConfig& config,
+                                                 const HWDeviceQueryDesc& queryDesc,
+                                                 Policy policy,
+                                                 Result* outResult) {
+  VulkanContextConfig groupConfig = config;
+  groupConfig.headless = true;
+  // the global Vulkan function pointers cannot be loaded for one of several devices
+  groupConfig.enableConcurrentVkDevicesSupport = true;
+
+  std::vector<std::unique_ptr<IDevice>> devices;
+
+  // physical device handles belong to the instance of a context, but every instance enumerates
+  // the devices in the same order
+  for (size_t i = 0;; i++) {
+    auto ctx = HWDevice::createContext(groupConfig, nullptr);
+    if (!ctx) {
+      Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create VulkanContext");
+      return nullptr;
+    }
+    const std::vector<HWDeviceDesc> descs = HWDevice::queryDevices(*ctx, queryDesc, outResult);
+    if (descs.empty()) {
+      return nullptr;
+    }
+    Result result;
+    auto device = HWDevice::create(std::move(ctx), descs[i], 0, 0, 0, nullptr, &result);
+    if (!result.isOk()) {
+      Result::setResult(outResult, std::move(result));
+      return nullptr;
+    }
+    devices.push_back(std::move(device));
+    if (devices.size() == descs.size()) {
+      break;
+    }
+  }
+
+  Result::setResult(outResult, Result());
+
+  return std::make_unique<DeviceGroup>(std::move(devices), policy);
+}
+
+DeviceGroup::DeviceGroup(std::vector<std::unique_ptr<IDevice>> devices, Policy policy) :
+  policy_(policy) {
+  IGL_ASSERT(!devices.empty());
+
+  devices_.reserve(devices.size());
+
+  for (auto& device : devices) {
+    IGL_ASSERT(device && device->getBackendType() == BackendType::Vulkan);
+    DeviceEntry entry;
+    entry.queue = device->createCommandQueue({CommandQueueType::Graphics}, nullptr);
+    entry.device = std::move(device);
+    devices_.push_back(std::move(entry));
+  }
+}
+
+DeviceGroup::~DeviceGroup() {
+  waitIdle();
+}
+
+void DeviceGroup::setDeviceWeight(size_t deviceIndex, float weight) {
+  IGL_ASSERT(weight > 0.0f);
+  devices_[deviceIndex].weight = weight;
+}
+
+size_t DeviceGroup::getNumPendingJobs(size_t deviceIndex) {
+  retireFinishedJobs(deviceIndex);
+  return devices_[deviceIndex].pendingJobs.size();
+}
+
+DeviceGroup::Job DeviceGroup::dispatch(const RecordFunc& record) {
+  return dispatchTo(chooseDevice(), record);
+}
+
+DeviceGroup::Job DeviceGroup::dispatchTo(size_t deviceIndex, const RecordFunc& record) {
+  IGL_PROFILER_FUNCTION();
+
+  DeviceEntry& entry = devices_[deviceIndex];
+
+  Job job;
+  job.deviceIndex = deviceIndex;
+
+  Result result;
+  job.commandBuffer = entry.queue->createCommandBuffer({}, &result);
+  if (!IGL_VERIFY(result.isOk())) {
+    return job;
+  }
+
+  record(*entry.device, *job.commandBuffer, deviceIndex);
+
+  job.handle = entry.queue->submit(*job.commandBuffer);
+  if (job.handle) {
+    entry.pendingJobs.push_back(job.handle);
+  }
+
+  return job;
+}
+
+void DeviceGroup::waitIdle() {
+  for (auto& entry : devices_) {
+    static_cast<Device&>(*entry.device).getVulkanContext().waitIdle();
+    entry.pendingJobs.clear();
+  }
+}
+
+size_t DeviceGroup::chooseDevice() {
+  if (policy_ == Policy::RoundRobin) {
+    const size_t deviceIndex = nextDevice_;
+    nextDevice_ = (nextDevice_ + 1) % devices_.size();
+    return deviceIndex;
+  }
+
+  // start the search after the last chosen device, so idle devices take turns
+  size_t bestIndex = nextDevice_;
+  float bestLoad = 0.0f;
+
+  for (size_t i = 0; i != devices_.size(); i++) {
+    const size_t deviceIndex = (nextDevice_ + i) % devices_.size();
+    const float load = float(getNumPendingJobs(deviceIndex)) / devices_[deviceIndex].weight;
+    if (i == 0 || load < bestLoad) {
+      bestIndex = deviceIndex;
+      bestLoad = load;
+    }
+  }
+
+  nextDevice_ = (bestIndex + 1) % devices_.size();
+
+  return bestIndex;
+}
+
+void DeviceGroup::retireFinishedJobs(size_t deviceIndex) {
+  DeviceEntry& entry = devices_[deviceIndex];
+
+  const VulkanContext& ctx = static_cast<Device&>(*entry.device).getVulkanContext();
+
+  while (!entry.pendingJobs.empty() &&
+         ctx.immediate_->isReady(
+             VulkanImmediateCommands::SubmitHandle(entry.pendingJobs.front()))) {
+    entry.pendingJobs.pop_front();
+  }
+}
+
+} // namespace vulkan
+} // namespace igl
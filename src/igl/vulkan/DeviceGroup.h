@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <igl/CommandQueue.h>
+#include <igl/Device.h>
+#include <igl/HWDevice.h>
+
+namespace igl {
+namespace vulkan {
+
+struct VulkanContextConfig;
+
+/**
+ * @brief Distributes offscreen work over several Vulkan devices, e.g. all GPUs of a render farm
+ * node. Every device has its own headless context (see VulkanContextConfig::headless) and a
+ * graphics command queue. A job records a command buffer of the device chosen by the scheduling
+ * policy and is submitted right away.
+ *
+ * Resources belong to one device: jobs which use resources of a specific device should be
+ * dispatched with dispatchTo(). Not thread-safe, dispatch all jobs from one thread.
+ */
+class DeviceGroup final {
+ public:
+  enum class Policy {
+    // devices take turns
+    RoundRobin,
+    // the device with the fewest unfinished jobs relative to its weight
+    LeastLoaded,
+  };
+
+  struct Job {
+    size_t deviceIndex = 0;
+    SubmitHandle handle = 0;
+    // can be used to wait for the job
+    std::shared_ptr<ICommandBuffer> commandBuffer;
+  };
+
+  // records the job into `commandBuffer` of `device`, which is the device `deviceIndex`
+  using RecordFunc =
+      std::function<void(IDevice& device, ICommandBuffer& commandBuffer, size_t deviceIndex)>;
+
+  /**
+   * @brief Creates a headless device for every physical device matching `queryDesc`. Contexts
+   * are created with `config`, `headless` and `enableConcurrentVkDevicesSupport` are always set.
+   */
+  static std::unique_ptr<DeviceGroup> create(const VulkanContextConfig& config,
+                                             const HWDeviceQueryDesc& queryDesc,
+                                             Policy policy = Policy::LeastLoaded,
+                                             Result* outResult = nullptr);
+
+  DeviceGroup(std::vector<std::unique_ptr<IDevice>> devices, Policy policy);
+  ~DeviceGroup();
+
+  DeviceGroup(const DeviceGroup&) = delete;
+  DeviceGroup& operator=(const DeviceGroup&) = delete;
+
+  size_t getNumDevices() const {
+    return devices_.size();
+  }
+  IDevice& getDevice(size_t deviceIndex) const {
+    return *devices_[deviceIndex].device;
+  }
+
+  /// Relative throughput of a device used by Policy::LeastLoaded, 1 by default. A device with
+  /// weight 2 gets twice as many unfinished jobs as a device with weight 1
+  void setDeviceWeight(size_t deviceIndex, float weight);
+
+  /// The number of submitted jobs of the device which the GPU has not finished yet
+  size_t getNumPendingJobs(size_t deviceIndex);
+
+  /// Records and submits a job on the device chosen by the scheduling policy
+  Job dispatch(const RecordFunc& record);
+  /// Records and submits a job on a specific device
+  Job dispatchTo(size_t deviceIndex, const RecordFunc& record);
+
+  /// Waits until all devices have finished their jobs
+  void waitIdle();
+
+ private:
+  size_t chooseDevice();
+  void retireFinishedJobs(size_t deviceIndex);
+
+ private:
+  struct DeviceEntry {
+    std::unique_ptr<IDevice> device;
+    std::shared_ptr<ICommandQueue> queue;
+    float weight = 1.0f;
+    // submit handles of unfinished jobs, oldest first
+    std::deque<SubmitHandle> pendingJobs;
+  };
+
+  std::vector<DeviceEntry> devices_;
+  Policy policy_ = Policy::LeastLoaded;
+  size_t nextDevice_ = 0;
+};
+
+} // namespace vulkan
+} // namespace igl
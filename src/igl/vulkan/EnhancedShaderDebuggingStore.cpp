@@ -25,6 +25,7 @@
 namespace igl {
 namespace vulkan {
 
+#if IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
 EnhancedShaderDebuggingStore::EnhancedShaderDebuggingStore() {
 #if !IGL_PLATFORM_ANDROID
   enabled_ = true;
@@ -34,6 +35,7 @@ EnhancedShaderDebuggingStore::EnhancedShaderDebuggingStore() {
 void EnhancedShaderDebuggingStore::initialize(const igl::vulkan::Device* device) {
   device_ = device;
 }
+#endif // IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
 
 std::string EnhancedShaderDebuggingStore::recordLineShaderCode(bool includeFunctionBody,
                                                                const VulkanExtensions& extensions) {
@@ -75,8 +77,14 @@ std::string EnhancedShaderDebuggingStore::recordLineShaderCode(bool includeFunct
   };
 
   void drawLine(vec3 v0, vec3 v1, vec4 color0, vec4 color1, mat4 transform) {
-    LinesWithHeader lines = LinesWithHeader(getBuffer()" +
-         bufferIndex + R"());
+    // the lines buffer is not bound for draw calls which are not instrumented
+    const uvec2 address = getBuffer()" +
+         bufferIndex + R"();
+    if (address == uvec2(0)) {
+      return;
+    }
+
+    LinesWithHeader lines = LinesWithHeader(address);
 
     const uint index = atomicAdd(lines.command.instanceCount, 1);
 
@@ -94,6 +102,7 @@ std::string EnhancedShaderDebuggingStore::recordLineShaderCode(bool includeFunct
   })";
 }
 
+#if IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
 void EnhancedShaderDebuggingStore::initializeBuffer() const {
   IGL_ASSERT_MSG(device_ != nullptr,
                  "Device is null. This object needs to be initialized to be used");
@@ -311,14 +320,13 @@ void EnhancedShaderDebuggingStore::installBufferBarrier(
   if (enabled_) {
     auto cmdBuffer = static_cast<const vulkan::CommandBuffer*>(&commandBuffer);
     auto* buffer = static_cast<vulkan::Buffer*>(vertexBuffer().get());
-    ivkBufferMemoryBarrier(cmdBuffer->getVkCommandBuffer(),
-                           buffer->getVkBuffer(),
-                           VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, /* src access flag */
-                           VK_ACCESS_INDIRECT_COMMAND_READ_BIT, /* dst access flag */
-                           0,
-                           VK_WHOLE_SIZE,
-                           VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                           VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT);
+    cmdBuffer->getBarrierBatch().bufferBarrier(buffer->getVkBuffer(),
+                                               VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, /* src */
+                                               VK_ACCESS_INDIRECT_COMMAND_READ_BIT, /* dst */
+                                               buffer->getVkBufferOffset(),
+                                               buffer->getSizeInBytes(),
+                                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                               VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT);
   }
 }
 
@@ -345,6 +353,7 @@ uint64_t EnhancedShaderDebuggingStore::hashFramebufferFormats(
 
   return hashValue;
 }
+#endif // IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
 
 } // namespace vulkan
 } // namespace igl
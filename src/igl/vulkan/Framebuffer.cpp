@@ -7,6 +7,8 @@
 
 #include "Framebuffer.h"
 
+#include <array>
+
 #include <igl/CommandBuffer.h>
 #include <igl/RenderPass.h>
 #include <igl/vulkan/Buffer.h>
@@ -22,6 +24,7 @@
 #include <igl/vulkan/Texture.h>
 #include <igl/vulkan/VertexInputState.h>
 #include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanDescriptorSetLayout.h>
 #include <igl/vulkan/VulkanDevice.h>
 #include <igl/vulkan/VulkanFramebuffer.h>
 #include <igl/vulkan/VulkanImage.h>
@@ -99,7 +102,9 @@ void Framebuffer::copyBytesColorAttachment(ICommandQueue& /* Not Used */,
                                      imageRegion,
                                      vkTex.getProperties(),
                                      VK_FORMAT_R8G8B8A8_UNORM,
-                                     vkTex.getVulkanTexture().getVulkanImage().imageLayout_,
+                                     vkTex.getVulkanTexture().getVulkanImage().getImageLayout(
+                                         static_cast<uint32_t>(range.mipLevel),
+                                         static_cast<uint32_t>(range.layer)),
                                      pixelBytes,
                                      static_cast<uint32_t>(bytesPerRow),
                                      true); // Flip the image vertically
@@ -156,6 +161,9 @@ void Framebuffer::copyTextureColorAttachment(ICommandQueue& cmdQueue,
                         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, // Don't wait for anything
                         VK_PIPELINE_STAGE_TRANSFER_BIT,
                         VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1});
+  dstVkTex.getVulkanTexture().getVulkanImage().setImageLayout(
+      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+      VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1});
 
   // 2. Transition src into TRANSFER_SRC_OPTIMAL
   srcVkTex.getVulkanTexture().getVulkanImage().transitionLayout(
@@ -213,6 +221,14 @@ std::shared_ptr<igl::ITexture> Framebuffer::updateDrawable(std::shared_ptr<IText
   return texture;
 }
 
+void Framebuffer::updateFragmentDensityMap(std::shared_ptr<ITexture> texture) {
+  if (texture && !device_.getVulkanContext().hasFragmentDensityMap()) {
+    IGL_LOG_INFO_ONCE("VK_EXT_fragment_density_map is not supported. Ignoring the density map\n");
+    return;
+  }
+  desc_.fragmentDensityMap = std::move(texture);
+}
+
 Framebuffer::Framebuffer(const Device& device, FramebufferDesc desc) :
   device_(device), desc_(std::move(desc)) {
   IGL_PROFILER_FUNCTION();
@@ -249,9 +265,14 @@ Framebuffer::Framebuffer(const Device& device, FramebufferDesc desc) :
 
   IGL_ASSERT(width_);
   IGL_ASSERT(height_);
+
+  // the density map is smaller than the attachments and does not participate in their size
+  updateFragmentDensityMap(std::move(desc_.fragmentDensityMap));
 }
 
-VkFramebuffer Framebuffer::getVkFramebuffer(uint32_t mipLevel, VkRenderPass pass) const {
+VkFramebuffer Framebuffer::getVkFramebuffer(uint32_t mipLevel,
+                                            uint32_t layer,
+                                            VkRenderPass pass) const {
   IGL_PROFILER_FUNCTION();
   // Because Vulkan framebuffers are immutable and we have a method updateDrawable() which can
   // change an attachment, we have to maintain a collection of attachments and map it into a
@@ -276,20 +297,21 @@ VkFramebuffer Framebuffer::getVkFramebuffer(uint32_t mipLevel, VkRenderPass pass
 
     const auto& colorTexture = static_cast<vulkan::Texture&>(*it->second.texture);
     attachments.attachments_.push_back(
-        colorTexture.getVkImageViewForFramebuffer(mipLevel, desc_.mode));
+        colorTexture.getVkImageViewForFramebuffer(mipLevel, layer, desc_.mode));
     // handle color MSAA
     if (it->second.resolveTexture) {
       IGL_ASSERT(mipLevel == 0);
       const auto& colorResolveTexture = static_cast<vulkan::Texture&>(*it->second.resolveTexture);
       attachments.attachments_.push_back(
-          colorResolveTexture.getVkImageViewForFramebuffer(0, desc_.mode));
+          colorResolveTexture.getVkImageViewForFramebuffer(0, layer, desc_.mode));
     }
   }
   // depth
   {
     const auto* depthTexture = static_cast<vulkan::Texture*>(desc_.depthAttachment.texture.get());
     if (depthTexture) {
-      attachments.attachments_.push_back(depthTexture->getVkImageViewForFramebuffer(0, desc_.mode));
+      attachments.attachments_.push_back(
+          depthTexture->getVkImageViewForFramebuffer(0, layer, desc_.mode));
     }
   }
   // handle depth MSAA
@@ -298,7 +320,15 @@ VkFramebuffer Framebuffer::getVkFramebuffer(uint32_t mipLevel, VkRenderPass pass
         static_cast<vulkan::Texture*>(desc_.depthAttachment.resolveTexture.get());
     if (depthResolveTexture) {
       attachments.attachments_.push_back(
-          depthResolveTexture->getVkImageViewForFramebuffer(0, desc_.mode));
+          depthResolveTexture->getVkImageViewForFramebuffer(0, layer, desc_.mode));
+    }
+  }
+  // fragment density map
+  {
+    const auto* densityMap = static_cast<vulkan::Texture*>(desc_.fragmentDensityMap.get());
+    if (densityMap) {
+      attachments.attachments_.push_back(
+          densityMap->getVkImageViewForFramebuffer(0, layer, desc_.mode));
     }
   }
 
@@ -328,6 +358,92 @@ VkFramebuffer Framebuffer::getVkFramebuffer(uint32_t mipLevel, VkRenderPass pass
   return fb->getVkFramebuffer();
 }
 
+Framebuffer::~Framebuffer() {
+  if (inputAttachments_.empty()) {
+    return;
+  }
+  const VulkanContext& ctx = device_.getVulkanContext();
+  std::vector<VkDescriptorPool> pools;
+  pools.reserve(inputAttachments_.size());
+  for (const auto& it : inputAttachments_) {
+    pools.push_back(it.second.pool);
+  }
+  // the descriptor sets can still be used by command buffers in flight
+  ctx.deferredTask(
+      std::packaged_task<void()>([device = ctx.getVkDevice(), pools = std::move(pools)]() {
+        for (VkDescriptorPool pool : pools) {
+          vkDestroyDescriptorPool(device, pool, nullptr);
+        }
+      }));
+}
+
+VkDescriptorSet Framebuffer::getInputAttachmentsDescriptorSet(uint32_t mipLevel,
+                                                              uint32_t layer) const {
+  IGL_PROFILER_FUNCTION();
+
+  const VulkanContext& ctx = device_.getVulkanContext();
+
+  if (!IGL_VERIFY(ctx.dslInputAttachments_)) {
+    return VK_NULL_HANDLE;
+  }
+
+  Attachments attachments;
+
+  size_t largestIndexPlusOne = 0;
+  for (const auto& attachment : desc_.colorAttachments) {
+    largestIndexPlusOne = std::max(largestIndexPlusOne, attachment.first + 1);
+  }
+
+  // same order as the color attachments of the render pass, see RenderCommandEncoder::initialize()
+  for (size_t i = 0; i < largestIndexPlusOne; ++i) {
+    auto it = desc_.colorAttachments.find(i);
+    if (it == desc_.colorAttachments.end()) {
+      continue;
+    }
+    IGL_ASSERT(it->second.texture);
+    const auto& colorTexture = static_cast<vulkan::Texture&>(*it->second.texture);
+    attachments.attachments_.push_back(
+        colorTexture.getVkImageViewForFramebuffer(mipLevel, layer, desc_.mode));
+  }
+
+  IGL_ASSERT(attachments.attachments_.size() <= IGL_COLOR_ATTACHMENTS_MAX);
+
+  auto it = inputAttachments_.find(attachments);
+
+  if (it != inputAttachments_.end()) {
+    return it->second.ds;
+  }
+
+  const VkDevice device = ctx.getVkDevice();
+
+  InputAttachments entry;
+
+  const VkDescriptorPoolSize poolSize = {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,
+                                         IGL_COLOR_ATTACHMENTS_MAX};
+  VK_ASSERT(ivkCreateDescriptorPool(device, 1, 1, &poolSize, &entry.pool));
+  VK_ASSERT(ivkAllocateDescriptorSet(
+      device, entry.pool, ctx.dslInputAttachments_->getVkDescriptorSetLayout(), &entry.ds));
+
+  std::array<VkDescriptorImageInfo, IGL_COLOR_ATTACHMENTS_MAX> infos = {};
+  std::vector<VkWriteDescriptorSet> writes;
+  writes.reserve(attachments.attachments_.size());
+
+  for (uint32_t i = 0; i != attachments.attachments_.size(); i++) {
+    // the render pass keeps attachments read by framebuffer fetch in the general layout
+    infos[i] = {VK_NULL_HANDLE, attachments.attachments_[i], VK_IMAGE_LAYOUT_GENERAL};
+    writes.push_back(ivkGetWriteDescriptorSet_ImageInfo(
+        entry.ds, i, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1, &infos[i]));
+  }
+
+  if (!writes.empty()) {
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+  }
+
+  inputAttachments_[attachments] = entry;
+
+  return entry.ds;
+}
+
 uint64_t Framebuffer::HashFunction::operator()(const Attachments& attachments) const {
   uint64_t hash = 0;
 
@@ -340,13 +456,14 @@ uint64_t Framebuffer::HashFunction::operator()(const Attachments& attachments) c
 
 VkRenderPassBeginInfo Framebuffer::getRenderPassBeginInfo(VkRenderPass renderPass,
                                                           uint32_t mipLevel,
+                                                          uint32_t layer,
                                                           uint32_t numClearValues,
                                                           const VkClearValue* clearValues) const {
   VkRenderPassBeginInfo bi = {};
   bi.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
   bi.pNext = nullptr;
   bi.renderPass = renderPass;
-  bi.framebuffer = getVkFramebuffer(mipLevel, renderPass);
+  bi.framebuffer = getVkFramebuffer(mipLevel, layer, renderPass);
   bi.renderArea =
       VkRect2D{VkOffset2D{0, 0},
                VkExtent2D{std::max(width_ >> mipLevel, 1u), std::max(height_ >> mipLevel, 1u)}};
@@ -21,7 +21,7 @@ class VulkanFramebuffer;
 class Framebuffer final : public IFramebuffer {
  public:
   Framebuffer(const Device& device, FramebufferDesc desc);
-  ~Framebuffer() override = default;
+  ~Framebuffer() override;
 
   // Accessors
   std::vector<size_t> getColorAttachmentIndices() const override;
@@ -55,7 +55,14 @@ class Framebuffer final : public IFramebuffer {
 
   std::shared_ptr<ITexture> updateDrawable(std::shared_ptr<ITexture> texture) override;
 
-  VkFramebuffer getVkFramebuffer(uint32_t mipLevel, VkRenderPass pass) const;
+  void updateFragmentDensityMap(std::shared_ptr<ITexture> texture) override;
+
+  VkFramebuffer getVkFramebuffer(uint32_t mipLevel, uint32_t layer, VkRenderPass pass) const;
+
+  // Returns the descriptor set #2 of graphics pipelines which exposes the color attachments as
+  // input attachments to framebuffer fetch (RenderPassDesc::framebufferFetch). The attachments are
+  // bound in the same order as the color attachments of the render pass
+  VkDescriptorSet getInputAttachmentsDescriptorSet(uint32_t mipLevel, uint32_t layer) const;
 
   uint32_t getWidth() const {
     return width_;
@@ -70,6 +77,7 @@ class Framebuffer final : public IFramebuffer {
 
   VkRenderPassBeginInfo getRenderPassBeginInfo(VkRenderPass renderPass,
                                                uint32_t mipLevel,
+                                               uint32_t layer,
                                                uint32_t numClearValues,
                                                const VkClearValue* clearValues) const;
 
@@ -92,6 +100,12 @@ class Framebuffer final : public IFramebuffer {
   uint32_t height_ = 0;
   mutable std::unordered_map<Attachments, std::shared_ptr<VulkanFramebuffer>, HashFunction>
       framebuffers_;
+  // keyed by the color attachments only; every descriptor set has its own small pool
+  struct InputAttachments {
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    VkDescriptorSet ds = VK_NULL_HANDLE;
+  };
+  mutable std::unordered_map<Attachments, InputAttachments, HashFunction> inputAttachments_;
 };
 
 } // namespace vulkan
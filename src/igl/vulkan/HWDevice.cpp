@@ -50,7 +50,8 @@ std::unique_ptr<IDevice> HWDevice::create(std::unique_ptr<VulkanContext> ctx,
     return nullptr;
   }
 
-  if (width > 0 && height > 0) {
+  // headless contexts render offscreen only
+  if (width > 0 && height > 0 && ctx->hasSurface()) {
     result = ctx->initSwapchain(width, height);
 
     Result::setResult(outResult, result);
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/ParallelRenderCommandEncoder.h>
+
+#include <igl/vulkan/Buffer.h>
+
+namespace igl {
+namespace vulkan {
+
+ParallelRenderCommandEncoder::ParallelRenderCommandEncoder(
+    const std::shared_ptr<CommandBuffer>& commandBuffer,
+    const VulkanContext& ctx) :
+  IParallelRenderCommandEncoder::IParallelRenderCommandEncoder(commandBuffer),
+  ctx_(ctx),
+  commandBuffer_(commandBuffer) {
+  IGL_PROFILER_FUNCTION();
+  IGL_ASSERT(commandBuffer);
+}
+
+std::unique_ptr<ParallelRenderCommandEncoder> ParallelRenderCommandEncoder::create(
+    const std::shared_ptr<CommandBuffer>& commandBuffer,
+    const VulkanContext& ctx,
+    const RenderPassDesc& renderPass,
+    const std::shared_ptr<IFramebuffer>& framebuffer,
+    Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+
+  Result ret;
+
+  std::unique_ptr<ParallelRenderCommandEncoder> encoder(
+      new ParallelRenderCommandEncoder(commandBuffer, ctx));
+  encoder->primary_ = RenderCommandEncoder::create(commandBuffer,
+                                                   ctx,
+                                                   renderPass,
+                                                   framebuffer,
+                                                   &ret,
+                                                   VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+  encoder->isEncoding_ = ret.isOk();
+
+  Result::setResult(outResult, ret);
+  return ret.isOk() ? std::move(encoder) : nullptr;
+}
+
+std::unique_ptr<IRenderCommandEncoder> ParallelRenderCommandEncoder::createRenderCommandEncoder(
+    Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+
+  if (!IGL_VERIFY(isEncoding_)) {
+    Result::setResult(outResult,
+                      Result::Code::InvalidOperation,
+                      "The parallel render command encoder is not encoding");
+    return nullptr;
+  }
+
+  // acquire outside of the lock: allocating a new pool does not touch this encoder
+  VulkanContext::SecondaryCommandBuffer buffer = ctx_.acquireSecondaryCommandBuffer();
+  const VkCommandBuffer cmdBuf = buffer.cmdBuf;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  buffers_.push_back(std::move(buffer));
+
+  Result ret;
+  auto encoder =
+      RenderCommandEncoder::createSecondary(commandBuffer_, ctx_, *primary_, cmdBuf, &ret);
+
+  if (!encoder) {
+    Result::setResult(outResult, ret);
+    return nullptr;
+  }
+
+  cmdBufs_.push_back(cmdBuf);
+
+  for (const auto& l : debugLabels_) {
+    encoder->pushDebugGroupLabel(l.label, l.color);
+  }
+  encoder->numInheritedDebugLabels_ = static_cast<uint32_t>(debugLabels_.size());
+
+  for (const auto& l : pendingDebugEvents_) {
+    encoder->insertDebugEventLabel(l.label, l.color);
+  }
+  pendingDebugEvents_.clear();
+
+  if (!ctx_.config_.enhancedShaderDebuggingSampled) {
+    encoder->setShaderDebuggingEnabled(true);
+  }
+
+  Result::setOk(outResult);
+  return encoder;
+}
+
+void ParallelRenderCommandEncoder::endEncoding() {
+  IGL_PROFILER_FUNCTION();
+
+  if (!isEncoding_) {
+    return;
+  }
+
+  isEncoding_ = false;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (!cmdBufs_.empty()) {
+    vkCmdExecuteCommands(
+        primary_->getVkCommandBuffer(), (uint32_t)cmdBufs_.size(), cmdBufs_.data());
+  }
+
+  primary_->endEncoding();
+
+  // the secondary command buffers can be reused once the primary one has been processed by GPU
+  const VulkanImmediateCommands::SubmitHandle handle = commandBuffer_->getSubmitHandle();
+
+  for (auto& buf : buffers_) {
+    ctx_.releaseSecondaryCommandBuffer(std::move(buf), handle);
+  }
+
+  buffers_.clear();
+  cmdBufs_.clear();
+}
+
+void ParallelRenderCommandEncoder::pushDebugGroupLabel(const std::string& label,
+                                                       const igl::Color& color) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  debugLabels_.push_back({label, color});
+}
+
+void ParallelRenderCommandEncoder::insertDebugEventLabel(const std::string& label,
+                                                         const igl::Color& color) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  pendingDebugEvents_.push_back({label, color});
+}
+
+void ParallelRenderCommandEncoder::popDebugGroupLabel() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  IGL_ASSERT(!debugLabels_.empty());
+  if (!debugLabels_.empty()) {
+    debugLabels_.pop_back();
+  }
+}
+
+} // namespace vulkan
+} // namespace igl
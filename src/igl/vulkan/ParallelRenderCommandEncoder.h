@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include <igl/Common.h>
+#include <igl/ParallelRenderCommandEncoder.h>
+#include <igl/vulkan/CommandBuffer.h>
+#include <igl/vulkan/RenderCommandEncoder.h>
+#include <igl/vulkan/VulkanContext.h>
+
+namespace igl {
+namespace vulkan {
+
+/**
+ * @brief Begins a render pass with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS on the primary
+ * command buffer. Every child encoder records into its own secondary command buffer. The secondary
+ * command buffers are executed in creation order by endEncoding().
+ */
+class ParallelRenderCommandEncoder final : public IParallelRenderCommandEncoder {
+ public:
+  static std::unique_ptr<ParallelRenderCommandEncoder> create(
+      const std::shared_ptr<CommandBuffer>& commandBuffer,
+      const VulkanContext& ctx,
+      const RenderPassDesc& renderPass,
+      const std::shared_ptr<IFramebuffer>& framebuffer,
+      Result* outResult);
+
+  ~ParallelRenderCommandEncoder() override {
+    IGL_ASSERT(!isEncoding_); // did you forget to call endEncoding()?
+    endEncoding();
+  }
+
+  std::unique_ptr<IRenderCommandEncoder> createRenderCommandEncoder(Result* outResult) override;
+
+  void endEncoding() override;
+
+  // Secondary command buffers cannot be interleaved with other commands inside the render pass.
+  // Debug labels are replayed into every child encoder created afterwards instead.
+  void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
+  void insertDebugEventLabel(const std::string& label, const igl::Color& color) const override;
+  void popDebugGroupLabel() const override;
+
+ private:
+  ParallelRenderCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer,
+                               const VulkanContext& ctx);
+
+ private:
+  struct DebugLabel {
+    std::string label;
+    igl::Color color;
+  };
+
+  const VulkanContext& ctx_;
+  std::shared_ptr<CommandBuffer> commandBuffer_;
+  std::unique_ptr<RenderCommandEncoder> primary_;
+  bool isEncoding_ = false;
+
+  mutable std::mutex mutex_;
+  // all secondary command buffers acquired by this encoder
+  std::vector<VulkanContext::SecondaryCommandBuffer> buffers_;
+  // secondary command buffers of successfully created child encoders, in creation order
+  std::vector<VkCommandBuffer> cmdBufs_;
+  mutable std::vector<DebugLabel> debugLabels_;
+  mutable std::vector<DebugLabel> pendingDebugEvents_;
+};
+
+} // namespace vulkan
+} // namespace igl
@@ -5,11 +5,13 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <glm/gtc/matrix_transform.hpp>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/Device.h>
 #include <igl/vulkan/PlatformDevice.h>
 #include <igl/vulkan/Texture.h>
 #include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
 #include <igl/vulkan/VulkanSwapchain.h>
 
 namespace igl {
@@ -147,6 +149,159 @@ void PlatformDevice::waitOnSubmitHandle(SubmitHandle handle) const {
   immediateCommands->wait(VulkanImmediateCommands::SubmitHandle(handle));
 }
 
+glm::mat4 PlatformDevice::getPreRotationMatrix() const {
+  const auto& ctx = device_.getVulkanContext();
+
+  if (!ctx.hasSwapchain()) {
+    return glm::mat4(1.0f);
+  }
+
+  float angle = 0.0f;
+
+  switch (ctx.swapchain_->getPreTransform()) {
+  case VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR:
+    angle = 90.0f;
+    break;
+  case VK_SURFACE_TRANSFORM_ROTATE_180_BIT_KHR:
+    angle = 180.0f;
+    break;
+  case VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR:
+    angle = 270.0f;
+    break;
+  default:
+    // mirrored transforms are not used by Android compositors
+    break;
+  }
+
+  return glm::rotate(glm::mat4(1.0f), glm::radians(angle), glm::vec3(0.0f, 0.0f, 1.0f));
+}
+
+#if IGL_PLATFORM_ANDROID && defined(VK_ANDROID_external_memory_android_hardware_buffer)
+std::shared_ptr<ITexture> PlatformDevice::createTextureFromNativeHardwareBuffer(
+    AHardwareBuffer* hardwareBuffer,
+    Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+
+  if (hardwareBuffer == nullptr) {
+    Result::setResult(outResult, Result::Code::ArgumentNull, "Hardware buffer is null");
+    return nullptr;
+  }
+
+  const auto& ctx = device_.getVulkanContext();
+  if (!ctx.useHardwareBufferImport_) {
+    Result::setResult(outResult,
+                      Result::Code::Unsupported,
+                      "VK_ANDROID_external_memory_android_hardware_buffer is not supported");
+    return nullptr;
+  }
+
+  AHardwareBuffer_Desc bufferDesc = {};
+  AHardwareBuffer_describe(hardwareBuffer, &bufferDesc);
+  if ((bufferDesc.usage & AHARDWAREBUFFER_USAGE_GPU_SAMPLED_IMAGE) == 0) {
+    Result::setResult(
+        outResult, Result::Code::ArgumentInvalid, "Hardware buffer cannot be sampled by the GPU");
+    return nullptr;
+  }
+  if (bufferDesc.layers != 1) {
+    Result::setResult(outResult,
+                      Result::Code::Unsupported,
+                      "Hardware buffers with several layers are not supported");
+    return nullptr;
+  }
+
+  VkDevice vkDevice = ctx.device_->getVkDevice();
+  VkAndroidHardwareBufferFormatPropertiesANDROID formatProperties = {
+      VK_STRUCTURE_TYPE_ANDROID_HARDWARE_BUFFER_FORMAT_PROPERTIES_ANDROID};
+  VkAndroidHardwareBufferPropertiesANDROID properties = {
+      VK_STRUCTURE_TYPE_ANDROID_HARDWARE_BUFFER_PROPERTIES_ANDROID, &formatProperties};
+  if (vkGetAndroidHardwareBufferPropertiesANDROID(vkDevice, hardwareBuffer, &properties) !=
+      VK_SUCCESS) {
+    Result::setResult(
+        outResult, Result::Code::RuntimeError, "Cannot get the hardware buffer properties");
+    return nullptr;
+  }
+
+  // External formats can only be sampled through immutable samplers with a
+  // VkSamplerYcbcrConversion, which the bindless descriptor sets don't have
+  const auto iglFormat = vkFormatToTextureFormat(formatProperties.format);
+  if (formatProperties.format == VK_FORMAT_UNDEFINED || iglFormat == TextureFormat::Invalid) {
+    Result::setResult(
+        outResult, Result::Code::Unsupported, "Hardware buffer format is not supported");
+    return nullptr;
+  }
+
+  TextureDesc::TextureUsage usage = TextureDesc::TextureUsageBits::Sampled;
+  VkImageUsageFlags usageFlags = VK_IMAGE_USAGE_SAMPLED_BIT;
+  if ((bufferDesc.usage & AHARDWAREBUFFER_USAGE_GPU_FRAMEBUFFER) != 0) {
+    usage |= TextureDesc::TextureUsageBits::Attachment;
+    usageFlags |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+  }
+
+  auto image = std::make_shared<VulkanImage>(ctx,
+                                             hardwareBuffer,
+                                             properties,
+                                             vkDevice,
+                                             VkExtent3D{bufferDesc.width, bufferDesc.height, 1},
+                                             formatProperties.format,
+                                             1,
+                                             usageFlags,
+                                             "Image: hardware buffer");
+  auto imageView = image->createImageView(VK_IMAGE_VIEW_TYPE_2D,
+                                          formatProperties.format,
+                                          VK_IMAGE_ASPECT_COLOR_BIT,
+                                          0,
+                                          VK_REMAINING_MIP_LEVELS,
+                                          0,
+                                          1,
+                                          "Image View: hardware buffer");
+  if (!IGL_VERIFY(imageView)) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create VulkanImageView");
+    return nullptr;
+  }
+
+  // Acquire the buffer from its producer. The transition from VK_IMAGE_LAYOUT_UNDEFINED keeps the
+  // contents since it is part of the ownership transfer from the foreign queue family.
+  const VkImageSubresourceRange range = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+  const VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                                        nullptr,
+                                        0,
+                                        VK_ACCESS_SHADER_READ_BIT,
+                                        VK_IMAGE_LAYOUT_UNDEFINED,
+                                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                        VK_QUEUE_FAMILY_FOREIGN_EXT,
+                                        ctx.deviceQueues_.graphicsQueueFamilyIndex,
+                                        image->getVkImage(),
+                                        range};
+  const auto& wrapper = ctx.immediate_->acquire();
+  vkCmdPipelineBarrier(wrapper.cmdBuf_,
+                       VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr,
+                       1,
+                       &barrier);
+  ctx.immediate_->submit(wrapper);
+  image->setImageLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, range);
+
+  const TextureDesc desc = TextureDesc::new2D(
+      iglFormat, bufferDesc.width, bufferDesc.height, usage, "Hardware Buffer Texture");
+  Result result;
+  std::shared_ptr<VulkanTexture> vkTexture =
+      ctx.createTexture(std::move(image), std::move(imageView), &result);
+  if (!result.isOk()) {
+    Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+  auto texture = std::make_shared<igl::vulkan::Texture>(device_, std::move(vkTexture), desc);
+
+  Result::setResult(outResult, Result::Code::Ok);
+  return texture;
+}
+#endif // IGL_PLATFORM_ANDROID && VK_ANDROID_external_memory_android_hardware_buffer
+
 #if defined(IGL_PLATFORM_ANDROID) && defined(VK_KHR_external_fence_fd)
 int PlatformDevice::getFenceFdFromSubmitHandle(SubmitHandle handle) const {
   if (handle == 0) {
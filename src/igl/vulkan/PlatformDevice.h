@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <glm/glm.hpp>
 #include <igl/PlatformDevice.h>
 #include <igl/Texture.h>
 #include <igl/vulkan/Common.h>
@@ -40,6 +41,23 @@ class PlatformDevice : public IPlatformDevice {
   /// @return pointer to generated Texture or nullptr
   std::shared_ptr<ITexture> createTextureFromNativeDrawable(Result* outResult);
 
+#if IGL_PLATFORM_ANDROID && defined(VK_ANDROID_external_memory_android_hardware_buffer)
+  /// Returns a texture sharing the memory of `hardwareBuffer`, e.g. a camera or video decoder
+  /// frame, without copying it. The buffer is acquired from its producer once, so the producer
+  /// must be done writing it. Buffers with an external (YUV) format are not supported.
+  /// @param hardwareBuffer A single-layer buffer with AHARDWAREBUFFER_USAGE_GPU_SAMPLED_IMAGE
+  /// @param outResult optional result
+  /// @return pointer to generated Texture or nullptr
+  std::shared_ptr<ITexture> createTextureFromNativeHardwareBuffer(AHardwareBuffer* hardwareBuffer,
+                                                                  Result* outResult);
+#endif // IGL_PLATFORM_ANDROID && VK_ANDROID_external_memory_android_hardware_buffer
+
+  /// Returns the rotation the swapchain images are pre-rotated with (see
+  /// VulkanContextConfig::enableSwapchainPreRotation). Apply it after the projection matrix when
+  /// rendering into native drawables; native drawables have a swapped extent for 90 and 270
+  /// degree rotations. Identity if there is no swapchain or the images are not rotated
+  [[nodiscard]] glm::mat4 getPreRotationMatrix() const;
+
   /// @param handle The handle to the GPU Fence
   /// @return The Vulkan fence associated with the handle
   [[nodiscard]] VkFence getVkFenceFromSubmitHandle(SubmitHandle handle) const;
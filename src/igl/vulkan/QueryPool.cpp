@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/QueryPool.h>
+
+#include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanHelpers.h>
+
+namespace igl {
+namespace vulkan {
+
+namespace {
+
+// the order of the bits matches the order of the members of igl::PipelineStatistics
+constexpr VkQueryPipelineStatisticFlags kPipelineStatistics =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+static_assert(sizeof(PipelineStatistics) == 7 * sizeof(uint64_t));
+
+} // namespace
+
+QueryPool::QueryPool(const VulkanContext& ctx, const QueryPoolDesc& desc, Result* outResult) :
+  ctx_(ctx), desc_(desc) {
+  IGL_PROFILER_FUNCTION();
+
+  if (desc_.queryCount == 0) {
+    Result::setResult(outResult, Result::Code::ArgumentInvalid, "Query count cannot be zero");
+    return;
+  }
+
+  if (desc_.type == QueryType::PipelineStatistics && !ctx_.usePipelineStatistics_) {
+    Result::setResult(
+        outResult, Result::Code::Unsupported, "Pipeline statistics queries are not supported");
+    return;
+  }
+
+  VkDevice device = ctx_.getVkDevice();
+
+  const bool isOcclusion = desc_.type == QueryType::Occlusion;
+
+  const VkResult result =
+      ivkCreateQueryPool(device,
+                         isOcclusion ? VK_QUERY_TYPE_OCCLUSION : VK_QUERY_TYPE_PIPELINE_STATISTICS,
+                         desc_.queryCount,
+                         isOcclusion ? 0 : kPipelineStatistics,
+                         &queryPool_);
+
+  if (result != VK_SUCCESS) {
+    VK_ASSERT(result);
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create a query pool");
+    return;
+  }
+
+  VK_ASSERT(ivkSetDebugObjectName(device,
+                                  VK_OBJECT_TYPE_QUERY_POOL,
+                                  (uint64_t)queryPool_,
+                                  IGL_FORMAT("Query Pool: {}", desc_.debugName).c_str()));
+
+  Result::setOk(outResult);
+}
+
+QueryPool::~QueryPool() {
+  if (queryPool_ == VK_NULL_HANDLE) {
+    return;
+  }
+
+  ctx_.deferredTask(std::packaged_task<void()>([device = ctx_.getVkDevice(), pool = queryPool_]() {
+    vkDestroyQueryPool(device, pool, nullptr);
+  }));
+}
+
+void QueryPool::reset(VkCommandBuffer cmdBuf, VulkanImmediateCommands::SubmitHandle handle) {
+  IGL_ASSERT(queryPool_ != VK_NULL_HANDLE);
+
+  vkCmdResetQueryPool(cmdBuf, queryPool_, 0, desc_.queryCount);
+
+  lastSubmitHandle_ = handle;
+}
+
+void QueryPool::begin(VkCommandBuffer cmdBuf,
+                      VulkanImmediateCommands::SubmitHandle handle,
+                      uint32_t query) {
+  IGL_ASSERT(queryPool_ != VK_NULL_HANDLE);
+  IGL_ASSERT(query < desc_.queryCount);
+
+  vkCmdResetQueryPool(cmdBuf, queryPool_, query, 1);
+  vkCmdBeginQuery(cmdBuf, queryPool_, query, 0);
+
+  lastSubmitHandle_ = handle;
+}
+
+void QueryPool::end(VkCommandBuffer cmdBuf, uint32_t query) const {
+  IGL_ASSERT(queryPool_ != VK_NULL_HANDLE);
+  IGL_ASSERT(query < desc_.queryCount);
+
+  vkCmdEndQuery(cmdBuf, queryPool_, query);
+}
+
+bool QueryPool::getResults(uint32_t firstQuery,
+                           uint32_t numQueries,
+                           void* outData,
+                           size_t stride) const {
+  if (queryPool_ == VK_NULL_HANDLE || !IGL_VERIFY(outData) ||
+      !IGL_VERIFY(numQueries > 0 && firstQuery + numQueries <= desc_.queryCount)) {
+    return false;
+  }
+
+  // nothing has been written yet, or the queries still hold the results of a previous command
+  // buffer until the last one is executed
+  if (lastSubmitHandle_.empty() || !ctx_.immediate_->isReady(lastSubmitHandle_)) {
+    return false;
+  }
+
+  // no VK_QUERY_RESULT_WAIT_BIT: returns VK_NOT_READY instead of stalling
+  const VkResult result = vkGetQueryPoolResults(ctx_.getVkDevice(),
+                                                queryPool_,
+                                                firstQuery,
+                                                numQueries,
+                                                numQueries * stride,
+                                                outData,
+                                                stride,
+                                                VK_QUERY_RESULT_64_BIT);
+
+  return result == VK_SUCCESS;
+}
+
+bool QueryPool::getOcclusionResults(uint32_t firstQuery,
+                                    uint32_t numQueries,
+                                    uint64_t* outSamplesPassed) const {
+  IGL_ASSERT(desc_.type == QueryType::Occlusion);
+
+  return desc_.type == QueryType::Occlusion &&
+         getResults(firstQuery, numQueries, outSamplesPassed, sizeof(uint64_t));
+}
+
+bool QueryPool::getPipelineStatistics(uint32_t firstQuery,
+                                      uint32_t numQueries,
+                                      PipelineStatistics* outStatistics) const {
+  IGL_ASSERT(desc_.type == QueryType::PipelineStatistics);
+
+  return desc_.type == QueryType::PipelineStatistics &&
+         getResults(firstQuery, numQueries, outStatistics, sizeof(PipelineStatistics));
+}
+
+} // namespace vulkan
+} // namespace igl
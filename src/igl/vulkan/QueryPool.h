@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/QueryPool.h>
+#include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
+
+namespace igl {
+namespace vulkan {
+
+class VulkanContext;
+
+/**
+ * @brief Wraps a VkQueryPool of occlusion or pipeline statistics queries. Results are read back
+ * without waiting once the command buffer which last wrote the queries has completed.
+ */
+class QueryPool final : public IQueryPool {
+ public:
+  QueryPool(const VulkanContext& ctx, const QueryPoolDesc& desc, Result* outResult);
+  ~QueryPool() override;
+
+  [[nodiscard]] QueryType getType() const override {
+    return desc_.type;
+  }
+  [[nodiscard]] uint32_t getQueryCount() const override {
+    return desc_.queryCount;
+  }
+
+  [[nodiscard]] bool getOcclusionResults(uint32_t firstQuery,
+                                         uint32_t numQueries,
+                                         uint64_t* outSamplesPassed) const override;
+  [[nodiscard]] bool getPipelineStatistics(uint32_t firstQuery,
+                                           uint32_t numQueries,
+                                           PipelineStatistics* outStatistics) const override;
+
+  // resets all queries; has to be recorded outside of render passes
+  void reset(VkCommandBuffer cmdBuf, VulkanImmediateCommands::SubmitHandle handle);
+  // resets and begins a single query
+  void begin(VkCommandBuffer cmdBuf, VulkanImmediateCommands::SubmitHandle handle, uint32_t query);
+  void end(VkCommandBuffer cmdBuf, uint32_t query) const;
+
+  VkQueryPool getVkQueryPool() const {
+    return queryPool_;
+  }
+
+ private:
+  bool getResults(uint32_t firstQuery,
+                  uint32_t numQueries,
+                  void* outData,
+                  size_t stride) const;
+
+ private:
+  const VulkanContext& ctx_;
+  QueryPoolDesc desc_;
+  VkQueryPool queryPool_ = VK_NULL_HANDLE;
+  // the submission of the command buffer which last wrote into the pool
+  VulkanImmediateCommands::SubmitHandle lastSubmitHandle_ = {};
+};
+
+} // namespace vulkan
+} // namespace igl
@@ -14,13 +14,16 @@
 #include <igl/vulkan/CommandBuffer.h>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/DepthStencilState.h>
+#include <igl/vulkan/EnhancedShaderDebuggingStore.h>
 #include <igl/vulkan/Framebuffer.h>
+#include <igl/vulkan/QueryPool.h>
 #include <igl/vulkan/RenderPipelineState.h>
 #include <igl/vulkan/SamplerState.h>
 #include <igl/vulkan/Texture.h>
 #include <igl/vulkan/VulkanBuffer.h>
 #include <igl/vulkan/VulkanContext.h>
 #include <igl/vulkan/VulkanDevice.h>
+#include <igl/vulkan/VulkanImage.h>
 #include <igl/vulkan/VulkanPipelineLayout.h>
 #include <igl/vulkan/VulkanRenderPassBuilder.h>
 #include <igl/vulkan/VulkanSwapchain.h>
@@ -56,27 +59,55 @@ VkAttachmentStoreOp storeActionToVkAttachmentStoreOp(igl::StoreAction a) {
   return VK_ATTACHMENT_STORE_OP_DONT_CARE;
 }
 
-VkStencilOp stencilOperationToVkStencilOp(igl::StencilOperation op) {
-  switch (op) {
-  case igl::StencilOperation::Keep:
-    return VK_STENCIL_OP_KEEP;
-  case igl::StencilOperation::Zero:
-    return VK_STENCIL_OP_ZERO;
-  case igl::StencilOperation::Replace:
-    return VK_STENCIL_OP_REPLACE;
-  case igl::StencilOperation::IncrementClamp:
-    return VK_STENCIL_OP_INCREMENT_AND_CLAMP;
-  case igl::StencilOperation::DecrementClamp:
-    return VK_STENCIL_OP_DECREMENT_AND_CLAMP;
-  case igl::StencilOperation::Invert:
-    return VK_STENCIL_OP_INVERT;
-  case igl::StencilOperation::IncrementWrap:
-    return VK_STENCIL_OP_INCREMENT_AND_WRAP;
-  case igl::StencilOperation::DecrementWrap:
-    return VK_STENCIL_OP_DECREMENT_AND_WRAP;
+VkExtent2D shadingRateToVkExtent2D(igl::ShadingRate rate) {
+  using igl::ShadingRate;
+  switch (rate) {
+  case ShadingRate::Rate1x1:
+    return {1, 1};
+  case ShadingRate::Rate1x2:
+    return {1, 2};
+  case ShadingRate::Rate2x1:
+    return {2, 1};
+  case ShadingRate::Rate2x2:
+    return {2, 2};
+  case ShadingRate::Rate2x4:
+    return {2, 4};
+  case ShadingRate::Rate4x2:
+    return {4, 2};
+  case ShadingRate::Rate4x4:
+    return {4, 4};
   }
   IGL_ASSERT(false);
-  return VK_STENCIL_OP_KEEP;
+  return {1, 1};
+}
+
+// Tracks whether the contents stored into an attachment are ever read and, when
+// VulkanContextConfig::enableRenderPassAnalysis is set, logs load and store operations which
+// waste memory bandwidth
+void analyzeAttachment(const igl::vulkan::VulkanContext& ctx,
+                       const igl::vulkan::VulkanImage& image,
+                       const igl::FramebufferDesc& desc,
+                       const char* attachmentName,
+                       igl::LoadAction loadAction,
+                       bool isStored) {
+  if (ctx.config_.enableRenderPassAnalysis) {
+    if (loadAction == igl::LoadAction::Load && image.imageLayout_ == VK_IMAGE_LAYOUT_UNDEFINED) {
+      IGL_LOG_INFO_ONCE(
+          "Render pass analysis: '%s' %s attachment loads undefined contents, use "
+          "LoadAction::DontCare or LoadAction::Clear\n",
+          desc.debugName.c_str(),
+          attachmentName);
+    }
+    if (loadAction != igl::LoadAction::Load && image.isStoredUnread_) {
+      IGL_LOG_INFO_ONCE(
+          "Render pass analysis: '%s' %s attachment overwrites contents which were stored but "
+          "never read, use StoreAction::DontCare in the previous pass\n",
+          desc.debugName.c_str(),
+          attachmentName);
+    }
+  }
+  // the contents are read by a later pass, a shader, a copy or a presentation
+  image.isStoredUnread_ = isStored;
 }
 
 VkIndexType indexFormatToVkIndexType(igl::IndexFormat fmt) {
@@ -90,23 +121,6 @@ VkIndexType indexFormatToVkIndexType(igl::IndexFormat fmt) {
   return VK_INDEX_TYPE_NONE_KHR;
 }
 
-VkPrimitiveTopology primitiveTypeToVkPrimitiveTopology(igl::PrimitiveType t) {
-  switch (t) {
-  case igl::PrimitiveType::Point:
-    return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
-  case igl::PrimitiveType::Line:
-    return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
-  case igl::PrimitiveType::LineStrip:
-    return VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
-  case igl::PrimitiveType::Triangle:
-    return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-  case igl::PrimitiveType::TriangleStrip:
-    return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
-  }
-  IGL_ASSERT_MSG(false, "Implement PrimitiveType = %u", (uint32_t)t);
-  return VK_PRIMITIVE_TOPOLOGY_MAX_ENUM;
-}
-
 } // namespace
 
 namespace igl {
@@ -123,8 +137,22 @@ RenderCommandEncoder::RenderCommandEncoder(const std::shared_ptr<CommandBuffer>&
   IGL_ASSERT(cmdBuffer_ != VK_NULL_HANDLE);
 }
 
+RenderCommandEncoder::RenderCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer,
+                                           const VulkanContext& ctx,
+                                           VkCommandBuffer secondaryCmdBuffer) :
+  IRenderCommandEncoder::IRenderCommandEncoder(commandBuffer),
+  ctx_(ctx),
+  cmdBuffer_(secondaryCmdBuffer),
+  isSecondary_(true),
+  binder_(commandBuffer, secondaryCmdBuffer, ctx, VK_PIPELINE_BIND_POINT_GRAPHICS) {
+  IGL_PROFILER_FUNCTION();
+  IGL_ASSERT(commandBuffer);
+  IGL_ASSERT(cmdBuffer_ != VK_NULL_HANDLE);
+}
+
 void RenderCommandEncoder::initialize(const RenderPassDesc& renderPass,
                                       const std::shared_ptr<IFramebuffer>& framebuffer,
+                                      VkSubpassContents contents,
                                       Result* outResult) {
   IGL_PROFILER_FUNCTION();
   framebuffer_ = framebuffer;
@@ -142,6 +170,7 @@ void RenderCommandEncoder::initialize(const RenderPassDesc& renderPass,
 
   std::vector<VkClearValue> clearValues;
   uint32_t mipLevel = 0;
+  uint32_t layer = 0;
 
   VulkanRenderPassBuilder builder;
 
@@ -194,9 +223,20 @@ void RenderCommandEncoder::initialize(const RenderPassDesc& renderPass,
                      "All color attachments should have the same mip-level");
     }
     mipLevel = descColor.mipmapLevel;
-    const auto initialLayout = descColor.loadAction == igl::LoadAction::Load
-                                   ? colorTexture.getVulkanTexture().getVulkanImage().imageLayout_
-                                   : VK_IMAGE_LAYOUT_UNDEFINED;
+    if (descColor.layer && layer) {
+      IGL_ASSERT_MSG(descColor.layer == layer, "All color attachments should have the same layer");
+    }
+    layer = descColor.layer;
+    analyzeAttachment(ctx_,
+                      colorTexture.getVulkanTexture().getVulkanImage(),
+                      desc,
+                      "color",
+                      descColor.loadAction,
+                      descColor.storeAction == StoreAction::Store);
+    const auto initialLayout =
+        descColor.loadAction == igl::LoadAction::Load
+            ? colorTexture.getVulkanTexture().getVulkanImage().getImageLayout(mipLevel, layer)
+            : VK_IMAGE_LAYOUT_UNDEFINED;
     builder.addColor(textureFormatToVkFormat(colorTexture.getFormat()),
                      loadActionToVkAttachmentLoadOp(descColor.loadAction),
                      storeActionToVkAttachmentStoreOp(descColor.storeAction),
@@ -210,6 +250,12 @@ void RenderCommandEncoder::initialize(const RenderPassDesc& renderPass,
       IGL_ASSERT_MSG(it->second.resolveTexture != nullptr,
                      "Framebuffer attachment should contain a resolve texture");
       const auto& colorResolveTexture = static_cast<vulkan::Texture&>(*it->second.resolveTexture);
+      analyzeAttachment(ctx_,
+                        colorResolveTexture.getVulkanTexture().getVulkanImage(),
+                        desc,
+                        "resolve",
+                        igl::LoadAction::DontCare,
+                        true);
       builder.addColorResolve(textureFormatToVkFormat(colorResolveTexture.getFormat()),
                               VK_ATTACHMENT_LOAD_OP_DONT_CARE,
                               VK_ATTACHMENT_STORE_OP_STORE);
@@ -230,11 +276,21 @@ void RenderCommandEncoder::initialize(const RenderPassDesc& renderPass,
     hasDepthAttachment_ = true;
     IGL_ASSERT_MSG(descDepth.mipmapLevel == mipLevel,
                    "Depth attachment should have the same mip-level as color attachments");
+    IGL_ASSERT_MSG(descDepth.layer == layer,
+                   "Depth attachment should have the same layer as color attachments");
     clearValues.push_back(
         ivkGetClearDepthStencilValue(descDepth.clearDepth, descStencil.clearStencil));
-    const auto initialLayout = descDepth.loadAction == igl::LoadAction::Load
-                                   ? depthTexture.getVulkanTexture().getVulkanImage().imageLayout_
-                                   : VK_IMAGE_LAYOUT_UNDEFINED;
+    analyzeAttachment(ctx_,
+                      depthTexture.getVulkanTexture().getVulkanImage(),
+                      desc,
+                      "depth",
+                      descDepth.loadAction,
+                      descDepth.storeAction == StoreAction::Store);
+    // all mip-levels of the rendered layer were transitioned by CommandBuffer::prepareFramebuffer()
+    const auto initialLayout =
+        descDepth.loadAction == igl::LoadAction::Load
+            ? depthTexture.getVulkanTexture().getVulkanImage().getImageLayout(0, layer)
+            : VK_IMAGE_LAYOUT_UNDEFINED;
     builder.addDepth(depthTexture.getVkFormat(),
                      loadActionToVkAttachmentLoadOp(descDepth.loadAction),
                      storeActionToVkAttachmentStoreOp(descDepth.storeAction),
@@ -245,28 +301,239 @@ void RenderCommandEncoder::initialize(const RenderPassDesc& renderPass,
     samples = depthTexture.getVulkanTexture().getVulkanImage().samples_;
   }
 
+  // the fragment density map follows all other attachments, see Framebuffer::getVkFramebuffer().
+  // Dynamic rendering does not use it
+  if (desc.fragmentDensityMap && !ctx_.useDynamicRendering_) {
+    const auto& densityMap = static_cast<vulkan::Texture&>(*desc.fragmentDensityMap);
+    builder.addFragmentDensityMap(densityMap.getVkFormat());
+  }
+
   const auto& fb = static_cast<vulkan::Framebuffer&>(*framebuffer);
 
-  auto renderPassHandle = ctx_.findRenderPass(builder);
+  dsInputAttachments_ = VK_NULL_HANDLE;
 
-  dynamicState_.renderPassIndex_ = renderPassHandle.index;
-  dynamicState_.depthBiasEnable_ = false;
+  if (renderPass.framebufferFetch) {
+    // dynamic rendering has no subpasses which could declare input attachments
+    IGL_ASSERT_MSG(!ctx_.useDynamicRendering_,
+                   "Framebuffer fetch requires VulkanContextConfig::enableDynamicRendering=false");
+    if (!ctx_.useDynamicRendering_) {
+      builder.enableFramebufferFetch();
+      dsInputAttachments_ = fb.getInputAttachmentsDescriptorSet(mipLevel, layer);
+    }
+  }
+
+  mipLevel_ = mipLevel;
+  layer_ = layer;
+
+  VkRenderPassBeginInfo bi = {};
+
+  if (ctx_.useDynamicRendering_) {
+    // no render passes; pipelines take attachment formats from their descriptors
+    dynamicState_.isStereo_ = desc.mode == FramebufferMode::Stereo;
+  } else {
+    auto renderPassHandle = ctx_.findRenderPass(builder);
 
-  const VkRenderPassBeginInfo bi = fb.getRenderPassBeginInfo(
-      renderPassHandle.pass, mipLevel, (uint32_t)clearValues.size(), clearValues.data());
+    // pipelines are keyed by a compatible render pass so that different load/store operations
+    // do not produce separate pipeline variants
+    dynamicState_.renderPassIndex_ =
+        ctx_.findRenderPass(builder.getCompatibleRenderPassBuilder()).index;
+
+    bi = fb.getRenderPassBeginInfo(renderPassHandle.pass,
+                                   mipLevel,
+                                   layer,
+                                   (uint32_t)clearValues.size(),
+                                   clearValues.data());
+
+    vkRenderPass_ = renderPassHandle.pass;
+    vkFramebuffer_ = bi.framebuffer;
+  }
+  dynamicState_.depthBiasEnable_ = false;
 
   const uint32_t width = std::max(fb.getWidth() >> mipLevel, 1u);
   const uint32_t height = std::max(fb.getHeight() >> mipLevel, 1u);
   const igl::Viewport viewport = {0.0f, 0.0f, (float)width, (float)height, 0.0f, +1.0f};
   const igl::ScissorRect scissor = {0, 0, width, height};
 
-  bindViewport(viewport);
-  bindScissorRect(scissor);
+  viewport_ = viewport;
+  scissor_ = scissor;
+
+  shadingRate_ = ShadingRate::Rate1x1;
+
+  // secondary command buffers inherit neither the dynamic state nor the bound descriptor sets
+  if (contents == VK_SUBPASS_CONTENTS_INLINE) {
+    bindViewport(viewport);
+    bindScissorRect(scissor);
+    recordShadingRate();
+  }
 
   ctx_.checkAndUpdateDescriptorSets();
-  ctx_.DUBs_->update(cmdBuffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, nullptr);
+  if (contents == VK_SUBPASS_CONTENTS_INLINE) {
+    ctx_.DUBs_->update(cmdBuffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, nullptr, 0);
+    bindInputAttachments();
+  }
+
+  if (renderPass.occlusionQueryPool) {
+    IGL_ASSERT(renderPass.occlusionQueryPool->getType() == QueryType::Occlusion);
+    occlusionQueryPool_ = std::static_pointer_cast<QueryPool>(renderPass.occlusionQueryPool);
+    // queries cannot be reset inside render passes
+    occlusionQueryPool_->reset(cmdBuffer_,
+                               static_cast<CommandBuffer&>(getCommandBuffer()).getSubmitHandle());
+  }
+
+  // layout transitions of all attachments are recorded with one barrier before the render pass
+  static_cast<CommandBuffer&>(getCommandBuffer()).flushBarriers();
+
+  if (ctx_.useDynamicRendering_) {
+    beginRendering(renderPass, desc, mipLevel, layer, samples, contents);
+  } else {
+    vkCmdBeginRenderPass(cmdBuffer_, &bi, contents);
+  }
+
+  isEncoding_ = true;
+
+  Result::setOk(outResult);
+}
+
+void RenderCommandEncoder::beginRendering(const RenderPassDesc& renderPass,
+                                          const FramebufferDesc& desc,
+                                          uint32_t mipLevel,
+                                          uint32_t layer,
+                                          VkSampleCountFlagBits samples,
+                                          VkSubpassContents contents) {
+  IGL_PROFILER_FUNCTION();
+
+  const auto& fb = static_cast<vulkan::Framebuffer&>(*framebuffer_);
+
+  std::vector<VkRenderingAttachmentInfoKHR> colorAttachments;
+  colorAttachments.reserve(desc.colorAttachments.size());
+  colorFormats_.clear();
+
+  // the layouts were set by CommandBuffer::prepareFramebuffer()
+  for (const auto& attachment : desc.colorAttachments) {
+    const auto& colorTexture = static_cast<vulkan::Texture&>(*attachment.second.texture);
+    const auto& descColor = renderPass.colorAttachments[attachment.first];
+    const VkImageView resolveView =
+        descColor.storeAction == StoreAction::MsaaResolve && attachment.second.resolveTexture
+            ? static_cast<vulkan::Texture&>(*attachment.second.resolveTexture)
+                  .getVkImageViewForFramebuffer(mipLevel, layer, desc.mode)
+            : VK_NULL_HANDLE;
+    colorAttachments.push_back(ivkGetRenderingAttachmentInfo(
+        colorTexture.getVkImageViewForFramebuffer(mipLevel, layer, desc.mode),
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        resolveView,
+        loadActionToVkAttachmentLoadOp(descColor.loadAction),
+        storeActionToVkAttachmentStoreOp(descColor.storeAction),
+        ivkGetClearColorValue(descColor.clearColor.r,
+                              descColor.clearColor.g,
+                              descColor.clearColor.b,
+                              descColor.clearColor.a)));
+    colorFormats_.push_back(textureFormatToVkFormat(colorTexture.getFormat()));
+  }
 
-  vkCmdBeginRenderPass(cmdBuffer_, &bi, VK_SUBPASS_CONTENTS_INLINE);
+  VkRenderingAttachmentInfoKHR depthAttachment = {};
+  VkRenderingAttachmentInfoKHR stencilAttachment = {};
+  depthFormat_ = VK_FORMAT_UNDEFINED;
+  stencilFormat_ = VK_FORMAT_UNDEFINED;
+
+  if (hasDepthAttachment_) {
+    const auto& depthTexture = static_cast<vulkan::Texture&>(*framebuffer_->getDepthAttachment());
+    const VkFormat format = depthTexture.getVkFormat();
+    const VkImageView view = depthTexture.getVkImageViewForFramebuffer(mipLevel, layer, desc.mode);
+    const VkClearValue clearValue = ivkGetClearDepthStencilValue(
+        renderPass.depthAttachment.clearDepth, renderPass.stencilAttachment.clearStencil);
+    if (VulkanImage::isDepthFormat(format)) {
+      depthFormat_ = format;
+      depthAttachment = ivkGetRenderingAttachmentInfo(
+          view,
+          VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+          VK_NULL_HANDLE,
+          loadActionToVkAttachmentLoadOp(renderPass.depthAttachment.loadAction),
+          storeActionToVkAttachmentStoreOp(renderPass.depthAttachment.storeAction),
+          clearValue);
+    }
+    if (VulkanImage::isStencilFormat(format)) {
+      stencilFormat_ = format;
+      stencilAttachment = ivkGetRenderingAttachmentInfo(
+          view,
+          VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+          VK_NULL_HANDLE,
+          loadActionToVkAttachmentLoadOp(renderPass.stencilAttachment.loadAction),
+          storeActionToVkAttachmentStoreOp(renderPass.stencilAttachment.storeAction),
+          clearValue);
+    }
+  }
+
+  samples_ = samples;
+  viewMask_ = desc.mode == FramebufferMode::Stereo ? 0x00000003 : 0;
+
+  VkRenderingInfoKHR info = {};
+  info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+  info.pNext = nullptr;
+  info.flags = contents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+                   ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT_KHR
+                   : 0u;
+  info.renderArea = VkRect2D{VkOffset2D{0, 0},
+                             VkExtent2D{std::max(fb.getWidth() >> mipLevel, 1u),
+                                        std::max(fb.getHeight() >> mipLevel, 1u)}};
+  info.layerCount = 1;
+  info.viewMask = viewMask_;
+  info.colorAttachmentCount = (uint32_t)colorAttachments.size();
+  info.pColorAttachments = colorAttachments.data();
+  info.pDepthAttachment = depthFormat_ != VK_FORMAT_UNDEFINED ? &depthAttachment : nullptr;
+  info.pStencilAttachment = stencilFormat_ != VK_FORMAT_UNDEFINED ? &stencilAttachment : nullptr;
+
+  ctx_.vkCmdBeginRendering_(cmdBuffer_, &info);
+}
+
+void RenderCommandEncoder::initializeSecondary(const RenderCommandEncoder& primary,
+                                               Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+
+  if (!IGL_VERIFY(primary.isEncoding_ && !primary.isSecondary_)) {
+    Result::setResult(outResult,
+                      Result::Code::InvalidOperation,
+                      "The primary render command encoder is not encoding");
+    return;
+  }
+
+  framebuffer_ = primary.framebuffer_;
+  hasDepthAttachment_ = primary.hasDepthAttachment_;
+  dynamicState_ = primary.dynamicState_;
+  vkRenderPass_ = primary.vkRenderPass_;
+  vkFramebuffer_ = primary.vkFramebuffer_;
+  dsInputAttachments_ = primary.dsInputAttachments_;
+  viewport_ = primary.viewport_;
+  scissor_ = primary.scissor_;
+  colorFormats_ = primary.colorFormats_;
+  depthFormat_ = primary.depthFormat_;
+  stencilFormat_ = primary.stencilFormat_;
+  samples_ = primary.samples_;
+  viewMask_ = primary.viewMask_;
+  shadingRate_ = primary.shadingRate_;
+
+  if (ctx_.useDynamicRendering_) {
+    VkCommandBufferInheritanceRenderingInfoKHR info = {};
+    info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR;
+    info.pNext = nullptr;
+    info.flags = 0;
+    info.viewMask = viewMask_;
+    info.colorAttachmentCount = (uint32_t)colorFormats_.size();
+    info.pColorAttachmentFormats = colorFormats_.data();
+    info.depthAttachmentFormat = depthFormat_;
+    info.stencilAttachmentFormat = stencilFormat_;
+    info.rasterizationSamples = samples_;
+    VK_ASSERT(ivkBeginSecondaryCommandBufferDynamicRendering(cmdBuffer_, &info));
+  } else {
+    VK_ASSERT(ivkBeginSecondaryCommandBuffer(cmdBuffer_, vkRenderPass_, vkFramebuffer_));
+  }
+
+  bindViewport(viewport_);
+  bindScissorRect(scissor_);
+  recordShadingRate();
+
+  // the bindless descriptor set was updated by the primary encoder
+  ctx_.DUBs_->update(cmdBuffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, nullptr, 0);
+  bindInputAttachments();
 
   isEncoding_ = true;
 
@@ -278,13 +545,32 @@ std::unique_ptr<RenderCommandEncoder> RenderCommandEncoder::create(
     const VulkanContext& ctx,
     const RenderPassDesc& renderPass,
     const std::shared_ptr<IFramebuffer>& framebuffer,
-    Result* outResult) {
+    Result* outResult,
+    VkSubpassContents contents) {
   IGL_PROFILER_FUNCTION();
 
   Result ret;
 
   std::unique_ptr<RenderCommandEncoder> encoder(new RenderCommandEncoder(commandBuffer, ctx));
-  encoder->initialize(renderPass, framebuffer, &ret);
+  encoder->initialize(renderPass, framebuffer, contents, &ret);
+
+  Result::setResult(outResult, ret);
+  return ret.isOk() ? std::move(encoder) : nullptr;
+}
+
+std::unique_ptr<RenderCommandEncoder> RenderCommandEncoder::createSecondary(
+    const std::shared_ptr<CommandBuffer>& commandBuffer,
+    const VulkanContext& ctx,
+    const RenderCommandEncoder& primary,
+    VkCommandBuffer secondaryCmdBuffer,
+    Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+
+  Result ret;
+
+  std::unique_ptr<RenderCommandEncoder> encoder(
+      new RenderCommandEncoder(commandBuffer, ctx, secondaryCmdBuffer));
+  encoder->initializeSecondary(primary, &ret);
 
   Result::setResult(outResult, ret);
   return ret.isOk() ? std::move(encoder) : nullptr;
@@ -299,7 +585,22 @@ void RenderCommandEncoder::endEncoding() {
 
   isEncoding_ = false;
 
-  vkCmdEndRenderPass(cmdBuffer_);
+  IGL_ASSERT_MSG(!isOcclusionQueryActive_, "Did you forget to call endOcclusionQuery()?");
+
+  if (isSecondary_) {
+    for (uint32_t i = 0; i != numInheritedDebugLabels_; i++) {
+      ivkCmdEndDebugUtilsLabel(cmdBuffer_);
+    }
+    // the render pass is ended by the primary encoder
+    VK_ASSERT(ivkEndCommandBuffer(cmdBuffer_));
+    return;
+  }
+
+  if (ctx_.useDynamicRendering_) {
+    ctx_.vkCmdEndRendering_(cmdBuffer_);
+  } else {
+    vkCmdEndRenderPass(cmdBuffer_);
+  }
 
   // set image layouts after the render pass
   const FramebufferDesc& desc = static_cast<const Framebuffer&>((*framebuffer_)).getDesc();
@@ -307,14 +608,19 @@ void RenderCommandEncoder::endEncoding() {
   for (const auto& attachment : desc.colorAttachments) {
     const vulkan::Texture& tex = static_cast<vulkan::Texture&>(*attachment.second.texture.get());
     // this must match the final layout of the render pass
-    tex.getVulkanTexture().getVulkanImage().imageLayout_ = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    tex.getVulkanTexture().getVulkanImage().setImageLayout(
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        tex.getVkImageSubresourceRangeForFramebuffer(mipLevel_, layer_, desc.mode));
   }
 
   if (desc.depthAttachment.texture) {
     const vulkan::Texture& tex = static_cast<vulkan::Texture&>(*desc.depthAttachment.texture.get());
+    VkImageSubresourceRange range =
+        tex.getVkImageSubresourceRangeForFramebuffer(0, layer_, desc.mode);
+    range.levelCount = VK_REMAINING_MIP_LEVELS;
     // this must match the final layout of the render pass
-    tex.getVulkanTexture().getVulkanImage().imageLayout_ =
-        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    tex.getVulkanTexture().getVulkanImage().setImageLayout(
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, range);
   }
 }
 
@@ -393,24 +699,24 @@ void RenderCommandEncoder::bindDepthStencilState(
   if (!IGL_VERIFY(depthStencilState != nullptr)) {
     return;
   }
+  // the device returns the same object for equal descriptors
+  if (depthStencilState == currentDepthStencilState_) {
+    return;
+  }
+  currentDepthStencilState_ = depthStencilState;
+
   const igl::vulkan::DepthStencilState* state =
       static_cast<igl::vulkan::DepthStencilState*>(depthStencilState.get());
 
   const igl::DepthStencilStateDesc& desc = state->getDepthStencilStateDesc();
 
-  dynamicState_.depthWriteEnable_ = desc.isDepthWriteEnabled;
-  dynamicState_.setDepthCompareOp(compareFunctionToVkCompareOp(desc.compareFunction));
+  dynamicState_.setDepthStencilState(desc);
 
   auto setStencilState = [this](VkStencilFaceFlagBits faceMask, const igl::StencilStateDesc& desc) {
     if (desc == igl::StencilStateDesc()) {
       // do not update anything if we don't have an actual state
       return;
     }
-    dynamicState_.setStencilStateOps(faceMask,
-                                     stencilOperationToVkStencilOp(desc.stencilFailureOperation),
-                                     stencilOperationToVkStencilOp(desc.depthStencilPassOperation),
-                                     stencilOperationToVkStencilOp(desc.depthFailureOperation),
-                                     compareFunctionToVkCompareOp(desc.stencilCompareFunction));
     // this is what the IGL/OGL backend does with masks
     vkCmdSetStencilReference(cmdBuffer_, faceMask, desc.readMask);
     vkCmdSetStencilCompareMask(cmdBuffer_, faceMask, 0xFF);
@@ -450,15 +756,20 @@ void RenderCommandEncoder::bindBuffer(int index,
       (buf->getBufferType() &
        (BufferDesc::BufferTypeBits::Uniform | BufferDesc::BufferTypeBits::Storage)) > 0;
 
-  if (buf->getBufferType() & BufferDesc::BufferTypeBits::Vertex) {
+  // storage buffers holding vertices are bound to a slot when shaders pull the vertices themselves
+  const bool isVertexPulling = isUniformOrStorageBuffer && target == BindTarget::kAllGraphics;
+
+  if ((buf->getBufferType() & BufferDesc::BufferTypeBits::Vertex) && !isVertexPulling) {
     IGL_ASSERT(target == BindTarget::kVertex);
-    const VkDeviceSize offset = bufferOffset;
+    const VkDeviceSize offset = buf->getVkBufferOffset() + bufferOffset;
     vkCmdBindVertexBuffers(cmdBuffer_, index, 1, &vkBuf, &offset);
   } else if (isUniformOrStorageBuffer) {
+#if IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
     if (ctx_.enhancedShaderDebuggingStore_) {
       IGL_ASSERT_MSG(index < (kMaxBindingSlots - 1),
                      "The last buffer index is reserved for enhanced debugging features");
     }
+#endif // IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
     if (!IGL_VERIFY(target == BindTarget::kAllGraphics)) {
       IGL_ASSERT_MSG(false, "Buffer target should be BindTarget::kAllGraphics");
       return;
@@ -546,16 +857,60 @@ void RenderCommandEncoder::bindPipeline() {
   }
 
   binder_.bindPipeline(rps->getVkPipeline(dynamicState_));
+
+  if (ctx_.useExtendedDynamicState_) {
+    setExtendedDynamicState();
+  }
+}
+
+void RenderCommandEncoder::setExtendedDynamicState() {
+  const RenderPipelineDynamicState& state = dynamicState_;
+  const RenderPipelineDynamicState& last = extendedDynamicState_;
+  const bool setAll = !hasExtendedDynamicState_;
+
+  if (setAll || state.getTopology() != last.getTopology()) {
+    ctx_.vkCmdSetPrimitiveTopology_(cmdBuffer_, state.getTopology());
+  }
+  if (setAll || state.depthWriteEnable_ != last.depthWriteEnable_) {
+    ctx_.vkCmdSetDepthWriteEnable_(cmdBuffer_, state.depthWriteEnable_ ? VK_TRUE : VK_FALSE);
+  }
+  if (setAll || state.getDepthCompareOp() != last.getDepthCompareOp()) {
+    ctx_.vkCmdSetDepthCompareOp_(cmdBuffer_, state.getDepthCompareOp());
+  }
+  for (const bool front : {true, false}) {
+    if (setAll || state.getStencilStateFailOp(front) != last.getStencilStateFailOp(front) ||
+        state.getStencilStatePassOp(front) != last.getStencilStatePassOp(front) ||
+        state.getStencilStateDepthFailOp(front) != last.getStencilStateDepthFailOp(front) ||
+        state.getStencilStateComapreOp(front) != last.getStencilStateComapreOp(front)) {
+      ctx_.vkCmdSetStencilOp_(cmdBuffer_,
+                              front ? VK_STENCIL_FACE_FRONT_BIT : VK_STENCIL_FACE_BACK_BIT,
+                              state.getStencilStateFailOp(front),
+                              state.getStencilStatePassOp(front),
+                              state.getStencilStateDepthFailOp(front),
+                              state.getStencilStateComapreOp(front));
+    }
+  }
+
+  extendedDynamicState_ = state;
+  hasExtendedDynamicState_ = true;
 }
 
 void RenderCommandEncoder::draw(PrimitiveType primitiveType,
                                 size_t vertexStart,
                                 size_t vertexCount) {
+  drawInstanced(primitiveType, vertexStart, vertexCount, 1);
+}
+
+void RenderCommandEncoder::drawInstanced(PrimitiveType primitiveType,
+                                         size_t vertexStart,
+                                         size_t vertexCount,
+                                         uint32_t instanceCount) {
   IGL_PROFILER_FUNCTION();
 
   ctx_.drawCallCount_ += drawCallCountEnabled_;
+  getCommandBuffer().incrementStatistic(CommandBufferCounter::Draws, drawCallCountEnabled_);
 
-  if (vertexCount == 0) {
+  if (vertexCount == 0 || instanceCount == 0) {
     return;
   }
 
@@ -567,7 +922,8 @@ void RenderCommandEncoder::draw(PrimitiveType primitiveType,
   IGL_LOG_INFO("%p vkCmdDraw(%u, %u)\n", cmdBuffer_, (uint32_t)vertexCount, (uint32_t)vertexStart);
 #endif // IGL_VULKAN_PRINT_COMMANDS
 
-  vkCmdDraw(cmdBuffer_, (uint32_t)vertexCount, 1, (uint32_t)vertexStart, 0);
+  IGL_PROFILER_ZONE_GPU_COLOR_VK("draw", ctx_.tracyCtx_, cmdBuffer_, IGL_PROFILER_COLOR_DRAW);
+  vkCmdDraw(cmdBuffer_, (uint32_t)vertexCount, instanceCount, (uint32_t)vertexStart, 0);
 }
 
 void RenderCommandEncoder::drawIndexed(PrimitiveType primitiveType,
@@ -575,11 +931,21 @@ void RenderCommandEncoder::drawIndexed(PrimitiveType primitiveType,
                                        IndexFormat indexFormat,
                                        IBuffer& indexBuffer,
                                        size_t indexBufferOffset) {
+  drawIndexedInstanced(primitiveType, indexCount, indexFormat, indexBuffer, indexBufferOffset, 1);
+}
+
+void RenderCommandEncoder::drawIndexedInstanced(PrimitiveType primitiveType,
+                                                size_t indexCount,
+                                                IndexFormat indexFormat,
+                                                IBuffer& indexBuffer,
+                                                size_t indexBufferOffset,
+                                                uint32_t instanceCount) {
   IGL_PROFILER_FUNCTION();
 
   ctx_.drawCallCount_ += drawCallCountEnabled_;
+  getCommandBuffer().incrementStatistic(CommandBufferCounter::Draws, drawCallCountEnabled_);
 
-  if (indexCount == 0) {
+  if (indexCount == 0 || instanceCount == 0) {
     return;
   }
 
@@ -593,12 +959,14 @@ void RenderCommandEncoder::drawIndexed(PrimitiveType primitiveType,
 #if IGL_VULKAN_PRINT_COMMANDS
   IGL_LOG_INFO("%p vkCmdBindIndexBuffer(%u)\n", cmdBuffer_, (uint32_t)indexBufferOffset);
 #endif // IGL_VULKAN_PRINT_COMMANDS
-  vkCmdBindIndexBuffer(cmdBuffer_, buf->getVkBuffer(), indexBufferOffset, type);
+  vkCmdBindIndexBuffer(
+      cmdBuffer_, buf->getVkBuffer(), buf->getVkBufferOffset() + indexBufferOffset, type);
 
 #if IGL_VULKAN_PRINT_COMMANDS
   IGL_LOG_INFO("%p vkCmdDrawIndexed(%u)\n", cmdBuffer_, (uint32_t)indexCount);
 #endif // IGL_VULKAN_PRINT_COMMANDS
-  vkCmdDrawIndexed(cmdBuffer_, (uint32_t)indexCount, 1, 0, 0, 0);
+  IGL_PROFILER_ZONE_GPU_COLOR_VK("draw", ctx_.tracyCtx_, cmdBuffer_, IGL_PROFILER_COLOR_DRAW);
+  vkCmdDrawIndexed(cmdBuffer_, (uint32_t)indexCount, instanceCount, 0, 0, 0);
 }
 
 void RenderCommandEncoder::drawIndexedIndirect(PrimitiveType primitiveType,
@@ -624,12 +992,14 @@ void RenderCommandEncoder::multiDrawIndirect(PrimitiveType primitiveType,
   bindPipeline();
 
   ctx_.drawCallCount_ += drawCallCountEnabled_;
+  getCommandBuffer().incrementStatistic(CommandBufferCounter::Draws, drawCallCountEnabled_);
 
   const igl::vulkan::Buffer* bufIndirect = static_cast<igl::vulkan::Buffer*>(&indirectBuffer);
 
+  IGL_PROFILER_ZONE_GPU_COLOR_VK("draw", ctx_.tracyCtx_, cmdBuffer_, IGL_PROFILER_COLOR_DRAW);
   vkCmdDrawIndirect(cmdBuffer_,
                     bufIndirect->getVkBuffer(),
-                    indirectBufferOffset,
+                    bufIndirect->getVkBufferOffset() + indirectBufferOffset,
                     drawCount,
                     stride ? stride : sizeof(VkDrawIndirectCommand));
 }
@@ -648,20 +1018,62 @@ void RenderCommandEncoder::multiDrawIndexedIndirect(PrimitiveType primitiveType,
   bindPipeline();
 
   ctx_.drawCallCount_ += drawCallCountEnabled_;
+  getCommandBuffer().incrementStatistic(CommandBufferCounter::Draws, drawCallCountEnabled_);
 
   const igl::vulkan::Buffer* bufIndex = static_cast<igl::vulkan::Buffer*>(&indexBuffer);
   const igl::vulkan::Buffer* bufIndirect = static_cast<igl::vulkan::Buffer*>(&indirectBuffer);
 
   const VkIndexType type = indexFormatToVkIndexType(indexFormat);
-  vkCmdBindIndexBuffer(cmdBuffer_, bufIndex->getVkBuffer(), 0, type);
+  vkCmdBindIndexBuffer(cmdBuffer_, bufIndex->getVkBuffer(), bufIndex->getVkBufferOffset(), type);
 
+  IGL_PROFILER_ZONE_GPU_COLOR_VK("draw", ctx_.tracyCtx_, cmdBuffer_, IGL_PROFILER_COLOR_DRAW);
   vkCmdDrawIndexedIndirect(cmdBuffer_,
                            bufIndirect->getVkBuffer(),
-                           indirectBufferOffset,
+                           bufIndirect->getVkBufferOffset() + indirectBufferOffset,
                            drawCount,
                            stride ? stride : sizeof(VkDrawIndexedIndirectCommand));
 }
 
+void RenderCommandEncoder::multiDrawIndexedIndirectCount(PrimitiveType primitiveType,
+                                                         IndexFormat indexFormat,
+                                                         IBuffer& indexBuffer,
+                                                         IBuffer& indirectBuffer,
+                                                         size_t indirectBufferOffset,
+                                                         IBuffer& countBuffer,
+                                                         size_t countBufferOffset,
+                                                         uint32_t maxDrawCount,
+                                                         uint32_t stride) {
+  IGL_PROFILER_FUNCTION();
+
+  if (!IGL_VERIFY(ctx_.vkCmdDrawIndexedIndirectCount_)) {
+    IGL_ASSERT_MSG(false, "VK_KHR_draw_indirect_count is not supported");
+    return;
+  }
+
+  binder_.updateBindings();
+  dynamicState_.setTopology(primitiveTypeToVkPrimitiveTopology(primitiveType));
+  bindPipeline();
+
+  ctx_.drawCallCount_ += drawCallCountEnabled_;
+  getCommandBuffer().incrementStatistic(CommandBufferCounter::Draws, drawCallCountEnabled_);
+
+  const igl::vulkan::Buffer* bufIndex = static_cast<igl::vulkan::Buffer*>(&indexBuffer);
+  const igl::vulkan::Buffer* bufIndirect = static_cast<igl::vulkan::Buffer*>(&indirectBuffer);
+  const igl::vulkan::Buffer* bufCount = static_cast<igl::vulkan::Buffer*>(&countBuffer);
+
+  const VkIndexType type = indexFormatToVkIndexType(indexFormat);
+  vkCmdBindIndexBuffer(cmdBuffer_, bufIndex->getVkBuffer(), bufIndex->getVkBufferOffset(), type);
+
+  IGL_PROFILER_ZONE_GPU_COLOR_VK("draw", ctx_.tracyCtx_, cmdBuffer_, IGL_PROFILER_COLOR_DRAW);
+  ctx_.vkCmdDrawIndexedIndirectCount_(cmdBuffer_,
+                                      bufIndirect->getVkBuffer(),
+                                      bufIndirect->getVkBufferOffset() + indirectBufferOffset,
+                                      bufCount->getVkBuffer(),
+                                      bufCount->getVkBufferOffset() + countBufferOffset,
+                                      maxDrawCount,
+                                      stride ? stride : sizeof(VkDrawIndexedIndirectCommand));
+}
+
 void RenderCommandEncoder::setStencilReferenceValue(uint32_t value) {
   setStencilReferenceValues(value, value);
 }
@@ -680,11 +1092,127 @@ void RenderCommandEncoder::setDepthBias(float depthBias, float slopeScale, float
   vkCmdSetDepthBias(cmdBuffer_, depthBias, clamp, slopeScale);
 }
 
+void RenderCommandEncoder::setShadingRate(ShadingRate rate) {
+  if (rate != shadingRate_) {
+    shadingRate_ = rate;
+    recordShadingRate();
+  }
+}
+
+void RenderCommandEncoder::recordShadingRate() {
+#if defined(VK_KHR_fragment_shading_rate)
+  if (!ctx_.hasFragmentShadingRate()) {
+    return;
+  }
+  const VkExtent2D fragmentSize = shadingRateToVkExtent2D(shadingRate_);
+  // there are no per-primitive rates nor shading rate attachments to combine with
+  const VkFragmentShadingRateCombinerOpKHR combinerOps[2] = {
+      VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR,
+      VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR,
+  };
+  ctx_.vkCmdSetFragmentShadingRate_(cmdBuffer_, &fragmentSize, combinerOps);
+#endif // VK_KHR_fragment_shading_rate
+}
+
+void RenderCommandEncoder::beginOcclusionQuery(uint32_t query) {
+  IGL_ASSERT_MSG(occlusionQueryPool_, "RenderPassDesc::occlusionQueryPool is not set");
+  IGL_ASSERT_MSG(!isOcclusionQueryActive_, "Occlusion queries cannot be nested");
+  IGL_ASSERT(!occlusionQueryPool_ || query < occlusionQueryPool_->getQueryCount());
+
+  if (!occlusionQueryPool_ || isOcclusionQueryActive_) {
+    return;
+  }
+
+  vkCmdBeginQuery(cmdBuffer_, occlusionQueryPool_->getVkQueryPool(), query, 0);
+
+  occlusionQuery_ = query;
+  isOcclusionQueryActive_ = true;
+}
+
+void RenderCommandEncoder::endOcclusionQuery() {
+  IGL_ASSERT(isOcclusionQueryActive_);
+
+  if (!isOcclusionQueryActive_) {
+    return;
+  }
+
+  occlusionQueryPool_->end(cmdBuffer_, occlusionQuery_);
+
+  isOcclusionQueryActive_ = false;
+}
+
+void RenderCommandEncoder::bindInputAttachments() const {
+  if (dsInputAttachments_ == VK_NULL_HANDLE) {
+    return;
+  }
+
+#if IGL_VULKAN_PRINT_COMMANDS
+  IGL_LOG_INFO("%p vkCmdBindDescriptorSets(input attachments)\n", cmdBuffer_);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+  // set #2 follows the bindless set and the dynamic uniform buffers
+  vkCmdBindDescriptorSets(cmdBuffer_,
+                          VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          ctx_.pipelineLayoutGraphics_->getVkPipelineLayout(),
+                          2,
+                          1,
+                          &dsInputAttachments_,
+                          0,
+                          nullptr);
+}
+
+void RenderCommandEncoder::framebufferFetchBarrier() {
+  IGL_PROFILER_FUNCTION();
+  IGL_ASSERT_MSG(dsInputAttachments_ != VK_NULL_HANDLE,
+                 "RenderPassDesc::framebufferFetch is not enabled");
+
+  if (dsInputAttachments_ == VK_NULL_HANDLE) {
+    return;
+  }
+
+  const bool isMultiview =
+      static_cast<const Framebuffer&>(*framebuffer_).getDesc().mode != FramebufferMode::Mono;
+
+  // matches the self-dependency of the render pass, see ivkGetSubpassSelfDependency()
+  const VkMemoryBarrier barrier = {
+      VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      nullptr,
+      VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+      VK_ACCESS_INPUT_ATTACHMENT_READ_BIT,
+  };
+  vkCmdPipelineBarrier(cmdBuffer_,
+                       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                       isMultiview ? VK_DEPENDENCY_BY_REGION_BIT | VK_DEPENDENCY_VIEW_LOCAL_BIT
+                                   : VK_DEPENDENCY_BY_REGION_BIT,
+                       1,
+                       &barrier,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr);
+}
+
 bool RenderCommandEncoder::setDrawCallCountEnabled(bool value) {
   const auto returnVal = drawCallCountEnabled_ > 0;
   drawCallCountEnabled_ = value;
   return returnVal;
 }
 
+void RenderCommandEncoder::setShaderDebuggingEnabled(bool enabled) {
+#if IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
+  if (ctx_.enhancedShaderDebuggingStore_) {
+    // drawLine() returns early when the lines buffer address is 0
+    binder_.bindBuffer(
+        EnhancedShaderDebuggingStore::kBufferIndex,
+        enabled ? static_cast<igl::vulkan::Buffer*>(
+                      ctx_.enhancedShaderDebuggingStore_->vertexBuffer().get())
+                : nullptr,
+        0);
+  }
+#else
+  (void)enabled;
+#endif // IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
+}
+
 } // namespace vulkan
 } // namespace igl
@@ -20,6 +20,8 @@
 namespace igl {
 namespace vulkan {
 
+class QueryPool;
+
 class RenderCommandEncoder : public IRenderCommandEncoder {
  public:
   static std::unique_ptr<RenderCommandEncoder> create(
@@ -27,6 +29,17 @@ class RenderCommandEncoder : public IRenderCommandEncoder {
       const VulkanContext& ctx,
       const RenderPassDesc& renderPass,
       const std::shared_ptr<IFramebuffer>& framebuffer,
+      Result* outResult,
+      VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
+
+  // Creates an encoder recording into `secondaryCmdBuffer`, which continues the render pass of
+  // `primary`. The primary encoder has to be created with
+  // VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS.
+  static std::unique_ptr<RenderCommandEncoder> createSecondary(
+      const std::shared_ptr<CommandBuffer>& commandBuffer,
+      const VulkanContext& ctx,
+      const RenderCommandEncoder& primary,
+      VkCommandBuffer secondaryCmdBuffer,
       Result* outResult);
 
   ~RenderCommandEncoder() override {
@@ -65,6 +78,16 @@ class RenderCommandEncoder : public IRenderCommandEncoder {
                    IndexFormat indexFormat,
                    IBuffer& indexBuffer,
                    size_t indexBufferOffset) override;
+  void drawInstanced(PrimitiveType primitiveType,
+                     size_t vertexStart,
+                     size_t vertexCount,
+                     uint32_t instanceCount) override;
+  void drawIndexedInstanced(PrimitiveType primitiveType,
+                            size_t indexCount,
+                            IndexFormat indexFormat,
+                            IBuffer& indexBuffer,
+                            size_t indexBufferOffset,
+                            uint32_t instanceCount) override;
   void drawIndexedIndirect(PrimitiveType primitiveType,
                            IndexFormat indexFormat,
                            IBuffer& indexBuffer,
@@ -82,11 +105,26 @@ class RenderCommandEncoder : public IRenderCommandEncoder {
                                 size_t indirectBufferOffset,
                                 uint32_t drawCount,
                                 uint32_t stride = 0) override;
+  void multiDrawIndexedIndirectCount(PrimitiveType primitiveType,
+                                     IndexFormat indexFormat,
+                                     IBuffer& indexBuffer,
+                                     IBuffer& indirectBuffer,
+                                     size_t indirectBufferOffset,
+                                     IBuffer& countBuffer,
+                                     size_t countBufferOffset,
+                                     uint32_t maxDrawCount,
+                                     uint32_t stride = 0) override;
 
   void setStencilReferenceValue(uint32_t value) override;
   void setStencilReferenceValues(uint32_t frontValue, uint32_t backValue) override;
   void setBlendColor(Color color) override;
   void setDepthBias(float depthBias, float slopeScale, float clamp) override;
+  void setShadingRate(ShadingRate rate) override;
+
+  void beginOcclusionQuery(uint32_t query) override;
+  void endOcclusionQuery() override;
+
+  void framebufferFetchBarrier() override;
 
   VkCommandBuffer getVkCommandBuffer() const {
     return cmdBuffer_;
@@ -98,8 +136,17 @@ class RenderCommandEncoder : public IRenderCommandEncoder {
 
   bool setDrawCallCountEnabled(bool value);
 
+  /// @brief Enables or disables drawLine() in the shaders of subsequent draw calls (enhanced
+  /// shader debugging). Draw calls which are not instrumented skip drawLine() at run time, so the
+  /// same pipelines are used either way. No-op if enhanced shader debugging is not enabled.
+  void setShaderDebuggingEnabled(bool enabled);
+
  private:
   void bindPipeline();
+  // records the states of dynamicState_ which are not baked into pipelines, if they changed
+  void setExtendedDynamicState();
+  // binds dsInputAttachments_, if any, as descriptor set #2
+  void bindInputAttachments() const;
 
  private:
   const VulkanContext& ctx_;
@@ -107,11 +154,41 @@ class RenderCommandEncoder : public IRenderCommandEncoder {
   bool isEncoding_ = false;
   bool hasDepthAttachment_ = false;
   std::shared_ptr<IFramebuffer> framebuffer_;
+  // the mip-level and the layer of the color attachments rendered into
+  uint32_t mipLevel_ = 0;
+  uint32_t layer_ = 0;
+
+  // needed to begin secondary command buffers inside this render pass
+  VkRenderPass vkRenderPass_ = VK_NULL_HANDLE;
+  VkFramebuffer vkFramebuffer_ = VK_NULL_HANDLE;
+  // the color attachments read by framebuffer fetch (descriptor set #2), if it is enabled
+  VkDescriptorSet dsInputAttachments_ = VK_NULL_HANDLE;
+  igl::Viewport viewport_ = {};
+  igl::ScissorRect scissor_ = {};
+  // needed to begin secondary command buffers with dynamic rendering
+  std::vector<VkFormat> colorFormats_;
+  VkFormat depthFormat_ = VK_FORMAT_UNDEFINED;
+  VkFormat stencilFormat_ = VK_FORMAT_UNDEFINED;
+  VkSampleCountFlagBits samples_ = VK_SAMPLE_COUNT_1_BIT;
+  uint32_t viewMask_ = 0;
+  // records into a secondary command buffer executed by a ParallelRenderCommandEncoder
+  bool isSecondary_ = false;
+  // debug groups pushed by the parent ParallelRenderCommandEncoder; popped in endEncoding()
+  uint32_t numInheritedDebugLabels_ = 0;
+  // all queries of the pool are reset before the render pass begins
+  std::shared_ptr<QueryPool> occlusionQueryPool_;
+  uint32_t occlusionQuery_ = 0;
+  bool isOcclusionQueryActive_ = false;
 
   igl::vulkan::ResourcesBinder binder_;
 
   std::shared_ptr<igl::IRenderPipelineState> currentPipeline_ = nullptr;
+  std::shared_ptr<igl::IDepthStencilState> currentDepthStencilState_;
   RenderPipelineDynamicState dynamicState_;
+  // the states last recorded by setExtendedDynamicState()
+  RenderPipelineDynamicState extendedDynamicState_;
+  bool hasExtendedDynamicState_ = false;
+  ShadingRate shadingRate_ = ShadingRate::Rate1x1;
 
   /* Used to increment the draw call count. Should either be 0 or 1
    *  0: When draw call count is disabled during auxiliary draw calls (shader debugging)
@@ -119,12 +196,27 @@ class RenderCommandEncoder : public IRenderCommandEncoder {
   uint32_t drawCallCountEnabled_ = 1u;
 
  private:
+  friend class ParallelRenderCommandEncoder;
+
   RenderCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer,
                        const VulkanContext& ctx);
+  RenderCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer,
+                       const VulkanContext& ctx,
+                       VkCommandBuffer secondaryCmdBuffer);
 
   void initialize(const RenderPassDesc& renderPass,
                   const std::shared_ptr<IFramebuffer>& framebuffer,
+                  VkSubpassContents contents,
                   Result* outResult);
+  void initializeSecondary(const RenderCommandEncoder& primary, Result* outResult);
+  // records shadingRate_ if the pipelines have a dynamic fragment shading rate
+  void recordShadingRate();
+  void beginRendering(const RenderPassDesc& renderPass,
+                      const FramebufferDesc& desc,
+                      uint32_t mipLevel,
+                      uint32_t layer,
+                      VkSampleCountFlagBits samples,
+                      VkSubpassContents contents);
 };
 
 } // namespace vulkan
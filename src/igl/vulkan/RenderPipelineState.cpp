@@ -11,8 +11,10 @@
 #include <igl/vulkan/VertexInputState.h>
 #include <igl/vulkan/VulkanContext.h>
 #include <igl/vulkan/VulkanDevice.h>
+#include <igl/vulkan/VulkanImage.h>
 #include <igl/vulkan/VulkanPipelineBuilder.h>
 #include <igl/vulkan/VulkanPipelineLayout.h>
+#include <igl/vulkan/VulkanRenderPassBuilder.h>
 
 namespace {
 
@@ -216,11 +218,221 @@ namespace igl {
 
 namespace vulkan {
 
+void RenderPipelineDynamicState::setDepthStencilState(const igl::DepthStencilStateDesc& desc) {
+  depthWriteEnable_ = desc.isDepthWriteEnabled;
+  setDepthCompareOp(compareFunctionToVkCompareOp(desc.compareFunction));
+
+  auto setStencilState = [this](bool front, const igl::StencilStateDesc& desc) {
+    if (desc == igl::StencilStateDesc()) {
+      // do not update anything if we don't have an actual state
+      return;
+    }
+    setStencilStateOps(front,
+                       stencilOperationToVkStencilOp(desc.stencilFailureOperation),
+                       stencilOperationToVkStencilOp(desc.depthStencilPassOperation),
+                       stencilOperationToVkStencilOp(desc.depthFailureOperation),
+                       compareFunctionToVkCompareOp(desc.stencilCompareFunction));
+  };
+
+  setStencilState(true, desc.frontFaceStencil);
+  setStencilState(false, desc.backFaceStencil);
+}
+
+RenderPipelineDynamicState RenderPipelineDynamicState::getExtendedDynamicStateKey() const {
+  RenderPipelineDynamicState key;
+
+  switch (getTopology()) {
+  case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+  case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+    key.setTopology(VK_PRIMITIVE_TOPOLOGY_LINE_LIST);
+    break;
+  case VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST:
+  case VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP:
+  case VK_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN:
+    key.setTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+    break;
+  default:
+    key.setTopology(getTopology());
+    break;
+  }
+
+  key.renderPassIndex_ = renderPassIndex_;
+  key.depthBiasEnable_ = depthBiasEnable_;
+  key.isStereo_ = isStereo_;
+
+  return key;
+}
+
+RenderPipelineVariants::~RenderPipelineVariants() {
+  destroyPipelines();
+
+  for (auto l : retiredLibraries_) {
+    ctx_.deferredDestroy(VulkanContext::DestructionType::Pipeline, (uint64_t)l);
+  }
+}
+
+void RenderPipelineVariants::destroyPipelines() const {
+  for (auto p : pipelines_) {
+    if (p.second != VK_NULL_HANDLE) {
+      ctx_.deferredDestroy(VulkanContext::DestructionType::Pipeline, (uint64_t)p.second);
+    }
+  }
+
+  pipelines_.clear();
+
+  for (auto& libraries : libraries_) {
+    for (auto l : libraries) {
+      if (l.second != VK_NULL_HANDLE) {
+        retiredLibraries_.push_back(l.second);
+      }
+    }
+    libraries.clear();
+  }
+}
+
+uint32_t RenderPipelineVariants::updateBindlessGeneration() const {
+  const uint32_t bindlessGeneration = ctx_.bindlessGeneration_;
+
+  if (bindlessGeneration_ != bindlessGeneration) {
+    // the pipeline layout has been recreated since these pipelines were built
+    destroyPipelines();
+    bindlessGeneration_ = bindlessGeneration;
+  }
+
+  return bindlessGeneration;
+}
+
+VkPipeline RenderPipelineVariants::find(const RenderPipelineDynamicState& dynamicState) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  updateBindlessGeneration();
+
+  const auto it = pipelines_.find(dynamicState);
+
+  return it != pipelines_.end() ? it->second : VK_NULL_HANDLE;
+}
+
+VkPipeline RenderPipelineVariants::add(const RenderPipelineDynamicState& dynamicState,
+                                       VkPipeline pipeline,
+                                       uint32_t bindlessGeneration) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (bindlessGeneration != updateBindlessGeneration()) {
+    // never handed out, so it can be destroyed right away
+    vkDestroyPipeline(ctx_.device_->getVkDevice(), pipeline, nullptr);
+    return VK_NULL_HANDLE;
+  }
+
+  const auto result = pipelines_.insert({dynamicState, pipeline});
+
+  if (!result.second && pipeline != VK_NULL_HANDLE) {
+    // somebody has built the same variant concurrently; keep the existing one
+    VkDevice device = ctx_.device_->getVkDevice();
+    vkDestroyPipeline(device, pipeline, nullptr);
+  }
+
+  return result.first->second;
+}
+
+bool RenderPipelineVariants::replace(const RenderPipelineDynamicState& dynamicState,
+                                     VkPipeline oldPipeline,
+                                     VkPipeline newPipeline) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  const auto it = pipelines_.find(dynamicState);
+
+  if (it == pipelines_.end() || it->second != oldPipeline) {
+    // the variants have been dropped while `newPipeline` was being built
+    vkDestroyPipeline(ctx_.device_->getVkDevice(), newPipeline, nullptr);
+    return false;
+  }
+
+  // `oldPipeline` can still be used by command buffers in flight
+  ctx_.deferredDestroy(VulkanContext::DestructionType::Pipeline, (uint64_t)oldPipeline);
+  it->second = newPipeline;
+  generation_++;
+
+  return true;
+}
+
+VkPipeline RenderPipelineVariants::findLibrary(LibraryPart part,
+                                               const RenderPipelineDynamicState& key,
+                                               uint32_t bindlessGeneration) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (bindlessGeneration != updateBindlessGeneration()) {
+    return VK_NULL_HANDLE;
+  }
+
+  const Pipelines& libraries = libraries_[static_cast<size_t>(part)];
+  const auto it = libraries.find(key);
+
+  return it != libraries.end() ? it->second : VK_NULL_HANDLE;
+}
+
+VkPipeline RenderPipelineVariants::addLibrary(LibraryPart part,
+                                              const RenderPipelineDynamicState& key,
+                                              VkPipeline library,
+                                              uint32_t bindlessGeneration) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (bindlessGeneration != updateBindlessGeneration()) {
+    vkDestroyPipeline(ctx_.device_->getVkDevice(), library, nullptr);
+    return VK_NULL_HANDLE;
+  }
+
+  const auto result = libraries_[static_cast<size_t>(part)].insert({key, library});
+
+  if (!result.second && library != VK_NULL_HANDLE) {
+    vkDestroyPipeline(ctx_.device_->getVkDevice(), library, nullptr);
+  }
+
+  return result.first->second;
+}
+
+RenderPipelineDynamicState RenderPipelineVariants::getLibraryKey(
+    LibraryPart part,
+    const RenderPipelineDynamicState& dynamicState) {
+  RenderPipelineDynamicState key;
+
+  switch (part) {
+  case LibraryPart::VertexInput:
+    key.setTopology(dynamicState.getTopology());
+    return key;
+  case LibraryPart::PreRasterization:
+    key.depthBiasEnable_ = dynamicState.depthBiasEnable_;
+    break;
+  case LibraryPart::FragmentShader:
+    key.depthWriteEnable_ = dynamicState.depthWriteEnable_;
+    key.setDepthCompareOp(dynamicState.getDepthCompareOp());
+    for (const bool front : {true, false}) {
+      key.setStencilStateOps(front,
+                             dynamicState.getStencilStateFailOp(front),
+                             dynamicState.getStencilStatePassOp(front),
+                             dynamicState.getStencilStateDepthFailOp(front),
+                             dynamicState.getStencilStateComapreOp(front));
+    }
+    break;
+  case LibraryPart::FragmentOutput:
+    break;
+  }
+
+  // all parts but the vertex input depend on the render pass or the view mask
+  key.renderPassIndex_ = dynamicState.renderPassIndex_;
+  key.isStereo_ = dynamicState.isStereo_;
+
+  return key;
+}
+
 RenderPipelineState::RenderPipelineState(const igl::vulkan::Device& device,
-                                         RenderPipelineDesc desc) :
+                                         RenderPipelineDesc desc,
+                                         std::shared_ptr<RenderPipelineVariants> variants) :
   device_(device),
   desc_(std::move(desc)),
-  reflection_(std::make_shared<RenderPipelineReflection>()) {
+  reflection_(std::make_shared<RenderPipelineReflection>()),
+  variants_(std::move(variants)) {
+  IGL_ASSERT(variants_);
+
   // Iterate and cache vertex input bindings and attributes
   const igl::vulkan::VertexInputState* vstate =
       static_cast<igl::vulkan::VertexInputState*>(desc_.vertexInputState.get());
@@ -259,32 +471,127 @@ RenderPipelineState::RenderPipelineState(const igl::vulkan::Device& device,
   }
 }
 
-RenderPipelineState::~RenderPipelineState() {
-  VkDevice device = device_.getVulkanContext().device_->getVkDevice();
+RenderPipelineState::~RenderPipelineState() = default;
 
-  for (auto p : pipelines_) {
-    if (p.second != VK_NULL_HANDLE) {
-      device_.getVulkanContext().deferredTask(std::packaged_task<void()>(
-          [device, pipeline = p.second]() { vkDestroyPipeline(device, pipeline, nullptr); }));
+VkPipeline RenderPipelineState::getVkPipeline(
+    const RenderPipelineDynamicState& drawState) const {
+  // variants differ only in the state which cannot be set in the command buffer
+  const RenderPipelineDynamicState dynamicState =
+      device_.getVulkanContext().useExtendedDynamicState_ ? drawState.getExtendedDynamicStateKey()
+                                                          : drawState;
+  {
+    std::lock_guard<std::mutex> lock(lastPipelineMutex_);
+    if (lastPipeline_ != VK_NULL_HANDLE && lastDynamicState_ == dynamicState &&
+        lastBindlessGeneration_ == device_.getVulkanContext().bindlessGeneration_ &&
+        lastVariantsGeneration_ == variants_->getGeneration()) {
+      return lastPipeline_;
     }
   }
-}
 
-VkPipeline RenderPipelineState::getVkPipeline(
-    const RenderPipelineDynamicState& dynamicState) const {
-  const auto it = pipelines_.find(dynamicState);
+  const uint32_t bindlessGeneration = device_.getVulkanContext().bindlessGeneration_;
+  const uint32_t variantsGeneration = variants_->getGeneration();
+
+  VkPipeline pipeline = variants_->find(dynamicState);
+
+  if (pipeline != VK_NULL_HANDLE) {
+    device_.pipelineVariantHits_++;
+  } else {
+    device_.pipelineVariantMisses_++;
+    const VulkanContext& ctx = device_.getVulkanContext();
+    // there are no render passes with dynamic rendering
+    pipeline = buildVkPipeline(dynamicState,
+                               ctx.useDynamicRendering_
+                                   ? VK_NULL_HANDLE
+                                   : ctx.getRenderPass(dynamicState.renderPassIndex_).pass,
+                               true);
+  }
 
-  if (it != pipelines_.end()) {
-    return it->second;
+  {
+    std::lock_guard<std::mutex> lock(lastPipelineMutex_);
+    lastDynamicState_ = dynamicState;
+    lastPipeline_ = pipeline;
+    lastBindlessGeneration_ = bindlessGeneration;
+    lastVariantsGeneration_ = variantsGeneration;
   }
 
-  // build a new Vulkan pipeline
+  return pipeline;
+}
 
+RenderPipelineDynamicState RenderPipelineState::getDynamicState(
+    const RenderPipelineVariantDesc& variant) const {
   const VulkanContext& ctx = device_.getVulkanContext();
 
-  VkRenderPass renderPass = ctx.getRenderPass(dynamicState.renderPassIndex_).pass;
+  RenderPipelineDynamicState dynamicState;
 
-  VkPipeline pipeline = VK_NULL_HANDLE;
+  dynamicState.isStereo_ = variant.framebufferMode == FramebufferMode::Stereo;
+  dynamicState.depthBiasEnable_ = variant.depthBiasEnable;
+  dynamicState.setTopology(primitiveTypeToVkPrimitiveTopology(variant.primitiveType));
+  dynamicState.setDepthStencilState(variant.depthStencilState);
+
+  if (ctx.useExtendedDynamicState_) {
+    dynamicState = dynamicState.getExtendedDynamicStateKey();
+  }
+
+  if (ctx.useDynamicRendering_) {
+    // pipelines take attachment formats from the pipeline descriptor
+    return dynamicState;
+  }
+
+  // describe a render pass compatible with the one RenderCommandEncoder is going to use
+  VulkanRenderPassBuilder builder;
+
+  if (variant.framebufferMode == FramebufferMode::Stereo) {
+    builder.setMultiviewMasks(0x00000003, 0x00000003);
+  }
+
+  const VkSampleCountFlagBits samples = getVulkanSampleCountFlags(desc_.sampleCount);
+
+  for (const auto& attachment : desc_.targetDesc.colorAttachments) {
+    if (attachment.textureFormat == TextureFormat::Invalid) {
+      continue;
+    }
+    const VkFormat format = textureFormatToVkFormat(attachment.textureFormat);
+    builder.addColor(format,
+                     VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+                     VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                     VK_IMAGE_LAYOUT_UNDEFINED,
+                     VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                     samples);
+    if (variant.hasColorResolve) {
+      builder.addColorResolve(
+          format, VK_ATTACHMENT_LOAD_OP_DONT_CARE, VK_ATTACHMENT_STORE_OP_DONT_CARE);
+    }
+  }
+
+  const TextureFormat depthFormat =
+      desc_.targetDesc.depthAttachmentFormat != TextureFormat::Invalid
+          ? desc_.targetDesc.depthAttachmentFormat
+          : desc_.targetDesc.stencilAttachmentFormat;
+
+  if (depthFormat != TextureFormat::Invalid) {
+    builder.addDepth(ctx.getClosestDepthStencilFormat(depthFormat),
+                     VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+                     VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                     VK_IMAGE_LAYOUT_UNDEFINED,
+                     VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                     samples);
+  }
+
+  if (variant.hasFragmentDensityMap && ctx.hasFragmentDensityMap()) {
+    // density maps written by OpenXR runtimes are VK_FORMAT_R8G8_UNORM
+    builder.addFragmentDensityMap(VK_FORMAT_R8G8_UNORM);
+  }
+
+  dynamicState.renderPassIndex_ =
+      ctx.findRenderPass(builder.getCompatibleRenderPassBuilder()).index;
+
+  return dynamicState;
+}
+
+void RenderPipelineState::setupPipelineBuilder(
+    VulkanPipelineBuilder& builder,
+    const RenderPipelineDynamicState& dynamicState) const {
+  const VulkanContext& ctx = device_.getVulkanContext();
 
   // Not all attachments are valid. We need to create color blend attachments only for active
   // attachments
@@ -314,7 +621,48 @@ VkPipeline RenderPipelineState::getVkPipeline(
 
   const auto& vertexModule = desc_.shaderStages->getVertexModule();
   const auto& fragmentModule = desc_.shaderStages->getFragmentModule();
-  igl::vulkan::VulkanPipelineBuilder()
+
+  if (ctx.useDynamicRendering_) {
+    std::vector<VkFormat> colorFormats;
+    colorFormats.reserve(desc_.targetDesc.colorAttachments.size());
+    for (const auto& attachment : desc_.targetDesc.colorAttachments) {
+      if (attachment.textureFormat != TextureFormat::Invalid) {
+        colorFormats.push_back(textureFormatToVkFormat(attachment.textureFormat));
+      }
+    }
+    const TextureFormat depthStencilFormat =
+        desc_.targetDesc.depthAttachmentFormat != TextureFormat::Invalid
+            ? desc_.targetDesc.depthAttachmentFormat
+            : desc_.targetDesc.stencilAttachmentFormat;
+    // this must match the attachments RenderCommandEncoder passes to vkCmdBeginRendering()
+    const VkFormat format = depthStencilFormat != TextureFormat::Invalid
+                                ? ctx.getClosestDepthStencilFormat(depthStencilFormat)
+                                : VK_FORMAT_UNDEFINED;
+    builder.dynamicRenderingFormats(
+        colorFormats,
+        VulkanImage::isDepthFormat(format) ? format : VK_FORMAT_UNDEFINED,
+        VulkanImage::isStencilFormat(format) ? format : VK_FORMAT_UNDEFINED,
+        dynamicState.isStereo_ ? 0x00000003 : 0);
+  }
+
+  if (ctx.useExtendedDynamicState_) {
+    // set by RenderCommandEncoder::bindPipeline(), the values below are ignored
+    builder.dynamicStates({
+        VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT,
+        VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT,
+        VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT,
+        VK_DYNAMIC_STATE_STENCIL_OP_EXT,
+    });
+  }
+
+#if defined(VK_KHR_fragment_shading_rate)
+  if (ctx.hasFragmentShadingRate()) {
+    // set by RenderCommandEncoder::setShadingRate()
+    builder.dynamicState(VK_DYNAMIC_STATE_FRAGMENT_SHADING_RATE_KHR);
+  }
+#endif // VK_KHR_fragment_shading_rate
+
+  builder
       .dynamicStates({
           // from Vulkan 1.0
           VK_DYNAMIC_STATE_VIEWPORT,
@@ -345,30 +693,174 @@ VkPipeline RenderPipelineState::getVkPipeline(
           ivkGetPipelineShaderStageCreateInfo(
               VK_SHADER_STAGE_VERTEX_BIT,
               igl::vulkan::ShaderModule::getVkShaderModule(vertexModule),
-              vertexModule->info().entryPoint.c_str()),
+              vertexModule->info().entryPoint.c_str(),
+              igl::vulkan::ShaderModule::getVkSpecializationInfo(vertexModule)),
           ivkGetPipelineShaderStageCreateInfo(
               VK_SHADER_STAGE_FRAGMENT_BIT,
               igl::vulkan::ShaderModule::getVkShaderModule(fragmentModule),
-              fragmentModule->info().entryPoint.c_str()),
+              fragmentModule->info().entryPoint.c_str(),
+              igl::vulkan::ShaderModule::getVkSpecializationInfo(fragmentModule)),
       })
       .cullMode(cullModeToVkCullMode(desc_.cullMode))
       .frontFace(windingModeToVkFrontFace(desc_.frontFaceWinding))
       .vertexInputState(vertexInputStateCreateInfo_)
-      .colorBlendAttachmentStates(colorBlendAttachmentStates)
-      .build(ctx.device_->getVkDevice(),
-             // TODO: use ctx.pipelineCache_
-             // @fb-only
-             // @fb-only
-             VK_NULL_HANDLE,
-             ctx.pipelineLayoutGraphics_->getVkPipelineLayout(),
-             renderPass,
-             &pipeline,
-             desc_.debugName.toConstChar());
-
-  pipelines_[dynamicState] = pipeline;
+      .colorBlendAttachmentStates(colorBlendAttachmentStates);
+}
+
+VkPipeline RenderPipelineState::buildVkPipeline(const RenderPipelineDynamicState& dynamicState,
+                                                VkRenderPass renderPass,
+                                                bool fastLink) const {
+  const VulkanContext& ctx = device_.getVulkanContext();
+
+  // Pipelines are built on worker threads while the rendering thread can grow the bindless
+  // descriptor set. A pipeline built with a layout which has been replaced meanwhile is rejected
+  // by `variants_`, so it is built again with the new layout
+  for (;;) {
+    uint32_t bindlessGeneration = 0;
+    const VkPipelineLayout layout =
+        ctx.getVkPipelineLayout(VK_PIPELINE_BIND_POINT_GRAPHICS, bindlessGeneration);
+    const VkPipeline pipeline =
+        buildVkPipeline(dynamicState, renderPass, fastLink, layout, bindlessGeneration);
+    if (pipeline != VK_NULL_HANDLE || bindlessGeneration == ctx.bindlessGeneration_) {
+      return pipeline;
+    }
+  }
+}
+
+VkPipeline RenderPipelineState::buildVkPipeline(const RenderPipelineDynamicState& dynamicState,
+                                                VkRenderPass renderPass,
+                                                bool fastLink,
+                                                VkPipelineLayout layout,
+                                                uint32_t bindlessGeneration) const {
+  IGL_PROFILER_FUNCTION();
+
+  const VulkanContext& ctx = device_.getVulkanContext();
+
+  igl::vulkan::VulkanPipelineBuilder builder;
+
+  setupPipelineBuilder(builder, dynamicState);
+  builder.creationFeedback(ctx.getPipelineCreationFeedback());
+  builder.createFlags(ctx.getPipelineCreateFlags());
+
+  if (ctx.useGraphicsPipelineLibrary_) {
+    const VkPipeline pipeline =
+        linkVkPipeline(builder, dynamicState, renderPass, fastLink, layout, bindlessGeneration);
+    if (pipeline != VK_NULL_HANDLE || bindlessGeneration != ctx.bindlessGeneration_) {
+      return pipeline;
+    }
+    // fall back to a monolithic pipeline
+  }
+
+  VkPipeline pipeline = VK_NULL_HANDLE;
+
+  builder.build(ctx.device_->getVkDevice(),
+                ctx.pipelineCache_,
+                layout,
+                renderPass,
+                &pipeline,
+                desc_.debugName.toConstChar());
 
   // @fb-only
   // @lint-ignore CLANGTIDY
+  return variants_->add(dynamicState, pipeline, bindlessGeneration);
+}
+
+VkPipeline RenderPipelineState::linkVkPipeline(VulkanPipelineBuilder& builder,
+                                               const RenderPipelineDynamicState& dynamicState,
+                                               VkRenderPass renderPass,
+                                               bool fastLink,
+                                               VkPipelineLayout layout,
+                                               uint32_t bindlessGeneration) const {
+  IGL_PROFILER_FUNCTION();
+
+  using LibraryPart = RenderPipelineVariants::LibraryPart;
+
+  constexpr VkGraphicsPipelineLibraryFlagsEXT kLibraryFlags[] = {
+      VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+      VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+      VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+      VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT,
+  };
+  static_assert(IGL_ARRAY_NUM_ELEMENTS(kLibraryFlags) == RenderPipelineVariants::kNumLibraryParts);
+
+  const VulkanContext& ctx = device_.getVulkanContext();
+  VkDevice device = ctx.device_->getVkDevice();
+
+  // every part is compiled once and shared by all variants using the same state of the part
+  std::vector<VkPipeline> libraries;
+  libraries.reserve(RenderPipelineVariants::kNumLibraryParts);
+
+  for (size_t i = 0; i != RenderPipelineVariants::kNumLibraryParts; i++) {
+    const auto part = static_cast<LibraryPart>(i);
+    const RenderPipelineDynamicState key =
+        RenderPipelineVariants::getLibraryKey(part, dynamicState);
+    VkPipeline library = variants_->findLibrary(part, key, bindlessGeneration);
+    if (library == VK_NULL_HANDLE) {
+      if (builder.buildLibrary(device,
+                               ctx.pipelineCache_,
+                               layout,
+                               renderPass,
+                               kLibraryFlags[i],
+                               &library,
+                               desc_.debugName.toConstChar()) != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+      }
+      library = variants_->addLibrary(part, key, library, bindlessGeneration);
+      if (library == VK_NULL_HANDLE) {
+        return VK_NULL_HANDLE;
+      }
+    }
+    libraries.push_back(library);
+  }
+
+  VkPipeline pipeline = VK_NULL_HANDLE;
+
+  if (VulkanPipelineBuilder::link(device,
+                                  ctx.pipelineCache_,
+                                  layout,
+                                  libraries,
+                                  !fastLink,
+                                  &pipeline,
+                                  desc_.debugName.toConstChar(),
+                                  ctx.getPipelineCreationFeedback()) != VK_SUCCESS) {
+    return VK_NULL_HANDLE;
+  }
+
+  const VkPipeline result = variants_->add(dynamicState, pipeline, bindlessGeneration);
+
+  if (!fastLink || result != pipeline) {
+    return result;
+  }
+
+  device_.pipelineVariantsFastLinked_++;
+
+  // Replace the fast-linked pipeline once an optimized one is ready. The libraries are owned by
+  // `variants`, kept alive until the task has finished
+  auto task = [&device = device_,
+               variants = variants_,
+               dynamicState,
+               libraries = std::move(libraries),
+               layout,
+               pipeline,
+               debugName = std::string(desc_.debugName.toConstChar())]() {
+    IGL_PROFILER_THREAD("Pipeline optimization");
+    const VulkanContext& ctx = device.getVulkanContext();
+    VkPipeline optimized = VK_NULL_HANDLE;
+    if (VulkanPipelineBuilder::link(ctx.device_->getVkDevice(),
+                                    ctx.pipelineCache_,
+                                    layout,
+                                    libraries,
+                                    true,
+                                    &optimized,
+                                    debugName.c_str(),
+                                    ctx.getPipelineCreationFeedback()) == VK_SUCCESS &&
+        variants->replace(dynamicState, pipeline, optimized)) {
+      device.pipelineVariantsOptimized_++;
+    }
+  };
+
+  device_.runTask(std::move(task), variants_);
+
   return pipeline;
 }
 
@@ -7,15 +7,22 @@
 
 #pragma once
 
+#include <atomic>
+#include <igl/Buffer.h>
+#include <igl/DepthStencilState.h>
+#include <igl/Framebuffer.h>
 #include <igl/RenderPipelineState.h>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/RenderPipelineReflection.h>
+#include <mutex>
 #include <unordered_map>
 
 namespace igl {
 namespace vulkan {
 
 class Device;
+class VulkanContext;
+class VulkanPipelineBuilder;
 
 class alignas(sizeof(uint64_t)) RenderPipelineDynamicState {
   uint32_t topology_ : 4;
@@ -56,6 +63,9 @@ class alignas(sizeof(uint64_t)) RenderPipelineDynamicState {
   // Ignore modernize-use-default-member-init
   // @lint-ignore CLANGTIDY
   uint32_t depthWriteEnable_ : 1;
+  // Ignore modernize-use-default-member-init
+  // @lint-ignore CLANGTIDY
+  uint32_t isStereo_ : 1; // used instead of renderPassIndex_ with dynamic rendering
 
   RenderPipelineDynamicState() {
     // memset makes sure all padding bits are zero
@@ -75,6 +85,7 @@ class alignas(sizeof(uint64_t)) RenderPipelineDynamicState {
     renderPassIndex_ = 0;
     depthBiasEnable_ = false;
     depthWriteEnable_ = false;
+    isStereo_ = false;
   }
 
   VkPrimitiveTopology getTopology() const {
@@ -134,6 +145,15 @@ class alignas(sizeof(uint64_t)) RenderPipelineDynamicState {
     }
   }
 
+  // depth write, depth compare and stencil operations
+  void setDepthStencilState(const igl::DepthStencilStateDesc& desc);
+
+  // The key of the pipeline variant when the topology, depth write, depth compare and stencil
+  // operations are set in the command buffer (VK_EXT_extended_dynamic_state). These states are
+  // reset to their defaults, but the topology class is kept since a dynamic topology must belong to
+  // the class of the topology of the pipeline
+  RenderPipelineDynamicState getExtendedDynamicStateKey() const;
+
   // comparison operator and hash function for std::unordered_map<>
   bool operator==(const RenderPipelineDynamicState& other) const {
     return *(uint64_t*)this == *(uint64_t*)&other;
@@ -149,13 +169,105 @@ class alignas(sizeof(uint64_t)) RenderPipelineDynamicState {
 static_assert(sizeof(RenderPipelineDynamicState) == sizeof(uint64_t));
 static_assert(alignof(RenderPipelineDynamicState) == sizeof(uint64_t));
 
+/// Describes a pipeline variant which can be compiled ahead of the first draw call using it. See
+/// vulkan::Device::warmUpRenderPipeline()
+struct RenderPipelineVariantDesc {
+  PrimitiveType primitiveType = PrimitiveType::Triangle;
+  DepthStencilStateDesc depthStencilState;
+  bool depthBiasEnable = false;
+  FramebufferMode framebufferMode = FramebufferMode::Mono;
+  // all color attachments are resolved (StoreAction::MsaaResolve)
+  bool hasColorResolve = false;
+  // the render pass has a fragment density map (FramebufferDesc::fragmentDensityMap)
+  bool hasFragmentDensityMap = false;
+};
+
+/// VkPipelines built for one RenderPipelineDesc. The set is shared between all
+/// RenderPipelineState objects created from equal descriptors, so the same variant is never
+/// compiled twice. Guarded by a mutex because variants can be built on background threads.
+///
+/// With VK_EXT_graphics_pipeline_library, variants are linked from pipeline libraries which are
+/// shared between all variants using the same state of a part.
+class RenderPipelineVariants final {
+ public:
+  enum class LibraryPart : uint8_t {
+    VertexInput,
+    PreRasterization,
+    FragmentShader,
+    FragmentOutput,
+  };
+  static constexpr size_t kNumLibraryParts = 4;
+
+  explicit RenderPipelineVariants(const VulkanContext& ctx) : ctx_(ctx) {}
+  ~RenderPipelineVariants();
+
+  VkPipeline find(const RenderPipelineDynamicState& dynamicState) const;
+  // returns the pipeline which ended up in the set (it might have been added by another thread).
+  // `bindlessGeneration` is the one of the pipeline layout `pipeline` was built with, see
+  // VulkanContext::getVkPipelineLayout(): if the layout has been replaced meanwhile, `pipeline` is
+  // destroyed and VK_NULL_HANDLE is returned
+  VkPipeline add(const RenderPipelineDynamicState& dynamicState,
+                 VkPipeline pipeline,
+                 uint32_t bindlessGeneration);
+  // replaces `oldPipeline` with `newPipeline`; `newPipeline` is destroyed and false is returned if
+  // `oldPipeline` is not in the set anymore
+  bool replace(const RenderPipelineDynamicState& dynamicState,
+               VkPipeline oldPipeline,
+               VkPipeline newPipeline);
+
+  // `key` holds only the state the library part depends on, see getLibraryKey(). Libraries are
+  // found and added only for the current `bindlessGeneration`, like add()
+  VkPipeline findLibrary(LibraryPart part,
+                         const RenderPipelineDynamicState& key,
+                         uint32_t bindlessGeneration) const;
+  VkPipeline addLibrary(LibraryPart part,
+                        const RenderPipelineDynamicState& key,
+                        VkPipeline library,
+                        uint32_t bindlessGeneration);
+
+  static RenderPipelineDynamicState getLibraryKey(LibraryPart part,
+                                                  const RenderPipelineDynamicState& dynamicState);
+
+  // incremented every time a pipeline is replaced
+  uint32_t getGeneration() const {
+    return generation_;
+  }
+
+ private:
+  void destroyPipelines() const;
+  // drops all pipelines if VulkanContext::bindlessGeneration_ has changed and returns it. Must be
+  // called with `mutex_` locked
+  uint32_t updateBindlessGeneration() const;
+
+ private:
+  using Pipelines = std::unordered_map<RenderPipelineDynamicState,
+                                       VkPipeline,
+                                       RenderPipelineDynamicState::HashFunction>;
+
+  const VulkanContext& ctx_;
+  mutable std::mutex mutex_;
+  mutable Pipelines pipelines_;
+  mutable Pipelines libraries_[kNumLibraryParts];
+  // Libraries dropped by a bindless generation change can still be used by background links, so
+  // they are destroyed only with this object: background links keep it alive
+  mutable std::vector<VkPipeline> retiredLibraries_;
+  // all pipelines are dropped when VulkanContext::bindlessGeneration_ changes
+  mutable uint32_t bindlessGeneration_ = 0;
+  std::atomic<uint32_t> generation_ = 0;
+};
+
 class RenderPipelineState final : public IRenderPipelineState {
  public:
-  RenderPipelineState(const igl::vulkan::Device& device, RenderPipelineDesc desc);
+  RenderPipelineState(const igl::vulkan::Device& device,
+                      RenderPipelineDesc desc,
+                      std::shared_ptr<RenderPipelineVariants> variants);
   ~RenderPipelineState() override;
 
   VkPipeline getVkPipeline(const RenderPipelineDynamicState& dynamicState) const;
 
+  // Should be called on the rendering thread: it can create new render passes
+  RenderPipelineDynamicState getDynamicState(const RenderPipelineVariantDesc& variant) const;
+
   const RenderPipelineDesc& getRenderPipelineDesc() const {
     return desc_;
   }
@@ -170,6 +282,26 @@ class RenderPipelineState final : public IRenderPipelineState {
   void setRenderPipelineReflection(
       const IRenderPipelineReflection& renderPipelineReflection) override;
 
+  // thread-safe: builds a variant if it does not exist yet. With pipeline libraries, `fastLink`
+  // links the variant without optimizations and schedules an optimized link on a worker thread
+  VkPipeline buildVkPipeline(const RenderPipelineDynamicState& dynamicState,
+                             VkRenderPass renderPass,
+                             bool fastLink) const;
+  // returns VK_NULL_HANDLE if `layout` has been replaced by a newer bindless generation meanwhile
+  VkPipeline buildVkPipeline(const RenderPipelineDynamicState& dynamicState,
+                             VkRenderPass renderPass,
+                             bool fastLink,
+                             VkPipelineLayout layout,
+                             uint32_t bindlessGeneration) const;
+  VkPipeline linkVkPipeline(VulkanPipelineBuilder& builder,
+                            const RenderPipelineDynamicState& dynamicState,
+                            VkRenderPass renderPass,
+                            bool fastLink,
+                            VkPipelineLayout layout,
+                            uint32_t bindlessGeneration) const;
+  void setupPipelineBuilder(VulkanPipelineBuilder& builder,
+                            const RenderPipelineDynamicState& dynamicState) const;
+
  private:
   const igl::vulkan::Device& device_;
 
@@ -183,10 +315,15 @@ class RenderPipelineState final : public IRenderPipelineState {
   // This is empty for now.
   std::shared_ptr<RenderPipelineReflection> reflection_;
 
-  mutable std::unordered_map<RenderPipelineDynamicState,
-                             VkPipeline,
-                             RenderPipelineDynamicState::HashFunction>
-      pipelines_;
+  std::shared_ptr<RenderPipelineVariants> variants_;
+
+  // the last used variant: consecutive draw calls usually share the same dynamic state
+  mutable RenderPipelineDynamicState lastDynamicState_;
+  mutable VkPipeline lastPipeline_ = VK_NULL_HANDLE;
+  mutable uint32_t lastBindlessGeneration_ = 0;
+  mutable uint32_t lastVariantsGeneration_ = 0;
+  // the same pipeline can be bound by parallel render command encoders on different threads
+  mutable std::mutex lastPipelineMutex_;
 };
 
 } // namespace vulkan
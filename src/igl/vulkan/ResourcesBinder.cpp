@@ -19,7 +19,13 @@ namespace vulkan {
 ResourcesBinder::ResourcesBinder(const std::shared_ptr<CommandBuffer>& commandBuffer,
                                  const VulkanContext& ctx,
                                  VkPipelineBindPoint bindPoint) :
-  ctx_(ctx), cmdBuffer_(commandBuffer->getVkCommandBuffer()), bindPoint_(bindPoint) {}
+  ResourcesBinder(commandBuffer, commandBuffer->getVkCommandBuffer(), ctx, bindPoint) {}
+
+ResourcesBinder::ResourcesBinder(const std::shared_ptr<CommandBuffer>& commandBuffer,
+                                 VkCommandBuffer cmdBuffer,
+                                 const VulkanContext& ctx,
+                                 VkPipelineBindPoint bindPoint) :
+  ctx_(ctx), commandBuffer_(*commandBuffer), cmdBuffer_(cmdBuffer), bindPoint_(bindPoint) {}
 
 void ResourcesBinder::bindBuffer(uint32_t index, igl::vulkan::Buffer* buffer, size_t bufferOffset) {
   IGL_PROFILER_FUNCTION();
@@ -29,8 +35,12 @@ void ResourcesBinder::bindBuffer(uint32_t index, igl::vulkan::Buffer* buffer, si
     return;
   }
 
-  bindings_.slots[index].buffer = buffer->gpuAddress(bufferOffset);
-  isBindingsUpdateRequired_ = true;
+  const VkDeviceAddress address = buffer ? buffer->gpuAddress(bufferOffset) : 0;
+
+  if (bindings_.slots[index].buffer != address) {
+    bindings_.slots[index].buffer = address;
+    markSlotDirty(index);
+  }
 }
 
 void ResourcesBinder::bindSamplerState(uint32_t index, igl::vulkan::SamplerState* samplerState) {
@@ -41,9 +51,12 @@ void ResourcesBinder::bindSamplerState(uint32_t index, igl::vulkan::SamplerState
     return;
   }
 
-  bindings_.slots[index].sampler = samplerState ? samplerState->getSamplerId() : 0;
+  const uint32_t samplerId = samplerState ? samplerState->getSamplerId() : 0;
 
-  isBindingsUpdateRequired_ = true;
+  if (bindings_.slots[index].sampler != samplerId) {
+    bindings_.slots[index].sampler = samplerId;
+    markSlotDirty(index);
+  }
 }
 
 void ResourcesBinder::bindTexture(uint32_t index, igl::vulkan::Texture* tex) {
@@ -76,18 +89,48 @@ void ResourcesBinder::bindTexture(uint32_t index, igl::vulkan::Texture* tex) {
   }
 
   // texture id is always within the range of `uint32_t` on our Vulkan implementation
-  bindings_.slots[index].texture = tex ? (uint32_t)tex->getTextureId() : 0;
+  const uint32_t textureId = tex ? (uint32_t)tex->getTextureId() : 0;
+
+  if (bindings_.slots[index].texture != textureId) {
+    bindings_.slots[index].texture = textureId;
+    markSlotDirty(index);
+  }
+}
 
-  isBindingsUpdateRequired_ = true;
+bool ResourcesBinder::hasChangedSinceUpload() const {
+  if (numSlotsUsed_ > numSlotsUploaded_) {
+    return true;
+  }
+  // slots can be bound back to their uploaded values, e.g. A -> B -> A between two draw calls
+  for (uint32_t i = 0; i != numSlotsUsed_; i++) {
+    if ((dirtySlots_ & (1u << i)) && bindings_.slots[i] != uploadedBindings_.slots[i]) {
+      return true;
+    }
+  }
+  return false;
 }
 
 void ResourcesBinder::updateBindings() {
   if (!isBindingsUpdateRequired_) {
-    return;
+    if (!dirtySlots_) {
+      return;
+    }
+    if (!hasChangedSinceUpload()) {
+      dirtySlots_ = 0;
+      return;
+    }
   }
 
-  ctx_.DUBs_->update(cmdBuffer_, bindPoint_, &bindings_);
+  IGL_PROFILER_FUNCTION();
+
+  const size_t size = numSlotsUsed_ * sizeof(Slot);
+  ctx_.DUBs_->update(cmdBuffer_, bindPoint_, &bindings_, size);
+  commandBuffer_.incrementStatistic(CommandBufferCounter::BindingUpdates);
+  commandBuffer_.incrementStatistic(CommandBufferCounter::UploadedBytes, size);
 
+  uploadedBindings_ = bindings_;
+  numSlotsUploaded_ = numSlotsUsed_;
+  dirtySlots_ = 0;
   isBindingsUpdateRequired_ = false;
 }
 
@@ -103,6 +146,7 @@ void ResourcesBinder::bindPipeline(VkPipeline pipeline) {
     IGL_LOG_INFO("%p vkCmdBindPipeline(%u, %p)\n", cmdBuffer_, bindPoint_, pipeline);
 #endif // IGL_VULKAN_PRINT_COMMANDS
     vkCmdBindPipeline(cmdBuffer_, bindPoint_, pipeline);
+    commandBuffer_.incrementStatistic(CommandBufferCounter::PipelineBinds);
   }
 }
 
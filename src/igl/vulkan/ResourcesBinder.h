@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <igl/Buffer.h>
 #include <igl/Common.h>
 #include <igl/Texture.h>
@@ -24,6 +26,7 @@ constexpr uint32_t kMaxBindingSlots = 16; // check shaders before changing this
 
 static_assert(kMaxBindingSlots <= igl::IGL_TEXTURE_SAMPLERS_MAX);
 static_assert(kMaxBindingSlots <= igl::IGL_UNIFORM_BLOCKS_BINDING_MAX);
+static_assert(kMaxBindingSlots <= 32); // ResourcesBinder::dirtySlots_
 
 struct Slot {
   uint32_t texture = 0;
@@ -40,24 +43,24 @@ struct Bindings {
   Slot slots[kMaxBindingSlots] = {};
 
   // comparison operator and hash function for std::unordered_map<>
+  // Slot has no padding, so the whole struct can be compared as raw memory
   bool operator==(const Bindings& other) const {
-    for (uint32_t i = 0; i != kMaxBindingSlots; i++) {
-      if (slots[i] != other.slots[i]) {
-        return false;
-      }
-    }
-    return true;
+    return memcmp(slots, other.slots, sizeof(slots)) == 0;
   }
 
   struct HashFunction {
     uint64_t operator()(const Bindings& s) const {
-      uint64_t hash = 0;
-      for (uint32_t i = 0; i != kMaxBindingSlots; i++) {
-        hash ^= std::hash<uint32_t>()(s.slots[i].texture);
-        hash ^= std::hash<uint32_t>()(s.slots[i].sampler);
-        hash ^= std::hash<uint64_t>()(s.slots[i].buffer);
+      // xxHash64 round over every 64-bit word: unlike XOR, the result depends on the slot order
+      constexpr uint64_t kPrime1 = 0x9e3779b185ebca87ull;
+      constexpr uint64_t kPrime2 = 0xc2b2ae3d27d4eb4full;
+      uint64_t words[sizeof(Bindings) / sizeof(uint64_t)];
+      memcpy(words, s.slots, sizeof(words));
+      uint64_t hash = kPrime1;
+      for (const uint64_t word : words) {
+        hash += word * kPrime2;
+        hash = ((hash << 31) | (hash >> 33)) * kPrime1;
       }
-      return hash;
+      return hash ^ (hash >> 29);
     }
   };
 };
@@ -69,6 +72,11 @@ class ResourcesBinder final {
   ResourcesBinder(const std::shared_ptr<CommandBuffer>& commandBuffer,
                   const VulkanContext& ctx,
                   VkPipelineBindPoint bindPoint);
+  // used by encoders which record into their own (secondary) command buffers
+  ResourcesBinder(const std::shared_ptr<CommandBuffer>& commandBuffer,
+                  VkCommandBuffer cmdBuffer,
+                  const VulkanContext& ctx,
+                  VkPipelineBindPoint bindPoint);
 
   void bindBuffer(uint32_t index, igl::vulkan::Buffer* buffer, size_t bufferOffset);
   void bindSamplerState(uint32_t index, igl::vulkan::SamplerState* samplerState);
@@ -84,15 +92,33 @@ class ResourcesBinder final {
     return bindPoint_ == VK_PIPELINE_BIND_POINT_GRAPHICS;
   }
 
+  // true if any dirty slot differs from what was uploaded last time
+  bool hasChangedSinceUpload() const;
+
+  void markSlotDirty(uint32_t index) {
+    numSlotsUsed_ = std::max(numSlotsUsed_, index + 1);
+    dirtySlots_ |= 1u << index;
+  }
+
  public:
   static constexpr uint32_t kDUBBufferSize = sizeof(Bindings);
 
  private:
   const VulkanContext& ctx_;
+  // the statistics of binding updates and pipeline binds are accumulated here
+  const CommandBuffer& commandBuffer_;
   VkCommandBuffer cmdBuffer_ = VK_NULL_HANDLE;
   VkPipeline lastPipelineBound_ = VK_NULL_HANDLE;
+  // nothing has been uploaded yet
   bool isBindingsUpdateRequired_ = true;
   Bindings bindings_;
+  // only slots [0...numSlotsUsed_) are uploaded into the dynamic uniform buffer
+  uint32_t numSlotsUsed_ = 0;
+  // one bit per slot modified since the last upload
+  uint32_t dirtySlots_ = 0;
+  // what the shaders see since the last upload
+  Bindings uploadedBindings_;
+  uint32_t numSlotsUploaded_ = 0;
   VkPipelineBindPoint bindPoint_ = VK_PIPELINE_BIND_POINT_GRAPHICS;
 };
 
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/RingBuffer.h>
+
+#include <igl/vulkan/Buffer.h>
+#include <igl/vulkan/Device.h>
+#include <igl/vulkan/VulkanContext.h>
+
+namespace igl {
+namespace vulkan {
+
+RingBuffer::RingBuffer(const Device& device, const RingBufferDesc& desc, Result* outResult) :
+  device_(device), allocator_(desc.length, desc.alignment) {
+  IGL_PROFILER_FUNCTION();
+
+  if (desc.length == 0) {
+    Result::setResult(outResult, Result::Code::ArgumentInvalid, "Ring buffer length is 0");
+    return;
+  }
+
+  Result result;
+  buffer_ = device_.createBuffer(
+      BufferDesc(desc.type, nullptr, desc.length, ResourceStorage::Shared, 0, desc.debugName),
+      &result);
+  if (!buffer_ || !result.isOk()) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create a ring buffer");
+    return;
+  }
+
+  // shared buffers are host-visible and coherent, keep them mapped until destruction
+  data_ = static_cast<uint8_t*>(buffer_->map(BufferRange(desc.length, 0), &result));
+  if (!data_ || !result.isOk()) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot map a ring buffer");
+    return;
+  }
+
+  Result::setOk(outResult);
+}
+
+RingBuffer::~RingBuffer() {
+  if (data_) {
+    buffer_->unmap();
+  }
+}
+
+void RingBuffer::retireFrames() {
+  const VulkanContext& ctx = device_.getVulkanContext();
+
+  while (!handles_.empty() && ctx.immediate_->isReady(handles_.front())) {
+    handles_.pop_front();
+    allocator_.retireFrame();
+  }
+}
+
+RingBufferAllocation RingBuffer::allocate(size_t size, Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+
+  if (!IGL_VERIFY(data_)) {
+    Result::setResult(outResult, Result::Code::InvalidOperation, "Ring buffer is not mapped");
+    return {};
+  }
+
+  if (size > allocator_.getCapacity()) {
+    Result::setResult(
+        outResult, Result::Code::ArgumentOutOfRange, "Allocation exceeds ring buffer length");
+    return {};
+  }
+
+  retireFrames();
+
+  const size_t offset = allocator_.allocate(size);
+
+  if (offset == RingBufferAllocator::kInvalidOffset) {
+    Result::setResult(outResult, Result::Code::InvalidOperation, "Ring buffer is full");
+    return {};
+  }
+
+  Result::setOk(outResult);
+
+  return {data_ + offset, offset, size};
+}
+
+void RingBuffer::endFrame(SubmitHandle handle) {
+  const VulkanContext& ctx = device_.getVulkanContext();
+
+  // without an explicit handle, the frame is retired together with the last submitted work
+  handles_.push_back(handle ? VulkanImmediateCommands::SubmitHandle(handle)
+                            : ctx.immediate_->getLastSubmitHandle());
+  allocator_.endFrame();
+}
+
+IBuffer& RingBuffer::getBuffer() const {
+  IGL_ASSERT(buffer_);
+  return *buffer_;
+}
+
+} // namespace vulkan
+} // namespace igl
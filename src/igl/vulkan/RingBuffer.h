@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <deque>
+#include <igl/RingBuffer.h>
+#include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
+
+namespace igl {
+namespace vulkan {
+
+class Device;
+
+/**
+ * @brief Sub-allocates per-frame data from a host-visible, coherent buffer which stays mapped for
+ * its whole lifetime. Frames are recycled once their submit handles are retired by
+ * VulkanImmediateCommands.
+ */
+class RingBuffer final : public IRingBuffer {
+ public:
+  RingBuffer(const Device& device, const RingBufferDesc& desc, Result* outResult);
+  ~RingBuffer() override;
+
+  RingBufferAllocation allocate(size_t size, Result* outResult) override;
+  void endFrame(SubmitHandle handle) override;
+  [[nodiscard]] IBuffer& getBuffer() const override;
+
+ private:
+  void retireFrames();
+
+ private:
+  const Device& device_;
+  std::unique_ptr<IBuffer> buffer_;
+  uint8_t* data_ = nullptr;
+  RingBufferAllocator allocator_;
+  // submit handles of all frames in flight, oldest first
+  std::deque<VulkanImmediateCommands::SubmitHandle> handles_;
+};
+
+} // namespace vulkan
+} // namespace igl
@@ -19,6 +19,26 @@ ShaderModule::ShaderModule(ShaderModuleInfo info,
                            std::shared_ptr<VulkanShaderModule> shaderModule) :
   IShaderModule(std::move(info)), module_(std::move(shaderModule)) {
   IGL_ASSERT(module_);
+
+  const auto& constants = this->info().specializationConstants;
+
+  specializationEntries_.reserve(constants.size());
+  specializationData_.reserve(constants.size());
+
+  // all constants are 32-bit, booleans are VkBool32
+  for (const auto& c : constants) {
+    VkSpecializationMapEntry entry = {};
+    entry.constantID = c.id;
+    entry.offset = uint32_t(specializationData_.size() * sizeof(uint32_t));
+    entry.size = sizeof(uint32_t);
+    specializationEntries_.push_back(entry);
+    specializationData_.push_back(c.value);
+  }
+
+  specializationInfo_.mapEntryCount = (uint32_t)specializationEntries_.size();
+  specializationInfo_.pMapEntries = specializationEntries_.data();
+  specializationInfo_.dataSize = specializationData_.size() * sizeof(uint32_t);
+  specializationInfo_.pData = specializationData_.data();
 }
 
 VkShaderModule ShaderModule::getVkShaderModule(const std::shared_ptr<IShaderModule>& shaderModule) {
@@ -29,6 +49,13 @@ VkShaderModule ShaderModule::getVkShaderModule(const std::shared_ptr<IShaderModu
   return sm ? sm->module_->getVkShaderModule() : VK_NULL_HANDLE;
 }
 
+const VkSpecializationInfo* ShaderModule::getVkSpecializationInfo(
+    const std::shared_ptr<IShaderModule>& shaderModule) {
+  const ShaderModule* sm = static_cast<ShaderModule*>(shaderModule.get());
+
+  return sm && !sm->specializationEntries_.empty() ? &sm->specializationInfo_ : nullptr;
+}
+
 ShaderStages::ShaderStages(ShaderStagesDesc desc) : IShaderStages(std::move(desc)) {}
 
 ShaderLibrary::ShaderLibrary(std::vector<std::shared_ptr<IShaderModule>> modules) :
@@ -24,9 +24,15 @@ class ShaderModule final : public IShaderModule {
   ~ShaderModule() override = default;
 
   static VkShaderModule getVkShaderModule(const std::shared_ptr<IShaderModule>& shaderModule);
+  // null if the module has no specialization constants
+  static const VkSpecializationInfo* getVkSpecializationInfo(
+      const std::shared_ptr<IShaderModule>& shaderModule);
 
  private:
   std::shared_ptr<VulkanShaderModule> module_;
+  std::vector<VkSpecializationMapEntry> specializationEntries_;
+  std::vector<uint32_t> specializationData_;
+  VkSpecializationInfo specializationInfo_ = {};
 };
 
 class ShaderStages final : public IShaderStages {
@@ -12,6 +12,7 @@
 #include <igl/vulkan/VulkanContext.h>
 #include <igl/vulkan/VulkanImage.h>
 #include <igl/vulkan/VulkanImageView.h>
+#include <igl/vulkan/VulkanMipmapGenerator.h>
 #include <igl/vulkan/VulkanStagingDevice.h>
 #include <igl/vulkan/VulkanTexture.h>
 
@@ -30,10 +31,12 @@ Result Texture::create(const TextureDesc& desc) {
                                 ? ctx.getClosestDepthStencilFormat(desc_.format)
                                 : textureFormatToVkFormat(desc_.format);
 
-  if (!IGL_VERIFY(desc_.options == 0)) {
+  if (!IGL_VERIFY((desc_.options & ~(TextureDesc::TextureOptionBits::Sparse |
+                                      TextureDesc::TextureOptionBits::MutableFormat)) == 0)) {
     IGL_ASSERT_NOT_IMPLEMENTED();
     return Result(Result::Code::Unimplemented);
   }
+  const bool isSparse = (desc_.options & TextureDesc::TextureOptionBits::Sparse) != 0;
   const igl::TextureType type = desc_.type;
   if (!IGL_VERIFY(type == TextureType::TwoD || type == TextureType::TwoDArray ||
                   type == TextureType::Cube || type == TextureType::ThreeD)) {
@@ -73,13 +76,37 @@ Result Texture::create(const TextureDesc& desc) {
     desc_.storage = ResourceStorage::Private;
   }
 
+  // memoryless textures can only be attachments which are never loaded or stored
+  if (desc_.storage == ResourceStorage::Memoryless) {
+    if (!IGL_VERIFY(desc_.usage == TextureDesc::TextureUsageBits::Attachment)) {
+      return Result(Result::Code::ArgumentInvalid,
+                    "Memoryless textures can only have the Attachment usage");
+    }
+    if (!ctx.hasLazilyAllocatedMemory_) {
+      desc_.storage = ResourceStorage::Private;
+    }
+  }
+  const bool isMemoryless = desc_.storage == ResourceStorage::Memoryless;
+
+  if (isSparse) {
+    if (!ctx.useSparseResidency_) {
+      return Result(Result::Code::Unsupported, "Sparse textures are not supported");
+    }
+    if (!IGL_VERIFY((type == TextureType::TwoD || type == TextureType::TwoDArray) &&
+                    desc_.numSamples <= 1 && desc_.storage == ResourceStorage::Private &&
+                    !getProperties().isDepthOrStencil())) {
+      return Result(Result::Code::ArgumentInvalid,
+                    "Sparse textures must be private single-sampled 2D or 2D array color textures");
+    }
+  }
+
   /* Use staging device to transfer data into the image when the storage is private to the device */
   VkImageUsageFlags usageFlags =
       (desc_.storage == ResourceStorage::Private) ? VK_IMAGE_USAGE_TRANSFER_DST_BIT : 0;
 
   // On M1 Macs, depth texture has to be ResourceStorage::Private.
   if (!ctx.useStaging_ && desc_.storage == ResourceStorage::Private &&
-      !getProperties().isDepthOrStencil()) {
+      !getProperties().isDepthOrStencil() && !isSparse) {
     desc_.storage = ResourceStorage::Shared;
   }
 
@@ -93,10 +120,19 @@ Result Texture::create(const TextureDesc& desc) {
   if (desc_.usage & TextureDesc::TextureUsageBits::Attachment) {
     usageFlags |= getProperties().isDepthOrStencil() ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
                                                      : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    // color attachments can be read by framebuffer fetch (RenderPassDesc::framebufferFetch)
+    if (!getProperties().isDepthOrStencil() && ctx.dslInputAttachments_) {
+      usageFlags |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+    }
   }
 
-  // For now, always set this flag so we can read it back
-  usageFlags |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+  if (isMemoryless) {
+    // transient attachments cannot have any usage other than attachment ones
+    usageFlags |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+  } else {
+    // For now, always set these flags so we can read it back and blit into it
+    usageFlags |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+  }
 
   IGL_ASSERT_MSG(usageFlags != 0, "Invalid usage flags");
 
@@ -137,6 +173,40 @@ Result Texture::create(const TextureDesc& desc) {
     return Result(Result::Code::Unimplemented, "Unimplemented or unsupported texture type.");
   }
 
+  if (isSparse) {
+    uint32_t numSparseProperties = 0;
+    vkGetPhysicalDeviceSparseImageFormatProperties(ctx.getVkPhysicalDevice(),
+                                                   vkFormat,
+                                                   imageType,
+                                                   VK_SAMPLE_COUNT_1_BIT,
+                                                   usageFlags,
+                                                   VK_IMAGE_TILING_OPTIMAL,
+                                                   &numSparseProperties,
+                                                   nullptr);
+    if (numSparseProperties == 0) {
+      return Result(Result::Code::Unsupported, "Sparse residency is not supported for this format");
+    }
+    // memory is bound to the tiles by CommandQueue::updateTextureTiles()
+    createFlags |= VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT;
+  }
+
+  if (desc_.options & TextureDesc::TextureOptionBits::MutableFormat) {
+    // views may reinterpret sRGB images as linear ones and vice versa
+    createFlags |= VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT;
+  }
+
+#if defined(VK_EXT_host_image_copy)
+  // textures which are only sampled are uploaded by the host, see VulkanStagingDevice
+  const VkImageUsageFlags deviceWriteFlags = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                             VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                                             VK_IMAGE_USAGE_STORAGE_BIT;
+  if (desc_.storage == ResourceStorage::Private && !isSparse &&
+      samples == VK_SAMPLE_COUNT_1_BIT && (usageFlags & deviceWriteFlags) == 0 &&
+      ctx.canUseHostImageCopy(imageType, vkFormat, usageFlags, createFlags)) {
+    usageFlags |= VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT;
+  }
+#endif // VK_EXT_host_image_copy
+
   Result result;
   auto image = ctx.createImage(
       imageType,
@@ -175,7 +245,45 @@ Result Texture::create(const TextureDesc& desc) {
     return Result(Result::Code::InvalidOperation, "Cannot create VulkanImageView");
   }
 
-  texture_ = ctx.createTexture(std::move(image), std::move(imageView));
+  texture_ = ctx.createTexture(std::move(image), std::move(imageView), &result);
+  if (!result.isOk()) {
+    return result;
+  }
+
+  // the pointer is only valid during creation
+  desc_.initialData = nullptr;
+  if (desc.initialData) {
+    if (isMemoryless || isSparse) {
+      return Result(Result::Code::ArgumentInvalid,
+                    "Memoryless and sparse textures cannot have initial data");
+    }
+    return uploadInitialData(desc.initialData);
+  }
+
+  return Result();
+}
+
+Result Texture::uploadInitialData(const void* data) const {
+  const std::vector<TextureRegionUpload> regions = getInitialDataRegions(data);
+  if (texture_->getVulkanImage().type_ == VK_IMAGE_TYPE_3D) {
+    return ITexture::uploadRegions(regions);
+  }
+
+  // all layers and mip-levels go through a single staging copy and submit
+  std::vector<VulkanStagingDevice::ImageRegion2D> imageRegions;
+  imageRegions.reserve(regions.size());
+  for (const auto& region : regions) {
+    const auto& range = region.range;
+    imageRegions.push_back({
+        ivkGetRect2D(0, 0, (uint32_t)range.width, (uint32_t)range.height),
+        (uint32_t)range.mipLevel,
+        (uint32_t)range.layer,
+        region.data,
+        0,
+    });
+  }
+  const VulkanContext& ctx = device_.getVulkanContext();
+  ctx.stagingDevice_->imageRegions2D(texture_->getVulkanImage(), imageRegions, getProperties());
 
   return Result();
 }
@@ -184,6 +292,9 @@ Result Texture::upload(const TextureRangeDesc& range, const void* data, size_t b
   if (!data) {
     return igl::Result();
   }
+  if (isView_) {
+    return Result(Result::Code::Unsupported, "Texture views cannot be uploaded to");
+  }
   const auto [result, _] = validateRange(range);
   if (!result.isOk()) {
     return result;
@@ -256,10 +367,63 @@ Result Texture::upload(const TextureRangeDesc& range, const void* data, size_t b
   return Result();
 }
 
+Result Texture::uploadRegions(const std::vector<TextureRegionUpload>& regions) const {
+  if (isView_) {
+    return Result(Result::Code::Unsupported, "Texture views cannot be uploaded to");
+  }
+  if (texture_->getVulkanImage().type_ == VK_IMAGE_TYPE_3D) {
+    return ITexture::uploadRegions(regions);
+  }
+
+  std::vector<VulkanStagingDevice::ImageRegion2D> imageRegions;
+  imageRegions.reserve(regions.size());
+
+  for (const auto& region : regions) {
+    if (!region.data) {
+      continue;
+    }
+    const auto& range = region.range;
+    const auto [result, _] = validateRange(range);
+    if (!result.isOk()) {
+      return result;
+    }
+    if (range.numMipLevels != 1) {
+      return Result(Result::Code::Unsupported, "Regions can only cover one mip-level");
+    }
+
+    // every layer of the range is its own region
+    const size_t bytesPerLayer =
+        (region.bytesPerRow ? region.bytesPerRow : getProperties().getBytesPerRow(range)) *
+        getProperties().getRows(range);
+    for (size_t layer = 0; layer != range.numLayers; ++layer) {
+      imageRegions.push_back({
+          ivkGetRect2D((int32_t)range.x,
+                       (int32_t)range.y,
+                       (uint32_t)range.width,
+                       (uint32_t)range.height),
+          (uint32_t)range.mipLevel,
+          (uint32_t)(range.layer + layer),
+          static_cast<const uint8_t*>(region.data) + layer * bytesPerLayer,
+          region.bytesPerRow,
+      });
+    }
+  }
+
+  if (!imageRegions.empty()) {
+    const VulkanContext& ctx = device_.getVulkanContext();
+    ctx.stagingDevice_->imageRegions2D(texture_->getVulkanImage(), imageRegions, getProperties());
+  }
+
+  return Result();
+}
+
 Result Texture::uploadCube(const TextureRangeDesc& range,
                            TextureCubeFace face,
                            const void* data,
                            size_t bytesPerRow) const {
+  if (isView_) {
+    return Result(Result::Code::Unsupported, "Texture views cannot be uploaded to");
+  }
   const auto [result, _] = validateRange(range);
   if (!result.isOk()) {
     return result;
@@ -285,7 +449,7 @@ Dimensions Texture::getDimensions() const {
 
 VkFormat Texture::getVkFormat() const {
   IGL_ASSERT(texture_);
-  return texture_ ? texture_->getVulkanImage().imageFormat_ : VK_FORMAT_UNDEFINED;
+  return texture_ ? texture_->getViewFormat() : VK_FORMAT_UNDEFINED;
 }
 
 size_t Texture::getNumLayers() const {
@@ -309,16 +473,23 @@ size_t Texture::getNumMipLevels() const {
 }
 
 void Texture::generateMipmap(ICommandQueue& /*cmdQueue*/) const {
-  if (desc_.numMipLevels > 1) {
+  // mipmaps of views are generated through the texture they alias
+  IGL_ASSERT_MSG(!isView_, "Cannot generate mipmaps of a texture view");
+  if (desc_.numMipLevels > 1 && !isView_) {
     const auto& ctx = device_.getVulkanContext();
     const auto& wrapper = ctx.immediate_->acquire();
-    texture_->getVulkanImage().generateMipmap(wrapper.cmdBuf_);
+    const VulkanImage& image = texture_->getVulkanImage();
+    if (ctx.mipmapGenerator_ && ctx.mipmapGenerator_->isSupported(image)) {
+      ctx.mipmapGenerator_->generate(wrapper.cmdBuf_, image, wrapper.handle_);
+    } else {
+      image.generateMipmap(wrapper.cmdBuf_);
+    }
     ctx.immediate_->submit(wrapper);
   }
 }
 
 bool Texture::isRequiredGenerateMipmap() const {
-  if (!texture_ || desc_.numMipLevels <= 1) {
+  if (!texture_ || desc_.numMipLevels <= 1 || isView_) {
     return false;
   }
 
@@ -329,32 +500,47 @@ uint64_t Texture::getTextureId() const {
   return texture_ ? texture_->getTextureId() : 0;
 }
 
+Dimensions Texture::getTileSize() const {
+  if (!texture_) {
+    return Dimensions(0, 0, 0);
+  }
+  const VkExtent3D extent = texture_->getVulkanImage().getSparseTileExtent();
+  return Dimensions(extent.width, extent.height, extent.depth);
+}
+
 VkImageView Texture::getVkImageView() const {
   return texture_ ? texture_->getVulkanImageView().vkImageView_ : VK_NULL_HANDLE;
 }
 
-VkImageView Texture::getVkImageViewForFramebuffer(uint32_t level, FramebufferMode mode) const {
-  if (level < imageViewForFramebuffer_.size() && imageViewForFramebuffer_[level]) {
-    return imageViewForFramebuffer_[level]->getVkImageView();
-  }
-
-  if (level >= imageViewForFramebuffer_.size()) {
-    imageViewForFramebuffer_.resize(level + 1);
-  }
-
+VkImageView Texture::getVkImageViewForFramebuffer(uint32_t level,
+                                                  uint32_t layer,
+                                                  FramebufferMode mode) const {
   const VkImageAspectFlags flags = texture_->getVulkanImage().getImageAspectFlags();
   const bool isStereo = mode == FramebufferMode::Stereo;
 
-  imageViewForFramebuffer_[level] = texture_->getVulkanImage().createImageView(
-      isStereo ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D,
-      textureFormatToVkFormat(desc_.format),
-      flags,
-      level,
-      1u,
-      0u,
-      isStereo ? VK_REMAINING_ARRAY_LAYERS : 1u);
+  IGL_ASSERT_MSG(!isStereo || layer == 0, "Stereo framebuffers render into all layers");
+
+  return texture_
+      ->getOrCreateImageView(isStereo ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D,
+                             flags,
+                             level,
+                             1u,
+                             isStereo ? 0u : layer,
+                             isStereo ? VK_REMAINING_ARRAY_LAYERS : 1u)
+      .vkImageView_;
+}
+
+VkImageSubresourceRange Texture::getVkImageSubresourceRangeForFramebuffer(
+    uint32_t level,
+    uint32_t layer,
+    FramebufferMode mode) const {
+  const VkImageAspectFlags flags = texture_->getVulkanImage().getImageAspectFlags();
+  const uint32_t baseLevel = texture_->getBaseLevel() + level;
+  const uint32_t baseLayer = texture_->getBaseLayer();
 
-  return imageViewForFramebuffer_[level]->vkImageView_;
+  return mode == FramebufferMode::Stereo
+             ? VkImageSubresourceRange{flags, baseLevel, 1, baseLayer, VK_REMAINING_ARRAY_LAYERS}
+             : VkImageSubresourceRange{flags, baseLevel, 1, baseLayer + layer, 1};
 }
 
 VkImage Texture::getVkImage() const {
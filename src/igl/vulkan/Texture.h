@@ -44,6 +44,7 @@ class Texture final : public ITexture {
                     TextureCubeFace face,
                     const void* data,
                     size_t bytesPerRow = 0) const override;
+  Result uploadRegions(const std::vector<TextureRegionUpload>& regions) const override;
 
   // Accessors
   Dimensions getDimensions() const override;
@@ -55,12 +56,18 @@ class Texture final : public ITexture {
   void generateMipmap(ICommandQueue& cmdQueue) const override;
   bool isRequiredGenerateMipmap() const override;
   uint64_t getTextureId() const override;
+  Dimensions getTileSize() const override;
   VkFormat getVkFormat() const;
 
   VkImageView getVkImageView() const;
+  // framebuffers can render only into 1 mip-level and 1 layer (or all layers in stereo mode)
   VkImageView getVkImageViewForFramebuffer(uint32_t level,
-                                           FramebufferMode mode) const; // framebuffers can render
-                                                                        // only into 1 mip-level
+                                           uint32_t layer,
+                                           FramebufferMode mode) const;
+  // the subresources seen through getVkImageViewForFramebuffer()
+  VkImageSubresourceRange getVkImageSubresourceRangeForFramebuffer(uint32_t level,
+                                                                   uint32_t layer,
+                                                                   FramebufferMode mode) const;
   VkImage getVkImage() const;
   VulkanTexture& getVulkanTexture() const {
     IGL_ASSERT(texture_);
@@ -68,16 +75,22 @@ class Texture final : public ITexture {
   }
 
   bool isSwapchainTexture() const;
+  // created by IDevice::createTextureView() and aliasing another texture's image
+  bool isView() const {
+    return isView_;
+  }
 
  private:
   Result create(const TextureDesc& desc);
+  // uploads TextureDesc::initialData into the new texture
+  Result uploadInitialData(const void* data) const;
 
  protected:
   const igl::vulkan::Device& device_;
   TextureDesc desc_;
 
   std::shared_ptr<VulkanTexture> texture_;
-  mutable std::vector<std::shared_ptr<VulkanImageView>> imageViewForFramebuffer_;
+  bool isView_ = false;
 };
 
 } // namespace vulkan
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/Timer.h>
+
+#include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanHelpers.h>
+
+namespace igl {
+namespace vulkan {
+
+Timer::Timer(const VulkanContext& ctx, Result* outResult) : ctx_(ctx) {
+  IGL_PROFILER_FUNCTION();
+
+  const VkPhysicalDeviceLimits& limits = ctx_.getVkPhysicalDeviceProperties().limits;
+
+  if (!limits.timestampComputeAndGraphics) {
+    Result::setResult(outResult, Result::Code::Unsupported, "Timestamp queries are not supported");
+    return;
+  }
+
+  timestampPeriod_ = limits.timestampPeriod;
+
+  VkDevice device = ctx_.getVkDevice();
+
+  const VkResult result = ivkCreateQueryPool(device, VK_QUERY_TYPE_TIMESTAMP, 2, 0, &queryPool_);
+
+  if (result != VK_SUCCESS) {
+    VK_ASSERT(result);
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create a query pool");
+    return;
+  }
+
+  VK_ASSERT(ivkSetDebugObjectName(
+      device, VK_OBJECT_TYPE_QUERY_POOL, (uint64_t)queryPool_, "Query Pool: Timer"));
+
+  Result::setOk(outResult);
+}
+
+Timer::~Timer() {
+  if (queryPool_ == VK_NULL_HANDLE) {
+    return;
+  }
+
+  ctx_.deferredDestroy(VulkanContext::DestructionType::QueryPool, (uint64_t)queryPool_);
+}
+
+void Timer::begin(VkCommandBuffer cmdBuf) {
+  IGL_ASSERT(queryPool_ != VK_NULL_HANDLE);
+
+  vkCmdResetQueryPool(cmdBuf, queryPool_, 0, 2);
+  vkCmdWriteTimestamp(cmdBuf, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool_, 0);
+
+  isPending_ = false;
+  hasResults_ = false;
+  elapsedTimeNanos_ = 0;
+}
+
+void Timer::end(VkCommandBuffer cmdBuf) {
+  IGL_ASSERT(queryPool_ != VK_NULL_HANDLE);
+
+  vkCmdWriteTimestamp(cmdBuf, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool_, 1);
+
+  isPending_ = true;
+}
+
+bool Timer::resultsAvailable() const {
+  if (!isPending_) {
+    return hasResults_;
+  }
+
+  uint64_t timestamps[2] = {};
+
+  // no VK_QUERY_RESULT_WAIT_BIT: returns VK_NOT_READY instead of stalling
+  const VkResult result = vkGetQueryPoolResults(ctx_.getVkDevice(),
+                                                queryPool_,
+                                                0,
+                                                2,
+                                                sizeof(timestamps),
+                                                timestamps,
+                                                sizeof(uint64_t),
+                                                VK_QUERY_RESULT_64_BIT);
+
+  if (result != VK_SUCCESS) {
+    return false;
+  }
+
+  isPending_ = false;
+  hasResults_ = true;
+  elapsedTimeNanos_ = timestamps[1] > timestamps[0]
+                          ? static_cast<uint64_t>((timestamps[1] - timestamps[0]) *
+                                                  timestampPeriod_)
+                          : 0;
+
+  return true;
+}
+
+uint64_t Timer::getElapsedTimeNanos() const {
+  return resultsAvailable() ? elapsedTimeNanos_ : 0;
+}
+
+} // namespace vulkan
+} // namespace igl
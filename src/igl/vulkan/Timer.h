@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/Timer.h>
+#include <igl/vulkan/Common.h>
+
+namespace igl {
+namespace vulkan {
+
+class VulkanContext;
+
+/**
+ * @brief Measures GPU time using a pair of timestamp queries. The query pool is read back without
+ * waiting, so resultsAvailable() stays false until the GPU has executed both timestamps.
+ */
+class Timer final : public ITimer {
+ public:
+  Timer(const VulkanContext& ctx, Result* outResult);
+  ~Timer() override;
+
+  [[nodiscard]] bool resultsAvailable() const override;
+  [[nodiscard]] uint64_t getElapsedTimeNanos() const override;
+
+  // record the timestamps; both have to be recorded outside of render passes
+  void begin(VkCommandBuffer cmdBuf);
+  void end(VkCommandBuffer cmdBuf);
+
+ private:
+  const VulkanContext& ctx_;
+  VkQueryPool queryPool_ = VK_NULL_HANDLE;
+  // nanoseconds per timestamp tick
+  double timestampPeriod_ = 1.0;
+  // the end timestamp was recorded but the results have not been read back yet
+  mutable bool isPending_ = false;
+  mutable bool hasResults_ = false;
+  mutable uint64_t elapsedTimeNanos_ = 0;
+};
+
+} // namespace vulkan
+} // namespace igl
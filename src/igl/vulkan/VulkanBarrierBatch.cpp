@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/VulkanBarrierBatch.h>
+
+namespace igl {
+namespace vulkan {
+
+namespace {
+
+// The legacy bits have the same values in both versions of the masks. The finer-grained stages of
+// VK_KHR_synchronization2 are replaced with the legacy stages containing them
+VkPipelineStageFlags toLegacyStageMask(VkPipelineStageFlags2KHR mask) {
+  auto legacyMask = static_cast<VkPipelineStageFlags>(mask & 0xFFFFFFFFull);
+
+  if (mask & (VK_PIPELINE_STAGE_2_COPY_BIT_KHR | VK_PIPELINE_STAGE_2_RESOLVE_BIT_KHR |
+              VK_PIPELINE_STAGE_2_BLIT_BIT_KHR | VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR)) {
+    legacyMask |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+  }
+  if (mask & (VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR |
+              VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR)) {
+    legacyMask |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+  }
+  if (mask & VK_PIPELINE_STAGE_2_PRE_RASTERIZATION_SHADERS_BIT_KHR) {
+    legacyMask |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+  }
+  IGL_ASSERT_MSG((mask & ~(0xFFFFFFFFull | VK_PIPELINE_STAGE_2_COPY_BIT_KHR |
+                           VK_PIPELINE_STAGE_2_RESOLVE_BIT_KHR | VK_PIPELINE_STAGE_2_BLIT_BIT_KHR |
+                           VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR |
+                           VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR |
+                           VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR |
+                           VK_PIPELINE_STAGE_2_PRE_RASTERIZATION_SHADERS_BIT_KHR)) == 0,
+                 "This pipeline stage has no legacy equivalent (yet)");
+
+  return legacyMask;
+}
+
+VkAccessFlags toLegacyAccessMask(VkAccessFlags2KHR mask) {
+  auto legacyMask = static_cast<VkAccessFlags>(mask & 0xFFFFFFFFull);
+
+  if (mask &
+      (VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR)) {
+    legacyMask |= VK_ACCESS_SHADER_READ_BIT;
+  }
+  if (mask & VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR) {
+    legacyMask |= VK_ACCESS_SHADER_WRITE_BIT;
+  }
+  IGL_ASSERT_MSG((mask & ~(0xFFFFFFFFull | VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR |
+                           VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR |
+                           VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR)) == 0,
+                 "This access type has no legacy equivalent (yet)");
+
+  return legacyMask;
+}
+
+} // namespace
+
+void VulkanBarrierBatch::memoryBarrier(VkAccessFlags2KHR srcAccessMask,
+                                       VkAccessFlags2KHR dstAccessMask,
+                                       VkPipelineStageFlags2KHR srcStageMask,
+                                       VkPipelineStageFlags2KHR dstStageMask) {
+  VkMemoryBarrier2KHR barrier = {};
+  barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2_KHR;
+  barrier.srcStageMask = srcStageMask;
+  barrier.srcAccessMask = srcAccessMask;
+  barrier.dstStageMask = dstStageMask;
+  barrier.dstAccessMask = dstAccessMask;
+
+  memoryBarriers_.push_back(barrier);
+}
+
+void VulkanBarrierBatch::imageBarrier(VkImage image,
+                                      VkAccessFlags2KHR srcAccessMask,
+                                      VkAccessFlags2KHR dstAccessMask,
+                                      VkImageLayout oldImageLayout,
+                                      VkImageLayout newImageLayout,
+                                      VkPipelineStageFlags2KHR srcStageMask,
+                                      VkPipelineStageFlags2KHR dstStageMask,
+                                      const VkImageSubresourceRange& subresourceRange) {
+  // A -> B followed by B -> C on the same subresources becomes A -> C
+  for (VkImageMemoryBarrier2KHR& b : imageBarriers_) {
+    if (b.image == image && b.newLayout == oldImageLayout &&
+        b.subresourceRange.aspectMask == subresourceRange.aspectMask &&
+        b.subresourceRange.baseMipLevel == subresourceRange.baseMipLevel &&
+        b.subresourceRange.levelCount == subresourceRange.levelCount &&
+        b.subresourceRange.baseArrayLayer == subresourceRange.baseArrayLayer &&
+        b.subresourceRange.layerCount == subresourceRange.layerCount) {
+      b.srcStageMask |= srcStageMask;
+      b.dstStageMask |= dstStageMask;
+      b.srcAccessMask |= srcAccessMask;
+      b.dstAccessMask |= dstAccessMask;
+      b.newLayout = newImageLayout;
+      return;
+    }
+  }
+
+  VkImageMemoryBarrier2KHR barrier = {};
+  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+  barrier.srcStageMask = srcStageMask;
+  barrier.srcAccessMask = srcAccessMask;
+  barrier.dstStageMask = dstStageMask;
+  barrier.dstAccessMask = dstAccessMask;
+  barrier.oldLayout = oldImageLayout;
+  barrier.newLayout = newImageLayout;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = image;
+  barrier.subresourceRange = subresourceRange;
+
+  imageBarriers_.push_back(barrier);
+}
+
+void VulkanBarrierBatch::bufferBarrier(VkBuffer buffer,
+                                       VkAccessFlags2KHR srcAccessMask,
+                                       VkAccessFlags2KHR dstAccessMask,
+                                       VkDeviceSize offset,
+                                       VkDeviceSize size,
+                                       VkPipelineStageFlags2KHR srcStageMask,
+                                       VkPipelineStageFlags2KHR dstStageMask) {
+  VkBufferMemoryBarrier2KHR barrier = {};
+  barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR;
+  barrier.srcStageMask = srcStageMask;
+  barrier.srcAccessMask = srcAccessMask;
+  barrier.dstStageMask = dstStageMask;
+  barrier.dstAccessMask = dstAccessMask;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.buffer = buffer;
+  barrier.offset = offset;
+  barrier.size = size;
+
+  bufferBarriers_.push_back(barrier);
+}
+
+uint32_t VulkanBarrierBatch::flush(VkCommandBuffer cmdBuf,
+                                   PFN_vkCmdPipelineBarrier2KHR cmdPipelineBarrier2) {
+  if (empty()) {
+    return 0;
+  }
+
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_TRANSITION);
+
+  if (cmdPipelineBarrier2) {
+    VkDependencyInfoKHR dependencyInfo = {};
+    dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+    dependencyInfo.memoryBarrierCount = (uint32_t)memoryBarriers_.size();
+    dependencyInfo.pMemoryBarriers = memoryBarriers_.data();
+    dependencyInfo.bufferMemoryBarrierCount = (uint32_t)bufferBarriers_.size();
+    dependencyInfo.pBufferMemoryBarriers = bufferBarriers_.data();
+    dependencyInfo.imageMemoryBarrierCount = (uint32_t)imageBarriers_.size();
+    dependencyInfo.pImageMemoryBarriers = imageBarriers_.data();
+    cmdPipelineBarrier2(cmdBuf, &dependencyInfo);
+  } else {
+    flushLegacy(cmdBuf);
+  }
+
+  const auto numBarriers = static_cast<uint32_t>(
+      memoryBarriers_.size() + bufferBarriers_.size() + imageBarriers_.size());
+
+  memoryBarriers_.clear();
+  imageBarriers_.clear();
+  bufferBarriers_.clear();
+
+  return numBarriers;
+}
+
+void VulkanBarrierBatch::flushLegacy(VkCommandBuffer cmdBuf) {
+  VkPipelineStageFlags srcStageMask = 0;
+  VkPipelineStageFlags dstStageMask = 0;
+
+  legacyMemoryBarriers_.clear();
+  legacyImageBarriers_.clear();
+  legacyBufferBarriers_.clear();
+
+  for (const VkMemoryBarrier2KHR& b : memoryBarriers_) {
+    srcStageMask |= toLegacyStageMask(b.srcStageMask);
+    dstStageMask |= toLegacyStageMask(b.dstStageMask);
+    legacyMemoryBarriers_.push_back(VkMemoryBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                                                    nullptr,
+                                                    toLegacyAccessMask(b.srcAccessMask),
+                                                    toLegacyAccessMask(b.dstAccessMask)});
+  }
+  for (const VkImageMemoryBarrier2KHR& b : imageBarriers_) {
+    srcStageMask |= toLegacyStageMask(b.srcStageMask);
+    dstStageMask |= toLegacyStageMask(b.dstStageMask);
+    legacyImageBarriers_.push_back(VkImageMemoryBarrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                                                        nullptr,
+                                                        toLegacyAccessMask(b.srcAccessMask),
+                                                        toLegacyAccessMask(b.dstAccessMask),
+                                                        b.oldLayout,
+                                                        b.newLayout,
+                                                        b.srcQueueFamilyIndex,
+                                                        b.dstQueueFamilyIndex,
+                                                        b.image,
+                                                        b.subresourceRange});
+  }
+  for (const VkBufferMemoryBarrier2KHR& b : bufferBarriers_) {
+    srcStageMask |= toLegacyStageMask(b.srcStageMask);
+    dstStageMask |= toLegacyStageMask(b.dstStageMask);
+    legacyBufferBarriers_.push_back(VkBufferMemoryBarrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                                                          nullptr,
+                                                          toLegacyAccessMask(b.srcAccessMask),
+                                                          toLegacyAccessMask(b.dstAccessMask),
+                                                          b.srcQueueFamilyIndex,
+                                                          b.dstQueueFamilyIndex,
+                                                          b.buffer,
+                                                          b.offset,
+                                                          b.size});
+  }
+
+  vkCmdPipelineBarrier(cmdBuf,
+                       srcStageMask ? srcStageMask : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       dstStageMask ? dstStageMask : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                       0,
+                       (uint32_t)legacyMemoryBarriers_.size(),
+                       legacyMemoryBarriers_.data(),
+                       (uint32_t)legacyBufferBarriers_.size(),
+                       legacyBufferBarriers_.data(),
+                       (uint32_t)legacyImageBarriers_.size(),
+                       legacyImageBarriers_.data());
+}
+
+} // namespace vulkan
+} // namespace igl
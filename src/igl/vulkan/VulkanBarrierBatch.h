@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <igl/vulkan/Common.h>
+
+namespace igl {
+namespace vulkan {
+
+/**
+ * @brief Accumulates memory, image and buffer barriers and records all of them with a single
+ * barrier command in flush(). A transition of an image which is already in the batch with the same
+ * subresource range is folded into the existing barrier.
+ *
+ * Barriers take VK_KHR_synchronization2 stage and access masks. With vkCmdPipelineBarrier2() every
+ * barrier keeps its own stage masks, so e.g. a copy-only barrier does not wait for fragment
+ * shaders of another barrier in the same batch. Otherwise the masks are converted to their legacy
+ * equivalents and the stage masks of all accumulated barriers are merged into one
+ * vkCmdPipelineBarrier() call.
+ */
+class VulkanBarrierBatch final {
+ public:
+  void memoryBarrier(VkAccessFlags2KHR srcAccessMask,
+                     VkAccessFlags2KHR dstAccessMask,
+                     VkPipelineStageFlags2KHR srcStageMask,
+                     VkPipelineStageFlags2KHR dstStageMask);
+
+  void imageBarrier(VkImage image,
+                    VkAccessFlags2KHR srcAccessMask,
+                    VkAccessFlags2KHR dstAccessMask,
+                    VkImageLayout oldImageLayout,
+                    VkImageLayout newImageLayout,
+                    VkPipelineStageFlags2KHR srcStageMask,
+                    VkPipelineStageFlags2KHR dstStageMask,
+                    const VkImageSubresourceRange& subresourceRange);
+
+  void bufferBarrier(VkBuffer buffer,
+                     VkAccessFlags2KHR srcAccessMask,
+                     VkAccessFlags2KHR dstAccessMask,
+                     VkDeviceSize offset,
+                     VkDeviceSize size,
+                     VkPipelineStageFlags2KHR srcStageMask,
+                     VkPipelineStageFlags2KHR dstStageMask);
+
+  // Records all accumulated barriers into `cmdBuf`, does nothing if the batch is empty. Uses
+  // `cmdPipelineBarrier2` if it is not null (VK_KHR_synchronization2). Returns the number of
+  // recorded barriers
+  uint32_t flush(VkCommandBuffer cmdBuf, PFN_vkCmdPipelineBarrier2KHR cmdPipelineBarrier2);
+
+  bool empty() const {
+    return memoryBarriers_.empty() && imageBarriers_.empty() && bufferBarriers_.empty();
+  }
+
+ private:
+  void flushLegacy(VkCommandBuffer cmdBuf);
+
+ private:
+  std::vector<VkMemoryBarrier2KHR> memoryBarriers_;
+  std::vector<VkImageMemoryBarrier2KHR> imageBarriers_;
+  std::vector<VkBufferMemoryBarrier2KHR> bufferBarriers_;
+  // converted barriers of flushLegacy(), kept to reuse their memory
+  std::vector<VkMemoryBarrier> legacyMemoryBarriers_;
+  std::vector<VkImageMemoryBarrier> legacyImageBarriers_;
+  std::vector<VkBufferMemoryBarrier> legacyBufferBarriers_;
+};
+
+} // namespace vulkan
+} // namespace igl
@@ -5,6 +5,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <igl/IGLSafeC.h>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanContext.h>
@@ -26,7 +27,14 @@ VulkanBuffer::VulkanBuffer(const VulkanContext& ctx,
   IGL_ASSERT(bufferSize > 0);
 
   // Initialize Buffer Info
-  const VkBufferCreateInfo ci = ivkGetBufferCreateInfo(bufferSize, usageFlags);
+  VkBufferCreateInfo ci = ivkGetBufferCreateInfo(bufferSize, usageFlags);
+  if (!ctx_.sharedQueueFamilyIndices_.empty()) {
+    // accessed from the async compute queue without queue family ownership transfers
+    ci.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    ci.queueFamilyIndexCount = (uint32_t)ctx_.sharedQueueFamilyIndices_.size();
+    ci.pQueueFamilyIndices = ctx_.sharedQueueFamilyIndices_.data();
+  }
+  vkBufferCreateInfo_ = ci;
 
   if (IGL_VULKAN_USE_VMA) {
     // Initialize VmaAllocation Info
@@ -40,6 +48,9 @@ VulkanBuffer::VulkanBuffer(const VulkanContext& ctx,
     if (memFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
       vmaAllocInfo_.requiredFlags |= VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
     }
+    if (isResizableBar()) {
+      vmaAllocInfo_.requiredFlags |= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    }
 
     vmaAllocInfo_.usage = VMA_MEMORY_USAGE_AUTO;
 
@@ -53,6 +64,20 @@ VulkanBuffer::VulkanBuffer(const VulkanContext& ctx,
     // handle memory-mapped buffers
     if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
       vmaMapMemory((VmaAllocator)ctx_.getVmaAllocator(), vmaAllocation_, &mappedPtr_);
+      // coherent memory is only preferred, VMA may have picked another memory type
+      VkMemoryPropertyFlags props = 0;
+      vmaGetAllocationMemoryProperties(
+          (VmaAllocator)ctx_.getVmaAllocator(), vmaAllocation_, &props);
+      isCoherent_ = (props & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+    }
+
+    // device-local buffers can be moved by VulkanDefragmenter unless shaders access them through
+    // their device address, which would change
+    const VkBufferUsageFlags kCopyUsage =
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    if (vmaAllocation_ && !mappedPtr_ && (usageFlags & kCopyUsage) == kCopyUsage &&
+        !(usageFlags & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT_KHR)) {
+      vmaSetAllocationUserData((VmaAllocator)ctx_.getVmaAllocator(), vmaAllocation_, this);
     }
   } else {
     // create buffer
@@ -71,11 +96,17 @@ VulkanBuffer::VulkanBuffer(const VulkanContext& ctx,
     // handle memory-mapped buffers
     if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
       VK_ASSERT(vkMapMemory(device_, vkMemory_, 0, bufferSize_, 0, &mappedPtr_));
+      isCoherent_ = (memFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
     }
   }
 
   IGL_ASSERT(vkBuffer_ != VK_NULL_HANDLE);
 
+  ctx_.bufferMemoryBytes_ += bufferSize_;
+  if (isResizableBar()) {
+    ctx_.resizableBarBufferMemoryBytes_ += bufferSize_;
+  }
+
   // set debug name
   VK_ASSERT(ivkSetDebugObjectName(device_, VK_OBJECT_TYPE_BUFFER, (uint64_t)vkBuffer_, debugName));
 
@@ -91,23 +122,34 @@ VulkanBuffer::VulkanBuffer(const VulkanContext& ctx,
 VulkanBuffer::~VulkanBuffer() {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_DESTROY);
 
+  ctx_.bufferMemoryBytes_ -= bufferSize_;
+  if (isResizableBar()) {
+    ctx_.resizableBarBufferMemoryBytes_ -= bufferSize_;
+  }
+
+  if (!isCoherent_) {
+    std::lock_guard<std::mutex> lock(ctx_.dirtyBuffersMutex_);
+    if (dirtyEnd_ > dirtyBegin_) {
+      auto& buffers = ctx_.dirtyBuffers_;
+      buffers.erase(std::remove(buffers.begin(), buffers.end(), this), buffers.end());
+    }
+  }
+
   if (IGL_VULKAN_USE_VMA) {
     if (mappedPtr_) {
       vmaUnmapMemory((VmaAllocator)ctx_.getVmaAllocator(), vmaAllocation_);
     }
-    ctx_.deferredTask(std::packaged_task<void()>(
-        [vma = ctx_.getVmaAllocator(), buffer = vkBuffer_, allocation = vmaAllocation_]() {
-          vmaDestroyBuffer((VmaAllocator)vma, buffer, allocation);
-        }));
+    // the allocation outlives this object until the GPU is done with it and cannot be moved
+    vmaSetAllocationUserData((VmaAllocator)ctx_.getVmaAllocator(), vmaAllocation_, nullptr);
+    ctx_.deferredDestroy(VulkanContext::DestructionType::VmaBuffer,
+                         (uint64_t)vkBuffer_,
+                         (uint64_t)(uintptr_t)vmaAllocation_);
   } else {
     if (mappedPtr_) {
       vkUnmapMemory(device_, vkMemory_);
     }
-    ctx_.deferredTask(
-        std::packaged_task<void()>([device = device_, buffer = vkBuffer_, memory = vkMemory_]() {
-          vkDestroyBuffer(device, buffer, nullptr);
-          vkFreeMemory(device, memory, nullptr);
-        }));
+    ctx_.deferredDestroy(
+        VulkanContext::DestructionType::Buffer, (uint64_t)vkBuffer_, (uint64_t)vkMemory_);
   }
 }
 
@@ -130,6 +172,45 @@ void VulkanBuffer::flushMappedMemory(VkDeviceSize offset, VkDeviceSize size) con
   }
 }
 
+void VulkanBuffer::markDirty(VkDeviceSize offset, VkDeviceSize size) {
+  IGL_ASSERT(isMapped());
+  IGL_ASSERT(offset + size <= bufferSize_);
+
+  if (isCoherent_ || !size) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(ctx_.dirtyBuffersMutex_);
+
+  if (dirtyEnd_ > dirtyBegin_) {
+    dirtyBegin_ = std::min(dirtyBegin_, offset);
+    dirtyEnd_ = std::max(dirtyEnd_, offset + size);
+  } else {
+    dirtyBegin_ = offset;
+    dirtyEnd_ = offset + size;
+    ctx_.dirtyBuffers_.push_back(this);
+  }
+}
+
+void VulkanBuffer::invalidateMappedMemory(VkDeviceSize offset, VkDeviceSize size) const {
+  if (!IGL_VERIFY(isMapped())) {
+    return;
+  }
+
+  if (IGL_VULKAN_USE_VMA) {
+    vmaInvalidateAllocation((VmaAllocator)ctx_.getVmaAllocator(), vmaAllocation_, offset, size);
+  } else {
+    const VkMappedMemoryRange memoryRange = {
+        VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+        nullptr,
+        vkMemory_,
+        offset,
+        size,
+    };
+    vkInvalidateMappedMemoryRanges(device_, 1, &memoryRange);
+  }
+}
+
 void VulkanBuffer::getBufferSubData(size_t offset, size_t size, void* data) {
   // Only mapped host-visible buffers can be downloaded this way. All other
   // GPU buffers should use a temporary staging buffer
@@ -146,6 +227,12 @@ void VulkanBuffer::getBufferSubData(size_t offset, size_t size, void* data) {
   checked_memcpy(data, size, src, size);
 }
 
+bool VulkanBuffer::isResizableBar() const {
+  const VkMemoryPropertyFlags flags =
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+  return ctx_.resizableBarHeapSize_ && (memFlags_ & flags) == flags;
+}
+
 void VulkanBuffer::bufferSubData(size_t offset, size_t size, const void* data) {
   // Only mapped host-visible buffers can be uploaded this way. All other GPU buffers should use a
   // temporary staging buffer
@@ -39,6 +39,15 @@ class VulkanBuffer {
     return mappedPtr_ != nullptr;
   }
   void flushMappedMemory(VkDeviceSize offset, VkDeviceSize size) const;
+  // records a host write to be flushed together with the writes to other buffers by
+  // VulkanContext::flushMappedMemoryRanges(). Dirty ranges are merged, nothing is recorded for
+  // coherent memory
+  void markDirty(VkDeviceSize offset, VkDeviceSize size);
+  bool isCoherent() const {
+    return isCoherent_;
+  }
+  // makes GPU writes visible to the host, required before reading non-coherent memory
+  void invalidateMappedMemory(VkDeviceSize offset, VkDeviceSize size) const;
   VkBuffer getVkBuffer() const {
     return vkBuffer_;
   }
@@ -51,11 +60,19 @@ class VulkanBuffer {
   VkMemoryPropertyFlags getMemoryPropertyFlags() const {
     return memFlags_;
   }
+  // device-local memory of a discrete GPU mapped through resizable BAR, see
+  // VulkanContext::useResizableBar()
+  bool isResizableBar() const;
 
  private:
+  friend class VulkanContext;
+  friend class VulkanDefragmenter;
+
   const VulkanContext& ctx_;
   VkDevice device_ = VK_NULL_HANDLE;
   VkBuffer vkBuffer_ = VK_NULL_HANDLE;
+  // kept to create an identical VkBuffer when the allocation is moved by VulkanDefragmenter
+  VkBufferCreateInfo vkBufferCreateInfo_ = {};
   VkDeviceMemory vkMemory_ = VK_NULL_HANDLE;
   VmaAllocationCreateInfo vmaAllocInfo_ = {};
   VmaAllocation vmaAllocation_ = VK_NULL_HANDLE;
@@ -63,6 +80,10 @@ class VulkanBuffer {
   VkDeviceSize bufferSize_ = 0;
   VkMemoryPropertyFlags memFlags_ = 0;
   void* mappedPtr_ = nullptr;
+  bool isCoherent_ = true;
+  // bytes written by the host since the last flush, guarded by VulkanContext::dirtyBuffersMutex_
+  VkDeviceSize dirtyBegin_ = 0;
+  VkDeviceSize dirtyEnd_ = 0;
 };
 
 } // namespace vulkan
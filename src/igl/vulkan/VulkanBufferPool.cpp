@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/VulkanBufferPool.h>
+
+#include <algorithm>
+
+#include <igl/vulkan/VulkanBuffer.h>
+#include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanDevice.h>
+
+namespace igl {
+namespace vulkan {
+
+VulkanBufferPool::VulkanBufferPool(const VulkanContext& ctx,
+                                   VkDeviceSize blockSize,
+                                   VkDeviceSize maxAllocationSize) :
+  ctx_(ctx), blockSize_(blockSize), maxAllocationSize_(std::min(maxAllocationSize, blockSize)) {
+  const VkPhysicalDeviceLimits& limits = ctx_.getVkPhysicalDeviceProperties().limits;
+
+  // every sub-allocation can be bound as a uniform or storage buffer, accessed via a buffer device
+  // address, and flushed when mapped - all of these limits are powers of two
+  alignment_ = std::max({alignment_,
+                         limits.minUniformBufferOffsetAlignment,
+                         limits.minStorageBufferOffsetAlignment,
+                         limits.nonCoherentAtomSize});
+}
+
+VulkanBufferPool::~VulkanBufferPool() = default;
+
+VulkanBufferPool::Allocation VulkanBufferPool::allocate(VkDeviceSize size,
+                                                        VkBufferUsageFlags usageFlags,
+                                                        VkMemoryPropertyFlags memFlags) {
+  IGL_PROFILER_FUNCTION();
+
+  if (size == 0 || size > maxAllocationSize_) {
+    return {};
+  }
+
+  const VkPhysicalDeviceLimits& limits = ctx_.getVkPhysicalDeviceProperties().limits;
+
+  // let the caller report the error when creating a dedicated buffer
+  if ((usageFlags & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) && size > limits.maxUniformBufferRange) {
+    return {};
+  }
+
+  const VkDeviceSize alignedSize = getAlignedSize(size);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  processPendingFrees();
+
+  Allocation allocation;
+  allocation.size = size;
+
+  for (Block& block : blocks_) {
+    if (block.usageFlags == usageFlags && block.memFlags == memFlags &&
+        allocateFromBlock(block, alignedSize, allocation.offset)) {
+      allocation.buffer = block.buffer;
+      return allocation;
+    }
+  }
+
+  Block block;
+  block.buffer = std::make_shared<VulkanBuffer>(ctx_,
+                                                ctx_.device_->getVkDevice(),
+                                                blockSize_,
+                                                usageFlags,
+                                                memFlags,
+                                                "Buffer: pooled block");
+  block.usageFlags = usageFlags;
+  block.memFlags = memFlags;
+  block.freeRanges[0] = blockSize_;
+
+  if (!IGL_VERIFY(block.buffer->getVkBuffer() != VK_NULL_HANDLE)) {
+    return {};
+  }
+
+  allocateFromBlock(block, alignedSize, allocation.offset);
+  allocation.buffer = block.buffer;
+
+  blocks_.push_back(std::move(block));
+
+  return allocation;
+}
+
+void VulkanBufferPool::free(const Allocation& allocation) {
+  if (allocation.empty()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // the GPU might still be accessing this range
+  pendingFrees_.push_back({allocation, ctx_.immediate_->getLastSubmitHandle()});
+}
+
+void VulkanBufferPool::processPendingFrees() {
+  while (!pendingFrees_.empty() && ctx_.immediate_->isReady(pendingFrees_.front().handle, true)) {
+    release(pendingFrees_.front().allocation);
+    pendingFrees_.pop_front();
+  }
+}
+
+void VulkanBufferPool::release(const Allocation& allocation) {
+  auto block = std::find_if(blocks_.begin(), blocks_.end(), [&allocation](const Block& b) {
+    return b.buffer == allocation.buffer;
+  });
+
+  if (!IGL_VERIFY(block != blocks_.end())) {
+    return;
+  }
+
+  auto& ranges = block->freeRanges;
+
+  auto it = ranges.emplace(allocation.offset, getAlignedSize(allocation.size)).first;
+
+  // merge with the next free range
+  auto next = std::next(it);
+  if (next != ranges.end() && it->first + it->second == next->first) {
+    it->second += next->second;
+    ranges.erase(next);
+  }
+
+  // merge with the previous free range
+  if (it != ranges.begin()) {
+    auto prev = std::prev(it);
+    if (prev->first + prev->second == it->first) {
+      prev->second += it->second;
+      ranges.erase(it);
+    }
+  }
+}
+
+VkDeviceSize VulkanBufferPool::getAlignedSize(VkDeviceSize size) const {
+  return (size + alignment_ - 1) & ~(alignment_ - 1);
+}
+
+bool VulkanBufferPool::allocateFromBlock(Block& block, VkDeviceSize size, VkDeviceSize& outOffset) {
+  // first fit: free ranges are always aligned because all allocation sizes are aligned
+  for (auto it = block.freeRanges.begin(); it != block.freeRanges.end(); ++it) {
+    if (it->second < size) {
+      continue;
+    }
+    outOffset = it->first;
+    const VkDeviceSize remaining = it->second - size;
+    block.freeRanges.erase(it);
+    if (remaining) {
+      block.freeRanges.emplace(outOffset + size, remaining);
+    }
+    return true;
+  }
+
+  return false;
+}
+
+} // namespace vulkan
+} // namespace igl
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
+
+namespace igl {
+namespace vulkan {
+
+class VulkanBuffer;
+class VulkanContext;
+
+/**
+ * @brief Sub-allocates small buffers from large VkBuffer blocks so that creating a small
+ * vulkan::Buffer does not require a new VkBuffer and a new memory allocation. Blocks are shared
+ * only by allocations with the same usage and memory property flags. Blocks are never released
+ * before the pool is destroyed.
+ */
+class VulkanBufferPool final {
+ public:
+  struct Allocation {
+    std::shared_ptr<VulkanBuffer> buffer;
+    VkDeviceSize offset = 0;
+    // the requested size, the range reserved in the block can be larger due to alignment
+    VkDeviceSize size = 0;
+
+    bool empty() const {
+      return buffer == nullptr;
+    }
+  };
+
+  VulkanBufferPool(const VulkanContext& ctx,
+                   VkDeviceSize blockSize,
+                   VkDeviceSize maxAllocationSize);
+  ~VulkanBufferPool();
+
+  VulkanBufferPool(const VulkanBufferPool&) = delete;
+  VulkanBufferPool& operator=(const VulkanBufferPool&) = delete;
+
+  /// Returns an empty allocation if `size` cannot be sub-allocated; the caller should create a
+  /// dedicated buffer instead
+  Allocation allocate(VkDeviceSize size,
+                      VkBufferUsageFlags usageFlags,
+                      VkMemoryPropertyFlags memFlags);
+  /// The range becomes available again once the last submitted command buffer has completed
+  void free(const Allocation& allocation);
+
+ private:
+  struct Block {
+    std::shared_ptr<VulkanBuffer> buffer;
+    VkBufferUsageFlags usageFlags = 0;
+    VkMemoryPropertyFlags memFlags = 0;
+    // offset -> size of every free range, adjacent ranges are always merged
+    std::map<VkDeviceSize, VkDeviceSize> freeRanges;
+  };
+
+  struct PendingFree {
+    Allocation allocation;
+    VulkanImmediateCommands::SubmitHandle handle;
+  };
+
+  void processPendingFrees();
+  void release(const Allocation& allocation);
+  VkDeviceSize getAlignedSize(VkDeviceSize size) const;
+  static bool allocateFromBlock(Block& block, VkDeviceSize size, VkDeviceSize& outOffset);
+
+ private:
+  const VulkanContext& ctx_;
+  const VkDeviceSize blockSize_;
+  const VkDeviceSize maxAllocationSize_;
+  VkDeviceSize alignment_ = 16;
+
+  std::mutex mutex_;
+  std::vector<Block> blocks_;
+  std::deque<PendingFree> pendingFrees_;
+};
+
+} // namespace vulkan
+} // namespace igl
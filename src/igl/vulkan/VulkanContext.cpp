@@ -5,11 +5,15 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <array>
+#include <cstdio>
 #include <cstring>
+#include <numeric>
 #include <set>
 #include <vector>
 
+#include <igl/CacheFile.h>
 #include <igl/IGLSafeC.h>
 
 // For vk_mem_alloc.h, define this before including VulkanContext.h in exactly
@@ -26,14 +30,18 @@
 #include <igl/vulkan/EnhancedShaderDebuggingStore.h>
 #include <igl/vulkan/SyncManager.h>
 #include <igl/vulkan/VulkanBuffer.h>
+#include <igl/vulkan/VulkanBufferPool.h>
 #include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanDefragmenter.h>
 #include <igl/vulkan/VulkanDescriptorSetLayout.h>
 #include <igl/vulkan/VulkanDevice.h>
 #include <igl/vulkan/VulkanExtensions.h>
+#include <igl/vulkan/VulkanMipmapGenerator.h>
 #include <igl/vulkan/VulkanPipelineBuilder.h>
 #include <igl/vulkan/VulkanPipelineLayout.h>
 #include <igl/vulkan/VulkanSampler.h>
 #include <igl/vulkan/VulkanSemaphore.h>
+#include <igl/vulkan/VulkanSpirvCache.h>
 #include <igl/vulkan/VulkanSwapchain.h>
 #include <igl/vulkan/VulkanTexture.h>
 #include <igl/vulkan/VulkanVma.h>
@@ -59,6 +67,27 @@ const uint32_t kBinding_Sampler = 4;
 const uint32_t kBinding_SamplerShadow = 5;
 const uint32_t kBinding_StorageImages = 6;
 
+// maxPushConstantsSize is guaranteed to be at least 128 bytes
+// https://www.khronos.org/registry/vulkan/specs/1.3/html/vkspec.html#features-limits
+// Table 32. Required Limits
+const uint32_t kPushConstantsSize = 128;
+
+// keep only the indices of existing resources which fit into the bindless arrays
+template<typename T>
+void getIndicesToUpdate(std::vector<uint32_t>& indices,
+                        const std::vector<std::shared_ptr<T>>& resources,
+                        uint32_t capacity) {
+  std::sort(indices.begin(), indices.end());
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+  indices.erase(std::remove_if(indices.begin(),
+                               indices.end(),
+                               [&resources, capacity](uint32_t index) {
+                                 return index >= capacity || index >= resources.size() ||
+                                        !resources[index];
+                               }),
+                indices.end());
+}
+
 #if defined(VK_EXT_debug_utils) && IGL_PLATFORM_WIN
 VKAPI_ATTR VkBool32 VKAPI_CALL
 vulkanDebugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT msgSeverity,
@@ -186,6 +215,75 @@ bool validateImageLimits(VkImageType imageType,
   return true;
 }
 
+/*
+ On-disk pipeline cache layout: PipelineCacheFileHeader followed by the data returned by
+ vkGetPipelineCacheData(). The header lets us reject stale or corrupted files before handing them
+ over to the driver, which is not guaranteed to validate the blob.
+ */
+const uint32_t kPipelineCacheFileMagic = 0x50434749; // "IGCP"
+const uint32_t kPipelineCacheFileVersion = 1;
+
+struct PipelineCacheFileHeader {
+  uint32_t magic = kPipelineCacheFileMagic;
+  uint32_t version = kPipelineCacheFileVersion;
+  uint32_t vendorID = 0;
+  uint32_t deviceID = 0;
+  uint32_t driverVersion = 0;
+  uint8_t pipelineCacheUUID[VK_UUID_SIZE] = {};
+  // keeps `dataSize` aligned without implicit padding, so no uninitialized bytes are written
+  uint32_t reserved = 0;
+  uint64_t dataSize = 0;
+  uint64_t dataHash = 0;
+};
+
+static_assert(sizeof(PipelineCacheFileHeader) == 6 * sizeof(uint32_t) + VK_UUID_SIZE +
+                                                     2 * sizeof(uint64_t));
+
+PipelineCacheFileHeader getPipelineCacheFileHeader(const VkPhysicalDeviceProperties& props) {
+  PipelineCacheFileHeader header;
+  header.vendorID = props.vendorID;
+  header.deviceID = props.deviceID;
+  header.driverVersion = props.driverVersion;
+  memcpy(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE);
+  return header;
+}
+
+bool isPipelineCacheDataCompatible(const std::vector<uint8_t>& data,
+                                   const VkPhysicalDeviceProperties& props) {
+  if (data.size() < sizeof(VkPipelineCacheHeaderVersionOne)) {
+    return false;
+  }
+
+  VkPipelineCacheHeaderVersionOne header = {};
+  memcpy(&header, data.data(), sizeof(header));
+
+  return header.headerSize >= sizeof(header) &&
+         header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+         header.vendorID == props.vendorID && header.deviceID == props.deviceID &&
+         memcmp(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+#if defined(VK_EXT_host_image_copy)
+// returns true if vkCopyMemoryToImageEXT() can write images in `layout`
+bool hasHostImageCopyDstLayout(VkPhysicalDevice physicalDevice, VkImageLayout layout) {
+  VkPhysicalDeviceHostImageCopyPropertiesEXT hostImageCopyProps = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_PROPERTIES_EXT};
+  VkPhysicalDeviceProperties2 props = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+                                       &hostImageCopyProps};
+  vkGetPhysicalDeviceProperties2(physicalDevice, &props);
+  std::vector<VkImageLayout> layouts(hostImageCopyProps.copyDstLayoutCount);
+  hostImageCopyProps.pCopyDstLayouts = layouts.data();
+  vkGetPhysicalDeviceProperties2(physicalDevice, &props);
+  layouts.resize(hostImageCopyProps.copyDstLayoutCount);
+  return std::find(layouts.begin(), layouts.end(), layout) != layouts.end();
+}
+#endif // VK_EXT_host_image_copy
+
+double getElapsedMilliseconds(std::chrono::steady_clock::time_point startTime) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime)
+      .count();
+}
+
 } // namespace
 
 namespace igl {
@@ -204,6 +302,8 @@ VulkanContext::VulkanContext(const VulkanContextConfig& config,
   config_(config) {
   IGL_PROFILER_THREAD("MainThread");
 
+  const auto startTime = std::chrono::steady_clock::now();
+
   pimpl_ = std::make_unique<VulkanContextImpl>();
 
   if (volkInitialize() != VK_SUCCESS) {
@@ -211,13 +311,13 @@ VulkanContext::VulkanContext(const VulkanContextConfig& config,
     exit(255);
   };
 
-  glslang_initialize_process();
-
   createInstance(numExtraInstanceExtensions, extraInstanceExtensions);
 
-  if (window) {
+  if (window && !config_.headless) {
     createSurface(window, display);
   }
+
+  startupTimings_.instance = getElapsedMilliseconds(startTime);
 }
 
 VulkanContext::~VulkanContext() {
@@ -227,12 +327,17 @@ VulkanContext::~VulkanContext() {
     waitIdle();
   }
 
+  defragmenter_.reset(nullptr);
+
+#if IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
   enhancedShaderDebuggingStore_.reset(nullptr);
+#endif // IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
 
   textures_.clear();
   samplers_.clear();
 
-  // This will free an internal buffer that was allocated by VMA
+  // This will free the pooled blocks and an internal buffer that were allocated by VMA
+  bufferPool_.reset(nullptr);
   stagingDevice_.reset(nullptr);
 
   VkDevice device = device_ ? device_->getVkDevice() : VK_NULL_HANDLE;
@@ -242,24 +347,51 @@ VulkanContext::~VulkanContext() {
     }
   }
   DUBs_.reset();
+  descriptorBufferBindless_.reset();
+  retiredDescriptorBuffers_.clear();
 
   dslDynamicUniformBuffer_.reset(nullptr);
+  dslInputAttachments_.reset(nullptr);
   dslBindless_.reset(nullptr);
   pipelineLayoutGraphics_.reset(nullptr);
   pipelineLayoutCompute_.reset(nullptr);
+  mipmapGenerator_.reset(nullptr);
+  retiredDSLs_.clear();
+  retiredPipelineLayouts_.clear();
   swapchain_.reset(nullptr); // Swapchain has to be destroyed prior to Surface
 
   waitDeferredTasks();
 
+  freeSecondaryCommandBuffers_.clear();
+
+  computeImmediate_.reset(nullptr);
   immediate_.reset(nullptr);
 
+#if defined(IGL_WITH_TRACY_GPU)
+  if (tracyCtx_) {
+    TracyVkDestroy(tracyCtx_);
+    tracyCtx_ = nullptr;
+  }
+  profilingCommandPool_.reset(nullptr);
+#endif // IGL_WITH_TRACY_GPU
+
   if (device_) {
     vkDestroyDescriptorPool(device, dpDynamicUniformBuffer_, nullptr);
     vkDestroyDescriptorPool(device, dpBindless_, nullptr);
+    for (auto dp : retiredDPs_) {
+      vkDestroyDescriptorPool(device, dp, nullptr);
+    }
+    savePipelineCache();
     vkDestroyPipelineCache(device, pipelineCache_, nullptr);
   }
 
-  vkDestroySurfaceKHR(vkInstance_, vkSurface_, nullptr);
+  if (spirvCache_) {
+    spirvCache_->save(config_.spirvCacheFilePath);
+  }
+
+  if (vkSurface_ != VK_NULL_HANDLE) {
+    vkDestroySurfaceKHR(vkInstance_, vkSurface_, nullptr);
+  }
 
   // Clean up VMA
   if (IGL_VULKAN_USE_VMA) {
@@ -272,7 +404,9 @@ VulkanContext::~VulkanContext() {
 #endif // defined(VK_EXT_debug_utils) && !IGL_PLATFORM_ANDROID
   vkDestroyInstance(vkInstance_, nullptr);
 
-  glslang_finalize_process();
+  if (isGlslangInitialized_) {
+    glslang_finalize_process();
+  }
 
 #if IGL_DEBUG || defined(IGL_FORCE_ENABLE_LOGS)
   IGL_LOG_INFO("Vulkan graphics pipelines created: %u\n",
@@ -285,8 +419,8 @@ VulkanContext::~VulkanContext() {
 void VulkanContext::createInstance(const size_t numExtraExtensions, const char** extraExtensions) {
   // Enumerate all instance extensions
   extensions_.enumerate();
-  extensions_.enableCommonExtensions(VulkanExtensions::ExtensionType::Instance,
-                                     config_.enableValidation);
+  extensions_.enableCommonExtensions(
+      VulkanExtensions::ExtensionType::Instance, config_.enableValidation, config_.headless);
   for (size_t index = 0; index < numExtraExtensions; ++index) {
     extensions_.enable(extraExtensions[index], VulkanExtensions::ExtensionType::Instance);
   }
@@ -387,13 +521,32 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
 
   vkPhysicalDevice_ = (VkPhysicalDevice)desc.guid;
 
+  auto stepStartTime = std::chrono::steady_clock::now();
+
   useStaging_ = !ivkIsHostVisibleSingleHeapMemory(vkPhysicalDevice_);
+  if (useStaging_ && config_.resizableBarMaxBufferSize) {
+    // without resizable BAR, only a 256 MB window of VRAM can be mapped by the CPU
+    constexpr VkDeviceSize kLegacyBarSize = 256ull * 1024ull * 1024ull;
+    const VkDeviceSize heapSize = ivkGetHostVisibleDeviceLocalHeapSize(vkPhysicalDevice_);
+    resizableBarHeapSize_ = heapSize > kLegacyBarSize ? heapSize : 0;
+  }
+  hasLazilyAllocatedMemory_ = ivkHasLazilyAllocatedMemory(vkPhysicalDevice_);
 
   vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &vkPhysicalDeviceFeatures2_);
   vkGetPhysicalDeviceProperties2(vkPhysicalDevice_, &vkPhysicalDeviceProperties2_);
 
   const uint32_t apiVersion = vkPhysicalDeviceProperties2_.properties.apiVersion;
 
+  // Reading the cache files does not depend on the device: it overlaps with the extension queries
+  // and the device creation below. The futures are joined before the caches are first used, or
+  // when an early return destroys them
+  std::future<std::vector<uint8_t>> pipelineCacheFileData =
+      std::async(std::launch::async, [this]() { return loadPipelineCacheFile(); });
+  spirvCache_ = std::make_unique<igl::vulkan::VulkanSpirvCache>();
+  std::future<bool> spirvCacheLoaded = std::async(std::launch::async, [this]() {
+    return spirvCache_->load(config_.spirvCacheFilePath);
+  });
+
   IGL_LOG_INFO("Vulkan physical device: %s\n", vkPhysicalDeviceProperties2_.properties.deviceName);
   IGL_LOG_INFO("           API version: %i.%i.%i.%i\n",
                VK_API_VERSION_MAJOR(apiVersion),
@@ -416,7 +569,190 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
   }
 #endif
 
-  extensions_.enableCommonExtensions(VulkanExtensions::ExtensionType::Device);
+  extensions_.enableCommonExtensions(
+      VulkanExtensions::ExtensionType::Device, config_.enableValidation, config_.headless);
+#if defined(VK_KHR_timeline_semaphore)
+  useTimelineSemaphore_ =
+      config_.enableTimelineSemaphore &&
+      vkPhysicalDeviceTimelineSemaphoreFeatures_.timelineSemaphore == VK_TRUE &&
+      extensions_.enable(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME,
+                         VulkanExtensions::ExtensionType::Device);
+#endif // VK_KHR_timeline_semaphore
+#if defined(VK_KHR_dynamic_rendering)
+  if (config_.enableDynamicRendering &&
+      vkPhysicalDeviceDynamicRenderingFeatures_.dynamicRendering == VK_TRUE) {
+    // dynamic rendering is core in Vulkan 1.3
+    useDynamicRendering_ = apiVersion >= VK_API_VERSION_1_3 ||
+                           extensions_.enable(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
+                                              VulkanExtensions::ExtensionType::Device);
+  }
+#endif // VK_KHR_dynamic_rendering
+#if defined(VK_KHR_present_wait)
+  // both extensions require VK_KHR_swapchain
+  usePresentWait_ = config_.enablePresentWait && !config_.headless &&
+                    vkPhysicalDevicePresentIdFeatures_.presentId == VK_TRUE &&
+                    vkPhysicalDevicePresentWaitFeatures_.presentWait == VK_TRUE &&
+                    extensions_.available(VK_KHR_PRESENT_ID_EXTENSION_NAME,
+                                          VulkanExtensions::ExtensionType::Device) &&
+                    extensions_.available(VK_KHR_PRESENT_WAIT_EXTENSION_NAME,
+                                          VulkanExtensions::ExtensionType::Device);
+  if (usePresentWait_) {
+    extensions_.enable(VK_KHR_PRESENT_ID_EXTENSION_NAME, VulkanExtensions::ExtensionType::Device);
+    extensions_.enable(VK_KHR_PRESENT_WAIT_EXTENSION_NAME,
+                       VulkanExtensions::ExtensionType::Device);
+  }
+#endif // VK_KHR_present_wait
+#if defined(VK_KHR_draw_indirect_count)
+  const bool hasDrawIndirectCount = extensions_.enable(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME,
+                                                       VulkanExtensions::ExtensionType::Device);
+#else
+  const bool hasDrawIndirectCount = false;
+#endif // VK_KHR_draw_indirect_count
+#if defined(VK_EXT_memory_budget)
+  useMemoryBudget_ = extensions_.enable(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
+                                        VulkanExtensions::ExtensionType::Device);
+#endif // VK_EXT_memory_budget
+#if defined(VK_EXT_pipeline_creation_feedback)
+  if (config_.pipelineCreationFeedback) {
+    // pipeline creation feedback is core in Vulkan 1.3
+    usePipelineCreationFeedback_ =
+        apiVersion >= VK_API_VERSION_1_3 ||
+        extensions_.enable(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME,
+                           VulkanExtensions::ExtensionType::Device);
+  }
+#endif // VK_EXT_pipeline_creation_feedback
+#if defined(VK_EXT_graphics_pipeline_library)
+  useGraphicsPipelineLibrary_ =
+      config_.enableGraphicsPipelineLibrary &&
+      vkPhysicalDeviceGraphicsPipelineLibraryFeatures_.graphicsPipelineLibrary == VK_TRUE &&
+      vkPhysicalDeviceGraphicsPipelineLibraryProperties_.graphicsPipelineLibraryFastLinking ==
+          VK_TRUE &&
+      extensions_.available(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device) &&
+      extensions_.available(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device);
+  if (useGraphicsPipelineLibrary_) {
+    extensions_.enable(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME,
+                       VulkanExtensions::ExtensionType::Device);
+    extensions_.enable(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME,
+                       VulkanExtensions::ExtensionType::Device);
+  }
+#endif // VK_EXT_graphics_pipeline_library
+#if defined(VK_KHR_fragment_shading_rate)
+  // VK_KHR_fragment_shading_rate needs VK_KHR_create_renderpass2, which is core in Vulkan 1.2
+  const bool canUseFragmentShadingRate =
+      vkPhysicalDeviceFragmentShadingRateFeatures_.pipelineFragmentShadingRate == VK_TRUE &&
+      extensions_.available(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device) &&
+      (apiVersion >= VK_API_VERSION_1_2 ||
+       extensions_.available(VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME,
+                             VulkanExtensions::ExtensionType::Device));
+#else
+  const bool canUseFragmentShadingRate = false;
+#endif // VK_KHR_fragment_shading_rate
+#if defined(VK_EXT_fragment_density_map)
+  // the two extensions cannot be enabled together
+  useFragmentDensityMap_ =
+      !(config_.preferFragmentShadingRate && canUseFragmentShadingRate) &&
+      vkPhysicalDeviceFragmentDensityMapFeatures_.fragmentDensityMap == VK_TRUE &&
+      extensions_.enable(VK_EXT_FRAGMENT_DENSITY_MAP_EXTENSION_NAME,
+                         VulkanExtensions::ExtensionType::Device);
+#endif // VK_EXT_fragment_density_map
+#if defined(VK_KHR_fragment_shading_rate)
+  useFragmentShadingRate_ = canUseFragmentShadingRate && !useFragmentDensityMap_;
+  if (useFragmentShadingRate_) {
+    if (apiVersion < VK_API_VERSION_1_2) {
+      extensions_.enable(VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME,
+                         VulkanExtensions::ExtensionType::Device);
+    }
+    extensions_.enable(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME,
+                       VulkanExtensions::ExtensionType::Device);
+  }
+#endif // VK_KHR_fragment_shading_rate
+#if defined(VK_EXT_extended_dynamic_state)
+  if (config_.enableExtendedDynamicState &&
+      vkPhysicalDeviceExtendedDynamicStateFeatures_.extendedDynamicState == VK_TRUE) {
+    // extended dynamic state is core in Vulkan 1.3
+    useExtendedDynamicState_ = apiVersion >= VK_API_VERSION_1_3 ||
+                               extensions_.enable(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME,
+                                                  VulkanExtensions::ExtensionType::Device);
+  }
+#endif // VK_EXT_extended_dynamic_state
+#if defined(VK_KHR_push_descriptor)
+  usePushDescriptors_ = config_.enablePushDescriptors &&
+                        extensions_.enable(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME,
+                                           VulkanExtensions::ExtensionType::Device);
+#endif // VK_KHR_push_descriptor
+#if IGL_PLATFORM_ANDROID && defined(VK_ANDROID_external_memory_android_hardware_buffer)
+  // the other dependencies of the extension are core in Vulkan 1.1; the foreign queue family is
+  // needed to acquire the buffers from their producers
+  useHardwareBufferImport_ =
+      extensions_.available(VK_ANDROID_EXTERNAL_MEMORY_ANDROID_HARDWARE_BUFFER_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device) &&
+      extensions_.available(VK_EXT_QUEUE_FAMILY_FOREIGN_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device);
+  if (useHardwareBufferImport_) {
+    extensions_.enable(VK_ANDROID_EXTERNAL_MEMORY_ANDROID_HARDWARE_BUFFER_EXTENSION_NAME,
+                       VulkanExtensions::ExtensionType::Device);
+    extensions_.enable(VK_EXT_QUEUE_FAMILY_FOREIGN_EXTENSION_NAME,
+                       VulkanExtensions::ExtensionType::Device);
+  }
+#endif // IGL_PLATFORM_ANDROID && VK_ANDROID_external_memory_android_hardware_buffer
+#if defined(VK_EXT_host_image_copy)
+  if (config_.enableHostImageCopy &&
+      vkPhysicalDeviceHostImageCopyFeatures_.hostImageCopy == VK_TRUE &&
+      extensions_.available(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device) &&
+      hasHostImageCopyDstLayout(vkPhysicalDevice_, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)) {
+    // the dependencies of the extension are core in Vulkan 1.3
+    useHostImageCopy_ = apiVersion >= VK_API_VERSION_1_3 ||
+                        (extensions_.available(VK_KHR_COPY_COMMANDS_2_EXTENSION_NAME,
+                                               VulkanExtensions::ExtensionType::Device) &&
+                         extensions_.available(VK_KHR_FORMAT_FEATURE_FLAGS_2_EXTENSION_NAME,
+                                               VulkanExtensions::ExtensionType::Device));
+    if (useHostImageCopy_) {
+      if (apiVersion < VK_API_VERSION_1_3) {
+        extensions_.enable(VK_KHR_COPY_COMMANDS_2_EXTENSION_NAME,
+                           VulkanExtensions::ExtensionType::Device);
+        extensions_.enable(VK_KHR_FORMAT_FEATURE_FLAGS_2_EXTENSION_NAME,
+                           VulkanExtensions::ExtensionType::Device);
+      }
+      extensions_.enable(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME,
+                         VulkanExtensions::ExtensionType::Device);
+    }
+  }
+#endif // VK_EXT_host_image_copy
+#if defined(VK_EXT_external_memory_host)
+  // the dependency of the extension, VK_KHR_external_memory, is core in Vulkan 1.1
+  if (config_.enableHostPointerReadback &&
+      vkPhysicalDeviceExternalMemoryHostProperties_.minImportedHostPointerAlignment > 0 &&
+      extensions_.available(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device)) {
+    useExternalMemoryHost_ = extensions_.enable(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME,
+                                                VulkanExtensions::ExtensionType::Device);
+  }
+#endif // VK_EXT_external_memory_host
+#if defined(VK_KHR_synchronization2)
+  if (config_.enableSynchronization2 &&
+      vkPhysicalDeviceSynchronization2Features_.synchronization2 == VK_TRUE) {
+    // synchronization2 is core in Vulkan 1.3
+    useSynchronization2_ = apiVersion >= VK_API_VERSION_1_3 ||
+                           extensions_.enable(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME,
+                                              VulkanExtensions::ExtensionType::Device);
+  }
+#endif // VK_KHR_synchronization2
+#if defined(VK_EXT_descriptor_buffer)
+  // the Bindings uniform buffer of set #1 cannot be a dynamic uniform buffer and the input
+  // attachments of render passes (set #2) would need descriptor sets, so descriptor buffers are
+  // used together with push descriptors and dynamic rendering only
+  if (config_.enableDescriptorBuffer && usePushDescriptors_ && useDynamicRendering_ &&
+      !useGraphicsPipelineLibrary_ &&
+      vkPhysicalDeviceDescriptorBufferFeatures_.descriptorBuffer == VK_TRUE &&
+      vkPhysicalDeviceDescriptorBufferFeatures_.descriptorBufferPushDescriptors == VK_TRUE) {
+    useDescriptorBuffer_ = extensions_.enable(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME,
+                                              VulkanExtensions::ExtensionType::Device);
+  }
+#endif // VK_EXT_descriptor_buffer
   // Enable extra device extensions
   for (size_t i = 0; i < numExtraDeviceExtensions; i++) {
     extensions_.enable(extraDeviceExtensions[i], VulkanExtensions::ExtensionType::Device);
@@ -438,8 +774,24 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
     return Result(Result::Code::Unsupported, "VK_QUEUE_COMPUTE_BIT is not supported");
   }
 
+  if (config_.enableSparseResidency &&
+      vkPhysicalDeviceFeatures2_.features.sparseBinding == VK_TRUE &&
+      vkPhysicalDeviceFeatures2_.features.sparseResidencyImage2D == VK_TRUE) {
+    uint32_t numQueueFamilies = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(vkPhysicalDevice_, &numQueueFamilies, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(numQueueFamilies);
+    vkGetPhysicalDeviceQueueFamilyProperties(
+        vkPhysicalDevice_, &numQueueFamilies, queueFamilies.data());
+    // sparse binding operations are queued on the graphics queue
+    useSparseResidency_ = (queueFamilies[graphicsQueueDescriptor.familyIndex].queueFlags &
+                           VK_QUEUE_SPARSE_BINDING_BIT) != 0;
+  }
+
+  usePipelineStatistics_ = vkPhysicalDeviceFeatures2_.features.pipelineStatisticsQuery == VK_TRUE;
+
   deviceQueues_.graphicsQueueFamilyIndex = graphicsQueueDescriptor.familyIndex;
   deviceQueues_.computeQueueFamilyIndex = computeQueueDescriptor.familyIndex;
+  deviceQueues_.computeQueueIndex = computeQueueDescriptor.queueIndex;
 
   queuePool.reserveQueue(graphicsQueueDescriptor);
   queuePool.reserveQueue(computeQueueDescriptor);
@@ -466,8 +818,39 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
     queuePool.reserveQueue(descriptor);
   }
 
+  // Reserve a transfer queue for the staging device. It is only useful if it belongs to a family
+  // different from the graphics one, otherwise uploads would be serialized with rendering anyway
+  if (config_.enableStagingTransferQueue) {
+    const auto transferQueueDescriptor = queuePool.findQueueDescriptor(VK_QUEUE_TRANSFER_BIT);
+    if (transferQueueDescriptor.isValid() &&
+        transferQueueDescriptor.familyIndex != deviceQueues_.graphicsQueueFamilyIndex) {
+      deviceQueues_.transferQueueFamilyIndex = transferQueueDescriptor.familyIndex;
+      deviceQueues_.transferQueueIndex = transferQueueDescriptor.queueIndex;
+      queuePool.reserveQueue(transferQueueDescriptor);
+    } else {
+      IGL_LOG_INFO("No dedicated transfer queue available. Staging uses the graphics queue\n");
+    }
+  }
+
+  // The present thread presents on its own queue: accesses to a VkQueue must be externally
+  // synchronized and the render thread keeps submitting to the graphics queue
+  if (config_.enablePresentThread && vkSurface_ != VK_NULL_HANDLE) {
+    const auto presentQueueDescriptor = queuePool.findQueueDescriptor(VK_QUEUE_GRAPHICS_BIT);
+    if (presentQueueDescriptor.isValid() &&
+        presentQueueDescriptor.familyIndex == deviceQueues_.graphicsQueueFamilyIndex) {
+      deviceQueues_.presentQueueIndex = presentQueueDescriptor.queueIndex;
+      queuePool.reserveQueue(presentQueueDescriptor);
+      usePresentThread_ = true;
+    } else {
+      IGL_LOG_INFO("No second graphics queue available. Presents stay on the render thread\n");
+    }
+  }
+
   const auto qcis = queuePool.getQueueCreationInfos();
 
+  startupTimings_.physicalDevice = getElapsedMilliseconds(stepStartTime);
+  stepStartTime = std::chrono::steady_clock::now();
+
   VkDevice device;
   VK_ASSERT_RETURN(
       ivkCreateDevice(vkPhysicalDevice_,
@@ -477,41 +860,240 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
                       extensions_.allEnabled(VulkanExtensions::ExtensionType::Device).data(),
                       vkPhysicalDeviceMultiviewFeatures_.multiview,
                       vkPhysicalDeviceShaderFloat16Int8Features_.shaderFloat16,
+                      useTimelineSemaphore_ ? VK_TRUE : VK_FALSE,
+                      useDynamicRendering_ ? VK_TRUE : VK_FALSE,
+                      usePresentWait_ ? VK_TRUE : VK_FALSE,
+                      useSparseResidency_ ? VK_TRUE : VK_FALSE,
+                      usePipelineStatistics_ ? VK_TRUE : VK_FALSE,
+                      useGraphicsPipelineLibrary_ ? VK_TRUE : VK_FALSE,
+                      useFragmentDensityMap_ ? VK_TRUE : VK_FALSE,
+                      useFragmentShadingRate_ ? VK_TRUE : VK_FALSE,
+                      useExtendedDynamicState_ ? VK_TRUE : VK_FALSE,
+                      useHostImageCopy_ ? VK_TRUE : VK_FALSE,
+                      useSynchronization2_ ? VK_TRUE : VK_FALSE,
+                      useDescriptorBuffer_ ? VK_TRUE : VK_FALSE,
                       &device));
   if (!config_.enableConcurrentVkDevicesSupport) {
     volkLoadDevice(device);
   }
 
+  if (useDynamicRendering_) {
+    const bool isCore = apiVersion >= VK_API_VERSION_1_3;
+    vkCmdBeginRendering_ = (PFN_vkCmdBeginRenderingKHR)vkGetDeviceProcAddr(
+        device, isCore ? "vkCmdBeginRendering" : "vkCmdBeginRenderingKHR");
+    vkCmdEndRendering_ = (PFN_vkCmdEndRenderingKHR)vkGetDeviceProcAddr(
+        device, isCore ? "vkCmdEndRendering" : "vkCmdEndRenderingKHR");
+    useDynamicRendering_ = vkCmdBeginRendering_ && vkCmdEndRendering_;
+  }
+
+#if defined(VK_KHR_fragment_shading_rate)
+  if (useFragmentShadingRate_) {
+    vkCmdSetFragmentShadingRate_ = (PFN_vkCmdSetFragmentShadingRateKHR)vkGetDeviceProcAddr(
+        device, "vkCmdSetFragmentShadingRateKHR");
+    useFragmentShadingRate_ = vkCmdSetFragmentShadingRate_ != nullptr;
+  }
+#endif // VK_KHR_fragment_shading_rate
+
+  if (useExtendedDynamicState_) {
+    const bool isCore = apiVersion >= VK_API_VERSION_1_3;
+    vkCmdSetPrimitiveTopology_ = (PFN_vkCmdSetPrimitiveTopologyEXT)vkGetDeviceProcAddr(
+        device, isCore ? "vkCmdSetPrimitiveTopology" : "vkCmdSetPrimitiveTopologyEXT");
+    vkCmdSetDepthWriteEnable_ = (PFN_vkCmdSetDepthWriteEnableEXT)vkGetDeviceProcAddr(
+        device, isCore ? "vkCmdSetDepthWriteEnable" : "vkCmdSetDepthWriteEnableEXT");
+    vkCmdSetDepthCompareOp_ = (PFN_vkCmdSetDepthCompareOpEXT)vkGetDeviceProcAddr(
+        device, isCore ? "vkCmdSetDepthCompareOp" : "vkCmdSetDepthCompareOpEXT");
+    vkCmdSetStencilOp_ = (PFN_vkCmdSetStencilOpEXT)vkGetDeviceProcAddr(
+        device, isCore ? "vkCmdSetStencilOp" : "vkCmdSetStencilOpEXT");
+    useExtendedDynamicState_ = vkCmdSetPrimitiveTopology_ && vkCmdSetDepthWriteEnable_ &&
+                               vkCmdSetDepthCompareOp_ && vkCmdSetStencilOp_;
+  }
+
+#if defined(VK_EXT_host_image_copy)
+  if (useHostImageCopy_) {
+    vkCopyMemoryToImage_ =
+        (PFN_vkCopyMemoryToImageEXT)vkGetDeviceProcAddr(device, "vkCopyMemoryToImageEXT");
+    vkTransitionImageLayout_ =
+        (PFN_vkTransitionImageLayoutEXT)vkGetDeviceProcAddr(device, "vkTransitionImageLayoutEXT");
+    useHostImageCopy_ = vkCopyMemoryToImage_ && vkTransitionImageLayout_;
+  }
+#endif // VK_EXT_host_image_copy
+
+#if defined(VK_EXT_external_memory_host)
+  if (useExternalMemoryHost_) {
+    vkGetMemoryHostPointerProperties_ =
+        (PFN_vkGetMemoryHostPointerPropertiesEXT)vkGetDeviceProcAddr(
+            device, "vkGetMemoryHostPointerPropertiesEXT");
+    useExternalMemoryHost_ = vkGetMemoryHostPointerProperties_ != nullptr;
+  }
+#endif // VK_EXT_external_memory_host
+
+  if (useSynchronization2_) {
+    const bool isCore = apiVersion >= VK_API_VERSION_1_3;
+    vkCmdPipelineBarrier2_ = (PFN_vkCmdPipelineBarrier2KHR)vkGetDeviceProcAddr(
+        device, isCore ? "vkCmdPipelineBarrier2" : "vkCmdPipelineBarrier2KHR");
+    useSynchronization2_ = vkCmdPipelineBarrier2_ != nullptr;
+  }
+
+  if (usePresentWait_) {
+    vkWaitForPresent_ =
+        (PFN_vkWaitForPresentKHR)vkGetDeviceProcAddr(device, "vkWaitForPresentKHR");
+    usePresentWait_ = vkWaitForPresent_ != nullptr;
+  }
+
+  if (usePushDescriptors_) {
+    vkCmdPushDescriptorSet_ = (PFN_vkCmdPushDescriptorSetKHR)vkGetDeviceProcAddr(
+        device, "vkCmdPushDescriptorSetKHR");
+    usePushDescriptors_ = vkCmdPushDescriptorSet_ != nullptr;
+  }
+
+#if defined(VK_EXT_descriptor_buffer)
+  if (useDescriptorBuffer_) {
+    vkGetDescriptorSetLayoutSize_ = (PFN_vkGetDescriptorSetLayoutSizeEXT)vkGetDeviceProcAddr(
+        device, "vkGetDescriptorSetLayoutSizeEXT");
+    vkGetDescriptorSetLayoutBindingOffset_ =
+        (PFN_vkGetDescriptorSetLayoutBindingOffsetEXT)vkGetDeviceProcAddr(
+            device, "vkGetDescriptorSetLayoutBindingOffsetEXT");
+    vkGetDescriptor_ = (PFN_vkGetDescriptorEXT)vkGetDeviceProcAddr(device, "vkGetDescriptorEXT");
+    vkCmdBindDescriptorBuffers_ = (PFN_vkCmdBindDescriptorBuffersEXT)vkGetDeviceProcAddr(
+        device, "vkCmdBindDescriptorBuffersEXT");
+    vkCmdSetDescriptorBufferOffsets_ = (PFN_vkCmdSetDescriptorBufferOffsetsEXT)vkGetDeviceProcAddr(
+        device, "vkCmdSetDescriptorBufferOffsetsEXT");
+    useDescriptorBuffer_ = usePushDescriptors_ && vkGetDescriptorSetLayoutSize_ &&
+                           vkGetDescriptorSetLayoutBindingOffset_ && vkGetDescriptor_ &&
+                           vkCmdBindDescriptorBuffers_ && vkCmdSetDescriptorBufferOffsets_;
+  }
+#endif // VK_EXT_descriptor_buffer
+
+  if (hasDrawIndirectCount) {
+    vkCmdDrawIndexedIndirectCount_ = (PFN_vkCmdDrawIndexedIndirectCountKHR)vkGetDeviceProcAddr(
+        device, "vkCmdDrawIndexedIndirectCountKHR");
+  }
+
   vkGetDeviceQueue(device, deviceQueues_.graphicsQueueFamilyIndex, 0, &deviceQueues_.graphicsQueue);
-  vkGetDeviceQueue(device, deviceQueues_.computeQueueFamilyIndex, 0, &deviceQueues_.computeQueue);
+  vkGetDeviceQueue(device,
+                   deviceQueues_.computeQueueFamilyIndex,
+                   deviceQueues_.computeQueueIndex,
+                   &deviceQueues_.computeQueue);
+  if (deviceQueues_.transferQueueFamilyIndex != DeviceQueues::INVALID) {
+    vkGetDeviceQueue(device,
+                     deviceQueues_.transferQueueFamilyIndex,
+                     deviceQueues_.transferQueueIndex,
+                     &deviceQueues_.transferQueue);
+  }
+
+  if (usePresentThread_) {
+    vkGetDeviceQueue(device,
+                     deviceQueues_.graphicsQueueFamilyIndex,
+                     deviceQueues_.presentQueueIndex,
+                     &deviceQueues_.presentQueue);
+  }
 
   device_ = std::make_unique<igl::vulkan::VulkanDevice>(device, "Device: VulkanContext::device_");
   immediate_ = std::make_unique<igl::vulkan::VulkanImmediateCommands>(
-      device, deviceQueues_.graphicsQueueFamilyIndex, "VulkanContext::immediate_");
+      device,
+      deviceQueues_.graphicsQueueFamilyIndex,
+      "VulkanContext::immediate_",
+      0,
+      useTimelineSemaphore_,
+      config_.maxCommandBuffersPerQueue);
+  if (config_.enableDeferredSubmits && useTimelineSemaphore_) {
+    submitBatch_ =
+        std::make_shared<VulkanImmediateCommands::SubmitBatch>(deviceQueues_.graphicsQueue);
+    immediate_->setSubmitBatch(submitBatch_);
+  }
+
+  startupTimings_.device = getElapsedMilliseconds(stepStartTime);
+  stepStartTime = std::chrono::steady_clock::now();
+
+  // Cross-queue dependencies are expressed with timeline semaphores. A compute queue from the
+  // graphics family would not run concurrently with rendering on most hardware
+  if (config_.enableAsyncComputeQueue) {
+    if (useTimelineSemaphore_ &&
+        deviceQueues_.computeQueueFamilyIndex != deviceQueues_.graphicsQueueFamilyIndex) {
+      computeImmediate_ = std::make_unique<igl::vulkan::VulkanImmediateCommands>(
+          device,
+          deviceQueues_.computeQueueFamilyIndex,
+          "VulkanContext::computeImmediate_",
+          deviceQueues_.computeQueueIndex,
+          true,
+          config_.maxCommandBuffersPerQueue);
+      sharedQueueFamilyIndices_ = {deviceQueues_.graphicsQueueFamilyIndex,
+                                   deviceQueues_.computeQueueFamilyIndex};
+      if (deviceQueues_.transferQueueFamilyIndex != DeviceQueues::INVALID &&
+          deviceQueues_.transferQueueFamilyIndex != deviceQueues_.computeQueueFamilyIndex) {
+        sharedQueueFamilyIndices_.push_back(deviceQueues_.transferQueueFamilyIndex);
+      }
+    } else {
+      IGL_LOG_INFO("No async compute queue available. Compute uses the graphics queue\n");
+    }
+  }
+
+#if defined(IGL_WITH_TRACY_GPU)
+  profilingCommandPool_ = std::make_unique<igl::vulkan::VulkanCommandPool>(
+      device,
+      VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+      deviceQueues_.graphicsQueueFamilyIndex,
+      "VulkanContext::profilingCommandPool_");
+  VK_ASSERT(ivkAllocateCommandBuffer(
+      device, profilingCommandPool_->getVkCommandPool(), &profilingCommandBuffer_));
+  tracyCtx_ = TracyVkContext(
+      getVkPhysicalDevice(), device, deviceQueues_.graphicsQueue, profilingCommandBuffer_);
+#endif // IGL_WITH_TRACY_GPU
+
   syncManager_ = std::make_unique<SyncManager>(*this, config_.maxResourceCount);
 
   // create Vulkan pipeline cache
   {
+    const std::vector<uint8_t> fileData = pipelineCacheFileData.get();
+    const bool hasFileData = !fileData.empty();
     const VkPipelineCacheCreateInfo ci = {
         VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
         nullptr,
         VkPipelineCacheCreateFlags(0),
-        config_.pipelineCacheDataSize,
-        config_.pipelineCacheData,
+        hasFileData ? fileData.size() : config_.pipelineCacheDataSize,
+        hasFileData ? fileData.data() : config_.pipelineCacheData,
     };
-    vkCreatePipelineCache(device, &ci, nullptr, &pipelineCache_);
+    if (vkCreatePipelineCache(device, &ci, nullptr, &pipelineCache_) != VK_SUCCESS &&
+        ci.initialDataSize) {
+      IGL_LOG_ERROR("vkCreatePipelineCache() rejected the initial data. Using an empty cache\n");
+      const VkPipelineCacheCreateInfo ciEmpty = {
+          VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+          nullptr,
+          VkPipelineCacheCreateFlags(0),
+          0,
+          nullptr,
+      };
+      VK_ASSERT(vkCreatePipelineCache(device, &ciEmpty, nullptr, &pipelineCache_));
+    }
+    pipelineCacheSavedSize_ = fileData.size();
+    pipelineCacheSaveTime_ = std::chrono::steady_clock::now();
+  }
+
+  spirvCacheLoaded.wait();
+
+  if (config_.enableComputeMipmapGeneration) {
+    mipmapGenerator_ = std::make_unique<igl::vulkan::VulkanMipmapGenerator>(*this);
   }
 
   // Create Vulkan Memory Allocator
   if (IGL_VULKAN_USE_VMA) {
-    VK_ASSERT_RETURN(ivkVmaCreateAllocator(
-        vkPhysicalDevice_, device_->getVkDevice(), vkInstance_, apiVersion, &pimpl_->vma_));
+    VK_ASSERT_RETURN(ivkVmaCreateAllocator(vkPhysicalDevice_,
+                                           device_->getVkDevice(),
+                                           vkInstance_,
+                                           apiVersion,
+                                           useMemoryBudget_ ? VK_TRUE : VK_FALSE,
+                                           &pimpl_->vma_));
   }
 
-  // The staging device will use VMA to allocate a buffer, so this needs
-  // to happen after VMA has been initialized.
+  // The staging device will use VMA to allocate its buffers, so this needs to happen after VMA has
+  // been initialized. The first staging chunk is allocated by the first upload
   stagingDevice_ = std::make_unique<igl::vulkan::VulkanStagingDevice>(*this);
 
+  if (config_.bufferPoolBlockSize) {
+    bufferPool_ = std::make_unique<igl::vulkan::VulkanBufferPool>(
+        *this, config_.bufferPoolBlockSize, config_.bufferPoolMaxAllocationSize);
+  }
+
   // default texture
   IGL_ASSERT(textures_.size() == 1);
   {
@@ -598,7 +1180,20 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
   const VkPhysicalDeviceLimits& limits = getVkPhysicalDeviceProperties().limits;
   dynamicUniformBufferSize_ = std::min(limits.maxUniformBufferRange, 262144u);
 
-  {
+  if (usePushDescriptors_) {
+    // push descriptor sets cannot contain dynamic uniform buffers: the offset goes into the
+    // pushed descriptor itself
+    const VkDescriptorSetLayoutBinding binding =
+        ivkGetDescriptorSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1);
+    dslDynamicUniformBuffer_ = std::make_unique<VulkanDescriptorSetLayout>(
+        device,
+        1,
+        &binding,
+        nullptr,
+        "Descriptor Set Layout: VulkanContext::dslDynamicUniformBuffer_ (push)",
+        true,
+        useDescriptorBuffer_);
+  } else {
     constexpr uint32_t numBindings = 1;
     const std::array<VkDescriptorSetLayoutBinding, numBindings> bindings = {
         ivkGetDescriptorSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1),
@@ -622,110 +1217,96 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
                                              poolSizes.data(),
                                              &dpDynamicUniformBuffer_));
   }
-  {
-    // create default descriptor set layout which is going to be shared by graphics pipelines
-    constexpr uint32_t numBindings = 7;
-    const std::array<VkDescriptorSetLayoutBinding, numBindings> bindings = {
-        ivkGetDescriptorSetLayoutBinding(
-            kBinding_Texture2D, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, config_.maxTextures),
-        ivkGetDescriptorSetLayoutBinding(
-            kBinding_Texture2DArray, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, config_.maxTextures),
-        ivkGetDescriptorSetLayoutBinding(
-            kBinding_Texture3D, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, config_.maxTextures),
-        ivkGetDescriptorSetLayoutBinding(
-            kBinding_TextureCube, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, config_.maxTextures),
-        ivkGetDescriptorSetLayoutBinding(
-            kBinding_Sampler, VK_DESCRIPTOR_TYPE_SAMPLER, config_.maxSamplers),
-        ivkGetDescriptorSetLayoutBinding(
-            kBinding_SamplerShadow, VK_DESCRIPTOR_TYPE_SAMPLER, config_.maxSamplers),
-        ivkGetDescriptorSetLayoutBinding(
-            kBinding_StorageImages, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, config_.maxTextures),
-    };
-    const uint32_t flags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
-                           VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT |
-                           VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
-    const std::array<VkDescriptorBindingFlags, numBindings> bindingFlags = {
-        flags, flags, flags, flags, flags, flags, flags};
-    dslBindless_ = std::make_unique<VulkanDescriptorSetLayout>(
-        device,
-        numBindings,
-        bindings.data(),
-        bindingFlags.data(),
-        "Descriptor Set Layout: VulkanContext::dslBindless_");
-
-    // create default descriptor pool and allocate 1 descriptor set
-    const uint32_t numSets = 1;
-    IGL_ASSERT(numSets > 0);
-    const std::array<VkDescriptorPoolSize, numBindings> poolSizes = {
-        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, numSets * config_.maxTextures},
-        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, numSets * config_.maxTextures},
-        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, numSets * config_.maxTextures},
-        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, numSets * config_.maxTextures},
-        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLER, numSets * config_.maxSamplers},
-        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLER, numSets * config_.maxSamplers},
-        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, numSets * config_.maxTextures},
-    };
-    bindlessDSets_.resize(numSets);
-    VK_ASSERT_RETURN(ivkCreateDescriptorPool(
-        device, numSets, static_cast<uint32_t>(poolSizes.size()), poolSizes.data(), &dpBindless_));
-    for (size_t i = 0; i != numSets; i++) {
-      VK_ASSERT_RETURN(ivkAllocateDescriptorSet(
-          device, dpBindless_, dslBindless_->getVkDescriptorSetLayout(), &bindlessDSets_[i].ds));
-    }
-  }
-
-  // maxPushConstantsSize is guaranteed to be at least 128 bytes
-  // https://www.khronos.org/registry/vulkan/specs/1.3/html/vkspec.html#features-limits
-  // Table 32. Required Limits
-  const uint32_t kPushConstantsSize = 128;
   if (!IGL_VERIFY(kPushConstantsSize <= limits.maxPushConstantsSize)) {
     IGL_LOG_ERROR("Push constants size exceeded %u (max %u bytes)",
                   kPushConstantsSize,
                   limits.maxPushConstantsSize);
   }
 
-  const std::vector<VkDescriptorSetLayout> DSLs = {
-      dslBindless_->getVkDescriptorSetLayout(),
-      dslDynamicUniformBuffer_->getVkDescriptorSetLayout()};
-
-  // create pipeline layout
-  pipelineLayoutGraphics_ = std::make_unique<VulkanPipelineLayout>(
-      device,
-      DSLs,
-      ivkGetPushConstantRange(
-          VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, kPushConstantsSize),
-      "Pipeline Layout: VulkanContext::pipelineLayoutGraphics_");
+  if (!useDynamicRendering_) {
+    // framebuffer fetch reads the color attachments as input attachments; their descriptor sets
+    // are owned by the framebuffers (see Framebuffer::getInputAttachmentsDescriptorSet())
+    std::array<VkDescriptorSetLayoutBinding, IGL_COLOR_ATTACHMENTS_MAX> bindings = {};
+    std::array<VkDescriptorBindingFlags, IGL_COLOR_ATTACHMENTS_MAX> bindingFlags = {};
+    for (uint32_t i = 0; i != IGL_COLOR_ATTACHMENTS_MAX; i++) {
+      bindings[i] = ivkGetDescriptorSetLayoutBinding(i, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1);
+      // input attachments can only be read by fragment shaders
+      bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+      bindingFlags[i] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+    }
+    dslInputAttachments_ = std::make_unique<VulkanDescriptorSetLayout>(
+        device,
+        IGL_COLOR_ATTACHMENTS_MAX,
+        bindings.data(),
+        bindingFlags.data(),
+        "Descriptor Set Layout: VulkanContext::dslInputAttachments_");
+  }
 
-  pipelineLayoutCompute_ = std::make_unique<VulkanPipelineLayout>(
-      device,
-      DSLs,
-      ivkGetPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, 0, kPushConstantsSize),
-      "Pipeline Layout: VulkanContext::pipelineLayoutCompute_");
+  {
+    const Result result = growBindlessDescriptorSet(config_.maxTextures, config_.maxSamplers);
+    if (!IGL_VERIFY(result.isOk())) {
+      return result;
+    }
+  }
 
   querySurfaceCapabilities();
 
   DUBs_ = std::make_unique<DynamicUniformsBufferSet>(*this);
 
+#if IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
   // enables/disables enhanced shader debugging
   if (config_.enhancedShaderDebugging) {
     enhancedShaderDebuggingStore_ = std::make_unique<EnhancedShaderDebuggingStore>();
   }
+#endif // IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
+
+  startupTimings_.resources = getElapsedMilliseconds(stepStartTime);
+
+  IGL_LOG_INFO(
+      "Vulkan startup: instance %.1f ms, physical device %.1f ms, device %.1f ms, resources %.1f "
+      "ms\n",
+      startupTimings_.instance,
+      startupTimings_.physicalDevice,
+      startupTimings_.device,
+      startupTimings_.resources);
 
   return Result();
 }
 
+void VulkanContext::initGlslang() const {
+  std::call_once(glslangOnce_, [this]() {
+    IGL_PROFILER_FUNCTION();
+    glslang_initialize_process();
+    isGlslangInitialized_ = true;
+  });
+}
+
 igl::Result VulkanContext::initSwapchain(uint32_t width, uint32_t height) {
   if (!device_ || !immediate_) {
     IGL_LOG_ERROR("Call initContext() first");
     return Result(Result::Code::Unsupported, "Call initContext() first");
   }
 
-  if (swapchain_) {
-    vkDeviceWaitIdle(device_->device_);
-    swapchain_ = nullptr; // Destroy old swapchain first
+  if (!hasSurface()) {
+    return Result(Result::Code::Unsupported, "The context has no surface (headless or no window)");
+  }
+
+  // The old swapchain is handed over to the new one instead of draining the GPU. Its images can be
+  // used by the frames still in flight, so it is destroyed once the last submit completes.
+  std::shared_ptr<igl::vulkan::VulkanSwapchain> oldSwapchain = std::move(swapchain_);
+  if (oldSwapchain) {
+    oldSwapchain->stopPresentThread();
   }
 
-  swapchain_ = std::make_unique<igl::vulkan::VulkanSwapchain>(*this, width, height);
+  swapchain_ = std::make_unique<igl::vulkan::VulkanSwapchain>(
+      *this, width, height, oldSwapchain ? oldSwapchain->getVkSwapchain() : VK_NULL_HANDLE);
+
+  if (oldSwapchain) {
+    deferredTask(std::packaged_task<void()>([swapchain = std::move(oldSwapchain)]() mutable {
+                   swapchain.reset();
+                 }),
+                 immediate_->getLastSubmitHandle());
+  }
 
   return swapchain_ ? Result() : Result(Result::Code::RuntimeError, "Failed to create Swapchain");
 }
@@ -734,11 +1315,49 @@ VkExtent2D VulkanContext::getSwapchainExtent() const {
   return hasSwapchain() ? swapchain_->getExtent() : VkExtent2D{0, 0};
 }
 
+igl::Result VulkanContext::setPresentMode(VkPresentModeKHR presentMode) {
+  if (config_.swapchainPresentMode == presentMode) {
+    return Result();
+  }
+
+  config_.swapchainPresentMode = presentMode;
+
+  return hasSwapchain() ? initSwapchain(swapchain_->getWindowExtent().width,
+                                        swapchain_->getWindowExtent().height)
+                        : Result();
+}
+
+void VulkanContext::setMaxFramesInFlight(uint32_t maxFramesInFlight) {
+  // takes effect on the next acquired swapchain image
+  config_.maxFramesInFlight = maxFramesInFlight;
+}
+
+uint64_t VulkanContext::getLastPresentId() const {
+  return hasSwapchain() ? swapchain_->getLastPresentId() : 0;
+}
+
+igl::Result VulkanContext::waitForPresent(uint64_t presentId, uint64_t timeoutNanos) const {
+  if (!hasSwapchain()) {
+    return Result(Result::Code::InvalidOperation, "No swapchain available");
+  }
+
+  return swapchain_->waitForPresent(presentId, timeoutNanos);
+}
+
 Result VulkanContext::waitIdle() const {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
 
-  for (auto queue : {deviceQueues_.graphicsQueue, deviceQueues_.computeQueue}) {
-    VK_ASSERT_RETURN(vkQueueWaitIdle(queue));
+  if (submitBatch_) {
+    submitBatch_->flush();
+  }
+
+  for (auto queue : {deviceQueues_.graphicsQueue,
+                     deviceQueues_.computeQueue,
+                     deviceQueues_.transferQueue,
+                     deviceQueues_.presentQueue}) {
+    if (queue != VK_NULL_HANDLE) {
+      VK_ASSERT_RETURN(vkQueueWaitIdle(queue));
+    }
   }
 
   return getResultFromVkResult(VK_SUCCESS);
@@ -752,6 +1371,58 @@ Result VulkanContext::present() const {
   return swapchain_->present(immediate_->acquireLastSubmitSemaphore());
 }
 
+void VulkanContext::flushMappedMemoryRanges() const {
+  std::lock_guard<std::mutex> lock(dirtyBuffersMutex_);
+
+  if (dirtyBuffers_.empty()) {
+    return;
+  }
+
+  IGL_PROFILER_FUNCTION();
+
+  const auto count = static_cast<uint32_t>(dirtyBuffers_.size());
+
+  if (IGL_VULKAN_USE_VMA) {
+    // VMA aligns the ranges to nonCoherentAtomSize
+    std::vector<VmaAllocation> allocations;
+    std::vector<VkDeviceSize> offsets;
+    std::vector<VkDeviceSize> sizes;
+    allocations.reserve(count);
+    offsets.reserve(count);
+    sizes.reserve(count);
+    for (const VulkanBuffer* buffer : dirtyBuffers_) {
+      allocations.push_back(buffer->vmaAllocation_);
+      offsets.push_back(buffer->dirtyBegin_);
+      sizes.push_back(buffer->dirtyEnd_ - buffer->dirtyBegin_);
+    }
+    VK_ASSERT(vmaFlushAllocations(
+        (VmaAllocator)getVmaAllocator(), count, allocations.data(), offsets.data(), sizes.data()));
+  } else {
+    const VkDeviceSize atomSize = getVkPhysicalDeviceProperties().limits.nonCoherentAtomSize;
+    std::vector<VkMappedMemoryRange> ranges;
+    ranges.reserve(count);
+    for (const VulkanBuffer* buffer : dirtyBuffers_) {
+      const VkDeviceSize begin = buffer->dirtyBegin_ / atomSize * atomSize;
+      const VkDeviceSize end = (buffer->dirtyEnd_ + atomSize - 1) / atomSize * atomSize;
+      ranges.push_back({
+          VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+          nullptr,
+          buffer->vkMemory_,
+          begin,
+          // the memory is mapped from offset 0 and may end before the aligned range
+          end < buffer->bufferSize_ ? end - begin : VK_WHOLE_SIZE,
+      });
+    }
+    VK_ASSERT(vkFlushMappedMemoryRanges(device_->getVkDevice(), count, ranges.data()));
+  }
+
+  for (VulkanBuffer* buffer : dirtyBuffers_) {
+    buffer->dirtyBegin_ = 0;
+    buffer->dirtyEnd_ = 0;
+  }
+  dirtyBuffers_.clear();
+}
+
 std::shared_ptr<VulkanBuffer> VulkanContext::createBuffer(VkDeviceSize bufferSize,
                                                           VkBufferUsageFlags usageFlags,
                                                           VkMemoryPropertyFlags memFlags,
@@ -810,6 +1481,35 @@ std::shared_ptr<VulkanImage> VulkanContext::createImage(VkImageType imageType,
                                        debugName);
 }
 
+bool VulkanContext::canUseHostImageCopy(VkImageType imageType,
+                                        VkFormat format,
+                                        VkImageUsageFlags usageFlags,
+                                        VkImageCreateFlags flags) const {
+#if defined(VK_EXT_host_image_copy)
+  if (!useHostImageCopy_) {
+    return false;
+  }
+  // host transfers may disable the compression of some images: use them only if the driver reports
+  // that the device access is not affected
+  VkHostImageCopyDevicePerformanceQueryEXT performance = {
+      VK_STRUCTURE_TYPE_HOST_IMAGE_COPY_DEVICE_PERFORMANCE_QUERY_EXT};
+  VkImageFormatProperties2 props = {VK_STRUCTURE_TYPE_IMAGE_FORMAT_PROPERTIES_2, &performance};
+  const VkPhysicalDeviceImageFormatInfo2 info = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGE_FORMAT_INFO_2,
+      nullptr,
+      format,
+      imageType,
+      VK_IMAGE_TILING_OPTIMAL,
+      usageFlags | VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT,
+      flags};
+  return vkGetPhysicalDeviceImageFormatProperties2(vkPhysicalDevice_, &info, &props) ==
+             VK_SUCCESS &&
+         performance.optimalDeviceAccess == VK_TRUE;
+#else
+  return false;
+#endif // VK_EXT_host_image_copy
+}
+
 std::shared_ptr<VulkanImage> VulkanContext::createImageFromFileDescriptor(
     int32_t fileDescriptor,
     uint64_t memoryAllocationSize,
@@ -865,45 +1565,82 @@ void VulkanContext::checkAndUpdateDescriptorSets() const {
   // newly created resources can be used immediately - make sure they are put into descriptor sets
   IGL_PROFILER_FUNCTION();
 
+  // other threads can create textures and samplers while the descriptors are being updated
+  std::lock_guard<std::mutex> lock(bindlessMutex_);
+
+  // submit handles are checked only here, on the thread which encodes commands, so that the
+  // creating threads merely pop the free indices
+  processPendingFreeIndices();
+
   // here we remove deleted textures - everything which has only 1 reference is owned by this
-  // context and can be released safely
+  // context and can be released safely; the indices are reused after the GPU is done with them
+  const SubmitHandle lastSubmitHandle = immediate_->getLastSubmitHandle();
+
   for (uint32_t i = 1; i < (uint32_t)textures_.size(); i++) {
     if (textures_[i] && textures_[i].use_count() == 1) {
-      if (i == textures_.size() - 1) {
-        textures_.pop_back();
-      } else {
-        textures_[i].reset();
-        freeIndicesTextures_.push_back(i);
-      }
+      textures_[i].reset();
+      pendingFreeIndicesTextures_.push_back({i, lastSubmitHandle});
     }
   }
   for (uint32_t i = 1; i < (uint32_t)samplers_.size(); i++) {
     if (samplers_[i] && samplers_[i].use_count() == 1) {
-      if (i == samplers_.size() - 1) {
-        samplers_.pop_back();
-      } else {
-        samplers_[i].reset();
-        freeIndicesSamplers_.push_back(i);
-      }
+      samplers_[i].reset();
+      pendingFreeIndicesSamplers_.push_back({i, lastSubmitHandle});
     }
   }
 
-  // update Vulkan descriptor set here
+  if (textures_.size() > bindlessMaxTextures_ || samplers_.size() > bindlessMaxSamplers_) {
+    // grow geometrically so that the full rewrite of the new descriptor set is amortized
+    const uint32_t limitTextures =
+        vkPhysicalDeviceDescriptorIndexingProperties_.maxDescriptorSetUpdateAfterBindSampledImages;
+    const uint32_t limitSamplers =
+        vkPhysicalDeviceDescriptorIndexingProperties_.maxDescriptorSetUpdateAfterBindSamplers;
+    uint32_t maxTextures = std::max(bindlessMaxTextures_, 1u);
+    uint32_t maxSamplers = std::max(bindlessMaxSamplers_, 1u);
+    while (maxTextures < textures_.size() && maxTextures < limitTextures) {
+      maxTextures *= 2;
+    }
+    while (maxSamplers < samplers_.size() && maxSamplers < limitSamplers) {
+      maxSamplers *= 2;
+    }
+    maxTextures = std::max(std::min(maxTextures, limitTextures), bindlessMaxTextures_);
+    maxSamplers = std::max(std::min(maxSamplers, limitSamplers), bindlessMaxSamplers_);
+
+    if (textures_.size() > maxTextures || samplers_.size() > maxSamplers) {
+      IGL_LOG_ERROR("Bindless arrays exceeded: %u textures (max %u), %u samplers (max %u)\n",
+                    (uint32_t)textures_.size(),
+                    maxTextures,
+                    (uint32_t)samplers_.size(),
+                    maxSamplers);
+    }
+
+    if (maxTextures != bindlessMaxTextures_ || maxSamplers != bindlessMaxSamplers_) {
+      growBindlessDescriptorSet(maxTextures, maxSamplers);
+    }
+  }
+
+  // Only the descriptors of newly created textures and samplers are written. They are not
+  // accessed by any pending command buffers, so they can be updated in place thanks to
+  // VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT. Released slots are left as is because
+  // the bindings are partially bound.
+  getIndicesToUpdate(dirtyIndicesTextures_, textures_, bindlessMaxTextures_);
+  getIndicesToUpdate(dirtyIndicesSamplers_, samplers_, bindlessMaxSamplers_);
 
   // 1. Sampled and storage images
   std::vector<VkDescriptorImageInfo> infoSampledImages;
   std::vector<VkDescriptorImageInfo> infoStorageImages;
   IGL_ASSERT(textures_.size() >= 1); // make sure the guard value is always there
-  infoSampledImages.reserve(textures_.size());
-  infoStorageImages.reserve(textures_.size());
+  infoSampledImages.reserve(dirtyIndicesTextures_.size());
+  infoStorageImages.reserve(dirtyIndicesTextures_.size());
 
   // use the dummy texture to avoid sparse array
   VkImageView dummyImageView = textures_[0]->imageView_->getVkImageView();
 
-  for (const auto& texture : textures_) {
+  for (uint32_t index : dirtyIndicesTextures_) {
+    const auto& texture = textures_[index];
     // multisampled images cannot be directly accessed from shaders
     const bool isTextureAvailable =
-        texture && ((texture->image_->samples_ & VK_SAMPLE_COUNT_1_BIT) == VK_SAMPLE_COUNT_1_BIT);
+        (texture->image_->samples_ & VK_SAMPLE_COUNT_1_BIT) == VK_SAMPLE_COUNT_1_BIT;
     const bool isSampledImage = isTextureAvailable && texture->image_->isSampledImage();
     const bool isStorageImage = isTextureAvailable && texture->image_->isStorageImage();
     infoSampledImages.push_back(
@@ -920,87 +1657,389 @@ void VulkanContext::checkAndUpdateDescriptorSets() const {
   // 2. Samplers
   std::vector<VkDescriptorImageInfo> infoSamplers;
   IGL_ASSERT(samplers_.size() >= 1); // make sure the guard value is always there
-  infoSamplers.reserve(samplers_.size());
+  infoSamplers.reserve(dirtyIndicesSamplers_.size());
 
-  for (const auto& sampler : samplers_) {
-    infoSamplers.push_back({(sampler ? sampler : samplers_[0])->getVkSampler(),
-                            VK_NULL_HANDLE,
-                            VK_IMAGE_LAYOUT_UNDEFINED});
+  for (uint32_t index : dirtyIndicesSamplers_) {
+    infoSamplers.push_back(
+        {samplers_[index]->getVkSampler(), VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED});
   }
 
-  std::vector<VkWriteDescriptorSet> write;
-
-  // we want to update the next available descriptor set
-  const uint32_t nextDSetIndex = (currentDSetIndex_ + 1) % bindlessDSets_.size();
-  auto& dsetToUpdate = bindlessDSets_[nextDSetIndex];
+  if (useDescriptorBuffer_) {
+    writeBindlessDescriptorBuffer(infoSampledImages, infoStorageImages, infoSamplers);
+  } else {
+    std::vector<VkWriteDescriptorSet> write;
+
+    // every run of consecutive indices is written with one VkWriteDescriptorSet
+    const auto addWrites = [this, &write](const std::vector<uint32_t>& indices,
+                                          const std::vector<VkDescriptorImageInfo>& infos,
+                                          uint32_t binding,
+                                          VkDescriptorType type) {
+      size_t begin = 0;
+      while (begin != indices.size()) {
+        size_t end = begin + 1;
+        while (end != indices.size() && indices[end] == indices[end - 1] + 1) {
+          end++;
+        }
+        write.push_back(ivkGetWriteDescriptorSet_ImageInfo(
+            dsBindless_, binding, type, uint32_t(end - begin), infos.data() + begin));
+        write.back().dstArrayElement = indices[begin];
+        begin = end;
+      }
+    };
 
-  if (!infoSampledImages.empty()) {
     // use the same indexing for every texture type
     for (uint32_t i = kBinding_Texture2D; i != kBinding_TextureCube + 1; i++) {
-      write.push_back(ivkGetWriteDescriptorSet_ImageInfo(dsetToUpdate.ds,
-                                                         i,
-                                                         VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
-                                                         (uint32_t)infoSampledImages.size(),
-                                                         infoSampledImages.data()));
+      addWrites(dirtyIndicesTextures_, infoSampledImages, i, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE);
     }
-  };
-
-  if (!infoSamplers.empty()) {
     for (uint32_t i = kBinding_Sampler; i != kBinding_SamplerShadow + 1; i++) {
-      write.push_back(ivkGetWriteDescriptorSet_ImageInfo(dsetToUpdate.ds,
-                                                         i,
-                                                         VK_DESCRIPTOR_TYPE_SAMPLER,
-                                                         (uint32_t)infoSamplers.size(),
-                                                         infoSamplers.data()));
+      addWrites(dirtyIndicesSamplers_, infoSamplers, i, VK_DESCRIPTOR_TYPE_SAMPLER);
     }
-  }
-
-  if (!infoStorageImages.empty()) {
-    write.push_back(ivkGetWriteDescriptorSet_ImageInfo(dsetToUpdate.ds,
-                                                       kBinding_StorageImages,
-                                                       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-                                                       (uint32_t)infoStorageImages.size(),
-                                                       infoStorageImages.data()));
-  };
+    addWrites(dirtyIndicesTextures_,
+              infoStorageImages,
+              kBinding_StorageImages,
+              VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
 
-  // do not switch to the next descriptor set if there is nothing to update
-  if (!write.empty()) {
+    if (!write.empty()) {
 #if IGL_VULKAN_PRINT_COMMANDS
-    IGL_LOG_INFO("Updating descriptor set %u\n", nextDSetIndex);
+      IGL_LOG_INFO("Updating %u textures and %u samplers in the bindless descriptor set\n",
+                   (uint32_t)dirtyIndicesTextures_.size(),
+                   (uint32_t)dirtyIndicesSamplers_.size());
 #endif // IGL_VULKAN_PRINT_COMMANDS
-    currentDSetIndex_ = nextDSetIndex;
-    immediate_->wait(std::exchange(dsetToUpdate.handle, immediate_->getLastSubmitHandle()));
-    vkUpdateDescriptorSets(
-        device_->getVkDevice(), static_cast<uint32_t>(write.size()), write.data(), 0, nullptr);
+      vkUpdateDescriptorSets(
+          device_->getVkDevice(), static_cast<uint32_t>(write.size()), write.data(), 0, nullptr);
+    }
   }
 
+  dirtyIndicesTextures_.clear();
+  dirtyIndicesSamplers_.clear();
+
   awaitingCreation_ = false;
   awaitingDeletion_ = false;
 
   lastDeletionFrame_ = getFrameNumber();
 }
 
+void VulkanContext::writeBindlessDescriptorBuffer(
+    const std::vector<VkDescriptorImageInfo>& infoSampledImages,
+    const std::vector<VkDescriptorImageInfo>& infoStorageImages,
+    const std::vector<VkDescriptorImageInfo>& infoSamplers) const {
+#if defined(VK_EXT_descriptor_buffer)
+  IGL_ASSERT(descriptorBufferBindless_);
+
+  const VkPhysicalDeviceDescriptorBufferPropertiesEXT& props =
+      vkPhysicalDeviceDescriptorBufferProperties_;
+
+  // every descriptor is written straight into its slot of the mapped buffer; descriptors of
+  // other slots are left as is, so the cost is proportional to the number of changed resources
+  const auto writeDescriptors = [this](const std::vector<uint32_t>& indices,
+                                       const std::vector<VkDescriptorImageInfo>& infos,
+                                       uint32_t binding,
+                                       VkDescriptorType type,
+                                       size_t descriptorSize) {
+    for (size_t i = 0; i != indices.size(); i++) {
+      VkDescriptorGetInfoEXT info = {VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT, nullptr, type, {}};
+      if (type == VK_DESCRIPTOR_TYPE_SAMPLER) {
+        info.data.pSampler = &infos[i].sampler;
+      } else if (type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE) {
+        info.data.pSampledImage = &infos[i];
+      } else {
+        info.data.pStorageImage = &infos[i];
+      }
+      const VkDeviceSize offset =
+          descriptorBufferBindingOffsets_[binding] + indices[i] * descriptorSize;
+      vkGetDescriptor_(device_->getVkDevice(),
+                       &info,
+                       descriptorSize,
+                       descriptorBufferBindless_->getMappedPtr() + offset);
+      descriptorBufferBindless_->flushMappedMemory(offset, descriptorSize);
+    }
+  };
+
+#if IGL_VULKAN_PRINT_COMMANDS
+  IGL_LOG_INFO("Updating %u textures and %u samplers in the bindless descriptor buffer\n",
+               (uint32_t)dirtyIndicesTextures_.size(),
+               (uint32_t)dirtyIndicesSamplers_.size());
+#endif // IGL_VULKAN_PRINT_COMMANDS
+
+  // use the same indexing for every texture type
+  for (uint32_t i = kBinding_Texture2D; i != kBinding_TextureCube + 1; i++) {
+    writeDescriptors(dirtyIndicesTextures_,
+                     infoSampledImages,
+                     i,
+                     VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                     props.sampledImageDescriptorSize);
+  }
+  for (uint32_t i = kBinding_Sampler; i != kBinding_SamplerShadow + 1; i++) {
+    writeDescriptors(dirtyIndicesSamplers_,
+                     infoSamplers,
+                     i,
+                     VK_DESCRIPTOR_TYPE_SAMPLER,
+                     props.samplerDescriptorSize);
+  }
+  writeDescriptors(dirtyIndicesTextures_,
+                   infoStorageImages,
+                   kBinding_StorageImages,
+                   VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                   props.storageImageDescriptorSize);
+#else
+  IGL_ASSERT_NOT_REACHED();
+#endif // VK_EXT_descriptor_buffer
+}
+
+void VulkanContext::bindBindlessDescriptorBuffer(VkCommandBuffer cmdBuf,
+                                                 VkPipelineBindPoint bindPoint,
+                                                 VkPipelineLayout layout) const {
+#if defined(VK_EXT_descriptor_buffer)
+  IGL_ASSERT(descriptorBufferBindless_);
+
+  const VkDescriptorBufferBindingPushDescriptorBufferHandleEXT pushDescriptorBuffer = {
+      VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_PUSH_DESCRIPTOR_BUFFER_HANDLE_EXT,
+      nullptr,
+      descriptorBufferBindless_->getVkBuffer(),
+  };
+  VkBufferUsageFlags usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+                             VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT;
+  if (!vkPhysicalDeviceDescriptorBufferProperties_.bufferlessPushDescriptors) {
+    usage |= VK_BUFFER_USAGE_PUSH_DESCRIPTORS_DESCRIPTOR_BUFFER_BIT_EXT;
+  }
+  const VkDescriptorBufferBindingInfoEXT bindingInfo = {
+      VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+      vkPhysicalDeviceDescriptorBufferProperties_.bufferlessPushDescriptors
+          ? nullptr
+          : &pushDescriptorBuffer,
+      descriptorBufferBindless_->getVkDeviceAddress(),
+      usage,
+  };
+  const uint32_t bufferIndex = 0;
+  const VkDeviceSize offset = 0;
+
+#if IGL_VULKAN_PRINT_COMMANDS
+  IGL_LOG_INFO("%p vkCmdBindDescriptorBuffersEXT(%u)\n", cmdBuf, bindPoint);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+  vkCmdBindDescriptorBuffers_(cmdBuf, 1, &bindingInfo);
+  vkCmdSetDescriptorBufferOffsets_(
+      cmdBuf, bindPoint, layout, kBindPoint_Bindless, 1, &bufferIndex, &offset);
+#else
+  IGL_ASSERT_NOT_REACHED();
+#endif // VK_EXT_descriptor_buffer
+}
+
+VkPipelineCreateFlags VulkanContext::getPipelineCreateFlags() const {
+#if defined(VK_EXT_descriptor_buffer)
+  if (useDescriptorBuffer_) {
+    return VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+  }
+#endif // VK_EXT_descriptor_buffer
+  return 0;
+}
+
+VkPipelineLayout VulkanContext::getVkPipelineLayout(VkPipelineBindPoint bindPoint,
+                                                    uint32_t& outBindlessGeneration) const {
+  std::lock_guard<std::mutex> lock(pipelineLayoutMutex_);
+
+  outBindlessGeneration = bindlessGeneration_;
+
+  return (bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE ? pipelineLayoutCompute_
+                                                      : pipelineLayoutGraphics_)
+      ->getVkPipelineLayout();
+}
+
+igl::Result VulkanContext::growBindlessDescriptorSet(uint32_t maxTextures,
+                                                     uint32_t maxSamplers) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  VkDevice device = device_->getVkDevice();
+
+  // create default descriptor set layout which is going to be shared by graphics pipelines
+  constexpr uint32_t numBindings = 7;
+  const std::array<VkDescriptorSetLayoutBinding, numBindings> bindings = {
+      ivkGetDescriptorSetLayoutBinding(
+          kBinding_Texture2D, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxTextures),
+      ivkGetDescriptorSetLayoutBinding(
+          kBinding_Texture2DArray, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxTextures),
+      ivkGetDescriptorSetLayoutBinding(
+          kBinding_Texture3D, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxTextures),
+      ivkGetDescriptorSetLayoutBinding(
+          kBinding_TextureCube, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxTextures),
+      ivkGetDescriptorSetLayoutBinding(kBinding_Sampler, VK_DESCRIPTOR_TYPE_SAMPLER, maxSamplers),
+      ivkGetDescriptorSetLayoutBinding(
+          kBinding_SamplerShadow, VK_DESCRIPTOR_TYPE_SAMPLER, maxSamplers),
+      ivkGetDescriptorSetLayoutBinding(
+          kBinding_StorageImages, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, maxTextures),
+  };
+  // descriptor buffers are plain memory: descriptors which are not accessed by the GPU can be
+  // written at any time, so they do not need (and do not allow) the update-after-bind flags
+  const uint32_t flags = useDescriptorBuffer_
+                             ? VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT
+                             : VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                   VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT |
+                                   VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+  const std::array<VkDescriptorBindingFlags, numBindings> bindingFlags = {
+      flags, flags, flags, flags, flags, flags, flags};
+  auto dsl = std::make_unique<VulkanDescriptorSetLayout>(
+      device,
+      numBindings,
+      bindings.data(),
+      bindingFlags.data(),
+      "Descriptor Set Layout: VulkanContext::dslBindless_",
+      false,
+      useDescriptorBuffer_);
+
+  VkDescriptorPool dp = VK_NULL_HANDLE;
+  VkDescriptorSet ds = VK_NULL_HANDLE;
+  std::shared_ptr<VulkanBuffer> descriptorBuffer;
+  std::array<VkDeviceSize, numBindings> bindingOffsets = {};
+
+  if (useDescriptorBuffer_) {
+#if defined(VK_EXT_descriptor_buffer)
+    VkDeviceSize size = 0;
+    vkGetDescriptorSetLayoutSize_(device, dsl->getVkDescriptorSetLayout(), &size);
+    for (uint32_t i = 0; i != numBindings; i++) {
+      vkGetDescriptorSetLayoutBindingOffset_(
+          device, dsl->getVkDescriptorSetLayout(), bindings[i].binding, &bindingOffsets[i]);
+    }
+    VkBufferUsageFlags usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+                               VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT |
+                               VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT_KHR;
+    if (!vkPhysicalDeviceDescriptorBufferProperties_.bufferlessPushDescriptors) {
+      // the Bindings descriptor pushed into set #1 is stored by the driver in this buffer
+      usage |= VK_BUFFER_USAGE_PUSH_DESCRIPTORS_DESCRIPTOR_BUFFER_BIT_EXT;
+    }
+    Result result;
+    descriptorBuffer =
+        createBuffer(size,
+                     usage,
+                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                     &result,
+                     "Buffer: VulkanContext::descriptorBufferBindless_");
+    if (!IGL_VERIFY(result.isOk())) {
+      return result;
+    }
+#endif // VK_EXT_descriptor_buffer
+  } else {
+    // create a descriptor pool and allocate 1 descriptor set: there is no need for more sets
+    // because descriptors are only ever written into slots which are not in use by the GPU
+    const std::array<VkDescriptorPoolSize, numBindings> poolSizes = {
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxTextures},
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxTextures},
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxTextures},
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxTextures},
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLER, maxSamplers},
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLER, maxSamplers},
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, maxTextures},
+    };
+    VK_ASSERT_RETURN(ivkCreateDescriptorPool(
+        device, 1, static_cast<uint32_t>(poolSizes.size()), poolSizes.data(), &dp));
+    VK_ASSERT_RETURN(ivkAllocateDescriptorSet(device, dp, dsl->getVkDescriptorSetLayout(), &ds));
+  }
+
+  const std::vector<VkDescriptorSetLayout> DSLs = {
+      dsl->getVkDescriptorSetLayout(), dslDynamicUniformBuffer_->getVkDescriptorSetLayout()};
+
+  // graphics pipelines read the input attachments of framebuffer fetch from set #2
+  std::vector<VkDescriptorSetLayout> graphicsDSLs = DSLs;
+  if (dslInputAttachments_) {
+    graphicsDSLs.push_back(dslInputAttachments_->getVkDescriptorSetLayout());
+  }
+
+  // create pipeline layout
+  auto pipelineLayoutGraphics = std::make_unique<VulkanPipelineLayout>(
+      device,
+      graphicsDSLs,
+      ivkGetPushConstantRange(
+          VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, kPushConstantsSize),
+      "Pipeline Layout: VulkanContext::pipelineLayoutGraphics_");
+
+  auto pipelineLayoutCompute = std::make_unique<VulkanPipelineLayout>(
+      device,
+      DSLs,
+      ivkGetPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, 0, kPushConstantsSize),
+      "Pipeline Layout: VulkanContext::pipelineLayoutCompute_");
+
+  std::lock_guard<std::mutex> lock(pipelineLayoutMutex_);
+
+  if (dslBindless_) {
+    retiredDSLs_.push_back(std::move(dslBindless_));
+    retiredPipelineLayouts_.push_back(std::move(pipelineLayoutGraphics_));
+    retiredPipelineLayouts_.push_back(std::move(pipelineLayoutCompute_));
+    if (dpBindless_ != VK_NULL_HANDLE) {
+      retiredDPs_.push_back(dpBindless_);
+    }
+    if (descriptorBufferBindless_) {
+      retiredDescriptorBuffers_.push_back(std::move(descriptorBufferBindless_));
+    }
+  }
+
+  dslBindless_ = std::move(dsl);
+  dpBindless_ = dp;
+  dsBindless_ = ds;
+  descriptorBufferBindless_ = std::move(descriptorBuffer);
+  descriptorBufferBindingOffsets_ = bindingOffsets;
+  pipelineLayoutGraphics_ = std::move(pipelineLayoutGraphics);
+  pipelineLayoutCompute_ = std::move(pipelineLayoutCompute);
+  bindlessMaxTextures_ = maxTextures;
+  bindlessMaxSamplers_ = maxSamplers;
+  bindlessGeneration_++;
+
+  // the new descriptor set is empty
+  dirtyIndicesTextures_.resize(textures_.size());
+  dirtyIndicesSamplers_.resize(samplers_.size());
+  std::iota(dirtyIndicesTextures_.begin(), dirtyIndicesTextures_.end(), 0u);
+  std::iota(dirtyIndicesSamplers_.begin(), dirtyIndicesSamplers_.end(), 0u);
+  awaitingCreation_ = true;
+
+  return Result();
+}
+
+void VulkanContext::processPendingFreeIndices() const {
+  while (!pendingFreeIndicesTextures_.empty() &&
+         immediate_->isReady(pendingFreeIndicesTextures_.front().handle, true)) {
+    freeIndicesTextures_.push_back(pendingFreeIndicesTextures_.front().index);
+    pendingFreeIndicesTextures_.pop_front();
+  }
+  while (!pendingFreeIndicesSamplers_.empty() &&
+         immediate_->isReady(pendingFreeIndicesSamplers_.front().handle, true)) {
+    freeIndicesSamplers_.push_back(pendingFreeIndicesSamplers_.front().index);
+    pendingFreeIndicesSamplers_.pop_front();
+  }
+}
+
 std::shared_ptr<VulkanTexture> VulkanContext::createTexture(
     std::shared_ptr<VulkanImage> image,
-    std::shared_ptr<VulkanImageView> imageView) const {
-  auto texture = std::make_shared<VulkanTexture>(*this, std::move(image), std::move(imageView));
+    std::shared_ptr<VulkanImageView> imageView,
+    igl::Result* outResult,
+    VkFormat viewFormat,
+    uint32_t baseLevel,
+    uint32_t baseLayer) const {
+  auto texture = std::make_shared<VulkanTexture>(
+      *this, std::move(image), std::move(imageView), viewFormat, baseLevel, baseLayer);
   if (!IGL_VERIFY(texture)) {
+    Result::setResult(outResult, Result::Code::InvalidOperation);
     return nullptr;
   }
+  std::lock_guard<std::mutex> lock(bindlessMutex_);
   if (!freeIndicesTextures_.empty()) {
     // reuse an empty slot
     texture->textureId_ = freeIndicesTextures_.back();
     freeIndicesTextures_.pop_back();
     textures_[texture->textureId_] = texture;
   } else {
+    // the bindless arrays cannot grow past the device limit, see checkAndUpdateDescriptorSets()
+    if (textures_.size() >= vkPhysicalDeviceDescriptorIndexingProperties_
+                                .maxDescriptorSetUpdateAfterBindSampledImages) {
+      Result::setResult(outResult,
+                        Result::Code::RuntimeError,
+                        "All bindless texture slots are in use; release textures first");
+      return nullptr;
+    }
     texture->textureId_ = uint32_t(textures_.size());
     textures_.emplace_back(texture);
   }
 
-  IGL_ASSERT(textures_.size() <= config_.maxTextures);
-
+  dirtyIndicesTextures_.push_back(texture->textureId_);
   awaitingCreation_ = true;
 
+  Result::setOk(outResult);
   return texture;
 }
 
@@ -1012,20 +2051,28 @@ std::shared_ptr<VulkanSampler> VulkanContext::createSampler(const VkSamplerCreat
     Result::setResult(outResult, Result::Code::InvalidOperation);
     return nullptr;
   }
+  std::lock_guard<std::mutex> lock(bindlessMutex_);
   if (!freeIndicesSamplers_.empty()) {
     // reuse an empty slot
     sampler->samplerId_ = freeIndicesSamplers_.back();
     freeIndicesSamplers_.pop_back();
     samplers_[sampler->samplerId_] = sampler;
   } else {
+    if (samplers_.size() >=
+        vkPhysicalDeviceDescriptorIndexingProperties_.maxDescriptorSetUpdateAfterBindSamplers) {
+      Result::setResult(outResult,
+                        Result::Code::RuntimeError,
+                        "All bindless sampler slots are in use; release samplers first");
+      return nullptr;
+    }
     sampler->samplerId_ = uint32_t(samplers_.size());
     samplers_.emplace_back(sampler);
   }
 
-  IGL_ASSERT(samplers_.size() <= config_.maxSamplers);
-
+  dirtyIndicesSamplers_.push_back(sampler->samplerId_);
   awaitingCreation_ = true;
 
+  Result::setOk(outResult);
   return sampler;
 }
 
@@ -1139,17 +2186,131 @@ std::vector<uint8_t> VulkanContext::getPipelineCacheData() const {
   return data;
 }
 
+std::vector<uint8_t> VulkanContext::loadPipelineCacheFile() const {
+  IGL_PROFILER_FUNCTION();
+
+  if (config_.pipelineCacheFilePath.empty()) {
+    return {};
+  }
+
+  FILE* file = fopen(config_.pipelineCacheFilePath.c_str(), "rb");
+
+  if (!file) {
+    IGL_LOG_INFO("Pipeline cache file %s not found\n", config_.pipelineCacheFilePath.c_str());
+    return {};
+  }
+
+  const VkPhysicalDeviceProperties& props = vkPhysicalDeviceProperties2_.properties;
+  const PipelineCacheFileHeader expected = getPipelineCacheFileHeader(props);
+
+  PipelineCacheFileHeader header;
+  std::vector<uint8_t> data;
+
+  const bool isHeaderValid =
+      fread(&header, sizeof(header), 1, file) == 1 && header.magic == expected.magic &&
+      header.version == expected.version && header.vendorID == expected.vendorID &&
+      header.deviceID == expected.deviceID && header.driverVersion == expected.driverVersion &&
+      memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) == 0 &&
+      header.reserved == 0 && header.dataSize <= config_.pipelineCacheMaxFileSize;
+
+  if (isHeaderValid) {
+    data.resize(header.dataSize);
+    if (fread(data.data(), 1, data.size(), file) != data.size() ||
+        hashCacheData(data.data(), data.size()) != header.dataHash ||
+        !isPipelineCacheDataCompatible(data, props)) {
+      data.clear();
+    }
+  }
+
+  fclose(file);
+
+  if (data.empty()) {
+    IGL_LOG_INFO("Pipeline cache file %s is stale or corrupted. Ignoring it\n",
+                 config_.pipelineCacheFilePath.c_str());
+  }
+
+  return data;
+}
+
+bool VulkanContext::savePipelineCache() const {
+  if (pipelineCacheSaved_.valid()) {
+    pipelineCacheSaved_.wait();
+  }
+
+  return writePipelineCacheFile();
+}
+
+bool VulkanContext::writePipelineCacheFile() const {
+  IGL_PROFILER_FUNCTION();
+
+  if (config_.pipelineCacheFilePath.empty() || !device_ || pipelineCache_ == VK_NULL_HANDLE) {
+    return false;
+  }
+
+  const std::vector<uint8_t> data = getPipelineCacheData();
+
+  if (data.empty() || data.size() == pipelineCacheSavedSize_) {
+    // pipeline caches only grow, so the same size means nothing new has been added
+    return true;
+  }
+
+  if (data.size() > config_.pipelineCacheMaxFileSize) {
+    IGL_LOG_INFO("Pipeline cache size %u exceeds the limit of %u bytes. Not saving it\n",
+                 (uint32_t)data.size(),
+                 (uint32_t)config_.pipelineCacheMaxFileSize);
+    return false;
+  }
+
+  PipelineCacheFileHeader header =
+      getPipelineCacheFileHeader(vkPhysicalDeviceProperties2_.properties);
+  header.dataSize = data.size();
+  header.dataHash = hashCacheData(data.data(), data.size());
+
+  if (!writeCacheFile(
+          config_.pipelineCacheFilePath, &header, sizeof(header), data.data(), data.size())) {
+    return false;
+  }
+
+  pipelineCacheSavedSize_ = data.size();
+
+  return true;
+}
+
+void VulkanContext::savePipelineCachePeriodically() const {
+  if (!config_.pipelineCacheSaveIntervalSec || config_.pipelineCacheFilePath.empty()) {
+    return;
+  }
+
+  const auto elapsed = std::chrono::steady_clock::now() - pipelineCacheSaveTime_;
+
+  if (elapsed < std::chrono::seconds(config_.pipelineCacheSaveIntervalSec)) {
+    return;
+  }
+
+  if (pipelineCacheSaved_.valid() &&
+      pipelineCacheSaved_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    return;
+  }
+
+  pipelineCacheSaveTime_ = std::chrono::steady_clock::now();
+
+  // vkGetPipelineCacheData() and the file I/O stay off the submit path. Pipeline caches are
+  // internally synchronized, so pipelines can keep being created meanwhile
+  pipelineCacheSaved_ =
+      std::async(std::launch::async, [this]() { return writePipelineCacheFile(); });
+}
+
 uint64_t VulkanContext::getFrameNumber() const {
   return swapchain_ ? swapchain_->getFrameNumber() : 0u;
 }
 
 VulkanContext::DynamicUniformsBufferSet::DynamicUniformsBufferSet(VulkanContext& ctx) : ctx_{ctx} {
   // Respect the hardware dynamic UBO alignment
-  const VkDeviceSize kMinAlignment =
-      ctx_.vkPhysicalDeviceProperties2_.properties.limits.minUniformBufferOffsetAlignment;
+  minAlignment_ =
+      std::max(ctx_.vkPhysicalDeviceProperties2_.properties.limits.minUniformBufferOffsetAlignment,
+               VkDeviceSize(1));
 
-  bufferSizeAligned_ = (ResourcesBinder::kDUBBufferSize + kMinAlignment - 1) & ~(kMinAlignment - 1);
-  IGL_ASSERT(bufferSizeAligned_ <= ctx_.dynamicUniformBufferSize_);
+  IGL_ASSERT(ResourcesBinder::kDUBBufferSize <= ctx_.dynamicUniformBufferSize_);
 
   // Pre-allocate all Dynamic Uniform Buffers
   for (uint32_t index = 0u; index < kMaxDynamicUniformBuffers; ++index) {
@@ -1175,11 +2336,20 @@ void VulkanContext::DynamicUniformsBufferSet::acquireNextDUB() {
 
 void VulkanContext::DynamicUniformsBufferSet::update(VkCommandBuffer cmdBuf,
                                                      VkPipelineBindPoint bindPoint,
-                                                     const Bindings* data) {
+                                                     const Bindings* data,
+                                                     size_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
   IGL_ASSERT(currentDUB_);
+  IGL_ASSERT(size <= ResourcesBinder::kDUBBufferSize);
+
+  // the shaders always see the entire Bindings struct, so every upload owns a whole range: the
+  // slots past `size` are zeroed instead of exposing the bindings of another draw call
+  const VkDeviceSize sizeAligned =
+      (ResourcesBinder::kDUBBufferSize + minAlignment_ - 1) & ~(minAlignment_ - 1);
 
-  const bool canFitIntoCurrentDUB =
-      (currentDUB_->offset_ + bufferSizeAligned_ <= ctx_.dynamicUniformBufferSize_);
+  const bool canFitIntoCurrentDUB = (currentDUB_->offset_ + ResourcesBinder::kDUBBufferSize <=
+                                     ctx_.dynamicUniformBufferSize_);
 
   if (!canFitIntoCurrentDUB) {
     acquireNextDUB();
@@ -1188,40 +2358,66 @@ void VulkanContext::DynamicUniformsBufferSet::update(VkCommandBuffer cmdBuf,
   DynamicUniformBuffer* buf = currentDUB_;
 
   IGL_ASSERT(buf->buffer_->getMappedPtr());
-  IGL_ASSERT(buf->offset_ + bufferSizeAligned_ <= ctx_.dynamicUniformBufferSize_);
+  IGL_ASSERT(buf->offset_ + ResourcesBinder::kDUBBufferSize <= ctx_.dynamicUniformBufferSize_);
 
   if (data) {
-    checked_memcpy(buf->buffer_->getMappedPtr() + buf->offset_,
-                   ctx_.dynamicUniformBufferSize_ - buf->offset_,
-                   data,
-                   ResourcesBinder::kDUBBufferSize);
-    buf->buffer_->flushMappedMemory(buf->offset_, ResourcesBinder::kDUBBufferSize);
+    uint8_t* dst = buf->buffer_->getMappedPtr() + buf->offset_;
+    checked_memcpy(dst, ctx_.dynamicUniformBufferSize_ - buf->offset_, data, size);
+    // zero-filling does not read the unused slots of `data`
+    memset(dst + size, 0, ResourcesBinder::kDUBBufferSize - size);
+    // flushed with the other uniform writes before the next submit
+    buf->buffer_->markDirty(buf->offset_, ResourcesBinder::kDUBBufferSize);
   }
 
   const bool isGraphics = bindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS;
-
-  // @lint-ignore CLANGTIDY
-  const VkDescriptorSet sets[] = {ctx_.bindlessDSets_[ctx_.currentDSetIndex_].ds, buf->ds_};
+  const VkPipelineLayout layout =
+      (isGraphics ? ctx_.pipelineLayoutGraphics_ : ctx_.pipelineLayoutCompute_)
+          ->getVkPipelineLayout();
+
+  if (ctx_.usePushDescriptors_) {
+    // the bindless descriptor set is bound once per command buffer (update() without data) and
+    // stays bound while the Bindings descriptor is pushed
+    if (!data) {
+      if (ctx_.useDescriptorBuffer_) {
+        ctx_.bindBindlessDescriptorBuffer(cmdBuf, bindPoint, layout);
+      } else {
+#if IGL_VULKAN_PRINT_COMMANDS
+        IGL_LOG_INFO("%p vkCmdBindDescriptorSets(%u, 1)\n", cmdBuf, bindPoint);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+        vkCmdBindDescriptorSets(
+            cmdBuf, bindPoint, layout, kBindPoint_Bindless, 1, &ctx_.dsBindless_, 0, nullptr);
+      }
+    }
+    const VkDescriptorBufferInfo bufferInfo = {
+        buf->buffer_->getVkBuffer(), buf->offset_, ResourcesBinder::kDUBBufferSize};
+    const VkWriteDescriptorSet write = ivkGetWriteDescriptorSet_BufferInfo(
+        VK_NULL_HANDLE, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, &bufferInfo);
+#if IGL_VULKAN_PRINT_COMMANDS
+    IGL_LOG_INFO("%p vkCmdPushDescriptorSetKHR(%u, %u)\n", cmdBuf, bindPoint, buf->offset_);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+    ctx_.vkCmdPushDescriptorSet_(cmdBuf, bindPoint, layout, kBindPoint_Bindless + 1, 1, &write);
+  } else {
+    // @lint-ignore CLANGTIDY
+    const VkDescriptorSet sets[] = {ctx_.dsBindless_, buf->ds_};
 
 #if IGL_VULKAN_PRINT_COMMANDS
-  IGL_LOG_INFO("%p vkCmdBindDescriptorSets(%u, %llu) - DSet: %u\n",
-               cmdBuf,
-               bindPoint,
-               IGL_ARRAY_NUM_ELEMENTS(sets),
-               ctx_.currentDSetIndex_);
+    IGL_LOG_INFO("%p vkCmdBindDescriptorSets(%u, %llu)\n",
+                 cmdBuf,
+                 bindPoint,
+                 IGL_ARRAY_NUM_ELEMENTS(sets));
 #endif // IGL_VULKAN_PRINT_COMMANDS
-  vkCmdBindDescriptorSets(cmdBuf,
-                          bindPoint,
-                          (isGraphics ? ctx_.pipelineLayoutGraphics_ : ctx_.pipelineLayoutCompute_)
-                              ->getVkPipelineLayout(),
-                          kBindPoint_Bindless,
-                          IGL_ARRAY_NUM_ELEMENTS(sets),
-                          sets,
-                          1,
-                          &buf->offset_);
+    vkCmdBindDescriptorSets(cmdBuf,
+                            bindPoint,
+                            layout,
+                            kBindPoint_Bindless,
+                            IGL_ARRAY_NUM_ELEMENTS(sets),
+                            sets,
+                            1,
+                            &buf->offset_);
+  }
 
   if (data) {
-    buf->offset_ += (uint32_t)bufferSizeAligned_;
+    buf->offset_ += (uint32_t)sizeAligned;
   }
 }
 
@@ -1238,22 +2434,31 @@ void VulkanContext::DynamicUniformsBufferSet::allocateDynamicUniformsBuffer() {
 
   IGL_ASSERT(result.isOk());
 
-  VK_ASSERT(ivkAllocateDescriptorSet(ctx_.device_->getVkDevice(),
-                                     ctx_.dpDynamicUniformBuffer_,
-                                     ctx_.dslDynamicUniformBuffer_->getVkDescriptorSetLayout(),
-                                     &buf.ds_));
+  // slots which are not uploaded by update() are read from whatever was written there before
+  memset(buf.buffer_->getMappedPtr(), 0, ctx_.dynamicUniformBufferSize_);
+  buf.buffer_->flushMappedMemory(0, ctx_.dynamicUniformBufferSize_);
+
+  // push descriptors are written straight into command buffers by update()
+  if (!ctx_.usePushDescriptors_) {
+    VK_ASSERT(ivkAllocateDescriptorSet(ctx_.device_->getVkDevice(),
+                                       ctx_.dpDynamicUniformBuffer_,
+                                       ctx_.dslDynamicUniformBuffer_->getVkDescriptorSetLayout(),
+                                       &buf.ds_));
 
-  const VkDescriptorBufferInfo bufferInfo = {
-      buf.buffer_->getVkBuffer(), 0, sizeof(ResourcesBinder::bindings_)};
-  const VkWriteDescriptorSet set = ivkGetWriteDescriptorSet_BufferInfo(
-      buf.ds_, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1, &bufferInfo);
-  vkUpdateDescriptorSets(ctx_.device_->getVkDevice(), 1, &set, 0, nullptr);
+    const VkDescriptorBufferInfo bufferInfo = {
+        buf.buffer_->getVkBuffer(), 0, sizeof(ResourcesBinder::bindings_)};
+    const VkWriteDescriptorSet set = ivkGetWriteDescriptorSet_BufferInfo(
+        buf.ds_, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1, &bufferInfo);
+    vkUpdateDescriptorSets(ctx_.device_->getVkDevice(), 1, &set, 0, nullptr);
+  }
 
   DUBs_.push_back(buf);
 }
 
 void VulkanContext::DynamicUniformsBufferSet::markSubmit(
     const VulkanImmediateCommands::SubmitHandle& handle) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
   IGL_ASSERT(currentDUB_);
 
   if (lastSubmittedDUBIndex_ == currentDUBIndex_ && !currentDUB_->offset_) {
@@ -1275,33 +2480,200 @@ void VulkanContext::DynamicUniformsBufferSet::markSubmit(
 }
 
 void VulkanContext::deferredTask(std::packaged_task<void()>&& task, SubmitHandle handle) const {
-  if (handle.empty()) {
-    handle = immediate_->getLastSubmitHandle();
+  VulkanDestructionQueue::Entry entry;
+  entry.type = DestructionType::Task;
+  entry.task = new std::packaged_task<void()>(std::move(task));
+  entry.handle = handle;
+  pushDeferredEntry(entry);
+}
+
+void VulkanContext::deferredDestroy(DestructionType type, uint64_t object, uint64_t memory) const {
+  IGL_ASSERT(type != DestructionType::Task);
+
+  VulkanDestructionQueue::Entry entry;
+  entry.type = type;
+  entry.object = object;
+  entry.memory = memory;
+  pushDeferredEntry(entry);
+}
+
+void VulkanContext::pushDeferredEntry(const VulkanDestructionQueue::Entry& entry) const {
+  if (!deferredQueue_.push(entry)) {
+    // the ring is full; this should be rare enough to take a lock
+    std::lock_guard<std::mutex> lock(deferredOverflowMutex_);
+    deferredOverflow_.push_back(entry);
+  }
+}
+
+VulkanContext::SecondaryCommandBuffer VulkanContext::acquireSecondaryCommandBuffer() const {
+  IGL_PROFILER_FUNCTION();
+
+  {
+    std::lock_guard<std::mutex> lock(secondaryCommandBuffersMutex_);
+    if (!freeSecondaryCommandBuffers_.empty()) {
+      SecondaryCommandBuffer buffer = std::move(freeSecondaryCommandBuffers_.back());
+      freeSecondaryCommandBuffers_.pop_back();
+      return buffer;
+    }
   }
-  deferredTasks_.emplace_back(std::move(task), handle);
+
+  SecondaryCommandBuffer buffer;
+  buffer.pool = std::make_shared<VulkanCommandPool>(device_->getVkDevice(),
+                                                    VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+                                                    deviceQueues_.graphicsQueueFamilyIndex,
+                                                    "VulkanContext::secondaryCommandPool");
+  VK_ASSERT(ivkAllocateSecondaryCommandBuffer(
+      device_->getVkDevice(), buffer.pool->getVkCommandPool(), &buffer.cmdBuf));
+
+  return buffer;
+}
+
+void VulkanContext::releaseSecondaryCommandBuffer(SecondaryCommandBuffer buffer,
+                                                  SubmitHandle handle) const {
+  IGL_ASSERT(buffer.pool);
+
+  deferredTask(std::packaged_task<void()>([this, buffer = std::move(buffer)]() {
+                 // the pool is transient and owns only this buffer, so resetting it is cheap
+                 VK_ASSERT(vkResetCommandPool(
+                     device_->getVkDevice(), buffer.pool->getVkCommandPool(), 0));
+                 std::lock_guard<std::mutex> lock(secondaryCommandBuffersMutex_);
+                 freeSecondaryCommandBuffers_.push_back(buffer);
+               }),
+               handle);
 }
 
 bool VulkanContext::areValidationLayersEnabled() const {
   return config_.enableValidation;
 }
 
+bool VulkanContext::useResizableBar(VkDeviceSize size) const {
+  if (!resizableBarHeapSize_ || size > config_.resizableBarMaxBufferSize) {
+    return false;
+  }
+  // leave at least half of the heap to allocations which require device-local memory
+  return resizableBarBufferMemoryBytes_ + size <= resizableBarHeapSize_ / 2;
+}
+
 void* VulkanContext::getVmaAllocator() const {
   return pimpl_->vma_;
 }
 
+bool VulkanContext::defragmentMemory(std::chrono::nanoseconds timeBudget) const {
+  if (!IGL_VULKAN_USE_VMA) {
+    return true;
+  }
+  if (!defragmenter_) {
+    defragmenter_ = std::make_unique<igl::vulkan::VulkanDefragmenter>(*this);
+  }
+  return defragmenter_->defragment(timeBudget);
+}
+
+void VulkanContext::popDeferredEntries() const {
+  // any command buffer submitted before an entry is popped might still use its object
+  const SubmitHandle lastSubmitHandle = immediate_->getLastSubmitHandle();
+
+  VulkanDestructionQueue::Entry entry;
+
+  while (deferredQueue_.pop(entry)) {
+    if (entry.handle.empty()) {
+      entry.handle = lastSubmitHandle;
+    }
+    deferredTasks_.push_back(entry);
+  }
+
+  std::lock_guard<std::mutex> lock(deferredOverflowMutex_);
+
+  for (auto& e : deferredOverflow_) {
+    if (e.handle.empty()) {
+      e.handle = lastSubmitHandle;
+    }
+    deferredTasks_.push_back(e);
+  }
+
+  deferredOverflow_.clear();
+}
+
+void VulkanContext::destroyDeferredEntry(const VulkanDestructionQueue::Entry& entry) const {
+  VkDevice device = device_->getVkDevice();
+
+  switch (entry.type) {
+  case DestructionType::Task:
+    (*entry.task)();
+    delete entry.task;
+    break;
+  case DestructionType::Pipeline:
+    vkDestroyPipeline(device, (VkPipeline)entry.object, nullptr);
+    break;
+  case DestructionType::ImageView:
+    vkDestroyImageView(device, (VkImageView)entry.object, nullptr);
+    break;
+  case DestructionType::Sampler:
+    vkDestroySampler(device, (VkSampler)entry.object, nullptr);
+    break;
+  case DestructionType::Framebuffer:
+    vkDestroyFramebuffer(device, (VkFramebuffer)entry.object, nullptr);
+    break;
+  case DestructionType::QueryPool:
+    vkDestroyQueryPool(device, (VkQueryPool)entry.object, nullptr);
+    break;
+  case DestructionType::Buffer:
+    vkDestroyBuffer(device, (VkBuffer)entry.object, nullptr);
+    vkFreeMemory(device, (VkDeviceMemory)entry.memory, nullptr);
+    break;
+  case DestructionType::Image:
+    vkDestroyImage(device, (VkImage)entry.object, nullptr);
+    if (entry.memory) {
+      vkFreeMemory(device, (VkDeviceMemory)entry.memory, nullptr);
+    }
+    break;
+  case DestructionType::VmaBuffer:
+    vmaDestroyBuffer((VmaAllocator)getVmaAllocator(),
+                     (VkBuffer)entry.object,
+                     (VmaAllocation)(uintptr_t)entry.memory);
+    break;
+  case DestructionType::VmaImage:
+    vmaDestroyImage((VmaAllocator)getVmaAllocator(),
+                    (VkImage)entry.object,
+                    (VmaAllocation)(uintptr_t)entry.memory);
+    break;
+  case DestructionType::Memory:
+    vkFreeMemory(device, (VkDeviceMemory)entry.object, nullptr);
+    break;
+  }
+}
+
 void VulkanContext::processDeferredTasks() const {
-  while (!deferredTasks_.empty() && immediate_->isReady(deferredTasks_.front().handle_, true)) {
-    deferredTasks_.front().task_();
+  popDeferredEntries();
+
+  while (!deferredTasks_.empty() && immediate_->isReady(deferredTasks_.front().handle, true)) {
+    destroyDeferredEntry(deferredTasks_.front());
     deferredTasks_.pop_front();
   }
 }
 
 void VulkanContext::waitDeferredTasks() {
-  for (auto& task : deferredTasks_) {
-    immediate_->wait(task.handle_);
-    task.task_();
+  popDeferredEntries();
+
+  while (!deferredTasks_.empty()) {
+    immediate_->wait(deferredTasks_.front().handle);
+    destroyDeferredEntry(deferredTasks_.front());
+    deferredTasks_.pop_front();
+    // destroying an object can release more objects
+    popDeferredEntries();
   }
-  deferredTasks_.clear();
+}
+
+VulkanContext::SubmitHandle VulkanContext::retireAsyncComputeSubmit(SubmitHandle handle) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_SUBMIT);
+  IGL_ASSERT(computeImmediate_);
+
+  const auto& wrapper = immediate_->acquire();
+  // waiting at the bottom of the pipe does not stall the graphics work submitted in the meantime,
+  // it only delays the completion of this (empty) submit
+  immediate_->waitTimelineSemaphore(computeImmediate_->getTimelineSemaphore(),
+                                    computeImmediate_->getSignalValue(handle),
+                                    VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+  return immediate_->submit(wrapper);
 }
 
 } // namespace vulkan
@@ -7,17 +7,25 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <deque>
 #include <future>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <unordered_map>
 
 #include <igl/HWDevice.h>
 #include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanCommandPool.h>
+#include <igl/vulkan/VulkanDestructionQueue.h>
 #include <igl/vulkan/VulkanDevice.h>
 #include <igl/vulkan/VulkanExtensions.h>
 #include <igl/vulkan/VulkanHelpers.h>
 #include <igl/vulkan/VulkanImmediateCommands.h>
+#include <igl/vulkan/VulkanPipelineBuilder.h>
 #include <igl/vulkan/VulkanQueuePool.h>
 #include <igl/vulkan/VulkanRenderPassBuilder.h>
 #include <igl/vulkan/VulkanStagingDevice.h>
@@ -32,13 +40,17 @@ class ComputeCommandEncoder;
 class RenderCommandEncoder;
 class SyncManager;
 class VulkanBuffer;
+class VulkanBufferPool;
+class VulkanDefragmenter;
 class VulkanDevice;
 class VulkanDescriptorSetLayout;
 class VulkanImage;
 class VulkanImageView;
+class VulkanMipmapGenerator;
 class VulkanPipelineLayout;
 class VulkanSampler;
 class VulkanSemaphore;
+class VulkanSpirvCache;
 class VulkanSwapchain;
 class VulkanTexture;
 
@@ -49,9 +61,17 @@ struct DeviceQueues {
   const static uint32_t INVALID = 0xFFFFFFFF;
   uint32_t graphicsQueueFamilyIndex = INVALID;
   uint32_t computeQueueFamilyIndex = INVALID;
+  uint32_t computeQueueIndex = 0;
+  // dedicated transfer queue used by the staging device for asynchronous uploads (optional)
+  uint32_t transferQueueFamilyIndex = INVALID;
+  uint32_t transferQueueIndex = 0;
+  // second queue of the graphics family used by the present thread (optional)
+  uint32_t presentQueueIndex = INVALID;
 
   VkQueue graphicsQueue = VK_NULL_HANDLE;
   VkQueue computeQueue = VK_NULL_HANDLE;
+  VkQueue transferQueue = VK_NULL_HANDLE;
+  VkQueue presentQueue = VK_NULL_HANDLE;
 
   DeviceQueues() = default;
 };
@@ -59,27 +79,184 @@ struct DeviceQueues {
 struct VulkanContextConfig {
   // small default values are used to speed up debugging via RenderDoc and Validation Layers
   // macOS: MVK_CONFIG_USE_METAL_ARGUMENT_BUFFERS is required when using this with MoltenVK
+  // initial capacity of the bindless arrays, they grow on demand up to the device limits
   uint32_t maxTextures = 512;
   uint32_t maxSamplers = 512;
   bool terminateOnValidationError = false; // invoke std::terminate() on any validation error
 
-  // enable/disable enhanced shader debugging capabilities (line drawing)
+  // enable/disable enhanced shader debugging capabilities (line drawing), ignored if
+  // IGL_VULKAN_ENHANCED_SHADER_DEBUGGING is 0
   bool enhancedShaderDebugging = false;
+  // instrument only the draw calls recorded after
+  // vulkan::RenderCommandEncoder::setShaderDebuggingEnabled(true); otherwise all draw calls record
+  // their lines. Shaders and pipelines are the same in both modes
+  bool enhancedShaderDebuggingSampled = false;
 
   bool enableConcurrentVkDevicesSupport = false;
 
+  // Offscreen rendering without a window, e.g. batch rendering on GPU servers without a display.
+  // No surface and swapchain extensions are enabled, the window passed to the context is ignored
+  // and initSwapchain() fails. Use enableConcurrentVkDevicesSupport as well to create a context
+  // per GPU in one process.
+  bool headless = false;
+
   bool enableValidation = true;
   bool enableGPUAssistedValidation = true;
   bool enableSynchronizationValidation = false;
   igl::ColorSpace swapChainColorSpace = igl::ColorSpace::SRGB_NONLINEAR;
+  // VK_PRESENT_MODE_MAX_ENUM_KHR picks the lowest-latency mode available. Unsupported modes fall
+  // back to VK_PRESENT_MODE_FIFO_KHR. Can be changed later with VulkanContext::setPresentMode()
+  VkPresentModeKHR swapchainPresentMode = VK_PRESENT_MODE_MAX_ENUM_KHR;
+  // How many frames the CPU can run ahead of the GPU before acquiring the next swapchain image
+  // blocks (0 means it is limited only by the number of swapchain images). With
+  // VK_KHR_present_wait frames are counted until they are displayed, otherwise until they are
+  // rendered. Can be changed later with VulkanContext::setMaxFramesInFlight()
+  uint32_t maxFramesInFlight = 0;
 
   std::vector<CommandQueueType> userQueues;
 
+  // Reserve a queue from a transfer-capable family other than the graphics one and let
+  // VulkanStagingDevice upload data on it asynchronously. Ignored if no such family exists.
+  bool enableStagingTransferQueue = false;
+
+  // Submit command buffers of CommandQueueType::Compute queues to deviceQueues_.computeQueue, so
+  // compute work can overlap with rendering. Requires timeline semaphores and a compute family
+  // other than the graphics one; compute queues share the graphics queue otherwise. Buffers and
+  // images created by IGL are shared between the queue families, external images are not.
+  bool enableAsyncComputeQueue = false;
+
+  // Acquire swapchain images and present them on a dedicated thread, so the render thread does not
+  // wait in vkAcquireNextImageKHR() and vkQueuePresentKHR(). The next image is acquired as soon as
+  // the previous one is presented. Requires a second queue in the graphics family, presents stay
+  // on the render thread otherwise. VulkanContext::waitForPresent() is unsupported in this mode.
+  bool enablePresentThread = false;
+
+  // Track submits with a VK_KHR_timeline_semaphore counter instead of polling fences, when the
+  // device supports it
+  bool enableTimelineSemaphore = true;
+
+  // Render without VkRenderPass/VkFramebuffer objects using VK_KHR_dynamic_rendering (core in
+  // Vulkan 1.3), when the device supports it
+  bool enableDynamicRendering = true;
+
+  // Identify presents with VK_KHR_present_id and wait for them with VK_KHR_present_wait, when the
+  // device supports both
+  bool enablePresentWait = true;
+
+  // Support sparse 2D textures (TextureDesc::TextureOptionBits::Sparse) when the device supports
+  // sparse residency and the graphics queue supports sparse binding operations
+  bool enableSparseResidency = true;
+
+  // Create the swapchain in the current orientation of the display (pre-rotation), so the
+  // compositor does not have to rotate every frame. The extent of the swapchain images is swapped
+  // for 90 and 270 degree rotations and rendering has to be rotated with
+  // PlatformDevice::getPreRotationMatrix(). Otherwise, the identity transform is used if supported
+  bool enableSwapchainPreRotation = true;
+
+  // Compile render pipeline variants from parts shared between variants and fast-link them with
+  // VK_EXT_graphics_pipeline_library, when the device supports fast linking. Linked pipelines are
+  // replaced with link-time optimized ones built on background threads.
+  bool enableGraphicsPipelineLibrary = true;
+
+  // Push the per-draw Bindings uniform buffer (see ResourcesBinder) with VK_KHR_push_descriptor,
+  // when the device supports it. Bindings updates push a single descriptor into the command buffer
+  // instead of rebinding both descriptor sets, and no descriptor sets are allocated for them.
+  bool enablePushDescriptors = true;
+
+  // Set the topology, depth write, depth compare and stencil operations of draws dynamically with
+  // VK_EXT_extended_dynamic_state (core in Vulkan 1.3), when the device supports it. Render
+  // pipelines then need one variant per topology class instead of one per combination of states.
+  bool enableExtendedDynamicState = true;
+
+  // Write the pixels of texture uploads straight from client memory with vkCopyMemoryToImageEXT()
+  // (VK_EXT_host_image_copy), when the device supports it. Such uploads use neither the staging
+  // buffer nor a queue submit. Only sampled textures which are never rendered to and whose format
+  // keeps optimal device access are created for host copies, see canUseHostImageCopy().
+  bool enableHostImageCopy = true;
+
+  // Import the client memory of large readbacks as a buffer (VK_EXT_external_memory_host), when
+  // the device supports it, so that the GPU copies the pixels straight into it. See
+  // VulkanStagingDevice::getImageData2D() for the alignment requirements.
+  bool enableHostPointerReadback = true;
+
+  // Record barriers with vkCmdPipelineBarrier2() (VK_KHR_synchronization2, core in Vulkan 1.3),
+  // when the device supports it. Each barrier of a batch keeps its own 64-bit stage and access
+  // masks instead of waiting for the union of all stages of the batch.
+  bool enableSynchronization2 = true;
+
+  // Store the bindless descriptors in a descriptor buffer (VK_EXT_descriptor_buffer) instead of a
+  // descriptor set, when the device supports it. Descriptors of new textures and samplers are
+  // copied straight into buffer memory and no descriptor pool is needed. Requires push
+  // descriptors and dynamic rendering, and is not used with graphics pipeline libraries.
+  bool enableDescriptorBuffer = false;
+
+  // Set the shading rate of draws with vkCmdSetFragmentShadingRateKHR()
+  // (VK_KHR_fragment_shading_rate), when the device supports it. The extension cannot be enabled
+  // together with VK_EXT_fragment_density_map, which is preferred unless this is true.
+  bool preferFragmentShadingRate = false;
+
+  // Log render pass attachments which waste memory bandwidth: contents stored by a pass and
+  // overwritten before being read, and loads of undefined contents. Intended for debugging
+  bool enableRenderPassAnalysis = false;
+
+  // Generate mipmaps of storage images with a single compute dispatch (VulkanMipmapGenerator)
+  // instead of a chain of blits. Other images and unsupported formats always use blits.
+  bool enableComputeMipmapGeneration = true;
+
   uint32_t maxResourceCount = 3u;
 
+  // VulkanStagingDevice stages uploads and readbacks through host-visible chunks. It starts with
+  // one chunk of `stagingChunkSize` bytes and adds more under load, up to `stagingMaxSize` bytes in
+  // total. Added chunks are released once they stay unused for a while.
+  uint32_t stagingChunkSize = 16u * 1024u * 1024u;
+  uint32_t stagingMaxSize = 256u * 1024u * 1024u;
+
+  // vulkan::Buffer objects up to `bufferPoolMaxAllocationSize` bytes are sub-allocated from
+  // shared VkBuffer blocks of `bufferPoolBlockSize` bytes. Set the block size to 0 to give every
+  // buffer its own VkBuffer and memory allocation.
+  size_t bufferPoolBlockSize = 4u * 1024u * 1024u;
+  size_t bufferPoolMaxAllocationSize = 64u * 1024u;
+
+  // On discrete GPUs with resizable BAR, ResourceStorage::Private buffers up to this size are
+  // placed in host-visible device-local memory and updated by the CPU without staging copies.
+  // Larger buffers and textures keep using staging. Set to 0 to always use staging.
+  size_t resizableBarMaxBufferSize = 256u * 1024u;
+
+  // VulkanImmediateCommands allocates more command buffers on demand, up to this number per queue,
+  // before acquire() has to wait for a submitted command buffer to complete
+  uint32_t maxCommandBuffersPerQueue = VulkanImmediateCommands::kDefaultMaxCommandBuffers;
+
+  // Accumulate the command buffers submitted to the graphics queue, including staging uploads, and
+  // issue them with a single vkQueueSubmit() at the end of the frame, before presenting, or when
+  // one of them is waited for. Saves the per-submit cost of drivers which make dozens of submits
+  // per frame expensive. Requires timeline semaphores, otherwise every submit is issued right away
+  bool enableDeferredSubmits = false;
+
   // owned by the application - should be alive until initContext() returns
   const void* pipelineCacheData = nullptr;
   size_t pipelineCacheDataSize = 0;
+
+  // Persistent on-disk pipeline cache. When the path is not empty, the cache is loaded in
+  // initContext() (taking precedence over `pipelineCacheData`) and written back on destruction.
+  // Files created by a different vendor/device/driver are discarded.
+  std::string pipelineCacheFilePath;
+  // caches larger than this are not saved (and not loaded), so the file cannot grow unbounded
+  size_t pipelineCacheMaxFileSize = 32u * 1024u * 1024u;
+  // if non-zero, the cache is also saved on a worker thread after a submit when this many seconds
+  // have elapsed since the last save
+  uint32_t pipelineCacheSaveIntervalSec = 0;
+
+  // Called after every pipeline and pipeline library creation with the time the driver spent and
+  // whether the pipeline was found in the pipeline cache (VK_EXT_pipeline_creation_feedback, core
+  // in Vulkan 1.3). The extension is only enabled when a callback is set. Optimized pipelines of
+  // enableGraphicsPipelineLibrary are linked on background threads, so the callback has to be
+  // thread-safe. Drivers may not report anything for some pipelines.
+  PipelineCreationFeedbackCallback pipelineCreationFeedback;
+
+  // GLSL shaders compiled by glslang are cached in memory for the lifetime of the context. When
+  // the path is not empty, the SPIR-V cache is also loaded from this file in initContext() and
+  // written back on destruction.
+  std::string spirvCacheFilePath;
 };
 
 class VulkanContext final {
@@ -98,7 +275,17 @@ class VulkanContext final {
 
   igl::Result initSwapchain(uint32_t width, uint32_t height);
   VkExtent2D getSwapchainExtent() const;
-
+  // recreates the swapchain if the present mode changes
+  igl::Result setPresentMode(VkPresentModeKHR presentMode);
+  void setMaxFramesInFlight(uint32_t maxFramesInFlight);
+  // the VK_KHR_present_id value of the last present (0 if presents are not identified)
+  uint64_t getLastPresentId() const;
+  // blocks until the present `presentId` is displayed or the timeout expires
+  igl::Result waitForPresent(uint64_t presentId, uint64_t timeoutNanos = UINT64_MAX) const;
+
+  // Images, buffers, textures and samplers can be created from any thread while other threads
+  // encode commands. Uploading their contents still goes through the staging device, which is
+  // not thread-safe.
   std::shared_ptr<VulkanImage> createImage(VkImageType imageType,
                                            VkExtent3D extent,
                                            VkFormat format,
@@ -111,6 +298,12 @@ class VulkanContext final {
                                            VkSampleCountFlagBits samples,
                                            igl::Result* outResult,
                                            const char* debugName = nullptr) const;
+  // returns true if images created with these parameters can be written by the host
+  // (VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT) without losing optimal device access
+  bool canUseHostImageCopy(VkImageType imageType,
+                           VkFormat format,
+                           VkImageUsageFlags usageFlags,
+                           VkImageCreateFlags flags) const;
   std::shared_ptr<VulkanImage> createImageFromFileDescriptor(int32_t fileDescriptor,
                                                              uint64_t memoryAllocationSize,
                                                              VkImageType imageType,
@@ -129,18 +322,39 @@ class VulkanContext final {
                                              VkMemoryPropertyFlags memFlags,
                                              igl::Result* outResult,
                                              const char* debugName = nullptr) const;
+  // textures and samplers fail to be created when every slot of the bindless arrays allowed by
+  // the device (maxDescriptorSetUpdateAfterBind*) is in use
   std::shared_ptr<VulkanTexture> createTexture(std::shared_ptr<VulkanImage> image,
-                                               std::shared_ptr<VulkanImageView> imageView) const;
+                                               std::shared_ptr<VulkanImageView> imageView,
+                                               igl::Result* outResult,
+                                               VkFormat viewFormat = VK_FORMAT_UNDEFINED,
+                                               uint32_t baseLevel = 0,
+                                               uint32_t baseLayer = 0) const;
   std::shared_ptr<VulkanSampler> createSampler(const VkSamplerCreateInfo& ci,
                                                igl::Result* outResult,
                                                const char* debugName = nullptr) const;
 
+  // false for headless contexts and contexts created without a window
+  bool hasSurface() const noexcept {
+    return vkSurface_ != VK_NULL_HANDLE;
+  }
   bool hasSwapchain() const noexcept {
     return swapchain_ != nullptr;
   }
+  // render passes accept FramebufferDesc::fragmentDensityMap (VK_EXT_fragment_density_map)
+  bool hasFragmentDensityMap() const noexcept {
+    return useFragmentDensityMap_;
+  }
+  // render pipelines have a dynamic fragment shading rate (VK_KHR_fragment_shading_rate)
+  bool hasFragmentShadingRate() const noexcept {
+    return useFragmentShadingRate_;
+  }
 
   Result waitIdle() const;
   Result present() const;
+  // flushes the host writes recorded with VulkanBuffer::markDirty() in one batched call. Called
+  // before every submit
+  void flushMappedMemoryRanges() const;
 
   const VkPhysicalDeviceProperties& getVkPhysicalDeviceProperties() const {
     return vkPhysicalDeviceProperties2_.properties;
@@ -174,25 +388,115 @@ class VulkanContext final {
 
   std::vector<uint8_t> getPipelineCacheData() const;
 
+  // writes the pipeline cache into `config_.pipelineCacheFilePath` (no-op if the path is empty)
+  bool savePipelineCache() const;
+  // reads the pipeline cache data from `config_.pipelineCacheFilePath`, empty if the file is
+  // missing, truncated, corrupted or was created by a different vendor/device/driver
+  std::vector<uint8_t> loadPipelineCacheFile() const;
+
+  // the callback pipeline builders report their creation feedback to, empty if unsupported
+  PipelineCreationFeedbackCallback getPipelineCreationFeedback() const {
+    return usePipelineCreationFeedback_ ? config_.pipelineCreationFeedback : nullptr;
+  }
+
+  // the function VulkanBarrierBatch records barriers with, null without VK_KHR_synchronization2
+  PFN_vkCmdPipelineBarrier2KHR getCmdPipelineBarrier2() const {
+    return vkCmdPipelineBarrier2_;
+  }
+
+  // the flags of all pipelines using the bindless pipeline layouts
+  VkPipelineCreateFlags getPipelineCreateFlags() const;
+
+  // the current bindless pipeline layout of `bindPoint` and the bindless generation it belongs to.
+  // Thread-safe: pipelines built on worker threads use it because growBindlessDescriptorSet()
+  // replaces the layouts on the rendering thread. Replaced layouts live as long as the context
+  VkPipelineLayout getVkPipelineLayout(VkPipelineBindPoint bindPoint,
+                                       uint32_t& outBindlessGeneration) const;
+
+  // glslang is only needed by shaders missing from the SPIR-V cache, so it is initialized by the
+  // first compilation (thread-safe)
+  void initGlslang() const;
+
+  // durations of the initialization steps in milliseconds, logged at the end of initContext()
+  struct StartupTimings {
+    double instance = 0; // loader, instance and surface (constructor)
+    double physicalDevice = 0; // features, properties, extensions and queues selection
+    double device = 0; // VkDevice, function pointers and command queues
+    double resources = 0; // VMA, pipeline cache, bindless descriptors and internal resources
+  };
+  const StartupTimings& getStartupTimings() const {
+    return startupTimings_;
+  }
+
   uint64_t getFrameNumber() const;
 
   using SubmitHandle = VulkanImmediateCommands::SubmitHandle;
 
   // execute a task some time in the future after the submit handle finished processing
+  // (thread-safe; an empty handle stands for the last submit before the task is processed)
   void deferredTask(std::packaged_task<void()>&& task, SubmitHandle handle = SubmitHandle()) const;
 
+  using DestructionType = VulkanDestructionQueue::Entry::Type;
+
+  // destroy a Vulkan object once the GPU is done with it (thread-safe, does not allocate memory)
+  void deferredDestroy(DestructionType type, uint64_t object, uint64_t memory = 0) const;
+
+  struct SecondaryCommandBuffer {
+    // every secondary command buffer has its own transient pool so that multiple threads can
+    // record into different secondary command buffers at the same time
+    std::shared_ptr<VulkanCommandPool> pool;
+    VkCommandBuffer cmdBuf = VK_NULL_HANDLE;
+  };
+
+  // secondary command buffers for parallel render command encoders (thread-safe)
+  SecondaryCommandBuffer acquireSecondaryCommandBuffer() const;
+  // recycle the buffer once the submit handle finished processing
+  void releaseSecondaryCommandBuffer(SecondaryCommandBuffer buffer, SubmitHandle handle) const;
+
   bool areValidationLayersEnabled() const;
 
+  // true if a buffer of `size` bytes should be placed in resizable BAR memory instead of using
+  // staging (thread-safe)
+  bool useResizableBar(VkDeviceSize size) const;
+
   void* getVmaAllocator() const;
 
+  // compacts VMA memory by moving textures and device-local buffers (see VulkanDefragmenter),
+  // running incremental passes until `timeBudget` is exceeded; a defragmentation which is not
+  // finished continues with the next call. Returns true if there is nothing left to move. Call it
+  // between frames, while no command buffers are being recorded
+  bool defragmentMemory(std::chrono::nanoseconds timeBudget) const;
+
  private:
   void createInstance(const size_t numExtraExtensions, const char** extraExtensions);
   void createSurface(void* window, void* display);
   void checkAndUpdateDescriptorSets() const;
+  // (re)creates the bindless descriptor set with the given capacity and both pipeline layouts
+  igl::Result growBindlessDescriptorSet(uint32_t maxTextures, uint32_t maxSamplers) const;
+  // writes the descriptors of the dirty indices into `descriptorBufferBindless_`
+  void writeBindlessDescriptorBuffer(const std::vector<VkDescriptorImageInfo>& infoSampledImages,
+                                     const std::vector<VkDescriptorImageInfo>& infoStorageImages,
+                                     const std::vector<VkDescriptorImageInfo>& infoSamplers) const;
+  // binds `descriptorBufferBindless_` as the bindless set #0 of `layout`
+  void bindBindlessDescriptorBuffer(VkCommandBuffer cmdBuf,
+                                    VkPipelineBindPoint bindPoint,
+                                    VkPipelineLayout layout) const;
+  void processPendingFreeIndices() const;
   void querySurfaceCapabilities();
   void allocateDynamicUniformsBuffer() const;
+  void pushDeferredEntry(const VulkanDestructionQueue::Entry& entry) const;
+  // moves everything released by other threads into `deferredTasks_`
+  void popDeferredEntries() const;
+  void destroyDeferredEntry(const VulkanDestructionQueue::Entry& entry) const;
   void processDeferredTasks() const;
   void waitDeferredTasks();
+  // submits an empty graphics command buffer which completes only after the async compute submit
+  // `handle`, so graphics submit handles keep covering all GPU work. Returns the graphics handle
+  SubmitHandle retireAsyncComputeSubmit(SubmitHandle handle) const;
+  bool writePipelineCacheFile() const;
+  // starts saving the pipeline cache on a worker thread if the save interval has elapsed and the
+  // previous save has finished
+  void savePipelineCachePeriodically() const;
 
  private:
   friend class igl::vulkan::Device;
@@ -200,6 +504,7 @@ class VulkanContext final {
   friend class igl::vulkan::CommandQueue;
   friend class igl::vulkan::ComputeCommandEncoder;
   friend class igl::vulkan::RenderCommandEncoder;
+  friend class igl::vulkan::VulkanDefragmenter;
 
   uint32_t dynamicUniformBufferSize_ = 65535;
   VkInstance vkInstance_ = VK_NULL_HANDLE;
@@ -208,11 +513,33 @@ class VulkanContext final {
   VkPhysicalDevice vkPhysicalDevice_ = VK_NULL_HANDLE;
   FOLLY_PUSH_WARNING
   FOLLY_GNU_DISABLE_WARNING("-Wmissing-field-initializers")
+  // Provided by VK_EXT_graphics_pipeline_library
+#if defined(VK_EXT_descriptor_buffer)
+  // Provided by VK_EXT_descriptor_buffer
+  VkPhysicalDeviceDescriptorBufferPropertiesEXT vkPhysicalDeviceDescriptorBufferProperties_ = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT,
+      // Ignore clang-diagnostic-missing-field-initializers
+      // @lint-ignore CLANGTIDY
+      nullptr};
+#endif // VK_EXT_descriptor_buffer
+
+  // Provided by VK_EXT_graphics_pipeline_library
+  VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT
+      vkPhysicalDeviceGraphicsPipelineLibraryProperties_ = {
+          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT,
+          // Ignore clang-diagnostic-missing-field-initializers
+          // @lint-ignore CLANGTIDY
+#if defined(VK_EXT_descriptor_buffer)
+          &vkPhysicalDeviceDescriptorBufferProperties_};
+#else
+          nullptr};
+#endif // VK_EXT_descriptor_buffer
+
   VkPhysicalDeviceDescriptorIndexingPropertiesEXT vkPhysicalDeviceDescriptorIndexingProperties_ = {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT,
       // Ignore clang-diagnostic-missing-field-initializers
       // @lint-ignore CLANGTIDY
-      nullptr};
+      &vkPhysicalDeviceGraphicsPipelineLibraryProperties_};
 
   // Provided by VK_KHR_driver_properties
   VkPhysicalDeviceDriverPropertiesKHR vkPhysicalDeviceDriverProperties_ = {
@@ -226,15 +553,101 @@ class VulkanContext final {
   VkSurfaceCapabilitiesKHR deviceSurfaceCaps_;
   std::vector<VkPresentModeKHR> devicePresentModes_;
 
+#if defined(VK_EXT_host_image_copy)
+  // Provided by VK_EXT_host_image_copy
+  VkPhysicalDeviceHostImageCopyFeaturesEXT vkPhysicalDeviceHostImageCopyFeatures_ = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT,
+      nullptr};
+#endif // VK_EXT_host_image_copy
+
+  // Provided by VK_EXT_extended_dynamic_state
+  VkPhysicalDeviceExtendedDynamicStateFeaturesEXT vkPhysicalDeviceExtendedDynamicStateFeatures_ = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT,
+#if defined(VK_EXT_host_image_copy)
+      &vkPhysicalDeviceHostImageCopyFeatures_};
+#else
+      nullptr};
+#endif // VK_EXT_host_image_copy
+
+#if defined(VK_EXT_descriptor_buffer)
+  // Provided by VK_EXT_descriptor_buffer
+  VkPhysicalDeviceDescriptorBufferFeaturesEXT vkPhysicalDeviceDescriptorBufferFeatures_ = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT,
+      &vkPhysicalDeviceExtendedDynamicStateFeatures_};
+#endif // VK_EXT_descriptor_buffer
+
+  // Provided by VK_KHR_synchronization2
+  VkPhysicalDeviceSynchronization2FeaturesKHR vkPhysicalDeviceSynchronization2Features_ = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR,
+#if defined(VK_EXT_descriptor_buffer)
+      &vkPhysicalDeviceDescriptorBufferFeatures_};
+#else
+      &vkPhysicalDeviceExtendedDynamicStateFeatures_};
+#endif // VK_EXT_descriptor_buffer
+
+  // Provided by VK_EXT_fragment_density_map
+  VkPhysicalDeviceFragmentDensityMapFeaturesEXT vkPhysicalDeviceFragmentDensityMapFeatures_ = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_DENSITY_MAP_FEATURES_EXT,
+      &vkPhysicalDeviceSynchronization2Features_};
+
+  // Provided by VK_EXT_graphics_pipeline_library
+  VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT
+      vkPhysicalDeviceGraphicsPipelineLibraryFeatures_ = {
+          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT,
+          &vkPhysicalDeviceFragmentDensityMapFeatures_};
+
+  // Provided by VK_KHR_present_wait
+  VkPhysicalDevicePresentWaitFeaturesKHR vkPhysicalDevicePresentWaitFeatures_ = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+      &vkPhysicalDeviceGraphicsPipelineLibraryFeatures_};
+
+  // Provided by VK_KHR_present_id
+  VkPhysicalDevicePresentIdFeaturesKHR vkPhysicalDevicePresentIdFeatures_ = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+      &vkPhysicalDevicePresentWaitFeatures_};
+
+#if defined(VK_KHR_fragment_shading_rate)
+  // Provided by VK_KHR_fragment_shading_rate
+  VkPhysicalDeviceFragmentShadingRateFeaturesKHR vkPhysicalDeviceFragmentShadingRateFeatures_ = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR,
+      &vkPhysicalDevicePresentIdFeatures_};
+#endif // VK_KHR_fragment_shading_rate
+
+  // Provided by VK_KHR_dynamic_rendering
+  VkPhysicalDeviceDynamicRenderingFeaturesKHR vkPhysicalDeviceDynamicRenderingFeatures_ = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR,
+#if defined(VK_KHR_fragment_shading_rate)
+      &vkPhysicalDeviceFragmentShadingRateFeatures_};
+#else
+      &vkPhysicalDevicePresentIdFeatures_};
+#endif // VK_KHR_fragment_shading_rate
+
+  // Provided by VK_KHR_timeline_semaphore
+  VkPhysicalDeviceTimelineSemaphoreFeaturesKHR vkPhysicalDeviceTimelineSemaphoreFeatures_ = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR,
+      &vkPhysicalDeviceDynamicRenderingFeatures_};
+
   // Provided by VK_VERSION_1_2
   VkPhysicalDeviceShaderFloat16Int8Features vkPhysicalDeviceShaderFloat16Int8Features_ = {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES_KHR,
-      nullptr};
+      &vkPhysicalDeviceTimelineSemaphoreFeatures_};
+
+#if defined(VK_EXT_external_memory_host)
+  // Provided by VK_EXT_external_memory_host
+  VkPhysicalDeviceExternalMemoryHostPropertiesEXT vkPhysicalDeviceExternalMemoryHostProperties_ = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT,
+      &vkPhysicalDeviceDriverProperties_,
+      0};
+#endif // VK_EXT_external_memory_host
 
   // Provided by VK_VERSION_1_1
   VkPhysicalDeviceProperties2 vkPhysicalDeviceProperties2_ = {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+#if defined(VK_EXT_external_memory_host)
+      &vkPhysicalDeviceExternalMemoryHostProperties_,
+#else
       &vkPhysicalDeviceDriverProperties_,
+#endif // VK_EXT_external_memory_host
       VkPhysicalDeviceProperties{}};
   VkPhysicalDeviceMultiviewFeatures vkPhysicalDeviceMultiviewFeatures_ = {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES,
@@ -250,32 +663,157 @@ class VulkanContext final {
   std::unique_ptr<igl::vulkan::VulkanDevice> device_;
   std::unique_ptr<igl::vulkan::VulkanSwapchain> swapchain_;
   std::unique_ptr<igl::vulkan::VulkanImmediateCommands> immediate_;
+  // shared by the VulkanImmediateCommands of the graphics queue with enableDeferredSubmits
+  std::shared_ptr<VulkanImmediateCommands::SubmitBatch> submitBatch_;
+  // submits to deviceQueues_.computeQueue (null unless the async compute queue is enabled)
+  std::unique_ptr<igl::vulkan::VulkanImmediateCommands> computeImmediate_;
+#if defined(IGL_WITH_TRACY_GPU)
+  // GPU zones of the graphics queue. The command buffer is only used to calibrate the timestamps.
+  TracyVkCtx tracyCtx_ = nullptr;
+  std::unique_ptr<igl::vulkan::VulkanCommandPool> profilingCommandPool_;
+  VkCommandBuffer profilingCommandBuffer_ = VK_NULL_HANDLE;
+#endif // IGL_WITH_TRACY_GPU
+  // queue families which access buffers and images concurrently (empty if all resources are
+  // exclusive to the graphics family)
+  std::vector<uint32_t> sharedQueueFamilyIndices_;
   std::unique_ptr<igl::vulkan::VulkanStagingDevice> stagingDevice_;
+  // null if buffer sub-allocation is disabled
+  std::unique_ptr<igl::vulkan::VulkanBufferPool> bufferPool_;
+  std::unique_ptr<igl::vulkan::VulkanSpirvCache> spirvCache_;
+  // null if VulkanContextConfig::enableComputeMipmapGeneration is false
+  std::unique_ptr<igl::vulkan::VulkanMipmapGenerator> mipmapGenerator_;
+  // created by the first defragmentMemory() call
+  mutable std::unique_ptr<igl::vulkan::VulkanDefragmenter> defragmenter_;
   std::unique_ptr<igl::vulkan::VulkanDescriptorSetLayout> dslDynamicUniformBuffer_;
-  std::unique_ptr<igl::vulkan::VulkanDescriptorSetLayout> dslBindless_;
+  // set #2 of graphics pipelines: the color attachments read by framebuffer fetch. Null with
+  // dynamic rendering
+  std::unique_ptr<igl::vulkan::VulkanDescriptorSetLayout> dslInputAttachments_;
+  // the bindless descriptor set layout, its pool and both pipeline layouts are recreated when
+  // the bindless arrays grow (see growBindlessDescriptorSet())
+  mutable std::unique_ptr<igl::vulkan::VulkanDescriptorSetLayout> dslBindless_;
   VkDescriptorPool dpDynamicUniformBuffer_ = VK_NULL_HANDLE;
-  VkDescriptorPool dpBindless_ = VK_NULL_HANDLE;
-  struct BindlessDescriptorSet {
-    VkDescriptorSet ds = VK_NULL_HANDLE;
-    SubmitHandle handle =
-        SubmitHandle(); // a handle of the last submit this descriptor set was a part of
-  };
-  mutable std::vector<BindlessDescriptorSet> bindlessDSets_;
-  mutable uint32_t currentDSetIndex_ = 0;
-  std::unique_ptr<igl::vulkan::VulkanPipelineLayout> pipelineLayoutGraphics_;
-  std::unique_ptr<igl::vulkan::VulkanPipelineLayout> pipelineLayoutCompute_;
+  mutable VkDescriptorPool dpBindless_ = VK_NULL_HANDLE;
+  mutable VkDescriptorSet dsBindless_ = VK_NULL_HANDLE;
+  // replaces `dpBindless_` and `dsBindless_` if `useDescriptorBuffer_` is set
+  mutable std::shared_ptr<VulkanBuffer> descriptorBufferBindless_;
+  // the offsets of the bindings of `dslBindless_` inside `descriptorBufferBindless_`
+  mutable std::array<VkDeviceSize, 7> descriptorBufferBindingOffsets_ = {};
+  // guards the pipeline layouts and `bindlessGeneration_` against getVkPipelineLayout()
+  mutable std::mutex pipelineLayoutMutex_;
+  mutable std::unique_ptr<igl::vulkan::VulkanPipelineLayout> pipelineLayoutGraphics_;
+  mutable std::unique_ptr<igl::vulkan::VulkanPipelineLayout> pipelineLayoutCompute_;
+  // the number of elements in the bindless texture and sampler arrays
+  mutable uint32_t bindlessMaxTextures_ = 0;
+  mutable uint32_t bindlessMaxSamplers_ = 0;
+  // incremented every time the pipeline layouts are recreated; pipelines built with an older
+  // layout are not compatible with the current bindless descriptor set and have to be rebuilt
+  mutable std::atomic<uint32_t> bindlessGeneration_ = 0;
   // don't use staging on devices with shared host-visible memory
   bool useStaging_ = true;
+  // size of the host-visible device-local heap exposed through resizable BAR, 0 if there is none
+  VkDeviceSize resizableBarHeapSize_ = 0;
+  // ResourceStorage::Memoryless attachments use lazily allocated memory
+  bool hasLazilyAllocatedMemory_ = false;
+  // heap usage and budgets are reported by the driver (VK_EXT_memory_budget)
+  bool useMemoryBudget_ = false;
+  // memory allocated for VulkanImage and VulkanBuffer objects
+  mutable std::atomic<uint64_t> imageMemoryBytes_ = 0;
+  mutable std::atomic<uint64_t> bufferMemoryBytes_ = 0;
+  // part of bufferMemoryBytes_ allocated in resizable BAR memory
+  mutable std::atomic<uint64_t> resizableBarBufferMemoryBytes_ = 0;
+  // buffers with host writes to non-coherent memory which have not been flushed yet
+  mutable std::vector<VulkanBuffer*> dirtyBuffers_;
+  mutable std::mutex dirtyBuffersMutex_;
+  // submits are tracked with timeline semaphores (VK_KHR_timeline_semaphore)
+  bool useTimelineSemaphore_ = false;
+  // render passes are replaced with vkCmdBeginRendering() (VK_KHR_dynamic_rendering)
+  bool useDynamicRendering_ = false;
+  PFN_vkCmdBeginRenderingKHR vkCmdBeginRendering_ = nullptr;
+  PFN_vkCmdEndRenderingKHR vkCmdEndRendering_ = nullptr;
+  // presents are identified and can be waited for (VK_KHR_present_id and VK_KHR_present_wait)
+  bool usePresentWait_ = false;
+  // swapchains acquire and present on a dedicated thread, see
+  // VulkanContextConfig::enablePresentThread
+  bool usePresentThread_ = false;
+  PFN_vkWaitForPresentKHR vkWaitForPresent_ = nullptr;
+  // images can be created with VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT and their memory is bound by
+  // vkQueueBindSparse() on the graphics queue
+  bool useSparseResidency_ = false;
+  // query pools can be created with VK_QUERY_TYPE_PIPELINE_STATISTICS
+  bool usePipelineStatistics_ = false;
+  // pipeline builders report to config_.pipelineCreationFeedback
+  // (VK_EXT_pipeline_creation_feedback)
+  bool usePipelineCreationFeedback_ = false;
+  // render pipelines are fast-linked from pipeline libraries (VK_EXT_graphics_pipeline_library)
+  bool useGraphicsPipelineLibrary_ = false;
+  // render passes can read a fragment density map attachment (VK_EXT_fragment_density_map)
+  bool useFragmentDensityMap_ = false;
+  // the fragment shading rate of draws is dynamic state (VK_KHR_fragment_shading_rate)
+  bool useFragmentShadingRate_ = false;
+#if defined(VK_KHR_fragment_shading_rate)
+  PFN_vkCmdSetFragmentShadingRateKHR vkCmdSetFragmentShadingRate_ = nullptr;
+#endif // VK_KHR_fragment_shading_rate
+  // topology, depth write, depth compare and stencil operations are set in command buffers instead
+  // of being baked into pipeline variants (VK_EXT_extended_dynamic_state)
+  bool useExtendedDynamicState_ = false;
+  PFN_vkCmdSetPrimitiveTopologyEXT vkCmdSetPrimitiveTopology_ = nullptr;
+  PFN_vkCmdSetDepthWriteEnableEXT vkCmdSetDepthWriteEnable_ = nullptr;
+  PFN_vkCmdSetDepthCompareOpEXT vkCmdSetDepthCompareOp_ = nullptr;
+  PFN_vkCmdSetStencilOpEXT vkCmdSetStencilOp_ = nullptr;
+  // the Bindings uniform buffer is pushed into command buffers (VK_KHR_push_descriptor) instead of
+  // being bound as a descriptor set with a dynamic offset
+  bool usePushDescriptors_ = false;
+  PFN_vkCmdPushDescriptorSetKHR vkCmdPushDescriptorSet_ = nullptr;
+  // Android hardware buffers can be imported as images without copying them
+  // (VK_ANDROID_external_memory_android_hardware_buffer)
+  bool useHardwareBufferImport_ = false;
+  // images can be written and transitioned by the host (VK_EXT_host_image_copy); they are written
+  // in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+  bool useHostImageCopy_ = false;
+#if defined(VK_EXT_host_image_copy)
+  PFN_vkCopyMemoryToImageEXT vkCopyMemoryToImage_ = nullptr;
+  PFN_vkTransitionImageLayoutEXT vkTransitionImageLayout_ = nullptr;
+#endif // VK_EXT_host_image_copy
+  // client memory can be imported as buffers (VK_EXT_external_memory_host)
+  bool useExternalMemoryHost_ = false;
+#if defined(VK_EXT_external_memory_host)
+  PFN_vkGetMemoryHostPointerPropertiesEXT vkGetMemoryHostPointerProperties_ = nullptr;
+#endif // VK_EXT_external_memory_host
+  // barriers are recorded with vkCmdPipelineBarrier2() (VK_KHR_synchronization2)
+  bool useSynchronization2_ = false;
+  PFN_vkCmdPipelineBarrier2KHR vkCmdPipelineBarrier2_ = nullptr;
+  // the bindless descriptors live in `descriptorBufferBindless_` (VK_EXT_descriptor_buffer)
+  // instead of `dsBindless_`
+  bool useDescriptorBuffer_ = false;
+#if defined(VK_EXT_descriptor_buffer)
+  PFN_vkGetDescriptorSetLayoutSizeEXT vkGetDescriptorSetLayoutSize_ = nullptr;
+  PFN_vkGetDescriptorSetLayoutBindingOffsetEXT vkGetDescriptorSetLayoutBindingOffset_ = nullptr;
+  PFN_vkGetDescriptorEXT vkGetDescriptor_ = nullptr;
+  PFN_vkCmdBindDescriptorBuffersEXT vkCmdBindDescriptorBuffers_ = nullptr;
+  PFN_vkCmdSetDescriptorBufferOffsetsEXT vkCmdSetDescriptorBufferOffsets_ = nullptr;
+#endif // VK_EXT_descriptor_buffer
+  // draw counts can be read from GPU buffers (VK_KHR_draw_indirect_count), null if unsupported
+  PFN_vkCmdDrawIndexedIndirectCountKHR vkCmdDrawIndexedIndirectCount_ = nullptr;
 
   std::unique_ptr<VulkanContextImpl> pimpl_;
 
+  StartupTimings startupTimings_;
+  mutable std::once_flag glslangOnce_;
+  mutable std::atomic<bool> isGlslangInitialized_ = false;
+
   VkPipelineCache pipelineCache_ = VK_NULL_HANDLE;
+  mutable size_t pipelineCacheSavedSize_ = 0;
+  mutable std::chrono::steady_clock::time_point pipelineCacheSaveTime_;
+  mutable std::future<bool> pipelineCacheSaved_;
 
   // 1. Textures can be safely deleted once they are not in use by GPU, hence our Vulkan context
   // owns all allocated textures (images+image views). The IGL interface vulkan::Texture does not
   // delete the underylying VulkanTexture but instead informs the context that it should be
   // deallocated. The context deallocates textures in a deferred way when it is safe to do so.
   // 2. Descriptor sets can be updated when they are not in use.
+  // 3. Textures and samplers can be created from any thread: `bindlessMutex_` guards the sparse
+  // arrays, their free indices and the dirty indices below.
+  mutable std::mutex bindlessMutex_;
   mutable std::vector<std::shared_ptr<VulkanTexture>> textures_ = {nullptr}; // the guard element
                                                                              // [0] is always there
   mutable std::vector<std::shared_ptr<VulkanSampler>> samplers_ = {nullptr}; // the guard element
@@ -284,13 +822,35 @@ class VulkanContext final {
   mutable std::vector<uint32_t> freeIndicesTextures_;
   // contains a list of free indices inside the sparse array `samplers_`
   mutable std::vector<uint32_t> freeIndicesSamplers_;
+  // released indices are not reused before the GPU is done with them because descriptors which
+  // might be accessed by pending command buffers cannot be updated
+  struct PendingFreeIndex {
+    uint32_t index = 0;
+    SubmitHandle handle;
+  };
+  mutable std::deque<PendingFreeIndex> pendingFreeIndicesTextures_;
+  mutable std::deque<PendingFreeIndex> pendingFreeIndicesSamplers_;
+  // indices inside `textures_` and `samplers_` which have to be written into `dsBindless_`
+  mutable std::vector<uint32_t> dirtyIndicesTextures_;
+  mutable std::vector<uint32_t> dirtyIndicesSamplers_;
+  // replaced bindless objects are kept alive because command buffers which are still being
+  // recorded might reference them
+  mutable std::vector<std::unique_ptr<VulkanDescriptorSetLayout>> retiredDSLs_;
+  mutable std::vector<std::unique_ptr<VulkanPipelineLayout>> retiredPipelineLayouts_;
+  mutable std::vector<VkDescriptorPool> retiredDPs_;
+  mutable std::vector<std::shared_ptr<VulkanBuffer>> retiredDescriptorBuffers_;
   // a texture/sampler was created since the last descriptor set update
-  mutable bool awaitingCreation_ = false;
-  // a texture/sampler was deleted since the last descriptor set update
-  mutable bool awaitingDeletion_ = false;
+  mutable std::atomic<bool> awaitingCreation_ = false;
+  // a texture/sampler was deleted since the last descriptor set update (set by destructors running
+  // on any thread)
+  mutable std::atomic<bool> awaitingDeletion_ = false;
   mutable uint64_t lastDeletionFrame_ = 0;
 
-  mutable size_t drawCallCount_ = 0;
+  // parallel render command encoders can issue draw calls from multiple threads
+  mutable std::atomic<size_t> drawCallCount_{0};
+
+  mutable std::mutex secondaryCommandBuffersMutex_;
+  mutable std::vector<SecondaryCommandBuffer> freeSecondaryCommandBuffers_;
 
   // stores an index into renderPasses_
   mutable std::
@@ -301,12 +861,15 @@ class VulkanContext final {
   VulkanExtensions extensions_;
   VulkanContextConfig config_;
 
+#if IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
   // Enhanced shader debug: line drawing
   std::unique_ptr<EnhancedShaderDebuggingStore> enhancedShaderDebuggingStore_;
+#endif // IGL_VULKAN_ENHANCED_SHADER_DEBUGGING
 
   struct DynamicUniformBuffer {
     SubmitHandle handle_;
     uint32_t offset_ = 0;
+    // VK_NULL_HANDLE if push descriptors are used
     VkDescriptorSet ds_ = VK_NULL_HANDLE;
     std::shared_ptr<VulkanBuffer> buffer_;
     void reset() {
@@ -315,12 +878,19 @@ class VulkanContext final {
     }
   };
 
-  /// @brief Manages a circular buffer of Dynamic Uniforms Buffers (DUBs)
+  /// @brief Manages a circular buffer of Dynamic Uniforms Buffers (DUBs). Every DUB is a linear
+  /// arena: each update() uploads only the used prefix of Bindings and binds it with a dynamic
+  /// offset.
   class DynamicUniformsBufferSet {
    public:
     explicit DynamicUniformsBufferSet(VulkanContext& ctx);
 
-    void update(VkCommandBuffer cmdBuf, VkPipelineBindPoint bindPoint, const Bindings* data);
+    /// @param size the number of bytes of `data` to upload, starting from the first slot. The rest
+    /// of the Bindings block seen by the shaders is zeroed
+    void update(VkCommandBuffer cmdBuf,
+                VkPipelineBindPoint bindPoint,
+                const Bindings* data,
+                size_t size);
     void markSubmit(const SubmitHandle& handle);
 
    private:
@@ -331,21 +901,22 @@ class VulkanContext final {
     DynamicUniformBuffer* currentDUB_ = nullptr;
 
     VulkanContext& ctx_;
-    VkDeviceSize bufferSizeAligned_ = 0;
+    VkDeviceSize minAlignment_ = 0;
     size_t currentDUBIndex_ = 0;
     size_t lastSubmittedDUBIndex_ = 0;
+    // update() can be called concurrently by parallel render command encoders
+    std::mutex mutex_;
   };
 
   mutable std::unique_ptr<DynamicUniformsBufferSet> DUBs_;
 
-  struct DeferredTask {
-    DeferredTask(std::packaged_task<void()>&& task, SubmitHandle handle) :
-      task_(std::move(task)), handle_(handle) {}
-    std::packaged_task<void()> task_;
-    SubmitHandle handle_;
-  };
-
-  mutable std::deque<DeferredTask> deferredTasks_;
+  // filled by any thread and drained by the thread which submits command buffers
+  mutable VulkanDestructionQueue deferredQueue_{4096};
+  // entries which did not fit into `deferredQueue_`
+  mutable std::mutex deferredOverflowMutex_;
+  mutable std::vector<VulkanDestructionQueue::Entry> deferredOverflow_;
+  // entries waiting for their submit handles, accessed only by the submitting thread
+  mutable std::deque<VulkanDestructionQueue::Entry> deferredTasks_;
 
   std::unique_ptr<SyncManager> syncManager_;
 };
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/VulkanDefragmenter.h>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+#include <igl/vulkan/VulkanBuffer.h>
+#include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanImage.h>
+#include <igl/vulkan/VulkanImageView.h>
+#include <igl/vulkan/VulkanTexture.h>
+
+namespace {
+
+bool isMovable(const igl::vulkan::VulkanImage& image) {
+  const VkImageUsageFlags kCopyUsage =
+      VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+  // framebuffers keep the views of their attachments
+  const VkImageUsageFlags kAttachmentUsage =
+      VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+      VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+
+  return image.vmaAllocation_ != VK_NULL_HANDLE && !image.isExternallyManaged_ &&
+         !image.isSparse_ && !image.isImported_ && !image.isExported_ && !image.mappedPtr_ &&
+         !image.hasTextureViews_ &&
+         image.samples_ == VK_SAMPLE_COUNT_1_BIT &&
+         (image.usageFlags_ & kCopyUsage) == kCopyUsage &&
+         !(image.usageFlags_ & kAttachmentUsage);
+}
+
+} // namespace
+
+namespace igl {
+namespace vulkan {
+
+VulkanDefragmenter::VulkanDefragmenter(const VulkanContext& ctx) : ctx_(ctx) {}
+
+VulkanDefragmenter::~VulkanDefragmenter() {
+  finish();
+}
+
+bool VulkanDefragmenter::defragment(std::chrono::nanoseconds timeBudget) {
+  IGL_PROFILER_FUNCTION();
+
+  const auto start = std::chrono::steady_clock::now();
+
+  if (vmaDefragmentationContext_ == VK_NULL_HANDLE) {
+    VmaDefragmentationInfo info = {};
+    info.maxBytesPerPass = kMaxBytesPerPass;
+    info.maxAllocationsPerPass = kMaxAllocationsPerPass;
+
+    const VkResult result = vmaBeginDefragmentation(
+        (VmaAllocator)ctx_.getVmaAllocator(), &info, &vmaDefragmentationContext_);
+    if (!IGL_VERIFY(result == VK_SUCCESS)) {
+      vmaDefragmentationContext_ = VK_NULL_HANDLE;
+      return true;
+    }
+  }
+
+  do {
+    if (runPass()) {
+      finish();
+      return true;
+    }
+  } while (std::chrono::steady_clock::now() - start < timeBudget);
+
+  return false;
+}
+
+bool VulkanDefragmenter::runPass() {
+  IGL_PROFILER_FUNCTION();
+
+  const VmaAllocator vma = (VmaAllocator)ctx_.getVmaAllocator();
+
+  VmaDefragmentationPassMoveInfo pass = {};
+  if (vmaBeginDefragmentationPass(vma, vmaDefragmentationContext_, &pass) != VK_INCOMPLETE) {
+    return true;
+  }
+
+  // textures are the only owners of movable images
+  std::unordered_map<VmaAllocation, VulkanTexture*> textures;
+  {
+    const std::lock_guard<std::mutex> lock(ctx_.bindlessMutex_);
+    for (const auto& texture : ctx_.textures_) {
+      if (texture && isMovable(*texture->image_)) {
+        textures[texture->image_->vmaAllocation_] = texture.get();
+      }
+    }
+  }
+
+  // work on the async compute queue is not ordered with the copies below
+  if (ctx_.computeImmediate_) {
+    ctx_.computeImmediate_->waitAll();
+  }
+
+  const auto& wrapper = ctx_.immediate_->acquire();
+
+  // the copies read resources written by previously submitted command buffers
+  const VkMemoryBarrier barrierBefore = {VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                                         nullptr,
+                                         VK_ACCESS_MEMORY_WRITE_BIT,
+                                         VK_ACCESS_TRANSFER_READ_BIT};
+  vkCmdPipelineBarrier(wrapper.cmdBuf_,
+                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       0,
+                       1,
+                       &barrierBefore,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr);
+
+  for (uint32_t i = 0; i != pass.moveCount; i++) {
+    VmaDefragmentationMove& move = pass.pMoves[i];
+
+    VmaAllocationInfo info = {};
+    vmaGetAllocationInfo(vma, move.srcAllocation, &info);
+
+    const auto it = textures.find(move.srcAllocation);
+
+    bool isMoved = false;
+    if (it != textures.end()) {
+      isMoved = moveImage(wrapper.cmdBuf_, *it->second, move.dstTmpAllocation);
+    } else if (info.pUserData) {
+      // see VulkanBuffer::VulkanBuffer()
+      isMoved = moveBuffer(
+          wrapper.cmdBuf_, *static_cast<VulkanBuffer*>(info.pUserData), move.dstTmpAllocation);
+    }
+    if (!isMoved) {
+      move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+    }
+  }
+
+  const VkMemoryBarrier barrierAfter = {VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                                        nullptr,
+                                        VK_ACCESS_TRANSFER_WRITE_BIT,
+                                        VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT};
+  vkCmdPipelineBarrier(wrapper.cmdBuf_,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                       0,
+                       1,
+                       &barrierAfter,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr);
+
+  // the old memory is released by vmaEndDefragmentationPass(), so the copies and all previous
+  // submits which could access it have to be finished
+  ctx_.immediate_->wait(ctx_.immediate_->submit(wrapper));
+
+  for (const MovedImage& moved : movedImages_) {
+    VulkanTexture& texture = *moved.texture;
+    VulkanImage& image = *texture.image_;
+
+    texture.imageView_->recreate(image.vkImage_);
+    {
+      const std::lock_guard<std::mutex> lock(texture.imageViewsMutex_);
+      for (auto& view : texture.imageViews_) {
+        view.second->recreate(image.vkImage_);
+      }
+    }
+    for (auto& view : image.storageMipViews_) {
+      view->recreate(image.vkImage_);
+    }
+    ctx_.deferredDestroy(VulkanContext::DestructionType::Image, (uint64_t)moved.oldImage);
+
+    // the bindless index stays the same, only the descriptor has to be updated
+    const std::lock_guard<std::mutex> lock(ctx_.bindlessMutex_);
+    ctx_.dirtyIndicesTextures_.push_back(texture.textureId_);
+    ctx_.awaitingCreation_ = true;
+  }
+  for (VkBuffer oldBuffer : oldBuffers_) {
+    ctx_.deferredDestroy(VulkanContext::DestructionType::Buffer, (uint64_t)oldBuffer);
+  }
+  movedImages_.clear();
+  oldBuffers_.clear();
+
+  return vmaEndDefragmentationPass(vma, vmaDefragmentationContext_, &pass) == VK_SUCCESS;
+}
+
+bool VulkanDefragmenter::moveImage(VkCommandBuffer cmdBuf,
+                                   VulkanTexture& texture,
+                                   VmaAllocation dstAllocation) {
+  VulkanImage& image = *texture.image_;
+
+  VkImage newImage = VK_NULL_HANDLE;
+  if (vkCreateImage(image.device_, &image.vkImageCreateInfo_, nullptr, &newImage) != VK_SUCCESS) {
+    return false;
+  }
+  if (vmaBindImageMemory((VmaAllocator)ctx_.getVmaAllocator(), dstAllocation, newImage) !=
+      VK_SUCCESS) {
+    vkDestroyImage(image.device_, newImage, nullptr);
+    return false;
+  }
+
+  const VkImageSubresourceRange range = {
+      image.getImageAspectFlags(), 0, image.mipLevels_, 0, image.arrayLayers_};
+
+  // the layouts of the moved image are the same as before
+  const VkImageLayout layout = image.imageLayout_;
+  const std::vector<VkImageLayout> subresourceLayouts = image.subresourceLayouts_;
+
+  image.transitionLayout(cmdBuf,
+                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         range);
+
+  const VkImage oldImage = image.vkImage_;
+
+  image.vkImage_ = newImage;
+  image.imageLayout_ = VK_IMAGE_LAYOUT_UNDEFINED;
+  image.subresourceLayouts_.clear();
+  image.transitionLayout(cmdBuf,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         range);
+
+  std::vector<VkImageCopy> regions(image.mipLevels_);
+  for (uint32_t level = 0; level != image.mipLevels_; level++) {
+    const VkImageSubresourceLayers layers = {range.aspectMask, level, 0, image.arrayLayers_};
+    regions[level] = {layers,
+                      {0, 0, 0},
+                      layers,
+                      {0, 0, 0},
+                      {std::max(1u, image.extent_.width >> level),
+                       std::max(1u, image.extent_.height >> level),
+                       std::max(1u, image.extent_.depth >> level)}};
+  }
+  vkCmdCopyImage(cmdBuf,
+                 oldImage,
+                 VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                 newImage,
+                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                 (uint32_t)regions.size(),
+                 regions.data());
+
+  if (subresourceLayouts.empty()) {
+    if (layout != VK_IMAGE_LAYOUT_UNDEFINED) {
+      image.transitionLayout(cmdBuf,
+                             layout,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                             range);
+    }
+  } else {
+    for (uint32_t layer = 0; layer != image.arrayLayers_; layer++) {
+      for (uint32_t level = 0; level != image.mipLevels_; level++) {
+        const VkImageLayout subresourceLayout =
+            subresourceLayouts[layer * image.mipLevels_ + level];
+        if (subresourceLayout != VK_IMAGE_LAYOUT_UNDEFINED) {
+          image.transitionLayout(cmdBuf,
+                                 subresourceLayout,
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                 VkImageSubresourceRange{range.aspectMask, level, 1, layer, 1});
+        }
+      }
+    }
+  }
+
+  movedImages_.push_back({&texture, oldImage});
+
+  return true;
+}
+
+bool VulkanDefragmenter::moveBuffer(VkCommandBuffer cmdBuf,
+                                    VulkanBuffer& buffer,
+                                    VmaAllocation dstAllocation) {
+  VkBuffer newBuffer = VK_NULL_HANDLE;
+  if (vkCreateBuffer(buffer.device_, &buffer.vkBufferCreateInfo_, nullptr, &newBuffer) !=
+      VK_SUCCESS) {
+    return false;
+  }
+  if (vmaBindBufferMemory((VmaAllocator)ctx_.getVmaAllocator(), dstAllocation, newBuffer) !=
+      VK_SUCCESS) {
+    vkDestroyBuffer(buffer.device_, newBuffer, nullptr);
+    return false;
+  }
+
+  const VkBufferCopy copy = {0, 0, buffer.bufferSize_};
+  vkCmdCopyBuffer(cmdBuf, buffer.vkBuffer_, newBuffer, 1, &copy);
+
+  oldBuffers_.push_back(buffer.vkBuffer_);
+
+  buffer.vkBuffer_ = newBuffer;
+
+  return true;
+}
+
+void VulkanDefragmenter::finish() {
+  if (vmaDefragmentationContext_ == VK_NULL_HANDLE) {
+    return;
+  }
+
+  VmaDefragmentationStats stats = {};
+  vmaEndDefragmentation((VmaAllocator)ctx_.getVmaAllocator(), vmaDefragmentationContext_, &stats);
+  vmaDefragmentationContext_ = VK_NULL_HANDLE;
+
+  IGL_LOG_INFO("Defragmentation: moved %u allocations (%llu bytes), freed %u memory blocks\n",
+               stats.allocationsMoved,
+               (unsigned long long)stats.bytesMoved,
+               stats.deviceMemoryBlocksFreed);
+}
+
+} // namespace vulkan
+} // namespace igl
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanHelpers.h>
+
+namespace igl {
+namespace vulkan {
+
+class VulkanBuffer;
+class VulkanContext;
+class VulkanTexture;
+
+/**
+ * @brief Compacts VMA memory by moving allocations out of sparsely used memory blocks, so that
+ * the emptied blocks can be freed. Defragmentation is incremental: every pass moves a bounded
+ * number of allocations, and a defragmentation started by one defragment() call is continued by
+ * the next one.
+ *
+ * Only textures registered in the context and device-local buffers which are not accessed through
+ * their device address are moved. Attachments, mapped, sparse, imported and exported resources
+ * stay in place. Moved resources keep their VulkanImage/VulkanBuffer objects and their bindless
+ * indices; their VkImage, VkBuffer and VkImageView handles are replaced.
+ */
+class VulkanDefragmenter final {
+ public:
+  explicit VulkanDefragmenter(const VulkanContext& ctx);
+  ~VulkanDefragmenter();
+
+  VulkanDefragmenter(const VulkanDefragmenter&) = delete;
+  VulkanDefragmenter& operator=(const VulkanDefragmenter&) = delete;
+
+  /// Runs defragmentation passes until `timeBudget` is exceeded (at least one pass is run). Waits
+  /// for the GPU to finish every pass. Returns true if there is nothing left to move
+  bool defragment(std::chrono::nanoseconds timeBudget);
+
+ private:
+  /// Returns true if defragmentation is finished
+  bool runPass();
+  bool moveImage(VkCommandBuffer cmdBuf, VulkanTexture& texture, VmaAllocation dstAllocation);
+  bool moveBuffer(VkCommandBuffer cmdBuf, VulkanBuffer& buffer, VmaAllocation dstAllocation);
+  void finish();
+
+ private:
+  // keep every pass short enough to fit into an idle frame
+  static constexpr VkDeviceSize kMaxBytesPerPass = 32ull * 1024 * 1024;
+  static constexpr uint32_t kMaxAllocationsPerPass = 64;
+
+  const VulkanContext& ctx_;
+  VmaDefragmentationContext vmaDefragmentationContext_ = VK_NULL_HANDLE;
+
+  // resources copied by the current pass, their old handles are destroyed after the copy
+  struct MovedImage {
+    VulkanTexture* texture = nullptr;
+    VkImage oldImage = VK_NULL_HANDLE;
+  };
+  std::vector<MovedImage> movedImages_;
+  std::vector<VkBuffer> oldBuffers_;
+};
+
+} // namespace vulkan
+} // namespace igl
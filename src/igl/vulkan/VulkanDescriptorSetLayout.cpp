@@ -18,12 +18,30 @@ VulkanDescriptorSetLayout::VulkanDescriptorSetLayout(VkDevice device,
                                                      uint32_t numBindings,
                                                      const VkDescriptorSetLayoutBinding* bindings,
                                                      const VkDescriptorBindingFlags* bindingFlags,
-                                                     const char* debugName) :
+                                                     const char* debugName,
+                                                     bool isPushDescriptorSet,
+                                                     bool isDescriptorBuffer) :
   device_(device) {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
 
-  VK_ASSERT(ivkCreateDescriptorSetLayout(
-      device, numBindings, bindings, bindingFlags, &vkDescriptorSetLayout_));
+  if (isDescriptorBuffer) {
+#if defined(VK_EXT_descriptor_buffer)
+    VK_ASSERT(ivkCreateDescriptorBufferSetLayout(device,
+                                                 numBindings,
+                                                 bindings,
+                                                 isPushDescriptorSet ? nullptr : bindingFlags,
+                                                 isPushDescriptorSet ? VK_TRUE : VK_FALSE,
+                                                 &vkDescriptorSetLayout_));
+#else
+    IGL_ASSERT_NOT_REACHED();
+#endif // VK_EXT_descriptor_buffer
+  } else if (isPushDescriptorSet) {
+    VK_ASSERT(ivkCreatePushDescriptorSetLayout(
+        device, numBindings, bindings, &vkDescriptorSetLayout_));
+  } else {
+    VK_ASSERT(ivkCreateDescriptorSetLayout(
+        device, numBindings, bindings, bindingFlags, &vkDescriptorSetLayout_));
+  }
   VK_ASSERT(ivkSetDebugObjectName(
       device_, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, (uint64_t)vkDescriptorSetLayout_, debugName));
 }
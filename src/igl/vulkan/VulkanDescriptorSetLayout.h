@@ -21,7 +21,9 @@ class VulkanDescriptorSetLayout final {
                             uint32_t numBindings,
                             const VkDescriptorSetLayoutBinding* bindings,
                             const VkDescriptorBindingFlags* bindingFlags,
-                            const char* debugName = nullptr);
+                            const char* debugName = nullptr,
+                            bool isPushDescriptorSet = false,
+                            bool isDescriptorBuffer = false);
   ~VulkanDescriptorSetLayout();
 
   VulkanDescriptorSetLayout(const VulkanDescriptorSetLayout&) = delete;
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/VulkanDestructionQueue.h>
+
+namespace igl {
+namespace vulkan {
+
+VulkanDestructionQueue::VulkanDestructionQueue(size_t capacity) {
+  size_t size = 2;
+  while (size < capacity) {
+    size *= 2;
+  }
+
+  cells_ = std::make_unique<Cell[]>(size);
+  mask_ = size - 1;
+
+  for (size_t i = 0; i != size; i++) {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+VulkanDestructionQueue::~VulkanDestructionQueue() {
+  // the owner is supposed to drain the ring; do not leak tasks if it did not
+  Entry entry;
+  while (pop(entry)) {
+    delete entry.task;
+  }
+}
+
+bool VulkanDestructionQueue::push(const Entry& entry) {
+  size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+
+  for (;;) {
+    Cell& cell = cells_[pos & mask_];
+    const size_t seq = cell.sequence.load(std::memory_order_acquire);
+    const intptr_t diff = intptr_t(seq) - intptr_t(pos);
+    if (diff == 0) {
+      // the cell is free, try to claim it
+      if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        cell.entry = entry;
+        cell.sequence.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      // the consumer has not released this cell yet
+      return false;
+    } else {
+      pos = enqueuePos_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool VulkanDestructionQueue::pop(Entry& outEntry) {
+  const size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+  Cell& cell = cells_[pos & mask_];
+
+  if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+    // empty, or the producer which claimed this cell has not finished writing it
+    return false;
+  }
+
+  dequeuePos_.store(pos + 1, std::memory_order_relaxed);
+  outEntry = cell.entry;
+  cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+
+  return true;
+}
+
+} // namespace vulkan
+} // namespace igl
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <future>
+#include <memory>
+
+#include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
+
+namespace igl {
+namespace vulkan {
+
+/**
+ * @brief Bounded lock-free multi-producer single-consumer ring of Vulkan objects waiting to be
+ * destroyed. Any thread can push() entries; only one thread at a time can pop() them. Based on the
+ * bounded MPMC queue by Dmitry Vyukov.
+ */
+class VulkanDestructionQueue final {
+ public:
+  struct Entry {
+    enum class Type : uint8_t {
+      Task, // a generic std::packaged_task<void()>
+      Pipeline,
+      ImageView,
+      Sampler,
+      Framebuffer,
+      QueryPool,
+      Buffer, // `object` is a VkBuffer, `memory` is a VkDeviceMemory
+      Image, // `object` is a VkImage, `memory` is a VkDeviceMemory (can be null)
+      VmaBuffer, // `object` is a VkBuffer, `memory` is a VmaAllocation
+      VmaImage, // `object` is a VkImage, `memory` is a VmaAllocation
+      Memory, // `object` is a VkDeviceMemory
+    };
+
+    Type type = Type::Task;
+    // non-dispatchable Vulkan handles are 64-bit on all platforms
+    uint64_t object = 0;
+    uint64_t memory = 0;
+    // owned by the entry, only for Type::Task
+    std::packaged_task<void()>* task = nullptr;
+    // an empty handle is replaced with the last submit handle when the entry is popped
+    VulkanImmediateCommands::SubmitHandle handle;
+  };
+
+  /// `capacity` is rounded up to a power of two
+  explicit VulkanDestructionQueue(size_t capacity);
+  ~VulkanDestructionQueue();
+
+  VulkanDestructionQueue(const VulkanDestructionQueue&) = delete;
+  VulkanDestructionQueue& operator=(const VulkanDestructionQueue&) = delete;
+
+  /// Thread-safe. Returns false if the ring is full
+  bool push(const Entry& entry);
+  /// Can be called by one thread at a time. Returns false if the ring is empty
+  bool pop(Entry& outEntry);
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence = 0;
+    Entry entry;
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_ = 0;
+  // keep producers and the consumer on different cache lines
+  alignas(64) std::atomic<size_t> enqueuePos_ = 0;
+  alignas(64) std::atomic<size_t> dequeuePos_ = 0;
+};
+
+} // namespace vulkan
+} // namespace igl
@@ -95,22 +95,34 @@ bool VulkanExtensions::enable(const char* extensionName, ExtensionType extension
 #endif
 }
 
-void VulkanExtensions::enableCommonExtensions(ExtensionType extensionType, bool validationEnabled) {
+void VulkanExtensions::enableCommonExtensions(ExtensionType extensionType,
+                                              bool validationEnabled,
+                                              bool headless) {
   if (extensionType == ExtensionType::Instance) {
-    enable(VK_KHR_SURFACE_EXTENSION_NAME, ExtensionType::Instance);
+    if (!headless) {
+      enable(VK_KHR_SURFACE_EXTENSION_NAME, ExtensionType::Instance);
+    }
     enable(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME, ExtensionType::Instance);
 #if IGL_PLATFORM_WIN
-    enable(VK_KHR_WIN32_SURFACE_EXTENSION_NAME, ExtensionType::Instance);
+    if (!headless) {
+      enable(VK_KHR_WIN32_SURFACE_EXTENSION_NAME, ExtensionType::Instance);
+    }
     enable(VK_EXT_DEBUG_UTILS_EXTENSION_NAME, ExtensionType::Instance);
 #elif IGL_PLATFORM_ANDROID
-    enable("VK_KHR_android_surface", ExtensionType::Instance);
+    if (!headless) {
+      enable("VK_KHR_android_surface", ExtensionType::Instance);
+    }
     enable(VK_EXT_DEBUG_REPORT_EXTENSION_NAME, ExtensionType::Instance);
 #elif IGL_PLATFORM_LINUX
     enable(VK_EXT_DEBUG_UTILS_EXTENSION_NAME, ExtensionType::Instance);
-    enable("VK_KHR_xlib_surface", ExtensionType::Instance);
+    if (!headless) {
+      enable("VK_KHR_xlib_surface", ExtensionType::Instance);
+    }
 #elif IGL_PLATFORM_MACOS
     enable(VK_EXT_DEBUG_UTILS_EXTENSION_NAME, ExtensionType::Instance);
-    enable(VK_EXT_METAL_SURFACE_EXTENSION_NAME, ExtensionType::Instance);
+    if (!headless) {
+      enable(VK_EXT_METAL_SURFACE_EXTENSION_NAME, ExtensionType::Instance);
+    }
 #endif
 
 #if IGL_PLATFORM_MACOS
@@ -135,7 +147,9 @@ void VulkanExtensions::enableCommonExtensions(ExtensionType extensionType, bool
 #if defined(VK_KHR_shader_non_semantic_info)
     enable(VK_KHR_SHADER_NON_SEMANTIC_INFO_EXTENSION_NAME, ExtensionType::Device);
 #endif // VK_KHR_shader_non_semantic_info
-    enable(VK_KHR_SWAPCHAIN_EXTENSION_NAME, ExtensionType::Device);
+    if (!headless) {
+      enable(VK_KHR_SWAPCHAIN_EXTENSION_NAME, ExtensionType::Device);
+    }
 
 #if IGL_PLATFORM_MACOS
     IGL_VERIFY(enable("VK_KHR_portability_subset", ExtensionType::Device));
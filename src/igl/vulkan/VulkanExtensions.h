@@ -64,7 +64,11 @@ class VulkanExtensions final {
   /// @param extensionType The type of the extensions
   /// @param validationEnabled Flag that informs the class whether the Validation Layer is
   /// enabled or not.
-  void enableCommonExtensions(ExtensionType extensionType, bool validationEnabled = false);
+  /// @param headless Flag that skips the surface and swapchain extensions, which are not needed
+  /// for offscreen rendering and are often missing on machines without a display.
+  void enableCommonExtensions(ExtensionType extensionType,
+                              bool validationEnabled = false,
+                              bool headless = false);
 
   /// @brief Enables the extension with name `extensionName` of the type `extensionType` if the
   /// extension is available. If an instance or physical device deoesn't support the
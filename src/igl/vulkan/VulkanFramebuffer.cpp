@@ -31,9 +31,7 @@ VulkanFramebuffer::VulkanFramebuffer(const VulkanContext& ctx,
 VulkanFramebuffer::~VulkanFramebuffer() {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_DESTROY);
 
-  ctx_.deferredTask(std::packaged_task<void()>([device = device_, framebuffer = vkFramebuffer_]() {
-    vkDestroyFramebuffer(device, framebuffer, nullptr);
-  }));
+  ctx_.deferredDestroy(VulkanContext::DestructionType::Framebuffer, (uint64_t)vkFramebuffer_);
 }
 
 } // namespace vulkan
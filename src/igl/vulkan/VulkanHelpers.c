@@ -179,6 +179,23 @@ VkResult ivkCreateCommandPool(VkDevice device,
   return vkCreateCommandPool(device, &ci, NULL, outCommandPool);
 }
 
+VkResult ivkCreateQueryPool(VkDevice device,
+                            VkQueryType queryType,
+                            uint32_t queryCount,
+                            VkQueryPipelineStatisticFlags pipelineStatistics,
+                            VkQueryPool* outQueryPool) {
+  const VkQueryPoolCreateInfo ci = {
+      .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+      .pNext = NULL,
+      .flags = 0,
+      .queryType = queryType,
+      .queryCount = queryCount,
+      .pipelineStatistics = pipelineStatistics,
+  };
+
+  return vkCreateQueryPool(device, &ci, NULL, outQueryPool);
+}
+
 VkResult ivkAllocateCommandBuffer(VkDevice device,
                                   VkCommandPool commandPool,
                                   VkCommandBuffer* outCommandBuffer) {
@@ -193,6 +210,20 @@ VkResult ivkAllocateCommandBuffer(VkDevice device,
   return vkAllocateCommandBuffers(device, &ai, outCommandBuffer);
 }
 
+VkResult ivkAllocateSecondaryCommandBuffer(VkDevice device,
+                                           VkCommandPool commandPool,
+                                           VkCommandBuffer* outCommandBuffer) {
+  const VkCommandBufferAllocateInfo ai = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+      .pNext = NULL,
+      .commandPool = commandPool,
+      .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+      .commandBufferCount = 1,
+  };
+
+  return vkAllocateCommandBuffers(device, &ai, outCommandBuffer);
+}
+
 VkResult ivkAllocateMemory(VkPhysicalDevice physDev,
                            VkDevice device,
                            const VkMemoryRequirements* memRequirements,
@@ -235,6 +266,43 @@ bool ivkIsHostVisibleSingleHeapMemory(VkPhysicalDevice physDev) {
   return false;
 }
 
+VkDeviceSize ivkGetHostVisibleDeviceLocalHeapSize(VkPhysicalDevice physDev) {
+  VkPhysicalDeviceMemoryProperties memProperties;
+
+  vkGetPhysicalDeviceMemoryProperties(physDev, &memProperties);
+
+  const uint32_t flag = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+  VkDeviceSize heapSize = 0;
+
+  for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+    if ((memProperties.memoryTypes[i].propertyFlags & flag) == flag) {
+      const uint32_t heapIndex = memProperties.memoryTypes[i].heapIndex;
+      const VkDeviceSize size = memProperties.memoryHeaps[heapIndex].size;
+      if (size > heapSize) {
+        heapSize = size;
+      }
+    }
+  }
+
+  return heapSize;
+}
+
+bool ivkHasLazilyAllocatedMemory(VkPhysicalDevice physDev) {
+  VkPhysicalDeviceMemoryProperties memProperties;
+
+  vkGetPhysicalDeviceMemoryProperties(physDev, &memProperties);
+
+  for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+    if (memProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 uint32_t ivkFindMemoryType(VkPhysicalDevice physDev,
                            uint32_t memoryTypeBits,
                            VkMemoryPropertyFlags flags) {
@@ -262,6 +330,22 @@ VkResult ivkCreateSemaphore(VkDevice device, VkSemaphore* outSemaphore) {
   return vkCreateSemaphore(device, &ci, NULL, outSemaphore);
 }
 
+VkResult ivkCreateTimelineSemaphore(VkDevice device,
+                                    uint64_t initialValue,
+                                    VkSemaphore* outSemaphore) {
+  const VkSemaphoreTypeCreateInfoKHR semaphoreTypeCreateInfo = {
+      .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR,
+      .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR,
+      .initialValue = initialValue,
+  };
+  const VkSemaphoreCreateInfo ci = {
+      .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+      .pNext = &semaphoreTypeCreateInfo,
+      .flags = 0,
+  };
+  return vkCreateSemaphore(device, &ci, NULL, outSemaphore);
+}
+
 VkResult ivkCreateFence(VkDevice device, VkFlags flags, VkFence* outFence) {
   const VkFenceCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
@@ -271,6 +355,16 @@ VkResult ivkCreateFence(VkDevice device, VkFlags flags, VkFence* outFence) {
   return vkCreateFence(device, &ci, NULL, outFence);
 }
 
+// puts `feedback` in front of the chain `next`, if there is a feedback
+static const void* ivkChainCreationFeedback(VkPipelineCreationFeedbackCreateInfoEXT* feedback,
+                                            const void* next) {
+  if (!feedback) {
+    return next;
+  }
+  feedback->pNext = next;
+  return feedback;
+}
+
 static void ivkAddNext(void* node, const void* next) {
   if (!node || !next) {
     return;
@@ -292,6 +386,18 @@ VkResult ivkCreateDevice(VkPhysicalDevice physicalDevice,
                          const char** deviceExtensions,
                          VkBool32 enableMultiview,
                          VkBool32 enableShaderFloat16,
+                         VkBool32 enableTimelineSemaphore,
+                         VkBool32 enableDynamicRendering,
+                         VkBool32 enablePresentWait,
+                         VkBool32 enableSparseResidency,
+                         VkBool32 enablePipelineStatistics,
+                         VkBool32 enableGraphicsPipelineLibrary,
+                         VkBool32 enableFragmentDensityMap,
+                         VkBool32 enableFragmentShadingRate,
+                         VkBool32 enableExtendedDynamicState,
+                         VkBool32 enableHostImageCopy,
+                         VkBool32 enableSynchronization2,
+                         VkBool32 enableDescriptorBuffer,
                          VkDevice* outDevice) {
   assert(numQueueCreateInfos >= 1);
   const VkPhysicalDeviceFeatures deviceFeatures = {
@@ -300,6 +406,9 @@ VkResult ivkCreateDevice(VkPhysicalDevice physicalDevice,
       .depthBiasClamp = VK_TRUE,
       .fillModeNonSolid = VK_TRUE,
       .shaderInt16 = VK_TRUE,
+      .sparseBinding = enableSparseResidency,
+      .sparseResidencyImage2D = enableSparseResidency,
+      .pipelineStatisticsQuery = enablePipelineStatistics,
   };
   VkDeviceCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
@@ -353,6 +462,112 @@ VkResult ivkCreateDevice(VkPhysicalDevice physicalDevice,
   }
 #endif // defined(VK_KHR_multiview)
 
+#if defined(VK_KHR_timeline_semaphore)
+  VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphoreFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR,
+      .timelineSemaphore = VK_TRUE,
+  };
+  if (enableTimelineSemaphore == VK_TRUE) {
+    ivkAddNext(&ci, &timelineSemaphoreFeature);
+  }
+#endif // defined(VK_KHR_timeline_semaphore)
+
+#if defined(VK_KHR_dynamic_rendering)
+  VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR,
+      .dynamicRendering = VK_TRUE,
+  };
+  if (enableDynamicRendering == VK_TRUE) {
+    ivkAddNext(&ci, &dynamicRenderingFeature);
+  }
+#endif // defined(VK_KHR_dynamic_rendering)
+
+#if defined(VK_KHR_present_wait)
+  VkPhysicalDevicePresentIdFeaturesKHR presentIdFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+      .presentId = VK_TRUE,
+  };
+  VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+      .presentWait = VK_TRUE,
+  };
+  if (enablePresentWait == VK_TRUE) {
+    ivkAddNext(&ci, &presentIdFeature);
+    ivkAddNext(&ci, &presentWaitFeature);
+  }
+#endif // defined(VK_KHR_present_wait)
+
+#if defined(VK_EXT_graphics_pipeline_library)
+  VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphicsPipelineLibraryFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT,
+      .graphicsPipelineLibrary = VK_TRUE,
+  };
+  if (enableGraphicsPipelineLibrary == VK_TRUE) {
+    ivkAddNext(&ci, &graphicsPipelineLibraryFeature);
+  }
+#endif // defined(VK_EXT_graphics_pipeline_library)
+
+#if defined(VK_EXT_fragment_density_map)
+  VkPhysicalDeviceFragmentDensityMapFeaturesEXT fragmentDensityMapFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_DENSITY_MAP_FEATURES_EXT,
+      .fragmentDensityMap = VK_TRUE,
+  };
+  if (enableFragmentDensityMap == VK_TRUE) {
+    ivkAddNext(&ci, &fragmentDensityMapFeature);
+  }
+#endif // defined(VK_EXT_fragment_density_map)
+
+#if defined(VK_KHR_fragment_shading_rate)
+  VkPhysicalDeviceFragmentShadingRateFeaturesKHR fragmentShadingRateFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR,
+      .pipelineFragmentShadingRate = VK_TRUE,
+  };
+  if (enableFragmentShadingRate == VK_TRUE) {
+    ivkAddNext(&ci, &fragmentShadingRateFeature);
+  }
+#endif // defined(VK_KHR_fragment_shading_rate)
+
+#if defined(VK_EXT_extended_dynamic_state)
+  VkPhysicalDeviceExtendedDynamicStateFeaturesEXT extendedDynamicStateFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT,
+      .extendedDynamicState = VK_TRUE,
+  };
+  if (enableExtendedDynamicState == VK_TRUE) {
+    ivkAddNext(&ci, &extendedDynamicStateFeature);
+  }
+#endif // defined(VK_EXT_extended_dynamic_state)
+
+#if defined(VK_EXT_host_image_copy)
+  VkPhysicalDeviceHostImageCopyFeaturesEXT hostImageCopyFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT,
+      .hostImageCopy = VK_TRUE,
+  };
+  if (enableHostImageCopy == VK_TRUE) {
+    ivkAddNext(&ci, &hostImageCopyFeature);
+  }
+#endif // defined(VK_EXT_host_image_copy)
+
+#if defined(VK_KHR_synchronization2)
+  VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Feature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR,
+      .synchronization2 = VK_TRUE,
+  };
+  if (enableSynchronization2 == VK_TRUE) {
+    ivkAddNext(&ci, &synchronization2Feature);
+  }
+#endif // defined(VK_KHR_synchronization2)
+
+#if defined(VK_EXT_descriptor_buffer)
+  VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptorBufferFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT,
+      .descriptorBuffer = VK_TRUE,
+      .descriptorBufferPushDescriptors = VK_TRUE,
+  };
+  if (enableDescriptorBuffer == VK_TRUE) {
+    ivkAddNext(&ci, &descriptorBufferFeature);
+  }
+#endif // defined(VK_EXT_descriptor_buffer)
+
   return vkCreateDevice(physicalDevice, &ci, NULL, outDevice);
 }
 
@@ -469,10 +684,12 @@ VkResult ivkCreateSwapchain(VkDevice device,
                             VkSurfaceFormatKHR surfaceFormat,
                             VkPresentModeKHR presentMode,
                             const VkSurfaceCapabilitiesKHR* caps,
+                            VkSurfaceTransformFlagBitsKHR preTransform,
                             VkImageUsageFlags imageUsage,
                             uint32_t queueFamilyIndex,
                             uint32_t width,
                             uint32_t height,
+                            VkSwapchainKHR oldSwapchain,
                             VkSwapchainKHR* outSwapchain) {
   assert(caps);
   const bool isCompositeAlphaOpaqueSupported =
@@ -489,12 +706,12 @@ VkResult ivkCreateSwapchain(VkDevice device,
       .imageSharingMode = VK_SHARING_MODE_EXCLUSIVE,
       .queueFamilyIndexCount = 1,
       .pQueueFamilyIndices = &queueFamilyIndex,
-      .preTransform = caps->currentTransform,
+      .preTransform = preTransform,
       .compositeAlpha = isCompositeAlphaOpaqueSupported ? VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR
                                                         : VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR,
       .presentMode = presentMode,
       .clipped = VK_TRUE,
-      .oldSwapchain = VK_NULL_HANDLE,
+      .oldSwapchain = oldSwapchain,
   };
   return vkCreateSwapchainKHR(device, &ci, NULL, outSwapchain);
 }
@@ -637,19 +854,31 @@ VkResult ivkCreateRenderPass(VkDevice device,
                              uint32_t numAttachments,
                              const VkAttachmentDescription* attachments,
                              const VkSubpassDescription* subpass,
-                             const VkSubpassDependency* dependency,
+                             uint32_t numDependencies,
+                             const VkSubpassDependency* dependencies,
                              const VkRenderPassMultiviewCreateInfo* renderPassMultiview,
+                             const VkAttachmentReference* fragmentDensityMap,
                              VkRenderPass* outRenderPass) {
-  const VkRenderPassCreateInfo ci = {
+  VkRenderPassCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
       .pNext = renderPassMultiview,
       .attachmentCount = numAttachments,
       .pAttachments = attachments,
       .subpassCount = 1,
       .pSubpasses = subpass,
-      .dependencyCount = 1,
-      .pDependencies = dependency,
+      .dependencyCount = numDependencies,
+      .pDependencies = dependencies,
   };
+#if defined(VK_EXT_fragment_density_map)
+  VkRenderPassFragmentDensityMapCreateInfoEXT fragmentDensityMapInfo = {
+      .sType = VK_STRUCTURE_TYPE_RENDER_PASS_FRAGMENT_DENSITY_MAP_CREATE_INFO_EXT,
+      .pNext = renderPassMultiview,
+  };
+  if (fragmentDensityMap) {
+    fragmentDensityMapInfo.fragmentDensityMapAttachment = *fragmentDensityMap;
+    ci.pNext = &fragmentDensityMapInfo;
+  }
+#endif // defined(VK_EXT_fragment_density_map)
   return vkCreateRenderPass(device, &ci, NULL, outRenderPass);
 }
 
@@ -687,6 +916,28 @@ VkAttachmentDescription ivkGetAttachmentDescription(VkFormat format,
   return desc;
 }
 
+VkRenderingAttachmentInfoKHR ivkGetRenderingAttachmentInfo(VkImageView imageView,
+                                                           VkImageLayout imageLayout,
+                                                           VkImageView resolveImageView,
+                                                           VkAttachmentLoadOp loadOp,
+                                                           VkAttachmentStoreOp storeOp,
+                                                           VkClearValue clearValue) {
+  const VkRenderingAttachmentInfoKHR info = {
+      .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR,
+      .pNext = NULL,
+      .imageView = imageView,
+      .imageLayout = imageLayout,
+      .resolveMode =
+          resolveImageView != VK_NULL_HANDLE ? VK_RESOLVE_MODE_AVERAGE_BIT : VK_RESOLVE_MODE_NONE,
+      .resolveImageView = resolveImageView,
+      .resolveImageLayout = imageLayout,
+      .loadOp = loadOp,
+      .storeOp = storeOp,
+      .clearValue = clearValue,
+  };
+  return info;
+}
+
 VkAttachmentReference ivkGetAttachmentReference(uint32_t attachment, VkImageLayout layout) {
   const VkAttachmentReference ref = {
       .attachment = attachment,
@@ -698,10 +949,14 @@ VkAttachmentReference ivkGetAttachmentReference(uint32_t attachment, VkImageLayo
 VkSubpassDescription ivkGetSubpassDescription(uint32_t numColorAttachments,
                                               const VkAttachmentReference* refsColor,
                                               const VkAttachmentReference* refsColorResolve,
-                                              const VkAttachmentReference* refDepth) {
+                                              const VkAttachmentReference* refDepth,
+                                              uint32_t numInputAttachments,
+                                              const VkAttachmentReference* refsInput) {
   const VkSubpassDescription desc = {
       .flags = 0,
       .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+      .inputAttachmentCount = numInputAttachments,
+      .pInputAttachments = refsInput,
       .colorAttachmentCount = numColorAttachments,
       .pColorAttachments = refsColor,
       .pResolveAttachments = refsColorResolve,
@@ -722,6 +977,19 @@ VkSubpassDependency ivkGetSubpassDependency(void) {
   return dep;
 }
 
+VkSubpassDependency ivkGetSubpassSelfDependency(void) {
+  const VkSubpassDependency dep = {
+      .srcSubpass = 0,
+      .dstSubpass = 0,
+      .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+      .dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+      .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT,
+      .dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT,
+  };
+  return dep;
+}
+
 VkRenderPassMultiviewCreateInfo ivkGetRenderPassMultiviewCreateInfo(
     const uint32_t* viewMask,
     const uint32_t* correlationMask) {
@@ -763,6 +1031,45 @@ VkResult ivkCreateDescriptorSetLayout(VkDevice device,
   return vkCreateDescriptorSetLayout(device, &ci, NULL, outLayout);
 }
 
+VkResult ivkCreatePushDescriptorSetLayout(VkDevice device,
+                                          uint32_t numBindings,
+                                          const VkDescriptorSetLayoutBinding* bindings,
+                                          VkDescriptorSetLayout* outLayout) {
+  // push descriptor set layouts cannot be combined with update-after-bind pools
+  const VkDescriptorSetLayoutCreateInfo ci = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR,
+      .bindingCount = numBindings,
+      .pBindings = bindings,
+  };
+  return vkCreateDescriptorSetLayout(device, &ci, NULL, outLayout);
+}
+
+#if defined(VK_EXT_descriptor_buffer)
+VkResult ivkCreateDescriptorBufferSetLayout(VkDevice device,
+                                            uint32_t numBindings,
+                                            const VkDescriptorSetLayoutBinding* bindings,
+                                            const VkDescriptorBindingFlags* bindingFlags,
+                                            VkBool32 isPushDescriptorSet,
+                                            VkDescriptorSetLayout* outLayout) {
+  const VkDescriptorSetLayoutBindingFlagsCreateInfo setLayoutBindingFlagsCI = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT,
+      .bindingCount = numBindings,
+      .pBindingFlags = bindingFlags,
+  };
+  // push descriptors are written into the command buffer, so they have no binding flags
+  const VkDescriptorSetLayoutCreateInfo ci = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .pNext = bindingFlags ? &setLayoutBindingFlagsCI : NULL,
+      .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT |
+               (isPushDescriptorSet ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR : 0),
+      .bindingCount = numBindings,
+      .pBindings = bindings,
+  };
+  return vkCreateDescriptorSetLayout(device, &ci, NULL, outLayout);
+}
+#endif // defined(VK_EXT_descriptor_buffer)
+
 VkResult ivkAllocateDescriptorSet(VkDevice device,
                                   VkDescriptorPool pool,
                                   VkDescriptorSetLayout layout,
@@ -801,6 +1108,52 @@ VkResult ivkBeginCommandBuffer(VkCommandBuffer buffer) {
   return vkBeginCommandBuffer(buffer, &bi);
 }
 
+VkResult ivkBeginSecondaryCommandBuffer(VkCommandBuffer buffer,
+                                        VkRenderPass renderPass,
+                                        VkFramebuffer framebuffer) {
+  const VkCommandBufferInheritanceInfo ii = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+      .pNext = NULL,
+      .renderPass = renderPass,
+      .subpass = 0,
+      .framebuffer = framebuffer,
+      .occlusionQueryEnable = VK_FALSE,
+      .queryFlags = 0,
+      .pipelineStatistics = 0,
+  };
+  const VkCommandBufferBeginInfo bi = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .pNext = NULL,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+               VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+      .pInheritanceInfo = &ii,
+  };
+  return vkBeginCommandBuffer(buffer, &bi);
+}
+
+VkResult ivkBeginSecondaryCommandBufferDynamicRendering(
+    VkCommandBuffer buffer,
+    const VkCommandBufferInheritanceRenderingInfoKHR* info) {
+  const VkCommandBufferInheritanceInfo ii = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+      .pNext = info,
+      .renderPass = VK_NULL_HANDLE,
+      .subpass = 0,
+      .framebuffer = VK_NULL_HANDLE,
+      .occlusionQueryEnable = VK_FALSE,
+      .queryFlags = 0,
+      .pipelineStatistics = 0,
+  };
+  const VkCommandBufferBeginInfo bi = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .pNext = NULL,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+               VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+      .pInheritanceInfo = &ii,
+  };
+  return vkBeginCommandBuffer(buffer, &bi);
+}
+
 VkResult ivkEndCommandBuffer(VkCommandBuffer buffer) {
   return vkEndCommandBuffer(buffer);
 }
@@ -921,6 +1274,18 @@ VkPipelineDynamicStateCreateInfo ivkGetPipelineDynamicStateCreateInfo(
   return ci;
 }
 
+VkPipelineCreationFeedbackCreateInfoEXT ivkGetPipelineCreationFeedbackCreateInfo(
+    VkPipelineCreationFeedbackEXT* feedback) {
+  const VkPipelineCreationFeedbackCreateInfoEXT ci = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT,
+      .pNext = NULL,
+      .pPipelineCreationFeedback = feedback,
+      .pipelineStageCreationFeedbackCount = 0,
+      .pPipelineStageCreationFeedbacks = NULL,
+  };
+  return ci;
+}
+
 VkPipelineViewportStateCreateInfo ivkGetPipelineViewportStateCreateInfo(const VkViewport* viewport,
                                                                         const VkRect2D* scissor) {
   // viewport and scissor can be NULL if the viewport state is dynamic
@@ -1132,16 +1497,18 @@ VkPushConstantRange ivkGetPushConstantRange(VkShaderStageFlags stageFlags,
   return range;
 }
 
-VkPipelineShaderStageCreateInfo ivkGetPipelineShaderStageCreateInfo(VkShaderStageFlagBits stage,
-                                                                    VkShaderModule shaderModule,
-                                                                    const char* entryPoint) {
+VkPipelineShaderStageCreateInfo ivkGetPipelineShaderStageCreateInfo(
+    VkShaderStageFlagBits stage,
+    VkShaderModule shaderModule,
+    const char* entryPoint,
+    const VkSpecializationInfo* specializationInfo) {
   const VkPipelineShaderStageCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
       .flags = 0,
       .stage = stage,
       .module = shaderModule,
       .pName = entryPoint ? entryPoint : "main",
-      .pSpecializationInfo = NULL,
+      .pSpecializationInfo = specializationInfo,
   };
   return ci;
 }
@@ -1233,6 +1600,7 @@ VkResult ivkCreateShaderModuleFromSPIRV(VkDevice device,
 
 VkResult ivkCreateGraphicsPipeline(VkDevice device,
                                    VkPipelineCache pipelineCache,
+                                   VkPipelineCreateFlags flags,
                                    uint32_t numShaderStages,
                                    const VkPipelineShaderStageCreateInfo* shaderStages,
                                    const VkPipelineVertexInputStateCreateInfo* vertexInputState,
@@ -1246,11 +1614,13 @@ VkResult ivkCreateGraphicsPipeline(VkDevice device,
                                    const VkPipelineDynamicStateCreateInfo* dynamicState,
                                    VkPipelineLayout pipelineLayout,
                                    VkRenderPass renderPass,
+                                   const VkPipelineRenderingCreateInfoKHR* renderingInfo,
+                                   VkPipelineCreationFeedbackCreateInfoEXT* feedback,
                                    VkPipeline* outPipeline) {
   const VkGraphicsPipelineCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-      .pNext = NULL,
-      .flags = 0,
+      .pNext = ivkChainCreationFeedback(feedback, renderingInfo),
+      .flags = flags,
       .stageCount = numShaderStages,
       .pStages = shaderStages,
       .pVertexInputState = vertexInputState,
@@ -1271,15 +1641,90 @@ VkResult ivkCreateGraphicsPipeline(VkDevice device,
   return vkCreateGraphicsPipelines(device, pipelineCache, 1, &ci, NULL, outPipeline);
 }
 
+VkResult ivkCreateGraphicsPipelineLibrary(
+    VkDevice device,
+    VkPipelineCache pipelineCache,
+    VkGraphicsPipelineLibraryFlagsEXT parts,
+    uint32_t numShaderStages,
+    const VkPipelineShaderStageCreateInfo* shaderStages,
+    const VkPipelineVertexInputStateCreateInfo* vertexInputState,
+    const VkPipelineInputAssemblyStateCreateInfo* inputAssemblyState,
+    const VkPipelineViewportStateCreateInfo* viewportState,
+    const VkPipelineRasterizationStateCreateInfo* rasterizationState,
+    const VkPipelineMultisampleStateCreateInfo* multisampleState,
+    const VkPipelineDepthStencilStateCreateInfo* depthStencilState,
+    const VkPipelineColorBlendStateCreateInfo* colorBlendState,
+    const VkPipelineDynamicStateCreateInfo* dynamicState,
+    VkPipelineLayout pipelineLayout,
+    VkRenderPass renderPass,
+    const VkPipelineRenderingCreateInfoKHR* renderingInfo,
+    VkPipelineCreationFeedbackCreateInfoEXT* feedback,
+    VkPipeline* outPipeline) {
+  VkGraphicsPipelineLibraryCreateInfoEXT libraryInfo = {
+      .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT,
+      .pNext = (void*)renderingInfo,
+      .flags = parts,
+  };
+  const VkGraphicsPipelineCreateInfo ci = {
+      .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+      .pNext = ivkChainCreationFeedback(feedback, &libraryInfo),
+      // keep the intermediate representation to link optimized pipelines later
+      .flags = VK_PIPELINE_CREATE_LIBRARY_BIT_KHR |
+               VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT,
+      .stageCount = numShaderStages,
+      .pStages = shaderStages,
+      .pVertexInputState = vertexInputState,
+      .pInputAssemblyState = inputAssemblyState,
+      .pViewportState = viewportState,
+      .pRasterizationState = rasterizationState,
+      .pMultisampleState = multisampleState,
+      .pDepthStencilState = depthStencilState,
+      .pColorBlendState = colorBlendState,
+      .pDynamicState = dynamicState,
+      .layout = pipelineLayout,
+      .renderPass = renderPass,
+      .subpass = 0,
+      .basePipelineHandle = VK_NULL_HANDLE,
+      .basePipelineIndex = -1,
+  };
+  return vkCreateGraphicsPipelines(device, pipelineCache, 1, &ci, NULL, outPipeline);
+}
+
+VkResult ivkLinkGraphicsPipelineLibraries(VkDevice device,
+                                          VkPipelineCache pipelineCache,
+                                          uint32_t numLibraries,
+                                          const VkPipeline* libraries,
+                                          VkPipelineLayout pipelineLayout,
+                                          VkBool32 optimize,
+                                          VkPipelineCreationFeedbackCreateInfoEXT* feedback,
+                                          VkPipeline* outPipeline) {
+  const VkPipelineLibraryCreateInfoKHR libraryInfo = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR,
+      .libraryCount = numLibraries,
+      .pLibraries = libraries,
+  };
+  const VkGraphicsPipelineCreateInfo ci = {
+      .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+      .pNext = ivkChainCreationFeedback(feedback, &libraryInfo),
+      .flags = optimize == VK_TRUE ? VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT : 0,
+      .layout = pipelineLayout,
+      .basePipelineHandle = VK_NULL_HANDLE,
+      .basePipelineIndex = -1,
+  };
+  return vkCreateGraphicsPipelines(device, pipelineCache, 1, &ci, NULL, outPipeline);
+}
+
 VkResult ivkCreateComputePipeline(VkDevice device,
                                   VkPipelineCache pipelineCache,
+                                  VkPipelineCreateFlags flags,
                                   const VkPipelineShaderStageCreateInfo* shaderStage,
                                   VkPipelineLayout pipelineLayout,
+                                  VkPipelineCreationFeedbackCreateInfoEXT* feedback,
                                   VkPipeline* outPipeline) {
   const VkComputePipelineCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
-      .pNext = NULL,
-      .flags = 0,
+      .pNext = ivkChainCreationFeedback(feedback, NULL),
+      .flags = flags,
       .stage = *shaderStage,
       .layout = pipelineLayout,
       .basePipelineHandle = VK_NULL_HANDLE,
@@ -1352,8 +1797,9 @@ void ivkCmdBlitImage(VkCommandBuffer buffer,
 VkResult ivkQueuePresent(VkQueue graphicsQueue,
                          VkSemaphore waitSemaphore,
                          VkSwapchainKHR swapchain,
-                         uint32_t currentSwapchainImageIndex) {
-  const VkPresentInfoKHR pi = {
+                         uint32_t currentSwapchainImageIndex,
+                         uint64_t presentId) {
+  VkPresentInfoKHR pi = {
       .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
       .waitSemaphoreCount = 1,
       .pWaitSemaphores = &waitSemaphore,
@@ -1361,6 +1807,16 @@ VkResult ivkQueuePresent(VkQueue graphicsQueue,
       .pSwapchains = &swapchain,
       .pImageIndices = &currentSwapchainImageIndex,
   };
+#if defined(VK_KHR_present_id)
+  const VkPresentIdKHR presentIdInfo = {
+      .sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR,
+      .swapchainCount = 1,
+      .pPresentIds = &presentId,
+  };
+  if (presentId) {
+    ivkAddNext(&pi, &presentIdInfo);
+  }
+#endif // defined(VK_KHR_present_id)
   return vkQueuePresentKHR(graphicsQueue, &pi);
 }
 
@@ -1492,6 +1948,7 @@ VkResult ivkVmaCreateAllocator(VkPhysicalDevice physDev,
                                VkDevice device,
                                VkInstance instance,
                                uint32_t apiVersion,
+                               VkBool32 enableMemoryBudget,
                                VmaAllocator* outVma) {
   const VmaVulkanFunctions funcs = {
     .vkGetInstanceProcAddr = vkGetInstanceProcAddr,
@@ -1528,8 +1985,11 @@ VkResult ivkVmaCreateAllocator(VkPhysicalDevice physDev,
 #endif
   };
 
+  // the allocator is internally synchronized (no VMA_ALLOCATOR_CREATE_EXTERNALLY_SYNCHRONIZED_BIT)
+  // because images and buffers can be created from any thread
   const VmaAllocatorCreateInfo ci = {
-      .flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
+      .flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT |
+               (enableMemoryBudget ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0),
       .physicalDevice = physDev,
       .device = device,
       .preferredLargeHeapBlockSize = 0,
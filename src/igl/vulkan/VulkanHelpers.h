@@ -49,6 +49,9 @@ VkResult ivkCreateDebugReportMessenger(VkInstance instance,
                                        VkDebugReportCallbackEXT* outMessenger);
 
 VkResult ivkCreateSemaphore(VkDevice device, VkSemaphore* outSemaphore);
+VkResult ivkCreateTimelineSemaphore(VkDevice device,
+                                    uint64_t initialValue,
+                                    VkSemaphore* outSemaphore);
 
 VkResult ivkCreateFence(VkDevice device, VkFlags flags, VkFence* outFence);
 
@@ -64,6 +67,18 @@ VkResult ivkCreateDevice(VkPhysicalDevice physicalDevice,
                          const char** deviceExtensions,
                          VkBool32 enableMultiview,
                          VkBool32 enableShaderFloat16,
+                         VkBool32 enableTimelineSemaphore,
+                         VkBool32 enableDynamicRendering,
+                         VkBool32 enablePresentWait,
+                         VkBool32 enableSparseResidency,
+                         VkBool32 enablePipelineStatistics,
+                         VkBool32 enableGraphicsPipelineLibrary,
+                         VkBool32 enableFragmentDensityMap,
+                         VkBool32 enableFragmentShadingRate,
+                         VkBool32 enableExtendedDynamicState,
+                         VkBool32 enableHostImageCopy,
+                         VkBool32 enableSynchronization2,
+                         VkBool32 enableDescriptorBuffer,
                          VkDevice* outDevice);
 
 VkResult ivkCreateHeadlessSurface(VkInstance instance, VkSurfaceKHR* surface);
@@ -74,10 +89,12 @@ VkResult ivkCreateSwapchain(VkDevice device,
                             VkSurfaceFormatKHR surfaceFormat,
                             VkPresentModeKHR presentMode,
                             const VkSurfaceCapabilitiesKHR* caps,
+                            VkSurfaceTransformFlagBitsKHR preTransform,
                             VkImageUsageFlags imageUsage,
                             uint32_t queueFamilyIndex,
                             uint32_t width,
                             uint32_t height,
+                            VkSwapchainKHR oldSwapchain,
                             VkSwapchainKHR* outSwapchain);
 
 VkResult ivkCreateSampler(VkDevice device, VkSampler* outSampler);
@@ -111,10 +128,20 @@ VkResult ivkCreateCommandPool(VkDevice device,
                               uint32_t queueFamilyIndex,
                               VkCommandPool* outCommandPool);
 
+VkResult ivkCreateQueryPool(VkDevice device,
+                            VkQueryType queryType,
+                            uint32_t queryCount,
+                            VkQueryPipelineStatisticFlags pipelineStatistics,
+                            VkQueryPool* outQueryPool);
+
 VkResult ivkAllocateCommandBuffer(VkDevice device,
                                   VkCommandPool commandPool,
                                   VkCommandBuffer* outCommandBuffer);
 
+VkResult ivkAllocateSecondaryCommandBuffer(VkDevice device,
+                                           VkCommandPool commandPool,
+                                           VkCommandBuffer* outCommandBuffer);
+
 VkResult ivkAllocateMemory(VkPhysicalDevice physDev,
                            VkDevice device,
                            const VkMemoryRequirements* memRequirements,
@@ -123,6 +150,13 @@ VkResult ivkAllocateMemory(VkPhysicalDevice physDev,
 
 bool ivkIsHostVisibleSingleHeapMemory(VkPhysicalDevice physDev);
 
+// Size of the largest device-local heap which can be mapped by the CPU (host-visible and coherent),
+// 0 if there is none. Discrete GPUs with resizable BAR expose most of their VRAM this way.
+VkDeviceSize ivkGetHostVisibleDeviceLocalHeapSize(VkPhysicalDevice physDev);
+
+// Tile-based GPUs can back transient attachments with on-chip memory only
+bool ivkHasLazilyAllocatedMemory(VkPhysicalDevice physDev);
+
 uint32_t ivkFindMemoryType(VkPhysicalDevice physDev,
                            uint32_t memoryTypeBits,
                            VkMemoryPropertyFlags flags);
@@ -131,8 +165,10 @@ VkResult ivkCreateRenderPass(VkDevice device,
                              uint32_t numAttachments,
                              const VkAttachmentDescription* attachments,
                              const VkSubpassDescription* subpass,
-                             const VkSubpassDependency* dependency,
+                             uint32_t numDependencies,
+                             const VkSubpassDependency* dependencies,
                              const VkRenderPassMultiviewCreateInfo* renderPassMultiview,
+                             const VkAttachmentReference* fragmentDensityMap,
                              VkRenderPass* outRenderPass);
 
 VkResult ivkCreateShaderModule(VkDevice device,
@@ -146,6 +182,7 @@ VkResult ivkCreateShaderModuleFromSPIRV(VkDevice device,
 
 VkResult ivkCreateGraphicsPipeline(VkDevice device,
                                    VkPipelineCache pipelineCache,
+                                   VkPipelineCreateFlags flags,
                                    uint32_t numShaderStages,
                                    const VkPipelineShaderStageCreateInfo* shaderStages,
                                    const VkPipelineVertexInputStateCreateInfo* vertexInputState,
@@ -159,12 +196,49 @@ VkResult ivkCreateGraphicsPipeline(VkDevice device,
                                    const VkPipelineDynamicStateCreateInfo* dynamicState,
                                    VkPipelineLayout pipelineLayout,
                                    VkRenderPass renderPass,
+                                   const VkPipelineRenderingCreateInfoKHR* renderingInfo,
+                                   VkPipelineCreationFeedbackCreateInfoEXT* feedback,
                                    VkPipeline* outPipeline);
 
+// Creates a pipeline library (VK_EXT_graphics_pipeline_library) with the subset of the state
+// selected by `parts`; the state of other parts is ignored and can be null
+VkResult ivkCreateGraphicsPipelineLibrary(
+    VkDevice device,
+    VkPipelineCache pipelineCache,
+    VkGraphicsPipelineLibraryFlagsEXT parts,
+    uint32_t numShaderStages,
+    const VkPipelineShaderStageCreateInfo* shaderStages,
+    const VkPipelineVertexInputStateCreateInfo* vertexInputState,
+    const VkPipelineInputAssemblyStateCreateInfo* inputAssemblyState,
+    const VkPipelineViewportStateCreateInfo* viewportState,
+    const VkPipelineRasterizationStateCreateInfo* rasterizationState,
+    const VkPipelineMultisampleStateCreateInfo* multisampleState,
+    const VkPipelineDepthStencilStateCreateInfo* depthStencilState,
+    const VkPipelineColorBlendStateCreateInfo* colorBlendState,
+    const VkPipelineDynamicStateCreateInfo* dynamicState,
+    VkPipelineLayout pipelineLayout,
+    VkRenderPass renderPass,
+    const VkPipelineRenderingCreateInfoKHR* renderingInfo,
+    VkPipelineCreationFeedbackCreateInfoEXT* feedback,
+    VkPipeline* outPipeline);
+
+// Links pipeline libraries into a complete graphics pipeline. Without `optimize` this is a fast
+// link; otherwise the libraries must have been created with link-time optimization info
+VkResult ivkLinkGraphicsPipelineLibraries(VkDevice device,
+                                          VkPipelineCache pipelineCache,
+                                          uint32_t numLibraries,
+                                          const VkPipeline* libraries,
+                                          VkPipelineLayout pipelineLayout,
+                                          VkBool32 optimize,
+                                          VkPipelineCreationFeedbackCreateInfoEXT* feedback,
+                                          VkPipeline* outPipeline);
+
 VkResult ivkCreateComputePipeline(VkDevice device,
                                   VkPipelineCache pipelineCache,
+                                  VkPipelineCreateFlags flags,
                                   const VkPipelineShaderStageCreateInfo* shaderStage,
                                   VkPipelineLayout pipelineLayout,
+                                  VkPipelineCreationFeedbackCreateInfoEXT* feedback,
                                   VkPipeline* outPipeline);
 
 VkResult ivkCreateDescriptorSetLayout(VkDevice device,
@@ -173,6 +247,24 @@ VkResult ivkCreateDescriptorSetLayout(VkDevice device,
                                       const VkDescriptorBindingFlags* bindingFlags,
                                       VkDescriptorSetLayout* outLayout);
 
+// Creates a layout for descriptor sets written by vkCmdPushDescriptorSetKHR()
+// (VK_KHR_push_descriptor)
+VkResult ivkCreatePushDescriptorSetLayout(VkDevice device,
+                                          uint32_t numBindings,
+                                          const VkDescriptorSetLayoutBinding* bindings,
+                                          VkDescriptorSetLayout* outLayout);
+
+#if defined(VK_EXT_descriptor_buffer)
+// Creates a layout for descriptor sets stored in descriptor buffers (VK_EXT_descriptor_buffer).
+// `bindingFlags` cannot contain update-after-bind flags
+VkResult ivkCreateDescriptorBufferSetLayout(VkDevice device,
+                                            uint32_t numBindings,
+                                            const VkDescriptorSetLayoutBinding* bindings,
+                                            const VkDescriptorBindingFlags* bindingFlags,
+                                            VkBool32 isPushDescriptorSet,
+                                            VkDescriptorSetLayout* outLayout);
+#endif // defined(VK_EXT_descriptor_buffer)
+
 VkDescriptorSetLayoutBinding ivkGetDescriptorSetLayoutBinding(uint32_t binding,
                                                               VkDescriptorType descriptorType,
                                                               uint32_t descriptorCount);
@@ -184,15 +276,29 @@ VkAttachmentDescription ivkGetAttachmentDescription(VkFormat format,
                                                     VkImageLayout finalLayout,
                                                     VkSampleCountFlagBits samples);
 
+// Describes an attachment for vkCmdBeginRendering(); `resolveImageView` can be VK_NULL_HANDLE
+VkRenderingAttachmentInfoKHR ivkGetRenderingAttachmentInfo(VkImageView imageView,
+                                                           VkImageLayout imageLayout,
+                                                           VkImageView resolveImageView,
+                                                           VkAttachmentLoadOp loadOp,
+                                                           VkAttachmentStoreOp storeOp,
+                                                           VkClearValue clearValue);
+
 VkAttachmentReference ivkGetAttachmentReference(uint32_t attachment, VkImageLayout layout);
 
 VkSubpassDescription ivkGetSubpassDescription(uint32_t numColorAttachments,
                                               const VkAttachmentReference* refsColor,
                                               const VkAttachmentReference* refsColorResolve,
-                                              const VkAttachmentReference* refDepth);
+                                              const VkAttachmentReference* refDepth,
+                                              uint32_t numInputAttachments,
+                                              const VkAttachmentReference* refsInput);
 
 VkSubpassDependency ivkGetSubpassDependency(void);
 
+/// @brief Returns a self-dependency of the first subpass which makes color attachment writes
+/// visible to input attachment reads by pipeline barriers recorded inside the subpass
+VkSubpassDependency ivkGetSubpassSelfDependency(void);
+
 VkRenderPassMultiviewCreateInfo ivkGetRenderPassMultiviewCreateInfo(
     const uint32_t* viewMask,
     const uint32_t* correlationMask);
@@ -210,6 +316,16 @@ VkResult ivkCreateDescriptorPool(VkDevice device,
 
 VkResult ivkBeginCommandBuffer(VkCommandBuffer buffer);
 
+// Begins a secondary command buffer which continues subpass 0 of `renderPass`
+VkResult ivkBeginSecondaryCommandBuffer(VkCommandBuffer buffer,
+                                        VkRenderPass renderPass,
+                                        VkFramebuffer framebuffer);
+
+// Begins a secondary command buffer which continues a dynamic rendering pass described by `info`
+VkResult ivkBeginSecondaryCommandBufferDynamicRendering(
+    VkCommandBuffer buffer,
+    const VkCommandBufferInheritanceRenderingInfoKHR* info);
+
 VkResult ivkEndCommandBuffer(VkCommandBuffer buffer);
 
 VkSubmitInfo ivkGetSubmitInfo(const VkCommandBuffer* buffer,
@@ -257,6 +373,11 @@ VkPipelineDynamicStateCreateInfo ivkGetPipelineDynamicStateCreateInfo(
     uint32_t numDynamicStates,
     const VkDynamicState* dynamicStates);
 
+// Receives the feedback of the whole pipeline (VK_EXT_pipeline_creation_feedback) without
+// per-stage feedback
+VkPipelineCreationFeedbackCreateInfoEXT ivkGetPipelineCreationFeedbackCreateInfo(
+    VkPipelineCreationFeedbackEXT* feedback);
+
 VkPipelineRasterizationStateCreateInfo ivkGetPipelineRasterizationStateCreateInfo(
     VkPolygonMode polygonMode,
     VkCullModeFlags cullMode);
@@ -311,9 +432,11 @@ VkViewport ivkGetViewport(float x, float y, float width, float height);
 
 VkRect2D ivkGetRect2D(int32_t x, int32_t y, uint32_t width, uint32_t height);
 
-VkPipelineShaderStageCreateInfo ivkGetPipelineShaderStageCreateInfo(VkShaderStageFlagBits stage,
-                                                                    VkShaderModule shaderModule,
-                                                                    const char* entryPoint);
+VkPipelineShaderStageCreateInfo ivkGetPipelineShaderStageCreateInfo(
+    VkShaderStageFlagBits stage,
+    VkShaderModule shaderModule,
+    const char* entryPoint,
+    const VkSpecializationInfo* specializationInfo);
 
 VkImageCopy ivkGetImageCopy2D(VkOffset2D srcDstOffset,
                               VkImageSubresourceLayers srcDstImageSubresource,
@@ -361,10 +484,12 @@ void ivkCmdBlitImage(VkCommandBuffer buffer,
                      VkImageSubresourceLayers dstSubresourceRange,
                      VkFilter filter);
 
+/// @param presentId VK_KHR_present_id value identifying this present (0 if not used)
 VkResult ivkQueuePresent(VkQueue graphicsQueue,
                          VkSemaphore waitSemaphore,
                          VkSwapchainKHR swapchain,
-                         uint32_t currentSwapchainImageIndex);
+                         uint32_t currentSwapchainImageIndex,
+                         uint64_t presentId);
 
 VkResult ivkSetDebugObjectName(VkDevice device,
                                VkObjectType type,
@@ -391,6 +516,7 @@ VkResult ivkVmaCreateAllocator(VkPhysicalDevice physDev,
                                VkDevice device,
                                VkInstance instance,
                                uint32_t apiVersion,
+                               VkBool32 enableMemoryBudget,
                                VmaAllocator* outVma);
 
 void ivkGlslangResource(glslang_resource_t* glslangResource,
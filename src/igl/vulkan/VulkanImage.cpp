@@ -7,9 +7,11 @@
 
 #include "VulkanImage.h"
 
+#include <algorithm>
 #include <array>
 #include <cinttypes>
 #include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanBarrierBatch.h>
 #include <igl/vulkan/VulkanContext.h>
 #include <igl/vulkan/VulkanImageView.h>
 
@@ -42,6 +44,114 @@ constexpr auto kHandleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_KMT_BIT
 constexpr auto kHandleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
 #endif
 
+// Deduces the access masks of a layout transition from its pipeline stages.
+void getTransitionAccessMasks(VkImageLayout oldImageLayout,
+                              VkPipelineStageFlags& srcStageMask,
+                              VkPipelineStageFlags dstStageMask,
+                              VkAccessFlags& srcAccessMask,
+                              VkAccessFlags& dstAccessMask) {
+  srcAccessMask = 0;
+  dstAccessMask = 0;
+
+  if (oldImageLayout == VK_IMAGE_LAYOUT_UNDEFINED) {
+    // we do not need to wait for any previous operations in this case
+    srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+  }
+
+  switch (srcStageMask) {
+  case VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT:
+  case VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT:
+  case VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT:
+  case VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT:
+  case VK_PIPELINE_STAGE_ALL_COMMANDS_BIT:
+  case VK_PIPELINE_STAGE_TRANSFER_BIT:
+  case VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT:
+    break;
+  default:
+    IGL_ASSERT_MSG(
+        false, "Automatic access mask deduction is not implemented (yet) for this srcStageMask");
+    break;
+  }
+
+  // once you want to add a new pipeline stage to this block of if's, don't forget to add it to the
+  // switch() statement above
+  if (srcStageMask & VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT) {
+    srcAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+  }
+  if (srcStageMask & VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT) {
+    srcAccessMask |= VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  }
+  if (srcStageMask & VK_PIPELINE_STAGE_TRANSFER_BIT) {
+    srcAccessMask |= VK_ACCESS_TRANSFER_WRITE_BIT;
+  }
+  if (srcStageMask & VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT) {
+    srcAccessMask |= VK_ACCESS_SHADER_WRITE_BIT;
+  }
+
+  switch (dstStageMask) {
+  case VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT:
+  case VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT:
+  case VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT:
+  case VK_PIPELINE_STAGE_TRANSFER_BIT:
+  case VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT:
+  case VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT:
+#if defined(VK_EXT_fragment_density_map)
+  case VK_PIPELINE_STAGE_FRAGMENT_DENSITY_PROCESS_BIT_EXT:
+#endif // VK_EXT_fragment_density_map
+    break;
+  default:
+    IGL_ASSERT_MSG(
+        false, "Automatic access mask deduction is not implemented (yet) for this dstStageMask");
+    break;
+  }
+
+  // once you want to add a new pipeline stage to this block of if's, don't forget to add it to the
+  // switch() statement above
+  if (dstStageMask & VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT) {
+    dstAccessMask |= VK_ACCESS_SHADER_READ_BIT;
+    dstAccessMask |= VK_ACCESS_SHADER_WRITE_BIT;
+  }
+  if (dstStageMask & VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT) {
+    dstAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+  }
+  if (dstStageMask & VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT) {
+    dstAccessMask |= VK_ACCESS_SHADER_READ_BIT;
+    dstAccessMask |= VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+  }
+  if (dstStageMask & VK_PIPELINE_STAGE_TRANSFER_BIT) {
+    dstAccessMask |= VK_ACCESS_TRANSFER_READ_BIT;
+  }
+#if defined(VK_EXT_fragment_density_map)
+  if (dstStageMask & VK_PIPELINE_STAGE_FRAGMENT_DENSITY_PROCESS_BIT_EXT) {
+    dstAccessMask |= VK_ACCESS_FRAGMENT_DENSITY_MAP_READ_BIT_EXT;
+  }
+#endif // VK_EXT_fragment_density_map
+}
+
+// any other layout means the contents of the image are going to be read
+bool isAttachmentLayout(VkImageLayout layout) {
+  return layout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL ||
+         layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+}
+
+uint32_t divideRoundingUp(uint32_t value, uint32_t divisor) {
+  return (value + divisor - 1) / divisor;
+}
+
+uint64_t getSparseTileKey(uint32_t mipLevel, uint32_t layer, uint32_t x, uint32_t y) {
+  IGL_ASSERT(mipLevel < (1u << 8) && layer < (1u << 16) && x < (1u << 20) && y < (1u << 20));
+  return (uint64_t(mipLevel) << 56) | (uint64_t(layer) << 40) | (uint64_t(y) << 20) | x;
+}
+
+bool isReadOnlyLayout(VkImageLayout layout) {
+  return layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL ||
+         layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL ||
+#if defined(VK_EXT_fragment_density_map)
+         layout == VK_IMAGE_LAYOUT_FRAGMENT_DENSITY_MAP_OPTIMAL_EXT ||
+#endif // VK_EXT_fragment_density_map
+         layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+}
+
 } // namespace
 
 namespace igl {
@@ -114,19 +224,35 @@ VulkanImage::VulkanImage(const VulkanContext& ctx,
   IGL_ASSERT_MSG(imageFormat_ != VK_FORMAT_UNDEFINED, "Invalid VkFormat value");
   IGL_ASSERT_MSG(samples_ > 0, "The image must contain at least one sample");
 
-  const VkImageCreateInfo ci = ivkGetImageCreateInfo(type,
-                                                     imageFormat_,
-                                                     tiling,
-                                                     usageFlags,
-                                                     extent_,
-                                                     mipLevels_,
-                                                     arrayLayers_,
-                                                     createFlags,
-                                                     samples);
-
-  if (IGL_VULKAN_USE_VMA) {
+  VkImageCreateInfo ci = ivkGetImageCreateInfo(type,
+                                               imageFormat_,
+                                               tiling,
+                                               usageFlags,
+                                               extent_,
+                                               mipLevels_,
+                                               arrayLayers_,
+                                               createFlags,
+                                               samples);
+  if (!ctx_.sharedQueueFamilyIndices_.empty()) {
+    // accessed from the async compute queue without queue family ownership transfers
+    ci.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    ci.queueFamilyIndexCount = (uint32_t)ctx_.sharedQueueFamilyIndices_.size();
+    ci.pQueueFamilyIndices = ctx_.sharedQueueFamilyIndices_.data();
+  }
+
+  if (createFlags & VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT) {
+    // sparse images are not backed by memory upfront (VMA cannot allocate memory for them)
+    IGL_ASSERT(createFlags & VK_IMAGE_CREATE_SPARSE_BINDING_BIT);
+    IGL_ASSERT(!(memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT));
+    isSparse_ = true;
+    VK_ASSERT(vkCreateImage(device_, &ci, nullptr, &vkImage_));
+    initSparseResidency();
+  } else if (IGL_VULKAN_USE_VMA) {
+    vkImageCreateInfo_ = ci;
     vmaAllocInfo_.usage = memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
                               ? VMA_MEMORY_USAGE_CPU_TO_GPU
+                          : memFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT
+                              ? VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED
                               : VMA_MEMORY_USAGE_AUTO;
 
     VkResult result = vmaCreateImage((VmaAllocator)ctx_.getVmaAllocator(),
@@ -175,6 +301,8 @@ VulkanImage::VulkanImage(const VulkanContext& ctx,
     }
   }
 
+  ctx_.imageMemoryBytes_ += allocatedSize;
+
   VK_ASSERT(ivkSetDebugObjectName(device_, VK_OBJECT_TYPE_IMAGE, (uint64_t)vkImage_, debugName));
 
   // Get physical device's properties for the image's format
@@ -295,6 +423,83 @@ VulkanImage::VulkanImage(const VulkanContext& ctx,
   VK_ASSERT(vkBindImageMemory(device_, vkImage_, vkMemory_, 0));
 }
 
+#if IGL_PLATFORM_ANDROID && defined(VK_ANDROID_external_memory_android_hardware_buffer)
+VulkanImage::VulkanImage(const VulkanContext& ctx,
+                         AHardwareBuffer* hardwareBuffer,
+                         const VkAndroidHardwareBufferPropertiesANDROID& properties,
+                         VkDevice device,
+                         VkExtent3D extent,
+                         VkFormat format,
+                         uint32_t arrayLayers,
+                         VkImageUsageFlags usageFlags,
+                         const char* debugName) :
+  ctx_(ctx),
+  physicalDevice_(ctx.getVkPhysicalDevice()),
+  device_(device),
+  usageFlags_(usageFlags),
+  extent_(extent),
+  type_(VK_IMAGE_TYPE_2D),
+  imageFormat_(format),
+  mipLevels_(1),
+  arrayLayers_(arrayLayers),
+  samples_(VK_SAMPLE_COUNT_1_BIT),
+  isDepthFormat_(isDepthFormat(format)),
+  isStencilFormat_(isStencilFormat(format)),
+  isDepthOrStencilFormat_(isDepthFormat_ || isStencilFormat_),
+  isImported_(true) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  IGL_ASSERT_MSG(hardwareBuffer, "The hardware buffer is null");
+  IGL_ASSERT_MSG(arrayLayers_ > 0, "The image must contain at least one layer");
+  IGL_ASSERT_MSG(imageFormat_ != VK_FORMAT_UNDEFINED, "External formats are not supported");
+
+  VkImageCreateInfo ci = ivkGetImageCreateInfo(type_,
+                                               imageFormat_,
+                                               VK_IMAGE_TILING_OPTIMAL,
+                                               usageFlags,
+                                               extent_,
+                                               mipLevels_,
+                                               arrayLayers_,
+                                               0,
+                                               samples_);
+
+  const VkExternalMemoryImageCreateInfo extImgMem = {
+      VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_IMAGE_CREATE_INFO,
+      nullptr,
+      VK_EXTERNAL_MEMORY_HANDLE_TYPE_ANDROID_HARDWARE_BUFFER_BIT_ANDROID};
+
+  ci.pNext = &extImgMem;
+  ci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  ci.queueFamilyIndexCount = 0;
+  ci.pQueueFamilyIndices = nullptr;
+  ci.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  // create image.. importing external memory cannot use VMA
+  VK_ASSERT(vkCreateImage(device_, &ci, nullptr, &vkImage_));
+  VK_ASSERT(ivkSetDebugObjectName(device_, VK_OBJECT_TYPE_IMAGE, (uint64_t)vkImage_, debugName));
+
+  // the memory of a hardware buffer can only be bound to a single image
+  const VkMemoryDedicatedAllocateInfo dedicatedInfo = {
+      VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO, nullptr, vkImage_, VK_NULL_HANDLE};
+  const VkImportAndroidHardwareBufferInfoANDROID importInfo = {
+      VK_STRUCTURE_TYPE_IMPORT_ANDROID_HARDWARE_BUFFER_INFO_ANDROID,
+      &dedicatedInfo,
+      hardwareBuffer};
+
+  VkPhysicalDeviceMemoryProperties vulkanMemoryProperties;
+  vkGetPhysicalDeviceMemoryProperties(physicalDevice_, &vulkanMemoryProperties);
+
+  const VkMemoryAllocateInfo memoryAllocateInfo = {
+      VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+      &importInfo,
+      properties.allocationSize,
+      ivkGetMemoryTypeIndex(vulkanMemoryProperties, properties.memoryTypeBits, 0)};
+
+  VK_ASSERT(vkAllocateMemory(device_, &memoryAllocateInfo, nullptr, &vkMemory_));
+  VK_ASSERT(vkBindImageMemory(device_, vkImage_, vkMemory_, 0));
+}
+#endif // IGL_PLATFORM_ANDROID && VK_ANDROID_external_memory_android_hardware_buffer
+
 #if IGL_PLATFORM_WIN
 VulkanImage::VulkanImage(const VulkanContext& ctx,
                          void* windowsHandle,
@@ -570,28 +775,224 @@ VulkanImage::VulkanImage(const VulkanContext& ctx,
 VulkanImage::~VulkanImage() {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_DESTROY);
 
+  const VkDeviceSize sparseMemoryBlocksSize =
+      sparseMemoryBlocks_.size() * kSparseTilesPerBlock * sparseMemoryRequirements_.alignment;
+  ctx_.imageMemoryBytes_ -= allocatedSize + sparseMemoryBlocksSize;
+
+  // the views have to be destroyed before the image
+  storageMipViews_.clear();
+
   if (!isExternallyManaged_) {
-    if (IGL_VULKAN_USE_VMA && !isImported_ && !isExported_) {
+    if (isSparse_) {
+      ctx_.deferredDestroy(VulkanContext::DestructionType::Image, (uint64_t)vkImage_);
+      for (VkDeviceMemory memory : sparseMipTailMemory_) {
+        ctx_.deferredDestroy(VulkanContext::DestructionType::Memory, (uint64_t)memory);
+      }
+      for (VkDeviceMemory memory : sparseMemoryBlocks_) {
+        ctx_.deferredDestroy(VulkanContext::DestructionType::Memory, (uint64_t)memory);
+      }
+    } else if (IGL_VULKAN_USE_VMA && !isImported_ && !isExported_) {
       if (mappedPtr_) {
         vmaUnmapMemory((VmaAllocator)ctx_.getVmaAllocator(), vmaAllocation_);
       }
-      ctx_.deferredTask(std::packaged_task<void()>(
-          [vma = ctx_.getVmaAllocator(), image = vkImage_, allocation = vmaAllocation_]() {
-            vmaDestroyImage((VmaAllocator)vma, image, allocation);
-          }));
+      ctx_.deferredDestroy(VulkanContext::DestructionType::VmaImage,
+                           (uint64_t)vkImage_,
+                           (uint64_t)(uintptr_t)vmaAllocation_);
     } else {
       if (mappedPtr_) {
         vkUnmapMemory(device_, vkMemory_);
       }
-      ctx_.deferredTask(
-          std::packaged_task<void()>([device = device_, image = vkImage_, memory = vkMemory_]() {
-            vkDestroyImage(device, image, nullptr);
-            if (memory != VK_NULL_HANDLE) {
-              vkFreeMemory(device, memory, nullptr);
+      ctx_.deferredDestroy(
+          VulkanContext::DestructionType::Image, (uint64_t)vkImage_, (uint64_t)vkMemory_);
+    }
+  }
+}
+
+void VulkanImage::initSparseResidency() {
+  vkGetImageMemoryRequirements(device_, vkImage_, &sparseMemoryRequirements_);
+
+  uint32_t numRequirements = 0;
+  vkGetImageSparseMemoryRequirements(device_, vkImage_, &numRequirements, nullptr);
+  std::vector<VkSparseImageMemoryRequirements> requirements(numRequirements);
+  vkGetImageSparseMemoryRequirements(device_, vkImage_, &numRequirements, requirements.data());
+
+  std::vector<VkSparseMemoryBind> binds;
+
+  for (const VkSparseImageMemoryRequirements& req : requirements) {
+    const bool isMetadata = (req.formatProperties.aspectMask & VK_IMAGE_ASPECT_METADATA_BIT) != 0;
+    if (req.formatProperties.aspectMask & VK_IMAGE_ASPECT_COLOR_BIT) {
+      sparseRequirements_ = req;
+    }
+    // metadata is always bound as a whole through the mip tail
+    if (!isMetadata && req.imageMipTailFirstLod >= mipLevels_) {
+      continue;
+    }
+    const bool isSingleMipTail =
+        (req.formatProperties.flags & VK_SPARSE_IMAGE_FORMAT_SINGLE_MIPTAIL_BIT) != 0;
+    const uint32_t numMipTails = isSingleMipTail ? 1u : arrayLayers_;
+
+    VkMemoryRequirements memRequirements = sparseMemoryRequirements_;
+    memRequirements.size = req.imageMipTailSize * numMipTails;
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VK_ASSERT(ivkAllocateMemory(physicalDevice_,
+                                device_,
+                                &memRequirements,
+                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                &memory));
+    sparseMipTailMemory_.push_back(memory);
+    allocatedSize += memRequirements.size;
+
+    for (uint32_t i = 0; i != numMipTails; i++) {
+      binds.push_back(VkSparseMemoryBind{
+          req.imageMipTailOffset + i * req.imageMipTailStride,
+          req.imageMipTailSize,
+          memory,
+          i * req.imageMipTailSize,
+          isMetadata ? VkSparseMemoryBindFlags(VK_SPARSE_MEMORY_BIND_METADATA_BIT) : 0u,
+      });
+    }
+  }
+
+  IGL_ASSERT_MSG(sparseRequirements_.formatProperties.aspectMask != 0,
+                 "The image does not support sparse residency of the color aspect");
+
+  if (binds.empty()) {
+    return;
+  }
+
+  const VkSparseImageOpaqueMemoryBindInfo opaqueBindInfo = {
+      vkImage_, (uint32_t)binds.size(), binds.data()};
+
+  VkBindSparseInfo bindInfo = {VK_STRUCTURE_TYPE_BIND_SPARSE_INFO};
+  bindInfo.imageOpaqueBindCount = 1;
+  bindInfo.pImageOpaqueBinds = &opaqueBindInfo;
+
+  ctx_.immediate_->bindSparse(bindInfo);
+}
+
+VkExtent3D VulkanImage::getSparseTileExtent() const {
+  return isSparse_ ? sparseRequirements_.formatProperties.imageGranularity : VkExtent3D{0, 0, 0};
+}
+
+Result VulkanImage::updateSparseTiles(uint32_t baseMipLevel,
+                                      uint32_t numMipLevels,
+                                      uint32_t baseLayer,
+                                      uint32_t numLayers,
+                                      VkOffset3D offset,
+                                      VkExtent3D extent,
+                                      bool commit) const {
+  IGL_PROFILER_FUNCTION();
+
+  if (!IGL_VERIFY(isSparse_)) {
+    return Result(Result::Code::ArgumentInvalid, "The image is not sparse");
+  }
+  if (!IGL_VERIFY(offset.x >= 0 && offset.y >= 0)) {
+    return Result(Result::Code::ArgumentOutOfRange, "The region is outside of the image");
+  }
+
+  const VkExtent3D tile = sparseRequirements_.formatProperties.imageGranularity;
+  const VkDeviceSize tileSize = sparseMemoryRequirements_.alignment;
+
+  // the mip tail is always resident
+  const uint32_t endMipLevel = std::min({baseMipLevel + numMipLevels,
+                                         mipLevels_,
+                                         sparseRequirements_.imageMipTailFirstLod});
+  const uint32_t endLayer = std::min(baseLayer + numLayers, arrayLayers_);
+
+  Result result;
+  std::vector<VkSparseImageMemoryBind> binds;
+
+  for (uint32_t mipLevel = baseMipLevel; mipLevel < endMipLevel && result.isOk(); mipLevel++) {
+    const uint32_t shift = mipLevel - baseMipLevel;
+    const uint32_t mipWidth = std::max(extent_.width >> mipLevel, 1u);
+    const uint32_t mipHeight = std::max(extent_.height >> mipLevel, 1u);
+
+    // the region is rounded out to whole tiles
+    const uint32_t beginX = (uint32_t(offset.x) >> shift) / tile.width;
+    const uint32_t beginY = (uint32_t(offset.y) >> shift) / tile.height;
+    const uint32_t endX = std::min(
+        divideRoundingUp(divideRoundingUp(uint32_t(offset.x) + extent.width, 1u << shift),
+                         tile.width),
+        divideRoundingUp(mipWidth, tile.width));
+    const uint32_t endY = std::min(
+        divideRoundingUp(divideRoundingUp(uint32_t(offset.y) + extent.height, 1u << shift),
+                         tile.height),
+        divideRoundingUp(mipHeight, tile.height));
+
+    for (uint32_t layer = baseLayer; layer < endLayer && result.isOk(); layer++) {
+      for (uint32_t y = beginY; y < endY && result.isOk(); y++) {
+        for (uint32_t x = beginX; x < endX; x++) {
+          const uint64_t key = getSparseTileKey(mipLevel, layer, x, y);
+          const auto it = sparseCommittedTiles_.find(key);
+
+          VkSparseImageMemoryBind bind = {
+              {VK_IMAGE_ASPECT_COLOR_BIT, mipLevel, layer},
+              {int32_t(x * tile.width), int32_t(y * tile.height), 0},
+              // tiles at the right and bottom edges of a mip level can be partial
+              {std::min(tile.width, mipWidth - x * tile.width),
+               std::min(tile.height, mipHeight - y * tile.height),
+               1u},
+              VK_NULL_HANDLE,
+              0,
+              0,
+          };
+
+          if (commit) {
+            if (it != sparseCommittedTiles_.end()) {
+              continue;
+            }
+            if (sparseFreeTiles_.empty()) {
+              VkMemoryRequirements memRequirements = sparseMemoryRequirements_;
+              memRequirements.size = tileSize * kSparseTilesPerBlock;
+              VkDeviceMemory memory = VK_NULL_HANDLE;
+              if (ivkAllocateMemory(physicalDevice_,
+                                    device_,
+                                    &memRequirements,
+                                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                    &memory) != VK_SUCCESS) {
+                result = Result(Result::Code::RuntimeError, "Cannot allocate sparse memory");
+                break;
+              }
+              const auto block = static_cast<uint32_t>(sparseMemoryBlocks_.size());
+              sparseMemoryBlocks_.push_back(memory);
+              for (uint32_t i = kSparseTilesPerBlock; i != 0; i--) {
+                sparseFreeTiles_.push_back(block * kSparseTilesPerBlock + i - 1);
+              }
+              ctx_.imageMemoryBytes_ += memRequirements.size;
             }
-          }));
+            const uint32_t memoryTile = sparseFreeTiles_.back();
+            sparseFreeTiles_.pop_back();
+            sparseCommittedTiles_[key] = memoryTile;
+            bind.memory = sparseMemoryBlocks_[memoryTile / kSparseTilesPerBlock];
+            bind.memoryOffset = (memoryTile % kSparseTilesPerBlock) * tileSize;
+          } else {
+            if (it == sparseCommittedTiles_.end()) {
+              continue;
+            }
+            // unbinding is queued before any later binding which reuses this memory
+            sparseFreeTiles_.push_back(it->second);
+            sparseCommittedTiles_.erase(it);
+          }
+          binds.push_back(bind);
+        }
+      }
     }
   }
+
+  // tiles committed before running out of memory are still bound
+  if (!binds.empty()) {
+    const VkSparseImageMemoryBindInfo imageBindInfo = {
+        vkImage_, (uint32_t)binds.size(), binds.data()};
+
+    VkBindSparseInfo bindInfo = {VK_STRUCTURE_TYPE_BIND_SPARSE_INFO};
+    bindInfo.imageBindCount = 1;
+    bindInfo.pImageBinds = &imageBindInfo;
+
+    ctx_.immediate_->bindSparse(bindInfo);
+  }
+
+  return result;
 }
 
 std::shared_ptr<VulkanImageView> VulkanImage::createImageView(VkImageViewType type,
@@ -622,86 +1023,143 @@ void VulkanImage::transitionLayout(VkCommandBuffer commandBuffer,
                                    const VkImageSubresourceRange& subresourceRange) const {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_TRANSITION);
 
-  VkAccessFlags srcAccessMask = 0;
-  VkAccessFlags dstAccessMask = 0;
+  transitionSubresources(
+      newImageLayout,
+      subresourceRange,
+      [&](VkImageLayout oldImageLayout, const VkImageSubresourceRange& range) {
+        VkAccessFlags srcAccessMask = 0;
+        VkAccessFlags dstAccessMask = 0;
+
+        getTransitionAccessMasks(
+            oldImageLayout, srcStageMask, dstStageMask, srcAccessMask, dstAccessMask);
+
+        ivkImageMemoryBarrier(commandBuffer,
+                              vkImage_,
+                              srcAccessMask,
+                              dstAccessMask,
+                              oldImageLayout,
+                              newImageLayout,
+                              srcStageMask,
+                              dstStageMask,
+                              range);
+      });
+}
 
-  if (imageLayout_ == VK_IMAGE_LAYOUT_UNDEFINED) {
-    // we do not need to wait for any previous operations in this case
-    srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-  }
+void VulkanImage::transitionLayout(VulkanBarrierBatch& batch,
+                                   VkImageLayout newImageLayout,
+                                   VkPipelineStageFlags srcStageMask,
+                                   VkPipelineStageFlags dstStageMask,
+                                   const VkImageSubresourceRange& subresourceRange) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_TRANSITION);
 
-  switch (srcStageMask) {
-  case VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT:
-  case VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT:
-  case VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT:
-  case VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT:
-  case VK_PIPELINE_STAGE_ALL_COMMANDS_BIT:
-  case VK_PIPELINE_STAGE_TRANSFER_BIT:
-  case VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT:
-    break;
-  default:
-    IGL_ASSERT_MSG(
-        false, "Automatic access mask deduction is not implemented (yet) for this srcStageMask");
-    break;
-  }
+  transitionSubresources(
+      newImageLayout,
+      subresourceRange,
+      [&](VkImageLayout oldImageLayout, const VkImageSubresourceRange& range) {
+        // reads after reads do not need any synchronization
+        if (oldImageLayout == newImageLayout && isReadOnlyLayout(newImageLayout)) {
+          return;
+        }
 
-  // once you want to add a new pipeline stage to this block of if's, don't forget to add it to the
-  // switch() statement above
-  if (srcStageMask & VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT) {
-    srcAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-  }
-  if (srcStageMask & VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT) {
-    srcAccessMask |= VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-  }
-  if (srcStageMask & VK_PIPELINE_STAGE_TRANSFER_BIT) {
-    srcAccessMask |= VK_ACCESS_TRANSFER_WRITE_BIT;
-  }
-  if (srcStageMask & VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT) {
-    srcAccessMask |= VK_ACCESS_SHADER_WRITE_BIT;
-  }
+        VkAccessFlags srcAccessMask = 0;
+        VkAccessFlags dstAccessMask = 0;
+
+        getTransitionAccessMasks(
+            oldImageLayout, srcStageMask, dstStageMask, srcAccessMask, dstAccessMask);
+
+        batch.imageBarrier(vkImage_,
+                           srcAccessMask,
+                           dstAccessMask,
+                           oldImageLayout,
+                           newImageLayout,
+                           srcStageMask,
+                           dstStageMask,
+                           range);
+      });
+}
 
-  switch (dstStageMask) {
-  case VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT:
-  case VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT:
-  case VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT:
-  case VK_PIPELINE_STAGE_TRANSFER_BIT:
-  case VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT:
-  case VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT:
-    break;
-  default:
-    IGL_ASSERT_MSG(
-        false, "Automatic access mask deduction is not implemented (yet) for this dstStageMask");
-    break;
+void VulkanImage::transitionSubresources(
+    VkImageLayout newImageLayout,
+    const VkImageSubresourceRange& subresourceRange,
+    const std::function<void(VkImageLayout oldImageLayout, const VkImageSubresourceRange& range)>&
+        barrier) const {
+  if (subresourceLayouts_.empty()) {
+    barrier(imageLayout_, subresourceRange);
+  } else {
+    const uint32_t baseLevel = subresourceRange.baseMipLevel;
+    const uint32_t endLevel = subresourceRange.levelCount == VK_REMAINING_MIP_LEVELS
+                                  ? mipLevels_
+                                  : baseLevel + subresourceRange.levelCount;
+    const uint32_t endLayer = subresourceRange.layerCount == VK_REMAINING_ARRAY_LAYERS
+                                  ? arrayLayers_
+                                  : subresourceRange.baseArrayLayer + subresourceRange.layerCount;
+    IGL_ASSERT(endLevel <= mipLevels_ && endLayer <= arrayLayers_);
+
+    for (uint32_t layer = subresourceRange.baseArrayLayer; layer < endLayer; layer++) {
+      uint32_t firstLevel = baseLevel;
+      for (uint32_t level = baseLevel + 1; level <= endLevel; level++) {
+        const VkImageLayout layout = getImageLayout(firstLevel, layer);
+        if (level == endLevel || getImageLayout(level, layer) != layout) {
+          barrier(layout,
+                  VkImageSubresourceRange{
+                      subresourceRange.aspectMask, firstLevel, level - firstLevel, layer, 1});
+          firstLevel = level;
+        }
+      }
+    }
   }
 
-  // once you want to add a new pipeline stage to this block of if's, don't forget to add it to the
-  // switch() statement above
-  if (dstStageMask & VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT) {
-    dstAccessMask |= VK_ACCESS_SHADER_READ_BIT;
-    dstAccessMask |= VK_ACCESS_SHADER_WRITE_BIT;
-  }
-  if (dstStageMask & VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT) {
-    dstAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+  if (!isAttachmentLayout(newImageLayout)) {
+    isStoredUnread_ = false;
   }
-  if (dstStageMask & VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT) {
-    dstAccessMask |= VK_ACCESS_SHADER_READ_BIT;
-    dstAccessMask |= VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+  setImageLayout(newImageLayout, subresourceRange);
+}
+
+VkImageLayout VulkanImage::getImageLayout(uint32_t level, uint32_t layer) const {
+  IGL_ASSERT(level < mipLevels_ && layer < arrayLayers_);
+
+  return subresourceLayouts_.empty() ? imageLayout_
+                                     : subresourceLayouts_[layer * mipLevels_ + level];
+}
+
+void VulkanImage::setImageLayout(VkImageLayout newImageLayout,
+                                 const VkImageSubresourceRange& subresourceRange) const {
+  const uint32_t baseLevel = subresourceRange.baseMipLevel;
+  const uint32_t baseLayer = subresourceRange.baseArrayLayer;
+  const uint32_t numLevels = subresourceRange.levelCount == VK_REMAINING_MIP_LEVELS
+                                 ? mipLevels_ - baseLevel
+                                 : subresourceRange.levelCount;
+  const uint32_t numLayers = subresourceRange.layerCount == VK_REMAINING_ARRAY_LAYERS
+                                 ? arrayLayers_ - baseLayer
+                                 : subresourceRange.layerCount;
+  IGL_ASSERT(baseLevel + numLevels <= mipLevels_ && baseLayer + numLayers <= arrayLayers_);
+
+  if (numLevels == mipLevels_ && numLayers == arrayLayers_) {
+    subresourceLayouts_.clear();
+    imageLayout_ = newImageLayout;
+    return;
   }
-  if (dstStageMask & VK_PIPELINE_STAGE_TRANSFER_BIT) {
-    dstAccessMask |= VK_ACCESS_TRANSFER_READ_BIT;
+
+  if (subresourceLayouts_.empty()) {
+    if (imageLayout_ == newImageLayout) {
+      return;
+    }
+    subresourceLayouts_.resize(size_t(mipLevels_) * arrayLayers_, imageLayout_);
   }
 
-  ivkImageMemoryBarrier(commandBuffer,
-                        vkImage_,
-                        srcAccessMask,
-                        dstAccessMask,
-                        imageLayout_,
-                        newImageLayout,
-                        srcStageMask,
-                        dstStageMask,
-                        subresourceRange);
+  for (uint32_t layer = baseLayer; layer != baseLayer + numLayers; layer++) {
+    auto it = subresourceLayouts_.begin() + layer * mipLevels_ + baseLevel;
+    std::fill(it, it + numLevels, newImageLayout);
+  }
 
   imageLayout_ = newImageLayout;
+
+  // go back to tracking the whole image once all subresources are in the same layout again
+  if (std::all_of(subresourceLayouts_.begin(),
+                  subresourceLayouts_.end(),
+                  [newImageLayout](VkImageLayout layout) { return layout == newImageLayout; })) {
+    subresourceLayouts_.clear();
+  }
 }
 
 VkImageAspectFlags VulkanImage::getImageAspectFlags() const {
@@ -848,7 +1306,8 @@ void VulkanImage::generateMipmap(VkCommandBuffer commandBuffer) const {
                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, // dstStageMask
                         VkImageSubresourceRange{imageAspectFlags, 0, mipLevels_, 0, arrayLayers_});
 
-  imageLayout_ = originalImageLayout;
+  setImageLayout(originalImageLayout,
+                 VkImageSubresourceRange{imageAspectFlags, 0, mipLevels_, 0, arrayLayers_});
 }
 
 bool VulkanImage::isDepthFormat(VkFormat format) {
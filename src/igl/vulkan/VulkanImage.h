@@ -7,7 +7,9 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include <igl/vulkan/Common.h>
@@ -16,6 +18,7 @@
 namespace igl {
 namespace vulkan {
 
+class VulkanBarrierBatch;
 class VulkanContext;
 class VulkanImageView;
 
@@ -105,6 +108,29 @@ class VulkanImage final {
               VkSampleCountFlagBits samples,
               const char* debugName = nullptr);
 
+#if IGL_PLATFORM_ANDROID && defined(VK_ANDROID_external_memory_android_hardware_buffer)
+  /**
+   * @brief Constructs a `VulkanImage` object and a 2D `VkImage` object bound to the memory of an
+   * Android hardware buffer, i.e. the pixels are not copied. `properties` are the properties of
+   * the buffer returned by `vkGetAndroidHardwareBufferPropertiesANDROID()`.
+   *
+   * This constructor does not support VMA. The imported memory holds a reference to the buffer
+   * until the object's destruction.
+   *
+   * `format` must be the format of the buffer. External formats, e.g. YUV formats only described
+   * by `VkAndroidHardwareBufferFormatPropertiesANDROID::externalFormat`, are not supported.
+   */
+  VulkanImage(const VulkanContext& ctx,
+              AHardwareBuffer* hardwareBuffer,
+              const VkAndroidHardwareBufferPropertiesANDROID& properties,
+              VkDevice device,
+              VkExtent3D extent,
+              VkFormat format,
+              uint32_t arrayLayers,
+              VkImageUsageFlags usageFlags,
+              const char* debugName = nullptr);
+#endif // IGL_PLATFORM_ANDROID && VK_ANDROID_external_memory_android_hardware_buffer
+
 #if IGL_PLATFORM_WIN
   /**
    * @brief Creates a `VulkanImage` with memory imported from a Windows handle.
@@ -194,6 +220,9 @@ class VulkanImage final {
    * The source and destination access masks for the transition are automatically deduced based on
    * the `srcStageMask` and the `dstStageMask` parameters. Not not all `VkPipelineStageFlags` are
    * supported.
+   *
+   * Only the subresources in `subresourceRange` change their layout. If they are not all in the
+   * same layout, one barrier is recorded per run of mip-levels of a layer sharing the same layout.
    */
   void transitionLayout(VkCommandBuffer commandBuffer,
                         VkImageLayout newImageLayout,
@@ -201,8 +230,56 @@ class VulkanImage final {
                         VkPipelineStageFlags dstStageMask,
                         const VkImageSubresourceRange& subresourceRange) const;
 
+  /**
+   * @brief Same as above but appends the Image Memory Barrier to `batch` instead of recording it.
+   * Transitions between identical read-only layouts are skipped.
+   */
+  void transitionLayout(VulkanBarrierBatch& batch,
+                        VkImageLayout newImageLayout,
+                        VkPipelineStageFlags srcStageMask,
+                        VkPipelineStageFlags dstStageMask,
+                        const VkImageSubresourceRange& subresourceRange) const;
+
+  /**
+   * @brief Returns the current layout of a single mip-level of a layer. `imageLayout_` is the
+   * layout of all subresources unless some of them were transitioned separately.
+   */
+  VkImageLayout getImageLayout(uint32_t level, uint32_t layer) const;
+
+  /**
+   * @brief Sets the tracked layout of the subresources in `subresourceRange` without recording any
+   * barriers. Used after layout changes done outside of transitionLayout(), e.g. by render passes.
+   */
+  void setImageLayout(VkImageLayout newImageLayout,
+                      const VkImageSubresourceRange& subresourceRange) const;
+
   VkImageAspectFlags getImageAspectFlags() const;
 
+  bool isSparse() const {
+    return isSparse_;
+  }
+
+  /**
+   * @brief Returns the size of a tile of a sparse image, in texels. Returns a zero extent if the
+   * image is not sparse.
+   */
+  VkExtent3D getSparseTileExtent() const;
+
+  /**
+   * @brief Binds (`commit` is true) or unbinds device memory to all tiles of a sparse image which
+   * intersect the region. `offset` and `extent` are specified for `baseMipLevel` and scaled down
+   * for the other mip levels. Levels which belong to the mip tail are always resident and skipped.
+   *
+   * The memory of decommitted tiles is reused by later commits and released on destruction.
+   */
+  Result updateSparseTiles(uint32_t baseMipLevel,
+                           uint32_t numMipLevels,
+                           uint32_t baseLayer,
+                           uint32_t numLayers,
+                           VkOffset3D offset,
+                           VkExtent3D extent,
+                           bool commit) const;
+
   static bool isDepthFormat(VkFormat format);
   static bool isStencilFormat(VkFormat format);
 
@@ -215,6 +292,8 @@ class VulkanImage final {
   VkDeviceMemory vkMemory_ = VK_NULL_HANDLE;
   VmaAllocationCreateInfo vmaAllocInfo_ = {};
   VmaAllocation vmaAllocation_ = VK_NULL_HANDLE;
+  // kept to create an identical VkImage when the allocation is moved by VulkanDefragmenter
+  VkImageCreateInfo vkImageCreateInfo_ = {};
   VkFormatProperties formatProperties_{};
   void* mappedPtr_ = nullptr;
   bool isExternallyManaged_ = false;
@@ -228,11 +307,23 @@ class VulkanImage final {
   bool isStencilFormat_ = false;
   bool isDepthOrStencilFormat_ = false;
   VkDeviceSize allocatedSize = 0;
-  mutable VkImageLayout imageLayout_ = VK_IMAGE_LAYOUT_UNDEFINED; // current image layout
+  // current layout of the whole image, or the layout most recently set for some of its subresources
+  mutable VkImageLayout imageLayout_ = VK_IMAGE_LAYOUT_UNDEFINED;
+  // layouts of individual subresources (`layer * mipLevels_ + level`); empty while all of them are
+  // in `imageLayout_`
+  mutable std::vector<VkImageLayout> subresourceLayouts_;
+  // stored by a render pass and not transitioned to any non-attachment layout since
+  mutable bool isStoredUnread_ = false;
+  // aliased by texture views (IDevice::createTextureView), which keep views of this VkImage
+  mutable bool hasTextureViews_ = false;
+  // single-level storage views used by VulkanMipmapGenerator, created on demand
+  mutable std::vector<std::shared_ptr<VulkanImageView>> storageMipViews_;
   bool isImported_ = false;
   bool isExported_ = false;
   void* exportedMemoryHandle_ = nullptr; // windows handle
   int exportedFd_ = -1; // linux fd
+  // created with VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT, memory is bound by updateSparseTiles()
+  bool isSparse_ = false;
 
  private:
 #if IGL_PLATFORM_WIN || IGL_PLATFORM_LINUX || IGL_PLATFORM_ANDROID
@@ -269,6 +360,32 @@ class VulkanImage final {
               const VkExportMemoryAllocateInfoKHR& externalMemoryAllocateInfo,
               const char* debugName);
 #endif // IGL_PLATFORM_WIN || IGL_PLATFORM_LINUX || IGL_PLATFORM_ANDROID
+
+  // queries the sparse memory requirements of the image and binds memory to its mip tails
+  void initSparseResidency();
+
+  // calls `barrier` for every run of mip-levels of a layer in `subresourceRange` which are in the
+  // same layout, then sets their layout to `newImageLayout`
+  void transitionSubresources(
+      VkImageLayout newImageLayout,
+      const VkImageSubresourceRange& subresourceRange,
+      const std::function<void(VkImageLayout oldImageLayout, const VkImageSubresourceRange& range)>&
+          barrier) const;
+
+  // tiles of sparse images are sub-allocated from blocks of this many tiles
+  static constexpr uint32_t kSparseTilesPerBlock = 64;
+  // the color aspect requirements, the tile size is `sparseRequirements_.formatProperties`
+  VkSparseImageMemoryRequirements sparseRequirements_ = {};
+  // memory requirements of the whole image, `alignment` is the size of a tile in bytes
+  VkMemoryRequirements sparseMemoryRequirements_ = {};
+  // memory bound to the mip tails, released on destruction
+  std::vector<VkDeviceMemory> sparseMipTailMemory_;
+  mutable std::vector<VkDeviceMemory> sparseMemoryBlocks_;
+  // free tiles in `sparseMemoryBlocks_` (block * kSparseTilesPerBlock + index in the block)
+  mutable std::vector<uint32_t> sparseFreeTiles_;
+  // committed tiles (mip level, layer and tile coordinates packed into 64 bits) and their memory
+  // in `sparseMemoryBlocks_`
+  mutable std::unordered_map<uint64_t, uint32_t> sparseCommittedTiles_;
 };
 
 } // namespace vulkan
@@ -25,16 +25,14 @@ VulkanImageView::VulkanImageView(const VulkanContext& ctx,
                                  uint32_t baseLayer,
                                  uint32_t numLayers,
                                  const char* debugName) :
-  ctx_(ctx), device_(device) {
+  ctx_(ctx),
+  device_(device),
+  type_(type),
+  format_(format),
+  range_{aspectMask, baseLevel, numLevels, baseLayer, numLayers} {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
 
-  VK_ASSERT(ivkCreateImageView(
-      device_,
-      image,
-      type,
-      format,
-      VkImageSubresourceRange{aspectMask, baseLevel, numLevels, baseLayer, numLayers},
-      &vkImageView_));
+  VK_ASSERT(ivkCreateImageView(device_, image, type_, format_, range_, &vkImageView_));
 
   VK_ASSERT(
       ivkSetDebugObjectName(device_, VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)vkImageView_, debugName));
@@ -43,9 +41,16 @@ VulkanImageView::VulkanImageView(const VulkanContext& ctx,
 VulkanImageView::~VulkanImageView() {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_DESTROY);
 
-  ctx_.deferredTask(std::packaged_task<void()>([device = device_, imageView = vkImageView_]() {
-    vkDestroyImageView(device, imageView, nullptr);
-  }));
+  ctx_.deferredDestroy(VulkanContext::DestructionType::ImageView, (uint64_t)vkImageView_);
+}
+
+void VulkanImageView::recreate(VkImage image) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  ctx_.deferredDestroy(VulkanContext::DestructionType::ImageView, (uint64_t)vkImageView_);
+
+  vkImageView_ = VK_NULL_HANDLE;
+  VK_ASSERT(ivkCreateImageView(device_, image, type_, format_, range_, &vkImageView_));
 }
 
 } // namespace vulkan
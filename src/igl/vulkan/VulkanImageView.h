@@ -51,10 +51,19 @@ class VulkanImageView final {
     return vkImageView_;
   }
 
+  /**
+   * @brief Replaces the imageView with an identical one of another image, used when the memory of
+   * the image is moved. The old imageView is destroyed once the GPU is done with it
+   */
+  void recreate(VkImage image);
+
  public:
   const VulkanContext& ctx_;
   VkDevice device_ = VK_NULL_HANDLE;
   VkImageView vkImageView_ = VK_NULL_HANDLE;
+  VkImageViewType type_ = VK_IMAGE_VIEW_TYPE_MAX_ENUM;
+  VkFormat format_ = VK_FORMAT_UNDEFINED;
+  VkImageSubresourceRange range_ = {};
 };
 
 } // namespace vulkan
@@ -7,6 +7,7 @@
 
 #include "VulkanImmediateCommands.h"
 
+#include <algorithm>
 #include <igl/vulkan/Common.h>
 #include <utility>
 
@@ -15,28 +16,29 @@ namespace vulkan {
 
 VulkanImmediateCommands::VulkanImmediateCommands(VkDevice device,
                                                  uint32_t queueFamilyIndex,
-                                                 const char* debugName) :
+                                                 const char* debugName,
+                                                 uint32_t queueIndex,
+                                                 bool useTimelineSemaphore,
+                                                 uint32_t maxCommandBuffers) :
   device_(device),
   commandPool_(device_,
                VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT |
                    VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
                queueFamilyIndex,
                debugName),
-  debugName_(debugName) {
+  debugName_(debugName),
+  maxCommandBuffers_(std::max(maxCommandBuffers, kNumInitialCommandBuffers)) {
   IGL_PROFILER_FUNCTION();
 
-  vkGetDeviceQueue(device, queueFamilyIndex, 0, &queue_);
+  vkGetDeviceQueue(device, queueFamilyIndex, queueIndex, &queue_);
 
-  buffers_.reserve(kMaxCommandBuffers);
+  for (uint32_t i = 0; i != kNumInitialCommandBuffers; i++) {
+    addCommandBuffer();
+  }
 
-  for (uint32_t i = 0; i != kMaxCommandBuffers; i++) {
-    buffers_.emplace_back(
-        VulkanFence(
-            device_, VkFenceCreateFlagBits{}, IGL_FORMAT("Fence: commandBuffer #{}", i).c_str()),
-        VulkanSemaphore(device, IGL_FORMAT("Semaphore: {} ({})", debugName, i).c_str()));
-    VK_ASSERT(ivkAllocateCommandBuffer(
-        device_, commandPool_.getVkCommandPool(), &buffers_[i].cmdBufAllocated_));
-    buffers_[i].handle_.bufferIndex_ = i;
+  if (useTimelineSemaphore) {
+    timelineSemaphore_ = std::make_unique<VulkanSemaphore>(
+        device, 0u, IGL_FORMAT("Timeline semaphore: {}", debugName).c_str());
   }
 }
 
@@ -44,19 +46,53 @@ VulkanImmediateCommands::~VulkanImmediateCommands() {
   waitAll();
 }
 
+void VulkanImmediateCommands::addCommandBuffer() {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  const auto i = static_cast<uint32_t>(buffers_.size());
+
+  buffers_.emplace_back(
+      VulkanFence(
+          device_, VkFenceCreateFlagBits{}, IGL_FORMAT("Fence: commandBuffer #{}", i).c_str()),
+      VulkanSemaphore(device_, IGL_FORMAT("Semaphore: {} ({})", debugName_, i).c_str()));
+  VK_ASSERT(ivkAllocateCommandBuffer(
+      device_, commandPool_.getVkCommandPool(), &buffers_[i].cmdBufAllocated_));
+  buffers_[i].handle_.bufferIndex_ = i;
+  numAvailableCommandBuffers_++;
+}
+
 void VulkanImmediateCommands::purge() {
   IGL_PROFILER_FUNCTION();
 
+  // one counter read for all buffers instead of polling every fence
+  const uint64_t completedValue = timelineSemaphore_ ? getCompletedTimelineValue() : 0;
+
   for (auto& buf : buffers_) {
     if (buf.cmdBuf_ == VK_NULL_HANDLE || buf.isEncoding_) {
       continue;
     }
 
-    const VkResult result = vkWaitForFences(device_, 1, &buf.fence_.vkFence_, VK_TRUE, 0);
+    if (timelineSemaphore_ && buf.signalValue_ > completedValue) {
+      continue;
+    }
+
+    if (!buf.hasFence_) {
+      // a deferred submit which was not the last one of its batch, the timeline value is enough
+      VK_ASSERT(vkResetCommandBuffer(buf.cmdBuf_, VkCommandBufferResetFlags{0}));
+      buf.cmdBuf_ = VK_NULL_HANDLE;
+      numAvailableCommandBuffers_++;
+      continue;
+    }
+
+    // The fence is still signaled by every submit (see getVkFenceFromSubmitHandle()) and has to be
+    // reset. Once the timeline value is reached, this wait returns right away
+    const VkResult result = vkWaitForFences(
+        device_, 1, &buf.fence_.vkFence_, VK_TRUE, timelineSemaphore_ ? UINT64_MAX : 0);
 
     if (result == VK_SUCCESS) {
       VK_ASSERT(vkResetCommandBuffer(buf.cmdBuf_, VkCommandBufferResetFlags{0}));
       VK_ASSERT(vkResetFences(device_, 1, &buf.fence_.vkFence_));
+      buf.hasFence_ = false;
       buf.cmdBuf_ = VK_NULL_HANDLE;
       numAvailableCommandBuffers_++;
     } else {
@@ -74,10 +110,26 @@ const VulkanImmediateCommands::CommandBufferWrapper& VulkanImmediateCommands::ac
     purge();
   }
 
-  while (!numAvailableCommandBuffers_) {
+  if (!numAvailableCommandBuffers_ && buffers_.size() < maxCommandBuffers_) {
+    addCommandBuffer();
+#if IGL_DEBUG
+    IGL_LOG_INFO("%s: allocated command buffer #%u\n",
+                 debugName_.c_str(),
+                 static_cast<uint32_t>(buffers_.size()));
+#endif // IGL_DEBUG
+  }
+
+  if (!numAvailableCommandBuffers_) {
     IGL_LOG_INFO("Waiting for command buffers...\n");
     IGL_PROFILER_ZONE("Waiting for command buffers...", IGL_PROFILER_COLOR_WAIT);
-    purge();
+    const auto start = std::chrono::steady_clock::now();
+    while (!numAvailableCommandBuffers_) {
+      waitForAnyCommandBuffer();
+      purge();
+    }
+    acquireStats_.numWaits++;
+    acquireStats_.waitTime += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
     IGL_PROFILER_ZONE_END();
   }
 
@@ -119,8 +171,16 @@ void VulkanImmediateCommands::wait(const SubmitHandle handle) {
     return;
   }
 
-  VK_ASSERT(vkWaitForFences(
-      device_, 1, &buffers_[handle.bufferIndex_].fence_.vkFence_, VK_TRUE, UINT64_MAX));
+  if (buffers_[handle.bufferIndex_].isPending_) {
+    flush();
+  }
+
+  if (timelineSemaphore_) {
+    waitTimelineValue(buffers_[handle.bufferIndex_].signalValue_);
+  } else {
+    VK_ASSERT(vkWaitForFences(
+        device_, 1, &buffers_[handle.bufferIndex_].fence_.vkFence_, VK_TRUE, UINT64_MAX));
+  }
 
   purge();
 }
@@ -128,26 +188,71 @@ void VulkanImmediateCommands::wait(const SubmitHandle handle) {
 void VulkanImmediateCommands::waitAll() {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
 
-  // @lint-ignore CLANGTIDY
-  VkFence fences[kMaxCommandBuffers];
+  flush();
 
-  uint32_t numFences = 0;
+  if (timelineSemaphore_) {
+    waitTimelineValue(lastSignalValue_);
+    purge();
+    return;
+  }
+
+  std::vector<VkFence> fences;
+  fences.reserve(buffers_.size());
 
   for (const auto& buf : buffers_) {
     if (buf.cmdBuf_ != VK_NULL_HANDLE && !buf.isEncoding_) {
-      fences[numFences++] = buf.fence_.vkFence_;
+      fences.push_back(buf.fence_.vkFence_);
     }
   }
 
-  if (numFences) {
-    VK_ASSERT(vkWaitForFences(device_, numFences, fences, VK_TRUE, UINT64_MAX));
+  if (!fences.empty()) {
+    VK_ASSERT(vkWaitForFences(
+        device_, static_cast<uint32_t>(fences.size()), fences.data(), VK_TRUE, UINT64_MAX));
   }
 
   purge();
 }
 
+void VulkanImmediateCommands::waitForAnyCommandBuffer() {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
+
+  flush();
+
+  if (timelineSemaphore_) {
+    // the oldest submit completes first, and deferred submits may not have a fence to wait for
+    uint64_t oldestValue = UINT64_MAX;
+    for (const auto& buf : buffers_) {
+      if (buf.cmdBuf_ != VK_NULL_HANDLE && !buf.isEncoding_) {
+        oldestValue = std::min(oldestValue, buf.signalValue_);
+      }
+    }
+    IGL_ASSERT_MSG(oldestValue != UINT64_MAX, "All command buffers are being encoded");
+    if (oldestValue != UINT64_MAX) {
+      waitTimelineValue(oldestValue);
+    }
+    return;
+  }
+
+  std::vector<VkFence> fences;
+  fences.reserve(buffers_.size());
+
+  for (const auto& buf : buffers_) {
+    if (buf.cmdBuf_ != VK_NULL_HANDLE && !buf.isEncoding_) {
+      fences.push_back(buf.fence_.vkFence_);
+    }
+  }
+
+  // if every buffer is still being encoded, there is nothing to wait for and purge() will spin
+  IGL_ASSERT_MSG(!fences.empty(), "All command buffers are being encoded");
+
+  if (!fences.empty()) {
+    VK_ASSERT(vkWaitForFences(
+        device_, static_cast<uint32_t>(fences.size()), fences.data(), VK_FALSE, UINT64_MAX));
+  }
+}
+
 bool VulkanImmediateCommands::isReady(const SubmitHandle handle, bool fastCheckNoVulkan) const {
-  IGL_ASSERT(handle.bufferIndex_ < kMaxCommandBuffers);
+  IGL_ASSERT(handle.bufferIndex_ < buffers_.size());
 
   if (handle.empty()) {
     // a null handle
@@ -166,6 +271,15 @@ bool VulkanImmediateCommands::isReady(const SubmitHandle handle, bool fastCheckN
     return true;
   }
 
+  if (timelineSemaphore_) {
+    if (buf.isEncoding_) {
+      return false;
+    }
+    // reading the counter is cheap, so it is done even for `fastCheckNoVulkan`
+    return buf.signalValue_ <= completedTimelineValue_ ||
+           buf.signalValue_ <= getCompletedTimelineValue();
+  }
+
   if (fastCheckNoVulkan) {
     // do not ask the Vulkan API about it, just let it retire naturally (when submitId for this
     // bufferIndex gets incremented)
@@ -181,39 +295,51 @@ VulkanImmediateCommands::SubmitHandle VulkanImmediateCommands::submit(
   IGL_ASSERT(wrapper.isEncoding_);
   VK_ASSERT(ivkEndCommandBuffer(wrapper.cmdBuf_));
 
-  // @lint-ignore CLANGTIDY
-  const VkPipelineStageFlags waitStageMasks[] = {VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT};
-  // @lint-ignore CLANGTIDY
-  VkSemaphore waitSemaphores[] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
-  uint32_t numWaitSemaphores = 0;
+  auto& mutableWrapper = const_cast<CommandBufferWrapper&>(wrapper);
+
+  SubmitInfo info;
+  info.cmdBuf = wrapper.cmdBuf_;
+  info.wrapper = &mutableWrapper;
+  info.waitStageMasks.fill(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
   if (waitSemaphore_) {
-    waitSemaphores[numWaitSemaphores++] = waitSemaphore_;
+    info.waitSemaphores[info.numWaitSemaphores++] = waitSemaphore_;
   }
   if (lastSubmitSemaphore_) {
-    waitSemaphores[numWaitSemaphores++] = lastSubmitSemaphore_;
+    info.waitSemaphores[info.numWaitSemaphores++] = lastSubmitSemaphore_;
+  }
+  if (waitTimelineSemaphore_) {
+    info.waitValues[info.numWaitSemaphores] = waitTimelineValue_;
+    info.waitStageMasks[info.numWaitSemaphores] = waitTimelineStageMask_;
+    info.waitSemaphores[info.numWaitSemaphores++] = waitTimelineSemaphore_;
   }
 
-  const VkSubmitInfo si = ivkGetSubmitInfo(&wrapper.cmdBuf_,
-                                           numWaitSemaphores,
-                                           waitSemaphores,
-                                           waitStageMasks,
-                                           &wrapper.semaphore_.vkSemaphore_);
-  // @lint-ignore CLANGTIDY
-  const VkFence vkFence = wrapper.fence_.vkFence_;
-  IGL_PROFILER_ZONE("vkQueueSubmit()", IGL_PROFILER_COLOR_SUBMIT);
-#if IGL_VULKAN_PRINT_COMMANDS
-  IGL_LOG_INFO("%p vkQueueSubmit()\n\n", wrapper.cmdBuf_);
-#endif // IGL_VULKAN_PRINT_COMMANDS
-  VK_ASSERT(vkQueueSubmit(queue_, 1u, &si, vkFence));
-  IGL_PROFILER_ZONE_END();
+  info.signalSemaphores[info.numSignalSemaphores++] = wrapper.semaphore_.vkSemaphore_;
+  if (timelineSemaphore_) {
+    mutableWrapper.signalValue_ = ++lastSignalValue_;
+    info.signalValues[info.numSignalSemaphores] = lastSignalValue_;
+    info.signalSemaphores[info.numSignalSemaphores++] = timelineSemaphore_->vkSemaphore_;
+  }
+  info.hasTimelineSemaphores = timelineSemaphore_ || waitTimelineSemaphore_;
+
+  if (submitBatch_) {
+    // the fence is signaled only if this ends up being the last command buffer of the batch
+    mutableWrapper.isPending_ = true;
+    mutableWrapper.hasFence_ = false;
+    submitBatch_->add(info);
+  } else {
+    mutableWrapper.hasFence_ = true;
+    queueSubmit(queue_, &info, 1u, wrapper.fence_.vkFence_);
+  }
 
   lastSubmitSemaphore_ = wrapper.semaphore_.vkSemaphore_;
   lastSubmitHandle_ = wrapper.handle_;
   waitSemaphore_ = VK_NULL_HANDLE;
+  waitTimelineSemaphore_ = VK_NULL_HANDLE;
+  waitTimelineValue_ = 0;
+  waitTimelineStageMask_ = 0;
 
   // reset
-  const_cast<CommandBufferWrapper&>(wrapper).isEncoding_ = false;
+  mutableWrapper.isEncoding_ = false;
   submitCounter_++;
 
   if (!submitCounter_) {
@@ -224,13 +350,151 @@ VulkanImmediateCommands::SubmitHandle VulkanImmediateCommands::submit(
   return lastSubmitHandle_;
 }
 
+void VulkanImmediateCommands::queueSubmit(VkQueue queue,
+                                          const SubmitInfo* infos,
+                                          uint32_t count,
+                                          VkFence fence) {
+  std::vector<VkSubmitInfo> submitInfos;
+  std::vector<VkTimelineSemaphoreSubmitInfoKHR> timelineInfos;
+  submitInfos.reserve(count);
+  // reserved upfront, so the pNext pointers stay valid
+  timelineInfos.reserve(count);
+
+  for (uint32_t i = 0; i != count; i++) {
+    const SubmitInfo& info = infos[i];
+    VkSubmitInfo si = ivkGetSubmitInfo(&info.cmdBuf,
+                                       info.numWaitSemaphores,
+                                       info.waitSemaphores.data(),
+                                       info.waitStageMasks.data(),
+                                       info.signalSemaphores.data());
+    si.signalSemaphoreCount = info.numSignalSemaphores;
+    if (info.hasTimelineSemaphores) {
+      timelineInfos.push_back({
+          VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR,
+          nullptr,
+          info.numWaitSemaphores,
+          info.waitValues.data(),
+          info.numSignalSemaphores,
+          info.signalValues.data(),
+      });
+      si.pNext = &timelineInfos.back();
+    }
+    submitInfos.push_back(si);
+#if IGL_VULKAN_PRINT_COMMANDS
+    IGL_LOG_INFO("%p vkQueueSubmit()\n\n", info.cmdBuf);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+  }
+
+  IGL_PROFILER_ZONE("vkQueueSubmit()", IGL_PROFILER_COLOR_SUBMIT);
+  VK_ASSERT(vkQueueSubmit(queue, count, submitInfos.data(), fence));
+  IGL_PROFILER_ZONE_END();
+}
+
+void VulkanImmediateCommands::SubmitBatch::flush() {
+  if (submits_.empty()) {
+    return;
+  }
+
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_SUBMIT);
+
+  CommandBufferWrapper* last = submits_.back().wrapper;
+  last->hasFence_ = true;
+  queueSubmit(
+      queue_, submits_.data(), static_cast<uint32_t>(submits_.size()), last->fence_.vkFence_);
+
+  for (const auto& info : submits_) {
+    info.wrapper->isPending_ = false;
+  }
+  IGL_PROFILER_PLOT("IGL command buffers per vkQueueSubmit", submits_.size());
+  submits_.clear();
+}
+
+void VulkanImmediateCommands::setSubmitBatch(std::shared_ptr<SubmitBatch> batch) {
+  IGL_ASSERT_MSG(!batch || timelineSemaphore_, "Deferred submits require timeline semaphores");
+  IGL_ASSERT(!batch || batch->getVkQueue() == queue_);
+
+  flush();
+  submitBatch_ = timelineSemaphore_ ? std::move(batch) : nullptr;
+}
+
+void VulkanImmediateCommands::flush() {
+  if (submitBatch_) {
+    submitBatch_->flush();
+  }
+}
+
 void VulkanImmediateCommands::waitSemaphore(VkSemaphore semaphore) {
   IGL_ASSERT(waitSemaphore_ == VK_NULL_HANDLE);
 
   waitSemaphore_ = semaphore;
 }
 
+void VulkanImmediateCommands::waitTimelineSemaphore(VkSemaphore semaphore,
+                                                    uint64_t value,
+                                                    VkPipelineStageFlags dstStageMask) {
+  IGL_ASSERT(waitTimelineSemaphore_ == VK_NULL_HANDLE || waitTimelineSemaphore_ == semaphore);
+
+  waitTimelineSemaphore_ = semaphore;
+  waitTimelineValue_ = std::max(waitTimelineValue_, value);
+  waitTimelineStageMask_ |= dstStageMask;
+}
+
+void VulkanImmediateCommands::bindSparse(const VkBindSparseInfo& bindInfo) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_SUBMIT);
+
+  flush();
+
+  // sparse binding operations are not ordered with other queue operations, so they are chained
+  // with the submits using semaphores
+  VkSemaphore waitSemaphore = std::exchange(lastSubmitSemaphore_, VK_NULL_HANDLE);
+  uint64_t waitValue = 0;
+  if (!waitSemaphore && !lastSubmitHandle_.empty()) {
+    // the semaphore of the last submit was consumed by the swapchain
+    if (timelineSemaphore_) {
+      waitSemaphore = timelineSemaphore_->vkSemaphore_;
+      waitValue = lastSignalValue_;
+    } else {
+      wait(lastSubmitHandle_);
+    }
+  }
+
+  // the semaphore signaled by the previous binding operation has already been waited for, either
+  // by a submit or by this binding operation
+  auto& signalSemaphore = bindSparseSemaphores_[bindSparseSemaphoreIndex_];
+  bindSparseSemaphoreIndex_ = (bindSparseSemaphoreIndex_ + 1) % bindSparseSemaphores_.size();
+  if (!signalSemaphore) {
+    signalSemaphore = std::make_unique<VulkanSemaphore>(
+        device_, IGL_FORMAT("Semaphore: {} (bind sparse)", debugName_).c_str());
+  }
+
+  const VkTimelineSemaphoreSubmitInfoKHR timelineInfo = {
+      VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR,
+      nullptr,
+      1u,
+      &waitValue,
+      0u,
+      nullptr,
+  };
+
+  VkBindSparseInfo bi = bindInfo;
+  bi.pNext = waitValue ? &timelineInfo : nullptr;
+  bi.waitSemaphoreCount = waitSemaphore ? 1u : 0u;
+  bi.pWaitSemaphores = &waitSemaphore;
+  bi.signalSemaphoreCount = 1u;
+  bi.pSignalSemaphores = &signalSemaphore->vkSemaphore_;
+
+  IGL_PROFILER_ZONE("vkQueueBindSparse()", IGL_PROFILER_COLOR_SUBMIT);
+  VK_ASSERT(vkQueueBindSparse(queue_, 1u, &bi, VK_NULL_HANDLE));
+  IGL_PROFILER_ZONE_END();
+
+  // the next submit waits for the binding operation
+  lastSubmitSemaphore_ = signalSemaphore->vkSemaphore_;
+}
+
 VkSemaphore VulkanImmediateCommands::acquireLastSubmitSemaphore() {
+  // the semaphore is waited for by another queue operation, which has to come after its signal
+  flush();
+
   return std::exchange(lastSubmitSemaphore_, VK_NULL_HANDLE);
 }
 
@@ -245,8 +509,66 @@ VkFence VulkanImmediateCommands::getVkFenceFromSubmitHandle(SubmitHandle handle)
     return VK_NULL_HANDLE;
   }
 
+  if (buffers_[handle.bufferIndex_].isPending_) {
+    flush();
+  }
+
+  if (!buffers_[handle.bufferIndex_].hasFence_) {
+    // only the last submit of a batch signals its fence, so there is nothing to wait for later
+    wait(handle);
+    return VK_NULL_HANDLE;
+  }
+
   return buffers_[handle.bufferIndex_].fence_.vkFence_;
 }
 
+VkSemaphore VulkanImmediateCommands::getTimelineSemaphore() const {
+  return timelineSemaphore_ ? timelineSemaphore_->vkSemaphore_ : VK_NULL_HANDLE;
+}
+
+uint64_t VulkanImmediateCommands::getSignalValue(SubmitHandle handle) const {
+  if (!timelineSemaphore_ || isReady(handle, true)) {
+    return 0;
+  }
+
+  return buffers_[handle.bufferIndex_].signalValue_;
+}
+
+VulkanImmediateCommands::AcquireStats VulkanImmediateCommands::getAcquireStats() const {
+  AcquireStats stats = acquireStats_;
+  stats.numCommandBuffers = static_cast<uint32_t>(buffers_.size());
+  return stats;
+}
+
+uint64_t VulkanImmediateCommands::getCompletedTimelineValue() const {
+  IGL_ASSERT(timelineSemaphore_);
+
+  uint64_t value = 0;
+  VK_ASSERT(vkGetSemaphoreCounterValueKHR(device_, timelineSemaphore_->vkSemaphore_, &value));
+  completedTimelineValue_ = std::max(completedTimelineValue_, value);
+
+  return completedTimelineValue_;
+}
+
+void VulkanImmediateCommands::waitTimelineValue(uint64_t value) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
+  IGL_ASSERT(timelineSemaphore_);
+
+  if (value <= completedTimelineValue_) {
+    return;
+  }
+
+  const VkSemaphoreWaitInfoKHR waitInfo = {
+      VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR,
+      nullptr,
+      0,
+      1u,
+      &timelineSemaphore_->vkSemaphore_,
+      &value,
+  };
+  VK_ASSERT(vkWaitSemaphoresKHR(device_, &waitInfo, UINT64_MAX));
+  completedTimelineValue_ = std::max(completedTimelineValue_, value);
+}
+
 } // namespace vulkan
 } // namespace igl
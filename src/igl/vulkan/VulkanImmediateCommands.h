@@ -7,6 +7,10 @@
 
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <deque>
+#include <memory>
 #include <vector>
 
 #include <igl/vulkan/Common.h>
@@ -20,11 +24,18 @@ namespace vulkan {
 
 class VulkanImmediateCommands final {
  public:
-  // the maximum number of command buffers which can similtaneously exist in the system; when we run
-  // out of buffers, we stall and wait until an existing buffer becomes available
-  static constexpr uint32_t kMaxCommandBuffers = 16;
+  // the number of command buffers allocated upfront; when we run out of buffers, more buffers are
+  // allocated on demand until `maxCommandBuffers` is reached. After that, we stall and wait until an
+  // existing buffer becomes available
+  static constexpr uint32_t kNumInitialCommandBuffers = 16;
+  static constexpr uint32_t kDefaultMaxCommandBuffers = 64;
 
-  VulkanImmediateCommands(VkDevice device, uint32_t queueFamilyIndex, const char* debugName);
+  VulkanImmediateCommands(VkDevice device,
+                          uint32_t queueFamilyIndex,
+                          const char* debugName,
+                          uint32_t queueIndex = 0,
+                          bool useTimelineSemaphore = false,
+                          uint32_t maxCommandBuffers = kDefaultMaxCommandBuffers);
   ~VulkanImmediateCommands();
   VulkanImmediateCommands(const VulkanImmediateCommands&) = delete;
   VulkanImmediateCommands& operator=(const VulkanImmediateCommands&) = delete;
@@ -47,21 +58,89 @@ class VulkanImmediateCommands final {
 
   static_assert(sizeof(SubmitHandle) == sizeof(uint64_t));
 
+  struct AcquireStats {
+    uint32_t numCommandBuffers = 0; // the number of allocated command buffers
+    uint64_t numWaits = 0; // the number of acquire() calls which had to wait for a command buffer
+    std::chrono::nanoseconds waitTime{0}; // total time spent waiting in acquire()
+  };
+
   struct CommandBufferWrapper {
     CommandBufferWrapper(VulkanFence&& fence, VulkanSemaphore&& semaphore) :
       fence_(std::move(fence)), semaphore_(std::move(semaphore)) {}
     VkCommandBuffer cmdBuf_ = VK_NULL_HANDLE;
     VkCommandBuffer cmdBufAllocated_ = VK_NULL_HANDLE;
     SubmitHandle handle_ = {};
+    uint64_t signalValue_ = 0; // timeline semaphore value signaled by the submit
     VulkanFence fence_;
     VulkanSemaphore semaphore_;
     bool isEncoding_ = false;
+    bool isPending_ = false; // submitted to a SubmitBatch which has not been flushed yet
+    bool hasFence_ = false; // the fence is signaled by the submit and has to be reset
+  };
+
+  // everything vkQueueSubmit() needs for one command buffer
+  struct SubmitInfo {
+    VkCommandBuffer cmdBuf = VK_NULL_HANDLE;
+    uint32_t numWaitSemaphores = 0;
+    std::array<VkSemaphore, 3> waitSemaphores = {};
+    std::array<VkPipelineStageFlags, 3> waitStageMasks = {};
+    std::array<uint64_t, 3> waitValues = {}; // ignored for binary semaphores
+    uint32_t numSignalSemaphores = 0;
+    std::array<VkSemaphore, 2> signalSemaphores = {};
+    std::array<uint64_t, 2> signalValues = {};
+    bool hasTimelineSemaphores = false;
+    CommandBufferWrapper* wrapper = nullptr;
+  };
+
+  /**
+   * Submits of the VulkanImmediateCommands sharing a queue, deferred until flush() so they are
+   * issued with a single vkQueueSubmit(). Each submit keeps its own VkSubmitInfo, so the order of
+   * the submits and their semaphores are preserved. Only the fence of the last command buffer of a
+   * batch is signaled, so deferred submits are tracked with timeline semaphores.
+   */
+  class SubmitBatch final {
+   public:
+    explicit SubmitBatch(VkQueue queue) : queue_(queue) {}
+    ~SubmitBatch() {
+      IGL_ASSERT_MSG(submits_.empty(), "Deferred submits were never flushed");
+    }
+    SubmitBatch(const SubmitBatch&) = delete;
+    SubmitBatch& operator=(const SubmitBatch&) = delete;
+
+    void add(const SubmitInfo& info) {
+      submits_.push_back(info);
+    }
+    void flush();
+    bool empty() const {
+      return submits_.empty();
+    }
+    VkQueue getVkQueue() const {
+      return queue_;
+    }
+
+   private:
+    VkQueue queue_ = VK_NULL_HANDLE;
+    std::vector<SubmitInfo> submits_;
   };
 
   // returns the current command buffer (creates one if it does not exist)
   const CommandBufferWrapper& acquire();
+  // submits the command buffer right away, or adds it to the submit batch if there is one
   SubmitHandle submit(const CommandBufferWrapper& wrapper);
+  // defers the submits of this queue to `batch` until it is flushed. Requires timeline semaphores
+  void setSubmitBatch(std::shared_ptr<SubmitBatch> batch);
+  // issues the deferred submits of the batch, if any
+  void flush();
   void waitSemaphore(VkSemaphore semaphore);
+  // the next submit waits until `semaphore` (a timeline semaphore) reaches `value` before executing
+  // the stages in `dstStageMask`
+  void waitTimelineSemaphore(
+      VkSemaphore semaphore,
+      uint64_t value,
+      VkPipelineStageFlags dstStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+  // queues a sparse memory binding operation (vkQueueBindSparse) which is executed after all
+  // previous submits and before the next one; semaphores in `bindInfo` are ignored
+  void bindSparse(const VkBindSparseInfo& bindInfo);
   VkSemaphore acquireLastSubmitSemaphore();
   SubmitHandle getLastSubmitHandle() const;
   bool isReady(SubmitHandle handle, bool fastCheckNoVulkan = false) const;
@@ -69,19 +148,50 @@ class VulkanImmediateCommands final {
   void waitAll();
   VkFence getVkFenceFromSubmitHandle(SubmitHandle handle);
 
+  bool hasTimelineSemaphore() const {
+    return timelineSemaphore_ != nullptr;
+  }
+  // every submit signals this semaphore with an increasing value (VK_NULL_HANDLE if timeline
+  // semaphores are not used)
+  VkSemaphore getTimelineSemaphore() const;
+  // the timeline value signaled by the submit `handle` (0 if it is already retired or not tracked)
+  uint64_t getSignalValue(SubmitHandle handle) const;
+
+  AcquireStats getAcquireStats() const;
+
  private:
   void purge();
+  void addCommandBuffer();
+  // blocks until at least one submitted command buffer is completed
+  void waitForAnyCommandBuffer();
+  // reads the last timeline value reached by the GPU and caches it in completedTimelineValue_
+  uint64_t getCompletedTimelineValue() const;
+  void waitTimelineValue(uint64_t value) const;
+  static void queueSubmit(VkQueue queue, const SubmitInfo* infos, uint32_t count, VkFence fence);
 
  private:
   VkDevice device_ = VK_NULL_HANDLE;
   VkQueue queue_ = VK_NULL_HANDLE;
   VulkanCommandPool commandPool_;
   std::string debugName_;
-  std::vector<CommandBufferWrapper> buffers_;
+  // std::deque keeps references returned by acquire() valid while growing
+  std::deque<CommandBufferWrapper> buffers_;
   SubmitHandle lastSubmitHandle_ = SubmitHandle();
   VkSemaphore lastSubmitSemaphore_ = VK_NULL_HANDLE;
   VkSemaphore waitSemaphore_ = VK_NULL_HANDLE;
-  uint32_t numAvailableCommandBuffers_ = kMaxCommandBuffers;
+  VkSemaphore waitTimelineSemaphore_ = VK_NULL_HANDLE;
+  uint64_t waitTimelineValue_ = 0;
+  VkPipelineStageFlags waitTimelineStageMask_ = 0;
+  std::unique_ptr<VulkanSemaphore> timelineSemaphore_;
+  std::shared_ptr<SubmitBatch> submitBatch_;
+  // sparse binding operations signal these semaphores in turn, created on demand
+  std::array<std::unique_ptr<VulkanSemaphore>, 2> bindSparseSemaphores_;
+  uint32_t bindSparseSemaphoreIndex_ = 0;
+  uint64_t lastSignalValue_ = 0;
+  mutable uint64_t completedTimelineValue_ = 0;
+  uint32_t maxCommandBuffers_ = kDefaultMaxCommandBuffers;
+  uint32_t numAvailableCommandBuffers_ = 0;
+  AcquireStats acquireStats_;
   uint32_t submitCounter_ = 1;
 };
 
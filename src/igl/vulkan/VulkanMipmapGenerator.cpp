@@ -0,0 +1,484 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/VulkanMipmapGenerator.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string>
+
+#include <igl/vulkan/VulkanBuffer.h>
+#include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanDescriptorSetLayout.h>
+#include <igl/vulkan/VulkanDevice.h>
+#include <igl/vulkan/VulkanImage.h>
+#include <igl/vulkan/VulkanImageView.h>
+#include <igl/vulkan/VulkanPipelineBuilder.h>
+#include <igl/vulkan/VulkanPipelineLayout.h>
+#include <igl/vulkan/VulkanShaderModule.h>
+#include <igl/vulkan/VulkanSpirvCache.h>
+
+namespace {
+
+const uint32_t kNumDescriptorSets = 64;
+// every workgroup reduces a 64x64 tile of the source level into 6 levels
+const uint32_t kTileSize = 64;
+const uint32_t kNumMipsPerTile = 6;
+const uint32_t kMaxImageSize = 1u << (igl::vulkan::VulkanMipmapGenerator::kMaxMipLevels - 1);
+
+struct PushConstants {
+  uint32_t numMips = 0;
+  uint32_t numWorkGroups = 0; // per array layer
+};
+
+// GLSL format layout qualifiers of the formats supported by the compute path
+const char* getImageFormatQualifier(VkFormat format) {
+  switch (format) {
+  case VK_FORMAT_R8G8B8A8_UNORM:
+    return "rgba8";
+  case VK_FORMAT_R8G8B8A8_SNORM:
+    return "rgba8_snorm";
+  case VK_FORMAT_R16G16B16A16_UNORM:
+    return "rgba16";
+  case VK_FORMAT_R16G16B16A16_SFLOAT:
+    return "rgba16f";
+  case VK_FORMAT_R32G32B32A32_SFLOAT:
+    return "rgba32f";
+  case VK_FORMAT_R8_UNORM:
+    return "r8";
+  case VK_FORMAT_R8G8_UNORM:
+    return "rg8";
+  case VK_FORMAT_R16_UNORM:
+    return "r16";
+  case VK_FORMAT_R16G16_UNORM:
+    return "rg16";
+  case VK_FORMAT_R16_SFLOAT:
+    return "r16f";
+  case VK_FORMAT_R16G16_SFLOAT:
+    return "rg16f";
+  case VK_FORMAT_R32_SFLOAT:
+    return "r32f";
+  case VK_FORMAT_R32G32_SFLOAT:
+    return "rg32f";
+  case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+    return "r11f_g11f_b10f";
+  case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+    return "rgb10_a2";
+  default:
+    return nullptr;
+  }
+}
+
+// IGL_MIP_FORMAT is defined by the caller
+const char* kShaderCode = R"(
+layout (local_size_x = 256) in;
+
+layout (set = 0, binding = 0, IGL_MIP_FORMAT) uniform coherent image2DArray kMips[13];
+layout (set = 0, binding = 1) coherent buffer Counters {
+  uint counters[];
+};
+layout (push_constant) uniform PushConstants {
+  uint numMips;
+  uint numWorkGroups;
+} pc;
+
+shared vec4 sTileA[256]; // 16x16
+shared vec4 sTileB[64]; // 8x8
+shared bool sIsLastWorkGroup;
+
+// image arrays are indexed with constants only, so shaderStorageImageArrayDynamicIndexing is not
+// required
+vec4 loadMip(uint mip, ivec3 p) {
+  switch (mip) {
+#define IGL_LOAD(i) case i: return imageLoad(kMips[i], p);
+  IGL_LOAD(0) IGL_LOAD(1) IGL_LOAD(2) IGL_LOAD(3) IGL_LOAD(4) IGL_LOAD(5) IGL_LOAD(6)
+  IGL_LOAD(7) IGL_LOAD(8) IGL_LOAD(9) IGL_LOAD(10) IGL_LOAD(11) IGL_LOAD(12)
+#undef IGL_LOAD
+  }
+  return vec4(0);
+}
+
+void storeMip(uint mip, ivec3 p, vec4 value) {
+  switch (mip) {
+#define IGL_STORE(i) case i: imageStore(kMips[i], p, value); break;
+  IGL_STORE(0) IGL_STORE(1) IGL_STORE(2) IGL_STORE(3) IGL_STORE(4) IGL_STORE(5) IGL_STORE(6)
+  IGL_STORE(7) IGL_STORE(8) IGL_STORE(9) IGL_STORE(10) IGL_STORE(11) IGL_STORE(12)
+#undef IGL_STORE
+  }
+}
+
+ivec2 getMipSize(uint mip) {
+  return max(imageSize(kMips[0]).xy >> mip, ivec2(1));
+}
+
+void storeMipClamped(uint mip, ivec2 p, int layer, vec4 value) {
+  if (all(lessThan(p, getMipSize(mip)))) {
+    storeMip(mip, ivec3(p, layer), value);
+  }
+}
+
+vec4 loadMipClamped(uint mip, ivec2 p, int layer) {
+  return loadMip(mip, ivec3(min(p, getMipSize(mip) - 1), layer));
+}
+
+// reduces the 64x64 `tile` of `srcMip` into levels srcMip+1...srcMip+6
+void downsampleTile(uint srcMip, ivec2 tile, int layer) {
+  const uint lastMip = min(srcMip + 6, pc.numMips - 1);
+  const uint t = gl_LocalInvocationIndex;
+  const ivec2 p = ivec2(t % 16, t / 16);
+
+  // every thread reduces 4x4 texels of `srcMip` into 2x2 texels of `srcMip + 1`...
+  vec4 sum = vec4(0);
+  for (int y = 0; y != 2; y++) {
+    for (int x = 0; x != 2; x++) {
+      const ivec2 dst = tile * 32 + 2 * p + ivec2(x, y);
+      const ivec2 src = 2 * dst;
+      const vec4 v = 0.25 * (loadMipClamped(srcMip, src, layer) +
+                             loadMipClamped(srcMip, src + ivec2(1, 0), layer) +
+                             loadMipClamped(srcMip, src + ivec2(0, 1), layer) +
+                             loadMipClamped(srcMip, src + ivec2(1, 1), layer));
+      storeMipClamped(srcMip + 1, dst, layer, v);
+      sum += v;
+    }
+  }
+
+  if (srcMip + 2 > lastMip) {
+    return;
+  }
+
+  // ...and 1 texel of `srcMip + 2`
+  sTileA[t] = 0.25 * sum;
+  storeMipClamped(srcMip + 2, tile * 16 + p, layer, sTileA[t]);
+
+  // the remaining levels ping-pong between the shared tiles
+  uint side = 16;
+  for (uint mip = srcMip + 3; mip <= lastMip; mip++) {
+    const uint prevSide = side;
+    side /= 2;
+    barrier();
+    if (t < side * side) {
+      const ivec2 q = ivec2(t % side, t / side);
+      const uint i = 2 * q.y * prevSide + 2 * q.x;
+      vec4 v;
+      if ((mip - srcMip) % 2 == 1) {
+        v = 0.25 * (sTileA[i] + sTileA[i + 1] + sTileA[i + prevSide] + sTileA[i + prevSide + 1]);
+        sTileB[t] = v;
+      } else {
+        v = 0.25 * (sTileB[i] + sTileB[i + 1] + sTileB[i + prevSide] + sTileB[i + prevSide + 1]);
+        sTileA[t] = v;
+      }
+      storeMipClamped(mip, tile * int(side) + q, layer, v);
+    }
+  }
+}
+
+void main() {
+  const int layer = int(gl_WorkGroupID.z);
+
+  downsampleTile(0, ivec2(gl_WorkGroupID.xy), layer);
+
+  if (pc.numMips <= 7) {
+    return;
+  }
+
+  // make level 6 of this tile visible to the last workgroup
+  memoryBarrierImage();
+  barrier();
+
+  if (gl_LocalInvocationIndex == 0) {
+    sIsLastWorkGroup = atomicAdd(counters[layer], 1) == pc.numWorkGroups - 1;
+  }
+
+  barrier();
+
+  if (!sIsLastWorkGroup) {
+    return;
+  }
+
+  // level 6 is at most 64x64 and fits into one tile
+  downsampleTile(6, ivec2(0), layer);
+}
+)";
+
+} // namespace
+
+namespace igl {
+namespace vulkan {
+
+VulkanMipmapGenerator::VulkanMipmapGenerator(const VulkanContext& ctx) : ctx_(ctx) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  VkDevice device = ctx_.device_->getVkDevice();
+
+  const std::array<VkDescriptorSetLayoutBinding, 2> bindings = {
+      ivkGetDescriptorSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, kMaxMipLevels),
+      ivkGetDescriptorSetLayoutBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1),
+  };
+  const std::array<VkDescriptorBindingFlags, 2> bindingFlags = {};
+  dsl_ = std::make_unique<VulkanDescriptorSetLayout>(device,
+                                                     uint32_t(bindings.size()),
+                                                     bindings.data(),
+                                                     bindingFlags.data(),
+                                                     "Descriptor Set Layout: mipmap generator");
+
+  pipelineLayout_ = std::make_unique<VulkanPipelineLayout>(
+      device,
+      std::vector<VkDescriptorSetLayout>{dsl_->getVkDescriptorSetLayout()},
+      ivkGetPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants)),
+      "Pipeline Layout: mipmap generator");
+
+  const std::array<VkDescriptorPoolSize, 2> poolSizes = {
+      VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, kNumDescriptorSets * kMaxMipLevels},
+      VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kNumDescriptorSets},
+  };
+  VK_ASSERT(ivkCreateDescriptorPool(
+      device, kNumDescriptorSets, uint32_t(poolSizes.size()), poolSizes.data(), &dp_));
+
+  descriptorSets_.resize(kNumDescriptorSets);
+  for (auto& ds : descriptorSets_) {
+    VK_ASSERT(ivkAllocateDescriptorSet(device, dp_, dsl_->getVkDescriptorSetLayout(), &ds.ds));
+  }
+}
+
+VulkanMipmapGenerator::~VulkanMipmapGenerator() {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_DESTROY);
+
+  VkDevice device = ctx_.device_->getVkDevice();
+
+  for (const auto& p : pipelines_) {
+    vkDestroyPipeline(device, p.second, nullptr);
+  }
+
+  vkDestroyDescriptorPool(device, dp_, nullptr);
+}
+
+bool VulkanMipmapGenerator::isSupported(const VulkanImage& image) const {
+  const bool isStorageFormat =
+      (image.formatProperties_.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+
+  return image.isStorageImage() && isStorageFormat && !image.isDepthOrStencilFormat_ &&
+         image.type_ == VK_IMAGE_TYPE_2D && image.samples_ == VK_SAMPLE_COUNT_1_BIT &&
+         image.mipLevels_ > 1 && image.mipLevels_ <= kMaxMipLevels &&
+         image.extent_.width <= kMaxImageSize && image.extent_.height <= kMaxImageSize &&
+         getImageFormatQualifier(image.imageFormat_) != nullptr;
+}
+
+VkPipeline VulkanMipmapGenerator::getPipeline(VkFormat format) {
+  auto it = pipelines_.find(format);
+
+  if (it != pipelines_.end()) {
+    return it->second;
+  }
+
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  VkDevice device = ctx_.device_->getVkDevice();
+
+  const std::string source = std::string("#version 460\n#define IGL_MIP_FORMAT ") +
+                             getImageFormatQualifier(format) + "\n" + kShaderCode;
+
+  // zero-initialize the padding because the whole struct is hashed by the SPIR-V cache
+  glslang_resource_t glslangResource;
+  memset(&glslangResource, 0, sizeof(glslangResource));
+  ivkGlslangResource(&glslangResource, &ctx_.getVkPhysicalDeviceProperties());
+
+  const uint64_t cacheKey =
+      VulkanSpirvCache::getKey(VK_SHADER_STAGE_COMPUTE_BIT, source.c_str(), glslangResource);
+
+  std::vector<uint32_t> spirv;
+
+  if (!ctx_.spirvCache_->find(cacheKey, spirv)) {
+    ctx_.initGlslang();
+    const Result result =
+        compileShader(VK_SHADER_STAGE_COMPUTE_BIT, source.c_str(), spirv, &glslangResource);
+    if (!IGL_VERIFY(result.isOk())) {
+      return VK_NULL_HANDLE;
+    }
+    ctx_.spirvCache_->insert(cacheKey, spirv);
+  }
+
+  VkShaderModule shaderModule = VK_NULL_HANDLE;
+  VK_ASSERT(ivkCreateShaderModuleFromSPIRV(
+      device, spirv.data(), spirv.size() * sizeof(uint32_t), &shaderModule));
+
+  VkPipeline pipeline = VK_NULL_HANDLE;
+
+  VulkanComputePipelineBuilder()
+      .shaderStage(ivkGetPipelineShaderStageCreateInfo(
+          VK_SHADER_STAGE_COMPUTE_BIT, shaderModule, "main", nullptr))
+      .creationFeedback(ctx_.getPipelineCreationFeedback())
+      .build(device,
+             ctx_.pipelineCache_,
+             pipelineLayout_->getVkPipelineLayout(),
+             &pipeline,
+             "Pipeline: mipmap generator");
+
+  vkDestroyShaderModule(device, shaderModule, nullptr);
+
+  pipelines_[format] = pipeline;
+
+  return pipeline;
+}
+
+VkDescriptorSet VulkanMipmapGenerator::acquireDescriptorSet(
+    VulkanImmediateCommands::SubmitHandle handle) {
+  DescriptorSet& ds = descriptorSets_[nextDescriptorSet_];
+
+  nextDescriptorSet_ = (nextDescriptorSet_ + 1) % kNumDescriptorSets;
+
+  // the oldest set is the most likely to be available
+  ctx_.immediate_->wait(ds.handle);
+
+  ds.handle = handle;
+
+  return ds.ds;
+}
+
+void VulkanMipmapGenerator::generate(VkCommandBuffer cmdBuf,
+                                     const VulkanImage& image,
+                                     VulkanImmediateCommands::SubmitHandle handle) {
+  IGL_PROFILER_FUNCTION();
+
+  IGL_ASSERT(isSupported(image));
+
+  VkPipeline pipeline = getPipeline(image.imageFormat_);
+
+  if (!IGL_VERIFY(pipeline != VK_NULL_HANDLE)) {
+    return;
+  }
+
+  VkDevice device = ctx_.device_->getVkDevice();
+
+  const uint32_t numMips = image.mipLevels_;
+  const uint32_t numLayers = image.arrayLayers_;
+
+  if (numCounters_ < numLayers) {
+    // the old buffer is destroyed after the last submit which uses it
+    counters_ = ctx_.createBuffer(numLayers * sizeof(uint32_t),
+                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                      VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                  nullptr,
+                                  "Buffer: mipmap generator counters");
+    if (!IGL_VERIFY(counters_)) {
+      numCounters_ = 0;
+      return;
+    }
+    numCounters_ = numLayers;
+  }
+
+  // per-level storage views are created once and live as long as the image
+  if (image.storageMipViews_.empty()) {
+    for (uint32_t mip = 0; mip != numMips; mip++) {
+      image.storageMipViews_.push_back(image.createImageView(VK_IMAGE_VIEW_TYPE_2D_ARRAY,
+                                                             image.imageFormat_,
+                                                             VK_IMAGE_ASPECT_COLOR_BIT,
+                                                             mip,
+                                                             1,
+                                                             0,
+                                                             numLayers,
+                                                             "Image View: mipmap generator"));
+    }
+  }
+
+  VkDescriptorSet ds = acquireDescriptorSet(handle);
+
+  {
+    // unused array elements point to the last level
+    std::array<VkDescriptorImageInfo, kMaxMipLevels> infoImages;
+    for (uint32_t i = 0; i != kMaxMipLevels; i++) {
+      infoImages[i] = {VK_NULL_HANDLE,
+                       image.storageMipViews_[std::min(i, numMips - 1)]->vkImageView_,
+                       VK_IMAGE_LAYOUT_GENERAL};
+    }
+    const VkDescriptorBufferInfo infoBuffer = {
+        counters_->getVkBuffer(), 0, numLayers * sizeof(uint32_t)};
+    const std::array<VkWriteDescriptorSet, 2> writes = {
+        ivkGetWriteDescriptorSet_ImageInfo(
+            ds, 0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, kMaxMipLevels, infoImages.data()),
+        ivkGetWriteDescriptorSet_BufferInfo(
+            ds, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, &infoBuffer),
+    };
+    vkUpdateDescriptorSets(device, uint32_t(writes.size()), writes.data(), 0, nullptr);
+  }
+
+  ivkCmdBeginDebugUtilsLabel(
+      cmdBuf, "Generate mipmaps (compute)", igl::Color(1.f, 0.75f, 0.f).toFloatPtr());
+
+  // reset the workgroup counters left by the previous dispatch
+  ivkBufferMemoryBarrier(cmdBuf,
+                         counters_->getVkBuffer(),
+                         VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                         VK_ACCESS_TRANSFER_WRITE_BIT,
+                         0,
+                         VK_WHOLE_SIZE,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT);
+  vkCmdFillBuffer(cmdBuf, counters_->getVkBuffer(), 0, numLayers * sizeof(uint32_t), 0);
+  ivkBufferMemoryBarrier(cmdBuf,
+                         counters_->getVkBuffer(),
+                         VK_ACCESS_TRANSFER_WRITE_BIT,
+                         VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                         0,
+                         VK_WHOLE_SIZE,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+  const VkImageLayout originalImageLayout = image.imageLayout_;
+
+  IGL_ASSERT(originalImageLayout != VK_IMAGE_LAYOUT_UNDEFINED);
+
+  const VkImageSubresourceRange range = {VK_IMAGE_ASPECT_COLOR_BIT, 0, numMips, 0, numLayers};
+
+  image.transitionLayout(cmdBuf,
+                         VK_IMAGE_LAYOUT_GENERAL,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         range);
+
+  const uint32_t numGroupsX = (image.extent_.width + kTileSize - 1) / kTileSize;
+  const uint32_t numGroupsY = (image.extent_.height + kTileSize - 1) / kTileSize;
+  const PushConstants pc = {numMips, numGroupsX * numGroupsY};
+
+  // level 0, the levels of every tile and the levels reduced by the last workgroup
+  static_assert(1 + 2 * kNumMipsPerTile == kMaxMipLevels);
+
+  vkCmdBindPipeline(cmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+  vkCmdBindDescriptorSets(cmdBuf,
+                          VK_PIPELINE_BIND_POINT_COMPUTE,
+                          pipelineLayout_->getVkPipelineLayout(),
+                          0,
+                          1,
+                          &ds,
+                          0,
+                          nullptr);
+  vkCmdPushConstants(cmdBuf,
+                     pipelineLayout_->getVkPipelineLayout(),
+                     VK_SHADER_STAGE_COMPUTE_BIT,
+                     0,
+                     sizeof(pc),
+                     &pc);
+  vkCmdDispatch(cmdBuf, numGroupsX, numGroupsY, numLayers);
+
+  ivkImageMemoryBarrier(cmdBuf,
+                        image.vkImage_,
+                        VK_ACCESS_SHADER_WRITE_BIT, // srcAccessMask
+                        0, // dstAccessMask
+                        VK_IMAGE_LAYOUT_GENERAL, // oldImageLayout
+                        originalImageLayout, // newImageLayout
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, // srcStageMask
+                        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, // dstStageMask
+                        range);
+
+  image.setImageLayout(originalImageLayout, range);
+
+  ivkCmdEndDebugUtilsLabel(cmdBuf);
+}
+
+} // namespace vulkan
+} // namespace igl
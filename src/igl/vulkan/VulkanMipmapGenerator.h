@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
+
+namespace igl {
+namespace vulkan {
+
+class VulkanBuffer;
+class VulkanContext;
+class VulkanDescriptorSetLayout;
+class VulkanImage;
+class VulkanPipelineLayout;
+
+/**
+ * @brief Generates the whole mip chain of a storage image with a single compute dispatch, in the
+ * style of AMD FidelityFX Single Pass Downsampler. Every workgroup reduces a 64x64 tile of level 0
+ * into 6 levels; the last workgroup to finish (tracked with an atomic counter) reduces the
+ * remaining levels. Levels are written through per-level storage image views with a 2x2 box
+ * filter, so this works for formats which do not support linear blits.
+ */
+class VulkanMipmapGenerator final {
+ public:
+  static constexpr uint32_t kMaxMipLevels = 13; // 4096x4096
+
+  explicit VulkanMipmapGenerator(const VulkanContext& ctx);
+  ~VulkanMipmapGenerator();
+
+  VulkanMipmapGenerator(const VulkanMipmapGenerator&) = delete;
+  VulkanMipmapGenerator& operator=(const VulkanMipmapGenerator&) = delete;
+
+  /// Returns true if generate() can handle `image`. Use VulkanImage::generateMipmap() otherwise
+  bool isSupported(const VulkanImage& image) const;
+
+  /// Records the generation of all mip levels of `image` from its level 0 into `cmdBuf`, which
+  /// will be submitted to the graphics queue as `handle`
+  void generate(VkCommandBuffer cmdBuf,
+                const VulkanImage& image,
+                VulkanImmediateCommands::SubmitHandle handle);
+
+ private:
+  VkPipeline getPipeline(VkFormat format);
+  VkDescriptorSet acquireDescriptorSet(VulkanImmediateCommands::SubmitHandle handle);
+
+ private:
+  struct DescriptorSet {
+    VkDescriptorSet ds = VK_NULL_HANDLE;
+    VulkanImmediateCommands::SubmitHandle handle;
+  };
+
+  const VulkanContext& ctx_;
+  std::unique_ptr<VulkanDescriptorSetLayout> dsl_;
+  std::unique_ptr<VulkanPipelineLayout> pipelineLayout_;
+  VkDescriptorPool dp_ = VK_NULL_HANDLE;
+  // used round-robin, every set is reused once its last submit is retired
+  std::vector<DescriptorSet> descriptorSets_;
+  uint32_t nextDescriptorSet_ = 0;
+  // compiled on demand, one per storage image format
+  std::unordered_map<VkFormat, VkPipeline> pipelines_;
+  // one workgroup counter per array layer
+  std::shared_ptr<VulkanBuffer> counters_;
+  uint32_t numCounters_ = 0;
+};
+
+} // namespace vulkan
+} // namespace igl
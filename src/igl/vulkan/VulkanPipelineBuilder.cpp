@@ -10,8 +10,25 @@
 namespace igl {
 namespace vulkan {
 
-uint32_t VulkanPipelineBuilder::numPipelinesCreated_ = 0;
-uint32_t VulkanComputePipelineBuilder::numPipelinesCreated_ = 0;
+namespace {
+
+void reportCreationFeedback(const PipelineCreationFeedbackCallback& callback,
+                            const VkPipelineCreationFeedbackEXT& feedback,
+                            const char* debugName) {
+  // drivers are allowed to leave the feedback invalid
+  if (!callback || (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT) == 0) {
+    return;
+  }
+  callback(debugName ? debugName : "",
+           feedback.duration,
+           (feedback.flags &
+            VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT) != 0);
+}
+
+} // namespace
+
+std::atomic<uint32_t> VulkanPipelineBuilder::numPipelinesCreated_ = 0;
+std::atomic<uint32_t> VulkanComputePipelineBuilder::numPipelinesCreated_ = 0;
 
 VulkanPipelineBuilder::VulkanPipelineBuilder() :
   vertexInputState_(ivkGetPipelineVertexInputStateCreateInfo_Empty()),
@@ -119,6 +136,31 @@ VulkanPipelineBuilder& VulkanPipelineBuilder::stencilStateOps(VkStencilFaceFlags
   return *this;
 }
 
+VulkanPipelineBuilder& VulkanPipelineBuilder::creationFeedback(
+    PipelineCreationFeedbackCallback callback) {
+  creationFeedback_ = std::move(callback);
+  return *this;
+}
+
+VulkanPipelineBuilder& VulkanPipelineBuilder::createFlags(VkPipelineCreateFlags flags) {
+  createFlags_ = flags;
+  return *this;
+}
+
+VulkanPipelineBuilder& VulkanPipelineBuilder::dynamicRenderingFormats(
+    const std::vector<VkFormat>& colorFormats,
+    VkFormat depthFormat,
+    VkFormat stencilFormat,
+    uint32_t viewMask) {
+  useDynamicRendering_ = true;
+  colorFormats_ = colorFormats;
+  renderingInfo_.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+  renderingInfo_.viewMask = viewMask;
+  renderingInfo_.depthAttachmentFormat = depthFormat;
+  renderingInfo_.stencilAttachmentFormat = stencilFormat;
+  return *this;
+}
+
 VkResult VulkanPipelineBuilder::build(VkDevice device,
                                       VkPipelineCache pipelineCache,
                                       VkPipelineLayout pipelineLayout,
@@ -134,8 +176,17 @@ VkResult VulkanPipelineBuilder::build(VkDevice device,
       ivkGetPipelineColorBlendStateCreateInfo(uint32_t(colorBlendAttachmentStates_.size()),
                                               colorBlendAttachmentStates_.data());
 
+  // point into colorFormats_ only now, the builder might have been copied
+  renderingInfo_.colorAttachmentCount = (uint32_t)colorFormats_.size();
+  renderingInfo_.pColorAttachmentFormats = colorFormats_.data();
+
+  VkPipelineCreationFeedbackEXT feedback = {};
+  VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo =
+      ivkGetPipelineCreationFeedbackCreateInfo(&feedback);
+
   const auto result = ivkCreateGraphicsPipeline(device,
                                                 pipelineCache,
+                                                createFlags_,
                                                 (uint32_t)shaderStages_.size(),
                                                 shaderStages_.data(),
                                                 &vertexInputState_,
@@ -148,7 +199,9 @@ VkResult VulkanPipelineBuilder::build(VkDevice device,
                                                 &colorBlendState,
                                                 &dynamicState,
                                                 pipelineLayout,
-                                                renderPass,
+                                                useDynamicRendering_ ? VK_NULL_HANDLE : renderPass,
+                                                useDynamicRendering_ ? &renderingInfo_ : nullptr,
+                                                creationFeedback_ ? &feedbackInfo : nullptr,
                                                 outPipeline);
 
   if (!IGL_VERIFY(result == VK_SUCCESS)) {
@@ -157,23 +210,142 @@ VkResult VulkanPipelineBuilder::build(VkDevice device,
 
   numPipelinesCreated_++;
 
+  reportCreationFeedback(creationFeedback_, feedback, debugName);
+
   // set debug name
   return ivkSetDebugObjectName(device, VK_OBJECT_TYPE_PIPELINE, (uint64_t)*outPipeline, debugName);
 }
 
+VkResult VulkanPipelineBuilder::buildLibrary(VkDevice device,
+                                             VkPipelineCache pipelineCache,
+                                             VkPipelineLayout pipelineLayout,
+                                             VkRenderPass renderPass,
+                                             VkGraphicsPipelineLibraryFlagsEXT parts,
+                                             VkPipeline* outLibrary,
+                                             const char* debugName) noexcept {
+  const VkPipelineDynamicStateCreateInfo dynamicState =
+      ivkGetPipelineDynamicStateCreateInfo((uint32_t)dynamicStates_.size(), dynamicStates_.data());
+  const VkPipelineViewportStateCreateInfo viewportState =
+      ivkGetPipelineViewportStateCreateInfo(nullptr, nullptr);
+  const VkPipelineColorBlendStateCreateInfo colorBlendState =
+      ivkGetPipelineColorBlendStateCreateInfo(uint32_t(colorBlendAttachmentStates_.size()),
+                                              colorBlendAttachmentStates_.data());
+
+  renderingInfo_.colorAttachmentCount = (uint32_t)colorFormats_.size();
+  renderingInfo_.pColorAttachmentFormats = colorFormats_.data();
+
+  // the vertex shader belongs to the pre-rasterization part, the fragment shader to its own part
+  std::vector<VkPipelineShaderStageCreateInfo> stages;
+  stages.reserve(shaderStages_.size());
+  for (const auto& stage : shaderStages_) {
+    const bool isFragment = stage.stage == VK_SHADER_STAGE_FRAGMENT_BIT;
+    const VkGraphicsPipelineLibraryFlagsEXT part =
+        isFragment ? VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT
+                   : VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+    if (parts & part) {
+      stages.push_back(stage);
+    }
+  }
+
+  VkPipelineCreationFeedbackEXT feedback = {};
+  VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo =
+      ivkGetPipelineCreationFeedbackCreateInfo(&feedback);
+
+  const auto result = ivkCreateGraphicsPipelineLibrary(
+      device,
+      pipelineCache,
+      parts,
+      (uint32_t)stages.size(),
+      stages.data(),
+      &vertexInputState_,
+      &inputAssembly_,
+      &viewportState,
+      &rasterizationState_,
+      &multisampleState_,
+      &depthStencilState_,
+      &colorBlendState,
+      &dynamicState,
+      pipelineLayout,
+      useDynamicRendering_ ? VK_NULL_HANDLE : renderPass,
+      useDynamicRendering_ ? &renderingInfo_ : nullptr,
+      creationFeedback_ ? &feedbackInfo : nullptr,
+      outLibrary);
+
+  if (!IGL_VERIFY(result == VK_SUCCESS)) {
+    return result;
+  }
+
+  reportCreationFeedback(creationFeedback_, feedback, debugName);
+
+  return ivkSetDebugObjectName(device, VK_OBJECT_TYPE_PIPELINE, (uint64_t)*outLibrary, debugName);
+}
+
+VkResult VulkanPipelineBuilder::link(VkDevice device,
+                                     VkPipelineCache pipelineCache,
+                                     VkPipelineLayout pipelineLayout,
+                                     const std::vector<VkPipeline>& libraries,
+                                     bool optimize,
+                                     VkPipeline* outPipeline,
+                                     const char* debugName,
+                                     const PipelineCreationFeedbackCallback& callback) noexcept {
+  VkPipelineCreationFeedbackEXT feedback = {};
+  VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo =
+      ivkGetPipelineCreationFeedbackCreateInfo(&feedback);
+
+  const VkResult result = ivkLinkGraphicsPipelineLibraries(device,
+                                                           pipelineCache,
+                                                           (uint32_t)libraries.size(),
+                                                           libraries.data(),
+                                                           pipelineLayout,
+                                                           optimize ? VK_TRUE : VK_FALSE,
+                                                           callback ? &feedbackInfo : nullptr,
+                                                           outPipeline);
+
+  if (!IGL_VERIFY(result == VK_SUCCESS)) {
+    return result;
+  }
+
+  numPipelinesCreated_++;
+
+  reportCreationFeedback(callback, feedback, debugName);
+
+  return ivkSetDebugObjectName(device, VK_OBJECT_TYPE_PIPELINE, (uint64_t)*outPipeline, debugName);
+}
+
 VulkanComputePipelineBuilder& VulkanComputePipelineBuilder::shaderStage(
     VkPipelineShaderStageCreateInfo stage) {
   shaderStage_ = stage;
   return *this;
 }
 
+VulkanComputePipelineBuilder& VulkanComputePipelineBuilder::creationFeedback(
+    PipelineCreationFeedbackCallback callback) {
+  creationFeedback_ = std::move(callback);
+  return *this;
+}
+
+VulkanComputePipelineBuilder& VulkanComputePipelineBuilder::createFlags(
+    VkPipelineCreateFlags flags) {
+  createFlags_ = flags;
+  return *this;
+}
+
 VkResult VulkanComputePipelineBuilder::build(VkDevice device,
                                              VkPipelineCache pipelineCache,
                                              VkPipelineLayout pipelineLayout,
                                              VkPipeline* outPipeline,
                                              const char* debugName) noexcept {
-  const VkResult result =
-      ivkCreateComputePipeline(device, pipelineCache, &shaderStage_, pipelineLayout, outPipeline);
+  VkPipelineCreationFeedbackEXT feedback = {};
+  VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo =
+      ivkGetPipelineCreationFeedbackCreateInfo(&feedback);
+
+  const VkResult result = ivkCreateComputePipeline(device,
+                                                   pipelineCache,
+                                                   createFlags_,
+                                                   &shaderStage_,
+                                                   pipelineLayout,
+                                                   creationFeedback_ ? &feedbackInfo : nullptr,
+                                                   outPipeline);
 
   if (!IGL_VERIFY(result == VK_SUCCESS)) {
     return result;
@@ -181,6 +353,8 @@ VkResult VulkanComputePipelineBuilder::build(VkDevice device,
 
   numPipelinesCreated_++;
 
+  reportCreationFeedback(creationFeedback_, feedback, debugName);
+
   // set debug name
   return ivkSetDebugObjectName(device, VK_OBJECT_TYPE_PIPELINE, (uint64_t)*outPipeline, debugName);
 }
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanHelpers.h>
 #include <vector>
@@ -14,6 +16,11 @@
 namespace igl {
 namespace vulkan {
 
+// Receives the debug name of a pipeline, how long the driver took to create it and whether it was
+// found in the pipeline cache (VK_EXT_pipeline_creation_feedback)
+using PipelineCreationFeedbackCallback =
+    std::function<void(const char* debugName, uint64_t durationNs, bool cacheHit)>;
+
 class VulkanPipelineBuilder final {
  public:
   VulkanPipelineBuilder();
@@ -39,6 +46,16 @@ class VulkanPipelineBuilder final {
   VulkanPipelineBuilder& vertexInputState(const VkPipelineVertexInputStateCreateInfo& state);
   VulkanPipelineBuilder& colorBlendAttachmentStates(
       std::vector<VkPipelineColorBlendAttachmentState>& states);
+  // Build a pipeline for dynamic rendering (VK_KHR_dynamic_rendering) with these formats.
+  // The `renderPass` parameter of build() is ignored in this case.
+  VulkanPipelineBuilder& dynamicRenderingFormats(const std::vector<VkFormat>& colorFormats,
+                                                 VkFormat depthFormat,
+                                                 VkFormat stencilFormat,
+                                                 uint32_t viewMask);
+  // Report the creation feedback of build() and buildLibrary() to `callback`
+  VulkanPipelineBuilder& creationFeedback(PipelineCreationFeedbackCallback callback);
+  // VkPipelineCreateFlags of build(), e.g. for pipelines using descriptor buffers
+  VulkanPipelineBuilder& createFlags(VkPipelineCreateFlags flags);
 
   VkResult build(VkDevice device,
                  VkPipelineCache pipelineCache,
@@ -47,6 +64,28 @@ class VulkanPipelineBuilder final {
                  VkPipeline* outPipeline,
                  const char* debugName = nullptr) noexcept;
 
+  // Build a pipeline library (VK_EXT_graphics_pipeline_library) from the state of `parts` only.
+  // Shader stages which do not belong to `parts` are skipped.
+  VkResult buildLibrary(VkDevice device,
+                        VkPipelineCache pipelineCache,
+                        VkPipelineLayout pipelineLayout,
+                        VkRenderPass renderPass,
+                        VkGraphicsPipelineLibraryFlagsEXT parts,
+                        VkPipeline* outLibrary,
+                        const char* debugName = nullptr) noexcept;
+
+  // Link libraries covering all 4 parts into a complete pipeline. Fast linking skips link-time
+  // optimizations, so the result can be slower on the GPU than a pipeline built with build().
+  // The creation feedback of the linked pipeline is reported to `callback`, if any
+  static VkResult link(VkDevice device,
+                       VkPipelineCache pipelineCache,
+                       VkPipelineLayout pipelineLayout,
+                       const std::vector<VkPipeline>& libraries,
+                       bool optimize,
+                       VkPipeline* outPipeline,
+                       const char* debugName = nullptr,
+                       const PipelineCreationFeedbackCallback& callback = nullptr) noexcept;
+
   static uint32_t getNumPipelinesCreated() {
     return numPipelinesCreated_;
   }
@@ -60,7 +99,12 @@ class VulkanPipelineBuilder final {
   VkPipelineMultisampleStateCreateInfo multisampleState_;
   VkPipelineDepthStencilStateCreateInfo depthStencilState_;
   std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachmentStates_;
-  static uint32_t numPipelinesCreated_;
+  bool useDynamicRendering_ = false;
+  std::vector<VkFormat> colorFormats_;
+  VkPipelineRenderingCreateInfoKHR renderingInfo_ = {};
+  PipelineCreationFeedbackCallback creationFeedback_;
+  VkPipelineCreateFlags createFlags_ = 0;
+  static std::atomic<uint32_t> numPipelinesCreated_;
 };
 
 class VulkanComputePipelineBuilder final {
@@ -69,6 +113,8 @@ class VulkanComputePipelineBuilder final {
   ~VulkanComputePipelineBuilder() = default;
 
   VulkanComputePipelineBuilder& shaderStage(VkPipelineShaderStageCreateInfo stage);
+  VulkanComputePipelineBuilder& creationFeedback(PipelineCreationFeedbackCallback callback);
+  VulkanComputePipelineBuilder& createFlags(VkPipelineCreateFlags flags);
 
   VkResult build(VkDevice device,
                  VkPipelineCache pipelineCache,
@@ -82,7 +128,9 @@ class VulkanComputePipelineBuilder final {
 
  private:
   VkPipelineShaderStageCreateInfo shaderStage_;
-  static uint32_t numPipelinesCreated_;
+  PipelineCreationFeedbackCallback creationFeedback_;
+  VkPipelineCreateFlags createFlags_ = 0;
+  static std::atomic<uint32_t> numPipelinesCreated_;
 };
 
 } // namespace vulkan
@@ -7,6 +7,8 @@
 
 #include "VulkanRenderPassBuilder.h"
 
+#include <array>
+
 // this cannot be put into namespace
 bool operator==(const VkAttachmentDescription& a, const VkAttachmentDescription& b) {
 #define CMP(field) (a.field == b.field)
@@ -35,9 +37,17 @@ VkResult VulkanRenderPassBuilder::build(VkDevice device,
       ivkGetSubpassDescription((uint32_t)refsColor_.size(),
                                refsColor_.data(),
                                refsColorResolve_.data(),
-                               hasDepthStencilAttachment ? &refDepth_ : nullptr);
-  const VkSubpassDependency dep = ivkGetSubpassDependency();
+                               hasDepthStencilAttachment ? &refDepth_ : nullptr,
+                               (uint32_t)refsInput_.size(),
+                               refsInput_.data());
   const bool hasViewMask = viewMask_ != 0;
+  std::array<VkSubpassDependency, 2> deps = {ivkGetSubpassDependency(),
+                                             ivkGetSubpassSelfDependency()};
+  if (hasViewMask) {
+    // self-dependencies of multiview subpasses must be view-local
+    deps[1].dependencyFlags |= VK_DEPENDENCY_VIEW_LOCAL_BIT;
+  }
+  const bool hasFragmentDensityMap = refFragmentDensityMap_.layout != VK_IMAGE_LAYOUT_UNDEFINED;
 
   const VkRenderPassMultiviewCreateInfo ci =
       ivkGetRenderPassMultiviewCreateInfo(&viewMask_, &correlationMask_);
@@ -45,8 +55,11 @@ VkResult VulkanRenderPassBuilder::build(VkDevice device,
                                               (uint32_t)attachments_.size(),
                                               attachments_.data(),
                                               &subpass,
-                                              &dep,
+                                              refsInput_.empty() ? 1u : 2u,
+                                              deps.data(),
                                               hasViewMask ? &ci : nullptr,
+                                              hasFragmentDensityMap ? &refFragmentDensityMap_
+                                                                    : nullptr,
                                               outRenderPass);
   if (!IGL_VERIFY(result == VK_SUCCESS)) {
     return result;
@@ -57,6 +70,20 @@ VkResult VulkanRenderPassBuilder::build(VkDevice device,
       device, VK_OBJECT_TYPE_RENDER_PASS, (uint64_t)*outRenderPass, debugName);
 }
 
+VulkanRenderPassBuilder VulkanRenderPassBuilder::getCompatibleRenderPassBuilder() const {
+  VulkanRenderPassBuilder builder(*this);
+
+  for (auto& a : builder.attachments_) {
+    a.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    a.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    a.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    a.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    a.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  }
+
+  return builder;
+}
+
 VulkanRenderPassBuilder& VulkanRenderPassBuilder::addColor(VkFormat format,
                                                            VkAttachmentLoadOp loadOp,
                                                            VkAttachmentStoreOp storeOp,
@@ -123,6 +150,26 @@ VulkanRenderPassBuilder& VulkanRenderPassBuilder::addDepthResolve(VkFormat forma
   return *this;
 }
 
+VulkanRenderPassBuilder& VulkanRenderPassBuilder::addFragmentDensityMap(
+    VkFormat format,
+    VkAttachmentLoadOp loadOp,
+    VkImageLayout initialLayout,
+    VkImageLayout finalLayout) {
+  IGL_ASSERT_MSG(refFragmentDensityMap_.layout == VK_IMAGE_LAYOUT_UNDEFINED,
+                 "Can have only 1 fragment density map");
+  IGL_ASSERT_MSG(format != VK_FORMAT_UNDEFINED, "Invalid fragment density map format");
+  IGL_ASSERT_MSG(loadOp != VK_ATTACHMENT_LOAD_OP_CLEAR, "A fragment density map cannot be cleared");
+  refFragmentDensityMap_ = ivkGetAttachmentReference(
+      (uint32_t)attachments_.size(), VK_IMAGE_LAYOUT_FRAGMENT_DENSITY_MAP_OPTIMAL_EXT);
+  attachments_.push_back(ivkGetAttachmentDescription(format,
+                                                     loadOp,
+                                                     VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                                                     initialLayout,
+                                                     finalLayout,
+                                                     VK_SAMPLE_COUNT_1_BIT));
+  return *this;
+}
+
 VulkanRenderPassBuilder& VulkanRenderPassBuilder::setMultiviewMasks(
     const uint32_t viewMask,
     const uint32_t correlationMask) {
@@ -131,10 +178,22 @@ VulkanRenderPassBuilder& VulkanRenderPassBuilder::setMultiviewMasks(
   return *this;
 }
 
+VulkanRenderPassBuilder& VulkanRenderPassBuilder::enableFramebufferFetch() {
+  IGL_ASSERT_MSG(refsInput_.empty(), "Framebuffer fetch is already enabled");
+  // attachments which are read and written by the same subpass have to be in the general layout
+  for (auto& ref : refsColor_) {
+    ref.layout = VK_IMAGE_LAYOUT_GENERAL;
+    refsInput_.push_back(ref);
+  }
+  return *this;
+}
+
 bool VulkanRenderPassBuilder::operator==(const VulkanRenderPassBuilder& other) const {
   return attachments_ == other.attachments_ && refsColor_ == other.refsColor_ &&
-         refsColorResolve_ == other.refsColorResolve_ && refDepth_ == other.refDepth_ &&
-         refDepthResolve_ == other.refDepthResolve_;
+         refsColorResolve_ == other.refsColorResolve_ && refsInput_ == other.refsInput_ &&
+         refDepth_ == other.refDepth_ &&
+         refDepthResolve_ == other.refDepthResolve_ &&
+         refFragmentDensityMap_ == other.refFragmentDensityMap_;
 }
 
 uint64_t VulkanRenderPassBuilder::HashFunction::operator()(
@@ -159,10 +218,14 @@ uint64_t VulkanRenderPassBuilder::HashFunction::operator()(
     hash ^= std::hash<uint32_t>()(r.attachment);
     hash ^= std::hash<uint32_t>()(r.layout);
   }
+  // input references mirror the color references and would cancel them out in the xor
+  hash ^= std::hash<size_t>()(builder.refsInput_.size());
   hash ^= std::hash<uint32_t>()(builder.refDepth_.attachment);
   hash ^= std::hash<uint32_t>()(builder.refDepth_.layout);
   hash ^= std::hash<uint32_t>()(builder.refDepthResolve_.attachment);
   hash ^= std::hash<uint32_t>()(builder.refDepthResolve_.layout);
+  hash ^= std::hash<uint32_t>()(builder.refFragmentDensityMap_.attachment);
+  hash ^= std::hash<uint32_t>()(builder.refFragmentDensityMap_.layout);
   return hash;
 }
 
@@ -48,8 +48,24 @@ class VulkanRenderPassBuilder final {
       VkAttachmentStoreOp storeOp,
       VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
       VkImageLayout finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+  // The fragment density map is read when the render pass begins and has no clear value. It lowers
+  // the fragment shading rate of the regions of all other attachments (VK_EXT_fragment_density_map)
+  VulkanRenderPassBuilder& addFragmentDensityMap(
+      VkFormat format,
+      VkAttachmentLoadOp loadOp = VK_ATTACHMENT_LOAD_OP_LOAD,
+      VkImageLayout initialLayout = VK_IMAGE_LAYOUT_FRAGMENT_DENSITY_MAP_OPTIMAL_EXT,
+      VkImageLayout finalLayout = VK_IMAGE_LAYOUT_FRAGMENT_DENSITY_MAP_OPTIMAL_EXT);
   VulkanRenderPassBuilder& setMultiviewMasks(const uint32_t viewMask,
                                              const uint32_t correlationMask);
+  // Makes all color attachments input attachments of the subpass as well, in the same order, so
+  // that fragment shaders can read them (RenderPassDesc::framebufferFetch). Call it after all
+  // color attachments have been added
+  VulkanRenderPassBuilder& enableFramebufferFetch();
+
+  // Returns a builder for a render pass which is compatible with this one (same attachment formats
+  // and sample counts) but ignores load/store operations and initial layouts. Pipelines only care
+  // about render pass compatibility, so this is used to avoid building redundant pipeline variants.
+  VulkanRenderPassBuilder getCompatibleRenderPassBuilder() const;
 
   // comparison operator and a hash function for std::unordered_map<>
   bool operator==(const VulkanRenderPassBuilder& other) const;
@@ -70,8 +86,10 @@ class VulkanRenderPassBuilder final {
   std::vector<VkAttachmentDescription> attachments_;
   std::vector<VkAttachmentReference> refsColor_;
   std::vector<VkAttachmentReference> refsColorResolve_;
+  std::vector<VkAttachmentReference> refsInput_;
   VkAttachmentReference refDepth_ = {};
   VkAttachmentReference refDepthResolve_ = {};
+  VkAttachmentReference refFragmentDensityMap_ = {};
   uint32_t viewMask_ = 0;
   uint32_t correlationMask_ = 0;
 };
@@ -29,8 +29,7 @@ VulkanSampler::VulkanSampler(const VulkanContext& ctx,
 VulkanSampler::~VulkanSampler() {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_DESTROY);
 
-  ctx_.deferredTask(std::packaged_task<void()>(
-      [device = device_, sampler = vkSampler_]() { vkDestroySampler(device, sampler, nullptr); }));
+  ctx_.deferredDestroy(VulkanContext::DestructionType::Sampler, (uint64_t)vkSampler_);
 }
 
 } // namespace vulkan
@@ -19,6 +19,17 @@ VulkanSemaphore::VulkanSemaphore(VkDevice device, const char* debugName) : devic
       ivkSetDebugObjectName(device_, VK_OBJECT_TYPE_SEMAPHORE, (uint64_t)vkSemaphore_, debugName));
 }
 
+VulkanSemaphore::VulkanSemaphore(VkDevice device,
+                                 uint64_t initialTimelineValue,
+                                 const char* debugName) :
+  device_(device) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  VK_ASSERT(ivkCreateTimelineSemaphore(device_, initialTimelineValue, &vkSemaphore_));
+  VK_ASSERT(
+      ivkSetDebugObjectName(device_, VK_OBJECT_TYPE_SEMAPHORE, (uint64_t)vkSemaphore_, debugName));
+}
+
 VulkanSemaphore ::~VulkanSemaphore() {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_DESTROY);
 
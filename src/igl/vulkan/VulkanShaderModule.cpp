@@ -56,17 +56,12 @@ void logShaderSource(const char* text) {
 namespace igl {
 namespace vulkan {
 
-Result compileShader(VkDevice device,
-                     VkShaderStageFlagBits stage,
+Result compileShader(VkShaderStageFlagBits stage,
                      const char* code,
-                     VkShaderModule* outShaderModule,
+                     std::vector<uint32_t>& outSPIRV,
                      const glslang_resource_t* glslLangResource) {
   IGL_PROFILER_FUNCTION();
 
-  if (!outShaderModule) {
-    return Result(Result::Code::ArgumentNull, "outShaderModule is NULL");
-  }
-
   const glslang_input_t input = ivkGetGLSLangInput(stage, glslLangResource, code);
 
   glslang_shader_t* shader = glslang_shader_create(&input);
@@ -124,7 +119,33 @@ Result compileShader(VkDevice device,
     IGL_LOG_ERROR("%s\n", glslang_program_SPIRV_get_messages(program));
   }
 
-  VK_ASSERT_RETURN(ivkCreateShaderModule(device, program, outShaderModule));
+  const uint32_t* words = glslang_program_SPIRV_get_ptr(program);
+  outSPIRV.assign(words, words + glslang_program_SPIRV_get_size(program));
+
+  return Result();
+}
+
+Result compileShader(VkDevice device,
+                     VkShaderStageFlagBits stage,
+                     const char* code,
+                     VkShaderModule* outShaderModule,
+                     const glslang_resource_t* glslLangResource) {
+  IGL_PROFILER_FUNCTION();
+
+  if (!outShaderModule) {
+    return Result(Result::Code::ArgumentNull, "outShaderModule is NULL");
+  }
+
+  std::vector<uint32_t> spirv;
+
+  const Result result = compileShader(stage, code, spirv, glslLangResource);
+
+  if (!result.isOk()) {
+    return result;
+  }
+
+  VK_ASSERT_RETURN(ivkCreateShaderModuleFromSPIRV(
+      device, spirv.data(), spirv.size() * sizeof(uint32_t), outShaderModule));
 
   return Result();
 }
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanHelpers.h>
@@ -15,6 +16,13 @@
 namespace igl {
 namespace vulkan {
 
+/// Compiles GLSL into SPIR-V without creating a shader module. glslang has to be initialized, see
+/// VulkanContext::initGlslang()
+Result compileShader(VkShaderStageFlagBits stage,
+                     const char* code,
+                     std::vector<uint32_t>& outSPIRV,
+                     const glslang_resource_t* glslLangResource = nullptr);
+
 Result compileShader(VkDevice device,
                      VkShaderStageFlagBits stage,
                      const char* code,
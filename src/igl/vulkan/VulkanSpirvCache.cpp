@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/VulkanSpirvCache.h>
+
+#include <cstdio>
+#include <cstring>
+#include <igl/CacheFile.h>
+
+namespace {
+
+/*
+ * File layout: SpirvCacheFileHeader followed by `numEntries` records of
+ * {uint64_t key, uint32_t numWords, uint32_t words[numWords]}. `dataHash` covers all records.
+ */
+const uint32_t kSpirvCacheFileMagic = 0x56534749; // "IGSV"
+const uint32_t kSpirvCacheFileVersion = 1;
+
+struct SpirvCacheFileHeader {
+  uint32_t magic = kSpirvCacheFileMagic;
+  uint32_t version = kSpirvCacheFileVersion;
+  uint64_t numEntries = 0;
+  uint64_t dataSize = 0;
+  uint64_t dataHash = 0;
+};
+
+template<typename T>
+void append(std::vector<uint8_t>& data, const T& value) {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+  data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+template<typename T>
+bool read(const std::vector<uint8_t>& data, size_t& offset, T& outValue) {
+  if (data.size() - offset < sizeof(T)) {
+    return false;
+  }
+  memcpy(&outValue, data.data() + offset, sizeof(T));
+  offset += sizeof(T);
+  return true;
+}
+
+} // namespace
+
+namespace igl {
+namespace vulkan {
+
+uint64_t VulkanSpirvCache::getKey(VkShaderStageFlagBits stage,
+                                  const char* source,
+                                  const glslang_resource_t& glslangResource) {
+  uint64_t hash = kCacheHashSeed;
+  hash = hashCacheData(&stage, sizeof(stage), hash);
+  // the resource is a plain struct of ints followed by bools, the caller should zero-initialize it
+  hash = hashCacheData(&glslangResource, sizeof(glslangResource), hash);
+  hash = hashCacheData(source, strlen(source), hash);
+  return hash;
+}
+
+bool VulkanSpirvCache::find(uint64_t key, std::vector<uint32_t>& outSpirv) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  const auto it = entries_.find(key);
+
+  if (it == entries_.end()) {
+    return false;
+  }
+
+  outSpirv = it->second;
+
+  return true;
+}
+
+void VulkanSpirvCache::insert(uint64_t key, std::vector<uint32_t> spirv) {
+  if (spirv.empty()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  entries_[key] = std::move(spirv);
+  isDirty_ = true;
+}
+
+size_t VulkanSpirvCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  return entries_.size();
+}
+
+bool VulkanSpirvCache::load(const std::string& path) {
+  IGL_PROFILER_FUNCTION();
+
+  if (path.empty()) {
+    return false;
+  }
+
+  FILE* file = fopen(path.c_str(), "rb");
+
+  if (!file) {
+    IGL_LOG_INFO("SPIR-V cache file %s not found\n", path.c_str());
+    return false;
+  }
+
+  SpirvCacheFileHeader header;
+  std::vector<uint8_t> data;
+
+  const bool isHeaderValid = fread(&header, sizeof(header), 1, file) == 1 &&
+                             header.magic == kSpirvCacheFileMagic &&
+                             header.version == kSpirvCacheFileVersion;
+
+  if (isHeaderValid) {
+    fseek(file, 0, SEEK_END);
+    const long fileSize = ftell(file);
+    fseek(file, sizeof(header), SEEK_SET);
+    // do not trust the header before allocating memory
+    if (fileSize >= 0 && header.dataSize == uint64_t(fileSize) - sizeof(header)) {
+      data.resize(header.dataSize);
+      if (fread(data.data(), 1, data.size(), file) != data.size() ||
+          hashCacheData(data.data(), data.size()) != header.dataHash) {
+        data.clear();
+      }
+    }
+  }
+
+  fclose(file);
+
+  std::unordered_map<uint64_t, std::vector<uint32_t>> entries;
+
+  size_t offset = 0;
+  bool isValid = !data.empty();
+
+  for (uint64_t i = 0; isValid && i != header.numEntries; i++) {
+    uint64_t key = 0;
+    uint32_t numWords = 0;
+    isValid = read(data, offset, key) && read(data, offset, numWords) && numWords &&
+              (data.size() - offset) / sizeof(uint32_t) >= numWords;
+    if (isValid) {
+      std::vector<uint32_t>& spirv = entries[key];
+      spirv.resize(numWords);
+      memcpy(spirv.data(), data.data() + offset, numWords * sizeof(uint32_t));
+      offset += numWords * sizeof(uint32_t);
+    }
+  }
+
+  if (!isValid || offset != data.size()) {
+    IGL_LOG_INFO("SPIR-V cache file %s is stale or corrupted. Ignoring it\n", path.c_str());
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // entries compiled in this process take precedence
+  entries_.insert(entries.begin(), entries.end());
+
+  return true;
+}
+
+bool VulkanSpirvCache::save(const std::string& path) const {
+  IGL_PROFILER_FUNCTION();
+
+  if (path.empty()) {
+    return false;
+  }
+
+  SpirvCacheFileHeader header;
+  std::vector<uint8_t> data;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!isDirty_) {
+      return true;
+    }
+
+    for (const auto& entry : entries_) {
+      append(data, entry.first);
+      append(data, uint32_t(entry.second.size()));
+      const auto* words = reinterpret_cast<const uint8_t*>(entry.second.data());
+      data.insert(data.end(), words, words + entry.second.size() * sizeof(uint32_t));
+    }
+
+    header.numEntries = entries_.size();
+    isDirty_ = false;
+  }
+
+  header.dataSize = data.size();
+  header.dataHash = hashCacheData(data.data(), data.size());
+
+  if (!writeCacheFile(path, &header, sizeof(header), data.data(), data.size())) {
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace vulkan
+} // namespace igl
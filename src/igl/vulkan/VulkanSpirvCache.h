@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanHelpers.h>
+
+namespace igl {
+namespace vulkan {
+
+/**
+ * @brief Content-addressed cache of SPIR-V binaries produced by glslang. The key is a hash of the
+ * GLSL source, the shader stage, and the glslang resource limits, so a cached binary is reused
+ * only for an identical compilation. The cache is thread-safe and can be persisted into a file.
+ */
+class VulkanSpirvCache final {
+ public:
+  VulkanSpirvCache() = default;
+
+  VulkanSpirvCache(const VulkanSpirvCache&) = delete;
+  VulkanSpirvCache& operator=(const VulkanSpirvCache&) = delete;
+
+  static uint64_t getKey(VkShaderStageFlagBits stage,
+                         const char* source,
+                         const glslang_resource_t& glslangResource);
+
+  /// Returns false if there is no binary for `key`
+  bool find(uint64_t key, std::vector<uint32_t>& outSpirv) const;
+  void insert(uint64_t key, std::vector<uint32_t> spirv);
+
+  /// Merges all entries from the file into the cache. Missing, stale or corrupted files are
+  /// ignored
+  bool load(const std::string& path);
+  /// Writes the cache into the file if anything has been inserted since the last load() or save()
+  bool save(const std::string& path) const;
+
+  size_t size() const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<uint64_t, std::vector<uint32_t>> entries_;
+  mutable bool isDirty_ = false;
+};
+
+} // namespace vulkan
+} // namespace igl
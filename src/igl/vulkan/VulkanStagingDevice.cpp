@@ -7,7 +7,10 @@
 
 #include <igl/vulkan/VulkanStagingDevice.h>
 
+#include <algorithm>
 #include <igl/IGLSafeC.h>
+#include <numeric>
+#include <set>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanBuffer.h>
 #include <igl/vulkan/VulkanContext.h>
@@ -21,15 +24,97 @@ using VulkanSubmitHandle = igl::vulkan::VulkanImmediateCommands::SubmitHandle;
 
 namespace {
 
-/// Vulkan textures are up-side down compared to OGL textures. IGL follows
-/// the OGL convention and this function flips the texture vertically
-void flipBMP(uint8_t* dstImg, const uint8_t* srcImg, size_t height, size_t bytesPerRow) {
-  for (size_t h = 0; h < height; h++) {
-    checked_memcpy(dstImg + h * bytesPerRow,
-                   bytesPerRow,
-                   srcImg + bytesPerRow * (height - 1 - h),
-                   bytesPerRow);
+// chunks other than the first one are released after so many submits without staging through them
+constexpr uint64_t kNumIdleSubmits = 60;
+
+/// Vulkan textures are up-side down compared to OGL textures. IGL follows the OGL convention, so
+/// readbacks can be flipped vertically: this is done by the copy itself, with one region per row
+/// written in reverse order, so that the destination buffer is in final layout and no CPU pass is
+/// needed afterwards. Rows are tightly packed, `bytesPerRow` apart.
+void copyImageToBuffer(VkCommandBuffer cmdBuf,
+                       VkImage srcImage,
+                       VkBuffer dstBuffer,
+                       uint32_t bufferOffset,
+                       const VkRect2D& imageRegion,
+                       const VkImageSubresourceLayers& imageSubresource,
+                       uint32_t bytesPerRow,
+                       bool flipImageVertical) {
+  if (!flipImageVertical) {
+    const VkBufferImageCopy copy =
+        ivkGetBufferImageCopy2D(bufferOffset, imageRegion, imageSubresource);
+    vkCmdCopyImageToBuffer(
+        cmdBuf, srcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dstBuffer, 1, &copy);
+    return;
+  }
+
+  IGL_ASSERT(bytesPerRow > 0);
+
+  const uint32_t height = imageRegion.extent.height;
+  std::vector<VkBufferImageCopy> copies;
+  copies.reserve(height);
+  for (uint32_t h = 0; h != height; h++) {
+    const VkRect2D row = {
+        VkOffset2D{imageRegion.offset.x,
+                   imageRegion.offset.y + static_cast<int32_t>(height - 1 - h)},
+        VkExtent2D{imageRegion.extent.width, 1},
+    };
+    copies.push_back(
+        ivkGetBufferImageCopy2D(bufferOffset + h * bytesPerRow, row, imageSubresource));
   }
+  vkCmdCopyImageToBuffer(cmdBuf,
+                         srcImage,
+                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                         dstBuffer,
+                         static_cast<uint32_t>(copies.size()),
+                         copies.data());
+}
+
+// Queue family ownership transfer of an uploaded image: TRANSFER_DST_OPTIMAL -> SHADER_READ_ONLY.
+// The release (on the transfer queue) and the acquire (on the graphics queue) must match
+void imageOwnershipBarrier(VkCommandBuffer cmdBuf,
+                           VkImage image,
+                           VkAccessFlags srcAccessMask,
+                           VkAccessFlags dstAccessMask,
+                           VkPipelineStageFlags srcStageMask,
+                           VkPipelineStageFlags dstStageMask,
+                           uint32_t srcQueueFamilyIndex,
+                           uint32_t dstQueueFamilyIndex,
+                           const VkImageSubresourceRange& range) {
+  const VkImageMemoryBarrier barrier = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+      .srcAccessMask = srcAccessMask,
+      .dstAccessMask = dstAccessMask,
+      .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+      .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+      .srcQueueFamilyIndex = srcQueueFamilyIndex,
+      .dstQueueFamilyIndex = dstQueueFamilyIndex,
+      .image = image,
+      .subresourceRange = range,
+  };
+  vkCmdPipelineBarrier(cmdBuf, srcStageMask, dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+void bufferOwnershipBarrier(VkCommandBuffer cmdBuf,
+                            VkBuffer buffer,
+                            VkAccessFlags srcAccessMask,
+                            VkAccessFlags dstAccessMask,
+                            VkPipelineStageFlags srcStageMask,
+                            VkPipelineStageFlags dstStageMask,
+                            uint32_t srcQueueFamilyIndex,
+                            uint32_t dstQueueFamilyIndex,
+                            VkDeviceSize offset,
+                            VkDeviceSize size) {
+  const VkBufferMemoryBarrier barrier = {
+      .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+      .srcAccessMask = srcAccessMask,
+      .dstAccessMask = dstAccessMask,
+      .srcQueueFamilyIndex = srcQueueFamilyIndex,
+      .dstQueueFamilyIndex = dstQueueFamilyIndex,
+      .buffer = buffer,
+      .offset = offset,
+      .size = size,
+  };
+  vkCmdPipelineBarrier(cmdBuf, srcStageMask, dstStageMask, 0, 0, nullptr, 1, &barrier, 0, nullptr);
 }
 
 } // namespace
@@ -43,59 +128,129 @@ VulkanStagingDevice::VulkanStagingDevice(VulkanContext& ctx) : ctx_(ctx) {
 
   const auto& limits = ctx_.getVkPhysicalDeviceProperties().limits;
 
-  // Use default value of 256 MB, and clamp it to the max limits
-  stagingBufferSize_ = std::min(limits.maxStorageBufferRange, 256u * 1024u * 1024u);
-
-  bufferCapacity_ = stagingBufferSize_;
+  // clamp the sizes to the max limits
+  maxSize_ = std::min(limits.maxStorageBufferRange, ctx_.config_.stagingMaxSize);
+  chunkSize_ = std::min(ctx_.config_.stagingChunkSize, maxSize_);
+  IGL_ASSERT(chunkSize_ > 0);
+  // the largest chunk still fits in the budget next to the first one
+  maxChunkSize_ = std::max(maxSize_ - chunkSize_, chunkSize_);
 
-  stagingBuffer_ =
-      ctx_.createBuffer(stagingBufferSize_,
-                        VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                        nullptr,
-                        "Buffer: staging buffer");
-  IGL_ASSERT(stagingBuffer_.get());
+  // the first chunk is added by the first upload or readback and is never released by
+  // releaseIdleChunks()
 
   immediate_ = std::make_unique<igl::vulkan::VulkanImmediateCommands>(
       ctx_.device_->getVkDevice(),
       ctx_.deviceQueues_.graphicsQueueFamilyIndex,
-      "VulkanStagingDevice::immediate_");
+      "VulkanStagingDevice::immediate_",
+      0,
+      ctx_.useTimelineSemaphore_,
+      ctx_.config_.maxCommandBuffersPerQueue);
   IGL_ASSERT(immediate_.get());
+  if (ctx_.submitBatch_) {
+    // staging uploads are batched with the rendering they are submitted between
+    immediate_->setSubmitBatch(ctx_.submitBatch_);
+  }
+
+  if (ctx_.deviceQueues_.transferQueueFamilyIndex != DeviceQueues::INVALID) {
+    transferImmediate_ = std::make_unique<igl::vulkan::VulkanImmediateCommands>(
+        ctx_.device_->getVkDevice(),
+        ctx_.deviceQueues_.transferQueueFamilyIndex,
+        "VulkanStagingDevice::transferImmediate_",
+        ctx_.deviceQueues_.transferQueueIndex,
+        ctx_.useTimelineSemaphore_,
+        ctx_.config_.maxCommandBuffersPerQueue);
+    IGL_ASSERT(transferImmediate_.get());
+  }
 }
 
 void VulkanStagingDevice::bufferSubData(VulkanBuffer& buffer,
                                         size_t dstOffset,
                                         size_t size,
                                         const void* data) {
+  bufferSubDataImpl(buffer, dstOffset, size, data, false);
+}
+
+VulkanSubmitHandle VulkanStagingDevice::bufferSubDataAsync(VulkanBuffer& buffer,
+                                                           size_t dstOffset,
+                                                           size_t size,
+                                                           const void* data) {
+  return bufferSubDataImpl(buffer, dstOffset, size, data, true);
+}
+
+VulkanSubmitHandle VulkanStagingDevice::bufferSubDataImpl(VulkanBuffer& buffer,
+                                                          size_t dstOffset,
+                                                          size_t size,
+                                                          const void* data,
+                                                          bool async) {
   IGL_PROFILER_FUNCTION();
   if (buffer.isMapped()) {
     buffer.bufferSubData(dstOffset, size, data);
-    return;
+    return {};
   }
 
+  uploadedBytes_.fetch_add(size, std::memory_order_relaxed);
+
+  const bool useTransferQueue = async && transferImmediate_;
+  VulkanImmediateCommands& immediate = useTransferQueue ? *transferImmediate_ : *immediate_;
+  // buffers shared by several queue families do not need ownership transfers
+  const bool isShared = !ctx_.sharedQueueFamilyIndices_.empty();
+  const uint32_t graphicsFamily =
+      isShared ? VK_QUEUE_FAMILY_IGNORED : ctx_.deviceQueues_.graphicsQueueFamilyIndex;
+  const uint32_t transferFamily =
+      isShared ? VK_QUEUE_FAMILY_IGNORED : ctx_.deviceQueues_.transferQueueFamilyIndex;
+
   size_t chunkDstOffset = dstOffset;
   void* copyData = const_cast<void*>(data);
+  VulkanSubmitHandle fenceId;
 
   while (size) {
-    // get next staging buffer free offset
-    const MemoryRegionDesc desc = getNextFreeOffset((uint32_t)size);
+    // large uploads are streamed through chunk-sized regions instead of a chunk of their own
+    const MemoryRegionDesc desc = getNextFreeOffset((uint32_t)std::min<size_t>(size, chunkSize_));
     const uint32_t chunkSize = std::min((uint32_t)size, desc.alignedSize_);
 
     // copy data into staging buffer
-    stagingBuffer_->bufferSubData(desc.srcOffset_, chunkSize, copyData);
+    desc.buffer_->bufferSubData(desc.srcOffset_, chunkSize, copyData);
 
     // do the transfer
     const VkBufferCopy copy = {desc.srcOffset_, chunkDstOffset, chunkSize};
 
-    auto& wrapper = immediate_->acquire();
-    vkCmdCopyBuffer(wrapper.cmdBuf_, stagingBuffer_->getVkBuffer(), buffer.getVkBuffer(), 1, &copy);
-    const VulkanSubmitHandle fenceId = immediate_->submit(wrapper);
-    outstandingFences_[fenceId.handle()] = desc;
+    auto& wrapper = immediate.acquire();
+    vkCmdCopyBuffer(wrapper.cmdBuf_, desc.buffer_->getVkBuffer(), buffer.getVkBuffer(), 1, &copy);
+    if (useTransferQueue) {
+      const VkBuffer vkBuffer = buffer.getVkBuffer();
+      bufferOwnershipBarrier(wrapper.cmdBuf_,
+                             vkBuffer,
+                             VK_ACCESS_TRANSFER_WRITE_BIT,
+                             0,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                             transferFamily,
+                             graphicsFamily,
+                             chunkDstOffset,
+                             chunkSize);
+      fenceId = submitTransfer(wrapper, [=](VkCommandBuffer cmdBuf) {
+        bufferOwnershipBarrier(cmdBuf,
+                               vkBuffer,
+                               0,
+                               VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT,
+                               VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                               VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                               transferFamily,
+                               graphicsFamily,
+                               chunkDstOffset,
+                               chunkSize);
+      });
+    } else {
+      fenceId = immediate_->submit(wrapper);
+    }
+    outstandingFences_.push_back({&immediate, fenceId.handle(), desc});
 
     size -= chunkSize;
     copyData = (uint8_t*)copyData + chunkSize;
     chunkDstOffset += chunkSize;
   }
+
+  return fenceId;
 }
 
 void VulkanStagingDevice::getBufferSubData(VulkanBuffer& buffer,
@@ -113,7 +268,7 @@ void VulkanStagingDevice::getBufferSubData(VulkanBuffer& buffer,
 
   while (size) {
     // get next staging buffer free offset
-    const MemoryRegionDesc desc = getNextFreeOffset((uint32_t)size);
+    const MemoryRegionDesc desc = getNextFreeOffset((uint32_t)std::min<size_t>(size, chunkSize_));
     const uint32_t chunkSize = std::min((uint32_t)size, desc.alignedSize_);
 
     // do the transfer
@@ -121,16 +276,16 @@ void VulkanStagingDevice::getBufferSubData(VulkanBuffer& buffer,
 
     auto& wrapper = immediate_->acquire();
 
-    vkCmdCopyBuffer(wrapper.cmdBuf_, buffer.getVkBuffer(), stagingBuffer_->getVkBuffer(), 1, &copy);
+    vkCmdCopyBuffer(wrapper.cmdBuf_, buffer.getVkBuffer(), desc.buffer_->getVkBuffer(), 1, &copy);
 
     VulkanSubmitHandle fenceId = immediate_->submit(wrapper);
-    outstandingFences_[fenceId.handle()] = desc;
+    outstandingFences_.push_back({immediate_.get(), fenceId.handle(), desc});
 
     // Wait for command to finish
     flushOutstandingFences();
 
     // copy data into data
-    const uint8_t* src = stagingBuffer_->getMappedPtr() + desc.srcOffset_;
+    const uint8_t* src = desc.buffer_->getMappedPtr() + desc.srcOffset_;
     checked_memcpy(dstData, size - chunkSrcOffset, src, chunkSize);
 
     size -= chunkSize;
@@ -147,7 +302,103 @@ void VulkanStagingDevice::imageData2D(VulkanImage& image,
                                       TextureFormatProperties properties,
                                       VkFormat format,
                                       const void* data) {
+  imageData2DImpl(
+      image, imageRegion, baseMipLevel, numMipLevels, layer, properties, format, data, false);
+}
+
+VulkanSubmitHandle VulkanStagingDevice::imageData2DAsync(VulkanImage& image,
+                                                         const VkRect2D& imageRegion,
+                                                         uint32_t baseMipLevel,
+                                                         uint32_t numMipLevels,
+                                                         uint32_t layer,
+                                                         TextureFormatProperties properties,
+                                                         VkFormat format,
+                                                         const void* data) {
+  return imageData2DImpl(
+      image, imageRegion, baseMipLevel, numMipLevels, layer, properties, format, data, true);
+}
+
+bool VulkanStagingDevice::copyMemoryToImage(VulkanImage& image,
+                                            const VkExtent3D& extent,
+                                            uint32_t baseMipLevel,
+                                            uint32_t numMipLevels,
+                                            uint32_t layer,
+                                            TextureFormatProperties properties,
+                                            const void* data) {
+#if defined(VK_EXT_host_image_copy)
+  if (!ctx_.useHostImageCopy_ ||
+      (image.getVkImageUsageFlags() & VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT) == 0) {
+    return false;
+  }
+  for (uint32_t level = baseMipLevel; level != baseMipLevel + numMipLevels; ++level) {
+    if (image.getImageLayout(level, layer) != VK_IMAGE_LAYOUT_UNDEFINED) {
+      return false;
+    }
+  }
   IGL_PROFILER_FUNCTION();
+
+  const VkImageSubresourceRange range{
+      VK_IMAGE_ASPECT_COLOR_BIT, baseMipLevel, numMipLevels, layer, 1};
+  const VkHostImageLayoutTransitionInfoEXT transition = {
+      VK_STRUCTURE_TYPE_HOST_IMAGE_LAYOUT_TRANSITION_INFO_EXT,
+      nullptr,
+      image.getVkImage(),
+      VK_IMAGE_LAYOUT_UNDEFINED,
+      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+      range};
+  const VkDevice device = ctx_.device_->getVkDevice();
+  VK_ASSERT(ctx_.vkTransitionImageLayout_(device, 1, &transition));
+
+  // the mip-levels are tightly packed one after another, as in the staging buffer
+  const auto baseRange =
+      TextureRangeDesc::new3D(0, 0, 0, extent.width, extent.height, extent.depth);
+  std::vector<VkMemoryToImageCopyEXT> copies;
+  copies.reserve(numMipLevels);
+  size_t dataOffset = 0;
+  for (uint32_t mipLevel = 0; mipLevel != numMipLevels; ++mipLevel) {
+    const auto levelRange = baseRange.atMipLevel(mipLevel);
+    copies.push_back(VkMemoryToImageCopyEXT{
+        VK_STRUCTURE_TYPE_MEMORY_TO_IMAGE_COPY_EXT,
+        nullptr,
+        static_cast<const uint8_t*>(data) + dataOffset,
+        0,
+        0,
+        VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, baseMipLevel + mipLevel, layer, 1},
+        VkOffset3D{0, 0, 0},
+        VkExtent3D{static_cast<uint32_t>(levelRange.width),
+                   static_cast<uint32_t>(levelRange.height),
+                   static_cast<uint32_t>(levelRange.depth)}});
+    dataOffset += properties.getBytesPerRange(levelRange);
+  }
+  const VkCopyMemoryToImageInfoEXT copyInfo = {VK_STRUCTURE_TYPE_COPY_MEMORY_TO_IMAGE_INFO_EXT,
+                                               nullptr,
+                                               0,
+                                               image.getVkImage(),
+                                               VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                               static_cast<uint32_t>(copies.size()),
+                                               copies.data()};
+  VK_ASSERT(ctx_.vkCopyMemoryToImage_(device, &copyInfo));
+
+  image.setImageLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, range);
+  return true;
+#else
+  return false;
+#endif // VK_EXT_host_image_copy
+}
+
+VulkanSubmitHandle VulkanStagingDevice::imageData2DImpl(VulkanImage& image,
+                                                        const VkRect2D& imageRegion,
+                                                        uint32_t baseMipLevel,
+                                                        uint32_t numMipLevels,
+                                                        uint32_t layer,
+                                                        TextureFormatProperties properties,
+                                                        VkFormat format,
+                                                        const void* data,
+                                                        bool async) {
+  IGL_PROFILER_FUNCTION();
+  const bool useTransferQueue = async && transferImmediate_;
+  VulkanImmediateCommands& immediate = useTransferQueue ? *transferImmediate_ : *immediate_;
+
   // cache the dimensions of each mip level for later
   std::vector<uint32_t> mipSizes;
   mipSizes.reserve(numMipLevels);
@@ -163,6 +414,17 @@ void VulkanStagingDevice::imageData2D(VulkanImage& image,
       "Uploading mip levels with an image region that is smaller than the base mip level is "
       "not supported");
 
+  // nothing is submitted, so there is no handle to wait for
+  if (copyMemoryToImage(image,
+                        VkExtent3D{imageRegion.extent.width, imageRegion.extent.height, 1},
+                        baseMipLevel,
+                        numMipLevels,
+                        layer,
+                        properties,
+                        data)) {
+    return VulkanSubmitHandle();
+  }
+
   // find the storage size for all mip levels being uploaded
   const auto range = TextureRangeDesc::new2D(0, 0, image.extent_.width, image.extent_.height);
   uint32_t storageSize = 0;
@@ -176,7 +438,9 @@ void VulkanStagingDevice::imageData2D(VulkanImage& image,
     height = height <= 1 ? 1 : height >> 1; // divide the height by 2
   }
 
-  IGL_ASSERT(storageSize <= stagingBufferSize_);
+  IGL_ASSERT(storageSize <= maxChunkSize_);
+
+  uploadedBytes_.fetch_add(storageSize, std::memory_order_relaxed);
 
   // get next staging buffer free offset
   MemoryRegionDesc desc = getNextFreeOffset(storageSize);
@@ -191,9 +455,9 @@ void VulkanStagingDevice::imageData2D(VulkanImage& image,
   IGL_ASSERT(desc.alignedSize_ >= storageSize);
 
   // 1. Copy the pixel data into the host visible staging buffer
-  stagingBuffer_->bufferSubData(desc.srcOffset_, storageSize, data);
+  desc.buffer_->bufferSubData(desc.srcOffset_, storageSize, data);
 
-  auto& wrapper = immediate_->acquire();
+  auto& wrapper = immediate.acquire();
 
   uint32_t mipLevelOffset = 0;
 
@@ -231,32 +495,198 @@ void VulkanStagingDevice::imageData2D(VulkanImage& image,
     IGL_LOG_INFO("%p vkCmdCopyBufferToImage()\n", wrapper.cmdBuf_);
 #endif // IGL_VULKAN_PRINT_COMMANDS
     vkCmdCopyBufferToImage(wrapper.cmdBuf_,
-                           stagingBuffer_->getVkBuffer(),
+                           desc.buffer_->getVkBuffer(),
                            image.getVkImage(),
                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                            1,
                            &copy);
 
-    // 3. Transition TRANSFER_DST_OPTIMAL into SHADER_READ_ONLY_OPTIMAL
-    ivkImageMemoryBarrier(
-        wrapper.cmdBuf_,
-        image.getVkImage(),
-        VK_ACCESS_TRANSFER_READ_BIT, // VK_ACCESS_TRANSFER_WRITE_BIT,
-        VK_ACCESS_SHADER_READ_BIT,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-        VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, currentMipLevel, 1, layer, 1});
+    // 3. Transition TRANSFER_DST_OPTIMAL into SHADER_READ_ONLY_OPTIMAL (on the transfer queue, this
+    // is done for all levels at once by the ownership transfer below)
+    if (!useTransferQueue) {
+      ivkImageMemoryBarrier(
+          wrapper.cmdBuf_,
+          image.getVkImage(),
+          VK_ACCESS_TRANSFER_READ_BIT, // VK_ACCESS_TRANSFER_WRITE_BIT,
+          VK_ACCESS_SHADER_READ_BIT,
+          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+          VK_PIPELINE_STAGE_TRANSFER_BIT,
+          VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+          VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, currentMipLevel, 1, layer, 1});
+    }
 
     // Compute the offset for the next level
     mipLevelOffset += mipSizes[mipLevel];
   }
 
-  image.imageLayout_ = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  // other mip-levels and layers keep their layouts
+  image.setImageLayout(
+      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+      VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, baseMipLevel, numMipLevels, layer, 1});
+
+  VulkanSubmitHandle fenceId;
+
+  if (useTransferQueue) {
+    const VkImage vkImage = image.getVkImage();
+    // images shared by several queue families do not need ownership transfers: the layout
+    // transition below is enough and the graphics queue must not repeat it
+    const bool isShared = !ctx_.sharedQueueFamilyIndices_.empty();
+    const uint32_t graphicsFamily =
+        isShared ? VK_QUEUE_FAMILY_IGNORED : ctx_.deviceQueues_.graphicsQueueFamilyIndex;
+    const uint32_t transferFamily =
+        isShared ? VK_QUEUE_FAMILY_IGNORED : ctx_.deviceQueues_.transferQueueFamilyIndex;
+    const VkImageSubresourceRange range{
+        VK_IMAGE_ASPECT_COLOR_BIT, baseMipLevel, numMipLevels, layer, 1};
+    imageOwnershipBarrier(wrapper.cmdBuf_,
+                          vkImage,
+                          VK_ACCESS_TRANSFER_WRITE_BIT,
+                          0,
+                          VK_PIPELINE_STAGE_TRANSFER_BIT,
+                          VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                          transferFamily,
+                          graphicsFamily,
+                          range);
+    fenceId = submitTransfer(wrapper, [=](VkCommandBuffer cmdBuf) {
+      if (isShared) {
+        return;
+      }
+      imageOwnershipBarrier(cmdBuf,
+                            vkImage,
+                            0,
+                            VK_ACCESS_SHADER_READ_BIT,
+                            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                            transferFamily,
+                            graphicsFamily,
+                            range);
+    });
+  } else {
+    fenceId = immediate_->submit(wrapper);
+  }
+  outstandingFences_.push_back({&immediate, fenceId.handle(), desc});
 
-  VulkanSubmitHandle fenceId = immediate_->submit(wrapper);
-  outstandingFences_[fenceId.handle()] = desc;
+  return fenceId;
+}
+
+void VulkanStagingDevice::imageRegions2D(VulkanImage& image,
+                                         const std::vector<ImageRegion2D>& regions,
+                                         TextureFormatProperties properties) {
+  IGL_PROFILER_FUNCTION();
+
+  // buffer offsets of copies must be multiples of 4 and of the texel block size
+  const uint32_t offsetAlignment = std::lcm(4u, static_cast<uint32_t>(properties.bytesPerBlock));
+
+  auto getRowSize = [&properties](const ImageRegion2D& region) {
+    return properties.getBytesPerRow(TextureRangeDesc::new1D(0, region.imageRegion.extent.width));
+  };
+  auto getNumRows = [&properties](const ImageRegion2D& region) {
+    return properties.getRows(TextureRangeDesc::new2D(
+        0, 0, region.imageRegion.extent.width, region.imageRegion.extent.height));
+  };
+
+  std::vector<uint32_t> offsets;
+  std::vector<VkBufferImageCopy> copies;
+  std::set<std::pair<uint32_t, uint32_t>> subresources;
+
+  size_t first = 0;
+  while (first < regions.size()) {
+    // 1. Gather as many regions as a staging chunk can hold
+    offsets.clear();
+    uint32_t storageSize = 0;
+    size_t last = first;
+    for (; last < regions.size(); ++last) {
+      const uint32_t offset =
+          (storageSize + offsetAlignment - 1) / offsetAlignment * offsetAlignment;
+      const auto size =
+          static_cast<uint32_t>(getRowSize(regions[last]) * getNumRows(regions[last]));
+      if (last > first && offset + size > chunkSize_) {
+        break;
+      }
+      offsets.push_back(offset);
+      storageSize = offset + size;
+    }
+
+    IGL_ASSERT(storageSize <= maxChunkSize_);
+
+    uploadedBytes_.fetch_add(storageSize, std::memory_order_relaxed);
+
+    MemoryRegionDesc desc = getNextFreeOffset(storageSize);
+    if (desc.alignedSize_ < storageSize) {
+      flushOutstandingFences();
+      desc = getNextFreeOffset(storageSize);
+    }
+
+    IGL_ASSERT(desc.alignedSize_ >= storageSize);
+
+    // 2. Copy the pixels of every region into the staging buffer, without their row padding
+    copies.clear();
+    subresources.clear();
+    for (size_t i = first; i != last; ++i) {
+      const ImageRegion2D& region = regions[i];
+      const uint32_t bufferOffset = desc.srcOffset_ + offsets[i - first];
+      const size_t rowSize = getRowSize(region);
+      const size_t numRows = getNumRows(region);
+      if (region.bytesPerRow == 0 || region.bytesPerRow == rowSize) {
+        desc.buffer_->bufferSubData(bufferOffset, rowSize * numRows, region.data);
+      } else {
+        for (size_t row = 0; row != numRows; ++row) {
+          desc.buffer_->bufferSubData(bufferOffset + row * rowSize,
+                                        rowSize,
+                                        static_cast<const uint8_t*>(region.data) +
+                                            row * region.bytesPerRow);
+        }
+      }
+      copies.push_back(ivkGetBufferImageCopy2D(
+          bufferOffset,
+          region.imageRegion,
+          VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, region.mipLevel, region.layer, 1}));
+      subresources.emplace(region.mipLevel, region.layer);
+    }
+
+    auto& wrapper = immediate_->acquire();
+
+    // 3. Transition the updated subresources into TRANSFER_DST_OPTIMAL, keeping their contents
+    for (const auto& [mipLevel, layer] : subresources) {
+      image.transitionLayout(
+          wrapper.cmdBuf_,
+          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+          VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+          VK_PIPELINE_STAGE_TRANSFER_BIT,
+          VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, mipLevel, 1, layer, 1});
+    }
+
+    // 4. Copy all the regions at once
+#if IGL_VULKAN_PRINT_COMMANDS
+    IGL_LOG_INFO(
+        "%p vkCmdCopyBufferToImage(%u regions)\n", wrapper.cmdBuf_, (uint32_t)copies.size());
+#endif // IGL_VULKAN_PRINT_COMMANDS
+    {
+      IGL_PROFILER_ZONE_GPU_COLOR_VK(
+          "imageRegions2D", ctx_.tracyCtx_, wrapper.cmdBuf_, IGL_PROFILER_COLOR_UPLOAD);
+      vkCmdCopyBufferToImage(wrapper.cmdBuf_,
+                             desc.buffer_->getVkBuffer(),
+                             image.getVkImage(),
+                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                             static_cast<uint32_t>(copies.size()),
+                             copies.data());
+    }
+
+    // 5. Transition the updated subresources into SHADER_READ_ONLY_OPTIMAL
+    for (const auto& [mipLevel, layer] : subresources) {
+      image.transitionLayout(
+          wrapper.cmdBuf_,
+          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+          VK_PIPELINE_STAGE_TRANSFER_BIT,
+          VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+          VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, mipLevel, 1, layer, 1});
+    }
+
+    const VulkanSubmitHandle fenceId = immediate_->submit(wrapper);
+    outstandingFences_.push_back({immediate_.get(), fenceId.handle(), desc});
+
+    first = last;
+  }
 }
 
 void VulkanStagingDevice::imageData3D(VulkanImage& image,
@@ -270,11 +700,17 @@ void VulkanStagingDevice::imageData3D(VulkanImage& image,
   IGL_ASSERT_MSG((offset.x == 0) && (offset.y == 0) && (offset.z == 0),
                  "Can upload only full-size 3D images");
 
+  if (copyMemoryToImage(image, extent, 0, 1, 0, properties, data)) {
+    return;
+  }
+
   const auto range = TextureRangeDesc::new3D(0, 0, 0, extent.width, extent.height, extent.depth);
   const uint32_t storageSize =
       static_cast<uint32_t>(properties.getBytesPerRange(range.atMipLevel(0)));
 
-  IGL_ASSERT(storageSize <= stagingBufferSize_);
+  IGL_ASSERT(storageSize <= maxChunkSize_);
+
+  uploadedBytes_.fetch_add(storageSize, std::memory_order_relaxed);
 
   // get next staging buffer free offset
   MemoryRegionDesc desc = getNextFreeOffset(storageSize);
@@ -289,7 +725,7 @@ void VulkanStagingDevice::imageData3D(VulkanImage& image,
   IGL_ASSERT(desc.alignedSize_ >= storageSize);
 
   // 1. Copy the pixel data into the host visible staging buffer
-  stagingBuffer_->bufferSubData(desc.srcOffset_, storageSize, data);
+  desc.buffer_->bufferSubData(desc.srcOffset_, storageSize, data);
 
   auto& wrapper = immediate_->acquire();
 
@@ -311,7 +747,7 @@ void VulkanStagingDevice::imageData3D(VulkanImage& image,
                               extent,
                               VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1});
   vkCmdCopyBufferToImage(wrapper.cmdBuf_,
-                         stagingBuffer_->getVkBuffer(),
+                         desc.buffer_->getVkBuffer(),
                          image.getVkImage(),
                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                          1,
@@ -328,10 +764,11 @@ void VulkanStagingDevice::imageData3D(VulkanImage& image,
                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                         VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1});
 
-  image.imageLayout_ = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  image.setImageLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                       VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1});
 
   VulkanSubmitHandle fenceId = immediate_->submit(wrapper);
-  outstandingFences_[fenceId.handle()] = desc;
+  outstandingFences_.push_back({immediate_.get(), fenceId.handle(), desc});
 }
 
 void VulkanStagingDevice::getImageData2D(VkImage srcImage,
@@ -351,10 +788,23 @@ void VulkanStagingDevice::getImageData2D(VkImage srcImage,
       TextureRangeDesc::new2D(0, 0, imageRegion.extent.width, imageRegion.extent.height);
   const uint32_t storageSize =
       static_cast<uint32_t>(properties.getBytesPerRange(range.atMipLevel(0)));
-  IGL_ASSERT(storageSize <= stagingBufferSize_);
 
   IGL_ASSERT(dataBytesPerRow == properties.getBytesPerRow(range.atMipLevel(0)));
 
+  if (getImageData2DToHostPointer(srcImage,
+                                  level,
+                                  layer,
+                                  imageRegion,
+                                  layout,
+                                  data,
+                                  storageSize,
+                                  dataBytesPerRow,
+                                  flipImageVertical)) {
+    return;
+  }
+
+  IGL_ASSERT(storageSize <= maxChunkSize_);
+
   // get next staging buffer free offset
   MemoryRegionDesc desc = getNextFreeOffset(storageSize);
 
@@ -380,36 +830,28 @@ void VulkanStagingDevice::getImageData2D(VkImage srcImage,
                         VK_PIPELINE_STAGE_TRANSFER_BIT, // dstStageMask
                         VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, level, 1, layer, 1});
 
-  // 2.  Copy the pixel data from the image into the staging buffer
-  const VkBufferImageCopy copy =
-      ivkGetBufferImageCopy2D(desc.srcOffset_,
-                              imageRegion,
-                              VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, level, layer, 1});
-  vkCmdCopyImageToBuffer(wrapper1.cmdBuf_,
-                         srcImage,
-                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                         stagingBuffer_->getVkBuffer(),
-                         1,
-                         &copy);
+  // 2.  Copy the pixel data from the image into the staging buffer, flipping it if needed
+  copyImageToBuffer(wrapper1.cmdBuf_,
+                    srcImage,
+                    desc.buffer_->getVkBuffer(),
+                    desc.srcOffset_,
+                    imageRegion,
+                    VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, level, layer, 1},
+                    dataBytesPerRow,
+                    flipImageVertical);
 
   VulkanSubmitHandle fenceId = immediate_->submit(wrapper1);
-  outstandingFences_[fenceId.handle()] = desc;
+  outstandingFences_.push_back({immediate_.get(), fenceId.handle(), desc});
 
   flushOutstandingFences();
 
   // 3. Copy data from staging buffer into data
-  if (!IGL_VERIFY(stagingBuffer_->getMappedPtr())) {
+  if (!IGL_VERIFY(desc.buffer_->getMappedPtr())) {
     return;
   }
 
-  const uint8_t* src = stagingBuffer_->getMappedPtr() + desc.srcOffset_;
-  uint8_t* dst = static_cast<uint8_t*>(data);
-
-  if (flipImageVertical) {
-    flipBMP(dst, src, imageRegion.extent.height, properties.getBytesPerRow(range.atMipLevel(0)));
-  } else {
-    checked_memcpy(dst, storageSize, src, storageSize);
-  }
+  // the staging memory is already in final layout
+  checked_memcpy(data, storageSize, desc.buffer_->getMappedPtr() + desc.srcOffset_, storageSize);
 
   // 4. Transition back to the initial image layout
   auto& wrapper2 = immediate_->acquire();
@@ -425,26 +867,440 @@ void VulkanStagingDevice::getImageData2D(VkImage srcImage,
                         VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, level, 1, layer, 1});
 
   fenceId = immediate_->submit(wrapper2);
-  outstandingFences_[fenceId.handle()] = desc;
+  outstandingFences_.push_back({immediate_.get(), fenceId.handle(), desc});
+}
+
+bool VulkanStagingDevice::getImageData2DToHostPointer(VkImage srcImage,
+                                                      uint32_t level,
+                                                      uint32_t layer,
+                                                      const VkRect2D& imageRegion,
+                                                      VkImageLayout layout,
+                                                      void* data,
+                                                      uint32_t size,
+                                                      uint32_t bytesPerRow,
+                                                      bool flipImageVertical) {
+#if defined(VK_EXT_external_memory_host)
+  if (!ctx_.useExternalMemoryHost_ || size < kMinHostPointerReadbackSize) {
+    return false;
+  }
+  // the imported range must be aligned on both ends
+  const VkDeviceSize alignment =
+      ctx_.vkPhysicalDeviceExternalMemoryHostProperties_.minImportedHostPointerAlignment;
+  if (reinterpret_cast<uintptr_t>(data) % alignment != 0 || size % alignment != 0) {
+    return false;
+  }
+
+  IGL_PROFILER_FUNCTION();
+
+  const VkDevice device = ctx_.getVkDevice();
+  VkMemoryHostPointerPropertiesEXT hostPointerProperties = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT,
+  };
+  if (ctx_.vkGetMemoryHostPointerProperties_(device,
+                                             VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+                                             data,
+                                             &hostPointerProperties) != VK_SUCCESS) {
+    return false;
+  }
+
+  const VkExternalMemoryBufferCreateInfo externalMemoryInfo = {
+      .sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO,
+      .handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+  };
+  const VkBufferCreateInfo bufferInfo = {
+      .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+      .pNext = &externalMemoryInfo,
+      .size = size,
+      .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+  };
+  VkBuffer buffer = VK_NULL_HANDLE;
+  if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
+    return false;
+  }
+  VkMemoryRequirements requirements = {};
+  vkGetBufferMemoryRequirements(device, buffer, &requirements);
+
+  // the GPU writes have to be visible to the host without mapping the memory to invalidate it
+  VkPhysicalDeviceMemoryProperties memoryProperties = {};
+  vkGetPhysicalDeviceMemoryProperties(ctx_.getVkPhysicalDevice(), &memoryProperties);
+  const uint32_t memoryTypeBits =
+      hostPointerProperties.memoryTypeBits & requirements.memoryTypeBits;
+  uint32_t memoryTypeIndex = VK_MAX_MEMORY_TYPES;
+  for (uint32_t i = 0; i != memoryProperties.memoryTypeCount; i++) {
+    if ((memoryTypeBits & (1u << i)) != 0 &&
+        (memoryProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+      memoryTypeIndex = i;
+      break;
+    }
+  }
+
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  if (memoryTypeIndex != VK_MAX_MEMORY_TYPES && requirements.size <= size) {
+    const VkImportMemoryHostPointerInfoEXT importInfo = {
+        .sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT,
+        .handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+        .pHostPointer = data,
+    };
+    const VkMemoryAllocateInfo allocateInfo = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .pNext = &importInfo,
+        .allocationSize = size,
+        .memoryTypeIndex = memoryTypeIndex,
+    };
+    if (vkAllocateMemory(device, &allocateInfo, nullptr, &memory) != VK_SUCCESS) {
+      memory = VK_NULL_HANDLE;
+    }
+  }
+  if (memory == VK_NULL_HANDLE || vkBindBufferMemory(device, buffer, memory, 0) != VK_SUCCESS) {
+    vkDestroyBuffer(device, buffer, nullptr);
+    if (memory != VK_NULL_HANDLE) {
+      vkFreeMemory(device, memory, nullptr);
+    }
+    return false;
+  }
+
+  auto& wrapper = immediate_->acquire();
+
+  const VkImageSubresourceRange range = {VK_IMAGE_ASPECT_COLOR_BIT, level, 1, layer, 1};
+
+  // 1. Transition to VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+  ivkImageMemoryBarrier(wrapper.cmdBuf_,
+                        srcImage,
+                        0, // srcAccessMask
+                        VK_ACCESS_TRANSFER_READ_BIT, // dstAccessMask
+                        layout,
+                        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, // wait for any previous operation
+                        VK_PIPELINE_STAGE_TRANSFER_BIT, // dstStageMask
+                        range);
+
+  // 2. Copy the pixel data from the image into the client memory, flipping it if needed
+  copyImageToBuffer(wrapper.cmdBuf_,
+                    srcImage,
+                    buffer,
+                    0,
+                    imageRegion,
+                    VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, level, layer, 1},
+                    bytesPerRow,
+                    flipImageVertical);
+
+  // 3. Transition back to the initial image layout in the same command buffer
+  ivkImageMemoryBarrier(wrapper.cmdBuf_,
+                        srcImage,
+                        VK_ACCESS_TRANSFER_READ_BIT, // srcAccessMask
+                        0, // dstAccessMask
+                        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                        layout,
+                        VK_PIPELINE_STAGE_TRANSFER_BIT, // srcStageMask
+                        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, // dstStageMask
+                        range);
+
+  // 4. Make the copy available to the host
+  ivkBufferMemoryBarrier(wrapper.cmdBuf_,
+                         buffer,
+                         VK_ACCESS_TRANSFER_WRITE_BIT, // srcAccessMask
+                         VK_ACCESS_HOST_READ_BIT, // dstAccessMask
+                         0,
+                         VK_WHOLE_SIZE,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, // srcStageMask
+                         VK_PIPELINE_STAGE_HOST_BIT); // dstStageMask
+
+  immediate_->wait(immediate_->submit(wrapper));
+
+  // the client keeps its memory, only the import is released
+  vkDestroyBuffer(device, buffer, nullptr);
+  vkFreeMemory(device, memory, nullptr);
+  return true;
+#else
+  return false;
+#endif // VK_EXT_external_memory_host
+}
+
+VulkanSubmitHandle VulkanStagingDevice::getBufferSubDataAsync(VulkanBuffer& buffer,
+                                                              size_t srcOffset,
+                                                              size_t size,
+                                                              VulkanBuffer& dstBuffer,
+                                                              size_t dstOffset) {
+  IGL_PROFILER_FUNCTION();
+  IGL_ASSERT(dstBuffer.isMapped());
+  IGL_ASSERT(srcOffset + size <= buffer.getSize());
+  IGL_ASSERT(dstOffset + size <= dstBuffer.getSize());
+
+  auto& wrapper = immediate_->acquire();
+
+  // wait for any previous writes into the source buffer
+  ivkBufferMemoryBarrier(wrapper.cmdBuf_,
+                         buffer.getVkBuffer(),
+                         VK_ACCESS_MEMORY_WRITE_BIT, // srcAccessMask
+                         VK_ACCESS_TRANSFER_READ_BIT, // dstAccessMask
+                         srcOffset,
+                         size,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, // srcStageMask
+                         VK_PIPELINE_STAGE_TRANSFER_BIT); // dstStageMask
+
+  const VkBufferCopy copy = {srcOffset, dstOffset, size};
+  vkCmdCopyBuffer(wrapper.cmdBuf_, buffer.getVkBuffer(), dstBuffer.getVkBuffer(), 1, &copy);
+
+  // make the copy available to the host
+  ivkBufferMemoryBarrier(wrapper.cmdBuf_,
+                         dstBuffer.getVkBuffer(),
+                         VK_ACCESS_TRANSFER_WRITE_BIT, // srcAccessMask
+                         VK_ACCESS_HOST_READ_BIT, // dstAccessMask
+                         dstOffset,
+                         size,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, // srcStageMask
+                         VK_PIPELINE_STAGE_HOST_BIT); // dstStageMask
+
+  return immediate_->submit(wrapper);
+}
+
+VulkanSubmitHandle VulkanStagingDevice::getImageData2DAsync(VkImage srcImage,
+                                                            uint32_t level,
+                                                            uint32_t layer,
+                                                            const VkRect2D& imageRegion,
+                                                            VkImageLayout layout,
+                                                            VulkanBuffer& dstBuffer,
+                                                            size_t dstOffset,
+                                                            bool flipImageVertical,
+                                                            uint32_t bytesPerRow) {
+  IGL_PROFILER_FUNCTION();
+  IGL_ASSERT(layout != VK_IMAGE_LAYOUT_UNDEFINED);
+  IGL_ASSERT(dstBuffer.isMapped());
+  IGL_ASSERT(!flipImageVertical || bytesPerRow > 0);
+
+  auto& wrapper = immediate_->acquire();
+
+  const VkImageSubresourceRange range = {VK_IMAGE_ASPECT_COLOR_BIT, level, 1, layer, 1};
+
+  // 1. Transition to VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+  ivkImageMemoryBarrier(wrapper.cmdBuf_,
+                        srcImage,
+                        0, // srcAccessMask
+                        VK_ACCESS_TRANSFER_READ_BIT, // dstAccessMask
+                        layout,
+                        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, // wait for any previous operation
+                        VK_PIPELINE_STAGE_TRANSFER_BIT, // dstStageMask
+                        range);
+
+  // 2. Copy the pixel data from the image into the readback buffer, flipping it if needed
+  copyImageToBuffer(wrapper.cmdBuf_,
+                    srcImage,
+                    dstBuffer.getVkBuffer(),
+                    static_cast<uint32_t>(dstOffset),
+                    imageRegion,
+                    VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, level, layer, 1},
+                    bytesPerRow,
+                    flipImageVertical);
+
+  // 3. Transition back to the initial image layout in the same command buffer
+  ivkImageMemoryBarrier(wrapper.cmdBuf_,
+                        srcImage,
+                        VK_ACCESS_TRANSFER_READ_BIT, // srcAccessMask
+                        0, // dstAccessMask
+                        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                        layout,
+                        VK_PIPELINE_STAGE_TRANSFER_BIT, // srcStageMask
+                        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, // dstStageMask
+                        range);
+
+  // 4. Make the copy available to the host
+  ivkBufferMemoryBarrier(wrapper.cmdBuf_,
+                         dstBuffer.getVkBuffer(),
+                         VK_ACCESS_TRANSFER_WRITE_BIT, // srcAccessMask
+                         VK_ACCESS_HOST_READ_BIT, // dstAccessMask
+                         dstOffset,
+                         VK_WHOLE_SIZE,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, // srcStageMask
+                         VK_PIPELINE_STAGE_HOST_BIT); // dstStageMask
+
+  return immediate_->submit(wrapper);
+}
+
+bool VulkanStagingDevice::isReadbackReady(VulkanSubmitHandle handle) const {
+  return immediate_->isReady(handle);
+}
+
+void VulkanStagingDevice::waitReadback(VulkanSubmitHandle handle, const VulkanBuffer& dstBuffer) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
+
+  immediate_->wait(handle);
+
+  // the memory can be non-coherent even if HOST_COHERENT was requested
+  dstBuffer.invalidateMappedMemory(0, VK_WHOLE_SIZE);
+}
+
+VulkanSubmitHandle VulkanStagingDevice::submitTransfer(
+    const VulkanImmediateCommands::CommandBufferWrapper& wrapper,
+    const std::function<void(VkCommandBuffer)>& acquireOwnership) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_SUBMIT);
+  IGL_ASSERT(transferImmediate_);
+
+  const VulkanSubmitHandle handle = transferImmediate_->submit(wrapper);
+
+  auto& graphicsWrapper = immediate_->acquire();
+  acquireOwnership(graphicsWrapper.cmdBuf_);
+
+  if (transferImmediate_->hasTimelineSemaphore()) {
+    immediate_->waitTimelineSemaphore(transferImmediate_->getTimelineSemaphore(),
+                                      transferImmediate_->getSignalValue(handle));
+  } else {
+    // the binary semaphore is consumed by the graphics queue, so the next transfer submit should
+    // not wait on it (transfer submits are ordered by the queue anyway)
+    immediate_->waitSemaphore(transferImmediate_->acquireLastSubmitSemaphore());
+  }
+  immediate_->submit(graphicsWrapper);
+
+  return handle;
+}
+
+bool VulkanStagingDevice::isTransferReady(VulkanSubmitHandle handle) const {
+  if (handle.empty()) {
+    return true;
+  }
+  return transferImmediate_ ? transferImmediate_->isReady(handle) : immediate_->isReady(handle);
+}
+
+void VulkanStagingDevice::waitTransfer(VulkanSubmitHandle handle) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
+  if (handle.empty()) {
+    return;
+  }
+  if (transferImmediate_) {
+    transferImmediate_->wait(handle);
+  } else {
+    immediate_->wait(handle);
+  }
 }
 
 uint32_t VulkanStagingDevice::getAlignedSize(uint32_t size) const {
   return (size + stagingBufferAlignment_ - 1) & ~(stagingBufferAlignment_ - 1);
 }
 
+VulkanStagingDevice::StagingChunk* VulkanStagingDevice::addChunk(uint32_t minSize) {
+  const uint32_t size = std::max(chunkSize_, minSize);
+
+  auto getTotalSize = [this]() {
+    uint64_t totalSize = 0;
+    for (const StagingChunk& chunk : chunks_) {
+      totalSize += chunk.size_;
+    }
+    return totalSize;
+  };
+
+  // make room by releasing chunks which are not in use, except the first one. Chunks with completed
+  // regions were rewound by rewindIdleChunks()
+  for (auto it = chunks_.empty() ? chunks_.end() : chunks_.begin() + 1;
+       it != chunks_.end() && getTotalSize() + size > maxSize_;) {
+    it = it->frontOffset_ == 0 ? chunks_.erase(it) : it + 1;
+  }
+
+  if (getTotalSize() + size > maxSize_) {
+    return nullptr;
+  }
+
+  StagingChunk chunk;
+  chunk.buffer_ = ctx_.createBuffer(size,
+                                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                    nullptr,
+                                    "Buffer: staging buffer");
+  if (!IGL_VERIFY(chunk.buffer_)) {
+    return nullptr;
+  }
+  chunk.size_ = size;
+  chunk.lastUsedSubmit_ = numSubmits_;
+
+#if IGL_VULKAN_DEBUG_STAGING_DEVICE
+  IGL_LOG_INFO("Adding staging chunk: %u bytes\n", size);
+#endif
+
+  chunks_.push_back(std::move(chunk));
+  return &chunks_.back();
+}
+
+VulkanStagingDevice::MemoryRegionDesc VulkanStagingDevice::allocateFromChunk(StagingChunk& chunk,
+                                                                             uint32_t size) {
+  IGL_ASSERT(size <= chunk.size_ - chunk.frontOffset_);
+  const MemoryRegionDesc desc = {chunk.buffer_.get(), chunk.frontOffset_, size};
+  chunk.frontOffset_ += size;
+  chunk.lastUsedSubmit_ = numSubmits_;
+
+#if IGL_VULKAN_DEBUG_STAGING_DEVICE
+  IGL_LOG_INFO("Allocating new memory region: %u bytes\n", size);
+#endif
+
+  return desc;
+}
+
+void VulkanStagingDevice::rewindIdleChunks() {
+  if (outstandingFences_.empty()) {
+    return;
+  }
+
+  // chunks with regions which are still read or written by the GPU
+  std::vector<const VulkanBuffer*> busyBuffers;
+  for (const OutstandingRegion& region : outstandingFences_) {
+    if (!region.immediate_->isReady(VulkanSubmitHandle(region.handle_))) {
+      busyBuffers.push_back(region.desc_.buffer_);
+    }
+  }
+
+  for (StagingChunk& chunk : chunks_) {
+    const VulkanBuffer* buffer = chunk.buffer_.get();
+    if (chunk.frontOffset_ == 0 ||
+        std::find(busyBuffers.begin(), busyBuffers.end(), buffer) != busyBuffers.end()) {
+      continue;
+    }
+    // all regions of the chunk were consumed: its whole space is free again
+    outstandingFences_.erase(std::remove_if(outstandingFences_.begin(),
+                                            outstandingFences_.end(),
+                                            [buffer](const OutstandingRegion& region) {
+                                              return region.desc_.buffer_ == buffer;
+                                            }),
+                             outstandingFences_.end());
+    chunk.frontOffset_ = 0;
+  }
+}
+
+void VulkanStagingDevice::releaseIdleChunks() {
+  IGL_PROFILER_FUNCTION();
+
+  numSubmits_++;
+
+  rewindIdleChunks();
+
+  // the first chunk is kept to serve light loads without allocations
+  for (size_t i = chunks_.size(); i-- > 1;) {
+    const StagingChunk& chunk = chunks_[i];
+    if (chunk.frontOffset_ == 0 && numSubmits_ - chunk.lastUsedSubmit_ > kNumIdleSubmits) {
+#if IGL_VULKAN_DEBUG_STAGING_DEVICE
+      IGL_LOG_INFO("Releasing idle staging chunk: %u bytes\n", chunk.size_);
+#endif
+      chunks_.erase(chunks_.begin() + i);
+    }
+  }
+}
+
 VulkanStagingDevice::MemoryRegionDesc VulkanStagingDevice::getNextFreeOffset(uint32_t size) {
   IGL_PROFILER_FUNCTION();
-  uint32_t alignedSize = getAlignedSize(size);
+  // larger uploads cannot be staged at once, the region returned is smaller than requested
+  const uint32_t alignedSize = std::min(getAlignedSize(size), maxChunkSize_);
+
+  rewindIdleChunks();
 
   // track maximum previously used region
   MemoryRegionDesc maxRegionDesc;
-  VulkanSubmitHandle maxRegionFence = VulkanSubmitHandle();
+  auto maxRegion = outstandingFences_.end();
 
   // check if we can reuse any of previously used memory region
-  for (auto [handle, desc] : outstandingFences_) {
-    if (immediate_->isReady(VulkanSubmitHandle(handle))) {
+  for (auto it = outstandingFences_.begin(); it != outstandingFences_.end(); ++it) {
+    if (it->immediate_->isReady(VulkanSubmitHandle(it->handle_))) {
+      const MemoryRegionDesc desc = it->desc_;
       if (desc.alignedSize_ >= alignedSize) {
-        outstandingFences_.erase(handle);
+        outstandingFences_.erase(it);
 #if IGL_VULKAN_DEBUG_STAGING_DEVICE
         IGL_LOG_INFO("Reusing memory region %u bytes\n", desc.alignedSize_);
 #endif
@@ -453,35 +1309,50 @@ VulkanStagingDevice::MemoryRegionDesc VulkanStagingDevice::getNextFreeOffset(uin
 
       if (maxRegionDesc.alignedSize_ < desc.alignedSize_) {
         maxRegionDesc = desc;
-        maxRegionFence = VulkanSubmitHandle(handle);
+        maxRegion = it;
       }
     }
   }
 
-  if (!maxRegionFence.empty() && bufferCapacity_ < maxRegionDesc.alignedSize_) {
-    outstandingFences_.erase(maxRegionFence.handle());
+  // allocate from the free space of a chunk
+  for (StagingChunk& chunk : chunks_) {
+    if (chunk.size_ - chunk.frontOffset_ >= alignedSize) {
+      return allocateFromChunk(chunk, alignedSize);
+    }
+  }
+
+  // add a chunk under load, as long as the total size stays within the budget
+  if (StagingChunk* chunk = addChunk(alignedSize)) {
+    return allocateFromChunk(*chunk, alignedSize);
+  }
+
+  // hand out the largest free region: buffer uploads are split, image uploads wait and retry
+  StagingChunk* largestChunk = nullptr;
+  uint32_t capacity = 0;
+  for (StagingChunk& chunk : chunks_) {
+    if (chunk.size_ - chunk.frontOffset_ > capacity) {
+      largestChunk = &chunk;
+      capacity = chunk.size_ - chunk.frontOffset_;
+    }
+  }
+
+  if (maxRegion != outstandingFences_.end() && capacity < maxRegionDesc.alignedSize_) {
+    outstandingFences_.erase(maxRegion);
 #if IGL_VULKAN_DEBUG_STAGING_DEVICE
     IGL_LOG_INFO("Reusing memory region %u bytes\n", maxRegionDesc.alignedSize_);
 #endif
     return maxRegionDesc;
   }
 
-  if (bufferCapacity_ == 0) {
-    // no more space available in the staging buffer
-    flushOutstandingFences();
+  if (capacity > 0) {
+    return allocateFromChunk(*largestChunk, capacity);
   }
 
-  // allocate from free staging memory
-  alignedSize = (alignedSize <= bufferCapacity_) ? alignedSize : bufferCapacity_;
-  const uint32_t srcOffset = stagingBufferFrontOffset_;
-  stagingBufferFrontOffset_ = (stagingBufferFrontOffset_ + alignedSize) % stagingBufferSize_;
-  bufferCapacity_ -= alignedSize;
-
-#if IGL_VULKAN_DEBUG_STAGING_DEVICE
-  IGL_LOG_INFO("Allocating new memory region: %u bytes\n", alignedSize);
-#endif
+  // no more space available in the staging chunks: wait for all of them to be released. The next
+  // call then finds free space at least in the first chunk, which is never released
+  flushOutstandingFences();
 
-  return {srcOffset, alignedSize};
+  return chunks_.empty() ? MemoryRegionDesc{} : getNextFreeOffset(size);
 }
 
 void VulkanStagingDevice::flushOutstandingFences() {
@@ -490,15 +1361,26 @@ void VulkanStagingDevice::flushOutstandingFences() {
 #if IGL_VULKAN_DEBUG_STAGING_DEVICE
   IGL_LOG_INFO("StagingDevice - Wait for Idle\n");
 #endif
+  if (!outstandingFences_.empty()) {
+    waits_.fetch_add(1, std::memory_order_relaxed);
+  }
   std::for_each(outstandingFences_.begin(),
                 outstandingFences_.end(),
-                [this](std::pair<uint64_t, MemoryRegionDesc> const& pair) {
-                  immediate_->wait(VulkanSubmitHandle(pair.first));
+                [](const OutstandingRegion& region) {
+                  region.immediate_->wait(VulkanSubmitHandle(region.handle_));
                 });
 
   outstandingFences_.clear();
-  stagingBufferFrontOffset_ = 0;
-  bufferCapacity_ = stagingBufferSize_;
+  for (StagingChunk& chunk : chunks_) {
+    chunk.frontOffset_ = 0;
+  }
+}
+
+VulkanStagingDevice::Statistics VulkanStagingDevice::takeStatistics() {
+  Statistics stats;
+  stats.uploadedBytes = uploadedBytes_.exchange(0, std::memory_order_relaxed);
+  stats.waits = waits_.exchange(0, std::memory_order_relaxed);
+  return stats;
 }
 
 } // namespace vulkan
@@ -7,12 +7,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanHelpers.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
 
 namespace igl {
 namespace vulkan {
@@ -20,7 +22,6 @@ namespace vulkan {
 class VulkanBuffer;
 class VulkanContext;
 class VulkanImage;
-class VulkanImmediateCommands;
 
 class VulkanStagingDevice final {
  public:
@@ -46,6 +47,50 @@ class VulkanStagingDevice final {
                    TextureFormatProperties properties,
                    VkFormat format,
                    const void* data);
+
+  // A region of a mip-level of a layer and its pixels, `bytesPerRow` apart (0 if tightly packed)
+  struct ImageRegion2D {
+    VkRect2D imageRegion = {};
+    uint32_t mipLevel = 0;
+    uint32_t layer = 0;
+    const void* data = nullptr;
+    size_t bytesPerRow = 0;
+  };
+  // Stages all `regions` together and copies them with a single vkCmdCopyBufferToImage(), unless
+  // they do not fit in the staging buffer at once. Unlike imageData2D(), the regions can be
+  // smaller than their mip-level: the rest of the image keeps its contents.
+  void imageRegions2D(VulkanImage& image,
+                      const std::vector<ImageRegion2D>& regions,
+                      TextureFormatProperties properties);
+
+  // Asynchronous uploads: the copy is recorded on the dedicated transfer queue (see
+  // VulkanContextConfig::enableStagingTransferQueue) and the ownership of the destination is
+  // transferred to the graphics queue family, which waits for the copy on the GPU. These functions
+  // do not wait for the copy to finish. The destination should not be in use by the GPU. Without a
+  // dedicated transfer queue, they fall back to the synchronous path on the graphics queue.
+  // The returned handle can be checked with isTransferReady() or waited on with waitTransfer().
+  VulkanImmediateCommands::SubmitHandle bufferSubDataAsync(VulkanBuffer& buffer,
+                                                           size_t dstOffset,
+                                                           size_t size,
+                                                           const void* data);
+  VulkanImmediateCommands::SubmitHandle imageData2DAsync(VulkanImage& image,
+                                                         const VkRect2D& imageRegion,
+                                                         uint32_t baseMipLevel,
+                                                         uint32_t numMipLevels,
+                                                         uint32_t layer,
+                                                         TextureFormatProperties properties,
+                                                         VkFormat format,
+                                                         const void* data);
+  bool hasTransferQueue() const {
+    return transferImmediate_ != nullptr;
+  }
+  bool isTransferReady(VulkanImmediateCommands::SubmitHandle handle) const;
+  void waitTransfer(VulkanImmediateCommands::SubmitHandle handle);
+
+  // Reads a region of a mip-level back into `data`. Readbacks of at least
+  // kMinHostPointerReadbackSize bytes whose `data` and size are multiples of
+  // minImportedHostPointerAlignment (4 KB on most devices) are copied straight into `data`,
+  // imported as a buffer (VK_EXT_external_memory_host). Others go through the staging buffer.
   void getImageData2D(VkImage srcImage,
                       const uint32_t level,
                       const uint32_t layer,
@@ -57,25 +102,129 @@ class VulkanStagingDevice final {
                       uint32_t dataBytesPerRow,
                       bool flipImageVertical);
 
+  // Asynchronous readbacks: the copy into the host-visible and mapped `dstBuffer` is recorded and
+  // submitted to the graphics queue without waiting for it. Poll the returned handle with
+  // isReadbackReady() and call waitReadback() before reading `dstBuffer.getMappedPtr() +
+  // dstOffset`; it does not block once the readback is ready. The source should not be modified
+  // by the GPU until then. Image rows are tightly packed; they are flipped vertically by the copy
+  // when `flipImageVertical` is set, which requires their size in `bytesPerRow`.
+  VulkanImmediateCommands::SubmitHandle getBufferSubDataAsync(VulkanBuffer& buffer,
+                                                              size_t srcOffset,
+                                                              size_t size,
+                                                              VulkanBuffer& dstBuffer,
+                                                              size_t dstOffset);
+  VulkanImmediateCommands::SubmitHandle getImageData2DAsync(VkImage srcImage,
+                                                            uint32_t level,
+                                                            uint32_t layer,
+                                                            const VkRect2D& imageRegion,
+                                                            VkImageLayout layout,
+                                                            VulkanBuffer& dstBuffer,
+                                                            size_t dstOffset,
+                                                            bool flipImageVertical = false,
+                                                            uint32_t bytesPerRow = 0);
+  bool isReadbackReady(VulkanImmediateCommands::SubmitHandle handle) const;
+  // below this size, importing the client memory costs more than copying it from staging
+  static constexpr uint32_t kMinHostPointerReadbackSize = 256 * 1024;
+  // waits for the readback and makes the contents of `dstBuffer` visible to the host
+  void waitReadback(VulkanImmediateCommands::SubmitHandle handle, const VulkanBuffer& dstBuffer);
+
+  struct Statistics {
+    uint64_t uploadedBytes = 0; // copied into the staging buffer for uploads
+    uint64_t waits = 0; // waits for the GPU to release staging memory
+  };
+  // returns the statistics accumulated since the previous call and resets them
+  Statistics takeStatistics();
+
+  // Called once per submit. Rewinds the staging chunks whose regions were all consumed by the GPU
+  // and releases the chunks added under load which have not been used for a while
+  void releaseIdleChunks();
+
  private:
   struct MemoryRegionDesc {
+    VulkanBuffer* buffer_ = nullptr; // the staging chunk the region belongs to
     uint32_t srcOffset_ = 0;
     uint32_t alignedSize_ = 0;
   };
 
+  // A host-visible staging buffer. Regions are allocated linearly from its front and are reused
+  // one by one as their fences signal; the whole chunk is rewound once none of them is in flight
+  struct StagingChunk {
+    std::shared_ptr<VulkanBuffer> buffer_;
+    uint32_t size_ = 0;
+    uint32_t frontOffset_ = 0;
+    uint64_t lastUsedSubmit_ = 0;
+  };
+
+  struct OutstandingRegion {
+    VulkanImmediateCommands* immediate_ = nullptr;
+    uint64_t handle_ = 0;
+    MemoryRegionDesc desc_;
+  };
+
+  VulkanImmediateCommands::SubmitHandle bufferSubDataImpl(VulkanBuffer& buffer,
+                                                          size_t dstOffset,
+                                                          size_t size,
+                                                          const void* data,
+                                                          bool async);
+  VulkanImmediateCommands::SubmitHandle imageData2DImpl(VulkanImage& image,
+                                                        const VkRect2D& imageRegion,
+                                                        uint32_t baseMipLevel,
+                                                        uint32_t numMipLevels,
+                                                        uint32_t layer,
+                                                        TextureFormatProperties properties,
+                                                        VkFormat format,
+                                                        const void* data,
+                                                        bool async);
+  // Writes the mip-levels `baseMipLevel`..`baseMipLevel + numMipLevels - 1` of `layer` straight
+  // from `data` with vkCopyMemoryToImageEXT() (VK_EXT_host_image_copy), without staging or
+  // submitting anything. The host cannot wait for the commands reading an image, so only images
+  // created with VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT whose mip-levels were never used by the GPU
+  // are written this way. Returns false if the pixels have to be staged instead.
+  bool copyMemoryToImage(VulkanImage& image,
+                         const VkExtent3D& extent,
+                         uint32_t baseMipLevel,
+                         uint32_t numMipLevels,
+                         uint32_t layer,
+                         TextureFormatProperties properties,
+                         const void* data);
+  // Copies the region into `data` imported as a buffer and waits for the copy. Returns false,
+  // without recording anything, if `data` cannot be imported and the readback has to be staged
+  bool getImageData2DToHostPointer(VkImage srcImage,
+                                   uint32_t level,
+                                   uint32_t layer,
+                                   const VkRect2D& imageRegion,
+                                   VkImageLayout layout,
+                                   void* data,
+                                   uint32_t size,
+                                   uint32_t bytesPerRow,
+                                   bool flipImageVertical);
+  // submits `wrapper` to the transfer queue and makes the graphics queue wait for it after
+  // recording the ownership acquire barriers with `acquireOwnership`
+  VulkanImmediateCommands::SubmitHandle submitTransfer(
+      const VulkanImmediateCommands::CommandBufferWrapper& wrapper,
+      const std::function<void(VkCommandBuffer)>& acquireOwnership);
   uint32_t getAlignedSize(uint32_t size) const;
   MemoryRegionDesc getNextFreeOffset(uint32_t size);
   void flushOutstandingFences();
+  // adds a chunk of at least `minSize` bytes, releasing idle chunks to stay within maxSize_.
+  // Returns null if the budget is exhausted
+  StagingChunk* addChunk(uint32_t minSize);
+  MemoryRegionDesc allocateFromChunk(StagingChunk& chunk, uint32_t size);
+  void rewindIdleChunks();
 
  private:
   VulkanContext& ctx_;
-  std::shared_ptr<VulkanBuffer> stagingBuffer_;
+  std::vector<StagingChunk> chunks_;
   std::unique_ptr<VulkanImmediateCommands> immediate_;
-  uint32_t stagingBufferFrontOffset_ = 0;
+  std::unique_ptr<VulkanImmediateCommands> transferImmediate_; // null without a transfer queue
   uint32_t stagingBufferAlignment_ = 16; // updated to support BC7 compressed image
-  uint32_t stagingBufferSize_;
-  uint32_t bufferCapacity_;
-  std::unordered_map<uint64_t, MemoryRegionDesc> outstandingFences_;
+  uint32_t chunkSize_ = 0; // the size of the first chunk and the minimum size of the others
+  uint32_t maxChunkSize_ = 0; // the largest upload which can be staged at once
+  uint32_t maxSize_ = 0; // the total size of all chunks
+  uint64_t numSubmits_ = 0;
+  std::vector<OutstandingRegion> outstandingFences_;
+  std::atomic<uint64_t> uploadedBytes_ = 0;
+  std::atomic<uint64_t> waits_ = 0;
 };
 
 } // namespace vulkan
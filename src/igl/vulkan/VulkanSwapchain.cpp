@@ -71,7 +71,17 @@ VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>
   return formats[0];
 }
 
-VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& modes) {
+VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& modes,
+                                       VkPresentModeKHR requested) {
+  if (requested != VK_PRESENT_MODE_MAX_ENUM_KHR) {
+    if (std::find(modes.cbegin(), modes.cend(), requested) != modes.cend()) {
+      return requested;
+    }
+    IGL_LOG_INFO("Present mode %u is not supported. Falling back to VK_PRESENT_MODE_FIFO_KHR\n",
+                 (uint32_t)requested);
+    // FIFO is the only mode guaranteed to be supported
+    return VK_PRESENT_MODE_FIFO_KHR;
+  }
   if (std::find(modes.cbegin(), modes.cend(), VK_PRESENT_MODE_IMMEDIATE_KHR) != modes.cend()) {
     return VK_PRESENT_MODE_IMMEDIATE_KHR;
   }
@@ -102,18 +112,38 @@ VkImageUsageFlags chooseUsageFlags(VkPhysicalDevice pd, VkSurfaceKHR surface, Vk
     usageFlags |= VK_IMAGE_USAGE_STORAGE_BIT;
   }
 
+  // framebuffer fetch reads all color attachments of a render pass, see
+  // RenderPassDesc::framebufferFetch
+  if (caps.supportedUsageFlags & VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT) {
+    usageFlags |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+  }
+
   return usageFlags;
 }
 
+VkSurfaceTransformFlagBitsKHR choosePreTransform(const VkSurfaceCapabilitiesKHR& caps,
+                                                 bool enablePreRotation) {
+  if (enablePreRotation ||
+      (caps.supportedTransforms & VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR) == 0) {
+    return caps.currentTransform;
+  }
+  // the compositor rotates the images
+  return VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+}
+
 } // namespace
 
 namespace igl {
 namespace vulkan {
 
-VulkanSwapchain::VulkanSwapchain(const VulkanContext& ctx, uint32_t width, uint32_t height) :
+VulkanSwapchain::VulkanSwapchain(const VulkanContext& ctx,
+                                 uint32_t width,
+                                 uint32_t height,
+                                 VkSwapchainKHR oldSwapchain) :
   ctx_(ctx),
   device_(ctx.device_->getVkDevice()),
   graphicsQueue_(ctx.deviceQueues_.graphicsQueue),
+  presentQueue_(ctx.deviceQueues_.presentQueue),
   width_(width),
   height_(height) {
   surfaceFormat_ =
@@ -147,17 +177,31 @@ VulkanSwapchain::VulkanSwapchain(const VulkanContext& ctx, uint32_t width, uint3
 
   const VkImageUsageFlags usageFlags =
       chooseUsageFlags(ctx.getVkPhysicalDevice(), ctx.vkSurface_, surfaceFormat_.format);
+  presentMode_ = chooseSwapPresentMode(ctx.devicePresentModes_, ctx.config_.swapchainPresentMode);
+
+  // the display can be rotated after the context was created
+  VkSurfaceCapabilitiesKHR caps = ctx.deviceSurfaceCaps_;
+  VK_ASSERT(
+      vkGetPhysicalDeviceSurfaceCapabilitiesKHR(ctx.getVkPhysicalDevice(), ctx.vkSurface_, &caps));
+  preTransform_ = choosePreTransform(caps, ctx.config_.enableSwapchainPreRotation);
+
+  // pre-rotated images are in the native orientation of the display
+  if (isPreRotatedSideways()) {
+    std::swap(width_, height_);
+  }
 
   VK_ASSERT(ivkCreateSwapchain(device_,
                                ctx.vkSurface_,
-                               chooseSwapImageCount(ctx.deviceSurfaceCaps_),
+                               chooseSwapImageCount(caps),
                                surfaceFormat_,
-                               chooseSwapPresentMode(ctx.devicePresentModes_),
-                               &ctx.deviceSurfaceCaps_,
+                               presentMode_,
+                               &caps,
+                               preTransform_,
                                usageFlags,
                                ctx.deviceQueues_.graphicsQueueFamilyIndex,
-                               width,
-                               height,
+                               width_,
+                               height_,
+                               oldSwapchain,
                                &swapchain_));
   VK_ASSERT(vkGetSwapchainImagesKHR(device_, swapchain_, &numSwapchainImages_, nullptr));
   std::vector<VkImage> swapchainImages(numSwapchainImages_);
@@ -192,6 +236,12 @@ VulkanSwapchain::VulkanSwapchain(const VulkanContext& ctx, uint32_t width, uint3
     swapchainTextures_.emplace_back(
         std::make_shared<VulkanTexture>(ctx_, std::move(image), std::move(imageView)));
   }
+
+  if (ctx.usePresentThread_) {
+    // the first image is acquired right away by the present thread
+    isAcquiring_ = true;
+    presentThread_ = std::thread([this]() { presentThreadLoop(); });
+  }
 }
 
 VkImage VulkanSwapchain::getDepthVkImage() const {
@@ -245,11 +295,142 @@ void VulkanSwapchain::lazyAllocateDepthBuffer() const {
 }
 
 VulkanSwapchain::~VulkanSwapchain() {
+  if (presentQueue_ != VK_NULL_HANDLE) {
+    stopPresentThread();
+    // An image acquired ahead was never rendered to. Its acquire semaphore has a pending signal
+    // which has to be consumed before the semaphore can be destroyed
+    if (acquiredImageIndex_ != kNoImage) {
+      const VkPipelineStageFlags waitStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+      VkSubmitInfo si = {};
+      si.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+      si.waitSemaphoreCount = 1;
+      si.pWaitSemaphores = &acquireSemaphore_->vkSemaphore_;
+      si.pWaitDstStageMask = &waitStageMask;
+      VK_ASSERT(vkQueueSubmit(presentQueue_, 1, &si, VK_NULL_HANDLE));
+    }
+    // the presents must complete before the swapchain is destroyed
+    VK_ASSERT(vkQueueWaitIdle(presentQueue_));
+  }
   vkDestroySwapchainKHR(device_, swapchain_, nullptr);
 }
 
+void VulkanSwapchain::stopPresentThread() {
+  if (!presentThread_.joinable()) {
+    return;
+  }
+
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
+
+  {
+    std::lock_guard<std::mutex> lock(presentMutex_);
+    isStopping_ = true;
+  }
+  presentCondition_.notify_all();
+  presentThread_.join();
+}
+
+void VulkanSwapchain::presentThreadLoop() {
+  IGL_PROFILER_THREAD("PresentThread");
+
+  acquireImageAhead();
+
+  while (true) {
+    PresentRequest request;
+    bool acquireNext = false;
+    {
+      std::unique_lock<std::mutex> lock(presentMutex_);
+      presentCondition_.wait(lock, [this]() { return isStopping_ || !presentRequests_.empty(); });
+      if (presentRequests_.empty()) {
+        return;
+      }
+      request = presentRequests_.front();
+      presentRequests_.pop_front();
+      // no more images are acquired once the thread is stopping
+      acquireNext = !isStopping_;
+      isAcquiring_ = acquireNext;
+    }
+
+    IGL_PROFILER_ZONE("vkQueuePresent()", IGL_PROFILER_COLOR_PRESENT);
+    const VkResult result =
+        ivkQueuePresent(presentQueue_, request.waitSemaphore, swapchain_, request.imageIndex, 0);
+    IGL_PROFILER_ZONE_END();
+
+    if (result != VK_SUCCESS) {
+      std::lock_guard<std::mutex> lock(presentMutex_);
+      if (presentResult_ == VK_SUCCESS) {
+        presentResult_ = result;
+      }
+    }
+
+    if (acquireNext) {
+      acquireImageAhead();
+    }
+  }
+}
+
+void VulkanSwapchain::acquireImageAhead() {
+  IGL_PROFILER_FUNCTION();
+
+  uint32_t imageIndex = 0;
+  const VkResult result = vkAcquireNextImageKHR(device_,
+                                                swapchain_,
+                                                UINT64_MAX,
+                                                acquireSemaphore_->vkSemaphore_,
+                                                VK_NULL_HANDLE,
+                                                &imageIndex);
+
+  {
+    std::lock_guard<std::mutex> lock(presentMutex_);
+    // on failure the render thread acquires the image itself and reports the error
+    acquiredImageIndex_ = result == VK_SUCCESS ? imageIndex : kNoImage;
+    isAcquiring_ = false;
+  }
+  presentCondition_.notify_all();
+}
+
+void VulkanSwapchain::throttleFramesInFlight() {
+  const uint32_t maxFramesInFlight = ctx_.config_.maxFramesInFlight;
+
+  if (!maxFramesInFlight) {
+    presentedSubmits_.clear();
+    return;
+  }
+
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
+
+  if (ctx_.usePresentWait_ && !ctx_.usePresentThread_) {
+    // the frame about to be rendered is (lastPresentId_ + 1)
+    if (lastPresentId_ + 1 > maxFramesInFlight) {
+      waitForPresent(lastPresentId_ + 1 - maxFramesInFlight, UINT64_MAX);
+    }
+    return;
+  }
+
+  while (presentedSubmits_.size() >= maxFramesInFlight) {
+    ctx_.immediate_->wait(presentedSubmits_.front());
+    presentedSubmits_.pop_front();
+  }
+}
+
 Result VulkanSwapchain::acquireNextImage() {
   IGL_PROFILER_FUNCTION();
+
+  throttleFramesInFlight();
+
+  if (presentThread_.joinable()) {
+    IGL_PROFILER_ZONE("Wait for the present thread", IGL_PROFILER_COLOR_WAIT);
+    std::unique_lock<std::mutex> lock(presentMutex_);
+    presentCondition_.wait(lock, [this]() { return presentRequests_.empty() && !isAcquiring_; });
+    IGL_PROFILER_ZONE_END();
+    if (acquiredImageIndex_ != kNoImage) {
+      currentImageIndex_ = acquiredImageIndex_;
+      acquiredImageIndex_ = kNoImage;
+      frameNumber_++;
+      return Result();
+    }
+    // the present thread is idle until the next present request, the swapchain can be used here
+  }
+
   // when timeout is set to UINT64_MAX, we wait until the next image has been acquired
   VK_ASSERT_RETURN(vkAcquireNextImageKHR(device_,
                                          swapchain_,
@@ -265,10 +446,37 @@ Result VulkanSwapchain::acquireNextImage() {
 Result VulkanSwapchain::present(VkSemaphore waitSemaphore) {
   IGL_PROFILER_FUNCTION();
 
+  if (presentThread_.joinable()) {
+    VkResult result = VK_SUCCESS;
+    {
+      std::lock_guard<std::mutex> lock(presentMutex_);
+      presentRequests_.push_back({currentImageIndex_, waitSemaphore});
+      std::swap(result, presentResult_);
+    }
+    presentCondition_.notify_all();
+
+    if (ctx_.config_.maxFramesInFlight) {
+      presentedSubmits_.push_back(ctx_.immediate_->getLastSubmitHandle());
+    }
+    getNextImage_ = true;
+
+    IGL_PROFILER_FRAME(nullptr);
+
+    return getResultFromVkResult(result);
+  }
+
   IGL_PROFILER_ZONE("vkQueuePresent()", IGL_PROFILER_COLOR_PRESENT);
-  VK_ASSERT_RETURN(ivkQueuePresent(graphicsQueue_, waitSemaphore, swapchain_, currentImageIndex_));
+  const uint64_t presentId = ctx_.usePresentWait_ ? lastPresentId_ + 1 : 0;
+  VK_ASSERT_RETURN(
+      ivkQueuePresent(graphicsQueue_, waitSemaphore, swapchain_, currentImageIndex_, presentId));
   IGL_PROFILER_ZONE_END();
 
+  if (presentId) {
+    lastPresentId_ = presentId;
+  } else if (ctx_.config_.maxFramesInFlight) {
+    presentedSubmits_.push_back(ctx_.immediate_->getLastSubmitHandle());
+  }
+
   // Ready to call acquireNextImage() on the next getCurrentVulkanTexture();
   getNextImage_ = true;
 
@@ -277,5 +485,33 @@ Result VulkanSwapchain::present(VkSemaphore waitSemaphore) {
   return Result();
 }
 
+Result VulkanSwapchain::waitForPresent(uint64_t presentId, uint64_t timeoutNanos) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
+
+  if (!ctx_.usePresentWait_) {
+    return Result(Result::Code::Unsupported, "VK_KHR_present_wait is not enabled");
+  }
+  // vkWaitForPresentKHR() would race with the presents of the present thread
+  if (ctx_.usePresentThread_) {
+    return Result(Result::Code::Unsupported, "Present wait is not available with a present thread");
+  }
+
+  if (!presentId || presentId > lastPresentId_) {
+    return Result(Result::Code::ArgumentInvalid, "Invalid present id");
+  }
+
+  const VkResult result = ctx_.vkWaitForPresent_(device_, swapchain_, presentId, timeoutNanos);
+
+  if (result == VK_TIMEOUT) {
+    return Result(Result::Code::RuntimeError, "Timeout");
+  }
+  // the swapchain is about to be recreated, e.g. when the window is resized
+  if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+    return Result();
+  }
+
+  return getResultFromVkResult(result);
+}
+
 } // namespace vulkan
 } // namespace igl
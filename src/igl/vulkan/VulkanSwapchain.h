@@ -7,12 +7,17 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanFramebuffer.h>
 #include <igl/vulkan/VulkanHelpers.h>
 #include <igl/vulkan/VulkanImage.h>
 #include <igl/vulkan/VulkanImageView.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
 #include <igl/vulkan/VulkanTexture.h>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace igl {
@@ -24,11 +29,20 @@ class VulktanTexture;
 
 class VulkanSwapchain final {
  public:
-  VulkanSwapchain(const VulkanContext& ctx, uint32_t width, uint32_t height);
+  // `oldSwapchain` is retired by the new swapchain: no more images can be acquired from it, the
+  // images already acquired can still be presented
+  VulkanSwapchain(const VulkanContext& ctx,
+                  uint32_t width,
+                  uint32_t height,
+                  VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
   ~VulkanSwapchain();
 
   Result acquireNextImage();
   Result present(VkSemaphore waitSemaphore);
+  Result waitForPresent(uint64_t presentId, uint64_t timeoutNanos) const;
+  // Presents all pending frames and stops the present thread (if any). Must be called before the
+  // swapchain is retired by a new one, since vkCreateSwapchainKHR() needs exclusive access to it
+  void stopPresentThread();
   VkImage getCurrentVkImage() const {
     if (IGL_VERIFY(currentImageIndex_ < numSwapchainImages_)) {
       return swapchainTextures_[currentImageIndex_]->getVulkanImage().getVkImage();
@@ -74,6 +88,20 @@ class VulkanSwapchain final {
   VkExtent2D getExtent() const {
     return VkExtent2D{width_, height_};
   }
+  // the extent the swapchain was requested with; differs from getExtent() if the images are
+  // pre-rotated by 90 or 270 degrees
+  VkExtent2D getWindowExtent() const {
+    return isPreRotatedSideways() ? VkExtent2D{height_, width_} : VkExtent2D{width_, height_};
+  }
+  // the transform the presentation engine applies to the images, see
+  // VulkanContextConfig::enableSwapchainPreRotation
+  VkSurfaceTransformFlagBitsKHR getPreTransform() const {
+    return preTransform_;
+  }
+  bool isPreRotatedSideways() const {
+    return (preTransform_ & (VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR |
+                             VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR)) != 0;
+  }
 
   VkFormat getFormatColor() const {
     return surfaceFormat_.format;
@@ -91,8 +119,25 @@ class VulkanSwapchain final {
     return frameNumber_;
   }
 
+  uint64_t getLastPresentId() const {
+    return lastPresentId_;
+  }
+
+  VkPresentModeKHR getPresentMode() const {
+    return presentMode_;
+  }
+
+  VkSwapchainKHR getVkSwapchain() const {
+    return swapchain_;
+  }
+
  private:
   void lazyAllocateDepthBuffer() const;
+  // blocks until no more than (maxFramesInFlight - 1) presented frames are still in flight
+  void throttleFramesInFlight();
+  // present thread: presents the queued frames and acquires the next image after each present
+  void presentThreadLoop();
+  void acquireImageAhead();
 
  public:
   std::unique_ptr<igl::vulkan::VulkanSemaphore> acquireSemaphore_;
@@ -101,18 +146,43 @@ class VulkanSwapchain final {
   const VulkanContext& ctx_;
   VkDevice device_;
   VkQueue graphicsQueue_;
+  VkQueue presentQueue_;
   uint32_t width_ = 0;
   uint32_t height_ = 0;
   uint32_t numSwapchainImages_ = 0;
   uint32_t currentImageIndex_ = 0;
   uint64_t frameNumber_ = 0;
   bool getNextImage_ = true;
+  VkPresentModeKHR presentMode_ = VK_PRESENT_MODE_FIFO_KHR;
+  VkSurfaceTransformFlagBitsKHR preTransform_ = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+  // increasing VK_KHR_present_id values; stays 0 if presents are not identified
+  uint64_t lastPresentId_ = 0;
+  // the last graphics submit of every presented frame still in flight (when present wait is not
+  // available)
+  std::deque<VulkanImmediateCommands::SubmitHandle> presentedSubmits_;
   VkSwapchainKHR swapchain_;
   std::vector<std::shared_ptr<VulkanTexture>> swapchainTextures_;
   mutable std::shared_ptr<VulkanImage> depthImage_;
   mutable std::shared_ptr<VulkanImageView> depthImageView_;
   mutable std::shared_ptr<VulkanTexture> depthTexture_;
   VkSurfaceFormatKHR surfaceFormat_;
+
+  // Present thread, see VulkanContextConfig::enablePresentThread. The render thread hands over
+  // frames in presentRequests_ and takes the images acquired ahead from acquiredImageIndex_
+  struct PresentRequest {
+    uint32_t imageIndex = 0;
+    VkSemaphore waitSemaphore = VK_NULL_HANDLE;
+  };
+  constexpr static uint32_t kNoImage = 0xFFFFFFFF;
+  std::thread presentThread_;
+  std::mutex presentMutex_;
+  std::condition_variable presentCondition_;
+  std::deque<PresentRequest> presentRequests_;
+  uint32_t acquiredImageIndex_ = kNoImage;
+  bool isAcquiring_ = false;
+  bool isStopping_ = false;
+  // the first error of the present thread, reported by the next present()
+  VkResult presentResult_ = VK_SUCCESS;
 };
 
 } // namespace vulkan
@@ -17,12 +17,24 @@ namespace vulkan {
 
 VulkanTexture::VulkanTexture(const VulkanContext& ctx,
                              std::shared_ptr<VulkanImage> image,
-                             std::shared_ptr<VulkanImageView> imageView) :
-  ctx_(ctx), image_(std::move(image)), imageView_(std::move(imageView)) {
+                             std::shared_ptr<VulkanImageView> imageView,
+                             VkFormat viewFormat,
+                             uint32_t baseLevel,
+                             uint32_t baseLayer) :
+  ctx_(ctx),
+  image_(std::move(image)),
+  imageView_(std::move(imageView)),
+  viewFormat_(viewFormat),
+  baseLevel_(baseLevel),
+  baseLayer_(baseLayer) {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
 
   IGL_ASSERT(image_);
   IGL_ASSERT(imageView_);
+
+  if (viewFormat_ == VK_FORMAT_UNDEFINED) {
+    viewFormat_ = image_->imageFormat_;
+  }
 }
 
 VulkanTexture::~VulkanTexture() {
@@ -32,6 +44,45 @@ VulkanTexture::~VulkanTexture() {
   ctx_.awaitingDeletion_ = true;
 }
 
+const VulkanImageView& VulkanTexture::getOrCreateImageView(VkImageViewType type,
+                                                           VkImageAspectFlags aspectMask,
+                                                           uint32_t baseLevel,
+                                                           uint32_t numLevels,
+                                                           uint32_t baseLayer,
+                                                           uint32_t numLayers) const {
+  const ImageViewKey key = {type, aspectMask, baseLevel, numLevels, baseLayer, numLayers};
+
+  const std::lock_guard<std::mutex> lock(imageViewsMutex_);
+
+  auto it = imageViews_.find(key);
+
+  if (it == imageViews_.end()) {
+    IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+    it = imageViews_
+             .emplace(key,
+                      image_->createImageView(type,
+                                              viewFormat_,
+                                              aspectMask,
+                                              baseLevel_ + baseLevel,
+                                              numLevels,
+                                              baseLayer_ + baseLayer,
+                                              numLayers))
+             .first;
+  }
+
+  return *it->second;
+}
+
+size_t VulkanTexture::HashFunction::operator()(const ImageViewKey& key) const {
+  size_t hash = std::hash<uint32_t>()(key.type);
+  hash ^= std::hash<uint32_t>()(key.aspectMask) << 1;
+  hash ^= std::hash<uint32_t>()(key.baseLevel) << 2;
+  hash ^= std::hash<uint32_t>()(key.numLevels) << 3;
+  hash ^= std::hash<uint32_t>()(key.baseLayer) << 4;
+  hash ^= std::hash<uint32_t>()(key.numLayers) << 5;
+  return hash;
+}
+
 } // namespace vulkan
 
 } // namespace igl
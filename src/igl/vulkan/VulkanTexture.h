@@ -8,6 +8,8 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include <igl/ColorSpace.h>
 #include <igl/vulkan/Common.h>
@@ -22,9 +24,14 @@ class VulkanImageView;
 
 class VulkanTexture final {
  public:
+  // `viewFormat`, `baseLevel` and `baseLayer` describe textures aliasing a subresource range of
+  // `image` in a compatible format (IDevice::createTextureView)
   VulkanTexture(const VulkanContext& ctx,
                 std::shared_ptr<VulkanImage> image,
-                std::shared_ptr<VulkanImageView> imageView);
+                std::shared_ptr<VulkanImageView> imageView,
+                VkFormat viewFormat = VK_FORMAT_UNDEFINED,
+                uint32_t baseLevel = 0,
+                uint32_t baseLayer = 0);
   ~VulkanTexture();
 
   VulkanTexture(const VulkanTexture&) = delete;
@@ -45,14 +52,63 @@ class VulkanTexture final {
   uint32_t getTextureId() const {
     return textureId_;
   }
+  VkFormat getViewFormat() const {
+    return viewFormat_;
+  }
+  uint32_t getBaseLevel() const {
+    return baseLevel_;
+  }
+  uint32_t getBaseLayer() const {
+    return baseLayer_;
+  }
+
+  /**
+   * @brief Returns a view of a subresource range of the image. Views are cached per texture and
+   * are released together with it, so rendering into separate mip-levels or layers every frame
+   * does not create new views. Levels and layers are relative to the ones seen by this texture.
+   */
+  const VulkanImageView& getOrCreateImageView(VkImageViewType type,
+                                              VkImageAspectFlags aspectMask,
+                                              uint32_t baseLevel,
+                                              uint32_t numLevels,
+                                              uint32_t baseLayer,
+                                              uint32_t numLayers) const;
+
+ private:
+  struct ImageViewKey {
+    VkImageViewType type;
+    VkImageAspectFlags aspectMask;
+    uint32_t baseLevel;
+    uint32_t numLevels;
+    uint32_t baseLayer;
+    uint32_t numLayers;
+
+    bool operator==(const ImageViewKey& other) const {
+      return type == other.type && aspectMask == other.aspectMask &&
+             baseLevel == other.baseLevel && numLevels == other.numLevels &&
+             baseLayer == other.baseLayer && numLayers == other.numLayers;
+    }
+  };
+
+  struct HashFunction {
+    size_t operator()(const ImageViewKey& key) const;
+  };
 
  private:
+  friend class Device;
   friend class VulkanContext;
+  friend class VulkanDefragmenter;
   const VulkanContext& ctx_;
   std::shared_ptr<VulkanImage> image_;
   std::shared_ptr<VulkanImageView> imageView_;
+  VkFormat viewFormat_ = VK_FORMAT_UNDEFINED;
+  uint32_t baseLevel_ = 0;
+  uint32_t baseLayer_ = 0;
   // an index into VulkanContext::textures_
   uint32_t textureId_ = 0;
+  mutable std::mutex imageViewsMutex_;
+  mutable std::unordered_map<ImageViewKey, std::shared_ptr<VulkanImageView>, HashFunction>
+      imageViews_;
 };
 
 } // namespace vulkan
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/VulkanWorkerPool.h>
+
+#include <algorithm>
+
+namespace igl::vulkan {
+
+VulkanWorkerPool::VulkanWorkerPool(size_t maxThreads) :
+  maxThreads_(std::max<size_t>(1, maxThreads)) {}
+
+VulkanWorkerPool::~VulkanWorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    isStopping_ = true;
+  }
+  condition_.notify_all();
+
+  for (auto& t : threads_) {
+    t.join();
+  }
+}
+
+std::shared_future<void> VulkanWorkerPool::push(std::function<void()> task) {
+  std::packaged_task<void()> packagedTask(std::move(task));
+  std::shared_future<void> future = packagedTask.get_future().share();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(packagedTask));
+    if (numIdleThreads_ < tasks_.size() && threads_.size() < maxThreads_) {
+      threads_.emplace_back([this]() { run(); });
+    }
+  }
+  condition_.notify_one();
+
+  return future;
+}
+
+size_t VulkanWorkerPool::getNumThreads() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return threads_.size();
+}
+
+void VulkanWorkerPool::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  for (;;) {
+    numIdleThreads_++;
+    condition_.wait(lock, [this]() { return isStopping_ || !tasks_.empty(); });
+    numIdleThreads_--;
+
+    if (tasks_.empty()) {
+      // stopping and everything has been run
+      return;
+    }
+
+    std::packaged_task<void()> task = std::move(tasks_.front());
+    tasks_.pop_front();
+
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
+
+} // namespace igl::vulkan
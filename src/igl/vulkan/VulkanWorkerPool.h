@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace igl::vulkan {
+
+/*
+ * A fixed number of worker threads running background tasks (pipeline warm-up, asynchronous
+ * compute pipelines and optimized pipeline links) in submission order. Threads are started on
+ * demand, so a pool which is never used costs nothing. The destructor runs the tasks still queued
+ * and joins the threads.
+ */
+class VulkanWorkerPool final {
+ public:
+  explicit VulkanWorkerPool(size_t maxThreads);
+  ~VulkanWorkerPool();
+
+  VulkanWorkerPool(const VulkanWorkerPool&) = delete;
+  VulkanWorkerPool& operator=(const VulkanWorkerPool&) = delete;
+
+  // thread-safe
+  std::shared_future<void> push(std::function<void()> task);
+
+  size_t getNumThreads() const;
+
+ private:
+  void run();
+
+ private:
+  const size_t maxThreads_;
+  mutable std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<std::packaged_task<void()>> tasks_;
+  std::vector<std::thread> threads_;
+  size_t numIdleThreads_ = 0;
+  bool isStopping_ = false;
+};
+
+} // namespace igl::vulkan